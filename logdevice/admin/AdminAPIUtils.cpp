@@ -8,6 +8,8 @@
 
 #include "logdevice/admin/AdminAPIUtils.h"
 
+#include <algorithm>
+
 #include "logdevice/admin/Conv.h"
 #include "logdevice/admin/toString.h"
 #include "logdevice/common/AuthoritativeStatus.h"
@@ -122,6 +124,42 @@ void forFilteredNodes(
   }
 }
 
+std::vector<node_index_t>
+filteredNodesPage(const NodesConfiguration& nodes_configuration,
+                  const thrift::NodesFilter* filter,
+                  const thrift::NodesPage* page,
+                  folly::Optional<node_index_t>& next_node_index) {
+  const node_index_t start = page ? page->get_start_node_index() : 0;
+  std::vector<node_index_t> nodes;
+  forFilteredNodes(nodes_configuration, filter, [&](node_index_t index) {
+    if (index >= start) {
+      nodes.push_back(index);
+    }
+  });
+
+  next_node_index.clear();
+  const size_t max_nodes = page ? page->get_max_nodes() : 0;
+  if (max_nodes > 0 && nodes.size() > max_nodes) {
+    // Only the nodes of the page need to be sorted. The first node of the
+    // next page ends up right after them.
+    std::nth_element(nodes.begin(), nodes.begin() + max_nodes, nodes.end());
+    next_node_index = nodes[max_nodes];
+    nodes.resize(max_nodes);
+  }
+  std::sort(nodes.begin(), nodes.end());
+  return nodes;
+}
+
+void validateNodesPage(const thrift::NodesPage& page) {
+  if (page.get_start_node_index() < 0) {
+    throw thrift::InvalidRequest(
+        "NodesPage.start_node_index can't be negative");
+  }
+  if (page.get_max_nodes() < 0) {
+    throw thrift::InvalidRequest("NodesPage.max_nodes can't be negative");
+  }
+}
+
 // TODO: Deprecate and use Maintenance Manager instead.
 thrift::ShardOperationalState
 toShardOperationalState(membership::StorageState storage_state,
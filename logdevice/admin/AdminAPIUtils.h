@@ -43,6 +43,24 @@ void forFilteredNodes(
     const thrift::NodesFilter* filter,
     NodeFunctor fn);
 
+/**
+ * Returns the indices of the nodes that match `filter`, in increasing order.
+ * If `page` is not null, only the nodes of that page are returned and
+ * `next_node_index` is set to the index of the first node past the page, if
+ * any. `page` is expected to have been validated with validateNodesPage().
+ */
+std::vector<node_index_t> filteredNodesPage(
+    const configuration::nodes::NodesConfiguration& nodes_configuration,
+    const thrift::NodesFilter* filter,
+    const thrift::NodesPage* page,
+    folly::Optional<node_index_t>& next_node_index);
+
+/**
+ * Throws thrift::InvalidRequest if `page` has a negative start index or
+ * size.
+ */
+void validateNodesPage(const thrift::NodesPage& page);
+
 void fillNodeConfig(
     thrift::NodeConfig& out,
     node_index_t node_index,
@@ -37,4 +37,38 @@ void NodesConfigAPIHandler::getNodesConfig(
       static_cast<int64_t>(nodes_configuration->getVersion().val()));
 }
 
+void NodesConfigAPIHandler::getNodesConfigPage(
+    thrift::NodesConfigResponse& out,
+    std::unique_ptr<thrift::NodesConfigRequest> request) {
+  if (request == nullptr) {
+    throw thrift::InvalidRequest(
+        "Cannot accept getNodesConfigPage without arguments");
+  }
+  const thrift::NodesFilter* filter = request->filter_ref().has_value()
+      ? &request->filter_ref().value()
+      : nullptr;
+  const thrift::NodesPage* page = request->page_ref().has_value()
+      ? &request->page_ref().value()
+      : nullptr;
+  if (page) {
+    validateNodesPage(*page);
+  }
+
+  auto nodes_configuration = processor_->getNodesConfiguration();
+  folly::Optional<node_index_t> next_node_index;
+  std::vector<thrift::NodeConfig> result_nodes;
+  for (node_index_t index : filteredNodesPage(
+           *nodes_configuration, filter, page, next_node_index)) {
+    thrift::NodeConfig node;
+    fillNodeConfig(node, index, *nodes_configuration);
+    result_nodes.push_back(std::move(node));
+  }
+  out.set_nodes(std::move(result_nodes));
+  out.set_version(
+      static_cast<int64_t>(nodes_configuration->getVersion().val()));
+  if (next_node_index.hasValue()) {
+    out.set_next_node_index(next_node_index.value());
+  }
+}
+
 }} // namespace facebook::logdevice
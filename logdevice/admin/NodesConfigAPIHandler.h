@@ -22,5 +22,10 @@ class NodesConfigAPIHandler : public virtual AdminAPIHandlerBase {
   // See admin.thrift for documentation
   getNodesConfig(thrift::NodesConfigResponse&,
                  std::unique_ptr<thrift::NodesFilter> filter) override;
+
+  // See admin.thrift for documentation
+  void getNodesConfigPage(
+      thrift::NodesConfigResponse&,
+      std::unique_ptr<thrift::NodesConfigRequest> request) override;
 };
 }} // namespace facebook::logdevice
@@ -52,8 +52,13 @@ NodesStateAPIHandler::semifuture_getNodesState(
   }
 
   auto filter = req->filter_ref().value_or(NodesFilter());
+  folly::Optional<thrift::NodesPage> page;
+  if (req->page_ref().has_value()) {
+    page = req->page_ref().value();
+    validateNodesPage(*page);
+  }
   if (isMaintenanceManagerEnabled()) {
-    return maintenance_manager_->getNodesState(filter)
+    return maintenance_manager_->getNodesState(filter, page)
         .via(getThreadManager())
         .thenValue([](auto&& expected_output) {
           if (expected_output.hasError()) {
@@ -71,15 +76,23 @@ NodesStateAPIHandler::semifuture_getNodesState(
     if (req) {
       force = req->force_ref().value_or(false);
     }
+    folly::Optional<node_index_t> next_node_index;
     std::vector<thrift::NodeState> result_states;
-    forFilteredNodes(*nodes_configuration, &filter, [&](node_index_t index) {
+    for (node_index_t index :
+         filteredNodesPage(*nodes_configuration,
+                           &filter,
+                           page.get_pointer(),
+                           next_node_index)) {
       thrift::NodeState node_state;
       toNodeState(node_state, index, force);
       result_states.push_back(std::move(node_state));
-    });
+    }
     out->set_states(std::move(result_states));
     out->set_version(
         static_cast<int64_t>(nodes_configuration->getVersion().val()));
+    if (next_node_index.hasValue()) {
+      out->set_next_node_index(next_node_index.value());
+    }
     return std::move(out);
   }
 }
@@ -32,6 +32,16 @@ service AdminAPI extends fb303.FacebookService {
   nodes.NodesConfigResponse getNodesConfig(1: nodes.NodesFilter filter) throws
       (1: exceptions.NodeNotReady notready) (cpp.coroutine);
 
+  /**
+   * Same as getNodesConfig, but only returns the page of the matching nodes
+   * selected by `request.page`. Large clusters should use this to fetch the
+   * config a page at a time instead of in a single response.
+   */
+  nodes.NodesConfigResponse getNodesConfigPage(
+      1: nodes.NodesConfigRequest request) throws
+      (1: exceptions.NodeNotReady notready,
+       2: exceptions.InvalidRequest invalid_request) (cpp.coroutine);
+
   /**
    * Gets the state object for all nodes that matches the supplied NodesFilter.
    * If NodesFilter is empty we will return all nodes. If the filter does not
@@ -39,9 +49,12 @@ service AdminAPI extends fb303.FacebookService {
    * NodesStateResponse object. `force` will force this method to return all the
    * available state even if the node is not fully ready. In this case we will
    * not throw NodeNotReady exception but we will return partial data.
+   * If `request.page` is set, only the state of the nodes in that page is
+   * returned, see NodesPage.
    */
    nodes.NodesStateResponse getNodesState(1: nodes.NodesStateRequest request) throws
-      (1: exceptions.NodeNotReady notready) (cpp.coroutine);
+      (1: exceptions.NodeNotReady notready,
+       2: exceptions.InvalidRequest invalid_request) (cpp.coroutine);
 
   /**
    * Add new nodes to the cluster. The request should contain the spec of each
@@ -64,6 +64,8 @@ enum LogGroupOperation {
   APPENDS = 0, # Appends received by the sequencer
   READS = 1,
   APPENDS_OUT = 2, # Append bytes after sequencer batching
+  APPENDS_UNBATCHED = 3, # Append bytes adaptive sequencer batching passed
+                         # through unbatched
 }
 
 struct LogGroupCustomCountersRequest {
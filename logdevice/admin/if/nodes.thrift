@@ -475,12 +475,38 @@ struct NodesFilter {
   3: optional string location,
 }
 
+/**
+ * Selects a page of the nodes that match a NodesFilter. Nodes are returned in
+ * increasing order of node index.
+ */
+struct NodesPage {
+  /**
+   * Only nodes with an index greater than or equal to this one are returned.
+   * To get the next page, pass the `next_node_index` of the previous response.
+   */
+  1: common.NodeIndex start_node_index = 0,
+  /**
+   * Maximum number of nodes to return. 0 means no limit.
+   */
+  2: i32 max_nodes = 0,
+}
+
+struct NodesConfigRequest {
+  1: optional NodesFilter filter,
+  2: optional NodesPage page,
+}
+
 struct NodesConfigResponse {
   /**
    * This is an empty list if we cannot find any nodes
    */
   1: NodesConfig nodes,
   2: common.unsigned64 version,
+  /**
+   * Set if the request asked for a page and more nodes match the filter. This
+   * is the index of the first node of the next page.
+   */
+  3: optional common.NodeIndex next_node_index,
 }
 
 struct NodesStateResponse {
@@ -489,6 +515,11 @@ struct NodesStateResponse {
    */
   1: NodesState states,
   2: common.unsigned64 version,
+  /**
+   * Set if the request asked for a page and more nodes match the filter. This
+   * is the index of the first node of the next page.
+   */
+  3: optional common.NodeIndex next_node_index,
 }
 
 struct NodesStateRequest {
@@ -498,4 +529,9 @@ struct NodesStateRequest {
    * is not fully ready. We don't throw NodeNotReady exception in this case.
    */
   2: optional bool force (deprecated),
+  /**
+   * If set, only the state of the nodes in this page is computed and
+   * returned.
+   */
+  3: optional NodesPage page,
 }
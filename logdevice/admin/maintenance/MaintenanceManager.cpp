@@ -61,6 +61,16 @@ void MaintenanceManagerDependencies::startSubscription() {
   nodes_config_update_handle_ = std::make_unique<ConfigSubscriptionHandle>(
       processor_->config_->updateableNodesConfiguration()->subscribeToUpdates(
           nc_callback));
+
+  // Register a callback for node state changes in gossip. This callback
+  // will be called on this worker.
+  if (processor_->cluster_state_) {
+    auto cs_callback = [this](node_index_t node, ClusterStateNodeState state) {
+      owner_->onClusterStateUpdated(node, state);
+    };
+    cluster_state_update_handle_ =
+        processor_->cluster_state_->subscribeToUpdates(cs_callback);
+  }
 }
 
 void MaintenanceManagerDependencies::stopSubscription() {
@@ -70,6 +80,12 @@ void MaintenanceManagerDependencies::stopSubscription() {
   el_update_handle_.reset();
   ld_info("Canceling subscription to NodesConfiguration");
   nodes_config_update_handle_.reset();
+  if (cluster_state_update_handle_.has_value()) {
+    ld_info("Canceling subscription to ClusterState");
+    processor_->cluster_state_->unsubscribeFromUpdates(
+        cluster_state_update_handle_.value());
+    cluster_state_update_handle_.reset();
+  }
 }
 
 folly::SemiFuture<SafetyCheckResult>
@@ -363,20 +379,23 @@ MaintenanceManager::getNodeState(node_index_t node) {
 }
 
 folly::SemiFuture<folly::Expected<NodesStateResponse, MaintenanceError>>
-MaintenanceManager::getNodesState(thrift::NodesFilter filter) {
+MaintenanceManager::getNodesState(thrift::NodesFilter filter,
+                                  folly::Optional<thrift::NodesPage> page) {
   return folly::via(this).thenValue(
-      [this, filter = std::move(filter)](
+      [this, filter = std::move(filter), page = std::move(page)](
           auto &&) -> folly::Expected<NodesStateResponse, MaintenanceError> {
         if (shouldStopProcessing()) {
           return folly::makeUnexpected(MaintenanceError(E::SHUTDOWN));
         }
         NodesStateResponse response;
-        std::vector<node_index_t> node_ids;
         std::vector<NodeState> states;
 
-        forFilteredNodes(*nodes_config_, &filter, [&](node_index_t index) {
-          node_ids.push_back(index);
-        });
+        folly::Optional<node_index_t> next_node_index;
+        std::vector<node_index_t> node_ids =
+            filteredNodesPage(*nodes_config_,
+                              &filter,
+                              page.get_pointer(),
+                              next_node_index);
 
         const ClusterState* cluster_state =
             deps_->getProcessor()->cluster_state_.get();
@@ -391,6 +410,9 @@ MaintenanceManager::getNodesState(thrift::NodesFilter filter) {
         response.set_states(std::move(states));
         response.set_version(
             static_cast<int64_t>(nodes_config_->getVersion().val()));
+        if (next_node_index.hasValue()) {
+          response.set_next_node_index(next_node_index.value());
+        }
         return response;
       });
 }
@@ -918,6 +940,22 @@ void MaintenanceManager::onNodesConfigurationUpdated() {
   add([this]() { scheduleRun(); });
 }
 
+void MaintenanceManager::onClusterStateUpdated(node_index_t node,
+                                               ClusterStateNodeState state) {
+  add([this, node, state]() {
+    if (active_shard_workflows_.empty() &&
+        active_sequencer_workflows_.empty()) {
+      // Nothing is waiting on the state of the cluster
+      return;
+    }
+    ld_debug("N%hd is now %s, scheduling a run",
+             node,
+             ClusterState::getNodeStateString(state));
+    STAT_INCR(deps_->getStats(), admin_server.mm_cluster_state_triggered_runs);
+    scheduleRun();
+  });
+}
+
 void MaintenanceManager::onClusterMaintenanceStateUpdate(
     ClusterMaintenanceState state,
     lsn_t version) {
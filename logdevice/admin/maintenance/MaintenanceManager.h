@@ -21,6 +21,7 @@
 #include "logdevice/admin/maintenance/SequencerWorkflow.h"
 #include "logdevice/admin/maintenance/ShardWorkflow.h"
 #include "logdevice/admin/maintenance/types.h"
+#include "logdevice/common/ClusterState.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
 #include "logdevice/common/configuration/nodes/NodesConfiguration.h"
@@ -181,6 +182,11 @@ class MaintenanceManagerDependencies {
   // Subscription handle for NodesConfig update
   std::unique_ptr<ConfigSubscriptionHandle> nodes_config_update_handle_;
 
+  // Subscription handle for node state changes in ClusterState (gossip).
+  // Set only if the processor has a ClusterState.
+  folly::Optional<ClusterState::SubscriptionHandle>
+      cluster_state_update_handle_;
+
   // MaintenanceLogWriter used mainly to remove expired maintenances.
   std::unique_ptr<MaintenanceLogWriter> maintenance_log_writer_;
 
@@ -256,11 +262,13 @@ class MaintenanceManager : public SerialWorkContext {
 
   /*
    * Takes a filter, it will match the nodes, combine the results
-   * and get the state from the maintenance manager.
+   * and get the state from the maintenance manager. If `page` is set, only
+   * the state of the nodes in that page is computed, see filteredNodesPage().
    */
   folly::SemiFuture<
       folly::Expected<thrift::NodesStateResponse, MaintenanceError>>
-  getNodesState(thrift::NodesFilter filter);
+  getNodesState(thrift::NodesFilter filter,
+                folly::Optional<thrift::NodesPage> page = folly::none);
 
   // Getter that returns a SemiFuture with ShardState for a given shard
   folly::SemiFuture<folly::Expected<ShardState, Status>>
@@ -323,6 +331,13 @@ class MaintenanceManager : public SerialWorkContext {
   // Schedules work on this object to call `scheduleRun`
   void onNodesConfigurationUpdated();
 
+  // Subscription callback for a change of the gossip state of a node.
+  // Schedules work on this object to call `scheduleRun` if there are
+  // workflows in progress, since whether they can proceed (e.g. pass safety
+  // checks) may depend on which nodes are alive. Without this, such changes
+  // would only be picked up by the periodic reevaluation.
+  void onClusterStateUpdated(node_index_t node, ClusterStateNodeState state);
+
   // Callback that gets called when there is a EventLogRebuildingSet
   // update. Schedules work on this object to update
   // `event_log_rebuilding_set_` and calls `scheduleRun`
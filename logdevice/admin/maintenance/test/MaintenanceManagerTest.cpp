@@ -1673,6 +1673,49 @@ TEST_F(MaintenanceManagerTest, TestProvisioningNode) {
   // The MM continues normally from here enabling the node.
 }
 
+// A change in the gossip state of a node re-evaluates the workflows in
+// progress without waiting for the periodic reevaluation.
+TEST_F(MaintenanceManagerTest, ClusterStateUpdateTriggersRun) {
+  init();
+  node_index_t node = 18;
+  addNewNode(node);
+  regenerateClusterMaintenanceWrapper();
+
+  EXPECT_CALL(*maintenance_manager_, runShardWorkflows())
+      .WillRepeatedly(Invoke([this]() { return getShardWorkflowResult(); }));
+  EXPECT_CALL(*maintenance_manager_, runSequencerWorkflows())
+      .WillRepeatedly(
+          Invoke([this]() { return getSequencerWorkflowResult(); }));
+
+  auto N18S0 = ShardID(18, 0);
+  setShardWorkflowResult({
+      {N18S0,
+       {MaintenanceStatus::AWAITING_NODE_PROVISIONING,
+        membership::StorageStateTransition::Count /* doesn't matter */}},
+  });
+  setSequencerWorkflowResult(SeqWfResult());
+
+  maintenance_manager_->onClusterMaintenanceStateUpdate(cms_, lsn_t(1));
+  maintenance_manager_->onEventLogRebuildingSetUpdate(set_, lsn_t(1));
+  runExecutor();
+  verifyMMStatus(MaintenanceManager::MMStatus::AWAITING_STATE_CHANGE);
+
+  setShardWorkflowResult({
+      {N18S0,
+       {MaintenanceStatus::AWAITING_NODES_CONFIG_CHANGES,
+        membership::StorageStateTransition::ENABLING_READ}},
+  });
+  EXPECT_CALL(
+      *maintenance_manager_, getExpectedStorageStateTransition(::testing::_))
+      .WillRepeatedly(Invoke([this](ShardID shard) {
+        return expected_storage_state_transition_[shard];
+      }));
+  maintenance_manager_->onClusterStateUpdated(
+      node, ClusterStateNodeState::FULLY_STARTED);
+  runExecutor();
+  verifyMMStatus(MaintenanceManager::MMStatus::AWAITING_NODES_CONFIG_UPDATE);
+}
+
 TEST_F(MaintenanceManagerTest, TestBootstrappingFlag) {
   init();
 
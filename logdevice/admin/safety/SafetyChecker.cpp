@@ -263,6 +263,10 @@ SafetyChecker::performSafetyCheck(
 
         const auto nodes_config = processor_->getNodesConfiguration();
         ClusterState* cluster_state = processor_->cluster_state_.get();
+        // Shared by all logs checked below, so that every distinct storage
+        // set is only evaluated once, whichever batch it is first seen in.
+        auto availability_cache =
+            std::make_shared<safety::ReadWriteAvailabilityCache>();
 
         // Check impact on capacity
         Impact capacity_impact;
@@ -348,7 +352,8 @@ SafetyChecker::performSafetyCheck(
                                                   abort_on_error_,
                                                   error_sample_size_,
                                                   nodes_config,
-                                                  cluster_state);
+                                                  cluster_state,
+                                                  availability_cache.get());
           if (impact.hasError()) {
             // The operation failed. Possibly because we don't have metadata for
             // this log-id. This is critical.
@@ -418,7 +423,8 @@ SafetyChecker::performSafetyCheck(
                                          safety_margin,
                                          this,
                                          cfg,
-                                         cluster_state](auto&&) {
+                                         cluster_state,
+                                         availability_cache](auto&&) {
                                return safety::checkImpactOnLogs(
                                    mbatch,
                                    metadata,
@@ -431,7 +437,8 @@ SafetyChecker::performSafetyCheck(
                                    abort_on_error_,
                                    error_sample_size_,
                                    processor_->getNodesConfiguration(),
-                                   cluster_state);
+                                   cluster_state,
+                                   availability_cache.get());
                              }));
           --chunks;
         }
@@ -451,13 +458,17 @@ SafetyChecker::performSafetyCheck(
                      return Impact::merge(
                          std::move(acc), result, error_sample_size_);
                    })
-            .thenValue([start_time](folly::Expected<Impact, Status> result) {
+            .thenValue([start_time, availability_cache](
+                           folly::Expected<Impact, Status> result) {
               std::chrono::seconds total_time =
                   std::chrono::duration_cast<std::chrono::seconds>(
                       std::chrono::steady_clock::now() - start_time);
               if (result.hasValue()) {
-                ld_info(
-                    "Sending %lu error samples", result->logs_affected.size());
+                ld_info("Sending %lu error samples. Evaluated %zu distinct "
+                        "storage sets for %zu logs.",
+                        result->logs_affected.size(),
+                        availability_cache->size(),
+                        result->total_logs_checked);
                 result->total_duration = total_time;
               }
               return result;
@@ -7,6 +7,8 @@
  */
 #include "logdevice/admin/safety/SafetyCheckerUtils.h"
 
+#include <folly/hash/Hash.h>
+
 #include "logdevice/common/EpochMetaData.h"
 #include "logdevice/common/FailureDomainNodeSet.h"
 
@@ -14,6 +16,20 @@ using namespace facebook::logdevice::configuration;
 
 namespace facebook { namespace logdevice { namespace safety {
 
+size_t ReadWriteAvailabilityKey::Hash::
+operator()(const ReadWriteAvailabilityKey& key) const {
+  size_t h = std::hash<bool>()(key.require_fully_started);
+  for (const ShardID& shard : key.storage_set) {
+    h = folly::hash::hash_combine(h, ShardID::Hash()(shard));
+  }
+  for (const auto& scope_replication :
+       key.replication.getDistinctReplicationFactors()) {
+    h = folly::hash::hash_combine(
+        h, scope_replication.first, scope_replication.second);
+  }
+  return h;
+}
+
 folly::Expected<Impact, Status> checkImpactOnLogs(
     const std::vector<logid_t>& log_ids,
     const std::shared_ptr<LogMetaDataFetcher::Results>& metadata,
@@ -27,11 +43,16 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     size_t error_sample_size,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache) {
   int impact_result_all = 0;
   std::vector<Impact::ImpactOnEpoch> affected_logs_sample;
   size_t logs_done = 0;
   bool internal_logs_affected = false;
+  ReadWriteAvailabilityCache local_cache;
+  if (!cache) {
+    cache = &local_cache;
+  }
 
   // Check other logs
   for (logid_t log_id : log_ids) {
@@ -45,7 +66,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
                                    target_storage_state,
                                    safety_margin,
                                    nodes_config,
-                                   cluster_state);
+                                   cluster_state,
+                                   cache);
     logs_done++;
     if (result.hasError()) {
       // The operation failed. Possibly because we don't have metadata for
@@ -88,7 +110,8 @@ folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache) {
   ld_assert(metadata_cache);
   if (metadata_cache->find(log_id) == metadata_cache->end()) {
     // We cannot find the epoch metadata for this log. This can have multiple
@@ -136,16 +159,26 @@ folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     bool safe_writes;
     bool safe_reads;
 
-    std::tie(safe_reads, safe_writes) =
-        checkReadWriteAvailablity(shard_status,
-                                  op_shards,
-                                  epoch_metadata.shards,
-                                  target_storage_state,
-                                  epoch_metadata.replication,
-                                  safety_margin,
-                                  nodes_config,
-                                  cluster_state,
-                                  require_fully_started);
+    auto check = [&] {
+      return checkReadWriteAvailablity(shard_status,
+                                       op_shards,
+                                       epoch_metadata.shards,
+                                       target_storage_state,
+                                       epoch_metadata.replication,
+                                       safety_margin,
+                                       nodes_config,
+                                       cluster_state,
+                                       require_fully_started);
+    };
+    if (cache) {
+      std::tie(safe_reads, safe_writes) = cache->getOrCompute(
+          ReadWriteAvailabilityKey{epoch_metadata.shards,
+                                   epoch_metadata.replication,
+                                   require_fully_started},
+          check);
+    } else {
+      std::tie(safe_reads, safe_writes) = check();
+    }
 
     if (safe_writes && safe_reads) {
       continue;
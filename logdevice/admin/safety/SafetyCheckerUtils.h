@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <folly/container/F14Set.h>
 
 #include "logdevice/admin/safety/LogMetaDataFetcher.h"
@@ -19,8 +21,73 @@
 
 namespace facebook { namespace logdevice { namespace safety {
 
+/**
+ * The outcome of checkReadWriteAvailablity() only depends on the storage set,
+ * the replication property and whether nodes are required to be fully started
+ * (the other inputs are the same for the whole safety check). Since most logs
+ * and epochs share one of a few storage sets, the outcome for each of them is
+ * kept in a ReadWriteAvailabilityCache and evaluated only once per check.
+ */
+struct ReadWriteAvailabilityKey {
+  StorageSet storage_set;
+  ReplicationProperty replication;
+  bool require_fully_started;
+
+  bool operator==(const ReadWriteAvailabilityKey& other) const {
+    return require_fully_started == other.require_fully_started &&
+        storage_set == other.storage_set && replication == other.replication;
+  }
+
+  struct Hash {
+    size_t operator()(const ReadWriteAvailabilityKey& key) const;
+  };
+};
+
+/**
+ * (safe_for_reads, safe_for_writes) for each ReadWriteAvailabilityKey.
+ * Thread-safe, so that all the batches of logs of a safety check, which are
+ * evaluated in parallel, can share it.
+ */
+class ReadWriteAvailabilityCache {
+ public:
+  /**
+   * Returns the cached outcome for key, calling check() to compute it if
+   * there is none yet.
+   */
+  template <typename F>
+  std::pair<bool, bool> getOrCompute(const ReadWriteAvailabilityKey& key,
+                                     F&& check) {
+    {
+      auto map = map_.rlock();
+      auto it = map->find(key);
+      if (it != map->end()) {
+        return it->second;
+      }
+    }
+    // Computed without holding the lock. If another thread computes it
+    // concurrently, both get the same outcome.
+    auto result = check();
+    map_.wlock()->emplace(key, result);
+    return result;
+  }
+
+  // Number of distinct storage sets evaluated
+  size_t size() const {
+    return map_.rlock()->size();
+  }
+
+ private:
+  folly::Synchronized<folly::F14FastMap<ReadWriteAvailabilityKey,
+                                        std::pair<bool, bool>,
+                                        ReadWriteAvailabilityKey::Hash>>
+      map_;
+};
+
 /**
  * Performs safety check on given logs
+ *
+ * @param cache  If not null, shared with other checkImpactOnLogs() calls of
+ *               the same safety check, see checkImpactOnLog().
  */
 folly::Expected<Impact, Status> checkImpactOnLogs(
     const std::vector<logid_t>& log_ids,
@@ -35,9 +102,14 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     size_t error_sample_size,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache = nullptr);
 /**
  * Perform safety check on a single log.
+ *
+ * @param cache  If not null, used to look up and store the availability of
+ *               the storage sets of the log's epochs. Must only be shared
+ *               between checks with the same other arguments.
  */
 folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     logid_t log_id,
@@ -49,7 +121,8 @@ folly::Expected<Impact::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache = nullptr);
 
 /**
  * Checks whether a node is alive in the FailureDetector (gossip) or not.
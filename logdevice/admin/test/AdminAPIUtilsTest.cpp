@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 
 #include "logdevice/admin/Conv.h"
+#include "logdevice/common/test/NodesConfigurationTestUtil.h"
 
 using namespace facebook::logdevice;
 using namespace facebook::logdevice::configuration::nodes;
@@ -212,3 +213,39 @@ TEST(AdminAPIUtilsTest, FillNodeConfigPopulatesAllFields) {
 
   EXPECT_EQ(expected, actual);
 }
+
+TEST(AdminAPIUtilsTest, FilteredNodesPage) {
+  // N1, N2, N7, N9, N11 and N13
+  auto nodes_configuration = NodesConfigurationTestUtil::provisionNodes();
+  folly::Optional<node_index_t> next;
+
+  // Without a page all matching nodes are returned, sorted.
+  EXPECT_EQ(std::vector<node_index_t>({1, 2, 7, 9, 11, 13}),
+            filteredNodesPage(*nodes_configuration, nullptr, nullptr, next));
+  EXPECT_FALSE(next.hasValue());
+
+  thrift::NodesPage page;
+  page.set_max_nodes(4);
+  EXPECT_EQ(std::vector<node_index_t>({1, 2, 7, 9}),
+            filteredNodesPage(*nodes_configuration, nullptr, &page, next));
+  ASSERT_TRUE(next.hasValue());
+  EXPECT_EQ(11, next.value());
+
+  page.set_start_node_index(next.value());
+  EXPECT_EQ(std::vector<node_index_t>({11, 13}),
+            filteredNodesPage(*nodes_configuration, nullptr, &page, next));
+  EXPECT_FALSE(next.hasValue());
+
+  // Pages only contain nodes that match the filter.
+  thrift::NodesFilter filter;
+  filter.set_role(thrift::Role::SEQUENCER);
+  page.set_start_node_index(0);
+  page.set_max_nodes(1);
+  EXPECT_EQ(std::vector<node_index_t>({1}),
+            filteredNodesPage(*nodes_configuration, &filter, &page, next));
+  ASSERT_TRUE(next.hasValue());
+  EXPECT_EQ(7, next.value());
+
+  page.set_max_nodes(-1);
+  EXPECT_THROW(validateNodesPage(page), thrift::InvalidRequest);
+}
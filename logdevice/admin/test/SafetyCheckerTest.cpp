@@ -9,6 +9,8 @@
 
 #include <gtest/gtest.h>
 
+#include "logdevice/admin/safety/SafetyCheckerUtils.h"
+
 using namespace facebook::logdevice;
 
 TEST(SafetyCheckerTest, Parse) {
@@ -21,3 +23,37 @@ TEST(SafetyCheckerTest, Parse) {
   ASSERT_EQ(2, safety_margin2[NodeLocationScope::RACK]);
   ASSERT_EQ(5, safety_margin2[NodeLocationScope::NODE]);
 }
+
+TEST(SafetyCheckerTest, ReadWriteAvailabilityCache) {
+  using safety::ReadWriteAvailabilityKey;
+  const StorageSet storage_set{ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+  const ReplicationProperty rack2({{NodeLocationScope::RACK, 2}});
+  const ReplicationProperty node2({{NodeLocationScope::NODE, 2}});
+
+  safety::ReadWriteAvailabilityCache cache;
+  int checks = 0;
+  auto check = [&] {
+    ++checks;
+    return std::make_pair(true, false);
+  };
+
+  EXPECT_EQ(std::make_pair(true, false),
+            cache.getOrCompute(
+                ReadWriteAvailabilityKey{storage_set, rack2, true}, check));
+  EXPECT_EQ(1, checks);
+
+  // same storage set and replication, e.g. another log using the same nodeset
+  EXPECT_EQ(std::make_pair(true, false),
+            cache.getOrCompute(
+                ReadWriteAvailabilityKey{storage_set, rack2, true}, check));
+  EXPECT_EQ(1, checks);
+
+  cache.getOrCompute(ReadWriteAvailabilityKey{storage_set, node2, true}, check);
+  cache.getOrCompute(
+      ReadWriteAvailabilityKey{storage_set, rack2, false}, check);
+  cache.getOrCompute(ReadWriteAvailabilityKey{
+                         StorageSet{ShardID(1, 0), ShardID(2, 0)}, rack2, true},
+                     check);
+  EXPECT_EQ(4, checks);
+  EXPECT_EQ(4, cache.size());
+}
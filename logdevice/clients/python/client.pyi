@@ -7,7 +7,17 @@
 # LICENSE file in the root directory of this source tree.
 
 from enum import Enum, auto
-from typing import Any, AnyStr, Dict, Iterator, List, Optional, Tuple, TypeVar
+from typing import (
+    Any,
+    AnyStr,
+    Dict,
+    Iterable,
+    Iterator,
+    List,
+    Optional,
+    Tuple,
+    TypeVar,
+)
 
 # Convenience
 Attrs = Dict[str, Any]
@@ -23,9 +33,20 @@ class LogGroup:
 class Directory:
     pass  # TODO flesh out
 
+class RecordBatch:
+    def __len__(self) -> int: ...
+    gap: Any
+    logids: memoryview
+    lsns: memoryview
+    timestamps: memoryview
+    payloads: List[memoryview]
+    payload_offsets: memoryview
+    payload_data: memoryview
+
 class Reader:
     def __iter__(self) -> Iterator: ...
     def __next__(self) -> Tuple[Any, Any]: ...
+    def read_batch(self, max_records: int) -> Optional[RecordBatch]: ...
     def stop_iteration(self) -> bool: ...
     def start_reading(self, logid: int, from_: lsn_t, until_: lsn_t) -> bool: ...
     def stop_reading(self, logid: int) -> bool: ...
@@ -44,6 +65,7 @@ class Client:
         csid: Optional[str] = None,
     ) -> None: ...
     def append(self, logid: int, data: AnyStr) -> lsn_t: ...
+    def append_batch(self, logid: int, data: Iterable[AnyStr]) -> List[lsn_t]: ...
     def create_reader(self, max_logs: int) -> Reader: ...
     def data_size(self, logid: int, start_sec: float, end_sec: float) -> int: ...
     def find_key(self, logid: int, key: str) -> Tuple[int, int]: ...
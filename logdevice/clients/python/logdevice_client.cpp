@@ -7,6 +7,7 @@
  */
 
 #include <cmath>
+#include <mutex>
 #include <type_traits>
 
 #include <boost/format.hpp>
@@ -24,6 +25,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/toString.h"
 #include "logdevice/common/util.h"
+#include "logdevice/include/BufferedWriter.h"
 #include "logdevice/include/Client.h"
 #include "logdevice/include/debug.h"
 
@@ -290,6 +292,117 @@ lsn_t logdevice_append(Client& self, logid_t logid, object data) {
   throw std::runtime_error("impossible, the line above always throws!");
 }
 
+namespace {
+// Collects the outcome of every append of an append_batch() call; the
+// context of each append is its index in the batch.
+class AppendBatchCallback : public BufferedWriter::AppendCallback {
+ public:
+  explicit AppendBatchCallback(size_t count)
+      : lsns_(count, LSN_INVALID), statuses_(count, E::UNKNOWN) {}
+
+  void onSuccess(logid_t,
+                 ContextSet contexts,
+                 const DataRecordAttributes& attrs) override {
+    complete(contexts, E::OK, attrs.lsn);
+  }
+
+  void onFailure(logid_t, ContextSet contexts, Status status) override {
+    complete(contexts, status, LSN_INVALID);
+  }
+
+  // for appends that BufferedWriter rejected right away
+  void onRejected(size_t idx, Status status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statuses_[idx] = status;
+    if (++done_ == lsns_.size()) {
+      sem_.post();
+    }
+  }
+
+  void wait() {
+    sem_.wait();
+  }
+
+  const std::vector<lsn_t>& lsns() const {
+    return lsns_;
+  }
+  const std::vector<Status>& statuses() const {
+    return statuses_;
+  }
+
+ private:
+  void complete(const ContextSet& contexts, Status status, lsn_t lsn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& context : contexts) {
+      size_t idx = reinterpret_cast<size_t>(context.first);
+      statuses_[idx] = status;
+      lsns_[idx] = lsn;
+    }
+    done_ += contexts.size();
+    if (done_ == lsns_.size()) {
+      sem_.post();
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<lsn_t> lsns_;
+  std::vector<Status> statuses_;
+  size_t done_{0};
+  Semaphore sem_;
+};
+} // namespace
+
+list logdevice_append_batch(Client& self, logid_t logid, object data) {
+  std::vector<std::string> payloads;
+  stl_input_iterator<object> begin(data), end;
+  std::for_each(begin, end, [&](object payload) {
+    payloads.push_back(extract_string(payload, "data"));
+  });
+  if (payloads.empty()) {
+    return list();
+  }
+
+  AppendBatchCallback cb(payloads.size());
+  {
+    gil_release_and_guard guard;
+    // The Python object keeps the client alive for the duration of the call,
+    // and the writer is gone before we return.
+    std::shared_ptr<Client> client(&self, [](Client*) {});
+    std::unique_ptr<BufferedWriter> writer =
+        BufferedWriter::create(client, &cb, BufferedWriter::Options());
+
+    std::vector<BufferedWriter::Append> appends;
+    appends.reserve(payloads.size());
+    using Context = BufferedWriter::AppendCallback::Context;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      appends.emplace_back(
+          logid, std::move(payloads[i]), reinterpret_cast<Context>(i));
+    }
+    std::vector<Status> rv = writer->append(std::move(appends));
+    for (size_t i = 0; i < rv.size(); ++i) {
+      if (rv[i] != E::OK) {
+        cb.onRejected(i, rv[i]);
+      }
+    }
+    writer->flushAll();
+    cb.wait();
+  }
+
+  list lsns;
+  Status first_failure = E::OK;
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    lsns.append(cb.lsns()[i]);
+    if (cb.statuses()[i] != E::OK && first_failure == E::OK) {
+      first_failure = cb.statuses()[i];
+    }
+  }
+  if (first_failure != E::OK) {
+    err = first_failure;
+    throw_logdevice_exception(lsns);
+  }
+  return lsns;
+}
+
 lsn_t logdevice_find_time(Client& self, logid_t logid, double seconds) {
   auto ts = std::chrono::milliseconds(lround(seconds * 1000));
   lsn_t lsn;
@@ -818,6 +931,23 @@ Append a record to log LOGID containing DATA.
 
 DATA can be a bytes object, which is appended as-is,
 or a str/Unicode object which are appended as utf-8 encoded data.
+)DOC")
+
+      .def("append_batch",
+           &logdevice_append_batch,
+           args("self", "logid", "data"),
+           R"DOC(
+Append every payload in the iterable DATA to log LOGID, and return the list of
+their LSNs, in order.
+
+The payloads are handed to a BufferedWriter without holding the GIL, so they
+are packed into as few records as the maximum payload size allows, and
+several records are in flight at once. Payloads packed together share an LSN;
+readers unpack them transparently. Payloads are converted like for append().
+
+Blocks until all appends complete. If any failed, raises a LogDevice error
+for the first failure, with the list of LSNs as its extra argument (LSN_INVALID
+for the payloads that weren't appended).
 )DOC")
 
       .def("find_time",
@@ -1113,6 +1243,7 @@ For example, all these are acceptable
   // register object wrappers from other components
   register_logdevice_reader();
   register_logdevice_record();
+  register_logdevice_record_batch();
 
   enum_<dbg::Level>("LoggingLevel")
       .value("NONE", dbg::Level::NONE)
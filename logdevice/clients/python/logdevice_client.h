@@ -25,3 +25,4 @@ boost::python::object
 // multiple C++ modules in the single end object requires registration
 void register_logdevice_reader();
 void register_logdevice_record();
+void register_logdevice_record_batch();
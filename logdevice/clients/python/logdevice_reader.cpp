@@ -13,6 +13,7 @@
 #include <boost/make_shared.hpp>
 
 #include "logdevice/clients/python/logdevice_client.h"
+#include "logdevice/clients/python/logdevice_record_batch.h"
 #include "logdevice/clients/python/util/util.h"
 #include "logdevice/include/Client.h"
 
@@ -98,6 +99,49 @@ class ReaderWrapper : boost::noncopyable {
     throw std::runtime_error("unpossible, the line above always throws!");
   }
 
+  /**
+   * Read up to max_records data records with a single Reader::read() call,
+   * without holding the GIL, and return them as a RecordBatch. The batch
+   * holds either data records or a single gap. Returns None once there is
+   * nothing left to read or stop_iteration() was called.
+   */
+  boost::python::object read_batch(size_t max_records) {
+    if (max_records == 0) {
+      throw_python_exception(PyExc_ValueError, "max_records must be positive");
+    }
+    std::vector<std::unique_ptr<DataRecord>> records;
+    GapRecord gap;
+
+    while (keep_reading_ && reader_->isReadingAny()) {
+      if (PyErr_CheckSignals() != 0)
+        throw_python_exception();
+
+      ssize_t n = 0;
+      boost::shared_ptr<RecordBatch> batch;
+      {
+        gil_release_and_guard guard;
+        n = reader_->read(max_records, &records, &gap);
+        if (n > 0) {
+          batch = boost::make_shared<RecordBatch>(std::move(records), nullptr);
+        } else if (n < 0 && err == E::GAP) {
+          batch = boost::make_shared<RecordBatch>(
+              std::move(records), std::make_unique<GapRecord>(gap));
+        }
+      }
+
+      if (batch) {
+        return boost::python::object(batch);
+      }
+      if (n < 0) {
+        throw_logdevice_exception();
+        throw std::runtime_error("unpossible, the line above always throws!");
+      }
+      // Timed out without records; check whether we should stop, and go
+      // back to waiting.
+    }
+    return boost::python::object();
+  }
+
   bool stop_iteration() {
     keep_reading_ = false;
     return true; // yes, we did stop as you requested
@@ -194,6 +238,19 @@ Implement the 'next' operation from the Python iterator protocol.
 
 This will read until the 'stop_iteration()' method is called
 from Python, or a record (data or gap) can be returned.
+)DOC")
+
+      .def("read_batch",
+           &ReaderWrapper::read_batch,
+           args("max_records"),
+           R"DOC(
+Read up to MAX_RECORDS data records at once and return them as a RecordBatch,
+with zero-copy access to their payloads and columns. The GIL is released while
+waiting for records.
+
+A batch holds either data records, or a gap (see RecordBatch.gap). Returns
+None once stop_iteration() was called or no log is being read anymore.
+Much faster than iterating one record at a time when reading many records.
 )DOC")
 
       .def("stop_iteration",
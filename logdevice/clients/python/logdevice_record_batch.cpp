@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/clients/python/logdevice_record_batch.h"
+
+#include <new>
+
+#include <boost/make_shared.hpp>
+
+#include "logdevice/clients/python/util/util.h"
+
+using namespace boost::python;
+using namespace facebook::logdevice;
+
+namespace {
+
+// Minimal Python type exporting a read-only, one-dimensional buffer over
+// memory owned by a C++ object. We wrap it in a memoryview right away; the
+// memoryview holds on to it, and it holds on to the owner.
+struct BufferView {
+  PyObject_HEAD
+  std::shared_ptr<const void> owner;
+  const void* buf;
+  Py_ssize_t shape;
+  Py_ssize_t itemsize;
+  const char* format;
+};
+
+int buffer_view_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "RecordBatch buffers are read-only");
+    view->obj = nullptr;
+    return -1;
+  }
+  auto* bv = reinterpret_cast<BufferView*>(self);
+  static char empty = 0;
+  view->obj = self;
+  Py_INCREF(self);
+  view->buf = bv->buf ? const_cast<void*>(bv->buf) : &empty;
+  view->len = bv->shape * bv->itemsize;
+  view->readonly = 1;
+  view->itemsize = bv->itemsize;
+  view->format =
+      (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(bv->format)
+                                             : nullptr;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &bv->shape : nullptr;
+  view->strides =
+      (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &bv->itemsize : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+  return 0;
+}
+
+void buffer_view_dealloc(PyObject* self) {
+  reinterpret_cast<BufferView*>(self)->owner.~shared_ptr();
+  Py_TYPE(self)->tp_free(self);
+}
+
+PyTypeObject* buffer_view_type() {
+  static PyBufferProcs procs;
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+  static bool ready = [] {
+    procs.bf_getbuffer = buffer_view_getbuffer;
+    type.tp_name = "logdevice.client._BufferView";
+    type.tp_basicsize = sizeof(BufferView);
+    type.tp_dealloc = buffer_view_dealloc;
+    type.tp_as_buffer = &procs;
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+#if PY_MAJOR_VERSION < 3
+    type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+    return PyType_Ready(&type) == 0;
+  }();
+  if (!ready) {
+    throw_python_exception();
+  }
+  return &type;
+}
+
+object make_memoryview(std::shared_ptr<const void> owner,
+                       const void* buf,
+                       size_t count,
+                       size_t itemsize,
+                       const char* format) {
+  PyTypeObject* type = buffer_view_type();
+  PyObject* obj = type->tp_alloc(type, 0);
+  if (!obj) {
+    throw_python_exception();
+  }
+  auto* bv = reinterpret_cast<BufferView*>(obj);
+  new (&bv->owner) std::shared_ptr<const void>(std::move(owner));
+  bv->buf = buf;
+  bv->shape = count;
+  bv->itemsize = itemsize;
+  bv->format = format;
+
+  PyObject* view = PyMemoryView_FromObject(obj);
+  Py_DECREF(obj);
+  if (!view) {
+    throw_python_exception();
+  }
+  return object(handle<>(view));
+}
+
+template <typename T>
+object column_view(const std::shared_ptr<const void>& owner,
+                   const std::vector<T>& column,
+                   const char* format) {
+  static_assert(sizeof(T) == 8, "format codes below assume 64-bit columns");
+  return make_memoryview(
+      owner, column.data(), column.size(), sizeof(T), format);
+}
+
+} // namespace
+
+RecordBatch::RecordBatch(std::vector<std::unique_ptr<DataRecord>> records,
+                         std::unique_ptr<GapRecord> gap)
+    : data_(std::make_shared<Data>()), gap_(std::move(gap)) {
+  data_->records = std::move(records);
+  const size_t n = data_->records.size();
+  data_->logids.reserve(n);
+  data_->lsns.reserve(n);
+  data_->timestamps.reserve(n);
+  for (const auto& record : data_->records) {
+    data_->logids.push_back(record->logid.val());
+    data_->lsns.push_back(record->attrs.lsn);
+    data_->timestamps.push_back(record->attrs.timestamp.count());
+  }
+}
+
+size_t RecordBatch::size() const {
+  return data_->records.size();
+}
+
+object RecordBatch::gap() const {
+  if (!gap_) {
+    return object();
+  }
+  return object(boost::make_shared<GapRecord>(*gap_));
+}
+
+object RecordBatch::logids() const {
+  return column_view(data_, data_->logids, "Q");
+}
+
+object RecordBatch::lsns() const {
+  return column_view(data_, data_->lsns, "Q");
+}
+
+object RecordBatch::timestamps() const {
+  return column_view(data_, data_->timestamps, "q");
+}
+
+list RecordBatch::payloads() const {
+  list out;
+  for (const auto& record : data_->records) {
+    out.append(make_memoryview(
+        data_, record->payload.data(), record->payload.size(), 1, "B"));
+  }
+  return out;
+}
+
+void RecordBatch::buildPayloadColumn() {
+  if (!data_->payload_offsets.empty()) {
+    return;
+  }
+  size_t total = 0;
+  for (const auto& record : data_->records) {
+    total += record->payload.size();
+  }
+  data_->payload_data.reserve(total);
+  data_->payload_offsets.reserve(data_->records.size() + 1);
+  data_->payload_offsets.push_back(0);
+  for (const auto& record : data_->records) {
+    data_->payload_data.append(
+        static_cast<const char*>(record->payload.data()),
+        record->payload.size());
+    data_->payload_offsets.push_back(data_->payload_data.size());
+  }
+}
+
+object RecordBatch::payload_offsets() {
+  buildPayloadColumn();
+  return column_view(data_, data_->payload_offsets, "q");
+}
+
+object RecordBatch::payload_data() {
+  buildPayloadColumn();
+  return make_memoryview(data_,
+                         data_->payload_data.data(),
+                         data_->payload_data.size(),
+                         1,
+                         "B");
+}
+
+void register_logdevice_record_batch() {
+  class_<RecordBatch, boost::shared_ptr<RecordBatch>, boost::noncopyable>(
+      "RecordBatch",
+      R"DOC(
+A batch of data records returned by Reader.read_batch().
+
+Columns are read-only memoryviews over buffers owned by the batch, so no
+per-record Python objects are created: logids and lsns are unsigned 64-bit
+integers, timestamps are signed 64-bit milliseconds since the epoch.
+payload_offsets and payload_data form an Arrow-style binary column, and can be
+handed to e.g. pyarrow.Array.from_buffers() or numpy.frombuffer() without
+copying. payloads is a list of memoryviews over the individual payloads.
+The memoryviews stay valid after the batch is garbage collected.
+
+If the batch ended at a gap, gap is the GapRecord (and the batch may hold no
+records); otherwise it is None.
+)DOC",
+      no_init)
+      .def("__len__", &RecordBatch::size)
+      .add_property("gap", &RecordBatch::gap)
+      .add_property("logids", &RecordBatch::logids)
+      .add_property("lsns", &RecordBatch::lsns)
+      .add_property("timestamps", &RecordBatch::timestamps)
+      .add_property("payloads", &RecordBatch::payloads)
+      .add_property("payload_offsets", &RecordBatch::payload_offsets)
+      .add_property("payload_data", &RecordBatch::payload_data);
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/python.hpp>
+
+#include "logdevice/include/Record.h"
+
+// A batch of data records returned by Reader.read_batch(), exposed to Python
+// without copying payloads into Python objects. Per-record columns (log ids,
+// LSNs, timestamps) and payloads are handed out as read-only memoryviews over
+// buffers owned by the batch; the memoryviews keep these buffers alive even
+// after the batch itself is gone.
+class RecordBatch {
+ public:
+  // Builds the columns. Doesn't need the GIL.
+  RecordBatch(
+      std::vector<std::unique_ptr<facebook::logdevice::DataRecord>> records,
+      std::unique_ptr<facebook::logdevice::GapRecord> gap);
+
+  size_t size() const;
+
+  // GapRecord that ended the batch, or None
+  boost::python::object gap() const;
+
+  boost::python::object logids() const;
+  boost::python::object lsns() const;
+  // milliseconds since the epoch
+  boost::python::object timestamps() const;
+
+  // list with a memoryview of every record's payload
+  boost::python::list payloads() const;
+
+  // Arrow-style binary column: payload i is
+  // payload_data[payload_offsets[i]:payload_offsets[i + 1]]. Built on first
+  // use, with one copy of every payload.
+  boost::python::object payload_offsets();
+  boost::python::object payload_data();
+
+ private:
+  struct Data {
+    std::vector<std::unique_ptr<facebook::logdevice::DataRecord>> records;
+    std::vector<uint64_t> logids;
+    std::vector<uint64_t> lsns;
+    std::vector<int64_t> timestamps;
+    std::vector<int64_t> payload_offsets;
+    std::string payload_data;
+  };
+
+  void buildPayloadColumn();
+
+  std::shared_ptr<Data> data_;
+  std::shared_ptr<facebook::logdevice::GapRecord> gap_;
+};
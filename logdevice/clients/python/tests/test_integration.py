@@ -124,6 +124,57 @@ class LogDeviceIntegrationTest(TestCase):
                 nread += 1
         self.assertEqual(NWRITES, nread)
 
+    def test_append_batch(self):
+        """append_batch() returns one LSN per payload, and the payloads can
+        be read back in order."""
+        client = self.client()
+        logid = 1
+        payloads = [("payload %d" % i).encode() for i in range(100)]
+        lsns = client.append_batch(logid, payloads)
+        self.assertEqual(len(payloads), len(lsns))
+        self.assertEqual(sorted(lsns), lsns)
+        self.assertEqual([], client.append_batch(logid, []))
+
+        reader = client.create_reader(1)
+        reader.start_reading(logid, lsns[0], lsns[-1])
+        read = [data.payload for data, _ in reader if data is not None]
+        self.assertEqual(payloads, read)
+
+    def test_read_batch(self):
+        """read_batch() returns the records as zero-copy columns."""
+        NWRITES = 50
+        logid = 1
+        client = self.client()
+        payloads = [("record %d" % i).encode() for i in range(NWRITES)]
+        lsns = [client.append(logid, payload) for payload in payloads]
+
+        reader = client.create_reader(1)
+        reader.start_reading(logid, lsns[0], lsns[-1])
+
+        read_lsns = []
+        read_payloads = []
+        columnar_payloads = []
+        while True:
+            batch = reader.read_batch(16)
+            if batch is None:
+                break
+            if batch.gap is not None:
+                self.assertEqual(0, len(batch))
+                continue
+            self.assertLessEqual(len(batch), 16)
+            self.assertEqual([logid] * len(batch), batch.logids.tolist())
+            read_lsns += batch.lsns.tolist()
+            read_payloads += [bytes(p) for p in batch.payloads]
+            offsets = batch.payload_offsets.tolist()
+            data = batch.payload_data
+            columnar_payloads += [
+                bytes(data[offsets[i] : offsets[i + 1]]) for i in range(len(batch))
+            ]
+
+        self.assertEqual(lsns, read_lsns)
+        self.assertEqual(payloads, read_payloads)
+        self.assertEqual(payloads, columnar_payloads)
+
     def test_is_log_empty(self):
         client = self.client()
         client.append(1, "test")
@@ -74,7 +74,11 @@ typedef AdminCommandTable<shard_index_t,              /* Shard */
                           int64_t,  /* Read shaping - current meter level */
                           std::string,                /* Client Session ID */
                           read_stream_id_t::raw_type, /* Read stream ID*/
-                          size_t                      /* send buf occupancy */
+                          size_t,                     /* send buf occupancy */
+                          size_t, /* Adaptive batch size (bytes) */
+                          double, /* Drain rate (bytes/s) */
+                          std::string, /* Wait state */
+                          int64_t      /* Stalled ms */
                           >
     InfoReadersTable;
 
@@ -145,7 +149,11 @@ typedef AdminCommandTable<uint32_t,                  /* Shard id */
                           uint64_t,    /* Read buffer bytes */
                           uint64_t,    /* Records in flight */
                           std::string, /* Read pointer */
-                          double       /* Progress */
+                          double,      /* Progress */
+                          int64_t,     /* Bytes total */
+                          int64_t,     /* Bytes remaining */
+                          double,      /* Bytes per sec */
+                          int64_t      /* ETA seconds */
                           >
     InfoRebuildingShardsTable;
 
@@ -171,7 +179,10 @@ typedef AdminCommandTable<int,                       /* Shard */
                           std::string,               /* Append Dirtied By */
                           std::string,               /* Rebuild Dirtied By */
                           bool,                      /* Under Replicated */
-                          uint64_t /* Approx. Obsolete Bytes */
+                          std::string,               /* Compaction */
+                          uint64_t, /* Compaction Bytes Filtered */
+                          std::string, /* Compaction Rate Limit */
+                          uint64_t     /* Approx. Obsolete Bytes */
                           >
     InfoPartitionsTable;
 
@@ -393,6 +404,39 @@ typedef AdminCommandTable<int,                       /* Stats NodeID */
                           >
     InfoAppendOutliersTable;
 
+typedef AdminCommandTable<logid_t,                  /* Log ID */
+                          double,                   /* Appends/s */
+                          double,                   /* Bytes/s */
+                          bool,                     /* Batching */
+                          std::chrono::milliseconds /* Time trigger */
+                          >
+    InfoSequencerBatchingTable;
+
+typedef AdminCommandTable<shard_index_t, /* Shard */
+                          std::string,   /* Principal */
+                          uint64_t,      /* Share */
+                          uint64_t,      /* Queued */
+                          uint64_t       /* Deficit */
+                          >
+    InfoStorageTaskQueuesTable;
+
+typedef AdminCommandTable<shard_index_t, /* Shard */
+                          std::string,   /* Kind */
+                          uint64_t,      /* Count */
+                          int64_t,       /* Total usec */
+                          int64_t,       /* p50 usec */
+                          int64_t,       /* p99 usec */
+                          int64_t,       /* p99.9 usec */
+                          int64_t        /* Max usec */
+                          >
+    InfoIOTracingTable;
+
+typedef AdminCommandTable<std::string, /* Subsystem */
+                          int64_t,     /* Bytes */
+                          std::string  /* Source */
+                          >
+    InfoMemoryTable;
+
 struct InfoStorageTasksTableFieldOffsets {
   static constexpr int SHARD_ID = 0;
   static constexpr int PRIORITY = 1;
@@ -61,6 +61,17 @@ LOGDEVICE_CONVERTER_DECL(Address)
 
 #undef LOGDEVICE_CONVERTER_DECL
 
+// Whether values of type T are converted to strings by set() instead of when
+// the table is printed. True for types whose converter depends on the state
+// of the calling thread, e.g. describing a ClientID needs the Worker that owns
+// the connection.
+template <typename T>
+struct ConvertOnSet : std::false_type {};
+template <>
+struct ConvertOnSet<ClientID> : std::true_type {};
+template <>
+struct ConvertOnSet<Address> : std::true_type {};
+
 } // namespace admin_command_table
 
 template <typename... Args>
@@ -74,6 +85,7 @@ AdminCommandTable<Args...>::AdminCommandTable(ColumnNames names, bool prettify)
 template <typename... Args>
 AdminCommandTable<Args...>& AdminCommandTable<Args...>::next() {
   rows_.push_back(Row{});
+  raw_rows_.push_back(RawRow{});
   return *this;
 }
 
@@ -91,6 +103,7 @@ AdminCommandTable<Args...>& AdminCommandTable<Args...>::set(T data,
   widths_[P] = std::max(widths_[P], converted.size());
 
   rows_.back()[P] = std::move(converted);
+  std::get<P>(raw_rows_.back()).reset();
   return *this;
 }
 
@@ -100,8 +113,18 @@ AdminCommandTable<Args...>& AdminCommandTable<Args...>::set(T data) {
   // T is the type of `data`. However we want the real type that was
   // explicitly defined for that column.
   typedef typename std::tuple_element<P, std::tuple<Args...>>::type real_type;
-  auto f = admin_command_table::Converter<real_type>();
-  return set<P>(static_cast<real_type>(data), f);
+  if constexpr (admin_command_table::ConvertOnSet<real_type>::value) {
+    auto f = admin_command_table::Converter<real_type>();
+    return set<P>(static_cast<real_type>(data), f);
+  } else {
+    // Caller should call next() before calling set().
+    ld_check(!raw_rows_.empty());
+    // Keep the value as is, materialize() converts it.
+    std::get<P>(raw_rows_.back()) = static_cast<real_type>(data);
+    rows_.back()[P].reset();
+    has_raw_values_ = true;
+    return *this;
+  }
 }
 
 template <typename... Args>
@@ -132,6 +155,11 @@ void AdminCommandTable<Args...>::mergeWith(AdminCommandTable<Args...> other) {
   rows_.insert(rows_.end(),
                std::make_move_iterator(other.rows_.begin()),
                std::make_move_iterator(other.rows_.end()));
+  raw_rows_.reserve(raw_rows_.size() + other.raw_rows_.size());
+  raw_rows_.insert(raw_rows_.end(),
+                   std::make_move_iterator(other.raw_rows_.begin()),
+                   std::make_move_iterator(other.raw_rows_.end()));
+  has_raw_values_ |= other.has_raw_values_;
 
   for (int i = 0; i < widths_.size(); ++i) {
     widths_[i] = std::max(widths_[i], other.widths_[i]);
@@ -143,9 +171,64 @@ size_t AdminCommandTable<Args...>::numRows() const {
   return rows_.size();
 }
 
+template <typename... Args>
+void AdminCommandTable<Args...>::page(size_t offset, size_t limit) {
+  const size_t begin = std::min(offset, rows_.size());
+  const size_t end = begin + std::min(limit, rows_.size() - begin);
+  rows_.erase(rows_.begin() + end, rows_.end());
+  rows_.erase(rows_.begin(), rows_.begin() + begin);
+  raw_rows_.erase(raw_rows_.begin() + end, raw_rows_.end());
+  raw_rows_.erase(raw_rows_.begin(), raw_rows_.begin() + begin);
+
+  // Dropped rows may have been the widest ones.
+  for (int i = 0; i < numCols(); ++i) {
+    widths_[i] = names_[i].size();
+    for (const Row& row : rows_) {
+      if (row[i].hasValue()) {
+        widths_[i] = std::max(widths_[i], row[i].value().size());
+      }
+    }
+  }
+}
+
+template <typename... Args>
+void AdminCommandTable<Args...>::materialize() const {
+  if (!has_raw_values_) {
+    return;
+  }
+  for (size_t row = 0; row < raw_rows_.size(); ++row) {
+    materializeRow(row, std::index_sequence_for<Args...>{});
+  }
+  has_raw_values_ = false;
+}
+
+template <typename... Args>
+template <std::size_t... P>
+void AdminCommandTable<Args...>::materializeRow(
+    size_t row,
+    std::index_sequence<P...>) const {
+  (materializeCell<P>(row), ...);
+}
+
+template <typename... Args>
+template <std::size_t P>
+void AdminCommandTable<Args...>::materializeCell(size_t row) const {
+  typedef typename std::tuple_element<P, std::tuple<Args...>>::type real_type;
+  auto& raw = std::get<P>(raw_rows_[row]);
+  if (!raw.hasValue()) {
+    return;
+  }
+  std::string converted = admin_command_table::Converter<real_type>()(
+      std::move(raw.value()), prettify_);
+  widths_[P] = std::max(widths_[P], converted.size());
+  rows_[row][P] = std::move(converted);
+  raw.reset();
+}
+
 template <typename... Args>
 void AdminCommandTable<Args...>::print(folly::io::Appender& output,
                                        std::size_t max_col_) const {
+  materialize();
   unsigned int max_col = std::min(max_col_, numCols());
 
   // Print the headers
@@ -181,6 +264,7 @@ void AdminCommandTable<Args...>::printRowVertically(
     unsigned int row,
     folly::io::Appender& output,
     std::size_t max_col_) const {
+  materialize();
   unsigned int max_col = std::min(max_col_, numCols());
 
   unsigned int max_width = *(std::max_element(widths_.begin(), widths_.end()));
@@ -202,6 +286,7 @@ void AdminCommandTable<Args...>::printRowVertically(
 template <typename... Args>
 void AdminCommandTable<Args...>::printJson(folly::io::Appender& output,
                                            std::size_t max_col_) const {
+  materialize();
   unsigned int max_col = std::min(max_col_, numCols());
 
   folly::dynamic object = folly::dynamic::object;
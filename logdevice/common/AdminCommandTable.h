@@ -10,6 +10,7 @@
 #include <array>
 #include <cstddef>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -46,6 +47,12 @@
  *
  * You can also print the table in json format for easier parsing from scripts:
  * my_table.printJson(evbuffer);
+ *
+ * Values set without a custom to_string function are kept as they are and only
+ * converted to strings when the table is printed, so that a table filled on a
+ * worker thread and printed from the admin command thread doesn't hold up the
+ * worker with formatting. Types whose conversion depends on the calling thread
+ * (see admin_command_table::ConvertOnSet) are converted right away.
  */
 
 namespace facebook { namespace logdevice {
@@ -133,6 +140,12 @@ class AdminCommandTable {
 
   size_t numRows() const;
 
+  /**
+   * Keeps only `limit` rows starting at row `offset`, for paginating large
+   * outputs. Values of the dropped rows are never converted to strings.
+   */
+  void page(size_t offset, size_t limit);
+
   /**
    * Print the table to the given evbuffer.
    *
@@ -161,11 +174,25 @@ class AdminCommandTable {
 
  private:
   typedef std::array<folly::Optional<std::string>, numCols()> Row;
+  // Values not converted to strings yet, see materialize().
+  typedef std::tuple<folly::Optional<Args>...> RawRow;
   typedef std::array<size_t, numCols()> ColumnWidths;
 
-  ColumnWidths widths_;
+  // Converts the values in raw_rows_ to strings in rows_.
+  void materialize() const;
+  template <std::size_t... P>
+  void materializeRow(size_t row, std::index_sequence<P...>) const;
+  template <std::size_t P>
+  void materializeCell(size_t row) const;
+
+  // Widths of the converted values. Up to date after materialize().
+  mutable ColumnWidths widths_;
   ColumnNames names_;
-  std::vector<Row> rows_;
+  mutable std::vector<Row> rows_;
+  // Same size as rows_.
+  mutable std::vector<RawRow> raw_rows_;
+  // True if raw_rows_ may contain values not converted yet.
+  mutable bool has_raw_values_ = false;
   bool prettify_;
 };
 
@@ -30,7 +30,9 @@ namespace facebook { namespace logdevice {
  *
  * The input to the class are append failures and successes.  The output is a
  * binary recommendation for each append, to send a probe before the actual
- * append or not.
+ * append or not.  A success whose reply says the sequencer is close to
+ * overloaded (APPENDED_Header::SEQUENCER_OVERLOADED) counts as a failure, so
+ * that we start probing before the sequencer starts rejecting payloads.
  *
  * The current logic is to recommend a probe if there was a recent failure and
  * there hasn't been a "recovery interval" since then during which all appends
@@ -58,9 +60,16 @@ class AppendProbeController {
    * NOTE: the Status here is what we get from the sequencer over the wire,
    * not necessarily what we report to the client.  The wire status contains
    * more information and may allow us to better determine whether to probe.
+   *
+   * @param overloaded  the sequencer hinted that it is close to overloaded
    */
-  void onAppendReply(NodeID node_id, logid_t log_id, Status wire_status) {
-    if (wire_status == E::OK) {
+  void onAppendReply(NodeID node_id,
+                     logid_t log_id,
+                     Status wire_status,
+                     bool overloaded = false) {
+    if (wire_status == E::OK && overloaded) {
+      onFailure(node_id, log_id, E::SEQNOBUFS);
+    } else if (wire_status == E::OK) {
       onSuccess(node_id, log_id);
     } else {
       onFailure(node_id, log_id, wire_status);
@@ -62,7 +62,9 @@ AppendRequest::AppendRequest(ClientBridge* client,
       attrs_(std::move(attrs)),
       on_socket_close_(id_),
       router_(std::move(router)),
-      tracer_(client ? client->getTraceLogger() : nullptr) {
+      tracer_(client ? client->getTraceLogger() : nullptr),
+      e2e_tracer_(client ? client->getTraceLogger() : nullptr),
+      e2e_trace_id_(e2e_tracer_.startTrace()) {
   if (!AppendRequest::clientThreadId) {
     AppendRequest::clientThreadId =
         std::max<unsigned>(1, ++AppendRequest::nextThreadId);
@@ -95,6 +97,8 @@ AppendRequest::AppendRequest(AppendRequest&& other) noexcept
       router_(std::make_unique<SequencerRouter>(record_.logid, this)),
       append_probe_controller_(std::move(other.append_probe_controller_)),
       tracer_(std::move(other.tracer_)),
+      e2e_tracer_(std::move(other.e2e_tracer_)),
+      e2e_trace_id_(other.e2e_trace_id_),
       buffered_writer_blob_flag_(std::move(other.buffered_writer_blob_flag_)),
       bypass_write_token_check_(std::move(other.bypass_write_token_check_)),
       append_redirected_to_dead_node_(
@@ -153,6 +157,14 @@ AppendRequest::~AppendRequest() {
                       latency_usec,
                       previous_lsn_,
                       sequencer_node_);
+  e2e_tracer_.traceSpan(e2e_trace_id_,
+                        "client_append",
+                        record_.logid,
+                        record_.attrs.lsn,
+                        client_status,
+                        creation_time_,
+                        std::chrono::steady_clock::now(),
+                        {{"payload_size", int64_t(record_.payload.size())}});
 
   if (is_active_) {
     // Call back only when the request is active. If not, it has been cancelled
@@ -333,8 +345,10 @@ std::unique_ptr<APPEND_Message> AppendRequest::createAppendMessage() {
       uint32_t(std::min<decltype(timeout_)::rep>(timeout_.count(), UINT_MAX)),
       append_flags};
 
-  return std::make_unique<APPEND_Message>(
+  auto msg = std::make_unique<APPEND_Message>(
       header, previous_lsn_, attrs_, payload_);
+  msg->e2e_trace_id_ = e2e_trace_id_;
+  return msg;
 }
 
 void AppendRequest::sendAppendMessage() {
@@ -428,8 +442,13 @@ void AppendRequest::onReplyReceived(const APPENDED_Header& reply,
   ld_check(reply.rqid == id_);
 
   if (append_probe_controller_) {
+    const bool overloaded =
+        reply.flags & APPENDED_Header::SEQUENCER_OVERLOADED;
+    if (overloaded) {
+      WORKER_STAT_INCR(client.append_overload_hints_received);
+    }
     append_probe_controller_->onAppendReply(
-        from.asNodeID(), record_.logid, reply.status);
+        from.asNodeID(), record_.logid, reply.status, overloaded);
   }
 
   status_ = reply.status;
@@ -451,6 +470,7 @@ void AppendRequest::onReplyReceived(const APPENDED_Header& reply,
         record_.attrs.timestamp = reply.timestamp.toMilliseconds();
       }
       updateSeenEpoch(record_.logid, lsn_to_epoch(reply.lsn));
+      router_->onSuccess(from.asNodeID());
       FOLLY_FALLTHROUGH;
     case E::TOOBIG:
     case E::BADPAYLOAD:
@@ -739,6 +759,9 @@ APPEND_flags_t AppendRequest::getAppendFlags() {
   if (previous_lsn_ != LSN_INVALID) {
     append_flags |= APPEND_Header::LSN_BEFORE_REDIRECT;
   }
+  if (e2e_trace_id_ != E2E_TRACE_ID_INVALID) {
+    append_flags |= APPEND_Header::E2E_TRACING_ON;
+  }
   return append_flags;
 }
 
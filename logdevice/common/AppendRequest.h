@@ -25,6 +25,7 @@
 #include "logdevice/common/AppendRequestBase.h"
 #include "logdevice/common/ClientAppendTracer.h"
 #include "logdevice/common/ClientBridge.h"
+#include "logdevice/common/E2ETracer.h"
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/Request.h"
 #include "logdevice/common/RequestType.h"
@@ -292,6 +293,10 @@ class AppendRequest : public AppendRequestBase,
     return previous_lsn_;
   }
 
+  e2e_trace_id_t getE2ETraceId() const {
+    return e2e_trace_id_;
+  }
+
   const AppendAttributes& getAppendAttributes() const {
     return attrs_;
   }
@@ -369,6 +374,12 @@ class AppendRequest : public AppendRequestBase,
   // Client-side append tracer
   ClientAppendTracer tracer_;
 
+  // Publishes the client_append span if the append was sampled for
+  // end-to-end tracing, in which case e2e_trace_id_ is valid and sent along
+  // in APPEND messages.
+  E2ETracer e2e_tracer_;
+  e2e_trace_id_t e2e_trace_id_;
+
   // Appends coming from BufferedWriter should have the BUFFERED_WRITER_BLOB
   // flag set in APPEND_Header.
   bool buffered_writer_blob_flag_ = false;
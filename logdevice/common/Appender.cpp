@@ -29,6 +29,7 @@
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Sequencer.h"
 #include "logdevice/common/TailRecord.h"
+#include "logdevice/common/ThreadLocalObjectPool.h"
 #include "logdevice/common/TraceLogger.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/WorkerTimeoutStats.h"
@@ -57,6 +58,17 @@ static const std::chrono::milliseconds LOG_IF_APPEND_TOOK_LONGER_THAN =
     std::chrono::seconds(20);
 static const int LOG_IF_WAVE_ABOVE = 7;
 
+using StageTimePoint = std::chrono::steady_clock::time_point;
+
+// Microseconds from `from` to `to`, or -1 if either stage wasn't reached.
+static int64_t usec_between(StageTimePoint from, StageTimePoint to) {
+  if (from == StageTimePoint() || to == StageTimePoint()) {
+    return -1;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(to - from)
+      .count();
+}
+
 Appender::Appender(Worker* worker,
                    std::shared_ptr<TraceLogger> trace_logger,
                    std::chrono::milliseconds client_timeout,
@@ -70,7 +82,8 @@ Appender::Appender(Worker* worker,
                    size_t full_appender_size,
                    lsn_t lsn_before_redirect)
     : sender_(std::make_unique<SenderProxy>()),
-      tracer_(std::move(trace_logger)),
+      tracer_(trace_logger),
+      e2e_tracer_(std::move(trace_logger)),
       created_on_(worker),
       full_appender_size_(full_appender_size),
       timeout_(),
@@ -85,6 +98,8 @@ Appender::Appender(Worker* worker,
       passthru_flags_(passthru_flags),
       release_type_(static_cast<ReleaseTypeRaw>(ReleaseType::GLOBAL)),
       lsn_before_redirect_(lsn_before_redirect) {
+  stage_times_.received = creation_time_;
+
   // Increment the total count of Appenders. Note: created_on_ can be nullptr
   // inside tests.
   if (created_on_) {
@@ -156,6 +171,14 @@ Appender::~Appender() {
   }
 }
 
+void* Appender::operator new(size_t size) {
+  return ThreadLocalObjectPool<Appender>::allocate(size);
+}
+
+void Appender::operator delete(void* p, size_t size) {
+  ThreadLocalObjectPool<Appender>::deallocate(p, size);
+}
+
 int Appender::sendSTORE(const StoreChainLink copyset[],
                         copyset_off_t copyset_offset,
                         folly::Optional<lsn_t> block_starting_lsn,
@@ -426,6 +449,14 @@ int Appender::trySendingWavesOfStores(
         break;
     }
 
+    if (stage_times_.copyset_selected == StageTimePoint()) {
+      stage_times_.copyset_selected = std::chrono::steady_clock::now();
+      HISTOGRAM_ADD(getStats(),
+                    append_stage_copyset,
+                    usec_between(stage_times_.admitted,
+                                 stage_times_.copyset_selected));
+    }
+
     ld_check(ncopies > 0);
     ld_check(ndest == ncopies);
 
@@ -524,6 +555,15 @@ int Appender::trySendingWavesOfStores(
       }
     }
   } while (replies_expected_ < recipients_.getReplication());
+
+  const bool first_wave_sent = stage_times_.store_sent == StageTimePoint();
+  stage_times_.store_sent = std::chrono::steady_clock::now();
+  if (first_wave_sent) {
+    HISTOGRAM_ADD(getStats(),
+                  append_stage_store_send,
+                  usec_between(stage_times_.copyset_selected,
+                               stage_times_.store_sent));
+  }
   return 0;
 }
 
@@ -604,10 +644,16 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
   epoch_sequencer_ = std::move(epoch_sequencer);
   ld_check(lsn != LSN_INVALID);
 
-  initStoreTimer();
-  initRetryTimer();
+  // The LSN was just assigned by the sliding window.
+  stage_times_.admitted = std::chrono::steady_clock::now();
+  HISTOGRAM_ADD(getStats(),
+                append_stage_prep,
+                usec_between(stage_times_.received, creation_time_));
+  HISTOGRAM_ADD(getStats(),
+                append_stage_window,
+                usec_between(creation_time_, stage_times_.admitted));
 
-  const std::shared_ptr<const Configuration> cfg(getClusterConfig());
+  prepare();
 
   // get the copyset manager from the EpochSequencer. It guarantees to have
   // a consistent (and immutable) nodeset and replication property. However,
@@ -647,8 +693,6 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
 
   biggest_replication_scope_ = getCurrentBiggestReplicationScope();
 
-  const auto logcfg = cfg->getLogGroupByIDShared(store_hdr_.rid.logid);
-
   recipients_.reset(replication, getExtras());
 
   ld_check(store_hdr_.rid.logid != LOGID_INVALID);
@@ -673,13 +717,7 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
   csm_state_ = copyset_manager_->createState();
   setStarted(true);
 
-  bool tail_optimized = false;
-  if (logcfg != nullptr) {
-    backlog_duration_ = logcfg->attrs().backlogDuration().value();
-    tail_optimized = logcfg->attrs().tailOptimized().value();
-  }
-
-  prepareTailRecord(tail_optimized);
+  prepareTailRecord(tail_optimized_);
   ld_check(tail_record_ != nullptr);
 
   STAT_INCR(getStats(), appender_start);
@@ -708,6 +746,37 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
   return 0;
 }
 
+AppendStageLatencies Appender::getStageLatencies() const {
+  AppendStageLatencies res;
+  res.prep_us = usec_between(stage_times_.received, creation_time_);
+  res.window_us = usec_between(creation_time_, stage_times_.admitted);
+  res.copyset_us =
+      usec_between(stage_times_.admitted, stage_times_.copyset_selected);
+  res.store_send_us =
+      usec_between(stage_times_.copyset_selected, stage_times_.store_sent);
+  res.stored_us =
+      usec_between(stage_times_.store_sent, stage_times_.fully_replicated);
+  return res;
+}
+
+void Appender::prepare() {
+  if (prepared_) {
+    return;
+  }
+  CHECK_WORKER_THREAD();
+
+  initStoreTimer();
+  initRetryTimer();
+
+  const std::shared_ptr<const Configuration> cfg(getClusterConfig());
+  const auto logcfg = cfg->getLogGroupByIDShared(log_id_);
+  if (logcfg != nullptr) {
+    backlog_duration_ = logcfg->attrs().backlogDuration().value();
+    tail_optimized_ = logcfg->attrs().tailOptimized().value();
+  }
+  prepared_ = true;
+}
+
 void Appender::prepareTailRecord(bool include_payload) {
   TailRecordHeader::flags_t flags = TailRecordHeader::OFFSET_WITHIN_EPOCH;
   // TODO (T35832374) : remove if condition when all servers support OffsetMap
@@ -844,6 +913,27 @@ void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
     deleteIfDone(REPLIED);
   };
 
+  if (status == E::OK && stage_times_.fully_replicated != StageTimePoint()) {
+    HISTOGRAM_ADD(getStats(),
+                  append_stage_reply,
+                  usec_between(stage_times_.fully_replicated,
+                               std::chrono::steady_clock::now()));
+  }
+
+  e2e_tracer_.traceSpan(extra_.e2e_trace_id,
+                        "sequencer_append",
+                        log_id_,
+                        lsn,
+                        status,
+                        stage_times_.received,
+                        std::chrono::steady_clock::now(),
+                        {{"waves", started() ? store_hdr_.wave : 0},
+                         {"prep_us",
+                          usec_between(stage_times_.received, creation_time_)},
+                         {"window_us",
+                          usec_between(
+                              creation_time_, stage_times_.admitted)}});
+
   if (lsn == LSN_INVALID) {
     ld_check(status != E::OK);
   } else {
@@ -883,6 +973,10 @@ void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
     // appends yet, and shouldn't be treated as append failures.
   } else if (status == E::OK) {
     STAT_ADD(getStats(), append_success, append_message_count_);
+    if (isWindowNearlyFull()) {
+      replyhdr.flags |= APPENDED_Header::SEQUENCER_OVERLOADED;
+      STAT_INCR(getStats(), append_overload_hints_sent);
+    }
     LOG_STAT_ADD(getStats(),
                  getClusterConfig(),
                  log_id_,
@@ -1075,7 +1169,8 @@ void Appender::sendError(Status reason) {
       backlog_duration_,
       started() ? store_hdr_.wave : 0,
       std::string(error_name(client_code)),
-      std::string(error_name(reason)));
+      std::string(error_name(reason)),
+      getStageLatencies());
 
   sendReply(LSN_INVALID, client_code);
 }
@@ -1386,6 +1481,13 @@ int Appender::onReply(const STORED_Header& header,
     return 0;
   }
 
+  if (header.status == E::OK) {
+    HISTOGRAM_ADD(getStats(),
+                  append_stage_stored,
+                  usec_between(stage_times_.store_sent,
+                               std::chrono::steady_clock::now()));
+  }
+
   if (replies_expected_ == 0) {
     RATELIMIT_ERROR(std::chrono::seconds(1),
                     10,
@@ -1764,9 +1866,17 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
   }
 
   ld_check(!reply_sent_);
+  stage_times_.fully_replicated = std::chrono::steady_clock::now();
   // record the latency of this append
   HISTOGRAM_ADD(getStats(), append_latency, usec_since(creation_time_));
   int64_t latency_usec = usec_since(creation_time_);
+  if (created_on_) { // can be null in tests
+    if (auto log_path =
+            created_on_->getConfiguration()->getLogGroupPath(log_id_)) {
+      LOG_GROUP_HISTOGRAM_ADD(
+          getStats(), append_latency, log_path.value(), latency_usec);
+    }
+  }
   const Sockaddr& client_sock_addr =
       Sender::sockaddrOrInvalid(Address(reply_to_));
   tracer_.traceAppend(
@@ -1782,7 +1892,8 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
       backlog_duration_,
       started() ? store_hdr_.wave : 0,
       std::string(error_name(E::OK)),
-      std::string(error_name(E::OK)));
+      std::string(error_name(E::OK)),
+      getStageLatencies());
   if (std::chrono::microseconds(latency_usec) >
       LOG_IF_APPEND_TOOK_LONGER_THAN) {
     RATELIMIT_WARNING(
@@ -1902,6 +2013,15 @@ void Appender::sendReleases(const ShardID* dests,
                             size_t ndests,
                             const RecordID& /* rid */,
                             ReleaseType release_type) {
+  if (stage_times_.release_sent == StageTimePoint() &&
+      stage_times_.fully_replicated != StageTimePoint()) {
+    stage_times_.release_sent = std::chrono::steady_clock::now();
+    HISTOGRAM_ADD(getStats(),
+                  append_stage_release,
+                  usec_between(stage_times_.fully_replicated,
+                               stage_times_.release_sent));
+  }
+
   ld_spew("Sending %s RELEASE messages for record %s to %zu nodes",
           release_type_to_string(release_type).c_str(),
           store_hdr_.rid.toString().c_str(),
@@ -2406,6 +2526,16 @@ bool Appender::isNodeAlive(NodeID node) {
   return (cs == nullptr || cs->isNodeAlive(node.index()));
 }
 
+bool Appender::isWindowNearlyFull() const {
+  const double fill = getSettings().append_overload_hint_window_fill;
+  if (fill <= 0 || !epoch_sequencer_) {
+    return false;
+  }
+  const size_t capacity = epoch_sequencer_->getMaxWindowSize();
+  return capacity > 0 &&
+      epoch_sequencer_->getNumAppendsInFlight() >= fill * capacity;
+}
+
 std::shared_ptr<const std::atomic<bool>>
 Appender::getClientSocketToken() const {
   return created_on_ ? created_on_->sender().getSocketToken(reply_to_)
@@ -19,6 +19,7 @@
 
 #include "logdevice/common/AppenderTracer.h"
 #include "logdevice/common/CopySetManager.h"
+#include "logdevice/common/E2ETracer.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
 #include "logdevice/common/IntrusiveUnorderedMap.h"
 #include "logdevice/common/NodeSetState.h"
@@ -130,6 +131,11 @@ class Appender : public IntrusiveUnorderedMapHook {
 
   virtual ~Appender();
 
+  // Appenders are allocated from a per-Worker free list, see
+  // ThreadLocalObjectPool.
+  static void* operator new(size_t size);
+  static void operator delete(void* p, size_t size);
+
   /**
    * Reason for the retirement of the Appender. Used to determine actions when
    * the appender retires.
@@ -216,6 +222,32 @@ class Appender : public IntrusiveUnorderedMapHook {
    */
   virtual int start(std::shared_ptr<EpochSequencer> epoch_sequencer, lsn_t lsn);
 
+  /**
+   * Does the part of start() that depends on neither the LSN nor the epoch:
+   * initializes the timers and looks up the log attributes in the config.
+   * AppenderBuffer calls this when the Appender is queued waiting for the
+   * sequencer, so that the work is off the critical path once an LSN can be
+   * assigned. No-op if already called; start() calls it otherwise.
+   *
+   * Copyset selection stays in start(): it needs the CopySetManager of the
+   * epoch the record ends up in, and sticky copysets depend on the LSN.
+   */
+  void prepare();
+
+  /**
+   * Sets when the APPEND was received, before the AppenderPrep checks.
+   * Start of the append_stage_prep stage; defaults to the time this Appender
+   * was created.
+   */
+  void setReceivedTime(std::chrono::steady_clock::time_point t) {
+    stage_times_.received = t;
+  }
+
+  /**
+   * Time spent so far in each stage of the write path, for AppenderTracer.
+   */
+  AppendStageLatencies getStageLatencies() const;
+
   /**
    * Mark this Appender as retired in its EpochSequencer's SlidingWindow. This
    * may cause this and other Appenders in that SlidingWindow to be reaped.
@@ -638,6 +670,14 @@ class Appender : public IntrusiveUnorderedMapHook {
     can_resume_write_stream_ = can_resume_write_stream;
   }
 
+  // Marks the append as sampled for end-to-end tracing. The trace id is
+  // passed on to storage nodes in STORE messages.
+  void setE2ETraceId(e2e_trace_id_t trace_id) {
+    ld_check(trace_id != E2E_TRACE_ID_INVALID);
+    passthru_flags_ |= STORE_Header::E2E_TRACING_ON;
+    extra_.e2e_trace_id = trace_id;
+  }
+
  protected:
   // protected: members are for use by test subclasses. This class is not
   // intended to be subclassed other than for testing.
@@ -701,6 +741,9 @@ class Appender : public IntrusiveUnorderedMapHook {
   virtual void activateRetryTimer();
   virtual bool retryTimerIsActive();
   virtual bool isNodeAlive(NodeID node);
+  // True if the sliding window of the epoch sequencer is filled to at least
+  // Settings::append_overload_hint_window_fill.
+  virtual bool isWindowNearlyFull() const;
 
  private:
   using ReleaseTypeRaw = std::underlying_type<ReleaseType>::type;
@@ -711,6 +754,8 @@ class Appender : public IntrusiveUnorderedMapHook {
 
   // AppenderTracer for tracing append operations
   AppenderTracer tracer_;
+  // Publishes the sequencer_append span if extra_.e2e_trace_id is valid
+  E2ETracer e2e_tracer_;
   // Worker on whose thread this Appender was created. May be null in tests so
   // Appender should access this through virtual methods of this class so that
   // tests can override them.
@@ -722,6 +767,12 @@ class Appender : public IntrusiveUnorderedMapHook {
   // Backlog duration (in seconds) configured for this log (used for tracing)
   folly::Optional<std::chrono::seconds> backlog_duration_;
 
+  // If the log is tail optimized, the tail record includes the payload.
+  bool tail_optimized_ = false;
+
+  // Set by prepare().
+  bool prepared_ = false;
+
   // Denotes if the stream append request can start a new write stream or
   // continue a broken one.
   bool can_resume_write_stream_ = false;
@@ -817,6 +868,22 @@ class Appender : public IntrusiveUnorderedMapHook {
   // time when the appender was created, used to calculate the latency
   std::chrono::steady_clock::time_point creation_time_;
 
+  // When this append got through the stages of the write path, for the
+  // append_stage_* histograms and AppenderTracer. Default-constructed time
+  // points for stages not reached yet. Except for store_sent, only the first
+  // wave is timed.
+  struct StageTimes {
+    using TimePoint = std::chrono::steady_clock::time_point;
+    TimePoint received;
+    TimePoint admitted;
+    TimePoint copyset_selected;
+    // Last wave of STOREs sent.
+    TimePoint store_sent;
+    TimePoint fully_replicated;
+    TimePoint release_sent;
+  };
+  StageTimes stage_times_;
+
   // deadline after which the client is presumed to have timed out. If the
   // epoch to which this Appender belongs (store_hdr_.epoch) is shut down
   // after this deadline, the appender may abort the request without sending
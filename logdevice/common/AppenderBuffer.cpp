@@ -184,6 +184,8 @@ bool AppenderBuffer::bufferAppender(logid_t logid,
     return false;
   }
 
+  // Do the LSN-independent part of starting the Appender while it waits.
+  appender->prepare();
   appender_queue->queue_.push(std::move(appender));
   WORKER_STAT_INCR(appenderbuffer_appender_buffered);
   WORKER_STAT_INCR(appenderbuffer_pending_appenders);
@@ -419,11 +419,15 @@ std::unique_ptr<Appender> AppenderPrep::constructAppender() {
                                  lsn_before_redirect_);
   appender->setAppendMessageCount(append_message_count_);
   appender->setAcceptableEpoch(acceptable_epoch_);
+  appender->setReceivedTime(received_time_);
   if (header_.flags & APPEND_Header::WRITE_STREAM_REQUEST) {
     appender->setWriteStreamAppendInfo(
         write_stream_rqid_,
         (bool)(header_.flags & APPEND_Header::WRITE_STREAM_RESUME));
   }
+  if (e2e_trace_id_ != E2E_TRACE_ID_INVALID) {
+    appender->setE2ETraceId(e2e_trace_id_);
+  }
   return appender;
 }
 
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "logdevice/common/AllSequencers.h"
@@ -68,6 +69,11 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
     return *this;
   }
 
+  AppenderPrep& setE2ETraceId(e2e_trace_id_t trace_id) {
+    e2e_trace_id_ = trace_id;
+    return *this;
+  }
+
   void execute();
 
   // Called directly in tests
@@ -167,6 +173,9 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   write_stream_request_id_t write_stream_rqid_ =
       WRITE_STREAM_REQUEST_ID_INVALID;
 
+  // Trace id, if the append was sampled for end-to-end tracing.
+  e2e_trace_id_t e2e_trace_id_ = E2E_TRACE_ID_INVALID;
+
   PayloadHolder payload_;
   // TODO factor away
   APPEND_Header header_;
@@ -190,6 +199,10 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   bool allow_batching_ = true;
   // only allow the append to go through on the following epoch, if set
   folly::Optional<epoch_t> acceptable_epoch_;
+  // When the append was received (this object is created right away), for
+  // the append_stage_prep histogram.
+  std::chrono::steady_clock::time_point received_time_{
+      std::chrono::steady_clock::now()};
   // Constructs an Appender after the message is received
   std::unique_ptr<Appender> constructAppender();
 
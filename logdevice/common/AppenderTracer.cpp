@@ -36,7 +36,8 @@ void AppenderTracer::traceAppend(
     folly::Optional<std::chrono::seconds> backlog_duration,
     uint32_t waves,
     std::string client_status,
-    std::string internal_status) {
+    std::string internal_status,
+    const AppendStageLatencies& stage_latencies) {
   auto sample_builder = [&]() -> std::unique_ptr<TraceSample> {
     auto sample = std::make_unique<TraceSample>();
     const auto& recipients = recipient_set.getRecipients();
@@ -65,6 +66,11 @@ void AppenderTracer::traceAppend(
     sample->addIntValue("appender_size", full_appender_size);
     sample->addIntValue("seen_epoch", seen_epoch.val());
     sample->addIntValue("latency_us", latency_us);
+    sample->addIntValue("prep_latency_us", stage_latencies.prep_us);
+    sample->addIntValue("window_latency_us", stage_latencies.window_us);
+    sample->addIntValue("copyset_latency_us", stage_latencies.copyset_us);
+    sample->addIntValue("store_send_latency_us", stage_latencies.store_send_us);
+    sample->addIntValue("stored_latency_us", stage_latencies.stored_us);
     sample->addIntValue("log_id", log_id.val());
     sample->addIntValue("lsn", lsn);
     if (backlog_duration) {
@@ -20,6 +20,22 @@ struct ClientID;
 
 constexpr auto APPENDER_TRACER = "appender";
 
+// Time spent by an append in each stage of the write path on the sequencer,
+// in microseconds. Negative for stages the append didn't get through.
+struct AppendStageLatencies {
+  // APPEND received to Appender created (AppenderPrep checks).
+  int64_t prep_us = -1;
+  // Appender created to LSN assigned (sliding window admission, includes
+  // waiting for sequencer activation in AppenderBuffer).
+  int64_t window_us = -1;
+  // LSN assigned to copyset selected for the first wave.
+  int64_t copyset_us = -1;
+  // Copyset selected to first wave of STOREs passed to the Sender.
+  int64_t store_send_us = -1;
+  // Last wave of STOREs sent to enough STOREDs received.
+  int64_t stored_us = -1;
+};
+
 class AppenderTracer : SampledTracer {
  public:
   explicit AppenderTracer(std::shared_ptr<TraceLogger> logger);
@@ -37,7 +53,8 @@ class AppenderTracer : SampledTracer {
                    folly::Optional<std::chrono::seconds> backlog_duration,
                    uint32_t waves,
                    std::string client_status,
-                   std::string internal_status);
+                   std::string internal_status,
+                   const AppendStageLatencies& stage_latencies = {});
 };
 
 }} // namespace facebook::logdevice
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/BusyPoller.h"
+
+#include "logdevice/common/checks.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr std::chrono::milliseconds BusyPoller::kBudgetPeriod;
+
+void BusyPoller::configure(std::chrono::microseconds max_spin,
+                           double cpu_budget) {
+  ld_check(max_spin.count() >= 0);
+  ld_check(cpu_budget >= 0 && cpu_budget <= 1);
+  if (max_spin != max_spin_) {
+    max_spin_ = max_spin;
+    window_ = max_spin;
+  }
+  cpu_budget_ = cpu_budget;
+}
+
+BusyPoller::Clock::duration BusyPoller::startSpin(Clock::time_point now) {
+  if (now >= period_end_) {
+    period_end_ = now + kBudgetPeriod;
+    spent_in_period_ = Clock::duration::zero();
+  }
+  const auto budget = std::chrono::duration_cast<Clock::duration>(
+      kBudgetPeriod * cpu_budget_);
+  return std::min(window_, budget - spent_in_period_);
+}
+
+void BusyPoller::finishSpin(Clock::duration spent, bool found) {
+  spent_in_period_ += spent;
+  if (found) {
+    window_ = max_spin_;
+  } else {
+    window_ = std::max<Clock::duration>(window_ / 2, max_spin_ / 8);
+  }
+
+  if (stats_) {
+    if (found) {
+      STAT_INCR(stats_, busy_poll_hits);
+    } else {
+      STAT_INCR(stats_, busy_poll_misses);
+    }
+    STAT_ADD(
+        stats_,
+        busy_poll_spin_usec,
+        std::chrono::duration_cast<std::chrono::microseconds>(spent).count());
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+#include <folly/portability/Asm.h>
+
+namespace facebook { namespace logdevice {
+
+class StatsHolder;
+
+/**
+ * @file Spin-then-sleep helper for threads that would otherwise block waiting
+ *       for work. Handing work to a sleeping thread costs a wakeup through the
+ *       kernel (tens of microseconds); if the consumer instead spins for a
+ *       short while before going to sleep, work that arrives during that
+ *       window is picked up right away.
+ *
+ *       spin() polls a readiness predicate for up to a window of time. The
+ *       window is adaptive: it is reset to the configured maximum whenever
+ *       spinning finds work and halved (down to an eighth of the maximum)
+ *       whenever it doesn't, so a mostly idle thread spins less. Time spent
+ *       spinning is also capped at a fraction (the CPU budget) of every
+ *       kBudgetPeriod of wall time; once the budget is used up the thread
+ *       goes straight to sleep until the next period.
+ *
+ *       Not thread-safe; each consumer thread should have its own instance.
+ */
+
+class BusyPoller {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::chrono::milliseconds kBudgetPeriod{1000};
+
+  /**
+   * @param max_spin    longest a single spin() may poll for; 0 disables
+   *                    spinning
+   * @param cpu_budget  fraction of wall time, in [0, 1], that may be spent
+   *                    spinning
+   */
+  void configure(std::chrono::microseconds max_spin, double cpu_budget);
+
+  /**
+   * Sets where to report busy_poll_* stats. nullptr disables reporting.
+   */
+  void setStats(StatsHolder* stats) {
+    stats_ = stats;
+  }
+
+  bool enabled() const {
+    return max_spin_.count() > 0;
+  }
+
+  /**
+   * Calls `ready` until it returns true or the spin window or CPU budget run
+   * out. Returns immediately if spinning is disabled.
+   *
+   * @return true if `ready` returned true, false if the caller should go to
+   *         sleep
+   */
+  template <typename Ready>
+  bool spin(Ready&& ready) {
+    if (!enabled()) {
+      return false;
+    }
+    const Clock::time_point start = Clock::now();
+    const Clock::duration window = startSpin(start);
+    if (window <= Clock::duration::zero()) {
+      return false;
+    }
+    const Clock::time_point deadline = start + window;
+    bool found = false;
+    Clock::time_point now;
+    while (true) {
+      if (ready()) {
+        found = true;
+        now = Clock::now();
+        break;
+      }
+      folly::asm_volatile_pause();
+      now = Clock::now();
+      if (now >= deadline) {
+        break;
+      }
+    }
+    finishSpin(now - start, found);
+    return found;
+  }
+
+ private:
+  // Starts a new budget period if needed and returns how long this spin may
+  // last.
+  Clock::duration startSpin(Clock::time_point now);
+
+  // Accounts for a finished spin and adapts the window.
+  void finishSpin(Clock::duration spent, bool found);
+
+  std::chrono::microseconds max_spin_{0};
+  double cpu_budget_{0};
+  Clock::duration window_{0};
+
+  Clock::time_point period_end_{};
+  Clock::duration spent_in_period_{0};
+
+  StatsHolder* stats_{nullptr};
+};
+
+}} // namespace facebook::logdevice
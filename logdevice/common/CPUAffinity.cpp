@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/CPUAffinity.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include <boost/filesystem.hpp>
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <sched.h>
+#include <sys/sysmacros.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const char* const kNodeDir = "/sys/devices/system/node";
+
+bool readSysfsFile(const std::string& path, std::string* out) {
+  if (!folly::readFile(path.c_str(), *out)) {
+    return false;
+  }
+  *out = folly::trimWhitespace(*out).str();
+  return true;
+}
+
+} // namespace
+
+int getNumaNodeCount() {
+  std::string online;
+  if (!readSysfsFile(std::string(kNodeDir) + "/online", &online)) {
+    return 1;
+  }
+  std::vector<int> nodes = parseCPUList(online);
+  return nodes.empty() ? 1 : nodes.back() + 1;
+}
+
+std::vector<int> getNumaNodeCPUs(int node) {
+  std::string cpulist;
+  std::string path =
+      folly::to<std::string>(kNodeDir, "/node", node, "/cpulist");
+  if (!readSysfsFile(path, &cpulist)) {
+    return {};
+  }
+  return parseCPUList(cpulist);
+}
+
+int getNumaNodeOfDevice(dev_t dev) {
+  // /sys/dev/block/<major>:<minor> links to the device's directory under
+  // /sys/devices. Partitions are subdirectories of the whole disk, and the
+  // disk is somewhere below the PCI device it's attached to, which is what
+  // has a numa_node. Walk up until we find one.
+  boost::system::error_code ec;
+  fs::path path = fs::canonical(
+      folly::to<std::string>("/sys/dev/block/", major(dev), ":", minor(dev)),
+      ec);
+  if (ec) {
+    return -1;
+  }
+  for (; !path.empty() && path != "/sys/devices" && path != "/";
+       path = path.parent_path()) {
+    std::string value;
+    if (!readSysfsFile((path / "numa_node").string(), &value) &&
+        !readSysfsFile((path / "device" / "numa_node").string(), &value)) {
+      continue;
+    }
+    auto node = folly::tryTo<int>(value);
+    // -1 means the device doesn't know. A parent might.
+    if (node.hasValue() && node.value() >= 0) {
+      return node.value();
+    }
+  }
+  return -1;
+}
+
+int setThreadCPUAffinity(pid_t tid, const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+    CPU_SET(cpu, &set);
+  }
+  if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+    ld_error("sched_setaffinity(%d, %s) failed: %s",
+             (int)tid,
+             formatCPUList(cpus).c_str(),
+             strerror(errno));
+    err = E::SYSLIMIT;
+    return -1;
+  }
+  return 0;
+}
+
+std::vector<int> getThreadCPUAffinity(pid_t tid) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(tid, sizeof(set), &set) != 0) {
+    return {};
+  }
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<int> parseCPUList(const std::string& s) {
+  std::vector<int> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', folly::trimWhitespace(s), ranges);
+  for (folly::StringPiece range : ranges) {
+    if (range.empty()) {
+      continue;
+    }
+    folly::StringPiece lo_str, hi_str;
+    if (!folly::split('-', range, lo_str, hi_str)) {
+      lo_str = hi_str = range;
+    }
+    auto lo = folly::tryTo<int>(lo_str);
+    auto hi = folly::tryTo<int>(hi_str);
+    if (!lo.hasValue() || !hi.hasValue() || lo.value() < 0 ||
+        hi.value() < lo.value() || hi.value() >= CPU_SETSIZE) {
+      return {};
+    }
+    for (int cpu = lo.value(); cpu <= hi.value(); ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+std::string formatCPUList(const std::vector<int>& cpus) {
+  std::string res;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    if (!res.empty()) {
+      res += ",";
+    }
+    res += folly::to<std::string>(cpus[i]);
+    if (j > i) {
+      res += folly::to<std::string>("-", cpus[j]);
+    }
+    i = j + 1;
+  }
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+/**
+ * @file Helpers for placing threads on NUMA nodes. The topology is read from
+ *       sysfs; on machines or containers where it isn't available everything
+ *       looks like a single node and nothing gets pinned.
+ */
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @return number of NUMA nodes on this machine, 1 if it can't be determined.
+ */
+int getNumaNodeCount();
+
+/**
+ * @return CPUs that belong to the given NUMA node, empty if unknown.
+ */
+std::vector<int> getNumaNodeCPUs(int node);
+
+/**
+ * @return NUMA node the block device `dev` (e.g. stat::st_dev of a file on
+ *         it) is attached to, or -1 if unknown (not a local block device, no
+ *         NUMA, etc).
+ */
+int getNumaNodeOfDevice(dev_t dev);
+
+/**
+ * Restricts the thread with kernel thread id `tid` to `cpus`.
+ *
+ * @return 0 on success, -1 on failure with err set to INVALID_PARAM if `cpus`
+ *         is empty or out of range, SYSLIMIT if sched_setaffinity() failed.
+ */
+int setThreadCPUAffinity(pid_t tid, const std::vector<int>& cpus);
+
+/**
+ * @return CPUs the thread with kernel thread id `tid` (0 for the calling
+ *         thread) may run on, empty on error.
+ */
+std::vector<int> getThreadCPUAffinity(pid_t tid);
+
+/**
+ * Parses and formats lists of CPUs in the kernel's format, e.g. "0-3,8,10-11".
+ * parseCPUList() returns an empty vector if `s` is malformed.
+ */
+std::vector<int> parseCPUList(const std::string& s);
+std::string formatCPUList(const std::vector<int>& cpus);
+
+}} // namespace facebook::logdevice
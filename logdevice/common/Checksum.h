@@ -39,6 +39,18 @@ namespace facebook { namespace logdevice {
 uint32_t checksum_32bit(Slice slice);
 uint64_t checksum_64bit(Slice slice);
 
+/**
+ * Batch versions of checksum_32bit() and checksum_64bit(): out[i] is set to
+ * the checksum of slices[i], for i in [0, count).
+ *
+ * checksum_32bit_batch() computes CRC32C of several small buffers in an
+ * interleaved fashion so that the hardware CRC instructions of independent
+ * buffers overlap in the CPU pipeline, which is considerably faster than
+ * checksumming records one by one when they are small.
+ */
+void checksum_32bit_batch(const Slice* slices, size_t count, uint32_t* out);
+void checksum_64bit_batch(const Slice* slices, size_t count, uint64_t* out);
+
 /**
  * Writes a binary checksum of the given blob to the given output buffer.  The
  * output buffer must be at least 8 bytes large to fit a 64-bit checksum.
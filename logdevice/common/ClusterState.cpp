@@ -12,6 +12,7 @@
 #include "logdevice/common/ClusterStateUpdatedRequest.h"
 #include "logdevice/common/GetClusterStateRequest.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/SequencerLocationCache.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
@@ -172,6 +173,7 @@ void ClusterState::setNodeState(node_index_t idx,
                    getNodeStateString(prev),
                    getNodeStateString(state));
 
+    processor_->sequencer_location_cache_->onNodeStateChanged(idx, state);
     postUpdateToWorkers(idx, state);
   }
 }
@@ -52,17 +52,24 @@ class ConfigurationFetchRequest : public Request {
         config_type_(config_type),
         conditional_poll_version_(conditional_poll_version) {}
 
+  /**
+   * @param delta_base_version  only for NODES_CONFIGURATION: if set, the
+   *                            reply may be a NODES_CONFIGURATION_DELTA
+   *                            against this version
+   */
   ConfigurationFetchRequest(
       NodeID node_id,
       ConfigType config_type,
       config_cb_t cb,
       worker_id_t cb_worker_id,
       std::chrono::milliseconds timeout,
-      folly::Optional<uint64_t> conditional_poll_version = folly::none)
+      folly::Optional<uint64_t> conditional_poll_version = folly::none,
+      folly::Optional<uint64_t> delta_base_version = folly::none)
       : Request(RequestType::CONFIGURATION_FETCH),
         node_id_(node_id),
         config_type_(config_type),
         conditional_poll_version_(conditional_poll_version),
+        delta_base_version_(delta_base_version),
         cb_(std::move(cb)),
         cb_worker_id_(cb_worker_id),
         timeout_(timeout) {}
@@ -102,6 +109,7 @@ class ConfigurationFetchRequest : public Request {
   NodeID node_id_;
   CONFIG_FETCH_Header::ConfigType config_type_;
   const folly::Optional<uint64_t> conditional_poll_version_;
+  const folly::Optional<uint64_t> delta_base_version_;
 
   // A callback to be called when the config is ready.
   config_cb_t cb_{};
@@ -9,6 +9,8 @@
 
 #include <algorithm>
 
+#include <folly/Random.h>
+
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/debug.h"
 
@@ -39,7 +41,14 @@ void ConnectThrottle::connectFailed() {
 
   auto time_now = now();
 
-  down_until_ = time_now + current_delay_;
+  // Peers that lost their connections at the same time would otherwise
+  // retry in lockstep, and all reconnect at the same time.
+  std::chrono::microseconds delay = current_delay_;
+  if (jitter_ > 0) {
+    delay -= std::chrono::microseconds(static_cast<int64_t>(
+        delay.count() * jitter_ * folly::Random::randDouble01()));
+  }
+  down_until_ = time_now + delay;
 
   ld_debug("at %s. set down_until_ to %s, current_delay_ to %ldms",
            SteadyTimestamp(time_now).toString().c_str(),
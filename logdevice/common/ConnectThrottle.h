@@ -23,9 +23,16 @@ namespace facebook { namespace logdevice {
 
 class ConnectThrottle {
  public:
+  /**
+   * @param jitter  fraction of each delay that is randomized: the actual
+   *                delay is picked uniformly between (1 - jitter) and 1 times
+   *                the backoff delay. Must be in [0, 1].
+   */
   explicit ConnectThrottle(
-      chrono_expbackoff_t<std::chrono::milliseconds> backoff_settings)
+      chrono_expbackoff_t<std::chrono::milliseconds> backoff_settings,
+      double jitter = 0)
       : backoff_settings_(std::move(backoff_settings)),
+        jitter_(jitter),
         current_delay_(std::chrono::milliseconds::zero()),
         down_until_(std::chrono::steady_clock::time_point::min()) {}
 
@@ -55,7 +62,9 @@ class ConnectThrottle {
 
  private:
   chrono_expbackoff_t<std::chrono::milliseconds> backoff_settings_;
-  std::chrono::milliseconds current_delay_; // last delay between reconnection
+  const double jitter_;
+  // last delay between reconnection, before jitter
+  std::chrono::milliseconds current_delay_;
 
   // reject connection attempts until std::chrono::steady_clock is
   // past this deadline. A call to connectSucceeded(true) resets the
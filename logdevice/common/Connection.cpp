@@ -38,6 +38,7 @@
 #include "logdevice/common/network/SessionInjectorCallback.h"
 #include "logdevice/common/network/SocketAdapter.h"
 #include "logdevice/common/network/SocketConnectCallback.h"
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
 #include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
@@ -636,6 +637,7 @@ void Connection::close(Status reason) {
   sock_write_cb_.clear();
   sendChain_.reset();
   sched_write_chain_.cancelTimeout();
+  send_chain_messages_ = 0;
   // Invoke closeNow to close the socket.
   proto_handler_->sock()->closeNow();
 
@@ -650,6 +652,7 @@ void Connection::markDisconnectedOnClose() {
   // socket was just closed; make sure it's properly accounted for
   conn_incoming_token_.release();
   conn_external_token_.release();
+  handshake_token_.release();
 
   our_name_at_peer_ = ClientID::INVALID;
   connected_ = false;
@@ -788,15 +791,47 @@ std::unique_ptr<folly::IOBuf> Connection::serializeMessage(const Message& msg) {
   protohdr.len = io_buf->computeChainDataLength();
 
   memcpy(static_cast<void*>(io_buf->writableData()), &protohdr, protohdr_bytes);
-  return io_buf;
+  return maybeCompressMessage(msg.type_, std::move(io_buf));
+}
+
+std::unique_ptr<folly::IOBuf>
+Connection::maybeCompressMessage(MessageType type,
+                                 std::unique_ptr<folly::IOBuf> io_buf) {
+  const auto& settings = getSettings();
+  // Handshake messages go out before the protocol is negotiated.
+  if (isHandshakeMessage(type) ||
+      proto_ < Compatibility::COMPRESSED_MESSAGE_SUPPORT ||
+      settings.message_compression == Compression::NONE ||
+      flow_group_.scope() <= settings.message_compression_boundary) {
+    return io_buf;
+  }
+  const size_t len = io_buf->computeChainDataLength();
+  if (len < settings.message_compression_min_size) {
+    return io_buf;
+  }
+
+  auto frame = COMPRESSED_Message::compress(
+      *io_buf, settings.message_compression, proto_);
+  if (!frame) {
+    STAT_INCR(deps_->getStats(), message_compression_not_smaller);
+    return io_buf;
+  }
+  STAT_INCR(deps_->getStats(), messages_compressed);
+  STAT_ADD(deps_->getStats(),
+           message_compression_bytes_saved,
+           len - frame->computeChainDataLength());
+  return frame;
 }
 
 Connection::SendStatus
 Connection::sendBuffer(std::unique_ptr<folly::IOBuf>&& io_buf) {
   if (proto_handler_->good()) {
+    ++send_chain_messages_;
     if (sendChain_) {
       ld_check(sched_write_chain_.isScheduled());
-      sendChain_->prependChain(std::move(io_buf));
+      if (!coalesceIntoSendChain(*io_buf)) {
+        sendChain_->prependChain(std::move(io_buf));
+      }
     } else {
       sendChain_ = std::move(io_buf);
       ld_check(!sched_write_chain_.isScheduled());
@@ -808,6 +843,24 @@ Connection::sendBuffer(std::unique_ptr<folly::IOBuf>&& io_buf) {
   return Connection::SendStatus::SCHEDULED;
 }
 
+bool Connection::coalesceIntoSendChain(const folly::IOBuf& io_buf) {
+  // Most control messages (STORED, WINDOW, RELEASE...) are a few dozen bytes
+  // serialized into an IOBUF_ALLOCATION_UNIT buffer, so the tail of the last
+  // one usually has room for many more. Copying them there instead of
+  // chaining their own buffers cuts the number of iovecs and buffers the
+  // socket write has to go through. Buffers shared with someone else (e.g.
+  // record payloads) must not be written to.
+  folly::IOBuf* last = sendChain_->prev();
+  if (io_buf.isChained() || io_buf.length() > last->tailroom() ||
+      last->isSharedOne()) {
+    return false;
+  }
+  memcpy(last->writableTail(), io_buf.data(), io_buf.length());
+  last->append(io_buf.length());
+  STAT_INCR(deps_->getStats(), sock_messages_coalesced);
+  return true;
+}
+
 void Connection::scheduleWriteChain() {
   auto g = folly::makeGuard(deps_->setupContextGuard());
   if (!proto_handler_->good()) {
@@ -825,12 +878,36 @@ void Connection::scheduleWriteChain() {
       SocketWriteCallback::WriteUnit{bytes_in_sendq, now});
   // These bytes are now buffered in socket and will be removed from sendq.
   sock_write_cb_.bytes_buffered += bytes_in_sendq;
-  proto_handler_->sock()->writeChain(&sock_write_cb_, std::move(sendChain_));
+  const folly::WriteFlags flags = getWriteFlags(bytes_in_sendq);
+  STAT_INCR(deps_->getStats(), sock_write_chains);
+  STAT_ADD(deps_->getStats(), sock_write_chain_messages, send_chain_messages_);
+  send_chain_messages_ = 0;
+  proto_handler_->sock()->writeChain(
+      &sock_write_cb_, std::move(sendChain_), flags);
   // All the bytes will be now removed from sendq now that we have written into
   // the asyncsocket.
   onBytesAdmittedToSend(bytes_in_sendq);
 }
 
+folly::WriteFlags Connection::getWriteFlags(size_t nbytes) {
+  const size_t threshold = getSettings().zero_copy_write_threshold;
+  if (threshold == 0 || nbytes < threshold) {
+    return folly::WriteFlags::NONE;
+  }
+  if (!zero_copy_enabled_.hasValue()) {
+    zero_copy_enabled_ = proto_handler_->sock()->setZeroCopy(true);
+  }
+  // The kernel reads the buffers after writeChain() returns, so all of them
+  // must be refcounted for AsyncSocket to keep them alive until it's done.
+  // Payloads serialized with writeWithoutCopy(const void*, size_t) aren't.
+  if (!zero_copy_enabled_.value() || !sendChain_->isManaged()) {
+    STAT_INCR(deps_->getStats(), sock_zero_copy_fallbacks);
+    return folly::WriteFlags::NONE;
+  }
+  STAT_ADD(deps_->getStats(), sock_zero_copy_bytes_sent, nbytes);
+  return folly::WriteFlags::WRITE_MSG_ZEROCOPY;
+}
+
 int Connection::serializeMessage(std::unique_ptr<Envelope>&& envelope) {
   // We should only write to the output buffer once connected.
   ld_check(connected_);
@@ -1363,6 +1440,9 @@ bool Connection::processHandshakeMessage(const Message* msg) {
 
 int Connection::dispatchMessageBody(ProtocolHeader header,
                                     std::unique_ptr<folly::IOBuf> inbuf) {
+  if (header.type == MessageType::COMPRESSED) {
+    return dispatchCompressedMessage(std::move(inbuf));
+  }
   auto g = folly::makeGuard(deps_->setupContextGuard());
   ProtocolHeader& ph = header;
   // Tell the Worker that we're processing a message, so it can time it.
@@ -1486,6 +1566,7 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
     handshaken_ = true;
     first_attempt_ = false;
     handshake_timeout_event_.cancelTimeout();
+    handshake_token_.release();
   }
 
   MESSAGE_TYPE_STAT_INCR(deps_->getStats(), ph.type, message_received);
@@ -1533,6 +1614,61 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
   return 0;
 }
 
+int Connection::dispatchCompressedMessage(std::unique_ptr<folly::IOBuf> body) {
+  if (proto_ < Compatibility::COMPRESSED_MESSAGE_SUPPORT) {
+    ld_error("PROTOCOL ERROR: got a COMPRESSED message from peer %s, which "
+             "negotiated protocol %hu",
+             conn_description_.c_str(),
+             proto_);
+    err = E::BADMSG;
+    return -1;
+  }
+  std::unique_ptr<folly::IOBuf> message = COMPRESSED_Message::decompress(*body);
+  if (!message) {
+    ld_error("PROTOCOL ERROR: got a malformed COMPRESSED message from peer %s",
+             conn_description_.c_str());
+    err = E::BADMSG;
+    return -1;
+  }
+
+  ProtocolHeader header;
+  const size_t min_protohdr_bytes =
+      sizeof(ProtocolHeader) - sizeof(ProtocolHeader::cksum);
+  if (message->length() <= min_protohdr_bytes) {
+    ld_error("PROTOCOL ERROR: COMPRESSED message from peer %s wraps a "
+             "%zu-byte message",
+             conn_description_.c_str(),
+             message->length());
+    err = E::BADMSG;
+    return -1;
+  }
+  memcpy(&header, message->data(), min_protohdr_bytes);
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(header.type, proto_);
+  if (header.type == MessageType::COMPRESSED ||
+      isHandshakeMessage(header.type) || header.len != message->length() ||
+      header.len < protohdr_bytes ||
+      !proto_handler_->validateProtocolHeader(header)) {
+    ld_error("PROTOCOL ERROR: COMPRESSED message from peer %s wraps an "
+             "invalid message of type %s, length %u (decompressed %zu)",
+             conn_description_.c_str(),
+             messageTypeNames()[header.type].c_str(),
+             header.len,
+             message->length());
+    err = E::BADMSG;
+    return -1;
+  }
+  if (ProtocolHeader::needChecksumInHeader(header.type, proto_)) {
+    memcpy(&header.cksum,
+           message->data() + min_protohdr_bytes,
+           sizeof(ProtocolHeader::cksum));
+  }
+  message->trimStart(protohdr_bytes);
+
+  STAT_INCR(deps_->getStats(), messages_decompressed);
+  return dispatchMessageBody(header, std::move(message));
+}
+
 int Connection::pushOnCloseCallback(SocketCallback& cb) {
   if (cb.active()) {
     RATELIMIT_CRITICAL(
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <memory>
 
+#include <folly/Optional.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/AsyncTimeout.h>
@@ -531,6 +532,15 @@ class Connection : public TrafficShappingSocket {
     connect_throttle_ = throttle;
   }
 
+  /**
+   * Holds the token until the handshake is received from the peer, or the
+   * connection is closed.
+   */
+  void setHandshakeToken(ResourceBudget::Token token) {
+    handshake_token_.release();
+    handshake_token_ = std::move(token);
+  }
+
   void dumpQueuedMessages(std::map<MessageType, int>* out) const;
 
   /**
@@ -677,6 +687,14 @@ class Connection : public TrafficShappingSocket {
    * @returns SendStatus based on the status of the write.
    */
   SendStatus sendBuffer(std::unique_ptr<folly::IOBuf>&& buffer_chain);
+
+  /**
+   * Copies `io_buf` into the tailroom of the last buffer of sendChain_ if it
+   * fits and that buffer is not shared.
+   *
+   * @return true if `io_buf` was copied and can be dropped.
+   */
+  bool coalesceIntoSendChain(const folly::IOBuf& io_buf);
   /**
    * For asyncsocket based connections, to batch data better we schedule a zero
    * timeout event in sendBuffer. It allows to batch all the data going to same
@@ -684,6 +702,13 @@ class Connection : public TrafficShappingSocket {
    */
   void scheduleWriteChain();
 
+  /**
+   * Flags for writing the next `nbytes` of sendChain_ into the socket:
+   * MSG_ZEROCOPY if the write is at least --zero-copy-write-threshold bytes
+   * and can be sent zero-copy.
+   */
+  folly::WriteFlags getWriteFlags(size_t nbytes);
+
   void onSent(std::unique_ptr<Envelope>,
               Status,
               Message::CompletionMethod = Message::CompletionMethod::IMMEDIATE);
@@ -769,6 +794,27 @@ class Connection : public TrafficShappingSocket {
    */
   std::unique_ptr<folly::IOBuf> serializeMessage(const Message& msg);
 
+  /**
+   * Wraps a message serialized by serializeMessage() into a COMPRESSED frame
+   * if the peer supports it, the connection crosses
+   * --message-compression-boundary, the message is at least
+   * --message-compression-min-size bytes and compression makes it smaller.
+   *
+   * @return the frame, or `io_buf` itself if it's sent uncompressed.
+   */
+  std::unique_ptr<folly::IOBuf>
+  maybeCompressMessage(MessageType type, std::unique_ptr<folly::IOBuf> io_buf);
+
+  /**
+   * Unwraps a COMPRESSED frame and dispatches the message inside with
+   * dispatchMessageBody().
+   *
+   * @param body  the frame without its ProtocolHeader.
+   * @return the result of dispatchMessageBody(), or -1 with err set to
+   *         E::BADMSG if the frame or the message inside is malformed.
+   */
+  int dispatchCompressedMessage(std::unique_ptr<folly::IOBuf> body);
+
   /**
    * Allow the async message error simulator to optionally take ownership of
    * this message just before it is sent.
@@ -1061,6 +1107,8 @@ class Connection : public TrafficShappingSocket {
   // fds for all accepted and client-only connections.
   ResourceBudget::Token conn_incoming_token_;
   ResourceBudget::Token conn_external_token_;
+  // See setHandshakeToken().
+  ResourceBudget::Token handshake_token_;
 
   // called when the end_stream_rewind_event_ is signed.
   static void endStreamRewindCallback(void* instance, short);
@@ -1100,6 +1148,9 @@ class Connection : public TrafficShappingSocket {
   // not invoke computeChainDataLength on it frequently.
   std::unique_ptr<folly::IOBuf> sendChain_;
 
+  // Number of messages in sendChain_.
+  size_t send_chain_messages_{0};
+
   // Timer used to schedule event as soon as data is added to sendChain_.The
   // callback of this timer add data into the asyncsocket.
   EvTimer sched_write_chain_;
@@ -1107,6 +1158,10 @@ class Connection : public TrafficShappingSocket {
   // Used to note down delays in writing into the asyncsocket.
   SteadyTimestamp sched_start_time_;
 
+  // Whether MSG_ZEROCOPY is enabled on the socket. folly::none until the first
+  // write of at least --zero-copy-write-threshold bytes tries to enable it.
+  folly::Optional<bool> zero_copy_enabled_;
+
   /**
    * For Testing only!
    */
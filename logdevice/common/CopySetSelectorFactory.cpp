@@ -63,7 +63,9 @@ std::unique_ptr<CopySetSelector> CopySetSelectorFactory::create(
         locality_enabled,
         Worker::stats(),
         init_rng,
-        print_bias_warnings);
+        print_bias_warnings,
+        CopySetSelectorDependencies::instance(),
+        settings.copyset_table_size);
   }
 
   if (legacy_replication->sync_replication_scope == NodeLocationScope::NODE ||
@@ -118,7 +120,9 @@ std::unique_ptr<CopySetManager> CopySetSelectorFactory::createManager(
         new StickyCopySetManager(std::move(copyset_selector),
                                  nodeset_state,
                                  sticky_copysets_block_size,
-                                 sticky_copysets_block_max_time));
+                                 sticky_copysets_block_max_time,
+                                 CopySetSelectorDependencies::instance(),
+                                 settings.sticky_copysets_block_max_size));
   } else {
     res = std::unique_ptr<CopySetManager>(new PassThroughCopySetManager(
         std::move(copyset_selector), nodeset_state));
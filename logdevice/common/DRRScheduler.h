@@ -94,6 +94,13 @@ class DRRStats {
   uint64_t bytesProcessed;
 };
 
+// Current state of the queue of one principal.
+struct DRRQueueInfo {
+  DRRPrincipal principal;
+  uint64_t numReqs;
+  uint64_t deficit;
+};
+
 class DRRStatsSnapshot {
  public:
   /*
@@ -325,6 +332,20 @@ class DRRScheduler {
     return numReqs_;
   }
 
+  /*
+   * Returns the number of queued requests and the deficit of each principal.
+   */
+  std::vector<DRRQueueInfo> getQueueInfo() {
+    std::vector<DRRQueueInfo> res;
+    std::unique_lock<std::mutex> lock(mutex_);
+    res.reserve(queues_.size());
+    for (const auto& q : queues_) {
+      res.push_back(
+          DRRQueueInfo{q->stats_.principal, q->numReqs_, q->deficit_});
+    }
+    return res;
+  }
+
   /*
    * This function introspects contents of the queue
    * and calls cb() on every element.
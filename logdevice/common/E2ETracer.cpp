@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/E2ETracer.h"
+
+#include <folly/Format.h>
+#include <folly/Random.h>
+
+#include "logdevice/common/TraceLogger.h"
+#include "logdevice/common/TraceSample.h"
+
+namespace facebook { namespace logdevice {
+
+E2ETracer::E2ETracer(std::shared_ptr<TraceLogger> logger)
+    : SampledTracer(std::move(logger)) {}
+
+e2e_trace_id_t E2ETracer::startTrace() {
+  if (!shouldSample(E2E_TRACER)) {
+    return E2E_TRACE_ID_INVALID;
+  }
+  uint64_t id;
+  do {
+    id = folly::Random::rand64();
+  } while (id == E2E_TRACE_ID_INVALID.val());
+  return e2e_trace_id_t(id);
+}
+
+void E2ETracer::traceSpan(
+    e2e_trace_id_t trace_id,
+    const char* span,
+    logid_t log_id,
+    lsn_t lsn,
+    Status status,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end,
+    std::initializer_list<std::pair<const char*, int64_t>> details) {
+  if (trace_id == E2E_TRACE_ID_INVALID) {
+    return;
+  }
+  auto sample_builder = [&]() -> std::unique_ptr<TraceSample> {
+    auto sample = std::make_unique<TraceSample>();
+    const auto duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    // Spans of a trace come from different nodes, so they are ordered by
+    // wall clock time.
+    const auto start_time = std::chrono::system_clock::now() -
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::steady_clock::now() - start);
+
+    sample->addNormalValue(
+        "trace_id", folly::sformat("{:016x}", trace_id.val()));
+    sample->addNormalValue("span", span);
+    const auto& my_node_id = logger_->getMyNodeID();
+    sample->addNormalValue(
+        "node", my_node_id.has_value() ? my_node_id->toString() : "client");
+    sample->addNormalValue("log_id", std::to_string(log_id.val()));
+    sample->addNormalValue("lsn", lsn_to_string(lsn));
+    sample->addNormalValue("status", error_name(status));
+    sample->addIntValue(
+        "start_time_us",
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            start_time.time_since_epoch())
+            .count());
+    sample->addIntValue("duration_us", duration.count());
+    for (const auto& detail : details) {
+      sample->addIntValue(detail.first, detail.second);
+    }
+    return sample;
+  };
+  // The coin was flipped by whoever started the trace.
+  publish(E2E_TRACER, sample_builder, /* force */ true);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "logdevice/common/SampledTracer.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+class TraceLogger;
+
+constexpr auto E2E_TRACER = "e2e_tracer";
+
+/**
+ * @file Follows a sampled subset of appends and read streams through the
+ *       cluster. The node where the operation starts (the client for appends
+ *       and reads) decides whether to trace it, with the sampling percentage
+ *       configured for e2e_tracer, and picks a random trace id. The id is
+ *       carried in APPEND, STORE and START messages, and every hop that sees
+ *       a valid id publishes a span: a sample of the e2e_tracer table
+ *       describing one step of the operation, with the trace id, the span
+ *       name, the node and the start time and duration of the step. Joining
+ *       the spans by trace id shows where the time of a slow operation went.
+ *       Nothing is traced unless a sampling percentage is configured for
+ *       e2e_tracer explicitly.
+ *
+ *       Spans:
+ *         client_append       AppendRequest, from creation to completion
+ *         sequencer_append    Appender, from receipt of APPEND to the reply
+ *         store               storage node, from receipt of STORE to STORED
+ *         write_storage_task  storage node, from queueing the write to the
+ *                             local log store to its completion
+ *         catchup_read        storage node, one batch of records read for a
+ *                             traced read stream
+ */
+class E2ETracer : SampledTracer {
+ public:
+  explicit E2ETracer(std::shared_ptr<TraceLogger> logger);
+
+  /**
+   * Decides whether to trace an operation that starts on this node.
+   *
+   * @return  a new random trace id, or E2E_TRACE_ID_INVALID if the operation
+   *          is not sampled or there is no TraceLogger
+   */
+  e2e_trace_id_t startTrace();
+
+  /**
+   * Publishes a span of trace `trace_id`. Does nothing if `trace_id` is
+   * E2E_TRACE_ID_INVALID, so that callers don't need to check.
+   *
+   * @param span     name of the step, see above
+   * @param start    when the step started
+   * @param end      when the step ended
+   * @param details  additional integer fields of the span
+   */
+  void traceSpan(e2e_trace_id_t trace_id,
+                 const char* span,
+                 logid_t log_id,
+                 lsn_t lsn,
+                 Status status,
+                 std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end =
+                     std::chrono::steady_clock::now(),
+                 std::initializer_list<std::pair<const char*, int64_t>>
+                     details = {});
+
+ private:
+  folly::Optional<double> getDefaultSamplePercentage() const override {
+    return 0;
+  }
+};
+
+}} // namespace facebook::logdevice
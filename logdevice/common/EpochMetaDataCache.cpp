@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/EpochMetaDataCache.h"
 
+#include <tuple>
+
 namespace facebook { namespace logdevice {
 
 EpochMetaDataCache::EpochMetaDataCache(size_t max_entries)
@@ -97,4 +99,43 @@ void EpochMetaDataCache::setMetaData(logid_t logid,
   cache_.set(std::make_pair(logid, epoch), {until, source, metadata});
 }
 
+EpochMetaDataCache::PendingRead::PendingRead(EpochMetaDataCache* cache,
+                                             logid_t logid,
+                                             epoch_t epoch)
+    : cache_(cache), logid_(logid), epoch_(epoch) {}
+
+EpochMetaDataCache::PendingRead::~PendingRead() {
+  cache_->finishRead(logid_, epoch_);
+}
+
+std::unique_ptr<EpochMetaDataCache::PendingRead>
+EpochMetaDataCache::startOrJoinRead(logid_t logid,
+                                    epoch_t epoch,
+                                    folly::Function<void()> on_done) {
+  std::lock_guard<std::mutex> guard(pending_reads_mutex_);
+  auto res = pending_reads_.emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(logid, epoch),
+      std::forward_as_tuple());
+  if (!res.second) {
+    res.first->second.push_back(std::move(on_done));
+    return nullptr;
+  }
+  return std::unique_ptr<PendingRead>(new PendingRead(this, logid, epoch));
+}
+
+void EpochMetaDataCache::finishRead(logid_t logid, epoch_t epoch) {
+  std::vector<folly::Function<void()>> waiters;
+  {
+    std::lock_guard<std::mutex> guard(pending_reads_mutex_);
+    auto it = pending_reads_.find(std::make_pair(logid, epoch));
+    ld_check(it != pending_reads_.end());
+    waiters = std::move(it->second);
+    pending_reads_.erase(it);
+  }
+  for (auto& on_done : waiters) {
+    on_done();
+  }
+}
+
 }} // namespace facebook::logdevice
@@ -7,9 +7,14 @@
  */
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
+#include <folly/Function.h>
 #include <folly/SharedMutex.h>
 #include <folly/container/EvictingCacheMap.h>
 #include <folly/hash/Hash.h>
@@ -38,6 +43,10 @@ namespace facebook { namespace logdevice {
  *  The cache is meant to be shared among all worker threads and is proteceted
  *  by locks.
  *
+ *  The cache also lets its users deduplicate concurrent reads of the same
+ *  epoch metadata (see startOrJoinRead()), so that many read streams
+ *  starting on the same log at the same time read the metadata log once.
+ *
  * TODO: write our own LRU cache implementation that supports:
  *       1) epoch interval ranged looked up
  *       2) finer grained locking
@@ -80,6 +89,34 @@ class EpochMetaDataCache : boost::noncopyable {
                    RecordSource source,
                    const EpochMetaData& metadata);
 
+  // Held by the user that reads the epoch metadata for a <logid, epoch> after
+  // a cache miss. Destroying it, once the result is in the cache (or the read
+  // failed or was abandoned), wakes up the users that joined the read.
+  class PendingRead : boost::noncopyable {
+   public:
+    ~PendingRead();
+
+   private:
+    friend class EpochMetaDataCache;
+    PendingRead(EpochMetaDataCache* cache, logid_t logid, epoch_t epoch);
+
+    EpochMetaDataCache* const cache_;
+    const logid_t logid_;
+    const epoch_t epoch_;
+  };
+
+  // Called after a cache miss, before reading the epoch metadata for @param
+  // logid and @param epoch.
+  //
+  // @return  a PendingRead if no one else is reading it; the caller should
+  //          then read it and keep the PendingRead until the result is in
+  //          the cache. Otherwise nullptr, and @param on_done will be called,
+  //          on the thread that destroys the PendingRead, when that read
+  //          completes; the caller should look up the cache again then.
+  std::unique_ptr<PendingRead> startOrJoinRead(logid_t logid,
+                                               epoch_t epoch,
+                                               folly::Function<void()> on_done);
+
  private:
   using Key = std::pair<logid_t, epoch_t>;
 
@@ -101,6 +138,14 @@ class EpochMetaDataCache : boost::noncopyable {
 
   // protect the access to lru_cache_
   folly::SharedMutex cache_mutex_;
+
+  // Reads started with startOrJoinRead(), with the callbacks of the users
+  // waiting for them.
+  std::unordered_map<Key, std::vector<folly::Function<void()>>, KeyHasher>
+      pending_reads_;
+  std::mutex pending_reads_mutex_;
+
+  void finishRead(logid_t logid, epoch_t epoch);
 };
 
 }} // namespace facebook::logdevice
@@ -133,7 +133,8 @@ UpdateResult updateMetaDataIfNeeded(
     bool use_storage_set_format,
     bool provision_if_empty,
     bool update_if_exists,
-    bool force_update) {
+    bool force_update,
+    const NodeSetSelector::Options* nodeset_options) {
   const auto logcfg = config.getLogGroupByIDShared(log_id);
   if (!logcfg) {
     err = E::NOTFOUND;
@@ -194,7 +195,7 @@ UpdateResult updateMetaDataIfNeeded(
       target_nodeset_size.value(),
       nodeset_seed.value(),
       prev_metadata_exists ? metadata.get() : nullptr,
-      nullptr);
+      nodeset_options);
 
   UpdateResult result =
       prev_metadata_exists ? UpdateResult::UNCHANGED : UpdateResult::CREATED;
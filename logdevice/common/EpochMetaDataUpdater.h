@@ -74,6 +74,8 @@ namespace facebook { namespace logdevice {
  *   WRITTEN_IN_METADATALOG flag, then update_if_exists must be false.
  * @param force_update
  *   Update the metadata even if the nodeset doesn't change.
+ * @param nodeset_options
+ *   Passed to the nodeset selector, e.g. to select the nodeset incrementally.
  */
 EpochMetaData::UpdateResult updateMetaDataIfNeeded(
     logid_t log_id,
@@ -86,7 +88,8 @@ EpochMetaData::UpdateResult updateMetaDataIfNeeded(
     bool use_storage_set_format,
     bool provision_if_empty = false,
     bool update_if_exists = true,
-    bool force_update = false);
+    bool force_update = false,
+    const NodeSetSelector::Options* nodeset_options = nullptr);
 
 // This class is only used in tests and in deprecated metadata-utility.
 // Normally metadata updates happen together with activating sequencer using
@@ -129,6 +129,16 @@ void EventLoop::addWithPriority(folly::Function<void()> func, int8_t priority) {
       priority_queues_enabled_ ? priority : folly::Executor::HI_PRI);
 }
 
+void EventLoop::addBatchWithPriority(
+    std::vector<std::pair<folly::Function<void()>, int8_t>> funcs) {
+  if (!priority_queues_enabled_) {
+    for (auto& f : funcs) {
+      f.second = folly::Executor::HI_PRI;
+    }
+  }
+  task_queue_->addBatchWithPriority(std::move(funcs));
+}
+
 Status EventLoop::init(
     EvBase::EvBaseType base_type,
     size_t request_pump_capacity,
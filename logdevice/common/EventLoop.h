@@ -14,6 +14,8 @@
 #include <semaphore.h>
 #include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <folly/Executor.h>
 
@@ -93,6 +95,13 @@ class EventLoop : public folly::Executor {
    */
   void addWithPriority(folly::Function<void()>, int8_t priority) override;
 
+  /**
+   * Enqueues several functions with their priorities at once, waking up the
+   * event loop thread only once. See EventLoopTaskQueue::addBatchWithPriority.
+   */
+  void addBatchWithPriority(
+      std::vector<std::pair<folly::Function<void()>, int8_t>> funcs);
+
   /**
    * Get the thread handle of this EventLoop.
    *
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/EventLoopProfiler.h"
+
+#include <algorithm>
+
+#include <folly/Random.h>
+
+namespace facebook { namespace logdevice {
+
+namespace {
+constexpr size_t kNumRequestTypes = static_cast<size_t>(RequestType::MAX);
+constexpr size_t kNumMessageTypes = static_cast<size_t>(MessageType::MAX);
+constexpr size_t kNumStorageTaskTypes =
+    static_cast<size_t>(StorageTaskType::MAX);
+} // namespace
+
+EventLoopProfiler::EventLoopProfiler()
+    : entries_(1 + kNumRequestTypes + kNumMessageTypes + kNumStorageTaskTypes) {
+}
+
+size_t EventLoopProfiler::indexOf(const RunContext& context) {
+  switch (context.type_) {
+    case RunContext::NONE:
+      return 0;
+    case RunContext::REQUEST:
+      return 1 + static_cast<size_t>(context.subtype_.request);
+    case RunContext::MESSAGE:
+      return 1 + kNumRequestTypes +
+          static_cast<size_t>(context.subtype_.message);
+    case RunContext::STORAGE_TASK_RESPONSE:
+      return 1 + kNumRequestTypes + kNumMessageTypes +
+          static_cast<size_t>(context.subtype_.storage_task);
+  }
+  ld_check(false);
+  return 0;
+}
+
+void EventLoopProfiler::onStarted(RunContext context,
+                                  std::chrono::steady_clock::time_point start) {
+  running_since_.store(
+      start.time_since_epoch().count(), std::memory_order_relaxed);
+  running_.store(context.pack(), std::memory_order_relaxed);
+}
+
+void EventLoopProfiler::onStopped(RunContext context,
+                                  std::chrono::steady_clock::duration duration,
+                                  double sampling_rate) {
+  running_.store(RunContext().pack(), std::memory_order_relaxed);
+
+  size_t idx = indexOf(context);
+  ld_check(idx < entries_.size());
+  Entry& entry = entries_[idx];
+  auto usec = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+  if (usec > entry.max || entry.max_time.time_since_epoch().count() == 0) {
+    entry.context = context;
+    entry.max = usec;
+    entry.max_time = std::chrono::system_clock::now();
+  }
+  if (sampling_rate > 0 &&
+      (sampling_rate >= 1 || folly::Random::randDouble01() < sampling_rate)) {
+    ++entry.sampled;
+    entry.total += usec;
+  }
+}
+
+std::pair<RunContext, std::chrono::steady_clock::duration>
+EventLoopProfiler::currentlyRunning() const {
+  RunContext context =
+      RunContext::unpack(running_.load(std::memory_order_relaxed));
+  if (context.type_ == RunContext::NONE) {
+    return std::make_pair(context, std::chrono::steady_clock::duration(0));
+  }
+  std::chrono::steady_clock::time_point since(std::chrono::steady_clock::duration(
+      running_since_.load(std::memory_order_relaxed)));
+  return std::make_pair(context, std::chrono::steady_clock::now() - since);
+}
+
+std::vector<EventLoopProfiler::Entry> EventLoopProfiler::getEntries() const {
+  std::vector<Entry> res;
+  for (const Entry& entry : entries_) {
+    if (entry.max_time.time_since_epoch().count() != 0) {
+      res.push_back(entry);
+    }
+  }
+  std::sort(res.begin(), res.end(), [](const Entry& a, const Entry& b) {
+    return a.max > b.max;
+  });
+  return res;
+}
+
+void EventLoopProfiler::reset() {
+  std::fill(entries_.begin(), entries_.end(), Entry());
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "logdevice/common/RunContext.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Keeps track of how long the request executions, message callbacks and
+ *       storage task responses run on an event loop take, by type, so that the
+ *       handlers that block the loop the most can be found.
+ *
+ *       The maximum duration of each type is always tracked. The count and the
+ *       total duration, which are used to compute the average, are only
+ *       updated for a sampled subset of executions.
+ *
+ *       Apart from currentlyRunning(), which may be called from any thread,
+ *       all methods must be called from the thread running the event loop.
+ */
+
+class EventLoopProfiler {
+ public:
+  struct Entry {
+    RunContext context;
+    // Number of sampled executions and their total duration.
+    uint64_t sampled{0};
+    std::chrono::microseconds total{0};
+    // Longest execution seen, sampled or not, and when it finished.
+    std::chrono::microseconds max{0};
+    std::chrono::system_clock::time_point max_time;
+  };
+
+  EventLoopProfiler();
+
+  /**
+   * Called when `context` starts (or, after being interrupted by a nested
+   * context, resumes) running on the event loop.
+   *
+   * @param start  when `context` started running
+   */
+  void onStarted(RunContext context,
+                 std::chrono::steady_clock::time_point start);
+
+  /**
+   * Called when `context` is done running on the event loop.
+   *
+   * @param duration       how long it ran for
+   * @param sampling_rate  probability in [0, 1] that this execution
+   *                       contributes to the count and average duration
+   */
+  void onStopped(RunContext context,
+                 std::chrono::steady_clock::duration duration,
+                 double sampling_rate);
+
+  /**
+   * @return what's running on the event loop right now and for how long it
+   *         has been running. Safe to call from any thread.
+   */
+  std::pair<RunContext, std::chrono::steady_clock::duration>
+  currentlyRunning() const;
+
+  /**
+   * @return entries of all types that ran at least once, the slowest first
+   *         (by max duration).
+   */
+  std::vector<Entry> getEntries() const;
+
+  void reset();
+
+ private:
+  // Index of the entry for `context` in entries_.
+  static size_t indexOf(const RunContext& context);
+
+  std::vector<Entry> entries_;
+
+  // Published by onStarted() for currentlyRunning().
+  std::atomic<uint32_t> running_{0};
+  std::atomic<std::chrono::steady_clock::rep> running_since_{0};
+};
+
+}} // namespace facebook::logdevice
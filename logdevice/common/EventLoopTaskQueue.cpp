@@ -15,6 +15,7 @@
 #include "logdevice/common/EventLoop.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/libevent/compat.h"
+#include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
 
@@ -95,6 +96,26 @@ int EventLoopTaskQueue::addWithPriority(Func func, int8_t priority) {
   return 0;
 }
 
+int EventLoopTaskQueue::addBatchWithPriority(
+    std::vector<std::pair<Func, int8_t>> funcs) {
+  if (UNLIKELY(sem_.isShutdown())) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+  if (funcs.empty()) {
+    return 0;
+  }
+  auto ctx = folly::RequestContext::saveContext();
+  for (auto& f : funcs) {
+    ld_check(f.first);
+    Task t(std::move(f.first), ctx);
+    queues_[translatePriority(f.second)].enqueue(std::move(t));
+  }
+  // A single post for the whole batch, so the eventloop is woken up once.
+  sem_.post(funcs.size());
+  return 0;
+}
+
 void EventLoopTaskQueue::haveTasksEventHandler() {
   ld_check(sem_waiter_);
   try {
@@ -104,6 +125,14 @@ void EventLoopTaskQueue::haveTasksEventHandler() {
     // items in the UMPSCQueue, because the producer pushes into the queue
     // first then increments the semaphore.
     sem_waiter_->processBatch(cb, total_dequeues_per_iteration_);
+
+    // If busy polling is on and there are no more tasks, spin for a bit
+    // rather than going to sleep in the event loop, so that a task posted
+    // shortly doesn't need a wakeup through the kernel. Once one arrives the
+    // fd is readable, and the event loop calls us again right away.
+    if (busy_poller_.enabled() && !sem_waiter_->is_readable()) {
+      busy_poller_.spin([this] { return sem_waiter_->is_readable(); });
+    }
   } catch (const folly::ShutdownSemError&) {
     // First delete the event since the fd is about to go away
     ld_check(tasks_pending_event_);
@@ -127,9 +156,12 @@ void EventLoopTaskQueue::executeTasks(uint32_t tokens) {
   std::array<uint32_t, kNumberOfPriorities> dequeues_to_execute{0};
   std::array<uint32_t, kNumberOfPriorities> tasks_available{0};
 
+  for (uint32_t i = 0; i < tasks_available.size(); ++i) {
+    tasks_available[i] = queues_[i].size();
+  }
+
   // Assign just the required slots first.
   for (uint32_t i = 0; tokens > 0 && i < dequeues_to_execute.size(); ++i) {
-    tasks_available[i] = queues_[i].size();
     dequeues_to_execute[i] = std::min(
         std::min(tasks_available[i], dequeues_per_iteration_[i]), tokens);
     tokens -= dequeues_to_execute[i];
@@ -144,6 +176,24 @@ void EventLoopTaskQueue::executeTasks(uint32_t tokens) {
     dequeues_to_execute[i] += dequeues;
   }
 
+  if (stats_) {
+    for (size_t i = 0; i < dequeues_to_execute.size(); ++i) {
+      if (tasks_available[i] > 0 && dequeues_to_execute[i] == 0) {
+        switch (kLookupTable[i]) {
+          case folly::Executor::HI_PRI:
+            STAT_INCR(stats_, worker_starved_hi_pri_iterations);
+            break;
+          case folly::Executor::MID_PRI:
+            STAT_INCR(stats_, worker_starved_mid_pri_iterations);
+            break;
+          default:
+            STAT_INCR(stats_, worker_starved_lo_pri_iterations);
+            break;
+        }
+      }
+    }
+  }
+
   for (size_t i = 0; i < dequeues_to_execute.size(); ++i) {
     while (dequeues_to_execute[i]--) {
       auto t = queues_[i].dequeue();
@@ -7,20 +7,25 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <numeric>
+#include <utility>
+#include <vector>
 
 #include <folly/Executor.h>
 #include <folly/Function.h>
 #include <folly/concurrency/UnboundedQueue.h>
 #include <folly/io/async/Request.h>
 
+#include "logdevice/common/BusyPoller.h"
 #include "logdevice/common/LifoEventSem.h"
 #include "logdevice/common/libevent/LibEventCompatibility.h"
 
 namespace facebook { namespace logdevice {
 using Func = folly::Function<void()>;
 struct EventLoopTaskQueueImpl;
+class StatsHolder;
 
 /**
  * @file This is a specialized bufferevent-type state machine that allows work
@@ -88,6 +93,14 @@ class EventLoopTaskQueue {
     return addWithPriority(std::move(func), folly::Executor::LO_PRI);
   }
 
+  /**
+   * Same as calling addWithPriority() for each element of `funcs` in order,
+   * but wakes up the eventloop thread only once for the whole batch.
+   *
+   * Can be invoked from any thread.
+   */
+  virtual int addBatchWithPriority(std::vector<std::pair<Func, int8_t>> funcs);
+
   /*
    * Checks if the queue is filled up to the soft capacity limit.
    */
@@ -127,9 +140,32 @@ class EventLoopTaskQueue {
                         uint32_t(0));
   }
 
+  /**
+   * Sets where to report iterations in which a priority got starved (had
+   * tasks queued but didn't get any of the budget). nullptr, the default,
+   * disables reporting. Must be called before the event loop starts.
+   */
+  void setStats(StatsHolder* stats) {
+    stats_ = stats;
+    busy_poller_.setStats(stats);
+  }
+
+  /**
+   * Makes the event loop spin for up to `max_spin` after running out of
+   * tasks, before going back to sleep, see BusyPoller. While spinning, the
+   * loop doesn't service its other events, so `max_spin` should be small.
+   * 0 disables spinning. Must be called on the event loop thread.
+   */
+  void setBusyPoll(std::chrono::microseconds max_spin, double cpu_budget) {
+    busy_poller_.configure(max_spin, cpu_budget);
+  }
+
  private:
   EvBase& base_;
 
+  StatsHolder* stats_{nullptr};
+  BusyPoller busy_poller_;
+
   class Task {
    public:
     explicit Task(Func func, std::shared_ptr<folly::RequestContext> ctx)
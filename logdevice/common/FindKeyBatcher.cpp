@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/FindKeyBatcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/FindKeyRequest.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+FindKeyBatcher::FindKeyBatcher() : flush_timer_([this] { flushAll(); }) {}
+
+bool FindKeyBatcher::add(const FINDKEY_Header& header, NodeID to) {
+  Worker* w = Worker::onThisThread();
+  if (w->settings().findkey_batch_size <= 1 ||
+      !FINDKEY_BATCH_Message::canBatch(header)) {
+    return false;
+  }
+  // If there is no connection to the node yet, assume it is running the same
+  // version as us. If it doesn't, the batch will fail with E::PROTONOSUPPORT
+  // and every request will resend its own FINDKEY.
+  auto proto = w->sender().getSocketProtocolVersion(to.index());
+  if (proto.hasValue() &&
+      proto.value() < Compatibility::FINDKEY_BATCH_SUPPORT) {
+    return false;
+  }
+
+  pending_[to.index()].push_back(header);
+  if (!flush_timer_.isActive()) {
+    flush_timer_.activate(std::chrono::microseconds(0));
+  }
+  return true;
+}
+
+void FindKeyBatcher::flushAll() {
+  auto pending = std::move(pending_);
+  pending_.clear();
+
+  const size_t max_batch_size = Worker::settings().findkey_batch_size;
+  for (auto& kv : pending) {
+    std::vector<FINDKEY_Header>& headers = kv.second;
+    for (size_t begin = 0; begin < headers.size(); begin += max_batch_size) {
+      const size_t end = std::min(begin + max_batch_size, headers.size());
+      flush(kv.first,
+            std::vector<FINDKEY_Header>(
+                headers.begin() + begin, headers.begin() + end));
+    }
+  }
+}
+
+void FindKeyBatcher::flush(node_index_t to,
+                           std::vector<FINDKEY_Header> headers) {
+  ld_check(!headers.empty());
+
+  std::unique_ptr<Message> msg;
+  if (headers.size() == 1) {
+    msg = std::make_unique<FINDKEY_Message>(headers[0], folly::none);
+  } else {
+    WORKER_STAT_INCR(findkey_batches_sent);
+    WORKER_STAT_ADD(findkey_batched, headers.size());
+    msg = std::make_unique<FINDKEY_BATCH_Message>(headers);
+  }
+  if (Worker::onThisThread()->sender().sendMessage(
+          std::move(msg), NodeID(to)) == 0) {
+    return;
+  }
+
+  // The requests were told their message was sent; let them retry.
+  const Status status = err;
+  auto& rqmap = Worker::onThisThread()->runningFindKey().map;
+  for (const FINDKEY_Header& header : headers) {
+    auto it = rqmap.find(header.client_rqid);
+    if (it == rqmap.end()) {
+      continue;
+    }
+    ShardID shard(to, header.shard);
+    if (status == E::PROTONOSUPPORT && headers.size() > 1) {
+      it->second->onBatchNotSupported(shard);
+    } else {
+      it->second->onMessageSent(shard, status);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/FINDKEY_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Batches the findTime() FINDKEY messages FindKeyRequests send to the
+ *       same storage node, so that findTimeBulk() for thousands of logs
+ *       sends a few FINDKEY_BATCH messages to every node of their nodesets
+ *       instead of a FINDKEY message per log. Messages are held until the end
+ *       of the current event loop iteration, and sent in batches of at most
+ *       --findkey-batch-size entries.
+ *
+ *       Owned by the Worker running the requests, see
+ *       Worker::findKeyBatcher().
+ */
+
+class FindKeyBatcher {
+ public:
+  FindKeyBatcher();
+
+  /**
+   * Adds the message to the batch for node `to` if batching is enabled, the
+   * message can be batched and the node is not known to run a version that
+   * doesn't support FINDKEY_BATCH.
+   *
+   * Never sends anything itself, so that the outcome of the send is always
+   * reported to the FindKeyRequest asynchronously, through
+   * FindKeyRequest::onMessageSent() or FindKeyRequest::onBatchNotSupported().
+   *
+   * @return true if the message was taken, false if the caller must send a
+   *         FINDKEY message itself.
+   */
+  bool add(const FINDKEY_Header& header, NodeID to);
+
+  /**
+   * Sends all pending messages.
+   */
+  void flushAll();
+
+ private:
+  void flush(node_index_t to, std::vector<FINDKEY_Header> headers);
+
+  std::unordered_map<node_index_t, std::vector<FINDKEY_Header>> pending_;
+
+  // Zero-delay timer flushing all batches at the end of the event loop
+  // iteration in which the first of them got a message.
+  Timer flush_timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -11,6 +11,7 @@
 #include <folly/Random.h>
 
 #include "logdevice/common/EventLoop.h"
+#include "logdevice/common/FindKeyBatcher.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -138,8 +139,12 @@ StorageSetAccessor::SendResult FindKeyRequest::sendTo(ShardID shard) {
 }
 
 int FindKeyRequest::sendOneMessage(const FINDKEY_Header& header, ShardID to) {
-  auto msg = std::make_unique<FINDKEY_Message>(header, key_);
   NodeID node_id(to.node());
+  if (batching_ && !key_.hasValue() &&
+      Worker::onThisThread()->findKeyBatcher().add(header, node_id)) {
+    return 0;
+  }
+  auto msg = std::make_unique<FINDKEY_Message>(header, key_);
   return Worker::onThisThread()->sender().sendMessage(std::move(msg), node_id);
 }
 
@@ -214,6 +219,18 @@ void FindKeyRequest::onMessageSent(ShardID to, Status status) {
   }
 }
 
+void FindKeyRequest::onBatchNotSupported(ShardID to) {
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 1,
+                 "FINDKEY_BATCH is not supported by the server at %s, "
+                 "falling back to FINDKEY for log %lu",
+                 to.toString().c_str(),
+                 log_id_.val_);
+  batching_ = false;
+  nodeset_accessor_->onShardAccessed(
+      to, {StorageSetAccessor::Result::TRANSIENT_ERROR, E::PROTONOSUPPORT});
+}
+
 void FindKeyRequest::onReply(ShardID from, Status status, lsn_t lo, lsn_t hi) {
   ld_debug(
       "received FINDKEY_REPLY from %s, status=%s, result=(%s, %s] for log %lu",
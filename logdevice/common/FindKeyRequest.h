@@ -162,12 +162,28 @@ class FindKeyRequest : public DistributedRequest,
     return log_id_;
   }
 
+  /**
+   * Lets the FINDKEY messages of this request go out in FINDKEY_BATCH
+   * messages, together with those of the other requests running on this
+   * Worker. Used by findTimeBulk(). Must be called before execute().
+   */
+  void enableBatching() {
+    batching_ = true;
+  }
+
   /**
    * Called by the messaging layer after it successfully sends out our
    * FINDKEY message, or fails to do so.
    */
   void onMessageSent(ShardID to, Status);
 
+  /**
+   * Called instead of onMessageSent() if our FINDKEY went out in a
+   * FINDKEY_BATCH that the storage node doesn't support. Stops batching and
+   * lets StorageSetAccessor retry the shard with a regular FINDKEY.
+   */
+  void onBatchNotSupported(ShardID to);
+
   /**
    * Called when we receive a FINDKEY_REPLY message from a storage node.
    */
@@ -236,6 +252,9 @@ class FindKeyRequest : public DistributedRequest,
   // Make sure to call the client callback exactly once
   bool callback_called_ = false;
 
+  // See enableBatching()
+  bool batching_ = false;
+
   // Invokes the application-supplied callback and (in most cases) destroys
   // the Request
   void finalize(Status, bool delete_this = true);
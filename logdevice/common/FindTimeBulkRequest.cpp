@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/FindTimeBulkRequest.h"
+
+#include <unordered_set>
+
+#include "logdevice/common/FindKeyRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Shared by the callbacks of the FindKeyRequests started by one
+// FindTimeBulkRequest; the last of them to complete calls the application.
+struct FindTimeBulkState {
+  std::vector<FindTimeBulkResult> results;
+  size_t remaining;
+  find_time_bulk_callback_t callback;
+
+  void complete(size_t idx, Status status, lsn_t lsn) {
+    results[idx].status = status;
+    results[idx].lsn = lsn;
+    ld_check(remaining > 0);
+    if (--remaining > 0) {
+      return;
+    }
+    Status st = E::OK;
+    for (const auto& result : results) {
+      if (result.status != E::OK) {
+        st = E::PARTIAL;
+        break;
+      }
+    }
+    callback(st, std::move(results));
+  }
+};
+
+} // namespace
+
+FindTimeBulkRequest::FindTimeBulkRequest(
+    std::vector<logid_t> log_ids,
+    std::chrono::milliseconds timestamp,
+    std::chrono::milliseconds client_timeout,
+    find_time_bulk_callback_t callback,
+    FindKeyAccuracy accuracy)
+    : Request(RequestType::FIND_TIME_BULK),
+      log_ids_(std::move(log_ids)),
+      timestamp_(timestamp),
+      client_timeout_(client_timeout),
+      callback_(std::move(callback)),
+      accuracy_(accuracy) {}
+
+Request::Execution FindTimeBulkRequest::execute() {
+  auto state = std::make_shared<FindTimeBulkState>();
+  std::unordered_set<logid_t, logid_t::Hash> seen;
+  for (logid_t log_id : log_ids_) {
+    if (seen.insert(log_id).second) {
+      state->results.push_back(
+          FindTimeBulkResult{log_id, E::FAILED, LSN_INVALID});
+    }
+  }
+  state->remaining = state->results.size();
+  state->callback = std::move(callback_);
+
+  if (state->results.empty()) {
+    state->callback(E::OK, {});
+    return Execution::COMPLETE;
+  }
+  WORKER_STAT_ADD(findtime_bulk_logs, state->results.size());
+
+  // The results vector is moved out when the last request completes, which
+  // may happen synchronously (e.g. for an invalid log id), so iterate over
+  // a copy of the log ids.
+  std::vector<logid_t> log_ids;
+  log_ids.reserve(state->results.size());
+  for (const auto& result : state->results) {
+    log_ids.push_back(result.log_id);
+  }
+
+  for (size_t idx = 0; idx < log_ids.size(); ++idx) {
+    auto cb = [state, idx](const FindKeyRequest&, Status st, lsn_t result) {
+      state->complete(idx, st, result);
+    };
+    auto rq = std::make_unique<FindKeyRequest>(log_ids[idx],
+                                               timestamp_,
+                                               folly::none,
+                                               client_timeout_,
+                                               cb,
+                                               find_key_callback_ex_t(),
+                                               accuracy_);
+    rq->enableBatching();
+    if (rq->execute() == Execution::CONTINUE) {
+      // The request is now owned by Worker::runningFindKey().
+      rq.release();
+    }
+  }
+  return Execution::COMPLETE;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "logdevice/common/Request.h"
+#include "logdevice/common/RequestType.h"
+#include "logdevice/include/Client.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file
+ *
+ * Request that runs in the client library in order to satisfy an
+ * application's call to the findTimeBulk() API.
+ *
+ * Starts a FindKeyRequest for every distinct log on the current Worker, with
+ * batching enabled, all within the same event loop iteration. The FINDKEY
+ * messages they send to the same storage node are thus collected by the
+ * Worker's FindKeyBatcher and go out together in FINDKEY_BATCH messages.
+ * Each FindKeyRequest otherwise runs exactly as for findTime(), with its own
+ * retries and timeout, and this request only gathers their results.
+ */
+
+class FindTimeBulkRequest : public Request {
+ public:
+  FindTimeBulkRequest(std::vector<logid_t> log_ids,
+                      std::chrono::milliseconds timestamp,
+                      std::chrono::milliseconds client_timeout,
+                      find_time_bulk_callback_t callback,
+                      FindKeyAccuracy accuracy);
+
+  Execution execute() override;
+
+ private:
+  const std::vector<logid_t> log_ids_;
+  const std::chrono::milliseconds timestamp_;
+  const std::chrono::milliseconds client_timeout_;
+  find_time_bulk_callback_t callback_;
+  const FindKeyAccuracy accuracy_;
+};
+
+}} // namespace facebook::logdevice
@@ -34,6 +34,7 @@ bool FlowGroup::applyUpdate(FlowGroupsUpdate::GroupEntry& update,
   }
 
   enabled_ = update.policy.enabled();
+  borrowing_enabled_ = update.policy.borrowingEnabled();
 
   if (!enabled_) {
     // Clear any accumulated bandwidth budget or debt so that any future enable
@@ -127,13 +128,29 @@ bool FlowGroup::applyUpdate(FlowGroupsUpdate::GroupEntry& update,
       need_to_run = true;
     }
 
+    const bool keep_budget_for_borrowing =
+        borrowing_enabled_ && p != Priority::INVALID;
+    if (p != Priority::INVALID) {
+      borrow_budget_[asInt(p)] = keep_budget_for_borrowing ? budget : 0;
+      lend_reserve_[asInt(p)] = policy_it->guaranteed_bw;
+      if (keep_budget_for_borrowing && priorityq_was_blocked &&
+          !meter_it->canDrain()) {
+        // The class may be able to borrow what it's missing.
+        need_to_run = true;
+      }
+    }
+
     // Update budget accounting.
     auto fill_amount = starting_budget - budget;
     if (fill_amount < policy_it->max_bw) {
       // We couldn't use up our deposit budget. Transfer the budget credit so
       // it is accessible by meters for this same class that are on other
-      // Senders.
-      entry.cur_deposit_budget_overflow += policy_it->max_bw - fill_amount;
+      // Senders. With borrowing, this Sender keeps it instead (see
+      // borrow_budget_), so that credit borrowed later in the quantum still
+      // counts against max_bw.
+      if (!keep_budget_for_borrowing) {
+        entry.cur_deposit_budget_overflow += policy_it->max_bw - fill_amount;
+      }
     } else {
       // Deduct any budget used from the last quantum.
       entry.last_deposit_budget_overflow -= fill_amount - policy_it->max_bw;
@@ -170,8 +187,17 @@ bool FlowGroup::run(std::mutex& flow_meters_mutex,
   for (Priority p = Priority::MAX; p < PRIORITYQ_PRIORITY;
        p = priorityBelow(p)) {
     auto& meter_entry = meter_.entries[asInt(p)];
-    while (!priorityq_.empty(p) && (!enabled_ || meter_entry.canDrain()) &&
-           !run_limits_exceeded()) {
+    auto can_drain = [&] {
+      if (!enabled_ || meter_entry.canDrain()) {
+        return true;
+      }
+      // Try to borrow enough to refill the bucket.
+      return borrowing_enabled_ &&
+          borrow(p,
+                 std::max<int64_t>(
+                     meter_entry.capacity() - meter_entry.level(), 1));
+    };
+    while (!priorityq_.empty(p) && can_drain() && !run_limits_exceeded()) {
       issueCallback(priorityq_.front(p), flow_meters_mutex);
     }
 
@@ -189,7 +215,9 @@ bool FlowGroup::drain(size_t cost, Priority p) {
   bool res = false;
   if (!wouldCutInLine(p)) {
     auto& meter = meter_.entries[asInt(p)];
-    if (!enabled_ || meter.drain(cost)) {
+    if (!enabled_ || meter.drain(cost) ||
+        (borrowing_enabled_ && borrow(p, cost + meter.debt()) &&
+         meter.drain(cost))) {
       deps_->statsAdd(&PerShapingPriorityStats::bwconsumed, scope_, p, cost);
       res = true;
     }
@@ -205,4 +233,30 @@ bool FlowGroup::drain(size_t cost, Priority p) {
   return res;
 }
 
+bool FlowGroup::borrow(Priority p, size_t amount) {
+  ld_check(p < PRIORITYQ_PRIORITY);
+  auto& sink = meter_.entries[asInt(p)];
+  size_t& budget = borrow_budget_[asInt(p)];
+
+  auto borrow_from = [&](Priority lender, int64_t reserve) {
+    size_t lent = meter_.entries[asInt(lender)].lendCredit(
+        sink, std::min(amount, budget), reserve);
+    amount -= lent;
+    budget -= lent;
+    deps_->statsAdd(&PerShapingPriorityStats::bwborrowed, scope_, p, lent);
+  };
+
+  // Unallocated credit first, then the classes that have nothing queued.
+  borrow_from(PRIORITYQ_PRIORITY, 0);
+  for (Priority lender = priorityAbove(PRIORITYQ_PRIORITY);
+       lender != Priority::INVALID && amount > 0 && budget > 0;
+       lender = priorityAbove(lender)) {
+    if (lender != p && priorityq_.empty(lender)) {
+      borrow_from(lender, lend_reserve_[asInt(lender)]);
+    }
+  }
+
+  return sink.canDrain();
+}
+
 }} // namespace facebook::logdevice
@@ -248,6 +248,10 @@ class FlowGroup {
   }
   bool drain(size_t cost, Priority p);
 
+  bool borrowingEnabled() const {
+    return borrowing_enabled_;
+  }
+
   /**
    * @return  true iff bandwidth should be considered exhausted while
    *               processing the current message
@@ -364,6 +368,16 @@ class FlowGroup {
                     initialSourceLevel - source_entry.level());
   }
 
+  /**
+   * Borrow up to `amount' of credit for priority `p' from the priority queue
+   * bucket and then from idle priority classes (lowest priority first),
+   * within what is left of p's max_bw budget for this quantum. See
+   * FlowGroupPolicy::borrowingEnabled().
+   *
+   * @return  true iff p's meter can now be drained
+   */
+  bool borrow(Priority p, size_t amount);
+
   /**
    * Dispatch a bandwidth available callback while asserting that
    * there should be sufficient bandwidth credit for the callback to
@@ -402,6 +416,17 @@ class FlowGroup {
   // traffic. Otherwise, all packets are released immediately.
   bool enabled_ = false;
 
+  // See FlowGroupPolicy::borrowingEnabled().
+  bool borrowing_enabled_ = false;
+
+  // Per priority class, the max_bw deposit budget left unused at the last
+  // update. Borrowed credit is taken out of it.
+  std::array<size_t, asInt(Priority::NUM_PRIORITIES)> borrow_budget_{};
+
+  // Per priority class, the credit it keeps for itself when lending to other
+  // classes: its guaranteed_bw for one quantum.
+  std::array<int64_t, asInt(Priority::NUM_PRIORITIES)> lend_reserve_{};
+
   // Usually if priorityq_ is not empty we don't allow sending messages, only
   // pushing more callbacks to priorityq_. But there's one exception: if we're
   // already inside a BWAvailableCallback, it's ok to send messages of the same
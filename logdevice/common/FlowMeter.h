@@ -53,6 +53,10 @@ class FlowMeter {
       return level_;
     }
 
+    int64_t capacity() const {
+      return bucket_capacity_;
+    }
+
     void setCapacity(int64_t capacity) {
       ld_check(capacity >= 0);
       bucket_capacity_ = capacity;
@@ -185,6 +189,25 @@ class FlowMeter {
       return static_cast<size_t>(transfer_amount) == requested_amount;
     }
 
+    /**
+     * Move up to requested_amount of credit to bwSink, leaving at least
+     * `reserve' in this bucket. Unlike transferCredit(), bwSink's capacity
+     * is not enforced: lent credit is expected to be spent right away.
+     *
+     * @return  the amount of credit moved
+     */
+    size_t lendCredit(Entry& bwSink, size_t requested_amount, int64_t reserve) {
+      if (level_ <= reserve) {
+        return 0;
+      }
+      int64_t amount = std::min(
+          static_cast<int64_t>(std::min(requested_amount, size_t(INT64_MAX))),
+          level_ - reserve);
+      level_ -= amount;
+      bwSink.level_ += amount;
+      return amount;
+    }
+
     /** @return  true  iff a call to drain() on this Entry will succeed. */
     bool canDrain() const {
       return level_ > 0;
@@ -327,6 +327,7 @@ void GetSeqStateRequest::onReply(NodeID from,
       break;
     case E::OK:
       last_seq_ = from;
+      router_->onSuccess(from);
       if (msg.header_.next_lsn < next_lsn_) {
         // unlikely
         RATELIMIT_WARNING(std::chrono::seconds(1),
@@ -0,0 +1,352 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/GetTailAttributesBulkRequest.h"
+
+#include <algorithm>
+
+#include "logdevice/common/MetaDataLog.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/SequencerLocator.h"
+#include "logdevice/common/SyncSequencerRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_Message.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr size_t GetTailAttributesBulkRequest::MAX_LOGS_PER_MESSAGE;
+constexpr size_t GetTailAttributesBulkRequest::MAX_FALLBACKS_IN_FLIGHT;
+
+GetTailAttributesBulkRequest::GetTailAttributesBulkRequest(
+    std::vector<logid_t> log_ids,
+    std::chrono::milliseconds timeout,
+    get_tail_attributes_bulk_callback_t callback)
+    : Request(RequestType::GET_TAIL_ATTRIBUTES_BULK),
+      timeout_(timeout),
+      callback_(std::move(callback)),
+      holder_(this) {
+  results_.reserve(log_ids.size());
+  for (logid_t log_id : log_ids) {
+    auto res =
+        logs_.emplace(log_id, LogInfo{results_.size(), LogState::DONE});
+    if (res.second) {
+      results_.push_back(
+          LogTailAttributesResult{log_id, E::TIMEDOUT, nullptr});
+    }
+  }
+  remaining_ = results_.size();
+}
+
+GetTailAttributesBulkRequest::~GetTailAttributesBulkRequest() {
+  const Worker* worker = Worker::onThisThread(false /* enforce_worker */);
+  if (!worker) {
+    // The request has not made it to a Worker. Do not call the callback.
+    return;
+  }
+
+  if (!callback_called_) {
+    // This can happen if the request or client gets torn down while the
+    // request is still processing
+    ld_check(worker->shuttingDown());
+    ld_warning("GetTailAttributesBulkRequest destroyed while still "
+               "processing");
+    for (auto& result : results_) {
+      if (logs_.at(result.log_id).state != LogState::DONE) {
+        result.status = E::SHUTDOWN;
+      }
+    }
+    callback_called_ = true;
+    callback_(E::PARTIAL, std::move(results_));
+  }
+}
+
+Request::Execution GetTailAttributesBulkRequest::execute() {
+  if (results_.empty()) {
+    callback_called_ = true;
+    callback_(E::OK, std::move(results_));
+    return Execution::COMPLETE;
+  }
+
+  // Insert request into map for worker to track it
+  auto insert_result =
+      Worker::onThisThread()->runningGetTailAttributesBulk().map.insert(
+          std::make_pair(
+              id_, std::unique_ptr<GetTailAttributesBulkRequest>(this)));
+  ld_check(insert_result.second);
+
+  WORKER_STAT_ADD(get_tail_attributes_bulk_logs, results_.size());
+
+  deadline_ = std::chrono::steady_clock::now() + timeout_;
+  timer_ = std::make_unique<Timer>([this] { onTimeout(); });
+  timer_->activate(timeout_);
+
+  std::vector<logid_t> log_ids;
+  log_ids.reserve(results_.size());
+  for (const auto& result : results_) {
+    if (MetaDataLog::isMetaDataLog(result.log_id)) {
+      // GET_TAIL_ATTRIBUTES_BULK only covers data logs.
+      logs_.at(result.log_id).state = LogState::FALLBACK;
+      fallback_queue_.push_back(result.log_id);
+    } else {
+      logs_.at(result.log_id).state = LogState::LOCATING;
+      log_ids.push_back(result.log_id);
+    }
+  }
+  locating_ = log_ids.size();
+
+  // Callbacks below may complete the last log and destroy this request
+  // before the loop is over.
+  auto ref = holder_.ref();
+  startFallbacks();
+  if (ref && locating_ == 0) {
+    sendMessages();
+  }
+
+  SequencerLocator& locator =
+      *Worker::onThisThread()->processor_->sequencer_locator_;
+  for (logid_t log_id : log_ids) {
+    if (!ref) {
+      break;
+    }
+    auto cb = [ref](Status status, logid_t located, NodeID node) {
+      GetTailAttributesBulkRequest* rq = ref.get();
+      if (rq) {
+        rq->onSequencerLocated(status, located, node);
+      }
+    };
+    if (locator.locateSequencer(log_id, cb) != 0) {
+      onSequencerLocated(E::NOSEQUENCER, log_id, NodeID());
+    }
+  }
+  return Execution::CONTINUE;
+}
+
+void GetTailAttributesBulkRequest::onSequencerLocated(Status status,
+                                                      logid_t log_id,
+                                                      NodeID node) {
+  auto it = logs_.find(log_id);
+  if (it == logs_.end() || it->second.state != LogState::LOCATING) {
+    return;
+  }
+  ld_check(locating_ > 0);
+  --locating_;
+
+  auto ref = holder_.ref();
+  if (status == E::OK) {
+    by_node_[node].push_back(log_id);
+  } else {
+    complete(
+        log_id, status == E::NOTFOUND ? E::NOTFOUND : E::NOSEQUENCER, nullptr);
+  }
+
+  if (ref && locating_ == 0) {
+    sendMessages();
+  }
+}
+
+void GetTailAttributesBulkRequest::sendMessages() {
+  auto by_node = std::move(by_node_);
+  by_node_.clear();
+
+  auto ref = holder_.ref();
+  Sender& sender = Worker::onThisThread()->sender();
+  for (auto& kv : by_node) {
+    const NodeID node = kv.first;
+    const std::vector<logid_t>& log_ids = kv.second;
+    for (size_t begin = 0; begin < log_ids.size();
+         begin += MAX_LOGS_PER_MESSAGE) {
+      const size_t end =
+          std::min(begin + MAX_LOGS_PER_MESSAGE, log_ids.size());
+      std::vector<logid_t> chunk(
+          log_ids.begin() + begin, log_ids.begin() + end);
+      for (logid_t log_id : chunk) {
+        logs_.at(log_id).state = LogState::SENT;
+      }
+
+      auto msg =
+          std::make_unique<GET_TAIL_ATTRIBUTES_BULK_Message>(id_, chunk);
+      if (sender.sendMessage(std::move(msg), node) == 0) {
+        WORKER_STAT_INCR(get_tail_attributes_bulk_messages);
+      } else {
+        onMessageSent(node, err, chunk);
+        if (!ref) {
+          return;
+        }
+      }
+    }
+  }
+}
+
+void GetTailAttributesBulkRequest::onMessageSent(
+    NodeID to,
+    Status status,
+    const std::vector<logid_t>& log_ids) {
+  if (status == E::OK) {
+    return;
+  }
+  RATELIMIT_LEVEL(status == E::PROTONOSUPPORT ? dbg::Level::DEBUG
+                                              : dbg::Level::INFO,
+                  std::chrono::seconds(10),
+                  2,
+                  "Failed to send GET_TAIL_ATTRIBUTES_BULK for %zu logs to "
+                  "%s: %s. Falling back to GET_SEQ_STATE.",
+                  log_ids.size(),
+                  to.toString().c_str(),
+                  error_name(status));
+
+  for (logid_t log_id : log_ids) {
+    auto it = logs_.find(log_id);
+    if (it != logs_.end() && it->second.state == LogState::SENT) {
+      it->second.state = LogState::FALLBACK;
+      fallback_queue_.push_back(log_id);
+    }
+  }
+  startFallbacks();
+}
+
+void GetTailAttributesBulkRequest::onReply(
+    NodeID /*from*/,
+    std::vector<GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::Entry>& entries) {
+  auto ref = holder_.ref();
+  for (auto& entry : entries) {
+    if (!ref) {
+      return;
+    }
+    auto it = logs_.find(entry.log_id);
+    if (it == logs_.end() || it->second.state != LogState::SENT) {
+      continue;
+    }
+    if (entry.status == E::OK) {
+      complete(entry.log_id,
+               E::OK,
+               std::make_unique<LogTailAttributes>(entry.attributes));
+    } else {
+      // The node couldn't answer without activating, recovering or
+      // redirecting; let a regular GET_SEQ_STATE do that.
+      it->second.state = LogState::FALLBACK;
+      fallback_queue_.push_back(entry.log_id);
+    }
+  }
+  if (ref) {
+    startFallbacks();
+  }
+}
+
+void GetTailAttributesBulkRequest::startFallbacks() {
+  if (starting_fallbacks_) {
+    // Called from the callback of a SyncSequencerRequest that completed
+    // synchronously; the loop below will carry on.
+    return;
+  }
+  starting_fallbacks_ = true;
+
+  auto ref = holder_.ref();
+  while (ref && fallbacks_in_flight_ < MAX_FALLBACKS_IN_FLIGHT &&
+         !fallback_queue_.empty()) {
+    const logid_t log_id = fallback_queue_.front();
+    fallback_queue_.pop_front();
+    ++fallbacks_in_flight_;
+    WORKER_STAT_INCR(get_tail_attributes_bulk_fallbacks);
+
+    auto cb = [ref, log_id](Status st,
+                            NodeID /*seq*/,
+                            lsn_t /*next_lsn*/,
+                            std::unique_ptr<LogTailAttributes> attributes,
+                            std::shared_ptr<const EpochMetaDataMap> /*unused*/,
+                            std::shared_ptr<TailRecord> /*unused*/,
+                            folly::Optional<bool> /*unused*/) {
+      GetTailAttributesBulkRequest* rq = ref.get();
+      if (!rq) {
+        return;
+      }
+      ld_check(rq->fallbacks_in_flight_ > 0);
+      --rq->fallbacks_in_flight_;
+      // Same as ClientImpl::getTailAttributes(): recovery is running and the
+      // sequencer can't provide the attributes yet.
+      if (st == E::OK && !attributes) {
+        st = E::AGAIN;
+      }
+      rq->complete(log_id, st, std::move(attributes));
+      if (ref) {
+        rq->startFallbacks();
+      }
+    };
+
+    // Share what is left of the timeout; SyncSequencerRequest takes 0 to mean
+    // no timeout.
+    auto remaining = std::max(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline_ - std::chrono::steady_clock::now()),
+        std::chrono::milliseconds(1));
+    std::unique_ptr<Request> rq = std::make_unique<SyncSequencerRequest>(
+        log_id,
+        SyncSequencerRequest::INCLUDE_TAIL_ATTRIBUTES,
+        cb,
+        GetSeqStateRequest::Context::GET_TAIL_ATTRIBUTES,
+        remaining);
+    if (rq->execute() == Execution::CONTINUE) {
+      rq.release();
+    }
+  }
+
+  if (ref) {
+    starting_fallbacks_ = false;
+  }
+}
+
+void GetTailAttributesBulkRequest::complete(
+    logid_t log_id,
+    Status status,
+    std::unique_ptr<LogTailAttributes> attributes) {
+  auto it = logs_.find(log_id);
+  if (it == logs_.end() || it->second.state == LogState::DONE) {
+    return;
+  }
+  it->second.state = LogState::DONE;
+  LogTailAttributesResult& result = results_[it->second.idx];
+  result.status = status;
+  result.attributes = status == E::OK ? std::move(attributes) : nullptr;
+
+  ld_check(remaining_ > 0);
+  if (--remaining_ == 0) {
+    finalize();
+  }
+}
+
+void GetTailAttributesBulkRequest::onTimeout() {
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 2,
+                 "GetTailAttributesBulkRequest timed out after %lums with "
+                 "%zu of %zu logs left",
+                 timeout_.count(),
+                 remaining_,
+                 results_.size());
+  // Logs without an outcome keep E::TIMEDOUT.
+  finalize();
+}
+
+void GetTailAttributesBulkRequest::finalize() {
+  ld_check(!callback_called_);
+  Status status = E::OK;
+  for (const auto& result : results_) {
+    if (result.status != E::OK) {
+      status = E::PARTIAL;
+      break;
+    }
+  }
+  callback_called_ = true;
+  callback_(status, std::move(results_));
+
+  Worker* worker = Worker::onThisThread();
+  auto& map = worker->runningGetTailAttributesBulk().map;
+  auto it = map.find(id_);
+  ld_check(it != map.end());
+  map.erase(it); // destroys unique_ptr which owns this
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/RequestType.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/WeakRefHolder.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_REPLY_Message.h"
+#include "logdevice/include/Client.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file
+ *
+ * Request that runs in the client library in order to satisfy an
+ * application's call to the getTailAttributesBulk() API.
+ *
+ * Locates the sequencer node of every log with SequencerLocator, then sends
+ * each of these nodes GET_TAIL_ATTRIBUTES_BULK messages with up to
+ * MAX_LOGS_PER_MESSAGE of its logs. Logs the node can't answer for cheaply
+ * (see GET_TAIL_ATTRIBUTES_BULK_Message.h), metadata logs, and the logs of
+ * messages that could not be sent (e.g. because the node runs an older
+ * version) fall back to a SyncSequencerRequest each, exactly like
+ * getTailAttributes() does, with at most MAX_FALLBACKS_IN_FLIGHT of them
+ * running at a time. Logs that don't have an outcome when the timeout
+ * expires get E::TIMEDOUT.
+ */
+
+class GetTailAttributesBulkRequest;
+
+// Wrapper instead of typedef to allow forward-declaring in Worker.h
+struct GetTailAttributesBulkRequestMap {
+  std::unordered_map<request_id_t,
+                     std::unique_ptr<GetTailAttributesBulkRequest>,
+                     request_id_t::Hash>
+      map;
+};
+
+class GetTailAttributesBulkRequest : public Request {
+ public:
+  // Bounds the size of GET_TAIL_ATTRIBUTES_BULK_REPLY, which has an OffsetMap
+  // for every log.
+  static constexpr size_t MAX_LOGS_PER_MESSAGE = 4096;
+
+  static constexpr size_t MAX_FALLBACKS_IN_FLIGHT = 256;
+
+  GetTailAttributesBulkRequest(std::vector<logid_t> log_ids,
+                               std::chrono::milliseconds timeout,
+                               get_tail_attributes_bulk_callback_t callback);
+
+  ~GetTailAttributesBulkRequest() override;
+
+  Execution execute() override;
+
+  /**
+   * Called by GET_TAIL_ATTRIBUTES_BULK_Message::onSent() if the message
+   * asking about log_ids could not be sent.
+   */
+  void onMessageSent(NodeID to,
+                     Status status,
+                     const std::vector<logid_t>& log_ids);
+
+  /**
+   * Called when we receive a GET_TAIL_ATTRIBUTES_BULK_REPLY message from a
+   * sequencer node.
+   */
+  void
+  onReply(NodeID from,
+          std::vector<GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::Entry>& entries);
+
+ private:
+  enum class LogState : uint8_t {
+    LOCATING,
+    SENT,
+    FALLBACK,
+    DONE,
+  };
+
+  struct LogInfo {
+    // index of the log in results_
+    size_t idx;
+    LogState state;
+  };
+
+  void onSequencerLocated(Status status, logid_t log_id, NodeID node);
+
+  // Sends the logs grouped in by_node_ to their sequencer nodes.
+  void sendMessages();
+
+  // Queues a SyncSequencerRequest for the log.
+  void fallBack(logid_t log_id);
+
+  void startFallbacks();
+
+  // Records the outcome for a log, and finalizes the request once all logs
+  // have one.
+  void complete(logid_t log_id,
+                Status status,
+                std::unique_ptr<LogTailAttributes> attributes);
+
+  void onTimeout();
+
+  // Invokes the application-supplied callback and destroys the Request
+  void finalize();
+
+  const std::chrono::milliseconds timeout_;
+  const get_tail_attributes_bulk_callback_t callback_;
+
+  // One entry per distinct log, in the order given by the application.
+  // Logs that don't get an outcome in time keep E::TIMEDOUT.
+  std::vector<LogTailAttributesResult> results_;
+  std::unordered_map<logid_t, LogInfo, logid_t::Hash> logs_;
+
+  // number of logs whose sequencer node is being located
+  size_t locating_{0};
+  // number of logs without an outcome yet
+  size_t remaining_{0};
+
+  std::unordered_map<NodeID, std::vector<logid_t>, NodeID::Hash> by_node_;
+
+  std::deque<logid_t> fallback_queue_;
+  size_t fallbacks_in_flight_{0};
+  bool starting_fallbacks_{false};
+
+  std::chrono::steady_clock::time_point deadline_;
+  std::unique_ptr<Timer> timer_;
+  bool callback_called_{false};
+
+  WeakRefHolder<GetTailAttributesBulkRequest> holder_;
+};
+
+}} // namespace facebook::logdevice
@@ -164,8 +164,45 @@ std::vector<node_index_t> GraylistingTracker::updatePotentialGraylist(
   return confirmed_outliers;
 }
 
+GraylistingTracker::Latencies GraylistingTracker::findMedianLatencyOutliers(
+    const Latencies& latencies) const {
+  const double ratio = getGraylistingMedianLatencyRatio();
+  if (ratio <= 0 || latencies.empty()) {
+    return {};
+  }
+  double exit_ratio = getGraylistingMedianLatencyExitRatio();
+  if (exit_ratio <= 0 || exit_ratio > ratio) {
+    exit_ratio = ratio;
+  }
+
+  std::vector<WorkerTimeoutStats::Latency> values;
+  values.reserve(latencies.size());
+  for (const auto& sample : latencies) {
+    values.push_back(sample.second);
+  }
+  // Upper median, so that in a region of two nodes neither is an outlier.
+  auto median_it = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), median_it, values.end());
+  const double median = *median_it;
+  if (median <= 0) {
+    return {};
+  }
+
+  Latencies outliers;
+  for (const auto& sample : latencies) {
+    const bool already_outlier =
+        potential_graylist_.count(sample.first) != 0 ||
+        graylist_deadlines_.count(sample.first) != 0;
+    if (sample.second > median * (already_outlier ? exit_ratio : ratio)) {
+      outliers.push_back(sample);
+    }
+  }
+  return outliers;
+}
+
 std::vector<node_index_t>
 GraylistingTracker::findSortedOutlierNodesPerRegion(Latencies latencies) {
+  auto median_outliers = findMedianLatencyOutliers(latencies);
   auto outlier_pairs =
       OutlierDetection::findOutliers(OutlierDetection::Method::RMSD,
                                      std::move(latencies),
@@ -173,6 +210,12 @@ GraylistingTracker::findSortedOutlierNodesPerRegion(Latencies latencies) {
                                      getMaxGraylistedNodes(),
                                      /* required_margin */ 0.75)
           .outliers;
+  for (const auto& sample : median_outliers) {
+    if (std::find(outlier_pairs.begin(), outlier_pairs.end(), sample) ==
+        outlier_pairs.end()) {
+      outlier_pairs.push_back(sample);
+    }
+  }
   using LatencySample = std::pair<node_index_t, WorkerTimeoutStats::Latency>;
   std::sort(outlier_pairs.begin(),
             outlier_pairs.end(),
@@ -334,6 +377,14 @@ std::chrono::milliseconds GraylistingTracker::getGraylistingMinLatency() const {
   return Worker::settings().graylisting_min_latency;
 }
 
+double GraylistingTracker::getGraylistingMedianLatencyRatio() const {
+  return Worker::settings().graylisting_median_latency_ratio;
+}
+
+double GraylistingTracker::getGraylistingMedianLatencyExitRatio() const {
+  return Worker::settings().graylisting_median_latency_exit_ratio;
+}
+
 std::shared_ptr<const configuration::nodes::NodesConfiguration>
 GraylistingTracker::getNodesConfiguration() const {
   return Worker::onThisThread()->getNodesConfiguration();
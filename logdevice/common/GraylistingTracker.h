@@ -21,7 +21,10 @@ namespace facebook { namespace logdevice {
 /**
  * @file A centeralized place where all the graylisting logic exists.
  * The graylisting is worker-local and is based on STORE latency outlier
- * detection logic.
+ * detection logic: a node is an outlier if its p95 STORE latency is a
+ * statistical outlier within its region, or, if
+ * graylisting_median_latency_ratio is set, if it is too many times the
+ * median latency of its region.
  * The graylist is refreshed every *graylisting_refresh_interval* seconds.
  */
 class GraylistingTracker {
@@ -108,6 +111,12 @@ class GraylistingTracker {
   // Don't graylist nodes that have p95 store latency less than this.
   virtual std::chrono::milliseconds getGraylistingMinLatency() const;
 
+  // See Settings::graylisting_median_latency_ratio
+  virtual double getGraylistingMedianLatencyRatio() const;
+
+  // See Settings::graylisting_median_latency_exit_ratio
+  virtual double getGraylistingMedianLatencyExitRatio() const;
+
   virtual std::shared_ptr<const configuration::nodes::NodesConfiguration>
   getNodesConfiguration() const;
 
@@ -136,6 +145,12 @@ class GraylistingTracker {
   std::vector<node_index_t>
   findSortedOutlierNodesPerRegion(Latencies latencies);
 
+  // Returns the nodes of a region whose latency is above
+  // getGraylistingMedianLatencyRatio() times the median of the region, or
+  // above getGraylistingMedianLatencyExitRatio() times the median for nodes
+  // that are already potentially or actually graylisted.
+  Latencies findMedianLatencyOutliers(const Latencies& latencies) const;
+
   // Create backoff variable if not exists
   void createGraylistingBackoff(node_index_t node);
 
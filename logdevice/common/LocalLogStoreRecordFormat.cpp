@@ -8,6 +8,8 @@
 #define __STDC_FORMAT_MACROS // pull in PRIu64 etc
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
 
+#include <vector>
+
 #include <folly/Range.h>
 #include <folly/Varint.h>
 #include <folly/hash/Hash.h>
@@ -430,18 +432,27 @@ bool parseCopySetIndexSingleEntry(const Slice& cs_dir_slice,
 
 #undef READ_FROM_SLICE
 
-int parse(const Slice& log_store_blob,
-          std::chrono::milliseconds* timestamp_out,
-          esn_t* last_known_good_out,
-          flags_t* flags_out,
-          uint32_t* wave_or_recovery_epoch_out,
-          copyset_size_t* copyset_size_out,
-          ShardID* copyset_arr_out,
-          size_t copyset_arr_out_size,
-          OffsetMap* offsets_within_epoch_out,
-          std::map<KeyType, std::string>* optional_keys,
-          Payload* payload_out,
-          shard_index_t this_shard) {
+// Implementation of parse() and parseWithOptionalKey(). Optional keys are
+// copied into `optional_keys` if it's not nullptr, and `key_out`, if not
+// nullptr, is pointed at the key of type `key_type` inside the blob.
+static int parseImpl(const Slice& log_store_blob,
+                     std::chrono::milliseconds* timestamp_out,
+                     esn_t* last_known_good_out,
+                     flags_t* flags_out,
+                     uint32_t* wave_or_recovery_epoch_out,
+                     copyset_size_t* copyset_size_out,
+                     ShardID* copyset_arr_out,
+                     size_t copyset_arr_out_size,
+                     OffsetMap* offsets_within_epoch_out,
+                     std::map<KeyType, std::string>* optional_keys,
+                     KeyType key_type,
+                     folly::Optional<folly::StringPiece>* key_out,
+                     Payload* payload_out,
+                     shard_index_t this_shard) {
+  if (key_out != nullptr) {
+    key_out->clear();
+  }
+
   const uint8_t *const start = reinterpret_cast<const uint8_t*>(
                            log_store_blob.data),
                        *const end = start + log_store_blob.size, *ptr = start;
@@ -650,7 +661,7 @@ int parse(const Slice& log_store_blob,
       memcpy(&optional_keys_size, ptr, sizeof(uint16_t));
       ptr += sizeof(uint16_t);
       for (uint16_t i = 0; i < optional_keys_size; i++) {
-        uint8_t key_type;
+        uint8_t cur_key_type;
         uint16_t key_length;
         if (ptr + sizeof(uint8_t) + sizeof(uint16_t) > end) {
           RATELIMIT_ERROR(std::chrono::seconds(10),
@@ -660,7 +671,7 @@ int parse(const Slice& log_store_blob,
           err = E::MALFORMED_RECORD;
           return -1;
         }
-        memcpy(&key_type, ptr, sizeof(uint8_t));
+        memcpy(&cur_key_type, ptr, sizeof(uint8_t));
         ptr += sizeof(uint8_t);
         memcpy(&key_length, ptr, sizeof(uint16_t));
         ptr += sizeof(uint16_t);
@@ -676,8 +687,14 @@ int parse(const Slice& log_store_blob,
         if (optional_keys != nullptr) {
           std::string key = std::string(
               reinterpret_cast<const char*>(ptr), (size_t)key_length);
-          optional_keys->insert(
-              std::make_pair(static_cast<KeyType>(key_type), std::move(key)));
+          optional_keys->insert(std::make_pair(
+              static_cast<KeyType>(cur_key_type), std::move(key)));
+        }
+        if (key_out != nullptr && !key_out->hasValue() &&
+            static_cast<KeyType>(cur_key_type) == key_type) {
+          // Like optional_keys->insert(), keep the first one.
+          *key_out = folly::StringPiece(
+              reinterpret_cast<const char*>(ptr), (size_t)key_length);
         }
         ptr += key_length;
       }
@@ -698,6 +715,10 @@ int parse(const Slice& log_store_blob,
                            std::string(reinterpret_cast<const char*>(ptr),
                                        (size_t)blob_size)));
       }
+      if (key_out != nullptr && key_type == KeyType::FINDKEY) {
+        *key_out = folly::StringPiece(
+            reinterpret_cast<const char*>(ptr), (size_t)blob_size);
+      }
       ptr += blob_size;
     }
   }
@@ -737,7 +758,76 @@ int parse(const Slice& log_store_blob,
   }
 }
 
-int checkWellFormed(Slice blob, Slice payload) {
+int parse(const Slice& log_store_blob,
+          std::chrono::milliseconds* timestamp_out,
+          esn_t* last_known_good_out,
+          flags_t* flags_out,
+          uint32_t* wave_or_recovery_epoch_out,
+          copyset_size_t* copyset_size_out,
+          ShardID* copyset_arr_out,
+          size_t copyset_arr_out_size,
+          OffsetMap* offsets_within_epoch_out,
+          std::map<KeyType, std::string>* optional_keys,
+          Payload* payload_out,
+          shard_index_t this_shard) {
+  return parseImpl(log_store_blob,
+                   timestamp_out,
+                   last_known_good_out,
+                   flags_out,
+                   wave_or_recovery_epoch_out,
+                   copyset_size_out,
+                   copyset_arr_out,
+                   copyset_arr_out_size,
+                   offsets_within_epoch_out,
+                   optional_keys,
+                   KeyType::UNDEFINED,
+                   nullptr,
+                   payload_out,
+                   this_shard);
+}
+
+int parseWithOptionalKey(const Slice& log_store_blob,
+                         std::chrono::milliseconds* timestamp_out,
+                         esn_t* last_known_good_out,
+                         flags_t* flags_out,
+                         uint32_t* wave_or_recovery_epoch_out,
+                         copyset_size_t* copyset_size_out,
+                         ShardID* copyset_arr_out,
+                         size_t copyset_arr_out_size,
+                         OffsetMap* offsets_within_epoch_out,
+                         KeyType key_type,
+                         folly::Optional<folly::StringPiece>* key_out,
+                         Payload* payload_out,
+                         shard_index_t this_shard) {
+  return parseImpl(log_store_blob,
+                   timestamp_out,
+                   last_known_good_out,
+                   flags_out,
+                   wave_or_recovery_epoch_out,
+                   copyset_size_out,
+                   copyset_arr_out,
+                   copyset_arr_out_size,
+                   offsets_within_epoch_out,
+                   nullptr,
+                   key_type,
+                   key_out,
+                   payload_out,
+                   this_shard);
+}
+
+namespace {
+
+// Checksum that checkWellFormed() needs to verify for a record, filled by
+// prepareChecksumCheck(). `size` is 0 if the record has no checksum.
+struct ChecksumCheck {
+  size_t size = 0;
+  Slice expected;
+  Slice payload;
+};
+
+// Does all the checks of checkWellFormed() except computing and comparing the
+// payload checksum.
+int prepareChecksumCheck(Slice blob, Slice payload, ChecksumCheck* out) {
   Payload parsed_payload_p;
   flags_t flags;
   uint32_t wave;
@@ -817,23 +907,91 @@ int checkWellFormed(Slice blob, Slice payload) {
       payload.data = (const char*)payload.data + checksum_size;
       payload.size -= checksum_size;
     }
-    char buf[8];
-    checksum_bytes(
-        Slice((const char*)payload.data, payload.size), checksum_size * 8, buf);
-    if (memcmp(buf, checksum_slice.data, checksum_size) != 0) {
-      uint64_t payload_checksum = 0;
-      uint64_t expected_checksum = 0;
-      memcpy(&payload_checksum, checksum_slice.data, checksum_size);
-      memcpy(&expected_checksum, buf, checksum_size);
-      RATELIMIT_ERROR(std::chrono::seconds(10),
-                      100,
-                      "checksum mismatch: Invalid record. Payload: %s, "
-                      "expected checksum: %lu, checksum in payload: %lu",
-                      hexdump_buf(payload, 500).c_str(),
-                      expected_checksum,
-                      payload_checksum);
-      err = E::CHECKSUM_MISMATCH;
-      return -1;
+    out->size = checksum_size;
+    out->expected = Slice(checksum_slice.data, checksum_size);
+    out->payload = payload;
+  }
+  return 0;
+}
+
+// Compares the checksum computed by the caller (its first check.size bytes are
+// used) with the one stored in the record.
+int compareChecksum(const ChecksumCheck& check, const char* computed) {
+  if (memcmp(computed, check.expected.data, check.size) != 0) {
+    uint64_t payload_checksum = 0;
+    uint64_t expected_checksum = 0;
+    memcpy(&payload_checksum, check.expected.data, check.size);
+    memcpy(&expected_checksum, computed, check.size);
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    100,
+                    "checksum mismatch: Invalid record. Payload: %s, "
+                    "expected checksum: %lu, checksum in payload: %lu",
+                    hexdump_buf(check.payload, 500).c_str(),
+                    expected_checksum,
+                    payload_checksum);
+    err = E::CHECKSUM_MISMATCH;
+    return -1;
+  }
+  return 0;
+}
+
+} // namespace
+
+int checkWellFormed(Slice blob, Slice payload) {
+  ChecksumCheck check;
+  int rv = prepareChecksumCheck(blob, payload, &check);
+  if (rv != 0 || check.size == 0) {
+    return rv;
+  }
+  char buf[8];
+  checksum_bytes(check.payload, check.size * 8, buf);
+  return compareChecksum(check, buf);
+}
+
+int checkWellFormedBatch(const Slice* blobs,
+                         const Slice* payloads,
+                         size_t count,
+                         size_t* bad_idx_out) {
+  ld_check(bad_idx_out != nullptr);
+  std::vector<ChecksumCheck> checks(count);
+  // Payloads with a 32-bit checksum, to be checksummed together.
+  std::vector<Slice> crc_payloads;
+  std::vector<size_t> crc_idx;
+  crc_payloads.reserve(count);
+  crc_idx.reserve(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    int rv = prepareChecksumCheck(
+        blobs[i], payloads ? payloads[i] : Slice(), &checks[i]);
+    if (rv != 0) {
+      *bad_idx_out = i;
+      return rv;
+    }
+    if (checks[i].size == 4) {
+      crc_payloads.push_back(checks[i].payload);
+      crc_idx.push_back(i);
+    }
+  }
+
+  std::vector<uint32_t> crcs(crc_payloads.size());
+  checksum_32bit_batch(crc_payloads.data(), crc_payloads.size(), crcs.data());
+
+  size_t next_crc = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const ChecksumCheck& check = checks[i];
+    int rv = 0;
+    if (check.size == 4) {
+      ld_check_lt(next_crc, crc_idx.size());
+      ld_check_eq(crc_idx[next_crc], i);
+      rv = compareChecksum(check, (const char*)&crcs[next_crc++]);
+    } else if (check.size == 8) {
+      char buf[8];
+      checksum_bytes(check.payload, 64, buf);
+      rv = compareChecksum(check, buf);
+    }
+    if (rv != 0) {
+      *bad_idx_out = i;
+      return rv;
     }
   }
   return 0;
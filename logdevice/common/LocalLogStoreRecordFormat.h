@@ -10,6 +10,7 @@
 #include <chrono>
 #include <string>
 
+#include <folly/Optional.h>
 #include <folly/Range.h>
 
 #include "logdevice/common/NodeID.h"
@@ -379,6 +380,27 @@ int parse(const Slice& log_store_blob,
           Payload* payload_out,
           shard_index_t this_shard);
 
+/**
+ * Same as parse() but, instead of copying all optional keys into a map, points
+ * *key_out into `log_store_blob` at the optional key of type `key_type`. Sets
+ * *key_out to folly::none if the record has no such key. Used on the read
+ * path, where copying keys for every record is a significant part of the cost
+ * of server-side filtering.
+ */
+int parseWithOptionalKey(const Slice& log_store_blob,
+                         std::chrono::milliseconds* timestamp_out,
+                         esn_t* last_known_good_out,
+                         flags_t* flags_out,
+                         uint32_t* wave_or_recovery_epoch_out,
+                         copyset_size_t* copyset_size_out,
+                         ShardID* copyset_arr_out,
+                         size_t copyset_arr_out_size,
+                         OffsetMap* offsets_within_epoch,
+                         KeyType key_type,
+                         folly::Optional<folly::StringPiece>* key_out,
+                         Payload* payload_out,
+                         shard_index_t this_shard);
+
 /**
  * Same as parse() but faster and only parses timestamp.
  */
@@ -411,6 +433,23 @@ int getCopysetHash(const Slice& log_store_blob, size_t* hash_out);
  */
 int checkWellFormed(Slice blob, Slice payload = Slice());
 
+/**
+ * Same as calling checkWellFormed(blobs[i], payloads[i]) for each i in
+ * [0, count), but payload checksums of all records are computed together with
+ * checksum_32bit_batch(), which is faster for batches of small records.
+ *
+ * @param payloads     May be nullptr, meaning all payloads are empty.
+ * @param bad_idx_out  On failure, set to the index of the first record that
+ *                     is not well formed.
+ *
+ * @return 0 if all records are well formed, otherwise -1 with err set as in
+ *         checkWellFormed().
+ */
+int checkWellFormedBatch(const Slice* blobs,
+                         const Slice* payloads,
+                         size_t count,
+                         size_t* bad_idx_out);
+
 /**
  * Helper method to forms Slice from optional_keys
  * @ param  optional_keys_string  a pointer to string that will hold serialized
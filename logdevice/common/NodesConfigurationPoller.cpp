@@ -13,6 +13,7 @@
 #include "logdevice/common/RandomNodeSelector.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/nodes/NodesConfigurationCodec.h"
+#include "logdevice/common/configuration/nodes/NodesConfigurationDelta.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/util.h"
 
@@ -164,6 +165,12 @@ void NodesConfigurationPoller::onConfigurationFetchResult(Poller::RoundID round,
   Poller::RequestResult result = Poller::RequestResult::OK;
   if (st == Status::OK || st == Status::UPTODATE) {
     result = Poller::RequestResult::OK;
+  } else if (st == E::VERSION_MISMATCH) {
+    // The source replied with a delta that can't be applied to our config.
+    // This isn't the source's fault; ask for full configs for the rest of
+    // the round.
+    delta_failed_round_ = round;
+    result = Poller::RequestResult::FAILURE_TRANSIENT;
   } else {
     // in all other cases (e.g., E::TIMEOUT), graylist the source
     result = Poller::RequestResult::FAILURE_GRAYLIST;
@@ -241,11 +248,40 @@ NodesConfigurationPoller::sendRequestToNode(Poller::RoundID round,
   const auto& nodes_configuration = getNodesConfiguration();
   NodeID nid = nodes_configuration->getNodeID(node);
 
+  // The config to ask for a delta against. The bootstrapping config is not a
+  // real version of the config.
+  std::shared_ptr<const configuration::nodes::NodesConfiguration> delta_base;
+  if (Worker::settings().nodes_configuration_poll_deltas &&
+      !isBootstrapping() && nodes_configuration->getVersion().val() > 0 &&
+      delta_failed_round_ != round) {
+    delta_base = nodes_configuration;
+  }
+
   auto ticket = callback_helper_.ticket(
       RequestType::NODES_CONFIGURATION_MANAGER, folly::Executor::HI_PRI);
-  auto cb_wrapper = [ticket, round, node](Status status,
-                                          CONFIG_CHANGED_Header /* header */,
-                                          std::string config) {
+  auto cb_wrapper = [ticket, round, node, delta_base](
+                        Status status,
+                        CONFIG_CHANGED_Header header,
+                        std::string config) {
+    if (status == Status::OK &&
+        header.config_type ==
+            CONFIG_CHANGED_Header::ConfigType::NODES_CONFIGURATION_DELTA) {
+      // Applying the delta here rather than in the poller's context, as it
+      // decompresses the whole config
+      folly::Optional<std::string> full;
+      if (delta_base != nullptr) {
+        full = configuration::nodes::NodesConfigurationDelta::apply(
+            *delta_base, config);
+      }
+      if (full.has_value()) {
+        WORKER_STAT_INCR(nodes_configuration_delta_applied);
+        config = std::move(full).value();
+      } else {
+        WORKER_STAT_INCR(nodes_configuration_delta_failed);
+        status = E::VERSION_MISMATCH;
+        config.clear();
+      }
+    }
     ticket.postCallbackRequest([round, node, status, cfg = std::move(config)](
                                    NodesConfigurationPoller* poller) mutable {
       if (poller != nullptr) {
@@ -277,7 +313,9 @@ NodesConfigurationPoller::sendRequestToNode(Poller::RoundID round,
       polling_worker_id,
       // use the full round timeout as the RPC request timeout
       options_.round_timeout,
-      conditional_poll_version_msg);
+      conditional_poll_version_msg,
+      delta_base ? folly::Optional<uint64_t>(delta_base->getVersion().val())
+                 : folly::none);
 
   int rv = worker->processor_->postRequest(rq);
   if (rv != 0 && err == E::NOBUFS) {
@@ -85,6 +85,10 @@ class NodesConfigurationPoller {
   const folly::Optional<Version> conditional_base_version_;
   Version highest_seen_{0};
 
+  // Last round in which a delta reply couldn't be applied. Requests of that
+  // round ask for the full config.
+  folly::Optional<Poller::RoundID> delta_failed_round_;
+
   std::unique_ptr<Poller> poller_;
 
   // used to re-route the ConfigurationFetchRequest result callback
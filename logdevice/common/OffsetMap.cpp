@@ -8,11 +8,29 @@
 
 #include "logdevice/common/OffsetMap.h"
 
+#include <algorithm>
+
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/util.h"
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+template <typename Map>
+auto findCounter(Map& map, counter_type_t counter_type)
+    -> decltype(map.begin()) {
+  return std::lower_bound(
+      map.begin(),
+      map.end(),
+      counter_type,
+      [](const std::pair<counter_type_t, uint64_t>& counter,
+         counter_type_t type) { return counter.first < type; });
+}
+
+} // namespace
+
 OffsetMap::OffsetMap(
     std::initializer_list<std::pair<const counter_type_t, uint64_t>>
         list) noexcept {
@@ -28,25 +46,33 @@ OffsetMap::OffsetMap(const OffsetMap& om) noexcept {
 void OffsetMap::setCounter(const counter_type_t counter_type,
                            uint64_t counter_val) {
   if (counter_val == BYTE_OFFSET_INVALID) {
-    counterTypeMap_.erase(counter_type);
+    unsetCounter(counter_type);
   } else {
-    counterTypeMap_[counter_type] = counter_val;
+    getOrInsert(counter_type) = counter_val;
   }
 }
 
+uint64_t& OffsetMap::getOrInsert(counter_type_t counter_type) {
+  auto it = findCounter(counterTypeMap_, counter_type);
+  if (it == counterTypeMap_.end() || it->first != counter_type) {
+    it = counterTypeMap_.insert(it, std::make_pair(counter_type, uint64_t(0)));
+  }
+  return it->second;
+}
+
 bool OffsetMap::isValid() const {
   return counterTypeMap_.size() > 0;
 }
 
 uint64_t OffsetMap::getCounter(const counter_type_t counter_type) const {
-  auto it = counterTypeMap_.find(counter_type);
-  if (it == counterTypeMap_.end()) {
+  auto it = findCounter(counterTypeMap_, counter_type);
+  if (it == counterTypeMap_.end() || it->first != counter_type) {
     return BYTE_OFFSET_INVALID;
   }
   return it->second;
 }
 
-const std::map<counter_type_t, uint64_t>& OffsetMap::getCounterMap() const {
+const OffsetMap::CounterMap& OffsetMap::getCounterMap() const {
   return counterTypeMap_;
 }
 
@@ -55,11 +81,15 @@ void OffsetMap::clear() {
 }
 
 void OffsetMap::unsetCounter(counter_type_t counter_type) {
-  counterTypeMap_.erase(counter_type);
+  auto it = findCounter(counterTypeMap_, counter_type);
+  if (it != counterTypeMap_.end() && it->first == counter_type) {
+    counterTypeMap_.erase(it);
+  }
 }
 
 bool OffsetMap::isValidOffset(const counter_type_t counter_type) const {
-  return counterTypeMap_.find(counter_type) != counterTypeMap_.end();
+  auto it = findCounter(counterTypeMap_, counter_type);
+  return it != counterTypeMap_.end() && it->first == counter_type;
 }
 
 void OffsetMap::serialize(ProtocolWriter& writer) const {
@@ -84,20 +114,13 @@ void OffsetMap::deserialize(ProtocolReader& reader,
       err = E::BADMSG;
       return;
     }
-    counterTypeMap_[counter_type] = counter_val;
+    getOrInsert(counter_type) = counter_val;
   }
 }
 
 bool OffsetMap::operator==(const OffsetMap& om) const {
-  if (counterTypeMap_.size() != om.counterTypeMap_.size()) {
-    return false;
-  }
-  for (auto& it : counterTypeMap_) {
-    if (it.second != om.getCounter(it.first)) {
-      return false;
-    }
-  }
-  return true;
+  // Both are sorted by counter type.
+  return counterTypeMap_ == om.counterTypeMap_;
 }
 
 bool OffsetMap::operator!=(const OffsetMap& om) const {
@@ -107,7 +130,7 @@ bool OffsetMap::operator!=(const OffsetMap& om) const {
 OffsetMap OffsetMap::mergeOffsets(OffsetMap lhs, const OffsetMap& rhs) {
   OffsetMap om = std::move(lhs);
   for (auto& it : rhs.counterTypeMap_) {
-    om.counterTypeMap_[it.first] += it.second;
+    om.getOrInsert(it.first) += it.second;
   }
   return om;
 }
@@ -115,16 +138,17 @@ OffsetMap OffsetMap::mergeOffsets(OffsetMap lhs, const OffsetMap& rhs) {
 OffsetMap OffsetMap::getOffsetsDifference(OffsetMap lhs, const OffsetMap& rhs) {
   OffsetMap om = std::move(lhs);
   for (auto& it : rhs.counterTypeMap_) {
-    ld_check(om.counterTypeMap_[it.first] >= it.second);
-    om.counterTypeMap_[it.first] -= it.second;
+    uint64_t& counter = om.getOrInsert(it.first);
+    ld_check(counter >= it.second);
+    counter -= it.second;
   }
   return om;
 }
 
 OffsetMap OffsetMap::operator*(uint64_t scalar) const {
-  OffsetMap om;
-  for (auto& it : counterTypeMap_) {
-    om.counterTypeMap_[it.first] = it.second * scalar;
+  OffsetMap om(*this);
+  for (auto& it : om.counterTypeMap_) {
+    it.second *= scalar;
   }
   return om;
 }
@@ -145,7 +169,8 @@ OffsetMap::OffsetMap(OffsetMap&& om) noexcept {
 
 void OffsetMap::max(const OffsetMap& om) {
   for (auto& it : om.getCounterMap()) {
-    counterTypeMap_[it.first] = std::max(it.second, counterTypeMap_[it.first]);
+    uint64_t& counter = getOrInsert(it.first);
+    counter = std::max(it.second, counter);
   }
 }
 
@@ -187,22 +212,34 @@ std::string OffsetMap::toString() const {
   return res;
 }
 
-void AtomicOffsetMap::atomicFetchMax(const OffsetMap& offsets_map) {
+template <typename Op>
+uint64_t AtomicOffsetMap::update(counter_type_t counter_type, Op op) {
+  if (counter_type == BYTE_OFFSET) {
+    has_byte_offset_.store(true);
+    return op(byte_offset_);
+  }
   FairRWLock::UpgradeHolder upgradeLock(rw_lock_);
+  auto iterator = atomicCounterTypeMap_.find(counter_type);
+  if (iterator == atomicCounterTypeMap_.end()) {
+    FairRWLock::WriteHolder writeLock(std::move(upgradeLock));
+    return op(atomicCounterTypeMap_[counter_type]);
+  }
+  return op(iterator->second);
+}
+
+void AtomicOffsetMap::atomicFetchMax(const OffsetMap& offsets_map) {
   for (const auto& it : offsets_map.getCounterMap()) {
-    auto iterator = atomicCounterTypeMap_.find(it.first);
-    if (iterator == atomicCounterTypeMap_.end()) {
-      FairRWLock::WriteHolder writeLock(std::move(upgradeLock));
-      atomic_fetch_max(atomicCounterTypeMap_[it.first], it.second);
-      upgradeLock = FairRWLock::UpgradeHolder(std::move(writeLock));
-    } else {
-      atomic_fetch_max(atomicCounterTypeMap_[it.first], it.second);
-    }
+    update(it.first, [&](std::atomic<uint64_t>& counter) {
+      return atomic_fetch_max(counter, it.second);
+    });
   }
 }
 
 OffsetMap AtomicOffsetMap::load() const {
   OffsetMap om;
+  if (has_byte_offset_.load()) {
+    om.setCounter(BYTE_OFFSET, byte_offset_.load());
+  }
   FairRWLock::ReadHolder read_guard(rw_lock_);
   for (const auto& it : atomicCounterTypeMap_) {
     om.setCounter(it.first, it.second.load());
@@ -212,17 +249,10 @@ OffsetMap AtomicOffsetMap::load() const {
 
 OffsetMap AtomicOffsetMap::fetchAdd(const OffsetMap& offsets_map) {
   OffsetMap om;
-  uint64_t offset;
-  FairRWLock::UpgradeHolder upgradeLock(rw_lock_);
   for (const auto& it : offsets_map.getCounterMap()) {
-    auto iterator = atomicCounterTypeMap_.find(it.first);
-    if (iterator == atomicCounterTypeMap_.end()) {
-      FairRWLock::WriteHolder writeLock(std::move(upgradeLock));
-      offset = atomicCounterTypeMap_[it.first].fetch_add(it.second) + it.second;
-      upgradeLock = FairRWLock::UpgradeHolder(std::move(writeLock));
-    } else {
-      offset = atomicCounterTypeMap_[it.first].fetch_add(it.second) + it.second;
-    }
+    uint64_t offset = update(it.first, [&](std::atomic<uint64_t>& counter) {
+      return counter.fetch_add(it.second) + it.second;
+    });
     om.setCounter(it.first, offset);
   }
   return om;
@@ -10,8 +10,10 @@
 
 #include <atomic>
 #include <map>
+#include <utility>
 
 #include <folly/SharedMutex.h>
+#include <folly/small_vector.h>
 
 #include "logdevice/common/SerializableData.h"
 #include "logdevice/include/RecordOffset.h"
@@ -22,6 +24,11 @@ namespace facebook { namespace logdevice {
  * @file map of counters that contains information on amount of data within
  *       epoch or at the end of epoch. Currently contains information on number
  *       of bytes. Refer to counter_type_t for information on tracked counters.
+ *
+ *       OffsetMaps are copied, updated and serialized for every append, and
+ *       almost always hold a single counter (BYTE_OFFSET). Counters are kept
+ *       in a vector sorted by counter type, with room for one counter inline,
+ *       so that the common case doesn't allocate.
  */
 
 class OffsetMap : public SerializableData {
@@ -29,6 +36,11 @@ class OffsetMap : public SerializableData {
   using SerializableData::deserialize;
   using SerializableData::serialize;
 
+  // Pairs <counter_type, counter_value>, sorted by counter_type, without
+  // duplicates.
+  using CounterMap =
+      folly::small_vector<std::pair<counter_type_t, uint64_t>, 1>;
+
   OffsetMap() noexcept = default;
   /*
    * Constructs an OffsetMap object from intializer_list. This constructor
@@ -56,7 +68,7 @@ class OffsetMap : public SerializableData {
    * get counterTypeMap_
    * @return  counterTypeMap_
    */
-  const std::map<counter_type_t, uint64_t>& getCounterMap() const;
+  const CounterMap& getCounterMap() const;
 
   /**
    * removes counter_type from counterTypeMap_
@@ -158,7 +170,11 @@ class OffsetMap : public SerializableData {
   bool operator!=(const OffsetMap& om) const;
 
  private:
-  std::map<counter_type_t, uint64_t> counterTypeMap_;
+  // Returns a reference to the value of counter_type, inserting a zero if
+  // there is none.
+  uint64_t& getOrInsert(counter_type_t counter_type);
+
+  CounterMap counterTypeMap_;
 };
 
 class AtomicOffsetMap {
@@ -181,6 +197,15 @@ class AtomicOffsetMap {
   OffsetMap fetchAdd(const OffsetMap& offsets_map);
 
  private:
+  // Updates the counter of the given type, passing it to op(). BYTE_OFFSET,
+  // the only counter in practice, is kept outside of the map, so that
+  // updating it on every append takes neither the lock nor a lookup.
+  template <typename Op>
+  uint64_t update(counter_type_t counter_type, Op op);
+
+  std::atomic<bool> has_byte_offset_{false};
+  std::atomic<uint64_t> byte_offset_{0};
+
   using FairRWLock = folly::SharedMutexWritePriority;
   FairRWLock rw_lock_;
   std::map<counter_type_t, std::atomic<uint64_t>> atomicCounterTypeMap_;
@@ -74,7 +74,8 @@ void PayloadHolder::serialize(ProtocolWriter& writer) const {
 
 /* static */
 PayloadHolder PayloadHolder::deserialize(ProtocolReader& reader,
-                                         size_t payload_size) {
+                                         size_t payload_size,
+                                         bool share) {
   if (reader.error()) {
     return PayloadHolder();
   }
@@ -85,7 +86,7 @@ PayloadHolder PayloadHolder::deserialize(ProtocolReader& reader,
 
   ld_check(payload_size > 0);
   PayloadHolder p;
-  reader.readIOBuf(&p.iobuf_, payload_size);
+  reader.readIOBuf(&p.iobuf_, payload_size, share);
   ld_check_eq(p.size(), reader.error() ? 0ul : payload_size);
 
   return p;
@@ -136,11 +136,19 @@ class PayloadHolder {
    * @param reader              ProtocolReader object that encapsulates the
    *                            buffer to read serialized data from
    * @param payload_size        number of bytes to read
+   * @param share               if true, the PayloadHolder references the
+   *                            received message buffer instead of copying
+   *                            out of it, even if the payload is only a small
+   *                            part of that buffer. Use this when the payload
+   *                            is the rest of a message whose buffer is
+   *                            released soon anyway (e.g. RECORD, STORE).
    *
    * @return  constructed PayloadHolder object, the object is invalid if
    *          deserializtion failed (i.e., reader enters error state).
    */
-  static PayloadHolder deserialize(ProtocolReader& reader, size_t payload_size);
+  static PayloadHolder deserialize(ProtocolReader& reader,
+                                   size_t payload_size,
+                                   bool share = false);
 
   /**
    * Corrupts a copy of the payload, runs reset(), and sets the corrupted copy
@@ -8,6 +8,7 @@
 #include "logdevice/common/Processor.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <vector>
@@ -16,11 +17,12 @@
 #include <folly/Hash.h>
 #include <folly/MPMCQueue.h>
 #include <folly/Memory.h>
-#include <folly/container/Array.h>
+#include <folly/Optional.h>
 #include <folly/synchronization/CallOnce.h>
 
 #include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/AppendProbeController.h"
+#include "logdevice/common/CPUAffinity.h"
 #include "logdevice/common/ClientAPIHitsTracer.h"
 #include "logdevice/common/ClientIdxAllocator.h"
 #include "logdevice/common/ClusterState.h"
@@ -35,6 +37,7 @@
 #include "logdevice/common/SSLSessionCache.h"
 #include "logdevice/common/SecurityInformation.h"
 #include "logdevice/common/SequencerBatching.h"
+#include "logdevice/common/SequencerLocationCache.h"
 #include "logdevice/common/SequencerLocator.h"
 #include "logdevice/common/TLSCredMonitor.h"
 #include "logdevice/common/Thread.h"
@@ -187,6 +190,7 @@ Processor::Processor(std::shared_ptr<UpdateableConfig> updateable_config,
       stats_(stats),
       impl_(new ProcessorImpl(this, settings, trace_logger)),
       sequencer_locator_(get_sequencer_locator(plugin_registry_, config_)),
+      sequencer_location_cache_(std::make_unique<SequencerLocationCache>()),
       conn_budget_incoming_(settings_->max_incoming_connections),
       conn_budget_external_(settings_->max_external_connections),
       api_hits_tracer_(std::make_unique<ClientAPIHitsTracer>(trace_logger)),
@@ -273,6 +277,9 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
   workers_t workers;
   workers.reserve(count);
 
+  const int numa_nodes =
+      local_settings->worker_numa_affinity ? getNumaNodeCount() : 1;
+
   for (int i = 0; i < count; i++) {
     // increment the next worker idx
     std::unique_ptr<Worker> worker;
@@ -283,13 +290,22 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
           ThreadID::CPU_EXEC,
           local_settings->worker_request_pipe_capacity,
           local_settings->enable_executor_priority_queues,
-          folly::make_array<uint32_t>(
-              local_settings->hi_requests_per_iteration,
-              local_settings->mid_requests_per_iteration,
-              local_settings->lo_requests_per_iteration),
+          local_settings->requestsPerIteration(type),
           local_settings->use_legacy_eventbase ? EvBase::LEGACY_EVENTBASE
                                                : EvBase::FOLLY_EVENTBASE,
           /* start_running */ false));
+      loops.back()->getTaskQueue().setStats(stats_);
+      if (numa_nodes > 1) {
+        // Best effort: a worker that can't be pinned just runs anywhere.
+        const int node = i % numa_nodes;
+        std::vector<int> cpus = getNumaNodeCPUs(node);
+        if (setThreadCPUAffinity(loops.back()->getThreadId(), cpus) == 0) {
+          ld_info("Pinned %s to NUMA node %d (CPUs %s)",
+                  Worker::getName(type, worker_id_t(i)).c_str(),
+                  node,
+                  formatCPUList(cpus).c_str());
+        }
+      }
       auto executor = folly::getKeepAliveToken(loops.back().get());
       worker.reset(createWorker(std::move(executor), worker_id_t(i), type));
     } catch (ConstructorFailed&) {
@@ -349,7 +365,12 @@ int Processor::getAllWorkersCount() const {
 }
 
 worker_id_t Processor::selectWorkerRandomly(uint64_t seed, WorkerType type) {
-  auto count = getWorkerCount(type);
+  int count = getWorkerCount(type);
+  if (type == WorkerType::GENERAL) {
+    // Don't give new work to parked workers.
+    count = std::min(
+        count, int(impl_->worker_load_balancing_.activeWorkers()));
+  }
   ld_check_gt(count, 0);
   return worker_id_t(folly::hash::twang_mix64(seed) % count);
 }
@@ -453,6 +474,79 @@ int Processor::postRequest(std::unique_ptr<Request>& rq) {
       rq, rq->getWorkerTypeAffinity(), getTargetThreadForRequest(rq));
 }
 
+size_t Processor::postBatchImpl(std::vector<std::unique_ptr<Request>>& rqs,
+                                bool force) {
+  if (shutting_down_.load() && !(force && allow_post_during_shutdown_)) {
+    err = E::SHUTDOWN;
+    return 0;
+  }
+
+  // Group requests by target worker, preserving their order. Remember where
+  // each one came from so that we can put it back if posting fails.
+  struct Batch {
+    std::vector<size_t> positions;
+    std::vector<std::unique_ptr<Request>> requests;
+  };
+  std::map<std::pair<WorkerType, int>, Batch> batches;
+  folly::Optional<E> failure;
+  for (size_t i = 0; i < rqs.size(); ++i) {
+    if (!rqs[i]) {
+      failure = E::INVALID_PARAM;
+      continue;
+    }
+    WorkerType worker_type = rqs[i]->getWorkerTypeAffinity();
+    int target_thread = getTargetThreadForRequest(rqs[i]);
+    if (target_thread >= getWorkerCount(worker_type)) {
+      failure = E::INVALID_PARAM;
+      continue;
+    }
+    Batch& batch = batches[std::make_pair(worker_type, target_thread)];
+    batch.positions.push_back(i);
+    batch.requests.push_back(std::move(rqs[i]));
+  }
+
+  size_t posted = 0;
+  for (auto& kv : batches) {
+    WorkerType worker_type = kv.first.first;
+    worker_id_t worker_idx(kv.first.second);
+    Batch& batch = kv.second;
+    std::vector<RequestType> types;
+    types.reserve(batch.requests.size());
+    for (const auto& rq : batch.requests) {
+      types.push_back(rq->type_);
+    }
+
+    Worker& w = getWorker(worker_idx, worker_type);
+    const int rv = w.postBatch(batch.requests, force);
+    for (RequestType type : types) {
+      Request::bumpStatsWhenPosted(
+          stats_, type, worker_type, worker_idx, rv == 0);
+    }
+    if (rv == 0) {
+      posted += batch.requests.size();
+    } else {
+      failure = err;
+      for (size_t j = 0; j < batch.positions.size(); ++j) {
+        rqs[batch.positions[j]] = std::move(batch.requests[j]);
+      }
+    }
+  }
+
+  if (failure.hasValue()) {
+    err = failure.value();
+  }
+  return posted;
+}
+
+size_t Processor::postRequests(std::vector<std::unique_ptr<Request>>& rqs) {
+  return postBatchImpl(rqs, /* force */ false);
+}
+
+size_t
+Processor::postImportantRequests(std::vector<std::unique_ptr<Request>>& rqs) {
+  return postBatchImpl(rqs, /* force */ true);
+}
+
 int Processor::blockingRequestImpl(std::unique_ptr<Request>& rq, bool force) {
   Semaphore sem;
   rq->setClientBlockedSemaphore(&sem);
@@ -642,7 +736,37 @@ void Processor::reportLoad(worker_id_t idx,
                            int64_t load,
                            WorkerType worker_type) {
   ld_check(worker_type == WorkerType::GENERAL);
-  impl_->worker_load_balancing_.reportLoad(idx, load);
+  auto& balancing = impl_->worker_load_balancing_;
+  balancing.reportLoad(idx, load);
+
+  // Worker 0 is never parked, so its periodic reports drive parking.
+  if (idx.val_ != 0) {
+    return;
+  }
+  auto s = settings();
+  // Loads are in CPU microseconds per second.
+  const int64_t park_below = s->worker_park_utilization_pct * 10000;
+  const int64_t unpark_above = s->worker_unpark_utilization_pct * 10000;
+  size_t min_active = s->min_active_workers;
+  if (park_below >= unpark_above) {
+    RATELIMIT_WARNING(std::chrono::minutes(1),
+                      1,
+                      "--worker-park-utilization-pct must be less than "
+                      "--worker-unpark-utilization-pct, not parking workers");
+    min_active = 0;
+  }
+  const size_t before = balancing.activeWorkers();
+  const size_t after =
+      balancing.adjustActiveWorkers(min_active, park_below, unpark_above);
+  if (after != before) {
+    ld_info("%s worker threads: %zu of %d now active",
+            after < before ? "Parked" : "Unparked",
+            after,
+            getWorkerCount(WorkerType::GENERAL));
+  }
+  STAT_SET(stats_,
+           parked_workers,
+           getWorkerCount(WorkerType::GENERAL) - int(after));
 }
 
 int Processor::postImportant(std::unique_ptr<Request>& rq) {
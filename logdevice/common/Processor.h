@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <memory>
@@ -57,6 +58,7 @@ class ProcessorImpl;
 class Request;
 class SequencerBatching;
 class ReadStreamDebugInfoSamplingConfig;
+class SequencerLocationCache;
 class SequencerLocator;
 class SSLSessionCache;
 class StatsHolder;
@@ -150,6 +152,9 @@ class Processor : public folly::enable_shared_from_this<Processor> {
                int target_thread,
                bool force);
 
+  // Common implementation of postRequests() and postImportantRequests().
+  size_t postBatchImpl(std::vector<std::unique_ptr<Request>>& rqs, bool force);
+
   int blockingRequestImpl(std::unique_ptr<Request>& rq, bool force);
 
   /**
@@ -340,6 +345,25 @@ class Processor : public folly::enable_shared_from_this<Processor> {
     return postImportant(rq);
   }
 
+  /**
+   * Batched versions of postRequest() and postImportant(). Each request is
+   * routed to the same worker postRequest() would route it to, and requests
+   * going to the same worker are handed over together, waking the worker up
+   * once per batch instead of once per request. Requests for the same worker
+   * are executed in the order they appear in `rqs`.
+   *
+   * @param rqs  requests to execute. Requests that were successfully posted
+   *             are replaced with nullptr. The ones that could not be posted
+   *             are left in place and remain owned by the caller. For
+   *             postRequests(), NOBUFS fails all requests for the worker in
+   *             question.
+   *
+   * @return number of requests posted. If less than rqs.size(), err is set
+   *         as in postRequest()/postImportant() for one of the failures.
+   */
+  size_t postRequests(std::vector<std::unique_ptr<Request>>& rqs);
+  size_t postImportantRequests(std::vector<std::unique_ptr<Request>>& rqs);
+
   /**
    * Are we a storage node, able to store and deliver records?
    */
@@ -527,6 +551,10 @@ class Processor : public folly::enable_shared_from_this<Processor> {
   // sequencer for a particular log.
   std::unique_ptr<SequencerLocator> sequencer_locator_;
 
+  // Sequencer nodes that recently accepted appends, per log. Consulted by
+  // SequencerRouter on clients before asking sequencer_locator_.
+  std::unique_ptr<SequencerLocationCache> sequencer_location_cache_;
+
   // ResourceBudget used to limit the total number of accepted connections.
   // See Settings::max_incoming_connections_.
   ResourceBudget conn_budget_incoming_;
@@ -592,6 +620,19 @@ class Processor : public folly::enable_shared_from_this<Processor> {
     return buffered_writer_id_t(next_buffered_writer_id_++);
   }
 
+  /**
+   * Maintains the number of bytes buffered by all client read streams of this
+   * Processor, @see ClientReadStream::getBytesBuffered(). Read streams shrink
+   * their windows while it's above --client-read-buffers-memory-limit.
+   */
+  void noteClientReadStreamsBytesBuffered(int64_t delta) {
+    client_read_streams_bytes_buffered_.fetch_add(delta);
+  }
+
+  size_t getClientReadStreamsBytesBuffered() const {
+    return std::max(int64_t(0), client_read_streams_bytes_buffered_.load());
+  }
+
   std::map<logid_t, lsn_t> getAllRSMVersions();
   std::map<logid_t, lsn_t> getAllDurableRSMVersions();
   void setRSMVersion(logid_t rsm_type, lsn_t ver);
@@ -599,7 +640,8 @@ class Processor : public folly::enable_shared_from_this<Processor> {
 
   /**
    * Selects a worker based on hash of the given `seed` value.
-   * Seed can be e.g. request ID or a random number.
+   * Seed can be e.g. request ID or a random number. Parked GENERAL workers
+   * (see --min-active-workers) are never selected.
    */
   worker_id_t selectWorkerRandomly(uint64_t seed, WorkerType type);
 
@@ -611,7 +653,7 @@ class Processor : public folly::enable_shared_from_this<Processor> {
 
   /**
    * Proxy for WorkerLoadBalancing::reportLoad(), used by Worker to report
-   * load.
+   * load. Reports of worker 0 also park or unpark workers.
    */
   virtual void reportLoad(worker_id_t idx,
                           int64_t load,
@@ -724,6 +766,9 @@ class Processor : public folly::enable_shared_from_this<Processor> {
   // Next ID for issueBufferedWriterID()
   std::atomic<buffered_writer_id_t::raw_type> next_buffered_writer_id_{1};
 
+  // See noteClientReadStreamsBytesBuffered().
+  std::atomic<int64_t> client_read_streams_bytes_buffered_{0};
+
   // See isDataMissingFromShard().
   folly::ConcurrentBitSet<MAX_SHARDS> shards_not_missing_data_;
 
@@ -29,14 +29,26 @@ RSMBasedVersionedConfigStore::RSMBasedVersionedConfigStore(
       processor_(processor),
       stop_timeout_(stop_timeout) {
   auto cb = [this](const KeyValueStoreState& state,
-                   const KeyValueStoreDelta*,
+                   const KeyValueStoreDelta* delta,
                    lsn_t version) {
     {
-      // It should probably always override the state.
       auto locked_state = state_.wlock();
-      if (version > locked_state->version) {
+      if (delta && synced_with_rsm_ && version >= locked_state->version) {
+        // The copy has all the previous deltas, apply just this one instead
+        // of copying the whole store. If version is equal, this is the delta
+        // of our own write that updateStateEntry() already applied, and
+        // applying it again is a no-op.
+        KeyValueStoreStateMachine::apply(*delta, locked_state->store);
+        locked_state->version = version;
+      } else if (version > locked_state->version) {
+        // It should probably always override the state.
         locked_state->store = state.store;
         locked_state->version = version;
+        synced_with_rsm_ = true;
+      } else if (delta) {
+        // We skipped a delta older than one of our own writes. Copy the whole
+        // store on the next update to pick it up.
+        synced_with_rsm_ = false;
       }
     }
     ready_.store(true);
@@ -56,6 +56,9 @@ class RSMBasedVersionedConfigStore : public VersionedConfigStore {
       subscription_handle_;
   folly::Synchronized<replicated_state_machine::thrift::KeyValueStoreState>
       state_;
+  // Whether state_ has all the deltas the RSM delivered, so that the next one
+  // can be applied to it incrementally. Protected by state_'s lock.
+  bool synced_with_rsm_{false};
   /**
    * The processor is used to perform RSM operations on the client side.
    */
@@ -178,6 +178,18 @@ class ShardRebuildingInterface {
   virtual void
   start(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan) = 0;
 
+  // Tells that the plan passed to start() doesn't cover all logs: the rest
+  // will come through addLogs(), and rebuilding can't complete before
+  // addLogs() is called with last = true. Must be called before start().
+  virtual void expectMoreLogs() = 0;
+
+  // Adds logs that were planned after start(). Only allowed after
+  // expectMoreLogs() and start(), and until called with last = true.
+  // `plan` may be empty. May call Listener::onShardRebuildingComplete().
+  virtual void
+  addLogs(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan,
+          bool last) = 0;
+
   // Notification that other donors made enough progress to allow us to advance
   // the global window to the given point. Note that the window can move
   // backwards (if window size setting was changed at runtime).
@@ -67,6 +67,62 @@ class RunContext {
     return !operator==(b);
   }
 
+  // Packs the context into an integer so that it can be published through an
+  // atomic and read from another thread (e.g. by WatchDogThread).
+  uint32_t pack() const {
+    uint32_t subtype = 0;
+    switch (type_) {
+      case NONE:
+        break;
+      case REQUEST:
+        subtype = static_cast<unsigned char>(subtype_.request);
+        break;
+      case MESSAGE:
+        subtype = static_cast<unsigned char>(subtype_.message);
+        break;
+      case STORAGE_TASK_RESPONSE:
+        subtype = static_cast<unsigned char>(subtype_.storage_task);
+        break;
+    }
+    return (static_cast<uint32_t>(type_) << 8) | subtype;
+  }
+
+  static RunContext unpack(uint32_t packed) {
+    RunContext res;
+    auto subtype = static_cast<unsigned char>(packed & 0xff);
+    switch (static_cast<Type>(packed >> 8)) {
+      case NONE:
+        break;
+      case REQUEST:
+        res = RunContext(static_cast<RequestType>(subtype));
+        break;
+      case MESSAGE:
+        res = RunContext(static_cast<MessageType>(subtype));
+        break;
+      case STORAGE_TASK_RESPONSE:
+        res = RunContext(static_cast<StorageTaskType>(subtype));
+        break;
+    }
+    return res;
+  }
+
+  // Name of the request/message/storage task type, without the kind of
+  // context describe() prefixes it with.
+  std::string subtypeName() const {
+    switch (type_) {
+      case NONE:
+        return "None";
+      case REQUEST:
+        return requestTypeNames[subtype_.request];
+      case MESSAGE:
+        return messageTypeNames()[subtype_.message].c_str();
+      case STORAGE_TASK_RESPONSE:
+        return storageTaskTypeNames[subtype_.storage_task].c_str();
+    }
+    ld_check(false);
+    return "";
+  }
+
   std::string describe() {
     std::string res("[");
     switch (type_) {
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/STOREDBatcher.h"
+
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/RebuildingTypes.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/STORED_BATCH_Message.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+STOREDBatcher::STOREDBatcher() : flush_timer_([this] { flushAll(); }) {}
+
+bool STOREDBatcher::add(const STORED_Message& msg, ClientID to) {
+  Worker* w = Worker::onThisThread();
+  const size_t max_batch_size = w->settings().max_stored_batch_size;
+  if (max_batch_size <= 1 || !STORED_BATCH_Message::canBatch(msg.header_)) {
+    flush(to);
+    return false;
+  }
+  auto proto = w->sender().getSocketProtocolVersion(to);
+  if (!proto.hasValue() ||
+      proto.value() < Compatibility::STORED_BATCH_SUPPORT) {
+    flush(to);
+    return false;
+  }
+
+  auto& batch = pending_[to];
+  batch.push_back(msg.header_);
+  if (batch.size() >= max_batch_size) {
+    flush(to);
+  } else if (!flush_timer_.isActive()) {
+    flush_timer_.activate(std::chrono::microseconds(0));
+  }
+  return true;
+}
+
+void STOREDBatcher::flush(ClientID to) {
+  auto it = pending_.find(to);
+  if (it == pending_.end()) {
+    return;
+  }
+  std::vector<STORED_Header> headers = std::move(it->second);
+  pending_.erase(it);
+  ld_check(!headers.empty());
+
+  Worker* w = Worker::onThisThread();
+  std::unique_ptr<Message> msg;
+  if (headers.size() == 1) {
+    msg = std::make_unique<STORED_Message>(
+        headers[0],
+        LSN_INVALID,
+        0,
+        CHUNK_REBUILDING_ID_INVALID,
+        FlushToken_INVALID,
+        w->processor_->getServerInstanceId());
+  } else {
+    WORKER_STAT_INCR(node_stored_batches_sent);
+    WORKER_STAT_ADD(node_stored_batched, headers.size());
+    msg = std::make_unique<STORED_BATCH_Message>(std::move(headers));
+  }
+  int rv = w->sender().sendMessage(std::move(msg), to);
+  if (rv != 0) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Failed to send replies to STOREs to %s: %s",
+                   Sender::describeConnection(Address(to)).c_str(),
+                   error_description(err));
+  }
+}
+
+void STOREDBatcher::flushAll() {
+  while (!pending_.empty()) {
+    flush(pending_.begin()->first);
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/ClientID.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/protocol/STORED_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Batches replies to STOREs per sequencer connection on a storage node,
+ *       so that a sequencer writing many small records gets one STORED_BATCH
+ *       message instead of a STORED message for each copy. Replies are held
+ *       until the end of the current event loop iteration, or until
+ *       --max-stored-batch-size of them are pending for the connection.
+ *
+ *       Owned by the Worker that owns the connections, see
+ *       Worker::storedBatcher().
+ */
+
+class STOREDBatcher {
+ public:
+  STOREDBatcher();
+
+  /**
+   * Adds the reply to the batch for `to` if batching is enabled, the reply
+   * can be batched and the peer supports STORED_BATCH.
+   *
+   * @return true if the reply was taken, false if the caller must send `msg`
+   *         itself. In that case the batch pending for `to` was sent first,
+   *         so that replies go out in the order they were made.
+   */
+  bool add(const STORED_Message& msg, ClientID to);
+
+  /**
+   * Sends the replies pending for `to`, if any.
+   */
+  void flush(ClientID to);
+
+  /**
+   * Sends all pending replies.
+   */
+  void flushAll();
+
+ private:
+  std::unordered_map<ClientID, std::vector<STORED_Header>, ClientID::Hash>
+      pending_;
+
+  // Zero-delay timer flushing all batches at the end of the event loop
+  // iteration in which the first of them got a reply.
+  Timer flush_timer_;
+};
+
+}} // namespace facebook::logdevice
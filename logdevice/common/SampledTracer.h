@@ -85,6 +85,13 @@ class SampledTracer {
     return false;
   }
 
+  // Flips the same coin as publish() does for `table`, without publishing
+  // anything. For tracers that decide up front whether to follow an operation
+  // and then publish all of its samples with force=true.
+  bool shouldSample(const char* table) const {
+    return logger_ && folly::Random::randDouble(0, 100) < percentage(table);
+  }
+
   const std::shared_ptr<TraceLogger> logger_;
 
  private:
@@ -15,6 +15,7 @@
 #include <folly/Optional.h>
 #include <folly/Random.h>
 #include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
 #include <folly/json.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -75,6 +76,89 @@ std::string Converter<Address>::operator()(Address address,
 }
 } // namespace admin_command_table
 
+/**
+ * Extra data connections to a node, used when --num-connections-per-node is
+ * greater than 1. Stripe 0 is the node's connection in server_conns_ (the
+ * primary), stripes 1..n-1 live here.
+ *
+ * All stripes share fate with the primary: when any of them closes, all of
+ * them are closed. Code that registers on-close callbacks on the connection
+ * to a node (read streams, Appenders...) thus still learns about the loss of
+ * messages it sent over any stripe.
+ */
+class ServerConnectionStripes {
+ public:
+  ServerConnectionStripes(Connection& primary, size_t nstripes)
+      : primary_(&primary), conns_(nstripes - 1), on_close_(nstripes) {
+    for (auto& cb : on_close_) {
+      cb.owner_ = this;
+    }
+    primary.pushOnCloseCallback(on_close_[0]);
+  }
+
+  // @return true if these are the stripes of `primary`, and it's still open.
+  bool belongsTo(const Connection& primary) const {
+    return primary_ == &primary;
+  }
+
+  // @param stripe  in [1, nstripes)
+  std::unique_ptr<Connection>& at(size_t stripe) {
+    ld_check(stripe > 0 && stripe <= conns_.size());
+    return conns_[stripe - 1];
+  }
+
+  // Closes the stripes but not the primary, which the caller is about to
+  // replace and close on its own.
+  void detach(Status reason) {
+    on_close_[0].deactivate();
+    primary_ = nullptr;
+    closeAll(reason);
+  }
+
+  // Makes the closing of a newly created stripe close all others.
+  void watch(size_t stripe) {
+    at(stripe)->pushOnCloseCallback(on_close_[stripe]);
+  }
+
+  void closeAll(Status reason) {
+    if (closing_) {
+      return;
+    }
+    closing_ = true;
+    if (primary_ != nullptr && !primary_->isClosed()) {
+      primary_->close(reason);
+    }
+    primary_ = nullptr;
+    for (auto& conn : conns_) {
+      if (conn && !conn->isClosed()) {
+        conn->close(reason);
+      }
+    }
+    closing_ = false;
+  }
+
+  const std::vector<std::unique_ptr<Connection>>& connections() const {
+    return conns_;
+  }
+
+ private:
+  class OnClose : public SocketCallback {
+   public:
+    void operator()(Status st, const Address& /* name */) override {
+      owner_->closeAll(st);
+    }
+    ServerConnectionStripes* owner_{nullptr};
+  };
+
+  // nullptr once closed.
+  Connection* primary_;
+  std::vector<std::unique_ptr<Connection>> conns_;
+  // on_close_[i] is registered on stripe i. Never resized, since the
+  // callbacks are linked into the Connections' lists.
+  std::vector<OnClose> on_close_;
+  bool closing_{false};
+};
+
 class SenderImpl {
  public:
   explicit SenderImpl(ClientIdxAllocator* client_id_allocator)
@@ -86,6 +170,12 @@ class SenderImpl {
   // attempts is controlled by a ConnectionThrottle.
   folly::F14NodeMap<node_index_t, std::unique_ptr<Connection>> server_conns_;
 
+  // Extra connections to nodes in server_conns_, see
+  // --num-connections-per-node. Stripes of a closed primary stay here until
+  // the primary is replaced.
+  folly::F14NodeMap<node_index_t, std::unique_ptr<ServerConnectionStripes>>
+      server_conn_stripes_;
+
   // a map of all Connections wrapping connections that were accepted from
   // clients, keyed by 32-bit client ids. This map is empty on clients.
   folly::F14NodeMap<ClientID, std::unique_ptr<Connection>, ClientID::Hash>
@@ -166,7 +256,8 @@ int Sender::addClient(int fd,
                       const Sockaddr& client_addr,
                       ResourceBudget::Token conn_token,
                       SocketType type,
-                      ConnectionType conntype) {
+                      ConnectionType conntype,
+                      ResourceBudget::Token handshake_token) {
   if (shutting_down_) {
     ld_check(false); // listeners are shut down before Senders.
     ld_error("Sender is shut down");
@@ -209,6 +300,7 @@ int Sender::addClient(int fd,
         flow_group,
         std::make_unique<SocketDependencies>(
             Worker::onThisThread()->processor_, this));
+    conn->setHandshakeToken(std::move(handshake_token));
 
     auto res = impl_->client_conns_.emplace(client_name, std::move(conn));
 
@@ -610,6 +702,13 @@ Sender::getSocketProtocolVersion(node_index_t idx) const {
                                                  : folly::Optional<uint16_t>();
 }
 
+folly::Optional<uint16_t>
+Sender::getSocketProtocolVersion(ClientID cid) const {
+  auto conn = findClientConnection(cid);
+  return conn != nullptr && conn->isHandshaken() ? conn->getProto()
+                                                 : folly::Optional<uint16_t>();
+}
+
 ClientID Sender::getOurNameAtPeer(node_index_t node_index) const {
   Connection* conn = findServerConnection(node_index);
   return conn != nullptr ? conn->getOurNameAtPeer() : ClientID::INVALID;
@@ -677,6 +776,14 @@ void Sender::flushOutputAndClose(Status reason) {
       ++open_socket_count;
     }
   }
+  for (const auto& it : impl_->server_conn_stripes_) {
+    for (const auto& conn : it.second->connections()) {
+      if (conn && !conn->isClosed()) {
+        conn->flushOutputAndClose(reason);
+        ++open_socket_count;
+      }
+    }
+  }
 
   for (auto& it : impl_->client_conns_) {
     if (it.second && !it.second->isClosed()) {
@@ -730,6 +837,15 @@ int Sender::closeServerSocket(NodeID peer, Status reason) {
 std::pair<uint32_t, uint32_t> Sender::closeAllSockets() {
   std::pair<uint32_t, uint32_t> sockets_closed = {0, 0};
 
+  for (auto& entry : impl_->server_conn_stripes_) {
+    for (const auto& conn : entry.second->connections()) {
+      if (conn && !conn->isClosed()) {
+        sockets_closed.first++;
+        conn->close(E::SHUTDOWN);
+      }
+    }
+  }
+
   for (auto& entry : impl_->server_conns_) {
     if (entry.second && !entry.second->isClosed()) {
       sockets_closed.first++;
@@ -765,6 +881,7 @@ void Sender::shutdownSockets(folly::Executor* executor) {
   executor->add([&] {
     shutting_down_ = true;
     closeAllSockets();
+    impl_->server_conn_stripes_.clear();
     impl_->server_conns_.clear();
     impl_->client_conns_.clear();
     sem.post();
@@ -795,6 +912,16 @@ bool Sender::isClosed() const {
       }
     }
   }
+  for (const auto& it : impl_->server_conn_stripes_) {
+    for (const auto& conn : it.second->connections()) {
+      if (conn && !conn->isClosed()) {
+        if (!go_over_all_sockets) {
+          return false;
+        }
+        ++num_open_server_sockets;
+      }
+    }
+  }
 
   int num_open_client_sockets = 0;
   ClientID max_pending_work_clientID;
@@ -990,6 +1117,11 @@ Connection* Sender::initServerConnection(NodeID nid, SocketType sock_type) {
       });
       ld_check(!it->second);
       impl_->server_conns_.erase(it);
+      auto stripes = impl_->server_conn_stripes_.find(nid.index());
+      if (stripes != impl_->server_conn_stripes_.end()) {
+        stripes->second->detach(E::SSLREQUIRED);
+        impl_->server_conn_stripes_.erase(stripes);
+      }
       it = impl_->server_conns_.end();
     }
   }
@@ -1151,7 +1283,64 @@ Connection* FOLLY_NULLABLE Sender::getConnection(const NodeID& nid,
 
   // conn is now connecting or connected, send msg
   ld_assert(conn->connect() == -1 && (err == E::ALREADY || err == E::ISCONN));
-  return conn;
+  return sock_type == SocketType::DATA ? selectServerConnectionStripe(*conn, msg)
+                                       : conn;
+}
+
+Connection* FOLLY_NULLABLE
+Sender::selectServerConnectionStripe(Connection& primary, const Message& msg) {
+  const size_t nstripes = settings_->num_connections_per_node;
+  const logid_t log_id = msg.getLogID();
+  if (nstripes <= 1 || log_id == LOGID_INVALID) {
+    return &primary;
+  }
+  const size_t stripe = folly::hash::twang_mix64(log_id.val_) % nstripes;
+  if (stripe == 0) {
+    return &primary;
+  }
+
+  const node_index_t idx = primary.peer_name_.asNodeID().index();
+  auto& stripes = impl_->server_conn_stripes_[idx];
+  if (!stripes || !stripes->belongsTo(primary)) {
+    // First use, or the primary was replaced since the stripes were created.
+    if (stripes) {
+      stripes->detach(E::PEER_CLOSED);
+    }
+    stripes = std::make_unique<ServerConnectionStripes>(primary, nstripes);
+  }
+
+  auto& conn = stripes->at(stripe);
+  if (!conn || conn->isClosed()) {
+    try {
+      conn = connection_factory_->createConnection(
+          primary.peer_name_.asNodeID(),
+          SocketType::DATA,
+          primary.getConnType(),
+          primary.flow_group_,
+          std::make_unique<SocketDependencies>(
+              Worker::onThisThread()->processor_, this));
+    } catch (ConstructorFailed& exp) {
+      ld_critical("Could not create connection %zu to node %s: %s",
+                  stripe,
+                  primary.peer_name_.toString().c_str(),
+                  exp.what());
+      if (err == E::NOTINCONFIG || err == E::NOSSLCONFIG) {
+        return nullptr;
+      }
+      ld_check(false);
+      err = E::INTERNAL;
+      return nullptr;
+    }
+    stripes->watch(stripe);
+  }
+
+  int rv = conn->connect();
+  if (rv != 0 && err != E::ALREADY && err != E::ISCONN) {
+    ld_check(err == E::UNROUTABLE || err == E::DISABLED || err == E::SYSLIMIT ||
+             err == E::NOMEM || err == E::INTERNAL);
+    return nullptr;
+  }
+  return conn.get();
 }
 Connection* FOLLY_NULLABLE Sender::getConnection(const Address& addr,
 
@@ -1509,6 +1698,7 @@ void Sender::noteConfigurationChanged(
     }
 
     s->close(E::NOTINCONFIG);
+    impl_->server_conn_stripes_.erase(it->first);
     it = impl_->server_conns_.erase(it);
   }
 }
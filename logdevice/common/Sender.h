@@ -686,6 +686,9 @@ class Sender : public SenderBase {
    * @param conn_token  an object used for accepted connection accounting
    * @param type        type of socket (DATA/GOSSIP)
    * @param conntype    type of connection (PLAIN/SSL)
+   * @param handshake_token  held by the Connection until the peer's handshake
+   *                    (HELLO) is received, to bound the number of accepted
+   *                    connections that haven't completed their handshake
    *
    * @return  0 on success, -1 if we failed to create a Connection, sets err to:
    *     EXISTS          a Connection for this ClientID already exists
@@ -698,7 +701,9 @@ class Sender : public SenderBase {
                 const Sockaddr& client_addr,
                 ResourceBudget::Token conn_token,
                 SocketType type,
-                ConnectionType conntype);
+                ConnectionType conntype,
+                ResourceBudget::Token handshake_token =
+                    ResourceBudget::Token());
 
   /**
    * Called by a Connection managed by this Sender when bytes are added to one
@@ -779,6 +784,7 @@ class Sender : public SenderBase {
    * @return protocol version of the Connection.
    */
   folly::Optional<uint16_t> getSocketProtocolVersion(node_index_t idx) const;
+  folly::Optional<uint16_t> getSocketProtocolVersion(ClientID cid) const;
 
   /**
    * @return get ID assigned by client.
@@ -943,6 +949,19 @@ class Sender : public SenderBase {
    */
   Connection* initServerConnection(NodeID nid, SocketType sock_type);
 
+  /**
+   * When --num-connections-per-node is greater than 1, picks which of the
+   * connections to the node of `primary` should carry `msg`, based on a hash
+   * of msg.getLogID(), and starts connecting it if needed. Stripes are
+   * created with the same peer, connection type and flow group as `primary`.
+   *
+   * @return `primary` for messages not about a log, for non-DATA connections
+   *         or if there is only one connection per node; otherwise the
+   *         selected stripe, or nullptr with err set as in getConnection().
+   */
+  Connection* FOLLY_NULLABLE selectServerConnectionStripe(Connection& primary,
+                                                          const Message& msg);
+
   /**
    * This method gets the Connection associated with a given ClientID. The
    * connection must already exist for this method to succeed.
@@ -25,7 +25,9 @@ SequencerBackgroundActivator::SequencerBackgroundActivator()
       unconditional_nodeset_randomization_enabled_(
           Worker::settings().nodeset_size_adjustment_min_factor == 0),
       nodeset_max_randomizations_(
-          Worker::settings().nodeset_max_randomizations) {}
+          Worker::settings().nodeset_max_randomizations),
+      nodeset_changes_limit_(Worker::settings().nodeset_changes_limit),
+      nodeset_changes_limiter_(nodeset_changes_limit_) {}
 
 void SequencerBackgroundActivator::checkWorkerAsserts() {
   Worker* w = Worker::onThisThread();
@@ -152,7 +154,9 @@ SequencerBackgroundActivator::processOneLog(logid_t log_id,
  * from small changes to the cluster.
  */
 SequencerBackgroundActivator::ProcessLogDecision
-SequencerBackgroundActivator::postponeSequencerReactivation(logid_t logid) {
+SequencerBackgroundActivator::postponeSequencerReactivation(
+    logid_t logid,
+    folly::Optional<std::chrono::milliseconds> delay) {
   // process this log picking a random time over a window specified in the
   // settings.
   LogState& state = logs_[logid];
@@ -172,26 +176,28 @@ SequencerBackgroundActivator::postponeSequencerReactivation(logid_t logid) {
     return ProcessLogDecision::POSTPONED;
   }
 
-  // compute random delay
-  auto min = Worker::settings().sequencer_reactivation_delay_secs.lo.count();
-  auto max = Worker::settings().sequencer_reactivation_delay_secs.hi.count();
-  std::chrono::seconds delay_secs(folly::Random::rand32(min, max));
+  if (!delay.has_value()) {
+    // compute random delay
+    auto min = Worker::settings().sequencer_reactivation_delay_secs.lo.count();
+    auto max = Worker::settings().sequencer_reactivation_delay_secs.hi.count();
+    delay = std::chrono::seconds(folly::Random::rand32(min, max));
+  }
   auto cb = [self = this, log_id = logid]() {
     LogState& cur_state = self->logs_[log_id];
     cur_state.reactivation_delay_timer.cancel();
     self->schedule({log_id}, true /* queued_by_alarm_callback */);
     WORKER_STAT_INCR(sequencer_reactivations_delay_completed);
   };
-  RecordTimestamp delayTS = RecordTimestamp::now() + delay_secs;
+  RecordTimestamp delayTS = RecordTimestamp::now() + delay.value();
   RATELIMIT_INFO(std::chrono::seconds(10),
                  10,
-                 "Delaying reactivation of log %ld for %ld secs (until %s)",
+                 "Delaying reactivation of log %ld for %ld ms (until %s)",
                  logid.val(),
-                 delay_secs.count(),
+                 delay->count(),
                  delayTS.toString().c_str());
 
   state.reactivation_delay_timer.assign(cb);
-  state.reactivation_delay_timer.activate(delay_secs);
+  state.reactivation_delay_timer.activate(delay.value());
   WORKER_STAT_INCR(sequencer_reactivations_delayed);
   return ProcessLogDecision::POSTPONED;
 }
@@ -306,6 +312,9 @@ ReactivationDecision SequencerBackgroundActivator::processMetadataChanges(
   }
   bool use_new_storage_set_format =
       Worker::settings().epoch_metadata_use_new_storage_set_format;
+  NodeSetSelector::Options nodeset_options;
+  nodeset_options.incremental =
+      Worker::settings().nodeset_incremental_selection;
 
   // Use the same logic for updating metadata as during sequencer activation.
   UpdateResult result = updateMetaDataIfNeeded(logid,
@@ -318,7 +327,8 @@ ReactivationDecision SequencerBackgroundActivator::processMetadataChanges(
                                                use_new_storage_set_format,
                                                /* provision_if_empty */ false,
                                                /* update_if_exists */ true,
-                                               /* force_update */ false);
+                                               /* force_update */ false,
+                                               &nodeset_options);
   if (result == UpdateResult::FAILED) {
     RATELIMIT_ERROR(
         std::chrono::seconds(10),
@@ -353,7 +363,8 @@ ReactivationDecision SequencerBackgroundActivator::processMetadataChanges(
                                               use_new_storage_set_format,
                                               false,
                                               true,
-                                              false);
+                                              false,
+                                              &nodeset_options);
 
     // The first check is redundant but provides a better error message.
     if (!ld_catch(another_res != UpdateResult::FAILED,
@@ -547,6 +558,20 @@ SequencerBackgroundActivator::reprovisionOrReactivateIfNeeded(
       // We need reactivation to be performed now. Either because we have an
       // important change to the options or metadata or because it's a change
       // that can be delayed but it has already been delayed once.
+      if (optionsDecision == ReactivationDecision::NOOP &&
+          new_metadata->shards != current_metadata->shards) {
+        // The reactivation is only needed to change the nodeset. Respect the
+        // limit on nodeset changes by delaying it until the limit allows it.
+        RateLimiter::Duration wait;
+        if (!nodeset_changes_limiter_.isAllowed(
+                1, &wait, RateLimiter::Duration::zero())) {
+          WORKER_STAT_INCR(sequencer_reactivations_nodeset_changes_throttled);
+          return postponeSequencerReactivation(
+              logid,
+              std::max(std::chrono::milliseconds(1),
+                       std::chrono::ceil<std::chrono::milliseconds>(wait)));
+        }
+      }
       ProcessLogDecision dec = ProcessLogDecision::SUCCESS;
       WORKER_STAT_INCR(sequencer_reactivations_for_metadata_update);
       // Switch off this flag so that the next enqueue doesn't go through
@@ -799,6 +824,9 @@ void SequencerBackgroundActivator::onSettingsUpdated() {
           Worker::settings().nodeset_size_adjustment_min_factor == 0) |
       upd(nodeset_max_randomizations_,
           Worker::settings().nodeset_max_randomizations);
+  if (upd(nodeset_changes_limit_, Worker::settings().nodeset_changes_limit)) {
+    nodeset_changes_limiter_.update(nodeset_changes_limit_);
+  }
 
   if (!adjustment_period_changed && !randomization_settings_changed) {
     return;
@@ -16,6 +16,7 @@
 #include "logdevice/common/EpochMetaData.h"
 #include "logdevice/common/NodeID.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/RateLimiter.h"
 #include "logdevice/common/ResourceBudget.h"
 #include "logdevice/common/Sequencer.h"
 #include "logdevice/common/Timer.h"
@@ -178,8 +179,11 @@ class SequencerBackgroundActivator {
   void randomizeNodeset(logid_t log_id, LogState& state);
 
   // Internal function that queues up a sequencer reactivation
-  // with a delay.
-  ProcessLogDecision postponeSequencerReactivation(logid_t logid);
+  // with a delay. If `delay` is not given, picks a random one from
+  // sequencer_reactivation_delay_secs.
+  ProcessLogDecision postponeSequencerReactivation(
+      logid_t logid,
+      folly::Optional<std::chrono::milliseconds> delay = folly::none);
 
   // queues up a job to update Epoch metadata
   ProcessLogDecision
@@ -268,5 +272,10 @@ class SequencerBackgroundActivator {
   std::chrono::milliseconds nodeset_adjustment_period_;
   bool unconditional_nodeset_randomization_enabled_;
   size_t nodeset_max_randomizations_;
+  rate_limit_t nodeset_changes_limit_;
+
+  // Limits the rate of reactivations that change nodesets, see
+  // --nodeset-changes-limit.
+  RateLimiter nodeset_changes_limiter_;
 };
 }} // namespace facebook::logdevice
@@ -23,6 +23,7 @@
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
+#include "logdevice/common/buffered_writer/ZstdDictionary.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/include/BufferedWriter.h"
@@ -34,36 +35,7 @@ using namespace std::literals::chrono_literals;
 using Compression = BufferedWriter::Options::Compression;
 using LogAttributes = logsconfig::LogAttributes;
 
-static BufferedWriter::LogOptions get_log_options(logid_t log_id) {
-  BufferedWriter::LogOptions opts;
-
-  // The following line is important for proper memory usage accounting.
-  // If we don't destroy payloads, we won't get notified of freed payloads,
-  // and will run into the total limit on the size of appenders (i.e.
-  // checkShard() will fail and no appends will go through.
-  opts.destroy_payloads = true;
-
-  auto config = Worker::getConfig();
-  const auto& settings = Worker::settings();
-
-  const auto group = config->getLogGroupByIDShared(log_id);
-
-  if (!group) {
-    opts.time_trigger = settings.sequencer_batching_time_trigger;
-    opts.size_trigger = settings.sequencer_batching_size_trigger;
-    opts.compression = settings.sequencer_batching_compression;
-    return opts;
-  }
-
-  opts.time_trigger = group->attrs().sequencerBatchingTimeTrigger().getValue(
-      settings.sequencer_batching_time_trigger);
-  opts.size_trigger = group->attrs().sequencerBatchingSizeTrigger().getValue(
-      settings.sequencer_batching_size_trigger);
-  opts.compression = group->attrs().sequencerBatchingCompression().getValue(
-      settings.sequencer_batching_compression);
-
-  return opts;
-}
+constexpr std::chrono::milliseconds SequencerBatching::kAdaptiveRateWindow;
 
 SequencerBatching::SequencerBatching(Processor* processor)
     : sender_(std::make_unique<SenderProxy>()),
@@ -71,7 +43,9 @@ SequencerBatching::SequencerBatching(Processor* processor)
       worker_state_machines_(processor_->settings()->num_workers),
       buffered_writer_(new ProcessorProxy(processor_),
                        nullptr, // BufferedWriter::AppendCallback
-                       &get_log_options,
+                       [this](logid_t log_id) {
+                         return getLogOptions(log_id);
+                       },
                        -1,   // infinite memory limit
                        this, // BufferedWriterAppendSink
                        processor_->stats_) {
@@ -96,6 +70,121 @@ void SequencerBatching::shutDown() {
   buffered_writer_.shutDown();
 }
 
+BufferedWriter::LogOptions SequencerBatching::getLogOptions(logid_t log_id) {
+  BufferedWriter::LogOptions opts;
+
+  // The following line is important for proper memory usage accounting.
+  // If we don't destroy payloads, we won't get notified of freed payloads,
+  // and will run into the total limit on the size of appenders (i.e.
+  // checkShard() will fail and no appends will go through.
+  opts.destroy_payloads = true;
+
+  auto config = Worker::getConfig();
+  const auto& settings = Worker::settings();
+
+  const auto group = config->getLogGroupByIDShared(log_id);
+
+  if (!group) {
+    opts.time_trigger = settings.sequencer_batching_time_trigger;
+    opts.size_trigger = settings.sequencer_batching_size_trigger;
+    opts.compression = settings.sequencer_batching_compression;
+  } else {
+    opts.time_trigger = group->attrs().sequencerBatchingTimeTrigger().getValue(
+        settings.sequencer_batching_time_trigger);
+    opts.size_trigger = group->attrs().sequencerBatchingSizeTrigger().getValue(
+        settings.sequencer_batching_size_trigger);
+    opts.compression = group->attrs().sequencerBatchingCompression().getValue(
+        settings.sequencer_batching_compression);
+    // A zstd dictionary trained on the log group's records can be set as a
+    // hex string in its "zstd_dictionary" extra attribute.
+    const auto& extras = group->attrs().extras();
+    if (opts.compression == Compression::ZSTD && extras.hasValue()) {
+      auto it = extras.value().find(kZstdDictionaryAttribute);
+      if (it != extras.value().end()) {
+        auto dict = ZstdDictionaryRegistry::get().getOrAddHex(it->second);
+        if (dict) {
+          opts.zstd_dictionary = dict->getData();
+        }
+      }
+    }
+  }
+
+  if (settings.sequencer_batching_adaptive) {
+    AdaptiveLogState& state = getAdaptiveLogState(log_id);
+    const auto rate = state.appends.getRate(kAdaptiveRateWindow);
+    const int64_t target = settings.sequencer_batching_adaptive_target_records;
+    if (target > 0 && rate.first > 0 && rate.second.count() > 0) {
+      // Flush once `target` appends are expected to have arrived, but never
+      // wait longer than the configured time trigger.
+      std::chrono::milliseconds wait(
+          (target * rate.second.count() + rate.first - 1) / rate.first);
+      if (opts.time_trigger.count() < 0 || wait < opts.time_trigger) {
+        opts.time_trigger = wait;
+      }
+    }
+    state.time_trigger_ms.store(opts.time_trigger.count());
+  }
+
+  return opts;
+}
+
+SequencerBatching::AdaptiveLogState&
+SequencerBatching::getAdaptiveLogState(logid_t log_id) {
+  auto it = adaptive_log_states_.find(log_id);
+  if (it != adaptive_log_states_.end()) {
+    return *it->second;
+  }
+  // If another thread inserted the log in the meantime, insert() returns its
+  // state.
+  auto res =
+      adaptive_log_states_.insert(log_id, std::make_unique<AdaptiveLogState>());
+  return *res.first->second;
+}
+
+bool SequencerBatching::adaptiveShouldBatch(
+    logid_t log_id,
+    size_t payload_size,
+    std::chrono::milliseconds time_trigger,
+    const Settings& settings) {
+  AdaptiveLogState& state = getAdaptiveLogState(log_id);
+  const auto now = SteadyTimestamp::now();
+  state.appends.addValue(1, kAdaptiveRateWindow, now);
+  state.bytes.addValue(payload_size, kAdaptiveRateWindow, now);
+
+  bool batching = true;
+  const auto rate = state.appends.getRate(kAdaptiveRateWindow, now);
+  // Until the rate can be estimated and for logs without a time trigger,
+  // keep batching as configured.
+  if (rate.second.count() > 0 && time_trigger.count() >= 0) {
+    const double expected_appends =
+        double(rate.first) * time_trigger.count() / rate.second.count();
+    batching =
+        expected_appends >= settings.sequencer_batching_adaptive_min_records;
+  }
+  state.batching.store(batching);
+  return batching;
+}
+
+std::vector<SequencerBatching::AdaptiveLogInfo>
+SequencerBatching::getAdaptiveLogInfo() const {
+  std::vector<AdaptiveLogInfo> res;
+  const auto now = SteadyTimestamp::now();
+  for (const auto& kv : adaptive_log_states_) {
+    const AdaptiveLogState& state = *kv.second;
+    auto per_sec = [](std::pair<int64_t, std::chrono::milliseconds> rate) {
+      return rate.second.count() > 0 ? rate.first * 1000.0 / rate.second.count()
+                                     : 0.0;
+    };
+    res.push_back(AdaptiveLogInfo{
+        kv.first,
+        per_sec(state.appends.getRate(kAdaptiveRateWindow, now)),
+        per_sec(state.bytes.getRate(kAdaptiveRateWindow, now)),
+        state.batching.load(),
+        std::chrono::milliseconds(state.time_trigger_ms.load())});
+  }
+  return res;
+}
+
 namespace {
 
 static int prepare_batch(logid_t log_id,
@@ -181,6 +270,24 @@ bool SequencerBatching::buffer(logid_t log_id,
     return false;
   }
 
+  if (settings.sequencer_batching_adaptive) {
+    const auto time_trigger = group
+        ? group->attrs().sequencerBatchingTimeTrigger().getValue(
+              settings.sequencer_batching_time_trigger)
+        : settings.sequencer_batching_time_trigger;
+    const size_t payload_size = appender_in->getPayload()->size();
+    if (!adaptiveShouldBatch(log_id, payload_size, time_trigger, settings)) {
+      StatsHolder* stats = Worker::stats();
+      STAT_ADD(
+          stats, append_bytes_seq_batching_adaptive_passthru, payload_size);
+      if (auto log_path = w->getConfiguration()->getLogGroupPath(log_id)) {
+        LOG_GROUP_TIME_SERIES_ADD(
+            stats, append_unbatched_bytes, log_path.value(), payload_size);
+      }
+      return false;
+    }
+  }
+
   if (shouldPassthru(*appender_in, group.get(), settings)) {
     StatsHolder* stats = Worker::stats();
     const size_t payload_size = appender_in->getPayload()->size();
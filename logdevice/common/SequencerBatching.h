@@ -8,12 +8,16 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <vector>
 
 #include <folly/IntrusiveList.h>
 #include <folly/Preprocessor.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/InternalAppendRequest.h"
+#include "logdevice/common/RateEstimator.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
@@ -176,6 +180,23 @@ class SequencerBatching : public BufferedWriterImpl::AppendCallbackInternal,
    */
   Status appendProbe();
 
+  // Adaptive batching decision for one log, see
+  // Settings::sequencer_batching_adaptive.
+  struct AdaptiveLogInfo {
+    logid_t log_id;
+    double appends_per_sec;
+    double bytes_per_sec;
+    bool batching;
+    // Time trigger of the log's last batch, -1 if none was started.
+    std::chrono::milliseconds time_trigger;
+  };
+
+  /**
+   * Returns the adaptive batching decisions for all logs that had appends
+   * while adaptive batching was enabled.  Can be called on any thread.
+   */
+  std::vector<AdaptiveLogInfo> getAdaptiveLogInfo() const;
+
  protected:
   virtual folly::Optional<APPENDED_Header>
   runBufferedAppend(logid_t logid,
@@ -217,6 +238,20 @@ class SequencerBatching : public BufferedWriterImpl::AppendCallbackInternal,
   // State machines grouped by owner worker.
   std::vector<StateMachineList> worker_state_machines_;
 
+  // Append rates and decisions of adaptive batching for one log.
+  struct AdaptiveLogState {
+    RateEstimator appends;
+    RateEstimator bytes;
+    std::atomic<bool> batching{true};
+    std::atomic<int64_t> time_trigger_ms{-1};
+  };
+
+  // Window over which adaptive batching estimates the append rate of logs.
+  static constexpr std::chrono::milliseconds kAdaptiveRateWindow{10000};
+
+  folly::ConcurrentHashMap<logid_t, std::unique_ptr<AdaptiveLogState>>
+      adaptive_log_states_;
+
   // Needs to be destroyed first to disarm callbacks before state machines are
   // destroyed
   BufferedWriterImpl buffered_writer_;
@@ -225,6 +260,18 @@ class SequencerBatching : public BufferedWriterImpl::AppendCallbackInternal,
   // sequencers.
   std::atomic<size_t> totalBufferedAppendSize_{0};
 
+  AdaptiveLogState& getAdaptiveLogState(logid_t log_id);
+
+  // Records an incoming append of `payload_size` bytes and decides whether
+  // appends to the log should be batched given its `time_trigger`.
+  bool adaptiveShouldBatch(logid_t log_id,
+                           size_t payload_size,
+                           std::chrono::milliseconds time_trigger,
+                           const Settings& settings);
+
+  // Called by BufferedWriter when it starts a batch.
+  BufferedWriter::LogOptions getLogOptions(logid_t log_id);
+
   bool shouldPassthru(const Appender& appender,
                       const logsconfig::LogGroupNode* group,
                       const Settings& settings) const;
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/SequencerLocationCache.h"
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+NodeID SequencerLocationCache::get(logid_t log_id) const {
+  auto it = map_.find(log_id);
+  return it == map_.cend() ? NodeID() : it->second;
+}
+
+void SequencerLocationCache::update(logid_t log_id, NodeID node) {
+  ld_check(node.isNodeID());
+  map_.insert_or_assign(log_id, node);
+}
+
+void SequencerLocationCache::invalidate(logid_t log_id, NodeID node) {
+  map_.erase_if_equal(log_id, node);
+}
+
+void SequencerLocationCache::onNodeStateChanged(
+    node_index_t node,
+    ClusterState::NodeState state) {
+  if (state == ClusterState::NodeState::FULLY_STARTED) {
+    // The node may be the preferred sequencer of logs currently cached as
+    // running elsewhere. Let hashing pick them again.
+    clear();
+    return;
+  }
+  for (auto it = map_.cbegin(); it != map_.cend();) {
+    if (it->second.index() == node) {
+      it = map_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void SequencerLocationCache::clear() {
+  map_.clear();
+}
+
+}} // namespace facebook::logdevice
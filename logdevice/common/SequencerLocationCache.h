@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <folly/concurrency/ConcurrentHashMap.h>
+
+#include "logdevice/common/ClusterState.h"
+#include "logdevice/common/NodeID.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file SequencerLocationCache remembers, for each data log, the node whose
+ *       sequencer last accepted a message for it. It is shared by all Workers
+ *       of a Processor and consulted by SequencerRouter before hashing, so
+ *       that after a failover the client goes straight to the node running
+ *       the sequencer instead of being redirected on every request.
+ *
+ *       Entries are learned from successful replies and forgotten when the
+ *       node redirects us or becomes unreachable. ClusterState also calls
+ *       onNodeStateChanged() as soon as it learns about a node changing
+ *       state: entries pointing to a node that is no longer fully started
+ *       are dropped, and everything is dropped when a node comes back, since
+ *       hashing may route some logs back to it.
+ *
+ *       All methods are thread-safe.
+ */
+
+class SequencerLocationCache {
+ public:
+  // @return  the cached sequencer node for log_id, or an invalid NodeID
+  NodeID get(logid_t log_id) const;
+
+  // Records that the sequencer of log_id runs on `node'.
+  void update(logid_t log_id, NodeID node);
+
+  // Forgets the entry of log_id, but only if it still points to `node'.
+  void invalidate(logid_t log_id, NodeID node);
+
+  void onNodeStateChanged(node_index_t node, ClusterState::NodeState state);
+
+  void clear();
+
+  size_t size() const {
+    return map_.size();
+  }
+
+ private:
+  folly::ConcurrentHashMap<logid_t, NodeID, logid_t::Hash> map_;
+};
+
+}} // namespace facebook::logdevice
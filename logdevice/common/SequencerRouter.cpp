@@ -9,6 +9,7 @@
 
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/SequencerLocationCache.h"
 #include "logdevice/common/SequencerLocator.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -32,6 +33,17 @@ void SequencerRouter::start() {
     sendTo(force_sequencer_choice, REDIRECT_CYCLE);
     return;
   }
+
+  const NodeID cached = getCachedSequencer();
+  if (cached.isNodeID() && cached != last_unavailable_.first) {
+    ld_debug("Sending to %s for log:%lu from the sequencer location cache",
+             cached.toString().c_str(),
+             log_id_.val_);
+    WORKER_STAT_INCR(client.sequencer_location_cache_hits);
+    sendTo(cached, flags_t(0));
+    return;
+  }
+
   // If this SequencerRouter object gets destroyed before the callback is
   // called, trying to access its variables will cause a crash. Using
   // WeakRefHolder to prevent that.
@@ -161,6 +173,8 @@ void SequencerRouter::onRedirected(NodeID from, NodeID to, Status status) {
              handler_);
   }
 
+  forgetCachedSequencer(from);
+
   if (!last_reply_.node.isNodeID()) {
     // Add the first visited node to the `redirected_' set. This reduces the
     // number of messages sent in case of a redirect cycle.
@@ -309,6 +323,13 @@ void SequencerRouter::onRedirected(NodeID from, NodeID to, Status status) {
   sendTo(to, flags_t(0));
 }
 
+void SequencerRouter::onSuccess(NodeID node) {
+  SequencerLocationCache* cache = locationCache();
+  if (cache && node.isNodeID()) {
+    cache->update(MetaDataLog::dataLogID(log_id_), node);
+  }
+}
+
 void SequencerRouter::onDeadNode(NodeID node, Status status) {
   RATELIMIT_INFO(std::chrono::seconds(1),
                  10,
@@ -320,6 +341,8 @@ void SequencerRouter::onDeadNode(NodeID node, Status status) {
                  handler_->getRequestTypeName().c_str(),
                  handler_);
 
+  forgetCachedSequencer(node);
+
   auto node_state = ClusterState::NodeState::FAILING_OVER;
   switch (status) {
     case E::DISABLED:
@@ -506,6 +529,44 @@ void SequencerRouter::sendTo(NodeID dest, flags_t flags) {
   handler_->onSequencerKnown(dest, flags);
 }
 
+SequencerLocationCache* SequencerRouter::locationCache() const {
+  const Settings& settings = getSettings();
+  if (settings.server || !settings.sequencer_location_cache ||
+      !getSequencerLocator().isAllowedToCache()) {
+    return nullptr;
+  }
+  return getSequencerLocationCache();
+}
+
+NodeID SequencerRouter::getCachedSequencer() const {
+  SequencerLocationCache* cache = locationCache();
+  if (!cache) {
+    return NodeID();
+  }
+  const logid_t data_log_id = MetaDataLog::dataLogID(log_id_);
+  const NodeID node = cache->get(data_log_id);
+  if (!node.isNodeID()) {
+    return NodeID();
+  }
+  // ClusterState normally evicts entries as soon as it learns about a node
+  // going down, but the node may also have been removed from the sequencer
+  // membership since.
+  auto cs = getClusterState();
+  if ((cs && !cs->isNodeFullyStarted(node.index())) ||
+      !getNodesConfiguration()->isSequencerNode(node.index())) {
+    cache->invalidate(data_log_id, node);
+    return NodeID();
+  }
+  return node;
+}
+
+void SequencerRouter::forgetCachedSequencer(NodeID node) {
+  SequencerLocationCache* cache = locationCache();
+  if (cache && node.isNodeID()) {
+    cache->invalidate(MetaDataLog::dataLogID(log_id_), node);
+  }
+}
+
 bool SequencerRouter::blacklist(NodeID node) {
   if (!sequencers_) {
     // make a copy of the sequencer list from the cluster config
@@ -558,6 +619,10 @@ ClusterState* SequencerRouter::getClusterState() const {
   return Worker::getClusterState();
 }
 
+SequencerLocationCache* SequencerRouter::getSequencerLocationCache() const {
+  return Worker::onThisThread()->processor_->sequencer_location_cache_.get();
+}
+
 void SequencerRouter::startClusterStateRefreshTimer() {
   if (getSettings().sequencer_router_internal_timeout <
           std::chrono::milliseconds::max() &&
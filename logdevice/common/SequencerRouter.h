@@ -39,6 +39,7 @@ namespace facebook { namespace logdevice {
  *        thread.
  */
 
+class SequencerLocationCache;
 class SequencerLocator;
 struct Settings;
 
@@ -113,6 +114,11 @@ class SequencerRouter {
   // Called when a redirect reply is received from a node.
   void onRedirected(NodeID from, NodeID to, Status status);
 
+  // Called when `node' accepted the message. Remembers it in the
+  // SequencerLocationCache so that the next request for the log is sent
+  // there directly.
+  void onSuccess(NodeID node);
+
   // Called when we're not able to communicate to the given node (e.g. failed
   // to connect, node is not in the config, etc.)
   void onNodeUnavailable(NodeID node, Status status);
@@ -139,6 +145,10 @@ class SequencerRouter {
   // Returns a pointer to the ClusterState object to check cluster/nodes health
   virtual ClusterState* getClusterState() const;
 
+  // Returns the Processor's SequencerLocationCache, or nullptr if there is
+  // none.
+  virtual SequencerLocationCache* getSequencerLocationCache() const;
+
   // Called when cluster_state_refresh_timer_ expires, and initiates an
   // asynchronous cluster state refresh
   virtual void onTimeout();
@@ -197,6 +207,17 @@ class SequencerRouter {
   // Calls handler_->sendTo() and updates flags_.
   void sendTo(NodeID dest, flags_t flags);
 
+  // Returns the SequencerLocationCache if this router is allowed to use it
+  // (clients only, see Settings::sequencer_location_cache), nullptr otherwise.
+  SequencerLocationCache* locationCache() const;
+
+  // Returns the node cached for the log if it is still a fully started
+  // sequencer node, an invalid NodeID otherwise.
+  NodeID getCachedSequencer() const;
+
+  // Drops the cache entry of the log if it points to `node'.
+  void forgetCachedSequencer(NodeID node);
+
   // Mark node as dead to prevent it from being selected by the
   // SequencerLocator. Returns true on success, false if the node was already
   // blacklisted.
@@ -125,6 +125,36 @@ operator!=(const ShardAuthoritativeStatusMap& other) const {
   return !(*this == other);
 }
 
+std::vector<ShardID> ShardAuthoritativeStatusMap::getChangedShards(
+    const ShardAuthoritativeStatusMap& other) const {
+  std::vector<ShardID> changed;
+  // Shards in this map that are missing or different in `other`.
+  for (const auto& node : shards_) {
+    auto other_node = other.shards_.find(node.first);
+    for (const auto& shard : node.second) {
+      if (other_node == other.shards_.end()) {
+        changed.emplace_back(node.first, shard.first);
+        continue;
+      }
+      auto other_shard = other_node->second.find(shard.first);
+      if (other_shard == other_node->second.end() ||
+          !(other_shard->second == shard.second)) {
+        changed.emplace_back(node.first, shard.first);
+      }
+    }
+  }
+  // Shards in `other` that are missing in this map.
+  for (const auto& other_node : other.shards_) {
+    auto node = shards_.find(other_node.first);
+    for (const auto& other_shard : other_node.second) {
+      if (node == shards_.end() || !node->second.count(other_shard.first)) {
+        changed.emplace_back(other_node.first, other_shard.first);
+      }
+    }
+  }
+  return changed;
+}
+
 Request::Execution UpdateShardAuthoritativeMapRequest::execute() {
   ShardAuthoritativeStatusMap& map = Worker::onThisThread()
                                          ->shardStatusManager()
@@ -133,9 +163,11 @@ Request::Execution UpdateShardAuthoritativeMapRequest::execute() {
     // The worker already has a more up to date version.
     return Execution::COMPLETE;
   }
+  std::vector<ShardID> changed_shards = map_.getChangedShards(map);
   map = std::move(map_);
 
-  Worker::onThisThread()->shardStatusManager().notifySubscribers();
+  Worker::onThisThread()->shardStatusManager().notifySubscribers(
+      std::move(changed_shards));
 
   return Execution::COMPLETE;
 }
@@ -187,8 +219,10 @@ void ShardAuthoritativeStatusSubscriber::
   worker->shardStatusManager().subscribe(*this);
 }
 
-void ShardAuthoritativeStatusManager::notifySubscribers() {
+void ShardAuthoritativeStatusManager::notifySubscribers(
+    std::vector<ShardID> changed_shards) {
   Worker* w = Worker::onThisThread();
+  changed_shards_ = std::move(changed_shards);
   for (auto it = w->shardStatusManager().subscribers_.begin();
        it != w->shardStatusManager().subscribers_.end();) {
     // onShardStatusUpdate() may remove subscriber from list
@@ -196,6 +230,7 @@ void ShardAuthoritativeStatusManager::notifySubscribers() {
     it++;
     subscriber->onShardStatusChanged();
   }
+  changed_shards_.clear();
 }
 
 }} // namespace facebook::logdevice
@@ -8,8 +8,10 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include <folly/IntrusiveList.h>
+#include <folly/Optional.h>
 
 #include "logdevice/common/AuthoritativeStatus.h"
 #include "logdevice/common/Request.h"
@@ -104,6 +106,10 @@ class ShardAuthoritativeStatusMap {
     return version_;
   }
 
+  void setVersion(lsn_t version) {
+    version_ = version;
+  }
+
   AuthoritativeStatus getShardStatus(node_index_t node, uint32_t shard) const;
 
   AuthoritativeStatus getShardStatus(const ShardID& shard_id) const;
@@ -146,6 +152,13 @@ class ShardAuthoritativeStatusMap {
   bool operator==(const ShardAuthoritativeStatusMap& other) const;
   bool operator!=(const ShardAuthoritativeStatusMap& other) const;
 
+  /**
+   * @return shards whose state (authoritative status or time-ranged rebuild
+   * flag) differs between this and `other`.
+   */
+  std::vector<ShardID>
+  getChangedShards(const ShardAuthoritativeStatusMap& other) const;
+
   // Entry to serialize in a SHARD_STATUS_UPDATE_Message.
   struct SerializedEntry {
     node_index_t node;
@@ -211,7 +224,22 @@ class ShardAuthoritativeStatusManager {
     subscribers_.push_back(subscriber);
   }
 
-  void notifySubscribers();
+  /**
+   * @param changed_shards  shards whose status changed since the previous
+   *                        notification, available to subscribers through
+   *                        getChangedShards()
+   */
+  void notifySubscribers(std::vector<ShardID> changed_shards);
+
+  /**
+   * While notifySubscribers() runs, the shards whose status changed.
+   * Subscribers can use it to only look at these shards. folly::none outside
+   * of notifySubscribers(), e.g. when a subscriber calls its own
+   * onShardStatusChanged() directly, in which case any shard may have changed.
+   */
+  const folly::Optional<std::vector<ShardID>>& getChangedShards() const {
+    return changed_shards_;
+  }
 
  private:
   folly::IntrusiveList<ShardAuthoritativeStatusSubscriber,
@@ -219,6 +247,8 @@ class ShardAuthoritativeStatusManager {
       subscribers_;
 
   ShardAuthoritativeStatusMap shard_status_map_;
+
+  folly::Optional<std::vector<ShardID>> changed_shards_;
 };
 
 }} // namespace facebook::logdevice
@@ -13,6 +13,8 @@
 #include <memory>
 #include <vector>
 
+#include <folly/Preprocessor.h>
+
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/SlidingWindow.h"
 #include "logdevice/common/types_internal.h"
@@ -87,11 +89,11 @@ class SlidingWindowSingleEpoch {
                                     int capacity,
                                     esn_t esn_max = ESN_MAX)
       : epoch_(epoch),
-        size_(0),
         esn_max_(std::min(esn_max.val_, ESN_MAX.val_ - 1)),
         // This is a bit tricky.  We need all slots in the window to map to
         // valid ESNs (at most `esn_max_')
         capacity_(std::min<uint64_t>(capacity, esn_max_.val_)),
+        size_(0),
         right_(compose_lsn(epoch_, ESN_MIN)) {
     if (capacity_ < SlidingWindowSingleEpoch::MIN_CAPACITY ||
         esn_max < ESN_MIN) {
@@ -346,10 +348,6 @@ class SlidingWindowSingleEpoch {
         state_[idx].store(0);
       }
 
-      // give up our token
-      size_t prev_size = size_.fetch_sub(1);
-      ld_check(prev_size > 0);
-
       // There will be no slot with TAIL set until set_tail() is done.
 
       unsigned next_idx = next_index(idx);
@@ -373,6 +371,16 @@ class SlidingWindowSingleEpoch {
       entry = state_[next_idx].load();
     }
 
+    if (n_reaped > 0) {
+      // Give up the tokens of all reaped entries at once. size_ is hammered
+      // by grow() and retire() on every worker appending to the log, so one
+      // atomic op per call rather than per entry matters with many entries
+      // reaped at a time. Holding the tokens until here only makes grow()
+      // conservative: the slots are already free.
+      size_t prev_size = size_.fetch_sub(n_reaped);
+      ld_check(prev_size >= n_reaped);
+    }
+
     return n_reaped;
   }
 
@@ -474,26 +482,12 @@ class SlidingWindowSingleEpoch {
   // epoch of the sliding window
   const epoch_t epoch_;
 
-  // This is a token dispenser that approximates the current window
-  // size. It is guaranteed to be 0 when the window is empty and no
-  // calls to grow() are in progress. It is incremented atomically
-  // as tokens are dispensed. A grow() fails unless it can get a
-  // token in the range [0..capacity_). Tokens are put back when
-  // retire() shrinks the window and when grow() gets a token that's
-  // too large. The value may temporarily exceed capacity_.
-  std::atomic<size_t> size_;
-
   // Max ESN to issue, inclusive (typically ESN_MAX - 1)
   const esn_t esn_max_;
 
   // Maximum window size
   const size_t capacity_;
 
-  // right edge of the window (max LSN in window plus one), or LSN_DISABLED if
-  // the window is disabled. Next successful call to grow() will return this
-  // LSN.
-  std::atomic<lsn_t> right_;
-
   // tail lsn of the previous epoch, used for validating conditional insert
   // in the case that it's the first insert of the window.
   std::atomic<lsn_t> prev_epoch_tail_{LSN_TAIL_UNKNOWN};
@@ -506,6 +500,25 @@ class SlidingWindowSingleEpoch {
   // fixed at construction and equals the capacity.
   std::unique_ptr<std::atomic<uintptr_t>[]> state_;
 
+  // size_ and right_ are modified by Appenders on every worker that appends
+  // to the log, so each gets its own cache line to avoid interference with
+  // each other and with the read-mostly members above.
+
+  // This is a token dispenser that approximates the current window
+  // size. It is guaranteed to be 0 when the window is empty and no
+  // calls to grow() or retire() are in progress. It is incremented atomically
+  // as tokens are dispensed. A grow() fails unless it can get a
+  // token in the range [0..capacity_). Tokens are put back when
+  // retire() shrinks the window and when grow() gets a token that's
+  // too large. The value may temporarily exceed capacity_.
+  alignas(128) std::atomic<size_t> size_;
+
+  // right edge of the window (max LSN in window plus one), or LSN_DISABLED if
+  // the window is disabled. Next successful call to grow() will return this
+  // LSN.
+  alignas(128) std::atomic<lsn_t> right_;
+  char FB_ANONYMOUS_VARIABLE(padding)[128 - sizeof(std::atomic<lsn_t>)];
+
   // a special value that may be stored in `prev_epoch_tail_`. used to
   // indicate that the sliding window is disabled and cannot take new appends
   static const lsn_t LSN_DISABLED = LSN_INVALID;
@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/StickyCopySetManager.h"
 
+#include <algorithm>
 #include <shared_mutex>
 
 #include <folly/Memory.h>
@@ -154,7 +155,7 @@ bool StickyCopySetManager::shouldStartNewBlock(const State& state,
   // In a single-copyset scenario we are changing the copyset with every
   // block.
   // TODO: consider not doing that for a multiple-copyset scenario?
-  if (current_block_bytes_written_ >= block_size_threshold_) {
+  if (current_block_bytes_written_ >= current_block_size_threshold_) {
     return true;
   }
 
@@ -187,6 +188,17 @@ bool StickyCopySetManager::startNewBlock(State& csm_state,
 
   shuffleCopySet(copyset, size, chain_out ? *chain_out : false);
 
+  // Grow the block if the previous one ended because it filled up, reset the
+  // size threshold otherwise.
+  if (current_block_starting_lsn_ != LSN_INVALID && extras == extras_ &&
+      csm_state.last_tried_block_seq_no != block_seq_no_ &&
+      current_block_bytes_written_ >= current_block_size_threshold_) {
+    current_block_size_threshold_ =
+        std::min(current_block_size_threshold_ * 2, max_block_size_threshold_);
+  } else {
+    current_block_size_threshold_ = block_size_threshold_;
+  }
+
   copyset_.clear();
 
   for (size_t i = 0; i < size; ++i) {
@@ -234,9 +246,13 @@ StickyCopySetManager::StickyCopySetManager(
     std::shared_ptr<NodeSetState> nodeset_state,
     size_t sticky_copysets_block_size,
     std::chrono::milliseconds sticky_copysets_block_max_time,
-    const CopySetSelectorDependencies* deps)
+    const CopySetSelectorDependencies* deps,
+    size_t sticky_copysets_block_max_size)
     : CopySetManager(std::move(selector), nodeset_state),
       block_size_threshold_(sticky_copysets_block_size),
+      max_block_size_threshold_(
+          std::max(sticky_copysets_block_size, sticky_copysets_block_max_size)),
+      current_block_size_threshold_(sticky_copysets_block_size),
       block_time_threshold_(sticky_copysets_block_max_time),
       deps_(deps) {}
 
@@ -24,6 +24,15 @@ namespace facebook { namespace logdevice {
  * records - a number of records being stored consecutively. It will start a
  * new block by generating a new copyset whenever a threshold for the total
  * size of processed appends is hit, or the block's maximum lifespan expires.
+ *
+ * If a maximum block size greater than the block size is given, the size
+ * threshold adapts to the log's write pattern: every block that ends because
+ * it filled up makes the next one twice as large, up to the maximum, so logs
+ * with sustained throughput get long contiguous runs of records on the same
+ * nodes, which single-copy-delivery readers can read with fewer seeks. A
+ * block that ends for any other reason (expiry, unavailable nodes, failed
+ * stores) resets the threshold to the block size.
+ *
  * Currently this is an implementation of a single-copyset selector.  When we
  * implement distributed appenders, we will want to maintain several copysets
  * and assign them based on which location scope the appender is in.
@@ -55,7 +64,8 @@ class StickyCopySetManager : public CopySetManager {
                        size_t sticky_copysets_block_size,
                        std::chrono::milliseconds sticky_copysets_block_max_time,
                        const CopySetSelectorDependencies* deps =
-                           CopySetSelectorDependencies::instance());
+                           CopySetSelectorDependencies::instance(),
+                       size_t sticky_copysets_block_max_size = 0);
 
   // see docblock in CopySetManager::getCopySet()
   CopySetSelector::Result
@@ -114,10 +124,16 @@ class StickyCopySetManager : public CopySetManager {
                     const CopySetManager::AppendContext& append_ctx);
   folly::SharedMutex mutex_;
 
-  // When the number of bytes appended in a block exceeds this value, we start
-  // a new one.
+  // Initial value of current_block_size_threshold_.
   const size_t block_size_threshold_;
 
+  // Upper bound for current_block_size_threshold_.
+  const size_t max_block_size_threshold_;
+
+  // When the number of bytes appended in the current block exceeds this
+  // value, we start a new one.
+  size_t current_block_size_threshold_;
+
   // When the age of a block exceeds this value, we start a new one.
   const std::chrono::milliseconds block_time_threshold_;
 
@@ -27,7 +27,7 @@ std::unique_ptr<APPEND_Message> StreamAppendRequest::createAppendMessage() {
                               getTimeout().count(), UINT_MAX)),
                           append_flags};
 
-  return std::make_unique<APPEND_Message>(
+  auto msg = std::make_unique<APPEND_Message>(
       header,
       getPreviousLsn(),
       // The key and payload may point into user-owned memory or be backed by a
@@ -36,6 +36,8 @@ std::unique_ptr<APPEND_Message> StreamAppendRequest::createAppendMessage() {
       getAppendAttributes(),
       payload_,
       stream_rqid_);
+  msg->e2e_trace_id_ = getE2ETraceId();
+  return msg;
 }
 
 }} // namespace facebook::logdevice
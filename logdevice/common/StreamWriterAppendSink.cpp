@@ -106,6 +106,10 @@ size_t StreamWriterAppendSink::getMaxPayloadSize() noexcept {
   return processor_->updateableSettings()->max_payload_size;
 }
 
+size_t StreamWriterAppendSink::getBacklogThreshold() noexcept {
+  return processor_->updateableSettings()->stream_writer_backlog_threshold;
+}
+
 std::chrono::milliseconds
 StreamWriterAppendSink::getAppendRetryTimeout() noexcept {
   return processor_->updateableSettings()->append_timeout.value_or(
@@ -216,6 +220,20 @@ StreamWriterAppendSink::createAppendRequest(
           next_seq_num(stream.max_prefix_acked_seq_num_));
 }
 
+bool StreamWriterAppendSink::isBacklogged(logid_t logid) {
+  const size_t threshold = getBacklogThreshold();
+  if (threshold == 0) {
+    return false;
+  }
+  // Called on the stream's target worker, like the rest of the stream state
+  // accesses.
+  auto it = streams_.find(logid);
+  if (it == streams_.end()) {
+    return false;
+  }
+  return it->second->pending_stream_requests_.size() >= threshold;
+}
+
 void StreamWriterAppendSink::onCallback(Stream& stream,
                                         write_stream_request_id_t stream_reqid,
                                         Status status,
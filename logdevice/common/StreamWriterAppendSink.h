@@ -266,6 +266,15 @@ class StreamWriterAppendSink : public BufferedWriterAppendSink {
                  worker_id_t target_worker,
                  int checksum_bits) override;
 
+  // Returns true if the stream of the log has at least
+  // stream-writer-backlog-threshold appends that haven't been acknowledged
+  // as part of the prefix yet. BufferedWriter then packs the records that
+  // keep coming into fewer, larger batches, each sent as a single APPEND with
+  // a single stream sequence number, until the sequencer catches up.
+  // Ordering and retries are unaffected since the stream only ever sees
+  // whole batches.
+  bool isBacklogged(logid_t logid) override;
+
   void onCallback(Stream& stream,
                   write_stream_request_id_t stream_reqid,
                   Status status,
@@ -282,6 +291,8 @@ class StreamWriterAppendSink : public BufferedWriterAppendSink {
 
   virtual size_t getMaxPayloadSize() noexcept;
 
+  virtual size_t getBacklogThreshold() noexcept;
+
   virtual std::chrono::milliseconds getAppendRetryTimeout() noexcept;
 
   // Obtain the seen_epoch for log from specified worker. This MUST be called
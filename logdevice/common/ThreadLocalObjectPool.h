@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  A per-thread cache of freed memory blocks of sizeof(T) bytes, for
+ *        objects allocated and freed at a very high rate on Worker threads
+ *        (e.g. one Appender and a few STORE_Messages per append). Reusing a
+ *        block from a thread-local free list is a couple of loads and stores,
+ *        cheaper than a round trip through the general purpose allocator, and
+ *        keeps hot blocks in the cache of the CPU that uses them.
+ *
+ *        Classes opt in by overriding their operator new and delete:
+ *
+ *          static void* operator new(size_t size) {
+ *            return ThreadLocalObjectPool<Foo>::allocate(size);
+ *          }
+ *          static void operator delete(void* p, size_t size) {
+ *            ThreadLocalObjectPool<Foo>::deallocate(p, size);
+ *          }
+ *
+ *        Only blocks of exactly sizeof(T) are pooled; subclasses of T (e.g.
+ *        mocks in tests) go straight to ::operator new and delete. A block
+ *        may be freed on a different thread than the one it was allocated on,
+ *        it then joins the free list of the freeing thread. Each thread caches
+ *        at most kMaxCached blocks, the rest are freed; cached blocks are
+ *        freed when the thread exits.
+ */
+
+template <typename T, size_t kMaxCached = 1024>
+class ThreadLocalObjectPool {
+ public:
+  static void* allocate(size_t size) {
+    if (size == sizeof(T) && enabled().load(std::memory_order_relaxed)) {
+      FreeList* list = freeList();
+      if (list && list->head) {
+        Block* block = list->head;
+        list->head = block->next;
+        --list->size;
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  static void deallocate(void* p, size_t size) {
+    if (p == nullptr) {
+      return;
+    }
+    if (size == sizeof(T) && enabled().load(std::memory_order_relaxed)) {
+      FreeList* list = freeList();
+      if (list && list->size < kMaxCached) {
+        Block* block = static_cast<Block*>(p);
+        block->next = list->head;
+        list->head = block;
+        ++list->size;
+        return;
+      }
+    }
+    ::operator delete(p);
+  }
+
+  /**
+   * Number of blocks cached by the calling thread.
+   */
+  static size_t cachedOnThisThread() {
+    FreeList* list = freeList();
+    return list ? list->size : 0;
+  }
+
+  /**
+   * Turns pooling on or off for all threads, for benchmarks and tests. Blocks
+   * cached so far stay cached until they're reused or the thread exits.
+   */
+  static void setEnabled(bool on) {
+    enabled().store(on, std::memory_order_relaxed);
+  }
+
+ private:
+  static_assert(sizeof(T) >= sizeof(void*), "T is too small to be pooled");
+
+  struct Block {
+    Block* next;
+  };
+
+  struct FreeList {
+    Block* head{nullptr};
+    size_t size{0};
+
+    ~FreeList() {
+      while (head) {
+        Block* next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+      // Thread-local objects destroyed after this one may still free T's on
+      // this thread, those must bypass the pool.
+      destroyed() = true;
+    }
+  };
+
+  static std::atomic<bool>& enabled() {
+    static std::atomic<bool> enabled{true};
+    return enabled;
+  }
+
+  // Trivially destructible, so it can still be read during thread exit.
+  static bool& destroyed() {
+    static thread_local bool destroyed{false};
+    return destroyed;
+  }
+
+  static FreeList* freeList() {
+    if (destroyed()) {
+      return nullptr;
+    }
+    static thread_local FreeList list;
+    return &list;
+  }
+};
+
+}} // namespace facebook::logdevice
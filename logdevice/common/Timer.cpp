@@ -11,6 +11,7 @@
 #include "logdevice/common/LibeventTimer.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/RunContext.h"
+#include "logdevice/common/TimerWheel.h"
 #include "logdevice/common/WheelTimer.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/stats/Stats.h"
@@ -102,6 +103,55 @@ class WheelTimerDispatchImpl : public TimerInterface {
   bool is_activated_{false};
 };
 
+// Timer on the Worker's TimerWheel. Everything happens on the Worker thread.
+class TimerWheelImpl : public TimerInterface, private TimerWheel::Timeout {
+ public:
+  void activate(std::chrono::microseconds delay,
+                TimeoutMap* /* timeout_map */ = nullptr) override {
+    ld_check(callback_);
+    worker_ = Worker::onThisThread();
+    workerRunContext_ = worker_->currentlyRunning_;
+    worker_->timerWheel().schedule(*this, delay);
+  }
+
+  void cancel() override {
+    cancelTimeout();
+  }
+
+  bool isActive() const override {
+    return isScheduled();
+  }
+
+  void setCallback(std::function<void()> callback) override {
+    callback_ = std::move(callback);
+  }
+
+  void assign(std::function<void()> callback) override {
+    setCallback(std::move(callback));
+  }
+
+  bool isAssigned() const override {
+    return !!callback_;
+  }
+
+ private:
+  void timeoutExpired() override {
+    RunContext run_context = workerRunContext_;
+    Worker* worker = worker_;
+    worker->onStartedRunning(run_context);
+    {
+      // Local copy in case the callback calls setCallback() or destroys us.
+      std::function<void()> cb = callback_;
+      cb();
+    }
+    worker->onStoppedRunning(run_context);
+  }
+
+  std::function<void()> callback_;
+  Worker* worker_{nullptr};
+  RunContext workerRunContext_;
+};
+
 decltype(auto)
 WheelTimerDispatchImpl::makeWheelTimerInternalExecutor(Worker* worker) {
   return [timer = this, canceled = is_canceled_, worker]() mutable {
@@ -198,7 +248,10 @@ TimerInterface& Timer::getTimerImpl() const {
     // This is called from tests and ldbench workers. Caller cannot assume
     // Worker interface to be available in those cases.
     auto worker = Worker::onThisThread(false /* enforce_worker */);
-    if (worker && worker->updateable_settings_->enable_hh_wheel_backed_timers) {
+    if (worker && worker->updateable_settings_->worker_timer_wheel) {
+      impl_ = std::make_unique<TimerWheelImpl>();
+    } else if (worker &&
+               worker->updateable_settings_->enable_hh_wheel_backed_timers) {
       impl_ = std::make_unique<WheelTimerDispatchImpl>();
     } else {
       impl_ = std::make_unique<LibEventTimerImpl>();
@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TimerWheel.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr size_t TimerWheel::kLevels;
+constexpr size_t TimerWheel::kSlotBits;
+constexpr size_t TimerWheel::kSlots;
+
+namespace {
+constexpr uint64_t kSlotMask = TimerWheel::kSlots - 1;
+// Deadlines at least this many ticks away don't fit in the wheel.
+constexpr uint64_t kRange = 1ull
+    << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+} // namespace
+
+void TimerWheel::Timeout::cancelTimeout() {
+  if (hook_.is_linked()) {
+    ld_check(wheel_ != nullptr);
+    hook_.unlink();
+    if (level_ < kLevels) {
+      --wheel_->level_size_[level_];
+    }
+    --wheel_->size_;
+  }
+}
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick,
+                       WakeUpCallback wake_up,
+                       Clock::time_point now)
+    : tick_(tick), start_(now), wake_up_(std::move(wake_up)) {
+  ld_check(tick_.count() > 0);
+}
+
+TimerWheel::~TimerWheel() {
+  auto clear = [](List& list) {
+    while (!list.empty()) {
+      list.front().wheel_ = nullptr;
+      list.pop_front();
+    }
+  };
+  for (auto& level : slots_) {
+    for (List& list : level) {
+      clear(list);
+    }
+  }
+  clear(due_);
+}
+
+void TimerWheel::schedule(Timeout& timeout,
+                          std::chrono::microseconds delay,
+                          Clock::time_point now) {
+  timeout.cancelTimeout();
+
+  if (delay.count() <= 0) {
+    timeout.expiry_tick_ = current_tick_;
+  } else {
+    // Round up, so that the timeout doesn't fire before its deadline.
+    const uint64_t elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::max(now - start_, Clock::duration(0)))
+            .count();
+    const uint64_t deadline = elapsed + delay.count();
+    timeout.expiry_tick_ = (deadline + tick_.count() - 1) / tick_.count();
+  }
+  timeout.wheel_ = this;
+  const uint64_t wake_up_tick = insert(timeout);
+  ++size_;
+
+  // Only this timeout can have made the next wake up earlier.
+  if (!advancing_ && wake_up_) {
+    Clock::time_point wake_up = tickToTime(wake_up_tick);
+    if (wake_up < requested_wake_up_) {
+      requested_wake_up_ = wake_up;
+      wake_up_(wake_up);
+    }
+  }
+}
+
+uint64_t TimerWheel::insert(Timeout& timeout) {
+  const uint64_t expiry = timeout.expiry_tick_;
+  if (expiry <= current_tick_) {
+    timeout.level_ = kLevels;
+    due_.push_back(timeout);
+    return current_tick_;
+  }
+  const uint64_t diff = expiry - current_tick_;
+  size_t level = 0;
+  while (level + 1 < kLevels && diff >= (1ull << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  // Too far out: park it in the furthest slot, it'll be re-filed from there.
+  const uint64_t key = diff < kRange ? expiry : current_tick_ + kRange - 1;
+  const size_t shift = kSlotBits * level;
+  timeout.level_ = level;
+  ++level_size_[level];
+  slots_[level][(key >> shift) & kSlotMask].push_back(timeout);
+  return level == 0 ? expiry : (key >> shift) << shift;
+}
+
+void TimerWheel::moveAll(List& list, List& out) {
+  while (!list.empty()) {
+    Timeout& timeout = list.front();
+    list.pop_front();
+    if (timeout.level_ < kLevels) {
+      --level_size_[timeout.level_];
+    }
+    timeout.level_ = kLevels;
+    out.push_back(timeout);
+  }
+}
+
+void TimerWheel::cascade(List& list) {
+  List tmp;
+  moveAll(list, tmp);
+  while (!tmp.empty()) {
+    Timeout& timeout = tmp.front();
+    tmp.pop_front();
+    insert(timeout);
+  }
+}
+
+size_t TimerWheel::advance(Clock::time_point now) {
+  ld_check(!advancing_);
+  const uint64_t target = now > start_ ? (now - start_) / tick_ : 0;
+
+  List expired;
+  moveAll(due_, expired);
+  while (current_tick_ < target) {
+    if (level_size_[0] == 0) {
+      // Nothing can happen until the lowest non-empty level is cascaded.
+      // Skip to right before that.
+      size_t level = 1;
+      while (level < kLevels && level_size_[level] == 0) {
+        ++level;
+      }
+      if (level == kLevels) {
+        current_tick_ = target;
+        break;
+      }
+      const size_t shift = kSlotBits * level;
+      const uint64_t next = ((current_tick_ >> shift) + 1) << shift;
+      current_tick_ = std::max(current_tick_, std::min(target, next - 1));
+      if (current_tick_ == target) {
+        break;
+      }
+    }
+    ++current_tick_;
+    // Move timeouts down from higher levels that wrapped around, highest
+    // first so that they can keep falling through.
+    for (size_t level = kLevels - 1; level > 0; --level) {
+      const size_t shift = kSlotBits * level;
+      if ((current_tick_ & ((1ull << shift) - 1)) == 0) {
+        cascade(slots_[level][(current_tick_ >> shift) & kSlotMask]);
+      }
+    }
+    moveAll(slots_[0][current_tick_ & kSlotMask], expired);
+    // Cascading files timeouts expiring in this very tick into due_.
+    moveAll(due_, expired);
+  }
+
+  // Callbacks may schedule or cancel timeouts, including ones still in
+  // `expired`, which simply unlinks them from it.
+  advancing_ = true;
+  size_t count = 0;
+  while (!expired.empty()) {
+    Timeout& timeout = expired.front();
+    expired.pop_front();
+    --size_;
+    ++count;
+    timeout.timeoutExpired();
+  }
+  advancing_ = false;
+
+  requested_wake_up_ = Clock::time_point::max();
+  if (wake_up_) {
+    Clock::time_point next = nextWakeUp();
+    if (next != Clock::time_point::max()) {
+      requested_wake_up_ = next;
+      wake_up_(next);
+    }
+  }
+  return count;
+}
+
+TimerWheel::Clock::time_point TimerWheel::nextWakeUp() const {
+  if (size_ == 0) {
+    return Clock::time_point::max();
+  }
+  if (!due_.empty()) {
+    return tickToTime(current_tick_);
+  }
+  // The first non-empty slot of level 0, or the first cascade of a non-empty
+  // slot of a higher level, whichever comes first.
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  if (level_size_[0] > 0) {
+    for (uint64_t tick = current_tick_ + 1; tick < current_tick_ + kSlots;
+         ++tick) {
+      if (!slots_[0][tick & kSlotMask].empty()) {
+        next = tick;
+        break;
+      }
+    }
+  }
+  for (size_t level = 1; level < kLevels; ++level) {
+    if (level_size_[level] == 0) {
+      continue;
+    }
+    const size_t shift = kSlotBits * level;
+    const uint64_t block = current_tick_ >> shift;
+    for (uint64_t i = block + 1; i <= block + kSlots; ++i) {
+      const uint64_t tick = i << shift;
+      if (tick >= next) {
+        break;
+      }
+      if (!slots_[level][i & kSlotMask].empty()) {
+        next = tick;
+        break;
+      }
+    }
+  }
+  ld_check(next != std::numeric_limits<uint64_t>::max());
+  return tickToTime(next);
+}
+
+}} // namespace facebook::logdevice
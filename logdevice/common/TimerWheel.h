@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include <folly/Function.h>
+#include <folly/IntrusiveList.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A single-threaded hierarchical timing wheel, used by Workers to run
+ *       large numbers of timers (store timeouts of Appenders, read stream
+ *       timers etc.) without putting each one into libevent's min-heap.
+ *
+ *       Scheduling and cancelling a timeout are O(1). Time is divided into
+ *       ticks; a timeout fires on the first advance() at or after the end of
+ *       the tick its deadline falls into, so never early and at most one tick
+ *       late (plus event loop delay). All timeouts that expire in one
+ *       advance() are collected first and then run as one batch.
+ *
+ *       The wheel has kLevels levels of kSlots slots. Level L covers
+ *       deadlines up to kSlots^(L+1) ticks away; timeouts further out than
+ *       that are parked in the last level and re-filed when their slot comes
+ *       up. Entries in a slot of a higher level are moved down (cascaded) when
+ *       the lower level wraps around.
+ *
+ *       The wheel doesn't own a clock or an event loop: the owner calls
+ *       advance() when the time returned by nextWakeUp() comes, and is told
+ *       through the callback passed to the constructor when that time moves
+ *       earlier.
+ */
+
+class TimerWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Something that can be scheduled on a TimerWheel. Subclass and implement
+   * timeoutExpired(). Destroying a scheduled Timeout cancels it.
+   */
+  class Timeout {
+   public:
+    Timeout() = default;
+    Timeout(const Timeout&) = delete;
+    Timeout& operator=(const Timeout&) = delete;
+    virtual ~Timeout() {
+      cancelTimeout();
+    }
+
+    bool isScheduled() const {
+      return hook_.is_linked();
+    }
+
+    void cancelTimeout();
+
+   protected:
+    virtual void timeoutExpired() = 0;
+
+   private:
+    friend class TimerWheel;
+
+    folly::IntrusiveListHook hook_;
+    TimerWheel* wheel_{nullptr};
+    // Tick at the end of which the timeout expires.
+    uint64_t expiry_tick_{0};
+    // Level of the wheel the timeout is in, kLevels if it's due.
+    size_t level_{0};
+  };
+
+  using WakeUpCallback = folly::Function<void(Clock::time_point)>;
+
+  /**
+   * @param tick     granularity of the wheel
+   * @param wake_up  called with the time advance() needs to be called at,
+   *                 whenever that time becomes earlier than previously
+   *                 requested (e.g. a timeout with a shorter delay than all
+   *                 others was scheduled). May be empty if the owner polls
+   *                 nextWakeUp() instead.
+   * @param now      current time, the wheel's time starts here
+   */
+  explicit TimerWheel(std::chrono::microseconds tick,
+                      WakeUpCallback wake_up = nullptr,
+                      Clock::time_point now = Clock::now());
+
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /**
+   * Schedules `timeout` to expire `delay` after `now`. If it was already
+   * scheduled (on this or another wheel), that is cancelled first. A zero
+   * delay expires on the next advance().
+   */
+  void schedule(Timeout& timeout,
+                std::chrono::microseconds delay,
+                Clock::time_point now = Clock::now());
+
+  /**
+   * Runs all timeouts due by `now`.
+   *
+   * @return number of timeouts that expired
+   */
+  size_t advance(Clock::time_point now = Clock::now());
+
+  /**
+   * @return time at which advance() should next be called, Clock::time_point
+   *         max() if nothing is scheduled. This may be earlier than the
+   *         earliest deadline, when timeouts need to be cascaded down.
+   */
+  Clock::time_point nextWakeUp() const;
+
+  /**
+   * @return number of scheduled timeouts.
+   */
+  size_t size() const {
+    return size_;
+  }
+
+  std::chrono::microseconds tick() const {
+    return tick_;
+  }
+
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 8;
+  static constexpr size_t kSlots = 1ul << kSlotBits;
+
+ private:
+  using List = folly::IntrusiveList<Timeout, &Timeout::hook_>;
+
+  // Files `timeout` (with expiry_tick_ set) into the right slot, or into
+  // due_ if its tick has already passed.
+  //
+  // @return the tick at which advance() needs to be called for the timeout:
+  //         its expiry tick if it's in level 0, the tick at which its slot is
+  //         cascaded otherwise
+  uint64_t insert(Timeout& timeout);
+
+  // Removes all timeouts from `list` and appends them to `out`.
+  void moveAll(List& list, List& out);
+
+  // Moves the contents of `list` back through insert(), relative to the
+  // current tick.
+  void cascade(List& list);
+
+  Clock::time_point tickToTime(uint64_t tick) const {
+    return start_ + tick_ * tick;
+  }
+
+  const std::chrono::microseconds tick_;
+  const Clock::time_point start_;
+  WakeUpCallback wake_up_;
+
+  // Ticks since start_ that have been fully processed.
+  uint64_t current_tick_{0};
+  std::array<std::array<List, kSlots>, kLevels> slots_;
+  // Number of timeouts in each level, to skip over empty ones.
+  std::array<size_t, kLevels> level_size_{};
+  // Timeouts whose tick has already passed, expiring on the next advance().
+  List due_;
+  size_t size_{0};
+
+  // The last time passed to wake_up_, or max() if the owner isn't expecting
+  // a call to advance().
+  Clock::time_point requested_wake_up_{Clock::time_point::max()};
+  // True while advance() runs. Wake up requests are deferred until it's done.
+  bool advancing_{false};
+};
+
+}} // namespace facebook::logdevice
@@ -59,6 +59,10 @@ class TraceLogger {
     return cluster_config_->get();
   }
 
+  const folly::Optional<NodeID>& getMyNodeID() const {
+    return my_node_id_;
+  }
+
  protected:
   const std::shared_ptr<UpdateableConfig> cluster_config_;
   const folly::Optional<NodeID> my_node_id_;
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TrimBatcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/TrimRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/TRIM_BATCH_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+TrimBatcher::TrimBatcher() : flush_timer_([this] { flushAll(); }) {}
+
+bool TrimBatcher::add(const TRIM_Header& header, NodeID to) {
+  Worker* w = Worker::onThisThread();
+  if (w->settings().trim_batch_size <= 1) {
+    return false;
+  }
+  // If there is no connection to the node yet, assume it is running the same
+  // version as us. If it doesn't, the batch will fail with E::PROTONOSUPPORT
+  // and every request will resend its own TRIM.
+  auto proto = w->sender().getSocketProtocolVersion(to.index());
+  if (proto.hasValue() && proto.value() < Compatibility::TRIM_BATCH_SUPPORT) {
+    return false;
+  }
+
+  pending_[to.index()].push_back(header);
+  if (!flush_timer_.isActive()) {
+    flush_timer_.activate(std::chrono::microseconds(0));
+  }
+  return true;
+}
+
+void TrimBatcher::flushAll() {
+  auto pending = std::move(pending_);
+  pending_.clear();
+
+  const size_t max_batch_size = Worker::settings().trim_batch_size;
+  for (auto& kv : pending) {
+    std::vector<TRIM_Header>& headers = kv.second;
+    for (size_t begin = 0; begin < headers.size(); begin += max_batch_size) {
+      const size_t end = std::min(begin + max_batch_size, headers.size());
+      flush(kv.first,
+            std::vector<TRIM_Header>(
+                headers.begin() + begin, headers.begin() + end));
+    }
+  }
+}
+
+void TrimBatcher::flush(node_index_t to, std::vector<TRIM_Header> headers) {
+  ld_check(!headers.empty());
+
+  std::unique_ptr<Message> msg;
+  if (headers.size() == 1) {
+    msg = std::make_unique<TRIM_Message>(headers[0]);
+  } else {
+    WORKER_STAT_INCR(trim_batches_sent);
+    WORKER_STAT_ADD(trim_batched, headers.size());
+    msg = std::make_unique<TRIM_BATCH_Message>(headers);
+  }
+  if (Worker::onThisThread()->sender().sendMessage(
+          std::move(msg), NodeID(to)) == 0) {
+    return;
+  }
+
+  // The requests were told their message was sent; let them retry.
+  const Status status = err;
+  TrimRequestMap& rqmap = Worker::onThisThread()->runningTrimRequests();
+  for (const TRIM_Header& header : headers) {
+    auto it = rqmap.map.find(header.client_rqid);
+    if (it == rqmap.map.end()) {
+      continue;
+    }
+    ShardID shard(to, header.shard);
+    if (status == E::PROTONOSUPPORT && headers.size() > 1) {
+      it->second->onBatchNotSupported(shard);
+    } else {
+      it->second->onMessageSent(shard, status);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TrimBulkRequest.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "logdevice/common/TrimRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Shared by the callbacks of the TrimRequests started by one
+// TrimBulkRequest; the last of them to complete calls the application.
+struct TrimBulkState {
+  std::vector<TrimBulkResult> results;
+  size_t remaining;
+  trim_bulk_callback_t callback;
+
+  void complete(size_t idx, Status status) {
+    results[idx].status = status;
+    ld_check(remaining > 0);
+    if (--remaining > 0) {
+      return;
+    }
+    Status st = E::OK;
+    for (const auto& result : results) {
+      if (result.status != E::OK) {
+        st = E::PARTIAL;
+        break;
+      }
+    }
+    callback(st, std::move(results));
+  }
+};
+
+} // namespace
+
+TrimBulkRequest::TrimBulkRequest(ClientBridge* client,
+                                 std::vector<std::pair<logid_t, lsn_t>> trims,
+                                 std::chrono::milliseconds client_timeout,
+                                 trim_bulk_callback_t callback)
+    : Request(RequestType::TRIM_BULK),
+      client_(client),
+      trims_(std::move(trims)),
+      client_timeout_(client_timeout),
+      callback_(std::move(callback)) {}
+
+Request::Execution TrimBulkRequest::execute() {
+  auto state = std::make_shared<TrimBulkState>();
+  std::unordered_map<logid_t, size_t, logid_t::Hash> idx_by_log;
+  for (const auto& trim : trims_) {
+    auto res = idx_by_log.emplace(trim.first, state->results.size());
+    if (res.second) {
+      state->results.push_back(
+          TrimBulkResult{trim.first, trim.second, E::FAILED});
+    } else {
+      // Trimming is monotonic, so only the highest trim point matters.
+      lsn_t& lsn = state->results[res.first->second].lsn;
+      lsn = std::max(lsn, trim.second);
+    }
+  }
+  state->remaining = state->results.size();
+  state->callback = std::move(callback_);
+
+  if (state->results.empty()) {
+    state->callback(E::OK, {});
+    return Execution::COMPLETE;
+  }
+  WORKER_STAT_ADD(trim_bulk_logs, state->results.size());
+
+  // The results vector is moved out when the last request completes, which
+  // may happen synchronously, so iterate over a copy of the trims.
+  std::vector<std::pair<logid_t, lsn_t>> trims;
+  trims.reserve(state->results.size());
+  for (const auto& result : state->results) {
+    trims.emplace_back(result.log_id, result.lsn);
+  }
+
+  for (size_t idx = 0; idx < trims.size(); ++idx) {
+    const logid_t log_id = trims[idx].first;
+    const lsn_t lsn = trims[idx].second;
+    if (log_id == LOGID_INVALID || lsn == LSN_INVALID || lsn >= LSN_MAX) {
+      // Same check as trimSync().
+      state->complete(idx, E::INVALID_PARAM);
+      continue;
+    }
+    auto cb = [state, idx](const TrimRequest&, Status st) {
+      state->complete(idx, st);
+    };
+    auto rq = std::make_unique<TrimRequest>(
+        client_, log_id, lsn, client_timeout_, trim_callback_ex_t(cb));
+    rq->enableBatching();
+    if (rq->execute() == Execution::CONTINUE) {
+      // The request is now owned by Worker::runningTrimRequests().
+      rq.release();
+    }
+  }
+  return Execution::COMPLETE;
+}
+
+}} // namespace facebook::logdevice
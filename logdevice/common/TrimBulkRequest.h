@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "logdevice/common/ClientBridge.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/RequestType.h"
+#include "logdevice/include/Client.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file
+ *
+ * Request that runs in the client library in order to satisfy an
+ * application's call to the trimBulk() API.
+ *
+ * Starts a TrimRequest for every distinct log on the current Worker, with
+ * batching enabled, all within the same event loop iteration. The TRIM
+ * messages they send to the same storage node are thus collected by the
+ * Worker's TrimBatcher and go out together in TRIM_BATCH messages. Each
+ * TrimRequest otherwise runs exactly as for trim(), with its own retries and
+ * timeout, and this request only gathers their results.
+ */
+
+class TrimBulkRequest : public Request {
+ public:
+  TrimBulkRequest(ClientBridge* client,
+                  std::vector<std::pair<logid_t, lsn_t>> trims,
+                  std::chrono::milliseconds client_timeout,
+                  trim_bulk_callback_t callback);
+
+  Execution execute() override;
+
+ private:
+  ClientBridge* client_;
+  const std::vector<std::pair<logid_t, lsn_t>> trims_;
+  const std::chrono::milliseconds client_timeout_;
+  trim_bulk_callback_t callback_;
+};
+
+}} // namespace facebook::logdevice
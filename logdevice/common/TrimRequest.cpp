@@ -12,6 +12,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/SyncSequencerRequest.h"
+#include "logdevice/common/TrimBatcher.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
@@ -291,6 +292,18 @@ void TrimRequest::onMessageSent(ShardID to, Status status) {
   }
 }
 
+void TrimRequest::onBatchNotSupported(ShardID to) {
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 1,
+                 "TRIM_BATCH is not supported by the server at %s, "
+                 "falling back to TRIM for log %lu",
+                 to.toString().c_str(),
+                 log_id_.val_);
+  batching_ = false;
+  nodeset_accessor_->onShardAccessed(
+      to, {StorageSetAccessor::Result::TRANSIENT_ERROR, E::PROTONOSUPPORT});
+}
+
 void TrimRequest::finalize(Status status) {
   callback_(*this, status);
   callback_ = nullptr;
@@ -300,6 +313,9 @@ void TrimRequest::finalize(Status status) {
 int TrimRequest::sendOneMessage(ShardID to) {
   NodeID node_id(to.node());
   TRIM_Header header = {id_, log_id_, trim_point_, to.shard()};
+  if (batching_ && Worker::onThisThread()->trimBatcher().add(header, node_id)) {
+    return 0;
+  }
   auto msg = std::make_unique<TRIM_Message>(header);
   return Worker::onThisThread()->sender().sendMessage(std::move(msg), node_id);
 }
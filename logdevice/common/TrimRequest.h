@@ -93,6 +93,22 @@ class TrimRequest : public DistributedRequest {
   void onReply(ShardID from, Status status);
   void onMessageSent(ShardID to, Status status);
 
+  /**
+   * Lets the TRIM messages of this request go out in TRIM_BATCH messages,
+   * together with those of the other requests running on this Worker. Used
+   * by trimBulk(). Must be called before execute().
+   */
+  void enableBatching() {
+    batching_ = true;
+  }
+
+  /**
+   * Called instead of onMessageSent() if our TRIM went out in a TRIM_BATCH
+   * that the storage node doesn't support. Stops batching and lets
+   * StorageSetAccessor retry the shard with a regular TRIM.
+   */
+  void onBatchNotSupported(ShardID to);
+
   /**
    * Forces the TrimRequest to run on a specific Worker.
    */
@@ -185,6 +201,9 @@ class TrimRequest : public DistributedRequest {
   bool bypass_write_token_check_ = false;
   bool bypass_tail_lsn_check_ = false;
 
+  // See enableBatching()
+  bool batching_ = false;
+
   std::unique_ptr<NodeSetFinder> nodeset_finder_{nullptr};
 };
 
@@ -169,6 +169,10 @@ class UnorderedMapWithLRU {
     index_.erase(it);
   }
 
+  size_t size() const {
+    return index_.size();
+  }
+
   bool empty() const {
     if (index_.empty()) {
       ld_check(sentinel_.next == empty_);
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
@@ -51,6 +52,12 @@ namespace facebook { namespace logdevice {
  *         FastUpdateableSharedPtr                 21ns,
  *         UpdateableSharedPtr                     28ns,
  *         without shared_ptr<shared_ptr> trick:   20ns,
+ *
+ *       Threads that read the same pointer very often and can tell when they
+ *       are done using what they read (e.g. Workers, between tasks) can put a
+ *       SnapshotCache in front of either class. That turns a read into one
+ *       atomic load of a version that only changes on update(), without the
+ *       thread-local lookup, lock and reference counting of get().
  */
 
 /**
@@ -136,6 +143,15 @@ class FastUpdateableSharedPtr : boost::noncopyable {
     return local.ptr;
   }
 
+  /**
+   * @return a number that changes every time the pointer is updated. If
+   *         version() returns v, a subsequent get() returns the value of
+   *         version v or newer.
+   */
+  uint64_t version() const {
+    return masterVersion_.load(std::memory_order_acquire);
+  }
+
  private:
   bool updateImpl(std::shared_ptr<T> ptr, std::shared_ptr<T>* cmp) {
     {
@@ -217,6 +233,13 @@ class UpdateableSharedPtr : boost::noncopyable {
     return local.ptr.value();
   }
 
+  /**
+   * @see FastUpdateableSharedPtr::version()
+   */
+  uint64_t version() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
  private:
   // @param ptr            Value to update to.
   // @param if_equal_to    If not nullptr, only update if current pointer is
@@ -258,6 +281,10 @@ class UpdateableSharedPtr : boost::noncopyable {
       }
     }
 
+    // Only now that no thread-local cache has the old value can readers be
+    // told about the new one.
+    version_.fetch_add(1);
+
     if (out_old_value) {
       *out_old_value = std::move(ptr);
     }
@@ -271,6 +298,7 @@ class UpdateableSharedPtr : boost::noncopyable {
   };
 
   std::shared_ptr<T> masterPtr_;
+  std::atomic<uint64_t> version_{1};
 
   // Instead of using Tag as tag for ThreadLocal, effectively use pair (T, Tag),
   // which is more granular.
@@ -281,4 +309,66 @@ class UpdateableSharedPtr : boost::noncopyable {
   mutable std::mutex mutex_;
 };
 
+/**
+ * A cache of the value of an UpdateableSharedPtr, FastUpdateableSharedPtr or
+ * anything else with get() and version() methods like theirs, for a single
+ * thread.
+ *
+ * refresh() picks up a new value if the source has been updated, otherwise
+ * it only costs an atomic load. The raw pointer returned by get() stays valid
+ * until the next call to endEpoch(), even if a later refresh() replaces the
+ * cached value: values that are replaced are kept alive until then. For
+ * example, a Worker can refresh on each read and end the epoch after every
+ * task, so that raw pointers can be used for the duration of a task.
+ *
+ * Not thread-safe.
+ */
+template <typename T>
+class SnapshotCache : boost::noncopyable {
+ public:
+  /**
+   * Updates the cached value from `source` if it has changed since the last
+   * refresh.
+   *
+   * @return true if the cached value was replaced
+   */
+  template <typename Source>
+  bool refresh(const Source& source) {
+    // Read the version first: if the source is updated concurrently we may
+    // get a newer value than `version` says, and harmlessly refresh again.
+    const uint64_t version = source.version();
+    if (version == version_) {
+      return false;
+    }
+    if (ptr_) {
+      retired_.push_back(std::move(ptr_));
+    }
+    ptr_ = source.get();
+    version_ = version;
+    return true;
+  }
+
+  T* get() const {
+    return ptr_.get();
+  }
+
+  const std::shared_ptr<T>& getShared() const {
+    return ptr_;
+  }
+
+  /**
+   * Releases values replaced by refresh() since the last call. Raw pointers
+   * to them must not be used after this.
+   */
+  void endEpoch() {
+    retired_.clear();
+  }
+
+ private:
+  std::shared_ptr<T> ptr_;
+  // Sources start at version 1 or more, so the first refresh() always reads.
+  uint64_t version_{0};
+  std::vector<std::shared_ptr<T>> retired_;
+};
+
 }} // namespace facebook::logdevice
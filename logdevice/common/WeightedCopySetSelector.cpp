@@ -20,6 +20,9 @@ using NodeStatus = NodeAvailabilityChecker::NodeStatus;
 // See select() for explanation.
 static constexpr int MAX_BLACKLISTING_ITERATIONS = 100;
 
+// See NodeAvailabilityCache::copyset_table.
+static constexpr size_t COPYSET_TABLE_REUSE = 16;
+
 // Returns either floor(x) or ceil(x), so that, on average, the return value
 // is equal to x. In particular, if x is integer returns x.
 static copyset_size_t randomRound(double x, RNG& rng) {
@@ -47,14 +50,16 @@ WeightedCopySetSelector::WeightedCopySetSelector(
     StatsHolder* stats,
     RNG& init_rng,
     bool print_bias_warnings,
-    const CopySetSelectorDependencies* deps)
+    const CopySetSelectorDependencies* deps,
+    size_t copyset_table_size)
     : logid_(logid),
       deps_(deps),
       nodeset_state_(nodeset_state),
       print_bias_warnings_(print_bias_warnings),
       locality_enabled_(locality_enabled),
       stats_(stats),
-      nodeset_indices_(epoch_metadata.shards) {
+      nodeset_indices_(epoch_metadata.shards),
+      copyset_table_size_(copyset_table_size) {
   {
     ld_check(nodes_configuration != nullptr);
     // Convert replication requirement from the more general ReplictionProperty
@@ -622,6 +627,7 @@ WeightedCopySetSelector::prepareCachedNodeAvailability() const {
       bool was_disabled = cache.adjusted_hierarchy->attachNode(shard);
       ld_check(was_disabled);
       cache.avoid_detaching_my_domain = false;
+      ++cache.version;
     }
   }
 
@@ -655,6 +661,7 @@ bool WeightedCopySetSelector::checkAvailabilityAndBlacklist(
       if (was_enabled_cache) {
         cache.unavailable_nodes.push_back(node);
         cache.avoid_detaching_my_domain = false;
+        ++cache.version;
       } else {
         // Be extra paranoid and don't allow cache.unavailable_nodes to grow
         // unboundedly if there's a bug.
@@ -698,6 +705,101 @@ WeightedCopySetSelector::select(copyset_size_t extras,
                                 State* selector_state,
                                 RNG& rng,
                                 bool retry) const {
+  if (copyset_table_size_ > 0 && retry) {
+    NodeAvailabilityCache& cache = prepareCachedNodeAvailability();
+    if (selectFromCopySetTable(cache, copyset_out, chain_out, rng)) {
+      *copyset_size_out = replication_;
+      STAT_INCR(stats_, copyset_selection_attempts);
+      STAT_INCR(stats_, copyset_selected);
+      STAT_INCR(stats_, copyset_selected_from_table);
+      // TODO #8329263: support extras
+      return extras ? Result::PARTIAL : Result::SUCCESS;
+    }
+  }
+  return selectUncached(extras,
+                        copyset_out,
+                        copyset_size_out,
+                        chain_out,
+                        selector_state,
+                        rng,
+                        retry);
+}
+
+bool WeightedCopySetSelector::selectFromCopySetTable(
+    NodeAvailabilityCache& cache,
+    StoreChainLink copyset_out[],
+    bool* chain_out,
+    RNG& rng) const {
+  if (cache.copyset_table.empty() ||
+      cache.copyset_table_version != cache.version ||
+      cache.copyset_table_uses >= copyset_table_size_ * COPYSET_TABLE_REUSE) {
+    fillCopySetTable(cache, rng);
+    if (cache.copyset_table.empty()) {
+      return false;
+    }
+  }
+
+  const size_t num_copysets = cache.copyset_table.size() / replication_;
+  const ShardID* copyset =
+      &cache.copyset_table[(rng() % num_copysets) * replication_];
+  bool chain = true;
+  for (size_t i = 0; i < replication_; ++i) {
+    StoreChainLink destination;
+    auto node_status = deps_->getNodeAvailability()->checkNode(
+        nodeset_state_.get(), copyset[i], &destination);
+    if (node_status == NodeStatus::NOT_AVAILABLE) {
+      // Blacklist the node, same as checkAvailabilityAndBlacklist(). This
+      // bumps cache.version, so the table will be redrawn without it.
+      if (cache.adjusted_hierarchy->detachNode(copyset[i])) {
+        cache.unavailable_nodes.push_back(copyset[i]);
+        cache.avoid_detaching_my_domain = false;
+        ++cache.version;
+      }
+      return false;
+    }
+    chain &= node_status == NodeStatus::AVAILABLE;
+    copyset_out[i] = destination;
+  }
+  if (chain_out) {
+    *chain_out &= chain;
+  }
+  ++cache.copyset_table_uses;
+  return true;
+}
+
+void WeightedCopySetSelector::fillCopySetTable(NodeAvailabilityCache& cache,
+                                               RNG& rng) const {
+  cache.copyset_table.clear();
+  cache.copyset_table.reserve(copyset_table_size_ * replication_);
+  copyset_chain_t copyset(replication_);
+  for (size_t i = 0; i < copyset_table_size_; ++i) {
+    copyset_size_t size;
+    bool chain = true;
+    // retry = false also keeps the draws out of the stats.
+    Result rv = selectUncached(
+        0, copyset.data(), &size, &chain, nullptr, rng, false /* retry */);
+    if (rv != Result::SUCCESS) {
+      break;
+    }
+    ld_check(size == replication_);
+    for (const StoreChainLink& link : copyset) {
+      cache.copyset_table.push_back(link.destination);
+    }
+  }
+  // Nodes blacklisted while filling may be in the copysets drawn before;
+  // selectFromCopySetTable() checks availability anyway.
+  cache.copyset_table_version = cache.version;
+  cache.copyset_table_uses = 0;
+}
+
+CopySetSelector::Result
+WeightedCopySetSelector::selectUncached(copyset_size_t extras,
+                                        StoreChainLink copyset_out[],
+                                        copyset_size_t* copyset_size_out,
+                                        bool* chain_out,
+                                        State* selector_state,
+                                        RNG& rng,
+                                        bool retry) const {
   NodeAvailabilityCache& cache = prepareCachedNodeAvailability();
   // Need to make a copy in case we'll detach local domain - don't want to
   // cache that.
@@ -745,13 +847,13 @@ WeightedCopySetSelector::select(copyset_size_t extras,
       if (worker) {
         worker->resetGraylist();
       }
-      return select(extras,
-                    copyset_out,
-                    copyset_size_out,
-                    chain_out,
-                    selector_state,
-                    rng,
-                    false /* retry */);
+      return selectUncached(extras,
+                            copyset_out,
+                            copyset_size_out,
+                            chain_out,
+                            selector_state,
+                            rng,
+                            false /* retry */);
     }
     RATELIMIT_ERROR(
         std::chrono::seconds(10),
@@ -29,6 +29,10 @@ class WeightedCopySetSelector : public CopySetSelector {
   //   Set to false if load balancing is not important, e.g. for internal logs.
   //   Other, non-load-balancing-related, warnings are printed regardless of
   //   this setting.
+  // @param copyset_table_size
+  //   If nonzero, select() draws copysets from a per-thread table of this
+  //   many precomputed copysets instead of sampling the hierarchy on every
+  //   call. See NodeAvailabilityCache::copyset_table.
   WeightedCopySetSelector(
       logid_t logid,
       const EpochMetaData& epoch_metadata,
@@ -42,7 +46,8 @@ class WeightedCopySetSelector : public CopySetSelector {
       RNG& init_rng = DefaultRNG::get(),
       bool print_bias_warnings = true,
       const CopySetSelectorDependencies* deps =
-          CopySetSelectorDependencies::instance());
+          CopySetSelectorDependencies::instance(),
+      size_t copyset_table_size = 0);
 
   std::string getName() const override;
 
@@ -269,6 +274,22 @@ class WeightedCopySetSelector : public CopySetSelector {
     // that detaching the local domain is probably not a good idea.
     // This is reset back to false every time `unavailable_nodes` changes.
     bool avoid_detaching_my_domain = false;
+
+    // Incremented every time `unavailable_nodes` changes.
+    uint64_t version = 0;
+
+    // If copyset_table_size_ is nonzero, copysets drawn from
+    // `adjusted_hierarchy` as it was when `version` was
+    // `copyset_table_version`, replication_ shards each. select() picks one
+    // of them uniformly at random, which costs O(replication_) instead of
+    // sampling the hierarchy. Since every copyset in the table came from the
+    // regular sampling, picking among them follows the weights, up to the
+    // sampling error of a table this size; to keep that error from sticking,
+    // the table is redrawn after COPYSET_TABLE_REUSE * copyset_table_size_
+    // uses, as well as whenever `version` changes.
+    std::vector<ShardID> copyset_table;
+    uint64_t copyset_table_version = 0;
+    size_t copyset_table_uses = 0;
   };
 
   const logid_t logid_;
@@ -314,6 +335,10 @@ class WeightedCopySetSelector : public CopySetSelector {
 
   mutable folly::ThreadLocal<NodeAvailabilityCache> node_availability_cache_;
 
+  // Number of copysets in NodeAvailabilityCache::copyset_table; 0 disables
+  // the table.
+  const size_t copyset_table_size_;
+
   // If there are no weights in epoch metadata, this method is used to take
   // weights from config, transforming them to compensate for different-sized
   // domains.
@@ -342,6 +367,26 @@ class WeightedCopySetSelector : public CopySetSelector {
   // initializing it if needed and re-checking the cached blacklist of nodes.
   NodeAvailabilityCache& prepareCachedNodeAvailability() const;
 
+  // select() without the copyset table.
+  Result selectUncached(copyset_size_t extras,
+                        StoreChainLink copyset_out[],
+                        copyset_size_t* copyset_size_out,
+                        bool* chain_out,
+                        State* selector_state,
+                        RNG& rng,
+                        bool retry) const;
+
+  // Picks a copyset from cache.copyset_table, redrawing the table first if
+  // it's outdated. Returns false if the table couldn't be filled or the
+  // picked copyset contains an unavailable node; the node then gets
+  // blacklisted in `cache`, and the caller should use selectUncached().
+  bool selectFromCopySetTable(NodeAvailabilityCache& cache,
+                              StoreChainLink copyset_out[],
+                              bool* chain_out,
+                              RNG& rng) const;
+
+  void fillCopySetTable(NodeAvailabilityCache& cache, RNG& rng) const;
+
   bool checkAvailabilityAndBlacklist(const StoreChainLink copyset[],
                                      size_t copyset_size,
                                      AdjustedHierarchy& hierarchy,
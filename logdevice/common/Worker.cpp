@@ -13,6 +13,7 @@
 #include <unistd.h>
 
 #include <folly/Memory.h>
+#include <folly/Random.h>
 #include <folly/stats/BucketedTimeSeries.h>
 #include <sys/resource.h>
 #include <sys/time.h>
@@ -33,6 +34,7 @@
 #include "logdevice/common/EventLoop.h"
 #include "logdevice/common/EventLoopTaskQueue.h"
 #include "logdevice/common/ExponentialBackoffAdaptiveVariable.h"
+#include "logdevice/common/FindKeyBatcher.h"
 #include "logdevice/common/FindKeyRequest.h"
 #include "logdevice/common/FireAndForgetRequest.h"
 #include "logdevice/common/GetClusterStateRequest.h"
@@ -40,6 +42,7 @@
 #include "logdevice/common/GetHeadAttributesRequest.h"
 #include "logdevice/common/GetLogInfoRequest.h"
 #include "logdevice/common/GetRsmSnapshotRequest.h"
+#include "logdevice/common/GetTailAttributesBulkRequest.h"
 #include "logdevice/common/GetTrimPointRequest.h"
 #include "logdevice/common/GraylistingTracker.h"
 #include "logdevice/common/LogIDUniqueQueue.h"
@@ -51,12 +54,16 @@
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/SSLFetcher.h"
+#include "logdevice/common/STOREDBatcher.h"
 #include "logdevice/common/SequencerBackgroundActivator.h"
 #include "logdevice/common/ServerConfigUpdatedRequest.h"
 #include "logdevice/common/ShapingContainer.h"
 #include "logdevice/common/SyncSequencerRequest.h"
 #include "logdevice/common/TimeoutMap.h"
+#include "logdevice/common/TimerWheel.h"
+#include "logdevice/common/UpdateableSharedPtr.h"
 #include "logdevice/common/TraceLogger.h"
+#include "logdevice/common/TrimBatcher.h"
 #include "logdevice/common/TrimRequest.h"
 #include "logdevice/common/WorkerTimeoutStats.h"
 #include "logdevice/common/WriteMetaDataRecord.h"
@@ -64,6 +71,7 @@
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/configuration/logs/LogsConfigManager.h"
+#include "logdevice/common/configuration/nodes/NodesConfigurationDelta.h"
 #include "logdevice/common/event_log/EventLogStateMachine.h"
 #include "logdevice/common/network/AsyncSocketConnectionFactory.h"
 #include "logdevice/common/network/OverloadDetector.h"
@@ -160,6 +168,7 @@ class WorkerImpl {
   GetTrimPointRequestMap runningGetTrimPoint_;
   DataSizeRequestMap runningDataSize_;
   GetHeadAttributesRequestMap runningGetHeadAttributes_;
+  GetTailAttributesBulkRequestMap runningGetTailAttributesBulk_;
   GetClusterStateRequestMap runningGetClusterState_;
   GetEpochRecoveryMetadataRequestMap runningGetEpochRecoveryMetadata_;
   LogsConfigApiRequestMap runningLogManagementReqs_;
@@ -169,6 +178,7 @@ class WorkerImpl {
   AppendRequestMap runningAppends_;
   CheckSealRequestMap runningCheckSeals_;
   ConfigurationFetchRequestMap runningConfigurationFetches_;
+  configuration::nodes::NodesConfigurationHistory nodesConfigurationHistory_;
   GetSeqStateRequestMap runningGetSeqState_;
   AppenderMap activeAppenders_;
   GetLogInfoRequestMaps runningGetLogInfo_;
@@ -186,6 +196,32 @@ class WorkerImpl {
   std::unique_ptr<SequencerBackgroundActivator> sequencerBackgroundActivator_;
   std::unique_ptr<GraylistingTracker> graylistingTracker_;
   std::unique_ptr<ShapingContainer> read_shaping_container_;
+  // Created on first use, on the worker thread.
+  std::unique_ptr<STOREDBatcher> storedBatcher_;
+  // Created on first use, on the worker thread.
+  std::unique_ptr<FindKeyBatcher> findKeyBatcher_;
+  // Created on first use, on the worker thread.
+  std::unique_ptr<TrimBatcher> trimBatcher_;
+
+  // Config as last seen by config getters called on the worker thread. See
+  // Worker::getConfiguration().
+  SnapshotCache<ServerConfig> serverConfigSnapshot_;
+  SnapshotCache<LogsConfig> logsConfigSnapshot_;
+  SnapshotCache<configuration::ZookeeperConfig> zookeeperConfigSnapshot_;
+  SnapshotCache<const configuration::nodes::NodesConfiguration>
+      nodesConfigurationSnapshot_;
+  // Composed from the first three snapshots.
+  std::shared_ptr<Configuration> configSnapshot_;
+  // Previous values of configSnapshot_, kept until the end of the task.
+  std::vector<std::shared_ptr<Configuration>> retiredConfigSnapshots_;
+
+  void endConfigSnapshotEpoch() {
+    serverConfigSnapshot_.endEpoch();
+    logsConfigSnapshot_.endEpoch();
+    zookeeperConfigSnapshot_.endEpoch();
+    nodesConfigurationSnapshot_.endEpoch();
+    retiredConfigSnapshots_.clear();
+  }
 };
 
 std::string Worker::makeThreadName(Processor* processor,
@@ -284,19 +320,58 @@ std::string Worker::getName(WorkerType type, worker_id_t idx) {
   return std::string("W") + workerTypeChar(type) + std::to_string(idx.val_);
 }
 
+bool Worker::useConfigSnapshots() const {
+  // The snapshots aren't thread-safe; other threads (and the constructor)
+  // go to UpdateableConfig.
+  return on_this_thread_ == this && impl_ != nullptr;
+}
+
 std::shared_ptr<Configuration> Worker::getConfiguration() const {
   ld_check((bool)config_);
-  return config_->get();
+  if (!useConfigSnapshots()) {
+    return config_->get();
+  }
+  // Same as UpdateableConfig::get(), but only allocates a new Configuration
+  // when one of its parts has changed.
+  bool changed = impl_->serverConfigSnapshot_.refresh(
+      *config_->updateableServerConfig());
+  changed |=
+      impl_->logsConfigSnapshot_.refresh(*config_->updateableLogsConfig());
+  changed |= impl_->zookeeperConfigSnapshot_.refresh(
+      *config_->updateableZookeeperConfig());
+  if (!impl_->serverConfigSnapshot_.get()) {
+    return nullptr;
+  }
+  if (changed || !impl_->configSnapshot_) {
+    if (impl_->configSnapshot_) {
+      impl_->retiredConfigSnapshots_.push_back(
+          std::move(impl_->configSnapshot_));
+    }
+    impl_->configSnapshot_ = std::make_shared<Configuration>(
+        impl_->serverConfigSnapshot_.getShared(),
+        impl_->logsConfigSnapshot_.getShared(),
+        impl_->zookeeperConfigSnapshot_.getShared());
+  }
+  return impl_->configSnapshot_;
 }
 
 std::shared_ptr<ServerConfig> Worker::getServerConfig() const {
   ld_check((bool)config_);
-  return config_->getServerConfig();
+  if (!useConfigSnapshots()) {
+    return config_->getServerConfig();
+  }
+  impl_->serverConfigSnapshot_.refresh(*config_->updateableServerConfig());
+  return impl_->serverConfigSnapshot_.getShared();
 }
 
 std::shared_ptr<const configuration::nodes::NodesConfiguration>
 Worker::getNodesConfiguration() const {
-  return config_->getNodesConfiguration();
+  if (!useConfigSnapshots()) {
+    return config_->getNodesConfiguration();
+  }
+  impl_->nodesConfigurationSnapshot_.refresh(
+      *config_->updateableNodesConfiguration());
+  return impl_->nodesConfigurationSnapshot_.getShared();
 }
 
 std::shared_ptr<const configuration::nodes::NodesConfiguration>
@@ -311,7 +386,11 @@ Worker::getNodesConfigurationFromServerConfigSource() const {
 
 std::shared_ptr<LogsConfig> Worker::getLogsConfig() const {
   ld_check((bool)config_);
-  return config_->getLogsConfig();
+  if (!useConfigSnapshots()) {
+    return config_->getLogsConfig();
+  }
+  impl_->logsConfigSnapshot_.refresh(*config_->updateableLogsConfig());
+  return impl_->logsConfigSnapshot_.getShared();
 }
 
 std::shared_ptr<configuration::ZookeeperConfig>
@@ -379,6 +458,12 @@ void Worker::onNodesConfigurationUpdated() {
             idx_.val(),
             workerTypeStr(worker_type_));
   }
+  if (immutable_settings_->server) {
+    auto& history = nodesConfigurationHistory();
+    history.setCapacity(
+        updateable_settings_->nodes_configuration_delta_history);
+    history.add(getNodesConfiguration());
+  }
   // note: onServerConfigUpdated() is a virtual function and this may calls
   // derived function from subclass (e.g., ServerWorker)
   onServerConfigUpdated();
@@ -433,9 +518,10 @@ void Worker::onSettingsUpdated() {
   immutable_settings_ = new_settings;
   auto event_loop = checked_downcast<EventLoop*>(getExecutor());
   event_loop->getTaskQueue().setDequeuesPerIteration(
-      {immutable_settings_->hi_requests_per_iteration,
-       immutable_settings_->mid_requests_per_iteration,
-       immutable_settings_->lo_requests_per_iteration});
+      immutable_settings_->requestsPerIteration(worker_type_));
+  event_loop->getTaskQueue().setBusyPoll(
+      immutable_settings_->busy_poll_max_spin,
+      immutable_settings_->busy_poll_cpu_budget);
   clientReadStreams().noteSettingsUpdated();
   if (logsconfig_manager_) {
     // LogsConfigManager might want to start or stop the underlying RSM if
@@ -547,6 +633,7 @@ void Worker::initSSLFetcher() {
                                     setting.ssl_key_path,
                                     setting.ssl_ca_path,
                                     setting.ssl_load_client_cert,
+                                    setting.ssl_ktls,
                                     stats());
 }
 
@@ -843,6 +930,36 @@ void Worker::popRecoveryRequest() {
     auto it = index.begin();
     std::shared_ptr<Sequencer> seq = seqmap.findSequencer(*it);
 
+    // Among the first few queued data logs, recover first the one with the
+    // most demand from writers. The order within the queue is kept, so a log
+    // without demand still gets its turn once it reaches the front.
+    const size_t window = settings().recovery_queue_demand_window;
+    if (&index == &dataqueue_index && window > 1) {
+      auto demand = [](const Sequencer* s) {
+        if (!s) {
+          return std::make_pair(size_t(0), int64_t(0));
+        }
+        return std::make_pair(
+            s->getNumAppendsInFlight(), s->appendRateEstimate().first);
+      };
+      auto best_demand = demand(seq.get());
+      auto candidate = std::next(it);
+      for (size_t i = 1; i < window && candidate != index.end();
+           ++i, ++candidate) {
+        std::shared_ptr<Sequencer> candidate_seq =
+            seqmap.findSequencer(*candidate);
+        auto candidate_demand = demand(candidate_seq.get());
+        if (candidate_demand > best_demand) {
+          it = candidate;
+          seq = std::move(candidate_seq);
+          best_demand = candidate_demand;
+        }
+      }
+      if (it != index.begin()) {
+        WORKER_STAT_INCR(recovery_reordered_by_demand);
+      }
+    }
+
     if (!seq) {
       // Sequencer went away.
       if (ld_catch(MetaDataLog::isMetaDataLog(*it) && err == E::NOSEQUENCER,
@@ -973,9 +1090,33 @@ ClusterState* Worker::getClusterState() {
   return Worker::onThisThread()->processor_->cluster_state_.get();
 }
 
+namespace {
+
+std::chrono::nanoseconds threadCpuTime() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+} // namespace
+
 void Worker::onStoppedRunning(RunContext prev_context) {
   std::chrono::steady_clock::time_point start_time;
   start_time = currentlyRunningStart_;
+  // Estimated CPU time of all executions like this one, or -1 if this one
+  // wasn't sampled.
+  int64_t cpu_usec = -1;
+  if (currentlyRunningCpuStart_.hasValue()) {
+    auto cpu_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        threadCpuTime() - currentlyRunningCpuStart_.value());
+    cpu_usec = std::max<int64_t>(
+        0,
+        static_cast<int64_t>(cpu_time.count() /
+                             currentlyRunningCpuSamplingRate_));
+    currentlyRunningCpuStart_.clear();
+  }
   generateErrorInjection(
       worker_stall_error_injection_chance_, worker_stall_inj_ms_);
   setCurrentlyRunningContext(RunContext(), prev_context);
@@ -1001,6 +1142,9 @@ void Worker::onStoppedRunning(RunContext prev_context) {
     }
   }
 
+  profiler_.onStopped(
+      prev_context, duration, settings().event_loop_profiler_sampling_rate);
+
   auto usec =
       std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
   switch (prev_context.type_) {
@@ -1009,6 +1153,12 @@ void Worker::onStoppedRunning(RunContext prev_context) {
       ld_check(msg_type < static_cast<int>(MessageType::MAX));
       MESSAGE_TYPE_STAT_ADD(
           Worker::stats(), msg_type, message_worker_usec, usec);
+      if (cpu_usec >= 0) {
+        MESSAGE_TYPE_STAT_ADD(
+            Worker::stats(), msg_type, message_worker_cpu_usec, cpu_usec);
+        MESSAGE_TYPE_STAT_INCR(
+            Worker::stats(), msg_type, message_cpu_time_samples);
+      }
       HISTOGRAM_ADD(Worker::stats(), message_callback_duration[msg_type], usec);
       break;
     }
@@ -1016,6 +1166,12 @@ void Worker::onStoppedRunning(RunContext prev_context) {
       int rqtype = static_cast<int>(prev_context.subtype_.request);
       ld_check(rqtype < static_cast<int>(RequestType::MAX));
       REQUEST_TYPE_STAT_ADD(Worker::stats(), rqtype, request_worker_usec, usec);
+      if (cpu_usec >= 0) {
+        REQUEST_TYPE_STAT_ADD(
+            Worker::stats(), rqtype, request_worker_cpu_usec, cpu_usec);
+        REQUEST_TYPE_STAT_INCR(
+            Worker::stats(), rqtype, request_cpu_time_samples);
+      }
       HISTOGRAM_ADD(Worker::stats(), request_execution_duration[rqtype], usec);
       break;
     }
@@ -1040,8 +1196,36 @@ void Worker::onStoppedRunning(RunContext prev_context) {
   }
 }
 
+TimerWheel& Worker::timerWheel() {
+  if (!timer_wheel_) {
+    ld_check(EventLoop::onThisThread());
+    timer_wheel_driver_ =
+        std::make_unique<EvTimer>(&EventLoop::onThisThread()->getEvBase());
+    timer_wheel_driver_->attachCallback([this] {
+      size_t expired = timer_wheel_->advance();
+      WORKER_STAT_ADD(timer_wheel_timeouts_expired, expired);
+    });
+    timer_wheel_ = std::make_unique<TimerWheel>(
+        std::chrono::milliseconds(1),
+        [this](TimerWheel::Clock::time_point at) {
+          // Round up to whole milliseconds, the resolution of EvTimer, so
+          // that we don't wake up before the wheel has anything to do.
+          auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+              at - TimerWheel::Clock::now());
+          timer_wheel_driver_->scheduleTimeout(
+              std::max(delay, std::chrono::milliseconds(0)));
+        });
+  }
+  return *timer_wheel_;
+}
+
 void Worker::onStartedRunning(RunContext new_context) {
   setCurrentlyRunningContext(new_context, RunContext());
+  const double rate = settings().worker_cpu_time_sampling_rate;
+  if (rate > 0 && (rate >= 1 || folly::Random::randDouble01() < rate)) {
+    currentlyRunningCpuSamplingRate_ = rate;
+    currentlyRunningCpuStart_ = threadCpuTime();
+  }
 }
 
 void Worker::activateIsolationTimer() {
@@ -1061,6 +1245,7 @@ void Worker::setCurrentlyRunningContext(RunContext new_context,
   ld_check(currentlyRunning_ == prev_context);
   currentlyRunning_ = new_context;
   currentlyRunningStart_ = std::chrono::steady_clock::now();
+  profiler_.onStarted(currentlyRunning_, currentlyRunningStart_);
 }
 
 std::unique_ptr<MessageDispatch> Worker::createMessageDispatch() {
@@ -1087,6 +1272,7 @@ Worker::packRunContext() {
       std::chrono::steady_clock::now() - w->currentlyRunningStart_);
   w->currentlyRunning_ = RunContext();
   w->currentlyRunningStart_ = std::chrono::steady_clock::now();
+  w->profiler_.onStarted(w->currentlyRunning_, w->currentlyRunningStart_);
   return res;
 }
 
@@ -1103,6 +1289,7 @@ void Worker::unpackRunContext(
   ld_check(w->currentlyRunning_.type_ == RunContext::Type::NONE);
   w->currentlyRunning_ = std::get<0>(s);
   w->currentlyRunningStart_ = std::chrono::steady_clock::now() - std::get<1>(s);
+  w->profiler_.onStarted(w->currentlyRunning_, w->currentlyRunningStart_);
 }
 
 //
@@ -1117,6 +1304,13 @@ FindKeyRequestMap& Worker::runningFindKey() const {
   return impl_->runningFindKey_;
 }
 
+FindKeyBatcher& Worker::findKeyBatcher() const {
+  if (!impl_->findKeyBatcher_) {
+    impl_->findKeyBatcher_ = std::make_unique<FindKeyBatcher>();
+  }
+  return *impl_->findKeyBatcher_;
+}
+
 FireAndForgetRequestMap& Worker::runningFireAndForgets() const {
   return impl_->runningFireAndForgets_;
 }
@@ -1125,6 +1319,13 @@ TrimRequestMap& Worker::runningTrimRequests() const {
   return impl_->runningTrimRequests_;
 }
 
+TrimBatcher& Worker::trimBatcher() const {
+  if (!impl_->trimBatcher_) {
+    impl_->trimBatcher_ = std::make_unique<TrimBatcher>();
+  }
+  return *impl_->trimBatcher_;
+}
+
 GetTrimPointRequestMap& Worker::runningGetTrimPoint() const {
   return impl_->runningGetTrimPoint_;
 }
@@ -1141,6 +1342,11 @@ GetHeadAttributesRequestMap& Worker::runningGetHeadAttributes() const {
   return impl_->runningGetHeadAttributes_;
 }
 
+GetTailAttributesBulkRequestMap&
+Worker::runningGetTailAttributesBulk() const {
+  return impl_->runningGetTailAttributesBulk_;
+}
+
 GetClusterStateRequestMap& Worker::runningGetClusterState() const {
   return impl_->runningGetClusterState_;
 }
@@ -1165,6 +1371,13 @@ AppenderMap& Worker::activeAppenders() const {
   return impl_->activeAppenders_;
 }
 
+STOREDBatcher& Worker::storedBatcher() const {
+  if (!impl_->storedBatcher_) {
+    impl_->storedBatcher_ = std::make_unique<STOREDBatcher>();
+  }
+  return *impl_->storedBatcher_;
+}
+
 AppendRequestMap& Worker::runningAppends() const {
   return impl_->runningAppends_;
 }
@@ -1177,6 +1390,11 @@ ConfigurationFetchRequestMap& Worker::runningConfigurationFetches() const {
   return impl_->runningConfigurationFetches_;
 }
 
+configuration::nodes::NodesConfigurationHistory&
+Worker::nodesConfigurationHistory() const {
+  return impl_->nodesConfigurationHistory_;
+}
+
 ShapingContainer& Worker::readShapingContainer() const {
   return *impl_->read_shaping_container_;
 }
@@ -1356,53 +1574,70 @@ void Worker::add(folly::Func func) {
 }
 
 void Worker::addWithPriority(folly::Func func, int8_t priority) {
+  WorkContext::addWithPriority(wrapWork(std::move(func), priority), priority);
+}
+
+folly::Func Worker::wrapWork(folly::Func func, int8_t priority) {
   switch (priority) {
     case folly::Executor::HI_PRI:
       STAT_INCR(processor_->stats_, worker_enqueued_hi_pri_work);
+      STAT_INCR(processor_->stats_, worker_queued_hi_pri_work);
       break;
     case folly::Executor::MID_PRI:
       STAT_INCR(processor_->stats_, worker_enqueued_mid_pri_work);
+      STAT_INCR(processor_->stats_, worker_queued_mid_pri_work);
       break;
     case folly::Executor::LO_PRI:
       STAT_INCR(processor_->stats_, worker_enqueued_lo_pri_work);
+      STAT_INCR(processor_->stats_, worker_queued_lo_pri_work);
       break;
     default:
       break;
   }
 
   num_requests_enqueued_.fetch_add(1, std::memory_order_relaxed);
-  WorkContext::addWithPriority(
-      [this,
-       func = std::move(func),
-       priority,
-       enqueue_time = std::chrono::steady_clock::now()]() mutable {
-        WorkerContextScopeGuard g(this);
-        num_requests_enqueued_.fetch_sub(1, std::memory_order_relaxed);
-
-        const auto queue_time =
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::steady_clock::now() - enqueue_time);
-
-        HISTOGRAM_ADD(stats_, requests_queue_latency, queue_time.count());
-        switch (priority) {
-          case folly::Executor::HI_PRI:
-            HISTOGRAM_ADD(stats_, hi_pri_requests_latency, queue_time.count());
-            STAT_INCR(processor_->stats_, worker_executed_hi_pri_work);
-            break;
-          case folly::Executor::MID_PRI:
-            HISTOGRAM_ADD(stats_, mid_pri_requests_latency, queue_time.count());
-            STAT_INCR(processor_->stats_, worker_executed_mid_pri_work);
-            break;
-          case folly::Executor::LO_PRI:
-            HISTOGRAM_ADD(stats_, lo_pri_requests_latency, queue_time.count());
-            STAT_INCR(processor_->stats_, worker_executed_lo_pri_work);
-            break;
-          default:
-            break;
-        }
-        func();
-      },
-      priority);
+  return [this,
+          func = std::move(func),
+          priority,
+          enqueue_time = std::chrono::steady_clock::now()]() mutable {
+    WorkerContextScopeGuard g(this);
+    num_requests_enqueued_.fetch_sub(1, std::memory_order_relaxed);
+
+    const auto queue_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - enqueue_time);
+
+    HISTOGRAM_ADD(stats_, requests_queue_latency, queue_time.count());
+    const int type_idx = workerIndexByType(worker_type_);
+    const size_t pri_idx = EventLoopTaskQueue::translatePriority(priority);
+    HISTOGRAM_ADD(stats_,
+                  worker_queue_latency[type_idx][pri_idx],
+                  queue_time.count());
+    switch (priority) {
+      case folly::Executor::HI_PRI:
+        HISTOGRAM_ADD(stats_, hi_pri_requests_latency, queue_time.count());
+        STAT_INCR(processor_->stats_, worker_executed_hi_pri_work);
+        STAT_DECR(processor_->stats_, worker_queued_hi_pri_work);
+        break;
+      case folly::Executor::MID_PRI:
+        HISTOGRAM_ADD(stats_, mid_pri_requests_latency, queue_time.count());
+        STAT_INCR(processor_->stats_, worker_executed_mid_pri_work);
+        STAT_DECR(processor_->stats_, worker_queued_mid_pri_work);
+        break;
+      case folly::Executor::LO_PRI:
+        HISTOGRAM_ADD(stats_, lo_pri_requests_latency, queue_time.count());
+        STAT_INCR(processor_->stats_, worker_executed_lo_pri_work);
+        STAT_DECR(processor_->stats_, worker_queued_lo_pri_work);
+        break;
+      default:
+        break;
+    }
+    func();
+    // Config objects replaced while running the task are no longer needed.
+    if (impl_) {
+      impl_->endConfigSnapshotEpoch();
+    }
+  };
 }
 
 int Worker::forcePost(std::unique_ptr<Request>& req) {
@@ -1426,6 +1661,48 @@ int Worker::forcePost(std::unique_ptr<Request>& req) {
   return 0;
 }
 
+int Worker::postBatch(std::vector<std::unique_ptr<Request>>& reqs, bool force) {
+  if (shutting_down_) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+  if (std::any_of(reqs.begin(), reqs.end(), [](const auto& r) { return !r; })) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  if (!force &&
+      num_requests_enqueued_.load(std::memory_order_relaxed) >
+          updateable_settings_->worker_request_pipe_capacity) {
+    err = E::NOBUFS;
+    return -1;
+  }
+
+  auto* event_loop = dynamic_cast<EventLoop*>(getExecutor());
+  if (event_loop == nullptr) {
+    // Not running on an EventLoop (e.g. in some tests), no batching.
+    for (auto& req : reqs) {
+      int rv = forcePost(req);
+      ld_check(rv == 0);
+    }
+    return 0;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  std::vector<std::pair<folly::Func, int8_t>> funcs;
+  funcs.reserve(reqs.size());
+  for (auto& req : reqs) {
+    req->enqueue_time_ = now;
+    auto priority = req->getExecutorPriority();
+    folly::Func func = [rq = std::move(req), this]() mutable {
+      processRequest(std::move(rq));
+    };
+    funcs.emplace_back(wrapWork(std::move(func), priority), priority);
+  }
+  event_loop->addBatchWithPriority(std::move(funcs));
+
+  return 0;
+}
+
 void Worker::generateErrorInjection(double error_chance,
                                     std::chrono::milliseconds sleep_duration) {
   if (UNLIKELY(worker_type_ == WorkerType::GENERAL && error_chance > 0 &&
@@ -19,6 +19,7 @@
 
 #include <folly/Function.h>
 #include <folly/IntrusiveList.h>
+#include <folly/Optional.h>
 #include <folly/Random.h>
 #include <folly/concurrency/UnboundedQueue.h>
 #include <folly/container/F14Map.h>
@@ -26,6 +27,7 @@
 
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/EventLoop.h"
+#include "logdevice/common/EventLoopProfiler.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/RunContext.h"
@@ -117,6 +119,7 @@ class ClusterState;
 class Configuration;
 class EpochRecovery;
 class EventLogStateMachine;
+class FindKeyBatcher;
 class GetSeqStateRequestMap;
 class LogStorageState;
 class LogsConfig;
@@ -128,6 +131,7 @@ class Processor;
 class RebuildingCoordinatorInterface;
 class Request;
 class SSLFetcher;
+class STOREDBatcher;
 class Sender;
 class SequencerBackgroundActivator;
 class ServerConfig;
@@ -136,7 +140,9 @@ class ShardAuthoritativeStatusManager;
 class SocketCallback;
 class StatsHolder;
 class SyncSequencerRequestList;
+class TimerWheel;
 class TraceLogger;
+class TrimBatcher;
 class UpdateableConfig;
 class WorkerImpl;
 class WorkerTimeoutStats;
@@ -162,6 +168,7 @@ struct GetEpochRecoveryMetadataRequestMap;
 struct GetHeadAttributesRequestMap;
 struct GetLogInfoRequestMaps;
 struct GetRsmSnapshotRequestMap;
+struct GetTailAttributesBulkRequestMap;
 struct GetTrimPointRequestMap;
 struct LogIDUniqueQueue;
 struct LogRecoveryRequestMap;
@@ -179,7 +186,8 @@ namespace configuration {
 class ZookeeperConfig;
 namespace nodes {
 class NodesConfiguration;
-}
+class NodesConfigurationHistory;
+} // namespace nodes
 } // namespace configuration
 
 template <typename Duration>
@@ -257,6 +265,11 @@ class Worker : public WorkContext {
   /**
    * @return cluster configuration object cached on this Worker and
    *         auto updated
+   *
+   * When called on the worker thread, this and the getters below return
+   * per-worker snapshots that are checked against the UpdateableConfig's
+   * version on every call, so they are as fresh as UpdateableConfig's but
+   * cheaper to get. Replaced snapshots are released after the current task.
    */
   std::shared_ptr<Configuration> getConfiguration() const;
 
@@ -413,12 +426,18 @@ class Worker : public WorkContext {
   // a map of all currently running FindKeyRequests
   FindKeyRequestMap& runningFindKey() const;
 
+  // batches FINDKEY messages sent by FindKeyRequests running on this Worker
+  FindKeyBatcher& findKeyBatcher() const;
+
   // a map of all currently running FireAndForgetRequest
   FireAndForgetRequestMap& runningFireAndForgets() const;
 
   // a map of all currently running TrimRequests
   TrimRequestMap& runningTrimRequests() const;
 
+  // batches TRIM messages sent by TrimRequests running on this Worker
+  TrimBatcher& trimBatcher() const;
+
   // a map of all currently running GetTrimPointRequest
   GetTrimPointRequestMap& runningGetTrimPoint() const;
 
@@ -430,6 +449,9 @@ class Worker : public WorkContext {
   // a map of all currently running GetHeadAttributesRequest
   GetHeadAttributesRequestMap& runningGetHeadAttributes() const;
 
+  // a map of all currently running GetTailAttributesBulkRequest
+  GetTailAttributesBulkRequestMap& runningGetTailAttributesBulk() const;
+
   // a map of all currently running GetClusterStateRequests
   GetClusterStateRequestMap& runningGetClusterState() const;
 
@@ -461,12 +483,19 @@ class Worker : public WorkContext {
 
   ConfigurationFetchRequestMap& runningConfigurationFetches() const;
 
+  // Recent NodesConfigurations, used to answer CONFIG_FETCH with deltas
+  configuration::nodes::NodesConfigurationHistory&
+  nodesConfigurationHistory() const;
+
   // a map of all currently running GetSeqStateRequests
   GetSeqStateRequestMap& runningGetSeqState() const;
 
   // a map of all currently active Appenders created by this Worker
   AppenderMap& activeAppenders() const;
 
+  // batches replies to STOREs sent through connections owned by this Worker
+  STOREDBatcher& storedBatcher() const;
+
   // a map of all currently running GetLogInfoRequests
   GetLogInfoRequestMaps& runningGetLogInfo() const;
 
@@ -709,6 +738,23 @@ class Worker : public WorkContext {
   // Time when currentlyRunning_ was set
   std::chrono::steady_clock::time_point currentlyRunningStart_;
 
+  // If the thread CPU time of currentlyRunning_ is being measured, the thread
+  // CPU time when it started and the sampling rate it was picked with, see
+  // worker-cpu-time-sampling-rate.
+  folly::Optional<std::chrono::nanoseconds> currentlyRunningCpuStart_;
+  double currentlyRunningCpuSamplingRate_{0};
+
+  // Per-type execution times of what has been running on this Worker. Also
+  // lets other threads see what the Worker is currently running.
+  EventLoopProfiler profiler_;
+
+  /**
+   * Timing wheel that backs Timers created on this Worker when the
+   * worker-timer-wheel setting is on, see TimerWheel. Created on first use.
+   * Must be called on this Worker's thread.
+   */
+  TimerWheel& timerWheel();
+
   // This should be called whenever the ServerConfig  has been updated.
   // Has to be called from the worker thread
   virtual void onServerConfigUpdated();
@@ -796,6 +842,17 @@ class Worker : public WorkContext {
    */
   int forcePost(std::unique_ptr<Request>& req);
 
+  /**
+   * Posts all of `reqs` at once, waking up the worker only once. Either all
+   * requests are posted (and `reqs` is left with nullptrs) or none are.
+   *
+   * @param force  if true, behaves like forcePost(), otherwise like tryPost()
+   *               with the capacity checked once for the whole batch
+   *
+   * @return 0 on success, -1 with err set as in tryPost()/forcePost()
+   */
+  int postBatch(std::vector<std::unique_ptr<Request>>& reqs, bool force);
+
   virtual void setupWorker();
   // Callback functions that register worker id and duration of slow/delayed
   // action.
@@ -823,6 +880,14 @@ class Worker : public WorkContext {
   // Initializes subscriptions to config and setting updates
   void initializeSubscriptions();
 
+  // True if config getters can use the worker's config snapshots, i.e. they
+  // are called on this worker's thread.
+  bool useConfigSnapshots() const;
+
+  // Wraps work added to the executor with queueing stats and the worker
+  // context. Used by addWithPriority() and postBatch().
+  folly::Func wrapWork(folly::Func func, int8_t priority);
+
   // Helper used by onStartedRunning() and onStoppedRunning()
   void setCurrentlyRunningContext(RunContext new_context,
                                   RunContext prev_context);
@@ -942,6 +1007,11 @@ class Worker : public WorkContext {
   std::chrono::milliseconds worker_stall_inj_ms_;
   std::chrono::milliseconds worker_queue_inj_ms_;
 
+  // See timerWheel(). timer_wheel_driver_ is a libevent timer armed for when
+  // the wheel next needs to be advanced.
+  std::unique_ptr<TimerWheel> timer_wheel_;
+  std::unique_ptr<EvTimer> timer_wheel_driver_;
+
  protected:
   std::unique_ptr<SSLFetcher> ssl_fetcher_;
 
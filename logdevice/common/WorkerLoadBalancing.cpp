@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/WorkerLoadBalancing.h"
 
+#include <algorithm>
+
 #include <folly/Random.h>
 
 #include "logdevice/common/Worker.h"
@@ -14,7 +16,8 @@
 namespace facebook { namespace logdevice {
 
 worker_id_t WorkerLoadBalancing::selectWorker() {
-  if (loads_.size() == 1) {
+  const int n = active_.load();
+  if (n <= 1) {
     return worker_id_t(0);
   }
 
@@ -33,7 +36,6 @@ worker_id_t WorkerLoadBalancing::selectWorker() {
   double coinflip;
 
   {
-    const int n = loads_.size();
     // This selects a pair of random numbers in [0, n - 1].
     index1 = folly::Random::rand32(n);
     index2 = (index1 + folly::Random::rand32(1, n)) % n;
@@ -72,4 +74,30 @@ worker_id_t WorkerLoadBalancing::selectWorker() {
   return worker_id_t(coinflip < prob ? index2 : index1);
 }
 
+size_t WorkerLoadBalancing::adjustActiveWorkers(size_t min_active,
+                                                int64_t park_below,
+                                                int64_t unpark_above) {
+  const size_t n = loads_.size();
+  size_t active = active_.load();
+  if (min_active == 0 || min_active >= n) {
+    active_.store(n);
+    return n;
+  }
+
+  int64_t total = 0;
+  for (size_t i = 0; i < active; ++i) {
+    total += std::max(int64_t(0), loads_[i].val.load());
+  }
+  if (active < min_active) {
+    active = min_active;
+  } else if (active < n && total > unpark_above * int64_t(active)) {
+    ++active;
+  } else if (active > min_active &&
+             total < park_below * int64_t(active - 1)) {
+    --active;
+  }
+  active_.store(active);
+  return active;
+}
+
 }} // namespace facebook::logdevice
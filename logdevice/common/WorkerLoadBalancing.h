@@ -30,7 +30,8 @@ class WorkerLoadBalancing {
    * Main constructor.  Pass an initialized RNG; tests can use a fixed seed,
    * production can properly initialize.
    */
-  explicit WorkerLoadBalancing(size_t nworkers) : loads_(nworkers) {
+  explicit WorkerLoadBalancing(size_t nworkers)
+      : loads_(nworkers), active_(nworkers) {
     static_assert(sizeof(PaddedLoad) == 128, "");
   }
 
@@ -48,12 +49,42 @@ class WorkerLoadBalancing {
 
   /**
    * Selects a worker based on load (less loaded workers are more likely to be
-   * chosen).
+   * chosen). Only active workers are considered.
    *
    * Thread-safe.
    */
   worker_id_t selectWorker();
 
+  /**
+   * Workers [0, activeWorkers()) are active; the rest are parked and get no
+   * new work from selectWorker(), though they keep running whatever they
+   * already own (connections, read streams etc.). Initially all workers are
+   * active.
+   *
+   * Thread-safe.
+   */
+  size_t activeWorkers() const {
+    return active_.load();
+  }
+
+  /**
+   * Parks or unparks at most one worker based on the most recently reported
+   * loads, in the units of reportLoad().
+   *
+   * Unparks the lowest-numbered parked worker if the average load of active
+   * workers is above `unpark_above`. Parks the highest-numbered active worker
+   * if there are more than `min_active` active workers and their total load
+   * would still average below `park_below` with one worker fewer. If
+   * `min_active` is 0 or at least the number of workers, unparks everything.
+   *
+   * Must not be called concurrently with itself.
+   *
+   * @return  the new number of active workers
+   */
+  size_t adjustActiveWorkers(size_t min_active,
+                             int64_t park_below,
+                             int64_t unpark_above);
+
  private:
   struct PaddedLoad {
     std::atomic<int64_t> val{0};
@@ -61,6 +92,7 @@ class WorkerLoadBalancing {
   };
 
   std::vector<PaddedLoad> loads_;
+  std::atomic<size_t> active_;
 };
 
 }} // namespace facebook::logdevice
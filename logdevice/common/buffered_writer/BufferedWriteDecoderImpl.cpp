@@ -10,9 +10,12 @@
 #include <lz4.h>
 #include <zstd.h>
 
+#include <variant>
+
 #include <folly/Varint.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/buffered_writer/ZstdDictionary.h"
 #include "logdevice/common/debug.h"
 
 namespace facebook { namespace logdevice {
@@ -111,16 +114,29 @@ int BufferedWriteDecoderImpl::decodeOne(std::unique_ptr<DataRecord>&& record,
 
 int BufferedWriteDecoderImpl::decodeOne(const DataRecord& record,
                                         std::vector<Payload>& payloads_out) {
+  const PayloadHolder* blob_owner = nullptr;
+  auto owns_payload = dynamic_cast<const DataRecordOwnsPayload*>(&record);
+  if (owns_payload) {
+    blob_owner = std::get_if<PayloadHolder>(&owns_payload->owner_);
+    if (blob_owner &&
+        (blob_owner->iobuf().data() != record.payload.data() ||
+         blob_owner->iobuf().length() != record.payload.size())) {
+      // Payload doesn't cover the holder's buffer exactly; don't guess.
+      blob_owner = nullptr;
+    }
+  }
   return decodeOne(Slice(record.payload),
                    payloads_out,
                    nullptr,
-                   /* copy_blob_if_uncompressed */ true);
+                   /* copy_blob_if_uncompressed */ true,
+                   blob_owner);
 };
 
 int BufferedWriteDecoderImpl::decodeOne(Slice blob,
                                         std::vector<Payload>& payloads_out,
                                         std::unique_ptr<DataRecord>&& record,
-                                        bool copy_blob_if_uncompressed) {
+                                        bool copy_blob_if_uncompressed,
+                                        const PayloadHolder* blob_owner) {
   if (record) {
     // For the memory ownership transfer to work as intended, `recordptr'
     // needs to be a DataRecordOwnsPayload under the hood.
@@ -135,6 +151,8 @@ int BufferedWriteDecoderImpl::decodeOne(Slice blob,
   Compression compression = (Compression)(flags & Flags::COMPRESSION_MASK);
   switch (compression) {
     case Compression::NONE: {
+      // No need to copy if we can share ownership of the blob's buffer.
+      copy_blob_if_uncompressed &= blob_owner == nullptr;
       std::unique_ptr<uint8_t[]> buf;
       if (copy_blob_if_uncompressed) {
         buf = std::make_unique<uint8_t[]>(blob.size);
@@ -144,7 +162,10 @@ int BufferedWriteDecoderImpl::decodeOne(Slice blob,
 
       int rv = decodeUnowned(blob, payloads_out);
       if (rv == 0) {
-        if (copy_blob_if_uncompressed) {
+        if (blob_owner) {
+          // Copying a PayloadHolder only bumps the IOBuf refcount.
+          pinned_payload_holders_.push_back(*blob_owner);
+        } else if (copy_blob_if_uncompressed) {
           pinned_buffers_.push_back(std::move(buf));
         } else if (record) {
           pinned_data_records_.push_back(std::move(record));
@@ -254,10 +275,39 @@ int BufferedWriteDecoderImpl::decodeCompressed(
   ld_spew("decompressing blob of size %ld", end - ptr);
   std::unique_ptr<uint8_t[]> buf(new uint8_t[uncompressed_size]);
   if (compression == Compression::ZSTD) {
-    size_t rv = ZSTD_decompress(buf.get(),         // dst
-                                uncompressed_size, // dstCapacity
-                                ptr,               // src
-                                end - ptr);        // compressedSize
+    // Batches compressed with a dictionary have its ID in the frame header.
+    const unsigned dict_id = ZSTD_getDictID_fromFrame(ptr, end - ptr);
+    size_t rv;
+    if (dict_id != 0) {
+      auto dict = ZstdDictionaryRegistry::get().find(dict_id);
+      if (!dict) {
+        RATELIMIT_ERROR(std::chrono::seconds(1),
+                        1,
+                        "Buffered write is compressed with unknown zstd "
+                        "dictionary %u. Register it with "
+                        "BufferedWriteDecoder::addZstdDictionary().",
+                        dict_id);
+        return -1;
+      }
+      static thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)>
+          dctx(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+      if (!dctx) {
+        RATELIMIT_ERROR(
+            std::chrono::seconds(1), 1, "ZSTD_createDCtx() failed");
+        return -1;
+      }
+      rv = ZSTD_decompress_usingDDict(dctx.get(),
+                                      buf.get(),
+                                      uncompressed_size,
+                                      ptr,
+                                      end - ptr,
+                                      dict->getDDict());
+    } else {
+      rv = ZSTD_decompress(buf.get(),         // dst
+                           uncompressed_size, // dstCapacity
+                           ptr,               // src
+                           end - ptr);        // compressedSize
+    }
     if (ZSTD_isError(rv)) {
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       1,
@@ -13,6 +13,7 @@
 
 #include <folly/FBVector.h>
 
+#include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/BufferedWriteDecoder.h"
 #include "logdevice/include/BufferedWriter.h"
@@ -42,17 +43,23 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
   // client-supplied output vector.
   int decodeOne(std::unique_ptr<DataRecord>&& record,
                 std::vector<Payload>& payloads_out);
-  // Variant that does not consume the input DataRecord.  Instead, the blob is
-  // copied if uncompressed.  This is useful when the caller cannot afford to
-  // unconditionally relinquish ownership of the DataRecord.
+  // Variant that does not consume the input DataRecord.  This is useful when
+  // the caller cannot afford to unconditionally relinquish ownership of the
+  // DataRecord.  If the blob is uncompressed and `record' is a
+  // DataRecordOwnsPayload holding a PayloadHolder, the decoder shares
+  // ownership of the (refcounted) payload buffer and the returned payloads
+  // point into it; otherwise an uncompressed blob is copied.
   int decodeOne(const DataRecord& record, std::vector<Payload>& payloads_out);
 
   // Internal variant of decodeOne() where `record' is optional (`blob' may
-  // point into a manually managed piece of memory).
+  // point into a manually managed piece of memory).  If `blob_owner' is
+  // given, it holds the memory `blob' points into, and is pinned instead of
+  // copying an uncompressed blob.
   int decodeOne(Slice blob,
                 std::vector<Payload>& payloads_out,
                 std::unique_ptr<DataRecord>&& record,
-                bool copy_blob_if_uncompressed);
+                bool copy_blob_if_uncompressed,
+                const PayloadHolder* blob_owner = nullptr);
 
   // Returns the number of individual records stored in a single DataRecord.
   static int getBatchSize(const DataRecord& record, size_t* size_out);
@@ -76,5 +83,8 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
   // Buffers used for decompression; Payload instances we returned to the
   // client point into these buffers.
   folly::fbvector<std::unique_ptr<uint8_t[]>> pinned_buffers_;
+  // References to payload buffers of DataRecords we decoded uncompressed
+  // blobs of without taking ownership of the DataRecord.
+  folly::fbvector<PayloadHolder> pinned_payload_holders_;
 };
 }} // namespace facebook::logdevice
@@ -7,6 +7,9 @@
  */
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 
+#include <thread>
+
+#include <folly/AtomicIntrusiveLinkedList.h>
 #include <folly/Memory.h>
 #include <folly/hash/Hash.h>
 
@@ -25,6 +28,59 @@ int ProcessorProxy::postWithRetrying(std::unique_ptr<Request>& rq) {
   return processor_->postWithRetrying(rq);
 }
 
+/**
+ * Lock-free queue of appends staged for one shard.  Application threads push
+ * with a single compare-and-swap; the shard's worker takes everything staged
+ * so far with a single exchange.
+ */
+class StagedAppends {
+ public:
+  struct Chunk {
+    Chunk(BufferedWriterShard::AppendChunk a, bool at)
+        : appends(std::move(a)),
+          atomic(at),
+          thread(std::this_thread::get_id()) {}
+
+    BufferedWriterShard::AppendChunk appends;
+    bool atomic;
+    // Thread that staged the chunk, to find it again if the drain couldn't
+    // be scheduled.
+    std::thread::id thread;
+    folly::AtomicIntrusiveLinkedListHook<Chunk> hook;
+  };
+
+  /**
+   * Thread-safe.
+   *
+   * @return  true if nothing was staged before, i.e. the caller needs to
+   *          schedule a drain.
+   */
+  bool push(std::unique_ptr<Chunk> chunk) {
+    return list_.insertHead(chunk.release());
+  }
+
+  /**
+   * Calls f() on all staged chunks, in the order they were staged.
+   */
+  template <typename F>
+  void drain(F&& f) {
+    list_.sweep([&](Chunk* c) {
+      std::unique_ptr<Chunk> chunk(c);
+      f(*chunk);
+    });
+  }
+
+  ~StagedAppends() {
+    // Only nonempty if appends were staged after the shard was destroyed.
+    drain([](Chunk&) {});
+  }
+
+ private:
+  char FB_ANONYMOUS_VARIABLE(padding)[128];
+  folly::AtomicIntrusiveLinkedList<Chunk, &Chunk::hook> list_;
+  char FB_ANONYMOUS_VARIABLE(padding)[128];
+};
+
 namespace {
 
 // All requests used by a single BufferedWriterImpl must have the same priority
@@ -147,6 +203,7 @@ BufferedWriterImpl::BufferedWriterImpl(ProcessorProxy* processor_proxy,
     int rv = processor()->postWithRetrying(req);
     ld_check(rv == 0);
     shards_.push_back(id);
+    staged_.push_back(std::make_unique<StagedAppends>());
   }
 
   // No need to wait for the requests to complete because they can't fail and
@@ -200,6 +257,8 @@ class QuiesceShardRequest : public PerShardRequest {
                         id,
                         sem) {}
   void doWork(Worker::ActiveBufferedWritersMap::iterator it) override {
+    // Appends staged before shutDown() fail with E::SHUTDOWN.
+    it->second->parent_->drainStagedAppends(worker_.val_, it->second);
     it->second->quiesce();
   }
 };
@@ -215,6 +274,7 @@ class DestroyShardRequest : public PerShardRequest {
                         id,
                         sem) {}
   void doWork(Worker::ActiveBufferedWritersMap::iterator it) override {
+    it->second->parent_->drainStagedAppends(worker_.val_, it->second);
     delete it->second;
     auto& map = Worker::onThisThread()->active_buffered_writers_;
     map.erase(it);
@@ -287,18 +347,13 @@ void BufferedWriterImpl::shutDown() {
 }
 
 namespace {
-// Transfers an AppendChunk to a Worker for processing
-class BufferedAppendRequest : public Request {
+// Tells a Worker to pick up the appends staged for its shard
+class DrainStagedAppendsRequest : public Request {
  public:
-  BufferedAppendRequest(worker_id_t worker,
-                        buffered_writer_id_t id,
-                        BufferedWriterShard::AppendChunk appends,
-                        bool atomic)
+  DrainStagedAppendsRequest(worker_id_t worker, buffered_writer_id_t id)
       : Request(RequestType::BUFFERED_WRITER_APPEND),
         worker_(worker),
-        id_(id),
-        appends_(std::move(appends)),
-        atomic_(atomic) {}
+        id_(id) {}
 
   int getThreadAffinity(int /*nthreads*/) override {
     return worker_.val_;
@@ -323,24 +378,70 @@ class BufferedAppendRequest : public Request {
     }
 
     BufferedWriterShard* shard = it->second;
-    shard->append(std::move(appends_), atomic_);
+    shard->parent_->drainStagedAppends(worker_.val_, shard);
     return Execution::COMPLETE;
   }
 
-  // If the Request failed to get posted, this allows the payloads to be
-  // transferred back to the client
-  BufferedWriterShard::AppendChunk releaseChunk() {
-    return std::move(appends_);
-  }
-
  private:
   worker_id_t worker_;
   buffered_writer_id_t id_;
-  BufferedWriterShard::AppendChunk appends_;
-  bool atomic_;
 };
 } // namespace
 
+int BufferedWriterImpl::stageAppends(int shard_idx,
+                                     BufferedWriterShard::AppendChunk& chunk,
+                                     bool atomic) {
+  if (!staged_[shard_idx]->push(
+          std::make_unique<StagedAppends::Chunk>(std::move(chunk), atomic))) {
+    // A drain is already scheduled and will pick this chunk up.
+    return 0;
+  }
+  // Not subject to the worker's request queue limit: there is at most one
+  // of these in flight per shard, and the memory limit bounds the appends it
+  // carries.
+  std::unique_ptr<Request> req = std::make_unique<DrainStagedAppendsRequest>(
+      worker_id_t(shard_idx), shards_[shard_idx]);
+  if (processor()->postImportant(req) == 0) {
+    STAT_INCR(stats_, buffered_writer_staged_drains);
+    return 0;
+  }
+
+  // The Processor is shutting down, so nothing will drain the staged appends.
+  // Take our chunk back, unless a drain that was already running picked it
+  // up, and fail the chunks other threads staged after it.
+  const Status status = err;
+  int rv = 0;
+  staged_[shard_idx]->drain([&](StagedAppends::Chunk& staged) {
+    if (staged.thread == std::this_thread::get_id()) {
+      chunk = std::move(staged.appends);
+      rv = -1;
+      return;
+    }
+    int64_t payload_bytes = 0;
+    for (auto& append : staged.appends) {
+      BufferedWriter::AppendCallback::ContextSet contexts;
+      payload_bytes += append.payload.size();
+      contexts.emplace_back(
+          std::move(append.context), std::move(append.payload));
+      callback_->onFailureInternal(
+          append.log_id, std::move(contexts), status, NodeID());
+    }
+    append_sink_->onBytesSentToWorker(-payload_bytes);
+    STAT_ADD(
+        stats_, buffered_append_failed_post_request, staged.appends.size());
+    releaseMemory(payload_bytes);
+  });
+  err = status;
+  return rv;
+}
+
+void BufferedWriterImpl::drainStagedAppends(int shard_idx,
+                                            BufferedWriterShard* shard) {
+  staged_[shard_idx]->drain([&](StagedAppends::Chunk& staged) {
+    shard->append(std::move(staged.appends), staged.atomic);
+  });
+}
+
 // Helper function shared by two append()s so that it's a single logging
 // callsite
 static void log_memory_limit_exceeded(int memory_limit_bytes) {
@@ -387,28 +488,20 @@ int BufferedWriterImpl::append(logid_t log_id,
   auto release_memory_on_fail =
       folly::makeGuard([this, payload_size] { releaseMemory(payload_size); });
 
-  // Post a BufferedAppendRequest to the appropriate Worker.
+  // Stage the append for the appropriate Worker.
   int shard_idx = mapLogToShardIndex(log_id);
 
   BufferedWriterShard::AppendChunk chunk;
   chunk.emplace_back(
       log_id, std::move(payload), std::move(cb_context), std::move(attrs));
-  std::unique_ptr<Request> req =
-      std::make_unique<BufferedAppendRequest>(worker_id_t(shard_idx),
-                                              shards_[shard_idx],
-                                              std::move(chunk),
-                                              /* atomic */ false);
   append_sink_->onBytesSentToWorker(payload_size);
-  int rv = processor()->postRequest(req);
+  int rv = stageAppends(shard_idx, chunk, /* atomic */ false);
   if (rv == 0) {
     // BufferedWriterSingleLog will release memory budget after append is done.
     release_memory_on_fail.dismiss();
   } else {
     // Failed to queue the append.  Return the payload to the caller.
     append_sink_->onBytesSentToWorker(-payload_size);
-    BufferedAppendRequest* rawreq =
-        static_cast<BufferedAppendRequest*>(req.get());
-    chunk = rawreq->releaseChunk();
     ld_check(chunk.size() == 1);
     payload = std::move(chunk.front().payload);
     attrs = std::move(chunk.front().attrs);
@@ -486,18 +579,16 @@ int BufferedWriterImpl::appendAtomic(logid_t log_id,
     chunks.emplace_back(std::move(append));
   }
 
-  std::unique_ptr<Request> req = std::make_unique<BufferedAppendRequest>(
-      worker_id_t(shard), shards_[shard], std::move(chunks), true);
   append_sink_->onBytesSentToWorker(append_sizes);
-  int rv = processor()->postRequest(req);
+  int rv = stageAppends(shard, chunks, /* atomic */ true);
   if (rv != 0) {
     // Failed to queue the append.  Return the payload to the caller.
     append_sink_->onBytesSentToWorker(-append_sizes);
-    BufferedAppendRequest* rawreq =
-        static_cast<BufferedAppendRequest*>(req.get());
-    chunks = rawreq->releaseChunk();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      input_appends[i] = std::move(chunks[i]);
+    }
     STAT_ADD(stats_, buffered_append_failed_post_request, input_appends.size());
-    // err set by postRequest
+    // err set by stageAppends()
     return -1;
   }
 
@@ -573,22 +664,16 @@ BufferedWriterImpl::appendImpl(std::vector<Append>&& input_appends,
       continue;
     }
 
-    // Post a BufferedAppendRequest to process this shard's chunk on the
-    // appropriate Worker.
-    std::unique_ptr<Request> req = std::make_unique<BufferedAppendRequest>(
-        worker_id_t(i), shards_[i], std::move(chunks[i]), atomic);
+    // Stage this shard's chunk for the appropriate Worker.
     append_sink_->onBytesSentToWorker(shard_bytes);
-    int rv = processor()->postRequest(req);
+    int rv = stageAppends(i, chunks[i], atomic);
     if (rv == 0) {
       chunk_status[i] = E::OK;
     } else {
-      // Failure!  Take the chunk back so that we can restore payloads in the
-      // input vector for all affected appends.
+      // Failure!  stageAppends() gave the chunk back so that we can restore
+      // payloads in the input vector for all affected appends.
       chunk_status[i] = err;
       ld_check(chunk_status[i] != E::OK);
-      BufferedAppendRequest* rawreq =
-          static_cast<BufferedAppendRequest*>(req.get());
-      chunks[i] = rawreq->releaseChunk();
       // Rewinding the counters.
       append_sink_->onBytesSentToWorker(-shard_bytes);
       STAT_ADD(
@@ -634,6 +719,9 @@ class FlushShardRequest : public Request {
     Worker* w = Worker::onThisThread();
     auto it = w->active_buffered_writers_.find(writer_id_);
     if (it != w->active_buffered_writers_.end()) {
+      // Flush appends staged before flushAll() was called too, even if their
+      // drain is still queued behind this request.
+      it->second->parent_->drainStagedAppends(worker_.val_, it->second);
       it->second->flushAll();
     }
     return Execution::COMPLETE;
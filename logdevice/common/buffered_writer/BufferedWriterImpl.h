@@ -8,9 +8,12 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 
+#include <folly/Optional.h>
 #include <folly/Preprocessor.h>
+#include <folly/small_vector.h>
 
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
@@ -22,10 +25,12 @@ class StreamWriterTest;
 
 namespace facebook { namespace logdevice {
 
+class BufferedWriterShard;
 class Client;
 class PayloadHolder;
 class Processor;
 class Request;
+class StagedAppends;
 
 // Abstract interface for BufferedWriter to sink appends when batches are
 // formed.  It needs to outlive the BufferedWriter instance.
@@ -72,6 +77,18 @@ class BufferedWriterAppendSink {
    */
   virtual void onBytesFreedByWorker(size_t /*bytes*/) {}
 
+  /**
+   * Returns true if enough earlier batches for the log are still waiting to
+   * be appended that sending another one now would only queue it behind
+   * them. BufferedWriter then keeps growing the batch it is building (up to
+   * the maximum payload size) instead of flushing it on the time or size
+   * trigger. Called on the Worker the log's batches are sent from.
+   * Overridden in StreamWriterAppendSink
+   */
+  virtual bool isBacklogged(logid_t /*logid*/) {
+    return false;
+  }
+
   /**
    * `checksum_bits' says how many of the first bits are the checksum,
    * prepended to the payload because BufferedWriterImpl::prependChecksums()
@@ -318,6 +335,20 @@ class BufferedWriterImpl : public BufferedWriter {
     return prepend_checksums_;
   }
 
+  /**
+   * If called, the time trigger of every log is `trigger` instead of
+   * LogOptions::time_trigger, which only has millisecond granularity.  Used
+   * by ClientImpl to coalesce appends within a sub-millisecond window.  Must
+   * be called before the first append().
+   */
+  void setTimeTriggerOverride(std::chrono::microseconds trigger) {
+    time_trigger_override_ = trigger;
+  }
+
+  folly::Optional<std::chrono::microseconds> getTimeTriggerOverride() const {
+    return time_trigger_override_;
+  }
+
   bool isShuttingDown() const {
     return shutting_down_.load();
   }
@@ -330,9 +361,25 @@ class BufferedWriterImpl : public BufferedWriter {
     return num_background_tasks_.recentValue();
   }
 
+  /**
+   * Hands appends staged for the shard by application threads over to
+   * `shard`.  Must be called on the shard's worker.
+   */
+  void drainStagedAppends(int shard_idx, BufferedWriterShard* shard);
+
  private:
   int mapLogToShardIndex(logid_t) const;
 
+  // Stages a chunk of appends for the shard's worker.  The first chunk staged
+  // after a drain posts a request for the worker to drain them, so under load
+  // a single request carries appends from many application threads.
+  //
+  // Returns 0 on success.  Only fails if the Processor is shutting down; then
+  // sets err and moves the appends back into `chunk`.
+  int stageAppends(int shard_idx,
+                   folly::small_vector<BufferedWriter::Append, 4>& chunk,
+                   bool atomic);
+
   int64_t memoryForPayloadBytes(int64_t payload_bytes) const {
     // Budget 2x the payload size; 1x for the original std::string which we
     // keep around, and another 1x in the blob sent to LogDevice (which we
@@ -364,9 +411,13 @@ class BufferedWriterImpl : public BufferedWriter {
   WaitableCounter num_background_tasks_;
   uint64_t hash_salt_;
   bool prepend_checksums_ = false;
+  folly::Optional<std::chrono::microseconds> time_trigger_override_;
   // This will have exactly one entry for each Worker in the Processor's
   // thread pool.
   std::vector<buffered_writer_id_t> shards_;
+  // Appends waiting for each shard's worker to pick them up, same indexing as
+  // shards_.
+  std::vector<std::unique_ptr<StagedAppends>> staged_;
 
   // Memory available in bytes, applies if Options::memory_limit_mb is set.
   // This will be modified from multiple threads in a ticket-dispenser
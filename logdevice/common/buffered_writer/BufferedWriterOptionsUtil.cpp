@@ -8,6 +8,7 @@
 #include "logdevice/common/buffered_writer/BufferedWriterOptionsUtil.h"
 
 #include <boost/program_options.hpp>
+#include <folly/FileUtil.h>
 
 #include "logdevice/common/commandline_util_chrono.h"
 
@@ -18,7 +19,7 @@ namespace facebook { namespace logdevice {
 void describeBufferedWriterOptions(options_description& po,
                                    BufferedWriter::Options* opts,
                                    std::string prefix) {
-  static_assert(sizeof(BufferedWriter::Options) == 7 * 8,
+  static_assert(sizeof(BufferedWriter::Options) == 9 * 8,
                 "If you added fields to BufferedWriter::Options, you may want "
                 "to add them here as well.");
 
@@ -86,6 +87,22 @@ void describeBufferedWriterOptions(options_description& po,
           }),
       "Algorithm to use for client-side compression in Buffered writer. 'none' "
       "for no compression. Supported values: 'zstd', 'lz4', 'lz4_hc'.");
+  po.add_options()(
+      (prefix + "zstd-dictionary").c_str(),
+      value<std::string>()->notifier([prefix, opts](const std::string& path) {
+        if (path.empty()) {
+          opts->zstd_dictionary.reset();
+          return;
+        }
+        auto dict = std::make_shared<std::string>();
+        if (!folly::readFile(path.c_str(), *dict)) {
+          throw boost::program_options::error(
+              "Failed to read " + prefix + "zstd-dictionary file: " + path);
+        }
+        opts->zstd_dictionary = std::move(dict);
+      }),
+      "Path to a zstd dictionary (e.g. trained with `zstd --train`) to "
+      "compress batches with when compression is 'zstd'.");
   po.add_options()((prefix + "memory-limit-mb").c_str(),
                    value<int32_t>(&opts->memory_limit_mb)
                        ->default_value(opts->memory_limit_mb),
@@ -8,6 +8,7 @@
 #include "logdevice/common/buffered_writer/BufferedWriterSingleLog.h"
 
 #include <chrono>
+#include <memory>
 #include <lz4.h>
 #include <lz4hc.h>
 #include <zstd.h>
@@ -27,6 +28,7 @@
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterShard.h"
+#include "logdevice/common/buffered_writer/ZstdDictionary.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
 
@@ -201,6 +203,12 @@ void BufferedWriterSingleLog::flushMeMaybe(bool defer_client_size_trigger) {
   // buffered exceeds it
   if (!defer_client_size_trigger && options_.size_trigger >= 0 &&
       batch.payload_bytes_total >= options_.size_trigger) {
+    if (parent_->parent_->appendSink()->isBacklogged(log_id_)) {
+      // Write-ahead batching: the batch keeps growing until the sink catches
+      // up. The next append checks again.
+      STAT_INCR(w->getStats(), buffered_writer_backlog_deferred_flush);
+      return;
+    }
     STAT_INCR(w->getStats(), buffered_writer_size_trigger_flush);
     flushBuildingBatch();
     return;
@@ -490,19 +498,30 @@ void BufferedWriterSingleLog::dropBlockedAppends(Status status,
 }
 
 void BufferedWriterSingleLog::activateTimeTrigger() {
-  if (options_.time_trigger.count() < 0) {
+  const auto time_trigger =
+      parent_->parent_->getTimeTriggerOverride().value_or(
+          options_.time_trigger);
+  if (time_trigger.count() < 0) {
     return;
   }
 
   if (!time_trigger_timer_) {
     time_trigger_timer_ = std::make_unique<Timer>([this] {
       StatsHolder* stats{parent_->parent_->processor()->stats_};
+      if (haveBuildingBatch() &&
+          parent_->parent_->appendSink()->isBacklogged(log_id_)) {
+        // Check again after another period instead of sending the batch
+        // behind the backlog.
+        STAT_INCR(stats, buffered_writer_backlog_deferred_flush);
+        activateTimeTrigger();
+        return;
+      }
       STAT_INCR(stats, buffered_writer_time_trigger_flush);
       flushAll();
     });
   }
   if (!time_trigger_timer_->isActive()) {
-    time_trigger_timer_->activate(options_.time_trigger);
+    time_trigger_timer_->activate(time_trigger);
   }
 }
 
@@ -666,11 +685,72 @@ void BufferedWriterSingleLog::Impl::construct_uncompressed_blob(
   batch.blob = std::move(blob_buf);
 }
 
+namespace {
+
+// Inputs smaller than this are compressed by a single thread even if
+// buffered-writer-zstd-workers is set: they wouldn't be split into several
+// zstd jobs anyway.
+constexpr size_t kZstdMultithreadMinBytes = 1024 * 1024;
+
+// Compresses `src` with ZSTD into a regular zstd frame.  If `workers` is
+// positive and `src` is large, zstd splits it into jobs compressed in parallel
+// by `workers` threads.  The output format is the same either way, so the
+// read path doesn't need to know.  With a dictionary, the frame carries the
+// dictionary ID, which the read path uses to find it.
+size_t zstd_compress(void* dst,
+                     size_t dst_capacity,
+                     const Slice& src,
+                     int level,
+                     int workers,
+                     const ZstdDictionary* dict) {
+  if (dict) {
+    const ZSTD_CDict* cdict = dict->getCDict(level);
+    static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)>
+        dict_cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    if (cdict && dict_cctx) {
+      return ZSTD_compress_usingCDict(
+          dict_cctx.get(), dst, dst_capacity, src.data, src.size, cdict);
+    }
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Failed to prepare zstd dictionary %u for level %d, "
+                    "compressing without it",
+                    dict->getID(),
+                    level);
+  }
+#if ZSTD_VERSION_NUMBER >= 10400
+  if (workers > 0 && src.size >= kZstdMultithreadMinBytes) {
+    // The context owns zstd's worker threads, keep one per compressing thread
+    // so that they are reused across batches.
+    static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)>
+        cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    static thread_local int cctx_workers = 0;
+    if (cctx && cctx_workers != workers &&
+        !ZSTD_isError(
+            ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_nbWorkers, workers))) {
+      cctx_workers = workers;
+    }
+    // If setting the number of workers failed, libzstd was built without
+    // multithreading support.
+    if (cctx && cctx_workers == workers &&
+        !ZSTD_isError(ZSTD_CCtx_setParameter(
+            cctx.get(), ZSTD_c_compressionLevel, level))) {
+      return ZSTD_compress2(cctx.get(), dst, dst_capacity, src.data, src.size);
+    }
+  }
+#endif
+  return ZSTD_compress(dst, dst_capacity, src.data, src.size, level);
+}
+
+} // namespace
+
 void BufferedWriterSingleLog::Impl::maybe_compress_blob(
     BufferedWriterSingleLog::Batch& batch,
     Compression compression,
     int checksum_bits,
-    const int zstd_level) {
+    const int zstd_level,
+    const int zstd_workers,
+    const ZstdDictionary* zstd_dict) {
   if (compression == Compression::NONE) {
     // Nothing to do.
     return;
@@ -708,11 +788,13 @@ void BufferedWriterSingleLog::Impl::maybe_compress_blob(
 
   size_t compressed_size;
   if (compression == Compression::ZSTD) {
-    compressed_size = ZSTD_compress(out,              // dst
-                                    end - out,        // dstCapacity
-                                    to_compress.data, // src
-                                    to_compress.size, // srcSize
-                                    zstd_level);      // level
+    compressed_size =
+        zstd_compress(out,
+                      end - out,
+                      to_compress,
+                      zstd_level,
+                      zstd_workers,
+                      zstd_dict);
     if (ZSTD_isError(compressed_size)) {
       ld_critical(
           "ZSTD_compress() failed: %s", ZSTD_getErrorName(compressed_size));
@@ -752,14 +834,18 @@ void BufferedWriterSingleLog::Impl::construct_blob_long_running(
     batch_flags_t flags,
     int checksum_bits,
     bool destroy_payloads,
-    const int zstd_level) {
+    const int zstd_level,
+    const int zstd_workers,
+    const ZstdDictionary* zstd_dict) {
   ld_check(batch.state == Batch::State::CONSTRUCTING_BLOB);
 
   construct_uncompressed_blob(batch, flags, checksum_bits, destroy_payloads);
   maybe_compress_blob(batch,
                       (Compression)(flags & Flags::COMPRESSION_MASK),
                       checksum_bits,
-                      zstd_level);
+                      zstd_level,
+                      zstd_workers,
+                      zstd_dict);
 
   if (checksum_bits > 0) {
     // construct_uncompressed_blob() left this many bytes at the front to put
@@ -786,6 +872,14 @@ void BufferedWriterSingleLog::construct_blob(
   }
 
   const int zstd_level = Worker::settings().buffered_writer_zstd_level;
+  const int zstd_workers = Worker::settings().buffered_writer_zstd_workers;
+  // Registering the dictionary also makes it known to readers in this
+  // process.
+  std::shared_ptr<const ZstdDictionary> zstd_dict;
+  if (options_.compression == Compression::ZSTD && options_.zstd_dictionary) {
+    zstd_dict =
+        ZstdDictionaryRegistry::get().getOrAdd(options_.zstd_dictionary);
+  }
 
   // We need to call construct_blob_long_running(), then callback().  If the
   // batch is large, we send it to a background thread so that this thread can
@@ -794,8 +888,13 @@ void BufferedWriterSingleLog::construct_blob(
 
   if (batch.blob_bytes_total <
       Worker::settings().buffered_writer_bg_thread_bytes_threshold) {
-    Impl::construct_blob_long_running(
-        batch, flags, checksum_bits, destroy_payloads, zstd_level);
+    Impl::construct_blob_long_running(batch,
+                                      flags,
+                                      checksum_bits,
+                                      destroy_payloads,
+                                      zstd_level,
+                                      zstd_workers,
+                                      zstd_dict.get());
     readyToSend(batch);
   } else {
     ProcessorProxy* processor_proxy = parent_->parent_->processorProxy();
@@ -815,9 +914,17 @@ void BufferedWriterSingleLog::construct_blob(
          trigger = parent_->parent_->getBackgroundTaskCountHolder(),
          thread_affinity = Worker::onThisThread()->idx_.val(),
          zstd_level,
+         zstd_workers,
+         zstd_dict,
          this]() mutable {
           BufferedWriterSingleLog::Impl::construct_blob_long_running(
-              batch, flags, checksum_bits, destroy_payloads, zstd_level);
+              batch,
+              flags,
+              checksum_bits,
+              destroy_payloads,
+              zstd_level,
+              zstd_workers,
+              zstd_dict.get());
           std::unique_ptr<Request> request =
               std::make_unique<ContinueBlobSendRequest>(
                   this, batch, thread_affinity);
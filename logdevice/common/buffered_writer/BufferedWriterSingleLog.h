@@ -47,6 +47,7 @@ class ExponentialBackoffTimer;
 class Timer;
 class StatsHolder;
 class Processor;
+class ZstdDictionary;
 
 using GetLogOptionsFunc = std::function<BufferedWriter::LogOptions(logid_t)>;
 
@@ -162,15 +163,21 @@ class BufferedWriterSingleLog {
                                 BufferedWriteDecoderImpl::flags_t flags,
                                 int checksum_bits,
                                 bool destroy_payloads,
-                                int zstd_level);
+                                int zstd_level,
+                                int zstd_workers = 0,
+                                const ZstdDictionary* zstd_dict = nullptr);
 
     // Possibly long running.  Checks conditions for compression, and if
-    // satisfied, compresses.
+    // satisfied, compresses.  Large blobs are compressed with ZSTD in
+    // parallel by `zstd_workers` threads if positive.  If `zstd_dict` is
+    // given, ZSTD compression uses it instead (single-threaded).
     static void
     maybe_compress_blob(Batch& batch,
                         BufferedWriter::Options::Compression compression,
                         int checksum_bits,
-                        int zstd_level);
+                        int zstd_level,
+                        int zstd_workers = 0,
+                        const ZstdDictionary* zstd_dict = nullptr);
     // Constructs a blob from a batch.  Copies the data, so is therefore
     // potentially long running.
     static void
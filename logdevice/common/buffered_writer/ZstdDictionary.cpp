@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/buffered_writer/ZstdDictionary.h"
+
+#include <zstd.h>
+#include <folly/String.h>
+
+#include "logdevice/common/checks.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+// Dictionary header: 4 bytes of magic number followed by the 4 byte ID.
+static constexpr size_t kDictHeaderSize = 8;
+
+ZstdDictionary::ZstdDictionary(std::shared_ptr<const std::string> data,
+                               uint32_t id,
+                               ZSTD_DDict* ddict)
+    : data_(std::move(data)), id_(id), ddict_(ddict) {}
+
+ZstdDictionary::~ZstdDictionary() {
+  for (auto& kv : cdicts_) {
+    ZSTD_freeCDict(kv.second);
+  }
+  ZSTD_freeDDict(ddict_);
+}
+
+std::shared_ptr<const ZstdDictionary>
+ZstdDictionary::create(std::shared_ptr<const std::string> data) {
+  ld_check(data);
+  const uint32_t id = peekID(*data);
+  if (id == 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Invalid zstd dictionary of size %zu: no dictionary ID",
+                    data->size());
+    return nullptr;
+  }
+  ZSTD_DDict* ddict = ZSTD_createDDict(data->data(), data->size());
+  if (ddict == nullptr) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Failed to digest zstd dictionary %u of size %zu",
+                    id,
+                    data->size());
+    return nullptr;
+  }
+  return std::shared_ptr<const ZstdDictionary>(
+      new ZstdDictionary(std::move(data), id, ddict));
+}
+
+uint32_t ZstdDictionary::peekID(const std::string& data) {
+  return ZSTD_getDictID_fromDict(data.data(), data.size());
+}
+
+const ZSTD_CDict* ZstdDictionary::getCDict(int level) const {
+  std::lock_guard<std::mutex> lock(cdicts_mutex_);
+  auto it = cdicts_.find(level);
+  if (it != cdicts_.end()) {
+    return it->second;
+  }
+  ZSTD_CDict* cdict = ZSTD_createCDict(data_->data(), data_->size(), level);
+  if (cdict != nullptr) {
+    cdicts_[level] = cdict;
+  }
+  return cdict;
+}
+
+ZstdDictionaryRegistry& ZstdDictionaryRegistry::get() {
+  static ZstdDictionaryRegistry registry;
+  return registry;
+}
+
+std::shared_ptr<const ZstdDictionary> ZstdDictionaryRegistry::getOrAdd(
+    const std::shared_ptr<const std::string>& data) {
+  ld_check(data);
+  const uint32_t id = ZstdDictionary::peekID(*data);
+  {
+    auto dicts = dicts_.rlock();
+    auto it = dicts->find(id);
+    if (it != dicts->end() &&
+        (it->second->getData() == data || *it->second->getData() == *data)) {
+      return it->second;
+    }
+  }
+
+  auto dict = ZstdDictionary::create(data);
+  if (!dict) {
+    return nullptr;
+  }
+  auto dicts = dicts_.wlock();
+  auto& entry = (*dicts)[id];
+  if (entry && *entry->getData() != *data) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      1,
+                      "Replacing zstd dictionary %u with a different one of "
+                      "the same ID. Batches compressed with the old one will "
+                      "fail to decode.",
+                      id);
+    entry = std::move(dict);
+  } else if (!entry) {
+    entry = std::move(dict);
+  }
+  return entry;
+}
+
+std::shared_ptr<const ZstdDictionary>
+ZstdDictionaryRegistry::getOrAddHex(const std::string& hex) {
+  // Avoid decoding the whole dictionary when it's already registered: the ID
+  // is in the header. Trained dictionaries get random IDs, so matching the ID
+  // and size is good enough here.
+  if (hex.size() >= kDictHeaderSize * 2) {
+    std::string header;
+    if (folly::unhexlify(hex.substr(0, kDictHeaderSize * 2), header)) {
+      const uint32_t id = ZSTD_getDictID_fromDict(header.data(), header.size());
+      auto dict = find(id);
+      if (dict && dict->getData()->size() * 2 == hex.size()) {
+        return dict;
+      }
+    }
+  }
+
+  auto data = std::make_shared<std::string>();
+  if (!folly::unhexlify(hex, *data)) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "zstd dictionary is not a valid hex string");
+    return nullptr;
+  }
+  return getOrAdd(data);
+}
+
+std::shared_ptr<const ZstdDictionary>
+ZstdDictionaryRegistry::find(uint32_t id) const {
+  if (id == 0) {
+    return nullptr;
+  }
+  auto dicts = dicts_.rlock();
+  auto it = dicts->find(id);
+  return it == dicts->end() ? nullptr : it->second;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  A zstd dictionary that BufferedWriter can compress batches with.
+ *        Batches of small, similar records compress much better with a
+ *        dictionary trained on a sample of them (e.g. with `zstd --train`)
+ *        than on their own.
+ *
+ *        The dictionary ID is stored in every zstd frame, so compressed
+ *        batches don't need a separate format flag; BufferedWriteDecoder
+ *        looks the dictionary up by ID in ZstdDictionaryRegistry.
+ */
+
+// Log group extra attribute holding a hex encoded zstd dictionary for
+// sequencer batching of the group's logs.
+constexpr const char* kZstdDictionaryAttribute = "zstd_dictionary";
+
+class ZstdDictionary {
+ public:
+  /**
+   * Digests a dictionary. Returns nullptr if `data` is not a zstd dictionary
+   * (raw content dictionaries have no ID and can't be looked up by readers).
+   */
+  static std::shared_ptr<const ZstdDictionary>
+  create(std::shared_ptr<const std::string> data);
+
+  ~ZstdDictionary();
+
+  uint32_t getID() const {
+    return id_;
+  }
+
+  const std::shared_ptr<const std::string>& getData() const {
+    return data_;
+  }
+
+  /**
+   * Digested dictionary for compressing at `level`, created on first use.
+   */
+  const ZSTD_CDict_s* getCDict(int level) const;
+
+  const ZSTD_DDict_s* getDDict() const {
+    return ddict_;
+  }
+
+  /**
+   * Reads the dictionary ID from the header of a serialized dictionary
+   * without digesting it. Returns 0 if it doesn't have one.
+   */
+  static uint32_t peekID(const std::string& data);
+
+ private:
+  ZstdDictionary(std::shared_ptr<const std::string> data,
+                 uint32_t id,
+                 ZSTD_DDict_s* ddict);
+
+  const std::shared_ptr<const std::string> data_;
+  const uint32_t id_;
+  ZSTD_DDict_s* const ddict_;
+
+  mutable std::mutex cdicts_mutex_;
+  mutable folly::F14FastMap<int, ZSTD_CDict_s*> cdicts_;
+};
+
+/**
+ * Process-wide set of known dictionaries, by ID. Dictionaries used by
+ * BufferedWriters in this process are added automatically; readers in other
+ * processes add them with BufferedWriteDecoder::addZstdDictionary().
+ * Dictionaries are never removed, they are expected to be few and rarely
+ * changed.
+ */
+class ZstdDictionaryRegistry {
+ public:
+  static ZstdDictionaryRegistry& get();
+
+  /**
+   * Returns the registered dictionary with the same ID and contents as
+   * `data`, digesting and registering it if needed. Cheap when it's already
+   * registered. Returns nullptr if `data` is not a valid dictionary.
+   */
+  std::shared_ptr<const ZstdDictionary>
+  getOrAdd(const std::shared_ptr<const std::string>& data);
+
+  /**
+   * Like getOrAdd() for a hex encoded dictionary, as stored in the
+   * kZstdDictionaryAttribute extra attribute of log groups.
+   */
+  std::shared_ptr<const ZstdDictionary> getOrAddHex(const std::string& hex);
+
+  std::shared_ptr<const ZstdDictionary> find(uint32_t id) const;
+
+ private:
+  folly::Synchronized<
+      folly::F14FastMap<uint32_t, std::shared_ptr<const ZstdDictionary>>>
+      dicts_;
+};
+
+}} // namespace facebook::logdevice
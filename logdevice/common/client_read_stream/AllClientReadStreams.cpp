@@ -127,9 +127,21 @@ void AllClientReadStreams::noteSettingsUpdated() {
 }
 
 void AllClientReadStreams::onShardStatusChanged() {
+  // Only read streams that read from a shard whose status changed need to
+  // look at the new map.
+  Worker* w = Worker::onThisThread(false);
+  folly::Optional<std::vector<ShardID>> changed_shards;
+  if (w) {
+    changed_shards = w->shardStatusManager().getChangedShards();
+  }
+
   // onShardStatusChanged() may delete some ClientReadStream instances but
   // forEachStream makes that safe.
-  forEachStream([](ClientReadStream& read_stream) {
+  forEachStream([&](ClientReadStream& read_stream) {
+    if (changed_shards.hasValue() &&
+        !read_stream.readsFromAnyOf(changed_shards.value())) {
+      return;
+    }
     read_stream.applyShardStatus("onShardStatusChanged");
   });
 }
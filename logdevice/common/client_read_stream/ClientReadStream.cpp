@@ -26,6 +26,7 @@
 #include "logdevice/common/ClientStalledReadTracer.h"
 #include "logdevice/common/ClusterState.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/E2ETracer.h"
 #include "logdevice/common/EpochMetaDataCache.h"
 #include "logdevice/common/EpochMetaDataUpdater.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
@@ -48,6 +49,7 @@
 #include "logdevice/common/nodeset_selection/NodeSetSelectorFactory.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/include/Record.h"
@@ -1122,7 +1124,11 @@ void ClientReadStream::onDataRecord(
     if (!rstate->record) {
       rstate->record = std::move(record);
       // Updating info reg. buffer usage.
-      bytes_buffered_ += rstate->record->payload.size();
+      const size_t payload_size = rstate->record->payload.size();
+      adjustBytesBuffered(payload_size);
+      avg_record_bytes_ = avg_record_bytes_ == 0
+          ? payload_size
+          : (avg_record_bytes_ * 7 + payload_size) / 8;
     }
     // This shard won't send us anything before `lsn'+1.
     // Use that information for gap detection.
@@ -3125,7 +3131,7 @@ int ClientReadStream::handleRecord(RecordState* rstate,
 
   // Free the record and advance to next LSN.
   ++next_lsn_to_deliver_;
-  rstate->reset();
+  resetRecordState(*rstate);
   buffer_->popFront();
   buffer_->advanceBufferHead();
   ld_check(next_lsn_to_deliver_ == buffer_->getBufferHead());
@@ -3247,6 +3253,9 @@ int ClientReadStream::deliverRecord(
   last_in_record_ts_ = record->attrs.timestamp;
   last_received_ts_ = std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::system_clock::now().time_since_epoch());
+  const auto backlog_age = deps_->getSettings().client_read_backlog_age;
+  backlog_ = backlog_age.count() > 0 &&
+      last_received_ts_ - last_in_record_ts_ > backlog_age;
 
   OffsetMap current_offsets = OffsetMap::fromRecord(record->attrs.offsets);
   OffsetMap payload_size_map;
@@ -3357,7 +3366,7 @@ int ClientReadStream::deliverRecord(
     num_records_delivered_++;
     num_bytes_delivered_ += payload_size_map.getCounter(BYTE_OFFSET);
     // Updating info reg. buffer usage.
-    bytes_buffered_ -= payload_size_map.getCounter(BYTE_OFFSET);
+    adjustBytesBuffered(-int64_t(payload_size_map.getCounter(BYTE_OFFSET)));
     if (current_offsets.isValid()) {
       accumulated_offsets_ = std::move(current_offsets);
     }
@@ -3622,7 +3631,10 @@ size_t ClientReadStream::numShardsNotFullyAuthoritative() const {
 void ClientReadStream::calcNextLSNToSlideWindow() {
   // NOTE: this bound is exclusive; we'll slide the window *after* delivering
   // `next_lsn_to_deliver_' to the application
-  size_t delta = flow_control_threshold_ * (window_size_ - 1);
+  const double threshold = backlog_
+      ? deps_->getSettings().client_read_backlog_flow_control_threshold
+      : flow_control_threshold_;
+  size_t delta = threshold * (window_size_ - 1);
   delta = std::min(delta, LSN_MAX - next_lsn_to_deliver_);
   next_lsn_to_slide_window_ = next_lsn_to_deliver_ + delta;
 
@@ -3654,13 +3666,23 @@ void ClientReadStream::updateServerWindow() {
 }
 
 void ClientReadStream::updateWindowSize() {
+  // The window can't be larger than what the buffer can hold, nor than what
+  // --client-read-buffer-bytes can hold given the average record size.
+  size_t max_window_size = buffer_->capacity();
+  const size_t max_bytes = deps_->getSettings().client_read_buffer_bytes;
+  if (max_bytes > 0 && avg_record_bytes_ > 0) {
+    max_window_size = std::max(
+        size_t(1), std::min(max_window_size, max_bytes / avg_record_bytes_));
+  }
+
   if (deps_->hasMemoryPressure()) {
     // cut the window size in half
     window_size_ = std::max(size_t(1), window_size_ / 2);
   } else {
-    // increment window size but not more than what the buffer can hold
-    window_size_ = std::min(buffer_->capacity(), window_size_ + 1);
+    // increment window size but not more than the maximum
+    window_size_ = window_size_ + 1;
   }
+  window_size_ = std::min(max_window_size, window_size_);
 }
 
 bool ClientReadStream::slideSenderWindows() {
@@ -3870,6 +3892,7 @@ ClientReadStream::~ClientReadStream() {
     }
   }
   storage_set_states_.clear();
+  adjustBytesBuffered(-int64_t(bytes_buffered_));
 }
 
 // Used in tests only.
@@ -4116,6 +4139,7 @@ void ClientReadStream::rewind(std::string reason) {
 
   // clear the entire read stream buffer
   buffer_->clear();
+  adjustBytesBuffered(-int64_t(bytes_buffered_));
 
   gap_end_outside_window_ = LSN_INVALID;
 
@@ -4331,6 +4355,23 @@ size_t ClientReadStream::getBytesBuffered() const {
   return bytes_buffered_;
 }
 
+void ClientReadStream::resetRecordState(RecordState& rstate) {
+  if (rstate.record) {
+    // The record is dropped without being delivered.
+    adjustBytesBuffered(-int64_t(rstate.record->payload.size()));
+  }
+  rstate.reset();
+}
+
+void ClientReadStream::adjustBytesBuffered(int64_t delta) {
+  if (delta == 0) {
+    return;
+  }
+  ld_check(delta > 0 || size_t(-delta) <= bytes_buffered_);
+  bytes_buffered_ += delta;
+  deps_->onBytesBufferedChanged(delta);
+}
+
 //
 // Production implementations of ClientReadStreamDependencies methods
 //
@@ -4340,8 +4381,21 @@ ClientReadStreamDependencies::ClientReadStreamDependencies() = default;
 ClientReadStreamDependencies::~ClientReadStreamDependencies() {}
 
 bool ClientReadStreamDependencies::hasMemoryPressure() const {
-  // TODO(T6159466): implement memory limits/accounting
-  return false;
+  auto w = Worker::onThisThread(/*enforce=*/false);
+  if (!w) {
+    return false;
+  }
+  const size_t limit = w->settings().client_read_buffers_memory_limit;
+  return limit > 0 &&
+      w->processor_->getClientReadStreamsBytesBuffered() > limit;
+}
+
+void ClientReadStreamDependencies::onBytesBufferedChanged(int64_t delta) {
+  auto w = Worker::onThisThread(/*enforce=*/false);
+  if (w) {
+    w->processor_->noteClientReadStreamsBytesBuffered(delta);
+    WORKER_STAT_ADD(client_read_streams_bytes_buffered, delta);
+  }
 }
 
 bool ClientReadStreamDependencies::isWorkerOverloaded() const {
@@ -4361,9 +4415,28 @@ bool ClientReadStreamDependencies::getMetaDataForEpoch(
     MetaDataLogReader::Callback cb,
     bool allow_from_cache,
     bool require_consistent_from_cache) {
+  return getMetaDataForEpochImpl(rsid,
+                                 epoch,
+                                 std::move(cb),
+                                 allow_from_cache,
+                                 require_consistent_from_cache,
+                                 /*join_pending_read=*/true);
+}
+
+bool ClientReadStreamDependencies::getMetaDataForEpochImpl(
+    read_stream_id_t rsid,
+    epoch_t epoch,
+    MetaDataLogReader::Callback cb,
+    bool allow_from_cache,
+    bool require_consistent_from_cache,
+    bool join_pending_read) {
   Worker* w = Worker::onThisThread();
   ld_check(w);
 
+  // Supersedes any previous request that is waiting for another read stream's
+  // read, see below.
+  const uint64_t request_id = ++metadata_request_id_;
+
   // If the read stream is used to read a metadata log, simply return its
   // meta storage set and replication factor from the Configuration. Such
   // information will never change and it is safe to set the until_ epoch
@@ -4467,6 +4540,48 @@ bool ClientReadStreamDependencies::getMetaDataForEpoch(
                       rsid.val_);
     nodeset_finder_.reset();
   }
+  pending_read_.reset();
+
+  if (allow_from_cache && metadata_cache_ != nullptr && join_pending_read) {
+    // If another read stream of this client is already reading the metadata
+    // for this epoch, wait for it to complete and look up the cache again
+    // instead of reading the metadata log too. That's common when an
+    // application starts many readers on the same log at once.
+    auto wake_up = [ref = holder_.ref(),
+                    processor = w->processor_,
+                    worker_idx = w->idx_,
+                    worker_type = w->worker_type_,
+                    request_id,
+                    rsid,
+                    epoch,
+                    cb,
+                    require_consistent_from_cache]() {
+      std::unique_ptr<Request> rq = FuncRequest::make(
+          worker_idx,
+          worker_type,
+          RequestType::EPOCH_METADATA_READ_JOINED,
+          [ref, request_id, rsid, epoch, cb, require_consistent_from_cache] {
+            ClientReadStreamDependencies* deps = ref.get();
+            if (deps && deps->metadata_request_id_ == request_id) {
+              deps->getMetaDataForEpochImpl(rsid,
+                                            epoch,
+                                            cb,
+                                            /*allow_from_cache=*/true,
+                                            require_consistent_from_cache,
+                                            /*join_pending_read=*/false);
+            }
+          });
+      // Can only fail if the processor is shutting down, and the read stream
+      // with it.
+      processor->postImportant(rq);
+    };
+    pending_read_ =
+        metadata_cache_->startOrJoinRead(log_id_, epoch, std::move(wake_up));
+    if (!pending_read_) {
+      WORKER_STAT_INCR(epoch_metadata_reads_joined);
+      return false;
+    }
+  }
 
   // a callback object which essentially wraps the ClientReadStream callback
   // passed in.
@@ -4544,6 +4659,9 @@ bool ClientReadStreamDependencies::getMetaDataForEpoch(
     // ASAN failures. It will be destroyed after the callback returned.
     std::unique_ptr<NodeSetFinder> nf;
     nodeset_finder_.swap(nf);
+    // Read streams that joined this read are woken up after cb() has put the
+    // result in the cache.
+    auto pending_read = std::move(pending_read_);
     cb(st, std::move(result));
   };
 
@@ -4583,9 +4701,16 @@ int ClientReadStreamDependencies::sendStartMessage(
   // Fill in the boilerplate fields
   header.log_id = log_id_;
   header.read_stream_id = read_stream_id_;
+  if (!e2e_trace_id_.has_value()) {
+    e2e_trace_id_ = E2ETracer(w->getTraceLogger()).startTrace();
+  }
+  if (e2e_trace_id_.value() != E2E_TRACE_ID_INVALID) {
+    header.flags |= START_Header::E2E_TRACING_ON;
+  }
 
   auto msg = std::make_unique<START_Message>(
       header, filtered_out, attrs, client_session_id_);
+  msg->e2e_trace_id_ = e2e_trace_id_.value();
   return w->sender().sendMessage(std::move(msg), shard.asNodeID(), onclose);
 }
 
@@ -14,9 +14,11 @@
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
+#include <folly/container/F14Map.h>
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/EpochMetaDataCache.h"
 #include "logdevice/common/ExponentialBackoffAdaptiveVariable.h"
 #include "logdevice/common/FailureDomainNodeSet.h"
 #include "logdevice/common/MetaDataLogReader.h"
@@ -25,6 +27,7 @@
 #include "logdevice/common/ReadStreamAttributes.h"
 #include "logdevice/common/ShardID.h"
 #include "logdevice/common/Timer.h"
+#include "logdevice/common/WeakRefHolder.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamSenderState.h"
 #include "logdevice/common/client_read_stream/RewindScheduler.h"
 #include "logdevice/common/protocol/GAP_Message.h"
@@ -345,14 +348,24 @@ class ClientReadStreamDependencies {
 
   virtual ~ClientReadStreamDependencies();
 
+  // True if the read streams of this Processor buffer more than
+  // --client-read-buffers-memory-limit bytes. Read streams then shrink their
+  // windows.
   virtual bool hasMemoryPressure() const;
 
+  // Called when the number of bytes buffered by the read stream changes, to
+  // maintain the total that hasMemoryPressure() compares against the limit.
+  virtual void onBytesBufferedChanged(int64_t delta);
+
   virtual bool isWorkerOverloaded() const;
 
  private:
   read_stream_id_t read_stream_id_;
   logid_t log_id_;
   std::string client_session_id_;
+  // Trace id if the read stream was sampled for end-to-end tracing. Decided
+  // when the first START is sent, so that all storage shards get the same id.
+  folly::Optional<e2e_trace_id_t> e2e_trace_id_;
   std::string reader_name_;
   record_cb_t record_callback_;
   gap_cb_t gap_callback_;
@@ -377,6 +390,26 @@ class ClientReadStreamDependencies {
 
   // currently running NodeSetFinder
   std::unique_ptr<NodeSetFinder> nodeset_finder_;
+
+  // Set while nodeset_finder_ reads epoch metadata that other read streams
+  // may be waiting for, see EpochMetaDataCache::startOrJoinRead().
+  std::unique_ptr<EpochMetaDataCache::PendingRead> pending_read_;
+
+  // Incremented by every getMetaDataForEpoch() call, so that a request waiting
+  // for another read stream's read is ignored if it was superseded.
+  uint64_t metadata_request_id_{0};
+
+  WeakRefHolder<ClientReadStreamDependencies> holder_{this};
+
+  // Implements getMetaDataForEpoch(). If @param join_pending_read is false,
+  // reads the metadata after a cache miss even if another read stream is
+  // already reading it.
+  bool getMetaDataForEpochImpl(read_stream_id_t rsid,
+                               epoch_t epoch,
+                               MetaDataLogReader::Callback cb,
+                               bool allow_from_cache,
+                               bool require_consistent_from_cache,
+                               bool join_pending_read);
 };
 
 /**
@@ -672,6 +705,19 @@ class ClientReadStream : boost::noncopyable {
                         folly::Optional<SenderState*> state = folly::none,
                         bool try_make_progress = true);
 
+  /**
+   * @return true if any of `shards` is in the storage set this read stream
+   *         is currently reading from.
+   */
+  bool readsFromAnyOf(const std::vector<ShardID>& shards) const {
+    for (const ShardID& shard : shards) {
+      if (storage_set_states_.count(shard)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   /**
    * Called when the previous request of fetching epoch metadata has completed.
    * If success, epoch metadata is delivered through the function.
@@ -713,6 +759,10 @@ class ClientReadStream : boost::noncopyable {
     return current_metadata_.get();
   }
 
+  size_t getBytesDelivered() const {
+    return num_bytes_delivered_;
+  }
+
   lsn_t getNextLSNToDeliver() const {
     return next_lsn_to_deliver_;
   }
@@ -1113,9 +1163,20 @@ class ClientReadStream : boost::noncopyable {
    */
   void clearRecordState(lsn_t lsn, RecordState& rstate) {
     unlinkRecordState(lsn, rstate);
-    rstate.reset();
+    resetRecordState(rstate);
   }
 
+  /**
+   * Resets the record state, accounting for the bytes of its record if it was
+   * not delivered.
+   */
+  void resetRecordState(RecordState& rstate);
+
+  /**
+   * Adds `delta` to bytes_buffered_ and reports it to deps_.
+   */
+  void adjustBytesBuffered(int64_t delta);
+
   /**
    * @return   number of storage shards in the storage set whose GapState is
    *           st regardless of their authoritative status.
@@ -1386,9 +1447,21 @@ class ClientReadStream : boost::noncopyable {
    * is 0.5. When reading starts, we ask senders for the first 100 records.
    * After we get the first 50 (100 * 0.5) records from senders, we'll
    * slide senders' windows.
+   *
+   * While reading a backlog (see backlog_), the smaller
+   * Settings::client_read_backlog_flow_control_threshold is used instead.
    */
   double flow_control_threshold_;
 
+  /**
+   * True if the last record delivered was written more than
+   * Settings::client_read_backlog_age before it was received, i.e. the
+   * reader is catching up rather than tailing. Storage shards then always
+   * have records to send, and sliding the window earlier keeps them from
+   * running out of window while the client drains its buffer.
+   */
+  bool backlog_{false};
+
   /**
    * This member is employed to avoid doing the math every time we call
    * slideSenderWindows().
@@ -1427,8 +1500,10 @@ class ClientReadStream : boost::noncopyable {
 
   // This is the map where we keep per-server state, such as the state of the
   // connection and other goodies.  Shards appear in this map if we are trying
-  // to read from them.
-  std::unordered_map<ShardID, SenderState, ShardID::Hash> storage_set_states_;
+  // to read from them. Looked up for every record and gap received; F14 keeps
+  // probing within a cache line, and its nodes keep SenderState addresses
+  // stable.
+  folly::F14NodeMap<ShardID, SenderState, ShardID::Hash> storage_set_states_;
 
   std::unique_ptr<ClientReadStreamDependencies> deps_;
 
@@ -1629,6 +1704,10 @@ class ClientReadStream : boost::noncopyable {
   // Counter of the size (in bytes) of the current ReadStream.
   size_t bytes_buffered_{0};
 
+  // Moving average of the payload size of records received, used to bound
+  // the window to --client-read-buffer-bytes.
+  size_t avg_record_bytes_{0};
+
   /**
    * When we are in all send all mode but SCD is in use on the log, there is a
    * race condition that can cause erroneous data loss reporting. We fix this by
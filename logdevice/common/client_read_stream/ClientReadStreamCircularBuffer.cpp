@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/client_read_stream/ClientReadStreamCircularBuffer.h"
 
+#include <algorithm>
+
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
@@ -22,7 +24,9 @@ RecordState* ClientReadStreamCircularBuffer::createOrGet(lsn_t lsn) {
   if (!LSNInBuffer(lsn)) {
     return nullptr;
   }
-  return &buffer_[getIndex(lsn)];
+  const size_t index = getIndex(lsn);
+  setTouched(getPosition(index));
+  return &buffer_[index];
 }
 
 RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
@@ -30,7 +34,14 @@ RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
     return nullptr;
   }
 
-  RecordState& state = buffer_[getIndex(lsn)];
+  const size_t index = getIndex(lsn);
+  if (!isTouched(getPosition(index))) {
+    ld_check(!buffer_[index].record && !buffer_[index].gap &&
+             !buffer_[index].filtered_out);
+    return nullptr;
+  }
+
+  RecordState& state = buffer_[index];
   if (!state.record && !state.gap && !state.filtered_out) {
     // this is an empty placeholder RecordState, treat it as not
     // exist
@@ -41,6 +52,22 @@ RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
   return &state;
 }
 
+size_t ClientReadStreamCircularBuffer::findTouched(size_t from,
+                                                   size_t limit) const {
+  while (from < limit) {
+    const size_t pos = getPosition(from);
+    const uint64_t word = touched_[pos / 64] >> (pos % 64);
+    if (word != 0) {
+      // Bits past the end of the storage are never set, so this doesn't
+      // wrap around.
+      return std::min(limit, from + __builtin_ctzll(word));
+    }
+    // Skip to the next word, or to the beginning of the storage.
+    from += std::min(64 - pos % 64, capacity() - pos);
+  }
+  return limit;
+}
+
 std::pair<ClientReadStreamRecordState*, lsn_t>
 ClientReadStreamCircularBuffer::findFirstMarker() {
   // avoid searching beyond buffer capacity
@@ -48,13 +75,15 @@ ClientReadStreamCircularBuffer::findFirstMarker() {
   size_t limit =
       std::min(capacity(), LSN_MAX - std::max(buffer_head_, 1lu) + 1);
 
-  for (size_t i = 0; i < limit; ++i) {
+  for (size_t i = findTouched(0, limit); i < limit;
+       i = findTouched(i + 1, limit)) {
     if (buffer_[i].gap || buffer_[i].record || buffer_[i].filtered_out) {
       return std::make_pair(&buffer_[i], getLSN(i));
     }
     // for slot that is not a record/gap marker, its list must be
     // empty
     ld_check(buffer_[i].list.empty());
+    clearTouched(getPosition(i));
   }
 
   // no gap/record marker in buffer
@@ -62,8 +91,9 @@ ClientReadStreamCircularBuffer::findFirstMarker() {
 }
 
 ClientReadStreamRecordState* ClientReadStreamCircularBuffer::front() {
-  if (buffer_.front().record || buffer_.front().gap ||
-      buffer_.front().filtered_out) {
+  if (isTouched(front_pos_) &&
+      (buffer_.front().record || buffer_.front().gap ||
+       buffer_.front().filtered_out)) {
     return &buffer_.front();
   }
 
@@ -77,6 +107,7 @@ void ClientReadStreamCircularBuffer::popFront() {
   ld_check(!buffer_.front().record && !buffer_.front().filtered_out);
   ld_check(buffer_.front().list.empty());
   buffer_.front().reset();
+  clearTouched(front_pos_);
 }
 
 void ClientReadStreamCircularBuffer::advanceBufferHead(size_t offset) {
@@ -93,14 +124,25 @@ void ClientReadStreamCircularBuffer::advanceBufferHead(size_t offset) {
     }
   }
 
+  // The skipped slots become the slots at the end of the buffer, make sure
+  // they're marked as empty.
+  const size_t skipped = std::min(offset, capacity());
+  for (size_t i = findTouched(0, skipped); i < skipped;
+       i = findTouched(i + 1, skipped)) {
+    clearTouched(getPosition(i));
+  }
+
   buffer_.rotate(offset);
+  front_pos_ = getPosition(offset % capacity());
   buffer_head_ += offset;
 }
 
 void ClientReadStreamCircularBuffer::clear() {
-  for (size_t i = 0; i < buffer_.size(); ++i) {
+  for (size_t i = findTouched(0, capacity()); i < capacity();
+       i = findTouched(i + 1, capacity())) {
     buffer_[i].reset();
   }
+  std::fill(touched_.begin(), touched_.end(), 0);
 }
 
 void ClientReadStreamCircularBuffer::forEachUpto(
@@ -29,6 +29,12 @@ ClientReadStreamScd::ClientReadStreamScd(ClientReadStream* owner, Mode mode)
           [this](small_shardset_t down) {
             return shardsDownFailoverTimerCallback(down);
           }),
+      stalled_shards_failover_timer_(
+          this,
+          owner_->deps_->getSettings().scd_stalled_shards_timeout,
+          [this](small_shardset_t stalled) {
+            return stalledShardsFailoverTimerCallback(stalled);
+          }),
       all_send_all_failover_timer_(
           this,
           owner_->deps_->getSettings().scd_all_send_all_timeout,
@@ -37,6 +43,7 @@ ClientReadStreamScd::ClientReadStreamScd(ClientReadStream* owner, Mode mode)
           }) {
   if (isActive()) {
     shards_down_failover_timer_.activate();
+    stalled_shards_failover_timer_.activate();
     all_send_all_failover_timer_.activate();
   }
 }
@@ -208,6 +215,57 @@ bool ClientReadStreamScd::shardsDownFailoverTimerCallback(
   return true;
 }
 
+bool ClientReadStreamScd::stalledShardsFailoverTimerCallback(
+    small_shardset_t stalled) {
+  ld_check(isActive());
+
+  if (stalled.empty() || !owner_->current_metadata_) {
+    return true;
+  }
+
+  // Only filter out the stalled shards if, together with the shards already
+  // filtered out, they can't hold all copies of a record. Otherwise leave it
+  // to shards_down_failover_timer_ and all_send_all_failover_timer_.
+  size_t n_filtered_out_non_empty = 0;
+  for (auto& it : owner_->storage_set_states_) {
+    if (it.second.getAuthoritativeStatus() !=
+            AuthoritativeStatus::AUTHORITATIVE_EMPTY &&
+        it.second.blacklist_state !=
+            ClientReadStreamSenderState::BlacklistState::NONE) {
+      ++n_filtered_out_non_empty;
+    }
+  }
+  const size_t replication =
+      owner_->current_metadata_->replication.getReplicationFactor();
+  if (n_filtered_out_non_empty + stalled.size() >= replication) {
+    return true;
+  }
+
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 1,
+                 "Could not make progress for log %lu during %lums because "
+                 "of stalled shards {%s}, scheduling rewind with them added "
+                 "in the shards down list. Shards down = {%s}, "
+                 "shards slow = {%s}. %s",
+                 owner_->log_id_.val_,
+                 stalled_shards_failover_timer_.period_.count(),
+                 toString(stalled).c_str(),
+                 toString(getShardsDown()).c_str(),
+                 toString(getShardsSlow()).c_str(),
+                 owner_->getDebugInfoStr().c_str());
+  for (ShardID shard : stalled) {
+    if (filtered_out_.deferredAddShardDown(shard)) {
+      WORKER_STAT_INCR(scd_shard_stalled_added);
+    }
+  }
+  owner_->scheduleRewind(RewindReason::SCD_TIMEOUT,
+                         folly::format("stalled shards {} added to shards "
+                                       "down list",
+                                       toString(stalled).c_str())
+                             .str());
+  return true;
+}
+
 bool ClientReadStreamScd::allSendAllFailoverTimerCallback(
     small_shardset_t down) {
   ld_check(isActive());
@@ -364,6 +422,8 @@ void ClientReadStreamScd::applyScheduledChanges() {
       // shardDownFailoverTimerCallback() is called.
       shards_down_failover_timer_.cancel();
       shards_down_failover_timer_.activate();
+      stalled_shards_failover_timer_.cancel();
+      stalled_shards_failover_timer_.activate();
     }
   }
 
@@ -376,12 +436,14 @@ void ClientReadStreamScd::applyScheduledChanges() {
     mode_ = Mode::SCD;
     owner_->grace_period_->reset();
     shards_down_failover_timer_.activate();
+    stalled_shards_failover_timer_.activate();
     all_send_all_failover_timer_.activate();
   } else if (scheduledTransitionTo(Mode::LOCAL_SCD)) {
     // Switch to local SCD.
     mode_ = Mode::LOCAL_SCD;
     owner_->grace_period_->reset();
     shards_down_failover_timer_.activate();
+    stalled_shards_failover_timer_.activate();
     all_send_all_failover_timer_.activate();
   }
   scheduled_mode_transition_.reset();
@@ -395,6 +457,7 @@ void ClientReadStreamScd::scheduleRewindToMode(Mode mode,
   if (mode == Mode::ALL_SEND_ALL) {
     ld_check(isActive());
     shards_down_failover_timer_.cancel();
+    stalled_shards_failover_timer_.cancel();
     all_send_all_failover_timer_.cancel();
   } else {
     ld_check(mode == Mode::SCD || mode == Mode::LOCAL_SCD);
@@ -71,6 +71,12 @@ enum class RewindReason : uint8_t;
  *         - A shard sent STARTED with status=E::AGAIN or an unexpected status;
  *         - The socket to a storage shard was closed.
  *
+ *         The `stalled_shards_failover_timer_` timer does the same, much
+ *         sooner than `shards_down_failover_timer_`, when the only shards
+ *         preventing progress are few enough to be filtered out without
+ *         leaving any record with no copy on the other shards (e.g. a storage
+ *         node that stopped sending while it restarts).
+ *
  *      3. Immediate primary failover due to checksum fail.
  *         If we receive a record with a checksum fail, ClientReadStream calls
  *         addToShardsDownAndScheduleRewind() similarly.
@@ -383,6 +389,14 @@ class ClientReadStreamScd : public boost::noncopyable {
   // The callback for this timer.
   bool shardsDownFailoverTimerCallback(small_shardset_t down);
 
+  // When in single copy delivery mode and --scd-stalled-shards-timeout is
+  // set, this timer will trigger at a regular interval and add to the shards
+  // down list the shards preventing progress, if filtering them out cannot
+  // leave a record with no copy on the other shards.
+  FailoverTimer stalled_shards_failover_timer_;
+  // The callback for this timer.
+  bool stalledShardsFailoverTimerCallback(small_shardset_t stalled);
+
   // When in single copy delivery mode, this timer will trigger at a regular
   // interval and check if we need to failover to all send all mode.
   FailoverTimer all_send_all_failover_timer_;
@@ -59,6 +59,21 @@ class FlowGroupPolicy {
     enabled_ = enable;
   }
 
+  /**
+   * If true, a priority class that runs out of credit may borrow credit from
+   * the priority queue bucket and from idle priority classes as soon as it
+   * needs it, rather than waiting for their overflow to be redistributed at
+   * the next quantum. Borrowing never lets a class exceed its max_bw, and an
+   * idle class always keeps one quantum of its guaranteed_bw.
+   */
+  bool borrowingEnabled() const {
+    return borrowing_enabled_;
+  }
+
+  void setBorrowingEnabled(bool enable) {
+    borrowing_enabled_ = enable;
+  }
+
   void set(Priority p,
            int64_t capacity,
            int64_t guaranteed_bw,
@@ -96,6 +111,7 @@ class FlowGroupPolicy {
  private:
   bool configured_ = false;
   bool enabled_ = false;
+  bool borrowing_enabled_ = false;
 };
 
 }} // namespace facebook::logdevice
@@ -958,6 +958,17 @@ bool parseShapingScope(ShapingConfig& sc, const folly::dynamic& scope) {
   }
   fgp.setEnabled(shaping_enabled);
 
+  // Not a required field, default value for borrowing_enabled is false.
+  bool borrowing_enabled = false;
+  successful = getBoolFromMap(scope, "borrowing_enabled", borrowing_enabled);
+  if (!(successful || err == E::NOTFOUND)) {
+    ld_error("Invalid type for scopes[%s].borrowing_enabled. Bool expected.",
+             scope_name.c_str());
+    err = E::INVALID_CONFIG;
+    return false;
+  }
+  fgp.setBorrowingEnabled(borrowing_enabled);
+
   // Not a required Field
   auto iter = scope.find("meters");
   if (iter != scope.items().end()) {
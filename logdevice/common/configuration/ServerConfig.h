@@ -235,6 +235,12 @@ class ServerConfig {
     // in part) is the fact that `hash` also doesn't describe just server config
     // but both server and logs config. This is all a mess.
     bool logs_config_may_be_outdated = false;
+
+    // True if the main config was read from the on-disk cache of a client
+    // (see Settings::config_cache_dir) rather than from its source. Any
+    // config that comes from the source then replaces it, whatever its
+    // version.
+    bool from_cache = false;
   };
 
   void setMainConfigMetadata(const ConfigMetadata& metadata) {
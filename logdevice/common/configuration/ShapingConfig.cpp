@@ -53,6 +53,9 @@ folly::dynamic ShapingConfig::toFollyDynamic(const NodeLocationScope scope,
   folly::dynamic result =
       folly::dynamic::object("name", NodeLocation::scopeNames()[scope])(
           "shaping_enabled", fgp.enabled());
+  if (fgp.borrowingEnabled()) {
+    result.insert("borrowing_enabled", true);
+  }
 
   folly::dynamic meter_list = folly::dynamic::array;
   Priority p = Priority::MAX;
@@ -8,6 +8,8 @@
 #include "logdevice/common/configuration/TextConfigUpdater.h"
 
 #include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
 #include <folly/compression/Compression.h>
 #include <folly/hash/SpookyHashV2.h>
 
@@ -46,7 +48,101 @@ int TextConfigUpdaterImpl::load(
     return -1;
   }
   main_config_state_.source = it->get();
-  return fetchFromSource();
+  const bool loaded_from_cache = loadFromCache();
+  int rv = fetchFromSource();
+  if (rv != 0 && loaded_from_cache) {
+    ld_warning("Failed to request main config \"%s\" from %s: %s. Using the "
+               "cached config until the source becomes available.",
+               main_config_state_.path.c_str(),
+               main_config_state_.source->getName().c_str(),
+               error_description(err));
+    return 0;
+  }
+  return rv;
+}
+
+std::string TextConfigUpdaterImpl::getCacheFilePath() const {
+  const std::string& dir = updateable_settings_->config_cache_dir;
+  if (dir.empty() || main_config_state_.source == nullptr) {
+    return "";
+  }
+  const std::string uri =
+      main_config_state_.source->getName() + ':' + main_config_state_.path;
+  return (boost::filesystem::path(dir) / (hash_contents(uri) + ".conf"))
+      .string();
+}
+
+bool TextConfigUpdaterImpl::loadFromCache() {
+  const std::string path = getCacheFilePath();
+  if (path.empty() || !boost::filesystem::exists(path)) {
+    return false;
+  }
+  // The file has the hash of the config on the first line, followed by the
+  // config contents.
+  std::string data;
+  if (!folly::readFile(path.c_str(), data)) {
+    ld_warning("Failed to read cached config %s: %s",
+               path.c_str(),
+               folly::errnoStr(errno).c_str());
+    return false;
+  }
+  const size_t eol = data.find('\n');
+  if (eol == std::string::npos || eol == 0) {
+    ld_warning("Ignoring malformed cached config %s", path.c_str());
+    return false;
+  }
+  ConfigSource::Output output;
+  output.hash = data.substr(0, eol);
+  output.contents = data.substr(eol + 1);
+  output.mtime = std::chrono::milliseconds::zero();
+
+  // Don't let an unusable cache file fail the initial load, which would
+  // otherwise succeed once the source provides the config.
+  if (!Configuration::fromJson(output.contents,
+                               alternative_logs_config_
+                                   ? alternative_logs_config_->copy()
+                                   : nullptr,
+                               config_parser_options_)) {
+    ld_warning("Ignoring invalid cached config %s", path.c_str());
+    return false;
+  }
+
+  ld_info("Using cached main config %s (hash %s) while fetching \"%s\" from "
+          "%s",
+          path.c_str(),
+          output.hash.c_str(),
+          main_config_state_.path.c_str(),
+          main_config_state_.source->getName().c_str());
+  main_config_state_.output = std::move(output);
+  main_config_state_.last_loaded_time = std::chrono::milliseconds::zero();
+  main_config_state_.from_cache = true;
+  update();
+  return true;
+}
+
+void TextConfigUpdaterImpl::writeToCache() {
+  const std::string path = getCacheFilePath();
+  if (path.empty()) {
+    return;
+  }
+  ld_check(main_config_state_.output.has_value());
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(
+      boost::filesystem::path(path).parent_path(), ec);
+  if (ec) {
+    ld_warning("Failed to create config cache directory for %s: %s",
+               path.c_str(),
+               ec.message().c_str());
+    return;
+  }
+  const ConfigSource::Output& output = main_config_state_.output.value();
+  int rv = folly::writeFileAtomicNoThrow(
+      path, output.hash + '\n' + output.contents, 0600);
+  if (rv != 0) {
+    ld_warning("Failed to write cached config %s: %s",
+               path.c_str(),
+               folly::errnoStr(rv).c_str());
+  }
 }
 
 int TextConfigUpdaterImpl::fetchFromSource() {
@@ -116,6 +212,7 @@ void TextConfigUpdaterImpl::onContents(State* state,
           output.hash.c_str());
 
   state->output = std::move(output);
+  state->from_cache = false;
   using namespace std::chrono;
   state->last_loaded_time =
       duration_cast<milliseconds>(system_clock::now().time_since_epoch());
@@ -150,6 +247,7 @@ void TextConfigUpdaterImpl::update(bool force_reload_logsconfig) {
   main_config_metadata.hash = main_config_state_.output->hash;
   main_config_metadata.modified_time = main_config_state_.output->mtime;
   main_config_metadata.loaded_time = main_config_state_.last_loaded_time;
+  main_config_metadata.from_cache = main_config_state_.from_cache;
 
   config->serverConfig()->setMainConfigMetadata(main_config_metadata);
 
@@ -179,6 +277,10 @@ void TextConfigUpdaterImpl::update(bool force_reload_logsconfig) {
     err = E::INVALID_CONFIG;
   }
   invalid_logs_config_ = logs_config_update == ConfigUpdateResult::INVALID;
+  if (server_config_update == ConfigUpdateResult::UPDATED &&
+      !main_config_state_.from_cache && !invalid_logs_config_) {
+    writeToCache();
+  }
   setRecentConfigValidity(server_config_update != ConfigUpdateResult::INVALID &&
                           zookeeper_config_update !=
                               ConfigUpdateResult::INVALID &&
@@ -235,6 +337,15 @@ int TextConfigUpdaterImpl::compareServerConfig(
     return 1;
   }
 
+  if (old_config->getMainConfigMetadata().from_cache &&
+      !new_config->getMainConfigMetadata().from_cache) {
+    ld_info("Replacing cached config (version %u) with config from source "
+            "(version %u)",
+            old_config->getVersion().val(),
+            new_config->getVersion().val());
+    return 1;
+  }
+
   config_version_t new_version = new_config->getVersion();
   config_version_t old_version = old_config->getVersion();
   RATELIMIT_INFO(std::chrono::seconds(1),
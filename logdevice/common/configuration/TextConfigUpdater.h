@@ -160,8 +160,22 @@ class TextConfigUpdaterImpl {
     std::string path;
     std::chrono::milliseconds last_loaded_time;
     folly::Optional<ConfigSource::Output> output;
+    // true if `output' was read from Settings::config_cache_dir and the
+    // source hasn't provided contents yet
+    bool from_cache = false;
   } main_config_state_;
 
+  // Path of the file caching the main config under
+  // Settings::config_cache_dir, or an empty string if the cache is disabled.
+  std::string getCacheFilePath() const;
+
+  // Publishes the cached main config, if any, so that the client doesn't
+  // have to wait for the source. Returns true if it did.
+  bool loadFromCache();
+
+  // Stores the main config fetched from the source in the cache.
+  void writeToCache();
+
   // Helper method called by load() and onAsyncGet() when a source provides
   // contents of a config, synchronously or asynchronously.  Logs and
   // optionally calls update().
@@ -177,6 +177,14 @@ class UpdateableConfigTmpl : public UpdateableConfigBase {
     return config_.get();
   }
 
+  /**
+   * @return a number that changes whenever the config returned by get()
+   *         does. See UpdateableSharedPtr::version() and SnapshotCache.
+   */
+  uint64_t version() const {
+    return config_.version();
+  }
+
   /**
    * Updates this config with a Config instance, applying any
    * existing, local, configuration overrides. This can be called, for
@@ -254,12 +254,16 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
    * This is mainly used to be used as the top-level deserialize method for
    * DirectoryNode.
    *
+   * If `registry` is given, the LogAttributes of the directory and of
+   * everything under it are deduplicated against it while decoding.
    */
   template <typename Out, typename In>
-  static std::unique_ptr<Out> fbuffers_deserialize(const In* in,
-                                                   DirectoryNode* parent,
-                                                   const std::string& delimiter,
-                                                   bool apply_defaults);
+  static std::unique_ptr<Out>
+  fbuffers_deserialize(const In* in,
+                       DirectoryNode* parent,
+                       const std::string& delimiter,
+                       bool apply_defaults,
+                       CommonValuesRegistry* registry = nullptr);
   // helper used in deserializing deltas
   template <typename Out, typename In>
   static std::unique_ptr<Out>
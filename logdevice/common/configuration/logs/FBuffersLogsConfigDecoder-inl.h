@@ -70,7 +70,8 @@ FBuffersLogsConfigCodec::fbuffers_deserialize<DirectoryNode,
     const fbuffers::Directory* dir,
     DirectoryNode* parent,
     const std::string& delimiter,
-    bool apply_defaults);
+    bool apply_defaults,
+    CommonValuesRegistry* registry);
 
 // fbuffers::Directory => DirectoryNode
 template <>
@@ -468,7 +468,8 @@ FBuffersLogsConfigCodec::fbuffers_deserialize<DirectoryNode,
     const fbuffers::Directory* dir,
     DirectoryNode* parent,
     const std::string& delimiter,
-    bool apply_defaults) {
+    bool apply_defaults,
+    CommonValuesRegistry* registry) {
   if (dir) {
     LogAttributes attrs;
     if (dir->attrs()) {
@@ -481,6 +482,9 @@ FBuffersLogsConfigCodec::fbuffers_deserialize<DirectoryNode,
             apply_defaults ? DefaultLogAttributes() : LogAttributes());
       }
     }
+    if (registry != nullptr) {
+      registry->deduplicate(attrs);
+    }
     auto out = std::make_unique<DirectoryNode>(
         dir->name()->str(), parent, attrs, delimiter);
 
@@ -488,7 +492,11 @@ FBuffersLogsConfigCodec::fbuffers_deserialize<DirectoryNode,
     if (dir->children()) {
       for (const auto* directory : *dir->children()) {
         auto child = fbuffers_deserialize<DirectoryNode>(
-            directory, out.get(), delimiter, false /* do not apply_defaults */);
+            directory,
+            out.get(),
+            delimiter,
+            false /* do not apply_defaults */,
+            registry);
         auto& dirsEntry = dirs[child->name()];
         dirsEntry = std::move(child);
       }
@@ -500,6 +508,11 @@ FBuffersLogsConfigCodec::fbuffers_deserialize<DirectoryNode,
       for (const auto* log_group : *dir->log_groups()) {
         auto one_log =
             fbuffers_deserialize<LogGroupNode>(log_group, delimiter, attrs);
+        if (registry != nullptr) {
+          // Cheaper than LogsConfigTree::deduplicateAttributes() later, which
+          // has to replace the (then shared and immutable) node.
+          one_log->deduplicateAttributes(*registry);
+        }
         auto& logsEntry = logs[one_log->name()];
         logsEntry = std::move(one_log);
       }
@@ -557,12 +570,20 @@ FBuffersLogsConfigCodec::fbuffers_deserialize<LogsConfigTree,
     const fbuffers::LogsConfig* logs_config,
     const std::string& delimiter) {
   if (logs_config && logs_config->root_dir()) {
-    std::unique_ptr<DirectoryNode> root = fbuffers_deserialize<DirectoryNode>(
-        logs_config->root_dir(), nullptr, delimiter, true /* apply defaults */);
+    // Deduplicate attributes while decoding, so that the tree comes out
+    // already deduplicated.
+    CommonValuesRegistry registry;
+    std::unique_ptr<DirectoryNode> root =
+        fbuffers_deserialize<DirectoryNode>(logs_config->root_dir(),
+                                            nullptr,
+                                            delimiter,
+                                            true /* apply defaults */,
+                                            &registry);
     auto version = logs_config->version();
 
     std::unique_ptr<LogsConfigTree> config_tree =
         std::make_unique<LogsConfigTree>(std::move(root), delimiter, version);
+    config_tree->registry_ = std::move(registry);
     // Build the lookup Index of the tree
     config_tree->rebuildIndex();
 
@@ -239,7 +239,7 @@ LogsConfigStateMachine::deserializeState(
     err = E::BADMSG;
     return nullptr;
   }
-  tree->deduplicateAttributes();
+  // The decoder has already deduplicated the attributes of the tree.
   tree->setVersion(version);
   return tree;
 }
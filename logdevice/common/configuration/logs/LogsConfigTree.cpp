@@ -8,7 +8,9 @@
 #include "logdevice/common/configuration/logs/LogsConfigTree.h"
 
 #include <deque>
+#include <functional>
 #include <iostream>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -356,7 +358,7 @@ DirectoryNode::DirectoryNode(const DirectoryNode& other, DirectoryNode* parent)
     : LogsConfigTreeNode(other.name_, other.attrs()),
       parent_(parent),
       delimiter_(other.delimiter_) {
-  // a simple copy of the log groups map
+  // the log groups map is shared until modified
   logs_ = other.logs_;
   for (const auto& item : other.children_) {
     children_[item.first] = std::make_unique<DirectoryNode>(*item.second, this);
@@ -368,7 +370,7 @@ ReplicationProperty DirectoryNode::getNarrowestReplication() const {
   for (const auto& item : children_) {
     narrowest = narrowest.narrowest(item.second->getNarrowestReplication());
   }
-  for (const auto& item : logs_) {
+  for (const auto& item : *logs_) {
     narrowest = narrowest.narrowest(item.second->getReplicationProperty());
   }
   return narrowest;
@@ -383,6 +385,15 @@ DirectoryNode* DirectoryNode::addChild(const std::string& name,
   return node;
 }
 
+LogGroupMap& DirectoryNode::mutableLogs() {
+  // If use_count() is 1 no other copy can appear concurrently, since copies
+  // are only made from this DirectoryNode.
+  if (logs_.use_count() > 1) {
+    logs_ = std::make_shared<LogGroupMap>(*logs_);
+  }
+  return *logs_;
+}
+
 void DirectoryNode::setChild(const std::string& name,
                              std::unique_ptr<DirectoryNode> child) {
   children_[name] = std::move(child);
@@ -395,12 +406,12 @@ void DirectoryNode::deduplicateRecursively(CommonValuesRegistry& registry,
     child.second->deduplicateRecursively(registry, callback);
   }
 
-  for (auto& item : logs_) {
+  for (auto& item : mutableLogs()) {
     auto& log = item.second;
     if (auto new_attrs = registry.deduplicate(log->attrs())) {
       log = std::make_shared<const LogGroupNode>(
           log->name(), *new_attrs, log->range());
-      callback(parent_, log);
+      callback(this, log);
     }
   }
 }
@@ -413,7 +424,7 @@ LogGroupNodePtr DirectoryNode::addLogGroup(LogGroupNodePtr group,
     err = E::EXISTS;
     return nullptr;
   }
-  logs_[group->name()] = group;
+  mutableLogs()[group->name()] = group;
   return group;
 }
 
@@ -454,8 +465,10 @@ bool DirectoryNode::refreshAttributesInheritance(std::string& failure_reason) {
       return false;
     }
   }
-  // for all log groups, replace.
-  for (auto& it : logs_) {
+  // for all log groups, replace. Take the private copy of the map before
+  // iterating, so that addLogGroup() below modifies the map being iterated
+  // rather than a fresh copy of it.
+  for (auto& it : mutableLogs()) {
     std::string log_path = getFullyQualifiedName() + delimiter_ + it.first;
     // create a replacement log group node that has our attributes applied
     LogGroupNode replacement = it.second->withLogAttributes(
@@ -471,13 +484,14 @@ bool DirectoryNode::refreshAttributesInheritance(std::string& failure_reason) {
 }
 
 LogGroupNodePtr DirectoryNode::deleteLogGroup(const std::string& name) {
-  auto iter = logs_.find(name);
-  if (iter != logs_.end()) {
-    auto old_node = iter->second;
-    logs_.erase(iter);
-    return old_node;
+  if (!logs_->count(name)) {
+    return nullptr;
   }
-  return nullptr;
+  LogGroupMap& logs = mutableLogs();
+  auto iter = logs.find(name);
+  auto old_node = iter->second;
+  logs.erase(iter);
+  return old_node;
 }
 
 void DirectoryNode::deleteChild(const std::string& name) {
@@ -1296,6 +1310,50 @@ void LogsConfigTree::rebuildIndexForDir(const DirectoryNode* dir,
   }
 }
 
+LogsConfigTree& LogsConfigTree::copy(const LogsConfigTree& other) {
+  delimiter_ = other.delimiter_;
+  root_ = std::make_unique<DirectoryNode>(*other.root_);
+  version_ = other.version_;
+  registry_ = other.registry_;
+  copyIndexFrom(other);
+  return *this;
+}
+
+void LogsConfigTree::copyIndexFrom(const LogsConfigTree& other) {
+  // The directories of this tree are copies of the ones of `other`, with the
+  // same names. Map each directory of `other` to its copy.
+  std::unordered_map<const DirectoryNode*, const DirectoryNode*> copies;
+  std::function<void(const DirectoryNode*, const DirectoryNode*)> map_dir =
+      [&](const DirectoryNode* from, const DirectoryNode* to) {
+        copies[from] = to;
+        for (const auto& child : from->children()) {
+          auto it = to->children().find(child.first);
+          ld_check(it != to->children().end());
+          map_dir(child.second.get(), it->second.get());
+        }
+      };
+  map_dir(other.root_.get(), root_.get());
+
+  logs_index_ = other.logs_index_;
+  max_backlog_duration_ = std::chrono::seconds(0);
+  for (auto& segment : logs_index_) {
+    LogGroupInDirectory& value = segment.second;
+    if (value.parent != nullptr) {
+      auto it = copies.find(value.parent);
+      ld_check(it != copies.end());
+      value.parent = it != copies.end() ? it->second : nullptr;
+    }
+    // Same as in updateLookupIndex().
+    if (value.log_group != nullptr) {
+      auto backlog = value.log_group->attrs().backlogDuration();
+      if (backlog.hasValue() && backlog.value().has_value()) {
+        max_backlog_duration_ =
+            std::max(max_backlog_duration_, backlog.value().value());
+      }
+    }
+  }
+}
+
 void LogsConfigTree::rebuildIndex() {
   logs_index_.clear();
   rebuildIndexForDir(root_.get(), false);
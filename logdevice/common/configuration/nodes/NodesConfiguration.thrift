@@ -88,3 +88,17 @@ struct NodesConfiguration {
   // 8: u64 last_maintenance;
   // 9: string last_context;
 }
+
+// A NodesConfiguration encoded relative to an older one. See
+// NodesConfigurationDelta.h.
+struct NodesConfigurationDelta {
+  1: u64 base_version;
+  // checksum_64bit() of the thrift serialization of the base config
+  2: u64 base_checksum;
+  3: u64 target_version;
+  // size of the thrift serialization of the target config
+  4: u64 target_size;
+  // thrift serialization of the target config, compressed with zstd using the
+  // serialization of the base config as a prefix
+  5: binary patch;
+}
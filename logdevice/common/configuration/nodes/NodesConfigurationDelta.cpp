@@ -0,0 +1,229 @@
+/**
+ * Copyright (c) 2018-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/configuration/nodes/NodesConfigurationDelta.h"
+
+#include <algorithm>
+
+#include <zstd.h>
+
+#include "logdevice/common/Checksum.h"
+#include "logdevice/common/ThriftCodec.h"
+#include "logdevice/common/configuration/nodes/NodesConfigurationCodec.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice { namespace configuration {
+namespace nodes {
+
+using apache::thrift::BinarySerializer;
+
+namespace {
+
+// zstd level for patches. Patches are small, the cost is dominated by
+// matching against the prefix.
+constexpr int kZstdLevel = 3;
+// Largest window zstd decompresses by default. Configs larger than that are
+// still encoded correctly, just with less of the prefix reachable.
+constexpr int kMaxWindowLog = 27;
+// Sanity limit on the decoded size, which comes from the network
+constexpr uint64_t kMaxTargetSize = 1ull << 30;
+
+std::string serializeToThrift(const NodesConfiguration& config) {
+  return ThriftCodec::serialize<BinarySerializer>(
+      NodesConfigurationThriftConverter::toThrift(config));
+}
+
+using CCtxPtr = std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)>;
+using DCtxPtr = std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)>;
+
+} // namespace
+
+/* static */
+std::string NodesConfigurationDelta::encode(const NodesConfiguration& base,
+                                            const NodesConfiguration& target) {
+  const std::string base_blob = serializeToThrift(base);
+  const std::string target_blob = serializeToThrift(target);
+
+  std::string patch;
+  patch.resize(ZSTD_compressBound(target_blob.size()));
+  CCtxPtr cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+  if (!cctx) {
+    return "";
+  }
+  size_t patch_size;
+#if ZSTD_VERSION_NUMBER >= 10400
+  // The whole base needs to be within the window for unchanged parts of the
+  // config to be found in it.
+  int window_log = ZSTD_WINDOWLOG_MIN;
+  while (window_log < kMaxWindowLog &&
+         (size_t(1) << window_log) < base_blob.size() + target_blob.size()) {
+    ++window_log;
+  }
+  ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_compressionLevel, kZstdLevel);
+  ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_windowLog, window_log);
+  ZSTD_CCtx_refPrefix(cctx.get(), base_blob.data(), base_blob.size());
+  patch_size = ZSTD_compress2(cctx.get(),
+                              &patch[0],
+                              patch.size(),
+                              target_blob.data(),
+                              target_blob.size());
+#else
+  patch_size = ZSTD_compress_usingDict(cctx.get(),
+                                       &patch[0],
+                                       patch.size(),
+                                       target_blob.data(),
+                                       target_blob.size(),
+                                       base_blob.data(),
+                                       base_blob.size(),
+                                       kZstdLevel);
+#endif
+  if (ZSTD_isError(patch_size)) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Failed to encode NodesConfiguration delta: %s",
+                    ZSTD_getErrorName(patch_size));
+    return "";
+  }
+  patch.resize(patch_size);
+
+  thrift::NodesConfigurationDelta delta;
+  delta.set_base_version(base.getVersion().val());
+  delta.set_base_checksum(checksum_64bit(Slice::fromString(base_blob)));
+  delta.set_target_version(target.getVersion().val());
+  delta.set_target_size(target_blob.size());
+  delta.set_patch(std::move(patch));
+  return ThriftCodec::serialize<BinarySerializer>(delta);
+}
+
+/* static */
+folly::Optional<std::string>
+NodesConfigurationDelta::apply(const NodesConfiguration& base,
+                               folly::StringPiece delta_blob) {
+  auto delta =
+      ThriftCodec::deserialize<BinarySerializer,
+                               thrift::NodesConfigurationDelta>(
+          Slice(delta_blob.data(), delta_blob.size()));
+  if (delta == nullptr) {
+    err = E::BADMSG;
+    return folly::none;
+  }
+
+  if (delta->base_version != base.getVersion().val()) {
+    err = E::VERSION_MISMATCH;
+    return folly::none;
+  }
+  const std::string base_blob = serializeToThrift(base);
+  if (delta->base_checksum != checksum_64bit(Slice::fromString(base_blob))) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "NodesConfiguration of version %lu serializes differently "
+                   "than on the sender of a delta against it",
+                   delta->base_version);
+    err = E::VERSION_MISMATCH;
+    return folly::none;
+  }
+
+  if (delta->target_size > kMaxTargetSize) {
+    err = E::BADMSG;
+    return folly::none;
+  }
+  std::string target_blob;
+  target_blob.resize(delta->target_size);
+  DCtxPtr dctx(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  if (!dctx) {
+    err = E::NOMEM;
+    return folly::none;
+  }
+#if ZSTD_VERSION_NUMBER >= 10400
+  ZSTD_DCtx_setParameter(dctx.get(), ZSTD_d_windowLogMax, kMaxWindowLog);
+  ZSTD_DCtx_refPrefix(dctx.get(), base_blob.data(), base_blob.size());
+  size_t size = ZSTD_decompressDCtx(dctx.get(),
+                                    &target_blob[0],
+                                    target_blob.size(),
+                                    delta->patch.data(),
+                                    delta->patch.size());
+#else
+  size_t size = ZSTD_decompress_usingDict(dctx.get(),
+                                          &target_blob[0],
+                                          target_blob.size(),
+                                          delta->patch.data(),
+                                          delta->patch.size(),
+                                          base_blob.data(),
+                                          base_blob.size());
+#endif
+  if (ZSTD_isError(size) || size != target_blob.size()) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Failed to decode NodesConfiguration delta: %s",
+                    ZSTD_isError(size) ? ZSTD_getErrorName(size)
+                                       : "size mismatch");
+    err = E::BADMSG;
+    return folly::none;
+  }
+
+  // Wrap the result the same way NodesConfigurationCodec::serialize() does,
+  // but without compression as it'd be undone right away by the consumer.
+  configuration::thrift::ConfigurationCodecHeader header;
+  header.set_proto_version(NodesConfigurationCodec::CURRENT_PROTO_VERSION);
+  header.set_config_version(delta->target_version);
+  header.set_is_compressed(false);
+  configuration::thrift::ConfigurationCodecWrapper wrapper;
+  wrapper.set_header(std::move(header));
+  wrapper.set_serialized_config(std::move(target_blob));
+  return ThriftCodec::serialize<BinarySerializer>(wrapper);
+}
+
+void NodesConfigurationHistory::setCapacity(size_t capacity) {
+  capacity_ = capacity;
+  while (configs_.size() > capacity_) {
+    configs_.pop_front();
+  }
+}
+
+void NodesConfigurationHistory::add(
+    std::shared_ptr<const NodesConfiguration> config) {
+  if (capacity_ == 0 || config == nullptr ||
+      (!configs_.empty() &&
+       config->getVersion() <= configs_.back()->getVersion())) {
+    return;
+  }
+  configs_.push_back(std::move(config));
+  while (configs_.size() > capacity_) {
+    configs_.pop_front();
+  }
+}
+
+std::string NodesConfigurationHistory::getDelta(
+    Version base_version,
+    const NodesConfiguration& target) {
+  if (target.getVersion() != deltas_target_) {
+    deltas_.clear();
+    deltas_target_ = target.getVersion();
+  }
+  auto cached = deltas_.find(base_version.val());
+  if (cached != deltas_.end()) {
+    return cached->second;
+  }
+
+  auto base = std::find_if(
+      configs_.begin(),
+      configs_.end(),
+      [&](const std::shared_ptr<const NodesConfiguration>& config) {
+        return config->getVersion() == base_version;
+      });
+  if (base == configs_.end()) {
+    return "";
+  }
+  std::string delta = NodesConfigurationDelta::encode(**base, target);
+  if (!delta.empty() && deltas_.size() < capacity_) {
+    deltas_[base_version.val()] = delta;
+  }
+  return delta;
+}
+
+}}}} // namespace facebook::logdevice::configuration::nodes
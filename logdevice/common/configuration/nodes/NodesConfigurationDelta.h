@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2018-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <folly/Optional.h>
+#include <folly/Range.h>
+
+#include "logdevice/common/configuration/nodes/NodesConfiguration.h"
+
+namespace facebook { namespace logdevice { namespace configuration {
+namespace nodes {
+
+/**
+ * @file Encodes a NodesConfiguration relative to an older version of it, so
+ * that nodes that already have the older version don't need to download the
+ * whole config on every change. Most changes (e.g. a maintenance moving a few
+ * shards to another storage state) touch a handful of nodes, and the delta is
+ * a few hundred bytes even for clusters with thousands of nodes.
+ *
+ * The delta is the thrift serialization of the new config compressed with
+ * zstd, using the serialization of the base config as a prefix (like
+ * `zstd --patch-from`). It doesn't depend on how the config got from one
+ * version to the other, only on the two versions. The delta carries a checksum
+ * of the serialized base config, so a receiver whose config of the base
+ * version serializes differently (e.g. because it runs a different version of
+ * the code) detects that and can fetch the full config instead.
+ */
+class NodesConfigurationDelta {
+ public:
+  /**
+   * @return  `target` encoded relative to `base`, or an empty string on error
+   */
+  static std::string encode(const NodesConfiguration& base,
+                            const NodesConfiguration& target);
+
+  /**
+   * Reconstructs the config encoded by encode() from the delta and the base
+   * config.
+   *
+   * @return  the target config serialized by NodesConfigurationCodec, for
+   *          consumers of NodesConfigurationStore, or folly::none with err
+   *          set to:
+   *            BADMSG            the delta is malformed
+   *            VERSION_MISMATCH  `base` is not the config the delta was
+   *                              encoded against
+   */
+  static folly::Optional<std::string> apply(const NodesConfiguration& base,
+                                            folly::StringPiece delta);
+};
+
+/**
+ * The last few NodesConfigurations a server has seen, to answer CONFIG_FETCH
+ * requests with a delta against the version the requester has. Also caches
+ * the deltas to the latest config, since many clients usually ask for the
+ * same one.
+ *
+ * Not thread-safe; each Worker has its own.
+ */
+class NodesConfigurationHistory {
+ public:
+  using Version = membership::MembershipVersion::Type;
+
+  /**
+   * Sets how many configs to keep. 0 disables deltas.
+   */
+  void setCapacity(size_t capacity);
+
+  /**
+   * Records `config` if it's newer than all the configs recorded so far.
+   */
+  void add(std::shared_ptr<const NodesConfiguration> config);
+
+  /**
+   * @return  `target` encoded as a delta against the recorded config of
+   *          version base_version, or an empty string if there is no such
+   *          config or encoding failed
+   */
+  std::string getDelta(Version base_version, const NodesConfiguration& target);
+
+ private:
+  size_t capacity_{0};
+  std::deque<std::shared_ptr<const NodesConfiguration>> configs_;
+
+  // Deltas to the config of version deltas_target_, by base version
+  Version deltas_target_{0};
+  std::unordered_map<uint64_t, std::string> deltas_;
+};
+
+}}}} // namespace facebook::logdevice::configuration::nodes
@@ -833,21 +833,50 @@ ShardAuthoritativeStatusMap EventLogRebuildingSet::toShardStatusMap(
     const configuration::nodes::NodesConfiguration& nodes_configuration) const {
   ShardAuthoritativeStatusMap map(getLastUpdate());
   for (auto& shard : getRebuildingShards()) {
-    for (auto& node : shard.second.nodes_) {
-      if (!nodes_configuration.getStorageMembership()->hasNode(node.first)) {
-        // ignore nodes that are not in the storagte membership
-        continue;
-      }
-      map.setShardStatus(node.first,
-                         shard.first,
-                         node.second.auth_status,
-                         !node.second.dc_dirty_ranges.empty());
-    }
+    addToShardStatusMap(map, shard.first, shard.second, nodes_configuration);
   }
 
   return map;
 }
 
+void EventLogRebuildingSet::updateShardStatusMap(
+    ShardAuthoritativeStatusMap& map,
+    uint32_t shard,
+    const configuration::nodes::NodesConfiguration& nodes_configuration) const {
+  std::vector<node_index_t> nodes;
+  for (const auto& node : map.getShards()) {
+    if (node.second.count(shard)) {
+      nodes.push_back(node.first);
+    }
+  }
+  for (node_index_t node : nodes) {
+    map.setShardStatus(node, shard, AuthoritativeStatus::FULLY_AUTHORITATIVE);
+  }
+
+  auto it = shards_.find(shard);
+  if (it != shards_.end()) {
+    addToShardStatusMap(map, shard, it->second, nodes_configuration);
+  }
+  map.setVersion(getLastUpdate());
+}
+
+void EventLogRebuildingSet::addToShardStatusMap(
+    ShardAuthoritativeStatusMap& map,
+    uint32_t shard,
+    const RebuildingShardInfo& shard_info,
+    const configuration::nodes::NodesConfiguration& nodes_configuration) {
+  for (auto& node : shard_info.nodes_) {
+    if (!nodes_configuration.getStorageMembership()->hasNode(node.first)) {
+      // ignore nodes that are not in the storagte membership
+      continue;
+    }
+    map.setShardStatus(node.first,
+                       shard,
+                       node.second.auth_status,
+                       !node.second.dc_dirty_ranges.empty());
+  }
+}
+
 void EventLogRebuildingSet::recomputeAuthoritativeStatus(
     uint32_t shard,
     std::chrono::milliseconds timestamp,
@@ -354,6 +354,19 @@ class EventLogRebuildingSet {
       const configuration::nodes::NodesConfiguration& nodes_configuration)
       const;
 
+  /**
+   * Brings the entries of shards with index `shard` in `map` up to date with
+   * this rebuilding set, and the version of `map` to getLastUpdate(). Applying
+   * this to every shard index touched by the events applied since `map` was
+   * computed by toShardStatusMap() gives the same result as calling
+   * toShardStatusMap() again, without looking at the other shards.
+   */
+  void updateShardStatusMap(
+      ShardAuthoritativeStatusMap& map,
+      uint32_t shard,
+      const configuration::nodes::NodesConfiguration& nodes_configuration)
+      const;
+
   void recomputeAuthoritativeStatus(
       uint32_t shard,
       std::chrono::milliseconds timestamp,
@@ -374,6 +387,13 @@ class EventLogRebuildingSet {
 
   folly::Optional<NodeID> my_node_id_{folly::none};
 
+  // Adds the entries of nodes rebuilding shard `shard` to `map`.
+  static void addToShardStatusMap(
+      ShardAuthoritativeStatusMap& map,
+      uint32_t shard,
+      const RebuildingShardInfo& shard_info,
+      const configuration::nodes::NodesConfiguration& nodes_configuration);
+
   // Recomputes `NodeInfo::auth_status` and `NodeInfo::donors_remaining`.
   // @param out_comment
   //   A human-readable explanation for this transition.
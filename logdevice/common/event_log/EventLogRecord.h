@@ -64,6 +64,12 @@ class EventLogRecord {
    */
   virtual int toPayload(void* payload, size_t size) const = 0;
   virtual std::string describe() const = 0;
+  /**
+   * @return index of the shard this event is about. Applying an event to an
+   *         EventLogRebuildingSet only changes the state of shards with that
+   *         index.
+   */
+  virtual uint32_t getShardIdx() const = 0;
   virtual ~EventLogRecord() {}
   explicit EventLogRecord(event_log_record_version_t version)
       : version_(version) {}
@@ -111,6 +117,9 @@ class FixedEventLogRecord : public EventLogRecord {
   std::string describe() const override {
     return header.describe();
   }
+  uint32_t getShardIdx() const override {
+    return header.shardIdx;
+  }
 
   Header header;
 };
@@ -235,6 +244,9 @@ class SHARD_NEEDS_REBUILD_Event : public EventLogRecord {
     return header.describe() +
         (time_ranges.empty() ? "" : toString(time_ranges));
   }
+  uint32_t getShardIdx() const override {
+    return header.shardIdx;
+  }
 
   SHARD_NEEDS_REBUILD_Header header;
 
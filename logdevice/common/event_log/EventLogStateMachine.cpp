@@ -221,8 +221,14 @@ void EventLogStateMachine::postWriteDeltaRequest(
 }
 
 void EventLogStateMachine::onUpdate(const EventLogRebuildingSet& set,
-                                    const EventLogRecord* /*delta*/,
+                                    const EventLogRecord* delta,
                                     lsn_t version) {
+  if (delta) {
+    dirty_shard_indexes_.insert(delta->getShardIdx());
+  } else {
+    all_shard_indexes_dirty_ = true;
+  }
+
   if (update_workers_) {
     gracePeriodTimer_.activate(settings_->event_log_grace_period);
     publishRebuildingSet();
@@ -313,8 +319,23 @@ Request::Execution EventLogWriteDeltaRequest::execute() {
 void EventLogStateMachine::updateWorkerShardStatusMap() {
   const auto& nodes_configuration =
       Worker::onThisThread()->getNodesConfiguration();
-  auto map = getState().toShardStatusMap(*nodes_configuration);
+  const auto membership_version =
+      nodes_configuration->getStorageMembership()->getVersion();
+  if (all_shard_indexes_dirty_ ||
+      membership_version != shard_status_map_membership_version_) {
+    shard_status_map_ = getState().toShardStatusMap(*nodes_configuration);
+    shard_status_map_membership_version_ = membership_version;
+  } else {
+    for (uint32_t shard : dirty_shard_indexes_) {
+      getState().updateShardStatusMap(
+          shard_status_map_, shard, *nodes_configuration);
+    }
+    shard_status_map_.setVersion(getState().getLastUpdate());
+  }
+  all_shard_indexes_dirty_ = false;
+  dirty_shard_indexes_.clear();
 
+  auto map = shard_status_map_;
   for (const auto& p : Worker::settings().authoritative_status_overrides) {
     map.setShardStatus(p.first.node(), p.first.shard(), p.second);
   }
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <set>
+
 #include "logdevice/common/event_log/EventLogRebuildingSet.h"
 #include "logdevice/common/event_log/EventLogRebuildingSetCodec.h"
 #include "logdevice/common/event_log/EventLogRebuildingSet_generated.h"
@@ -242,6 +244,17 @@ class EventLogStateMachine
   // Last ShardAuthoritativeStatusMap that was broadcast.
   ShardAuthoritativeStatusMap last_broadcast_map_;
 
+  // getState().toShardStatusMap() as of the last call to
+  // updateWorkerShardStatusMap(), without authoritative_status_overrides.
+  // Kept up to date incrementally: only the shard indexes touched by deltas
+  // since then are recomputed, unless the whole state or the storage
+  // membership changed.
+  ShardAuthoritativeStatusMap shard_status_map_;
+  std::set<uint32_t> dirty_shard_indexes_;
+  bool all_shard_indexes_dirty_{true};
+  membership::MembershipVersion::Type shard_status_map_membership_version_{
+      membership::MembershipVersion::EMPTY_VERSION};
+
   std::unique_ptr<SubscriptionHandle> handle_;
 
   // folly::none if this object is not running on a server node.
@@ -140,6 +140,13 @@ void AsyncSocketAdapter::writeChain(WriteCallback* callback,
   transport_->writeChain(callback, std::move(buf), flags);
 }
 
+bool AsyncSocketAdapter::setZeroCopy(bool enable) {
+  if (dynamic_cast<folly::AsyncSSLSocket*>(transport_.get()) != nullptr) {
+    return false;
+  }
+  return transport_->setZeroCopy(enable);
+}
+
 int AsyncSocketAdapter::setSendBufSize(size_t bufsize) {
   return transport_->setSendBufSize(bufsize);
 }
@@ -236,6 +236,12 @@ class AsyncSocketAdapter : public SocketAdapter {
                   std::unique_ptr<folly::IOBuf>&& buf,
                   folly::WriteFlags flags = folly::WriteFlags::NONE) override;
 
+  /**
+   * Enables MSG_ZEROCOPY on plain sockets. SSL sockets encrypt into their
+   * own buffers, there is nothing to gain.
+   */
+  bool setZeroCopy(bool enable) override;
+
   /**
    * Set the send bufsize
    */
@@ -56,6 +56,7 @@ std::unique_ptr<Connection> AsyncSocketConnectionFactory::createConnection(
     sock_adapter = std::make_unique<AsyncSocketAdapter>(base_);
   }
   const auto throttle_setting = deps->getSettings().connect_throttle;
+  const double throttle_jitter = deps->getSettings().connect_throttle_jitter;
   auto connection = std::make_unique<Connection>(node_id,
                                                  socket_type,
                                                  connection_type,
@@ -65,7 +66,8 @@ std::unique_ptr<Connection> AsyncSocketConnectionFactory::createConnection(
   auto it = connect_throttle_map_.find(node_id);
   if (it == connect_throttle_map_.end()) {
     auto res = connect_throttle_map_.emplace(
-        node_id, std::make_unique<ConnectThrottle>(throttle_setting));
+        node_id,
+        std::make_unique<ConnectThrottle>(throttle_setting, throttle_jitter));
     ld_check(res.second);
     it = res.first;
     ld_check(it->second);
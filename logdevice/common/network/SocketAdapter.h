@@ -177,6 +177,19 @@ class SocketAdapter {
              std::unique_ptr<folly::IOBuf>&& buf,
              folly::WriteFlags flags = folly::WriteFlags::NONE) = 0;
 
+  /**
+   * Enable or disable MSG_ZEROCOPY on the socket. Once enabled, writeChain()
+   * with folly::WriteFlags::WRITE_MSG_ZEROCOPY hands the buffers to the kernel
+   * without copying them and keeps the chain alive until the kernel reports
+   * it no longer needs it.
+   *
+   * @return  true if zero-copy writes are now enabled, false if the socket
+   *          (e.g. an SSL one) or the kernel doesn't support them.
+   */
+  virtual bool setZeroCopy(bool /* enable */) {
+    return false;
+  }
+
   /**
    * Set the send bufsize
    */
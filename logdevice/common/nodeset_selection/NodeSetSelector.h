@@ -48,6 +48,14 @@ class NodeSetSelector {
     // Nodes that shouldn't be picked into nodeset
     // (as if they weren't in config).
     std::unordered_set<node_index_t> exclude_nodes;
+
+    // If true, and the previous nodeset was selected with the same seed, keep
+    // as many shards of the previous nodeset as possible and only replace or
+    // add the shards needed to satisfy the size, balance and replication
+    // constraints. This avoids reshuffling nodesets of many logs (and making
+    // readers contact the union of old and new nodesets) after a small change
+    // in the cluster. A change of seed still re-selects the whole nodeset.
+    bool incremental = false;
   };
 
   struct Result {
@@ -110,6 +118,20 @@ class NodeSetSelector {
       const Options* options = nullptr) = 0;
 
   virtual ~NodeSetSelector() {}
+
+ protected:
+  // Returns the shards of the previous nodeset that an incremental selection
+  // should prefer (see Options::incremental), or nullptr if the nodeset
+  // should be selected from scratch.
+  static const StorageSet* getShardsToKeep(const EpochMetaData* prev,
+                                           uint64_t seed,
+                                           const Options* options) {
+    if (options == nullptr || !options->incremental || prev == nullptr ||
+        prev->nodeset_params.seed != seed) {
+      return nullptr;
+    }
+    return &prev->shards;
+  }
 };
 
 }} // namespace facebook::logdevice
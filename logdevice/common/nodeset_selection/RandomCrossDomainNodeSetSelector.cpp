@@ -273,6 +273,7 @@ NodeSetSelector::Result RandomCrossDomainNodeSetSelector::getStorageSet(
   ld_check(num_domains > 0);
 
   const size_t nodes_per_domain = nodeset_size / num_domains;
+  const StorageSet* shards_to_keep = getShardsToKeep(prev, seed, options);
 
   for (const auto& kv : domain_map) {
     const auto& domain_nodes = kv.second;
@@ -299,7 +300,8 @@ NodeSetSelector::Result RandomCrossDomainNodeSetSelector::getStorageSet(
                                               nodes_configuration,
                                               domain_nodes,
                                               nodes_per_domain,
-                                              options);
+                                              options,
+                                              shards_to_keep);
 
     if (selected_nodes == nullptr) {
       ld_error(
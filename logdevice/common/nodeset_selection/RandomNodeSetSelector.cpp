@@ -34,7 +34,8 @@ std::unique_ptr<StorageSet> RandomNodeSetSelector::randomlySelectNodes(
     const configuration::nodes::NodesConfiguration& nodes_configuration,
     const NodeSetIndices& eligible_nodes,
     size_t nodeset_size,
-    const Options* options) {
+    const Options* options,
+    const StorageSet* shards_to_keep) {
   if (nodeset_size > eligible_nodes.size()) {
     return nullptr;
   }
@@ -79,6 +80,14 @@ std::unique_ptr<StorageSet> RandomNodeSetSelector::randomlySelectNodes(
   }
 
   std::shuffle(candidates->begin(), candidates->end(), rnd_);
+  if (shards_to_keep != nullptr) {
+    std::stable_partition(
+        candidates->begin(), candidates->end(), [&](ShardID shard) {
+          return std::find(shards_to_keep->begin(),
+                           shards_to_keep->end(),
+                           shard) != shards_to_keep->end();
+        });
+  }
   candidates->resize(nodeset_size);
 
   ld_check(nodeset_size == candidates->size());
@@ -166,7 +175,8 @@ NodeSetSelector::Result RandomNodeSetSelector::getStorageSet(
                           nodes_configuration,
                           all_nodes_indices,
                           nodeset_size,
-                          options);
+                          options,
+                          getShardsToKeep(prev, seed, options));
 
   if (candidates == nullptr) {
     // We select from the entire cluster, a valid configuration should
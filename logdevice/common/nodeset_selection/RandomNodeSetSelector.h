@@ -45,14 +45,16 @@ class RandomNodeSetSelector : public NodeSetSelector {
 
  protected:
   // randomly select a nodeset of size @nodeset_size from a pool of candidate
-  // nodes @eligible_nodes
+  // nodes @eligible_nodes. Candidates in @shards_to_keep, if given, are
+  // selected before all others.
   std::unique_ptr<StorageSet> randomlySelectNodes(
       logid_t log_id,
       const Configuration* config,
       const configuration::nodes::NodesConfiguration& nodes_configuration,
       const NodeSetIndices& eligible_nodes,
       size_t nodeset_size,
-      const Options* options);
+      const Options* options,
+      const StorageSet* shards_to_keep = nullptr);
 
  private:
   std::default_random_engine rnd_;
@@ -9,6 +9,8 @@
 
 #include <map>
 #include <queue>
+#include <tuple>
+#include <unordered_set>
 #include <utility>
 
 #include <folly/Random.h>
@@ -83,15 +85,27 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
                static_cast<nodeset_size_t>(
                    replication_property.getReplicationFactor() * 2 - 1));
 
+  // In incremental mode, shards of the previous nodeset are picked before
+  // all other shards of their domain, and domains that had more of them are
+  // preferred when breaking ties, so that only the shards that are needed to
+  // satisfy the constraints change.
+  std::unordered_set<ShardID, ShardID::Hash> shards_to_keep;
+  if (const StorageSet* prev_shards = getShardsToKeep(prev, seed, options)) {
+    shards_to_keep.insert(prev_shards->begin(), prev_shards->end());
+  }
+
   struct CandidateNode {
     uint64_t shard_id_hash;
     ShardID shard_id;
     bool is_writable;
+    bool is_kept;
   };
 
   struct Domain {
     int num_picked = 0;
     int num_picked_writable = 0;
+    // Number of candidates that are in shards_to_keep.
+    int num_kept = 0;
 
     uint64_t priority;
 
@@ -151,6 +165,7 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     CandidateNode n;
     n.shard_id = shard;
     n.is_writable = membership->canWriteToShard(shard);
+    n.is_kept = shards_to_keep.count(shard) > 0;
 
     // If consistent hashing is toggled, hash the log id along with the shard
     // ID, thereby allowing us to create a unique, deterministic ranking of
@@ -163,7 +178,9 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     } else {
       n.shard_id_hash = folly::Random::rand64();
     }
-    domains[location_str].nodes.push_back(n);
+    Domain& domain = domains[location_str];
+    domain.nodes.push_back(n);
+    domain.num_kept += n.is_kept;
   }
 
   for (auto& kv : domains) {
@@ -175,9 +192,11 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
               d->nodes.end(),
               [](const CandidateNode& a, const CandidateNode& b) {
                 // Sort in order of decreasing hash, so that we pick nodes with
-                // smaller hash first (for historical reasons).
-                return std::tie(a.shard_id_hash, a.shard_id) >
-                    std::tie(b.shard_id_hash, b.shard_id);
+                // smaller hash first (for historical reasons). Kept shards go
+                // to the back to be picked before the others.
+                return std::make_tuple(
+                           !a.is_kept, a.shard_id_hash, a.shard_id) >
+                    std::make_tuple(!b.is_kept, b.shard_id_hash, b.shard_id);
               });
   }
 
@@ -220,10 +239,14 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
 
   auto select_nodes = [&](bool only_writable) {
     auto cmp = [&](Domain* a, Domain* b) {
-      return std::tie(only_writable ? a->num_picked_writable : a->num_picked,
-                      a->priority) >
-          std::tie(only_writable ? b->num_picked_writable : b->num_picked,
-                   b->priority);
+      return std::make_tuple(
+                 only_writable ? a->num_picked_writable : a->num_picked,
+                 -a->num_kept,
+                 a->priority) >
+          std::make_tuple(
+                 only_writable ? b->num_picked_writable : b->num_picked,
+                 -b->num_kept,
+                 b->priority);
     };
     std::priority_queue<Domain*, std::vector<Domain*>, decltype(cmp)> queue(
         cmp);
@@ -12,6 +12,7 @@
 #include "logdevice/common/Request.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/include/types.h"
 
 namespace facebook { namespace logdevice {
@@ -86,6 +87,12 @@ struct APPENDED_Header {
   // preemptor doesn't seem to be alive. In that case clients need to retry the
   // append rather than follow the redirect.
   static const APPENDED_flags_t REDIRECT_NOT_ALIVE = 4;
+  // Only set on successful appends. The sliding window of the sequencer was
+  // close to full when the append completed (see
+  // Settings::append_overload_hint_window_fill), so further appends are
+  // likely to fail with E::SEQNOBUFS. Clients use this to probe before
+  // sending large payloads. Older clients ignore the flag.
+  static const APPENDED_flags_t SEQUENCER_OVERLOADED = 8;
 };
 
 static_assert(sizeof(APPENDED_Header) ==
@@ -93,7 +100,8 @@ static_assert(sizeof(APPENDED_Header) ==
                    sizeof(NodeID) + sizeof(Status) + sizeof(APPENDED_flags_t)),
               "APPENDED_Header has unexpected compiler inserted padding");
 
-class APPENDED_Message : public Message {
+class APPENDED_Message : public Message,
+                         public MessagePoolAllocated<APPENDED_Message> {
  public:
   explicit APPENDED_Message(const APPENDED_Header& header)
       : Message(MessageType::APPENDED, TrafficClass::APPEND), header_(header) {}
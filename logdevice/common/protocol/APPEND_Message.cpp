@@ -49,6 +49,11 @@ void APPEND_Message::serialize(ProtocolWriter& writer) const {
     proto_supported_header.flags &= ~(APPEND_Header::WRITE_STREAM_REQUEST |
                                       APPEND_Header::WRITE_STREAM_RESUME);
   }
+  ld_check_eq((header_.flags & APPEND_Header::E2E_TRACING_ON) > 0,
+              e2e_trace_id_ != E2E_TRACE_ID_INVALID);
+  if (writer.proto() < Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT) {
+    proto_supported_header.flags &= ~APPEND_Header::E2E_TRACING_ON;
+  }
   writer.write(proto_supported_header);
   if (header_.flags & APPEND_Header::LSN_BEFORE_REDIRECT) {
     writer.write(lsn_before_redirect_);
@@ -86,6 +91,9 @@ void APPEND_Message::serialize(ProtocolWriter& writer) const {
           &write_stream_request_id_, sizeof(write_stream_request_id_t));
     }
   }
+  if (proto_supported_header.flags & APPEND_Header::E2E_TRACING_ON) {
+    writer.write(e2e_trace_id_);
+  }
 
   // If we are supposed to checksum the payload, calculate it now and inject the
   // checksum at the front of the payload.
@@ -184,14 +192,21 @@ MessageReadResult APPEND_Message::deserialize(ProtocolReader& reader) {
       reader.read(&req_id);
     }
   }
+  e2e_trace_id_t e2e_trace_id = E2E_TRACE_ID_INVALID;
+  if (reader.proto() >= Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT &&
+      (header.flags & APPEND_Header::E2E_TRACING_ON)) {
+    reader.read(&e2e_trace_id);
+  }
 
   size_t payload_size = reader.bytesRemaining();
   ld_check(payload_size < Message::MAX_LEN);
   PayloadHolder ph = PayloadHolder::deserialize(reader, payload_size);
 
   return reader.result([&] {
-    return new APPEND_Message(
+    auto m = new APPEND_Message(
         header, lsn_before_redirect, std::move(attrs), std::move(ph), req_id);
+    m->e2e_trace_id_ = e2e_trace_id;
+    return m;
   });
 }
 
@@ -222,6 +237,9 @@ Message::Disposition APPEND_Message::onReceived(const Address& from) {
   if (header_.flags & APPEND_Header::WRITE_STREAM_REQUEST) {
     append_prep->setWriteStreamRequestId(write_stream_request_id_);
   }
+  if (header_.flags & APPEND_Header::E2E_TRACING_ON) {
+    append_prep->setE2ETraceId(e2e_trace_id_);
+  }
   append_prep->execute();
 
   return Disposition::NORMAL;
@@ -277,6 +295,7 @@ APPEND_Message::getDebugInfo() const {
     FLAG(CUSTOM_KEY)
     FLAG(NO_ACTIVATION)
     FLAG(CUSTOM_COUNTERS)
+    FLAG(E2E_TRACING_ON)
 #undef FLAG
     return folly::join('|', strings);
   };
@@ -15,6 +15,8 @@
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/Request.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
+#include "logdevice/common/types_internal.h"
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
 
@@ -71,6 +73,10 @@ struct APPEND_Header {
 
   static constexpr APPEND_flags_t CUSTOM_COUNTERS = 1u << 10; // 1024
 
+  // The append was sampled for end-to-end tracing, see E2ETracer. The trace
+  // id follows the write stream request id on the wire.
+  static constexpr APPEND_flags_t E2E_TRACING_ON = 1u << 11; // 2048
+
   // Append request belongs to a stream.
   static constexpr APPEND_flags_t WRITE_STREAM_REQUEST = 1u << 12; // 4096
   // Used by stream writer to denote that the append message is next in
@@ -80,7 +86,8 @@ struct APPEND_Header {
   static constexpr APPEND_flags_t FORCE = NO_REDIRECT | REACTIVATE_IF_PREEMPTED;
 } __attribute__((__packed__));
 
-class APPEND_Message : public Message {
+class APPEND_Message : public Message,
+                       public MessagePoolAllocated<APPEND_Message> {
  public:
   APPEND_Message(const APPEND_Header& header,
                  lsn_t lsn_before_redirect,
@@ -125,6 +132,9 @@ class APPEND_Message : public Message {
 
   const APPEND_Header header_;
 
+  // Set if E2E_TRACING_ON is set in header_.flags.
+  e2e_trace_id_t e2e_trace_id_ = E2E_TRACE_ID_INVALID;
+
   virtual std::vector<std::pair<std::string, folly::dynamic>>
   getDebugInfo() const override;
 
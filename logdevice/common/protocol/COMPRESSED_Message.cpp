@@ -0,0 +1,180 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
+
+#include <cstring>
+
+#include <folly/Varint.h>
+#include <lz4.h>
+#include <lz4hc.h>
+#include <zstd.h>
+
+#include "logdevice/common/checks.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolHeader.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+
+namespace facebook { namespace logdevice {
+
+// Compression happens on the Worker thread sending the message, keep it cheap.
+static constexpr int ZSTD_LEVEL = 1;
+
+std::unique_ptr<folly::IOBuf>
+COMPRESSED_Message::compress(folly::IOBuf& message,
+                             Compression compression,
+                             uint16_t proto) {
+  ld_check(compression == Compression::ZSTD ||
+           compression == Compression::LZ4 ||
+           compression == Compression::LZ4_HC);
+  const folly::ByteRange src = message.coalesce();
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(MessageType::COMPRESSED, proto);
+  const size_t compressed_bound = compression == Compression::ZSTD
+      ? ZSTD_compressBound(src.size())
+      : LZ4_compressBound(src.size());
+  const size_t capacity = protohdr_bytes + 1 + folly::kMaxVarintLength64 +
+      compressed_bound;
+
+  auto frame = folly::IOBuf::create(capacity);
+  uint8_t* out = frame->writableData() + protohdr_bytes;
+  uint8_t* const end = frame->writableData() + capacity;
+  *out++ = static_cast<uint8_t>(compression);
+  out += folly::encodeVarint(src.size(), out);
+
+  size_t compressed_size;
+  if (compression == Compression::ZSTD) {
+    compressed_size =
+        ZSTD_compress(out, end - out, src.data(), src.size(), ZSTD_LEVEL);
+    if (ZSTD_isError(compressed_size)) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "ZSTD_compress() failed: %s",
+                      ZSTD_getErrorName(compressed_size));
+      return nullptr;
+    }
+  } else {
+    const int rv = compression == Compression::LZ4
+        ? LZ4_compress_default((const char*)src.data(),
+                               (char*)out,
+                               src.size(),
+                               end - out)
+        : LZ4_compress_HC((const char*)src.data(),
+                          (char*)out,
+                          src.size(),
+                          end - out,
+                          0);
+    if (rv <= 0) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "LZ4 compression failed with error %d",
+                      rv);
+      return nullptr;
+    }
+    compressed_size = rv;
+  }
+  out += compressed_size;
+  ld_check(out <= end);
+
+  const size_t frame_len = out - frame->data();
+  if (frame_len >= src.size()) {
+    // Not worth it.
+    return nullptr;
+  }
+
+  ProtocolHeader protohdr;
+  protohdr.len = frame_len;
+  protohdr.type = MessageType::COMPRESSED;
+  protohdr.cksum = 0;
+  memcpy(frame->writableData(), &protohdr, protohdr_bytes);
+  frame->append(frame_len);
+  return frame;
+}
+
+std::unique_ptr<folly::IOBuf>
+COMPRESSED_Message::decompress(folly::IOBuf& body) {
+  folly::ByteRange range = body.coalesce();
+  if (range.empty()) {
+    err = E::BADMSG;
+    return nullptr;
+  }
+  const auto compression = static_cast<Compression>(range.front());
+  range.advance(1);
+
+  // Refuse to allocate more than the largest valid message, whatever the
+  // peer claims.
+  auto size = folly::tryDecodeVarint(range);
+  if (!size.hasValue() || size.value() < sizeof(ProtocolHeader::len) ||
+      size.value() > Message::MAX_LEN + sizeof(ProtocolHeader)) {
+    err = E::BADMSG;
+    return nullptr;
+  }
+  const size_t message_len = size.value();
+
+  auto message = folly::IOBuf::create(message_len);
+  switch (compression) {
+    case Compression::ZSTD: {
+      const size_t rv = ZSTD_decompress(
+          message->writableData(), message_len, range.data(), range.size());
+      if (ZSTD_isError(rv) || rv != message_len) {
+        RATELIMIT_ERROR(std::chrono::seconds(10),
+                        1,
+                        "ZSTD decompression of a %zu-byte message failed: %s",
+                        message_len,
+                        ZSTD_isError(rv) ? ZSTD_getErrorName(rv)
+                                         : "length mismatch");
+        err = E::BADMSG;
+        return nullptr;
+      }
+      break;
+    }
+    case Compression::LZ4:
+    case Compression::LZ4_HC: {
+      const int rv = LZ4_decompress_safe((const char*)range.data(),
+                                         (char*)message->writableData(),
+                                         range.size(),
+                                         message_len);
+      if (rv < 0 || static_cast<size_t>(rv) != message_len) {
+        RATELIMIT_ERROR(std::chrono::seconds(10),
+                        1,
+                        "LZ4 decompression of a %zu-byte message failed "
+                        "with %d",
+                        message_len,
+                        rv);
+        err = E::BADMSG;
+        return nullptr;
+      }
+      break;
+    }
+    default:
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      1,
+                      "Invalid compression 0x%02x in COMPRESSED frame",
+                      (uint8_t)compression);
+      err = E::BADMSG;
+      return nullptr;
+  }
+  message->append(message_len);
+  return message;
+}
+
+MessageReadResult COMPRESSED_Message::deserialize(ProtocolReader& reader) {
+  ld_check(false);
+  return reader.errorResult(E::INTERNAL);
+}
+
+void COMPRESSED_Message::serialize(ProtocolWriter&) const {
+  ld_check(false);
+}
+
+Message::Disposition COMPRESSED_Message::onReceived(const Address&) {
+  ld_check(false);
+  err = E::INTERNAL;
+  return Disposition::ERROR;
+}
+
+}} // namespace facebook::logdevice
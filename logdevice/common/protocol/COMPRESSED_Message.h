@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include <folly/io/IOBuf.h>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file COMPRESSED is not a message of its own but a frame around another
+ *       serialized message, ProtocolHeader included, compressed. Connection
+ *       wraps messages of at least --message-compression-min-size bytes into
+ *       it on connections that cross --message-compression-boundary, and
+ *       unwraps it before deserializing the message inside, which goes
+ *       through checksum verification, validation and stats like any other.
+ *
+ *       Body: Compression (1 byte), varint size of the wrapped message,
+ *       compressed bytes of the wrapped message. The frame's own checksum is
+ *       always 0, the wrapped message carries its own.
+ *
+ *       Each message is compressed independently, so that a frame can be
+ *       decompressed without the ones before it, in whatever order the
+ *       receiving side gets to them.
+ */
+
+class COMPRESSED_Message : public Message {
+ public:
+  /**
+   * @param message  a message serialized by Connection, with its
+   *                 ProtocolHeader. Coalesced by this call.
+   *
+   * @return  the COMPRESSED frame for `message`, ProtocolHeader included, or
+   *          nullptr if compression with `compression` didn't make it
+   *          smaller.
+   */
+  static std::unique_ptr<folly::IOBuf> compress(folly::IOBuf& message,
+                                                Compression compression,
+                                                uint16_t proto);
+
+  /**
+   * @param body  the body of a COMPRESSED frame, without its ProtocolHeader.
+   *              Coalesced by this call.
+   *
+   * @return  the wrapped message, ProtocolHeader included. nullptr with err
+   *          set to E::BADMSG if the body is malformed.
+   */
+  static std::unique_ptr<folly::IOBuf> decompress(folly::IOBuf& body);
+
+  // Frames are unwrapped by Connection, never deserialized, serialized or
+  // received as a Message. These are only here to fill
+  // messageDeserializers.
+  static Message::deserializer_t deserialize;
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+};
+
+}} // namespace facebook::logdevice
@@ -22,7 +22,10 @@ struct CONFIG_CHANGED_Header {
   enum class ConfigType : uint8_t {
     MAIN_CONFIG = 0,
     LOGS_CONFIG = 1,
-    NODES_CONFIGURATION = 2
+    NODES_CONFIGURATION = 2,
+    // The body is a NodesConfigurationDelta against the delta_base_version
+    // of the CONFIG_FETCH this is a reply to
+    NODES_CONFIGURATION_DELTA = 3
   };
   enum class Action : uint8_t {
     // Used by RemoteLogsConfig to signal that current config should be
@@ -14,7 +14,9 @@
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/configuration/nodes/NodesConfigurationCodec.h"
+#include "logdevice/common/configuration/nodes/NodesConfigurationDelta.h"
 #include "logdevice/common/protocol/CONFIG_CHANGED_Message.h"
+#include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
 
@@ -25,6 +27,10 @@ void CONFIG_FETCH_Header::serialize(ProtocolWriter& writer) const {
     writer.write(my_version);
   }
   writer.write(config_type);
+  if (writer.proto() >=
+      Compatibility::ProtocolVersion::NODES_CONFIGURATION_DELTA_SUPPORT) {
+    writer.write(delta_base_version);
+  }
 }
 
 CONFIG_FETCH_Header CONFIG_FETCH_Header::deserialize(ProtocolReader& reader) {
@@ -40,10 +46,17 @@ CONFIG_FETCH_Header CONFIG_FETCH_Header::deserialize(ProtocolReader& reader) {
 
   reader.read(&config_type);
 
+  uint64_t delta_base_version = 0;
+  if (reader.proto() >=
+      Compatibility::ProtocolVersion::NODES_CONFIGURATION_DELTA_SUPPORT) {
+    reader.read(&delta_base_version);
+  }
+
   return CONFIG_FETCH_Header{
       rid,
       config_type,
       my_version,
+      delta_base_version,
   };
 }
 
@@ -163,7 +176,19 @@ CONFIG_FETCH_Message::handleNodesConfigurationRequest(const Address& from) {
     // The requester already have an up to date version.
     hdr.status = Status::UPTODATE;
     msg = std::make_unique<CONFIG_CHANGED_Message>(hdr, "");
-  } else {
+  } else if (header_.delta_base_version != 0 &&
+             header_.delta_base_version < nodes_cfg->getVersion().val()) {
+    std::string delta =
+        getNodesConfigurationDelta(header_.delta_base_version, *nodes_cfg);
+    if (!delta.empty()) {
+      WORKER_STAT_INCR(nodes_configuration_delta_sent);
+      hdr.config_type =
+          CONFIG_CHANGED_Header::ConfigType::NODES_CONFIGURATION_DELTA;
+      msg = std::make_unique<CONFIG_CHANGED_Message>(hdr, std::move(delta));
+    }
+  }
+
+  if (msg == nullptr) {
     auto serialized = nodes_cfg->serialize();
     if (!serialized) {
       // Failed to serialize configuration, the details should have been logged
@@ -197,6 +222,13 @@ CONFIG_FETCH_Message::getNodesConfiguration() {
   return Worker::onThisThread()->getNodesConfiguration();
 }
 
+std::string CONFIG_FETCH_Message::getNodesConfigurationDelta(
+    uint64_t base_version,
+    const configuration::nodes::NodesConfiguration& target) {
+  return Worker::onThisThread()->nodesConfigurationHistory().getDelta(
+      membership::MembershipVersion::Type(base_version), target);
+}
+
 int CONFIG_FETCH_Message::sendMessage(
     std::unique_ptr<CONFIG_CHANGED_Message> msg,
     const Address& to) {
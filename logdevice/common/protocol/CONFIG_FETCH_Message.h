@@ -33,8 +33,12 @@ struct CONFIG_FETCH_Header {
   CONFIG_FETCH_Header() = default;
   CONFIG_FETCH_Header(request_id_t rid,
                       ConfigType config_type,
-                      uint64_t my_version = 0)
-      : rid(rid), my_version(my_version), config_type(config_type) {}
+                      uint64_t my_version = 0,
+                      uint64_t delta_base_version = 0)
+      : rid(rid),
+        my_version(my_version),
+        config_type(config_type),
+        delta_base_version(delta_base_version) {}
 
   explicit CONFIG_FETCH_Header(ConfigType config_type, uint64_t my_version = 0)
       : CONFIG_FETCH_Header(REQUEST_ID_INVALID, config_type, my_version) {}
@@ -53,10 +57,17 @@ struct CONFIG_FETCH_Header {
   // sent.
   uint64_t my_version;
   ConfigType config_type;
+
+  // Only for NODES_CONFIGURATION. If nonzero, the requester has the
+  // NodesConfiguration of this version and accepts a reply of type
+  // NODES_CONFIGURATION_DELTA against it. The responder may still send the
+  // full config. Only sent in protocol NODES_CONFIGURATION_DELTA_SUPPORT and
+  // later.
+  uint64_t delta_base_version{0};
 } __attribute__((__packed__));
 
-static_assert(sizeof(CONFIG_FETCH_Header) == 17,
-              "CONFIG_FETCH_Header is expected to be 17 byte");
+static_assert(sizeof(CONFIG_FETCH_Header) == 25,
+              "CONFIG_FETCH_Header is expected to be 25 byte");
 
 class CONFIG_FETCH_Message : public Message {
  public:
@@ -85,6 +96,11 @@ class CONFIG_FETCH_Message : public Message {
   virtual NodeID getMyNodeID() const;
   virtual std::shared_ptr<const configuration::nodes::NodesConfiguration>
   getNodesConfiguration();
+  // Returns `target` encoded as a delta against the NodesConfiguration of
+  // version base_version, or an empty string if that's not possible.
+  virtual std::string getNodesConfigurationDelta(
+      uint64_t base_version,
+      const configuration::nodes::NodesConfiguration& target);
 
   virtual int sendMessage(std::unique_ptr<CONFIG_CHANGED_Message> msg,
                           const Address& to);
@@ -53,6 +53,34 @@ enum ProtocolVersion : uint16_t {
 
   GET_RSM_SNAPSHOT_MESSAGE_SUPPORT, // = 103
 
+  // Connections may wrap messages into COMPRESSED frames
+  COMPRESSED_MESSAGE_SUPPORT, // = 104
+
+  // Storage nodes may reply to several STOREs with one STORED_BATCH message
+  STORED_BATCH_SUPPORT, // = 105
+
+  // CONFIG_FETCH may ask for the NodesConfiguration as a delta against the
+  // version the requester has
+  NODES_CONFIGURATION_DELTA_SUPPORT, // = 106
+
+  // GOSSIP may encode its node list and versions with varints
+  COMPACT_GOSSIP_ENCODING, // = 107
+
+  // APPEND, STORE and START may carry an end-to-end trace id
+  E2E_TRACING_SUPPORT, // = 108
+
+  // Clients may ask a sequencer node for the tail attributes of many logs
+  // with one GET_TAIL_ATTRIBUTES_BULK message
+  TAIL_ATTRIBUTES_BULK_SUPPORT, // = 109
+
+  // Clients may ask a storage node to run findTime() for several logs with
+  // one FINDKEY_BATCH message
+  FINDKEY_BATCH_SUPPORT, // = 110
+
+  // Clients may trim several logs on a storage node with one TRIM_BATCH
+  // message
+  TRIM_BATCH_SUPPORT, // = 111
+
   // NOTE: insert new protocol versions here
 
   // Maximum version number of the protocol this version of LogDevice
@@ -77,6 +105,14 @@ static_assert(HEALTH_MONITOR_SUPPORT_IN_GOSSIP == 100, "");
 static_assert(NODE_STATUS_AND_HASHMAP_SUPPORT_IN_CLUSTER_STATE == 101, "");
 static_assert(INCLUDE_VERSIONS_IN_GOSSIP == 102, "");
 static_assert(GET_RSM_SNAPSHOT_MESSAGE_SUPPORT == 103, "");
+static_assert(COMPRESSED_MESSAGE_SUPPORT == 104, "");
+static_assert(STORED_BATCH_SUPPORT == 105, "");
+static_assert(NODES_CONFIGURATION_DELTA_SUPPORT == 106, "");
+static_assert(COMPACT_GOSSIP_ENCODING == 107, "");
+static_assert(E2E_TRACING_SUPPORT == 108, "");
+static_assert(TAIL_ATTRIBUTES_BULK_SUPPORT == 109, "");
+static_assert(FINDKEY_BATCH_SUPPORT == 110, "");
+static_assert(TRIM_BATCH_SUPPORT == 111, "");
 
 constexpr uint16_t MIN_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_LOWER_BOUND + 1;
 constexpr uint16_t MAX_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_UPPER_BOUND - 1;
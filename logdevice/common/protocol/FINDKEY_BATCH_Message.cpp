@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/FINDKEY_BATCH_Message.h"
+
+#include "logdevice/common/FindKeyRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+FINDKEY_BATCH_Message::FINDKEY_BATCH_Message(
+    std::vector<FINDKEY_Header> headers)
+    : Message(MessageType::FINDKEY_BATCH, TrafficClass::READ_BACKLOG),
+      headers_(std::move(headers)) {}
+
+void FINDKEY_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  writer.writeLengthPrefixedVector(headers_);
+}
+
+MessageReadResult FINDKEY_BATCH_Message::deserialize(ProtocolReader& reader) {
+  std::vector<FINDKEY_Header> headers;
+  reader.readLengthPrefixedVector(&headers);
+  if (reader.ok()) {
+    for (const FINDKEY_Header& header : headers) {
+      if (!canBatch(header)) {
+        ld_error("PROTOCOL ERROR: got a FINDKEY_BATCH message with a findKey "
+                 "entry for log %lu (flags %u)",
+                 header.log_id.val_,
+                 header.flags);
+        return reader.errorResult(E::BADMSG);
+      }
+    }
+  }
+  return reader.result(
+      [&] { return new FINDKEY_BATCH_Message(std::move(headers)); });
+}
+
+uint16_t FINDKEY_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::FINDKEY_BATCH_SUPPORT;
+}
+
+void FINDKEY_BATCH_Message::onSent(Status status, const Address& to) const {
+  Message::onSent(status, to);
+
+  // Inform every FindKeyRequest of the outcome of sending the message
+  auto& rqmap = Worker::onThisThread()->runningFindKey().map;
+  for (const FINDKEY_Header& header : headers_) {
+    auto it = rqmap.find(header.client_rqid);
+    if (it == rqmap.end()) {
+      continue;
+    }
+    ShardID shard(to.id_.node_.index(), header.shard);
+    if (status == E::PROTONOSUPPORT) {
+      it->second->onBatchNotSupported(shard);
+    } else {
+      it->second->onMessageSent(shard, status);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/FINDKEY_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file FINDKEY_BATCH carries several findTime() FINDKEY messages for the
+ *       same storage node, each entry exactly the header a FINDKEY message
+ *       would have carried. findKey() entries, which are followed by a key,
+ *       can't be batched. The storage node replies with FINDKEY_BATCH_REPLY
+ *       messages, and the client processes every entry as if it had come in
+ *       its own FINDKEY message. Sent by FindKeyBatcher.
+ */
+
+class FINDKEY_BATCH_Message : public Message {
+ public:
+  explicit FINDKEY_BATCH_Message(std::vector<FINDKEY_Header> headers);
+
+  /**
+   * @return true if a FINDKEY message with this header carries nothing else,
+   *         and can thus be sent as part of a FINDKEY_BATCH.
+   */
+  static bool canBatch(const FINDKEY_Header& header) {
+    return !(header.flags & FINDKEY_Header::USER_KEY);
+  }
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address&) override {
+    // Receipt handler lives in server/FINDKEY_BATCH_onReceived.cpp; this
+    // should never get called.
+    std::abort();
+  }
+  void onSent(Status st, const Address& to) const override;
+  uint16_t getMinProtocolVersion() const override;
+
+  int8_t getExecutorPriority() const override {
+    return folly::Executor::LO_PRI;
+  }
+
+  static Message::deserializer_t deserialize;
+
+  std::vector<FINDKEY_Header> headers_;
+};
+
+}} // namespace facebook::logdevice
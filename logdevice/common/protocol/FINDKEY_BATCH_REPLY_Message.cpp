@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/FINDKEY_BATCH_REPLY_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+FINDKEY_BATCH_REPLY_Message::FINDKEY_BATCH_REPLY_Message(
+    std::vector<FINDKEY_REPLY_Header> headers)
+    : Message(MessageType::FINDKEY_BATCH_REPLY, TrafficClass::READ_BACKLOG),
+      headers_(std::move(headers)) {}
+
+void FINDKEY_BATCH_REPLY_Message::serialize(ProtocolWriter& writer) const {
+  writer.writeLengthPrefixedVector(headers_);
+}
+
+MessageReadResult
+FINDKEY_BATCH_REPLY_Message::deserialize(ProtocolReader& reader) {
+  std::vector<FINDKEY_REPLY_Header> headers;
+  reader.readLengthPrefixedVector(&headers);
+  return reader.result(
+      [&] { return new FINDKEY_BATCH_REPLY_Message(std::move(headers)); });
+}
+
+Message::Disposition
+FINDKEY_BATCH_REPLY_Message::onReceived(const Address& from) {
+  if (from.isClientAddress()) {
+    ld_error("got FINDKEY_BATCH_REPLY message from client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  for (const FINDKEY_REPLY_Header& header : headers_) {
+    FINDKEY_REPLY_Message msg(header);
+    if (msg.onReceived(from) == Disposition::ERROR) {
+      return Disposition::ERROR;
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+uint16_t FINDKEY_BATCH_REPLY_Message::getMinProtocolVersion() const {
+  return Compatibility::FINDKEY_BATCH_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
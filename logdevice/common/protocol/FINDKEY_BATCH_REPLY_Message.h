@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/FINDKEY_REPLY_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Reply to some of the entries of a FINDKEY_BATCH message, each
+ *       exactly what a FINDKEY_REPLY message would have carried. A storage
+ *       node answers the entries it can answer right away with one such
+ *       message, and the others with one message per shard once they have
+ *       been looked up in the local log store.
+ */
+
+class FINDKEY_BATCH_REPLY_Message : public Message {
+ public:
+  explicit FINDKEY_BATCH_REPLY_Message(
+      std::vector<FINDKEY_REPLY_Header> headers);
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  std::vector<FINDKEY_REPLY_Header> headers_;
+};
+
+}} // namespace facebook::logdevice
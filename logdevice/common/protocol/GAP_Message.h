@@ -10,6 +10,7 @@
 #include <string>
 
 #include "logdevice/common/protocol/FixedSizeMessage.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/EnumMap.h"
 #include "logdevice/include/Record.h"
@@ -74,7 +75,8 @@ struct GAP_Header {
   std::string identify() const;
 } __attribute((packed));
 
-class GAP_Message : public Message {
+class GAP_Message : public Message,
+                    public MessagePoolAllocated<GAP_Message> {
  public:
   // identifies the origin of the gap
   enum class Source { LOCAL_LOG_STORE, CACHED_DIGEST };
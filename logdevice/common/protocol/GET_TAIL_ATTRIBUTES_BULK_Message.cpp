@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_Message.h"
+
+#include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/GetTailAttributesBulkRequest.h"
+#include "logdevice/common/MetaDataLog.h"
+#include "logdevice/common/OffsetMap.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Sequencer.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_REPLY_Message.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+GET_TAIL_ATTRIBUTES_BULK_Message::GET_TAIL_ATTRIBUTES_BULK_Message(
+    request_id_t request_id,
+    std::vector<logid_t> log_ids)
+    : Message(MessageType::GET_TAIL_ATTRIBUTES_BULK, TrafficClass::RECOVERY),
+      request_id_(request_id),
+      log_ids_(std::move(log_ids)) {}
+
+void GET_TAIL_ATTRIBUTES_BULK_Message::serialize(
+    ProtocolWriter& writer) const {
+  writer.write(request_id_);
+  writer.writeLengthPrefixedVector(log_ids_);
+}
+
+MessageReadResult
+GET_TAIL_ATTRIBUTES_BULK_Message::deserialize(ProtocolReader& reader) {
+  request_id_t request_id;
+  std::vector<logid_t> log_ids;
+  reader.read(&request_id);
+  reader.readLengthPrefixedVector(&log_ids);
+  return reader.result([&] {
+    return new GET_TAIL_ATTRIBUTES_BULK_Message(request_id, std::move(log_ids));
+  });
+}
+
+uint16_t GET_TAIL_ATTRIBUTES_BULK_Message::getMinProtocolVersion() const {
+  return Compatibility::TAIL_ATTRIBUTES_BULK_SUPPORT;
+}
+
+Status
+GET_TAIL_ATTRIBUTES_BULK_Message::getTailAttributes(logid_t log_id,
+                                                    LogTailAttributes* out) {
+  ld_check(out != nullptr);
+  if (MetaDataLog::isMetaDataLog(log_id)) {
+    return E::INVALID_PARAM;
+  }
+
+  std::shared_ptr<Sequencer> sequencer =
+      Worker::onThisThread()->processor_->allSequencers().findSequencer(
+          log_id);
+  if (!sequencer) {
+    return E::NOSEQUENCER;
+  }
+  if (sequencer->checkIfPreempted(sequencer->getCurrentEpoch()).isNodeID()) {
+    return E::REDIRECTED;
+  }
+  if (sequencer->getState() != Sequencer::State::ACTIVE ||
+      !sequencer->isRecoveryComplete()) {
+    return E::AGAIN;
+  }
+
+  auto tail = sequencer->getTailRecord();
+  if (!tail) {
+    return E::AGAIN;
+  }
+  out->last_released_real_lsn = tail->header.lsn;
+  out->last_timestamp = std::chrono::milliseconds(tail->header.timestamp);
+  out->offsets = OffsetMap::toRecord(tail->offsets_map_);
+  return E::OK;
+}
+
+Message::Disposition
+GET_TAIL_ATTRIBUTES_BULK_Message::onReceived(const Address& from) {
+  ld_spew("Received a GET_TAIL_ATTRIBUTES_BULK message (rqid:%lu) for %zu "
+          "logs from %s",
+          request_id_.val(),
+          log_ids_.size(),
+          Sender::describeConnection(from).c_str());
+
+  Worker* w = Worker::onThisThread();
+  const bool accepting_work = w->isAcceptingWork();
+
+  std::vector<GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::Entry> entries;
+  entries.reserve(log_ids_.size());
+  for (logid_t log_id : log_ids_) {
+    GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::Entry entry;
+    entry.log_id = log_id;
+    entry.status = accepting_work
+        ? getTailAttributes(log_id, &entry.attributes)
+        : E::SHUTDOWN;
+    entries.push_back(std::move(entry));
+  }
+
+  auto reply = std::make_unique<GET_TAIL_ATTRIBUTES_BULK_REPLY_Message>(
+      request_id_, std::move(entries));
+  if (w->sender().sendMessage(std::move(reply), from) != 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(5),
+                    5,
+                    "Failed to send GET_TAIL_ATTRIBUTES_BULK_REPLY (rqid:%lu, "
+                    "%zu logs) to %s: %s",
+                    request_id_.val(),
+                    log_ids_.size(),
+                    Sender::describeConnection(from).c_str(),
+                    error_description(err));
+  }
+  return Disposition::NORMAL;
+}
+
+void GET_TAIL_ATTRIBUTES_BULK_Message::onSent(Status status,
+                                              const Address& to) const {
+  if (status == E::OK) {
+    return;
+  }
+  auto& rqmap = Worker::onThisThread()->runningGetTailAttributesBulk().map;
+  auto it = rqmap.find(request_id_);
+  if (it != rqmap.end()) {
+    it->second->onMessageSent(to.id_.node_, status, log_ids_);
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/Request.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/LogTailAttributes.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file GET_TAIL_ATTRIBUTES_BULK asks a sequencer node for the tail
+ *       attributes of many data logs at once. Sent by
+ *       GetTailAttributesBulkRequest to the node SequencerLocator picked for
+ *       all of these logs.
+ *
+ *       Unlike GET_SEQ_STATE, the node only answers from sequencers it
+ *       already runs: it doesn't activate sequencers, send redirects, wait
+ *       for recovery or check for remote preemption (as with
+ *       GET_SEQ_STATE's SKIP_REMOTE_PREEMPTION_CHECK). Every log it can't
+ *       answer this way gets an error status in the reply, and the client
+ *       asks about it with a regular GET_SEQ_STATE.
+ */
+
+class GET_TAIL_ATTRIBUTES_BULK_Message : public Message {
+ public:
+  GET_TAIL_ATTRIBUTES_BULK_Message(request_id_t request_id,
+                                   std::vector<logid_t> log_ids);
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  void onSent(Status status, const Address& to) const override;
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  /**
+   * Gets the tail attributes of a log from the sequencer running on this
+   * node, if it can answer right away.
+   *
+   * @return  E::OK if *out was filled, otherwise:
+   *          E::NOSEQUENCER  no sequencer for the log runs on this node
+   *          E::REDIRECTED   the sequencer was preempted
+   *          E::AGAIN        the sequencer is not active, is still doing
+   *                          recovery or doesn't know its tail yet
+   *          E::INVALID_PARAM  log_id is a metadata log
+   */
+  static Status getTailAttributes(logid_t log_id, LogTailAttributes* out);
+
+  // id of the GetTailAttributesBulkRequest, used to route the reply to it
+  request_id_t request_id_;
+
+  std::vector<logid_t> log_ids_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_REPLY_Message.h"
+
+#include "logdevice/common/GetTailAttributesBulkRequest.h"
+#include "logdevice/common/OffsetMap.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::GET_TAIL_ATTRIBUTES_BULK_REPLY_Message(
+    request_id_t request_id,
+    std::vector<Entry> entries)
+    : Message(MessageType::GET_TAIL_ATTRIBUTES_BULK_REPLY,
+              TrafficClass::RECOVERY),
+      request_id_(request_id),
+      entries_(std::move(entries)) {}
+
+void GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::serialize(
+    ProtocolWriter& writer) const {
+  writer.write(request_id_);
+  writer.write(static_cast<uint32_t>(entries_.size()));
+  for (const Entry& entry : entries_) {
+    writer.write(entry.log_id);
+    writer.write(entry.status);
+    if (entry.status == E::OK) {
+      writer.write(entry.attributes.last_released_real_lsn);
+      uint64_t timestamp = entry.attributes.last_timestamp.count();
+      writer.write(timestamp);
+      OffsetMap::fromRecord(entry.attributes.offsets).serialize(writer);
+    }
+  }
+}
+
+MessageReadResult
+GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::deserialize(ProtocolReader& reader) {
+  request_id_t request_id;
+  uint32_t count = 0;
+  std::vector<Entry> entries;
+  reader.read(&request_id);
+  reader.read(&count);
+  for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+    Entry entry;
+    reader.read(&entry.log_id);
+    reader.read(&entry.status);
+    if (reader.ok() && entry.status == E::OK) {
+      uint64_t timestamp = 0;
+      reader.read(&entry.attributes.last_released_real_lsn);
+      reader.read(&timestamp);
+      OffsetMap offsets;
+      offsets.deserialize(reader, false /* unused */);
+      entry.attributes.last_timestamp = std::chrono::milliseconds(timestamp);
+      entry.attributes.offsets = OffsetMap::toRecord(std::move(offsets));
+    }
+    entries.push_back(std::move(entry));
+  }
+  return reader.result([&] {
+    return new GET_TAIL_ATTRIBUTES_BULK_REPLY_Message(
+        request_id, std::move(entries));
+  });
+}
+
+uint16_t
+GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::getMinProtocolVersion() const {
+  return Compatibility::TAIL_ATTRIBUTES_BULK_SUPPORT;
+}
+
+Message::Disposition
+GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::onReceived(const Address& from) {
+  if (from.isClientAddress()) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "got GET_TAIL_ATTRIBUTES_BULK_REPLY message from client %s",
+                    Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  auto& rqmap = Worker::onThisThread()->runningGetTailAttributesBulk().map;
+  auto it = rqmap.find(request_id_);
+  if (it != rqmap.end()) {
+    it->second->onReply(from.id_.node_, entries_);
+  }
+  return Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
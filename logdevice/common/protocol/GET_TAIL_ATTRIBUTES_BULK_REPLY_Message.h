@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/Request.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/LogTailAttributes.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Reply to GET_TAIL_ATTRIBUTES_BULK, sent by the sequencer node. Has
+ *       one entry for every log of the request, with the status returned by
+ *       GET_TAIL_ATTRIBUTES_BULK_Message::getTailAttributes(). The tail
+ *       attributes are only serialized for entries with E::OK.
+ */
+
+class GET_TAIL_ATTRIBUTES_BULK_REPLY_Message : public Message {
+ public:
+  struct Entry {
+    logid_t log_id;
+    Status status;
+    LogTailAttributes attributes;
+  };
+
+  GET_TAIL_ATTRIBUTES_BULK_REPLY_Message(request_id_t request_id,
+                                         std::vector<Entry> entries);
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  request_id_t request_id_;
+  std::vector<Entry> entries_;
+};
+
+}} // namespace facebook::logdevice
@@ -9,6 +9,7 @@
 
 #include <memory>
 
+#include <folly/Varint.h>
 #include <folly/small_vector.h>
 
 #include "logdevice/common/Processor.h"
@@ -21,6 +22,33 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+void writeVarint(ProtocolWriter& writer, uint64_t value) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  size_t len = folly::encodeVarint(value, buf);
+  writer.write(buf, len);
+}
+
+uint64_t readVarint(ProtocolReader& reader) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = 0;
+    reader.read(&byte);
+    if (!reader.ok()) {
+      return 0;
+    }
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  reader.setError(E::BADMSG);
+  return 0;
+}
+
+} // namespace
+
 GOSSIP_Message::GOSSIP_Message(NodeID this_node,
                                node_list_t node_list,
                                std::chrono::milliseconds instance_id,
@@ -52,6 +80,12 @@ Message::Disposition GOSSIP_Message::onReceived(const Address& /*from*/) {
 
 void GOSSIP_Message::serialize(ProtocolWriter& writer) const {
   auto flags = flags_;
+  const bool compact = compact_encoding_ &&
+      writer.proto() >=
+          Compatibility::ProtocolVersion::COMPACT_GOSSIP_ENCODING;
+  if (compact) {
+    flags |= COMPACT_ENCODING;
+  }
 
   writer.write((uint16_t)node_list_.size());
   writer.write(gossip_node_);
@@ -71,9 +105,13 @@ void GOSSIP_Message::serialize(ProtocolWriter& writer) const {
                    });
     writer.writeVector(legacy_node_list);
   } else {
-    writer.writeVector(node_list_);
+    if (compact) {
+      writeCompactNodeList(writer);
+    } else {
+      writer.writeVector(node_list_);
+    }
     if (flags & HAS_IN_MEM_VERSIONS || flags & HAS_DURABLE_SNAPSHOT_VERSIONS) {
-      writeVersions(writer);
+      writeVersions(writer, compact);
     }
   }
 }
@@ -90,6 +128,8 @@ MessageReadResult GOSSIP_Message::deserialize(ProtocolReader& reader) {
   reader.read(&num_nodes);
   reader.read(&msg->gossip_node_);
   reader.read(&msg->flags_);
+  const bool compact = msg->flags_ & COMPACT_ENCODING;
+  msg->flags_ &= ~COMPACT_ENCODING;
   reader.read(&msg->instance_id_);
   reader.read(&msg->sent_time_);
   msg->readBoycottList(reader);
@@ -105,13 +145,17 @@ MessageReadResult GOSSIP_Message::deserialize(ProtocolReader& reader) {
                      return GOSSIP_Node{gossip_node};
                    });
   } else {
-    reader.readVector(&msg->node_list_, num_nodes);
+    if (compact) {
+      msg->readCompactNodeList(reader, num_nodes);
+    } else {
+      reader.readVector(&msg->node_list_, num_nodes);
+    }
     if (msg->flags_ & HAS_IN_MEM_VERSIONS ||
         msg->flags_ & HAS_DURABLE_SNAPSHOT_VERSIONS) {
       // For future compatibility deserialize messages with durable flag.
       // It will be discarded in this commit of the code, but will be supported
       // in future iteration(once Local snapshot store is implemented)
-      msg->readVersions(reader, num_nodes);
+      msg->readVersions(reader, num_nodes, compact);
     }
   }
   return reader.resultMsg(std::move(msg));
@@ -170,7 +214,40 @@ void GOSSIP_Message::readBoycottDurations(ProtocolReader& reader) {
   }
 }
 
-void GOSSIP_Message::writeVersions(ProtocolWriter& writer) const {
+void GOSSIP_Message::writeCompactNodeList(ProtocolWriter& writer) const {
+  for (const auto& node : node_list_) {
+    writeVarint(writer, node.node_id_);
+    writeVarint(writer, node.gossip_);
+    writeVarint(writer, node.gossip_ts_.count());
+    writeVarint(writer, node.failover_.count());
+    uint8_t bits = (node.is_node_starting_ ? 1 : 0) |
+        (static_cast<uint8_t>(node.node_status_) << 1);
+    writer.write(bits);
+  }
+}
+
+void GOSSIP_Message::readCompactNodeList(ProtocolReader& reader,
+                                         uint16_t num_nodes) {
+  node_list_.resize(num_nodes);
+  for (auto& node : node_list_) {
+    node.node_id_ = readVarint(reader);
+    node.gossip_ = readVarint(reader);
+    node.gossip_ts_ = std::chrono::milliseconds(readVarint(reader));
+    node.failover_ = std::chrono::milliseconds(readVarint(reader));
+    uint8_t bits = 0;
+    reader.read(&bits);
+    node.is_node_starting_ = bits & 1;
+    node.node_status_ = static_cast<NodeHealthStatus>(bits >> 1);
+    if (node.node_status_ > NodeHealthStatus::UNHEALTHY) {
+      reader.setError(E::BADMSG);
+    }
+    if (!reader.ok()) {
+      return;
+    }
+  }
+}
+
+void GOSSIP_Message::writeVersions(ProtocolWriter& writer, bool compact) const {
   if (writer.proto() <
       Compatibility::ProtocolVersion::INCLUDE_VERSIONS_IN_GOSSIP) {
     return;
@@ -183,6 +260,20 @@ void GOSSIP_Message::writeVersions(ProtocolWriter& writer) const {
     writer.write(rsm_type);
   }
 
+  if (compact) {
+    for (const auto& node : versions_) {
+      writeVarint(writer, node.node_id_);
+      ld_check(node.rsm_versions_.size() == num_rsms_);
+      for (const auto& rsm_ver : node.rsm_versions_) {
+        writeVarint(writer, rsm_ver);
+      }
+      for (const auto& ncm_ver : node.ncm_versions_) {
+        writeVarint(writer, ncm_ver.val());
+      }
+    }
+    return;
+  }
+
   for (const auto& node : versions_) {
     writer.write(node.node_id_);
     ld_check(node.rsm_versions_.size() == num_rsms_);
@@ -197,7 +288,9 @@ void GOSSIP_Message::writeVersions(ProtocolWriter& writer) const {
   }
 }
 
-void GOSSIP_Message::readVersions(ProtocolReader& reader, uint16_t num_nodes) {
+void GOSSIP_Message::readVersions(ProtocolReader& reader,
+                                  uint16_t num_nodes,
+                                  bool compact) {
   if (reader.proto() <
       Compatibility::ProtocolVersion::INCLUDE_VERSIONS_IN_GOSSIP) {
     return;
@@ -215,6 +308,23 @@ void GOSSIP_Message::readVersions(ProtocolReader& reader, uint16_t num_nodes) {
   }
 
   versions_.resize(num_nodes);
+  if (compact) {
+    for (auto& node : versions_) {
+      node.node_id_ = readVarint(reader);
+      node.rsm_versions_.resize(num_rsms_);
+      for (auto& rsm_ver : node.rsm_versions_) {
+        rsm_ver = readVarint(reader);
+      }
+      for (auto& ncm_ver : node.ncm_versions_) {
+        ncm_ver = membership::MembershipVersion::Type(readVarint(reader));
+      }
+      if (!reader.ok()) {
+        return;
+      }
+    }
+    return;
+  }
+
   for (size_t i = 0; i < num_nodes; ++i) {
     reader.read(&versions_[i].node_id_);
 
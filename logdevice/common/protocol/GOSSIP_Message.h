@@ -126,6 +126,11 @@ class GOSSIP_Message : public Message {
   // RSM and NCM versions
   versions_node_list_t versions_;
 
+  // If true and the recipient supports it, the node list and versions are
+  // serialized with varints and the COMPACT_ENCODING flag is set on the wire.
+  // Not serialized itself; the flag is cleared on deserialization.
+  bool compact_encoding_{false};
+
   // When set in flags_, indicates that the message includes the failover list.
   static const GOSSIP_flags_t HAS_FAILOVER_LIST_FLAG = 1 << 0;
 
@@ -159,6 +164,10 @@ class GOSSIP_Message : public Message {
   // The message contains durable RSM versions(in local store) on cluster nodes
   static const GOSSIP_flags_t HAS_DURABLE_SNAPSHOT_VERSIONS = 1 << 6;
 
+  // The node list and versions are encoded with varints, see
+  // writeCompactNodeList(). Only set on the wire.
+  static const GOSSIP_flags_t COMPACT_ENCODING = 1 << 7;
+
  private:
   // flattens the matrices and then writes them
   void writeBoycottList(ProtocolWriter& writer) const;
@@ -176,7 +185,12 @@ class GOSSIP_Message : public Message {
   void readStartingList(ProtocolReader& reader);
 
   // Read and Write RSM and NCM versions
-  void readVersions(ProtocolReader& reader, uint16_t num_nodes);
-  void writeVersions(ProtocolWriter& writer) const;
+  void readVersions(ProtocolReader& reader, uint16_t num_nodes, bool compact);
+  void writeVersions(ProtocolWriter& writer, bool compact) const;
+
+  // Varint encoding of node_list_, about 12 bytes per node instead of
+  // sizeof(GOSSIP_Node).
+  void writeCompactNodeList(ProtocolWriter& writer) const;
+  void readCompactNodeList(ProtocolReader& reader, uint16_t num_nodes);
 };
 }} // namespace facebook::logdevice
@@ -227,6 +227,19 @@ struct Message {
     return Compatibility::MIN_PROTOCOL_SUPPORTED;
   }
 
+  /**
+   * Log this message is about, if any. When there are several connections to
+   * a node (--num-connections-per-node), Sender sends all messages about the
+   * same log over the same one, so that they stay in order. Messages that
+   * return LOGID_INVALID go over the first connection to the node.
+   *
+   * Message types that make up most of the traffic for a log (records, reads)
+   * are expected to override this.
+   */
+  virtual logid_t getLogID() const {
+    return LOGID_INVALID;
+  }
+
   /**
    * By default, when a message is sent over a socket running a protocol older
    * than getMinProtocolVersion(), the messaging layer emits warnings into the
@@ -18,6 +18,7 @@
 #include "logdevice/common/protocol/CHECK_SEAL_REPLY_Message.h"
 #include "logdevice/common/protocol/CLEANED_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
 #include "logdevice/common/protocol/CONFIG_ADVISORY_Message.h"
 #include "logdevice/common/protocol/CONFIG_CHANGED_Message.h"
 #include "logdevice/common/protocol/CONFIG_FETCH_Message.h"
@@ -26,6 +27,8 @@
 #include "logdevice/common/protocol/DELETE_LOG_METADATA_Message.h"
 #include "logdevice/common/protocol/DELETE_LOG_METADATA_REPLY_Message.h"
 #include "logdevice/common/protocol/DELETE_Message.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_Message.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_REPLY_Message.h"
 #include "logdevice/common/protocol/FINDKEY_Message.h"
 #include "logdevice/common/protocol/FINDKEY_REPLY_Message.h"
 #include "logdevice/common/protocol/GAP_Message.h"
@@ -39,6 +42,8 @@
 #include "logdevice/common/protocol/GET_RSM_SNAPSHOT_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_REPLY_Message.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_Message.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_TRIM_POINT_Message.h"
 #include "logdevice/common/protocol/GET_TRIM_POINT_REPLY_Message.h"
 #include "logdevice/common/protocol/GOSSIP_Message.h"
@@ -60,10 +65,13 @@
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/START_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
+#include "logdevice/common/protocol/STORED_BATCH_Message.h"
 #include "logdevice/common/protocol/STORED_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/protocol/TEST_Message.h"
+#include "logdevice/common/protocol/TRIMMED_BATCH_Message.h"
 #include "logdevice/common/protocol/TRIMMED_Message.h"
+#include "logdevice/common/protocol/TRIM_BATCH_Message.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
 
@@ -0,0 +1,19 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MessagePool.h"
+
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice { namespace detail {
+
+void noteMessageAllocationAvoided() {
+  WORKER_STAT_INCR(message_allocations_avoided);
+}
+
+}}} // namespace facebook::logdevice::detail
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Thread-local free lists for frequently allocated Message types.
+ *
+ *        Messages are created for every send and every receive, and the hot
+ *        ones (STORE, STORED, RECORD, WINDOW, ...) are destroyed shortly after
+ *        on the same worker. Deriving a message class T from
+ *        MessagePoolAllocated<T> gives it class-specific operator new/delete
+ *        that keep up to kMaxFreeListSize freed objects of that type on a
+ *        list owned by the current thread and hand them out again on the
+ *        next allocation, skipping malloc. Since each Worker runs on its own
+ *        thread, the lists are effectively per-worker and need no
+ *        synchronization.
+ *
+ *        Objects of a subclass of T with a different size (e.g. test
+ *        messages derived from a FixedSizeMessage) bypass the list. An object
+ *        freed on a different thread than it was allocated on simply goes to
+ *        that thread's list.
+ *
+ *        Every allocation served from a free list bumps the
+ *        message_allocations_avoided stat of the current worker.
+ */
+
+namespace detail {
+// Called when an allocation was served from a free list.
+void noteMessageAllocationAvoided();
+} // namespace detail
+
+template <typename T>
+class MessagePoolAllocated {
+ public:
+  static constexpr size_t kMaxFreeListSize = 1024;
+
+  static void* operator new(size_t size) {
+    if (size == sizeof(T) && !freeListDestroyed()) {
+      FreeList& list = freeList();
+      if (list.head) {
+        Node* node = list.head;
+        list.head = node->next;
+        --list.size;
+        detail::noteMessageAllocationAvoided();
+        return node;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* p, size_t size) {
+    if (p == nullptr) {
+      return;
+    }
+    if (size == sizeof(T) && !freeListDestroyed()) {
+      FreeList& list = freeList();
+      if (list.size < kMaxFreeListSize) {
+        list.head = new (p) Node{list.head};
+        ++list.size;
+        return;
+      }
+    }
+    ::operator delete(p);
+  }
+
+  // Number of objects of type T cached by the calling thread. For tests.
+  static size_t freeListSize() {
+    return freeListDestroyed() ? 0 : freeList().size;
+  }
+
+ private:
+  struct Node {
+    Node* next;
+  };
+
+  struct FreeList {
+    Node* head{nullptr};
+    size_t size{0};
+
+    ~FreeList() {
+      // Messages may still be destroyed later in thread exit (e.g. by other
+      // thread-local objects); those go straight to the global allocator.
+      freeListDestroyed() = true;
+      while (head) {
+        Node* node = head;
+        head = node->next;
+        ::operator delete(node);
+      }
+    }
+  };
+
+  static FreeList& freeList() {
+    static thread_local FreeList list;
+    return list;
+  }
+
+  // Trivially destructible, so it stays valid throughout thread exit.
+  static bool& freeListDestroyed() {
+    static thread_local bool destroyed = false;
+    return destroyed;
+  }
+};
+
+template <typename T>
+constexpr size_t MessagePoolAllocated<T>::kMaxFreeListSize;
+
+}} // namespace facebook::logdevice
@@ -171,9 +171,12 @@ class IOBufSource : public ProtocolReader::Source {
     return -1;
   }
 
-  int readIOBuf(folly::IOBuf* dest, size_t to_read, size_t nread) override {
+  int readIOBuf(folly::IOBuf* dest,
+                size_t to_read,
+                size_t nread,
+                bool share) override {
     ld_check(to_read <= io_buf_->length());
-    if (to_read * 3 < io_buf_->capacity()) {
+    if (!share && to_read * 3 < io_buf_->capacity()) {
       // The allocated size of io_buf_ is more than 3x greater than what we're
       // reading. Let's avoid pinning the whole buffer and fall back to just
       // making a copy.
@@ -321,11 +324,14 @@ void ProtocolReader::readEvbuffer(evbuffer* out, size_t to_read) {
   }
 }
 
-void ProtocolReader::readIOBuf(folly::IOBuf* out, size_t to_read) {
+void ProtocolReader::readIOBuf(folly::IOBuf* out,
+                               size_t to_read,
+                               bool share) {
   ld_check(out);
   ld_check(!out->isChained());
   if (ok() && isProtoVersionAllowed()) {
-    readImplCb(to_read, [&] { return src_->readIOBuf(out, to_read, nread_); });
+    readImplCb(
+        to_read, [&] { return src_->readIOBuf(out, to_read, nread_, share); });
   }
 }
 
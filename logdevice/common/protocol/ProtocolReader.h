@@ -77,7 +77,18 @@ class ProtocolReader {
      */
     virtual int readEvbuffer(evbuffer* dest, size_t to_read, size_t nread) = 0;
 
-    virtual int readIOBuf(folly::IOBuf* dest, size_t to_read, size_t nread) {
+    /**
+     * Similar to read() except the destination is an IOBuf. Sources backed by
+     * an IOBuf may make `dest' share their buffer instead of copying.
+     *
+     * @param share      if true, share the source buffer whenever possible,
+     *                   even if that keeps much more memory alive than
+     *                   @param to_read bytes
+     */
+    virtual int readIOBuf(folly::IOBuf* dest,
+                          size_t to_read,
+                          size_t nread,
+                          bool /* share */ = false) {
       // Default implementation just allocates an IOBuf and copies into it.
 
       *dest = folly::IOBuf(folly::IOBuf::CREATE, to_read);
@@ -193,7 +204,8 @@ class ProtocolReader {
    * In case of error leaves the output buffer empty.
    */
   void readEvbuffer(evbuffer* out, size_t to_read);
-  void readIOBuf(folly::IOBuf* out, size_t to_read);
+  // @param share  see Source::readIOBuf()
+  void readIOBuf(folly::IOBuf* out, size_t to_read, bool share = false);
 
   uint64_t computeChecksum(size_t msglen) {
     return src_ ? src_->computeChecksum(msglen) : 0;
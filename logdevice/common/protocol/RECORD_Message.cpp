@@ -148,8 +148,10 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
   size_t payload_size = reader.ok() ? reader.bytesRemaining() : 0;
   ld_check(payload_size < Message::MAX_LEN);
 
+  // The payload is the rest of the message, so reference the received buffer
+  // rather than copying, even for small records.
   PayloadHolder payload_holder =
-      PayloadHolder::deserialize(reader, payload_size);
+      PayloadHolder::deserialize(reader, payload_size, /* share */ true);
 
   return reader.result([&] {
     auto m = std::make_unique<RECORD_Message>(
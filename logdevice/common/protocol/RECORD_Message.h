@@ -15,6 +15,7 @@
 #include "logdevice/common/OffsetMap.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
@@ -125,7 +126,9 @@ struct ExtraMetadata {
   OffsetMap offsets_within_epoch;
 };
 
-class RECORD_Message : public Message, boost::noncopyable {
+class RECORD_Message : public Message,
+                       public MessagePoolAllocated<RECORD_Message>,
+                       boost::noncopyable {
  public:
   // identifies the origin of the record
   enum class Source { LOCAL_LOG_STORE, CACHED_DIGEST, UNKNOWN };
@@ -13,6 +13,7 @@
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/FixedSizeMessage.h"
+#include "logdevice/common/protocol/MessagePool.h"
 
 namespace facebook { namespace logdevice {
 
@@ -37,7 +38,8 @@ struct RELEASE_Header {
   }
 } __attribute__((__packed__));
 
-class RELEASE_Message : public Message {
+class RELEASE_Message : public Message,
+                        public MessagePoolAllocated<RELEASE_Message> {
  public:
   explicit RELEASE_Message(const RELEASE_Header& header);
 
@@ -48,6 +50,9 @@ class RELEASE_Message : public Message {
 
   // see Message.h
   void serialize(ProtocolWriter&) const override;
+  logid_t getLogID() const override {
+    return header_.rid.logid;
+  }
   Disposition onReceived(const Address&) override {
     // Receipt handler lives in PurgeCoordinator::onReceived(); this should
     // never get called.
@@ -9,6 +9,7 @@
 
 #include "logdevice/common/CopySet.h"
 #include "logdevice/common/protocol/FixedSizeMessage.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/types.h"
@@ -71,7 +72,8 @@ struct STARTED_Header {
   shard_index_t shard;
 } __attribute__((__packed__));
 
-class STARTED_Message : public Message {
+class STARTED_Message : public Message,
+                        public MessagePoolAllocated<STARTED_Message> {
  public:
   // identifies the origin of the started response.
   enum class Source { LOCAL_LOG_STORE, CACHED_DIGEST };
@@ -75,7 +75,13 @@ START_Message::START_Message(const START_Header& header,
 }
 
 void START_Message::serialize(ProtocolWriter& writer) const {
-  writer.write(header_);
+  ld_check_eq((header_.flags & START_Header::E2E_TRACING_ON) > 0,
+              e2e_trace_id_ != E2E_TRACE_ID_INVALID);
+  START_Header proto_supported_header(header_);
+  if (writer.proto() < Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT) {
+    proto_supported_header.flags &= ~START_Header::E2E_TRACING_ON;
+  }
+  writer.write(proto_supported_header);
   writer.writeLengthPrefixedVector(filtered_out_);
   writer.write(static_cast<uint8_t>(attrs_.filter_type));
   writer.writeLengthPrefixedVector(attrs_.filter_key1);
@@ -95,6 +101,10 @@ void START_Message::serialize(ProtocolWriter& writer) const {
     writer.write(h1);
     writer.write(h2);
   }
+
+  if (proto_supported_header.flags & START_Header::E2E_TRACING_ON) {
+    writer.write(e2e_trace_id_);
+  }
 }
 
 MessageReadResult START_Message::deserialize(ProtocolReader& reader) {
@@ -133,6 +143,11 @@ MessageReadResult START_Message::deserialize(ProtocolReader& reader) {
       reader.read(&m->csid_hash_pt1, sizeof(m->csid_hash_pt1));
       reader.read(&m->csid_hash_pt2, sizeof(m->csid_hash_pt2));
     }
+
+    if (proto >= Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT &&
+        (m->header_.flags & START_Header::E2E_TRACING_ON)) {
+      reader.read(&m->e2e_trace_id_);
+    }
   }
 
   return reader.resultMsg(std::move(m));
@@ -156,6 +171,9 @@ START_Message::getDebugInfo() const {
   add("replication", header_.replication);
   add("scd_copyset_reordering", int(header_.scd_copyset_reordering));
   add("flags", header_.flags);
+  if (e2e_trace_id_ != E2E_TRACE_ID_INVALID) {
+    add("e2e_trace_id", e2e_trace_id_.val());
+  }
   return res;
 }
 
@@ -104,6 +104,10 @@ struct START_Header {
   // if it is the primary recipient (left-most in copyset) of the record in the
   // client's region.
   static const START_flags_t LOCAL_SCD_ENABLED = 1u << 11; //=2048
+
+  // The read stream was sampled for end-to-end tracing, see E2ETracer. The
+  // trace id is included in the message.
+  static const START_flags_t E2E_TRACING_ON = 1u << 12; //=4096
 } __attribute__((__packed__));
 
 class START_Message : public Message {
@@ -137,6 +141,9 @@ class START_Message : public Message {
   START_Message& operator=(START_Message&&) = delete;
   // see Message.h
   void serialize(ProtocolWriter&) const override;
+  logid_t getLogID() const override {
+    return header_.log_id;
+  }
   Disposition onReceived(const Address&) override {
     // Receipt handler lives in server/START_onReceived.cpp; this should never
     // get called.
@@ -163,6 +170,9 @@ class START_Message : public Message {
   uint64_t csid_hash_pt1 = 0;     // Session id hash, pt1
   uint64_t csid_hash_pt2 = 0;     // Session id hash, pt2
 
+  // Set if E2E_TRACING_ON is set in header_.flags.
+  e2e_trace_id_t e2e_trace_id_ = E2E_TRACE_ID_INVALID;
+
   virtual std::vector<std::pair<std::string, folly::dynamic>>
   getDebugInfo() const override;
 };
@@ -39,6 +39,9 @@ class STOP_Message : public Message {
 
   // see Message.h
   void serialize(ProtocolWriter&) const override;
+  logid_t getLogID() const override {
+    return header_.log_id;
+  }
   Disposition onReceived(const Address&) override;
   static Message::deserializer_t deserialize;
 
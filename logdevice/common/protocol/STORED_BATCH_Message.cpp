@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/STORED_BATCH_Message.h"
+
+#include "logdevice/common/RebuildingTypes.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+STORED_BATCH_Message::STORED_BATCH_Message(std::vector<STORED_Header> headers)
+    : Message(MessageType::STORED_BATCH, TrafficClass::APPEND),
+      headers_(std::move(headers)) {}
+
+void STORED_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  writer.writeLengthPrefixedVector(headers_);
+}
+
+MessageReadResult STORED_BATCH_Message::deserialize(ProtocolReader& reader) {
+  std::vector<STORED_Header> headers;
+  reader.readLengthPrefixedVector(&headers);
+  if (reader.ok()) {
+    for (const STORED_Header& header : headers) {
+      if (!canBatch(header) || header.shard == -1) {
+        ld_error("PROTOCOL ERROR: got a STORED_BATCH message with a reply "
+                 "for record %s that can't be batched (status %s, flags %u, "
+                 "shard %d)",
+                 header.rid.toString().c_str(),
+                 error_name(header.status),
+                 header.flags,
+                 header.shard);
+        return reader.errorResult(E::BADMSG);
+      }
+    }
+  }
+  return reader.result(
+      [&] { return new STORED_BATCH_Message(std::move(headers)); });
+}
+
+Message::Disposition STORED_BATCH_Message::onReceived(const Address& from) {
+  for (const STORED_Header& header : headers_) {
+    STORED_Message msg(header,
+                       LSN_INVALID,
+                       0,
+                       CHUNK_REBUILDING_ID_INVALID,
+                       FlushToken_INVALID,
+                       ServerInstanceId_INVALID);
+    if (msg.onReceivedCommon(from) == Disposition::ERROR) {
+      return Disposition::ERROR;
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+uint16_t STORED_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::STORED_BATCH_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
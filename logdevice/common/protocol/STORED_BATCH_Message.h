@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/STORED_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file STORED_BATCH carries the replies to several STOREs from the same
+ *       storage node, each of them exactly what a STORED message would have
+ *       carried. Only replies that consist of a STORED_Header alone can be
+ *       batched (see canBatch()); the sequencer processes each of them as if
+ *       it had come in its own STORED message. Sent by STOREDBatcher.
+ */
+
+class STORED_BATCH_Message : public Message {
+ public:
+  explicit STORED_BATCH_Message(std::vector<STORED_Header> headers);
+
+  /**
+   * @return true if a STORED message with this header carries nothing else,
+   *         and can thus be sent as part of a STORED_BATCH.
+   */
+  static bool canBatch(const STORED_Header& header) {
+    return !(header.flags & STORED_Header::REBUILDING) &&
+        header.status != E::REBUILDING;
+  }
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  uint16_t getMinProtocolVersion() const override;
+
+  int8_t getExecutorPriority() const override {
+    return folly::Executor::HI_PRI;
+  }
+
+  static Message::deserializer_t deserialize;
+
+  std::vector<STORED_Header> headers_;
+};
+
+}} // namespace facebook::logdevice
@@ -16,6 +16,7 @@
 #include "logdevice/common/RebuildingTypes.h"
 #include "logdevice/common/Request.h"
 #include "logdevice/common/RequestType.h"
+#include "logdevice/common/STOREDBatcher.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
@@ -249,12 +250,17 @@ class SendSTOREDRequest : public Request {
           to.getIdx());
     }
 
+    STOREDBatcher& batcher = Worker::onThisThread()->storedBatcher();
+    if (batcher.add(*msg, to)) {
+      return;
+    }
+    const RecordID rid = msg->header_.rid;
     rv = sender.sendMessage(std::move(msg), to);
     if (rv != 0) {
       RATELIMIT_INFO(std::chrono::seconds(10),
                      1,
                      "Failed to send a STORED message for %s to %s: %s",
-                     msg->header_.rid.toString().c_str(),
+                     rid.toString().c_str(),
                      Sender::describeConnection(Address(to)).c_str(),
                      error_description(err));
     }
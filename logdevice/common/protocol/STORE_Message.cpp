@@ -19,6 +19,7 @@
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/EpochRecovery.h"
 #include "logdevice/common/RebuildingTypes.h"
+#include "logdevice/common/ThreadLocalObjectPool.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/MUTATED_Message.h"
@@ -38,6 +39,14 @@ namespace facebook { namespace logdevice {
 //              "StoreChainLink must be trivially copyable because we use "
 //              "memcpy() on its objects");
 
+void* STORE_Message::operator new(size_t size) {
+  return ThreadLocalObjectPool<STORE_Message>::allocate(size);
+}
+
+void STORE_Message::operator delete(void* p, size_t size) {
+  ThreadLocalObjectPool<STORE_Message>::deallocate(p, size);
+}
+
 STORE_Message::STORE_Message(const STORE_Header& header,
                              const StoreChainLink copyset[],
                              copyset_off_t copyset_offset,
@@ -123,6 +132,9 @@ void STORE_Message::serialize(ProtocolWriter& writer) const {
   if (writer.proto() < Compatibility::ProtocolVersion::STREAM_WRITER_SUPPORT) {
     proto_supported_header.flags &= ~STORE_Header::WRITE_STREAM;
   }
+  if (writer.proto() < Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT) {
+    proto_supported_header.flags &= ~STORE_Header::E2E_TRACING_ON;
+  }
   writer.write(proto_supported_header);
 
   if (header_.flags & STORE_Header::RECOVERY) {
@@ -148,6 +160,10 @@ void STORE_Message::serialize(ProtocolWriter& writer) const {
     writer.write(extra_.first_amendable_offset);
   }
 
+  if (proto_supported_header.flags & STORE_Header::E2E_TRACING_ON) {
+    writer.write(extra_.e2e_trace_id);
+  }
+
   writer.writeVector(copyset_);
   ld_check(header_.copyset_size == copyset_.size());
 
@@ -206,6 +222,11 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
     reader.read(&extra.first_amendable_offset);
   }
 
+  if (reader.proto() >= Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT &&
+      (hdr.flags & STORE_Header::E2E_TRACING_ON)) {
+    reader.read(&extra.e2e_trace_id);
+  }
+
   if (reader.ok() &&
       (hdr.copyset_size <= 0 || hdr.copyset_size > COPYSET_SIZE_MAX)) {
     ld_error("Bad STORE message: copyset_size (%hhu) is not in the allowed "
@@ -244,8 +265,9 @@ MessageReadResult STORE_Message::deserialize(ProtocolReader& reader) {
   }
 
   const size_t payload_size = reader.bytesRemaining();
+  // See RECORD_Message::deserialize().
   PayloadHolder payload_holder =
-      PayloadHolder::deserialize(reader, payload_size);
+      PayloadHolder::deserialize(reader, payload_size, /* share */ true);
 
   return reader.result([&] {
     // No, you can't replace this with make_unique. The constructor is private.
@@ -472,6 +494,7 @@ std::string STORE_Message::flagsToString(STORE_flags_t flags) {
   FLAG(EPOCH_BEGIN)
   FLAG(DRAINED)
   FLAG(WRITE_STREAM)
+  FLAG(E2E_TRACING_ON)
 
 #undef FLAG
 
@@ -514,6 +537,9 @@ STORE_Message::getDebugInfo() const {
   if (extra_.first_amendable_offset != COPYSET_SIZE_MAX) {
     add("first_amendable_offset", extra_.first_amendable_offset);
   }
+  if (extra_.e2e_trace_id != E2E_TRACE_ID_INVALID) {
+    add("e2e_trace_id", extra_.e2e_trace_id.val());
+  }
   add("payload_size", payload_.size());
   add("copyset", toString(copyset_));
   if (block_starting_lsn_ != LSN_INVALID) {
@@ -27,6 +27,7 @@
 #include "logdevice/common/ShardID.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/settings/Durability.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Record.h"
@@ -166,6 +167,10 @@ struct STORE_Header {
   // RECORD_Header::WRITE_STREAM
   static const STORE_flags_t WRITE_STREAM = 1u << 22; //=4194304
 
+  // The record is being appended by an append sampled for end-to-end tracing,
+  // see E2ETracer. STORE_Extra::e2e_trace_id is included in the message.
+  static const STORE_flags_t E2E_TRACING_ON = 1u << 23; //=8388608
+
   // Please update STORE_Message::flagsToString() when adding flags.
 } __attribute__((__packed__));
 
@@ -214,6 +219,9 @@ struct STORE_Extra {
   // chain).
   copyset_size_t first_amendable_offset = COPYSET_SIZE_MAX;
 
+  // Serialized if E2E_TRACING_ON flag is set.
+  e2e_trace_id_t e2e_trace_id = E2E_TRACE_ID_INVALID;
+
   bool operator==(const STORE_Extra& other) const {
     auto as_tuple = [](const STORE_Extra& r) {
       return std::tie(r.recovery_id,
@@ -227,7 +235,8 @@ struct STORE_Extra {
   }
 };
 
-class STORE_Message : public Message {
+class STORE_Message : public Message,
+                      public MessagePoolAllocated<STORE_Message> {
  public:
   /**
    * Appender and Mutator use this constructor when composing STORE messages to
@@ -262,6 +271,10 @@ class STORE_Message : public Message {
   STORE_Message(const STORE_Message&) = delete;
   STORE_Message& operator=(const STORE_Message&) = delete;
 
+  // Allocated from a per-Worker free list, see ThreadLocalObjectPool.
+  static void* operator new(size_t size);
+  static void operator delete(void* p, size_t size);
+
   int8_t getExecutorPriority() const override {
     return header_.flags & (STORE_Header::REBUILDING | STORE_Header::AMEND)
         ? folly::Executor::LO_PRI
@@ -284,6 +297,9 @@ class STORE_Message : public Message {
   // see Message.h
   bool cancelled() const override;
   void serialize(ProtocolWriter& writer) const override;
+  logid_t getLogID() const override {
+    return header_.rid.logid;
+  }
 
   // The onSent() logic is a bit different on client and server. This method
   // is the part that is shared by both. The server-specific part lives in
@@ -12,6 +12,7 @@
 
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/protocol/MessageType.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
@@ -34,7 +35,10 @@ template <class Header,
           MessageType MESSAGE_TYPE,
           TrafficClass TRAFFIC_CLASS,
           bool include_blob = true>
-class SimpleMessage : public Message {
+class SimpleMessage
+    : public Message,
+      public MessagePoolAllocated<
+          SimpleMessage<Header, MESSAGE_TYPE, TRAFFIC_CLASS, include_blob>> {
   typedef uint32_t blob_size_t;
   // TODO: uncomment this whenever gcc ships it.
   // static_assert(std::is_trivially_copyable<Header>::value,
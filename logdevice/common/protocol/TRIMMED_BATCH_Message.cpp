@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/TRIMMED_BATCH_Message.h"
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+TRIMMED_BATCH_Message::TRIMMED_BATCH_Message(
+    std::vector<TRIMMED_Header> headers)
+    : Message(MessageType::TRIMMED_BATCH, TrafficClass::TRIM),
+      headers_(std::move(headers)) {}
+
+void TRIMMED_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  writer.writeLengthPrefixedVector(headers_);
+}
+
+MessageReadResult TRIMMED_BATCH_Message::deserialize(ProtocolReader& reader) {
+  std::vector<TRIMMED_Header> headers;
+  reader.readLengthPrefixedVector(&headers);
+  return reader.result(
+      [&] { return new TRIMMED_BATCH_Message(std::move(headers)); });
+}
+
+Message::Disposition TRIMMED_BATCH_Message::onReceived(const Address& from) {
+  if (from.isClientAddress()) {
+    ld_error("got TRIMMED_BATCH message from client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Disposition::ERROR;
+  }
+
+  for (const TRIMMED_Header& header : headers_) {
+    TRIMMED_Message msg(header);
+    if (msg.onReceived(from) == Disposition::ERROR) {
+      return Disposition::ERROR;
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+uint16_t TRIMMED_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::TRIM_BATCH_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/TRIMMED_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Reply to some of the entries of a TRIM_BATCH message, each exactly
+ *       what a TRIMMED message would have carried. A storage node answers
+ *       the entries it rejects right away with one such message, and the
+ *       others with one message per shard once their trim points have been
+ *       written to the local log store.
+ */
+
+class TRIMMED_BATCH_Message : public Message {
+ public:
+  explicit TRIMMED_BATCH_Message(std::vector<TRIMMED_Header> headers);
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address& from) override;
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  std::vector<TRIMMED_Header> headers_;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/TRIM_BATCH_Message.h"
+
+#include "logdevice/common/TrimRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+TRIM_BATCH_Message::TRIM_BATCH_Message(std::vector<TRIM_Header> headers)
+    : Message(MessageType::TRIM_BATCH, TrafficClass::TRIM),
+      headers_(std::move(headers)) {}
+
+void TRIM_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  writer.writeLengthPrefixedVector(headers_);
+}
+
+MessageReadResult TRIM_BATCH_Message::deserialize(ProtocolReader& reader) {
+  std::vector<TRIM_Header> headers;
+  reader.readLengthPrefixedVector(&headers);
+  return reader.result(
+      [&] { return new TRIM_BATCH_Message(std::move(headers)); });
+}
+
+uint16_t TRIM_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::TRIM_BATCH_SUPPORT;
+}
+
+void TRIM_BATCH_Message::onSent(Status status, const Address& to) const {
+  Message::onSent(status, to);
+
+  // Inform every TrimRequest of the outcome of sending the message
+  TrimRequestMap& rqmap = Worker::onThisThread()->runningTrimRequests();
+  for (const TRIM_Header& header : headers_) {
+    auto it = rqmap.map.find(header.client_rqid);
+    if (it == rqmap.map.end()) {
+      continue;
+    }
+    ShardID shard(to.id_.node_.index(), header.shard);
+    if (status == E::PROTONOSUPPORT) {
+      it->second->onBatchNotSupported(shard);
+    } else {
+      it->second->onMessageSent(shard, status);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/TRIM_Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file TRIM_BATCH carries several TRIM messages for the same storage node,
+ *       each entry exactly the header a TRIM message would have carried. The
+ *       storage node persists the trim points of all entries for the same
+ *       shard with a single write, and replies with TRIMMED_BATCH messages.
+ *       The client processes every entry of those as if it had come in its
+ *       own TRIMMED message. Sent by TrimBatcher.
+ */
+
+class TRIM_BATCH_Message : public Message {
+ public:
+  explicit TRIM_BATCH_Message(std::vector<TRIM_Header> headers);
+
+  void serialize(ProtocolWriter&) const override;
+  Disposition onReceived(const Address&) override {
+    // Receipt handler lives in server/TRIM_BATCH_onReceived.cpp; this should
+    // never get called.
+    std::abort();
+  }
+  void onSent(Status st, const Address& to) const override;
+  uint16_t getMinProtocolVersion() const override;
+
+  static Message::deserializer_t deserialize;
+
+  std::vector<TRIM_Header> headers_;
+};
+
+}} // namespace facebook::logdevice
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/types.h"
 
@@ -33,7 +34,8 @@ struct WINDOW_Header {
                                    // protocol.
 } __attribute__((__packed__));
 
-class WINDOW_Message : public Message {
+class WINDOW_Message : public Message,
+                       public MessagePoolAllocated<WINDOW_Message> {
  public:
   /**
    * Construct a WINDOW message.
@@ -46,6 +48,9 @@ class WINDOW_Message : public Message {
 
   // see Message.h
   void serialize(ProtocolWriter&) const override;
+  logid_t getLogID() const override {
+    return header_.log_id;
+  }
   Disposition onReceived(const Address&) override;
   static Message::deserializer_t deserialize;
 
@@ -58,28 +58,77 @@ KeyValueStoreStateMachine::deserializeDelta(Payload payload) {
   return delta;
 }
 
+void KeyValueStoreStateMachine::enableSnapshotting(size_t max_delta_records,
+                                                   size_t max_delta_bytes) {
+  ld_check(snapshot_log_id_ != LOGID_INVALID);
+  max_delta_records_ = max_delta_records;
+  max_delta_bytes_ = max_delta_bytes;
+  if (!self_subscription_) {
+    self_subscription_ = subscribe(
+        [this](const KeyValueStoreState&, const KeyValueStoreDelta*, lsn_t) {
+          if (shouldCreateSnapshot()) {
+            snapshot(nullptr);
+          }
+        });
+  }
+}
+
+int KeyValueStoreStateMachine::apply(const KeyValueStoreDelta& delta,
+                                     Store& store) {
+  switch (delta.getType()) {
+    case KeyValueStoreDelta::Type::update_value:
+      store[delta.get_update_value().key] = delta.get_update_value().value;
+      return 0;
+    case KeyValueStoreDelta::Type::remove_value:
+      store.erase(delta.get_remove_value().key);
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+KeyValueStoreStateMachine::StoreRange
+KeyValueStoreStateMachine::range(const Store& store,
+                                 folly::StringPiece from,
+                                 folly::StringPiece to) {
+  auto begin = store.lower_bound(from.str());
+  auto end = store.lower_bound(to.str());
+  if (to <= from) {
+    end = begin;
+  }
+  return {begin, end};
+}
+
+KeyValueStoreStateMachine::StoreRange
+KeyValueStoreStateMachine::prefixRange(const Store& store,
+                                       folly::StringPiece prefix) {
+  auto begin = store.lower_bound(prefix.str());
+  // The first key after all the keys with the prefix is the prefix with its
+  // last byte that isn't 0xff incremented and the rest dropped.
+  std::string after = prefix.str();
+  while (!after.empty() && static_cast<unsigned char>(after.back()) == 0xff) {
+    after.pop_back();
+  }
+  if (after.empty()) {
+    return {begin, store.end()};
+  }
+  after.back() =
+      static_cast<char>(static_cast<unsigned char>(after.back()) + 1);
+  return {begin, store.lower_bound(after)};
+}
+
 int KeyValueStoreStateMachine::applyDelta(const KeyValueStoreDelta& delta,
                                           KeyValueStoreState& state,
                                           lsn_t version,
                                           std::chrono::milliseconds,
                                           std::string& failure_reason) {
-  auto type = delta.getType();
-  switch (type) {
-    case KeyValueStoreDelta::Type::update_value: {
-      state.store[delta.get_update_value().key] =
-          delta.get_update_value().value;
-      state.set_version(version);
-      return 0;
-    }
-    case KeyValueStoreDelta::Type::remove_value: {
-      // TODO: Not implemented
-      return 0;
-    }
-    default:
-      ld_warning("Unknown type of KeyValueStoreDelta. Not applying the delta");
-      failure_reason = "Unknown type";
-      return -1;
+  if (apply(delta, state.store) != 0) {
+    ld_warning("Unknown type of KeyValueStoreDelta. Not applying the delta");
+    failure_reason = "Unknown type";
+    return -1;
   }
+  state.set_version(version);
+  return 0;
 }
 
 int KeyValueStoreStateMachine::serializeState(const KeyValueStoreState& state,
@@ -95,14 +144,27 @@ int KeyValueStoreStateMachine::serializeState(const KeyValueStoreState& state,
 }
 
 bool KeyValueStoreStateMachine::shouldCreateSnapshot() const {
-  // TODO: Not implemented
-  return false;
+  return canSnapshot() &&
+      ((max_delta_records_ > 0 &&
+        numDeltaRecordsSinceLastSnapshot() > max_delta_records_) ||
+       (max_delta_bytes_ > 0 &&
+        numBytesSinceLastSnapshot() > max_delta_bytes_));
 }
+
 bool KeyValueStoreStateMachine::canSnapshot() const {
-  // TODO: Not implemented
-  return false;
+  return (max_delta_records_ > 0 || max_delta_bytes_ > 0) &&
+      snapshot_log_id_ != LOGID_INVALID && !snapshot_in_flight_ && canTrim();
 }
-void KeyValueStoreStateMachine::onSnapshotCreated(Status, size_t) {
-  // TODO: Not implemented
+
+void KeyValueStoreStateMachine::onSnapshotCreated(Status st,
+                                                  size_t snapshotSize) {
+  if (st == E::OK) {
+    rsm_info(rsm_type_,
+             "Created a snapshot of %zu bytes at version %s",
+             snapshotSize,
+             lsn_to_string(getVersion()).c_str());
+  } else {
+    rsm_error(rsm_type_, "Could not create a snapshot: %s", error_name(st));
+  }
 }
 }} // namespace facebook::logdevice
@@ -7,6 +7,10 @@
  */
 #pragma once
 
+#include <utility>
+
+#include <folly/Range.h>
+
 #include "logdevice/common/replicated_state_machine/ReplicatedStateMachine.h"
 #include "logdevice/common/replicated_state_machine/if/gen-cpp2/KeyValueStore_types.h"
 
@@ -17,15 +21,54 @@ namespace facebook { namespace logdevice {
  * key value store state in memory. The structure of the state and the delta is
  * documented in KeyValueStore.thrift file. For detailed information on how this
  * works, check out the documentation on ReplicatatedStateMachine.h
+ *
+ * The store is a sorted map, see range() and prefixRange() for iterating over
+ * a subset of the keys. Subscribers that keep a copy of the store can keep it
+ * up to date with apply() instead of copying the whole store on every delta.
  */
 class KeyValueStoreStateMachine
     : public facebook::logdevice::ReplicatedStateMachine<
           replicated_state_machine::thrift::KeyValueStoreState,
           replicated_state_machine::thrift::KeyValueStoreDelta> {
  public:
+  using Store =
+      decltype(replicated_state_machine::thrift::KeyValueStoreState::store);
+  using StoreRange = std::pair<Store::const_iterator, Store::const_iterator>;
+
   explicit KeyValueStoreStateMachine(logid_t delta_log_id,
                                      logid_t snapshot_log_id = LOGID_INVALID);
 
+  /**
+   * Makes this state machine write a snapshot of the store to the snapshot log
+   * once more than `max_delta_records` delta records or `max_delta_bytes`
+   * bytes of deltas were written since the last snapshot, so that readers
+   * don't need to replay the whole delta log. Only the node responsible for
+   * trimming RSMs (the first node alive) writes snapshots. Must be called
+   * before start(), and only if there is a snapshot log.
+   */
+  void enableSnapshotting(size_t max_delta_records, size_t max_delta_bytes);
+
+  /**
+   * Applies a delta to a store.
+   *
+   * @return 0 on success, or -1 if the delta has an unknown type
+   */
+  static int
+  apply(const replicated_state_machine::thrift::KeyValueStoreDelta& delta,
+        Store& store);
+
+  /**
+   * @return  the entries with keys in [from, to)
+   */
+  static StoreRange range(const Store& store,
+                          folly::StringPiece from,
+                          folly::StringPiece to);
+
+  /**
+   * @return  the entries whose keys start with `prefix`
+   */
+  static StoreRange prefixRange(const Store& store, folly::StringPiece prefix);
+
   std::unique_ptr<replicated_state_machine::thrift::KeyValueStoreState>
   makeDefaultState(lsn_t version) const override;
 
@@ -52,5 +95,12 @@ class KeyValueStoreStateMachine
   bool shouldCreateSnapshot() const override;
   bool canSnapshot() const override;
   void onSnapshotCreated(Status st, size_t snapshotSize) override;
+
+ private:
+  // 0 if snapshotting is disabled, see enableSnapshotting()
+  size_t max_delta_records_{0};
+  size_t max_delta_bytes_{0};
+
+  std::unique_ptr<SubscriptionHandle> self_subscription_;
 };
 }} // namespace facebook::logdevice
@@ -51,6 +51,7 @@ void ReplicatedStateMachine<T, D>::start() {
   if (snapshot_log_id_ == LOGID_INVALID) {
     onBaseSnapshotRetrieved();
   } else {
+    prefetchDeltaLogTailLSN();
     startFetchingSnapshot();
   }
   stopped_ = false;
@@ -144,6 +145,7 @@ void ReplicatedStateMachine<T, D>::stop() {
 
   stop_read_stream(snapshot_log_rsid_);
   stop_read_stream(delta_log_rsid_);
+  delta_tail_prefetch_request_.reset();
 
   stopped_ = true;
   cancelGracePeriodForSnapshotting();
@@ -271,6 +273,12 @@ read_stream_id_t ReplicatedStateMachine<T, D>::createBasicReadStream(
   Worker* w = Worker::onThisThread();
   Processor* processor = w->processor_;
 
+  // The delta log stream replays the whole backlog on startup, give it a
+  // bigger buffer so that it's not limited by round trips to storage nodes.
+  const size_t buffer_size = logid == delta_log_id_
+      ? w->settings().rsm_delta_log_read_buffer_size
+      : 100;
+
   const auto rsid = processor->issueReadStreamID();
 
   auto deps = std::make_unique<ClientReadStreamDependencies>(
@@ -283,7 +291,7 @@ read_stream_id_t ReplicatedStateMachine<T, D>::createBasicReadStream(
       until_lsn,
       Worker::settings().client_read_flow_control_threshold,
       ClientReadStreamBufferType::CIRCULAR,
-      100,
+      buffer_size,
       std::move(deps),
       processor->config_,
       nullptr,
@@ -670,7 +678,57 @@ void ReplicatedStateMachine<T, D>::onBaseSnapshotRetrieved() {
   if (delta_read_ptr_ == LSN_INVALID) {
     delta_read_ptr_ = last_snapshot_last_read_ptr_;
   }
-  getDeltaLogTailLSN();
+  if (prefetched_delta_tail_ != LSN_INVALID) {
+    const lsn_t tail_lsn = prefetched_delta_tail_;
+    prefetched_delta_tail_ = LSN_INVALID;
+    onGotDeltaLogTailLSN(E::OK, tail_lsn);
+  } else if (!delta_tail_prefetch_request_) {
+    getDeltaLogTailLSN();
+  }
+  // Otherwise onPrefetchedDeltaLogTailLSN() will take it from here.
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::prefetchDeltaLogTailLSN() {
+  ld_check(delta_tail_prefetch_request_ == nullptr);
+  if (!Worker::settings().rsm_prefetch_delta_log_tail) {
+    return;
+  }
+
+  rsm_info(rsm_type_, "Prefetching tail lsn of delta log...");
+
+  delta_tail_prefetch_request_ = std::make_unique<SyncSequencerRequest>(
+      delta_log_id_,
+      /* flags */ 0,
+      [this](Status st,
+             NodeID /*seq*/,
+             lsn_t next_lsn,
+             std::unique_ptr<LogTailAttributes> /* tail_attributes */,
+             std::shared_ptr<const EpochMetaDataMap> /*metadata_map*/,
+             std::shared_ptr<TailRecord> /*tail_record*/,
+             folly::Optional<bool> /*is_log_empty*/) {
+        delta_tail_prefetch_request_.reset();
+        lsn_t tail_lsn = next_lsn <= LSN_OLDEST ? LSN_OLDEST : next_lsn - 1;
+        onPrefetchedDeltaLogTailLSN(st, tail_lsn);
+      },
+      GetSeqStateRequest::Context::RSM);
+  int rv = delta_tail_prefetch_request_->start();
+  ld_check(rv == 0);
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::onPrefetchedDeltaLogTailLSN(Status st,
+                                                               lsn_t lsn) {
+  // Same as in onGotDeltaLogTailLSN(), the request has no timeout.
+  ld_check(st == E::OK);
+
+  if (sync_state_ == SyncState::SYNC_SNAPSHOT) {
+    prefetched_delta_tail_ = lsn;
+  } else {
+    // onBaseSnapshotRetrieved() was called first and is waiting for us.
+    ld_check_eq(sync_state_, SyncState::SYNC_DELTAS);
+    onGotDeltaLogTailLSN(st, lsn);
+  }
 }
 
 template <typename T, typename D>
@@ -451,6 +451,9 @@ class ReplicatedStateMachine {
   // multiple times.
   void onGotDeltaLogTailLSN(Status st, lsn_t lsn);
 
+  // Called when the request issued by prefetchDeltaLogTailLSN() completes.
+  void onPrefetchedDeltaLogTailLSN(Status st, lsn_t lsn);
+
   // Called when the delta log client read stream switches to being unhealthy
   // or healthy again
   void onDeltaLogReadStreamHealthChange(bool is_healthy);
@@ -531,6 +534,11 @@ class ReplicatedStateMachine {
   // a SyncSequencerRequest to find the tail lsn of the delta log.
   virtual void getDeltaLogTailLSN();
 
+  // Called by start() if there is a snapshot to fetch. Looks up the tail lsn
+  // of the delta log while the snapshot is being fetched, so that
+  // onBaseSnapshotRetrieved() can start reading deltas right away.
+  virtual void prefetchDeltaLogTailLSN();
+
   // Utility function for creating a read stream for the delta and snapshot
   // logs.
   virtual read_stream_id_t
@@ -700,7 +708,8 @@ class ReplicatedStateMachine {
   // the tail lsn `snapshot_sync_` of the snapshot log. When this
   // function is called, we have the base snapshot to apply deltas onto, so it's
   // time to read the delta log.
-  // Calls getDeltaLogTailLSN().
+  // Calls getDeltaLogTailLSN(), unless the tail was already found by
+  // prefetchDeltaLogTailLSN().
   void onBaseSnapshotRetrieved();
 
   /**
@@ -766,6 +775,12 @@ class ReplicatedStateMachine {
   // SyncState is SYNC_SNAPSHOT) or for deltas log (if SYNC_DELTAS).
   std::unique_ptr<SyncSequencerRequest> sync_sequencer_request_;
 
+  // Request started by prefetchDeltaLogTailLSN(), and its result if it
+  // completed before we got the base snapshot. The tail is used only once,
+  // by the first onBaseSnapshotRetrieved().
+  std::unique_ptr<SyncSequencerRequest> delta_tail_prefetch_request_;
+  lsn_t prefetched_delta_tail_{LSN_INVALID};
+
   // LSN of the tail of the snapshot log computed on startup. We use this to
   // define which record in the snapshot log can be considered the most recent
   // base to apply deltas on. Once we have found that record (if any), we start
@@ -16,6 +16,9 @@ using namespace facebook::logdevice::setting_validators;
 
 namespace facebook { namespace logdevice {
 
+// Defined in Settings.cpp
+std::istream& operator>>(std::istream& in, NodeLocationScope& val);
+
 std::istream& operator>>(std::istream& in, GossipSettings::SelectionMode& val) {
   std::string token;
   in >> token;
@@ -23,6 +26,8 @@ std::istream& operator>>(std::istream& in, GossipSettings::SelectionMode& val) {
     val = GossipSettings::SelectionMode::RANDOM;
   } else if (token == "round-robin") {
     val = GossipSettings::SelectionMode::ROUND_ROBIN;
+  } else if (token == "hierarchical") {
+    val = GossipSettings::SelectionMode::HIERARCHICAL;
   } else {
     in.setstate(std::ios::failbit);
   }
@@ -123,7 +128,8 @@ void GossipSettings::defineSettings(SettingEasyInit& init) {
        "How to select a node to send a "
        "gossip message to. One of: "
        "'round-robin', "
-       "'random' (default)",
+       "'random' (default), "
+       "'hierarchical' (see gossip-hierarchy-scope)",
        SERVER | REQUIRES_RESTART,
        SettingsCategory::FailureDetector);
   init("ignore-isolation",
@@ -160,6 +166,47 @@ void GossipSettings::defineSettings(SettingEasyInit& init) {
        "1/10th of the GOSSIP_Messages.",
        SERVER,
        SettingsCategory::FailureDetector);
+  init("gossip-compact-encoding",
+       &gossip_compact_encoding,
+       "true",
+       nullptr, // no validation
+       "Encode the node list and the versions in GOSSIP messages with "
+       "variable-length integers when the recipient supports it.",
+       SERVER,
+       SettingsCategory::FailureDetector);
+  init("gossip-full-state-interval",
+       &gossip_full_state_interval,
+       "10",
+       parse_positive<int32_t>(),
+       "Every how many GOSSIP messages to the same node carry the state of "
+       "all nodes. The other messages only carry the entries that changed "
+       "since the previous message to that node. 1 means every message "
+       "carries the full state.",
+       SERVER,
+       SettingsCategory::FailureDetector);
+  init("gossip-hierarchy-scope",
+       &gossip_hierarchy_scope,
+       "rack",
+       nullptr, // no validation
+       "With gossip-mode=hierarchical, nodes gossip to random nodes of their "
+       "own location domain at this scope. The alive node with the lowest "
+       "index in each domain also gossips to its counterparts in other "
+       "domains, see gossip-hierarchy-cross-scope-interval. This keeps "
+       "failure detection fast in clusters with thousands of nodes. Nodes "
+       "without a location form domains of their own.",
+       SERVER,
+       SettingsCategory::FailureDetector);
+  init("gossip-hierarchy-cross-scope-interval",
+       &gossip_hierarchy_cross_scope_interval,
+       "3",
+       parse_positive<int32_t>(),
+       "With gossip-mode=hierarchical, one of every this many GOSSIP messages "
+       "sent by the node gossiping for its location domain goes to another "
+       "domain. Information about a node reaches other domains within a few "
+       "times this many gossip intervals, which needs to stay well below "
+       "gossip-threshold.",
+       SERVER,
+       SettingsCategory::FailureDetector);
 };
 
 }} // namespace facebook::logdevice
@@ -10,6 +10,7 @@
 #include <chrono>
 
 #include "logdevice/common/settings/UpdateableSettings.h"
+#include "logdevice/include/NodeLocationScope.h"
 
 /**
  * @file  Settings specific to the gossip-based failure detector.
@@ -21,6 +22,9 @@ struct GossipSettings : public SettingsBundle {
   enum class SelectionMode {
     RANDOM,
     ROUND_ROBIN,
+    // Gossip densely inside location domains, with one node of each domain
+    // also gossiping to other domains. See gossip-hierarchy-scope.
+    HIERARCHICAL,
   };
 
   // See .cpp for docs and defaults
@@ -48,6 +52,10 @@ struct GossipSettings : public SettingsBundle {
 
   // See .cpp for documentation
   int32_t gossip_include_rsm_versions_frequency;
+  bool gossip_compact_encoding;
+  int32_t gossip_full_state_interval;
+  NodeLocationScope gossip_hierarchy_scope;
+  int32_t gossip_hierarchy_cross_scope_interval;
 
   const char* getName() const override {
     return "GossipSettings";
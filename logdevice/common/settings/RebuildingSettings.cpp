@@ -53,6 +53,22 @@ std::istream& operator>>(std::istream& in, RebuildingReadOnlyOption& val) {
   return in;
 }
 
+std::istream& operator>>(std::istream& in,
+                         RebuildingChecksumVerification& val) {
+  std::string token;
+  in >> token;
+  if (token == "per-record") {
+    val = RebuildingChecksumVerification::PER_RECORD;
+  } else if (token == "batch") {
+    val = RebuildingChecksumVerification::BATCH;
+  } else if (token == "skip-if-verified-on-store") {
+    val = RebuildingChecksumVerification::SKIP_IF_VERIFIED_ON_STORE;
+  } else {
+    in.setstate(std::ios::failbit);
+  }
+  return in;
+}
+
 void RebuildingSettings::defineSettings(SettingEasyInit& init) {
   using namespace SettingFlag;
 
@@ -74,6 +90,17 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "allow many shards to be grouped and planned together.",
        SERVER,
        SettingsCategory::Rebuilding);
+  init("rebuilding-planning-batch-logs",
+       &planning_batch_logs,
+       "0",
+       nullptr,
+       "If positive, a donor starts re-replicating a shard as soon as this "
+       "many logs have a rebuilding plan, instead of waiting for all logs to "
+       "be planned. Logs planned after that are handed to the running shard "
+       "rebuilding in batches of this size, each read by its own read "
+       "stream. 0 means wait for the whole plan.",
+       SERVER,
+       SettingsCategory::Rebuilding);
 
   init("disable-rebuilding",
        &disable_rebuilding,
@@ -129,6 +156,18 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "Max amount of time rebuilding read storage task is allowed to "
        "take before yielding to other storage tasks. \"max\" for unlimited.",
        SERVER);
+  init("rebuilding-read-streams",
+       &read_streams,
+       "1",
+       parse_positive<size_t>(),
+       "Number of independent read streams a donor uses to read a shard for "
+       "rebuilding. Logs are split among the streams, and each stream has its "
+       "own iterator and at most one read storage task in flight, so the "
+       "shard is scanned by up to this many storage threads concurrently. "
+       "Records of a log are always read by the same stream, in order. Takes "
+       "effect for rebuildings started after the change.",
+       SERVER,
+       SettingsCategory::Rebuilding);
   init("rebuilding-max-records-in-flight",
        &max_records_in_flight,
        "200",
@@ -152,6 +191,47 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
       "node can have in flight at the same time, per shard.",
       SERVER,
       SettingsCategory::Rebuilding);
+  init("rebuilding-autotune-interval",
+       &autotune_interval,
+       "0s",
+       validate_nonnegative<ssize_t>(),
+       "If positive, every this often each shard rebuilding on a donor looks "
+       "at the p99 latency of appends on this node and of stores on the "
+       "shard since the last check. While both are below "
+       "rebuilding-autotune-append-latency-p99 and "
+       "rebuilding-autotune-store-latency-p99, it raises its "
+       "rebuilding-max-records-in-flight and "
+       "rebuilding-max-record-bytes-in-flight limits step by step, up to "
+       "rebuilding-autotune-max-scale times the configured values; when "
+       "either is above target it halves them, down to 1/16 of the "
+       "configured values. 0 disables autotuning and uses the configured "
+       "limits as is.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-autotune-append-latency-p99",
+       &autotune_append_latency_p99,
+       "100ms",
+       validate_positive<ssize_t>(),
+       "Target p99 append latency for rebuilding-autotune-interval.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-autotune-store-latency-p99",
+       &autotune_store_latency_p99,
+       "20ms",
+       validate_positive<ssize_t>(),
+       "Target p99 latency of (non-rebuilding) stores on the donor shard for "
+       "rebuilding-autotune-interval.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-autotune-max-scale",
+       &autotune_max_scale,
+       "4",
+       validate_range<double>(1, 1000),
+       "Highest multiplier that rebuilding-autotune-interval may apply to "
+       "rebuilding-max-records-in-flight and "
+       "rebuilding-max-record-bytes-in-flight.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Rebuilding);
   init(
       "rebuilding-max-get-seq-state-in-flight",
       &max_get_seq_state_in_flight,
@@ -186,6 +266,21 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
        "default to avoid thrashing the cache.",
        SERVER,
        SettingsCategory::Rebuilding);
+  init("rebuilding-checksum-verification",
+       &checksum_verification,
+       "per-record",
+       nullptr,
+       "How a donor verifies checksums of the records it rebuilds when "
+       "verify-checksum-before-replicating is set. per-record: each record is "
+       "verified on a worker thread before being sent. batch: all records "
+       "read by a read storage task are verified together on the storage "
+       "thread using the multi-buffer checksum code. "
+       "skip-if-verified-on-store: don't verify records if "
+       "rocksdb-verify-checksum-during-store is set, since the records were "
+       "verified when written and RocksDB block checksums are verified on "
+       "read; otherwise same as per-record.",
+       SERVER,
+       SettingsCategory::Rebuilding);
   init("rebuilding-read-only",
        &read_only,
        "none",
@@ -26,6 +26,21 @@ enum class RebuildingReadOnlyOption {
   ON_RECIPIENT = 2,
 };
 
+// How a donor verifies payload checksums of the records it re-replicates
+// (if verify-checksum-before-replicating is set).
+enum class RebuildingChecksumVerification {
+  // Each record is verified on a worker thread right before its STOREs are
+  // sent.
+  PER_RECORD = 0,
+  // All records read by a read storage task are verified together on the
+  // storage thread, using the multi-buffer checksum code.
+  BATCH = 1,
+  // Records aren't verified if the local log store verified them when they
+  // were written and detects corruption of stored data on read (RocksDB
+  // block checksums). Otherwise same as PER_RECORD.
+  SKIP_IF_VERIFIED_ON_STORE = 2,
+};
+
 struct RebuildingSettings : public SettingsBundle {
   const char* getName() const override {
     return "RebuildingSettings";
@@ -40,12 +55,19 @@ struct RebuildingSettings : public SettingsBundle {
   std::chrono::milliseconds local_window;
   std::chrono::milliseconds global_window;
   std::chrono::milliseconds planner_scheduling_delay;
+  size_t planning_batch_logs;
   size_t max_batch_bytes;
   std::chrono::milliseconds max_batch_time;
+  size_t read_streams;
   size_t max_records_in_flight;
   size_t max_record_bytes_in_flight;
+  std::chrono::milliseconds autotune_interval;
+  std::chrono::milliseconds autotune_append_latency_p99;
+  std::chrono::milliseconds autotune_store_latency_p99;
+  double autotune_max_scale;
   bool use_rocksdb_cache;
   RebuildingReadOnlyOption read_only;
+  RebuildingChecksumVerification checksum_verification;
   size_t max_get_seq_state_in_flight;
   chrono_interval_t<std::chrono::milliseconds> retry_timeout;
   chrono_interval_t<std::chrono::milliseconds> store_timeout;
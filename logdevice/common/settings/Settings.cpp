@@ -15,6 +15,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/program_options.hpp>
 #include <boost/thread/thread.hpp>
+#include <folly/Conv.h>
 #include <folly/String.h>
 
 #include "logdevice/common/SnapshotStoreTypes.h"
@@ -394,6 +395,36 @@ parse_authoritative_status_overrides(const std::string& value) {
   return res;
 }
 
+static std::array<std::array<uint32_t, 3>, numOfWorkerTypes()>
+parse_requests_per_iteration_by_worker_type(const std::string& value) {
+  std::array<std::array<uint32_t, 3>, numOfWorkerTypes()> res{};
+  std::vector<std::string> tokens;
+  folly::split(',', value, tokens, true);
+  for (const std::string& tok : tokens) {
+    // tok format: "F:40:8:1", worker type followed by hi, mid and lo
+    std::vector<folly::StringPiece> parts;
+    folly::split(':', tok, parts);
+    WorkerType type = parts.size() == 4 && parts[0].size() == 1
+        ? workerTypeByChar(parts[0][0])
+        : WorkerType::MAX;
+    std::array<uint32_t, 3> counts{};
+    bool ok = type != WorkerType::MAX &&
+        res[workerIndexByType(type)] == std::array<uint32_t, 3>{};
+    for (size_t i = 0; ok && i < counts.size(); ++i) {
+      auto count = folly::tryTo<uint32_t>(parts[i + 1]);
+      ok = count.hasValue() && count.value() > 0;
+      counts[i] = ok ? count.value() : 0;
+    }
+    if (!ok) {
+      throw boost::program_options::error(
+          "Invalid or duplicate requests per iteration override: " + tok +
+          "; expected <worker type>:<hi>:<mid>:<lo>, e.g. F:40:8:1");
+    }
+    res[workerIndexByType(type)] = counts;
+  }
+  return res;
+}
+
 static SnapshotStoreType validate_rsm_snapshot_store(const std::string& value) {
   if (value == "legacy") {
     return SnapshotStoreType::LEGACY;
@@ -410,6 +441,17 @@ static SnapshotStoreType validate_rsm_snapshot_store(const std::string& value) {
   }
 }
 
+std::array<uint32_t, 3> Settings::requestsPerIteration(WorkerType type) const {
+  const auto& counts =
+      requests_per_iteration_by_worker_type[workerIndexByType(type)];
+  if (counts != std::array<uint32_t, 3>{}) {
+    return counts;
+  }
+  return {hi_requests_per_iteration,
+          mid_requests_per_iteration,
+          lo_requests_per_iteration};
+}
+
 void Settings::defineSettings(SettingEasyInit& init) {
   using namespace SettingFlag;
 
@@ -468,6 +510,35 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "per CPU core",
        SERVER | CLIENT | REQUIRES_RESTART /* used in Processor ctor */,
        SettingsCategory::Execution);
+  init("min-active-workers",
+       &min_active_workers,
+       "0",
+       validate_nonnegative<int>(),
+       "If nonzero, lets lightly loaded nodes park worker threads down to "
+       "this many. A parked worker gets no new work (requests, read streams, "
+       "incoming connections) and mostly sleeps, but keeps serving whatever "
+       "it already owns. Workers are unparked one at a time as load rises. "
+       "0 keeps all --num-workers workers active.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
+  init("worker-park-utilization-pct",
+       &worker_park_utilization_pct,
+       "20",
+       validate_range<double>(0, 100),
+       "If --min-active-workers is set, a worker is parked when the average "
+       "CPU utilization of active workers would stay below this percentage "
+       "of a core without it.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
+  init("worker-unpark-utilization-pct",
+       &worker_unpark_utilization_pct,
+       "70",
+       validate_range<double>(0, 100),
+       "If --min-active-workers is set, a parked worker is unparked when the "
+       "average CPU utilization of active workers exceeds this percentage of "
+       "a core. Must be greater than --worker-park-utilization-pct.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
   init("msg-error-injection-chance",
        &message_error_injection_chance_percent,
        "0",
@@ -568,6 +639,36 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "amount of RECORD data to push to the client at once",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
+  init("read-batch-target-drain-time",
+       &read_batch_target_drain_time,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, the size of each batch of records read for a read stream "
+       "is chosen from the rate at which the client has been draining "
+       "records of that stream, so that the batch plus the bytes still "
+       "pending in the output buffer last about this long. Batches are "
+       "capped at output-max-records-kb. 0 disables adaptive sizing.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
+  init("read-batch-min-bytes",
+       &read_batch_min_bytes,
+       "16K",
+       parse_positive<size_t>(),
+       "Smallest read batch that read-batch-target-drain-time may choose.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
+  init("read-stream-stall-trace-threshold",
+       &read_stream_stall_trace_threshold,
+       "1min",
+       validate_nonnegative<ssize_t>(),
+       "Report a server read stream to the server_stall_read_tracer trace "
+       "table once it has gone this long without shipping records or gaps to "
+       "the client, not counting time spent waiting for new records to be "
+       "released. The sample breaks the stall down by what the stream was "
+       "waiting for (storage task, bandwidth, client window, ...). 0 "
+       "disables.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("max-time-to-allow-socket-drain",
        &max_time_to_allow_socket_drain,
        "3min",
@@ -587,6 +688,48 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "details.",
        SERVER | CLIENT,
        SettingsCategory::Network);
+  init("zero-copy-write-threshold",
+       &zero_copy_write_threshold,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Socket writes of at least this many bytes are sent with MSG_ZEROCOPY, "
+       "saving the copy into the kernel for large RECORD batches. Only plain "
+       "(non-SSL) sockets on kernels supporting SO_ZEROCOPY, and only writes "
+       "whose buffers are all refcounted. The kernel pins the pages until the "
+       "data is acknowledged, and small writes are cheaper to copy, so keep "
+       "this well above a page (e.g. 64KB). 0 disables zero-copy writes.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("message-compression",
+       &message_compression,
+       "lz4",
+       parse_compression,
+       "Codec for compressing messages sent across "
+       "--message-compression-boundary: \"none\", \"zstd\", \"lz4\" or "
+       "\"lz4_hc\". Each message is compressed on its own, so no state is "
+       "kept per connection. Only used with peers that support it.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("message-compression-boundary",
+       &message_compression_boundary,
+       "none",
+       nullptr, // no validation
+       "Compress messages sent across this boundary, e.g. \"region\" "
+       "compresses cross-region traffic. Can be one of \"none\", \"node\", "
+       "\"rack\", \"row\", \"cluster\", \"data_center\" or \"region\". "
+       "\"none\" disables message compression. On servers, connections "
+       "from clients count as crossing every boundary below \"region\", "
+       "and \"region\" too if they use SSL.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("message-compression-min-size",
+       &message_compression_min_size,
+       "4096",
+       parse_nonnegative<ssize_t>(),
+       "Only messages of at least this many bytes are compressed. Smaller "
+       "messages rarely compress well enough to be worth the CPU.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
   init("min-socket-idle-threshold-percent",
        &min_socket_idle_threshold_percent,
        "50",
@@ -679,6 +822,41 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "number of LO_PRI requests to process per worker event loop iteration",
        SERVER | CLIENT,
        SettingsCategory::Execution);
+  init("requests-per-iteration-by-worker-type",
+       &requests_per_iteration_by_worker_type,
+       "",
+       parse_requests_per_iteration_by_worker_type,
+       "Overrides execute-requests, mid_requests_per_iteration and "
+       "lo_requests_per_iteration for workers of the given types. "
+       "Comma-separated list of '<type>:<hi>:<mid>:<lo>', where type is the "
+       "letter of the worker type as in worker names (G for general, F for "
+       "failure detector, B for background). E.g. 'F:40:8:1' lets the "
+       "failure detector worker run up to 40 HI_PRI requests per event loop "
+       "iteration, so that gossip processing isn't held back by a backlog "
+       "of other work.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
+  init("busy-poll-max-spin",
+       &busy_poll_max_spin,
+       "0us",
+       validate_nonnegative<ssize_t>(),
+       "If nonzero, worker threads and storage threads that run out of work "
+       "busy-poll their queues for up to this long before going to sleep, "
+       "which takes a kernel wakeup off the latency of work handed to them "
+       "shortly after, at the cost of CPU. The spin time adapts to how often "
+       "spinning finds work and is capped by --busy-poll-cpu-budget. A worker "
+       "doesn't process socket events while spinning, so keep this to tens "
+       "of microseconds. Meant for latency-critical tiers with spare cores.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
+  init("busy-poll-cpu-budget",
+       &busy_poll_cpu_budget,
+       "0.5",
+       validate_range<double>(0, 1),
+       "Fraction of wall time each thread may spend busy-polling when "
+       "--busy-poll-max-spin is set.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
   init("worker-request-pipe-capacity",
        &worker_request_pipe_capacity,
        "524288",
@@ -704,6 +882,27 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "logdevice.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Execution);
+  init("worker-numa-affinity",
+       &worker_numa_affinity,
+       "false",
+       nullptr, // no validation
+       "Spread the worker threads of each pool across the NUMA nodes of the "
+       "machine, round-robin, and pin each one to the CPUs of its node. Has no "
+       "effect on machines with a single NUMA node.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Execution);
+  init("handoff-stores-by-log",
+       &handoff_stores_by_log,
+       "false",
+       nullptr, // no validation
+       "Process each STORE on the worker that owns its log (picked by a hash "
+       "of the log ID) rather than on the worker that owns the connection it "
+       "arrived on. The connection's worker still reads and parses the "
+       "message. Separates socket I/O from store processing and keeps a slow "
+       "log from delaying stores for other logs on the same connection, at "
+       "the cost of a hop between workers.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Execution);
   init("request-exec-threshold",
        &request_execution_delay_threshold,
        "10ms",
@@ -712,6 +911,27 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "and 'worker_slow_requests' stat is bumped",
        SERVER | CLIENT,
        SettingsCategory::Monitoring);
+  init("event-loop-profiler-sampling-rate",
+       &event_loop_profiler_sampling_rate,
+       "0.01",
+       validate_range<double>(0, 1),
+       "Fraction of request executions and message callbacks on workers whose "
+       "duration is used to compute the per-type average execution time "
+       "reported by the 'info event_loop' admin command. The per-type maximum "
+       "execution time is tracked regardless of this setting.",
+       SERVER | CLIENT,
+       SettingsCategory::Monitoring);
+  init("worker-cpu-time-sampling-rate",
+       &worker_cpu_time_sampling_rate,
+       "0.01",
+       validate_range<double>(0, 1),
+       "Fraction of request executions and message callbacks on workers whose "
+       "thread CPU time is measured. The per-request-type and "
+       "per-message-type stats request_worker_cpu_usec and "
+       "message_worker_cpu_usec extrapolate the total CPU time from the "
+       "sampled executions. 0 disables the measurement.",
+       SERVER | CLIENT,
+       SettingsCategory::Monitoring);
   init("slow-background-task-threshold",
        &slow_background_task_threshold,
        "100ms",
@@ -798,6 +1018,28 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "size of the record cache.",
        SERVER,
        SettingsCategory::Recovery);
+  init("record-cache-rss-limit",
+       &record_cache_rss_limit,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive and the resident set size of the server process grows "
+       "above this many bytes, the record cache monitor evicts the excess "
+       "from the record cache, even if the cache is under "
+       "--record-cache-max-size. Set it somewhat below the memory limit of "
+       "the container to shed record cache before the process gets killed. "
+       "0 disables.",
+       SERVER,
+       SettingsCategory::Recovery);
+  init("record-cache-repopulation-threads",
+       &record_cache_repopulation_threads,
+       "4",
+       parse_positive<ssize_t>(),
+       "Number of threads each shard uses to deserialize record cache "
+       "snapshots and insert them into the record cache when repopulating "
+       "record caches on startup. Snapshot blobs are still read from the "
+       "local log store sequentially.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Recovery);
 
   init("abort-on-failed-check",
        &abort_on_failed_check,
@@ -1073,6 +1315,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "often. Needs restart to load the new values.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Network);
+  init("connect-throttle-jitter",
+       &connect_throttle_jitter,
+       "0.5",
+       validate_range<double>(0, 1),
+       "fraction of the --connect-throttle delay that is randomized: after a "
+       "failed connection attempt, the next one is made after a random time "
+       "between (1 - jitter) and 1 times the current delay. Keeps nodes and "
+       "clients that lost their connections at the same time, e.g. in a "
+       "network partition, from all reconnecting at the same time when it "
+       "heals. Needs restart to load the new value.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Network);
   init("disable-chain-sending",
        &disable_chain_sending,
        "false",
@@ -1080,6 +1334,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "never send a wave of STORE messages through a chain",
        SERVER,
        SettingsCategory::WritePath);
+  init("max-stored-batch-size",
+       &max_stored_batch_size,
+       "1",
+       validate_positive<ssize_t>(),
+       "Storage nodes reply to up to this many STOREs from the same sequencer "
+       "connection with a single STORED_BATCH message, instead of one STORED "
+       "message each. Replies are held at most until the end of the current "
+       "event loop iteration. Replies to rebuilding STOREs are never batched, "
+       "and only sequencers that support it get batches. 1 disables "
+       "batching.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("sbr-low-watermark-check-interval",
        &sbr_low_watermark_check_interval,
        "60s",
@@ -1145,6 +1411,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "too long).",
        SERVER,
        SettingsCategory::WritePath);
+  init("append-overload-hint-window-fill",
+       &append_overload_hint_window_fill,
+       "0.9",
+       validate_range<double>(0, 1),
+       "Fraction of the sliding window of a sequencer that must be in use "
+       "for the sequencer to tell clients, in the replies to successful "
+       "appends, that it is close to overloaded. Clients then send probes "
+       "ahead of their next appends to it, instead of payloads that would "
+       "likely be rejected. 0 disables the hint.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("disabled-retry-interval",
        &disabled_retry_interval,
        "30s",
@@ -1175,6 +1452,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "the number of TCP connection retries before giving up",
        SERVER | CLIENT,
        SettingsCategory::Network);
+  init("num-connections-per-node",
+       &num_connections_per_node,
+       "1",
+       validate_positive<ssize_t>(),
+       "Number of data connections each worker opens to each node it talks "
+       "to. Records, reads and other messages about a log are spread across "
+       "them by a hash of the log ID, so messages about the same log stay in "
+       "order, while the peer can read different logs from different "
+       "connections in parallel, possibly on different workers. The "
+       "connections to a node are closed together if one of them closes.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Network);
   init("connect-timeout-retry-multiplier",
        &connect_timeout_retry_multiplier,
        "3",
@@ -1262,6 +1551,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Don't graylist nodes that have p95 store latency less than this.",
        SERVER,
        SettingsCategory::WritePath);
+  init("graylisting-median-latency-ratio",
+       &graylisting_median_latency_ratio,
+       "0",
+       validate_nonnegative<double>(),
+       "If positive, outlier based graylisting also considers a node an "
+       "outlier when its p95 store latency exceeds this multiple of the "
+       "median p95 store latency of the nodes in its region. This reacts to "
+       "slow but otherwise healthy nodes sooner than the statistical outlier "
+       "detection alone. 0 disables this check.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
+  init("graylisting-median-latency-exit-ratio",
+       &graylisting_median_latency_exit_ratio,
+       "0",
+       validate_nonnegative<double>(),
+       "A node that is already graylisted or about to be graylisted because "
+       "of --graylisting-median-latency-ratio keeps being considered an "
+       "outlier until its p95 store latency drops below this multiple of the "
+       "region median, so that nodes hovering around the threshold don't "
+       "flap in and out of the graylist. 0, or a value above "
+       "--graylisting-median-latency-ratio, means no hysteresis.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
   init("enable-read-throttling",
        &enable_read_throttling,
        "false",
@@ -1291,6 +1603,36 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "unless write-batch-size is reached first",
        SERVER,
        SettingsCategory::Storage);
+  init("rebuilding-write-batch-size",
+       &rebuilding_write_batch_size,
+       "4096",
+       parse_positive<ssize_t>(),
+       "max number of rebuilding STOREs for a storage thread to write in one "
+       "batch. Rebuilding writes arrive in bulk and nobody waits on their "
+       "latency, so bigger batches than write-batch-size cut the number of "
+       "rocksdb writes on rebuilding recipients.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-write-batch-bytes",
+       &rebuilding_write_batch_bytes,
+       "8388608", // 8MB
+       parse_positive<ssize_t>(),
+       "min number of payload bytes for a storage thread to write in one "
+       "batch of rebuilding STOREs unless rebuilding-write-batch-size is "
+       "reached first",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("write-batch-group-commit-window",
+       &write_batch_group_commit_window,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, a storage thread that picked up writes that need a WAL "
+       "sync (sync durability) waits up to this long for more writes to add "
+       "to the batch, until write-batch-size or write-batch-bytes is reached. "
+       "Trades a bit of latency for fewer rocksdb writes and WAL syncs under "
+       "load. 0 disables the wait.",
+       SERVER,
+       SettingsCategory::Storage);
   init("storage-tasks-use-drr",
        &storage_tasks_use_drr,
        "false",
@@ -1306,6 +1648,28 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Use something like 1MB for byte based scheduling.",
        SERVER,
        SettingsCategory::Storage);
+  init("storage-tasks-steal-cpu-stages",
+       &storage_tasks_steal_cpu_stages,
+       "false",
+       nullptr,
+       "If true, the CPU-only stage of a storage task that has one may run on "
+       "an idle storage thread of another shard after the I/O stage has been "
+       "done by the task's own shard. Helps when a few shards are much busier "
+       "than the others.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Storage);
+  init("storage-tasks-drr-injection-lanes",
+       &storage_tasks_drr_injection_lanes,
+       "0",
+       nullptr,
+       "If positive and storage-tasks-use-drr is enabled, up to this many "
+       "threads posting storage tasks (normally workers) get their own "
+       "lock-free queue feeding the DRR scheduler of each shard, instead of "
+       "all of them contending on the scheduler mutex. Threads beyond that "
+       "number use the mutex. Should be at least the total number of "
+       "workers. 0 disables the lanes.",
+       SERVER | REQUIRES_RESTART | EXPERIMENTAL,
+       SettingsCategory::Storage);
 
 #define STORAGE_TASK_PRINCIPAL(name, key, shareVal)                      \
   init("storage-task-" #key "-share",                                    \
@@ -1349,6 +1713,44 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "limit on the number of logs that can be in recovery at the same time",
        SERVER,
        SettingsCategory::Recovery);
+  init("recovery-queue-demand-window",
+       &recovery_queue_demand_window,
+       "64",
+       parse_positive<ssize_t>(),
+       "When more than --concurrent-log-recoveries data logs need recovery, "
+       "the rest are queued. Each time a recovery finishes, the next log to "
+       "recover is chosen among the first this many queued logs, preferring "
+       "logs whose sequencers have the most appends in flight, then the "
+       "highest recent append throughput, so that logs with writers waiting "
+       "are recovered first. 1 recovers queued logs in FIFO order.",
+       SERVER,
+       SettingsCategory::Recovery);
+  init("seal-storage-tasks-batch-size",
+       &seal_storage_tasks_batch_size,
+       "1",
+       parse_positive<ssize_t>(),
+       "Maximum number of SEAL requests for the same shard that a worker "
+       "groups into a single storage task. Requests are grouped if they "
+       "arrive during the same event loop iteration; their seals are written "
+       "to the local log store in one write batch and synced once, which "
+       "speeds up sealing when a sequencer failover triggers recovery of many "
+       "logs at once. 1 disables batching.",
+       SERVER,
+       SettingsCategory::Recovery);
+  init("purge-delete-tasks-batch-size",
+       &purge_delete_tasks_batch_size,
+       "1",
+       parse_positive<ssize_t>(),
+       "Maximum number of purging record deletions for the same shard that a "
+       "worker groups into a single storage task. Deletions are grouped if "
+       "they are issued during the same event loop iteration, possibly for "
+       "different logs; records of the same log are found with a single "
+       "iterator and all deletes of the group are written in one batch. This "
+       "reduces the number of small storage tasks and writes when many logs "
+       "are purged at once, e.g. after a sequencer failover. 1 disables "
+       "batching.",
+       SERVER,
+       SettingsCategory::Recovery);
   init("appender-buffer-queue-cap",
        &appender_buffer_queue_cap,
        "10000",
@@ -1398,6 +1800,25 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "apply to new reader instances",
        SERVER | CLIENT,
        SettingsCategory::ReadPath);
+  init("client-read-buffer-bytes",
+       &client_read_buffer_bytes,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "if nonzero, maximum number of bytes of records to buffer per read "
+       "stream in the client object while reading. The read window is shrunk "
+       "below --client-read-buffer-size records when the average record size "
+       "requires it. 0 means no limit",
+       SERVER | CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-buffers-memory-limit",
+       &client_read_buffers_memory_limit,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "if nonzero, maximum total number of bytes of records buffered by all "
+       "read streams of the client object. While it is exceeded, read streams "
+       "halve their windows each time they slide them. 0 means no limit",
+       SERVER | CLIENT,
+       SettingsCategory::ReadPath);
   init("client-read-flow-control-threshold",
        &client_read_flow_control_threshold,
        "0.7",
@@ -1406,6 +1827,27 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "window update messages (less means more often)",
        CLIENT | SERVER /* for event log reads */,
        SettingsCategory::ReadPath);
+  init("client-read-backlog-age",
+       &client_read_backlog_age,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, a read stream delivering records that were written more "
+       "than this long before they were received is considered to be reading "
+       "a backlog, and slides its window according to "
+       "--client-read-backlog-flow-control-threshold instead of "
+       "--client-read-flow-control-threshold. 0 disables backlog detection.",
+       CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-backlog-flow-control-threshold",
+       &client_read_backlog_flow_control_threshold,
+       "0.25",
+       validate_range<double>(std::numeric_limits<double>::min(), 1),
+       "like --client-read-flow-control-threshold, for read streams reading a "
+       "backlog (see --client-read-backlog-age). A lower value sends window "
+       "updates sooner, so that storage nodes keep reading ahead while the "
+       "client drains its buffer.",
+       CLIENT,
+       SettingsCategory::ReadPath);
   init("client-epoch-metadata-cache-size",
        &client_epoch_metadata_cache_size,
        "50000",
@@ -1414,6 +1856,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Set it to 0 to disable the epoch metadata cache.",
        CLIENT | REQUIRES_RESTART,
        SettingsCategory::ReadPath);
+  init("share-client-transport",
+       &share_client_transport,
+       "false",
+       nullptr, // no validation
+       "If true, Client objects created in the same process with the same "
+       "config URL, cluster name and credentials, that all have this setting "
+       "enabled, share worker threads and connections to the cluster instead "
+       "of each creating their own. Settings used by the worker threads are "
+       "those of the first such Client. Other settings, timeouts and write "
+       "tokens remain per Client.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Execution);
   init("client-readers-flow-tracer-period",
        &client_readers_flow_tracer_period,
        "0s",
@@ -1723,6 +2177,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "copyset manager will start a new block.",
        SERVER | REQUIRES_RESTART /* Used in CopySetManager ctor */,
        SettingsCategory::WritePath);
+  init("sticky-copysets-block-max-size",
+       &sticky_copysets_block_max_size,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If greater than --sticky-copysets-block-size, sticky copyset blocks "
+       "adapt to the write pattern of the log: every block that is ended "
+       "because it reached the size limit doubles the size limit of the next "
+       "block, up to this value. Blocks that end for other reasons, e.g. "
+       "because they reached --sticky-copysets-block-max-time, reset the limit "
+       "to --sticky-copysets-block-size. Larger blocks let readers using "
+       "single copy delivery read longer runs of records from the same node.",
+       SERVER | REQUIRES_RESTART /* Used in CopySetManager ctor */,
+       SettingsCategory::WritePath);
   init(
       "sticky-copysets-block-max-time",
       &sticky_copysets_block_max_time,
@@ -1886,6 +2353,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "be.",
        CLIENT | REQUIRES_RESTART /* used in ClientImpl::create() */,
        SettingsCategory::Configuration);
+  init("remote-logs-config-cache-size",
+       &remote_logs_config_cache_size,
+       "0",
+       parse_nonnegative<size_t>(),
+       "Maximum number of log groups the remote logs config (see "
+       "--on-demand-logs-config) keeps in its cache. When the cache is full, "
+       "the least recently used log groups are evicted. 0 means no limit.",
+       CLIENT | REQUIRES_RESTART /* used in ClientImpl::create() */,
+       SettingsCategory::Configuration);
+  init("remote-logs-config-prefetch-siblings",
+       &remote_logs_config_prefetch_siblings,
+       "false",
+       nullptr, // no validation
+       "If true, when the remote logs config (see --on-demand-logs-config) "
+       "fetches a log group by ID, it also fetches the other log groups in the "
+       "same directory in the background, so that lookups of neighbouring "
+       "logs don't each need a round trip to the server. Top-level log groups "
+       "are never prefetched, as that would fetch the whole config.",
+       CLIENT | REQUIRES_RESTART /* used in ClientImpl::create() */,
+       SettingsCategory::Configuration);
   init("alternative-layout-property",
        &alternative_layout_property,
        "",
@@ -1913,6 +2400,32 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Maximum amount of memory that can be allocated by read storage tasks.",
        SERVER,
        SettingsCategory::ResourceManagement);
+  init("read-storage-tasks-batch-size",
+       &read_storage_tasks_batch_size,
+       "1",
+       parse_positive<size_t>(),
+       "Maximum number of read storage tasks for the same shard that a worker "
+       "groups into a single storage task. Tasks are grouped if they are "
+       "issued during the same event loop iteration, and are executed back to "
+       "back in (log, lsn) order, which amortizes the storage thread handoff "
+       "and improves block cache locality when many readers tail adjacent "
+       "logs. 1 disables batching.",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("digest-read-tasks-per-client",
+       &digest_read_tasks_per_client,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Maximum number of read storage tasks for epoch recovery digest streams "
+       "that a worker may have in flight for one client (usually a sequencer "
+       "node recovering many logs), in addition to the single storage task "
+       "shared by all of the client's read streams. Combined with "
+       "--read-storage-tasks-batch-size, digest reads for many logs and "
+       "epochs are then executed together in one storage task instead of one "
+       "after another. 0 makes digest streams wait for the shared storage "
+       "task like other read streams.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("append-stores-max-mem-bytes",
        &append_stores_max_mem_bytes,
        "2G",
@@ -1945,6 +2458,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "externally before logdevice can do any ZooKeeper epoch store operations",
       SERVER | EXPERIMENTAL,
       SettingsCategory::Core);
+  init("zk-znode-cache-size",
+       &zk_znode_cache_size,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Maximum number of last clean epoch (LCE) znodes whose value and "
+       "version the Zookeeper epoch store remembers from its last read or "
+       "write. Updating the LCE of a log with a cached znode skips reading it "
+       "and writes it conditionally on the cached version, saving a round "
+       "trip to Zookeeper during recovery; if another node wrote the znode "
+       "since, the write fails and the update falls back to reading the "
+       "znode. 0 disables the cache.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Core);
   init("ssl-load-client-cert",
        &ssl_load_client_cert,
        "false",
@@ -1988,6 +2514,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "cached sessions.",
        SERVER | CLIENT,
        SettingsCategory::Security);
+  init("ssl-ktls",
+       &ssl_ktls,
+       "false",
+       nullptr,
+       "If enabled, once the TLS handshake completes, encryption and "
+       "decryption of SSL connections are offloaded to the kernel (kTLS), "
+       "saving the CPU cost of copying data through userspace crypto. Needs "
+       "OpenSSL 3 built with kTLS support and the kernel 'tls' module; "
+       "connections using a cipher the kernel doesn't support keep doing "
+       "crypto in userspace.",
+       SERVER | CLIENT | REQUIRES_RESTART /* used in Worker ctor */,
+       SettingsCategory::Security);
   init("ssl-boundary",
        &ssl_boundary,
        "none",
@@ -2093,6 +2631,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "for some time",
        SERVER /* for event log */ | CLIENT,
        SettingsCategory::ReaderFailover);
+  init("scd-stalled-shards-timeout",
+       &scd_stalled_shards_timeout,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "Timeout after which ClientReadStream considers down the storage "
+       "shards that did not send anything past the next record to deliver "
+       "while all other shards did, provided the other shards have copies of "
+       "all the records the stalled shards were supposed to send. Much lower "
+       "than --scd-timeout to fail over quickly when a storage node stalls. "
+       "0 disables it.",
+       SERVER /* for event log */ | CLIENT,
+       SettingsCategory::ReaderFailover);
   init(
       "verify-checksum-before-replicating",
       &verify_checksum_before_replicating,
@@ -2148,6 +2698,25 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Store polling in addition to the required response for each wave",
        CLIENT | SERVER,
        SettingsCategory::Configuration);
+  init("nodes-configuration-delta-history",
+       &nodes_configuration_delta_history,
+       "8",
+       parse_nonnegative<ssize_t>(),
+       "Number of recent nodes configurations each worker keeps in order to "
+       "answer nodes configuration polls with a delta against the version the "
+       "poller already has, instead of the full config. A poller whose version "
+       "is older than all of them gets the full config. 0 disables deltas.",
+       SERVER,
+       SettingsCategory::Configuration);
+  init("nodes-configuration-poll-deltas",
+       &nodes_configuration_poll_deltas,
+       "true",
+       nullptr, // no validation
+       "When polling servers for nodes configuration updates, ask for a delta "
+       "against the version we have instead of the full config. If a delta "
+       "can't be applied, the full config is fetched instead.",
+       CLIENT | SERVER,
+       SettingsCategory::Configuration);
   init("nodes-configuration-seed-servers",
        &nodes_configuration_seed_servers,
        "",
@@ -2280,6 +2849,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Maximum delay to use when reader application rejects a record or gap",
        SERVER /* event log */ | CLIENT,
        SettingsCategory::ReadPath);
+  init("client-read-stream-rebalance-interval",
+       &client_read_stream_rebalance_interval,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, AsyncReader measures the bytes/sec delivered by each of "
+       "its read streams this often, and if the streams on one Worker "
+       "deliver more than 25% above the average per Worker, moves some of "
+       "them to the least loaded Workers. A moved stream is restarted on the "
+       "new Worker from the next LSN it would have delivered. 0 disables "
+       "rebalancing; streams then stay on the Worker chosen by "
+       "startReading().",
+       CLIENT,
+       SettingsCategory::ReadPath);
   init("include-destination-on-handshake",
        &include_destination_on_handshake,
        "true",
@@ -2355,6 +2937,38 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "benefit of batching and recompressing would be small.",
       SERVER,
       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive",
+       &sequencer_batching_adaptive,
+       "false",
+       nullptr, // no validation
+       "If true, sequencer batching (if used) tracks the append rate of every "
+       "log and decides per log whether to batch and how long to wait. Logs "
+       "that are expected to get fewer than "
+       "--sequencer-batching-adaptive-min-records appends within their time "
+       "trigger pass through unbatched. For the other logs the time trigger is "
+       "shortened to the time in which "
+       "--sequencer-batching-adaptive-target-records appends are expected; "
+       "the configured time trigger is the upper bound on the batching delay. "
+       "Decisions are reported by 'info sequencer_batching'.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive-min-records",
+       &sequencer_batching_adaptive_min_records,
+       "2",
+       nullptr, // no validation
+       "With --sequencer-batching-adaptive, only batch logs that are expected "
+       "to get at least this many appends within their time trigger.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive-target-records",
+       &sequencer_batching_adaptive_target_records,
+       "100",
+       nullptr, // no validation
+       "With --sequencer-batching-adaptive, flush a log's batch after the time "
+       "in which this many appends are expected, if shorter than its time "
+       "trigger. 0 means always wait for the time trigger.",
+       SERVER,
+       SettingsCategory::Batching);
   init("num-processor-background-threads",
        &num_processor_background_threads,
        "0",
@@ -2376,6 +2990,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "thread.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
+  init("client-bg-decompression-bytes-threshold",
+       &client_bg_decompression_bytes_threshold,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive, AsyncReader decompresses compressed buffered writes of "
+       "at least this many bytes on background threads (see "
+       "num-processor-background-threads) instead of the Worker thread that "
+       "reads the log. Records of each log are still delivered in order, but "
+       "decompression of different logs read by the same Worker proceeds in "
+       "parallel. 0 (default) means decompress on the Worker.",
+       CLIENT,
+       SettingsCategory::Batching);
   init("buffered-writer-zstd-level",
        &buffered_writer_zstd_level,
        "1",
@@ -2383,6 +3009,32 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Zstd compression level to use in BufferedWriter.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
+  init("buffered-writer-zstd-workers",
+       &buffered_writer_zstd_workers,
+       "0",
+       parse_validate_range<int>(0, 64),
+       "If positive, BufferedWriter (and sequencer batching) compresses ZSTD "
+       "batches of at least 1MB with this many threads in parallel: zstd "
+       "splits the batch into chunks compressed independently. Every thread "
+       "constructing batches (see num-processor-background-threads) gets its "
+       "own set of compression threads. The compressed format doesn't change. "
+       "Has no effect if libzstd was built without multithreading support.",
+       SERVER | CLIENT,
+       SettingsCategory::Batching);
+  init("stream-writer-backlog-threshold",
+       &stream_writer_backlog_threshold,
+       "8",
+       nullptr,
+       "Write-ahead batching for ordered stream writes. While the write "
+       "stream of a log has at least this many appends waiting for the "
+       "sequencer's acknowledgement, BufferedWriter keeps adding records to "
+       "the batch it is building for the log instead of flushing it on the "
+       "time or size trigger, up to the maximum payload size. This sends "
+       "fewer, larger APPENDs (one stream sequence number each) when the "
+       "sequencer falls behind. Explicit flushes are not affected. 0 "
+       "disables.",
+       CLIENT,
+       SettingsCategory::Batching);
   init("background-queue-size",
        &background_queue_size,
        "100000",
@@ -2762,6 +3414,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Testing);
 
+  init("rebuilding-local-recipients-scope",
+       &rebuilding_local_recipients_scope,
+       "root",
+       nullptr, // no validation
+       "When picking recipients for rebuilt copies of records, prefer nodes "
+       "that share the donor's location at the smallest possible scope up to "
+       "this one (e.g. \"row\" tries the donor's rack, then its row), as "
+       "long as the log's replication property can still be satisfied. "
+       "Reduces cross-rack and cross-row traffic generated by rebuilding. "
+       "\"node\" or \"root\" disable the preference.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+
   init("scd-copyset-reordering-max",
        &scd_copyset_reordering_max,
        "hash-shuffle",
@@ -2842,6 +3507,21 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER | DEPRECATED,
        SettingsCategory::WritePath);
 
+  init("copyset-table-size",
+       &copyset_table_size,
+       "0",
+       nullptr, // no validation
+       "If nonzero, the weighted copyset selector draws this many copysets "
+       "per log and worker thread in advance, and then picks each copyset "
+       "uniformly at random from these, which is much cheaper than sampling "
+       "the failure domain hierarchy for every record. The table is redrawn "
+       "whenever a node of the nodeset becomes unavailable or available "
+       "again, and after every copyset was used about 16 times on average. "
+       "Larger tables follow the node weights more closely. 0 disables the "
+       "table.",
+       SERVER,
+       SettingsCategory::WritePath);
+
   init("copyset-locality-min-scope",
        &copyset_locality_min_scope,
        "rack",
@@ -2910,6 +3590,31 @@ void Settings::defineSettings(SettingEasyInit& init) {
        CLIENT,
        SettingsCategory::Monitoring);
 
+  init("shadow-batching-time-trigger",
+       &shadow_batching_time_trigger,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If nonzero, shadow clients batch appends that aren't BufferedWriter "
+       "batches already and have no keys or counters with a BufferedWriter, "
+       "which sends a batch to the shadow cluster after this long. Saves the "
+       "client one APPEND per shadowed record. 0 sends every shadowed record "
+       "as a separate append. Only applies to shadow clients created after the "
+       "setting is changed.",
+       CLIENT,
+       SettingsCategory::Batching);
+
+  init("shadow-buffer-limit-mb",
+       &shadow_buffer_limit_mb,
+       "64",
+       nullptr,
+       "Approximate memory budget of each shadow client for payloads that are "
+       "buffered or being appended to the shadow cluster. Shadow appends that "
+       "would exceed it are dropped rather than slowing down the client. "
+       "0 for no limit. Only applies to shadow clients created after the "
+       "setting is changed.",
+       CLIENT,
+       SettingsCategory::WritePath);
+
   init("enable-nodes-configuration-manager",
        &enable_nodes_configuration_manager,
        "false", // defaults to false
@@ -2969,6 +3674,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        CLIENT | SERVER | REQUIRES_RESTART,
        SettingsCategory::Testing);
 
+  init("config-cache-dir",
+       &config_cache_dir,
+       "", // defaults to empty
+       nullptr,
+       "If set, the client stores the last main config it fetched from the "
+       "config source in this directory, and on startup uses the stored copy "
+       "right away instead of waiting for the source. The config from the "
+       "source replaces the cached one as soon as it is fetched, even if it "
+       "has an older version. Empty string disables the cache.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Configuration);
+
   init("shadow-client",
        &shadow_client,
        "false",
@@ -3061,6 +3778,41 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "activations for reprovisioning.",
        SERVER,
        SettingsCategory::Configuration);
+  init("sequencer-preactivation-history-path",
+       &sequencer_preactivation_history_path,
+       "",
+       nullptr, // no validation
+       "If not empty, path of a local file where the server periodically "
+       "records the logs whose sequencers on this node recently took appends. "
+       "On startup, the sequencers of these logs are activated in the "
+       "background, if this node is still the one that should run them, so "
+       "that the first appends after a restart don't wait for sequencer "
+       "activation and recovery. Only used with lazy sequencer placement.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Sequencer);
+  init("sequencer-preactivation-window",
+       &sequencer_preactivation_window,
+       "1h",
+       validate_positive<ssize_t>(),
+       "Logs whose sequencer took an append within this window are recorded "
+       "in sequencer-preactivation-history-path.",
+       SERVER,
+       SettingsCategory::Sequencer);
+  init("sequencer-preactivation-batch-size",
+       &sequencer_preactivation_batch_size,
+       "100",
+       parse_positive<ssize_t>(),
+       "Maximum number of sequencers pre-activated on startup every "
+       "sequencer-preactivation-batch-interval.",
+       SERVER,
+       SettingsCategory::Sequencer);
+  init("sequencer-preactivation-batch-interval",
+       &sequencer_preactivation_batch_interval,
+       "100ms",
+       validate_positive<ssize_t>(),
+       "Delay between batches of sequencer pre-activations on startup.",
+       SERVER,
+       SettingsCategory::Sequencer);
   init(
       "use-sequencer-affinity",
       &use_sequencer_affinity,
@@ -3071,6 +3823,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "looking elsewhere.",
       SERVER | CLIENT,
       SettingsCategory::WritePath);
+  init("sequencer-location-cache",
+       &sequencer_location_cache,
+       "true",
+       nullptr, // no validation
+       "If true, the client remembers which node last accepted an append for "
+       "each log and sends subsequent appends there directly instead of "
+       "hashing, which avoids redirects after sequencer failovers. Entries "
+       "are dropped when the node redirects, becomes unreachable, or changes "
+       "state in the cluster state.",
+       CLIENT,
+       SettingsCategory::WritePath);
   init("real-time-max-bytes",
        &real_time_max_bytes,
        "100000000",
@@ -3087,6 +3850,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "When the real time buffer reaches this size, we evict entries.",
        SERVER | REQUIRES_RESTART | EXPERIMENTAL,
        SettingsCategory::ReadPath);
+  init("real-time-shared-tail-batches",
+       &real_time_shared_tail_batches,
+       "0",
+       nullptr, // no validation
+       "Number of most recent batches of released records that each worker "
+       "keeps per log for real time reads, shared by all read streams of the "
+       "log. Without this, a read stream only gets the records released "
+       "since its last batch; with it, streams that fell slightly behind the "
+       "tail (e.g. when many readers tail the same log) are served from "
+       "memory instead of re-reading the same records from the local log "
+       "store. Counts towards real-time-max-bytes. 0 disables.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::ReadPath);
 
   init("test-timestamp-linear-transform",
        &test_timestamp_linear_transform,
@@ -3339,6 +4115,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Core);
 
+  init("rsm-prefetch-delta-log-tail",
+       &rsm_prefetch_delta_log_tail,
+       "true",
+       nullptr, // no validation
+       "When a replicated state machine (event log, logs config) starts, find "
+       "the tail of its delta log while its snapshot is being fetched rather "
+       "than after",
+       SERVER | CLIENT,
+       SettingsCategory::Core);
+
+  init("rsm-delta-log-read-buffer-size",
+       &rsm_delta_log_read_buffer_size,
+       "1000",
+       parse_positive<ssize_t>(),
+       "Buffer size, in records, of the read stream replicated state machines "
+       "use to read their delta log. A larger buffer allows more deltas to be "
+       "in flight while a state machine is catching up on startup.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Core);
+
   init("eventlog-snapshotting-period",
        &eventlog_snapshotting_period,
        "1h",
@@ -3391,6 +4187,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Findkey API call timeout. If omitted the client timeout will be used.",
        CLIENT,
        SettingsCategory::Core);
+  init("findkey-batch-size",
+       &findkey_batch_size,
+       "1024",
+       validate_positive<ssize_t>(),
+       "findTimeBulk() sends the FINDKEY messages for up to this many logs "
+       "that go to the same storage node within one event loop iteration as "
+       "a single FINDKEY_BATCH message. Storage nodes that don't support it "
+       "get one FINDKEY message per log. 1 disables batching.",
+       CLIENT,
+       SettingsCategory::Performance);
+  init("trim-batch-size",
+       &trim_batch_size,
+       "1024",
+       validate_positive<ssize_t>(),
+       "trimBulk() sends the TRIM messages for up to this many logs that go "
+       "to the same storage node within one event loop iteration as a single "
+       "TRIM_BATCH message. Storage nodes that don't support it get one TRIM "
+       "message per log. 1 disables batching.",
+       CLIENT,
+       SettingsCategory::Performance);
   init("append-timeout",
        &append_timeout,
        "",
@@ -3398,6 +4214,35 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Timeout for appends. If omitted the client timeout will be used.",
        CLIENT,
        SettingsCategory::Core);
+  init("append-coalescing",
+       &append_coalescing,
+       "false",
+       nullptr, // no validation
+       "Coalesce Client::append() calls for the same log that arrive within "
+       "--append-coalescing-window of each other into one APPEND message. "
+       "The batch is formatted like a BufferedWriter batch, which readers "
+       "decode into the original records. Callbacks are called for each "
+       "record; all records of a batch share the LSN and fail or succeed "
+       "together. Appends with keys or counters are never coalesced. Only "
+       "applies to clients created after the setting is changed.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Batching);
+  init("append-coalescing-window",
+       &append_coalescing_window,
+       "200us",
+       validate_nonnegative<ssize_t>(),
+       "With --append-coalescing, how long an append may wait for more "
+       "appends to the same log before it is sent.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Batching);
+  init("append-coalescing-max-batch-bytes",
+       &append_coalescing_max_batch_bytes,
+       "65536",
+       parse_positive<ssize_t>(),
+       "With --append-coalescing, only payloads smaller than this are "
+       "coalesced, and a batch is sent as soon as it reaches this size.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Batching);
   init("logsconfig-timeout",
        &logsconfig_timeout,
        "",
@@ -3433,6 +4278,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "and use HHWheelTimer backend.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Core);
+  init("worker-timer-wheel",
+       &worker_timer_wheel,
+       "false",
+       nullptr, // no validation
+       "Run timers (Appender store timeouts, read stream timers etc) on a "
+       "per-worker hierarchical timing wheel with 1ms ticks instead of "
+       "scheduling each one with libevent. Makes scheduling and cancelling a "
+       "timer O(1) and runs timers expiring together in one batch. Takes "
+       "precedence over --enable-hh-wheel-backed-timers.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Core);
   init("enable-store-histograms-calculations",
        &enable_store_histogram_calculations,
        "false",
@@ -3542,6 +4398,44 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Sequencer);
 
+  init("nodeset-incremental-selection",
+       &nodeset_incremental_selection,
+       "false",
+       nullptr,
+       "When the cluster or log attributes change, re-select nodesets "
+       "incrementally: keep as many shards of the current nodeset as "
+       "possible and only replace or add the shards needed to satisfy "
+       "nodeset size, balance and replication constraints. Without it, a "
+       "small change in the cluster can reshuffle the nodesets of many logs. "
+       "Nodeset randomizations (changes of nodeset seed) still select a new "
+       "nodeset from scratch. Supported by the weight-aware, consistent "
+       "hashing and random nodeset selectors.",
+       SERVER,
+       SettingsCategory::Sequencer);
+
+  init(
+      "nodeset-changes-limit",
+      &nodeset_changes_limit,
+      "unlimited",
+      [](const std::string& val) -> rate_limit_t {
+        rate_limit_t res;
+        int rv = parse_rate_limit(val.c_str(), &res);
+        if (rv != 0) {
+          throw boost::program_options::error(
+              "Invalid value for --nodeset-changes-limit. Expected format is "
+              "<count>/<duration><unit>, e.g. 100/1min, or 'unlimited'");
+        }
+        return res;
+      },
+      "Maximum rate at which a sequencer node reactivates sequencers in the "
+      "background to change their nodesets, across all logs. Reactivations "
+      "over the limit are delayed until the limit allows them, which spreads "
+      "out the new epochs and metadata log writes caused by a cluster "
+      "change. Doesn't apply to reactivations that are needed for other "
+      "reasons, e.g. a change in sequencer options.",
+      SERVER,
+      SettingsCategory::Sequencer);
+
   sequencer_boycotting.defineSettings(init);
 
   init("require-permission-message-types",
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <string>
 
@@ -17,6 +18,7 @@
 #include "logdevice/common/SnapshotStoreTypes.h"
 #include "logdevice/common/Sockaddr.h"
 #include "logdevice/common/StorageTask-enums.h"
+#include "logdevice/common/WorkerType.h"
 #include "logdevice/common/configuration/NodeLocation.h"
 #include "logdevice/common/protocol/MessageType.h"
 #include "logdevice/common/settings/ClientReadStreamFailureDetectorSettings.h"
@@ -79,6 +81,15 @@ struct Settings : public SettingsBundle {
   // number of worker threads to run
   int num_workers;
 
+  // If nonzero, GENERAL workers beyond this many may be parked (get no new
+  // work) while lightly loaded. See WorkerLoadBalancing::adjustActiveWorkers.
+  int min_active_workers;
+
+  // Average CPU utilization of active workers, in percent of a core, below
+  // which one more worker is parked and above which one is unparked.
+  double worker_park_utilization_pct;
+  double worker_unpark_utilization_pct;
+
   // Time interval after which watchdog wakes up and detects stalls
   std::chrono::milliseconds watchdog_poll_interval_ms;
 
@@ -202,6 +213,20 @@ struct Settings : public SettingsBundle {
   // details.
   size_t socket_idle_threshold;
 
+  // Writes of at least this many bytes are sent with MSG_ZEROCOPY, 0 disables.
+  size_t zero_copy_write_threshold;
+
+  // Codec for compressing messages sent across message_compression_boundary.
+  // NONE disables message compression.
+  Compression message_compression;
+
+  // Messages sent to peers that don't share this scope with us are
+  // compressed. ROOT (the default) means never.
+  NodeLocationScope message_compression_boundary;
+
+  // Only messages of at least this many bytes are compressed.
+  size_t message_compression_min_size;
+
   // A Connection is considered active if it had bytes pending in the Connection
   // above socket-idle-threshold for greater than
   // min-socket-idle-threshold-percent of socket-health-check-period.
@@ -222,6 +247,18 @@ struct Settings : public SettingsBundle {
   // to the client at once.  If -1, use the TCP sendbuf size.
   int output_max_records_kb;
 
+  // If positive, size read batches of each read stream so that they hold
+  // about this much time worth of data at the rate the client has been
+  // draining it, but no more than output_max_records_kb.
+  std::chrono::milliseconds read_batch_target_drain_time;
+
+  // Lower bound on read batch sizes chosen by read_batch_target_drain_time.
+  size_t read_batch_min_bytes;
+
+  // Report read streams that haven't made progress for this long to
+  // ServerStalledReadTracer. 0 disables.
+  std::chrono::milliseconds read_stream_stall_trace_threshold;
+
   // How many bytes of records to read in a single StorageTask.
   // Similar to output_max_records_kb but is applied *before* filtering records.
   int64_t max_record_bytes_read_at_once;
@@ -240,6 +277,23 @@ struct Settings : public SettingsBundle {
   uint32_t mid_requests_per_iteration;
   uint32_t lo_requests_per_iteration;
 
+  // Overrides of the three settings above for workers of some WorkerTypes,
+  // indexed by workerIndexByType(), in order hi, mid, lo. All zeros for types
+  // without an override. Use requestsPerIteration() to get the effective
+  // values.
+  std::array<std::array<uint32_t, 3>, numOfWorkerTypes()>
+      requests_per_iteration_by_worker_type;
+
+  // @return {hi,mid,lo}_requests_per_iteration for workers of the given type
+  std::array<uint32_t, 3> requestsPerIteration(WorkerType type) const;
+
+  // If nonzero, worker event loops and storage threads spin for up to this
+  // long waiting for more work before going to sleep. See BusyPoller.
+  std::chrono::microseconds busy_poll_max_spin;
+
+  // Fraction of wall time each busy polling thread may spend spinning.
+  double busy_poll_cpu_budget;
+
   // Size worker request pipe to hold this many requests.
   //
   // NOTE: This currently translates to a fcntl(F_SETPIPE_SZ) call which is
@@ -258,10 +312,29 @@ struct Settings : public SettingsBundle {
   // eventbase otherwise it will be instantiated with folly eventbase.
   bool use_legacy_eventbase;
 
+  // If true, workers are spread across NUMA nodes round-robin and each one
+  // only runs on the CPUs of its node.
+  bool worker_numa_affinity;
+
+  // If true, a Worker that receives a STORE for a log owned by another Worker
+  // (by a hash of the log ID) passes the message to that Worker instead of
+  // processing it itself. See HandOffMessageRequest.
+  bool handoff_stores_by_log;
+
   // Request Execution time(in milli-seconds) after which it is considered slow
   // and Worker stats 'worker_slow_requests' is bumped
   std::chrono::milliseconds request_execution_delay_threshold;
 
+  // Fraction of request executions and message callbacks whose duration is
+  // counted towards the averages reported by "info event_loop". The maximum
+  // durations are always tracked.
+  double event_loop_profiler_sampling_rate;
+
+  // Fraction of request executions and message callbacks on workers whose
+  // thread CPU time is measured for the request_worker_cpu_usec and
+  // message_worker_cpu_usec stats.
+  double worker_cpu_time_sampling_rate;
+
   // Background task execution time (in milli-seconds) after which it is
   // considered slow and we log it
   std::chrono::milliseconds slow_background_task_threshold;
@@ -307,6 +380,15 @@ struct Settings : public SettingsBundle {
   // See .cpp
   std::chrono::milliseconds graylisting_min_latency;
 
+  // If positive, also treat as outliers nodes whose p95 store latency is above
+  // this multiple of the median of their region. 0 disables.
+  double graylisting_median_latency_ratio;
+
+  // Hysteresis for graylisting_median_latency_ratio: a node that is already a
+  // (potential) outlier stays one until its latency drops below this multiple
+  // of the median. See .cpp
+  double graylisting_median_latency_exit_ratio;
+
   // Enable adaptive store timeouts. Which will use per worker histograms to
   // estimate first wave timeout.
   bool enable_adaptive_store_timeout;
@@ -331,6 +413,15 @@ struct Settings : public SettingsBundle {
   // size of the record cache
   std::chrono::seconds record_cache_monitor_interval;
 
+  // If positive and the resident set size of the process exceeds this, the
+  // record cache monitor evicts the excess from the record cache even if
+  // the cache is under record_cache_max_size.
+  size_t record_cache_rss_limit;
+
+  // number of threads each shard uses to deserialize record cache snapshots
+  // when repopulating record caches on startup
+  size_t record_cache_repopulation_threads;
+
   // When an ld_check() fails, call abort().  If not, just continue
   // executing.  We'll log either way.
   bool abort_on_failed_check;
@@ -405,10 +496,19 @@ struct Settings : public SettingsBundle {
   // a connection. Backoff for throttling Connection reinitiation attempts.
   chrono_expbackoff_t<std::chrono::milliseconds> connect_throttle;
 
+  // Fraction of connect_throttle delays that is randomized, to spread out
+  // reconnections of peers that lost their connections at the same time.
+  double connect_throttle_jitter;
+
   // If set, sequencer will never attempt to send STORE messages through a
   // chain.
   bool disable_chain_sending;
 
+  // Storage nodes batch up to this many replies to STOREs received on the
+  // same connection within one event loop iteration into a STORED_BATCH
+  // message. 1 disables batching.
+  size_t max_stored_batch_size;
+
   // Time interval that a node health check probe is sent if there is
   // an outstanding probe from the same node in nodeset
   std::chrono::seconds node_health_check_retry_interval;
@@ -442,6 +542,11 @@ struct Settings : public SettingsBundle {
   // temporarily disabled in the NodeSetState.
   std::chrono::seconds overloaded_retry_interval;
 
+  // Fraction of the sliding window of a sequencer that has to be in use for
+  // successful APPENDED replies to carry the SEQUENCER_OVERLOADED hint.
+  // 0 disables the hint.
+  double append_overload_hint_window_fill;
+
   // Time interval that Appenders would retry sending STOREs to a storage node
   // after it reported persistent error or rebuilding
   // (DISABLED status in STORED message) and
@@ -459,6 +564,10 @@ struct Settings : public SettingsBundle {
   // This option has no effect if connect_timeout is set to 0.
   size_t connection_retries;
 
+  // Number of data connections each Worker opens to each node. Messages about
+  // the same log always go over the same connection.
+  size_t num_connections_per_node;
+
   // Multiplier for the connect_timeout that will be applied on each
   // retry.
   // NOTE: default values are set up to kick off quick retries in case a SYN
@@ -482,12 +591,30 @@ struct Settings : public SettingsBundle {
   //   unless write_batch_size is reached first.
   size_t write_batch_bytes;
 
+  // Same as write_batch_size and write_batch_bytes but for batches of
+  // rebuilding STOREs (FAST_STALLABLE storage threads).
+  size_t rebuilding_write_batch_size;
+  size_t rebuilding_write_batch_bytes;
+
+  // If positive, a storage thread that picked up a batch of writes with
+  // SYNC_WRITE durability keeps collecting more writes for up to this long
+  // (or until write_batch_size/write_batch_bytes is reached) before writing,
+  // so that STOREs from many logs share one rocksdb write and one WAL sync.
+  std::chrono::microseconds write_batch_group_commit_window;
+
   // SLOW threadpool storage tasks go through the DRR scheduler.
   bool storage_tasks_use_drr;
 
   // Quanta for the DRR scheduler.
   uint64_t storage_tasks_drr_quanta = 1;
 
+  // If true, idle storage threads may run CPU stages of tasks of other shards.
+  bool storage_tasks_steal_cpu_stages;
+
+  // If positive, up to this many producer threads (normally workers) get a
+  // lock-free lane for putting tasks into the DRR scheduler of each shard.
+  size_t storage_tasks_drr_injection_lanes;
+
   // Shares for StorageTask principals.
   std::array<StorageTaskShare, (uint64_t)StorageTaskPrincipal::NUM_PRINCIPALS>
       storage_task_shares;
@@ -531,6 +658,22 @@ struct Settings : public SettingsBundle {
   // metadata recoveries running.
   int concurrent_log_recoveries;
 
+  // When a LogRecoveryRequest finishes and data log recoveries are queued,
+  // the next one is picked among the first this many queued logs, preferring
+  // the log with the most appends in flight and then the highest recent
+  // append throughput. 1 starts queued recoveries in FIFO order.
+  size_t recovery_queue_demand_window;
+
+  // Maximum number of SealStorageTasks for the same shard, created by one
+  // worker in the same event loop iteration, whose seals are written to the
+  // local log store in a single batch. 1 disables batching.
+  size_t seal_storage_tasks_batch_size;
+
+  // Maximum number of PurgeDeleteRecordsStorageTasks for the same shard,
+  // created by one worker in the same event loop iteration, whose deletes are
+  // written in a single batch. 1 disables batching.
+  size_t purge_delete_tasks_batch_size;
+
   // If true, purging will get the EpochRecoveryMetadata even if the epoch
   // is empty locally on the node
   bool get_erm_for_empty_epoch;
@@ -654,16 +797,39 @@ struct Settings : public SettingsBundle {
   // Client::createReader()
   size_t client_read_buffer_size;
 
+  // (client-only setting) If nonzero, maximum number of bytes of records to
+  // buffer in ClientReadStream. The window is shrunk below
+  // client_read_buffer_size records if records are large enough for a full
+  // buffer to exceed it.
+  size_t client_read_buffer_bytes;
+
+  // (client-only setting) If nonzero, maximum total number of bytes of
+  // records buffered by all read streams of the client. Read streams halve
+  // their windows each time they slide them while the total exceeds it.
+  size_t client_read_buffers_memory_limit;
+
   // (client-only setting) Threshold (relative to buffer size) at which
   // ClientReadStream broadcasts WINDOW messages to storage nodes.  Smaller
   // values mean more frequent broadcasting, possibly increasing throughput
   // but also wire chatter.
   double client_read_flow_control_threshold;
 
+  // If positive, a read stream whose records are older than this when they
+  // arrive is considered to be reading a backlog, and uses
+  // client_read_backlog_flow_control_threshold instead of
+  // client_read_flow_control_threshold.
+  std::chrono::milliseconds client_read_backlog_age;
+  double client_read_backlog_flow_control_threshold;
+
   // (client-only setting) maximum number of epoch metadata entries cached in
   // the client. Set it to 0 to disable epoch metadata caching
   size_t client_epoch_metadata_cache_size;
 
+  // (client-only setting) If true, Clients created with the same config URL,
+  // cluster name and credentials share one Processor, with its workers and
+  // connections. See SharedClientTransport.
+  bool share_client_transport;
+
   // (client-only setting) Period for logging in logdevice_readers_flow scuba
   // table. Set it to 0 to disable feature.
   std::chrono::milliseconds client_readers_flow_tracer_period;
@@ -729,6 +895,11 @@ struct Settings : public SettingsBundle {
   // CopySetSelector manager - sticky copyset block size
   size_t sticky_copysets_block_size;
 
+  // CopySetSelector manager - upper bound for the sticky copyset block size
+  // of logs whose blocks keep filling up. Not greater than
+  // sticky_copysets_block_size means fixed-size blocks.
+  size_t sticky_copysets_block_max_size;
+
   // CopySetSelector manager - sticky copyset block max time
   std::chrono::milliseconds sticky_copysets_block_max_time;
 
@@ -820,6 +991,14 @@ struct Settings : public SettingsBundle {
   // the client will be.
   std::chrono::seconds remote_logs_config_cache_ttl;
 
+  // (client-only setting) Maximum number of log groups the remote logs config
+  // keeps in its cache, 0 for no limit.
+  size_t remote_logs_config_cache_size;
+
+  // (client-only setting) When the remote logs config fetches a log group by
+  // ID, also fetch the other log groups in the same directory.
+  bool remote_logs_config_prefetch_siblings;
+
   // (server-only setting) Override the client FindKeyAccuracy setting with
   // FindKeyAccuracy::APPROXIMATE.
   bool findtime_force_approximate;
@@ -831,9 +1010,23 @@ struct Settings : public SettingsBundle {
   // the root znodes should be created by external tooling.
   bool zk_create_root_znodes;
 
+  // Number of last clean epoch znodes whose value and version the Zookeeper
+  // epoch store caches, letting LCE updates skip the read. 0 disables.
+  size_t zk_znode_cache_size;
+
   // Maximum amount of memory that can be allocated by read storage tasks.
   size_t read_storage_tasks_max_mem_bytes;
 
+  // Maximum number of ReadStorageTasks for the same shard, posted by one worker
+  // in the same event loop iteration, that get executed back to back as a
+  // single storage task. 1 disables batching.
+  size_t read_storage_tasks_batch_size;
+
+  // Maximum number of ReadStorageTasks for digest (recovery) read streams that
+  // one client's CatchupQueue may have in flight in addition to its one
+  // regular storage task. 0 means digest streams share the regular slot.
+  size_t digest_read_tasks_per_client;
+
   size_t append_stores_max_mem_bytes;
   size_t rebuilding_stores_max_mem_bytes;
 
@@ -855,6 +1048,10 @@ struct Settings : public SettingsBundle {
   // sessions.
   bool ssl_use_session_resumption;
 
+  // If enabled, SSL record encryption is offloaded to the kernel (kTLS) after
+  // the handshake, when OpenSSL and the kernel support it.
+  bool ssl_ktls;
+
   // Sets the boundary which triggers enabling SSL. Communication that crosses
   // this boundary will be encrypted; communication that doesn't will not.
   // For instance, if set to NodeLocationScope::RACK, all cross-rack traffic
@@ -895,6 +1092,16 @@ struct Settings : public SettingsBundle {
   // it is reasonable to keep it as high as 5min.
   std::chrono::milliseconds scd_all_send_all_timeout;
 
+  // (client-only setting) Timeout after which ClientReadStream adds to the
+  // shards down list the storage shards that have not sent anything past the
+  // next record to deliver while all the other shards have, if there are few
+  // enough of them that the other shards are guaranteed to hold a copy of
+  // every record they were supposed to send. This is much cheaper to act on
+  // than scd-timeout and can be set much lower, so that readers fail over
+  // quickly when a storage node stops sending (e.g. while it is restarting).
+  // 0 disables it.
+  std::chrono::milliseconds scd_stalled_shards_timeout;
+
   // (client-only setting) Default namespace to use on the client. This will
   // be used for any client functions that take log group name as a parameter.
   std::string default_log_namespace;
@@ -921,6 +1128,13 @@ struct Settings : public SettingsBundle {
   // polling in addition to the required response for each wave
   size_t server_based_nodes_configuration_store_polling_extra_requests;
 
+  // (server-only setting) Number of recent NodesConfigurations each worker
+  // keeps to answer NodesConfiguration polls with deltas. 0 disables deltas.
+  size_t nodes_configuration_delta_history;
+
+  // Ask for NodesConfiguration deltas when polling servers for updates
+  bool nodes_configuration_poll_deltas;
+
   // The seed string that will be used to fetch the initial nodes configuration
   // It can be in the form string:<server1>,<server2>,etc. Or you can provide an
   // smc tier via "smc:<smc_tier>". If it's empty, NCM client bootstrapping is
@@ -992,6 +1206,11 @@ struct Settings : public SettingsBundle {
   // Maximum delay to use when downstream rejects a record or gap.
   std::chrono::milliseconds client_max_redelivery_delay;
 
+  // If positive, AsyncReader compares the bytes/sec delivered by its read
+  // streams on each Worker this often, and moves streams off Workers that
+  // deliver much more than average.
+  std::chrono::milliseconds client_read_stream_rebalance_interval;
+
   // When true, the destination node ID of the client will be included in the
   // inital handshake. The client's actual node ID will be checked against the
   // intended destination node ID to see if there is a mismatch. If there is a
@@ -1026,6 +1245,20 @@ struct Settings : public SettingsBundle {
   // batching and recompressing would be small.
   ssize_t sequencer_batching_passthru_threshold;
 
+  // If true, sequencer batching tracks the append rate of every log and only
+  // batches logs that are expected to get at least
+  // sequencer_batching_adaptive_min_records appends within their time
+  // trigger. For logs it batches, the time trigger is shortened to the time
+  // in which sequencer_batching_adaptive_target_records appends are
+  // expected, the configured time trigger being the upper bound.
+  bool sequencer_batching_adaptive;
+
+  // See sequencer_batching_adaptive.
+  size_t sequencer_batching_adaptive_min_records;
+
+  // See sequencer_batching_adaptive. 0 means never shorten the time trigger.
+  size_t sequencer_batching_adaptive_target_records;
+
   // Number of background threads.  Currently, background threads are used by
   // BufferedWriter to construct/compress large batches.  If 0 (the default),
   // use num_workers.
@@ -1038,9 +1271,24 @@ struct Settings : public SettingsBundle {
   // larger, it will be enqueued to a helper thread.
   size_t buffered_writer_bg_thread_bytes_threshold;
 
+  // AsyncReader decompresses buffered writes of at least this many bytes on
+  // Processor's background threads, so that a reader reading many logs isn't
+  // limited by the Worker thread. 0 means always decompress on the Worker.
+  size_t client_bg_decompression_bytes_threshold;
+
   // Zstd compression level to use in BufferedWriter
   size_t buffered_writer_zstd_level;
 
+  // If positive, BufferedWriter batches of at least 1MB are compressed with
+  // ZSTD by this many threads in parallel.
+  int buffered_writer_zstd_workers;
+
+  // If positive, BufferedWriter doesn't flush the batch it's building for a
+  // log on the time or size trigger while the log's write stream has at least
+  // this many appends that aren't acknowledged yet. See
+  // StreamWriterAppendSink::isBacklogged().
+  size_t stream_writer_backlog_threshold;
+
   // Maximum number of tasks we can queue to a Processor's background thread
   // pool.  A single queue is shared by all threads in a single Processor's
   // pool.
@@ -1085,6 +1333,11 @@ struct Settings : public SettingsBundle {
   // and use HHWheelTimer backend.
   bool enable_hh_wheel_backed_timers;
 
+  // If true, Timers are run by a hierarchical timing wheel owned by the
+  // Worker they were created on instead of individual libevent timers. Takes
+  // precedence over enable_hh_wheel_backed_timers.
+  bool worker_timer_wheel;
+
   // If true, use the new version of timers which run on a different thread
   // and use HHWheelTimer backend.
   bool enable_store_histogram_calculations;
@@ -1223,6 +1476,12 @@ struct Settings : public SettingsBundle {
   // fully divorce append content from records touched by rebuilding.
   bool rebuild_without_amends;
 
+  // If RACK or bigger, rebuilding donors try to put new copies of records on
+  // nodes sharing the donor's location at that scope (trying smaller scopes
+  // first), as long as the replication property can still be satisfied.
+  // NODE or ROOT disable the preference.
+  NodeLocationScope rebuilding_local_recipients_scope;
+
   // Whether we use the internal ReplicatedStateMachine or not for logsconfig
   bool enable_logsconfig_manager;
   // Grace period before populating new LogsConfigTree upon receiving RSM delta
@@ -1269,10 +1528,28 @@ struct Settings : public SettingsBundle {
   // reactivation queue on failure
   std::chrono::milliseconds sequencer_background_activation_retry_interval;
 
+  // If not empty, the server records which logs recently had appends on its
+  // sequencers in this file, and activates their sequencers on startup.
+  // See SequencerPreactivator.
+  std::string sequencer_preactivation_history_path;
+
+  // Logs with appends within this window are recorded for pre-activation.
+  std::chrono::milliseconds sequencer_preactivation_window;
+
+  // Number of sequencers to pre-activate at a time ...
+  size_t sequencer_preactivation_batch_size;
+
+  // ... and the delay between batches.
+  std::chrono::milliseconds sequencer_preactivation_batch_interval;
+
   // TODO (#13478262): After WeightedCopySetSelector proves worthy, remove this
   //   setting, along with LinearCopySetSelector and CrossDomainCopySetSelector.
   bool weighted_copyset_selector;
 
+  // If nonzero, WeightedCopySetSelector picks copysets from a per-thread
+  // table of this many precomputed copysets.
+  size_t copyset_table_size;
+
   NodeLocationScope copyset_locality_min_scope;
 
   // Defaults to false, allows clients to opt-in to traffic shadowing
@@ -1285,6 +1562,14 @@ struct Settings : public SettingsBundle {
   // See .cpp
   std::chrono::milliseconds shadow_client_timeout;
 
+  // If nonzero, shadow appends are batched with a BufferedWriter that flushes
+  // batches after this long. See .cpp
+  std::chrono::milliseconds shadow_batching_time_trigger;
+
+  // Memory budget of each shadow client for payloads that haven't been
+  // appended yet; shadow appends over budget are dropped. 0 for no limit.
+  size_t shadow_buffer_limit_mb;
+
   // Defaults to false, should only be set by traffic shadowing framework
   bool shadow_client;
 
@@ -1317,10 +1602,19 @@ struct Settings : public SettingsBundle {
   //  instead of the default (zookeeper) store. Used by integration testing.
   std::string nodes_configuration_file_store_dir;
 
+  // If set, the client keeps a copy of the last main config it fetched in
+  // this directory, and starts with it instead of waiting for the config
+  // source. The config from the source replaces it once it arrives.
+  std::string config_cache_dir;
+
   // If true, sequencer routing will first try to find a sequencer in the
   // location given by sequencerAffinity before looking elsewhere.
   bool use_sequencer_affinity;
 
+  // (client-only setting) If true, remember which node accepted the last
+  // append for each log and route subsequent appends there directly.
+  bool sequencer_location_cache;
+
   // Client only setting:
 
   // The following settings list logs for which certain operations should be
@@ -1348,6 +1642,11 @@ struct Settings : public SettingsBundle {
   // entries.
   size_t real_time_eviction_threshold_bytes;
 
+  // (server-only setting) Number of most recent batches of released records
+  // each worker keeps per log, shared by all read streams of the log, so that
+  // tailers slightly behind the tail can still be served from memory.
+  size_t real_time_shared_tail_batches;
+
   // Test Options:
 
   // This option should only be used in tests. This is used to linerarly
@@ -1386,6 +1685,12 @@ struct Settings : public SettingsBundle {
   bool rsm_include_read_pointer_in_snapshot;
   SnapshotStoreType rsm_snapshot_store_type;
   bool rsm_snapshot_enable_dual_writes;
+  // Look up the tail of the delta log of replicated state machines while
+  // their snapshot is being fetched.
+  bool rsm_prefetch_delta_log_tail;
+  // Buffer size of the read stream replicated state machines use to read
+  // their delta log.
+  size_t rsm_delta_log_read_buffer_size;
   std::chrono::milliseconds eventlog_snapshotting_period;
   std::chrono::milliseconds logsconfig_snapshotting_period;
 
@@ -1394,8 +1699,28 @@ struct Settings : public SettingsBundle {
 
   folly::Optional<std::chrono::milliseconds> findkey_timeout;
 
+  // findTimeBulk() sends up to this many findTime() lookups for the same
+  // storage node in one FINDKEY_BATCH message. 1 disables batching.
+  size_t findkey_batch_size;
+
+  // trimBulk() sends up to this many trims for the same storage node in one
+  // TRIM_BATCH message. 1 disables batching.
+  size_t trim_batch_size;
+
   folly::Optional<std::chrono::milliseconds> append_timeout;
 
+  // If true, Client::append() calls for the same log that arrive within
+  // append_coalescing_window of each other are sent in one APPEND, formatted
+  // like a BufferedWriter batch. Callbacks are still called for each record.
+  bool append_coalescing;
+
+  // How long a coalesced append may wait for more appends to the same log.
+  std::chrono::microseconds append_coalescing_window;
+
+  // Only payloads smaller than this are coalesced, and a batch is sent as
+  // soon as it reaches this size.
+  size_t append_coalescing_max_batch_bytes;
+
   folly::Optional<std::chrono::milliseconds> logsconfig_timeout;
 
   folly::Optional<std::chrono::milliseconds> meta_api_timeout;
@@ -1415,6 +1740,14 @@ struct Settings : public SettingsBundle {
   std::chrono::milliseconds nodeset_adjustment_min_window;
   size_t nodeset_max_randomizations;
 
+  // If true, nodesets are re-selected incrementally when the cluster changes,
+  // keeping as many shards of the current nodeset as possible.
+  bool nodeset_incremental_selection;
+
+  // Limit on the number of background sequencer reactivations that change
+  // the nodeset, across all logs of this sequencer node.
+  rate_limit_t nodeset_changes_limit;
+
   // Use metadata logs in NodeSetFinder if true, otherwise use sequencers
   // (metadata logs v2) and fallback to metadata logs if needed.
   // TODO: set default to false (or remove option) when 2.35 is deployed
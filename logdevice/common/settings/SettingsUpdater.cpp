@@ -376,12 +376,24 @@ void SettingsUpdater::update(setting_checker_t checker) {
   // the new effective value for each setting by applying priority rules across
   // sources. This map holds what are the updates we need to apply for this.
   std::unordered_map<std::string, std::string> new_vals;
+  // Bundles containing at least one of these settings
+  std::unordered_set<std::string> changed_bundles;
 
   for (auto& opt : settings_) {
-    if (fails_check(checker, opt.second)) {
+    const SettingState& state = opt.second;
+    if (fails_check(checker, state)) {
       continue;
     }
-    new_vals[opt.first] = *getValue(opt.first);
+    std::string value = folly::join(" ", computeValue(state));
+    if (!unpublished_bundles_.count(state.bundle_name)) {
+      auto current = state.sources.find(static_cast<int>(Source::CURRENT));
+      if (current != state.sources.end() &&
+          folly::join(" ", current->second) == value) {
+        continue;
+      }
+    }
+    new_vals[opt.first] = std::move(value);
+    changed_bundles.insert(state.bundle_name);
   }
 
   try {
@@ -393,9 +405,13 @@ void SettingsUpdater::update(setting_checker_t checker) {
     ld_check(false);
   }
 
-  // Tell each bundle to update their FastUpdateableSharedPtr.
+  // Tell each changed bundle to update their FastUpdateableSharedPtr.
   for (const auto& bundle : bundles_) {
-    bundle->update();
+    const std::string name = bundle->getName();
+    if (changed_bundles.count(name)) {
+      bundle->update();
+      unpublished_bundles_.erase(name);
+    }
   }
 }
 
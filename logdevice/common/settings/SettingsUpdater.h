@@ -11,6 +11,7 @@
 #include <deque>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/program_options.hpp>
@@ -44,7 +45,8 @@ class SettingsUpdater {
   SettingsUpdater() {}
   SettingsUpdater(SettingsUpdater&& other) noexcept
       : bundles_(std::move(other.bundles_)),
-        settings_(std::move(other.settings_)) {}
+        settings_(std::move(other.settings_)),
+        unpublished_bundles_(std::move(other.unpublished_bundles_)) {}
 
   // CURRENT is a pseudo-source. It's a cache of the effective value aggregated
   // from the other sources according to precedence rules.
@@ -111,6 +113,7 @@ class SettingsUpdater {
   void registerSettings(UpdateableSettings<T> bundle) {
     auto raw = std::static_pointer_cast<UpdateableSettingsBase>(bundle.raw());
     bundles_.push_back(raw);
+    unpublished_bundles_.insert(raw->getName());
     for (const auto& i : raw->getSettings()) {
       SettingState setting;
       setting.bundle_name = raw->getName();
@@ -283,6 +286,10 @@ class SettingsUpdater {
 
   std::vector<std::shared_ptr<UpdateableSettingsBase>> bundles_;
   std::unordered_map<std::string, SettingState> settings_;
+  // Names of the bundles that update() hasn't published yet. All their
+  // settings are applied on the next update(); for the other bundles only the
+  // settings whose effective value changed are.
+  std::unordered_set<std::string> unpublished_bundles_;
 
   // Used to protect concurrent accesses for writes on settings from admin
   // commnd thread, config update thread, client main thread, etc.
@@ -374,7 +381,9 @@ class SettingsUpdater {
    * Must be called after one or more calls to parse() that changed the settings
    * from different sources. Reconciles the current value for each setting
    * considering the order of precedence between sources, then update each
-   * Bundle to make the changes available to readers of settings.
+   * Bundle in which a setting changed to make the changes available to readers
+   * of settings. Bundles in which nothing changed are not republished, so
+   * their readers and subscribers don't see an update.
    *
    * @param checker Checker function that checks whether a given option could
    *                have changed.
@@ -996,4 +996,262 @@ CompactNoUnitHistogram::CompactNoUnitHistogram()
                                        {1000000000000l, "T"}};
         return &units;
       }()) {}
+
+static double sketchGamma() {
+  return (1 + SketchHistogram::kRelativeAccuracy) /
+      (1 - SketchHistogram::kRelativeAccuracy);
+}
+
+SketchHistogram::SketchHistogram(const HistogramInterface* formatter)
+    : formatter_(formatter) {}
+
+SketchHistogram::SketchHistogram(const SketchHistogram& rhs)
+    : formatter_(rhs.formatter_), state_(rhs.copyState()) {}
+
+SketchHistogram& SketchHistogram::operator=(const SketchHistogram& rhs) {
+  assign(rhs);
+  return *this;
+}
+
+int32_t SketchHistogram::valueToIndex(int64_t value) {
+  ld_check(value > 0);
+  static const double log_gamma = std::log(sketchGamma());
+  return static_cast<int32_t>(
+      std::ceil(std::log(static_cast<double>(value)) / log_gamma));
+}
+
+int64_t SketchHistogram::indexToValue(int32_t index) {
+  const double gamma = sketchGamma();
+  // Within kRelativeAccuracy of both gamma^(index-1) and gamma^index.
+  const double value = 2 * std::pow(gamma, index) / (gamma + 1);
+  if (value >= static_cast<double>(std::numeric_limits<int64_t>::max())) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  return std::max<int64_t>(1, std::llround(value));
+}
+
+void SketchHistogram::collapse(std::vector<Bucket>& buckets) {
+  if (buckets.size() <= kMaxBuckets) {
+    return;
+  }
+  const size_t excess = buckets.size() - kMaxBuckets;
+  for (size_t i = 0; i < excess; ++i) {
+    buckets[excess].second += buckets[i].second;
+  }
+  buckets.erase(buckets.begin(), buckets.begin() + excess);
+}
+
+SketchHistogram::State SketchHistogram::copyState() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return state_;
+}
+
+void SketchHistogram::add(int64_t value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++state_.count;
+  state_.sum += value;
+  if (value <= 0) {
+    ++state_.zero_count;
+    return;
+  }
+  const int32_t index = valueToIndex(value);
+  auto& buckets = state_.buckets;
+  auto it = std::lower_bound(buckets.begin(), buckets.end(), Bucket(index, 0));
+  if (it != buckets.end() && it->first == index) {
+    ++it->second;
+    return;
+  }
+  buckets.insert(it, Bucket(index, 1));
+  collapse(buckets);
+}
+
+void SketchHistogram::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  state_ = State();
+}
+
+void SketchHistogram::assign(const HistogramInterface& other_if) {
+  auto& other = checked_cref_cast<SketchHistogram>(other_if);
+  ld_check(formatter_ == other.formatter_);
+
+  State state = other.copyState();
+  std::lock_guard<std::mutex> lock(mutex_);
+  state_ = std::move(state);
+}
+
+void SketchHistogram::merge(const HistogramInterface& other_if) {
+  auto& other = checked_cref_cast<SketchHistogram>(other_if);
+  ld_check(formatter_ == other.formatter_);
+
+  State state = other.copyState();
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& a = state_.buckets;
+  const auto& b = state.buckets;
+  std::vector<Bucket> merged;
+  merged.reserve(a.size() + b.size());
+  size_t i = 0, j = 0;
+  while (i < a.size() || j < b.size()) {
+    if (j == b.size() || (i < a.size() && a[i].first < b[j].first)) {
+      merged.push_back(a[i++]);
+    } else if (i == a.size() || b[j].first < a[i].first) {
+      merged.push_back(b[j++]);
+    } else {
+      merged.emplace_back(a[i].first, a[i].second + b[j].second);
+      ++i;
+      ++j;
+    }
+  }
+  collapse(merged);
+  state_.buckets = std::move(merged);
+  state_.zero_count += state.zero_count;
+  state_.count += state.count;
+  state_.sum += state.sum;
+}
+
+void SketchHistogram::subtract(const HistogramInterface& other_if) {
+  auto& other = checked_cref_cast<SketchHistogram>(other_if);
+  ld_check(formatter_ == other.formatter_);
+
+  State state = other.copyState();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& buckets = state_.buckets;
+  for (const Bucket& b : state.buckets) {
+    auto it =
+        std::lower_bound(buckets.begin(), buckets.end(), Bucket(b.first, 0));
+    if (it == buckets.end() || it->first != b.first) {
+      // Buckets below the lowest one may have been collapsed into it.
+      if (buckets.empty() || b.first > buckets.front().first) {
+        dd_assert(false,
+                  "Histogram subtraction of a nonexistent bucket %d",
+                  b.first);
+        continue;
+      }
+      it = buckets.begin();
+    }
+    if (!dd_assert(b.second <= it->second,
+                   "Histogram subtraction overflowed. Bucket %d",
+                   b.first)) {
+      it->second = 0;
+    } else {
+      it->second -= b.second;
+    }
+  }
+  buckets.erase(std::remove_if(buckets.begin(),
+                               buckets.end(),
+                               [](const Bucket& b) { return b.second == 0; }),
+                buckets.end());
+  state_.zero_count -= std::min(state_.zero_count, state.zero_count);
+  state_.count -= std::min(state_.count, state.count);
+  state_.sum -= state.sum;
+}
+
+void SketchHistogram::estimatePercentiles(const double* percentiles,
+                                          size_t npercentiles,
+                                          int64_t* samples_out,
+                                          uint64_t* count_out,
+                                          int64_t* sum_out) const {
+  const State state = copyState();
+  uint64_t count = state.zero_count;
+  for (const Bucket& b : state.buckets) {
+    count += b.second;
+  }
+  if (count_out) {
+    *count_out = count;
+  }
+  if (sum_out) {
+    *sum_out = state.sum;
+  }
+
+  if (npercentiles == 0) {
+    return;
+  }
+
+  ld_check(samples_out != nullptr);
+  ld_check(std::is_sorted(percentiles, percentiles + npercentiles));
+  ld_check(std::all_of(percentiles, percentiles + npercentiles, [](double p) {
+    return p >= 0.0 && p <= 1.0;
+  }));
+
+  if (count == 0) {
+    std::fill(samples_out, samples_out + npercentiles, 0l);
+    return;
+  }
+
+  size_t idx = 0; // index in percentiles
+  // Assigns `value` to the percentiles that fall below `next` values.
+  auto visit = [&](uint64_t next, int64_t value) {
+    while (idx < npercentiles &&
+           (percentiles[idx] * count <= next || next == count)) {
+      samples_out[idx++] = value;
+    }
+  };
+  uint64_t seen = state.zero_count;
+  if (seen > 0) {
+    visit(seen, 0);
+  }
+  for (const Bucket& b : state.buckets) {
+    seen += b.second;
+    visit(seen, indexToValue(b.first));
+  }
+
+  ld_check(idx == npercentiles);
+}
+
+void SketchHistogram::print(std::ostream& out) const {
+  std::array<double, 4> pct = {.5, .75, .95, .99};
+
+  const State state = copyState();
+  uint64_t count = state.zero_count;
+  for (const Bucket& b : state.buckets) {
+    count += b.second;
+  }
+
+  size_t idx = 0;    // in `pct`
+  uint64_t seen = 0; // count in buckets seen so far
+  auto print_bucket = [&](const std::string& label, uint64_t x) {
+    if (x == 0) {
+      return;
+    }
+    uint64_t next = seen + x;
+    std::string pct_str;
+    while (idx < pct.size() && (pct[idx] * count <= next || next == count)) {
+      pct_str += folly::sformat(" p{}", static_cast<int>(pct[idx] * 100 + .5));
+      ++idx;
+    }
+    out << std::setw(20) << std::right << label << std::setw(1) << " : "
+        << std::setw(10) << std::left << x << std::setw(1) << pct_str
+        << std::endl;
+    seen = next;
+  };
+
+  print_bucket("<= " + valueToString(0), state.zero_count);
+  const double gamma = sketchGamma();
+  for (const Bucket& b : state.buckets) {
+    // The lowest bucket may contain collapsed lower buckets.
+    const int64_t min = &b == &state.buckets.front()
+        ? 0
+        : std::llround(std::pow(gamma, b.first - 1));
+    const int64_t max = std::llround(std::pow(gamma, b.first));
+    print_bucket(valueToString(min) + ".." + valueToString(max), b.second);
+  }
+}
+
+std::string SketchHistogram::getUnitName() const {
+  return formatter_->getUnitName();
+}
+
+std::string SketchHistogram::valueToString(int64_t value) const {
+  return formatter_->valueToString(value);
+}
+
+size_t SketchHistogram::numBuckets() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return state_.buckets.size();
+}
+
+SketchLatencyHistogram::SketchLatencyHistogram()
+    : SketchHistogram([] {
+        static CompactLatencyHistogram formatter;
+        return &formatter;
+      }()) {}
 }} // namespace facebook::logdevice
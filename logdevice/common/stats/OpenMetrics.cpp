@@ -0,0 +1,274 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/OpenMetrics.h"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/container/F14Map.h>
+
+#include "logdevice/common/PriorityMap.h"
+#include "logdevice/common/RequestType.h"
+#include "logdevice/common/StorageTask-enums.h"
+#include "logdevice/common/configuration/NodeLocation.h"
+#include "logdevice/common/configuration/TrafficClass.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/stats/Histogram.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Quantiles of histograms to export.
+constexpr std::array<double, 5> kQuantiles = {.5, .75, .95, .99, .999};
+
+std::string label(folly::StringPiece name, folly::StringPiece value) {
+  std::string res;
+  res.reserve(name.size() + value.size() + 3);
+  res.append(name.data(), name.size());
+  res += "=\"";
+  for (char c : value) {
+    switch (c) {
+      case '\\':
+        res += "\\\\";
+        break;
+      case '"':
+        res += "\\\"";
+        break;
+      case '\n':
+        res += "\\n";
+        break;
+      default:
+        res += c;
+    }
+  }
+  res += '"';
+  return res;
+}
+
+class Callbacks : public Stats::EnumerationCallbacks {
+ public:
+  Callbacks(folly::StringPiece prefix, bool include_log_groups)
+      : prefix_(prefix), includeLogGroups_(include_log_groups) {}
+
+  // Simple stats.
+  void stat(const std::string& name, int64_t val) override {
+    sample(name, "", val);
+  }
+  // Per-message-type stats.
+  void stat(const std::string& name, MessageType msg, int64_t val) override {
+    sample(name, label("msg_type", messageTypeNames()[msg]), val);
+  }
+  // Per-shard stats.
+  void stat(const std::string& name,
+            shard_index_t shard,
+            int64_t val) override {
+    sample(name, label("shard", folly::to<std::string>(shard)), val);
+  }
+  // Per-traffic-class stats.
+  void stat(const std::string& name, TrafficClass tc, int64_t val) override {
+    sample(name, label("traffic_class", trafficClasses()[tc]), val);
+  }
+  // Per-flow-group stats.
+  void stat(const std::string& name,
+            NodeLocationScope flow_group,
+            int64_t val) override {
+    sample(name, label("scope", NodeLocation::scopeNames()[flow_group]), val);
+  }
+  // Per-flow-group-and-msg-priority stats.
+  void stat(const std::string& name,
+            NodeLocationScope flow_group,
+            Priority pri,
+            int64_t val) override {
+    sample(name,
+           label("scope", NodeLocation::scopeNames()[flow_group]) + "," +
+               label("priority", PriorityMap::toName()[pri]),
+           val);
+  }
+  // Per-monitoring-tier stats.
+  void stat(const std::string& name,
+            MonitoringTier monitoring_tier,
+            int64_t val) override {
+    sample(name, label("monitoring_tier", toString(monitoring_tier)), val);
+  }
+  // Per-msg-priority stats.
+  void stat(const std::string& name, Priority pri, int64_t val) override {
+    sample(name, label("priority", PriorityMap::toName()[pri]), val);
+  }
+  // Per-request-type stats.
+  void stat(const std::string& name, RequestType rq, int64_t val) override {
+    sample(name, label("request_type", requestTypeNames[rq]), val);
+  }
+  // Per-storage-task-type stats.
+  void stat(const std::string& name,
+            StorageTaskType type,
+            int64_t val) override {
+    sample(name, label("storage_task_type", storageTaskTypeNames[type]), val);
+  }
+  // Per-worker stats.
+  void stat(const std::string& name,
+            worker_id_t worker_id,
+            uint64_t load) override {
+    sample(
+        name, label("worker", folly::to<std::string>(worker_id.val())), load);
+  }
+  // Per-log stats.
+  void stat(const char* name,
+            const std::string& log_group,
+            int64_t val) override {
+    if (includeLogGroups_) {
+      sample(name, label("log_group", log_group), val);
+    }
+  }
+  // Simple histograms.
+  void histogram(const std::string& name,
+                 const HistogramInterface& hist) override {
+    summary(name, "", hist);
+  }
+  // Per-shard histograms.
+  void histogram(const std::string& name,
+                 shard_index_t shard,
+                 const HistogramInterface& hist) override {
+    summary(name, label("shard", folly::to<std::string>(shard)), hist);
+  }
+
+  // Per-log histograms, which Stats::enumerate() doesn't list.
+  void perLogHistograms(const Stats& stats) {
+    if (!includeLogGroups_) {
+      return;
+    }
+    for (const auto& kv : stats.synchronizedCopy(&Stats::per_log_stats)) {
+      std::vector<std::pair<const char*, std::shared_ptr<SketchHistogram>>>
+          hists;
+      {
+        std::lock_guard<std::mutex> guard(kv.second->mutex);
+#define HISTOGRAM_DEFINE(name)                  \
+  if (kv.second->name) {                        \
+    hists.emplace_back(#name, kv.second->name); \
+  }
+#include "logdevice/common/stats/per_log_histograms.inc" // nolint
+      }
+      for (const auto& h : hists) {
+        summary(std::string("log_group.") + h.first,
+                label("log_group", kv.first),
+                *h.second);
+      }
+    }
+  }
+
+  void finish(folly::io::Appender& out) {
+    for (const Family& family : families_) {
+      out.printf(
+          "# TYPE %s %s\n", family.metric.c_str(), family.type.c_str());
+      out.push(reinterpret_cast<const uint8_t*>(family.samples.data()),
+               family.samples.size());
+    }
+    out.printf("# EOF\n");
+  }
+
+ private:
+  struct Family {
+    std::string metric;
+    std::string type;
+    // Formatted samples, one per line.
+    std::string samples;
+  };
+
+  Family& family(const std::string& name, const char* type) {
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+      return families_[it->second];
+    }
+    index_.emplace(name, families_.size());
+    std::string metric = prefix_.str();
+    metric.reserve(metric.size() + name.size());
+    for (char c : name) {
+      bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+          (c >= '0' && c <= '9') || c == '_' || c == ':';
+      metric += ok ? c : '_';
+    }
+    families_.push_back(Family{std::move(metric), type, ""});
+    return families_.back();
+  }
+
+  static void appendSample(std::string& out,
+                           const std::string& metric,
+                           const char* suffix,
+                           const std::string& labels,
+                           const std::string& value) {
+    out += metric;
+    out += suffix;
+    if (!labels.empty()) {
+      out += '{';
+      out += labels;
+      out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+  }
+
+  template <typename T>
+  void sample(const std::string& name, const std::string& labels, T val) {
+    Family& f = family(name, "unknown");
+    appendSample(
+        f.samples, f.metric, "", labels, folly::to<std::string>(val));
+  }
+
+  void summary(const std::string& name,
+               const std::string& labels,
+               const HistogramInterface& hist) {
+    std::array<int64_t, kQuantiles.size()> values;
+    uint64_t count;
+    int64_t sum;
+    hist.estimatePercentiles(
+        kQuantiles.data(), kQuantiles.size(), values.data(), &count, &sum);
+
+    Family& f = family(name, "summary");
+    const std::string sep = labels.empty() ? "" : ",";
+    for (size_t i = 0; i < kQuantiles.size(); ++i) {
+      appendSample(f.samples,
+                   f.metric,
+                   "",
+                   labels + sep +
+                       label("quantile", folly::to<std::string>(kQuantiles[i])),
+                   folly::to<std::string>(values[i]));
+    }
+    appendSample(
+        f.samples, f.metric, "_count", labels, folly::to<std::string>(count));
+    appendSample(
+        f.samples, f.metric, "_sum", labels, folly::to<std::string>(sum));
+  }
+
+  const folly::StringPiece prefix_;
+  const bool includeLogGroups_;
+  // Metrics in order of first appearance.
+  std::vector<Family> families_;
+  // Stat name -> index in families_.
+  folly::F14FastMap<std::string, size_t> index_;
+};
+
+} // namespace
+
+void OpenMetricsWriter::write(const Stats& stats,
+                              folly::io::Appender& out,
+                              bool include_log_groups,
+                              folly::StringPiece prefix) {
+  Callbacks cb(prefix, include_log_groups);
+  stats.enumerate(&cb, /* list_all */ true);
+  cb.perLogHistograms(stats);
+  cb.finish(out);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/io/Cursor.h>
+
+namespace facebook { namespace logdevice {
+
+struct Stats;
+
+/**
+ * @file Renders Stats in the OpenMetrics text exposition format, which
+ *       Prometheus also accepts, so that stats can be scraped without parsing
+ *       the output of the "stats" admin command.
+ *
+ *       Each stat becomes a metric named `prefix` + the stat name, with
+ *       characters that aren't allowed in metric names replaced by '_'.
+ *       Per-something stats become labels of that metric (e.g.
+ *       {shard="3"}, {traffic_class="READ_TAIL"}); the totals across all
+ *       values of the label are the unlabeled sample of the same metric.
+ *       Counters and gauges aren't distinguished by Stats, so all of them
+ *       are of type "unknown"; rates are left to the scraper (e.g.
+ *       Prometheus' rate()), which computes them from consecutive scrapes.
+ *       Histograms become summaries with a few quantiles, _count and _sum.
+ *
+ *       Samples of a metric have to be contiguous in the output, while
+ *       Stats::enumerate() interleaves them (e.g. all stats of shard 0, then
+ *       all stats of shard 1). The writer keeps one buffer of formatted
+ *       samples per metric and writes them out in order of first appearance.
+ */
+class OpenMetricsWriter {
+ public:
+  /**
+   * Writes all of `stats`, terminated by "# EOF", to `out`.
+   *
+   * @param include_log_groups  whether to include per-log-group stats and
+   *                            histograms, with a log_group label
+   * @param prefix              prepended to all metric names
+   */
+  static void write(const Stats& stats,
+                    folly::io::Appender& out,
+                    bool include_log_groups,
+                    folly::StringPiece prefix = "logdevice_");
+};
+
+}} // namespace facebook::logdevice
@@ -46,6 +46,7 @@ struct PerShardHistograms : public PerShardHistogramBundle {
         {"flushed_log_run_length", &flushed_log_run_length},
         {"compacted_log_run_length", &compacted_log_run_length},
         {"trimmed_record_age", &trimmed_record_age},
+        {"sync_batch_size", &sync_batch_size},
 
         // Rebuilding related histograms
         {"record_rebuilding", &record_rebuilding},
@@ -72,6 +73,26 @@ struct PerShardHistograms : public PerShardHistogramBundle {
       {"queue_time." class_name,                                         \
        &storage_task_queue_time[static_cast<int>(StorageTaskType::name)]},
 #include "logdevice/common/storage_task_types.inc"
+
+    // Queueing and execution latencies of storage tasks by priority and by
+    // IO principal, to tell whether a class of tasks is waiting behind others
+    // or is slow to execute.
+#define STORAGE_TASK_PRIORITY(name, class_name)                        \
+  {"queue_time.priority." class_name,                                  \
+   &storage_task_queue_time_by_priority[static_cast<int>(              \
+       StorageTaskPriority::name)]},                                   \
+      {"execution_time.priority." class_name,                          \
+       &storage_task_execution_time_by_priority[static_cast<int>(      \
+           StorageTaskPriority::name)]},
+#include "logdevice/common/storage_task_priorities.inc"
+#define STORAGE_TASK_PRINCIPAL(name, class_name, share)                \
+  {"queue_time.principal." #class_name,                                \
+   &storage_task_queue_time_by_principal[static_cast<int>(             \
+       StorageTaskPrincipal::name)]},                                  \
+      {"execution_time.principal." #class_name,                        \
+       &storage_task_execution_time_by_principal[static_cast<int>(     \
+           StorageTaskPrincipal::name)]},
+#include "logdevice/common/storage_task_principals.inc"
     };
   }
 
@@ -113,6 +134,10 @@ struct PerShardHistograms : public PerShardHistogramBundle {
   // The Histogram of trimmed records age, in seconds
   record_age_histogram_t trimmed_record_age;
 
+  // Number of SYNC_WRITE storage tasks acknowledged by each sync issued by
+  // SyncingStorageThread.
+  compact_no_unit_histogram_t sync_batch_size;
+
   // Latency of RecordRebuilding state machine.
   compact_latency_histogram_t record_rebuilding;
 
@@ -125,6 +150,16 @@ struct PerShardHistograms : public PerShardHistogramBundle {
   // Queueing latencies for storage threads (by storage thread type)
   compact_latency_histogram_t storage_threads_queue_time[static_cast<size_t>(
       StorageTaskThreadType::MAX)];
+  // Queueing and execution latencies for storage tasks by task priority
+  compact_latency_histogram_t storage_task_queue_time_by_priority
+      [static_cast<size_t>(StorageTaskPriority::NUM_PRIORITIES)];
+  compact_latency_histogram_t storage_task_execution_time_by_priority
+      [static_cast<size_t>(StorageTaskPriority::NUM_PRIORITIES)];
+  // Queueing and execution latencies for storage tasks by IO principal
+  compact_latency_histogram_t storage_task_queue_time_by_principal
+      [static_cast<size_t>(StorageTaskPrincipal::NUM_PRINCIPALS)];
+  compact_latency_histogram_t storage_task_execution_time_by_principal
+      [static_cast<size_t>(StorageTaskPrincipal::NUM_PRINCIPALS)];
 };
 
 }} // namespace facebook::logdevice
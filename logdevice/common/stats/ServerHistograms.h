@@ -8,9 +8,11 @@
 #pragma once
 
 #include <array>
+#include <string>
 
 #include "logdevice/common/RequestType.h"
 #include "logdevice/common/StorageTask-enums.h"
+#include "logdevice/common/WorkerType.h"
 #include "logdevice/common/protocol/MessageType.h"
 #include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/stats/HistogramBundle.h"
@@ -22,8 +24,15 @@ namespace facebook { namespace logdevice {
  */
 struct ServerHistograms : public HistogramBundle {
   HistogramBundle::MapType getMap() override {
-    return {
+    HistogramBundle::MapType map = {
         {"append_latency", &append_latency},
+        {"append_stage_prep_latency", &append_stage_prep},
+        {"append_stage_window_latency", &append_stage_window},
+        {"append_stage_copyset_latency", &append_stage_copyset},
+        {"append_stage_store_send_latency", &append_stage_store_send},
+        {"append_stage_stored_latency", &append_stage_stored},
+        {"append_stage_release_latency", &append_stage_release},
+        {"append_stage_reply_latency", &append_stage_reply},
         {"store_bw_wait_latency", &store_bw_wait_latency},
         {"write_to_read_latency", &write_to_read_latency},
         {"store_timeouts", &store_timeouts},
@@ -67,10 +76,36 @@ struct ServerHistograms : public HistogramBundle {
    &storage_task_response_duration[int(StorageTaskType::type)]},
 #include "logdevice/common/storage_task_types.inc" // nolint
     };
+    const char* priorities[] = {"hi_pri", "mid_pri", "lo_pri"};
+    for (int type = 0; type < numOfWorkerTypes(); ++type) {
+      for (size_t pri = 0; pri < worker_queue_latency[type].size(); ++pri) {
+        map[std::string("worker_queue_latency.") +
+            workerTypeStr(workerTypeByIndex(type)) + "." + priorities[pri]] =
+            &worker_queue_latency[type][pri];
+      }
+    }
+    return map;
   }
   // Latency of appends as seen by the sequencer
   LatencyHistogram append_latency;
 
+  // Breakdown of append latency by stage of the write path on the sequencer
+  // (see AppendStageLatencies):
+  // APPEND received to Appender created (AppenderPrep checks).
+  CompactLatencyHistogram append_stage_prep;
+  // Appender created to LSN assigned by the sliding window.
+  CompactLatencyHistogram append_stage_window;
+  // LSN assigned to first copyset selected.
+  CompactLatencyHistogram append_stage_copyset;
+  // First copyset selected to first wave of STOREs sent.
+  CompactLatencyHistogram append_stage_store_send;
+  // STORE wave sent to each successful STORED of that wave received.
+  LatencyHistogram append_stage_stored;
+  // Fully replicated to RELEASE sent (waiting for preceding records).
+  CompactLatencyHistogram append_stage_release;
+  // Fully replicated to APPENDED sent.
+  CompactLatencyHistogram append_stage_reply;
+
   LatencyHistogram write_to_read_latency;
 
   LatencyHistogram store_bw_wait_latency;
@@ -86,6 +121,11 @@ struct ServerHistograms : public HistogramBundle {
 
   LatencyHistogram lo_pri_requests_latency;
 
+  // Same as the three above, by type of worker. Indexed by
+  // workerIndexByType() and EventLoopTaskQueue::translatePriority().
+  std::array<std::array<CompactLatencyHistogram, 3>, numOfWorkerTypes()>
+      worker_queue_latency;
+
   // How long the gossip requests stay in the pipe
   LatencyHistogram gossip_queue_latency;
 
@@ -109,11 +109,64 @@ static folly::BucketedTimeSeries<T, V> newTimeSeriesWithUpdatedRetentionTime(
   return time_series_new;
 }
 
+size_t PerLogStats::slotFor(const std::string& log_group) {
+  // Leaked so that threads exiting after static destruction can still use it.
+  static auto* slots =
+      new folly::Synchronized<std::unordered_map<std::string, size_t>>();
+  {
+    auto rlock = slots->rlock();
+    auto it = rlock->find(log_group);
+    if (it != rlock->end()) {
+      return it->second;
+    }
+  }
+  auto wlock = slots->wlock();
+  const size_t next_slot = wlock->size();
+  return wlock->emplace(log_group, next_slot).first->second;
+}
+
 void PerLogStats::aggregate(PerLogStats const& other,
                             StatsAggOptional agg_override) {
 #define STAT_DEFINE(name, agg) \
   aggregateStat(StatsAgg::agg, agg_override, name, other.name);
 #include "logdevice/common/stats/per_log_stats.inc" // nolint
+
+  // The histograms of `other` may be allocated concurrently by the thread
+  // owning it, so grab the pointers under its mutex, then merge outside of it.
+  // The histograms themselves are thread-safe.
+  std::vector<std::pair<std::shared_ptr<SketchHistogram> PerLogStats::*,
+                        std::shared_ptr<SketchHistogram>>>
+      other_histograms;
+  {
+    std::lock_guard<std::mutex> guard(other.mutex);
+#define HISTOGRAM_DEFINE(name)                                     \
+  if (other.name) {                                                \
+    other_histograms.emplace_back(&PerLogStats::name, other.name); \
+  }
+#include "logdevice/common/stats/per_log_histograms.inc" // nolint
+  }
+  if (other_histograms.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto& h : other_histograms) {
+    auto& histogram = this->*h.first;
+    if (!histogram) {
+      histogram = std::make_shared<SketchLatencyHistogram>();
+    }
+    aggregateHistogram(agg_override, *histogram, *h.second);
+  }
+}
+
+void PerLogStats::addToHistogram(
+    std::shared_ptr<SketchHistogram> PerLogStats::*histogram,
+    int64_t value) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& h = this->*histogram;
+  if (UNLIKELY(!h)) {
+    h = std::make_shared<SketchLatencyHistogram>();
+  }
+  h->add(value);
 }
 
 void PerTrafficClassStats::aggregate(PerTrafficClassStats const& other,
@@ -301,7 +354,9 @@ Stats::Stats(Stats&& other) noexcept(true) = default;
 
 Stats& Stats::operator=(Stats&& other) noexcept(false) = default;
 
-void Stats::aggregate(Stats const& other, StatsAggOptional agg_override) {
+void Stats::aggregate(Stats const& other,
+                      StatsAggOptional agg_override,
+                      bool include_per_log_stats) {
   switch (params->get()->stats_set) {
     case StatsParams::StatsSet::DEFAULT:
       if (params->get()->is_server) {
@@ -351,7 +406,7 @@ void Stats::aggregate(Stats const& other, StatsAggOptional agg_override) {
       break;
   } // let compiler check that all enum values are handled.
 
-  aggregateCompoundStats(other, agg_override);
+  aggregateCompoundStats(other, agg_override, false, include_per_log_stats);
 }
 
 void Stats::aggregateForDestroyedThread(Stats const& other) {
@@ -398,7 +453,8 @@ void Stats::aggregateForDestroyedThread(Stats const& other) {
 
 void Stats::aggregateCompoundStats(Stats const& other,
                                    StatsAggOptional agg_override,
-                                   bool destroyed_threads) {
+                                   bool destroyed_threads,
+                                   bool include_per_log_stats) {
   if (params->get()->stats_set != StatsParams::StatsSet::DEFAULT) {
     switch (params->get()->stats_set) {
       case StatsParams::StatsSet::LDBENCH_WORKER:
@@ -453,19 +509,21 @@ void Stats::aggregateCompoundStats(Stats const& other,
   // Aggregate per log stats. Use synchronizedCopy() to copy other's
   // per_log_stats into temporary vector, to avoid holding a read lock on it
   // while we aggregate.
-  this->per_log_stats.withWLock(
-      [&agg_override,
-       other_per_log_stats_entries = other.synchronizedCopy(
-           &Stats::per_log_stats)](auto& this_per_log_stats) {
-        for (const auto& kv : other_per_log_stats_entries) {
-          ld_check(kv.second != nullptr);
-          auto& stats_ptr = this_per_log_stats[kv.first];
-          if (stats_ptr == nullptr) {
-            stats_ptr = std::make_shared<PerLogStats>();
+  if (include_per_log_stats) {
+    this->per_log_stats.withWLock(
+        [&agg_override,
+         other_per_log_stats_entries = other.synchronizedCopy(
+             &Stats::per_log_stats)](auto& this_per_log_stats) {
+          for (const auto& kv : other_per_log_stats_entries) {
+            ld_check(kv.second != nullptr);
+            auto& stats_ptr = this_per_log_stats[kv.first];
+            if (stats_ptr == nullptr) {
+              stats_ptr = std::make_shared<PerLogStats>(kv.second->slot);
+            }
+            stats_ptr->aggregate(*kv.second, agg_override);
           }
-          stats_ptr->aggregate(*kv.second, agg_override);
-        }
-      });
+        });
+  }
 
   // Aggregate per worker stats. Also use synchronizedCopy()
   this->per_worker_stats.withWLock(
@@ -939,13 +997,39 @@ StatsHolder::StatsHolder(StatsParams params)
 Stats StatsHolder::aggregate() const {
   Stats result(&params_);
 
+  // Per-log stats are merged by PerLogStats::slot rather than through
+  // Stats::aggregate(), so that each log group name is hashed and copied once
+  // per call instead of once per thread. Threads' maps are only read-locked,
+  // which doesn't block their owners from updating existing entries.
+  std::unordered_map<std::string, std::shared_ptr<PerLogStats>> per_log;
+  std::vector<PerLogStats*> per_log_by_slot;
+  auto merge_per_log = [&](const Stats& stats) {
+    auto locked = stats.per_log_stats.rlock();
+    for (const auto& kv : *locked) {
+      ld_check(kv.second != nullptr);
+      const size_t slot = kv.second->slot;
+      if (slot >= per_log_by_slot.size()) {
+        per_log_by_slot.resize(slot + 1, nullptr);
+      }
+      if (per_log_by_slot[slot] == nullptr) {
+        auto stats_ptr = std::make_shared<PerLogStats>(slot);
+        per_log_by_slot[slot] = stats_ptr.get();
+        per_log.emplace(kv.first, std::move(stats_ptr));
+      }
+      per_log_by_slot[slot]->aggregate(*kv.second, folly::none);
+    }
+  };
+
   {
     auto accessor = thread_stats_.accessAllThreads();
-    result.aggregate(dead_stats_);
+    result.aggregate(dead_stats_, folly::none, false);
+    merge_per_log(dead_stats_);
     for (const auto& x : accessor) {
-      result.aggregate(x.stats);
+      result.aggregate(x.stats, folly::none, false);
+      merge_per_log(x.stats);
     }
   }
+  *result.per_log_stats.wlock() = std::move(per_log);
 
   result.deriveStats();
 
@@ -57,6 +57,7 @@ namespace facebook { namespace logdevice {
 
 class LatencyHistogram;
 class HistogramInterface;
+class SketchHistogram;
 struct ClientHistograms;
 struct PerShardHistograms;
 struct ServerHistograms;
@@ -133,6 +134,19 @@ struct CustomCountersTimeSeries {
  * group.
  */
 struct PerLogStats {
+  /**
+   * @param slot  dense index of the log group, see slotFor()
+   */
+  explicit PerLogStats(size_t slot) : slot(slot) {}
+
+  /**
+   * Returns the dense index of the log group with the given name. Indices are
+   * process-wide, assigned on first use and never reused. They let
+   * StatsHolder::aggregate() merge the PerLogStats of all threads by index
+   * instead of looking up every log group name in a map once per thread.
+   */
+  static size_t slotFor(const std::string& log_group);
+
   /**
    * Add or subtract most values from @param other.
    */
@@ -146,9 +160,24 @@ struct PerLogStats {
 #include "logdevice/common/stats/per_log_time_series.inc" // nolint
 
   std::shared_ptr<CustomCountersTimeSeries> custom_counters;
+
+  // Per-log-group histograms, null until the first value is added. Protected
+  // by `mutex`.
+#define HISTOGRAM_DEFINE(name) std::shared_ptr<SketchHistogram> name;
+#include "logdevice/common/stats/per_log_histograms.inc" // nolint
+
+  /**
+   * Adds a value to one of the histograms above, allocating it if needed.
+   * Locks `mutex`.
+   */
+  void addToHistogram(std::shared_ptr<SketchHistogram> PerLogStats::*histogram,
+                      int64_t value);
+
+  // Dense index of the log group, as returned by slotFor()
+  const size_t slot;
   // Mutex almost exclusively locked by one thread since PerLogStats objects
   // are contained in thread-local stats
-  std::mutex mutex;
+  mutable std::mutex mutex;
 };
 
 struct PerTrafficClassStats {
@@ -554,9 +583,14 @@ struct Stats final {
 
   /**
    * Add all values from @param other.
+   *
+   * @param include_per_log_stats  if false, per_log_stats is left untouched;
+   *                               used by StatsHolder::aggregate(), which
+   *                               merges them separately
    */
   void aggregate(Stats const& other,
-                 StatsAggOptional agg_override = folly::none);
+                 StatsAggOptional agg_override = folly::none,
+                 bool include_per_log_stats = true);
 
   /**
    * Same but with DESTROYING_THREAD defined, i.e. exclude stats which
@@ -570,7 +604,8 @@ struct Stats final {
    */
   void aggregateCompoundStats(Stats const& other,
                               StatsAggOptional agg_override,
-                              bool destroyed_threads = false);
+                              bool destroyed_threads = false,
+                              bool include_per_log_stats = true);
 
   /**
    * Reset all counters to their initial values.
@@ -1077,7 +1112,8 @@ class PerShardStatToken {
         /* PerLogStats for log_name do not exist yet (rare case). */     \
         /* Upgrade ulock to wlock and emplace new PerLogStats. */        \
         /* No risk of deadlock because we are the only writer thread. */ \
-        auto stats_ptr = std::make_shared<PerLogStats>();                \
+        auto stats_ptr = std::make_shared<PerLogStats>(                  \
+            PerLogStats::slotFor((log_name)));                           \
         stats_ptr->name += (val);                                        \
         stats_ulock.moveFromUpgradeToWrite()->emplace_hint(              \
             stats_it, (log_name), std::move(stats_ptr));                 \
@@ -1100,7 +1136,8 @@ class PerShardStatToken {
         /* PerLogStats for log_name do not exist yet (rare case). */           \
         /* Upgrade ulock to wlock and emplace new PerLogStats. */              \
         /* No risk of deadlock because we are the only writer thread. */       \
-        auto stats_ptr = std::make_shared<PerLogStats>();                      \
+        auto stats_ptr = std::make_shared<PerLogStats>(                        \
+            PerLogStats::slotFor((log_name)));                                 \
         auto stats_wlock = stats_ulock.moveFromUpgradeToWrite();               \
         stats_it =                                                             \
             stats_wlock->emplace((log_name), std::move(stats_ptr)).first;      \
@@ -1133,7 +1170,8 @@ class PerShardStatToken {
         /* PerLogStats for log_name do not exist yet (rare case). */           \
         /* Upgrade ulock to wlock and emplace new PerLogStats. */              \
         /* No risk of deadlock because we are the only writer thread. */       \
-        auto stats_ptr = std::make_shared<PerLogStats>();                      \
+        auto stats_ptr = std::make_shared<PerLogStats>(                        \
+            PerLogStats::slotFor((log_name)));                                 \
         auto stats_wlock = stats_ulock.moveFromUpgradeToWrite();               \
         stats_it =                                                             \
             stats_wlock->emplace((log_name), std::move(stats_ptr)).first;      \
@@ -1150,6 +1188,32 @@ class PerShardStatToken {
     }                                                                          \
   } while (0)
 
+#define LOG_GROUP_HISTOGRAM_ADD(stats_struct, stat_name, log_name, val)        \
+  do {                                                                         \
+    if (stats_struct) {                                                        \
+      auto stats_ulock = (stats_struct)->get().per_log_stats.ulock();          \
+      /* Unfortunately, the type of the lock after a downgrade from write to   \
+       * upgrade isn't the same as the type of upgrade lock initially acquired \
+       */                                                                      \
+      folly::LockedPtr<decltype(stats_ulock)::Synchronized,                    \
+                       folly::LockPolicyFromExclusiveToUpgrade>                \
+          stats_downgraded_ulock;                                              \
+      auto stats_it = stats_ulock->find((log_name));                           \
+      if (UNLIKELY(stats_it == stats_ulock->end())) {                          \
+        /* PerLogStats for log_name do not exist yet (rare case). */           \
+        /* Upgrade ulock to wlock and emplace new PerLogStats. */              \
+        /* No risk of deadlock because we are the only writer thread. */       \
+        auto stats_ptr = std::make_shared<PerLogStats>(                        \
+            PerLogStats::slotFor((log_name)));                                 \
+        auto stats_wlock = stats_ulock.moveFromUpgradeToWrite();               \
+        stats_it =                                                             \
+            stats_wlock->emplace((log_name), std::move(stats_ptr)).first;      \
+        stats_downgraded_ulock = stats_wlock.moveFromWriteToUpgrade();         \
+      }                                                                        \
+      stats_it->second->addToHistogram(&PerLogStats::stat_name, (val));        \
+    }                                                                          \
+  } while (0)
+
 #define TRAFFIC_CLASS_STAT_ADD(stats_struct, traffic_class, name, val) \
   do {                                                                 \
     if (stats_struct) {                                                \
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AdminCommandTable.h"
+
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+using admin_command_table::LSN;
+using TestTable = AdminCommandTable<logid_t, LSN, std::string>;
+
+TestTable makeTable() {
+  return TestTable(true, "Log", "LSN", "Name");
+}
+
+} // namespace
+
+TEST(AdminCommandTableTest, Print) {
+  TestTable table = makeTable();
+  table.next().set<0>(logid_t(1)).set<1>(LSN_MAX).set<2>("a");
+  table.next().set<0>(logid_t(22)).set<2>(
+      "b", [](std::string s, bool) { return s + s; });
+
+  EXPECT_EQ("Log  LSN      Name  \r\n"
+            "--------------------\r\n"
+            "1    LSN_MAX  a     \r\n"
+            "22            bb    \r\n",
+            table.toString());
+}
+
+// Values are converted when the table is printed, so tables filled on
+// different threads can be merged first.
+TEST(AdminCommandTableTest, MergeAndOverwrite) {
+  TestTable table = makeTable();
+  TestTable other = makeTable();
+  table.next().set<0>(logid_t(1)).set<2>("first");
+  // The last value set wins, whether it was converted right away or not.
+  table.set<2>("x", [](std::string s, bool) { return s; }).set<2>("second");
+  other.next().set<0>(logid_t(123456)).set<1>(LSN_MAX - 1);
+  table.mergeWith(std::move(other));
+
+  ASSERT_EQ(2, table.numRows());
+  EXPECT_EQ("Log     LSN        Name    \r\n"
+            "---------------------------\r\n"
+            "1                  second  \r\n"
+            "123456  LSN_MAX-1          \r\n",
+            table.toString());
+  folly::dynamic json = folly::parseJson(table.toString(/*json=*/true));
+  EXPECT_EQ(folly::dynamic::array(folly::dynamic::array("1", nullptr, "second"),
+                                  folly::dynamic::array(
+                                      "123456", "LSN_MAX-1", nullptr)),
+            json["rows"]);
+}
+
+TEST(AdminCommandTableTest, Page) {
+  TestTable table = makeTable();
+  for (int i = 0; i < 5; ++i) {
+    table.next().set<0>(logid_t(i)).set<2>(std::string(5 - i, 'x'));
+  }
+  table.page(2, 2);
+  ASSERT_EQ(2, table.numRows());
+  EXPECT_EQ("Log  LSN  Name  \r\n"
+            "----------------\r\n"
+            "2         xxx   \r\n"
+            "3         xx    \r\n",
+            table.toString());
+
+  table.page(5, 1);
+  EXPECT_EQ(0, table.numRows());
+}
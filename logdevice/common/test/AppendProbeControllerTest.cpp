@@ -81,6 +81,34 @@ TEST(AppendProbeControllerTest, Basic) {
   ASSERT_FALSE(controller.shouldProbe(N2, LOG_ID));
 }
 
+TEST(AppendProbeControllerTest, OverloadHint) {
+  std::chrono::milliseconds t(0);
+  auto time_cb = [&]() { return TestAppendProbeController::TimePoint(t); };
+  TestAppendProbeController controller(std::chrono::seconds(1), time_cb);
+
+  const NodeID N1(1, 1), N2(2, 1);
+  const logid_t LOG_ID(1);
+
+  // t=100ms: append succeeds but the sequencer hints it is overloaded
+  t = std::chrono::milliseconds(100);
+  controller.onAppendReply(N1, LOG_ID, E::OK, /* overloaded */ true);
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID));
+  ASSERT_FALSE(controller.shouldProbe(N2, LOG_ID));
+
+  // Errors are not affected by the hint
+  controller.onAppendReply(N2, LOG_ID, E::ACCESS, /* overloaded */ true);
+  ASSERT_FALSE(controller.shouldProbe(N2, LOG_ID));
+
+  // t=200ms: append succeeds without the hint, recovery starts
+  t = std::chrono::milliseconds(200);
+  controller.onAppendReply(N1, LOG_ID, E::OK);
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID));
+
+  // t=1200ms: recovery interval elapsed, stop probing
+  t = std::chrono::milliseconds(1200);
+  ASSERT_FALSE(controller.shouldProbe(N1, LOG_ID));
+}
+
 // Test that nothing crashes or locks up under stress
 TEST(AppendProbeControllerTest, MultiThreadedStressTest) {
   // dbg::currentLevel = dbg::Level::DEBUG;
@@ -8,8 +8,13 @@
 #include "logdevice/include/BufferedWriter.h"
 
 #include <random>
+#include <thread>
 
+#include <zdict.h>
+
+#include <folly/Format.h>
 #include <folly/Memory.h>
+#include <folly/Varint.h>
 #include <gtest/gtest.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
@@ -18,6 +23,8 @@
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 #include "logdevice/common/buffered_writer/BufferedWriterSingleLog.h"
+#include "logdevice/common/buffered_writer/ZstdDictionary.h"
+#include "logdevice/include/BufferedWriteDecoder.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/settings/Settings.h"
@@ -403,6 +410,50 @@ TEST_F(BufferedWriterTest, ExplicitFlushOneAtATime) {
   this->explicitFlushTest(BufferedWriter::Options::Mode::ONE_AT_A_TIME, 0);
 }
 
+// Appends from many threads are staged for the workers.  Each thread's
+// appends to a log must still arrive in order.
+TEST_F(BufferedWriterTest, ConcurrentAppendsStaged) {
+  TestCallback cb;
+  auto writer = this->createWriter(&cb);
+  const int NTHREADS = 8;
+  const int NAPPENDS = 1000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NTHREADS; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < NAPPENDS; ++i) {
+        // Two threads per log.
+        int rv = writer->append(logid_t(t / 2 + 1),
+                                folly::sformat("{}-{}", t, i),
+                                NULL_CONTEXT);
+        ASSERT_EQ(0, rv);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  writer->flushAll();
+
+  wait_until("BufferedWriter has flushed everything", [&]() {
+    return cb.getNumSucceeded() == size_t(NTHREADS * NAPPENDS);
+  });
+  for (int log = 1; log <= NTHREADS / 2; ++log) {
+    std::vector<int> next(NTHREADS, 0);
+    for (const std::string& payload :
+         sink_->getFlushedOriginalPayloads(logid_t(log))) {
+      int t, i;
+      ASSERT_EQ(2, sscanf(payload.c_str(), "%d-%d", &t, &i));
+      ASSERT_EQ(log, t / 2 + 1);
+      EXPECT_EQ(next[t]++, i);
+    }
+  }
+
+  Stats stats = stats_.aggregate();
+  EXPECT_GT(stats.buffered_writer_staged_drains, 0);
+  EXPECT_LE(stats.buffered_writer_staged_drains, NTHREADS * NAPPENDS);
+}
+
 TEST_F(BufferedWriterTest, ExplicitFlushIndependentUseBackgroundThread) {
   Settings settings = create_default_settings<Settings>();
   settings.buffered_writer_bg_thread_bytes_threshold = 1;
@@ -517,6 +568,185 @@ TEST_F(BufferedWriterTest, RoundTripLZ4NotCompressible) {
   this->roundTripTest(Compression::LZ4, false);
 }
 
+// Large ZSTD batches compressed by several threads decode like any other.
+TEST_F(BufferedWriterTest, RoundTripZstdMultithreaded) {
+  using Batch = BufferedWriterSingleLog::Batch;
+  using Flags = BufferedWriteDecoderImpl::Flags;
+  Batch batch(0);
+  batch.state = Batch::State::CONSTRUCTING_BLOB;
+  batch.blob_bytes_total = 2 + folly::kMaxVarintLength64;
+  std::vector<std::string> orig_payloads;
+  while (batch.blob_bytes_total < 4 * 1024 * 1024) {
+    std::string payload = std::to_string(orig_payloads.size());
+    payload.resize(1000, 'a' + orig_payloads.size() % 26);
+    uint8_t varint[folly::kMaxVarintLength64];
+    batch.blob_bytes_total +=
+        folly::encodeVarint(payload.size(), varint) + payload.size();
+    batch.payload_bytes_total += payload.size();
+    batch.appends.emplace_back(NULL_CONTEXT, payload);
+    orig_payloads.push_back(std::move(payload));
+  }
+
+  const BufferedWriteDecoderImpl::flags_t flags = Flags::SIZE_INCLUDED |
+      (uint8_t(Compression::ZSTD) & Flags::COMPRESSION_MASK);
+  BufferedWriterSingleLog::Impl::construct_blob_long_running(
+      batch,
+      flags,
+      /* checksum_bits */ 0,
+      /* destroy_payloads */ false,
+      /* zstd_level */ 1,
+      /* zstd_workers */ 2);
+  ASSERT_LT(batch.blob.length(), batch.payload_bytes_total / 2);
+
+  BufferedWriteDecoderImpl decoder;
+  std::vector<Payload> payloads;
+  ASSERT_EQ(0,
+            decoder.decodeOne(Slice(batch.blob.data(), batch.blob.length()),
+                              payloads,
+                              nullptr,
+                              /* copy_blob_if_uncompressed */ true));
+  ASSERT_EQ(orig_payloads.size(), payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    ASSERT_EQ(orig_payloads[i], payloads[i].toString());
+  }
+}
+
+// Small records compressed with a trained zstd dictionary should compress
+// better than without, and decode once the reader knows the dictionary.
+TEST_F(BufferedWriterTest, RoundTripZstdDictionary) {
+  using Batch = BufferedWriterSingleLog::Batch;
+  using Flags = BufferedWriteDecoderImpl::Flags;
+  auto record = [](size_t i) {
+    return folly::sformat(
+        "{{\"user_id\":{},\"event\":\"page_view\",\"country\":\"{}\"}}",
+        i * 7919 % 100000,
+        i % 3 == 0 ? "US" : "BR");
+  };
+
+  // Train a dictionary on a separate sample of records.
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (size_t i = 1000; i < 3000; ++i) {
+    std::string r = record(i);
+    samples += r;
+    sample_sizes.push_back(r.size());
+  }
+  std::string dict_data(4096, '\0');
+  size_t dict_size = ZDICT_trainFromBuffer(&dict_data[0],
+                                           dict_data.size(),
+                                           samples.data(),
+                                           sample_sizes.data(),
+                                           sample_sizes.size());
+  ASSERT_FALSE(ZDICT_isError(dict_size)) << ZDICT_getErrorName(dict_size);
+  dict_data.resize(dict_size);
+  auto dict = ZstdDictionary::create(
+      std::make_shared<const std::string>(dict_data));
+  ASSERT_NE(nullptr, dict);
+
+  std::vector<std::string> orig_payloads;
+  for (size_t i = 0; i < 20; ++i) {
+    orig_payloads.push_back(record(i));
+  }
+  auto compress = [&](const ZstdDictionary* zstd_dict) {
+    Batch batch(0);
+    batch.state = Batch::State::CONSTRUCTING_BLOB;
+    batch.blob_bytes_total = 2 + folly::kMaxVarintLength64;
+    for (const std::string& payload : orig_payloads) {
+      uint8_t varint[folly::kMaxVarintLength64];
+      batch.blob_bytes_total +=
+          folly::encodeVarint(payload.size(), varint) + payload.size();
+      batch.payload_bytes_total += payload.size();
+      batch.appends.emplace_back(NULL_CONTEXT, payload);
+    }
+    const BufferedWriteDecoderImpl::flags_t flags = Flags::SIZE_INCLUDED |
+        (uint8_t(Compression::ZSTD) & Flags::COMPRESSION_MASK);
+    BufferedWriterSingleLog::Impl::construct_blob_long_running(
+        batch,
+        flags,
+        /* checksum_bits */ 0,
+        /* destroy_payloads */ false,
+        /* zstd_level */ 3,
+        /* zstd_workers */ 0,
+        zstd_dict);
+    return batch.blob.moveToFbString().toStdString();
+  };
+  const std::string plain = compress(nullptr);
+  const std::string with_dict = compress(dict.get());
+  ASSERT_LT(with_dict.size(), plain.size());
+
+  BufferedWriteDecoderImpl decoder;
+  std::vector<Payload> payloads;
+  // The dictionary wasn't registered: construct_blob_long_running() doesn't
+  // do it, BufferedWriterSingleLog does.
+  ASSERT_EQ(nullptr, ZstdDictionaryRegistry::get().find(dict->getID()));
+  ASSERT_EQ(-1,
+            decoder.decodeOne(Slice(with_dict.data(), with_dict.size()),
+                              payloads,
+                              nullptr,
+                              /* copy_blob_if_uncompressed */ true));
+
+  ASSERT_EQ(0, BufferedWriteDecoder::addZstdDictionary(dict_data));
+  payloads.clear();
+  ASSERT_EQ(0,
+            decoder.decodeOne(Slice(with_dict.data(), with_dict.size()),
+                              payloads,
+                              nullptr,
+                              /* copy_blob_if_uncompressed */ true));
+  ASSERT_EQ(orig_payloads.size(), payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    ASSERT_EQ(orig_payloads[i], payloads[i].toString());
+  }
+
+  // Raw content dictionaries have no ID.
+  ASSERT_EQ(-1, BufferedWriteDecoder::addZstdDictionary(samples));
+  ASSERT_EQ(E::INVALID_PARAM, err);
+}
+
+// Decoding an uncompressed batch without consuming the DataRecord should
+// return payloads pointing into the record's buffer, and keep that buffer
+// alive after the record is gone.
+TEST_F(BufferedWriterTest, DecodeUncompressedWithoutCopy) {
+  using Flags = BufferedWriteDecoderImpl::Flags;
+  const std::vector<std::string> orig_payloads = {"foo", "", "barbaz"};
+  std::string blob;
+  blob += char(0xb1);
+  blob += char(Flags::SIZE_INCLUDED |
+               (uint8_t(Compression::NONE) & Flags::COMPRESSION_MASK));
+  uint8_t varint[folly::kMaxVarintLength64];
+  blob.append(reinterpret_cast<char*>(varint),
+              folly::encodeVarint(orig_payloads.size(), varint));
+  for (const std::string& payload : orig_payloads) {
+    blob.append(reinterpret_cast<char*>(varint),
+                folly::encodeVarint(payload.size(), varint));
+    blob += payload;
+  }
+
+  auto record = std::make_unique<DataRecordOwnsPayload>(
+      logid_t(1),
+      PayloadHolder::copyString(blob),
+      lsn_t(1),
+      std::chrono::milliseconds(0),
+      RECORD_flags_t(RECORD_Header::BUFFERED_WRITER_BLOB));
+  const char* begin = static_cast<const char*>(record->payload.data());
+  const char* end = begin + record->payload.size();
+
+  BufferedWriteDecoderImpl decoder;
+  std::vector<Payload> payloads;
+  ASSERT_EQ(0, decoder.decodeOne(*record, payloads));
+  ASSERT_EQ(orig_payloads.size(), payloads.size());
+  for (const Payload& payload : payloads) {
+    if (payload.size() > 0) {
+      const char* data = static_cast<const char*>(payload.data());
+      EXPECT_TRUE(data >= begin && data + payload.size() <= end);
+    }
+  }
+
+  record.reset();
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    EXPECT_EQ(orig_payloads[i], payloads[i].toString());
+  }
+}
+
 // Test Options::size_trigger.
 TEST_F(BufferedWriterTest, SizeTrigger) {
   TestCallback cb;
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/BusyPoller.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace std::chrono;
+
+TEST(BusyPollerTest, DisabledByDefault) {
+  BusyPoller poller;
+  EXPECT_FALSE(poller.enabled());
+  int calls = 0;
+  EXPECT_FALSE(poller.spin([&] { return ++calls > 0; }));
+  EXPECT_EQ(0, calls);
+}
+
+TEST(BusyPollerTest, FindsWork) {
+  BusyPoller poller;
+  poller.configure(milliseconds(100), 1.0);
+  int calls = 0;
+  EXPECT_TRUE(poller.spin([&] { return ++calls == 10; }));
+  EXPECT_EQ(10, calls);
+}
+
+TEST(BusyPollerTest, GivesUpAfterWindow) {
+  BusyPoller poller;
+  poller.configure(microseconds(200), 1.0);
+  auto start = steady_clock::now();
+  EXPECT_FALSE(poller.spin([] { return false; }));
+  EXPECT_GE(steady_clock::now() - start, microseconds(200));
+}
+
+TEST(BusyPollerTest, RespectsCPUBudget) {
+  BusyPoller poller;
+  poller.configure(milliseconds(10), 0.0);
+  int calls = 0;
+  EXPECT_FALSE(poller.spin([&] { return ++calls > 0; }));
+  EXPECT_EQ(0, calls);
+
+  // A budget of 5ms per period allows one full 4ms spin, then only what's
+  // left of the budget.
+  poller.configure(milliseconds(4), 0.005);
+  auto start = steady_clock::now();
+  EXPECT_FALSE(poller.spin([] { return false; }));
+  EXPECT_FALSE(poller.spin([] { return false; }));
+  EXPECT_FALSE(poller.spin([] { return false; }));
+  auto elapsed = steady_clock::now() - start;
+  EXPECT_GE(elapsed, milliseconds(5));
+  EXPECT_LT(elapsed, milliseconds(5) + BusyPoller::kBudgetPeriod / 2);
+  calls = 0;
+  if (steady_clock::now() - start < BusyPoller::kBudgetPeriod / 2) {
+    EXPECT_FALSE(poller.spin([&] { return ++calls > 0; }));
+    EXPECT_EQ(0, calls);
+  }
+}
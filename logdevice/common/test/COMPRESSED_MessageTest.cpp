@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
+
+#include <cstring>
+#include <string>
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/ProtocolHeader.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+// A serialized message of type TEST with `body` as its body.
+std::unique_ptr<folly::IOBuf> makeMessage(const std::string& body) {
+  ProtocolHeader protohdr;
+  protohdr.len = sizeof(ProtocolHeader) + body.size();
+  protohdr.type = MessageType::TEST;
+  protohdr.cksum = 0xdeadbeef;
+  auto buf = folly::IOBuf::create(protohdr.len);
+  memcpy(buf->writableData(), &protohdr, sizeof(protohdr));
+  memcpy(buf->writableData() + sizeof(protohdr), body.data(), body.size());
+  buf->append(protohdr.len);
+  return buf;
+}
+
+std::string toString(folly::IOBuf& buf) {
+  auto range = buf.coalesce();
+  return std::string(reinterpret_cast<const char*>(range.data()), range.size());
+}
+
+void roundTrip(Compression compression) {
+  std::string body;
+  while (body.size() < 100000) {
+    body += "record " + std::to_string(body.size() % 1000) + " ";
+  }
+  auto message = makeMessage(body);
+  const std::string expected = toString(*message);
+
+  const uint16_t proto = Compatibility::COMPRESSED_MESSAGE_SUPPORT;
+  auto frame = COMPRESSED_Message::compress(*message, compression, proto);
+  ASSERT_NE(nullptr, frame);
+  EXPECT_LT(frame->computeChainDataLength(), expected.size());
+
+  ProtocolHeader protohdr;
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(MessageType::COMPRESSED, proto);
+  memcpy(&protohdr, frame->data(), protohdr_bytes);
+  EXPECT_EQ(MessageType::COMPRESSED, protohdr.type);
+  EXPECT_EQ(frame->computeChainDataLength(), protohdr.len);
+
+  frame->trimStart(protohdr_bytes);
+  auto decompressed = COMPRESSED_Message::decompress(*frame);
+  ASSERT_NE(nullptr, decompressed);
+  EXPECT_EQ(expected, toString(*decompressed));
+}
+
+} // namespace
+
+TEST(COMPRESSED_MessageTest, RoundTripZSTD) {
+  roundTrip(Compression::ZSTD);
+}
+
+TEST(COMPRESSED_MessageTest, RoundTripLZ4) {
+  roundTrip(Compression::LZ4);
+}
+
+TEST(COMPRESSED_MessageTest, RoundTripLZ4HC) {
+  roundTrip(Compression::LZ4_HC);
+}
+
+TEST(COMPRESSED_MessageTest, NotSmaller) {
+  std::string body(10000, '\0');
+  for (char& c : body) {
+    c = folly::Random::rand32();
+  }
+  auto message = makeMessage(body);
+  EXPECT_EQ(nullptr,
+            COMPRESSED_Message::compress(
+                *message,
+                Compression::LZ4,
+                Compatibility::COMPRESSED_MESSAGE_SUPPORT));
+}
+
+TEST(COMPRESSED_MessageTest, Malformed) {
+  // Empty body.
+  auto body = folly::IOBuf::create(0);
+  EXPECT_EQ(nullptr, COMPRESSED_Message::decompress(*body));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // Invalid compression.
+  body = folly::IOBuf::copyBuffer(std::string("\x7f\x10garbage"));
+  EXPECT_EQ(nullptr, COMPRESSED_Message::decompress(*body));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // Claims to be larger than any message.
+  body = folly::IOBuf::copyBuffer(std::string("\x04\xff\xff\xff\xff\x0f"));
+  EXPECT_EQ(nullptr, COMPRESSED_Message::decompress(*body));
+  EXPECT_EQ(E::BADMSG, err);
+
+  // Garbage instead of compressed data.
+  body = folly::IOBuf::copyBuffer(std::string("\x04\x40garbage"));
+  EXPECT_EQ(nullptr, COMPRESSED_Message::decompress(*body));
+  EXPECT_EQ(E::BADMSG, err);
+}
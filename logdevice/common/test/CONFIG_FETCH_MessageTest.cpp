@@ -89,6 +89,35 @@ TEST(CONFIG_FETCH_MessageTest, LegacySerializeAndDeserialize) {
   EXPECT_EQ(0, deserialized_msg->getHeader().my_version);
 }
 
+TEST(CONFIG_FETCH_MessageTest, SerializeAndDeserializeDeltaBase) {
+  CONFIG_FETCH_Header header{
+      request_id_t(3),
+      CONFIG_FETCH_Header::ConfigType::NODES_CONFIGURATION,
+      10,
+      7};
+  CONFIG_FETCH_Message msg{header};
+
+  for (uint16_t proto :
+       {uint16_t(Compatibility::ProtocolVersion::RID_IN_CONFIG_MESSAGES),
+        uint16_t(Compatibility::ProtocolVersion::
+                     NODES_CONFIGURATION_DELTA_SUPPORT)}) {
+    std::string dest;
+    ProtocolWriter writer(&dest, "", proto);
+    msg.serialize(writer);
+    ASSERT_GT(writer.result(), 0);
+
+    auto deserialized_msg = tryRead<CONFIG_FETCH_Message>(dest, proto);
+    EXPECT_EQ(10, deserialized_msg->getHeader().my_version);
+    // Older protocols don't carry the delta base, so the reply is always a
+    // full config
+    EXPECT_EQ(proto >= Compatibility::ProtocolVersion::
+                           NODES_CONFIGURATION_DELTA_SUPPORT
+                  ? 7
+                  : 0,
+              deserialized_msg->getHeader().delta_base_version);
+  }
+}
+
 struct CONFIG_FETCH_MessageMock : public CONFIG_FETCH_Message {
   using CONFIG_FETCH_Message::CONFIG_FETCH_Message;
 
@@ -102,11 +131,21 @@ struct CONFIG_FETCH_MessageMock : public CONFIG_FETCH_Message {
 
   std::shared_ptr<const configuration::nodes::NodesConfiguration>
   getNodesConfiguration() override {
+    if (nodes_configuration) {
+      return nodes_configuration;
+    }
     // TODO: migrate it to use NodesConfiguration with switchable source
     return config->serverConfig()
         ->getNodesConfigurationFromServerConfigSource();
   }
 
+  std::string getNodesConfigurationDelta(
+      uint64_t base_version,
+      const configuration::nodes::NodesConfiguration& /* target */) override {
+    requested_delta_base = base_version;
+    return delta;
+  }
+
   int sendMessage(std::unique_ptr<CONFIG_CHANGED_Message> msg,
                   const Address& to) override {
     return sendMessage_(msg, to);
@@ -116,6 +155,10 @@ struct CONFIG_FETCH_MessageMock : public CONFIG_FETCH_Message {
                int(std::unique_ptr<CONFIG_CHANGED_Message>& msg, Address to));
 
   std::shared_ptr<Configuration> config;
+  std::shared_ptr<const configuration::nodes::NodesConfiguration>
+      nodes_configuration;
+  std::string delta;
+  uint64_t requested_delta_base{0};
 };
 
 void compareChangedMessages(std::unique_ptr<CONFIG_CHANGED_Message>& expected,
@@ -245,3 +288,51 @@ TEST(CONFIG_FETCH_MessageTest, OnReceivedUpdate) {
   EXPECT_EQ(CONFIG_FETCH_MessageMock::Disposition::NORMAL,
             msg.onReceived(Address(NodeID(1, 1))));
 }
+
+TEST(CONFIG_FETCH_MessageTest, OnReceivedNodesConfigurationDelta) {
+  auto config = createSimpleConfig(3, 1);
+  auto nodes_configuration =
+      config->serverConfig()
+          ->getNodesConfigurationFromServerConfigSource()
+          ->withVersion(vcs_config_version_t(5));
+
+  for (bool have_delta : {true, false}) {
+    CONFIG_FETCH_MessageMock msg{
+        CONFIG_FETCH_Header{
+            request_id_t(4),
+            CONFIG_FETCH_Header::ConfigType::NODES_CONFIGURATION,
+            3,
+            3,
+        },
+    };
+    msg.config = config;
+    msg.nodes_configuration = nodes_configuration;
+    msg.delta = have_delta ? "delta" : "";
+
+    EXPECT_CALL(msg, sendMessage_(_, Address(NodeID(1, 1))))
+        .WillOnce(
+            Invoke([&](std::unique_ptr<CONFIG_CHANGED_Message>& got, Address) {
+              EXPECT_EQ(Status::OK, got->getHeader().status);
+              EXPECT_EQ(5, got->getHeader().version);
+              if (have_delta) {
+                EXPECT_EQ(CONFIG_CHANGED_Header::ConfigType::
+                              NODES_CONFIGURATION_DELTA,
+                          got->getHeader().config_type);
+                EXPECT_EQ("delta", got->getConfigStr());
+              } else {
+                // No delta against the requested base, fall back to the
+                // full config
+                EXPECT_EQ(
+                    CONFIG_CHANGED_Header::ConfigType::NODES_CONFIGURATION,
+                    got->getHeader().config_type);
+                EXPECT_EQ(*nodes_configuration->serialize(),
+                          got->getConfigStr());
+              }
+              return 0;
+            }));
+
+    EXPECT_EQ(CONFIG_FETCH_MessageMock::Disposition::NORMAL,
+              msg.onReceived(Address(NodeID(1, 1))));
+    EXPECT_EQ(3, msg.requested_delta_base);
+  }
+}
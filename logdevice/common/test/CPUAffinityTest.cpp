@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/CPUAffinity.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+TEST(CPUAffinityTest, ParseCPUList) {
+  EXPECT_EQ(std::vector<int>({0}), parseCPUList("0"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            parseCPUList("0-3,8,10-11\n"));
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), parseCPUList("3,1-2,2"));
+  EXPECT_TRUE(parseCPUList("").empty());
+  EXPECT_TRUE(parseCPUList("3-1").empty());
+  EXPECT_TRUE(parseCPUList("a-b").empty());
+  EXPECT_TRUE(parseCPUList("-1").empty());
+}
+
+TEST(CPUAffinityTest, FormatCPUList) {
+  EXPECT_EQ("", formatCPUList({}));
+  EXPECT_EQ("5", formatCPUList({5}));
+  EXPECT_EQ("0-3,8,10-11", formatCPUList({0, 1, 2, 3, 8, 10, 11}));
+}
+
+TEST(CPUAffinityTest, PinCurrentThread) {
+  std::vector<int> cpus = getThreadCPUAffinity(0);
+  ASSERT_FALSE(cpus.empty());
+  // Restricting to what we already have always works and changes nothing.
+  EXPECT_EQ(0, setThreadCPUAffinity(0, cpus));
+  EXPECT_EQ(cpus, getThreadCPUAffinity(0));
+  EXPECT_GE(getNumaNodeCount(), 1);
+}
@@ -8,6 +8,8 @@
 #include "logdevice/common/Checksum.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <folly/ScopeGuard.h>
 #include <gtest/gtest.h>
@@ -60,6 +62,36 @@ TEST_F(ChecksumTest, Invariable) {
   EXPECT_EQ(0xf8e4f0d10bd88705, checksum_64bit(data));
 }
 
+// Batch checksums must match checksumming the slices one by one, for a mix of
+// sizes that exercises the interleaved lanes, tails and large buffers.
+TEST_F(ChecksumTest, Batch) {
+  std::vector<std::string> buffers;
+  for (size_t i = 0; i < 50; ++i) {
+    size_t size = (i % 7 == 0) ? 10000 + i : i * 13 % 300;
+    std::string buf(size, '\0');
+    for (size_t j = 0; j < size; ++j) {
+      buf[j] = static_cast<char>((i * 31 + j * 7) & 0xff);
+    }
+    buffers.push_back(std::move(buf));
+  }
+  std::vector<Slice> slices;
+  for (const auto& buf : buffers) {
+    slices.push_back(Slice(buf.data(), buf.size()));
+  }
+
+  std::vector<uint32_t> out32(slices.size());
+  checksum_32bit_batch(slices.data(), slices.size(), out32.data());
+  std::vector<uint64_t> out64(slices.size());
+  checksum_64bit_batch(slices.data(), slices.size(), out64.data());
+  for (size_t i = 0; i < slices.size(); ++i) {
+    EXPECT_EQ(checksum_32bit(slices[i]), out32[i]) << i;
+    EXPECT_EQ(checksum_64bit(slices[i]), out64[i]) << i;
+  }
+
+  // Empty batch.
+  checksum_32bit_batch(nullptr, 0, nullptr);
+}
+
 std::unique_ptr<RECORD_Message> ChecksumTest::roundTrip(
     APPEND_flags_t checksum_flags,
     std::function<void(RECORD_flags_t&, Payload)> mutation) {
@@ -145,6 +145,51 @@ TEST_P(ClientReadStreamBufferTest, ForEachBackwardEmpty) {
   ASSERT_TRUE(true);
 }
 
+// Markers are found wherever they are relative to the wrap-around point of the
+// circular buffer's storage, and slots given out by createOrGet() but left
+// empty aren't reported.
+TEST_P(ClientReadStreamBufferTest, FindFirstMarkerAfterRotation) {
+  // the ordered map doesn't keep empty placeholders around
+  if (GetParam() != ClientReadStreamBufferType::CIRCULAR) {
+    return;
+  }
+  auto rotate_by = [&](size_t n) {
+    buf->advanceBufferHead(n);
+    ASSERT_EQ(buf->find(buf->getBufferHead()), nullptr);
+  };
+  auto expect_first_marker = [&](lsn_t expected) {
+    auto res = buf->findFirstMarker();
+    EXPECT_EQ(expected, res.second);
+    EXPECT_EQ(expected == LSN_INVALID, res.first == nullptr);
+  };
+
+  for (size_t shift = 1; shift <= 23; shift += 11) {
+    rotate_by(shift);
+    const lsn_t head = buf->getBufferHead();
+    expect_first_marker(LSN_INVALID);
+
+    // Empty placeholder.
+    buf->createOrGet(head + 2);
+    expect_first_marker(LSN_INVALID);
+    EXPECT_EQ(nullptr, buf->find(head + 2));
+
+    buf->createOrGet(head + 9)->gap = true;
+    expect_first_marker(head + 9);
+    buf->createOrGet(head + 4)->filtered_out = true;
+    expect_first_marker(head + 4);
+    EXPECT_NE(nullptr, buf->find(head + 9));
+
+    buf->find(head + 4)->filtered_out = false;
+    buf->find(head + 9)->gap = false;
+    expect_first_marker(LSN_INVALID);
+    EXPECT_EQ(nullptr, buf->front());
+  }
+
+  buf->createOrGet(buf->getBufferHead() + 1)->gap = true;
+  buf->clear();
+  expect_first_marker(LSN_INVALID);
+}
+
 INSTANTIATE_TEST_CASE_P(
     ClientReadStreamBufferTest,
     ClientReadStreamBufferTest,
@@ -209,7 +209,7 @@ struct TestState {
   std::vector<CacheEntry> cache_entries_;
 
   bool has_memory_pressure = false;
-  std::unordered_map<ShardID, ClientReadStreamSenderState, ShardID::Hash>*
+  folly::F14NodeMap<ShardID, ClientReadStreamSenderState, ShardID::Hash>*
       storage_set_states;
 };
 
@@ -588,6 +588,11 @@ class ClientReadStreamTest
     read_stream_->scd_->shards_down_failover_timer_.callback();
   }
 
+  void scdStalledShardsFailoverTimerCallback() {
+    ld_check(read_stream_->scd_);
+    read_stream_->scd_->stalled_shards_failover_timer_.callback();
+  }
+
   void scdAllSendAllFailoverTimerCallback() {
     ld_check(read_stream_->scd_);
     read_stream_->scd_->all_send_all_failover_timer_.callback();
@@ -1122,6 +1127,49 @@ TEST_P(ClientReadStreamTest, MultipleWindowRound) {
   ASSERT_NO_WINDOW_MESSAGES()
 }
 
+// Records much older than their arrival time put the stream in backlog mode,
+// which slides the window sooner.
+TEST_P(ClientReadStreamTest, BacklogFlowControlThreshold) {
+  state_.shards.resize(4);
+  buffer_size_ = 7;
+  until_lsn_ = lsn(1, 15);
+  flow_control_threshold_ = 0.5;
+  // mockRecord() timestamps are 0, so every record is from the backlog.
+  state_.settings.client_read_backlog_age = std::chrono::hours(1);
+  state_.settings.client_read_backlog_flow_control_threshold = 0.01;
+
+  start();
+  ASSERT_START_MESSAGES(lsn(1, 1),
+                        lsn(1, 15),
+                        lsn(1, 7),
+                        filter_version_t{1},
+                        false,
+                        small_shardset_t{},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+
+  // The initial window was computed before any record was seen and slides
+  // after the first 4 records, as in MultipleWindowRound.
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  onDataRecord(N1, mockRecord(lsn(1, 2)));
+  onDataRecord(N2, mockRecord(lsn(1, 3)));
+  ASSERT_RECV(lsn(1, 1), lsn(1, 2), lsn(1, 3));
+  ASSERT_NO_WINDOW_MESSAGES()
+  onDataRecord(N3, mockRecord(lsn(1, 4)));
+  ASSERT_RECV(lsn(1, 4));
+  ASSERT_WINDOW_MESSAGES(lsn(1, 5), lsn(1, 11), N0, N1, N2, N3);
+
+  // From now on the window slides after every record.
+  onDataRecord(N0, mockRecord(lsn(1, 5)));
+  ASSERT_RECV(lsn(1, 5));
+  ASSERT_WINDOW_MESSAGES(lsn(1, 6), lsn(1, 12), N0, N1, N2, N3);
+  onDataRecord(N1, mockRecord(lsn(1, 6)));
+  ASSERT_RECV(lsn(1, 6));
+  ASSERT_WINDOW_MESSAGES(lsn(1, 7), lsn(1, 13), N0, N1, N2, N3);
+}
+
 TEST_P(ClientReadStreamTest, DynamicWindowScaling) {
   state_.shards.resize(4);
   buffer_size_ = 10;
@@ -1217,6 +1265,42 @@ TEST_P(ClientReadStreamTest, DynamicWindowScaling) {
   ASSERT_NO_WINDOW_MESSAGES();
 }
 
+// With --client-read-buffer-bytes, the window is shrunk to the number of
+// records of average size that fit in it.
+TEST_P(ClientReadStreamTest, WindowBoundedByBufferBytes) {
+  state_.shards.resize(4);
+  buffer_size_ = 10;
+  until_lsn_ = lsn(1, 100);
+  flow_control_threshold_ = 1;
+  // mockRecord() payloads are 4 bytes, this fits 3 records.
+  state_.settings.client_read_buffer_bytes = 12;
+
+  start();
+  ASSERT_START_MESSAGES(lsn(1, 1),
+                        lsn(1, 100),
+                        lsn(1, 10),
+                        filter_version_t{1},
+                        false,
+                        small_shardset_t{},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+
+  std::vector<TestStep> steps = {
+      // The first window is sized in records, the average record size is
+      // not known yet.
+      {TestStep::RECORDS, lsn(1, 1), lsn(1, 11)},
+      {TestStep::WINDOW, lsn(1, 11), lsn(1, 13)},
+      {TestStep::RECORDS, lsn(1, 11), lsn(1, 14)},
+      {TestStep::WINDOW, lsn(1, 14), lsn(1, 16)},
+      {TestStep::RECORDS, lsn(1, 14), lsn(1, 17)},
+      {TestStep::WINDOW, lsn(1, 17), lsn(1, 19)},
+  };
+  runTestSteps(steps);
+  ASSERT_NO_WINDOW_MESSAGES();
+}
+
 /**
  * Receiving the same LSN from the same node more than once should not be an
  * issue.  This can happen when:
@@ -2496,6 +2580,71 @@ TEST_P(ClientReadStreamTest, ScdFailoverTimerOneNodeStuck) {
   ASSERT_RECV(lsn(1, 16), lsn(1, 17), lsn(1, 18))
 }
 
+// A storage node (N1) stops sending while the other nodes keep sending
+// records past it. The stalled shards timer adds it to the known down list, but
+// only once the other stuck node (N3) is no longer stuck: with replication 2,
+// filtering out both could leave records with no copy on N0 and N2.
+TEST_P(ClientReadStreamTest, ScdStalledShardsTimer) {
+  state_.shards.resize(4);
+  buffer_size_ = 30;
+  replication_factor_ = 2;
+  scd_enabled_ = true;
+  state_.settings.scd_stalled_shards_timeout = std::chrono::seconds(1);
+  start();
+
+  lsn_t buffer_max = calc_buffer_max(start_lsn_, buffer_size_);
+  ASSERT_START_MESSAGES(lsn_t(start_lsn_),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{1},
+                        true,
+                        small_shardset_t{},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  onDataRecord(N1, mockRecord(lsn(1, 2)));
+  onDataRecord(N2, mockRecord(lsn(1, 3)));
+  onDataRecord(N3, mockRecord(lsn(1, 4)));
+  ASSERT_RECV(lsn(1, 1), lsn(1, 2), lsn(1, 3), lsn(1, 4));
+
+  // Record 5 is missing, neither N1 nor N3 sent anything past it.
+  onDataRecord(N0, mockRecord(lsn(1, 6)));
+  onDataRecord(N2, mockRecord(lsn(1, 7)));
+  ASSERT_RECV();
+
+  scdStalledShardsFailoverTimerCallback();
+  scdStalledShardsFailoverTimerCallback();
+  ASSERT_FALSE(rewindScheduled());
+
+  // Now only N1 is stuck.
+  onDataRecord(N3, mockRecord(lsn(1, 8)));
+  ASSERT_RECV();
+  scdStalledShardsFailoverTimerCallback();
+  ASSERT_TRUE(rewindScheduled());
+  triggerScheduledRewind();
+
+  ASSERT_START_MESSAGES(lsn(1, 5),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{2},
+                        true,
+                        small_shardset_t{N1},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+  ON_STARTED(filter_version_t{2}, N0, N1, N2, N3);
+
+  onDataRecord(N0, mockRecord(lsn(1, 5)));
+  onDataRecord(N0, mockRecord(lsn(1, 6)));
+  onDataRecord(N2, mockRecord(lsn(1, 7)));
+  onDataRecord(N3, mockRecord(lsn(1, 8)));
+  ASSERT_RECV(lsn(1, 5), lsn(1, 6), lsn(1, 7), lsn(1, 8));
+}
+
 // Even more unlikely and rare situation:
 // Same as ScdFailoverTimerOneNodeStuck but this time failover happens twice ie,
 // one node is stuck which causes the streams to be rewound with it in the known
@@ -198,6 +198,32 @@ TEST_F(ClientConnectionTest, Handshake) {
   receiveAckMessage();
   EXPECT_TRUE(handshaken());
 }
+TEST_F(ClientConnectionTest, ZeroCopyWrite) {
+  settings_.zero_copy_write_threshold = 1;
+  std::unique_ptr<folly::IOBuf> hello_buf;
+  ON_CALL(*sock_, connect_(_, _, _, _, _))
+      .WillByDefault(SaveArg<0>(&conn_callback_));
+  ON_CALL(*sock_, good()).WillByDefault(Return(true));
+  EXPECT_CALL(*sock_, setZeroCopy(true)).WillOnce(Return(true));
+  // HELLO is serialized into IOBufs the Connection owns, it can be sent
+  // zero-copy.
+  EXPECT_CALL(*sock_, writeChain_(_, _, folly::WriteFlags::WRITE_MSG_ZEROCOPY))
+      .WillOnce(Invoke([this, &hello_buf](folly::AsyncSocket::WriteCallback* cb,
+                                          folly::IOBuf* buf,
+                                          folly::WriteFlags) {
+        wr_callback_ = cb;
+        hello_buf.reset(buf);
+      }));
+  ON_CALL(*sock_, setReadCB(_)).WillByDefault(SaveArg<0>(&rd_callback_));
+  EXPECT_EQ(conn_->connect(), 0);
+  conn_callback_->connectSuccess();
+  EXPECT_TRUE(connected());
+  ev_base_folly_.loopOnce();
+  writeSuccess();
+  receiveAckMessage();
+  EXPECT_TRUE(handshaken());
+}
+
 static Envelope* create_message(Connection& s) {
   GET_SEQ_STATE_flags_t flags = 0;
   auto msg = std::make_unique<GET_SEQ_STATE_Message>(
@@ -245,6 +271,46 @@ TEST_F(ClientConnectionTest, SerializationStages) {
   CHECK_SERIALIZEQ();
 }
 
+// Small messages sent in the same event loop iteration are copied into one
+// buffer and written together.
+TEST_F(ClientConnectionTest, CoalesceSmallMessages) {
+  std::unique_ptr<folly::IOBuf> written;
+  ON_CALL(*sock_, connect_(_, _, _, _, _))
+      .WillByDefault(SaveArg<0>(&conn_callback_));
+  ON_CALL(*sock_, writeChain_(_, _, _))
+      .WillByDefault(
+          Invoke([this, &written](folly::AsyncSocket::WriteCallback* cb,
+                                  folly::IOBuf* buf,
+                                  folly::WriteFlags) {
+            wr_callback_ = cb;
+            written.reset(buf);
+          }));
+  ON_CALL(*sock_, setReadCB(_)).WillByDefault(SaveArg<0>(&rd_callback_));
+  EXPECT_EQ(conn_->connect(), 0);
+  conn_callback_->connectSuccess();
+  ev_base_folly_.loopOnce();
+  writeSuccess();
+  CHECK_ON_SENT(MessageType::HELLO, E::OK);
+  receiveAckMessage();
+  EXPECT_TRUE(handshaken());
+
+  const size_t nmessages = 3;
+  for (size_t i = 0; i < nmessages; ++i) {
+    auto envelope = create_message(*conn_);
+    ASSERT_NE(envelope, nullptr);
+    conn_->releaseMessage(*envelope);
+  }
+  written.reset();
+  ev_base_folly_.loopOnce();
+  ASSERT_NE(written, nullptr);
+  EXPECT_FALSE(written->isChained());
+  writeSuccess();
+  for (size_t i = 0; i < nmessages; ++i) {
+    CHECK_ON_SENT(MessageType::GET_SEQ_STATE, E::OK);
+  }
+  CHECK_NO_MESSAGE_SENT();
+}
+
 // Verify that handshake works for a server Socket.
 TEST_F(ServerConnectionTest, Handshake) {
   // Simulate HELLO to be received by the server.
@@ -78,6 +78,7 @@ class CopySetSelectorTest : public ::testing::Test {
   bool sticky_copysets_{false};
   size_t sticky_copysets_block_size_{64 * 1024 * 1024};
   std::chrono::milliseconds sticky_copysets_block_max_time_{3600 * 1000};
+  size_t sticky_copysets_block_max_size_{0};
 
   // internal state of the copyset_selector_
   std::unique_ptr<CopySetManager::State> csm_state_;
@@ -273,7 +274,8 @@ class MockStickyCopySetManager : public StickyCopySetManager {
                              test->nodeset_state_,
                              test->sticky_copysets_block_size_,
                              test->sticky_copysets_block_max_time_,
-                             &test->deps_) {}
+                             &test->deps_,
+                             test->sticky_copysets_block_max_size_) {}
 
  private:
 };
@@ -1166,6 +1168,68 @@ TEST_F(CopySetSelectorTest, StickyCopySetManager) {
   ASSERT_EQ(CopySetSelector::Result::FAILED, result_.rv);
 }
 
+TEST_F(CopySetSelectorTest, StickyCopySetManagerAdaptiveBlockSize) {
+  replication_ = 3;
+  extras_ = 0;
+
+  copyset_selector_type_ = CopySetSelectorType::CROSS_DOMAIN;
+  sync_replication_scope_ = NodeLocationScope::REGION;
+
+  sticky_copysets_ = true;
+  // Each append is 1024 bytes, so blocks start with 2 records and grow to
+  // 4 records.
+  sticky_copysets_block_size_ = 2048;
+  sticky_copysets_block_max_size_ = 4096;
+  setUp();
+
+  Result res;
+  res.ndest = 3;
+  res.chain_out = false;
+  res.rv = CopySetSelector::Result::SUCCESS;
+  auto push_copyset = [&](ShardID a, ShardID b, ShardID c) {
+    res.copyset[0] = {a, ClientID()};
+    res.copyset[1] = {b, ClientID()};
+    res.copyset[2] = {c, ClientID()};
+    underlying_result_queue_.push(res);
+  };
+  auto select_records = [&](int count) {
+    for (int i = 0; i < count; ++i) {
+      csm_state_ = copyset_manager_->createState();
+      selectCopySet();
+      ASSERT_EQ(CopySetSelector::Result::SUCCESS, result_.rv);
+    }
+  };
+
+  // First block has the initial size.
+  push_copyset(ShardID(0, 0), N1, N2);
+  select_records(2);
+  ASSERT_EQ(0, underlying_result_queue_.size());
+
+  // It filled up, so the second block is twice as large.
+  push_copyset(N3, N4, N5);
+  select_records(4);
+  ASSERT_EQ(0, underlying_result_queue_.size());
+  ASSERT_EQ(N3, result_.copyset[0].destination);
+
+  // Blocks don't grow beyond the maximum.
+  push_copyset(N6, N7, N8);
+  select_records(4);
+  ASSERT_EQ(0, underlying_result_queue_.size());
+  ASSERT_EQ(N6, result_.copyset[0].destination);
+
+  // A block that ends because of an unavailable node resets the size.
+  push_copyset(N3, N4, N5);
+  select_records(1);
+  deps_.setNodeStatus(N4, NodeStatus::NOT_AVAILABLE, ClientID::MIN);
+  push_copyset(ShardID(0, 0), N1, N2);
+  select_records(2);
+  ASSERT_EQ(0, underlying_result_queue_.size());
+  push_copyset(N6, N7, N8);
+  select_records(1);
+  ASSERT_EQ(0, underlying_result_queue_.size());
+  ASSERT_EQ(N6, result_.copyset[0].destination);
+}
+
 TEST_F(CopySetSelectorTest, CrossDomainCopysetSelectorDistribution) {
   replication_ = 3;
   extras_ = 0;
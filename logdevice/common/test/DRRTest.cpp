@@ -455,3 +455,29 @@ TEST_F(DRRIntegrationTest, ByteBasedSmallQuantaVariableSize) {
   while ((task = params.q->dequeue()))
     ;
 }
+
+// getQueueInfo() reports the number of queued requests of each principal
+TEST_F(DRRIntegrationTest, QueueInfo) {
+  std::vector<DRRPrincipal> shares = {{"a", 1}, {"b", 2}};
+  DRRScheduler<TestTask, &TestTask::schedulerQHook_> ioq;
+  ioq.initShares("unit-test-q", 1, shares);
+
+  TestTask t1(1), t2(1), t3(1);
+  ioq.enqueue(&t1, 1);
+  ioq.enqueue(&t2, 1);
+  ioq.enqueue(&t3, 0);
+
+  auto info = ioq.getQueueInfo();
+  ASSERT_EQ(2, info.size());
+  EXPECT_EQ("a", info[0].principal.name);
+  EXPECT_EQ(1, info[0].principal.share);
+  EXPECT_EQ(1, info[0].numReqs);
+  EXPECT_EQ("b", info[1].principal.name);
+  EXPECT_EQ(2, info[1].numReqs);
+
+  while (ioq.dequeue()) {
+  }
+  info = ioq.getQueueInfo();
+  EXPECT_EQ(0, info[0].numReqs);
+  EXPECT_EQ(0, info[1].numReqs);
+}
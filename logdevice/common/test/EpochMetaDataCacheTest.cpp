@@ -155,6 +155,31 @@ TEST_F(EpochMetaDataCacheTest, Overwrite) {
   ASSERT_EQ(expected, result_);
 }
 
+TEST_F(EpochMetaDataCacheTest, PendingReads) {
+  setUp();
+  int woken_up = 0;
+  auto first = cache_->startOrJoinRead(LOG_ID, epoch_t(1), [] {});
+  ASSERT_NE(nullptr, first);
+  // same log and epoch: join the read in flight
+  ASSERT_EQ(nullptr,
+            cache_->startOrJoinRead(LOG_ID, epoch_t(1), [&] { ++woken_up; }));
+  ASSERT_EQ(nullptr,
+            cache_->startOrJoinRead(LOG_ID, epoch_t(1), [&] { ++woken_up; }));
+  // a different epoch or log is read separately
+  auto other_epoch = cache_->startOrJoinRead(LOG_ID, epoch_t(2), [] {});
+  ASSERT_NE(nullptr, other_epoch);
+  auto other_log = cache_->startOrJoinRead(logid_t(1), epoch_t(1), [] {});
+  ASSERT_NE(nullptr, other_log);
+
+  ASSERT_EQ(0, woken_up);
+  first.reset();
+  ASSERT_EQ(2, woken_up);
+
+  // the read is over, the next one starts a new read
+  auto next = cache_->startOrJoinRead(LOG_ID, epoch_t(1), [] {});
+  ASSERT_NE(nullptr, next);
+}
+
 // TODO: add test(s) for eviction
 
 } // namespace
@@ -604,4 +604,41 @@ TEST_F(EventLogRebuildingSetTest, DowngradeToMiniRebuilding) {
   ASSERT_SHARD_STATUS(set, node_index_t{0}, uint32_t{0}, FULLY_AUTHORITATIVE);
 }
 
+// Updating a ShardAuthoritativeStatusMap with only the shard indexes that
+// events touched gives the same map as recomputing it.
+TEST_F(EventLogRebuildingSetTest, IncrementalShardStatusMap) {
+  EventLogRebuildingSet set;
+  const auto nc = getNodesConfiguration();
+  ShardAuthoritativeStatusMap map = set.toShardStatusMap(*nc);
+
+  // Returns the shards whose status changed.
+  auto check = [&](uint32_t shard) {
+    auto prev = map;
+    set.updateShardStatusMap(map, shard, *nc);
+    EXPECT_EQ(set.toShardStatusMap(*nc), map);
+    auto changed = map.getChangedShards(prev);
+    EXPECT_EQ(changed.size(), prev.getChangedShards(map).size());
+    for (ShardID s : changed) {
+      EXPECT_EQ(shard, s.shard());
+    }
+    return changed;
+  };
+
+  EVENT(set, SHARD_NEEDS_REBUILD, node_index_t{0}, uint32_t{1}, "", "", 0);
+  EXPECT_EQ(std::vector<ShardID>({ShardID(0, 1)}), check(1));
+  EVENT(set, SHARD_NEEDS_REBUILD, node_index_t{2}, uint32_t{0}, "", "", 0);
+  EXPECT_EQ(std::vector<ShardID>({ShardID(2, 0)}), check(0));
+  EVENT(set, SHARD_UNRECOVERABLE, node_index_t{0}, uint32_t{1});
+  check(1);
+  EVENT(set, SHARD_IS_REBUILT, node_index_t{1}, uint32_t{1}, lsn_t(1), 0u);
+  check(1);
+  EVENT(set, SHARD_IS_REBUILT, node_index_t{2}, uint32_t{1}, lsn_t(1), 0u);
+  EVENT(set, SHARD_IS_REBUILT, node_index_t{3}, uint32_t{1}, lsn_t(1), 0u);
+  EVENT(set, SHARD_IS_REBUILT, node_index_t{4}, uint32_t{1}, lsn_t(1), 0u);
+  check(1);
+  EVENT(set, SHARD_ABORT_REBUILD, node_index_t{2}, uint32_t{0}, lsn_t(2));
+  EXPECT_EQ(std::vector<ShardID>({ShardID(2, 0)}), check(0));
+  ASSERT_SHARD_STATUS(set, node_index_t{2}, uint32_t{0}, FULLY_AUTHORITATIVE);
+}
+
 }} // namespace facebook::logdevice
@@ -143,6 +143,7 @@ class MockEventLogStateMachine : public EventLogStateMachine {
 
   void getDeltaLogTailLSN() override;
   void getSnapshotLogTailLSN() override;
+  void prefetchDeltaLogTailLSN() override {}
   read_stream_id_t createBasicReadStream(
       logid_t /*logid*/,
       lsn_t /*start_lsn*/,
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/EventLoopProfiler.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace std::chrono_literals;
+
+namespace {
+
+TEST(EventLoopProfilerTest, PackRunContext) {
+  for (RunContext context : {RunContext(),
+                             RunContext(RequestType::MISC),
+                             RunContext(MessageType::STORE),
+                             RunContext(StorageTaskType::COMPACT_PARTITION)}) {
+    RunContext unpacked = RunContext::unpack(context.pack());
+    EXPECT_TRUE(unpacked == context) << context.describe();
+  }
+}
+
+TEST(EventLoopProfilerTest, SlowestFirst) {
+  EventLoopProfiler profiler;
+  profiler.onStopped(RunContext(MessageType::STORE), 10us, 1);
+  profiler.onStopped(RunContext(MessageType::STORE), 30us, 1);
+  profiler.onStopped(RunContext(RequestType::MISC), 20us, 1);
+  // Not sampled, only counts towards the max.
+  profiler.onStopped(RunContext(RequestType::MISC), 50us, 0);
+
+  auto entries = profiler.getEntries();
+  ASSERT_EQ(2, entries.size());
+
+  RunContext misc(RequestType::MISC);
+  EXPECT_TRUE(entries[0].context == misc);
+  EXPECT_EQ(1, entries[0].sampled);
+  EXPECT_EQ(20us, entries[0].total);
+  EXPECT_EQ(50us, entries[0].max);
+
+  RunContext store(MessageType::STORE);
+  EXPECT_TRUE(entries[1].context == store);
+  EXPECT_EQ(2, entries[1].sampled);
+  EXPECT_EQ(40us, entries[1].total);
+  EXPECT_EQ(30us, entries[1].max);
+
+  profiler.reset();
+  EXPECT_TRUE(profiler.getEntries().empty());
+}
+
+TEST(EventLoopProfilerTest, CurrentlyRunning) {
+  EventLoopProfiler profiler;
+  EXPECT_EQ(RunContext::NONE, profiler.currentlyRunning().first.type_);
+
+  RunContext store(MessageType::STORE);
+  profiler.onStarted(store, std::chrono::steady_clock::now() - 1s);
+  auto running = profiler.currentlyRunning();
+  EXPECT_TRUE(running.first == store);
+  EXPECT_GE(running.second, 1s);
+
+  profiler.onStopped(store, 1s, 1);
+  EXPECT_EQ(RunContext::NONE, profiler.currentlyRunning().first.type_);
+}
+
+} // namespace
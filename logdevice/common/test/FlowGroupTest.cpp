@@ -372,3 +372,60 @@ TEST_F(FlowGroupTest, AllowCompleteBandwidthUsageForBurstyTraffic) {
 }
 
 } // anonymous namespace
+
+TEST_F(FlowGroupTest, BorrowFromIdleClasses) {
+  // Per-quantum values, as in FlowGroupBandwidthCaps.
+  update.policy.set(Priority::BACKGROUND,
+                    /*burst*/ 10000,
+                    /*guaranteed_bps*/ 1000,
+                    /*max_bps*/ 3000);
+  update.policy.set(FlowGroup::PRIORITYQ_PRIORITY,
+                    /*burst*/ 10000,
+                    /*guaranteed_bps*/ 0,
+                    /*max_bps*/ 0);
+  resetMeter(0);
+
+  // Accumulate some credit in all classes.
+  for (int i = 0; i < 5; ++i) {
+    flow_group->applyUpdate(update);
+  }
+  ASSERT_EQ(flow_group->level(Priority::BACKGROUND), 5000);
+  ASSERT_EQ(flow_group->level(Priority::IDLE), 5000);
+  ASSERT_TRUE(flow_group->drain(5000, Priority::BACKGROUND));
+
+  // Without borrowing, BACKGROUND has to wait for the next quantum even
+  // though the other classes are idle.
+  ASSERT_FALSE(flow_group->drain(1500, Priority::BACKGROUND));
+
+  update.policy.setBorrowingEnabled(true);
+  flow_group->applyUpdate(update);
+  ASSERT_TRUE(flow_group->borrowingEnabled());
+  ASSERT_EQ(flow_group->level(Priority::BACKGROUND), 1000);
+  ASSERT_TRUE(flow_group->drain(1000, Priority::BACKGROUND));
+
+  // BACKGROUND may now borrow up to the 2000 bytes of its max_bw budget that
+  // it didn't use in this quantum. IDLE, the lowest priority class, lends
+  // first.
+  ASSERT_TRUE(flow_group->drain(1500, Priority::BACKGROUND));
+  ASSERT_EQ(flow_group->level(Priority::BACKGROUND), 0);
+  ASSERT_EQ(flow_group->level(Priority::IDLE), 6000 - 1500);
+
+  // Only 500 bytes of budget left: enough to release one more message, which
+  // leaves BACKGROUND in debt.
+  ASSERT_TRUE(flow_group->drain(1000, Priority::BACKGROUND));
+  ASSERT_EQ(flow_group->debt(Priority::BACKGROUND), 500);
+  ASSERT_EQ(flow_group->level(Priority::IDLE), 6000 - 2000);
+  ASSERT_FALSE(flow_group->drain(1, Priority::BACKGROUND));
+
+  // A class with queued work doesn't lend.
+  flow_group->applyUpdate(update);
+  ASSERT_EQ(flow_group->level(Priority::BACKGROUND), 500);
+  ASSERT_TRUE(flow_group->drain(500, Priority::BACKGROUND));
+  flow_group->push(*new FlowOperation(sent, "Idle Op", 1000), Priority::IDLE);
+  ASSERT_TRUE(flow_group->drain(100, Priority::BACKGROUND));
+  ASSERT_EQ(flow_group->level(Priority::IDLE), 5000);
+  ASSERT_EQ(flow_group->level(Priority::CLIENT_LOW), 7000 - 100);
+
+  run();
+  CHECK_SENT("Idle Op", 1000);
+}
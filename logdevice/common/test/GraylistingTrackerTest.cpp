@@ -102,6 +102,19 @@ class MockGraylistingTracker : public GraylistingTracker {
     return 0s;
   }
 
+  double getGraylistingMedianLatencyRatio() const override {
+    return median_latency_ratio_;
+  }
+
+  double getGraylistingMedianLatencyExitRatio() const override {
+    return median_latency_exit_ratio_;
+  }
+
+  void setMedianLatencyRatios(double ratio, double exit_ratio) {
+    median_latency_ratio_ = ratio;
+    median_latency_exit_ratio_ = exit_ratio;
+  }
+
   NodesConfigurationTestUtil::NodeTemplate buildNode(node_index_t id,
                                                      std::string domain,
                                                      bool metadata = false) {
@@ -121,6 +134,9 @@ class MockGraylistingTracker : public GraylistingTracker {
  private:
   MockWorkerTimeoutStats stats_;
 
+  double median_latency_ratio_{0};
+  double median_latency_exit_ratio_{0};
+
   std::vector<NodesConfigurationTestUtil::NodeTemplate> nodes_;
 
   std::shared_ptr<const configuration::nodes::NodesConfiguration>
@@ -413,6 +429,46 @@ TEST(GraylistingTrackerTest, AllNotOutlier) {
   EXPECT_EQ(0, tracker.getGraylistedNodes().size());
 }
 
+TEST(GraylistingTrackerTest, MedianLatencyOutlier) {
+  // 2x slower than the others: not a statistical outlier, but above a 1.8x
+  // median ratio
+  auto stats = buildWorkerStats(
+      {{1, 100ms}, {2, 110ms}, {3, 90ms}, {4, 100ms}, {5, 200ms}}, 10);
+  auto now = SteadyTimestamp::now();
+
+  MockGraylistingTracker tracker(std::move(stats));
+  tracker.updateGraylist(now);
+  tracker.updateGraylist(now + 10s);
+  EXPECT_EQ(0, tracker.getGraylistedNodes().size());
+
+  tracker.setMedianLatencyRatios(1.8, 1.5);
+  tracker.updateGraylist(now + 20s);
+  EXPECT_EQ(0, tracker.getGraylistedNodes().size());
+
+  // Gets a bit better, but stays above the exit ratio while it is a
+  // potential outlier
+  tracker.setStats(buildWorkerStats(
+      {{1, 100ms}, {2, 110ms}, {3, 90ms}, {4, 100ms}, {5, 160ms}}, 10));
+  tracker.updateGraylist(now + 30s);
+  EXPECT_THAT(tracker.getGraylistedNodes(), UnorderedElementsAre(5));
+}
+
+TEST(GraylistingTrackerTest, MedianLatencyNoHysteresis) {
+  auto stats = buildWorkerStats(
+      {{1, 100ms}, {2, 110ms}, {3, 90ms}, {4, 100ms}, {5, 200ms}}, 10);
+  auto now = SteadyTimestamp::now();
+
+  MockGraylistingTracker tracker(std::move(stats));
+  tracker.setMedianLatencyRatios(1.8, 0);
+  tracker.updateGraylist(now);
+
+  // Below the ratio before the grace period is over: not graylisted
+  tracker.setStats(buildWorkerStats(
+      {{1, 100ms}, {2, 110ms}, {3, 90ms}, {4, 100ms}, {5, 160ms}}, 10));
+  tracker.updateGraylist(now + 10s);
+  EXPECT_EQ(0, tracker.getGraylistedNodes().size());
+}
+
 TEST(GraylistingTrackerTest, NoStoresSent) {
   auto stats = buildWorkerStats({}, 0);
   auto now = SteadyTimestamp::now();
@@ -151,3 +151,58 @@ TEST_F(KeyValueStoreStateMachineTest, DefaultStateHasVersion) {
   EXPECT_TRUE(default_state->store.empty());
   EXPECT_EQ(50, default_state->version);
 }
+
+TEST_F(KeyValueStoreStateMachineTest, AppliesDeltaForRemove) {
+  KeyValueStoreState state;
+  state.store = std::map<std::string, std::string>(
+      {{"customer1", "abc"}, {"customer2", "def"}});
+  state.version = 5;
+
+  RemoveValue remove;
+  remove.key = "customer1";
+  KeyValueStoreDelta delta;
+  delta.set_remove_value(remove);
+
+  std::string failure_reason;
+  int rv = state_machine_->applyDelta(
+      delta, state, 60, std::chrono::milliseconds(0), failure_reason);
+  EXPECT_EQ(0, rv);
+  EXPECT_EQ(1, state.store.size());
+  EXPECT_EQ(0, state.store.count("customer1"));
+  EXPECT_EQ(60, state.version);
+
+  // Removing a key that doesn't exist is a no-op.
+  rv = state_machine_->applyDelta(
+      delta, state, 61, std::chrono::milliseconds(0), failure_reason);
+  EXPECT_EQ(0, rv);
+  EXPECT_EQ(1, state.store.size());
+  EXPECT_EQ(61, state.version);
+}
+
+TEST_F(KeyValueStoreStateMachineTest, RangeQueries) {
+  KeyValueStoreStateMachine::Store store({{"a", "1"},
+                                          {"b/1", "2"},
+                                          {"b/2", "3"},
+                                          {"b\xff", "4"},
+                                          {"c", "5"}});
+  auto keys = [](KeyValueStoreStateMachine::StoreRange range) {
+    std::vector<std::string> res;
+    for (auto it = range.first; it != range.second; ++it) {
+      res.push_back(it->first);
+    }
+    return res;
+  };
+  using V = std::vector<std::string>;
+
+  EXPECT_EQ(V({"b/1", "b/2"}), keys(state_machine_->prefixRange(store, "b/")));
+  EXPECT_EQ(V({"b/1", "b/2", "b\xff"}),
+            keys(state_machine_->prefixRange(store, "b")));
+  EXPECT_EQ(V({"b\xff"}), keys(state_machine_->prefixRange(store, "b\xff")));
+  EXPECT_EQ(V({}), keys(state_machine_->prefixRange(store, "d")));
+  EXPECT_EQ(5, keys(state_machine_->prefixRange(store, "")).size());
+
+  EXPECT_EQ(V({"a", "b/1"}), keys(state_machine_->range(store, "", "b/2")));
+  EXPECT_EQ(V({"b/2", "b\xff", "c"}),
+            keys(state_machine_->range(store, "b/2", "z")));
+  EXPECT_EQ(V({}), keys(state_machine_->range(store, "c", "a")));
+}
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 
+#include "logdevice/common/Checksum.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/STORE_Message.h"
@@ -180,6 +181,28 @@ TEST_P(LocalLogStoreRecordFormatTest, RoundTrip) {
   }
   ASSERT_EQ(optional_keys.at(KeyType::FILTERABLE),
             optional_keys_read.at(KeyType::FILTERABLE));
+
+  // parseWithOptionalKey() points into the blob instead of copying the key.
+  folly::Optional<folly::StringPiece> filterable_key_read;
+  rv = LocalLogStoreRecordFormat::parseWithOptionalKey(log_store_blob,
+                                                       nullptr,
+                                                       nullptr,
+                                                       nullptr,
+                                                       nullptr,
+                                                       nullptr,
+                                                       nullptr,
+                                                       0,
+                                                       nullptr,
+                                                       KeyType::FILTERABLE,
+                                                       &filterable_key_read,
+                                                       &payload_read,
+                                                       -1 /* unused */);
+  ASSERT_EQ(0, rv);
+  ASSERT_TRUE(filterable_key_read.hasValue());
+  ASSERT_EQ("abcd", filterable_key_read.value());
+  ASSERT_GE(filterable_key_read->data(), blob_buf.data());
+  ASSERT_LT(filterable_key_read->data(), blob_buf.data() + blob_buf.size());
+  ASSERT_EQ("data", payload_read.toString());
   // Now get the copyset
   ShardID copyset_read[copyset_size_read];
   rv = LocalLogStoreRecordFormat::parse(log_store_blob,
@@ -284,6 +307,61 @@ TEST_P(LocalLogStoreRecordFormatTest, CSIRoundTrip) {
   ASSERT_EQ(rec_2, copyset_read[1]);
 }
 
+TEST(LocalLogStoreRecordFormatChecksumTest, CheckWellFormedBatch) {
+  using namespace LocalLogStoreRecordFormat;
+  const ShardID copyset[] = {ShardID(1, 0), ShardID(2, 0)};
+
+  std::vector<std::string> header_bufs(6);
+  std::vector<std::string> payloads(6);
+  std::vector<Slice> headers;
+  std::vector<Slice> data;
+  for (size_t i = 0; i < header_bufs.size(); ++i) {
+    // Alternate between 32-bit, 64-bit and no checksum.
+    flags_t flags = i % 3 == 0
+        ? FLAG_CHECKSUM
+        : i % 3 == 1
+            ? FLAG_CHECKSUM | FLAG_CHECKSUM_64BIT | FLAG_CHECKSUM_PARITY
+            : FLAG_CHECKSUM_PARITY;
+    headers.push_back(formRecordHeader(1000 + i,
+                                       esn_t(1),
+                                       flags,
+                                       1,
+                                       folly::range(copyset),
+                                       OffsetMap(),
+                                       std::map<KeyType, std::string>(),
+                                       &header_bufs[i]));
+    std::string payload = "payload " + std::to_string(i);
+    if (flags & FLAG_CHECKSUM) {
+      char buf[8];
+      Slice checksum =
+          checksum_bytes(Slice(payload.data(), payload.size()),
+                         (flags & FLAG_CHECKSUM_64BIT) ? 64 : 32,
+                         buf);
+      payload = std::string((const char*)checksum.data, checksum.size) +
+          payload;
+    }
+    payloads[i] = std::move(payload);
+    data.push_back(Slice(payloads[i].data(), payloads[i].size()));
+  }
+
+  size_t bad_idx = 0;
+  ASSERT_EQ(0,
+            checkWellFormedBatch(
+                headers.data(), data.data(), headers.size(), &bad_idx));
+
+  // Corrupt the payloads of a 32-bit and a 64-bit record; the first one is
+  // reported.
+  payloads[4].back() ^= 1;
+  payloads[3].back() ^= 1;
+  ASSERT_EQ(-1,
+            checkWellFormedBatch(
+                headers.data(), data.data(), headers.size(), &bad_idx));
+  EXPECT_EQ(E::CHECKSUM_MISMATCH, err);
+  EXPECT_EQ(3, bad_idx);
+  EXPECT_EQ(-1, checkWellFormed(headers[4], data[4]));
+  EXPECT_EQ(0, checkWellFormed(headers[5], data[5]));
+}
+
 INSTANTIATE_TEST_CASE_P(LocalLogStoreRecordFormatTest,
                         LocalLogStoreRecordFormatTest,
                         ::testing::Combine(::testing::Bool(),
@@ -512,6 +512,50 @@ TEST(LogsConfigCodecTest, LogsConfigTreeCodecTest3) {
   ASSERT_FALSE(lg2->attrs().scdEnabled().value());
 }
 
+TEST(LogsConfigCodecTest, LogsConfigTreeDeduplicatedOnDecode) {
+  auto tree = LogsConfigTree::create(
+      "/", DefaultLogAttributes().with_replicationFactor(2));
+  for (int i = 1; i <= 3; ++i) {
+    ASSERT_NE(nullptr,
+              tree->addLogGroup("/dir/lg" + std::to_string(i),
+                                logid_range_t{logid_t(i), logid_t(i)},
+                                LogAttributes(),
+                                true));
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  auto buffer =
+      FBuffersLogsConfigCodec::fbuffers_serialize<const LogsConfigTree&,
+                                                  fbuffers::LogsConfig>(
+          builder, *tree, false);
+  builder.Finish(buffer);
+  auto recovered =
+      FBuffersLogsConfigCodec::fbuffers_deserialize<LogsConfigTree>(
+          flatbuffers::GetRoot<fbuffers::LogsConfig>(
+              builder.GetBufferPointer()),
+          "/");
+  ASSERT_TRUE(recovered);
+  EXPECT_LT(0, recovered->registrySize());
+
+  // Log groups with equal attributes share their CommonValues.
+  auto lg1 = recovered->findLogGroup("/dir/lg1");
+  auto lg3 = recovered->findLogGroup("/dir/lg3");
+  ASSERT_NE(nullptr, lg1);
+  ASSERT_NE(nullptr, lg3);
+  EXPECT_EQ(lg1->attrs().getCommonValuesPtr(),
+            lg3->attrs().getCommonValuesPtr());
+
+  // Deduplicating again has nothing left to do: the index still points at
+  // the same nodes.
+  const size_t registry_size = recovered->registrySize();
+  recovered->deduplicateAttributes();
+  EXPECT_EQ(registry_size, recovered->registrySize());
+  const LogGroupInDirectory* lgid = recovered->getLogGroupByID(logid_t(1));
+  ASSERT_NE(nullptr, lgid);
+  EXPECT_EQ(lg1, lgid->log_group);
+  EXPECT_EQ("/dir/lg1", lgid->getFullyQualifiedName());
+}
+
 // This is disabled as it's covered by an assertion in the code
 TEST(LogsConfigCodecTest, DISABLED_InvalidPayload) {
   std::string invalid_payload = "BAD DATA IN PAYLOAD";
@@ -398,6 +398,39 @@ TEST(LogsConfigTreeTest, ImmutabilityTest) {
   ASSERT_TRUE(snapshot1->findDirectory("/normal_logs"));
 }
 
+TEST(LogsConfigTreeTest, CopySharesLogGroupsUntilModified) {
+  std::unique_ptr<LogsConfigTree> tree = LogsConfigTree::create();
+  auto dir = tree->addDirectory(
+      tree->root(), "dir", LogAttributes().with_replicationFactor(2));
+  tree->addLogGroup(dir, "lg1", logid_range_t{logid_t(1), logid_t(10)});
+  tree->addLogGroup(dir, "lg2", logid_range_t{logid_t(11), logid_t(20)});
+
+  std::unique_ptr<LogsConfigTree> snapshot = tree->copy();
+  auto snapshot_dir = snapshot->findDirectory("/dir");
+  ASSERT_NE(nullptr, snapshot_dir);
+  ASSERT_NE(dir, snapshot_dir);
+  EXPECT_EQ(&dir->logs(), &snapshot_dir->logs());
+
+  // The index of the copy points at the directories of the copy.
+  const LogGroupInDirectory* lgid = snapshot->getLogGroupByID(logid_t(15));
+  ASSERT_NE(nullptr, lgid);
+  EXPECT_EQ(snapshot_dir, lgid->parent);
+  EXPECT_EQ("/dir/lg2", lgid->getFullyQualifiedName());
+
+  // Modifying the tree doesn't affect the snapshot.
+  ASSERT_EQ(0, tree->deleteLogGroup("/dir/lg1"));
+  tree->addLogGroup(dir, "lg3", logid_range_t{logid_t(21), logid_t(30)});
+  EXPECT_NE(&dir->logs(), &snapshot_dir->logs());
+  EXPECT_EQ(2, dir->logs().size());
+  EXPECT_EQ(2, snapshot_dir->logs().size());
+  EXPECT_TRUE(snapshot->logExists(logid_t(5)));
+  EXPECT_FALSE(snapshot->logExists(logid_t(25)));
+  EXPECT_FALSE(tree->logExists(logid_t(5)));
+  EXPECT_TRUE(tree->logExists(logid_t(25)));
+  EXPECT_TRUE(snapshot->findLogGroup("/dir/lg1"));
+  EXPECT_FALSE(tree->findLogGroup("/dir/lg1"));
+}
+
 TEST(LogsConfigTreeTest, TestSnapshottingPerformance) {
   auto defaults = DefaultLogAttributes();
   std::unique_ptr<LogsConfigTree> tree = LogsConfigTree::create();
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MessagePool.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+struct Base {
+  virtual ~Base() {}
+};
+
+struct Pooled : public Base, public MessagePoolAllocated<Pooled> {
+  char data[40];
+};
+
+struct BiggerPooled : public Pooled {
+  char more[100];
+};
+
+} // namespace
+
+TEST(MessagePoolTest, ReusesFreedObjects) {
+  const size_t initial = Pooled::freeListSize();
+  Pooled* a = new Pooled();
+  std::unique_ptr<Base> b(new Pooled());
+  Base* b_ptr = b.get();
+  delete a;
+  b.reset();
+  EXPECT_EQ(initial + 2, Pooled::freeListSize());
+
+  // Most recently freed first.
+  Pooled* c = new Pooled();
+  EXPECT_EQ(b_ptr, c);
+  EXPECT_EQ(initial + 1, Pooled::freeListSize());
+  delete c;
+}
+
+TEST(MessagePoolTest, SubclassesOfDifferentSizeBypassThePool) {
+  const size_t initial = Pooled::freeListSize();
+  std::unique_ptr<Base> p(new BiggerPooled());
+  p.reset();
+  EXPECT_EQ(initial, Pooled::freeListSize());
+}
+
+TEST(MessagePoolTest, FreeListIsBoundedAndPerThread) {
+  std::thread([] {
+    EXPECT_EQ(0, Pooled::freeListSize());
+    std::vector<Pooled*> objects;
+    for (size_t i = 0; i < Pooled::kMaxFreeListSize + 10; ++i) {
+      objects.push_back(new Pooled());
+    }
+    for (Pooled* p : objects) {
+      delete p;
+    }
+    EXPECT_EQ(Pooled::kMaxFreeListSize, Pooled::freeListSize());
+  }).join();
+}
@@ -21,9 +21,13 @@
 #include "logdevice/common/protocol/APPEND_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
 #include "logdevice/common/protocol/DELETE_Message.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_Message.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_EPOCH_RECOVERY_METADATA_Message.h"
 #include "logdevice/common/protocol/GET_EPOCH_RECOVERY_METADATA_REPLY_Message.h"
 #include "logdevice/common/protocol/GET_SEQ_STATE_Message.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_Message.h"
+#include "logdevice/common/protocol/GET_TAIL_ATTRIBUTES_BULK_REPLY_Message.h"
 #include "logdevice/common/protocol/HELLO_Message.h"
 #include "logdevice/common/protocol/LOGS_CONFIG_API_Message.h"
 #include "logdevice/common/protocol/MUTATED_Message.h"
@@ -37,7 +41,10 @@
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/START_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
+#include "logdevice/common/protocol/STORED_BATCH_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/protocol/TRIMMED_BATCH_Message.h"
+#include "logdevice/common/protocol/TRIM_BATCH_Message.h"
 #include "logdevice/common/request_util.h"
 #include "logdevice/common/test/TestUtil.h"
 #include "logdevice/common/util.h"
@@ -110,13 +117,18 @@ class MessageSerializationTest : public ::testing::Test {
     ASSERT_EQ(sent.header_.nsync, recv.header_.nsync);
     ASSERT_EQ(sent.header_.copyset_offset, recv.header_.copyset_offset);
     ASSERT_EQ(sent.header_.copyset_size, recv.header_.copyset_size);
-    if (proto >= Compatibility::ProtocolVersion::STREAM_WRITER_SUPPORT) {
+    if (proto >= Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT) {
       ASSERT_EQ(sent.header_.flags, recv.header_.flags);
+      ASSERT_EQ(sent.extra_.e2e_trace_id, recv.extra_.e2e_trace_id);
     } else {
-      APPEND_flags_t flag1 = sent.header_.flags, flag2 = recv.header_.flags;
-      flag1 &= ~STORE_Header::WRITE_STREAM;
-      flag2 &= ~STORE_Header::WRITE_STREAM;
+      STORE_flags_t flag1 = sent.header_.flags, flag2 = recv.header_.flags;
+      if (proto < Compatibility::ProtocolVersion::STREAM_WRITER_SUPPORT) {
+        flag1 &= ~STORE_Header::WRITE_STREAM;
+        flag2 &= ~STORE_Header::WRITE_STREAM;
+      }
+      flag1 &= ~STORE_Header::E2E_TRACING_ON;
       ASSERT_EQ(flag1, flag2);
+      ASSERT_EQ(E2E_TRACE_ID_INVALID, recv.extra_.e2e_trace_id);
     }
     ASSERT_EQ(sent.header_.timeout_ms, recv.header_.timeout_ms);
     ASSERT_EQ(sent.header_.sequencer_node_id, recv.header_.sequencer_node_id);
@@ -165,15 +177,20 @@ class MessageSerializationTest : public ::testing::Test {
     ASSERT_EQ(m.header_.logid, m2.header_.logid);
     ASSERT_EQ(m.header_.seen, m2.header_.seen);
     ASSERT_EQ(m.header_.timeout_ms, m2.header_.timeout_ms);
-    if (proto >= Compatibility::ProtocolVersion::STREAM_WRITER_SUPPORT) {
+    if (proto >= Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT) {
       ASSERT_EQ(m.header_.flags, m2.header_.flags);
+      ASSERT_EQ(m.e2e_trace_id_, m2.e2e_trace_id_);
     } else {
       APPEND_flags_t flag1 = m.header_.flags, flag2 = m2.header_.flags;
-      flag1 &= ~(APPEND_Header::WRITE_STREAM_REQUEST |
-                 APPEND_Header::WRITE_STREAM_RESUME);
-      flag2 &= ~(APPEND_Header::WRITE_STREAM_REQUEST |
-                 APPEND_Header::WRITE_STREAM_RESUME);
+      if (proto < Compatibility::ProtocolVersion::STREAM_WRITER_SUPPORT) {
+        flag1 &= ~(APPEND_Header::WRITE_STREAM_REQUEST |
+                   APPEND_Header::WRITE_STREAM_RESUME);
+        flag2 &= ~(APPEND_Header::WRITE_STREAM_REQUEST |
+                   APPEND_Header::WRITE_STREAM_RESUME);
+      }
+      flag1 &= ~APPEND_Header::E2E_TRACING_ON;
       ASSERT_EQ(flag1, flag2);
+      ASSERT_EQ(E2E_TRACE_ID_INVALID, m2.e2e_trace_id_);
     }
     ASSERT_EQ(m.attrs_.optional_keys, m2.attrs_.optional_keys);
     ASSERT_EQ(m.attrs_.counters.has_value(), m2.attrs_.counters.has_value());
@@ -358,13 +375,17 @@ struct TestStoreMessageFactory {
   }
 
   STORE_Message message() const {
+    return message(PayloadHolder::copyString(payload_));
+  }
+
+  STORE_Message message(const PayloadHolder& payload) const {
     return STORE_Message(header_,
                          cs_.data(),
                          header_.copyset_offset,
                          0,
                          extra_,
                          optional_keys_,
-                         PayloadHolder::copyString(payload_),
+                         payload,
                          false);
   }
 
@@ -386,6 +407,9 @@ struct TestStoreMessageFactory {
     if (proto < Compatibility::STREAM_WRITER_SUPPORT) {
       flags &= ~STORE_Header::WRITE_STREAM;
     }
+    if (proto < Compatibility::E2E_TRACING_SUPPORT) {
+      flags &= ~STORE_Header::E2E_TRACING_ON;
+    }
     std::string rv = "CE0465BE038BE5C5E25152C7813ABC0F" // rid
                      "8EEC9DDEBF2549EB"                 // timestamp
                      "BBB8ECEB"                         // last_known_good
@@ -405,6 +429,9 @@ struct TestStoreMessageFactory {
 
     // Copyset, optional blobs, payload
     rv += extra_serialized_;
+    if (flags & STORE_Header::E2E_TRACING_ON) {
+      rv += hex(extra_.e2e_trace_id.val());
+    }
 
     // StoreChainLink
     rv += "010000000400008002000000050000800300000006000080";
@@ -609,6 +636,26 @@ TEST_F(MessageSerializationTest, STORE_WithFirstAmendableOffset) {
           nullptr);
 }
 
+TEST_F(MessageSerializationTest, STORE_E2ETracing) {
+  STORE_Extra extra;
+  extra.e2e_trace_id = e2e_trace_id_t(0x1234567890abcdef);
+
+  TestStoreMessageFactory factory;
+  factory.setFlags(STORE_Header::E2E_TRACING_ON);
+  factory.setExtra(extra, "");
+
+  STORE_Message m = factory.message();
+  auto check = [&](const STORE_Message& m2, uint16_t proto) {
+    checkSTORE(m, m2, proto);
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MIN_PROTOCOL_SUPPORTED,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          std::bind(&TestStoreMessageFactory::serialized, &factory, arg::_1),
+          nullptr);
+}
+
 TEST_F(MessageSerializationTest, STORE_WithWriteStreamFlagSet) {
   TestStoreMessageFactory factory;
 
@@ -626,6 +673,38 @@ TEST_F(MessageSerializationTest, STORE_WithWriteStreamFlagSet) {
           nullptr);
 }
 
+// Appender sends a STORE_Message with the same PayloadHolder to every
+// recipient. The serialized messages must reference the payload buffer rather
+// than copy it.
+TEST_F(MessageSerializationTest, STORE_PayloadSharedAcrossRecipients) {
+  TestStoreMessageFactory factory;
+  const PayloadHolder payload =
+      PayloadHolder::copyString(std::string(1024 * 1024, 'x'));
+  const uint8_t* payload_data = payload.iobuf().data();
+
+  for (int recipient = 0; recipient < 3; ++recipient) {
+    STORE_Message m = factory.message(payload);
+    std::unique_ptr<folly::IOBuf> iobuf =
+        folly::IOBuf::create(IOBUF_ALLOCATION_UNIT);
+    ProtocolWriter writer(
+        m.type_, iobuf.get(), Compatibility::MAX_PROTOCOL_SUPPORTED);
+    m.serialize(writer);
+    ASSERT_EQ(E::OK, writer.status());
+    ASSERT_GT(writer.result(), (ssize_t)payload.size());
+
+    bool found = false;
+    const folly::IOBuf* buf = iobuf.get();
+    do {
+      if (buf->data() == payload_data) {
+        EXPECT_EQ(payload.size(), buf->length());
+        found = true;
+      }
+      buf = buf->next();
+    } while (buf != iobuf.get());
+    EXPECT_TRUE(found) << "payload copied for recipient " << recipient;
+  }
+}
+
 TEST_F(MessageSerializationTest, SHUTDOWN_WithServerInstanceId) {
   SHUTDOWN_Header h = {E::SHUTDOWN, ServerInstanceId(10)};
 
@@ -878,6 +957,30 @@ TEST_F(MessageSerializationTest, APPEND) {
   }
 }
 
+TEST_F(MessageSerializationTest, APPEND_E2ETracing) {
+  APPEND_Header h = {request_id_t(0xb64a0f255e281e45),
+                     logid_t(0x3c3b4fa7a1299851),
+                     epoch_t(0xee396b50),
+                     0xed5b3efc,
+                     APPEND_Header::CHECKSUM_64BIT |
+                         APPEND_Header::E2E_TRACING_ON};
+  auto expected_fn = [](uint16_t) { return std::string(); };
+  APPEND_Message m(h,
+                   LSN_INVALID,
+                   AppendAttributes(),
+                   PayloadHolder::copyString("hello"));
+  m.e2e_trace_id_ = e2e_trace_id_t(0x1234567890abcdef);
+  auto check = [&](const APPEND_Message& m2, uint16_t proto) {
+    checkAPPEND(m, m2, proto);
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MIN_PROTOCOL_SUPPORTED,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected_fn,
+          nullptr);
+}
+
 TEST_F(MessageSerializationTest, RECORD) {
   RECORD_Header h = {
       logid_t(0xb1ae6d3809c1cdad),
@@ -1326,6 +1429,41 @@ TEST_F(MessageSerializationTest, START_num_filtered_out) {
   }
 }
 
+TEST_F(MessageSerializationTest, START_E2ETracing) {
+  START_Header h = {logid_t(0xDCC49E8FF44783D3),
+                    read_stream_id_t(0x8B49478D2C473B3A),
+                    lsn_t(5),
+                    lsn_t(13),
+                    lsn_t(8),
+                    START_Header::E2E_TRACING_ON,
+                    0,
+                    filter_version_t(1),
+                    0,
+                    0,
+                    SCDCopysetReordering::NONE,
+                    shard_index_t{0}};
+  START_Message m(h);
+  m.e2e_trace_id_ = e2e_trace_id_t(0x1234567890abcdef);
+
+  auto check = [&](const START_Message& m2, uint16_t proto) {
+    if (proto >= Compatibility::ProtocolVersion::E2E_TRACING_SUPPORT) {
+      ASSERT_EQ(m.header_.flags, m2.header_.flags);
+      ASSERT_EQ(m.e2e_trace_id_, m2.e2e_trace_id_);
+    } else {
+      ASSERT_FALSE(m2.header_.flags & START_Header::E2E_TRACING_ON);
+      ASSERT_EQ(E2E_TRACE_ID_INVALID, m2.e2e_trace_id_);
+    }
+    ASSERT_EQ(m.header_.log_id, m2.header_.log_id);
+    ASSERT_EQ(m.header_.until_lsn, m2.header_.until_lsn);
+  };
+  DO_TEST(m,
+          check,
+          Compatibility::MIN_PROTOCOL_SUPPORTED,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [](uint16_t) { return std::string(); },
+          nullptr);
+}
+
 TEST_F(MessageSerializationTest, CLEAN) {
   CLEAN_Header h = {
       logid_t(0xBBC18E8AA44783D3),
@@ -1620,4 +1758,226 @@ TEST_F(MessageSerializationTest, LOGS_CONFIG_API) {
           nullptr);
 }
 
+TEST_F(MessageSerializationTest, STORED_BATCH) {
+  std::vector<STORED_Header> headers(2);
+  headers[0].rid = RecordID(esn_t(5), epoch_t(2), logid_t(1));
+  headers[0].wave = 1;
+  headers[0].status = E::OK;
+  headers[0].redirect = NodeID();
+  headers[0].flags = STORED_Header::SYNCED;
+  headers[0].shard = 0;
+  headers[1] = headers[0];
+  headers[1].rid.esn = esn_t(6);
+  headers[1].wave = 2;
+  headers[1].flags = 0;
+  headers[1].shard = 1;
+  STORED_BATCH_Message msg(headers);
+
+  DO_TEST(msg,
+          [&](const STORED_BATCH_Message& msg2, uint16_t /*proto*/) {
+            ASSERT_EQ(headers.size(), msg2.headers_.size());
+            for (size_t i = 0; i < headers.size(); ++i) {
+              EXPECT_EQ(headers[i].rid, msg2.headers_[i].rid);
+              EXPECT_EQ(headers[i].wave, msg2.headers_[i].wave);
+              EXPECT_EQ(headers[i].status, msg2.headers_[i].status);
+              EXPECT_EQ(headers[i].redirect, msg2.headers_[i].redirect);
+              EXPECT_EQ(headers[i].flags, msg2.headers_[i].flags);
+              EXPECT_EQ(headers[i].shard, msg2.headers_[i].shard);
+            }
+          },
+          Compatibility::STORED_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "3A00000000000000050000000200000001000000000000000100000000"
+                   "0000000080010000060000000200000001000000000000000200000000"
+                   "0000000080000100";
+          },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, FINDKEY_BATCH) {
+  std::vector<FINDKEY_Header> headers(2);
+  headers[0].client_rqid = request_id_t(7);
+  headers[0].log_id = logid_t(1);
+  headers[0].timestamp = 1000;
+  headers[0].flags = FINDKEY_Header::APPROXIMATE;
+  headers[0].hint_lo = LSN_INVALID;
+  headers[0].hint_hi = LSN_MAX;
+  headers[0].timeout_ms = 500;
+  headers[0].shard = 0;
+  headers[1] = headers[0];
+  headers[1].client_rqid = request_id_t(8);
+  headers[1].log_id = logid_t(2);
+  headers[1].flags = 0;
+  headers[1].shard = 1;
+  FINDKEY_BATCH_Message msg(headers);
+
+  DO_TEST(msg,
+          [&](const FINDKEY_BATCH_Message& msg2, uint16_t /*proto*/) {
+            ASSERT_EQ(headers.size(), msg2.headers_.size());
+            for (size_t i = 0; i < headers.size(); ++i) {
+              const FINDKEY_Header& h = msg2.headers_[i];
+              EXPECT_EQ(headers[i].client_rqid, h.client_rqid);
+              EXPECT_EQ(headers[i].log_id, h.log_id);
+              EXPECT_EQ(headers[i].timestamp, h.timestamp);
+              EXPECT_EQ(headers[i].flags, h.flags);
+              EXPECT_EQ(headers[i].hint_lo, h.hint_lo);
+              EXPECT_EQ(headers[i].hint_hi, h.hint_hi);
+              EXPECT_EQ(headers[i].timeout_ms, h.timeout_ms);
+              EXPECT_EQ(headers[i].shard, h.shard);
+            }
+          },
+          Compatibility::FINDKEY_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "660000000000000007000000000000000100000000000000E803000000"
+                   "000000010000000000000000FFFFFFFFFFFFFFFFF40100000000000000"
+                   "0008000000000000000200000000000000E80300000000000000000000"
+                   "0000000000FFFFFFFFFFFFFFFFF4010000000000000100";
+          },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, FINDKEY_BATCH_REPLY) {
+  std::vector<FINDKEY_REPLY_Header> headers = {
+      {request_id_t(7), E::OK, lsn_t(10), lsn_t(12), 0},
+      {request_id_t(8), E::AGAIN, LSN_INVALID, LSN_INVALID, 1}};
+  FINDKEY_BATCH_REPLY_Message msg(headers);
+
+  DO_TEST(msg,
+          [&](const FINDKEY_BATCH_REPLY_Message& msg2, uint16_t /*proto*/) {
+            ASSERT_EQ(headers.size(), msg2.headers_.size());
+            for (size_t i = 0; i < headers.size(); ++i) {
+              const FINDKEY_REPLY_Header& h = msg2.headers_[i];
+              EXPECT_EQ(headers[i].client_rqid, h.client_rqid);
+              EXPECT_EQ(headers[i].status, h.status);
+              EXPECT_EQ(headers[i].result_lo, h.result_lo);
+              EXPECT_EQ(headers[i].result_hi, h.result_hi);
+              EXPECT_EQ(headers[i].shard, h.shard);
+            }
+          },
+          Compatibility::FINDKEY_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "3800000000000000070000000000000000000A000000000000000C0000"
+                   "0000000000000008000000000000002200000000000000000000000000"
+                   "000000000100";
+          },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, TRIM_BATCH) {
+  std::vector<TRIM_Header> headers = {
+      {request_id_t(7), logid_t(1), compose_lsn(epoch_t(1), esn_t(5)), 0},
+      {request_id_t(8), logid_t(2), compose_lsn(epoch_t(2), esn_t(10)), 1}};
+  TRIM_BATCH_Message msg(headers);
+
+  DO_TEST(msg,
+          [&](const TRIM_BATCH_Message& msg2, uint16_t /*proto*/) {
+            ASSERT_EQ(headers.size(), msg2.headers_.size());
+            for (size_t i = 0; i < headers.size(); ++i) {
+              const TRIM_Header& h = msg2.headers_[i];
+              EXPECT_EQ(headers[i].client_rqid, h.client_rqid);
+              EXPECT_EQ(headers[i].log_id, h.log_id);
+              EXPECT_EQ(headers[i].trim_point, h.trim_point);
+              EXPECT_EQ(headers[i].shard, h.shard);
+            }
+          },
+          Compatibility::TRIM_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "3400000000000000070000000000000001000000000000000500000001"
+                   "0000000000080000000000000002000000000000000A000000020000"
+                   "000100";
+          },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, TRIMMED_BATCH) {
+  std::vector<TRIMMED_Header> headers = {
+      {request_id_t(7), E::OK, 0}, {request_id_t(8), E::AGAIN, 1}};
+  TRIMMED_BATCH_Message msg(headers);
+
+  DO_TEST(msg,
+          [&](const TRIMMED_BATCH_Message& msg2, uint16_t /*proto*/) {
+            ASSERT_EQ(headers.size(), msg2.headers_.size());
+            for (size_t i = 0; i < headers.size(); ++i) {
+              const TRIMMED_Header& h = msg2.headers_[i];
+              EXPECT_EQ(headers[i].client_rqid, h.client_rqid);
+              EXPECT_EQ(headers[i].status, h.status);
+              EXPECT_EQ(headers[i].shard, h.shard);
+            }
+          },
+          Compatibility::TRIM_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "18000000000000000700000000000000000000000800000000000000"
+                   "22000100";
+          },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, GET_TAIL_ATTRIBUTES_BULK) {
+  GET_TAIL_ATTRIBUTES_BULK_Message msg(
+      request_id_t(7), {logid_t(1), logid_t(2)});
+
+  DO_TEST(msg,
+          [&](const GET_TAIL_ATTRIBUTES_BULK_Message& msg2,
+              uint16_t /*proto*/) {
+            EXPECT_EQ(request_id_t(7), msg2.request_id_);
+            EXPECT_EQ(msg.log_ids_, msg2.log_ids_);
+          },
+          Compatibility::TAIL_ATTRIBUTES_BULK_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "07000000000000001000000000000000"
+                   "01000000000000000200000000000000";
+          },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, GET_TAIL_ATTRIBUTES_BULK_REPLY) {
+  std::vector<GET_TAIL_ATTRIBUTES_BULK_REPLY_Message::Entry> entries(2);
+  entries[0].log_id = logid_t(1);
+  entries[0].status = E::OK;
+  entries[0].attributes =
+      LogTailAttributes(compose_lsn(epoch_t(3), esn_t(5)),
+                        std::chrono::milliseconds(1000),
+                        RecordOffset({{BYTE_OFFSET, 200}}));
+  // Attributes of entries with an error are not sent.
+  entries[1].log_id = logid_t(2);
+  entries[1].status = E::AGAIN;
+  entries[1].attributes.last_released_real_lsn = lsn_t(42);
+  GET_TAIL_ATTRIBUTES_BULK_REPLY_Message msg(request_id_t(7), entries);
+
+  DO_TEST(msg,
+          [&](const GET_TAIL_ATTRIBUTES_BULK_REPLY_Message& msg2,
+              uint16_t /*proto*/) {
+            EXPECT_EQ(request_id_t(7), msg2.request_id_);
+            ASSERT_EQ(2, msg2.entries_.size());
+            const auto& ok = msg2.entries_[0];
+            EXPECT_EQ(logid_t(1), ok.log_id);
+            EXPECT_EQ(E::OK, ok.status);
+            EXPECT_EQ(entries[0].attributes.last_released_real_lsn,
+                      ok.attributes.last_released_real_lsn);
+            EXPECT_EQ(entries[0].attributes.last_timestamp,
+                      ok.attributes.last_timestamp);
+            EXPECT_EQ(entries[0].attributes.offsets, ok.attributes.offsets);
+            const auto& failed = msg2.entries_[1];
+            EXPECT_EQ(logid_t(2), failed.log_id);
+            EXPECT_EQ(E::AGAIN, failed.status);
+            EXPECT_EQ(LSN_INVALID, failed.attributes.last_released_real_lsn);
+          },
+          Compatibility::TAIL_ATTRIBUTES_BULK_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [&](uint16_t /*proto*/) {
+            return "070000000000000002000000"
+                   "01000000000000000000"
+                   "0500000003000000E803000000000000"
+                   "01F6C800000000000000"
+                   "02000000000000002200";
+          },
+          nullptr);
+}
+
 }} // namespace facebook::logdevice
@@ -177,8 +177,9 @@ std::atomic<bool> SlowRequest::stall{true};
 class MockConnectThrottle : public ConnectThrottle {
  public:
   explicit MockConnectThrottle(
-      chrono_expbackoff_t<std::chrono::milliseconds> backoff_settings)
-      : ConnectThrottle(std::move(backoff_settings)),
+      chrono_expbackoff_t<std::chrono::milliseconds> backoff_settings,
+      double jitter = 0)
+      : ConnectThrottle(std::move(backoff_settings), jitter),
         current_(std::chrono::steady_clock::now()) {}
 
   std::chrono::steady_clock::time_point now() const override {
@@ -194,6 +195,29 @@ class MockConnectThrottle : public ConnectThrottle {
   std::chrono::steady_clock::time_point current_;
 };
 
+/**
+ * With jitter, delays are spread between (1 - jitter) and 1 times the
+ * backoff delay.
+ */
+TEST(MessagingTest, ConnectThrottleJitter) {
+  const auto backoff =
+      chrono_expbackoff_t<std::chrono::milliseconds>(1000, 1000, 2u);
+  std::chrono::steady_clock::duration min_delay =
+      std::chrono::milliseconds(1000);
+  std::chrono::steady_clock::duration max_delay{0};
+  for (int i = 0; i < 100; ++i) {
+    MockConnectThrottle ct(backoff, 0.5);
+    ct.connectFailed();
+    auto delay = ct.downUntil() - ct.current_;
+    EXPECT_GE(delay, std::chrono::milliseconds(500));
+    EXPECT_LE(delay, std::chrono::milliseconds(1000));
+    min_delay = std::min(min_delay, delay);
+    max_delay = std::max(max_delay, delay);
+  }
+  // Not all the same.
+  EXPECT_LT(min_delay, max_delay);
+}
+
 /**
  * Creates a ConnectThrottle and verifies that mayConnect() reports results
  * as expected for a given sequence of connectSucceeded()/Failed() calls.
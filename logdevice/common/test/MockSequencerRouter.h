@@ -95,8 +95,12 @@ class MockSequencerRouter : public SequencerRouter {
   ClusterState* getClusterState() const override {
     return cluster_state_;
   }
+  SequencerLocationCache* getSequencerLocationCache() const override {
+    return location_cache_;
+  }
 
   Settings settings_;
+  SequencerLocationCache* location_cache_{nullptr};
   void startClusterStateRefreshTimer() override {}
 
  private:
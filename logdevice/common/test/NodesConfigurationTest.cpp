@@ -13,6 +13,7 @@
 
 #include "logdevice/common/configuration/nodes/NodesConfigLegacyConverter.h"
 #include "logdevice/common/configuration/nodes/NodesConfigurationCodec.h"
+#include "logdevice/common/configuration/nodes/NodesConfigurationDelta.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/test/NodesConfigurationTestUtil.h"
 #include "logdevice/common/test/TestUtil.h"
@@ -827,6 +828,82 @@ TEST_F(NodesConfigurationTest, LegacyMetadataLogsConfigConversion) {
   }
 } // namespace
 
+std::shared_ptr<const NodesConfiguration>
+withNewCapacity(const NodesConfiguration& config, double capacity) {
+  NodesConfiguration::Update update{};
+  update.storage_config_update = std::make_unique<StorageConfig::Update>();
+  update.storage_config_update->attributes_update =
+      std::make_unique<StorageAttributeConfig::Update>();
+  update.storage_config_update->attributes_update->addNode(
+      2,
+      {StorageAttributeConfig::UpdateType::RESET,
+       std::make_unique<StorageNodeAttribute>(
+           StorageNodeAttribute{capacity,
+                                /*num_shards*/ 1,
+                                /*generation*/ 1,
+                                /*exclude_from_nodesets*/ false})});
+  return config.applyUpdate(std::move(update));
+}
+
+TEST_F(NodesConfigurationTest, Delta) {
+  auto base = provisionNodes();
+  auto target = withNewCapacity(*base, 233.0);
+  ASSERT_NE(nullptr, target);
+  ASSERT_GT(target->getVersion(), base->getVersion());
+
+  std::string delta = NodesConfigurationDelta::encode(*base, *target);
+  ASSERT_FALSE(delta.empty());
+
+  auto full = NodesConfigurationDelta::apply(*base, delta);
+  ASSERT_TRUE(full.has_value());
+  EXPECT_EQ(target->getVersion(),
+            NodesConfigurationCodec::extractConfigVersion(*full));
+  auto decoded = NodesConfigurationCodec::deserialize(*full);
+  ASSERT_NE(nullptr, decoded);
+  EXPECT_EQ(*target, *decoded);
+
+  // Wrong base version
+  EXPECT_FALSE(NodesConfigurationDelta::apply(*target, delta).has_value());
+  EXPECT_EQ(E::VERSION_MISMATCH, err);
+
+  // Right base version but different contents
+  auto impostor = withNewCapacity(*base, 1.0)->withVersion(base->getVersion());
+  EXPECT_FALSE(NodesConfigurationDelta::apply(*impostor, delta).has_value());
+  EXPECT_EQ(E::VERSION_MISMATCH, err);
+
+  EXPECT_FALSE(NodesConfigurationDelta::apply(*base, "junk").has_value());
+  EXPECT_EQ(E::BADMSG, err);
+}
+
+TEST_F(NodesConfigurationTest, DeltaHistory) {
+  NodesConfigurationHistory history;
+  history.setCapacity(2);
+  auto v1 = provisionNodes();
+  auto v2 = withNewCapacity(*v1, 2.0);
+  auto v3 = withNewCapacity(*v2, 3.0);
+
+  history.add(v1);
+  history.add(v2);
+  std::string delta = history.getDelta(v1->getVersion(), *v2);
+  ASSERT_FALSE(delta.empty());
+  EXPECT_EQ(delta, history.getDelta(v1->getVersion(), *v2));
+  EXPECT_TRUE(history.getDelta(v3->getVersion(), *v2).empty());
+
+  // Adding v3 evicts v1
+  history.add(v3);
+  EXPECT_TRUE(history.getDelta(v1->getVersion(), *v3).empty());
+  delta = history.getDelta(v2->getVersion(), *v3);
+  auto full = NodesConfigurationDelta::apply(*v2, delta);
+  ASSERT_TRUE(full.has_value());
+  auto decoded = NodesConfigurationCodec::deserialize(*full);
+  ASSERT_NE(nullptr, decoded);
+  EXPECT_EQ(*v3, *decoded);
+
+  // Older configs are ignored
+  history.add(v1);
+  EXPECT_TRUE(history.getDelta(v1->getVersion(), *v3).empty());
+}
+
 TEST_F(NodesConfigurationTest, ExtractVersionErrorEmptyString) {
   auto version = NodesConfigurationCodec::extractConfigVersion(std::string());
   ASSERT_FALSE(version.has_value());
@@ -8,6 +8,7 @@
 
 #include "logdevice/common/OffsetMap.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <thread>
@@ -71,12 +72,38 @@ TEST(OffsetMapTest, Operators) {
   ASSERT_NE(result == result_test, true);
 }
 
+TEST(OffsetMapTest, Counters) {
+  OffsetMap om;
+  om.setCounter(BYTE_OFFSET, 100);
+  om.setCounter(3, 30);
+  om.setCounter(1, 10);
+  ASSERT_EQ(3u, om.getCounterMap().size());
+  ASSERT_TRUE(std::is_sorted(
+      om.getCounterMap().begin(), om.getCounterMap().end()));
+  ASSERT_EQ(100, om.getCounter(BYTE_OFFSET));
+  ASSERT_EQ(BYTE_OFFSET_INVALID, om.getCounter(2));
+  ASSERT_EQ(OffsetMap({{1, 10}, {3, 30}, {BYTE_OFFSET, 100}}), om);
+
+  om.unsetCounter(3);
+  om.setCounter(1, BYTE_OFFSET_INVALID);
+  ASSERT_FALSE(om.isValidOffset(1));
+  ASSERT_FALSE(om.isValidOffset(3));
+  ASSERT_EQ(OffsetMap({{BYTE_OFFSET, 100}}), om);
+
+  OffsetMap other({{2, 5}, {BYTE_OFFSET, 50}});
+  om.max(other);
+  ASSERT_EQ(OffsetMap({{2, 5}, {BYTE_OFFSET, 100}}), om);
+  ASSERT_EQ(OffsetMap({{2, 0}, {BYTE_OFFSET, 50}}),
+            OffsetMap::getOffsetsDifference(om, other));
+}
+
 TEST(OffsetMapTest, AtomicTest) {
   AtomicOffsetMap atomic_offset_map;
   OffsetMap offset_map_1, offset_map_2;
   offset_map_1.setCounter(1, 10);
   offset_map_1.setCounter(2, 20);
   offset_map_2.setCounter(3, 30);
+  offset_map_2.setCounter(BYTE_OFFSET, 40);
 
   int n_loop = 10;
 
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/OpenMetrics.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <folly/String.h>
+#include <folly/io/IOBuf.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/stats/Stats.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+std::string render(const Stats& stats, bool include_log_groups) {
+  auto buf = folly::IOBuf::create(0);
+  {
+    folly::io::Appender out(buf.get(), 1024);
+    OpenMetricsWriter::write(stats, out, include_log_groups);
+  }
+  return buf->moveToFbString().toStdString();
+}
+
+} // namespace
+
+TEST(OpenMetricsTest, Format) {
+  StatsHolder holder(StatsParams().setIsServer(false));
+  STAT_ADD(&holder, records_delivered, 3);
+  TRAFFIC_CLASS_STAT_ADD(&holder, TrafficClass::READ_TAIL, messages_sent, 5);
+  LOG_GROUP_STAT_ADD(&holder, std::string("/a\"b"), append_success, 7);
+  Stats stats = holder.aggregate();
+
+  std::string text = render(stats, true);
+  std::vector<std::string> lines;
+  folly::split('\n', text, lines);
+  ASSERT_GE(lines.size(), 2);
+  EXPECT_EQ("# EOF", lines[lines.size() - 2]);
+  EXPECT_EQ("", lines.back());
+
+  std::set<std::string> line_set(lines.begin(), lines.end());
+  EXPECT_EQ(1, line_set.count("# TYPE logdevice_records_delivered unknown"));
+  EXPECT_EQ(1, line_set.count("logdevice_records_delivered 3"));
+  EXPECT_EQ(1, line_set.count("logdevice_messages_sent 5"));
+  EXPECT_EQ(
+      1,
+      line_set.count("logdevice_messages_sent{traffic_class=\"READ_TAIL\"} 5"));
+  EXPECT_EQ(1,
+            line_set.count(
+                "logdevice_append_success{log_group=\"/a\\\"b\"} 7"));
+
+  // All samples of a metric follow its TYPE line, before the next one.
+  std::set<std::string> seen;
+  std::string current;
+  for (const std::string& line : lines) {
+    if (line.empty() || line == "# EOF") {
+      continue;
+    }
+    if (line.compare(0, 7, "# TYPE ") == 0) {
+      current = line.substr(7, line.find(' ', 7) - 7);
+      EXPECT_TRUE(seen.insert(current).second) << current;
+      continue;
+    }
+    std::string metric = line.substr(0, line.find_first_of("{ "));
+    EXPECT_EQ(current, metric);
+  }
+
+  // Per-log stats are only written on request.
+  EXPECT_EQ(std::string::npos, render(stats, false).find("log_group="));
+}
@@ -25,6 +25,7 @@
 #include "logdevice/common/Semaphore.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/test/TestUtil.h"
 #include "logdevice/common/types_internal.h"
@@ -114,6 +115,52 @@ TEST_F(ProcessorTest, ThreadTargetingTest) {
   EXPECT_EQ(expected, counts);
 }
 
+/**
+ * postRequests() should route each request like postRequest() does, run the
+ * requests for each worker in order, and leave invalid ones with the caller.
+ */
+TEST_F(ProcessorTest, PostRequestsBatch) {
+  Settings settings = create_default_settings<Settings>();
+  settings.num_workers = 3;
+  auto processor = make_test_processor(settings);
+
+  std::mutex mutex;
+  std::vector<std::vector<int>> executed(3);
+  Semaphore sem;
+  std::vector<std::unique_ptr<Request>> rqs;
+  for (int i = 0; i < 30; ++i) {
+    worker_id_t target(i % 3);
+    rqs.push_back(FuncRequest::make(
+        target,
+        WorkerType::GENERAL,
+        RequestType::TEST_PROCESSOR_TARGETED_NOOP_REQUEST,
+        [&, i, target] {
+          EXPECT_EQ(target, Worker::onThisThread()->idx_);
+          std::lock_guard<std::mutex> guard(mutex);
+          executed[target.val_].push_back(i);
+          sem.post();
+        }));
+  }
+  rqs.insert(rqs.begin() + 10, nullptr);
+
+  EXPECT_EQ(30, processor->postRequests(rqs));
+  EXPECT_EQ(E::INVALID_PARAM, err);
+  for (const auto& rq : rqs) {
+    EXPECT_EQ(nullptr, rq);
+  }
+  for (int i = 0; i < 30; ++i) {
+    sem.wait();
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  for (int w = 0; w < 3; ++w) {
+    ASSERT_EQ(10, executed[w].size());
+    for (int j = 0; j < 10; ++j) {
+      EXPECT_EQ(w + j * 3, executed[w][j]);
+    }
+  }
+}
+
 struct TargetedNoopRequest : public Request {
   explicit TargetedNoopRequest(worker_id_t target)
       : Request(RequestType::TEST_PROCESSOR_TARGETED_NOOP_REQUEST),
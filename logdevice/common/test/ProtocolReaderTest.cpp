@@ -201,3 +201,42 @@ TEST_F(ProtocolReaderTest, ProtoMustBeSetToRead) {
   ASSERT_NE(0xfaceu, val);
   ASSERT_EQ(reader.status(), E::PROTO);
 }
+
+TEST_F(ProtocolReaderTest, ReadIOBufShare) {
+  auto make_buf = [] {
+    auto buf = folly::IOBuf::create(1024);
+    memset(buf->writableTail(), 'x', 1024);
+    buf->append(1024);
+    return buf;
+  };
+
+  {
+    // A small read out of a big buffer is copied by default...
+    auto buf = make_buf();
+    const void* data = buf->data();
+    ProtocolReader reader(MessageType::RECORD,
+                          std::move(buf),
+                          Compatibility::MAX_PROTOCOL_SUPPORTED);
+    reader.allowTrailingBytes();
+    folly::IOBuf out;
+    reader.readIOBuf(&out, 16);
+    ASSERT_TRUE(reader.ok());
+    ASSERT_EQ(16, out.length());
+    ASSERT_NE(data, out.data());
+  }
+  {
+    // ... and shared if requested.
+    auto buf = make_buf();
+    const void* data = buf->data();
+    ProtocolReader reader(MessageType::RECORD,
+                          std::move(buf),
+                          Compatibility::MAX_PROTOCOL_SUPPORTED);
+    reader.allowTrailingBytes();
+    folly::IOBuf out;
+    reader.readIOBuf(&out, 16, /* share */ true);
+    ASSERT_TRUE(reader.ok());
+    ASSERT_EQ(16, out.length());
+    ASSERT_EQ(data, out.data());
+    ASSERT_TRUE(out.isShared());
+  }
+}
@@ -5,8 +5,11 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <numeric>
+#include <tuple>
 #include <utility>
 
 #include <folly/Memory.h>
@@ -925,6 +928,110 @@ TEST(ConsistentHashingWeightAwareNodeSetSelectorTest, AddNode) {
   EXPECT_LE(new_totalremoved, numlogs / 2);
 }
 
+// Adding a rack should only move the nodes needed to span the new rack when
+// nodesets are selected incrementally.
+TEST(NodeSetSelectorTest, IncrementalSelection) {
+  Nodes nodes1;
+  for (int rack = 0; rack < 4; ++rack) {
+    addWeightedNodes(&nodes1, 10, 1, "a.a.a.a.rack" + toString(rack), 10);
+  }
+  Nodes nodes2 = nodes1;
+  addWeightedNodes(&nodes2, 10, 1, "a.a.a.a.rack4", 10);
+
+  Configuration::NodesConfig nodes_config1(std::move(nodes1));
+  Configuration::NodesConfig nodes_config2(std::move(nodes2));
+  ReplicationProperty replication(
+      {{NodeLocationScope::RACK, 2}, {NodeLocationScope::NODE, 3}});
+
+  const int numlogs = 100;
+  auto logs_config = std::make_shared<LocalLogsConfig>();
+  for (int i = 1; i <= numlogs; ++i) {
+    addLog(logs_config.get(), logid_t(i), replication, 0, 12);
+  }
+  auto logs_config2 = logs_config;
+
+  auto config1 = std::make_shared<Configuration>(
+      ServerConfig::fromDataTest(
+          "nodeset_selector_test", std::move(nodes_config1)),
+      std::move(logs_config));
+  auto config2 = std::make_shared<Configuration>(
+      ServerConfig::fromDataTest(
+          "nodeset_selector_test", std::move(nodes_config2)),
+      std::move(logs_config2));
+
+  NodeSetSelector::Options options;
+  options.incremental = true;
+
+  // Expected number of shards removed from and added to each nodeset.
+  // WeightAwareNodeSetSelector goes from 3 nodes in each of 4 racks to
+  // 3+3+2+2+2. RandomCrossDomainNodeSetSelector needs the same number of
+  // nodes in each rack, so it goes to 2 nodes per rack.
+  std::vector<std::tuple<NodeSetSelectorType, size_t, size_t>> cases = {
+      {NodeSetSelectorType::WEIGHT_AWARE, 2, 2},
+      {NodeSetSelectorType::CONSISTENT_HASHING, 2, 2},
+      {NodeSetSelectorType::RANDOM_CROSSDOMAIN, 4, 2},
+  };
+  for (const auto& c : cases) {
+    SCOPED_TRACE(toString(static_cast<int>(std::get<0>(c))));
+    auto selector = NodeSetSelectorFactory::create(std::get<0>(c));
+    for (int i = 1; i <= numlogs; ++i) {
+      auto res1 = selector->getStorageSet(
+          logid_t(i),
+          config1.get(),
+          *config1->getNodesConfigurationFromServerConfigSource(),
+          12,
+          0,
+          nullptr,
+          &options);
+      ASSERT_EQ(Decision::NEEDS_CHANGE, res1.decision);
+      ASSERT_EQ(12, res1.storage_set.size());
+
+      EpochMetaData meta(res1.storage_set, replication);
+      meta.nodeset_params.signature = res1.signature;
+      auto res2 = selector->getStorageSet(
+          logid_t(i),
+          config2.get(),
+          *config2->getNodesConfigurationFromServerConfigSource(),
+          12,
+          0,
+          &meta,
+          &options);
+      ASSERT_EQ(Decision::NEEDS_CHANGE, res2.decision);
+
+      StorageSet removed, added;
+      std::set_difference(res1.storage_set.begin(),
+                          res1.storage_set.end(),
+                          res2.storage_set.begin(),
+                          res2.storage_set.end(),
+                          std::back_inserter(removed));
+      std::set_difference(res2.storage_set.begin(),
+                          res2.storage_set.end(),
+                          res1.storage_set.begin(),
+                          res1.storage_set.end(),
+                          std::back_inserter(added));
+      EXPECT_EQ(std::get<1>(c), removed.size());
+      EXPECT_EQ(std::get<2>(c), added.size());
+      for (ShardID shard : added) {
+        // All added shards are in the new rack.
+        EXPECT_GE(shard.node(), 40);
+      }
+
+      // The new nodeset is stable.
+      meta.shards = res2.storage_set;
+      meta.nodeset_params.signature = res2.signature;
+      auto res3 = selector->getStorageSet(
+          logid_t(i),
+          config2.get(),
+          *config2->getNodesConfigurationFromServerConfigSource(),
+          12,
+          0,
+          &meta,
+          &options);
+      EXPECT_EQ(Decision::KEEP, res3.decision);
+    }
+  }
+}
+
 TEST(ConsistentHashingWeightAwareNodeSetSelectorTest, DisabledNodes) {
   Nodes nodes;
   addWeightedNodes(&nodes, 3, 1, "a.a.a.a.rack0", 3);
@@ -8,6 +8,8 @@
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
 
+#include "logdevice/common/MetaDataLog.h"
+#include "logdevice/common/SequencerLocationCache.h"
 #include "logdevice/common/SequencerLocator.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/test/MockSequencerRouter.h"
@@ -50,6 +52,7 @@ class SequencerRouterTest : public ::testing::Test,
         config->serverConfig()->getNodes().size());
     auto router = std::make_unique<MockSequencerRouter>(
         log_id, this, config->serverConfig(), locator_, cluster_state_.get());
+    router->location_cache_ = location_cache_.get();
     return std::move(router);
   }
 
@@ -66,6 +69,7 @@ class SequencerRouterTest : public ::testing::Test,
       next_node_;             // node the next message will be routed to
   Status status_{E::UNKNOWN}; // status of the whole operatio
   std::unique_ptr<ClusterState> cluster_state_{nullptr};
+  std::unique_ptr<SequencerLocationCache> location_cache_{nullptr};
 };
 
 // In this test, SequencerLocator ignores the list of available sequencers and
@@ -175,6 +179,78 @@ TEST_F(SequencerRouterTest, PreemptedByDeadNode) {
   EXPECT_EQ(E::NOSEQUENCER, status_);
 }
 
+// Tests that the node which accepted a message for a log is remembered, used
+// for the next request for that log (or its metadata log), and forgotten
+// once it redirects elsewhere.
+TEST_F(SequencerRouterTest, SequencerLocationCache) {
+  const NodeID N0(0, 1), N1(1, 1);
+  std::shared_ptr<const Configuration> config = createSimpleConfig(4, 1);
+  const logid_t log_id(1);
+
+  // N0 takes care of all logs by default
+  locator_ = std::make_shared<StaticLocator>(N0);
+  location_cache_ = std::make_unique<SequencerLocationCache>();
+
+  auto router = createRouter(log_id, config);
+  router->start();
+  ASSERT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+
+  // the sequencer failed over to N1
+  router->onRedirected(N0, N1, E::PREEMPTED);
+  ASSERT_EQ(std::make_pair(N1, SequencerRouter::flags_t(0)), next_node_);
+  router->onSuccess(N1);
+  EXPECT_EQ(N1, location_cache_->get(log_id));
+
+  // the next requests go to N1 directly
+  router = createRouter(MetaDataLog::metaDataLogID(log_id), config);
+  router->start();
+  EXPECT_EQ(std::make_pair(N1, SequencerRouter::flags_t(0)), next_node_);
+
+  router = createRouter(log_id, config);
+  router->start();
+  ASSERT_EQ(std::make_pair(N1, SequencerRouter::flags_t(0)), next_node_);
+
+  // N1 redirects back to N0, the entry is dropped
+  router->onRedirected(N1, N0, E::REDIRECTED);
+  ASSERT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+  EXPECT_FALSE(location_cache_->get(log_id).isNodeID());
+
+  // entries pointing to a node that is not fully started are ignored
+  location_cache_->update(log_id, N1);
+  router = createRouter(log_id, config);
+  cluster_state_->setNodeState(N1.index(), ClusterState::NodeState::DEAD);
+  router->start();
+  EXPECT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+  EXPECT_FALSE(location_cache_->get(log_id).isNodeID());
+
+  // the cache is not used if the locator doesn't allow it
+  location_cache_->update(log_id, N1);
+  std::static_pointer_cast<StaticLocator>(locator_)->can_cache_ = false;
+  router = createRouter(log_id, config);
+  router->start();
+  EXPECT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+}
+
+TEST(SequencerLocationCacheTest, NodeStateChanges) {
+  const NodeID N0(0, 1), N1(1, 1);
+  SequencerLocationCache cache;
+  cache.update(logid_t(1), N0);
+  cache.update(logid_t(2), N1);
+  cache.update(logid_t(3), N1);
+
+  // invalidate() only drops the entry if it still points to the given node
+  cache.invalidate(logid_t(1), N1);
+  EXPECT_EQ(N0, cache.get(logid_t(1)));
+
+  cache.onNodeStateChanged(N1.index(), ClusterState::NodeState::DEAD);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(N0, cache.get(logid_t(1)));
+
+  // a node coming back may be preferred by hashing again
+  cache.onNodeStateChanged(N1.index(), ClusterState::NodeState::FULLY_STARTED);
+  EXPECT_EQ(0u, cache.size());
+}
+
 // Tests if the node with the location matching the sequencerAffinity is chosen
 // as the sequencer. If there are none, it makes sure the SequencerLocator
 // still picks something.
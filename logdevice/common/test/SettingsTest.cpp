@@ -9,6 +9,7 @@
 
 #include "logdevice/common/commandline_util_chrono.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/settings/Settings.h"
 #include "logdevice/common/settings/SettingsUpdater.h"
 #include "logdevice/common/settings/UpdateableSettings.h"
 #include "logdevice/common/settings/Validators.h"
@@ -486,6 +487,37 @@ TEST_F(SettingsTest, BoolImplicitValue) {
   EXPECT_EQ(3, bundle_2->setting_3);
 }
 
+// Only the bundles in which a setting changed are republished.
+TEST_F(SettingsTest, OnlyChangedBundlesArePublished) {
+  parseFromCLI({"--bundle-1-setting-1=43"});
+
+  int bundle_1_updates = 0;
+  int bundle_2_updates = 0;
+  auto handle_1 = bundle_1.subscribeToUpdates([&]() { ++bundle_1_updates; });
+  auto handle_2 = bundle_2.subscribeToUpdates([&]() { ++bundle_2_updates; });
+  auto bundle_1_ptr = bundle_1.get();
+
+  settings.setFromAdminCmd("--bundle-2-setting-3", "6");
+  EXPECT_EQ(0, bundle_1_updates);
+  EXPECT_EQ(1, bundle_2_updates);
+  EXPECT_EQ(bundle_1_ptr, bundle_1.get());
+  EXPECT_EQ(43, bundle_1->setting_1);
+  EXPECT_EQ(6, bundle_2->setting_3);
+
+  // Setting the value a setting already has from another source doesn't
+  // change anything either.
+  ServerConfig::SettingsConfig s;
+  s["bundle-1-setting-1"] = "43";
+  settings.setFromConfig(s);
+  EXPECT_EQ(0, bundle_1_updates);
+  EXPECT_EQ(1, bundle_2_updates);
+
+  settings.unsetFromAdminCmd("bundle-2-setting-3");
+  EXPECT_EQ(0, bundle_1_updates);
+  EXPECT_EQ(2, bundle_2_updates);
+  EXPECT_EQ(3, bundle_2->setting_3);
+}
+
 TEST(SettingsTest_, DefaultsInConstructor) {
   Bundle1 b = create_default_settings<Bundle1>();
   b.setting_1 = 1337;
@@ -575,4 +607,30 @@ TEST(SettingsTest_, OverrideDefaults) {
   }
 }
 
+TEST(SettingsTest_, RequestsPerIterationByWorkerType) {
+  UpdateableSettings<Settings> s;
+  SettingsUpdater up;
+  up.registerSettings(s);
+  up.setFromCLI({{"execute-requests", "13"},
+                 {"mid_requests_per_iteration", "2"},
+                 {"lo_requests_per_iteration", "1"}});
+
+  using Counts = std::array<uint32_t, 3>;
+  EXPECT_EQ((Counts{13, 2, 1}), s->requestsPerIteration(WorkerType::GENERAL));
+  EXPECT_EQ((Counts{13, 2, 1}),
+            s->requestsPerIteration(WorkerType::FAILURE_DETECTOR));
+
+  up.setFromAdminCmd("requests-per-iteration-by-worker-type", "F:40:8:1");
+  EXPECT_EQ((Counts{13, 2, 1}), s->requestsPerIteration(WorkerType::GENERAL));
+  EXPECT_EQ((Counts{40, 8, 1}),
+            s->requestsPerIteration(WorkerType::FAILURE_DETECTOR));
+
+  for (const char* bad : {"F:40:8", "X:1:1:1", "F:1:0:1", "F:1:1:1,F:2:2:2"}) {
+    EXPECT_THROW(
+        up.setFromAdminCmd("requests-per-iteration-by-worker-type", bad),
+        boost::program_options::error)
+        << bad;
+  }
+}
+
 }} // namespace facebook::logdevice
@@ -10,6 +10,7 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <unistd.h>
@@ -116,6 +117,60 @@ TEST(StatsTest, MultipleThreadsTest) {
   EXPECT_EQ(nthreads, total.store_synced);
 }
 
+// Per-log stats of several threads, some of which have exited, are merged by
+// log group.
+TEST(StatsTest, PerLogStatsMultipleThreadsTest) {
+  StatsHolder holder(StatsParams().setIsServer(true));
+  constexpr int nthreads = 8;
+
+  EXPECT_EQ(PerLogStats::slotFor("a"), PerLogStats::slotFor("a"));
+  EXPECT_NE(PerLogStats::slotFor("a"), PerLogStats::slotFor("b"));
+
+  Semaphore started, finish;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&, i] {
+      LOG_GROUP_STAT_ADD(&holder, std::string("a"), append_success, 1);
+      // Only half of the threads see log group "b", in different orders.
+      if (i % 2) {
+        LOG_GROUP_STAT_ADD(&holder, std::string("b"), append_success, i);
+        LOG_GROUP_STAT_ADD(&holder, std::string("c"), append_failed, 1);
+      } else {
+        LOG_GROUP_STAT_ADD(&holder, std::string("c"), append_failed, 1);
+      }
+      // The second half of the threads stays alive until stats are collected.
+      if (i >= nthreads / 2) {
+        started.post();
+        finish.wait();
+      }
+    });
+    if (i < nthreads / 2) {
+      threads.back().join();
+    }
+  }
+  for (int i = nthreads / 2; i < nthreads; ++i) {
+    started.wait();
+  }
+
+  Stats total = holder.aggregate();
+  for (int i = nthreads / 2; i < nthreads; ++i) {
+    finish.post();
+  }
+  for (int i = nthreads / 2; i < nthreads; ++i) {
+    threads[i].join();
+  }
+
+  auto per_log = total.synchronizedCopy(&Stats::per_log_stats);
+  std::map<std::string, std::pair<int64_t, int64_t>> values;
+  for (const auto& kv : per_log) {
+    EXPECT_EQ(PerLogStats::slotFor(kv.first), kv.second->slot);
+    values[kv.first] = {kv.second->append_success, kv.second->append_failed};
+  }
+  std::map<std::string, std::pair<int64_t, int64_t>> expected = {
+      {"a", {nthreads, 0}}, {"b", {1 + 3 + 5 + 7, 0}}, {"c", {0, nthreads}}};
+  EXPECT_EQ(expected, values);
+}
+
 TEST(StatsTest, LatencyPercentileTest) {
   FastUpdateableSharedPtr<StatsParams> params(std::make_shared<StatsParams>());
   Stats s(&params);
@@ -244,6 +299,89 @@ TEST(StatsTest, HistogramConcurrencyTest) {
   }
 }
 
+TEST(StatsTest, SketchHistogramPercentiles) {
+  SketchLatencyHistogram hist;
+  // 1..100000, uniformly.
+  for (int64_t v = 1; v <= 100000; ++v) {
+    hist.add(v);
+  }
+  // Values span more than kMaxBuckets buckets, so the lowest buckets get
+  // collapsed and low percentiles are off. Higher ones are accurate.
+  std::array<double, 4> pct = {.5, .9, .99, 1};
+  std::array<int64_t, 4> out;
+  uint64_t count;
+  int64_t sum;
+  hist.estimatePercentiles(&pct[0], pct.size(), &out[0], &count, &sum);
+  EXPECT_EQ(100000, count);
+  EXPECT_EQ(100000l * 100001 / 2, sum);
+  for (size_t i = 0; i < pct.size(); ++i) {
+    double expected = pct[i] * 100000;
+    EXPECT_NEAR(expected,
+                out[i],
+                expected * SketchHistogram::kRelativeAccuracy + 1)
+        << pct[i];
+  }
+  EXPECT_EQ(SketchHistogram::kMaxBuckets, hist.numBuckets());
+
+  SketchLatencyHistogram empty;
+  EXPECT_EQ(0, empty.numBuckets());
+  EXPECT_EQ(0, empty.estimatePercentile(.5));
+}
+
+TEST(StatsTest, SketchHistogramMergeAndSubtract) {
+  SketchLatencyHistogram a, b;
+  for (int i = 0; i < 100; ++i) {
+    a.add(1000);
+    b.add(1000000);
+  }
+  b.add(0);
+
+  SketchLatencyHistogram total;
+  total.merge(a);
+  total.merge(b);
+  EXPECT_EQ(201, total.getCountAndSum().first);
+  EXPECT_NEAR(1000, total.estimatePercentile(.25), 20);
+  EXPECT_NEAR(1000000, total.estimatePercentile(.75), 20000);
+
+  total.subtract(a);
+  EXPECT_EQ(b.getCountAndSum(), total.getCountAndSum());
+  EXPECT_NEAR(1000000, total.estimatePercentile(.25), 20000);
+  EXPECT_EQ(1, total.numBuckets());
+
+  SketchLatencyHistogram copy(total);
+  EXPECT_EQ(total.getCountAndSum(), copy.getCountAndSum());
+}
+
+// Per-log histograms of all threads are merged by StatsHolder::aggregate().
+TEST(StatsTest, PerLogHistogramsTest) {
+  StatsHolder holder(StatsParams().setIsServer(true));
+  constexpr int nthreads = 4;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&holder, i] {
+      for (int j = 0; j < 100; ++j) {
+        LOG_GROUP_HISTOGRAM_ADD(
+            &holder, append_latency, std::string("a"), 1000 * (i + 1));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  Stats total = holder.aggregate();
+  auto per_log = total.synchronizedCopy(&Stats::per_log_stats);
+  ASSERT_EQ(1, per_log.size());
+  EXPECT_EQ("a", per_log[0].first);
+  const auto& hist = per_log[0].second->append_latency;
+  ASSERT_NE(nullptr, hist);
+  EXPECT_EQ(nullptr, per_log[0].second->write_to_read_latency);
+  EXPECT_EQ(nthreads * 100, hist->getCountAndSum().first);
+  EXPECT_NEAR(4000, hist->estimatePercentile(.99), 80);
+  EXPECT_NEAR(1000, hist->estimatePercentile(.1), 20);
+}
+
 TEST(StatsTest, CompactLatencyHistogramShouldGetFrequencyCounters) {
   constexpr auto min_value = std::numeric_limits<int64_t>::min();
   constexpr auto max_value = std::numeric_limits<int64_t>::max();
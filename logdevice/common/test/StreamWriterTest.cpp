@@ -93,6 +93,7 @@ class TestStreamWriterAppendSink : public StreamWriterAppendSink {
       std::unordered_map<epoch_t, StreamStatePerSequencer, epoch_t::Hash>;
 
   epoch_t seen_epoch = EPOCH_INVALID;
+  size_t backlog_threshold = 0;
   MessageLog message_log;
   RequestsQueue incoming_queue;
   StreamState stream_state;
@@ -286,6 +287,10 @@ class TestStreamWriterAppendSink : public StreamWriterAppendSink {
     return MAX_PAYLOAD_SIZE_PUBLIC;
   }
 
+  size_t getBacklogThreshold() noexcept override {
+    return backlog_threshold;
+  }
+
   std::chrono::milliseconds getAppendRetryTimeout() noexcept override {
     return std::chrono::milliseconds(10000);
   }
@@ -814,3 +819,42 @@ TEST_F(StreamWriterAppendSinkTest,
   ASSERT_EQ(7UL, test_sink_->getMaxPrefixAckedSeqNum(logid).val());
   ASSERT_EQ(7UL, test_sink_->getMaxAckedSeqNum(logid).val());
 }
+
+// The sink reports a backlog once the stream has backlog_threshold appends
+// that aren't part of the acked prefix, and clears it as they get acked.
+TEST_F(StreamWriterAppendSinkTest, Backlogged) {
+  int num_msg_received = 0;
+  auto callback = [&num_msg_received](
+                      Status status, const DataRecord&, NodeID) {
+    ASSERT_EQ(Status::OK, status);
+    num_msg_received++;
+  };
+
+  logid_t logid(1UL);
+  ASSERT_FALSE(test_sink_->isBacklogged(logid));
+  std::vector<TestCommand> cmds;
+  cmds.push_back(TestCommand::create(ACCEPT, "a"));
+  cmds.push_back(
+      TestCommand::create(REJECT_ONCE, "b").addArg(toString(E::CONNFAILED)));
+  cmds.push_back(TestCommand::create(ACCEPT, "c"));
+  for (auto& cmd : cmds) {
+    appendHelper(logid, cmd, callback);
+  }
+  // Disabled by default.
+  ASSERT_FALSE(test_sink_->isBacklogged(logid));
+
+  test_sink_->backlog_threshold = 3;
+  ASSERT_TRUE(test_sink_->isBacklogged(logid));
+  ASSERT_FALSE(test_sink_->isBacklogged(logid_t(2UL)));
+
+  test_sink_->processTestRequests(false);
+  // "a" is acked, "b" is waiting for a retry and holds "c" back.
+  ASSERT_EQ(1, num_msg_received);
+  ASSERT_FALSE(test_sink_->isBacklogged(logid));
+  test_sink_->backlog_threshold = 2;
+  ASSERT_TRUE(test_sink_->isBacklogged(logid));
+
+  test_sink_->processTestRequests();
+  ASSERT_EQ(3, num_msg_received);
+  ASSERT_FALSE(test_sink_->isBacklogged(logid));
+}
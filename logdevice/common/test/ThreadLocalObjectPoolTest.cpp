@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/ThreadLocalObjectPool.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+constexpr size_t kMaxCached = 4;
+
+struct Pooled {
+  virtual ~Pooled() = default;
+
+  static void* operator new(size_t size) {
+    return ThreadLocalObjectPool<Pooled, kMaxCached>::allocate(size);
+  }
+  static void operator delete(void* p, size_t size) {
+    ThreadLocalObjectPool<Pooled, kMaxCached>::deallocate(p, size);
+  }
+
+  char data[100];
+};
+
+struct PooledSubclass : public Pooled {
+  char more_data[100];
+};
+
+using Pool = ThreadLocalObjectPool<Pooled, kMaxCached>;
+
+} // namespace
+
+TEST(ThreadLocalObjectPoolTest, ReusesFreedBlocks) {
+  // Each test runs on a fresh thread so that the free list starts empty.
+  std::thread([] {
+    auto* a = new Pooled();
+    void* addr = a;
+    delete a;
+    EXPECT_EQ(1, Pool::cachedOnThisThread());
+    auto* b = new Pooled();
+    EXPECT_EQ(addr, b);
+    EXPECT_EQ(0, Pool::cachedOnThisThread());
+    delete b;
+  }).join();
+}
+
+TEST(ThreadLocalObjectPoolTest, SubclassesBypassThePool) {
+  std::thread([] {
+    std::unique_ptr<Pooled> p = std::make_unique<PooledSubclass>();
+    p.reset();
+    EXPECT_EQ(0, Pool::cachedOnThisThread());
+  }).join();
+}
+
+TEST(ThreadLocalObjectPoolTest, CachesAtMostMaxCached) {
+  std::thread([] {
+    std::vector<std::unique_ptr<Pooled>> objects;
+    for (size_t i = 0; i < kMaxCached * 2; ++i) {
+      objects.push_back(std::make_unique<Pooled>());
+    }
+    objects.clear();
+    EXPECT_EQ(kMaxCached, Pool::cachedOnThisThread());
+  }).join();
+}
+
+TEST(ThreadLocalObjectPoolTest, FreedOnOtherThread) {
+  std::unique_ptr<Pooled> p;
+  std::thread([&] { p = std::make_unique<Pooled>(); }).join();
+  std::thread([&] {
+    p.reset();
+    EXPECT_EQ(1, Pool::cachedOnThisThread());
+  }).join();
+}
+
+TEST(ThreadLocalObjectPoolTest, Disabled) {
+  std::thread([] {
+    Pool::setEnabled(false);
+    delete new Pooled();
+    EXPECT_EQ(0, Pool::cachedOnThisThread());
+    Pool::setEnabled(true);
+  }).join();
+}
+
+}} // namespace facebook::logdevice
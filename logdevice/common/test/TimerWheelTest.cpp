@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TimerWheel.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace std::chrono;
+using Clock = TimerWheel::Clock;
+
+namespace {
+
+class TestTimeout : public TimerWheel::Timeout {
+ public:
+  explicit TestTimeout(std::function<void()> cb = nullptr)
+      : cb_(std::move(cb)) {}
+
+  int fired = 0;
+
+ protected:
+  void timeoutExpired() override {
+    ++fired;
+    if (cb_) {
+      cb_();
+    }
+  }
+
+ private:
+  std::function<void()> cb_;
+};
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  const Clock::time_point start_ = Clock::now();
+  std::vector<Clock::time_point> wake_ups_;
+  TimerWheel wheel_{milliseconds(1),
+                    [this](Clock::time_point t) { wake_ups_.push_back(t); },
+                    start_};
+
+  Clock::time_point at(microseconds us) const {
+    return start_ + us;
+  }
+};
+
+} // namespace
+
+TEST_F(TimerWheelTest, FiresNotEarlyAndWithinATick) {
+  TestTimeout t;
+  wheel_.schedule(t, microseconds(2500), at(microseconds(0)));
+  EXPECT_TRUE(t.isScheduled());
+  EXPECT_EQ(1, wheel_.size());
+  ASSERT_EQ(1, wake_ups_.size());
+  EXPECT_EQ(at(milliseconds(3)), wake_ups_.back());
+
+  EXPECT_EQ(0, wheel_.advance(at(microseconds(2499))));
+  EXPECT_EQ(0, t.fired);
+  EXPECT_EQ(1, wheel_.advance(at(milliseconds(3))));
+  EXPECT_EQ(1, t.fired);
+  EXPECT_FALSE(t.isScheduled());
+  EXPECT_EQ(0, wheel_.size());
+  EXPECT_EQ(Clock::time_point::max(), wheel_.nextWakeUp());
+}
+
+TEST_F(TimerWheelTest, ZeroDelayFiresOnNextAdvance) {
+  TestTimeout t;
+  wheel_.schedule(t, microseconds(0), at(microseconds(10)));
+  EXPECT_LE(wheel_.nextWakeUp(), at(microseconds(10)));
+  EXPECT_EQ(1, wheel_.advance(at(microseconds(10))));
+  EXPECT_EQ(1, t.fired);
+}
+
+TEST_F(TimerWheelTest, CancelAndReschedule) {
+  TestTimeout a, b;
+  wheel_.schedule(a, milliseconds(5), at(microseconds(0)));
+  wheel_.schedule(b, milliseconds(5), at(microseconds(0)));
+  a.cancelTimeout();
+  EXPECT_FALSE(a.isScheduled());
+  EXPECT_EQ(1, wheel_.size());
+
+  // Rescheduling replaces the previous deadline.
+  wheel_.schedule(b, milliseconds(20), at(microseconds(0)));
+  EXPECT_EQ(1, wheel_.size());
+  EXPECT_EQ(0, wheel_.advance(at(milliseconds(10))));
+  EXPECT_EQ(1, wheel_.advance(at(milliseconds(20))));
+  EXPECT_EQ(0, a.fired);
+  EXPECT_EQ(1, b.fired);
+}
+
+TEST_F(TimerWheelTest, DestroyingScheduledTimeoutCancelsIt) {
+  auto t = std::make_unique<TestTimeout>();
+  wheel_.schedule(*t, milliseconds(5), at(microseconds(0)));
+  t.reset();
+  EXPECT_EQ(0, wheel_.size());
+  EXPECT_EQ(0, wheel_.advance(at(milliseconds(10))));
+}
+
+// Timeouts in higher levels must be cascaded down and fire on time, including
+// ones beyond the range of the wheel.
+TEST_F(TimerWheelTest, LongDelays) {
+  const std::vector<milliseconds> delays{milliseconds(255),
+                                         milliseconds(256),
+                                         milliseconds(1000),
+                                         milliseconds(70000),
+                                         milliseconds(20000000),
+                                         hours(24 * 60)};
+  std::vector<std::unique_ptr<TestTimeout>> timeouts;
+  for (auto delay : delays) {
+    timeouts.push_back(std::make_unique<TestTimeout>());
+    wheel_.schedule(*timeouts.back(), delay, at(microseconds(100)));
+  }
+  for (size_t i = 0; i < delays.size(); ++i) {
+    // Advance in big steps the way an idle worker woken up at nextWakeUp()
+    // would, but never past the deadline.
+    Clock::time_point deadline = at(microseconds(100)) + delays[i];
+    while (wheel_.nextWakeUp() < deadline - milliseconds(1)) {
+      wheel_.advance(wheel_.nextWakeUp());
+    }
+    wheel_.advance(deadline - milliseconds(1));
+    EXPECT_EQ(0, timeouts[i]->fired) << i;
+    wheel_.advance(deadline + milliseconds(1));
+    EXPECT_EQ(1, timeouts[i]->fired) << i;
+  }
+  EXPECT_EQ(0, wheel_.size());
+}
+
+TEST_F(TimerWheelTest, CallbacksCanScheduleAndCancel) {
+  TestTimeout other;
+  TestTimeout rescheduled;
+  TestTimeout t([&] {
+    other.cancelTimeout();
+    wheel_.schedule(rescheduled, milliseconds(1), at(milliseconds(1)));
+  });
+  wheel_.schedule(t, milliseconds(1), at(microseconds(0)));
+  wheel_.schedule(other, milliseconds(1), at(microseconds(0)));
+
+  // `other` expires in the same batch as `t` but is cancelled by it first.
+  EXPECT_EQ(1, wheel_.advance(at(milliseconds(1))));
+  EXPECT_EQ(1, t.fired);
+  EXPECT_EQ(0, other.fired);
+  EXPECT_TRUE(rescheduled.isScheduled());
+  EXPECT_EQ(at(milliseconds(2)), wake_ups_.back());
+  EXPECT_EQ(1, wheel_.advance(at(milliseconds(2))));
+  EXPECT_EQ(1, rescheduled.fired);
+}
+
+TEST_F(TimerWheelTest, WakeUpRequestedOnlyWhenEarlier) {
+  TestTimeout a, b, c;
+  wheel_.schedule(a, milliseconds(10), at(microseconds(0)));
+  wheel_.schedule(b, milliseconds(20), at(microseconds(0)));
+  EXPECT_EQ(1, wake_ups_.size());
+  wheel_.schedule(c, milliseconds(5), at(microseconds(0)));
+  ASSERT_EQ(2, wake_ups_.size());
+  EXPECT_EQ(at(milliseconds(5)), wake_ups_.back());
+}
+
+TEST_F(TimerWheelTest, DestroyWheelWithPendingTimeouts) {
+  TestTimeout t;
+  {
+    TimerWheel wheel(milliseconds(1), nullptr, start_);
+    wheel.schedule(t, milliseconds(5), start_);
+  }
+  EXPECT_FALSE(t.isScheduled());
+  t.cancelTimeout();
+}
@@ -169,6 +169,9 @@ class WeightedCopySetSelectorTest : public ::testing::Test {
 
   // If true, we'll pass `*chain_out = false` to select().
   bool test_disabling_chain_ = false;
+
+  // Passed to the WeightedCopySetSelector constructor.
+  size_t copyset_table_size_ = 0;
 };
 
 } // namespace
@@ -276,7 +279,8 @@ WeightedCopySetSelectorTest::getSelector(logid_t log,
       &stats,
       rng_,
       /* print_bias_warnings */ true,
-      &deps_);
+      &deps_,
+      copyset_table_size_);
   return *s.selector;
 }
 
@@ -824,6 +828,37 @@ TEST_F(WeightedCopySetSelectorTest, Unblacklisting) {
   EXPECT_EQ(std::vector<ShardID>({N2, N0}), cs);
 }
 
+TEST_F(WeightedCopySetSelectorTest, CopySetTable) {
+  addNodes("rg.dc.cl.ro.rk0", {1, 1, 1});
+  addNodes("rg.dc.cl.ro.rk1", {1, 1, 1});
+  replication_ = ReplicationProperty({{S::RACK, 2}, {S::NODE, 3}});
+  copyset_table_size_ = 8;
+  std::vector<ShardID> cs;
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(CopySetSelector::Result::SUCCESS, select(cs));
+  }
+  EXPECT_EQ(100, stats.get().copyset_selected);
+  EXPECT_EQ(100, stats.get().copyset_selected_from_table);
+
+  // Copysets with the unavailable node are dropped from the table.
+  deps_.setNotAvailableNodes({N0});
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(CopySetSelector::Result::SUCCESS, select(cs));
+    EXPECT_EQ(0, std::count(cs.begin(), cs.end(), N0));
+  }
+
+  // And come back once the node is available again.
+  deps_.setNotAvailableNodes({});
+  bool picked_n0 = false;
+  for (int i = 0; i < 100 && !picked_n0; ++i) {
+    ASSERT_EQ(CopySetSelector::Result::SUCCESS, select(cs));
+    picked_n0 = std::count(cs.begin(), cs.end(), N0);
+  }
+  EXPECT_TRUE(picked_n0);
+  EXPECT_EQ(0, stats.get().copyset_selection_failed);
+}
+
 TEST_F(WeightedCopySetSelectorTest, Augment) {
   addNodes("rg.dc.cl.ro.rk0", {1, 1, 1, 1});
   addNodes("rg.dc.cl.ro.rk1", {1, 1, 1});
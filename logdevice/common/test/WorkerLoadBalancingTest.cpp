@@ -82,4 +82,44 @@ TEST(WorkerLoadBalancingTest, NewWorkRebalances) {
   ASSERT_LT(after_ratio, 2.2);
 }
 
+// Workers are parked one at a time while the rest can absorb their load,
+// unparked one at a time when active workers are busy, and parked workers
+// don't get selected.
+TEST(WorkerLoadBalancingTest, ParkAndUnpark) {
+  const int N = 4;
+  WorkerLoadBalancing balancer(N);
+  auto report = [&](int64_t load) {
+    for (int i = 0; i < N; ++i) {
+      balancer.reportLoad(worker_id_t(i), load);
+    }
+  };
+  EXPECT_EQ(N, balancer.activeWorkers());
+
+  // Disabled, nothing changes however idle the workers are.
+  report(0);
+  EXPECT_EQ(N, balancer.adjustActiveWorkers(0, 200, 700));
+
+  // 4 workers at 100 each fit into 3 and then 2 workers below 200, but not 1.
+  report(100);
+  EXPECT_EQ(3, balancer.adjustActiveWorkers(1, 200, 700));
+  EXPECT_EQ(2, balancer.adjustActiveWorkers(1, 200, 700));
+  EXPECT_EQ(2, balancer.adjustActiveWorkers(1, 200, 700));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_LT(balancer.selectWorker().val_, 2);
+  }
+
+  // Never below the minimum.
+  report(0);
+  EXPECT_EQ(1, balancer.adjustActiveWorkers(1, 200, 700));
+  EXPECT_EQ(1, balancer.adjustActiveWorkers(1, 200, 700));
+  EXPECT_EQ(W0, balancer.selectWorker());
+  EXPECT_EQ(2, balancer.adjustActiveWorkers(2, 200, 700));
+
+  // Busy, unpark.
+  report(800);
+  EXPECT_EQ(3, balancer.adjustActiveWorkers(2, 200, 700));
+  EXPECT_EQ(4, balancer.adjustActiveWorkers(2, 200, 700));
+  EXPECT_EQ(4, balancer.adjustActiveWorkers(2, 200, 700));
+}
+
 }} // namespace facebook::logdevice
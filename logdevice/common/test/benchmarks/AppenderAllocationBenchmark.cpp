@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/Appender.h"
+#include "logdevice/common/PayloadHolder.h"
+#include "logdevice/common/ThreadLocalObjectPool.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: allocation cost of the objects every append creates on the
+ *        sequencer: an Appender and one STORE_Message per copy, with and
+ *        without ThreadLocalObjectPool.
+ *
+ *        Each thread keeps --appends-in-flight appends alive and retires the
+ *        oldest one whenever it starts a new one, so that blocks are reused
+ *        in the order a sequencer with a full sliding window would reuse
+ *        them. One iteration is one append; with --threads standing in for
+ *        workers, a result of 1M iters/s or more means allocation alone can
+ *        sustain 1M appends/sec on that many workers.
+ */
+
+DEFINE_int32(threads, 16, "Number of threads creating appends concurrently.");
+DEFINE_int32(appends_in_flight,
+             1000,
+             "Number of appends each thread keeps alive at any time.");
+DEFINE_int32(copies, 3, "Number of STORE messages per append.");
+DEFINE_int32(payload_size, 100, "Payload size of appends, in bytes.");
+
+namespace {
+
+struct InFlightAppend {
+  std::unique_ptr<Appender> appender;
+  std::vector<std::unique_ptr<STORE_Message>> stores;
+};
+
+class AppendFactory {
+ public:
+  AppendFactory()
+      : payload_(PayloadHolder::copyString(
+            std::string(FLAGS_payload_size, 'x'))) {
+    header_.rid = RecordID(lsn_t(1), logid_t(1));
+    header_.timestamp = 0;
+    header_.last_known_good = ESN_INVALID;
+    header_.wave = 1;
+    header_.flags = 0;
+    header_.nsync = 0;
+    header_.copyset_offset = 0;
+    header_.copyset_size = FLAGS_copies;
+    header_.timeout_ms = 0;
+    header_.sequencer_node_id = NodeID(0, 1);
+    for (int i = 0; i < FLAGS_copies; ++i) {
+      copyset_.push_back(StoreChainLink{ShardID(i + 1, 0), ClientID()});
+    }
+  }
+
+  void make(InFlightAppend& out, size_t id) const {
+    using Keys = std::map<KeyType, std::string>;
+    out.appender = std::make_unique<Appender>(nullptr,
+                                              nullptr,
+                                              std::chrono::milliseconds(1000),
+                                              request_id_t(id),
+                                              STORE_flags_t(0),
+                                              logid_t(1),
+                                              AppendAttributes(),
+                                              payload_,
+                                              ClientID(),
+                                              EPOCH_MIN,
+                                              FLAGS_payload_size,
+                                              LSN_INVALID);
+    out.stores.clear();
+    for (int i = 0; i < FLAGS_copies; ++i) {
+      out.stores.push_back(std::make_unique<STORE_Message>(header_,
+                                                           copyset_.data(),
+                                                           i,
+                                                           STORE_flags_t(0),
+                                                           STORE_Extra(),
+                                                           Keys(),
+                                                           payload_,
+                                                           true));
+    }
+  }
+
+ private:
+  const PayloadHolder payload_;
+  STORE_Header header_;
+  std::vector<StoreChainLink> copyset_;
+};
+
+void setPooled(bool pooled) {
+  ThreadLocalObjectPool<Appender>::setEnabled(pooled);
+  ThreadLocalObjectPool<STORE_Message>::setEnabled(pooled);
+}
+
+void runAppends(size_t n, bool pooled) {
+  const size_t nthreads = std::max(1, FLAGS_threads);
+  const size_t per_thread = (n + nthreads - 1) / nthreads;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t ready = 0;
+  bool go = false;
+
+  BENCHMARK_SUSPEND {
+    setPooled(pooled);
+    for (size_t t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&] {
+        AppendFactory factory;
+        std::vector<InFlightAppend> window(FLAGS_appends_in_flight);
+        // Warm up: fill the window, and the free lists when pooled.
+        for (size_t i = 0; i < window.size(); ++i) {
+          factory.make(window[i], i);
+        }
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          ++ready;
+          cv.notify_all();
+          cv.wait(lock, [&] { return go; });
+        }
+        for (size_t i = 0; i < per_thread; ++i) {
+          factory.make(window[i % window.size()], i);
+        }
+        folly::doNotOptimizeAway(window.data());
+        // Destroying the window when the thread exits is measured too, but
+        // it's small next to per_thread appends.
+      });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return ready == nthreads; });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    go = true;
+  }
+  cv.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  BENCHMARK_SUSPEND {
+    setPooled(true);
+  }
+}
+
+} // namespace
+
+BENCHMARK(AppendAllocationMalloc, n) {
+  runAppends(n, false);
+}
+
+BENCHMARK_RELATIVE(AppendAllocationPooled, n) {
+  runAppends(n, true);
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
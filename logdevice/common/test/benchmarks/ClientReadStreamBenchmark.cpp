@@ -0,0 +1,532 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/EpochMetaData.h"
+#include "logdevice/common/MetaDataLogReader.h"
+#include "logdevice/common/PayloadHolder.h"
+#include "logdevice/common/ShardAuthoritativeStatusMap.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
+#include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/STARTED_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/util.h"
+#include "logdevice/common/test/MockBackoffTimer.h"
+#include "logdevice/common/test/MockTimer.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: CPU cost of ClientReadStream turning RECORD and GAP messages from
+ *        storage shards into an ordered stream of records, without sockets,
+ *        Workers or storage nodes: ClientReadStreamDependencies are stubbed
+ *        and the messages are generated upfront.
+ *
+ *        Record i is stored on --replication shards starting at i % senders.
+ *        In all-send-all mode every copy is sent, in SCD only the first one.
+ *        Messages are sent in batches of --batch LSNs, either in LSN order or
+ *        by one shard after another (so records arrive ahead of the ones
+ *        before them and have to be buffered). In the Holes benchmarks every
+ *        --hole-every-th LSN has no record and each shard closes every batch
+ *        with a NO_RECORDS gap, so the holes are found by gap detection.
+ *
+ *        One iteration is one LSN, so iters/s is records (or holes) per second
+ *        delivered by one read stream on one thread. When run standalone, the
+ *        number of heap allocations per LSN of each case is printed after the
+ *        benchmarks.
+ */
+
+DEFINE_int32(senders, 6, "Number of storage shards the stream reads from.");
+DEFINE_int32(replication, 3, "Number of copies of each record.");
+DEFINE_int32(batch, 16, "Number of LSNs in each batch of messages.");
+DEFINE_int32(hole_every, 4, "In Holes benchmarks, every Nth LSN is a hole.");
+DEFINE_int32(payload_size, 100, "Payload size of records, in bytes.");
+DEFINE_int32(buffer_size, 512, "Size of the read stream's buffer, in LSNs.");
+DEFINE_int32(alloc_records,
+             100000,
+             "Number of LSNs to deliver when counting allocations.");
+
+#ifndef BENCHMARK_BUNDLE
+// Count heap allocations. Only in the standalone binary, a bundle may link
+// other replacements of the global operator new.
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept {
+  std::free(p);
+}
+#endif
+
+namespace {
+
+const logid_t LOG_ID(1);
+constexpr size_t CHUNK_LSNS = 1 << 16;
+
+struct Pattern {
+  bool scd;
+  // Send the records of a batch by one shard after another rather than in
+  // LSN order.
+  bool reordered;
+  bool holes;
+};
+
+/**
+ * Stubs out everything ClientReadStream would need a Worker for. Records and
+ * gaps are counted and dropped.
+ */
+class BenchmarkDependencies : public ClientReadStreamDependencies {
+ public:
+  BenchmarkDependencies(const Settings& settings,
+                        const EpochMetaData& metadata,
+                        size_t* delivered)
+      : settings_(settings), metadata_(metadata), delivered_(delivered) {}
+
+  bool getMetaDataForEpoch(read_stream_id_t /*rsid*/,
+                           epoch_t epoch,
+                           MetaDataLogReader::Callback cb,
+                           bool /*allow_from_cache*/,
+                           bool /*require_consistent_from_cache*/) override {
+    cb(E::OK,
+       MetaDataLogReader::Result{LOG_ID,
+                                 epoch,
+                                 EPOCH_MAX,
+                                 MetaDataLogReader::RecordSource::LAST,
+                                 compose_lsn(epoch, esn_t(1)),
+                                 std::chrono::milliseconds(0),
+                                 std::make_unique<EpochMetaData>(metadata_)});
+    return true;
+  }
+
+  void updateEpochMetaDataCache(epoch_t,
+                                epoch_t,
+                                const EpochMetaData&,
+                                MetaDataLogReader::RecordSource) override {}
+
+  int sendStartMessage(ShardID,
+                       SocketCallback*,
+                       START_Header,
+                       const small_shardset_t&,
+                       const ReadStreamAttributes*) override {
+    return 0;
+  }
+
+  int sendStopMessage(ShardID) override {
+    return 0;
+  }
+
+  int sendWindowMessage(ShardID, lsn_t, lsn_t) override {
+    return 0;
+  }
+
+  bool recordCallback(std::unique_ptr<DataRecord>& /*record*/) override {
+    ++*delivered_;
+    return true;
+  }
+
+  bool gapCallback(const GapRecord& /*gap*/) override {
+    return true;
+  }
+
+  void healthCallback(bool) override {}
+
+  void dispose() override {}
+
+  std::unique_ptr<BackoffTimer>
+  createBackoffTimer(std::chrono::milliseconds,
+                     std::chrono::milliseconds) override {
+    return std::make_unique<MockBackoffTimer>();
+  }
+
+  std::unique_ptr<BackoffTimer> createBackoffTimer(
+      const chrono_expbackoff_t<std::chrono::milliseconds>&) override {
+    return std::make_unique<MockBackoffTimer>();
+  }
+
+  std::unique_ptr<Timer>
+  createTimer(std::function<void()> cb = nullptr) override {
+    return std::make_unique<MockTimer>(std::move(cb));
+  }
+
+  std::function<ClientReadStream*(read_stream_id_t)>
+  getStreamByIDCallback() override {
+    return [this](read_stream_id_t) { return stream_; };
+  }
+
+  const Settings& getSettings() const override {
+    return settings_;
+  }
+
+  ShardAuthoritativeStatusMap getShardStatus() const override {
+    return ShardAuthoritativeStatusMap();
+  }
+
+  void refreshClusterState() override {}
+
+  folly::Optional<uint16_t>
+  getSocketProtocolVersion(node_index_t) const override {
+    return Compatibility::MAX_PROTOCOL_SUPPORTED;
+  }
+
+  ClientID getOurNameAtPeer(node_index_t) const override {
+    return ClientID::INVALID;
+  }
+
+  bool hasMemoryPressure() const override {
+    return false;
+  }
+
+  void onBytesBufferedChanged(int64_t) override {}
+
+  bool isWorkerOverloaded() const override {
+    return false;
+  }
+
+  ClientReadStream* stream_{nullptr};
+
+ private:
+  const Settings& settings_;
+  const EpochMetaData metadata_;
+  size_t* delivered_;
+};
+
+/**
+ * A read stream from the start of epoch 1, and the messages its senders will
+ * send next.
+ */
+class ReadStreamBench {
+ public:
+  ReadStreamBench(Pattern pattern, size_t nsenders)
+      : pattern_(pattern),
+        settings_(create_default_settings<Settings>()),
+        config_(std::make_shared<UpdateableConfig>()),
+        next_lsn_(compose_lsn(EPOCH_MIN, ESN_MIN)) {
+    configuration::Nodes nodes;
+    for (size_t i = 0; i < nsenders; ++i) {
+      Configuration::Node& node = nodes[i];
+      node.address = Sockaddr("::1", folly::to<std::string>(4440 + i));
+      node.generation = 1;
+      node.addSequencerRole();
+      node.addStorageRole();
+      shards_.push_back(ShardID(i, 0));
+    }
+    sender_next_lsn_.assign(nsenders, next_lsn_);
+    replication_ = std::min<size_t>(std::max(1, FLAGS_replication), nsenders);
+
+    auto server_config = ServerConfig::fromDataTest(
+        "ClientReadStreamBenchmark",
+        Configuration::NodesConfig(std::move(nodes)));
+    config_->updateableNodesConfiguration()->update(
+        server_config->getNodesConfigurationFromServerConfigSource());
+    config_->updateableServerConfig()->update(std::move(server_config));
+    auto logs_config = std::make_shared<configuration::LocalLogsConfig>();
+    logs_config->insert(boost::icl::right_open_interval<logid_t::raw_type>(
+                            LOG_ID.val_, LOG_ID.val_ + 1),
+                        "log",
+                        logsconfig::LogAttributes()
+                            .with_replicationFactor(replication_)
+                            .with_scdEnabled(pattern.scd));
+    config_->updateableLogsConfig()->update(std::move(logs_config));
+
+    EpochMetaData metadata(shards_,
+                           ReplicationProperty(replication_,
+                                               NodeLocationScope::NODE),
+                           EPOCH_MIN,
+                           EPOCH_MIN);
+    auto deps = std::make_unique<BenchmarkDependencies>(
+        settings_, metadata, &delivered_);
+    BenchmarkDependencies* deps_ptr = deps.get();
+    stream_ = std::make_unique<ClientReadStream>(
+        read_stream_id_t(1),
+        LOG_ID,
+        next_lsn_,
+        LSN_MAX,
+        settings_.client_read_flow_control_threshold,
+        ClientReadStreamBufferType::CIRCULAR,
+        std::max(1, FLAGS_buffer_size),
+        std::move(deps),
+        config_);
+    deps_ptr->stream_ = stream_.get();
+    stream_->start();
+
+    STARTED_Header header = {LOG_ID,
+                             read_stream_id_t(1),
+                             E::OK,
+                             filter_version_t(1),
+                             LSN_INVALID,
+                             /*shard_idx*/ 0};
+    for (ShardID shard : shards_) {
+      stream_->onStartSent(shard, E::OK);
+      stream_->onStarted(
+          shard, STARTED_Message(header, TrafficClass::READ_BACKLOG));
+    }
+  }
+
+  /**
+   * Generates the messages for the next `nlsns` LSNs.
+   */
+  void prepare(size_t nlsns) {
+    events_.clear();
+    const size_t batch = std::max<int>(
+        1, std::min(FLAGS_batch, std::max(1, FLAGS_buffer_size) / 2));
+    const lsn_t end = next_lsn_ + nlsns;
+    const PayloadHolder payload =
+        PayloadHolder::copyString(std::string(FLAGS_payload_size, 'x'));
+
+    while (next_lsn_ < end) {
+      const lsn_t batch_end = std::min<lsn_t>(next_lsn_ + batch, end);
+      if (pattern_.reordered) {
+        // Last shard first, it holds the highest LSNs of the batch.
+        for (size_t s = shards_.size(); s-- > 0;) {
+          for (lsn_t lsn = next_lsn_; lsn < batch_end; ++lsn) {
+            if (sends(s, lsn)) {
+              addRecord(s, lsn, payload);
+            }
+          }
+        }
+      } else {
+        for (lsn_t lsn = next_lsn_; lsn < batch_end; ++lsn) {
+          for (size_t s = 0; s < shards_.size(); ++s) {
+            if (sends(s, lsn)) {
+              addRecord(s, lsn, payload);
+            }
+          }
+        }
+      }
+      if (pattern_.holes) {
+        for (size_t s = 0; s < shards_.size(); ++s) {
+          if (sender_next_lsn_[s] < batch_end) {
+            events_.push_back(
+                Event{shards_[s], nullptr, sender_next_lsn_[s], batch_end - 1});
+            sender_next_lsn_[s] = batch_end;
+          }
+        }
+      }
+      next_lsn_ = batch_end;
+    }
+  }
+
+  /**
+   * Feeds the messages generated by prepare() to the read stream.
+   */
+  void replay() {
+    for (Event& event : events_) {
+      if (event.record) {
+        stream_->onDataRecord(event.shard, std::move(event.record));
+      } else {
+        GAP_Header gap = {LOG_ID,
+                          read_stream_id_t(1),
+                          event.gap_lo,
+                          event.gap_hi,
+                          GapReason::NO_RECORDS,
+                          GAP_flags_t{0},
+                          event.shard.shard()};
+        stream_->onGap(
+            event.shard, GAP_Message(gap, TrafficClass::READ_BACKLOG));
+      }
+    }
+  }
+
+  size_t delivered() const {
+    return delivered_;
+  }
+
+ private:
+  struct Event {
+    ShardID shard;
+    // nullptr for a NO_RECORDS gap [gap_lo, gap_hi].
+    std::unique_ptr<DataRecordOwnsPayload> record;
+    lsn_t gap_lo;
+    lsn_t gap_hi;
+  };
+
+  // Whether shard `s` sends a copy of record `lsn`.
+  bool sends(size_t s, lsn_t lsn) const {
+    const uint64_t i = lsn_to_esn(lsn).val_;
+    if (pattern_.holes && i % std::max(1, FLAGS_hole_every) == 0) {
+      return false;
+    }
+    const size_t first = i % shards_.size();
+    const size_t offset = (s + shards_.size() - first) % shards_.size();
+    return offset < (pattern_.scd ? 1 : replication_);
+  }
+
+  void addRecord(size_t s, lsn_t lsn, const PayloadHolder& payload) {
+    events_.push_back(
+        Event{shards_[s],
+              std::make_unique<DataRecordOwnsPayload>(
+                  LOG_ID,
+                  PayloadHolder(payload),
+                  lsn,
+                  std::chrono::milliseconds(0),
+                  RECORD_flags_t(0)),
+              LSN_INVALID,
+              LSN_INVALID});
+    sender_next_lsn_[s] = lsn + 1;
+  }
+
+  const Pattern pattern_;
+  Settings settings_;
+  std::shared_ptr<UpdateableConfig> config_;
+  StorageSet shards_;
+  size_t replication_;
+  size_t delivered_{0};
+  std::unique_ptr<ClientReadStream> stream_;
+
+  // First LSN prepare() hasn't generated messages for yet.
+  lsn_t next_lsn_;
+  // Next LSN each sender will send a record or gap for.
+  std::vector<lsn_t> sender_next_lsn_;
+  std::vector<Event> events_;
+};
+
+void runPattern(size_t n, Pattern pattern, size_t nsenders) {
+  std::unique_ptr<ReadStreamBench> bench;
+  BENCHMARK_SUSPEND {
+    bench = std::make_unique<ReadStreamBench>(pattern, nsenders);
+  }
+  for (size_t done = 0; done < n;) {
+    const size_t chunk = std::min(n - done, CHUNK_LSNS);
+    BENCHMARK_SUSPEND {
+      bench->prepare(chunk);
+    }
+    bench->replay();
+    done += chunk;
+  }
+  BENCHMARK_SUSPEND {
+    folly::doNotOptimizeAway(bench->delivered());
+    bench.reset();
+  }
+}
+
+// {scd, reordered, holes}
+constexpr Pattern IN_ORDER{false, false, false};
+constexpr Pattern REORDERED{false, true, false};
+constexpr Pattern HOLES{false, false, true};
+constexpr Pattern SCD{true, false, false};
+constexpr Pattern SCD_REORDERED{true, true, false};
+constexpr Pattern SCD_HOLES{true, false, true};
+
+size_t senders() {
+  return std::max(1, FLAGS_senders);
+}
+
+// The ManySenders benchmarks read from 10x --senders shards.
+size_t manySenders() {
+  return senders() * 10;
+}
+
+#ifndef BENCHMARK_BUNDLE
+void reportAllocations() {
+  std::printf("\nHeap allocations per LSN (%d LSNs):\n", FLAGS_alloc_records);
+  struct Case {
+    const char* name;
+    Pattern pattern;
+    size_t nsenders;
+  };
+  const Case cases[] = {
+      {"InOrder", IN_ORDER, senders()},
+      {"Reordered", REORDERED, senders()},
+      {"Holes", HOLES, senders()},
+      {"Scd", SCD, senders()},
+      {"ScdReordered", SCD_REORDERED, senders()},
+      {"ScdHoles", SCD_HOLES, senders()},
+      {"InOrderManySenders", IN_ORDER, manySenders()},
+      {"ScdManySenders", SCD, manySenders()},
+  };
+  for (const Case& c : cases) {
+    ReadStreamBench bench(c.pattern, c.nsenders);
+    bench.prepare(FLAGS_alloc_records);
+    const size_t before = allocations.load();
+    bench.replay();
+    const size_t after = allocations.load();
+    std::printf("  %-20s %6.2f (%zu records delivered)\n",
+                c.name,
+                double(after - before) / std::max(1, FLAGS_alloc_records),
+                bench.delivered());
+  }
+}
+#endif
+
+} // namespace
+
+BENCHMARK(InOrder, n) {
+  runPattern(n, IN_ORDER, senders());
+}
+
+BENCHMARK_RELATIVE(Reordered, n) {
+  runPattern(n, REORDERED, senders());
+}
+
+BENCHMARK_RELATIVE(Holes, n) {
+  runPattern(n, HOLES, senders());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(Scd, n) {
+  runPattern(n, SCD, senders());
+}
+
+BENCHMARK_RELATIVE(ScdReordered, n) {
+  runPattern(n, SCD_REORDERED, senders());
+}
+
+BENCHMARK_RELATIVE(ScdHoles, n) {
+  runPattern(n, SCD_HOLES, senders());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(InOrderManySenders, n) {
+  runPattern(n, IN_ORDER, manySenders());
+}
+
+BENCHMARK_RELATIVE(ScdManySenders, n) {
+  runPattern(n, SCD, manySenders());
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  reportAllocations();
+
+  return 0;
+}
+#endif
@@ -0,0 +1,391 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/CopySetSelectorDependencies.h"
+#include "logdevice/common/CrossDomainCopySetSelector.h"
+#include "logdevice/common/EpochMetaData.h"
+#include "logdevice/common/LinearCopySetSelector.h"
+#include "logdevice/common/NodeAvailabilityChecker.h"
+#include "logdevice/common/NodeSetState.h"
+#include "logdevice/common/WeightedCopySetSelector.h"
+#include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/nodeset_selection/NodeSetSelectorFactory.h"
+
+using namespace facebook::logdevice;
+
+DEFINE_int32(regions, 3, "Number of regions in the cluster");
+DEFINE_int32(racks_per_region, 10, "Number of racks in each region");
+DEFINE_int32(nodes_per_rack, 10, "Average number of storage nodes per rack");
+DEFINE_double(rack_size_spread,
+              0.5,
+              "Racks have uniformly random sizes in [nodes_per_rack * (1 - "
+              "spread), nodes_per_rack * (1 + spread)]");
+DEFINE_double(weight_spread,
+              0.3,
+              "Node weights (storage capacities) are uniformly random in "
+              "[1 - spread, 1 + spread]");
+DEFINE_int32(nodeset_size, 40, "Target nodeset size");
+DEFINE_int32(replication, 3, "Replication factor");
+DEFINE_string(sync_replication_scope,
+              "rack",
+              "Copies must span at least two domains of this scope");
+DEFINE_int32(extras, 0, "Extra copies to select");
+DEFINE_double(unavailable_fraction,
+              0.05,
+              "Fraction of the nodeset that is down or has no connection");
+DEFINE_double(graylisted_fraction,
+              0.05,
+              "Fraction of the nodeset that is graylisted as slow");
+DEFINE_uint64(distribution_copysets,
+              1000000,
+              "Number of copysets each selector picks to measure how stores "
+              "are distributed over the nodes; 0 to skip");
+DEFINE_bool(print_per_node, false, "Print the number of stores of each node");
+DEFINE_uint64(seed, 1, "Seed for generating the cluster");
+
+/**
+ * @file Cost and balance of copyset selectors on a large cluster. Builds a
+ *       cluster of --regions x --racks_per_region racks of uneven sizes and
+ *       node weights, picks a nodeset for a log with the weight-aware
+ *       nodeset selector, and makes some of the nodeset unavailable and some
+ *       of it graylisted.
+ *
+ *       Before running the select() benchmarks, each selector picks
+ *       --distribution_copysets copysets, and the spread of stores per unit
+ *       of weight over the available nodes of the nodeset is printed.
+ *       Linear and CrossDomain selectors ignore weights, so they're expected
+ *       to be less balanced when --weight_spread is not 0.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+const logid_t LOG_ID(1);
+
+// Reports nodes as unavailable if they're in `unavailable_` or graylisted in
+// the NodeSetState, the way NodeAvailabilityChecker does, without the
+// Worker and Sender it needs.
+class BenchCopySetSelectorDeps : public CopySetSelectorDependencies,
+                                 public NodeAvailabilityChecker {
+ public:
+  NodeStatus checkNode(NodeSetState* nodeset_state,
+                       ShardID shard,
+                       StoreChainLink* destination_out,
+                       bool ignore_nodeset_state) const override {
+    if (unavailable_.count(shard.node())) {
+      return NodeStatus::NOT_AVAILABLE;
+    }
+    if (!ignore_nodeset_state && nodeset_state &&
+        nodeset_state->getNotAvailableUntil(shard) >
+            std::chrono::steady_clock::now()) {
+      return NodeStatus::NOT_AVAILABLE;
+    }
+    *destination_out = {shard, ClientID::MIN};
+    return NodeStatus::AVAILABLE;
+  }
+
+  const NodeAvailabilityChecker* getNodeAvailability() const override {
+    return this;
+  }
+
+  std::unordered_set<node_index_t> unavailable_;
+};
+
+struct Cluster {
+  std::shared_ptr<Configuration> config;
+  std::shared_ptr<const configuration::nodes::NodesConfiguration> nodes_config;
+  std::vector<double> weights; // by node index
+  ReplicationProperty replication;
+  StorageSet nodeset;
+  std::unordered_set<node_index_t> graylisted;
+  std::shared_ptr<NodeSetState> nodeset_state;
+  BenchCopySetSelectorDeps deps;
+  logsconfig::DefaultLogAttributes log_attrs;
+  NodeID my_node;
+};
+
+std::unique_ptr<Cluster> buildCluster() {
+  auto cluster = std::make_unique<Cluster>();
+  Cluster& c = *cluster;
+  std::mt19937_64 rng(FLAGS_seed);
+  auto uniform = [&](double spread) {
+    return std::uniform_real_distribution<double>(1 - spread, 1 + spread)(rng);
+  };
+
+  configuration::Nodes nodes;
+  for (int region = 0; region < FLAGS_regions; ++region) {
+    for (int rack = 0; rack < FLAGS_racks_per_region; ++rack) {
+      int rack_size = std::max<int>(
+          1,
+          std::lround(FLAGS_nodes_per_rack * uniform(FLAGS_rack_size_spread)));
+      for (int i = 0; i < rack_size; ++i) {
+        node_index_t id = nodes.size();
+        configuration::Node n;
+        n.address = Sockaddr("::1", std::to_string(id));
+        n.generation = 1;
+        NodeLocation loc;
+        std::string r = std::to_string(region);
+        int rv = loc.fromDomainString("rg" + r + ".dc" + r + ".cl" + r +
+                                      ".rw" + r + ".rk" + std::to_string(rack));
+        ld_check(rv == 0);
+        n.location = std::move(loc);
+        n.addSequencerRole(true, 1);
+        n.addStorageRole(1);
+        n.storage_attributes->capacity = uniform(FLAGS_weight_spread);
+        c.weights.push_back(n.storage_attributes->capacity);
+        nodes[id] = std::move(n);
+      }
+    }
+  }
+
+  std::string scope_str = FLAGS_sync_replication_scope;
+  std::transform(
+      scope_str.begin(), scope_str.end(), scope_str.begin(), ::toupper);
+  NodeLocationScope scope = NodeLocation::scopeNames().reverseLookup(scope_str);
+  ld_check(scope >= NodeLocationScope::NODE && scope < NodeLocationScope::ROOT);
+  c.replication = ReplicationProperty(FLAGS_replication, scope);
+
+  auto logs_config = std::make_shared<configuration::LocalLogsConfig>();
+  auto log_attrs = logsconfig::LogAttributes().with_replicateAcross(
+      c.replication.getDistinctReplicationFactors());
+  logs_config->insert(
+      boost::icl::right_open_interval<logid_t::raw_type>(1, 2),
+      "CopySetSelectorBenchmark",
+      log_attrs);
+  Configuration::NodesConfig nodes_config(std::move(nodes));
+  c.config = std::make_shared<Configuration>(
+      ServerConfig::fromDataTest(
+          "CopySetSelectorBenchmark", std::move(nodes_config)),
+      std::move(logs_config));
+  c.nodes_config = c.config->getNodesConfigurationFromServerConfigSource();
+
+  auto nodeset_selector =
+      NodeSetSelectorFactory::create(NodeSetSelectorType::WEIGHT_AWARE);
+  auto res = nodeset_selector->getStorageSet(LOG_ID,
+                                             c.config.get(),
+                                             *c.nodes_config,
+                                             FLAGS_nodeset_size,
+                                             FLAGS_seed,
+                                             nullptr,
+                                             nullptr);
+  ld_check(res.decision == NodeSetSelector::Decision::NEEDS_CHANGE);
+  c.nodeset = std::move(res.storage_set);
+
+  c.nodeset_state = std::make_shared<NodeSetState>(
+      c.nodeset, LOG_ID, NodeSetState::HealthCheck::DISABLED);
+  StorageSet shuffled = c.nodeset;
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+  size_t num_unavailable =
+      std::lround(FLAGS_unavailable_fraction * c.nodeset.size());
+  size_t num_graylisted =
+      std::lround(FLAGS_graylisted_fraction * c.nodeset.size());
+  size_t i = 0;
+  for (; i < num_unavailable && i < shuffled.size(); ++i) {
+    c.deps.unavailable_.insert(shuffled[i].node());
+  }
+  for (; i < num_unavailable + num_graylisted && i < shuffled.size(); ++i) {
+    c.graylisted.insert(shuffled[i].node());
+  }
+  // The sequencer runs on an available node of the nodeset, so that locality
+  // has something to work with.
+  c.my_node = NodeID(
+      i < shuffled.size() ? shuffled[i].node() : shuffled[0].node(), 1);
+
+  ld_info("Cluster of %zu nodes, nodeset of %zu, %zu unavailable, %zu "
+          "graylisted, replication %s",
+          c.weights.size(),
+          c.nodeset.size(),
+          c.deps.unavailable_.size(),
+          c.graylisted.size(),
+          c.replication.toString().c_str());
+  return cluster;
+}
+
+Cluster& getCluster() {
+  static std::unique_ptr<Cluster> cluster = buildCluster();
+  return *cluster;
+}
+
+// Selectors reset the graylist when they can't pick a copyset, so it's set
+// again for each selector.
+void graylistNodes() {
+  Cluster& c = getCluster();
+  for (node_index_t node : c.graylisted) {
+    c.nodeset_state->setNotAvailableUntil(
+        ShardID(node, 0),
+        std::chrono::steady_clock::now() + std::chrono::hours(24),
+        NodeSetState::NotAvailableReason::SLOW);
+  }
+}
+
+enum class SelectorType { WEIGHTED, WEIGHTED_LOCALITY, CROSS_DOMAIN, LINEAR };
+
+std::unique_ptr<CopySetSelector> makeSelector(SelectorType type) {
+  Cluster& c = getCluster();
+  graylistNodes();
+  switch (type) {
+    case SelectorType::WEIGHTED:
+    case SelectorType::WEIGHTED_LOCALITY:
+      return std::make_unique<WeightedCopySetSelector>(
+          LOG_ID,
+          EpochMetaData(c.nodeset, c.replication),
+          c.nodeset_state,
+          c.nodes_config,
+          c.my_node,
+          &c.log_attrs,
+          /* locality_enabled */ type == SelectorType::WEIGHTED_LOCALITY,
+          /* stats */ nullptr,
+          DefaultRNG::get(),
+          /* print_bias_warnings */ false,
+          &c.deps);
+    case SelectorType::CROSS_DOMAIN:
+      return std::make_unique<CrossDomainCopySetSelector>(
+          LOG_ID,
+          c.nodeset,
+          c.nodeset_state,
+          c.nodes_config,
+          c.my_node,
+          c.replication.getReplicationFactor(),
+          c.replication.getBiggestReplicationScope(),
+          &c.deps);
+    case SelectorType::LINEAR:
+      return std::make_unique<LinearCopySetSelector>(
+          c.replication.getReplicationFactor(),
+          c.nodeset,
+          c.nodeset_state,
+          &c.deps);
+  }
+  ld_check(false);
+  return nullptr;
+}
+
+void printDistribution(const char* name, SelectorType type) {
+  Cluster& c = getCluster();
+  auto selector = makeSelector(type);
+  std::vector<uint64_t> stores(c.weights.size());
+  std::vector<StoreChainLink> cs(COPYSET_SIZE_MAX);
+  uint64_t failed = 0;
+  for (uint64_t i = 0; i < FLAGS_distribution_copysets; ++i) {
+    copyset_size_t size;
+    auto res = selector->select(FLAGS_extras, cs.data(), &size);
+    if (res == CopySetSelector::Result::FAILED) {
+      ++failed;
+      continue;
+    }
+    for (copyset_size_t j = 0; j < size; ++j) {
+      ++stores[cs[j].destination.node()];
+    }
+  }
+
+  // Stores per unit of weight on the nodes that are supposed to get stores.
+  std::vector<double> load;
+  uint64_t graylisted_stores = 0;
+  for (ShardID shard : c.nodeset) {
+    node_index_t node = shard.node();
+    if (c.graylisted.count(node)) {
+      graylisted_stores += stores[node];
+    } else if (!c.deps.unavailable_.count(node)) {
+      load.push_back(stores[node] / c.weights[node]);
+    }
+    if (FLAGS_print_per_node) {
+      printf("  %s N%d: weight %.2f, %lu stores\n",
+             name,
+             node,
+             c.weights[node],
+             stores[node]);
+    }
+  }
+  if (load.empty()) {
+    printf("%s: no available nodes\n", name);
+    return;
+  }
+  double mean = 0;
+  for (double l : load) {
+    mean += l;
+  }
+  mean /= load.size();
+  double var = 0;
+  for (double l : load) {
+    var += (l - mean) * (l - mean);
+  }
+  var /= load.size();
+  auto minmax = std::minmax_element(load.begin(), load.end());
+  printf("%s: %lu copysets, %lu failed; stores per unit of weight over %zu "
+         "nodes: min/mean %.3f, max/mean %.3f, cv %.4f; %lu stores on "
+         "graylisted nodes\n",
+         name,
+         FLAGS_distribution_copysets,
+         failed,
+         load.size(),
+         mean > 0 ? *minmax.first / mean : 0.,
+         mean > 0 ? *minmax.second / mean : 0.,
+         mean > 0 ? std::sqrt(var) / mean : 0.,
+         graylisted_stores);
+}
+
+void benchSelect(SelectorType type, unsigned n) {
+  std::unique_ptr<CopySetSelector> selector;
+  std::vector<StoreChainLink> cs;
+  BENCHMARK_SUSPEND {
+    selector = makeSelector(type);
+    cs.resize(COPYSET_SIZE_MAX);
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    copyset_size_t size;
+    bool chain = true;
+    auto res =
+        selector->select(FLAGS_extras, cs.data(), &size, &chain, nullptr);
+    folly::doNotOptimizeAway(res);
+  }
+}
+
+} // namespace
+
+BENCHMARK(Weighted, n) {
+  benchSelect(SelectorType::WEIGHTED, n);
+}
+
+BENCHMARK(WeightedLocality, n) {
+  benchSelect(SelectorType::WEIGHTED_LOCALITY, n);
+}
+
+BENCHMARK(CrossDomain, n) {
+  benchSelect(SelectorType::CROSS_DOMAIN, n);
+}
+
+BENCHMARK(Linear, n) {
+  benchSelect(SelectorType::LINEAR, n);
+}
+
+#ifndef BENCHMARK_BUNDLE
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_distribution_copysets > 0) {
+    printDistribution("Weighted", SelectorType::WEIGHTED);
+    printDistribution("WeightedLocality", SelectorType::WEIGHTED_LOCALITY);
+    printDistribution("CrossDomain", SelectorType::CROSS_DOMAIN);
+    printDistribution("Linear", SelectorType::LINEAR);
+  }
+  folly::runBenchmarks();
+  return 0;
+}
+#endif
@@ -0,0 +1,640 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/EpochMetaData.h"
+#include "logdevice/common/EpochRecovery.h"
+#include "logdevice/common/Mutator.h"
+#include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/protocol/START_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/util.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/test/DigestTestUtil.h"
+#include "logdevice/common/test/MockBackoffTimer.h"
+#include "logdevice/common/test/MockTimer.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: End-to-end cost of recovering one epoch with EpochRecovery, driven
+ *        through stubbed EpochRecoveryDependencies against simulated storage
+ *        nodes.
+ *
+ *        Every message EpochRecovery sends (START, CLEAN, and the STOREs of
+ *        its Mutators) is answered by the simulated node after a round trip
+ *        of 2 * --latency-us plus up to --jitter-us of random jitter. Replies
+ *        are kept in a queue ordered by simulated time, so nothing actually
+ *        sleeps: folly's iters/s is epochs recovered per second of CPU on one
+ *        thread, and the simulated recovery latency is reported separately.
+ *
+ *        Each of --nodes storage shards has seen ESNs [1, --epoch-esns] of the
+ *        epoch. Record i is stored on --replication shards starting at
+ *        i % nodes. In the Holes cases every --hole-every-th ESN has no copy
+ *        at all and has to be plugged; in the UnderReplicated cases every
+ *        --under-replicated-every-th record has a single copy and has to be
+ *        re-replicated.
+ *
+ *        When run standalone, the number of messages, digest payload bytes,
+ *        mutations and the simulated recovery time per epoch of each case are
+ *        printed after the benchmarks. Messages include the SEAL and SEALED
+ *        that LogRecoveryRequest exchanges before handing the epoch to
+ *        EpochRecovery.
+ */
+
+DEFINE_int32(nodes, 6, "Number of storage shards in the nodeset.");
+DEFINE_int32(replication, 3, "Number of copies of each record.");
+DEFINE_int32(epoch_esns, 128, "Number of ESNs digested in each epoch.");
+DEFINE_int32(big_epoch_factor,
+             16,
+             "BigEpoch cases digest this many times more ESNs.");
+DEFINE_int32(hole_every, 8, "In Holes cases, every Nth ESN is a hole.");
+DEFINE_int32(under_replicated_every,
+             4,
+             "In UnderReplicated cases, every Nth record has one copy.");
+DEFINE_int32(payload_size, 100, "Payload size of records, in bytes.");
+DEFINE_int32(latency_us, 500, "One-way network latency to storage nodes.");
+DEFINE_int32(jitter_us, 200, "Random extra latency added to each round trip.");
+DEFINE_int32(epoch_store_us, 2000, "Latency of updating LCE in epoch store.");
+DEFINE_int32(report_epochs,
+             100,
+             "Number of epochs to recover when reporting per epoch counts.");
+
+namespace {
+
+const logid_t LOG_ID(1);
+const epoch_t EPOCH(23);
+const epoch_t SEAL_EPOCH(27);
+
+struct Scenario {
+  size_t esns;
+  size_t hole_every;
+  size_t under_replicated_every;
+};
+
+class RecoveryBench;
+
+/**
+ * Stands in for the STOREs a Mutator would send: completes once every shard
+ * of the mutation set would have replied.
+ */
+class BenchMutator : public Mutator {
+ public:
+  BenchMutator(RecoveryBench* bench,
+               const STORE_Header& header,
+               const STORE_Extra& extra,
+               Payload payload,
+               StorageSet mutation_set,
+               ReplicationProperty replication,
+               std::set<ShardID> amend_metadata,
+               std::set<ShardID> conflict_copies,
+               EpochRecovery* epoch_recovery)
+      : Mutator(header,
+                extra,
+                payload,
+                std::move(mutation_set),
+                std::move(replication),
+                std::move(amend_metadata),
+                std::move(conflict_copies),
+                epoch_recovery),
+        bench_(bench) {}
+
+  void start() override;
+
+ private:
+  RecoveryBench* const bench_;
+};
+
+/**
+ * Recovers one epoch at a time against simulated storage nodes.
+ */
+class RecoveryBench {
+ public:
+  explicit RecoveryBench(const Scenario& scenario)
+      : scenario_(scenario),
+        settings_(create_default_settings<Settings>()),
+        stats_(StatsParams().setIsServer(true)),
+        rng_(0xdeadbeef) {
+    const size_t nodes = std::max(1, FLAGS_nodes);
+    configuration::Nodes config_nodes;
+    for (size_t i = 0; i < nodes; ++i) {
+      Configuration::Node& node = config_nodes[i];
+      node.address = Sockaddr("::1", folly::to<std::string>(4440 + i));
+      node.generation = 1;
+      node.addSequencerRole();
+      node.addStorageRole();
+      shards_.push_back(ShardID(i, 0));
+    }
+    replication_ = std::min<size_t>(std::max(1, FLAGS_replication), nodes);
+    nodes_configuration_ =
+        ServerConfig::fromDataTest(
+            "EpochRecoveryBenchmark",
+            Configuration::NodesConfig(std::move(config_nodes)))
+            ->getNodesConfigurationFromServerConfigSource();
+    digests_.resize(nodes);
+
+    prev_tail_ = TailRecord(
+        {LOG_ID,
+         compose_lsn(epoch_t(EPOCH.val_ - 1), esn_t(7)),
+         0,
+         {BYTE_OFFSET_INVALID /* deprecated, use OffsetMap instead */},
+         TailRecordHeader::CHECKSUM_PARITY,
+         {}},
+        OffsetMap(),
+        PayloadHolder());
+  }
+
+  /**
+   * Generates the digest each shard will send for the next epoch.
+   */
+  void prepare() {
+    const size_t nodes = shards_.size();
+    for (auto& digest : digests_) {
+      digest.clear();
+    }
+    for (size_t i = 1; i <= scenario_.esns; ++i) {
+      if (scenario_.hole_every > 0 && i % scenario_.hole_every == 0) {
+        continue;
+      }
+      const size_t copies = scenario_.under_replicated_every > 0 &&
+              i % scenario_.under_replicated_every == 0
+          ? 1
+          : replication_;
+      for (size_t c = 0; c < copies; ++c) {
+        digests_[(i + c) % nodes].push_back(
+            DigestTestUtil::create_record(LOG_ID,
+                                          compose_lsn(EPOCH, esn_t(i)),
+                                          DigestTestUtil::NORMAL,
+                                          /*wave*/ 1,
+                                          std::chrono::milliseconds(i),
+                                          std::max(0, FLAGS_payload_size)));
+      }
+    }
+  }
+
+  /**
+   * Recovers the epoch generated by prepare(), from sealing to advancing LCE.
+   */
+  void run();
+
+  size_t epochs() const {
+    return epochs_;
+  }
+
+  // Per epoch averages, for the report.
+  double messagesSent() const {
+    return perEpoch(messages_sent_);
+  }
+  double messagesReceived() const {
+    return perEpoch(messages_received_);
+  }
+  double digestPayloadBytes() const {
+    return perEpoch(digest_payload_bytes_);
+  }
+  double mutations() const {
+    return perEpoch(mutations_);
+  }
+  double recoveryMs() const {
+    return perEpoch(total_time_us_) / 1000.0;
+  }
+
+ private:
+  friend class BenchDependencies;
+  friend class BenchMutator;
+
+  double perEpoch(uint64_t total) const {
+    return epochs_ > 0 ? double(total) / epochs_ : 0;
+  }
+
+  // A round trip to `shard` and back, in simulated microseconds.
+  uint64_t roundTrip(ShardID /*shard*/) {
+    std::uniform_int_distribution<uint64_t> jitter(
+        0, std::max(0, FLAGS_jitter_us));
+    return 2 * std::max(0, FLAGS_latency_us) + jitter(rng_);
+  }
+
+  void schedule(uint64_t delay_us, std::function<void()> fn) {
+    events_.emplace(std::make_pair(now_us_ + delay_us, next_event_++),
+                    std::move(fn));
+  }
+
+  // Intercepts a message sent by EpochRecovery and schedules the reply of the
+  // simulated node.
+  void onMessage(std::unique_ptr<Message> msg, const Address& to);
+
+  void onMutatorStarted(esn_t esn, const StorageSet& mutation_set) {
+    uint64_t rtt = 0;
+    for (ShardID shard : mutation_set) {
+      rtt = std::max(rtt, roundTrip(shard));
+    }
+    // One STORE to and one STORED from each shard in the mutation set.
+    messages_sent_ += mutation_set.size();
+    ++mutations_;
+    schedule(rtt, [this, esn, n = mutation_set.size()] {
+      messages_received_ += n;
+      erm_->onMutationComplete(esn, E::OK, ShardID());
+    });
+  }
+
+  const Scenario scenario_;
+  Settings settings_;
+  StatsHolder stats_;
+  std::mt19937_64 rng_;
+  StorageSet shards_;
+  size_t replication_;
+  std::shared_ptr<const configuration::nodes::NodesConfiguration>
+      nodes_configuration_;
+  TailRecord prev_tail_;
+
+  // Digest records each shard will send, indexed by node.
+  std::vector<std::vector<std::unique_ptr<DataRecordOwnsPayload>>> digests_;
+
+  std::unique_ptr<EpochRecovery> erm_;
+  bool finished_{false};
+  read_stream_id_t next_rsid_{1};
+
+  // Pending replies, ordered by simulated delivery time and then by the order
+  // they were scheduled in.
+  std::map<std::pair<uint64_t, uint64_t>, std::function<void()>> events_;
+  uint64_t now_us_{0};
+  uint64_t next_event_{0};
+
+  size_t epochs_{0};
+  uint64_t messages_sent_{0};
+  uint64_t messages_received_{0};
+  uint64_t digest_payload_bytes_{0};
+  uint64_t mutations_{0};
+  uint64_t total_time_us_{0};
+};
+
+void BenchMutator::start() {
+  bench_->onMutatorStarted(getStoreHeader().rid.esn, getMutationSet());
+}
+
+class BenchDependencies : public EpochRecoveryDependencies {
+  using BenchSender = SenderTestProxy<BenchDependencies>;
+
+ public:
+  explicit BenchDependencies(RecoveryBench* bench)
+      : EpochRecoveryDependencies(/*driver=*/nullptr), bench_(bench) {
+    sender_ = std::make_unique<BenchSender>(this);
+  }
+
+  int sendMessageImpl(std::unique_ptr<Message>&& msg,
+                      const Address& addr,
+                      BWAvailableCallback*,
+                      SocketCallback*) {
+    bench_->onMessage(std::move(msg), addr);
+    return 0;
+  }
+
+  bool canSendToImpl(const Address&, TrafficClass, BWAvailableCallback&) {
+    return true;
+  }
+
+  epoch_t getSealEpoch() const override {
+    return SEAL_EPOCH;
+  }
+
+  epoch_t getLogRecoveryNextEpoch() const override {
+    return epoch_t(SEAL_EPOCH.val_ + 1);
+  }
+
+  void onEpochRecovered(epoch_t /*epoch*/,
+                        TailRecord /*epoch_tail*/,
+                        Status status,
+                        Seal /*seal*/) override {
+    if (status != E::OK) {
+      ld_critical("Epoch recovery failed: %s", error_name(status));
+      std::abort();
+    }
+    bench_->finished_ = true;
+  }
+
+  void onShardRemovedFromConfig(ShardID) override {}
+
+  bool canMutateShard(ShardID) const override {
+    return true;
+  }
+
+  NodeID getMyNodeID() const override {
+    return NodeID(0, 1);
+  }
+
+  read_stream_id_t issueReadStreamID() override {
+    return read_stream_id_t(bench_->next_rsid_.val_++);
+  }
+
+  void noteMutationsCompleted(const EpochRecovery&) override {}
+
+  std::unique_ptr<BackoffTimer>
+  createBackoffTimer(const chrono_expbackoff_t<std::chrono::milliseconds>&,
+                     std::function<void()> callback) override {
+    auto timer = std::make_unique<MockBackoffTimer>();
+    if (callback) {
+      timer->setCallback(std::move(callback));
+    }
+    return std::move(timer);
+  }
+
+  std::unique_ptr<Timer> createTimer(std::function<void()> cb) override {
+    return std::make_unique<MockTimer>(std::move(cb));
+  }
+
+  int registerOnSocketClosed(const Address&, SocketCallback&) override {
+    return 0;
+  }
+
+  int setLastCleanEpoch(logid_t,
+                        epoch_t lce,
+                        const TailRecord& tail_record,
+                        EpochStore::CompletionLCE) override {
+    RecoveryBench* bench = bench_;
+    bench->schedule(
+        std::max(0, FLAGS_epoch_store_us), [bench, lce, tail_record] {
+          bench->erm_->onLastCleanEpochUpdated(E::OK, lce, tail_record);
+        });
+    return 0;
+  }
+
+  std::unique_ptr<Mutator>
+  createMutator(const STORE_Header& header,
+                const STORE_Extra& extra,
+                Payload payload,
+                StorageSet mutation_set,
+                ReplicationProperty replication,
+                std::set<ShardID> amend_metadata,
+                std::set<ShardID> conflict_copies,
+                EpochRecovery* epoch_recovery) override {
+    return std::make_unique<BenchMutator>(bench_,
+                                          header,
+                                          extra,
+                                          payload,
+                                          std::move(mutation_set),
+                                          std::move(replication),
+                                          std::move(amend_metadata),
+                                          std::move(conflict_copies),
+                                          epoch_recovery);
+  }
+
+  const Settings& getSettings() const override {
+    return bench_->settings_;
+  }
+
+  StatsHolder* getStats() const override {
+    return &bench_->stats_;
+  }
+
+  logid_t getLogID() const override {
+    return LOG_ID;
+  }
+
+  bool isShardAlive(ShardID) const override {
+    return true;
+  }
+
+ private:
+  RecoveryBench* const bench_;
+};
+
+void RecoveryBench::onMessage(std::unique_ptr<Message> msg,
+                              const Address& to) {
+  ++messages_sent_;
+  const node_index_t node = to.asNodeID().index();
+  switch (msg->type_) {
+    case MessageType::START: {
+      const START_Header& header =
+          static_cast<const START_Message*>(msg.get())->header_;
+      const ShardID shard(node, header.shard);
+      const read_stream_id_t rsid = header.read_stream_id;
+      schedule(0, [this, shard, rsid] {
+        erm_->onMessageSent(shard, MessageType::START, E::OK, rsid);
+      });
+      schedule(roundTrip(shard), [this, shard, rsid] {
+        ++messages_received_;
+        erm_->onDigestStreamStarted(shard, rsid, LSN_INVALID, E::OK);
+        esn_t next = erm_->getDigestStart();
+        for (auto& record : digests_[shard.node()]) {
+          const esn_t esn = lsn_to_esn(record->attrs.lsn);
+          if (esn < next) {
+            continue;
+          }
+          ++messages_received_;
+          digest_payload_bytes_ += record->payload.size();
+          next = esn_t(esn.val_ + 1);
+          erm_->onDigestRecord(shard, rsid, std::move(record));
+        }
+        ++messages_received_;
+        erm_->onDigestGap(shard,
+                          GAP_Header{LOG_ID,
+                                     rsid,
+                                     compose_lsn(EPOCH, next),
+                                     compose_lsn(EPOCH, ESN_MAX),
+                                     GapReason::NO_RECORDS,
+                                     GAP_Header::DIGEST,
+                                     shard.shard()});
+      });
+      break;
+    }
+    case MessageType::CLEAN: {
+      const ShardID shard(
+          node, static_cast<const CLEAN_Message*>(msg.get())->header_.shard);
+      schedule(0, [this, shard] {
+        erm_->onMessageSent(shard, MessageType::CLEAN, E::OK);
+      });
+      schedule(roundTrip(shard), [this, shard] {
+        ++messages_received_;
+        erm_->onCleaned(shard, E::OK, Seal());
+      });
+      break;
+    }
+    default:
+      ld_critical("Unexpected %s message sent by EpochRecovery",
+                  messageTypeNames()[msg->type_].c_str());
+      std::abort();
+  }
+}
+
+void RecoveryBench::run() {
+  const EpochMetaData metadata(
+      shards_, ReplicationProperty(replication_, NodeLocationScope::NODE));
+  erm_ = std::make_unique<EpochRecovery>(LOG_ID,
+                                         EPOCH,
+                                         metadata,
+                                         nodes_configuration_,
+                                         std::make_unique<BenchDependencies>(
+                                             this),
+                                         /*tail_optimized=*/false);
+  finished_ = false;
+  now_us_ = 0;
+
+  // LogRecoveryRequest seals the log on every shard and hands the replies to
+  // EpochRecovery.
+  const esn_t max_seen(scenario_.esns);
+  for (ShardID shard : shards_) {
+    ++messages_sent_;
+    schedule(roundTrip(shard), [this, shard, max_seen] {
+      ++messages_received_;
+      erm_->onSealed(shard, ESN_INVALID, max_seen, OffsetMap(), folly::none);
+    });
+  }
+  erm_->activate(prev_tail_);
+
+  while (!finished_) {
+    if (events_.empty()) {
+      // Nothing in flight; EpochRecovery must be waiting for its grace period
+      // to expire.
+      auto* grace_period = static_cast<MockTimer*>(erm_->getGracePeriodTimer());
+      if (grace_period == nullptr || !grace_period->isActive()) {
+        ld_critical("Epoch recovery stalled: %s", erm_->identify().c_str());
+        std::abort();
+      }
+      grace_period->trigger();
+      continue;
+    }
+    auto it = events_.begin();
+    now_us_ = it->first.first;
+    std::function<void()> fn = std::move(it->second);
+    events_.erase(it);
+    fn();
+  }
+
+  // Replies to messages sent after the epoch was recovered are dropped.
+  events_.clear();
+  erm_.reset();
+  total_time_us_ += now_us_;
+  ++epochs_;
+}
+
+Scenario scenario(bool big, bool holes, bool under_replicated) {
+  const size_t esns = std::max(0, FLAGS_epoch_esns) *
+      (big ? std::max(1, FLAGS_big_epoch_factor) : 1);
+  return Scenario{esns,
+                  holes ? size_t(std::max(1, FLAGS_hole_every)) : 0,
+                  under_replicated
+                      ? size_t(std::max(1, FLAGS_under_replicated_every))
+                      : 0};
+}
+
+void runScenario(size_t n, const Scenario& s) {
+  std::unique_ptr<RecoveryBench> bench;
+  BENCHMARK_SUSPEND {
+    bench = std::make_unique<RecoveryBench>(s);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    BENCHMARK_SUSPEND {
+      bench->prepare();
+    }
+    bench->run();
+  }
+  BENCHMARK_SUSPEND {
+    folly::doNotOptimizeAway(bench->epochs());
+    bench.reset();
+  }
+}
+
+#ifndef BENCHMARK_BUNDLE
+void reportPerEpoch() {
+  std::printf("\nPer epoch (%d epochs, %dus one-way latency, %dus jitter):\n",
+              FLAGS_report_epochs,
+              FLAGS_latency_us,
+              FLAGS_jitter_us);
+  std::printf("  %-28s %8s %8s %12s %8s %10s\n",
+              "case",
+              "sent",
+              "received",
+              "digest bytes",
+              "mutated",
+              "latency ms");
+  struct Case {
+    const char* name;
+    Scenario scenario;
+  };
+  const Case cases[] = {
+      {"EmptyEpoch", Scenario{0, 0, 0}},
+      {"FullyReplicated", scenario(false, false, false)},
+      {"Holes", scenario(false, true, false)},
+      {"UnderReplicated", scenario(false, false, true)},
+      {"BigEpoch", scenario(true, false, false)},
+      {"BigEpochHolesUnderReplicated", scenario(true, true, true)},
+  };
+  for (const Case& c : cases) {
+    RecoveryBench bench(c.scenario);
+    for (int i = 0; i < std::max(1, FLAGS_report_epochs); ++i) {
+      bench.prepare();
+      bench.run();
+    }
+    std::printf("  %-28s %8.1f %8.1f %12.0f %8.1f %10.2f\n",
+                c.name,
+                bench.messagesSent(),
+                bench.messagesReceived(),
+                bench.digestPayloadBytes(),
+                bench.mutations(),
+                bench.recoveryMs());
+  }
+}
+#endif
+
+} // namespace
+
+BENCHMARK(EmptyEpoch, n) {
+  runScenario(n, Scenario{0, 0, 0});
+}
+
+BENCHMARK_RELATIVE(FullyReplicated, n) {
+  runScenario(n, scenario(false, false, false));
+}
+
+BENCHMARK_RELATIVE(Holes, n) {
+  runScenario(n, scenario(false, true, false));
+}
+
+BENCHMARK_RELATIVE(UnderReplicated, n) {
+  runScenario(n, scenario(false, false, true));
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(BigEpoch, n) {
+  runScenario(n, scenario(true, false, false));
+}
+
+BENCHMARK_RELATIVE(BigEpochHolesUnderReplicated, n) {
+  runScenario(n, scenario(true, true, true));
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  dbg::currentLevel = dbg::Level::ERROR;
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  reportPerEpoch();
+
+  return 0;
+}
+#endif
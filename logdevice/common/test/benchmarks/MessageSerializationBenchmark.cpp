@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <folly/io/IOBuf.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/PayloadHolder.h"
+#include "logdevice/common/protocol/APPEND_Message.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/MessageDeserializers.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
+#include "logdevice/common/protocol/STORED_Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/protocol/WINDOW_Message.h"
+#include "logdevice/common/types_internal.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: CPU cost of serializing (ProtocolWriter) and deserializing
+ *        (ProtocolReader + the message type's deserializer) the messages that
+ *        make up most of the traffic between clients, sequencers and storage
+ *        nodes, at the current protocol version. No sockets or Workers are
+ *        involved.
+ *
+ *        One iteration is one message, so the time per iteration is ns/op.
+ *        Deserialization includes handing a clone of the serialized IOBuf to
+ *        ProtocolReader, as Connection does.
+ *
+ *        When run standalone, the serialized size of each message is printed
+ *        after the benchmarks. Sizes only change with the wire format, so
+ *        they can be compared against a baseline file (--baseline) to catch
+ *        unintended protocol growth; --write_baseline regenerates the file.
+ */
+
+DEFINE_int32(payload_size, 1024, "Payload size of STORE/RECORD/APPEND.");
+DEFINE_int32(copyset_size, 3, "Number of copies in STORE's copyset.");
+DEFINE_string(baseline,
+              "",
+              "File with the expected serialized size of each message. If "
+              "set, exit with an error if any size differs.");
+DEFINE_bool(write_baseline,
+            false,
+            "Write the serialized sizes to --baseline instead of comparing.");
+
+namespace {
+
+const uint16_t PROTO = Compatibility::MAX_PROTOCOL_SUPPORTED;
+
+PayloadHolder makePayload() {
+  return PayloadHolder::copyString(std::string(FLAGS_payload_size, 'x'));
+}
+
+std::unique_ptr<Message> makeSTORE() {
+  STORE_Header h{};
+  h.rid = RecordID(lsn_t(0x0000000500000010), logid_t(1234567));
+  h.timestamp = 1600000000000;
+  h.last_known_good = esn_t(15);
+  h.wave = 1;
+  h.flags = STORE_Header::CHECKSUM_PARITY;
+  h.nsync = 0;
+  h.copyset_offset = 0;
+  h.copyset_size = FLAGS_copyset_size;
+  h.timeout_ms = 0;
+  h.sequencer_node_id = NodeID(1, 1);
+
+  std::vector<StoreChainLink> copyset;
+  for (int i = 0; i < FLAGS_copyset_size; ++i) {
+    copyset.push_back({ShardID(i + 2, 0), ClientID::INVALID});
+  }
+  return std::make_unique<STORE_Message>(h,
+                                         copyset.data(),
+                                         0,
+                                         0,
+                                         STORE_Extra(),
+                                         std::map<KeyType, std::string>(),
+                                         makePayload());
+}
+
+std::unique_ptr<Message> makeSTORED() {
+  STORED_Header h{};
+  h.rid = RecordID(lsn_t(0x0000000500000010), logid_t(1234567));
+  h.wave = 1;
+  h.status = E::OK;
+  h.redirect = NodeID();
+  h.flags = STORED_Header::SYNCED;
+  h.shard = 0;
+  return std::make_unique<STORED_Message>(h,
+                                          LSN_INVALID,
+                                          0,
+                                          chunk_rebuilding_id_t(),
+                                          FlushToken_INVALID,
+                                          ServerInstanceId_INVALID);
+}
+
+std::unique_ptr<Message> makeRECORD() {
+  RECORD_Header h{};
+  h.log_id = logid_t(1234567);
+  h.read_stream_id = read_stream_id_t(42);
+  h.lsn = lsn_t(0x0000000500000010);
+  h.timestamp = 1600000000000;
+  h.flags = RECORD_Header::CHECKSUM_PARITY;
+  h.shard = 0;
+  return std::make_unique<RECORD_Message>(
+      h, TrafficClass::READ_TAIL, makePayload(), nullptr);
+}
+
+std::unique_ptr<Message> makeAPPEND() {
+  APPEND_Header h{};
+  h.rqid = request_id_t(42);
+  h.logid = logid_t(1234567);
+  h.seen = EPOCH_INVALID;
+  h.timeout_ms = 10000;
+  h.flags = APPEND_Header::CHECKSUM_64BIT;
+  return std::make_unique<APPEND_Message>(
+      h, LSN_INVALID, AppendAttributes(), makePayload());
+}
+
+std::unique_ptr<Message> makeGAP() {
+  GAP_Header h{};
+  h.log_id = logid_t(1234567);
+  h.read_stream_id = read_stream_id_t(42);
+  h.start_lsn = lsn_t(0x0000000500000010);
+  h.end_lsn = lsn_t(0x0000000500000020);
+  h.reason = GapReason::NO_RECORDS;
+  h.flags = 0;
+  h.shard = 0;
+  return std::make_unique<GAP_Message>(h, TrafficClass::READ_TAIL);
+}
+
+std::unique_ptr<Message> makeWINDOW() {
+  WINDOW_Header h{};
+  h.log_id = logid_t(1234567);
+  h.read_stream_id = read_stream_id_t(42);
+  h.sliding_window.low = lsn_t(0x0000000500000010);
+  h.sliding_window.high = lsn_t(0x0000000500001010);
+  h.shard = 0;
+  return std::make_unique<WINDOW_Message>(h);
+}
+
+std::unique_ptr<folly::IOBuf> serialize(const Message& msg) {
+  auto iobuf = folly::IOBuf::create(IOBUF_ALLOCATION_UNIT);
+  ProtocolWriter writer(msg.type_, iobuf.get(), PROTO);
+  msg.serialize(writer);
+  ssize_t sz = writer.result();
+  if (sz <= 0) {
+    std::fprintf(stderr,
+                 "Failed to serialize %s: %s\n",
+                 messageTypeNames()[msg.type_].c_str(),
+                 error_name(writer.status()));
+    std::abort();
+  }
+  return iobuf;
+}
+
+void runSerialize(size_t n, std::unique_ptr<Message> (*make)()) {
+  std::unique_ptr<Message> msg;
+  BENCHMARK_SUSPEND {
+    msg = make();
+  }
+  for (size_t i = 0; i < n; ++i) {
+    auto iobuf = serialize(*msg);
+    folly::doNotOptimizeAway(iobuf);
+  }
+}
+
+void runDeserialize(size_t n, std::unique_ptr<Message> (*make)()) {
+  std::unique_ptr<folly::IOBuf> serialized;
+  MessageType type;
+  BENCHMARK_SUSPEND {
+    auto msg = make();
+    type = msg->type_;
+    serialized = serialize(*msg);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    ProtocolReader reader(type, serialized->clone(), PROTO);
+    auto msg = messageDeserializers[type](reader).msg;
+    if (!msg) {
+      std::fprintf(stderr,
+                   "Failed to deserialize %s: %s\n",
+                   messageTypeNames()[type].c_str(),
+                   error_name(reader.status()));
+      std::abort();
+    }
+    folly::doNotOptimizeAway(msg);
+  }
+}
+
+struct Case {
+  const char* name;
+  std::unique_ptr<Message> (*make)();
+};
+
+const Case cases[] = {
+    {"STORE", makeSTORE},
+    {"STORED", makeSTORED},
+    {"RECORD", makeRECORD},
+    {"APPEND", makeAPPEND},
+    {"GAP", makeGAP},
+    {"WINDOW", makeWINDOW},
+};
+
+#ifndef BENCHMARK_BUNDLE
+// Prints the serialized size of each message and compares it with (or
+// writes it to) --baseline. The first line of the file is the payload size
+// the sizes were computed with.
+//
+// @return 0 on success, 1 if the sizes don't match the baseline
+int reportSizes() {
+  std::map<std::string, size_t> sizes;
+  std::printf("\nSerialized sizes (payload %d bytes, protocol %u):\n",
+              FLAGS_payload_size,
+              (unsigned)PROTO);
+  for (const Case& c : cases) {
+    size_t size = serialize(*c.make())->computeChainDataLength();
+    sizes[c.name] = size;
+    std::printf("  %-10s %8zu\n", c.name, size);
+  }
+
+  if (FLAGS_baseline.empty()) {
+    return 0;
+  }
+
+  if (FLAGS_write_baseline) {
+    std::ofstream out(FLAGS_baseline);
+    out << "payload_size " << FLAGS_payload_size << "\n";
+    for (const auto& kv : sizes) {
+      out << kv.first << " " << kv.second << "\n";
+    }
+    std::printf("Wrote %s\n", FLAGS_baseline.c_str());
+    return out.good() ? 0 : 1;
+  }
+
+  std::ifstream in(FLAGS_baseline);
+  std::string key;
+  size_t value;
+  if (!(in >> key >> value) || key != "payload_size") {
+    std::fprintf(stderr, "Malformed baseline %s\n", FLAGS_baseline.c_str());
+    return 1;
+  }
+  if (value != static_cast<size_t>(FLAGS_payload_size)) {
+    std::fprintf(stderr,
+                 "Baseline was computed with --payload_size=%zu, not "
+                 "comparing.\n",
+                 value);
+    return 1;
+  }
+  int rv = 0;
+  while (in >> key >> value) {
+    auto it = sizes.find(key);
+    if (it == sizes.end()) {
+      continue;
+    }
+    if (it->second != value) {
+      std::fprintf(stderr,
+                   "%s: serialized size changed from %zu to %zu bytes\n",
+                   key.c_str(),
+                   value,
+                   it->second);
+      rv = 1;
+    }
+  }
+  return rv;
+}
+#endif
+
+} // namespace
+
+#define SERIALIZATION_BENCHMARKS(name)  \
+  BENCHMARK(name##_serialize, n) {      \
+    runSerialize(n, make##name);        \
+  }                                     \
+  BENCHMARK(name##_deserialize, n) {    \
+    runDeserialize(n, make##name);      \
+  }                                     \
+  BENCHMARK_DRAW_LINE();
+
+SERIALIZATION_BENCHMARKS(STORE)
+SERIALIZATION_BENCHMARKS(STORED)
+SERIALIZATION_BENCHMARKS(RECORD)
+SERIALIZATION_BENCHMARKS(APPEND)
+SERIALIZATION_BENCHMARKS(GAP)
+SERIALIZATION_BENCHMARKS(WINDOW)
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return reportSizes();
+}
+#endif
@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <atomic>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/settings/GossipSettings.h"
+#include "logdevice/common/settings/RebuildingSettings.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/SettingsUpdater.h"
+
+using namespace facebook::logdevice;
+
+DEFINE_int32(workers, 64, "Number of threads reading the settings");
+
+/**
+ * @file Cost of changing a setting through SettingsUpdater, the way the admin
+ *       "set" command does, while --workers threads keep reading the settings
+ *       bundles and each of them is subscribed to updates of every bundle,
+ *       re-reading the bundle from the callback.
+ *
+ *       Gossip: changes a setting of the small GossipSettings bundle. Only
+ *       that bundle is republished.
+ *       Main: changes a setting of the large Settings bundle.
+ *       Unchanged: sets a setting to the value it already has. Nothing is
+ *       republished.
+ *
+ *       Run with --bm_min_usec=1000000.
+ */
+
+namespace {
+
+class SettingsUpdaterBench {
+ public:
+  SettingsUpdaterBench() {
+    updater_.registerSettings(settings_);
+    updater_.registerSettings(gossip_settings_);
+    updater_.registerSettings(rebuilding_settings_);
+    updater_.setFromCLI({});
+
+    for (int i = 0; i < FLAGS_workers; ++i) {
+      handles_.push_back(settings_.subscribeToUpdates([this] {
+        reads_.fetch_add(settings_->num_workers, std::memory_order_relaxed);
+      }));
+      gossip_handles_.push_back(gossip_settings_.subscribeToUpdates([this] {
+        reads_.fetch_add(gossip_settings_->gossip_failure_threshold,
+                         std::memory_order_relaxed);
+      }));
+      rebuilding_handles_.push_back(
+          rebuilding_settings_.subscribeToUpdates([this] {
+            reads_.fetch_add(rebuilding_settings_->max_records_in_flight,
+                             std::memory_order_relaxed);
+          }));
+    }
+
+    for (int i = 0; i < FLAGS_workers; ++i) {
+      readers_.emplace_back([this] {
+        while (!shutdown_.load()) {
+          uint64_t v = settings_->num_workers +
+              gossip_settings_->gossip_failure_threshold +
+              rebuilding_settings_->max_records_in_flight;
+          reads_.fetch_add(v, std::memory_order_relaxed);
+        }
+      });
+    }
+  }
+
+  ~SettingsUpdaterBench() {
+    shutdown_.store(true);
+    for (auto& t : readers_) {
+      t.join();
+    }
+  }
+
+  void set(const std::string& name, const std::string& value) {
+    updater_.setFromAdminCmd(name, value);
+  }
+
+ private:
+  UpdateableSettings<Settings> settings_;
+  UpdateableSettings<GossipSettings> gossip_settings_;
+  UpdateableSettings<RebuildingSettings> rebuilding_settings_;
+  SettingsUpdater updater_;
+
+  std::list<UpdateableSettings<Settings>::SubscriptionHandle> handles_;
+  std::list<UpdateableSettings<GossipSettings>::SubscriptionHandle>
+      gossip_handles_;
+  std::list<UpdateableSettings<RebuildingSettings>::SubscriptionHandle>
+      rebuilding_handles_;
+
+  std::vector<std::thread> readers_;
+  std::atomic<bool> shutdown_{false};
+  std::atomic<uint64_t> reads_{0};
+};
+
+void benchUpdates(int n,
+                  const std::string& name,
+                  const std::string& value1,
+                  const std::string& value2) {
+  std::unique_ptr<SettingsUpdaterBench> bench;
+  BENCHMARK_SUSPEND {
+    bench = std::make_unique<SettingsUpdaterBench>();
+  }
+  for (int i = 0; i < n; ++i) {
+    bench->set(name, i % 2 ? value1 : value2);
+  }
+  BENCHMARK_SUSPEND {
+    bench.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(Gossip, n) {
+  benchUpdates(n, "gossip-threshold", "30", "31");
+}
+
+BENCHMARK(Main, n) {
+  benchUpdates(n, "rsm-prefetch-delta-log-tail", "true", "false");
+}
+
+BENCHMARK(Unchanged, n) {
+  benchUpdates(n, "gossip-threshold", "30", "30");
+}
+
+#ifndef BENCHMARK_BUNDLE
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  return 0;
+}
+#endif
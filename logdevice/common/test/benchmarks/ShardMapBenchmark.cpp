@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/container/F14Map.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/ShardID.h"
+#include "logdevice/common/SmallMap.h"
+
+/**
+ * @file Benchmark comparing lookups in the maps that the read path keeps per
+ *       read stream, keyed by ShardID: std::unordered_map, folly's F14 maps
+ *       and SmallUnorderedMap. A lookup is made for every record and gap a
+ *       read stream receives. Many read streams are alive at a time, so maps
+ *       are mostly cold in the cache; --streams controls how many maps the
+ *       lookups go round.
+ */
+
+DEFINE_int32(streams, 1000, "Number of maps to spread lookups over.");
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Stand-in for ClientReadStreamSenderState, which is a few cache lines big.
+struct Value {
+  std::array<uint64_t, 24> data{};
+};
+
+template <typename Map>
+void lookups(size_t iters, size_t nshards) {
+  std::vector<Map> maps;
+  std::vector<ShardID> keys;
+  BENCHMARK_SUSPEND {
+    maps.resize(std::max(1, FLAGS_streams));
+    for (Map& map : maps) {
+      for (size_t i = 0; i < nshards; ++i) {
+        map[ShardID(node_index_t(i * 7), 0)];
+      }
+    }
+    keys.resize(4096);
+    for (ShardID& key : keys) {
+      key = ShardID(node_index_t(folly::Random::rand32(nshards) * 7), 0);
+    }
+  }
+
+  uint64_t sum = 0;
+  for (size_t i = 0; i < iters; ++i) {
+    Map& map = maps[i % maps.size()];
+    auto it = map.find(keys[i % keys.size()]);
+    sum += it->second.data[0]++;
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+using StdMap = std::unordered_map<ShardID, Value, ShardID::Hash>;
+using F14NodeMap = folly::F14NodeMap<ShardID, Value, ShardID::Hash>;
+using F14ValueMap = folly::F14ValueMap<ShardID, Value, ShardID::Hash>;
+using SmallMap = SmallUnorderedMap<ShardID, Value, 1>;
+
+} // namespace
+
+#define SHARD_MAP_BENCHMARKS(n)                     \
+  BENCHMARK(StdUnorderedMap##n, iters) {            \
+    lookups<StdMap>(iters, n);                      \
+  }                                                 \
+  BENCHMARK_RELATIVE(F14NodeMap##n, iters) {        \
+    lookups<F14NodeMap>(iters, n);                  \
+  }                                                 \
+  BENCHMARK_RELATIVE(F14ValueMap##n, iters) {       \
+    lookups<F14ValueMap>(iters, n);                 \
+  }                                                 \
+  BENCHMARK_RELATIVE(SmallUnorderedMap##n, iters) { \
+    lookups<SmallMap>(iters, n);                    \
+  }                                                 \
+  BENCHMARK_DRAW_LINE();
+
+// Typical nodeset sizes.
+SHARD_MAP_BENCHMARKS(6)
+SHARD_MAP_BENCHMARKS(20)
+SHARD_MAP_BENCHMARKS(60)
+
+#undef SHARD_MAP_BENCHMARKS
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
+#endif
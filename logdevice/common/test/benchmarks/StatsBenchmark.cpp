@@ -1,7 +1,9 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <future>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -14,6 +16,9 @@
 #include "logdevice/common/test/TestUtil.h"
 
 DEFINE_int32(num_threads, 32, "Number of threads for benchmarks.");
+DEFINE_int32(num_log_groups,
+             10000,
+             "Number of log groups for per-log stats benchmarks.");
 
 namespace facebook { namespace logdevice {
 
@@ -172,6 +177,45 @@ BENCHMARK(BM_stats_aggregate, iters) {
       });
 }
 
+// Collecting stats from FLAGS_num_threads threads that each have per-log stats
+// for FLAGS_num_log_groups log groups. Run with --bm_min_iters=1 --bm_regex
+// to select it, the default --bm_min_iters is meant for the benchmarks above.
+BENCHMARK(BM_stats_aggregate_per_log, iters) {
+  StatsHolder stats(StatsParams().setIsServer(true));
+  std::vector<std::thread> threads;
+  std::promise<void> finish;
+  std::shared_future<void> finished = finish.get_future().share();
+
+  BENCHMARK_SUSPEND {
+    std::vector<std::string> log_groups;
+    for (int i = 0; i < FLAGS_num_log_groups; ++i) {
+      log_groups.push_back("/log_group_" + std::to_string(i));
+    }
+    MultiBaton ready(FLAGS_num_threads);
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads.emplace_back([&] {
+        for (const auto& log_group : log_groups) {
+          LOG_GROUP_STAT_ADD(&stats, log_group, append_success, 1);
+        }
+        ready.post();
+        finished.wait();
+      });
+    }
+    ready.wait();
+  }
+
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(stats.aggregate());
+  }
+
+  BENCHMARK_SUSPEND {
+    finish.set_value();
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+}
+
 }} // namespace facebook::logdevice
 
 #ifndef BENCHMARK_BUNDLE
@@ -5,8 +5,10 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <atomic>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #include <folly/Benchmark.h>
 #include <gflags/gflags.h>
@@ -18,7 +20,10 @@ using namespace facebook::logdevice;
 /**
  * @file Benchmark comparing UpdateableSharedPtr, FastUpdateableSharedPtr and
  *       an implementation similar to FastUpdateableSharedPtr, but without
- *       shared_ptr<shared_ptr> trick.
+ *       shared_ptr<shared_ptr> trick. The *_Snapshot variants read through a
+ *       SnapshotCache owned by each reading thread, the way Workers read
+ *       the config, ending the epoch after every read (i.e. as if every read
+ *       was in a separate task).
  *
  *       Run with --bm_min_usec=1000000.
  */
@@ -144,11 +149,10 @@ void benchWritesWhenReading(int n) {
   }
 }
 
-template <class PtrInt>
-void benchReadsIn10Threads(int n) {
+template <class PtrInt, int NumThreads>
+void benchReadsInThreads(int n) {
   PtrInt ptr(std::make_shared<int>(27));
-  std::vector<std::thread> threads(10);
-  int n_per_thread = n;
+  std::vector<std::thread> threads(NumThreads);
 
   for (std::thread& t : threads) {
     t = std::thread([&] {
@@ -164,6 +168,71 @@ void benchReadsIn10Threads(int n) {
   }
 }
 
+template <class PtrInt>
+void benchReadsIn10Threads(int n) {
+  benchReadsInThreads<PtrInt, 10>(n);
+}
+
+template <class PtrInt>
+void benchReadsIn64Threads(int n) {
+  benchReadsInThreads<PtrInt, 64>(n);
+}
+
+// Reads through a SnapshotCache, see @file.
+template <class PtrInt>
+void readSnapshots(const PtrInt& ptr, int n) {
+  SnapshotCache<int> cache;
+  for (int i = 0; i < n; ++i) {
+    cache.refresh(ptr);
+    folly::doNotOptimizeAway(cache.get());
+    cache.endEpoch();
+  }
+}
+
+template <class PtrInt>
+void benchSnapshotReads(int n) {
+  PtrInt ptr(std::make_shared<int>(42));
+  readSnapshots(ptr, n);
+}
+
+template <class PtrInt>
+void benchSnapshotReadsWhenWriting(int n) {
+  PtrInt ptr;
+  std::atomic<bool> shutdown{false};
+  std::thread writing_thread;
+
+  BENCHMARK_SUSPEND {
+    writing_thread = std::thread([&] {
+      std::shared_ptr<int> values[2]{
+          std::make_shared<int>(3), std::make_shared<int>(14)};
+      for (uint64_t i = 0; !shutdown.load(); ++i) {
+        ptr.update(values[i & 1]);
+      }
+    });
+  }
+
+  readSnapshots(ptr, n);
+
+  BENCHMARK_SUSPEND {
+    shutdown.store(true);
+    writing_thread.join();
+  }
+}
+
+template <class PtrInt>
+void benchSnapshotReadsIn64Threads(int n) {
+  PtrInt ptr(std::make_shared<int>(27));
+  std::vector<std::thread> threads(64);
+
+  for (std::thread& t : threads) {
+    t = std::thread([&] { readSnapshots(ptr, n); });
+  }
+
+  for (std::thread& t : threads) {
+    t.join();
+  }
+}
+
 #define BENCH(name)                                 \
   BENCHMARK(name##_Slow, n) {                       \
     bench##name<slow::UpdateableSharedPtr<int>>(n); \
@@ -176,11 +245,25 @@ void benchReadsIn10Threads(int n) {
   }                                                 \
   BENCHMARK_DRAW_LINE();
 
+// slow::UpdateableSharedPtr has no version(), so it can't be snapshotted.
+#define BENCH_SNAPSHOT(name)                               \
+  BENCHMARK(name##_UpdateableSharedPtr_Snapshot, n) {      \
+    benchSnapshot##name<UpdateableSharedPtr<int, int>>(n); \
+  }                                                        \
+  BENCHMARK(name##_FastUpdateableSharedPtr_Snapshot, n) {  \
+    benchSnapshot##name<FastUpdateableSharedPtr<int>>(n);  \
+  }                                                        \
+  BENCHMARK_DRAW_LINE();
+
 BENCH(Reads)
+BENCH_SNAPSHOT(Reads)
 BENCH(Writes)
 BENCH(ReadsWhenWriting)
+BENCH_SNAPSHOT(ReadsWhenWriting)
 BENCH(WritesWhenReading)
 BENCH(ReadsIn10Threads)
+BENCH(ReadsIn64Threads)
+BENCH_SNAPSHOT(ReadsIn64Threads)
 
 #ifndef BENCHMARK_BUNDLE
 
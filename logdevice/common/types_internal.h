@@ -222,6 +222,14 @@ LOGDEVICE_STRONG_TYPEDEF(uint64_t, chunk_rebuilding_id_t);
 
 constexpr chunk_rebuilding_id_t CHUNK_REBUILDING_ID_INVALID(0);
 
+/**
+ * Identifies an append or a read stream sampled for end-to-end tracing, see
+ * E2ETracer. Sent in APPEND, STORE and START messages.
+ */
+LOGDEVICE_STRONG_TYPEDEF(uint64_t, e2e_trace_id_t);
+
+constexpr e2e_trace_id_t E2E_TRACE_ID_INVALID(0);
+
 /**
  * Filter version used in START messages. This is bumped each time a new START
  * message is sent with a different filtering policy. The storage nodes use this
@@ -9,6 +9,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
@@ -57,6 +58,37 @@ class AsyncReader {
   virtual void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) = 0;
 
+  /**
+   * Like setRecordCallback(), but the callback may receive several
+   * consecutive records of a log in one call. Currently these are all records
+   * of a batch written by BufferedWriter, which share the memory of the
+   * decompressed batch: delivering them together saves a callback invocation
+   * per record to applications reading many small records.
+   *
+   * Records are in the order they would be delivered to a record callback.
+   * The callback should return true if it consumed all of them. Otherwise it
+   * must consume a prefix of the vector, if anything, reset the consumed
+   * unique_ptrs to nullptr and leave the rest intact; delivery of the rest
+   * will be retried like with setRecordCallback().
+   *
+   * Replaces the callback set with setRecordCallback(), and vice versa. Only
+   * affects subsequent startReading() calls.
+   */
+  virtual void setRecordBatchCallback(
+      std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)> cb) {
+    // Implementations that don't support batches deliver one record at a time.
+    setRecordCallback(
+        [cb = std::move(cb)](std::unique_ptr<DataRecord>& record) {
+          std::vector<std::unique_ptr<DataRecord>> records;
+          records.push_back(std::move(record));
+          if (cb(records) || records[0] == nullptr) {
+            return true;
+          }
+          record = std::move(records[0]);
+          return false;
+        });
+  }
+
   /**
    * Sets a callback that the LogDevice client library will call when a gap
    * record is delivered for this log. A gap record informs the reader about
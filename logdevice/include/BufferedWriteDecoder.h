@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "logdevice/include/Record.h"
@@ -39,6 +40,17 @@ class BufferedWriteDecoder {
    */
   static int getBatchSize(const DataRecord& record, size_t* size_out);
 
+  /**
+   * Makes a zstd dictionary (see BufferedWriter::LogOptions::zstd_dictionary)
+   * known to all decoders in this process, so that batches compressed with it
+   * can be decoded.  Dictionaries used by BufferedWriters in this process are
+   * known automatically.
+   *
+   * @return 0 on success, -1 if `dictionary` is not a valid zstd dictionary
+   *         with a dictionary ID, and sets err to E::INVALID_PARAM.
+   */
+  static int addZstdDictionary(std::string dictionary);
+
   /**
    * This method is meant to be used with data records returned by the Reader
    * API.
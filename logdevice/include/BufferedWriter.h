@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -214,6 +215,13 @@ class BufferedWriter {
     // Compression codec.
     Compression compression = Compression::LZ4;
 
+    // With ZSTD compression, a zstd dictionary (e.g. trained with
+    // `zstd --train` on sample records) to compress batches with.  Helps a lot
+    // with batches of small, similar records.  The dictionary must have a
+    // dictionary ID.  Readers in other processes need to register it with
+    // BufferedWriteDecoder::addZstdDictionary() to decode these batches.
+    std::shared_ptr<const std::string> zstd_dictionary;
+
     // If set to true, will destroy individual payloads immediately after they
     // are batched together. onSuccess(), onFailure() and onRetry() callbacks
     // will not contain payloads.
@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <chrono>
+#include <functional>
+
 #include <folly/Function.h>
 #include <folly/Optional.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
@@ -15,6 +18,7 @@
 
 namespace facebook { namespace logdevice {
 
+class CoalescingCheckpointWriter;
 struct ReadStreamAttributes;
 
 /*
@@ -25,12 +29,31 @@ class CheckpointedReaderBase {
  public:
   using StatusCallback = folly::Function<void(Status)>;
 
+  /*
+   * Called with the status of a commit, the number of logs it wrote, and the
+   * time from the first write it carried until the store acknowledged it.
+   */
+  using CommitCallback =
+      std::function<void(Status, size_t, std::chrono::milliseconds)>;
+
   struct CheckpointingOptions {
     /*
      * The number of retries when synchronously writing checkpoints. folly::none
      * means that it will retry forever.
      */
     uint32_t num_retries = 10;
+
+    /*
+     * AsyncCheckpointedReader merges the asynchronous checkpoint writes made
+     * within this window and commits them as a single update of the store,
+     * with at most one commit in flight. Zero writes every call through.
+     */
+    std::chrono::milliseconds commit_coalescing_window{100};
+
+    /*
+     * If set, called after every coalesced commit.
+     */
+    CommitCallback commit_cb;
   };
 
   /*
@@ -40,7 +63,7 @@ class CheckpointedReaderBase {
                          std::unique_ptr<CheckpointStore> store,
                          CheckpointingOptions opts);
 
-  virtual ~CheckpointedReaderBase() = default;
+  virtual ~CheckpointedReaderBase();
 
   /*
    * Writes the passed checkpoints synchronously with retries specified in opts.
@@ -85,6 +108,10 @@ class CheckpointedReaderBase {
  protected:
   void setLastLSNInMap(logid_t log_id, lsn_t lsn);
 
+  // Makes asyncWriteCheckpoints() go through a CoalescingCheckpointWriter, if
+  // options_.commit_coalescing_window is positive.
+  void enableCommitCoalescing();
+
   CheckpointingOptions options_;
   std::string reader_name_;
   std::unique_ptr<CheckpointStore> store_;
@@ -95,6 +122,9 @@ class CheckpointedReaderBase {
   folly::ConcurrentHashMap<logid_t, lsn_t> last_read_lsn_;
 
  private:
+  // Declared after store_ so that it is destroyed first.
+  std::unique_ptr<CoalescingCheckpointWriter> writer_;
+
   folly::Expected<std::map<logid_t, lsn_t>, E>
   getNewCheckpoints(const std::vector<logid_t>& logs);
 };
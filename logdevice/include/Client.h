@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "logdevice/include/AsyncReader.h"
 #include "logdevice/include/ClientFactory.h"
@@ -83,6 +84,29 @@ typedef std::function<void(Status, lsn_t result)> find_time_callback_t;
  */
 typedef std::function<void(FindKeyResult result)> find_key_callback_t;
 
+/**
+ * Outcome of findTimeBulk() for one log.
+ *
+ * @param log_id  the log
+ * @param status  what findTimeSync() would have set *status_out to
+ * @param lsn     what findTimeSync() would have returned
+ */
+struct FindTimeBulkResult {
+  logid_t log_id;
+  Status status;
+  lsn_t lsn;
+};
+
+/**
+ * Type of callback that is called when a non-blocking findTimeBulk() request
+ * completes.
+ *
+ * See findTimeBulk() and findTimeBulkSync() for docs.
+ */
+typedef std::function<void(Status status,
+                           std::vector<FindTimeBulkResult> results)>
+    find_time_bulk_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking ByteOffset() request
  * completes.
@@ -99,6 +123,28 @@ typedef std::function<void(Status, uint64_t result)> byte_offset_callback_t;
  */
 typedef std::function<void(Status)> trim_callback_t;
 
+/**
+ * Outcome of trimBulk() for one log.
+ *
+ * @param log_id  the log
+ * @param lsn     the LSN the log was trimmed up to
+ * @param status  what trimSync() would have set err to, or E::OK
+ */
+struct TrimBulkResult {
+  logid_t log_id;
+  lsn_t lsn;
+  Status status;
+};
+
+/**
+ * Type of callback that is called when a non-blocking trimBulk() request
+ * completes.
+ *
+ * See trimBulk() and trimBulkSync() for docs.
+ */
+typedef std::function<void(Status status, std::vector<TrimBulkResult> results)>
+    trim_bulk_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking isLogEmpty() request
  * completes.
@@ -188,6 +234,39 @@ typedef std::function<
 typedef std::function<void(Status status, std::unique_ptr<LogTailAttributes>)>
     get_tail_attributes_callback_t;
 
+/**
+ * Outcome of getTailAttributesBulk() for one log.
+ *
+ * @param log_id      the log
+ * @param status      E::OK if attributes were fetched, otherwise one of the
+ *                    errors getTailAttributesSync() can fail with
+ * @param attributes  tail attributes of the log, nullptr unless status is OK
+ */
+struct LogTailAttributesResult {
+  logid_t log_id;
+  Status status;
+  std::unique_ptr<LogTailAttributes> attributes;
+};
+
+/**
+ * Type of callback that is called when a non-blocking getTailAttributesBulk()
+ * request completes.
+ *
+ * See getTailAttributesBulk() and getTailAttributesBulkSync() for docs.
+ */
+typedef std::function<void(Status status,
+                           std::vector<LogTailAttributesResult> results)>
+    get_tail_attributes_bulk_callback_t;
+
+/**
+ * Type of callback that is called when a non-blocking readLogTail() request
+ * completes.
+ *
+ * See readLogTail() and readLogTailSync() for docs.
+ */
+typedef std::function<void(Status status, std::unique_ptr<DataRecord>)>
+    read_log_tail_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking getHeadAttributes()
  * request completes.
@@ -450,6 +529,41 @@ class Client {
    */
   virtual int trim(logid_t logid, lsn_t lsn, trim_callback_t cb) noexcept = 0;
 
+  /**
+   * Like trimSync(), for many logs at once, e.g. for a retention job.
+   *
+   * The trims of all logs run on the same Worker, and those that go to the
+   * same storage node are sent together in TRIM_BATCH messages of up to
+   * --trim-batch-size logs, instead of one TRIM message per log. A storage
+   * node persists the trim points of all logs of a batch that live on the
+   * same shard with a single write. Nodes running an older version get one
+   * TRIM per log, as with trim().
+   *
+   * @param trims    (log, LSN) pairs, each meaning the same as the arguments
+   *                 of trimSync(). If a log appears more than once, it is
+   *                 trimmed up to the highest of its LSNs.
+   * @param results  on return, has one entry per distinct log of trims, in
+   *                 the order of their first occurrence
+   * @return 0 if all entries of results have E::OK. Otherwise -1, with err
+   *         set to:
+   *     E::PARTIAL     Some logs failed; see the status of their entries in
+   *                    results.
+   *     E::NOBUFS      Too many requests were pending to be delivered to
+   *                    Workers; results is left untouched.
+   */
+  virtual int trimBulkSync(std::vector<std::pair<logid_t, lsn_t>> trims,
+                           std::vector<TrimBulkResult>* results) noexcept = 0;
+
+  /**
+   * A non-blocking version of trimBulkSync().
+   *
+   * @param cb  will be called once every log has its outcome, with E::OK if
+   *            all of them succeeded and E::PARTIAL otherwise.
+   * @return 0 if the request was successfully scheduled, -1 otherwise.
+   */
+  virtual int trimBulk(std::vector<std::pair<logid_t, lsn_t>> trims,
+                       trim_bulk_callback_t cb) noexcept = 0;
+
   /**
    * Supply a write token.  Without this, writes to any logs configured to
    * require a write token will fail.
@@ -630,6 +744,48 @@ class Client {
            find_time_callback_t cb,
            FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
 
+  /**
+   * Like findTimeSync(), for many logs and the same timestamp, e.g. to
+   * rewind all the logs a consumer group reads to some point in time.
+   *
+   * The lookups of all logs run on the same Worker, and those that go to the
+   * same storage node are sent together in FINDKEY_BATCH messages of up to
+   * --findkey-batch-size logs, instead of one FINDKEY message per log. A
+   * storage node looks up all logs of a batch that live on the same shard
+   * with a single storage task. Nodes running an older version get one
+   * FINDKEY per log, as with findTime().
+   *
+   * @param logids    logs to query. Duplicates are ignored.
+   * @param timestamp as for findTimeSync()
+   * @param results   on return, has one entry per distinct log of logids,
+   *                  in the order of their first occurrence
+   * @param accuracy  as for findTimeSync()
+   * @return 0 if all entries of results have E::OK. Otherwise -1, with err
+   *         set to:
+   *     E::PARTIAL     Some logs failed or only got an approximate answer;
+   *                    see the status of their entries in results.
+   *     E::NOBUFS      Too many requests were pending to be delivered to
+   *                    Workers; results is left untouched.
+   */
+  virtual int findTimeBulkSync(
+      std::vector<logid_t> logids,
+      std::chrono::milliseconds timestamp,
+      std::vector<FindTimeBulkResult>* results,
+      FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
+
+  /**
+   * A non-blocking version of findTimeBulkSync().
+   *
+   * @param cb  will be called once every log has its outcome, with E::OK if
+   *            all of them succeeded and E::PARTIAL otherwise.
+   * @return 0 if the request was successfully scheduled, -1 otherwise.
+   */
+  virtual int
+  findTimeBulk(std::vector<logid_t> logids,
+               std::chrono::milliseconds timestamp,
+               find_time_bulk_callback_t cb,
+               FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
+
   /**
    * A non-blocking version of findKeySync().
    *
@@ -843,6 +999,79 @@ class Client {
   virtual int getTailAttributes(logid_t logid,
                                 get_tail_attributes_callback_t cb) noexcept = 0;
 
+  /**
+   * Like getTailAttributesSync(), for many logs at once. Meant for callers
+   * that need the tails of thousands of logs, e.g. to checkpoint them.
+   *
+   * Logs are grouped by the node SequencerLocator picks to run their
+   * sequencer, and each of these nodes gets a few GET_TAIL_ATTRIBUTES_BULK
+   * messages instead of one GET_SEQ_STATE per log. A node only answers such a
+   * message from the sequencers it already runs, without checking whether
+   * they were preempted by a sequencer on another node (the consistency
+   * trade-off GET_SEQ_STATE makes with SKIP_REMOTE_PREEMPTION_CHECK). The
+   * logs it can't answer for, e.g. because their sequencer isn't active yet,
+   * are then looked up the way getTailAttributes() does it, so the cost of
+   * the call is proportional to the number of sequencer nodes in the common
+   * case, and never worse than calling getTailAttributes() for every log.
+   *
+   * @param logids  logs to get the tail attributes of. Duplicates are
+   *                ignored.
+   * @param results on return, has one entry per distinct log of logids, in
+   *                the order of their first occurrence. Metadata logs are
+   *                supported.
+   * @return 0 if the tail attributes of all logs were fetched. Otherwise -1,
+   *         with err set to:
+   *     E::PARTIAL     Some logs failed; see the status of their entries in
+   *                    results.
+   *     E::NOBUFS, E::SHUTDOWN, E::INTERNAL  The request could not be
+   *                    posted, as for getTailAttributesSync(); results is
+   *                    left untouched.
+   */
+  virtual int getTailAttributesBulkSync(
+      std::vector<logid_t> logids,
+      std::vector<LogTailAttributesResult>* results) noexcept = 0;
+
+  /**
+   * A non-blocking version of getTailAttributesBulkSync().
+   *
+   * @param cb  will be called once every log has its outcome, with E::OK if
+   *            all of them succeeded and E::PARTIAL otherwise.
+   * @return 0 if the request was successfully scheduled, -1 otherwise.
+   */
+  virtual int
+  getTailAttributesBulk(std::vector<logid_t> logids,
+                        get_tail_attributes_bulk_callback_t cb) noexcept = 0;
+
+  /**
+   * Return the last released record of a tail optimized log (see
+   * LogAttributes::tailOptimized), as kept by its sequencer. Takes a single
+   * round trip to the sequencer node and, unlike reading the tail with a
+   * Reader, doesn't touch storage nodes.
+   *
+   * @param logid is the ID of the log whose last record to read
+   * @return      the last record of the log, or nullptr on error and err is
+   *              set to one of the errors of getTailAttributesSync(), or:
+   *     E::EMPTY               no record was released in the log yet;
+   *     E::NOTSUPPORTEDLOG     the sequencer doesn't keep the payload of the
+   *                            tail record, e.g. because the log is not tail
+   *                            optimized;
+   *     E::MALFORMED_RECORD    the tail record received is malformed;
+   *     E::CHECKSUM_MISMATCH   the payload failed checksum verification.
+   */
+  virtual std::unique_ptr<DataRecord>
+  readLogTailSync(logid_t logid) noexcept = 0;
+
+  /**
+   * A non-blocking version of readLogTailSync().
+   *
+   * @param cb  will be called with the last record of the log or with an
+   *            error. The possible status values are the same as for
+   *            readLogTailSync().
+   * @return 0 if the request was successfully scheduled, -1 otherwise.
+   */
+  virtual int readLogTail(logid_t logid,
+                          read_log_tail_callback_t cb) noexcept = 0;
+
   /**
    * Return current attributes of the head of the log.
    * See LogHeadAttributes.h docs about possible head attributes.
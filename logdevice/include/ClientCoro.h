@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <folly/Function.h>
+#include <folly/Optional.h>
+#include <folly/experimental/coro/Coroutine.h>
+#include <folly/experimental/coro/Task.h>
+
+#include "logdevice/include/Client.h"
+
+/**
+ * @file folly::coro::Task-returning variants of some of the non-blocking
+ *       Client operations. They are an alternative to the *Sync() methods
+ *       that doesn't tie up a thread per outstanding call, and to callbacks
+ *       that don't compose.
+ *
+ *       Each task issues the request through the corresponding callback
+ *       method of Client when it is first awaited. The callback, which runs
+ *       on a client worker thread, resumes the awaiting coroutine directly;
+ *       there is no intermediate Promise/Future or thread. As with any
+ *       folly::coro::Task, the caller then continues on its own executor
+ *       (or right on the worker thread if that executor is inline, in which
+ *       case it must not block).
+ *
+ *       Errors are reported in the returned status rather than through
+ *       logdevice::err, which is thread-local and so meaningless after the
+ *       coroutine is resumed on another thread. If the request couldn't be
+ *       submitted at all, the status is what the callback method set err
+ *       to (e.g. E::NOBUFS).
+ *
+ *       `client` is taken by reference and must outlive the task.
+ */
+
+namespace facebook { namespace logdevice {
+
+struct AppendResult {
+  // E::OK or one of the errors of Client::appendSync()
+  Status status;
+  // LSN assigned to the record, LSN_INVALID on failure
+  lsn_t lsn;
+  // timestamp assigned to the record
+  std::chrono::milliseconds timestamp;
+};
+
+struct FindTimeResult {
+  // see Client::findTimeSync()
+  Status status;
+  lsn_t lsn;
+};
+
+struct TailAttributesResult {
+  // see Client::getTailAttributesSync()
+  Status status;
+  std::unique_ptr<LogTailAttributes> attributes;
+};
+
+struct ReadLogTailResult {
+  // see Client::readLogTailSync()
+  Status status;
+  std::unique_ptr<DataRecord> record;
+};
+
+struct DataSizeResult {
+  // see Client::dataSizeSync()
+  Status status;
+  size_t size;
+};
+
+namespace detail {
+
+/**
+ * Awaitable that issues a request through a Client callback method when the
+ * awaiting coroutine suspends, and resumes it from the callback.
+ */
+template <typename Result>
+class ClientRequestAwaitable {
+ public:
+  // Issues the request, arranging for complete() to be called with its
+  // outcome, and returns 0. Returns -1 with err set if the request could not
+  // be issued, in which case complete() must never be called.
+  using Start = folly::Function<int(ClientRequestAwaitable*)>;
+  // Makes a Result out of the err set by a failed Start.
+  using OnFailure = folly::Function<Result(Status)>;
+
+  ClientRequestAwaitable(Start start, OnFailure on_failure)
+      : start_(std::move(start)), on_failure_(std::move(on_failure)) {}
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+
+  bool await_suspend(folly::coro::coroutine_handle<> handle) {
+    handle_ = handle;
+    // The callback may resume (and complete, destroying this awaitable)
+    // the coroutine on another thread before start() returns, so nothing
+    // owned by the awaitable can be used after a successful start().
+    Start start = std::move(start_);
+    if (start(this) == 0) {
+      return true;
+    }
+    result_ = on_failure_(err);
+    return false;
+  }
+
+  Result await_resume() {
+    return std::move(result_.value());
+  }
+
+  void complete(Result result) {
+    result_ = std::move(result);
+    handle_.resume();
+  }
+
+ private:
+  Start start_;
+  OnFailure on_failure_;
+  folly::coro::coroutine_handle<> handle_;
+  folly::Optional<Result> result_;
+};
+
+} // namespace detail
+
+/**
+ * Appends a record to the log. See Client::append().
+ */
+inline folly::coro::Task<AppendResult>
+co_append(Client& client,
+          logid_t logid,
+          std::string payload,
+          AppendAttributes attrs = AppendAttributes()) {
+  using Awaitable = detail::ClientRequestAwaitable<AppendResult>;
+  co_return co_await Awaitable(
+      [&](Awaitable* req) {
+        return client.append(
+            logid,
+            std::move(payload),
+            [req](Status st, const DataRecord& r) {
+              req->complete(AppendResult{st, r.attrs.lsn, r.attrs.timestamp});
+            },
+            std::move(attrs));
+      },
+      [](Status st) {
+        return AppendResult{st, LSN_INVALID, std::chrono::milliseconds(0)};
+      });
+}
+
+/**
+ * Finds the LSN of the first record with a timestamp of at least
+ * `timestamp`. See Client::findTimeSync().
+ */
+inline folly::coro::Task<FindTimeResult>
+co_findTime(Client& client,
+            logid_t logid,
+            std::chrono::milliseconds timestamp,
+            FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) {
+  using Awaitable = detail::ClientRequestAwaitable<FindTimeResult>;
+  co_return co_await Awaitable(
+      [&](Awaitable* req) {
+        return client.findTime(
+            logid,
+            timestamp,
+            [req](Status st, lsn_t lsn) {
+              req->complete(FindTimeResult{st, lsn});
+            },
+            accuracy);
+      },
+      [](Status st) { return FindTimeResult{st, LSN_INVALID}; });
+}
+
+/**
+ * Gets the attributes of the tail of the log. See
+ * Client::getTailAttributesSync().
+ */
+inline folly::coro::Task<TailAttributesResult>
+co_getTailAttributes(Client& client, logid_t logid) {
+  using Awaitable = detail::ClientRequestAwaitable<TailAttributesResult>;
+  co_return co_await Awaitable(
+      [&](Awaitable* req) {
+        return client.getTailAttributes(
+            logid,
+            [req](Status st, std::unique_ptr<LogTailAttributes> attributes) {
+              req->complete(TailAttributesResult{st, std::move(attributes)});
+            });
+      },
+      [](Status st) { return TailAttributesResult{st, nullptr}; });
+}
+
+/**
+ * Reads the last record of a tail optimized log from its sequencer. See
+ * Client::readLogTailSync().
+ */
+inline folly::coro::Task<ReadLogTailResult> co_readLogTail(Client& client,
+                                                           logid_t logid) {
+  using Awaitable = detail::ClientRequestAwaitable<ReadLogTailResult>;
+  co_return co_await Awaitable(
+      [&](Awaitable* req) {
+        return client.readLogTail(
+            logid, [req](Status st, std::unique_ptr<DataRecord> record) {
+              req->complete(ReadLogTailResult{st, std::move(record)});
+            });
+      },
+      [](Status st) { return ReadLogTailResult{st, nullptr}; });
+}
+
+/**
+ * Estimates the amount of data in the log between `start` and `end`. See
+ * Client::dataSizeSync().
+ */
+inline folly::coro::Task<DataSizeResult>
+co_dataSize(Client& client,
+            logid_t logid,
+            std::chrono::milliseconds start,
+            std::chrono::milliseconds end,
+            DataSizeAccuracy accuracy = DataSizeAccuracy::APPROXIMATE) {
+  using Awaitable = detail::ClientRequestAwaitable<DataSizeResult>;
+  co_return co_await Awaitable(
+      [&](Awaitable* req) {
+        return client.dataSize(
+            logid, start, end, accuracy, [req](Status st, size_t size) {
+              req->complete(DataSizeResult{st, size});
+            });
+      },
+      [](Status st) { return DataSizeResult{st, 0}; });
+}
+
+/**
+ * Trims the log up to and including `lsn`. See Client::trimSync().
+ *
+ * @return E::OK on success, otherwise one of the errors of trimSync()
+ */
+inline folly::coro::Task<Status> co_trim(Client& client,
+                                         logid_t logid,
+                                         lsn_t lsn) {
+  using Awaitable = detail::ClientRequestAwaitable<Status>;
+  co_return co_await Awaitable(
+      [&](Awaitable* req) {
+        return client.trim(
+            logid, lsn, [req](Status st) { req->complete(st); });
+      },
+      [](Status st) { return st; });
+}
+
+}} // namespace facebook::logdevice
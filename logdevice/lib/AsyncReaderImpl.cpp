@@ -7,7 +7,11 @@
  */
 #include "logdevice/lib/AsyncReaderImpl.h"
 
+#include <algorithm>
+#include <iterator>
+#include <shared_mutex>
 #include <thread>
+#include <variant>
 
 #include <folly/Memory.h>
 
@@ -25,12 +29,15 @@
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
 
+using Compression = BufferedWriter::Options::Compression;
+
 AsyncReaderImpl::AsyncReaderImpl(std::shared_ptr<ClientImpl> client,
                                  ssize_t buffer_size)
     : client_(std::move(client)),
@@ -40,19 +47,29 @@ AsyncReaderImpl::AsyncReaderImpl(std::shared_ptr<ClientImpl> client,
                             : static_cast<size_t>(buffer_size)) {}
 
 AsyncReaderImpl::~AsyncReaderImpl() {
+  {
+    // Waits for any read stream move in progress, and prevents new ones.
+    std::lock_guard<std::mutex> lock(rebalancer_->mutex);
+    rebalancer_->reader = nullptr;
+  }
+
   // The destructor should ensure that all reading is stopped.
   folly::SharedMutex::WriteHolder guard(log_state_mutex_);
 
   Semaphore sem;
   int to_wait = 0;
   std::vector<ReadingHandle> to_destroy_on_this_thread;
+  // Readers of many logs stop them all here; post the StopReadingRequests in
+  // one batch so that each worker is woken up once.
+  std::vector<std::unique_ptr<Request>> stop_requests;
   Worker* w = Worker::onThisThread(false);
 
   auto destroy = [&](ReadingHandle handle) {
     if (w && w->idx_ == handle.worker_id) {
       to_destroy_on_this_thread.push_back(handle);
     } else {
-      postStopReadingRequest(handle, [&]() { sem.post(); });
+      stop_requests.push_back(
+          std::make_unique<StopReadingRequest>(handle, [&]() { sem.post(); }));
       ++to_wait;
     }
   };
@@ -73,6 +90,11 @@ AsyncReaderImpl::~AsyncReaderImpl() {
     }
   }
 
+  size_t posted = processor_->postImportantRequests(stop_requests);
+  // postImportantRequests() can only fail during Client shutdown. But it's
+  // illegal to destroy a Client while it has an AsyncReader.
+  ld_check(posted == stop_requests.size());
+
   for (ReadingHandle h : to_destroy_on_this_thread) {
     StopReadingRequest req(h, [] {});
     req.execute();
@@ -91,6 +113,13 @@ AsyncReaderImpl::~AsyncReaderImpl() {
 void AsyncReaderImpl::setRecordCallback(
     std::function<bool(std::unique_ptr<DataRecord>&)> cb) {
   record_callback_ = std::move(cb);
+  record_batch_callback_ = nullptr;
+}
+
+void AsyncReaderImpl::setRecordBatchCallback(
+    std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)> cb) {
+  record_batch_callback_ = std::move(cb);
+  record_callback_ = nullptr;
 }
 
 void AsyncReaderImpl::setGapCallback(std::function<bool(const GapRecord&)> cb) {
@@ -198,10 +227,12 @@ bool AsyncReaderImpl::recordCallbackWrapper(
   // must be a DataRecordOwnsPayload. Downcast so we can access the metadata.
   ld_assert(dynamic_cast<DataRecordOwnsPayload*>(record.get()) != nullptr);
 
-  if (!record_callback_) {
+  if (!record_callback_ && !record_batch_callback_) {
     return true;
   }
 
+  maybeRebalance();
+
   if (buffered_delivery_failed_.load()) {
     // We may have buffered decoded records from a previous batch that we need
     // to attempt to redeliver.  If so, drainBufferedRecords() will deliver
@@ -225,7 +256,7 @@ bool AsyncReaderImpl::recordCallbackWrapper(
       decode_buffered_writes_ && !without_payload_) {
     return handleBufferedWrite(record);
   } else {
-    bool rv = record_callback_(record);
+    bool rv = deliverToApplication(record);
     if (!rv) {
       RATELIMIT_DEBUG(std::chrono::seconds(10),
                       10,
@@ -257,7 +288,7 @@ int AsyncReaderImpl::startReading(logid_t log_id,
     return -1;
   }
 
-  if (!record_callback_) {
+  if (!record_callback_ && !record_batch_callback_) {
     ld_error("called without specifying record callback for log_id %lu",
              log_id.val_);
     err = E::INVALID_PARAM;
@@ -285,10 +316,43 @@ int AsyncReaderImpl::startReading(logid_t log_id,
 
   // Now construct the ClientReadStream object and pass it to a worker thread
   // by way of a StartReadingRequest.
+  read_stream_id_t rsid = processor_->issueReadStreamID();
+  auto read_stream = createReadStream(log_id, rsid, from, until, attrs);
 
-  auto settings = processor_->settings();
+  // Select a worker thread to route the StartReadingRequest to.  We need to
+  // remember it so that we can later route a StopReadingRequest to the same
+  // thread.
+  //
+  // Use load-aware worker assignment to avoid pathological cases like
+  // #7621815.
+  worker_id_t worker_id = processor_->selectWorkerLoadAware();
+  ReadingHandle handle = {worker_id, rsid};
 
-  read_stream_id_t rsid = processor_->issueReadStreamID();
+  {
+    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
+    log_states_.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(log_id),
+                        std::forward_as_tuple(handle, until, attrs));
+  }
+
+  std::unique_ptr<Request> req = std::make_unique<StartReadingRequest>(
+      worker_id, log_id, std::move(read_stream));
+
+  int rv = processor_->postRequest(req);
+  if (rv != 0) {
+    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
+    log_states_.erase(log_id);
+  }
+  return rv;
+}
+
+std::unique_ptr<ClientReadStream>
+AsyncReaderImpl::createReadStream(logid_t log_id,
+                                  read_stream_id_t rsid,
+                                  lsn_t from,
+                                  lsn_t until,
+                                  const ReadStreamAttributes* attrs) {
+  auto settings = processor_->settings();
 
   namespace arg = std::placeholders;
   auto deps = std::make_unique<ClientReadStreamDependencies>(
@@ -357,31 +421,7 @@ int AsyncReaderImpl::startReading(logid_t log_id,
     read_stream->includeByteOffset();
   }
 
-  // Select a worker thread to route the StartReadingRequest to.  We need to
-  // remember it so that we can later route a StopReadingRequest to the same
-  // thread.
-  //
-  // Use load-aware worker assignment to avoid pathological cases like
-  // #7621815.
-  worker_id_t worker_id = processor_->selectWorkerLoadAware();
-  ReadingHandle handle = {worker_id, rsid};
-
-  {
-    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
-    log_states_.emplace(std::piecewise_construct,
-                        std::forward_as_tuple(log_id),
-                        std::forward_as_tuple(handle));
-  }
-
-  std::unique_ptr<Request> req = std::make_unique<StartReadingRequest>(
-      worker_id, log_id, std::move(read_stream));
-
-  int rv = processor_->postRequest(req);
-  if (rv != 0) {
-    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
-    log_states_.erase(log_id);
-  }
-  return rv;
+  return read_stream;
 }
 
 int AsyncReaderImpl::stopReading(logid_t log_id,
@@ -463,12 +503,19 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   const RECORD_flags_t flags = record_with_attributes->flags_;
   record_with_attributes = nullptr; // no longer safe
 
-  auto decoder = std::make_shared<BufferedWriteDecoderImpl>();
+  std::shared_ptr<BufferedWriteDecoderImpl> decoder;
   std::vector<Payload> payloads;
-  // We use an overload of BufferedWriteDecoderImpl that does not claim
-  // ownership of the input DataRecord, in case the client rejects delivery
-  // and we need to return the record to ClientReadStream intact.
-  int rv = decoder->decodeOne(*record, payloads);
+  int rv;
+  if (!decodeInBackground(*record, decoder, payloads, rv)) {
+    return false;
+  }
+  if (!decoder) {
+    decoder = std::make_shared<BufferedWriteDecoderImpl>();
+    // We use an overload of BufferedWriteDecoderImpl that does not claim
+    // ownership of the input DataRecord, in case the client rejects delivery
+    // and we need to return the record to ClientReadStream intact.
+    rv = decoder->decodeOne(*record, payloads);
+  }
   if (rv != 0) {
     // Whoops, decoding failed. This is tragic and unlikely with checksums
     // but let's generate a DATALOSS gap to inform the client.
@@ -480,62 +527,174 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   }
 
   // Decoding succeeded. Now we need to create a DataRecordOwnsPayload for
-  // each original record, and call the callback for each one.
+  // each original record, and pass them to the application.
   int batch_offset = 0;
+  std::vector<std::unique_ptr<DataRecord>> sub_records;
+  sub_records.reserve(payloads.size());
+  for (const Payload& payload : payloads) {
+    sub_records.push_back(std::make_unique<DataRecordOwnsPayload>(
+        log_id,
+        payload,
+        decoder, // shared ownership of the decoder
+        attrs.lsn,
+        attrs.timestamp,
+        flags & ~RECORD_Header::BUFFERED_WRITER_BLOB,
+        nullptr, // no rebuilding metadata
+        batch_offset++,
+        // Report the same offsets for all subrecords. This may be
+        // confusing but we don't have better options since offsets
+        // currently count the bytes of compressed batches.
+        attrs.offsets));
+  }
+
+  const size_t consumed = deliverToApplication(sub_records);
+  if (consumed == sub_records.size()) {
+    return true;
+  }
+
   // If the client callback starts rejecting delivery halfway through the
   // batch, we buffer the rest of the batch for redelivery next time
   // ClientReadStream pokes us.
-  bool buffer_rest = false;
-  // `guard_map' and `log_state' are lazily initialized in the rare case of
-  // the application rejecting delivery.
-  folly::SharedMutex::ReadHolder guard_map(nullptr);
-  LogState* log_state = nullptr;
+  RATELIMIT_DEBUG(std::chrono::seconds(10),
+                  10,
+                  "Record callback rejected sub-record of record %lu%s",
+                  log_id.val_,
+                  lsn_to_string(attrs.lsn).c_str());
+  buffered_delivery_failed_.store(true);
+  folly::SharedMutex::ReadHolder guard_map(log_state_mutex_);
+  auto it = log_states_.find(log_id);
+  if (it == log_states_.end() ||
+      it->second.handle.worker_id != Worker::onThisThread()->idx_) {
+    // Corner case -- must have stopped reading the log but word hasn't
+    // reached ClientReadStream yet.  Pretend all is fine.
+    return true;
+  }
+  LogState& log_state = it->second;
+  ld_check(log_state.pre_queue.empty());
+  std::move(sub_records.begin() + consumed,
+            sub_records.end(),
+            std::back_inserter(log_state.pre_queue));
+  return false;
+}
 
-  for (const Payload& payload : payloads) {
-    std::unique_ptr<DataRecord> sub_record =
-        std::make_unique<DataRecordOwnsPayload>(
-            log_id,
-            payload,
-            decoder, // shared ownership of the decoder
-            attrs.lsn,
-            attrs.timestamp,
-            flags & ~RECORD_Header::BUFFERED_WRITER_BLOB,
-            nullptr, // no rebuilding metadata
-            batch_offset++,
-            // Report the same offsets for all subrecords. This may be
-            // confusing but we don't have better options since offsets
-            // currently count the bytes of compressed batches.
-            attrs.offsets);
-    if (buffer_rest) {
-      // The application already rejected a previous record in this batch,
-      // just buffer for later redelivery
-      log_state->pre_queue.push_back(std::move(sub_record));
-      continue;
+bool AsyncReaderImpl::decodeInBackground(
+    const DataRecord& record,
+    std::shared_ptr<BufferedWriteDecoderImpl>& decoder,
+    std::vector<Payload>& payloads,
+    int& rv) {
+  const size_t threshold =
+      Worker::settings().client_bg_decompression_bytes_threshold;
+  if (threshold == 0 || record.payload.size() < threshold) {
+    return true;
+  }
+  Compression compression;
+  if (BufferedWriteDecoderImpl::getCompression(record, &compression) != 0 ||
+      compression == Compression::NONE) {
+    // Nothing to offload, decoding an uncompressed batch is cheap.
+    return true;
+  }
+  // The background thread needs its own reference to the blob since
+  // ClientReadStream may drop the record in the meantime.
+  const auto& owner = static_cast<const DataRecordOwnsPayload&>(record).owner_;
+  const PayloadHolder* holder = std::get_if<PayloadHolder>(&owner);
+  if (holder == nullptr) {
+    return true;
+  }
+
+  folly::SharedMutex::ReadHolder guard_map(log_state_mutex_);
+  auto it = log_states_.find(record.logid);
+  if (it == log_states_.end() ||
+      it->second.handle.worker_id != Worker::onThisThread()->idx_) {
+    return true;
+  }
+  LogState& state = it->second;
+
+  if (state.bg_decode && state.bg_decode->lsn == record.attrs.lsn) {
+    if (!state.bg_decode->done.load()) {
+      // Still decoding. ClientReadStream keeps the record and we'll ask it to
+      // redeliver once the background thread is done.
+      return false;
     }
-    if (!record_callback_(sub_record)) {
-      RATELIMIT_DEBUG(std::chrono::seconds(10),
-                      10,
-                      "Record callback rejected sub-record of record %lu%s",
-                      log_id.val_,
-                      lsn_to_string(attrs.lsn).c_str());
-      // We'll buffer the rest.
-      buffered_delivery_failed_.store(true);
-      buffer_rest = true;
-      guard_map = folly::SharedMutex::ReadHolder(log_state_mutex_);
-      auto it = log_states_.find(log_id);
-      if (it == log_states_.end() ||
-          it->second.handle.worker_id != Worker::onThisThread()->idx_) {
-        // Corner case -- must have stopped reading the log but word hasn't
-        // reached ClientReadStream yet.  Pretend all is fine.
-        return true;
+    std::shared_ptr<BackgroundDecode> result = std::move(state.bg_decode);
+    rv = result->rv;
+    decoder = std::move(result->decoder);
+    payloads = std::move(result->payloads);
+    if (!decoder) {
+      decoder = std::make_shared<BufferedWriteDecoderImpl>();
+    }
+    return true;
+  }
+
+  // Either nothing in flight or a leftover from a batch ClientReadStream
+  // won't redeliver (e.g. it rewound), which we drop.
+  auto job = std::make_shared<BackgroundDecode>(record.attrs.lsn);
+  bool enqueued = processor_->enqueueToBackground(
+      [job,
+       blob = *holder, // only bumps the refcount
+       processor = processor_,
+       handle = state.handle]() mutable {
+        auto bg_decoder = std::make_shared<BufferedWriteDecoderImpl>();
+        job->rv = bg_decoder->decodeOne(Slice(blob.getPayload()),
+                                        job->payloads,
+                                        nullptr,
+                                        /* copy_blob_if_uncompressed */ false,
+                                        &blob);
+        job->decoder = std::move(bg_decoder);
+        job->done.store(true);
+        // Processor outlives its background threads. If posting fails,
+        // ClientReadStream's redelivery timer will pick the record up a bit
+        // later.
+        std::unique_ptr<Request> req =
+            std::make_unique<ResumeReadingRequest>(handle);
+        processor->postRequest(req);
+      });
+  if (!enqueued) {
+    // Background queue is full, decode inline.
+    state.bg_decode.reset();
+    return true;
+  }
+  state.bg_decode = std::move(job);
+  WORKER_STAT_INCR(client.bg_decompressions);
+  return false;
+}
+
+bool AsyncReaderImpl::deliverToApplication(
+    std::unique_ptr<DataRecord>& record) {
+  if (!record_batch_callback_) {
+    return record_callback_(record);
+  }
+  // Reused to avoid allocating a vector per record. Workers deliver records
+  // concurrently, hence thread-local.
+  static thread_local std::vector<std::unique_ptr<DataRecord>> single;
+  ld_check(single.empty());
+  single.push_back(std::move(record));
+  bool rv = record_batch_callback_(single) || single[0] == nullptr;
+  if (!rv) {
+    record = std::move(single[0]);
+  }
+  single.clear();
+  return rv;
+}
+
+size_t AsyncReaderImpl::deliverToApplication(
+    std::vector<std::unique_ptr<DataRecord>>& records) {
+  if (!record_batch_callback_) {
+    for (size_t i = 0; i < records.size(); ++i) {
+      if (!record_callback_(records[i])) {
+        return i;
       }
-      log_state = &it->second;
-      ld_check(log_state->pre_queue.empty());
-      log_state->pre_queue.push_back(std::move(sub_record));
     }
+    return records.size();
+  }
+
+  if (record_batch_callback_(records)) {
+    return records.size();
+  }
+  size_t consumed = 0;
+  while (consumed < records.size() && records[consumed] == nullptr) {
+    ++consumed;
   }
-  // We successfully consumed the batch if we didn't have to buffer
-  return !buffer_rest;
+  return consumed;
 }
 
 int AsyncReaderImpl::drainBufferedRecords(logid_t log_id,
@@ -582,7 +741,7 @@ int AsyncReaderImpl::drainBufferedRecords(logid_t log_id,
       record_mismatch = true;
     }
 
-    if (!record_callback_(record)) {
+    if (!deliverToApplication(record)) {
       RATELIMIT_DEBUG(std::chrono::seconds(10),
                       10,
                       "Record callback rejected record %lu%s",
@@ -606,4 +765,252 @@ int AsyncReaderImpl::drainBufferedRecords(logid_t log_id,
   return record_mismatch ? 0 : count;
 }
 
+void AsyncReaderImpl::maybeRebalance() {
+  const auto interval =
+      Worker::settings().client_read_stream_rebalance_interval;
+  if (interval.count() <= 0) {
+    return;
+  }
+  // Don't look at the clock on every record.
+  static thread_local uint32_t calls = 0;
+  if (++calls % 256 != 0) {
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(rebalancer_->mutex);
+    if (!rebalancer_->reader || rebalancer_->round_in_progress ||
+        now - rebalancer_->last_round < interval) {
+      return;
+    }
+    rebalancer_->nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+    if (rebalancer_->nworkers < 2) {
+      rebalancer_->last_round = now;
+      return;
+    }
+    rebalancer_->round_in_progress = true;
+  }
+
+  std::map<worker_id_t, std::vector<std::pair<logid_t, ReadingHandle>>>
+      per_worker;
+  {
+    // Don't block the Worker if the destructor or stopReading() holds the
+    // lock, just skip this round.
+    std::shared_lock<folly::SharedMutex> guard(
+        log_state_mutex_, std::try_to_lock);
+    if (guard.owns_lock()) {
+      for (const auto& kv : log_states_) {
+        per_worker[kv.second.handle.worker_id].emplace_back(
+            kv.first, kv.second.handle);
+      }
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(rebalancer_->mutex);
+    rebalancer_->samples.clear();
+    rebalancer_->pending_workers = per_worker.size();
+    if (per_worker.empty()) {
+      rebalancer_->round_in_progress = false;
+      rebalancer_->last_round = now;
+      return;
+    }
+  }
+
+  std::weak_ptr<Rebalancer> weak(rebalancer_);
+  for (auto& kv : per_worker) {
+    std::unique_ptr<Request> req = FuncRequest::make(
+        kv.first,
+        WorkerType::GENERAL,
+        RequestType::MOVE_READ_STREAM,
+        [weak, streams = std::move(kv.second)] {
+          AllClientReadStreams& all =
+              Worker::onThisThread()->clientReadStreams();
+          std::vector<RebalanceSample> samples;
+          for (const auto& stream : streams) {
+            ClientReadStream* crs =
+                all.getStream(stream.second.read_stream_id);
+            if (crs) {
+              samples.push_back(RebalanceSample{
+                  stream.first, stream.second, crs->getBytesDelivered()});
+            }
+          }
+          if (auto rebalancer = weak.lock()) {
+            onRebalanceSamples(rebalancer, std::move(samples));
+          }
+        });
+    if (processor_->postRequest(req) != 0) {
+      onRebalanceSamples(rebalancer_, {});
+    }
+  }
+}
+
+void AsyncReaderImpl::onRebalanceSamples(
+    const std::shared_ptr<Rebalancer>& rebalancer,
+    std::vector<RebalanceSample> samples) {
+  // Move streams until the busiest Worker is within this factor of the
+  // average.
+  constexpr double kMaxImbalance = 1.25;
+  // Restarting a stream isn't free, don't move too many at once.
+  constexpr size_t kMaxMovesPerRound = 8;
+
+  std::lock_guard<std::mutex> lock(rebalancer->mutex);
+  if (!rebalancer->reader || !rebalancer->round_in_progress) {
+    return;
+  }
+  std::move(samples.begin(),
+            samples.end(),
+            std::back_inserter(rebalancer->samples));
+  if (--rebalancer->pending_workers > 0) {
+    return;
+  }
+
+  // All Workers reported. Compute bytes/sec of each stream since the last
+  // round; streams we haven't seen before only get a baseline this time.
+  const auto now = std::chrono::steady_clock::now();
+  const double elapsed_sec =
+      std::chrono::duration<double>(now - rebalancer->last_round).count();
+  const bool have_baseline = !rebalancer->last_bytes.empty();
+  std::unordered_map<read_stream_id_t, size_t, read_stream_id_t::Hash>
+      new_bytes;
+  struct StreamRate {
+    const RebalanceSample* sample;
+    double rate;
+  };
+  std::vector<std::vector<StreamRate>> streams(rebalancer->nworkers);
+  std::vector<double> load(rebalancer->nworkers, 0);
+  double total = 0;
+  for (const RebalanceSample& sample : rebalancer->samples) {
+    const read_stream_id_t rsid = sample.handle.read_stream_id;
+    new_bytes[rsid] = sample.bytes_delivered;
+    auto it = rebalancer->last_bytes.find(rsid);
+    const int w = sample.handle.worker_id.val_;
+    if (it == rebalancer->last_bytes.end() || w >= rebalancer->nworkers ||
+        sample.bytes_delivered < it->second) {
+      continue;
+    }
+    const double rate = (sample.bytes_delivered - it->second) / elapsed_sec;
+    streams[w].push_back(StreamRate{&sample, rate});
+    load[w] += rate;
+    total += rate;
+  }
+  rebalancer->last_bytes = std::move(new_bytes);
+  rebalancer->last_round = now;
+  rebalancer->round_in_progress = false;
+  if (!have_baseline || total <= 0) {
+    return;
+  }
+
+  const double average = total / rebalancer->nworkers;
+  size_t moves = 0;
+  while (moves < kMaxMovesPerRound) {
+    const int hi = std::max_element(load.begin(), load.end()) - load.begin();
+    const int lo = std::min_element(load.begin(), load.end()) - load.begin();
+    if (load[hi] <= average * kMaxImbalance) {
+      break;
+    }
+    // Move the busiest stream that doesn't make `lo' busier than `hi' was.
+    const double gap = load[hi] - load[lo];
+    auto best = streams[hi].end();
+    for (auto it = streams[hi].begin(); it != streams[hi].end(); ++it) {
+      if (it->rate > 0 && it->rate < gap &&
+          (best == streams[hi].end() || it->rate > best->rate)) {
+        best = it;
+      }
+    }
+    if (best == streams[hi].end()) {
+      break;
+    }
+    const RebalanceSample& sample = *best->sample;
+    load[hi] -= best->rate;
+    load[lo] += best->rate;
+    streams[hi].erase(best);
+    ++moves;
+
+    std::weak_ptr<Rebalancer> weak(rebalancer);
+    std::unique_ptr<Request> req = FuncRequest::make(
+        sample.handle.worker_id,
+        WorkerType::GENERAL,
+        RequestType::MOVE_READ_STREAM,
+        [weak,
+         log_id = sample.log_id,
+         handle = sample.handle,
+         target = worker_id_t(lo)] {
+          auto locked = weak.lock();
+          if (!locked) {
+            return;
+          }
+          std::lock_guard<std::mutex> guard(locked->mutex);
+          if (locked->reader) {
+            locked->reader->moveReadStream(log_id, handle, target);
+          }
+        });
+    rebalancer->reader->processor_->postRequest(req);
+  }
+}
+
+void AsyncReaderImpl::moveReadStream(logid_t log_id,
+                                     ReadingHandle handle,
+                                     worker_id_t target) {
+  Worker* w = Worker::onThisThread();
+  ld_check(w->idx_ == handle.worker_id);
+
+  // The destructor and stopReading() take this lock while waiting for or
+  // posting to Workers; don't wait for it on a Worker.
+  std::unique_lock<folly::SharedMutex> guard(log_state_mutex_,
+                                             std::try_to_lock);
+  if (!guard.owns_lock()) {
+    return;
+  }
+  auto it = log_states_.find(log_id);
+  if (it == log_states_.end() ||
+      it->second.handle.read_stream_id != handle.read_stream_id ||
+      it->second.handle.worker_id != handle.worker_id) {
+    // Stopped or restarted in the meantime.
+    return;
+  }
+  LogState& state = it->second;
+  if (!state.pre_queue.empty() || state.bg_decode) {
+    // Part of a batch is waiting for redelivery; try again next round.
+    return;
+  }
+  ClientReadStream* old_stream =
+      w->clientReadStreams().getStream(handle.read_stream_id);
+  if (!old_stream) {
+    return;
+  }
+  const lsn_t from = old_stream->getNextLSNToDeliver();
+  if (from > state.until) {
+    return;
+  }
+
+  // Nothing is delivered from the old stream from now on since we're on its
+  // Worker, and the new one starts right after the last delivered LSN.
+  const read_stream_id_t rsid = processor_->issueReadStreamID();
+  std::unique_ptr<Request> req = std::make_unique<StartReadingRequest>(
+      target,
+      log_id,
+      createReadStream(log_id,
+                       rsid,
+                       from,
+                       state.until,
+                       state.attrs.hasValue() ? state.attrs.get_pointer()
+                                              : nullptr));
+  if (processor_->postRequest(req) != 0) {
+    return;
+  }
+  w->clientReadStreams().erase(handle.read_stream_id);
+  state.handle = ReadingHandle{target, rsid};
+  WORKER_STAT_INCR(client.read_streams_rebalanced);
+  RATELIMIT_INFO(std::chrono::seconds(10),
+                 10,
+                 "Moved read stream of log %lu from worker %d to worker %d "
+                 "at %s",
+                 log_id.val_,
+                 handle.worker_id.val_,
+                 target.val_,
+                 lsn_to_string(from).c_str());
+}
+
 }} // namespace facebook::logdevice
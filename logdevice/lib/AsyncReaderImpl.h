@@ -8,10 +8,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
+#include <folly/Optional.h>
 #include <folly/SharedMutex.h>
 
 #include "logdevice/common/ReadStreamAttributes.h"
@@ -22,6 +25,8 @@
 
 namespace facebook { namespace logdevice {
 
+class BufferedWriteDecoderImpl;
+class ClientReadStream;
 class Semaphore;
 class Processor;
 
@@ -30,6 +35,9 @@ class AsyncReaderImpl : public AsyncReader {
   // see AsyncReader.h for all of these functions:
   void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) override;
+
+  void setRecordBatchCallback(
+      std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)>) override;
   void setGapCallback(std::function<bool(const GapRecord&)>) override;
   void setDoneCallback(std::function<void(logid_t)>) override;
   void setHealthChangeCallback(
@@ -66,6 +74,14 @@ class AsyncReaderImpl : public AsyncReader {
 
  private:
   void postStopReadingRequest(ReadingHandle handle, std::function<void()> cb);
+
+  // Creates the ClientReadStream for startReading().
+  std::unique_ptr<ClientReadStream>
+  createReadStream(logid_t log_id,
+                   read_stream_id_t rsid,
+                   lsn_t from,
+                   lsn_t until,
+                   const ReadStreamAttributes* attrs);
   void postStatisticsRequest(std::vector<ReadingHandle> handles,
                              std::function<void(size_t)> cb) const;
 
@@ -76,6 +92,40 @@ class AsyncReaderImpl : public AsyncReader {
   // Handles a record that is a buffered write and needs automatic decoding
   bool handleBufferedWrite(std::unique_ptr<DataRecord>& record);
 
+  // Result of decompressing a buffered write on a background thread.
+  struct BackgroundDecode {
+    explicit BackgroundDecode(lsn_t lsn) : lsn(lsn) {}
+    const lsn_t lsn;
+    // Set by the background thread after it's written `rv' and `payloads'.
+    std::atomic<bool> done{false};
+    int rv{-1};
+    std::shared_ptr<BufferedWriteDecoderImpl> decoder;
+    std::vector<Payload> payloads;
+  };
+
+  // If the batch in `record' should be decompressed on a background thread,
+  // either starts doing so or checks on the decoding already in progress.
+  // Returns true and fills `decoder' and `payloads' if the batch is decoded
+  // (or failed to decode, then `rv' is -1), or false if delivery of `record'
+  // must be retried later; ClientReadStream will be told to redeliver when
+  // decoding completes.  Returns true and leaves `decoder' empty if the batch
+  // should be decoded inline.
+  bool decodeInBackground(const DataRecord& record,
+                          std::shared_ptr<BufferedWriteDecoderImpl>& decoder,
+                          std::vector<Payload>& payloads,
+                          int& rv);
+
+  // Passes a record to whichever of record_callback_ and
+  // record_batch_callback_ is set. Same return value and contract as the
+  // record callback.
+  bool deliverToApplication(std::unique_ptr<DataRecord>& record);
+
+  // Passes consecutive records to the application, in one call if
+  // record_batch_callback_ is set. Returns the number of records consumed,
+  // which are a prefix of `records'; the rest are intact.
+  size_t
+  deliverToApplication(std::vector<std::unique_ptr<DataRecord>>& records);
+
   // Drains any BufferedWriter-originated records that were decoded by
   // handleBufferedWrite() but not successfully delivered to the application.
   // If there are such records, `batch' is expected to be the full batch
@@ -86,12 +136,33 @@ class AsyncReaderImpl : public AsyncReader {
   // buffered, >0 if some records were buffered and delivered.
   int drainBufferedRecords(logid_t log_id, const DataRecord& batch);
 
+  // Read stream rebalancing, see
+  // Settings::client_read_stream_rebalance_interval. maybeRebalance() is
+  // called on record delivery; every interval, it samples the bytes delivered
+  // by all read streams on their Workers, and onRebalanceSamples() moves
+  // streams from the busiest Workers to the least busy ones.
+  struct RebalanceSample {
+    logid_t log_id;
+    ReadingHandle handle;
+    size_t bytes_delivered;
+  };
+  struct Rebalancer;
+  void maybeRebalance();
+  static void onRebalanceSamples(const std::shared_ptr<Rebalancer>& rebalancer,
+                                 std::vector<RebalanceSample> samples);
+  // Runs on the Worker reading the log. Restarts the read stream on `target'
+  // from the next LSN the current stream would deliver, unless the log is
+  // being stopped or has decoded records waiting for redelivery.
+  void moveReadStream(logid_t log_id, ReadingHandle handle, worker_id_t target);
+
   // Shared pointer to the parent ClientImpl object.  Prevents it to be
   // destroyed while any of the AsyncReaders still exist.
   std::shared_ptr<ClientImpl> client_;
   Processor* processor_;
 
   std::function<bool(std::unique_ptr<DataRecord>&)> record_callback_;
+  std::function<bool(std::vector<std::unique_ptr<DataRecord>>&)>
+      record_batch_callback_;
   std::function<bool(const GapRecord&)> gap_callback_;
   std::function<void(logid_t)> done_callback_;
   std::function<void(logid_t, HealthChangeType)> health_change_callback_;
@@ -126,10 +197,22 @@ class AsyncReaderImpl : public AsyncReader {
   ClientReadStreamBufferType buffer_type_{ClientReadStreamBufferType::CIRCULAR};
 
   struct LogState {
-    explicit LogState(ReadingHandle handle) : handle(handle) {}
+    LogState(ReadingHandle handle,
+             lsn_t until,
+             const ReadStreamAttributes* attrs)
+        : handle(handle), until(until) {
+      if (attrs) {
+        this->attrs = *attrs;
+      }
+    }
     // ReadingHandle generated when we started reading, used to stop reading
-    // (which requires communication with Worker)
-    const ReadingHandle handle;
+    // (which requires communication with Worker). Changes when the read
+    // stream is moved to another Worker, with log_state_mutex_ held for
+    // writing.
+    ReadingHandle handle;
+    // startReading() arguments needed to recreate the read stream.
+    const lsn_t until;
+    folly::Optional<ReadStreamAttributes> attrs;
     // Connection health for the log as reported by ClientReadStream.  Read
     // from application thread, written on Worker thread (ClientReadStream
     // health callback).
@@ -137,6 +220,9 @@ class AsyncReaderImpl : public AsyncReader {
     // Records that were decoded from a buffered write but could not be
     // immediately delivered (application callback rejected them).
     std::deque<std::unique_ptr<DataRecord>> pre_queue;
+    // Buffered write being decompressed on a background thread, if any.
+    // Record delivery for the log waits for it, see decodeInBackground().
+    std::shared_ptr<BackgroundDecode> bg_decode;
   };
   // Logs currently being read from
   std::unordered_map<logid_t, LogState, logid_t::Hash> log_states_;
@@ -159,6 +245,25 @@ class AsyncReaderImpl : public AsyncReader {
   std::shared_ptr<PendingStops> pending_stops_ =
       std::make_shared<PendingStops>();
 
+  // State of read stream rebalancing, shared with Requests posted to Workers.
+  struct Rebalancer {
+    explicit Rebalancer(AsyncReaderImpl* reader) : reader(reader) {}
+    std::mutex mutex;
+    // Cleared by the destructor; Requests that find it null do nothing.
+    AsyncReaderImpl* reader;
+    int nworkers{0};
+    bool round_in_progress{false};
+    std::chrono::steady_clock::time_point last_round;
+    // Bytes delivered by each read stream at the end of the last round.
+    std::unordered_map<read_stream_id_t, size_t, read_stream_id_t::Hash>
+        last_bytes;
+    // Samples gathered so far in the current round, and the number of
+    // Workers yet to report.
+    std::vector<RebalanceSample> samples;
+    int pending_workers{0};
+  };
+  std::shared_ptr<Rebalancer> rebalancer_ = std::make_shared<Rebalancer>(this);
+
   // Use to gather info for a pending stats Request.
   // Trigger callback once there are no more leftover requests.
   struct RequestAcc {
@@ -10,6 +10,8 @@
 #include <folly/Memory.h>
 
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
+#include "logdevice/common/buffered_writer/ZstdDictionary.h"
+#include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
 
@@ -22,6 +24,16 @@ int BufferedWriteDecoder::getBatchSize(const DataRecord& record,
   return BufferedWriteDecoderImpl::getBatchSize(record, size_out);
 }
 
+int BufferedWriteDecoder::addZstdDictionary(std::string dictionary) {
+  auto dict = ZstdDictionaryRegistry::get().getOrAdd(
+      std::make_shared<const std::string>(std::move(dictionary)));
+  if (!dict) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  return 0;
+}
+
 int BufferedWriteDecoder::decode(
     std::vector<std::unique_ptr<DataRecord>>&& records,
     std::vector<Payload>& payloads_out) {
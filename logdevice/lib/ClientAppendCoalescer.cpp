@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/lib/ClientAppendCoalescer.h"
+
+#include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/lib/ClientImpl.h"
+
+namespace facebook { namespace logdevice {
+
+ClientAppendCoalescer::ClientAppendCoalescer(ClientImpl* client,
+                                             std::chrono::microseconds window,
+                                             size_t max_batch_bytes)
+    : client_(client), max_batch_bytes_(max_batch_bytes) {
+  BufferedWriter::LogOptions opts;
+  // Sent when the window expires (see setTimeTriggerOverride() below) or the
+  // batch is full.
+  opts.size_trigger = max_batch_bytes;
+  // Batches are small and short-lived, compression isn't worth the CPU.
+  opts.compression = Compression::NONE;
+  // Plain append semantics: no retries, the outcome goes to the callbacks.
+  opts.retry_count = 0;
+  opts.mode = BufferedWriter::Options::Mode::INDEPENDENT;
+  writer_ = std::make_unique<BufferedWriterImpl>(
+      new ProcessorProxy(&client->getProcessor()),
+      this,
+      [opts](logid_t) { return opts; },
+      /* memory_limit_mb */ -1,
+      client,
+      client->stats());
+  writer_->setTimeTriggerOverride(window);
+}
+
+ClientAppendCoalescer::~ClientAppendCoalescer() {
+  shutDown();
+}
+
+bool ClientAppendCoalescer::canCoalesce(size_t payload_size,
+                                        const AppendAttributes& attrs) const {
+  return payload_size < max_batch_bytes_ && attrs.optional_keys.empty() &&
+      !attrs.counters.hasValue();
+}
+
+int ClientAppendCoalescer::append(logid_t logid,
+                                  std::string payload,
+                                  append_callback_t cb) {
+  auto ctx = std::make_unique<append_callback_t>(std::move(cb));
+  int rv = writer_->append(
+      logid, std::move(payload), ctx.get(), AppendAttributes());
+  if (rv != 0) {
+    return -1;
+  }
+  ctx.release();
+  STAT_INCR(client_->stats(), client.append_coalesced);
+  return 0;
+}
+
+void ClientAppendCoalescer::shutDown() {
+  if (writer_) {
+    writer_->shutDown();
+  }
+}
+
+void ClientAppendCoalescer::onSuccess(logid_t log_id,
+                                      ContextSet contexts_and_payloads,
+                                      const DataRecordAttributes& attrs) {
+  int batch_offset = 0;
+  for (auto& ctx_payload : contexts_and_payloads) {
+    std::unique_ptr<append_callback_t> cb(
+        static_cast<append_callback_t*>(ctx_payload.first));
+    const std::string& payload = ctx_payload.second;
+    DataRecord record(log_id,
+                      Payload(payload.data(), payload.size()),
+                      attrs.lsn,
+                      attrs.timestamp,
+                      batch_offset++);
+    (*cb)(E::OK, record);
+  }
+}
+
+void ClientAppendCoalescer::onFailure(logid_t log_id,
+                                      ContextSet contexts_and_payloads,
+                                      Status status) {
+  for (auto& ctx_payload : contexts_and_payloads) {
+    std::unique_ptr<append_callback_t> cb(
+        static_cast<append_callback_t*>(ctx_payload.first));
+    const std::string& payload = ctx_payload.second;
+    DataRecord record(log_id, Payload(payload.data(), payload.size()));
+    (*cb)(status, record);
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "logdevice/include/BufferedWriter.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/types.h"
+
+/**
+ * @file ClientAppendCoalescer coalesces Client::append() calls for the same log
+ * that arrive within a short window (see Settings::append_coalescing) into one
+ * APPEND. It is a thin layer over an internal BufferedWriter that doesn't
+ * retry, so failure semantics stay those of a plain append, and fans the
+ * batch outcome out to the individual append callbacks.
+ *
+ * The batch is a BufferedWriter blob, which readers decode into the original
+ * records. All records of a batch share the LSN and timestamp reported to
+ * their callbacks; DataRecord::attrs.batch_offset tells them apart.
+ */
+
+namespace facebook { namespace logdevice {
+
+class BufferedWriterImpl;
+class ClientImpl;
+
+class ClientAppendCoalescer : public BufferedWriter::AppendCallback {
+ public:
+  ClientAppendCoalescer(ClientImpl* client,
+                        std::chrono::microseconds window,
+                        size_t max_batch_bytes);
+  ~ClientAppendCoalescer() override;
+
+  /**
+   * Whether an append can go through the coalescer. Appends with optional
+   * keys or counters can't, since a batch has a single set of attributes.
+   */
+  bool canCoalesce(size_t payload_size, const AppendAttributes& attrs) const;
+
+  /**
+   * Buffers an append. `cb` will be called with the outcome of the batch it
+   * ends up in.
+   *
+   * @return 0 on success, -1 on failure with err set as BufferedWriter
+   *         append() sets it
+   */
+  int append(logid_t logid, std::string payload, append_callback_t cb);
+
+  /**
+   * Fails buffered appends with E::SHUTDOWN and stops accepting new ones.
+   * Must be called before the Processor is shut down, not on a worker.
+   */
+  void shutDown();
+
+  void onSuccess(logid_t log_id,
+                 ContextSet contexts_and_payloads,
+                 const DataRecordAttributes& attrs) override;
+  void onFailure(logid_t log_id,
+                 ContextSet contexts_and_payloads,
+                 Status status) override;
+
+ private:
+  ClientImpl* const client_;
+  const size_t max_batch_bytes_;
+  std::unique_ptr<BufferedWriterImpl> writer_;
+};
+
+}} // namespace facebook::logdevice
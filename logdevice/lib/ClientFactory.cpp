@@ -26,6 +26,7 @@
 #include "logdevice/lib/ClientProcessor.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
 #include "logdevice/lib/RemoteLogsConfig.h"
+#include "logdevice/lib/SharedClientTransport.h"
 
 namespace facebook { namespace logdevice {
 
@@ -152,6 +153,67 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
     return true;
   };
 
+  if (credentials_.size() > HELLO_Header::CREDS_SIZE_V1) {
+    // credentials is too large to fit in HELLO_Message credential buffer
+    err = E::INVALID_PARAM;
+    return nullptr;
+  }
+
+  if (csid_.size() > MAX_CSID_SIZE) {
+    // csid is too large
+    err = E::INVALID_PARAM;
+    return nullptr;
+  }
+
+  if (csid_.empty()) {
+    boost::uuids::uuid gen_csid = boost::uuids::random_generator()();
+    csid_ = boost::uuids::to_string(gen_csid);
+  }
+
+  std::string transport_key;
+  if (impl_settings->getSettings()->share_client_transport) {
+    transport_key =
+        SharedClientTransport::makeKey(config_url, cluster_name_, credentials_);
+    std::shared_ptr<SharedClientTransport> transport =
+        SharedClientTransport::find(transport_key);
+    if (transport) {
+      // The transport's config is already loaded; only pick up the client
+      // settings it carries.
+      std::shared_ptr<UpdateableConfig> config = transport->config_;
+      if (!update_settings(*config->getServerConfig())) {
+        err = E::INVALID_CONFIG;
+        return nullptr;
+      }
+      auto handle =
+          config->updateableServerConfig()->addHook(std::move(update_settings));
+
+      std::shared_ptr<ClientImpl> impl = nullptr;
+      try {
+        impl = std::make_shared<ClientImpl>(cluster_name_,
+                                            std::move(config),
+                                            credentials_,
+                                            csid_,
+                                            timeout_,
+                                            std::move(impl_settings),
+                                            plugin_registry,
+                                            std::move(transport));
+      } catch (const ConstructorFailed&) {
+        ld_error(
+            "Constructing ClientImpl failed with %s.", error_description(err));
+        return nullptr;
+      }
+      impl->addServerConfigHookHandle(std::move(handle));
+
+      ld_info("Created Client sharing the Processor of an existing one in %.3f "
+              "seconds. Config: %s",
+              std::chrono::duration_cast<std::chrono::duration<double>>(
+                  std::chrono::steady_clock::now() - start_time)
+                  .count(),
+              config_url.c_str());
+      return std::shared_ptr<Client>(impl);
+    }
+  }
+
   auto config = std::make_shared<UpdateableConfig>();
   auto handle =
       config->updateableServerConfig()->addHook(std::move(update_settings));
@@ -168,7 +230,11 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
     // on_demand_logs_config enabled
     ld_info("Remote (on-demand) LogsConfig is ENABLED");
     auto cache_ttl = impl_settings->getSettings()->remote_logs_config_cache_ttl;
-    RemoteLogsConfig* raw_logs_cfg = new RemoteLogsConfig(timeout_, cache_ttl);
+    RemoteLogsConfig* raw_logs_cfg = new RemoteLogsConfig(
+        timeout_,
+        cache_ttl,
+        impl_settings->getSettings()->remote_logs_config_cache_size,
+        impl_settings->getSettings()->remote_logs_config_prefetch_siblings);
     logs_cfg_processor_ptr_ptr = raw_logs_cfg->getProcessorPtrPtr();
     logs_cfg.reset(raw_logs_cfg);
   }
@@ -243,23 +309,6 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
     return nullptr;
   }
 
-  if (credentials_.size() > HELLO_Header::CREDS_SIZE_V1) {
-    // credentials is too large to fit in HELLO_Message credential buffer
-    err = E::INVALID_PARAM;
-    return nullptr;
-  }
-
-  if (csid_.size() > MAX_CSID_SIZE) {
-    // csid is too large
-    err = E::INVALID_PARAM;
-    return nullptr;
-  }
-
-  if (csid_.empty()) {
-    boost::uuids::uuid gen_csid = boost::uuids::random_generator()();
-    csid_ = boost::uuids::to_string(gen_csid);
-  }
-
   std::shared_ptr<ClientImpl> impl = nullptr;
   try {
     impl = std::make_shared<ClientImpl>(cluster_name_,
@@ -280,6 +329,10 @@ std::shared_ptr<Client> ClientFactory::create(std::string config_url) noexcept {
 
   impl->addServerConfigHookHandle(std::move(handle));
 
+  if (!transport_key.empty() && impl->getSharedTransport()) {
+    SharedClientTransport::publish(transport_key, impl->getSharedTransport());
+  }
+
   // Setting the logs config's shared processor pointer to the actual
   // processor
   if (logs_cfg_processor_ptr_ptr) {
@@ -23,7 +23,9 @@
 #include "logdevice/common/EpochMetaDataCache.h"
 #include "logdevice/common/EpochMetaDataMap.h"
 #include "logdevice/common/FindKeyRequest.h"
+#include "logdevice/common/FindTimeBulkRequest.h"
 #include "logdevice/common/GetHeadAttributesRequest.h"
+#include "logdevice/common/GetTailAttributesBulkRequest.h"
 #include "logdevice/common/LogsConfigApiRequest.h"
 #include "logdevice/common/NoopTraceLogger.h"
 #include "logdevice/common/Processor.h"
@@ -34,6 +36,7 @@
 #include "logdevice/common/SyncSequencerRequest.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/ThreadID.h"
+#include "logdevice/common/TrimBulkRequest.h"
 #include "logdevice/common/TrimRequest.h"
 #include "logdevice/common/client_read_stream/AllClientReadStreams.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -56,10 +59,12 @@
 #include "logdevice/include/Err.h"
 #include "logdevice/include/Record.h"
 #include "logdevice/lib/AsyncReaderImpl.h"
+#include "logdevice/lib/ClientAppendCoalescer.h"
 #include "logdevice/lib/ClientProcessor.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
 #include "logdevice/lib/ClusterAttributesImpl.h"
 #include "logdevice/lib/LogsConfigTypesImpl.h"
+#include "logdevice/lib/SharedClientTransport.h"
 #include "logdevice/lib/shadow/Shadow.h"
 
 using facebook::logdevice::logsconfig::FBuffersLogsConfigCodec;
@@ -87,7 +92,8 @@ ClientImpl::ClientImpl(std::string cluster_name,
                        std::string csid,
                        std::chrono::milliseconds timeout,
                        std::unique_ptr<ClientSettings>&& client_settings,
-                       std::shared_ptr<PluginRegistry> plugin_registry)
+                       std::shared_ptr<PluginRegistry> plugin_registry,
+                       std::shared_ptr<SharedClientTransport> transport)
     : plugin_registry_(std::move(plugin_registry)),
       cluster_name_(cluster_name),
       credentials_(std::move(credentials)),
@@ -114,11 +120,47 @@ ClientImpl::ClientImpl(std::string cluster_name,
   UpdateableSettings<Settings> settings = settings_->getSettings();
 
   const size_t metadata_cache_size = settings->client_epoch_metadata_cache_size;
-  if (metadata_cache_size > 0) {
+  if (metadata_cache_size > 0 && !transport) {
     epoch_metadata_cache_ =
-        std::make_unique<EpochMetaDataCache>(metadata_cache_size);
+        std::make_shared<EpochMetaDataCache>(metadata_cache_size);
+  }
+
+  if (transport) {
+    // Join the Processor of other Clients, see SharedClientTransport.
+    epoch_metadata_cache_ = transport->epoch_metadata_cache_;
+    stats_ = transport->stats_;
+    trace_logger_ = transport->trace_logger_;
+    processor_ = transport->processor_;
+    shared_transport_ = std::move(transport);
+    STAT_SET(stats_.get(), client.client_started, 1);
+    event_tracer_ =
+        std::make_unique<ClientEventTracer>(trace_logger_, stats_.get());
+  } else {
+    initProcessor(settings);
+  }
+
+  ld_check(config_->getLogsConfig() != nullptr);
+
+  // Initialize traffic shadowing
+  if (!settings->shadow_client) {
+    shadow_ = std::make_unique<Shadow>(
+        cluster_name_, config_, settings_->getSettings(), stats_.get());
+  }
+
+  settings_subscription_handle_ =
+      settings.subscribeToUpdates([this] { this->updateStatsSettings(); });
+
+  if (settings->append_coalescing) {
+    append_coalescer_ = std::make_unique<ClientAppendCoalescer>(
+        this,
+        settings->append_coalescing_window,
+        settings->append_coalescing_max_batch_bytes);
   }
 
+  ld_info("Client created with Client Session id=%s", csid_.c_str());
+}
+
+void ClientImpl::initProcessor(UpdateableSettings<Settings> settings) {
   if (settings->stats_collection_interval.count() > 0 ||
       settings->client_test_force_stats) {
     auto params =
@@ -274,18 +316,15 @@ ClientImpl::ClientImpl(std::string cluster_name,
     }
   }
 
-  ld_check(config_->getLogsConfig() != nullptr);
-
-  // Initialize traffic shadowing
-  if (!settings->shadow_client) {
-    shadow_ = std::make_unique<Shadow>(
-        cluster_name_, config_, settings_->getSettings(), stats_.get());
+  if (settings->share_client_transport) {
+    shared_transport_ =
+        std::make_shared<SharedClientTransport>(config_,
+                                                stats_,
+                                                trace_logger_,
+                                                processor_,
+                                                std::move(stats_thread_),
+                                                epoch_metadata_cache_);
   }
-
-  settings_subscription_handle_ =
-      settings.subscribeToUpdates([this] { this->updateStatsSettings(); });
-
-  ld_info("Client created with Client Session id=%s", csid_.c_str());
 }
 
 ClientImpl::~ClientImpl() {
@@ -293,7 +332,15 @@ ClientImpl::~ClientImpl() {
   ld_info("Destroying Client. Cluster name: %s", cluster_name_.c_str());
 
   server_config_hook_handles_.clear();
-  processor_->shutdown();
+  // Fails buffered appends with E::SHUTDOWN while workers are still running.
+  append_coalescer_.reset();
+  if (shared_transport_) {
+    shared_transport_->retireBridge(std::move(bridge_));
+    // Shuts down the Processor if no other Client uses it
+    shared_transport_.reset();
+  } else {
+    processor_->shutdown();
+  }
 
   auto end_time = std::chrono::steady_clock::now();
   ld_info("Destroyed Client in %.3f seconds. Cluster name: %s",
@@ -536,6 +583,10 @@ int ClientImpl::append(logid_t logid,
                        std::string payload,
                        append_callback_t cb,
                        AppendAttributes attrs) noexcept {
+  if (append_coalescer_ &&
+      append_coalescer_->canCoalesce(payload.size(), attrs)) {
+    return append_coalescer_->append(logid, std::move(payload), std::move(cb));
+  }
   return append(logid,
                 std::move(payload),
                 std::move(cb),
@@ -548,6 +599,13 @@ int ClientImpl::append(logid_t logid,
                        const Payload& payload,
                        append_callback_t cb,
                        AppendAttributes attrs) noexcept {
+  if (append_coalescer_ &&
+      append_coalescer_->canCoalesce(payload.size(), attrs)) {
+    return append_coalescer_->append(
+        logid,
+        std::string(static_cast<const char*>(payload.data()), payload.size()),
+        std::move(cb));
+  }
   return append(logid, payload, cb, std::move(attrs), worker_id_t{-1}, nullptr);
 }
 
@@ -1540,6 +1598,42 @@ int ClientImpl::trim(logid_t logid, lsn_t lsn, trim_callback_t cb) noexcept {
   ;
 }
 
+int ClientImpl::trimBulkSync(std::vector<std::pair<logid_t, lsn_t>> trims,
+                             std::vector<TrimBulkResult>* results) noexcept {
+  ld_check(results != nullptr);
+  Status status = E::OK;
+
+  Semaphore sem;
+  auto cb = [&](Status st, std::vector<TrimBulkResult> r) {
+    *results = std::move(r);
+    status = st;
+    sem.post();
+  };
+
+  int rv = trimBulk(std::move(trims), cb);
+  if (rv != 0) {
+    // err set by trimBulk.
+    return -1;
+  }
+
+  sem.wait();
+  if (status != E::OK) {
+    err = status;
+    return -1;
+  }
+  return 0;
+}
+
+int ClientImpl::trimBulk(std::vector<std::pair<logid_t, lsn_t>> trims,
+                         trim_bulk_callback_t cb) noexcept {
+  std::unique_ptr<Request> req = std::make_unique<TrimBulkRequest>(
+      bridge_.get(),
+      std::move(trims),
+      settings_->getSettings()->meta_api_timeout.value_or(timeout_),
+      std::move(cb));
+  return processor_->postRequest(req);
+}
+
 struct FindTimeGate {
   // called by FindKeyRequest when request processing completes or
   // timeout expires
@@ -1633,6 +1727,47 @@ int ClientImpl::findTime(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::findTimeBulkSync(std::vector<logid_t> logids,
+                                 std::chrono::milliseconds timestamp,
+                                 std::vector<FindTimeBulkResult>* results,
+                                 FindKeyAccuracy accuracy) noexcept {
+  ld_check(results != nullptr);
+  Status status = E::OK;
+
+  Semaphore sem;
+  auto cb = [&](Status st, std::vector<FindTimeBulkResult> r) {
+    *results = std::move(r);
+    status = st;
+    sem.post();
+  };
+
+  int rv = findTimeBulk(std::move(logids), timestamp, cb, accuracy);
+  if (rv != 0) {
+    // err set by findTimeBulk.
+    return -1;
+  }
+
+  sem.wait();
+  if (status != E::OK) {
+    err = status;
+    return -1;
+  }
+  return 0;
+}
+
+int ClientImpl::findTimeBulk(std::vector<logid_t> logids,
+                             std::chrono::milliseconds timestamp,
+                             find_time_bulk_callback_t cb,
+                             FindKeyAccuracy accuracy) noexcept {
+  std::unique_ptr<Request> req = std::make_unique<FindTimeBulkRequest>(
+      std::move(logids),
+      timestamp,
+      settings_->getSettings()->findkey_timeout.value_or(timeout_),
+      std::move(cb),
+      accuracy);
+  return processor_->postRequest(req);
+}
+
 FindKeyResult ClientImpl::findKeySync(logid_t logid,
                                       std::string key,
                                       FindKeyAccuracy accuracy) noexcept {
@@ -1958,6 +2093,44 @@ int ClientImpl::getTailAttributes(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::getTailAttributesBulkSync(
+    std::vector<logid_t> logids,
+    std::vector<LogTailAttributesResult>* results) noexcept {
+  ld_check(results != nullptr);
+  Status status = E::OK;
+
+  Semaphore sem;
+  auto cb = [&](Status st, std::vector<LogTailAttributesResult> r) {
+    *results = std::move(r);
+    status = st;
+    sem.post();
+  };
+
+  int rv = getTailAttributesBulk(std::move(logids), cb);
+  if (rv != 0) {
+    // err set by getTailAttributesBulk.
+    return -1;
+  }
+
+  sem.wait();
+  if (status != E::OK) {
+    err = status;
+    return -1;
+  }
+  return 0;
+}
+
+int ClientImpl::getTailAttributesBulk(
+    std::vector<logid_t> logids,
+    get_tail_attributes_bulk_callback_t cb) noexcept {
+  std::unique_ptr<Request> req =
+      std::make_unique<GetTailAttributesBulkRequest>(
+          std::move(logids),
+          settings_->getSettings()->meta_api_timeout.value_or(timeout_),
+          std::move(cb));
+  return processor_->postRequest(req);
+}
+
 std::shared_ptr<const EpochMetaDataMap>
 ClientImpl::getHistoricalMetaDataSync(logid_t logid) noexcept {
   std::shared_ptr<const EpochMetaDataMap> historical_metadata;
@@ -2074,7 +2247,8 @@ ClientImpl::readLogTailSync(logid_t logid) noexcept {
   return record;
 }
 
-int ClientImpl::readLogTail(logid_t logid, read_tail_callback_t cb) noexcept {
+int ClientImpl::readLogTail(logid_t logid,
+                            read_log_tail_callback_t cb) noexcept {
   auto cb_wrapper = [cb](Status st, std::shared_ptr<TailRecord> tail) {
     if (st != E::OK) {
       cb(st, nullptr);
@@ -2306,8 +2480,11 @@ void ClientImpl::registerCustomStats(StatsHolder* custom_stats) {
   // Use presence of regular stats as a proxy for stats being enabled; this
   // also means that we won't have to take care of starting the stats
   // collection thread or anything like that.
-  if (stats_) {
-    stats_thread_->addStatsSource(custom_stats);
+  StatsCollectionThread* stats_thread = shared_transport_
+      ? shared_transport_->getStatsThread()
+      : stats_thread_.get();
+  if (stats_ && stats_thread) {
+    stats_thread->addStatsSource(custom_stats);
   }
 }
 
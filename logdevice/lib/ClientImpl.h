@@ -41,6 +41,7 @@ class NodesConfigurationManager;
 
 class AppendRequest;
 class ClientAPIHitsTracer;
+class ClientAppendCoalescer;
 class ClientBridgeImpl;
 class ClientEventTracer;
 class ClientProcessor;
@@ -54,6 +55,7 @@ class PluginRegistry;
 class Processor;
 struct Settings;
 class Shadow;
+class SharedClientTransport;
 class StatsCollectionThread;
 class StatsHolder;
 class TailRecord;
@@ -79,7 +81,8 @@ class ClientImpl : public Client,
              std::string csid,
              std::chrono::milliseconds timeout,
              std::unique_ptr<ClientSettings>&& settings,
-             std::shared_ptr<PluginRegistry> plugin_registry);
+             std::shared_ptr<PluginRegistry> plugin_registry,
+             std::shared_ptr<SharedClientTransport> transport = nullptr);
 
   virtual ~ClientImpl() override;
 
@@ -167,6 +170,12 @@ class ClientImpl : public Client,
 
   int trim(logid_t logid, lsn_t lsn, trim_callback_t cb) noexcept override;
 
+  int trimBulkSync(std::vector<std::pair<logid_t, lsn_t>> trims,
+                   std::vector<TrimBulkResult>* results) noexcept override;
+
+  int trimBulk(std::vector<std::pair<logid_t, lsn_t>> trims,
+               trim_bulk_callback_t cb) noexcept override;
+
   void addWriteToken(std::string token) noexcept override {
     folly::SharedMutex::WriteHolder guard(write_tokens_mutex_);
     write_tokens_.insert(token);
@@ -182,6 +191,16 @@ class ClientImpl : public Client,
                find_time_callback_t cb,
                FindKeyAccuracy accuracy) noexcept override;
 
+  int findTimeBulkSync(std::vector<logid_t> logids,
+                       std::chrono::milliseconds timestamp,
+                       std::vector<FindTimeBulkResult>* results,
+                       FindKeyAccuracy accuracy) noexcept override;
+
+  int findTimeBulk(std::vector<logid_t> logids,
+                   std::chrono::milliseconds timestamp,
+                   find_time_bulk_callback_t cb,
+                   FindKeyAccuracy accuracy) noexcept override;
+
   FindKeyResult findKeySync(logid_t logid,
                             std::string key,
                             FindKeyAccuracy accuracy) noexcept override;
@@ -215,6 +234,18 @@ class ClientImpl : public Client,
   int getTailAttributes(logid_t logid,
                         get_tail_attributes_callback_t cb) noexcept override;
 
+  int getTailAttributesBulkSync(
+      std::vector<logid_t> logids,
+      std::vector<LogTailAttributesResult>* results) noexcept override;
+
+  int getTailAttributesBulk(
+      std::vector<logid_t> logids,
+      get_tail_attributes_bulk_callback_t cb) noexcept override;
+
+  std::unique_ptr<DataRecord> readLogTailSync(logid_t logid) noexcept override;
+
+  int readLogTail(logid_t logid, read_log_tail_callback_t cb) noexcept override;
+
   std::unique_ptr<LogHeadAttributes>
   getHeadAttributesSync(logid_t logid) noexcept override;
 
@@ -346,23 +377,16 @@ class ClientImpl : public Client,
   using tail_record_callback_t =
       std::function<void(Status status, std::shared_ptr<TailRecord>)>;
 
-  using read_tail_callback_t =
-      std::function<void(Status status, std::unique_ptr<DataRecord>)>;
-
   std::shared_ptr<const EpochMetaDataMap>
   getHistoricalMetaDataSync(logid_t logid) noexcept;
 
   std::shared_ptr<TailRecord> getTailRecordSync(logid_t logid) noexcept;
 
-  std::unique_ptr<DataRecord> readLogTailSync(logid_t logid) noexcept;
-
   int getHistoricalMetaData(logid_t logid,
                             historical_metadata_callback_t cb) noexcept;
 
   int getTailRecord(logid_t logid, tail_record_callback_t cb) noexcept;
 
-  int readLogTail(logid_t logid, read_tail_callback_t cb) noexcept;
-
   ClientSettings& settings() override;
 
   std::string getAllReadStreamsDebugInfo() noexcept override;
@@ -383,6 +407,12 @@ class ClientImpl : public Client,
     return processor_;
   }
 
+  // Non-null if Settings::share_client_transport was set when the Client was
+  // created.
+  std::shared_ptr<SharedClientTransport> getSharedTransport() const {
+    return shared_transport_;
+  }
+
   StatsHolder* stats() const {
     return stats_.get();
   }
@@ -478,6 +508,11 @@ class ClientImpl : public Client,
 
   bool hasFullyLoadedLocalLogsConfig() const;
 
+  // Creates the Processor and what it depends on (stats, NodesConfiguration
+  // manager, LogsConfig manager, ...), and waits for the LogsConfig to load.
+  // Not called when joining a SharedClientTransport.
+  void initProcessor(UpdateableSettings<Settings> settings);
+
   std::shared_ptr<PluginRegistry> plugin_registry_;
 
   std::string cluster_name_;
@@ -497,12 +532,14 @@ class ClientImpl : public Client,
   // Order matters.  Settings need to stick around longer than the Processor.
   std::unique_ptr<ClientSettingsImpl> settings_;
 
-  // cache epoch metadata entries read from the metadata log
-  std::unique_ptr<EpochMetaDataCache> epoch_metadata_cache_;
+  // cache epoch metadata entries read from the metadata log. Shared with
+  // other Clients if shared_transport_ is set.
+  std::shared_ptr<EpochMetaDataCache> epoch_metadata_cache_;
 
   std::shared_ptr<UpdateableConfig> config_;
 
-  std::unique_ptr<StatsHolder> stats_;
+  // Shared with other Clients if shared_transport_ is set
+  std::shared_ptr<StatsHolder> stats_;
 
   std::unique_ptr<ClientBridgeImpl> bridge_;
 
@@ -518,6 +555,10 @@ class ClientImpl : public Client,
 
   std::unique_ptr<StatsCollectionThread> stats_thread_;
 
+  // If set, processor_ (along with config_, stats_ and trace_logger_) may be
+  // used by other Clients too, and is shut down by the last of them.
+  std::shared_ptr<SharedClientTransport> shared_transport_;
+
   // Should be deleted before config and settings
   std::unique_ptr<Shadow> shadow_;
 
@@ -533,6 +574,10 @@ class ClientImpl : public Client,
       settings_subscription_handle_;
 
   folly::Optional<AppendErrorInjector> append_error_injector_;
+
+  // If Settings::append_coalescing is set, append() goes through this.
+  // Must be destroyed before the Processor is shut down.
+  std::unique_ptr<ClientAppendCoalescer> append_coalescer_;
 };
 
 class ClientBridgeImpl : public ClientBridge {
@@ -540,15 +585,28 @@ class ClientBridgeImpl : public ClientBridge {
   explicit ClientBridgeImpl(ClientImpl* parent) : parent_(parent) {}
 
   const std::shared_ptr<TraceLogger> getTraceLogger() const override {
-    return parent_->getTraceLogger();
+    folly::SharedMutex::ReadHolder lock(mutex_);
+    return parent_ ? parent_->getTraceLogger() : trace_logger_;
   }
 
   bool hasWriteToken(const std::string& required) const override {
-    return parent_->hasWriteToken(required);
+    folly::SharedMutex::ReadHolder lock(mutex_);
+    return parent_ && parent_->hasWriteToken(required);
+  }
+
+  // Called when the Client is destroyed while the Processor lives on (see
+  // SharedClientTransport). Requests still in flight then get the
+  // Processor's trace logger and no write tokens.
+  void detach(std::shared_ptr<TraceLogger> trace_logger) {
+    folly::SharedMutex::WriteHolder lock(mutex_);
+    parent_ = nullptr;
+    trace_logger_ = std::move(trace_logger);
   }
 
  private:
+  mutable folly::SharedMutex mutex_;
   ClientImpl* parent_;
+  std::shared_ptr<TraceLogger> trace_logger_;
 };
 
 }} // namespace facebook::logdevice
@@ -8,7 +8,9 @@
 #include "logdevice/lib/RemoteLogsConfig.h"
 
 #include <deque>
+#include <limits>
 #include <shared_mutex>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -119,26 +121,18 @@ void RemoteLogsConfig::getLogGroupByIDAsync(
     return;
   }
 
-  {
-    // Attempting to fetch result from cache
-    std::shared_lock<RWSpinLock> lock(id_cache_mutex);
-    auto it = id_result_cache.find(id.val_);
-    if (it != id_result_cache.end()) {
-      // potential cache hit - check timestamp
-      steady_clock::time_point tnow = steady_clock::now();
-      if (tnow - it->second.time_fetched <= max_data_age_) {
-        // data not too old - return from cache
-        auto log_sptr_copy = it->second.log;
-        lock.unlock();
-        cb(std::move(log_sptr_copy));
-        return;
-      }
-    }
+  // Attempting to fetch result from cache
+  LogGroupNodePtr cached = findInIdCache(id);
+  if (cached) {
+    cb(std::move(cached));
+    return;
   }
 
   std::string delimiter = getNamespaceDelimiter();
+  uint64_t generation = generation_;
   // No suitable results in cache - proceed to get them from remote hosts.
-  auto request_callback = [cb, delimiter](Status st, std::string payload) {
+  auto request_callback = [cb, delimiter, generation](Status st,
+                                                      std::string payload) {
     auto config = Worker::onThisThread()->getConfig();
     RemoteLogsConfig* rlc = checked_downcast<RemoteLogsConfig*>(
         const_cast<LogsConfig*>(config->logsConfig().get()));
@@ -165,8 +159,13 @@ void RemoteLogsConfig::getLogGroupByIDAsync(
 
     const auto log_shared = lid->log_group;
 
-    // Placing result in cache
-    rlc->insertIntoIdCache(log_shared);
+    if (rlc->canCacheResultOf(generation)) {
+      // Placing result in cache
+      rlc->insertIntoIdCache(log_shared);
+      if (rlc->prefetch_siblings_) {
+        rlc->prefetchDirectory(lid->parent_path);
+      }
+    }
 
     // Returning to client
     cb(std::move(log_shared));
@@ -180,6 +179,53 @@ void RemoteLogsConfig::getLogGroupByIDAsync(
   }
 }
 
+LogGroupNodePtr RemoteLogsConfig::findInIdCache(logid_t id) const {
+  auto lookup = [&]() -> LogGroupNodePtr {
+    auto it = id_result_cache.find(id.val_);
+    if (it == id_result_cache.end()) {
+      return nullptr;
+    }
+    // potential cache hit - check timestamp
+    if (steady_clock::now() - it->second.time_fetched > max_data_age_) {
+      return nullptr;
+    }
+    // data not too old - return from cache
+    return it->second.log;
+  };
+
+  if (max_cached_log_groups_ == 0) {
+    std::shared_lock<RWSpinLock> lock(id_cache_mutex);
+    return lookup();
+  }
+
+  // Bumping the entry in the LRU modifies it, so an exclusive lock is needed
+  std::unique_lock<RWSpinLock> lock(id_cache_mutex);
+  LogGroupNodePtr res = lookup();
+  if (res) {
+    id_cache_lru_.get(res->range().first.val_);
+  }
+  return res;
+}
+
+void RemoteLogsConfig::eraseFromIdCacheLocked(
+    const LogGroupNodePtr& log) const {
+  auto range = log->range();
+  boost::icl::right_open_interval<logid_t::raw_type> interval(
+      range.first.val_, range.second.val_ + 1);
+  // Parts of the range may have been overwritten by other log groups since
+  // `log` was inserted; leave those alone.
+  std::vector<IDMap::interval_type> to_erase;
+  auto bounds = id_result_cache.equal_range(interval);
+  for (auto it = bounds.first; it != bounds.second; ++it) {
+    if (it->second.log == log) {
+      to_erase.push_back(it->first);
+    }
+  }
+  for (const auto& segment : to_erase) {
+    id_result_cache.erase(segment);
+  }
+}
+
 void RemoteLogsConfig::insertIntoIdCache(const LogGroupNodePtr& log) const {
   auto range = log->range();
   boost::icl::right_open_interval<logid_t::raw_type> interval(
@@ -188,6 +234,79 @@ void RemoteLogsConfig::insertIntoIdCache(const LogGroupNodePtr& log) const {
   std::unique_lock<RWSpinLock> lock(id_cache_mutex);
   id_result_cache.erase(interval);
   id_result_cache.insert(std::make_pair(interval, entry));
+
+  if (max_cached_log_groups_ == 0) {
+    return;
+  }
+  id_cache_lru_.add(range.first.val_, log);
+  while (id_cache_lru_.size() > max_cached_log_groups_) {
+    auto lru = id_cache_lru_.getWithoutPromotion(id_cache_lru_.getLRU());
+    ld_check(lru.first != nullptr);
+    eraseFromIdCacheLocked(*lru.first);
+    id_cache_lru_.erase(lru.second);
+  }
+}
+
+void RemoteLogsConfig::prefetchDirectory(const std::string& path) const {
+  std::string delimiter = getNamespaceDelimiter();
+  if (path.empty() || path == delimiter) {
+    // The server returns the whole subtree of a directory, so prefetching the
+    // siblings of a top-level log group would fetch the entire config.
+    return;
+  }
+
+  {
+    std::unique_lock<RWSpinLock> lock(name_cache_mutex);
+    auto now = steady_clock::now();
+    auto it = prefetch_times.find(path);
+    if (it != prefetch_times.end() && now - it->second <= max_data_age_) {
+      // Already prefetched, or a prefetch is in flight
+      return;
+    }
+    prefetch_times[path] = now;
+  }
+
+  uint64_t generation = generation_;
+  auto request_callback = [path, delimiter, generation](
+                              Status st, std::string payload) {
+    auto config = Worker::onThisThread()->getConfig();
+    RemoteLogsConfig* rlc = dynamic_cast<RemoteLogsConfig*>(
+        const_cast<LogsConfig*>(config->logsConfig().get()));
+    if (!rlc || st != E::OK || !rlc->canCacheResultOf(generation)) {
+      // Prefetching is best effort; the log groups will be fetched one by one
+      // if they are needed.
+      return;
+    }
+
+    std::unique_ptr<logsconfig::DirectoryNode> directory =
+        LogsConfigStateMachine::deserializeDirectory(payload, delimiter);
+    if (directory == nullptr) {
+      ld_error("Error parsing DirectoryNode result");
+      return;
+    }
+
+    // Only the direct children of the directory are cached. Leave at least
+    // half of a bounded cache to log groups that were actually requested.
+    size_t limit = rlc->max_cached_log_groups_ == 0
+        ? std::numeric_limits<size_t>::max()
+        : rlc->max_cached_log_groups_ / 2;
+    size_t inserted = 0;
+    for (const auto& lg : directory->logs()) {
+      if (inserted++ >= limit) {
+        break;
+      }
+      rlc->insertIntoIdCache(std::make_shared<logsconfig::LogGroupNode>(
+          path + lg.second->name(), lg.second->attrs(), lg.second->range()));
+    }
+  };
+
+  this->postRequest(
+      LOGS_CONFIG_API_Header::Type::GET_DIRECTORY, path, request_callback);
+}
+
+bool RemoteLogsConfig::isInIdCache(logid_t id) const {
+  std::shared_lock<RWSpinLock> lock(id_cache_mutex);
+  return id_result_cache.find(id.val_) != id_result_cache.end();
 }
 
 bool RemoteLogsConfig::logExists(logid_t id) const {
@@ -224,7 +343,8 @@ void RemoteLogsConfig::getLogRangeByNameAsync(
     }
   }
 
-  auto request_callback = [delimiter, name, cb](
+  uint64_t generation = generation_;
+  auto request_callback = [delimiter, name, cb, generation](
                               Status st, std::string payload) {
     auto config = Worker::onThisThread()->getConfig();
     RemoteLogsConfig* rlc = dynamic_cast<RemoteLogsConfig*>(
@@ -249,6 +369,11 @@ void RemoteLogsConfig::getLogRangeByNameAsync(
     }
 
     logid_range_t res = log_group->range();
+    if (!rlc->canCacheResultOf(generation)) {
+      // The config was invalidated while the request was in flight
+      cb(E::OK, res);
+      return;
+    }
     {
       // writing to name->range cache
       std::unique_lock<RWSpinLock> lock(rlc->name_cache_mutex);
@@ -355,6 +480,9 @@ void RemoteLogsConfig::processDirectoryResult(
             lg.second->attrs(),
             lg.second->range());
     map.insert(std::make_pair(flat_log_group->name(), flat_log_group->range()));
+    if (rlc == nullptr) {
+      continue;
+    }
 
     // writing to name->range cache
     NameMapEntry entry{flat_log_group->range(), steady_clock::now()};
@@ -395,7 +523,8 @@ void RemoteLogsConfig::getLogRangesByNamespaceAsync(
     return;
   }
 
-  auto request_callback = [path, cb, delimiter](
+  uint64_t generation = generation_;
+  auto request_callback = [path, cb, delimiter, generation](
                               Status st, std::string payload) {
     auto config = Worker::onThisThread()->getConfig();
     RemoteLogsConfig* rlc = dynamic_cast<RemoteLogsConfig*>(
@@ -417,6 +546,14 @@ void RemoteLogsConfig::getLogRangesByNamespaceAsync(
       return;
     }
 
+    if (!rlc->canCacheResultOf(generation)) {
+      // The config was invalidated while the request was in flight
+      RangeLookupMap res;
+      processDirectoryResult(nullptr, res, *directory, "", delimiter);
+      cb(res.empty() ? E::NOTFOUND : E::OK, res);
+      return;
+    }
+
     // writing to namespace timing cache
     auto now = steady_clock::now();
     std::unique_lock<RWSpinLock> lock(rlc->name_cache_mutex);
@@ -445,8 +582,14 @@ RemoteLogsConfig::RemoteLogsConfig(const RemoteLogsConfig& src)
   // not copying the cache
   timeout_ = src.timeout_;
   max_data_age_ = src.max_data_age_;
+  max_cached_log_groups_ = src.max_cached_log_groups_;
+  prefetch_siblings_ = src.prefetch_siblings_;
   processor_ = src.processor_;
   target_node_info_ = src.target_node_info_;
+  // Responses to requests posted by older copies must not populate the
+  // caches of this one
+  generation_counter_ = src.generation_counter_;
+  generation_ = ++*generation_counter_;
 
   // Enabling sending LOGS_CONFIG_API messages if it's disabled
   std::unique_lock<std::mutex> lock(target_node_info_->mutex_);
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <chrono>
 
 #include <folly/synchronization/RWSpinLock.h>
@@ -14,6 +15,7 @@
 #include "logdevice/common/GetLogInfoRequest.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Semaphore.h"
+#include "logdevice/common/UnorderedMapWithLRU.h"
 #include "logdevice/common/configuration/Configuration.h"
 
 namespace facebook { namespace logdevice {
@@ -21,14 +23,25 @@ namespace facebook { namespace logdevice {
 /*
  * This class resolves the log configuration via sending requests to servers
  * and parsing the json blobs it receives in response.
+ *
+ * Log groups fetched by ID are cached for cache_ttl. If max_cached_log_groups
+ * is nonzero, the cache holds at most that many log groups and evicts the
+ * least recently used ones. If prefetch_siblings is true, a cache miss by ID
+ * also fetches the other log groups of the same directory in the background,
+ * since clients tend to use logs that are close to each other in the tree.
  */
 class RemoteLogsConfig : public LogsConfig {
  public:
   RemoteLogsConfig(std::chrono::milliseconds timeout,
-                   std::chrono::milliseconds cache_ttl)
+                   std::chrono::milliseconds cache_ttl,
+                   size_t max_cached_log_groups = 0,
+                   bool prefetch_siblings = false)
       : timeout_(timeout),
         max_data_age_(cache_ttl),
+        max_cached_log_groups_(max_cached_log_groups),
+        prefetch_siblings_(prefetch_siblings),
         processor_(new std::weak_ptr<Processor>()),
+        generation_counter_(std::make_shared<std::atomic<uint64_t>>(0)),
         target_node_info_(std::make_shared<GetLogInfoRequestSharedState>()) {}
 
   bool isLocal() const override {
@@ -71,12 +84,37 @@ class RemoteLogsConfig : public LogsConfig {
   // used in tests only
   std::shared_ptr<GetLogInfoRequestSharedState> getTargetNodeInfo() const;
 
+  // used in tests only; doesn't affect the LRU order
+  bool isInIdCache(logid_t id) const;
+
  private:
   using RangeLookupMap = LogsConfig::NamespaceRangeLookupMap;
 
-  // Inserts entries into logid->log struct cache
+  // Inserts entries into logid->log struct cache, evicting the least recently
+  // used log groups if the cache is bounded and full
   void insertIntoIdCache(const LogGroupNodePtr& log) const;
 
+  // Looks up a fresh entry in the id cache and marks it as recently used.
+  // Returns nullptr on a miss.
+  LogGroupNodePtr findInIdCache(logid_t id) const;
+
+  // Removes the segments of the id cache that still belong to `log`. Called
+  // with id_cache_mutex held exclusively.
+  void eraseFromIdCacheLocked(const LogGroupNodePtr& log) const;
+
+  // Fetches the log groups of directory `path` (a fully qualified directory
+  // name ending with the delimiter) into the id cache, unless that was done
+  // within the TTL
+  void prefetchDirectory(const std::string& path) const;
+
+  // Returns true if results of a request posted when this instance had
+  // generation `generation` may be written to this instance's caches. They
+  // may not if the config was invalidated (e.g. by CONFIG_CHANGED) while the
+  // request was in flight.
+  bool canCacheResultOf(uint64_t generation) const {
+    return generation == generation_;
+  }
+
   // attempts to fetch results from cache into res. Returns true on success,
   // false on failure.
   bool getLogRangesByNamespaceCached(const std::string& ns,
@@ -89,7 +127,7 @@ class RemoteLogsConfig : public LogsConfig {
                   get_log_info_callback_t callback) const;
 
   // Recursively processes the result of the BY_NAMESPACE result and adds it
-  // to the cache
+  // to the cache of rlc, unless rlc is nullptr
   static void processDirectoryResult(RemoteLogsConfig* rlc,
                                      RangeLookupMap& map,
                                      const logsconfig::DirectoryNode& directory,
@@ -100,6 +138,12 @@ class RemoteLogsConfig : public LogsConfig {
 
   // TTL for the result cache
   std::chrono::milliseconds max_data_age_ = std::chrono::milliseconds(60000);
+
+  // Maximum number of log groups in the id cache, 0 for no limit
+  size_t max_cached_log_groups_ = 0;
+
+  bool prefetch_siblings_ = false;
+
   // This is a pointer to the client's processor. It is shared for easier
   // substitution across all RemoteLogsConfig instances
   std::shared_ptr<std::weak_ptr<Processor>> processor_;
@@ -124,6 +168,13 @@ class RemoteLogsConfig : public LogsConfig {
       IDMap;
   mutable IDMap id_result_cache;
 
+  // Eviction order of the log groups in id_result_cache, keyed by the first
+  // log id of their range. Only maintained if max_cached_log_groups_ is
+  // nonzero. May contain log groups whose segments in id_result_cache were
+  // overwritten by newer ones; those are no-ops to evict.
+  mutable UnorderedMapWithLRU<logid_t::raw_type, LogGroupNodePtr>
+      id_cache_lru_{LOGID_INVALID.val_, LOGID_INVALID2.val_};
+
   // Name -> log id range entry cache
   struct NameMapEntry {
     std::pair<logid_t, logid_t> range;
@@ -134,6 +185,16 @@ class RemoteLogsConfig : public LogsConfig {
   mutable std::map<std::string, NameMapEntry> name_result_cache;
   mutable std::unordered_map<std::string, std::chrono::steady_clock::time_point>
       namespace_last_fetch_times;
+  // Directory path -> time of the last sibling prefetch. Guarded by
+  // name_cache_mutex.
+  mutable std::unordered_map<std::string, std::chrono::steady_clock::time_point>
+      prefetch_times;
+
+  // Incremented every time the config is copied, i.e. whenever the caches are
+  // dropped. Shared between all copies.
+  std::shared_ptr<std::atomic<uint64_t>> generation_counter_;
+  // Value of *generation_counter_ when this instance was created
+  uint64_t generation_ = 0;
 
   // This is a structure shared between all GetLogInfoRequest instances, which
   // defines where the request should be sent to
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/lib/SharedClientTransport.h"
+
+#include <unordered_map>
+
+#include "logdevice/common/EpochMetaDataCache.h"
+#include "logdevice/common/StatsCollectionThread.h"
+#include "logdevice/common/TraceLogger.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/lib/ClientImpl.h"
+#include "logdevice/lib/ClientProcessor.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::weak_ptr<SharedClientTransport>> map;
+};
+
+Registry& registry() {
+  // Leaked so that Clients destroyed during static destruction can still
+  // use it.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+} // namespace
+
+SharedClientTransport::SharedClientTransport(
+    std::shared_ptr<UpdateableConfig> config,
+    std::shared_ptr<StatsHolder> stats,
+    std::shared_ptr<TraceLogger> trace_logger,
+    std::shared_ptr<ClientProcessor> processor,
+    std::unique_ptr<StatsCollectionThread> stats_thread,
+    std::shared_ptr<EpochMetaDataCache> metadata_cache)
+    : config_(std::move(config)),
+      stats_(std::move(stats)),
+      trace_logger_(std::move(trace_logger)),
+      processor_(std::move(processor)),
+      epoch_metadata_cache_(std::move(metadata_cache)),
+      stats_thread_(std::move(stats_thread)) {
+  ld_check(config_);
+  ld_check(processor_);
+}
+
+SharedClientTransport::~SharedClientTransport() {
+  ld_info("Shutting down the Processor shared by Clients");
+  processor_->shutdown();
+}
+
+std::string SharedClientTransport::makeKey(const std::string& config_url,
+                                           const std::string& cluster_name,
+                                           const std::string& credentials) {
+  // None of these can contain NUL characters in practice
+  return config_url + '\0' + cluster_name + '\0' + credentials;
+}
+
+std::shared_ptr<SharedClientTransport>
+SharedClientTransport::find(const std::string& key) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  auto it = r.map.find(key);
+  return it == r.map.end() ? nullptr : it->second.lock();
+}
+
+void SharedClientTransport::publish(
+    const std::string& key,
+    std::shared_ptr<SharedClientTransport> transport) {
+  ld_check(transport);
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto it = r.map.begin(); it != r.map.end();) {
+    if (it->second.expired()) {
+      it = r.map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Keep the transport other Clients may already have joined
+  r.map.emplace(key, transport);
+}
+
+void SharedClientTransport::retireBridge(
+    std::unique_ptr<ClientBridgeImpl> bridge) {
+  bridge->detach(trace_logger_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  retired_bridges_.push_back(std::move(bridge));
+}
+
+}} // namespace facebook::logdevice
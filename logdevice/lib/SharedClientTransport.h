@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file SharedClientTransport owns what Client instances created with
+ * Settings::share_client_transport share: the ClientProcessor with its
+ * workers and connections, the config it follows, and the stats and trace
+ * logger it reports to. The ClientImpl that creates a transport registers it
+ * under a key made of the config URL, the cluster name and the credentials
+ * (which go into HELLO and therefore bind the connections); later
+ * ClientFactory::create() calls with the same key join it instead of building
+ * their own. The Processor is shut down when the last of these Clients is
+ * destroyed.
+ *
+ * The Clients also share the EpochMetaDataCache of the first one, so that
+ * readers of any of them benefit from metadata read by the others.
+ *
+ * Everything else (settings, timeouts, write tokens, the append coalescer,
+ * ...) stays per Client. Settings that the Processor reads, however, are
+ * those of the Client that created the transport.
+ */
+
+namespace facebook { namespace logdevice {
+
+class ClientBridgeImpl;
+class ClientProcessor;
+class EpochMetaDataCache;
+class StatsCollectionThread;
+class StatsHolder;
+class TraceLogger;
+class UpdateableConfig;
+
+class SharedClientTransport {
+ public:
+  SharedClientTransport(std::shared_ptr<UpdateableConfig> config,
+                        std::shared_ptr<StatsHolder> stats,
+                        std::shared_ptr<TraceLogger> trace_logger,
+                        std::shared_ptr<ClientProcessor> processor,
+                        std::unique_ptr<StatsCollectionThread> stats_thread,
+                        std::shared_ptr<EpochMetaDataCache> metadata_cache);
+
+  // Shuts down the Processor.
+  ~SharedClientTransport();
+
+  static std::string makeKey(const std::string& config_url,
+                             const std::string& cluster_name,
+                             const std::string& credentials);
+
+  // @return  the live transport registered under `key', or nullptr
+  static std::shared_ptr<SharedClientTransport> find(const std::string& key);
+
+  // Registers `transport' under `key' unless a live transport is already
+  // registered there (Clients created concurrently may race to create one).
+  static void publish(const std::string& key,
+                      std::shared_ptr<SharedClientTransport> transport);
+
+  // Takes ownership of the ClientBridge of a Client that is being destroyed,
+  // after detaching it from the Client. Requests the Client posted may still
+  // be running on the shared workers and use the bridge, so it is kept until
+  // the transport goes away.
+  void retireBridge(std::unique_ptr<ClientBridgeImpl> bridge);
+
+  StatsCollectionThread* getStatsThread() const {
+    return stats_thread_.get();
+  }
+
+  const std::shared_ptr<UpdateableConfig> config_;
+  const std::shared_ptr<StatsHolder> stats_;
+  const std::shared_ptr<TraceLogger> trace_logger_;
+  const std::shared_ptr<ClientProcessor> processor_;
+  // nullptr if the cache is disabled
+  const std::shared_ptr<EpochMetaDataCache> epoch_metadata_cache_;
+
+ private:
+  std::unique_ptr<StatsCollectionThread> stats_thread_;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ClientBridgeImpl>> retired_bridges_;
+};
+
+}} // namespace facebook::logdevice
@@ -20,6 +20,7 @@ AsyncCheckpointedReaderImpl::AsyncCheckpointedReaderImpl(
     : AsyncCheckpointedReader(reader_name, std::move(store), opts),
       reader_(std::move(reader)) {
   ld_check(reader_);
+  enableCommitCoalescing();
 }
 
 void AsyncCheckpointedReaderImpl::startReadingFromCheckpoint(
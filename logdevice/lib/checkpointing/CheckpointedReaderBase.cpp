@@ -12,6 +12,7 @@
 
 #include "logdevice/common/ReadStreamAttributes.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/lib/checkpointing/CoalescingCheckpointWriter.h"
 
 namespace facebook { namespace logdevice {
 
@@ -21,8 +22,28 @@ CheckpointedReaderBase::CheckpointedReaderBase(
     CheckpointingOptions opts)
     : options_(opts), reader_name_(reader_name), store_(std::move(store)) {}
 
+CheckpointedReaderBase::~CheckpointedReaderBase() = default;
+
+void CheckpointedReaderBase::enableCommitCoalescing() {
+  if (options_.commit_coalescing_window.count() > 0) {
+    writer_ = std::make_unique<CoalescingCheckpointWriter>(
+        store_.get(),
+        reader_name_,
+        options_.commit_coalescing_window,
+        options_.commit_cb);
+  }
+}
+
 Status CheckpointedReaderBase::syncWriteCheckpoints(
     const std::map<logid_t, lsn_t>& checkpoints) {
+  if (writer_) {
+    // Don't let older coalesced writes overwrite these.
+    std::vector<logid_t> logs;
+    for (const auto& kv : checkpoints) {
+      logs.push_back(kv.first);
+    }
+    writer_->dropPending(logs);
+  }
   Status return_status = Status::UNKNOWN;
   for (int retries = 0; retries < options_.num_retries; retries++) {
     return_status = store_->updateLSNSync(reader_name_, checkpoints);
@@ -43,25 +64,41 @@ Status CheckpointedReaderBase::syncWriteCheckpoints(
 void CheckpointedReaderBase::asyncWriteCheckpoints(
     const std::map<logid_t, lsn_t>& checkpoints,
     StatusCallback cb) {
+  if (writer_) {
+    writer_->write(checkpoints, std::move(cb));
+    return;
+  }
   store_->updateLSN(reader_name_, checkpoints, std::move(cb));
 }
 
 Status CheckpointedReaderBase::syncRemoveCheckpoints(
     const std::vector<logid_t>& checkpoints) {
+  if (writer_) {
+    writer_->dropPending(checkpoints);
+  }
   return store_->removeCheckpointsSync(reader_name_, checkpoints);
 }
 
 void CheckpointedReaderBase::asyncRemoveCheckpoints(
     const std::vector<logid_t>& checkpoints,
     StatusCallback cb) {
+  if (writer_) {
+    writer_->dropPending(checkpoints);
+  }
   store_->removeCheckpoints(reader_name_, checkpoints, std::move(cb));
 }
 
 Status CheckpointedReaderBase::syncRemoveAllCheckpoints() {
+  if (writer_) {
+    writer_->dropAllPending();
+  }
   return store_->removeAllCheckpointsSync(reader_name_);
 }
 
 void CheckpointedReaderBase::asyncRemoveAllCheckpoints(StatusCallback cb) {
+  if (writer_) {
+    writer_->dropAllPending();
+  }
   store_->removeAllCheckpoints(reader_name_, std::move(cb));
 }
 
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/lib/checkpointing/CoalescingCheckpointWriter.h"
+
+#include <algorithm>
+
+#include <folly/executors/GlobalExecutor.h>
+#include <folly/io/async/EventBase.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+CoalescingCheckpointWriter::CoalescingCheckpointWriter(
+    CheckpointStore* store,
+    std::string customer_id,
+    std::chrono::milliseconds window,
+    CommitCallback commit_cb)
+    : store_(store),
+      customer_id_(std::move(customer_id)),
+      window_(window),
+      commit_cb_(std::move(commit_cb)),
+      event_base_(folly::getEventBase()),
+      timer_(folly::HHWheelTimer::newTimer(event_base_)),
+      holder_(this) {
+  ld_check(store_);
+}
+
+CoalescingCheckpointWriter::~CoalescingCheckpointWriter() {
+  event_base_->runImmediatelyOrRunInEventBaseThreadAndWait([this] {
+    holder_.invalidate();
+    timer_.reset();
+    Batch batch = std::move(pending_);
+    for (auto& cb : batch.callbacks) {
+      if (cb) {
+        cb(Status::SHUTDOWN);
+      }
+    }
+  });
+}
+
+void CoalescingCheckpointWriter::write(
+    const std::map<logid_t, lsn_t>& checkpoints,
+    StatusCallback cb) {
+  event_base_->runInEventBaseThread(
+      [this, ref = holder_.ref(), checkpoints, cb = std::move(cb)]() mutable {
+        if (!ref) {
+          if (cb) {
+            cb(Status::SHUTDOWN);
+          }
+          return;
+        }
+        if (pending_.callbacks.empty()) {
+          pending_.first_write = std::chrono::steady_clock::now();
+        }
+        for (auto [log_id, lsn] : checkpoints) {
+          pending_.checkpoints[log_id] = lsn;
+        }
+        pending_.callbacks.push_back(std::move(cb));
+        scheduleCommit();
+      });
+}
+
+void CoalescingCheckpointWriter::dropPending(const std::vector<logid_t>& logs) {
+  event_base_->runImmediatelyOrRunInEventBaseThreadAndWait([&] {
+    for (logid_t log_id : logs) {
+      pending_.checkpoints.erase(log_id);
+    }
+  });
+}
+
+void CoalescingCheckpointWriter::dropAllPending() {
+  event_base_->runImmediatelyOrRunInEventBaseThreadAndWait(
+      [&] { pending_.checkpoints.clear(); });
+}
+
+void CoalescingCheckpointWriter::scheduleCommit() {
+  if (commit_scheduled_ || commit_in_flight_ || pending_.callbacks.empty()) {
+    return;
+  }
+  commit_scheduled_ = true;
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - pending_.first_write);
+  auto delay = std::max(window_ - elapsed, std::chrono::milliseconds(0));
+  timer_->scheduleTimeoutFn(
+      [this, ref = holder_.ref()] {
+        if (!ref) {
+          return;
+        }
+        commit_scheduled_ = false;
+        commit();
+      },
+      delay);
+}
+
+void CoalescingCheckpointWriter::commit() {
+  ld_check(!commit_in_flight_);
+  Batch batch = std::move(pending_);
+  pending_ = Batch();
+  if (batch.checkpoints.empty()) {
+    // Everything was dropped by removals, nothing left to write.
+    for (auto& cb : batch.callbacks) {
+      if (cb) {
+        cb(Status::OK);
+      }
+    }
+    return;
+  }
+
+  commit_in_flight_ = true;
+  const std::map<logid_t, lsn_t> checkpoints = batch.checkpoints;
+  auto cb = [ref = holder_.ref(),
+             event_base = event_base_,
+             batch = std::move(batch)](Status status) mutable {
+    event_base->runInEventBaseThread(
+        [ref, batch = std::move(batch), status]() mutable {
+          CoalescingCheckpointWriter* writer = ref.get();
+          if (writer) {
+            writer->onCommitted(std::move(batch), status);
+            return;
+          }
+          for (auto& batch_cb : batch.callbacks) {
+            if (batch_cb) {
+              batch_cb(status);
+            }
+          }
+        });
+  };
+  store_->updateLSN(customer_id_, checkpoints, std::move(cb));
+}
+
+void CoalescingCheckpointWriter::onCommitted(Batch batch, Status status) {
+  ld_check(commit_in_flight_);
+  commit_in_flight_ = false;
+  auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - batch.first_write);
+  ld_debug("Committed %zu checkpoints from %zu writes for customer %s in "
+           "%ldms: %s",
+           batch.checkpoints.size(),
+           batch.callbacks.size(),
+           customer_id_.c_str(),
+           latency.count(),
+           error_name(status));
+
+  // Writes that came in meanwhile go next.
+  scheduleCommit();
+  if (commit_cb_) {
+    commit_cb_(status, batch.checkpoints.size(), latency);
+  }
+  // The callbacks may destroy this object.
+  for (auto& cb : batch.callbacks) {
+    if (cb) {
+      cb(status);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
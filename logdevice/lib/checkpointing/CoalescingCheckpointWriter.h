@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include <folly/io/async/HHWheelTimer.h>
+
+#include "logdevice/common/WeakRefHolder.h"
+#include "logdevice/include/CheckpointStore.h"
+#include "logdevice/include/CheckpointedReaderBase.h"
+
+namespace facebook { namespace logdevice {
+
+/*
+ * @file CoalescingCheckpointWriter merges the asynchronous checkpoint writes
+ *       of one customer over a time window and commits them to the
+ *       CheckpointStore as a single update, instead of doing one
+ *       read-modify-write of the customer's checkpoint per write.
+ *
+ *       At most one commit is in flight at a time. Writes that arrive while
+ *       it is go into the next commit, which is issued when the window of
+ *       its first write expires or the in-flight commit completes, whichever
+ *       comes last. If a log is written several times within a window, the
+ *       last LSN wins. Every write's callback gets the status of the commit
+ *       that carried it.
+ *
+ *       All state is kept on a single EventBase thread, so write() and
+ *       remove() may be called from any thread.
+ */
+class CoalescingCheckpointWriter {
+ public:
+  using StatusCallback = CheckpointedReaderBase::StatusCallback;
+  using CommitCallback = CheckpointedReaderBase::CommitCallback;
+
+  /**
+   * @param store: must outlive this object.
+   * @param window: how long to accumulate writes before committing them.
+   * @param commit_cb: if set, called after every commit, see
+   *   CheckpointingOptions::commit_cb.
+   */
+  CoalescingCheckpointWriter(CheckpointStore* store,
+                             std::string customer_id,
+                             std::chrono::milliseconds window,
+                             CommitCallback commit_cb = nullptr);
+
+  /**
+   * Fails the callbacks of writes that were not committed yet with
+   * E::SHUTDOWN. Callbacks of the in-flight commit are still called when it
+   * completes.
+   */
+  ~CoalescingCheckpointWriter();
+
+  void write(const std::map<logid_t, lsn_t>& checkpoints, StatusCallback cb);
+
+  /**
+   * Drops the given logs from the writes that are not committed yet, so that
+   * they don't overwrite checkpoints removed or written directly to the store
+   * afterwards. The callbacks of these writes still complete with the next
+   * commit.
+   */
+  void dropPending(const std::vector<logid_t>& logs);
+  void dropAllPending();
+
+ private:
+  struct Batch {
+    std::map<logid_t, lsn_t> checkpoints;
+    std::vector<StatusCallback> callbacks;
+    // when the first write of the batch was made
+    std::chrono::steady_clock::time_point first_write;
+  };
+
+  // The methods below run on event_base_.
+  void scheduleCommit();
+  void commit();
+  void onCommitted(Batch batch, Status status);
+
+  CheckpointStore* store_;
+  const std::string customer_id_;
+  const std::chrono::milliseconds window_;
+  CommitCallback commit_cb_;
+
+  folly::EventBase* event_base_;
+  folly::HHWheelTimer::UniquePtr timer_;
+
+  Batch pending_;
+  bool commit_scheduled_{false};
+  bool commit_in_flight_{false};
+
+  WeakRefHolder<CoalescingCheckpointWriter> holder_;
+};
+
+}} // namespace facebook::logdevice
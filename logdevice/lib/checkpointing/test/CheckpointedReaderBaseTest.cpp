@@ -8,6 +8,8 @@
 
 #include "logdevice/include/CheckpointedReaderBase.h"
 
+#include <atomic>
+
 #include <folly/synchronization/Baton.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -48,6 +50,43 @@ TEST_F(CheckpointedReaderBaseTest, AsyncWriteUsesCheckpointStore) {
   call_baton.wait();
 }
 
+TEST_F(CheckpointedReaderBaseTest, AsyncWritesAreCoalesced) {
+  std::map<logid_t, lsn_t> merged = {
+      {logid_t(3), 7}, {logid_t(5), 2}, {logid_t(9), 1}};
+  EXPECT_CALL(*mock_checkpoint_store_, updateLSN("customer", merged, _))
+      .Times(1)
+      .WillOnce(Invoke([](auto, auto, auto cb) { cb(Status::OK); }));
+
+  folly::Baton<> commit_baton;
+  CheckpointedReaderBase::CheckpointingOptions opts;
+  opts.commit_coalescing_window = std::chrono::milliseconds(50);
+  opts.commit_cb = [&commit_baton](Status status,
+                                   size_t num_logs,
+                                   std::chrono::milliseconds) {
+    EXPECT_EQ(Status::OK, status);
+    EXPECT_EQ(3u, num_logs);
+    commit_baton.post();
+  };
+  auto reader_base = MockCheckpointedReader(
+      "customer", std::move(mock_checkpoint_store_), opts);
+  reader_base.enableCommitCoalescing();
+
+  std::atomic<int> num_callbacks{0};
+  folly::Baton<> call_baton;
+  auto callback = [&num_callbacks, &call_baton](Status status) {
+    EXPECT_EQ(Status::OK, status);
+    if (++num_callbacks == 2) {
+      call_baton.post();
+    }
+  };
+  reader_base.asyncWriteCheckpoints({{logid_t(3), 4}, {logid_t(5), 2}},
+                                    callback);
+  reader_base.asyncWriteCheckpoints({{logid_t(3), 7}, {logid_t(9), 1}},
+                                    callback);
+  commit_baton.wait();
+  call_baton.wait();
+}
+
 TEST_F(CheckpointedReaderBaseTest, SyncWriteRetries) {
   std::map<logid_t, lsn_t> checkpoints = {{logid_t(3), 4}, {logid_t(5), 2}};
 
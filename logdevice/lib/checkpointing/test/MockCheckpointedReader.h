@@ -21,6 +21,8 @@ class MockCheckpointedReader : public CheckpointedReaderBase {
       : CheckpointedReaderBase(reader_name, std::move(store), std::move(opts)) {
   }
 
+  using CheckpointedReaderBase::enableCommitCoalescing;
+
   void insertLastReadLSN(logid_t log_id, lsn_t lsn) {
     last_read_lsn_.insert_or_assign(log_id, lsn);
   }
@@ -83,7 +83,8 @@ int Shadow::appendShadow(const AppendRequest& req) {
 
   int rv = shadow_client->append(
       logid, std::move(payload), req_attrs, req.getBufferedWriterBlobFlag());
-  if (rv == -1) {
+  if (rv == -1 && err != E::NOBUFS) {
+    // Drops are counted separately by ShadowClient.
     // TODO detailed scuba stats T20416930 including error code
     STAT_INCR(stats_, client.shadow_append_failed);
   }
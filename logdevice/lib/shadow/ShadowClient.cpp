@@ -147,7 +147,12 @@ void ShadowClientFactory::clientInitThreadMain() {
              attrs->destination().c_str());
     ld_check(client_timeout_.count() > 0);
     std::shared_ptr<ShadowClient> shadow_client =
-        ShadowClient::create(origin_name_, attrs, client_timeout_, stats_);
+        ShadowClient::create(origin_name_,
+                             attrs,
+                             client_timeout_,
+                             stats_,
+                             client_settings_->shadow_batching_time_trigger,
+                             client_settings_->shadow_buffer_limit_mb);
     if (shadow_client == nullptr) {
       // TODO scuba detailed stats T20416930 about which shadow and error code
       if (retry) {
@@ -175,7 +180,9 @@ std::shared_ptr<ShadowClient>
 ShadowClient::create(const std::string& origin_name,
                      const Shadow::Attrs& attrs,
                      std::chrono::milliseconds timeout,
-                     StatsHolder* stats) {
+                     StatsHolder* stats,
+                     std::chrono::milliseconds batching_time_trigger,
+                     size_t buffer_limit_mb) {
   std::string shadow_name(origin_name + ".shadow:" + attrs->destination());
   std::shared_ptr<Client> client =
       ClientFactory()
@@ -194,13 +201,33 @@ ShadowClient::create(const std::string& origin_name,
     return nullptr;
   }
 
-  return std::shared_ptr<ShadowClient>{new ShadowClient(client, attrs, stats)};
+  return std::shared_ptr<ShadowClient>{new ShadowClient(
+      client, attrs, stats, batching_time_trigger, buffer_limit_mb)};
 }
 
 ShadowClient::ShadowClient(std::shared_ptr<Client> client,
                            const Shadow::Attrs& attrs,
-                           StatsHolder* stats)
-    : client_(std::move(client)), shadow_attrs_(attrs), stats_(stats) {}
+                           StatsHolder* stats,
+                           std::chrono::milliseconds batching_time_trigger,
+                           size_t buffer_limit_mb)
+    : buffer_limit_bytes_(buffer_limit_mb << 20),
+      client_(std::move(client)),
+      shadow_attrs_(attrs),
+      stats_(stats) {
+  if (batching_time_trigger.count() > 0) {
+    BufferedWriter::Options opts;
+    opts.time_trigger = batching_time_trigger;
+    // Shadowing shouldn't cost the client more CPU than it saves.
+    opts.compression = Compression::NONE;
+    // Same semantics as separate shadow appends: no retries.
+    opts.retry_count = 0;
+    opts.mode = BufferedWriter::Options::Mode::INDEPENDENT;
+    opts.destroy_payloads = true;
+    opts.memory_limit_mb =
+        buffer_limit_mb > 0 ? static_cast<int32_t>(buffer_limit_mb) : -1;
+    writer_ = BufferedWriter::create(client_, this, opts);
+  }
+}
 
 ShadowClient::~ShadowClient() {}
 
@@ -208,12 +235,58 @@ int ShadowClient::append(logid_t logid,
                          PayloadHolder&& payload,
                          AppendAttributes attrs,
                          bool buffered_writer_blob) noexcept {
-  auto callback = [&](auto a, const auto& b) { this->appendCallback(a, b); };
-
   ld_spew(LD_SHADOW_PREFIX "Shadowing payload of size %zu to shadow '%s'",
           payload.size(),
           shadow_attrs_->destination().c_str()); // TODO replace with stats
 
+  int rv;
+  // A BufferedWriter blob can't be put in another batch since readers only
+  // unpack one level, and a batch has a single set of keys and counters.
+  if (writer_ && !buffered_writer_blob && attrs.optional_keys.empty() &&
+      !attrs.counters.hasValue()) {
+    rv = writer_->append(logid, payload.toString(), nullptr, std::move(attrs));
+    if (rv == 0) {
+      STAT_INCR(stats_, client.shadow_append_batched);
+    }
+  } else {
+    rv = appendDirect(
+        logid, std::move(payload), std::move(attrs), buffered_writer_blob);
+  }
+
+  if (rv == -1) {
+    if (err == E::NOBUFS) {
+      STAT_INCR(stats_, client.shadow_append_dropped);
+      RATELIMIT_INFO(1s,
+                     1,
+                     LD_SHADOW_PREFIX "Dropping shadow appends to '%s', over "
+                                      "the memory budget",
+                     shadow_attrs_->destination().c_str());
+    } else {
+      RATELIMIT_WARNING(1s,
+                        1,
+                        LD_SHADOW_PREFIX "Shadow append failed with '%s'",
+                        error_description(err));
+    }
+  }
+  return rv;
+}
+
+int ShadowClient::appendDirect(logid_t logid,
+                               PayloadHolder&& payload,
+                               AppendAttributes attrs,
+                               bool buffered_writer_blob) {
+  const int64_t size = payload.size();
+  if (buffer_limit_bytes_ > 0 &&
+      bytes_in_flight_.load() + size > buffer_limit_bytes_) {
+    err = E::NOBUFS;
+    return -1;
+  }
+  bytes_in_flight_ += size;
+  auto callback = [this, size](Status status, const DataRecord& record) {
+    bytes_in_flight_ -= size;
+    appendCallback(status, record);
+  };
+
   // Downcast client in order to use lower level API. The reason is we need
   // to be able to alter append request flags to match those of the original
   // request. In particular, we need to propage the BUFFERED_WRITER_BLOB
@@ -230,10 +303,8 @@ int ShadowClient::append(logid_t logid,
   }
 
   if (rv == -1) {
-    RATELIMIT_WARNING(1s,
-                      1,
-                      LD_SHADOW_PREFIX "Shadow append failed with '%s'",
-                      error_description(err));
+    // The callback won't be called.
+    bytes_in_flight_ -= size;
   }
   return rv;
 }
@@ -256,4 +327,23 @@ void ShadowClient::appendCallback(Status status, const DataRecord& record) {
   }
 }
 
+void ShadowClient::onSuccess(logid_t /*log_id*/,
+                             ContextSet contexts_and_payloads,
+                             const DataRecordAttributes& /*attrs*/) {
+  STAT_ADD(stats_, client.shadow_append_success, contexts_and_payloads.size());
+}
+
+void ShadowClient::onFailure(logid_t log_id,
+                             ContextSet contexts_and_payloads,
+                             Status status) {
+  STAT_ADD(stats_, client.shadow_append_failed, contexts_and_payloads.size());
+  RATELIMIT_WARNING(1s,
+                    1,
+                    LD_SHADOW_PREFIX
+                    "Batch of %zu shadow appends to logid %lu failed with '%s'",
+                    contexts_and_payloads.size(),
+                    log_id.val(),
+                    error_description(status));
+}
+
 }} // namespace facebook::logdevice
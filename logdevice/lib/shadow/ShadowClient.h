@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <memory>
@@ -18,6 +19,7 @@
 
 #include <folly/Synchronized.h>
 
+#include "logdevice/include/BufferedWriter.h"
 #include "logdevice/include/Client.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/Record.h"
@@ -28,6 +30,14 @@
  *       shadow clusters. The factory maintains a map of destination URLs to
  *       their associated client objects, and provides a method for creating the
  *       client object asynchronously if it doesn't yet exist.
+ *
+ *       ShadowClient forwards the payload it is given, which shares the
+ *       refcounted buffer of the original append, without copying it. With
+ *       Settings::shadow_batching_time_trigger, records that can be batched
+ *       go through a BufferedWriter instead, which copies them into batches.
+ *       Either way the payloads held by a shadow client are bounded by
+ *       Settings::shadow_buffer_limit_mb, and shadow appends over that budget
+ *       are dropped.
  */
 
 namespace facebook { namespace logdevice {
@@ -107,35 +117,75 @@ class ShadowClientFactory {
   bool shutdown_ = false;
 };
 
-class ShadowClient {
+class ShadowClient : public BufferedWriter::AppendCallback {
  public:
   /**
    * Creates a shadow client object backed by a Client object used for shadow
    * appends. Runs on current thread, so should only be used by the factory.
+   *
+   * @param batching_time_trigger  if nonzero, batch appends with a
+   *                               BufferedWriter flushing after this long
+   * @param buffer_limit_mb        memory budget for payloads not appended
+   *                               yet, 0 for no limit
    */
-  static std::shared_ptr<ShadowClient> create(const std::string& origin_name,
-                                              const Shadow::Attrs& attrs,
-                                              std::chrono::milliseconds timeout,
-                                              StatsHolder* stats);
+  static std::shared_ptr<ShadowClient>
+  create(const std::string& origin_name,
+         const Shadow::Attrs& attrs,
+         std::chrono::milliseconds timeout,
+         StatsHolder* stats,
+         std::chrono::milliseconds batching_time_trigger =
+             std::chrono::milliseconds::zero(),
+         size_t buffer_limit_mb = 0);
 
-  ~ShadowClient();
+  ~ShadowClient() override;
 
+  /**
+   * @return 0 if the append was sent or buffered, -1 otherwise with err set.
+   *         E::NOBUFS means it was dropped because the shadow client is over
+   *         its memory budget.
+   */
   int append(logid_t logid,
              PayloadHolder&& payload,
              AppendAttributes attrs,
              bool buffered_writer_blob) noexcept;
 
+  // BufferedWriter::AppendCallback interface, for batched appends
+  void onSuccess(logid_t log_id,
+                 ContextSet contexts_and_payloads,
+                 const DataRecordAttributes& attrs) override;
+  void onFailure(logid_t log_id,
+                 ContextSet contexts_and_payloads,
+                 Status status) override;
+
  private:
   ShadowClient(std::shared_ptr<Client> client,
                const Shadow::Attrs& attrs,
-               StatsHolder* stats);
+               StatsHolder* stats,
+               std::chrono::milliseconds batching_time_trigger,
+               size_t buffer_limit_mb);
+
+  // Sends the record as a separate append.
+  int appendDirect(logid_t logid,
+                   PayloadHolder&& payload,
+                   AppendAttributes attrs,
+                   bool buffered_writer_blob);
 
   void appendCallback(Status status, const DataRecord& record);
 
+  // Bytes of payloads of direct appends in flight, bounded by
+  // buffer_limit_bytes_. Declared before client_ since callbacks may run
+  // while client_ is being destroyed.
+  std::atomic<int64_t> bytes_in_flight_{0};
+  const int64_t buffer_limit_bytes_;
+
   std::shared_ptr<Client> client_;
   Shadow::Attrs shadow_attrs_;
   StatsHolder* stats_;
   std::chrono::milliseconds client_timeout_{0};
+
+  // Batches appends if batching is enabled, null otherwise. Has its own
+  // budget of buffer_limit_bytes_ for the batched payloads.
+  std::unique_ptr<BufferedWriter> writer_;
 };
 
 }} // namespace facebook::logdevice
@@ -29,6 +29,12 @@ class MockClient : public Client {
   MOCK_METHOD1(setTimeout, void(std::chrono::milliseconds timeout));
   MOCK_METHOD2(trimSync, int(logid_t logid, lsn_t lsn));
   MOCK_METHOD3(trim, int(logid_t logid, lsn_t lsn, trim_callback_t cb));
+  MOCK_METHOD2(trimBulkSync,
+               int(std::vector<std::pair<logid_t, lsn_t>>,
+                   std::vector<TrimBulkResult>*));
+  MOCK_METHOD2(trimBulk,
+               int(std::vector<std::pair<logid_t, lsn_t>>,
+                   trim_bulk_callback_t));
   MOCK_METHOD1(addWriteToken, void(std::string));
   MOCK_METHOD4(
       findTimeSync,
@@ -40,6 +46,16 @@ class MockClient : public Client {
                    std::chrono::milliseconds,
                    find_time_callback_t,
                    FindKeyAccuracy));
+  MOCK_METHOD4(findTimeBulkSync,
+               int(std::vector<logid_t>,
+                   std::chrono::milliseconds,
+                   std::vector<FindTimeBulkResult>*,
+                   FindKeyAccuracy));
+  MOCK_METHOD4(findTimeBulk,
+               int(std::vector<logid_t>,
+                   std::chrono::milliseconds,
+                   find_time_bulk_callback_t,
+                   FindKeyAccuracy));
   MOCK_METHOD4(findKey,
                int(logid_t, std::string, find_key_callback_t, FindKeyAccuracy));
   MOCK_METHOD2(isLogEmptySync, int(logid_t logid, bool* empty));
@@ -62,6 +78,14 @@ class MockClient : public Client {
                std::unique_ptr<LogTailAttributes>(logid_t logid));
   MOCK_METHOD2(getTailAttributes,
                int(logid_t logid, get_tail_attributes_callback_t cb));
+  MOCK_METHOD2(getTailAttributesBulkSync,
+               int(std::vector<logid_t> logids,
+                   std::vector<LogTailAttributesResult>* results));
+  MOCK_METHOD2(getTailAttributesBulk,
+               int(std::vector<logid_t> logids,
+                   get_tail_attributes_bulk_callback_t cb));
+  MOCK_METHOD1(readLogTailSync, std::unique_ptr<DataRecord>(logid_t logid));
+  MOCK_METHOD2(readLogTail, int(logid_t logid, read_log_tail_callback_t cb));
   MOCK_METHOD1(getHeadAttributesSync,
                std::unique_ptr<LogHeadAttributes>(logid_t logid));
   MOCK_METHOD2(getHeadAttributes,
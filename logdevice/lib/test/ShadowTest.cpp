@@ -295,4 +295,29 @@ TEST(ShadowClientTest, ShadowClientInitAppend) {
   ASSERT_EQ(rv, 0);
 }
 
+TEST(ShadowClientTest, ShadowClientBatchingAndBudget) {
+  LogAttributes::Shadow shadowAttr{
+      std::string("file:") + TEST_CONFIG_FILE("sample_no_ssl.conf"), 0.1};
+  std::shared_ptr<ShadowClient> shadow_client =
+      ShadowClient::create("test",
+                           shadowAttr,
+                           std::chrono::seconds(10),
+                           nullptr,
+                           std::chrono::milliseconds(10),
+                           1 /* buffer_limit_mb */);
+  ASSERT_NE(shadow_client, nullptr);
+
+  // Batched
+  int rv = shadow_client->append(
+      logid_t{1}, PayloadHolder::copyString("test"), {}, false);
+  ASSERT_EQ(rv, 0);
+
+  // BufferedWriter blobs are sent as they are, and dropped when over budget
+  std::string big(2 << 20, 'x');
+  rv = shadow_client->append(
+      logid_t{1}, PayloadHolder::copyString(big), {}, true);
+  ASSERT_EQ(rv, -1);
+  ASSERT_EQ(err, E::NOBUFS);
+}
+
 }} // namespace facebook::logdevice
@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/lib/verifier/VerificationTrailer.h"
+
+#include <cstring>
+
+#include "logdevice/common/Checksum.h"
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr uint32_t VerificationTrailer::MAGIC;
+constexpr size_t VerificationTrailerChecker::MAX_OUT_OF_ORDER;
+
+VerificationTrailerWriter::VerificationTrailerWriter(uint64_t writer_id)
+    : writer_id_(writer_id) {}
+
+void VerificationTrailerWriter::appendTrailer(logid_t log_id,
+                                              std::string& payload) {
+  vsn_t seq;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seq = next_seq_nums_[log_id]++;
+  }
+  appendTrailer(payload, writer_id_, seq);
+}
+
+void VerificationTrailerWriter::appendTrailer(std::string& payload,
+                                              uint64_t writer_id,
+                                              vsn_t sequence_num) {
+  VerificationTrailer trailer;
+  trailer.writer_id = writer_id;
+  trailer.sequence_num = sequence_num;
+  trailer.payload_checksum =
+      checksum_32bit(Slice(payload.data(), payload.size()));
+  trailer.magic_number = VerificationTrailer::MAGIC;
+  payload.append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+}
+
+void VerificationTrailerChecker::checkRecords(
+    std::vector<std::unique_ptr<DataRecord>>& records,
+    const error_callback_t& ecb) {
+  // First pass: find the records with a trailer and strip it.
+  std::vector<size_t> positions;
+  std::vector<VerificationTrailer> trailers;
+  std::vector<Slice> slices;
+  positions.reserve(records.size());
+  trailers.reserve(records.size());
+  slices.reserve(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    Payload& p = records[i]->payload;
+    if (p.size() < sizeof(VerificationTrailer)) {
+      ++stats_.no_trailer;
+      continue;
+    }
+    const size_t user_size = p.size() - sizeof(VerificationTrailer);
+    VerificationTrailer trailer;
+    std::memcpy(&trailer,
+                static_cast<const char*>(p.data()) + user_size,
+                sizeof(trailer));
+    if (trailer.magic_number != VerificationTrailer::MAGIC) {
+      ++stats_.no_trailer;
+      continue;
+    }
+    p = Payload(p.data(), user_size);
+    positions.push_back(i);
+    trailers.push_back(trailer);
+    slices.emplace_back(p.data(), user_size);
+  }
+
+  std::vector<uint32_t> checksums(slices.size());
+  checksum_32bit_batch(slices.data(), slices.size(), checksums.data());
+
+  // Second pass: check checksums and sequence numbers in read order.
+  for (size_t j = 0; j < positions.size(); ++j) {
+    const DataRecord& record = *records[positions[j]];
+    const VerificationTrailer& trailer = trailers[j];
+    ++stats_.records;
+    if (checksums[j] != trailer.payload_checksum) {
+      ++stats_.checksum_mismatches;
+      VerificationFoundError vfe;
+      vfe.vrs = VerificationRecordStatus::CHECKSUM_MISMATCH;
+      vfe.error_record = std::make_pair(
+          trailer.sequence_num, VerificationAppendInfo{record.attrs.lsn});
+      ecb(vfe);
+      continue;
+    }
+    checkSequenceNumber(trailer, record.logid, record.attrs.lsn, ecb);
+  }
+}
+
+void VerificationTrailerChecker::checkSequenceNumber(
+    const VerificationTrailer& trailer,
+    logid_t log_id,
+    lsn_t lsn,
+    const error_callback_t& ecb) {
+  const vsn_t seq = trailer.sequence_num;
+  auto res = writers_.emplace(std::make_pair(log_id, trailer.writer_id),
+                              WriterState{seq, {}});
+  WriterState& state = res.first->second;
+
+  auto report = [&](VerificationRecordStatus vrs, vsn_t error_seq, lsn_t l) {
+    VerificationFoundError vfe;
+    vfe.vrs = vrs;
+    vfe.error_record = std::make_pair(error_seq, VerificationAppendInfo{l});
+    ecb(vfe);
+  };
+
+  if (seq < state.next_expected || state.seen_above.count(seq)) {
+    ++stats_.duplicates;
+    report(VerificationRecordStatus::DUPLICATE, seq, lsn);
+    return;
+  }
+
+  if (seq > state.next_expected) {
+    if (!state.seen_above.empty() && seq < *state.seen_above.rbegin()) {
+      // seq fills a gap above the lowest one.
+      ++stats_.reordered;
+      report(VerificationRecordStatus::REORDERING, seq, lsn);
+    }
+    state.seen_above.insert(seq);
+    if (state.seen_above.size() <= MAX_OUT_OF_ORDER) {
+      return;
+    }
+    // Too many records past the lowest gap: give up on it.
+    const vsn_t resume = *state.seen_above.begin();
+    stats_.lost += resume - state.next_expected;
+    VerificationFoundError vfe;
+    vfe.vrs = VerificationRecordStatus::DATALOSS;
+    vfe.error_record = std::make_pair(
+        state.next_expected, VerificationAppendInfo{LSN_INVALID});
+    vfe.error_discovery_record =
+        std::make_pair(resume, VerificationAppendInfo{LSN_INVALID});
+    ecb(vfe);
+    state.next_expected = resume;
+  } else {
+    ld_check(seq == state.next_expected);
+    if (!state.seen_above.empty()) {
+      // seq fills the lowest gap.
+      ++stats_.reordered;
+      report(VerificationRecordStatus::REORDERING, seq, lsn);
+    }
+    ++state.next_expected;
+  }
+
+  // Skip over the sequence numbers already seen.
+  while (!state.seen_above.empty() &&
+         *state.seen_above.begin() == state.next_expected) {
+    state.seen_above.erase(state.seen_above.begin());
+    ++state.next_expected;
+  }
+}
+
+size_t VerificationTrailerChecker::getNumMissing() const {
+  size_t missing = 0;
+  for (const auto& kv : writers_) {
+    const WriterState& state = kv.second;
+    if (!state.seen_above.empty()) {
+      missing += *state.seen_above.rbegin() - state.next_expected + 1 -
+          state.seen_above.size();
+    }
+  }
+  return missing;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <folly/Random.h>
+
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+#include "logdevice/lib/verifier/VerificationDataStructures.h"
+
+/**
+ * @file Compact alternative to the verification data of VerificationWriter,
+ * cheap enough to be enabled on a share of production writers.
+ *
+ * Instead of a variable-size header with an ack list in front of the payload,
+ * the writer appends a fixed 24-byte trailer: writer id, per-log sequence
+ * number and CRC32C of the payload. The user payload stays a prefix of the
+ * record, so readers strip the trailer without copying.
+ *
+ * VerificationTrailerChecker detects corrupted, duplicated and reordered
+ * records, as well as sequence numbers that never showed up. Since there are
+ * no ack lists, a missing sequence number is only a loss if the append
+ * succeeded; writers should compare the number of missing records with their
+ * own count of failed appends.
+ */
+
+namespace facebook { namespace logdevice {
+
+struct VerificationTrailer {
+  static constexpr uint32_t MAGIC = 0x31525456; // "VTR1"
+
+  uint64_t writer_id;
+  vsn_t sequence_num;
+  uint32_t payload_checksum;
+  uint32_t magic_number;
+};
+
+static_assert(sizeof(VerificationTrailer) == 24,
+              "VerificationTrailer is part of the record format");
+
+class VerificationTrailerWriter {
+ public:
+  explicit VerificationTrailerWriter(
+      uint64_t writer_id = folly::Random::rand64());
+
+  /**
+   * Appends a trailer with the next sequence number of `log_id` to `payload`.
+   * Thread-safe.
+   */
+  void appendTrailer(logid_t log_id, std::string& payload);
+
+  /**
+   * Appends a trailer with the given writer id and sequence number.
+   */
+  static void appendTrailer(std::string& payload,
+                            uint64_t writer_id,
+                            vsn_t sequence_num);
+
+  uint64_t getWriterID() const {
+    return writer_id_;
+  }
+
+ private:
+  const uint64_t writer_id_;
+  std::mutex mutex_;
+  std::unordered_map<logid_t, vsn_t, logid_t::Hash> next_seq_nums_;
+};
+
+class VerificationTrailerChecker {
+ public:
+  struct Stats {
+    // records that had a trailer
+    size_t records = 0;
+    size_t no_trailer = 0;
+    size_t checksum_mismatches = 0;
+    size_t duplicates = 0;
+    // records that filled a gap in the sequence numbers of their writer
+    size_t reordered = 0;
+    // sequence numbers given up on, see MAX_OUT_OF_ORDER
+    size_t lost = 0;
+  };
+
+  // Number of sequence numbers above a gap that are remembered per writer.
+  // Once exceeded, the lowest gap is given up on and reported with a single
+  // DATALOSS error: error_record is the first sequence number of the gap and
+  // error_discovery_record the first one after it.
+  static constexpr size_t MAX_OUT_OF_ORDER = 4096;
+
+  /**
+   * Checks a batch of records, e.g. the output of Reader::read(). Records
+   * with a trailer get it stripped from their payload. The checksums of the
+   * whole batch are computed together with checksum_32bit_batch(). Records
+   * without a trailer are left untouched.
+   *
+   * The first sequence number seen from a writer on a log is taken as the
+   * starting point, so the reader may start reading anywhere.
+   */
+  void checkRecords(std::vector<std::unique_ptr<DataRecord>>& records,
+                    const error_callback_t& ecb);
+
+  const Stats& getStats() const {
+    return stats_;
+  }
+
+  /**
+   * @return number of sequence numbers below the highest one seen that have
+   *         not been seen yet, over all writers. These are either still to be
+   *         read (reordering), failed appends, or lost.
+   */
+  size_t getNumMissing() const;
+
+ private:
+  struct WriterState {
+    // All sequence numbers below this one were seen or reported lost.
+    vsn_t next_expected;
+    // Sequence numbers above next_expected that were seen.
+    std::set<vsn_t> seen_above;
+  };
+
+  void checkSequenceNumber(const VerificationTrailer& trailer,
+                           logid_t log_id,
+                           lsn_t lsn,
+                           const error_callback_t& ecb);
+
+  std::map<std::pair<logid_t, uint64_t>, WriterState> writers_;
+  Stats stats_;
+};
+
+}} // namespace facebook::logdevice
@@ -19,6 +19,7 @@
 #include "logdevice/lib/verifier/MockDataSourceWriter.h"
 #include "logdevice/lib/verifier/VerificationDataStructures.h"
 #include "logdevice/lib/verifier/VerificationReader.h"
+#include "logdevice/lib/verifier/VerificationTrailer.h"
 #include "logdevice/lib/verifier/VerificationWriter.h"
 
 using namespace facebook::logdevice;
@@ -613,3 +614,79 @@ TEST(VerificationTest, ReorderingDetectionTest) {
     EXPECT_EQ(reordered_vai, verified_reordered_records);
   }
 }
+
+TEST(VerificationTest, TrailerRoundTrip) {
+  const logid_t log(1);
+  VerificationTrailerWriter writer;
+  std::vector<std::string> payloads;
+  std::vector<std::unique_ptr<DataRecord>> records;
+  for (int i = 0; i < 10; ++i) {
+    payloads.push_back("payload " + toString(i));
+    writer.appendTrailer(log, payloads.back());
+    EXPECT_EQ(("payload " + toString(i)).size() + sizeof(VerificationTrailer),
+              payloads.back().size());
+  }
+  for (int i = 0; i < 10; ++i) {
+    records.push_back(std::make_unique<DataRecord>(
+        log, Payload(payloads[i].data(), payloads[i].size()), lsn_t(i + 1)));
+  }
+  // A record written without the trailer.
+  std::string plain = "no trailer";
+  records.push_back(std::make_unique<DataRecord>(
+      log, Payload(plain.data(), plain.size()), lsn_t(11)));
+
+  VerificationTrailerChecker checker;
+  size_t errors = 0;
+  checker.checkRecords(
+      records, [&](const VerificationFoundError& /*vfe*/) { ++errors; });
+  EXPECT_EQ(0, errors);
+  EXPECT_EQ(10, checker.getStats().records);
+  EXPECT_EQ(1, checker.getStats().no_trailer);
+  EXPECT_EQ(0, checker.getNumMissing());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ("payload " + toString(i), records[i]->payload.toString());
+  }
+  EXPECT_EQ(plain, records[10]->payload.toString());
+}
+
+TEST(VerificationTest, TrailerDetectsErrors) {
+  const logid_t log(1);
+  const uint64_t writer_id = 42;
+  // 2 is read after 3, 1 is duplicated and 4 is never read.
+  const std::vector<vsn_t> seqs = {0, 1, 1, 3, 2, 5, 6};
+  std::vector<std::string> payloads;
+  std::vector<std::unique_ptr<DataRecord>> records;
+  for (vsn_t seq : seqs) {
+    payloads.push_back("record " + toString(seq));
+    VerificationTrailerWriter::appendTrailer(payloads.back(), writer_id, seq);
+  }
+  // Corrupt the payload of record 6.
+  payloads.back()[0] = 'R';
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    records.push_back(std::make_unique<DataRecord>(
+        log, Payload(payloads[i].data(), payloads[i].size()), lsn_t(i + 1)));
+  }
+
+  VerificationTrailerChecker checker;
+  std::vector<VerificationFoundError> errors;
+  checker.checkRecords(records, [&](const VerificationFoundError& vfe) {
+    errors.push_back(vfe);
+  });
+
+  ASSERT_EQ(3, errors.size());
+  EXPECT_EQ(VerificationRecordStatus::DUPLICATE, errors[0].vrs);
+  EXPECT_EQ(1, errors[0].error_record.first);
+  EXPECT_EQ(lsn_t(3), errors[0].error_record.second.lsn);
+  EXPECT_EQ(VerificationRecordStatus::REORDERING, errors[1].vrs);
+  EXPECT_EQ(2, errors[1].error_record.first);
+  EXPECT_EQ(VerificationRecordStatus::CHECKSUM_MISMATCH, errors[2].vrs);
+  EXPECT_EQ(6, errors[2].error_record.first);
+
+  const auto& stats = checker.getStats();
+  EXPECT_EQ(seqs.size(), stats.records);
+  EXPECT_EQ(1, stats.duplicates);
+  EXPECT_EQ(1, stats.reordered);
+  EXPECT_EQ(1, stats.checksum_mismatches);
+  EXPECT_EQ(0, stats.lost);
+  EXPECT_EQ(1, checker.getNumMissing());
+}
@@ -23,12 +23,14 @@
 #include "tables/ClientReadStreams.h"
 #include "tables/ClusterStateTable.h"
 #include "tables/EpochStore.h"
+#include "tables/EventLoop.h"
 #include "tables/EventLog.h"
 #include "tables/Graylist.h"
 #include "tables/HistoricalMetadata.h"
 #include "tables/Info.h"
 #include "tables/InfoConfig.h"
 #include "tables/InfoRsm.h"
+#include "tables/IOTracing.h"
 #include "tables/Iterators.h"
 #include "tables/LogGroups.h"
 #include "tables/LogRebuildings.h"
@@ -150,12 +152,14 @@ LDQuery::LDQuery(std::string config_path,
   table_registry_.registerTable<tables::LogsDBDirectory>(ctx_);
   table_registry_.registerTable<tables::EpochStore>(ctx_);
   table_registry_.registerTable<tables::EventLog>(ctx_);
+  table_registry_.registerTable<tables::EventLoop>(ctx_);
   table_registry_.registerTable<tables::Graylist>(ctx_);
   table_registry_.registerTable<tables::HistoricalMetadata>(ctx_);
   table_registry_.registerTable<tables::HistoricalMetadataLegacy>(ctx_);
   table_registry_.registerTable<tables::Info>(ctx_);
   table_registry_.registerTable<tables::InfoConfig>(ctx_);
   table_registry_.registerTable<tables::InfoRsm>(ctx_);
+  table_registry_.registerTable<tables::IOTracing>(ctx_);
   table_registry_.registerTable<tables::Iterators>(ctx_);
   table_registry_.registerTable<tables::LogGroups>(ctx_);
   table_registry_.registerTable<tables::LogRebuildings>(ctx_);
@@ -190,6 +190,32 @@ bool Table::columnHasEqualityConstraintOnLogid(int col,
   return true;
 }
 
+bool Table::columnHasEqualityConstraintOnClientID(int col,
+                                                  QueryContext& ctx,
+                                                  int32_t& client_idx) const {
+  auto it_constraints = ctx.constraints.find(col);
+  if (it_constraints == ctx.constraints.end()) {
+    return false;
+  }
+
+  for (const Constraint& c : it_constraints->second.constraints_) {
+    if (c.op != SQLITE_INDEX_CONSTRAINT_EQ || !c.expr.has_value()) {
+      continue;
+    }
+    const std::string& expr = c.expr.value();
+    if (expr.size() < 2 || expr[0] != 'C') {
+      continue;
+    }
+    auto idx = folly::tryTo<int32_t>(folly::StringPiece(expr).subpiece(1));
+    if (idx.hasValue() && idx.value() > 0) {
+      ctx.used_constraints[col].add(c);
+      client_idx = idx.value();
+      return true;
+    }
+  }
+  return false;
+}
+
 bool Table::columnHasConstraintsOnLSN(int col,
                                       QueryContext& ctx,
                                       std::pair<lsn_t, lsn_t>& range) const {
@@ -264,6 +264,20 @@ class Table {
                                           QueryContext& ctx,
                                           logid_t& logid) const;
 
+  /**
+   * Checks if there is an equality constraint on column `col` for a client
+   * id, formatted like ClientID::toString() (e.g. "C42"). Constraints that
+   * can't be parsed as a client id are left for SQLite to evaluate.
+   * @param col Column for which to look for constraints;
+   * @param ctx Query context;
+   * @param client_idx if there is such a constraint, populated with the index
+   *                   of the client id (e.g. 42).
+   * @return True if an equality constraint was found.
+   */
+  bool columnHasEqualityConstraintOnClientID(int col,
+                                             QueryContext& ctx,
+                                             int32_t& client_idx) const;
+
   /**
    * Checks if there are constraints to be applied on the column `col` that is
    * for a LSN.
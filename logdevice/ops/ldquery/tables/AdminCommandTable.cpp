@@ -7,10 +7,9 @@
  */
 #include "logdevice/ops/ldquery/tables/AdminCommandTable.h"
 
-#include <thread>
-
 #include <folly/Memory.h>
 #include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/json.h>
 
 #include "external/gason/gason.h"
@@ -23,6 +22,8 @@ using std::chrono::steady_clock;
 
 namespace facebook { namespace logdevice { namespace ldquery {
 
+constexpr size_t AdminCommandTable::MAX_PARSING_THREADS;
+
 namespace {
 struct ColumnAndDataType {
   Column* data = nullptr;
@@ -283,8 +284,11 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
           requests.size());
 
   steady_clock::time_point tstart = steady_clock::now();
-  auto responses = ld_admin_client.send(requests, command_timeout_);
-  ld_check(requests.size() == responses.size());
+  std::vector<AdminCommandClient::Response> responses;
+  std::vector<TableData> results =
+      fetchAndTransform(ld_admin_client, requests, responses);
+  ld_check(results.size() == requests.size());
+  ld_check(responses.size() == requests.size());
   steady_clock::time_point tend = steady_clock::now();
   double duration =
       std::chrono::duration_cast<std::chrono::duration<double>>(tend - tstart)
@@ -293,15 +297,12 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
   for (const auto& r : responses) {
     replies += r.success;
   }
-  ld_info("Receiving data took %.1fs, %lu/%lu nodes replied",
+  ld_info("Receiving and parsing data took %.1fs, %lu/%lu nodes replied",
           duration,
           replies,
           responses.size());
   tstart = tend;
 
-  ld_info("Parsing json data...");
-  std::vector<TableData> results = transformDataParallel(responses);
-  ld_check(results.size() == responses.size());
   for (int i = 0; i < results.size(); ++i) {
     if (!results[i].cols.empty()) {
       size_t rows = results[i].cols.begin()->second.size();
@@ -323,13 +324,6 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
     }
   }
 
-  tend = steady_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::duration<double>>(tend - tstart)
-          .count();
-  ld_info("Json parsing took %.1fs", duration);
-
-  tstart = tend;
   Data data;
   ld_info("Aggregating data from %lu nodes...", responses.size());
   data.data = std::make_shared<TableData>(aggregate(std::move(results)));
@@ -698,39 +692,54 @@ AdminCommandTable::transformData(std::string response_from_node) const {
   return PartialTableData{folly::none, false, "UNEXPECTED"};
 }
 
-std::vector<TableData> AdminCommandTable::transformDataParallel(
+std::vector<TableData> AdminCommandTable::fetchAndTransform(
+    const AdminCommandClient& client,
+    const std::vector<AdminCommandClient::Request>& requests,
     std::vector<AdminCommandClient::Response>& responses) {
-  std::vector<TableData> outputs(responses.size());
-
-  auto thread_func = [&](size_t from, size_t to) {
-    for (size_t i = from; i < std::min(to, responses.size()); ++i) {
-      if (responses[i].success) {
-        PartialTableData partial_data =
-            transformData(std::move(responses[i].response));
-        if (partial_data.success) {
-          outputs[i] = std::move(*(partial_data.data));
-        } else {
-          responses[i].success = false;
-          responses[i].failure_reason = partial_data.failure_reason;
-        }
-      }
-    }
-  };
-
-  const size_t num_threads = 32;
-  const size_t num_per_thread = responses.size() / num_threads + 1;
-
-  std::vector<std::thread> threads;
-  for (int i = 0; i < num_threads && i * num_per_thread < responses.size();
-       i++) {
-    const size_t from = i * num_per_thread;
-    const size_t to = from + num_per_thread;
-    threads.push_back(std::thread(thread_func, from, to));
-  }
-
-  for (int i = 0; i < threads.size(); ++i) {
-    threads[i].join();
-  }
+  responses.clear();
+  responses.resize(requests.size());
+  std::vector<TableData> outputs(requests.size());
+  if (requests.empty()) {
+    return outputs;
+  }
+
+  // Parse each reply as soon as it arrives, so that parsing the replies of
+  // fast nodes overlaps with waiting for slow ones.
+  folly::CPUThreadPoolExecutor parse_executor(
+      std::min(requests.size(), MAX_PARSING_THREADS));
+  auto futures = client.asyncSend(requests, command_timeout_);
+  ld_check(futures.size() == requests.size());
+
+  std::vector<folly::Future<folly::Unit>> parsed;
+  parsed.reserve(futures.size());
+  for (size_t i = 0; i < futures.size(); ++i) {
+    parsed.push_back(
+        std::move(futures[i])
+            .via(&parse_executor)
+            .thenTry([this, i, &responses, &outputs](
+                         folly::Try<AdminCommandClient::Response> response) {
+              // Each callback only touches the entries of its own node.
+              AdminCommandClient::Response& r = responses[i];
+              if (response.hasException()) {
+                r = AdminCommandClient::Response(
+                    "", false, response.exception().what().toStdString());
+                return;
+              }
+              r = std::move(response).value();
+              if (!r.success) {
+                return;
+              }
+              PartialTableData partial_data =
+                  transformData(std::move(r.response));
+              if (partial_data.success) {
+                outputs[i] = std::move(*(partial_data.data));
+              } else {
+                r.success = false;
+                r.failure_reason = partial_data.failure_reason;
+              }
+            }));
+  }
+  folly::collectAll(parsed).wait();
 
   return outputs;
 }
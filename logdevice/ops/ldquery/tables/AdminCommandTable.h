@@ -35,6 +35,8 @@ class AdminCommandTable : public Table {
  public:
   // @see num_fetches_.
   static constexpr int MAX_FETCHES = 5;
+  // Maximum number of threads parsing the replies of nodes.
+  static constexpr size_t MAX_PARSING_THREADS = 32;
 
   enum class Type { JSON_TABLE, STAT };
 
@@ -125,8 +127,14 @@ class AdminCommandTable : public Table {
   // getFetchableColumns().
   std::unordered_map<ColumnName, int> nameToPosMap_;
 
+  // Sends the requests to all nodes at once and transforms each reply into
+  // TableData as soon as it is received. `responses` is populated with the
+  // outcome for each node; replies that could not be transformed are turned
+  // into failures.
   std::vector<TableData>
-  transformDataParallel(std::vector<AdminCommandClient::Response>& responses);
+  fetchAndTransform(const AdminCommandClient& client,
+                    const std::vector<AdminCommandClient::Request>& requests,
+                    std::vector<AdminCommandClient::Response>& responses);
 
   std::chrono::milliseconds command_timeout_;
   Type type_;
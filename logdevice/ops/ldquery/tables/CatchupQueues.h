@@ -75,7 +75,12 @@ class CatchupQueues : public AdminCommandTable {
          "schedule more reads under certain conditions.  This column indicates "
          "whether the timer is currently active."}};
   }
-  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+  std::string getCommandToSend(QueryContext& ctx) const override {
+    int32_t client_idx;
+    if (columnHasEqualityConstraintOnClientID(1, ctx, client_idx)) {
+      return std::string("info catchup_queues --client=") +
+          std::to_string(client_idx) + " --json\n";
+    }
     return std::string("info catchup_queues --json\n");
   }
 };
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "../Context.h"
+#include "AdminCommandTable.h"
+
+namespace facebook {
+  namespace logdevice {
+    namespace ldquery {
+      namespace tables {
+
+class EventLoop : public AdminCommandTable {
+ public:
+  explicit EventLoop(std::shared_ptr<Context> ctx) : AdminCommandTable(ctx) {}
+  static std::string getName() {
+    return "event_loop";
+  }
+  std::string getDescription() override {
+    return "How long requests, message callbacks and storage task responses "
+           "of each type take to run on each worker thread, the slowest "
+           "first. Useful for finding what blocks workers' event loops. The "
+           "average is computed over a sample of executions (see "
+           "\"event-loop-profiler-sampling-rate\"), the maximum over all of "
+           "them.";
+  }
+  TableColumns getFetchableColumns() const override {
+    return {
+        {"worker", DataType::TEXT, "Name of the worker thread."},
+        {"context",
+         DataType::TEXT,
+         "What ran: \"request\", \"message\" or \"storage_task_response\"."},
+        {"type",
+         DataType::TEXT,
+         "Request type, message type or storage task type."},
+        {"sampled",
+         DataType::BIGINT,
+         "Number of executions the average was computed over."},
+        {"avg_usec",
+         DataType::BIGINT,
+         "Average execution time in microseconds."},
+        {"max_usec",
+         DataType::BIGINT,
+         "Longest execution time in microseconds."},
+        {"max_time", DataType::TIME, "When the longest execution finished."},
+    };
+  }
+
+  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+    return std::string("info event_loop --json\n");
+  }
+};
+
+}}}} // namespace facebook::logdevice::ldquery::tables
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "../Context.h"
+#include "AdminCommandTable.h"
+
+namespace facebook {
+  namespace logdevice {
+    namespace ldquery {
+      namespace tables {
+
+class IOTracing : public AdminCommandTable {
+ public:
+  explicit IOTracing(std::shared_ptr<Context> ctx) : AdminCommandTable(ctx) {}
+  static std::string getName() {
+    return "io_tracing";
+  }
+  std::string getDescription() override {
+    return "Latency histograms of IO operations done by RocksDB on each "
+           "storage shard, aggregated by the kind of context they were done "
+           "in. Only populated on nodes with setting "
+           "--rocksdb-io-tracing-histograms enabled. Latencies are cumulative "
+           "since the setting was enabled and are estimated from "
+           "power-of-two buckets.";
+  }
+  TableColumns getFetchableColumns() const override {
+    return {
+        {"shard", DataType::BIGINT, "Index of the shard."},
+        {"kind",
+         DataType::TEXT,
+         "What the IO was done for: \"write\" (writing records and "
+         "metadata, including appending to WAL), \"wal_sync\", \"flush\", "
+         "\"compaction\", \"iterator_seek\", \"iterator_step\" or "
+         "\"other\"."},
+        {"count", DataType::BIGINT, "Number of IO operations."},
+        {"total_usec",
+         DataType::BIGINT,
+         "Approximate total time spent in IO operations, in microseconds."},
+        {"p50_usec",
+         DataType::BIGINT,
+         "Median latency of IO operations, in microseconds."},
+        {"p99_usec",
+         DataType::BIGINT,
+         "99th percentile latency of IO operations, in microseconds."},
+        {"p999_usec",
+         DataType::BIGINT,
+         "99.9th percentile latency of IO operations, in microseconds."},
+        {"max_usec",
+         DataType::BIGINT,
+         "Maximum latency of IO operations, in microseconds."},
+    };
+  }
+  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
+    return std::string("info io_tracing --json\n");
+  }
+};
+
+}}}} // namespace facebook::logdevice::ldquery::tables
@@ -112,7 +112,21 @@ class Partitions : public AdminCommandTable {
          "Nodes that have uncommitted append data in this partition."},
         {"rebuild_dirtied_by",
          DataType::TEXT,
-         "Nodes that have uncommitted rebuild data in this partition."}};
+         "Nodes that have uncommitted rebuild data in this partition."},
+        {"compaction",
+         DataType::TEXT,
+         "\"running (<reason>)\" if the partition is being compacted, "
+         "\"pending (hi-pri)\" or \"pending (lo-pri)\" if a manual "
+         "compaction of it was requested with the \"logsdb compact\" admin "
+         "command and hasn't started yet, null otherwise."},
+        {"compaction_bytes_filtered",
+         DataType::BIGINT,
+         "If the partition is being compacted, bytes of keys and values the "
+         "compaction has gone through so far."},
+        {"compaction_rate_limit",
+         DataType::TEXT,
+         "If the partition is being compacted and the compaction was requested "
+         "with --rate-limit, that rate limit, as <bytes>/<duration>ms."}};
   }
   std::string getCommandToSend(QueryContext& ctx) const override {
     std::string expr;
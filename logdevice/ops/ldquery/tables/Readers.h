@@ -120,16 +120,44 @@ class Readers : public AdminCommandTable {
         {"sndbuf_occupancy",
          DataType::INTEGER,
          "Number of bytes in TCP sndbuf waiting to be sent"},
+        {"adaptive_batch_bytes",
+         DataType::BIGINT,
+         "Byte limit chosen for the last read batch of this stream from the "
+         "client's drain rate (see \"read-batch-target-drain-time\"). Null "
+         "if adaptive batch sizing is disabled."},
+        {"drain_rate",
+         DataType::REAL,
+         "Estimated rate, in bytes per second, at which the client drains "
+         "records of this stream. Null until measured."},
+        {"wait_state",
+         DataType::TEXT,
+         "What the stream is currently waiting for: QUEUED (in the catchup "
+         "queue), STORAGE_TASK, NETWORK_BANDWIDTH, READ_BANDWIDTH, WINDOW "
+         "(client's window exhausted), RELEASE (caught up) or NONE."},
+        {"stalled_ms",
+         DataType::BIGINT,
+         "How long the stream has gone without shipping records or gaps to "
+         "the client, excluding time spent caught up. See "
+         "\"read-stream-stall-trace-threshold\"."},
     };
   }
   std::string getCommandToSend(QueryContext& ctx) const override {
+    std::string cmd;
     logid_t logid;
+    int32_t client_idx;
     if (columnHasEqualityConstraintOnLogid(3, ctx, logid)) {
-      return std::string("info readers log ") + std::to_string(logid.val_) +
-          " --json\n";
+      cmd = std::string("info readers log ") + std::to_string(logid.val_);
+    } else if (columnHasEqualityConstraintOnClientID(2, ctx, client_idx)) {
+      cmd = std::string("info readers client ") + std::to_string(client_idx);
     } else {
-      return std::string("info readers all --json\n");
+      cmd = std::string("info readers all");
+    }
+
+    std::string shard_expr;
+    if (columnHasEqualityConstraint(1, ctx, shard_expr)) {
+      cmd += std::string(" --shard=") + shard_expr;
     }
+    return cmd + " --json\n";
   }
 };
 
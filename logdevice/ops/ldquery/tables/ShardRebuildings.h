@@ -104,6 +104,22 @@ class ShardRebuildings : public AdminCommandTable {
          DataType::REAL,
          "Approximately what fraction of the work is done, between 0 and 1. "
          "-1 if the implementation doesn't support progress estimation."},
+        {"bytes_total",
+         DataType::BIGINT,
+         "Approximate amount of data this donor needs to read, based on the "
+         "data size estimates in the partition directory. -1 if not "
+         "supported."},
+        {"bytes_remaining",
+         DataType::BIGINT,
+         "Approximate amount of data left to read. -1 if not supported."},
+        {"bytes_per_sec",
+         DataType::REAL,
+         "Average reading throughput since the first read completed, "
+         "including time spent rate limited or waiting for global window."},
+        {"eta_seconds",
+         DataType::BIGINT,
+         "Estimated time until this donor has read all the data, at the "
+         "average throughput so far. -1 if unknown."},
     };
   }
   std::string getCommandToSend(QueryContext& /*ctx*/) const override {
@@ -8,7 +8,9 @@
 
 #include "logdevice/replication_checker/LogErrorTracker.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <sstream>
 
 #include <boost/tokenizer.hpp>
@@ -156,6 +158,21 @@ LogErrorTracker::recordLevelErrorsToString(RecordLevelError errors) {
   return res.str();
 }
 
+double LogErrorTracker::errorRateUpperBound(size_t errors,
+                                            size_t samples,
+                                            double z) {
+  ld_check(errors <= samples);
+  if (samples == 0) {
+    return 1;
+  }
+  const double n = samples;
+  const double p = errors / n;
+  const double z2 = z * z;
+  const double center = p + z2 / (2 * n);
+  const double margin = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n));
+  return std::min(1.0, (center + margin) / (1 + z2 / n));
+}
+
 std::string LogErrorTracker::logLevelErrorsToString(LogLevelError errors) {
   std::stringstream res;
   bool prepend_comma{false};
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -100,6 +101,22 @@ class LogErrorTracker {
    */
   static RecordLevelError parseRecordLevelErrors(std::string errors);
 
+  /**
+   * Upper bound of the Wilson score interval for the proportion of records
+   * with errors, given that `errors` of `samples` randomly sampled records
+   * had errors.
+   *
+   * @param  errors  Number of sampled records with errors
+   * @param  samples Number of sampled records
+   * @param  z       Quantile of the normal distribution for the confidence
+   *                 level; 1.96 for 95%
+   * @return         Error rate that the actual one is below with the given
+   *                 confidence, or 1 if nothing was sampled
+   */
+  static double errorRateUpperBound(size_t errors,
+                                    size_t samples,
+                                    double z = 1.96);
+
   RecordLevelError getRecordLevelFilter() const;
   LogLevelError getLogLevelFilter() const;
 
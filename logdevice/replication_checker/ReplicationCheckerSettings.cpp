@@ -108,6 +108,18 @@ void ReplicationCheckerSettings::defineSettings(SettingEasyInit& init) {
        "Read each log from a point in time which is read-starting-point before "
        "now",
        CLIENT);
+  init("sample-records-per-log",
+       &sample_records_per_log,
+       "0",
+       nullptr,
+       "If nonzero, check only a sample of each data log: this many records "
+       "starting at a random point in time within the last "
+       "--read-starting-point (which is then required), instead of "
+       "everything from --read-starting-point ago to the tail. The summary "
+       "then includes an upper bound of the error rate at 95% confidence. "
+       "Combined with --per-log-max-bps and --logs-in-flight, this bounds the "
+       "read load of a run enough to verify replication continuously.",
+       CLIENT);
   init("max-execution-time",
        &max_execution_time,
        "240h",
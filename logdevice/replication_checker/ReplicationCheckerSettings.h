@@ -44,6 +44,7 @@ class ReplicationCheckerSettings : public SettingsBundle {
   std::chrono::seconds idle_timeout;
   std::chrono::microseconds read_duration;
   std::chrono::seconds read_starting_point;
+  size_t sample_records_per_log;
   std::chrono::microseconds max_execution_time;
   std::chrono::seconds client_timeout;
 
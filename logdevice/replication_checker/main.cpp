@@ -441,7 +441,8 @@ struct CheckStats {
           field(trimmed_bytes) field(records_above_bridge)                    \
               field(copies_on_authoritative_empty_nodes)                      \
                   field(authoritative_empty_in_copyset)                       \
-                      field(records_rebuilding_pending)
+                      field(records_rebuilding_pending)                       \
+                          field(records_with_errors)
 
 #define DECLARE_FIELD(name) size_t name = 0;
   FIELDS(DECLARE_FIELD)
@@ -650,9 +651,15 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
     // to read.
     if (checker_settings->read_starting_point.count() > 0 &&
         !MetaDataLog::isMetaDataLog(log_id_) && did_findtime_ == false) {
-      auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch() -
+      auto lookback = std::chrono::duration_cast<std::chrono::milliseconds>(
           checker_settings->read_starting_point);
+      if (checker_settings->sample_records_per_log > 0) {
+        // Start the sample at a random point of the lookback period.
+        lookback = std::chrono::milliseconds(
+            folly::Random::rand64(lookback.count() + 1));
+      }
+      auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch() - lookback);
       int rv = client_impl_.findTime(
           log_id_,
           timestamp,
@@ -1258,6 +1265,10 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
       ++stats_.records_rebuilding_pending;
     }
 
+    if ((errors & ~errors_to_ignore) != RecordLevelError::NONE) {
+      ++stats_.records_with_errors;
+    }
+
     maybeReportRecord(
         log_id_, lsn, copies, auths, errors, record_errors, samplers);
 
@@ -1265,6 +1276,13 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
         "log %lu: checked record %s", log_id_.val_, lsn_to_string(lsn).c_str());
 
     records_.erase(records_.begin());
+
+    if (checker_settings->sample_records_per_log > 0 &&
+        !MetaDataLog::isMetaDataLog(log_id_) &&
+        stats_.num_records_seen >= checker_settings->sample_records_per_log) {
+      // The sample of this log is complete.
+      finish("");
+    }
     return true;
   }
 
@@ -1930,6 +1948,12 @@ int main(int argc, const char** argv) {
     std::cerr << "--numTasks > 1 and --logs are incompatible" << std::endl;
     exit(2);
   }
+  if (checker_settings->sample_records_per_log > 0 &&
+      checker_settings->read_starting_point.count() == 0) {
+    std::cerr << "--sample-records-per-log requires --read-starting-point"
+              << std::endl;
+    exit(2);
+  }
   errors_to_ignore = checker_settings->dont_fail_on_errors;
   if (!checker_settings->enable_noisy_errors) {
     const RecordLevelError noisy_errors =
@@ -2067,6 +2091,18 @@ int main(int argc, const char** argv) {
 
   ld_info("all done");
   output(dbg::Level::INFO, "done; total stats:\n%s", st.toString("  ").c_str());
+  folly::Optional<double> error_rate_bound;
+  if (checker_settings->sample_records_per_log > 0) {
+    const CheckStats total = st.aggregate();
+    error_rate_bound = LogErrorTracker::errorRateUpperBound(
+        total.records_with_errors, total.num_records_seen);
+    output(dbg::Level::INFO,
+           "sampled %lu records, %lu with errors; the error rate is below "
+           "%.6f%% with 95%% confidence",
+           total.num_records_seen,
+           total.records_with_errors,
+           error_rate_bound.value() * 100);
+  }
   if (checker_settings->json && !checker_settings->json_continuous) {
     folly::dynamic per_log_stats = folly::dynamic::object();
     for (const auto& rq : worker_coordinators) {
@@ -2077,6 +2113,9 @@ int main(int argc, const char** argv) {
       data["per_log"] = per_log_stats;
     }
     data["summary"] = st.toDynamic();
+    if (error_rate_bound.hasValue()) {
+      data["summary"]["error_rate_upper_bound_95"] = error_rate_bound.value();
+    }
     folly::json::serialization_opts opts;
     opts.pretty_formatting = true;
     std::string json = folly::json::serialize(data, opts);
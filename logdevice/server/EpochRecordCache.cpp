@@ -268,15 +268,15 @@ int EpochRecordCache::putRecord(RecordID rid,
   // it is likely that the record will be stored in cache, pre-allocate
   // its entry
   auto entry = std::shared_ptr<EpochRecordCacheEntry>(
-      new EpochRecordCacheEntry(rid.lsn(),
-                                flags,
-                                timestamp,
-                                lng,
-                                wave_or_recovery_epoch,
-                                copyset,
-                                offsets_within_epoch,
-                                std::move(keys),
-                                payload_holder),
+      new (entry_arena_) EpochRecordCacheEntry(rid.lsn(),
+                                               flags,
+                                               timestamp,
+                                               lng,
+                                               wave_or_recovery_epoch,
+                                               copyset,
+                                               offsets_within_epoch,
+                                               std::move(keys),
+                                               payload_holder),
       EpochRecordCacheEntry::Disposer(deps_));
 
   ReleasedVector entries_to_drop;
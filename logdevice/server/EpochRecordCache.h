@@ -22,6 +22,7 @@
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/common/util.h"
+#include "logdevice/server/EpochRecordCacheEntry.h"
 #include "logdevice/server/RecordCacheDependencies.h"
 
 namespace facebook { namespace logdevice {
@@ -465,6 +466,9 @@ class EpochRecordCache {
   // NOTE: access must be protected by rw_lock_
   TailRecord tail_record_;
 
+  // slabs that entries put into buffer_ are allocated from
+  EpochRecordCacheEntry::Arena entry_arena_;
+
   // actual buffer for storing (pointers to) cache entries
   CircularBuffer<std::shared_ptr<EpochRecordCacheEntry>> buffer_;
 
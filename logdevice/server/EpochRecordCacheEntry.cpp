@@ -8,10 +8,14 @@
 #include "logdevice/server/EpochRecordCacheEntry.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstring>
+#include <new>
 
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/checks.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/stats/Stats.h"
@@ -196,6 +200,122 @@ EpochRecordCacheEntry::createFromLinearBuffer(lsn_t lsn,
   return result;
 }
 
+struct EpochRecordCacheEntry::Arena::Slab {
+  // Live entries in the slab, plus one while the arena allocates from it.
+  std::atomic<uint32_t> refs{1};
+  uint32_t capacity;
+  // Number of slots handed out so far. Only used under the arena's mutex.
+  uint32_t used{0};
+
+  explicit Slab(uint32_t cap) : capacity(cap) {}
+};
+
+namespace {
+
+constexpr size_t roundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// A slot is a pointer to its slab followed by the entry.
+constexpr size_t kSlotHeaderSize =
+    std::max(sizeof(void*), alignof(EpochRecordCacheEntry));
+constexpr size_t kSlotSize =
+    roundUp(kSlotHeaderSize + sizeof(EpochRecordCacheEntry),
+            alignof(EpochRecordCacheEntry));
+
+static_assert(alignof(EpochRecordCacheEntry) <= alignof(std::max_align_t),
+              "Slabs are allocated with ::operator new");
+
+} // namespace
+
+constexpr uint32_t EpochRecordCacheEntry::Arena::kMinSlotsPerSlab;
+constexpr uint32_t EpochRecordCacheEntry::Arena::kMaxSlotsPerSlab;
+
+size_t EpochRecordCacheEntry::Arena::slotSize() {
+  return kSlotSize;
+}
+
+EpochRecordCacheEntry::Arena::Slab*
+EpochRecordCacheEntry::Arena::allocateSlab(uint32_t capacity) {
+  constexpr size_t header_size = roundUp(sizeof(Slab), kSlotHeaderSize);
+  void* mem = ::operator new(header_size + capacity * kSlotSize);
+  return new (mem) Slab(capacity);
+}
+
+void* EpochRecordCacheEntry::Arena::allocate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_ == nullptr || current_->used == current_->capacity) {
+    if (current_ != nullptr) {
+      unref(current_);
+    }
+    current_ = allocateSlab(next_capacity_);
+    next_capacity_ = std::min(next_capacity_ * 2, kMaxSlotsPerSlab);
+  }
+  Slab* slab = current_;
+  slab->refs.fetch_add(1, std::memory_order_relaxed);
+
+  constexpr size_t header_size = roundUp(sizeof(Slab), kSlotHeaderSize);
+  char* slot =
+      reinterpret_cast<char*>(slab) + header_size + slab->used++ * kSlotSize;
+  *reinterpret_cast<Slab**>(slot) = slab;
+  return slot + kSlotHeaderSize;
+}
+
+void EpochRecordCacheEntry::Arena::release(void* p) {
+  char* slot = static_cast<char*>(p) - kSlotHeaderSize;
+  unref(*reinterpret_cast<Slab**>(slot));
+}
+
+void EpochRecordCacheEntry::Arena::unref(Slab* slab) {
+  if (slab->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    slab->~Slab();
+    ::operator delete(slab);
+  }
+}
+
+EpochRecordCacheEntry::Arena::~Arena() {
+  if (current_ != nullptr) {
+    unref(current_);
+  }
+}
+
+void* EpochRecordCacheEntry::operator new(size_t size) {
+  ld_check_eq(size, sizeof(EpochRecordCacheEntry));
+  // A slab of one slot, whose only reference is the entry's.
+  Arena::Slab* slab = Arena::allocateSlab(1);
+  constexpr size_t header_size =
+      roundUp(sizeof(Arena::Slab), kSlotHeaderSize);
+  char* slot = reinterpret_cast<char*>(slab) + header_size;
+  slab->used = 1;
+  *reinterpret_cast<Arena::Slab**>(slot) = slab;
+  return slot + kSlotHeaderSize;
+}
+
+void* EpochRecordCacheEntry::operator new(size_t size, Arena& arena) {
+  ld_check_eq(size, sizeof(EpochRecordCacheEntry));
+  return arena.allocate();
+}
+
+void EpochRecordCacheEntry::operator delete(void* p) {
+  if (p != nullptr) {
+    Arena::release(p);
+  }
+}
+
+void EpochRecordCacheEntry::operator delete(void* p, Arena& /* arena */) {
+  Arena::release(p);
+}
+
+/*static*/
+size_t EpochRecordCacheEntry::getBytesEstimate(Payload payload_raw) {
+  return kSlotSize + payload_raw.size() +
+      /* control block size estimation*/ 32;
+}
+
+size_t EpochRecordCacheEntry::getBytesEstimate() const {
+  return getBytesEstimate(payload.getPayload());
+}
+
 void EpochRecordCacheEntry::Disposer::operator()(EpochRecordCacheEntry* e) {
   std::unique_ptr<EpochRecordCacheEntry> entry_ptr(e);
   deps_->disposeOfCacheEntry(std::move(entry_ptr));
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include <folly/AtomicIntrusiveLinkedList.h>
 
@@ -31,8 +32,27 @@ class EpochRecordCacheCompare;
  */
 class EpochRecordCacheEntry : public ZeroCopiedRecord {
  public:
+  class Arena;
   class Disposer;
 
+  /**
+   * Entries are carved out of slabs, see Arena. A plain new allocates a
+   * slab of its own; new (arena) takes the next slot of the arena's current
+   * slab. Either way delete returns the slot to its slab, which is freed
+   * when its last entry is.
+   */
+  static void* operator new(size_t size);
+  static void* operator new(size_t size, Arena& arena);
+  static void operator delete(void* p);
+  static void operator delete(void* p, Arena& arena);
+
+  /**
+   * Estimate of the memory used by an entry with the given payload: its slot
+   * in a slab, the payload and the shared_ptr control block.
+   */
+  static size_t getBytesEstimate(Payload payload_raw);
+  size_t getBytesEstimate() const override;
+
   /*
    * Create and repopulate an entry from serialized representation in the
    * given buffer, and with the given disposer. Returns nullptr if the
@@ -79,6 +99,55 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
   friend class EpochRecordCacheSerializer::EpochRecordCacheCompare;
 };
 
+/**
+ * Allocates the entries of one EpochRecordCache from slabs of contiguous
+ * slots, rather than with a heap allocation each. Entries of an epoch are
+ * evicted roughly in the order they were put in, as the LNG advances, so the
+ * slots of a slab tend to be released together, and the slab is freed as
+ * soon as the last of its entries is destroyed and the arena has moved on to
+ * another slab. Entries may outlive the arena and be destroyed on any
+ * thread.
+ *
+ * Slabs start small, so that the many caches of mostly idle logs don't hold
+ * on to much unused memory, and double in size up to kMaxSlotsPerSlab.
+ *
+ * Thread-safe.
+ */
+class EpochRecordCacheEntry::Arena {
+ public:
+  static constexpr uint32_t kMinSlotsPerSlab = 4;
+  static constexpr uint32_t kMaxSlotsPerSlab = 64;
+
+  Arena() = default;
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Memory used by one entry in a slab.
+  static size_t slotSize();
+
+ private:
+  struct Slab;
+
+  void* allocate();
+
+  // Allocates a slab with `capacity` slots and one reference held by the
+  // caller.
+  static Slab* allocateSlab(uint32_t capacity);
+  // Drops a reference to the slab of the entry at `p`.
+  static void release(void* p);
+  static void unref(Slab* slab);
+
+  std::mutex mutex_;
+  // Slab entries are currently allocated from, nullptr if none yet. The
+  // arena holds a reference to it.
+  Slab* current_{nullptr};
+  uint32_t next_capacity_{kMinSlotsPerSlab};
+
+  friend class EpochRecordCacheEntry;
+};
+
 class EpochRecordCacheEntry::Disposer {
  public:
   explicit Disposer(EpochRecordCacheDependencies* deps) : deps_(deps) {}
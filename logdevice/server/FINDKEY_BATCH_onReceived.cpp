@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/FINDKEY_BATCH_onReceived.h"
+
+#include "logdevice/common/FindKeyTracer.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_REPLY_Message.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/FindKeyBatchStorageTask.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+using EntriesByShard =
+    std::unordered_map<shard_index_t,
+                       std::vector<FindKeyBatchStorageTask::Entry>>;
+
+class FindKeyBatchHandler {
+ public:
+  explicit FindKeyBatchHandler(const Address& from) : from_(from) {}
+
+  // Answers the entry, or queues it in tasks_ for a storage thread.
+  void process(const FINDKEY_Header& header, PermissionCheckStatus perm);
+
+  void sendReplies();
+  void putTasks();
+
+ private:
+  void reply(const FINDKEY_Header& header,
+             Status status,
+             lsn_t lo,
+             lsn_t hi,
+             FindKeyTracer& tracer) {
+    tracer.trace(status, lo, hi);
+    replies_.push_back(
+        FINDKEY_REPLY_Header{header.client_rqid, status, lo, hi, header.shard});
+  }
+
+  // Same as runNonBlockingFindKey() in FINDKEY_onReceived.cpp, for
+  // findTime().
+  bool runNonBlockingFindTime(const FINDKEY_Header& header,
+                              FINDKEY_flags_t flags,
+                              lsn_t lo,
+                              lsn_t hi,
+                              FindKeyTracer& tracer);
+
+  const Address& from_;
+  std::vector<FINDKEY_REPLY_Header> replies_;
+  EntriesByShard tasks_;
+};
+
+void FindKeyBatchHandler::process(const FINDKEY_Header& header,
+                                  PermissionCheckStatus perm) {
+  ServerWorker* worker = ServerWorker::onThisThread();
+  ServerProcessor* processor = worker->processor_;
+  FindKeyTracer tracer(
+      worker->getTraceLogger(), Sender::sockaddrOrInvalid(from_), header);
+  std::chrono::milliseconds timestamp(header.timestamp);
+  tracer.setTimestamp(timestamp);
+
+  Status status = PermissionChecker::toStatus(perm);
+  if (status != E::OK) {
+    RATELIMIT_LEVEL(
+        status == E::ACCESS ? dbg::Level::WARNING : dbg::Level::INFO,
+        std::chrono::seconds(2),
+        1,
+        "FINDKEY_BATCH request from %s for log %lu failed with %s",
+        Sender::describeConnection(from_).c_str(),
+        header.log_id.val_,
+        error_description(status));
+    reply(header, status, LSN_INVALID, LSN_INVALID, tracer);
+    return;
+  }
+
+  if (header.log_id == LOGID_INVALID) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "got FINDKEY_BATCH message from %s with invalid log ID, "
+                    "ignoring the entry",
+                    Sender::describeConnection(from_).c_str());
+    tracer.trace(E::INVALID_PARAM, LSN_INVALID, LSN_INVALID);
+    return;
+  }
+
+  if (!worker->isAcceptingWork()) {
+    reply(header, E::SHUTDOWN, LSN_INVALID, LSN_INVALID, tracer);
+    return;
+  }
+
+  WORKER_LOG_STAT_INCR(header.log_id, findkey_received);
+
+  if (!processor->runningOnStorageNode()) {
+    reply(header, E::NOTSTORAGE, LSN_INVALID, LSN_INVALID, tracer);
+    return;
+  }
+
+  const auto& log_map = Worker::settings().dont_serve_findtimes_logs;
+  if (log_map.find(header.log_id) != log_map.end()) {
+    reply(header,
+          Worker::settings().dont_serve_findtimes_status,
+          LSN_INVALID,
+          LSN_INVALID,
+          tracer);
+    return;
+  }
+
+  const shard_index_t shard_idx = header.shard;
+  const shard_size_t n_shards = worker->getNodesConfiguration()->getNumShards();
+  if (shard_idx < 0 || shard_idx >= n_shards) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Got FINDKEY_BATCH message from client %s with invalid "
+                    "shard %d, this node only has %u shards",
+                    Sender::describeConnection(from_).c_str(),
+                    shard_idx,
+                    n_shards);
+    return;
+  }
+
+  if (processor->isDataMissingFromShard(shard_idx)) {
+    reply(header, E::REBUILDING, LSN_INVALID, LSN_INVALID, tracer);
+    return;
+  }
+
+  LogStorageState* log_state =
+      processor->getLogStorageStateMap().insertOrGet(header.log_id, shard_idx);
+  if (log_state == nullptr || log_state->hasPermanentError()) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    10,
+                    "Got FINDKEY_BATCH message from client %s but the "
+                    "LogStorageStateMap is at capacity or in permanent error "
+                    "for log %lu",
+                    Sender::describeConnection(from_).c_str(),
+                    header.log_id.val_);
+    reply(header, E::FAILED, LSN_INVALID, LSN_INVALID, tracer);
+    return;
+  }
+
+  const lsn_t last_per_epoch_released_lsn =
+      log_state->getLastPerEpochReleasedLSN();
+  const lsn_t trim_point = log_state->getTrimPoint();
+  if (timestamp == std::chrono::milliseconds::max()) {
+    // See FINDKEY_onReceived().
+    reply(header,
+          E::OK,
+          std::max(last_per_epoch_released_lsn, trim_point),
+          LSN_MAX,
+          tracer);
+    return;
+  }
+
+  FINDKEY_flags_t flags = header.flags;
+  if (Worker::settings().findtime_force_approximate) {
+    flags |= FINDKEY_Header::APPROXIMATE;
+    tracer.setApproximateEnforced(true);
+  }
+
+  const lsn_t lo = std::max(trim_point, header.hint_lo);
+  const lsn_t hi = std::min(last_per_epoch_released_lsn, header.hint_hi);
+  if (runNonBlockingFindTime(header, flags, lo, hi, tracer)) {
+    return;
+  }
+
+  FindKeyBatchStorageTask::Entry entry;
+  entry.client_rqid = header.client_rqid;
+  entry.log_id = header.log_id;
+  entry.target_timestamp = timestamp;
+  entry.last_released_lsn = hi;
+  entry.trim_point = lo;
+  entry.flags = flags;
+  entry.deadline = header.timeout_ms > 0
+      ? std::chrono::steady_clock::now() +
+          std::chrono::milliseconds(header.timeout_ms)
+      : std::chrono::steady_clock::time_point::max();
+  entry.tracer = std::move(tracer);
+  entry.status = E::UNKNOWN;
+  entry.result_lo = LSN_INVALID;
+  entry.result_hi = LSN_INVALID;
+  tasks_[shard_idx].push_back(std::move(entry));
+}
+
+bool FindKeyBatchHandler::runNonBlockingFindTime(const FINDKEY_Header& header,
+                                                 FINDKEY_flags_t flags,
+                                                 lsn_t lo,
+                                                 lsn_t hi,
+                                                 FindKeyTracer& tracer) {
+  LocalLogStore& store = ServerWorker::onThisThread()
+                             ->processor_->sharded_storage_thread_pool_
+                             ->getByIndex(header.shard)
+                             .getLocalLogStore();
+  if (!Worker::settings().allow_reads_on_workers ||
+      !store.supportsNonBlockingFindTime()) {
+    return false;
+  }
+
+  const bool approximate = flags & FINDKEY_Header::APPROXIMATE;
+  if (approximate) {
+    WORKER_STAT_INCR(approximate_find_key_try_non_blocking);
+  } else {
+    WORKER_STAT_INCR(strict_find_key_try_non_blocking);
+  }
+
+  int rv = store.findTime(header.log_id,
+                          std::chrono::milliseconds(header.timestamp),
+                          &lo,
+                          &hi,
+                          approximate,
+                          false /* do not allow blocking io */
+  );
+  if (rv == 0) {
+    reply(header, E::OK, lo, hi, tracer);
+    return true;
+  }
+  if (err == E::FAILED) {
+    reply(header, E::FAILED, LSN_INVALID, LSN_INVALID, tracer);
+    return true;
+  }
+  ld_check(err == E::WOULDBLOCK);
+  if (approximate) {
+    WORKER_STAT_INCR(approximate_find_key_would_block);
+  } else {
+    WORKER_STAT_INCR(strict_find_key_would_block);
+  }
+  return false;
+}
+
+void FindKeyBatchHandler::sendReplies() {
+  if (replies_.empty()) {
+    return;
+  }
+  auto msg =
+      std::make_unique<FINDKEY_BATCH_REPLY_Message>(std::move(replies_));
+  if (Worker::onThisThread()->sender().sendMessage(std::move(msg), from_) !=
+      0) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Failed to send FINDKEY_BATCH_REPLY to %s: %s",
+                   Sender::describeConnection(from_).c_str(),
+                   error_description(err));
+  }
+}
+
+void FindKeyBatchHandler::putTasks() {
+  ServerWorker* worker = ServerWorker::onThisThread();
+  for (auto& kv : tasks_) {
+    WORKER_STAT_INCR(findkey_batch_storage_tasks);
+    worker->getStorageTaskQueueForShard(kv.first)->putTask(
+        std::make_unique<FindKeyBatchStorageTask>(
+            from_.id_.client_,
+            std::move(kv.second),
+            worker->sender().getSockaddr(from_)));
+  }
+}
+
+} // namespace
+
+Message::Disposition FINDKEY_BATCH_onReceived(
+    FINDKEY_BATCH_Message* msg,
+    const Address& from,
+    const std::unordered_map<logid_t, PermissionCheckStatus, logid_t::Hash>&
+        permission_statuses) {
+  if (!from.isClientAddress()) {
+    ld_error("got FINDKEY_BATCH message from non-client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  WORKER_STAT_INCR(findkey_batches_received);
+
+  FindKeyBatchHandler handler(from);
+  for (const FINDKEY_Header& header : msg->headers_) {
+    auto it = permission_statuses.find(header.log_id);
+    handler.process(header,
+                    it != permission_statuses.end()
+                        ? it->second
+                        : PermissionCheckStatus::NONE);
+  }
+  handler.sendReplies();
+  handler.putTasks();
+  return Message::Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
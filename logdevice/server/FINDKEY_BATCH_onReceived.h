@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+
+#include "logdevice/common/PermissionChecker.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_Message.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+struct Address;
+
+/**
+ * Handles every entry of the batch as FINDKEY_onReceived() would handle a
+ * FINDKEY message with the same header. Entries that can be answered right
+ * away get their replies in one FINDKEY_BATCH_REPLY; the others are looked
+ * up by one FindKeyBatchStorageTask per shard.
+ *
+ * @param permission_statuses  outcome of the permission check of each log of
+ *                             the batch; logs that weren't checked are
+ *                             missing.
+ */
+Message::Disposition FINDKEY_BATCH_onReceived(
+    FINDKEY_BATCH_Message* msg,
+    const Address& from,
+    const std::unordered_map<logid_t, PermissionCheckStatus, logid_t::Hash>&
+        permission_statuses);
+
+}} // namespace facebook::logdevice
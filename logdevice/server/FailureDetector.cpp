@@ -8,6 +8,7 @@
 
 #include "logdevice/server/FailureDetector.h"
 
+#include <map>
 #include <unordered_set>
 
 #include <folly/Memory.h>
@@ -115,6 +116,91 @@ class FailureDetector::RoundRobinSelector
   size_t iters_{0};
 };
 
+class FailureDetector::HierarchicalSelector
+    : public FailureDetector::NodeSelector {
+ public:
+  NodeID getNode(FailureDetector* detector) override {
+    const auto& nodes_configuration = detector->getNodesConfiguration();
+    const auto& serv_disc = nodes_configuration->getServiceDiscovery();
+    const NodeLocationScope scope = detector->settings_->gossip_hierarchy_scope;
+    const node_index_t my_idx = detector->getMyNodeID().index();
+
+    // Group the nodes by location domain at `scope'. Within each domain, the
+    // alive node with the lowest index gossips on behalf of the domain.
+    // Every node computes the same choice from its own view of the cluster
+    // state, so no coordination is needed; if views differ for a while,
+    // a domain just has more than one such node.
+    std::string my_domain;
+    std::map<std::string, std::vector<node_index_t>> domains;
+    for (const auto& it : *serv_disc) {
+      const node_index_t idx = it.first;
+      std::string domain = it.second.location.has_value()
+          ? it.second.location->getDomain(scope)
+          : "N" + std::to_string(idx);
+      if (idx == my_idx) {
+        my_domain = domain;
+      }
+      domains[std::move(domain)].push_back(idx);
+    }
+
+    auto& local = domains[my_domain];
+    node_index_t local_aggregator = my_idx;
+    for (node_index_t idx : local) {
+      if (idx == my_idx || detector->getClusterState()->isNodeAlive(idx)) {
+        local_aggregator = std::min(local_aggregator, idx);
+      }
+    }
+
+    std::vector<node_index_t> candidates;
+    for (node_index_t idx : local) {
+      if (idx != my_idx && detector->isValidDestination(idx)) {
+        candidates.push_back(idx);
+      }
+    }
+
+    const int32_t cross_scope_interval =
+        detector->settings_->gossip_hierarchy_cross_scope_interval;
+    const bool cross_scope = candidates.empty() ||
+        (local_aggregator == my_idx && ++rounds_ % cross_scope_interval == 0);
+    if (cross_scope) {
+      // Gossip to the node gossiping for a random other domain. If no node
+      // in that domain is alive, any of them will do.
+      candidates.clear();
+      std::vector<const std::vector<node_index_t>*> remote;
+      for (const auto& kv : domains) {
+        if (kv.first != my_domain) {
+          remote.push_back(&kv.second);
+        }
+      }
+      if (!remote.empty()) {
+        const auto& nodes = *remote[folly::Random::rand32(remote.size())];
+        for (node_index_t idx : nodes) {
+          if (detector->isValidDestination(idx)) {
+            candidates.push_back(idx);
+            if (detector->getClusterState()->isNodeAlive(idx)) {
+              candidates = {idx};
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    if (candidates.empty()) {
+      return fallback_.getNode(detector);
+    }
+    return nodes_configuration->getNodeID(
+        candidates[folly::Random::rand32(candidates.size())]);
+  }
+
+ private:
+  // Used when no node in the chosen domain can be sent to
+  RandomSelector fallback_;
+
+  // number of calls to getNode() that may have gone to another domain
+  uint64_t rounds_{0};
+};
+
 FailureDetector::FailureDetector(UpdateableSettings<GossipSettings> settings,
                                  ServerProcessor* processor,
                                  StatsHolder* stats)
@@ -128,6 +214,9 @@ FailureDetector::FailureDetector(UpdateableSettings<GossipSettings> settings,
     case GossipSettings::SelectionMode::ROUND_ROBIN:
       selector_.reset(new RoundRobinSelector());
       break;
+    case GossipSettings::SelectionMode::HIERARCHICAL:
+      selector_.reset(new HierarchicalSelector());
+      break;
     default:
       ld_error("Invalid gossip mode(%d)", (int)settings_->mode);
       ld_check(false);
@@ -441,6 +530,7 @@ void FailureDetector::gossip() {
       }
     }
     last_gossip_tick_time_ = now;
+    ++gossip_ticks_;
   }
 
   // stayin' alive
@@ -547,6 +637,28 @@ void FailureDetector::gossip() {
     }
   }
 
+  // bump the message sequence number
+  ++current_msg_id_;
+
+  // Decide whether to send the state of all nodes or only the entries that
+  // changed since the previous message to dest. Versions are sent for all
+  // nodes, so messages carrying them are always full.
+  const bool has_versions = flags & GOSSIP_Message::HAS_IN_MEM_VERSIONS ||
+      flags & GOSSIP_Message::HAS_DURABLE_SNAPSHOT_VERSIONS;
+  auto dest_node_it = nodes_.find(dest.index());
+  const std::chrono::milliseconds dest_instance_id =
+      dest_node_it != nodes_.end() ? dest_node_it->second.gossip_ts_
+                                   : std::chrono::milliseconds::zero();
+  auto peer_it = gossip_peers_.find(dest.index());
+  const bool full_state = has_versions ||
+      settings_->gossip_full_state_interval <= 1 ||
+      peer_it == gossip_peers_.end() ||
+      peer_it->second.instance_id_ != dest_instance_id ||
+      peer_it->second.msgs_since_full_state_ + 1 >=
+          settings_->gossip_full_state_interval;
+  const uint64_t peer_last_msg_id =
+      full_state ? 0 : peer_it->second.last_msg_id_;
+
   for (auto serv_it = serv_disc->begin(); serv_it != serv_disc->end();
        ++serv_it) {
     if (nodes_.find(serv_it->first) == nodes_.end()) {
@@ -568,6 +680,27 @@ void FailureDetector::gossip() {
     gnode.failover_ = fdnode.failover_;
     gnode.is_node_starting_ = fdnode.is_node_starting_;
     gnode.node_status_ = fdnode.status_;
+
+    // Recipients bump gossip_ of the entries they know once per tick too, so
+    // an entry that only aged doesn't tell them anything new.
+    const GOSSIP_Node& prev = fdnode.last_gossiped_entry_;
+    const uint64_t aged_gossip = std::min<uint64_t>(
+        std::numeric_limits<uint32_t>::max(),
+        uint64_t(prev.gossip_) + (gossip_ticks_ - fdnode.last_gossiped_tick_));
+    if (fdnode.changed_msg_id_ == 0 || gnode.gossip_ < aged_gossip ||
+        gnode.gossip_ts_ != prev.gossip_ts_ ||
+        gnode.failover_ != prev.failover_ ||
+        gnode.is_node_starting_ != prev.is_node_starting_ ||
+        gnode.node_status_ != prev.node_status_) {
+      fdnode.changed_msg_id_ = current_msg_id_;
+    }
+    fdnode.last_gossiped_entry_ = gnode;
+    fdnode.last_gossiped_tick_ = gossip_ticks_;
+    // The recipient needs our own entry to know our health status.
+    if (serv_it->first != this_node.index() &&
+        fdnode.changed_msg_id_ <= peer_last_msg_id) {
+      continue;
+    }
     gossip_node_list.push_back(gnode);
 
     if (flags & GOSSIP_Message::HAS_IN_MEM_VERSIONS ||
@@ -591,22 +724,32 @@ void FailureDetector::gossip() {
   skip_sending_versions_ = (skip_sending_versions_ + 1) %
       (settings_->gossip_include_rsm_versions_frequency);
 
-  // bump the message sequence number
-  ++current_msg_id_;
-  int rv = sendGossipMessage(
-      dest,
-      std::make_unique<GOSSIP_Message>(this_node,
-                                       std::move(gossip_node_list),
-                                       instance_id_,
-                                       getCurrentTimeInMillis(),
-                                       std::move(boycotts),
-                                       std::move(boycott_durations),
-                                       flags,
-                                       current_msg_id_,
-                                       registered_rsms_,
-                                       std::move(versions_list)));
+  auto& peer = gossip_peers_[dest.index()];
+  peer.instance_id_ = dest_instance_id;
+  peer.last_msg_id_ = current_msg_id_;
+  if (full_state) {
+    peer.msgs_since_full_state_ = 0;
+  } else {
+    ++peer.msgs_since_full_state_;
+    STAT_INCR(getStats(), gossips_delta_sent);
+  }
+
+  auto msg = std::make_unique<GOSSIP_Message>(this_node,
+                                              std::move(gossip_node_list),
+                                              instance_id_,
+                                              getCurrentTimeInMillis(),
+                                              std::move(boycotts),
+                                              std::move(boycott_durations),
+                                              flags,
+                                              current_msg_id_,
+                                              registered_rsms_,
+                                              std::move(versions_list));
+  msg->compact_encoding_ = settings_->gossip_compact_encoding;
+  int rv = sendGossipMessage(dest, std::move(msg));
 
   if (rv != 0) {
+    // The next message to dest will carry the full state.
+    gossip_peers_.erase(dest.index());
     RATELIMIT_DEBUG(std::chrono::seconds(1),
                     10,
                     "Failed to send GOSSIP to node %s: %s",
@@ -1464,6 +1607,9 @@ void FailureDetector::onGossipMessageSent(Status st,
     if (isAlive(nidx)) {
       STAT_INCR(getStats(), gossips_failed_to_send_to_alive_nodes);
     }
+    // The recipient may have missed some changes, send it the full state
+    // next time.
+    gossip_peers_.erase(nidx);
   }
 
   if (current_msg_id_ != msg_id || msg_id == 0) {
@@ -288,6 +288,7 @@ class FailureDetector {
   class InitRequest;
   class RandomSelector;
   class RoundRobinSelector;
+  class HierarchicalSelector;
 
   struct Node {
     // All fields of Node are assigned with locked mutex_, almost always from
@@ -333,6 +334,16 @@ class FailureDetector {
     // - storage_membership_version
     std::array<membership::MembershipVersion::Type, 3> ncm_versions_;
 
+    // The entry of this node in the last GOSSIP message built and the number
+    // of gossip ticks at the time, to tell real changes from aging of gossip_.
+    // Only accessed on the gossip thread.
+    GOSSIP_Node last_gossiped_entry_{};
+    uint64_t last_gossiped_tick_{0};
+    // Id of the last GOSSIP message in which the entry changed other than by
+    // aging. Entries that haven't changed since the last message to a node
+    // are left out of delta messages to it.
+    uint64_t changed_msg_id_{0};
+
     Node()
         : state_(NodeState::DEAD),
           blacklisted_(false),
@@ -422,6 +433,21 @@ class FailureDetector {
   // keep track of the time of the last gossip tick, which is when
   // the tick counters in Node::gossip_ were last updated
   SteadyTimestamp last_gossip_tick_time_{SteadyTimestamp::min()};
+  // number of gossip ticks so far
+  uint64_t gossip_ticks_{0};
+
+  // What we last gossiped to a node. Recipients age the entries in their
+  // gossip list on their own, so an entry that only aged since the previous
+  // message to the same node doesn't need to be sent again. See
+  // gossip-full-state-interval. Only accessed on the gossip thread.
+  struct GossipPeer {
+    // instance id of the recipient when the previous message was sent
+    std::chrono::milliseconds instance_id_;
+    uint64_t last_msg_id_;
+    // messages sent since the last one with the state of all nodes
+    int32_t msgs_since_full_state_;
+  };
+  std::unordered_map<node_index_t, GossipPeer> gossip_peers_;
 
   // save pointer to the timer so we can explicitly trigger it to force retries
   ExponentialBackoffTimerNode* gossip_timer_node_{nullptr};
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/FindKeyBatchStorageTask.h"
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/FINDKEY_BATCH_REPLY_Message.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+FindKeyBatchStorageTask::FindKeyBatchStorageTask(ClientID reply_to,
+                                                 std::vector<Entry> entries,
+                                                 Sockaddr client_address)
+    : StorageTask(StorageTask::Type::FINDKEY_BATCH),
+      entries_(std::move(entries)),
+      reply_to_(reply_to),
+      client_address_(client_address) {}
+
+void FindKeyBatchStorageTask::execute() {
+  LocalLogStore& store = storageThreadPool_->getLocalLogStore();
+  executeImpl(store, storageThreadPool_->stats());
+}
+
+void FindKeyBatchStorageTask::executeImpl(const LocalLogStore& store,
+                                          StatsHolder* stats) {
+  for (Entry& entry : entries_) {
+    entry.result_lo = LSN_INVALID;
+    entry.result_hi = LSN_INVALID;
+    if (std::chrono::steady_clock::now() >= entry.deadline) {
+      entry.status = E::TIMEDOUT;
+      STAT_INCR(stats, findkey_timedout_before_run);
+      continue;
+    }
+
+    lsn_t lo = entry.trim_point;
+    lsn_t hi = entry.last_released_lsn;
+    int rv = store.findTime(entry.log_id,
+                            entry.target_timestamp,
+                            &lo,
+                            &hi,
+                            entry.flags & FINDKEY_Header::APPROXIMATE);
+    if (rv == 0) {
+      entry.status = E::OK;
+      entry.result_lo = lo;
+      entry.result_hi = hi;
+    } else if (err == E::TIMEDOUT) {
+      entry.status = E::TIMEDOUT;
+      STAT_INCR(stats, findkey_timedout_during_run);
+    } else {
+      entry.status = E::FAILED;
+    }
+  }
+}
+
+void FindKeyBatchStorageTask::onDone() {
+  sendReply();
+}
+
+void FindKeyBatchStorageTask::onDropped() {
+  for (Entry& entry : entries_) {
+    entry.status = E::FAILED;
+  }
+  sendReply();
+}
+
+void FindKeyBatchStorageTask::sendReply() {
+  shard_index_t shard = storageThreadPool_->getShardIdx();
+  std::vector<FINDKEY_REPLY_Header> headers;
+  headers.reserve(entries_.size());
+  for (Entry& entry : entries_) {
+    FINDKEY_REPLY_Header header = {
+        entry.client_rqid,
+        entry.status,
+        entry.status == E::OK ? entry.result_lo : LSN_INVALID,
+        entry.status == E::OK ? entry.result_hi : LSN_INVALID,
+        shard};
+    entry.tracer.trace(header.status, header.result_lo, header.result_hi);
+    headers.push_back(header);
+  }
+  Worker::onThisThread()->sender().sendMessage(
+      std::make_unique<FINDKEY_BATCH_REPLY_Message>(std::move(headers)),
+      reply_to_);
+}
+
+void FindKeyBatchStorageTask::getDebugInfoDetailed(
+    StorageTaskDebugInfo& info) const {
+  info.client_id = reply_to_;
+  info.client_address = client_address_;
+  info.extra_info = folly::sformat(
+      "client: {}, logs: {}, target timestamp: {}",
+      reply_to_.toString(),
+      entries_.size(),
+      entries_.empty() ? std::string("none")
+                       : format_time(entries_[0].target_timestamp));
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "logdevice/common/ClientID.h"
+#include "logdevice/common/FindKeyTracer.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/protocol/FINDKEY_Message.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Runs findTime() for all the entries of a FINDKEY_BATCH message that
+ * go to the same shard, one after the other on the same storage thread, and
+ * replies to all of them with one FINDKEY_BATCH_REPLY message. Each entry is
+ * looked up exactly as FindKeyStorageTask would have done it; the batch
+ * saves the per-task queueing and messaging overhead, and lets consecutive
+ * lookups for the same timestamp hit the partitions the previous ones
+ * brought into the cache.
+ */
+
+class FindKeyBatchStorageTask : public StorageTask {
+ public:
+  struct Entry {
+    request_id_t client_rqid;
+    logid_t log_id;
+    std::chrono::milliseconds target_timestamp;
+    lsn_t last_released_lsn;
+    lsn_t trim_point;
+    FINDKEY_flags_t flags;
+    // deadline after which the lookup is presumed to have timed out
+    std::chrono::steady_clock::time_point deadline;
+    FindKeyTracer tracer;
+
+    // The result
+    Status status; // OK, TIMEDOUT or FAILED
+    lsn_t result_lo;
+    lsn_t result_hi;
+  };
+
+  FindKeyBatchStorageTask(ClientID reply_to,
+                          std::vector<Entry> entries,
+                          Sockaddr client_address = Sockaddr());
+
+  void execute() override;
+  void onDone() override;
+  void onDropped() override;
+
+  ThreadType getThreadType() const override {
+    return ThreadType::SLOW;
+  }
+
+  StorageTaskPriority getPriority() const override {
+    // Same as FindKeyStorageTask.
+    return StorageTaskPriority::VERY_HIGH;
+  }
+
+  Principal getPrincipal() const override {
+    return Principal::FINDKEY;
+  }
+
+  // Workhorse of execute(), LocalLogStore passed from above for testability
+  void executeImpl(const LocalLogStore& store, StatsHolder* stats = nullptr);
+
+  // Public for tests
+  std::vector<Entry> entries_;
+
+ private:
+  const ClientID reply_to_;
+
+  // used for debugging
+  Sockaddr client_address_;
+
+  void sendReply();
+
+  void getDebugInfoDetailed(StorageTaskDebugInfo&) const override;
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/HandOffMessageRequest.h"
+
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+int logWorker(logid_t log_id, int nthreads) {
+  return folly::hash::twang_mix64(log_id.val_) % nthreads;
+}
+} // namespace
+
+bool HandOffMessageRequest::handOff(Message* msg,
+                                    const Address& from,
+                                    Handler handler) {
+  Worker* worker = Worker::onThisThread();
+  logid_t log_id = msg->getLogID();
+  if (log_id == LOGID_INVALID || !from.isClientAddress() ||
+      worker->worker_type_ != WorkerType::GENERAL) {
+    return false;
+  }
+  const int nworkers =
+      worker->processor_->getWorkerCount(WorkerType::GENERAL);
+  if (nworkers <= 1 || logWorker(log_id, nworkers) == worker->idx_.val_) {
+    return false;
+  }
+
+  std::unique_ptr<Request> rq = std::make_unique<HandOffMessageRequest>(
+      std::unique_ptr<Message>(msg), from, worker->idx_, handler);
+  if (worker->processor_->postImportant(rq) != 0) {
+    // Only fails when shutting down. Take the message back and let this
+    // Worker deal with it.
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      1,
+                      "Failed to hand off a %s message from %s: %s",
+                      messageTypeNames()[msg->type_].c_str(),
+                      Sender::describeConnection(from).c_str(),
+                      error_name(err));
+    static_cast<HandOffMessageRequest*>(rq.get())->msg_.release();
+    return false;
+  }
+  WORKER_STAT_INCR(messages_handed_off);
+  return true;
+}
+
+HandOffMessageRequest::HandOffMessageRequest(std::unique_ptr<Message> msg,
+                                             const Address& from,
+                                             worker_id_t from_worker,
+                                             Handler handler)
+    : Request(RequestType::HANDOFF_MESSAGE),
+      msg_(std::move(msg)),
+      from_(from),
+      from_worker_(from_worker),
+      handler_(handler) {}
+
+int HandOffMessageRequest::getThreadAffinity(int nthreads) {
+  return logWorker(msg_->getLogID(), nthreads);
+}
+
+Request::Execution HandOffMessageRequest::execute() {
+  Message::Disposition disp = handler_(msg_.get(), from_);
+  switch (disp) {
+    case Message::Disposition::NORMAL:
+      break;
+    case Message::Disposition::KEEP:
+      msg_.release();
+      break;
+    case Message::Disposition::ERROR: {
+      // The connection belongs to another Worker. Have it close the
+      // connection, as Connection would have if the message had been
+      // processed there.
+      Status reason = err;
+      ClientID client = from_.id_.client_;
+      std::unique_ptr<Request> close_rq = FuncRequest::make(
+          from_worker_,
+          WorkerType::GENERAL,
+          RequestType::HANDOFF_MESSAGE,
+          [client, reason] {
+            Worker::onThisThread()->sender().closeClientSocket(client, reason);
+          });
+      Worker::onThisThread()->processor_->postImportant(close_rq);
+      break;
+    }
+  }
+  return Execution::COMPLETE;
+}
+
+}} // namespace facebook::logdevice
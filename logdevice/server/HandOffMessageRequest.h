@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include "logdevice/common/Address.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/protocol/Message.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file HandOffMessageRequest moves the processing of a received message from
+ * the Worker that read it off the connection to the GENERAL Worker that owns
+ * the message's log, i.e. twang_mix64(log_id) % nworkers, the same mapping
+ * log-bound Requests use for getThreadAffinity().
+ *
+ * The connection stays on the Worker that accepted it, which keeps doing the
+ * socket I/O and message parsing. The state machines for a log all run on one
+ * Worker, so a slow handler for one log no longer delays messages for other
+ * logs that happen to share its connection, and the messages of a log stay in
+ * the order they arrived in. Replies are expected to find their way back to
+ * the connection's Worker on their own (as STORED does, see
+ * SendSTOREDRequest). If the handler rejects the message with
+ * Disposition::ERROR, the connection is closed on the Worker that owns it,
+ * as it would have been without the hand-off.
+ *
+ * Enabled for STORE messages by --handoff-stores-by-log.
+ */
+
+class HandOffMessageRequest : public Request {
+ public:
+  using Handler = Message::Disposition (*)(Message* msg, const Address& from);
+
+  /**
+   * If `msg`'s log is owned by another Worker, posts a HandOffMessageRequest
+   * that calls `handler` on that Worker.
+   *
+   * @return true if the message was handed off, in which case the request
+   *         took ownership of `msg`. false if `msg` should be processed on
+   *         this Worker: it's for this Worker's log, it's not about a log, or
+   *         the request couldn't be posted.
+   */
+  static bool handOff(Message* msg, const Address& from, Handler handler);
+
+  HandOffMessageRequest(std::unique_ptr<Message> msg,
+                        const Address& from,
+                        worker_id_t from_worker,
+                        Handler handler);
+
+  Execution execute() override;
+
+  int getThreadAffinity(int nthreads) override;
+
+  int8_t getExecutorPriority() const override {
+    return msg_->getExecutorPriority();
+  }
+
+  RunContext getRunContext() const override {
+    return RunContext(msg_->type_);
+  }
+
+ private:
+  std::unique_ptr<Message> msg_;
+  const Address from_;
+  // Worker the connection `from_` is assigned to.
+  const worker_id_t from_worker_;
+  const Handler handler_;
+};
+
+}} // namespace facebook::logdevice
@@ -51,6 +51,11 @@ class LastCleanEpochZRQ : public ZookeeperEpochStoreRequest {
         cf_lce_, worker_idx_, worker_type_, st, logid_, epoch_, tail_record_));
   }
 
+  // see ZookeeperEpochStoreRequest.h
+  bool isZnodeValueCacheable() const override {
+    return true;
+  }
+
   static constexpr const char* znodeNameDataLog = "lce";
   static constexpr const char* znodeNameMetaDataLog = "metadatalog_lce";
 
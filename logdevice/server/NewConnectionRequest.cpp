@@ -23,8 +23,16 @@ Request::Execution NewConnectionRequest::execute() {
     conntype_ = ConnectionType::SSL;
   }
 
-  int rv = w->sender().addClient(
-      fd_, client_addr_, std::move(conn_token_), sock_type_, conntype_);
+  // The backlog token is held until the client's HELLO is received, so that
+  // the connection backlog also bounds the TLS and protocol handshakes in
+  // progress, which are what overwhelms a node when many clients reconnect
+  // at once.
+  int rv = w->sender().addClient(fd_,
+                                 client_addr_,
+                                 std::move(conn_token_),
+                                 sock_type_,
+                                 conntype_,
+                                 std::move(conn_backlog_token_));
 
   if (rv == 0) {
     ld_debug("A new connection from %s is running on "
@@ -1338,7 +1338,6 @@ void RebuildingCoordinator::onRetrievedPlanForLog(
   auto& shard_state = getShardState(shard_idx);
   ld_check(version == shard_state.version);
   ld_check(shard_state.waitingForMorePlans);
-  ld_check(shard_state.shardRebuilding == nullptr);
   ld_check(!shard_state.logsWithPlan.count(log));
 
   if (!is_authoritative && shard_state.isAuthoritative &&
@@ -1352,6 +1351,67 @@ void RebuildingCoordinator::onRetrievedPlanForLog(
   ld_check(!log_plan->epochsToRead.empty());
 
   shard_state.logsWithPlan.emplace(log, std::move(log_plan));
+
+  const size_t batch_logs = rebuildingSettings_->planning_batch_logs;
+  if (batch_logs > 0 && shard_state.logsWithPlan.size() >= batch_logs) {
+    startRebuildingPlannedLogs(shard_idx);
+  }
+}
+
+size_t RebuildingCoordinator::removePlannedLogsNotInConfig(
+    ShardState& shard_state) {
+  auto config = config_->get();
+  size_t total_epoch_ranges = 0;
+  for (auto it = shard_state.logsWithPlan.begin();
+       it != shard_state.logsWithPlan.end();) {
+    if (!config->getLogGroupByIDShared(it->first)) {
+      it = shard_state.logsWithPlan.erase(it);
+    } else {
+      total_epoch_ranges +=
+          boost::icl::interval_count(it->second->epochsToRead);
+      ++it;
+    }
+  }
+  return total_epoch_ranges;
+}
+
+void RebuildingCoordinator::startRebuildingPlannedLogs(uint32_t shard_idx) {
+  auto& shard_state = getShardState(shard_idx);
+  ld_check(shard_state.waitingForMorePlans);
+  const size_t total_epoch_ranges = removePlannedLogsNotInConfig(shard_state);
+  if (shard_state.logsWithPlan.empty()) {
+    return;
+  }
+  auto plan = std::move(shard_state.logsWithPlan);
+  shard_state.logsWithPlan.clear();
+
+  if (shard_state.shardRebuilding != nullptr) {
+    ld_debug("Adding %lu planned logs (%lu epoch ranges) to rebuilding of "
+             "shard %u",
+             plan.size(),
+             total_epoch_ranges,
+             shard_idx);
+    shard_state.shardRebuilding->addLogs(std::move(plan), /* last */ false);
+    return;
+  }
+
+  ld_info("Got rebuilding plan for the first %lu logs (%lu epoch ranges) of "
+          "shard %u. Starting rebuilding while planning continues. "
+          "Rebuilding set: %s",
+          plan.size(),
+          total_epoch_ranges,
+          shard_idx,
+          shard_state.rebuildingSet->describe().c_str());
+  shard_state.shardRebuilding =
+      createShardRebuilding(shard_idx,
+                            shard_state.version,
+                            shard_state.restartVersion,
+                            shard_state.rebuildingSet,
+                            rebuildingSettings_);
+  shard_state.shardRebuilding->advanceGlobalWindow(
+      shard_state.globalWindowEnd);
+  shard_state.shardRebuilding->expectMoreLogs();
+  shard_state.shardRebuilding->start(std::move(plan));
 }
 
 void RebuildingCoordinator::onLogsEnumerated(
@@ -1387,25 +1447,26 @@ void RebuildingCoordinator::onFinishedRetrievingPlans(uint32_t shard_idx,
           lsn_to_string(version).c_str());
 
   // Remove logs that are not in config anymore.
-  auto config = config_->get();
-  size_t total_epoch_ranges = 0;
-  for (auto it = shard_state.logsWithPlan.begin();
-       it != shard_state.logsWithPlan.end();) {
-    if (!config->getLogGroupByIDShared(it->first)) {
-      it = shard_state.logsWithPlan.erase(it);
-    } else {
-      total_epoch_ranges +=
-          boost::icl::interval_count(it->second->epochsToRead);
-      ++it;
-    }
-  }
+  const size_t total_epoch_ranges = removePlannedLogsNotInConfig(shard_state);
 
   double planning_seconds =
       std::chrono::duration_cast<std::chrono::duration<double>>(
           SteadyTimestamp::now() - shard_state.planningStartTime)
           .count();
 
-  if (shard_state.logsWithPlan.empty()) {
+  if (shard_state.shardRebuilding != nullptr) {
+    // Rebuilding was started with the logs planned so far; hand it the rest.
+    ld_info("Finished planning rebuilding of shard %u in %.3fs. Adding the "
+            "last %lu logs (%lu epoch ranges).",
+            shard_idx,
+            planning_seconds,
+            shard_state.logsWithPlan.size(),
+            total_epoch_ranges);
+    auto plan = std::move(shard_state.logsWithPlan);
+    shard_state.logsWithPlan.clear();
+    // May complete the rebuilding and destroy the ShardRebuilding.
+    shard_state.shardRebuilding->addLogs(std::move(plan), /* last */ true);
+  } else if (shard_state.logsWithPlan.empty()) {
     ld_info(
         "Got empty rebuild plan for shard %u in %.3fs with rebuilding set: %s",
         shard_idx,
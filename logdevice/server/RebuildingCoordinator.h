@@ -739,6 +739,21 @@ class RebuildingCoordinator : public RebuildingPlanner::Listener,
   ShardState& getShardState(uint32_t shard_idx);
   const ShardState& getShardState(uint32_t shard_idx) const;
 
+  /**
+   * Hands the logs planned so far to the shard's ShardRebuilding, creating
+   * it if needed. Used when rebuilding-planning-batch-logs is positive, so
+   * that re-replication doesn't wait for all logs to be planned.
+   */
+  void startRebuildingPlannedLogs(uint32_t shard);
+
+  /**
+   * Removes logs that are not in config anymore from
+   * shard_state.logsWithPlan.
+   *
+   * @return  total number of epoch ranges in the remaining plans.
+   */
+  size_t removePlannedLogsNotInConfig(ShardState& shard_state);
+
   // A helper method to write a thrift:;RemoveMaintenanceRequest to
   // maintenance log
   void writeRemoveMaintenance(ShardID shard, const std::string& reason_message);
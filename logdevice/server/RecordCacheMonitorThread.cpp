@@ -7,11 +7,15 @@
  */
 #include "logdevice/server/RecordCacheMonitorThread.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <functional>
 #include <queue>
 #include <vector>
 
+#include <unistd.h>
+
 #include "logdevice/common/ThreadID.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
@@ -20,6 +24,26 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// @return  resident set size of this process in bytes, 0 if unknown
+size_t getProcessRSS() {
+  FILE* fp = std::fopen("/proc/self/statm", "r");
+  if (fp == nullptr) {
+    return 0;
+  }
+  unsigned long size_pages = 0;
+  unsigned long resident_pages = 0;
+  int rv = std::fscanf(fp, "%lu %lu", &size_pages, &resident_pages);
+  std::fclose(fp);
+  if (rv != 2) {
+    return 0;
+  }
+  return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+} // namespace
+
 RecordCacheMonitorThread::RecordCacheMonitorThread(ServerProcessor* processor)
     : processor_(processor) {
   ld_check(processor != nullptr);
@@ -62,7 +86,7 @@ void RecordCacheMonitorThread::threadMain() {
 
 std::pair<bool, size_t> RecordCacheMonitorThread::recordCacheNeedsEviction() {
   const size_t size_limit = processor_->settings()->record_cache_max_size;
-  if (size_limit == 0) {
+  if (size_limit == 0 && processor_->settings()->record_cache_rss_limit == 0) {
     // ulimited, no eviction required
     return std::make_pair(false, 0);
   }
@@ -96,11 +120,36 @@ std::pair<bool, size_t> RecordCacheMonitorThread::recordCacheNeedsEviction() {
     total_cache_size += stats.record_cache_bytes_cached_estimate;
   });
 
-  if (total_cache_size > 0 && total_cache_size > (int64_t)size_limit) {
+  size_t target_bytes = 0;
+  if (size_limit > 0 && total_cache_size > (int64_t)size_limit) {
     // beside the bytes exceed the limit, evict another 20% of the max
     // cache size to prevent frequent eviction
-    return std::make_pair(
-        true, (size_t)total_cache_size - size_limit + size_limit / 5);
+    target_bytes = (size_t)total_cache_size - size_limit + size_limit / 5;
+  }
+
+  // Under memory pressure, shed the excess RSS from the cache, with the same
+  // 20% headroom.
+  const size_t rss_limit = processor_->settings()->record_cache_rss_limit;
+  if (rss_limit > 0 && total_cache_size > 0) {
+    const size_t rss = getProcessRSS();
+    if (rss > rss_limit) {
+      const size_t rss_target = std::min(
+          rss - rss_limit + rss_limit / 5, (size_t)total_cache_size);
+      if (rss_target > target_bytes) {
+        RATELIMIT_INFO(std::chrono::seconds(10),
+                       1,
+                       "Process RSS of %lu bytes exceeds the limit of %lu "
+                       "bytes, evicting from the record cache.",
+                       rss,
+                       rss_limit);
+        STAT_INCR(holder, record_cache_eviction_rss_triggered);
+        target_bytes = rss_target;
+      }
+    }
+  }
+
+  if (target_bytes > 0) {
+    return std::make_pair(true, target_bytes);
   }
 
   ld_debug("Total record cache size is %ld not greater than the limit %lu "
@@ -122,20 +171,28 @@ struct LogEntry {
   }
 };
 
-} // namespace
+using MinQueue = std::
+    priority_queue<LogEntry, std::vector<LogEntry>, std::greater<LogEntry>>;
 
-void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
-  ld_check(target_bytes > 0);
-  using MinQueue = std::
-      priority_queue<LogEntry, std::vector<LogEntry>, std::greater<LogEntry>>;
+// A log is active if its records may be needed soon: some worker has read
+// streams for it, or it is being recovered.
+bool isActiveLog(const LogStorageState& state) {
+  return state.hasSubscribedWorkers() || state.isRecoveryPending();
+}
 
+// Picks the largest logs among active or inactive ones (depending on
+// `active`) so that the total size of the picked logs just reaches
+// `target_bytes`, or all of them if they are not enough. Sets
+// *bytes_in_queue to the total size of the picked logs.
+MinQueue selectLogsToEvict(LogStorageStateMap& log_map,
+                           size_t target_bytes,
+                           bool active,
+                           size_t* bytes_in_queue) {
   MinQueue min_queue;
-  // number of bytes for logs in the min_queue
-  size_t bytes_in_queue = 0;
+  *bytes_in_queue = 0;
 
-  auto access_log = [target_bytes, &bytes_in_queue, &min_queue](
-                        logid_t logid, const LogStorageState& state) {
-    if (state.record_cache_ == nullptr) {
+  auto access_log = [&](logid_t logid, const LogStorageState& state) {
+    if (state.record_cache_ == nullptr || isActiveLog(state) != active) {
       return 0;
     }
     const size_t log_size = state.record_cache_->getPayloadSizeEstimate();
@@ -144,36 +201,30 @@ void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
     }
 
     min_queue.push(LogEntry{logid, state.getShardIdx(), log_size});
-    bytes_in_queue += log_size;
+    *bytes_in_queue += log_size;
 
     // pop the queue until 1) it is empty or
     // 2) bytes_in_queue - queue.top() < target_bytes
-    while (!min_queue.empty() && bytes_in_queue > target_bytes) {
+    while (!min_queue.empty() && *bytes_in_queue > target_bytes) {
       const auto& entry = min_queue.top();
-      ld_check(bytes_in_queue >= entry.cache_size);
-      if (bytes_in_queue - entry.cache_size < target_bytes) {
+      ld_check(*bytes_in_queue >= entry.cache_size);
+      if (*bytes_in_queue - entry.cache_size < target_bytes) {
         break;
       }
-      bytes_in_queue -= entry.cache_size;
+      *bytes_in_queue -= entry.cache_size;
       min_queue.pop();
     }
 
     return 0;
   };
 
-  auto& log_map = processor_->getLogStorageStateMap();
   log_map.forEachLog(access_log);
+  return min_queue;
+}
 
-  if (min_queue.empty()) {
-    RATELIMIT_INFO(std::chrono::seconds(10),
-                   1,
-                   "Can't find a log to evict, nothing to do.");
-    return;
-  }
-
+// @return  number of logs evicted
+size_t evictLogs(LogStorageStateMap& log_map, MinQueue& min_queue) {
   size_t num_logs_evicted = 0;
-
-  // evict all logs in queue
   while (!min_queue.empty()) {
     const LogEntry& e = min_queue.top();
     auto& record_cache_ptr = log_map.get(e.log_id, e.shard).record_cache_;
@@ -183,19 +234,56 @@ void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
     min_queue.pop();
     ++num_logs_evicted;
   }
+  return num_logs_evicted;
+}
+
+} // namespace
+
+void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
+  ld_check(target_bytes > 0);
+  auto& log_map = processor_->getLogStorageStateMap();
+
+  // Evicting the cache of a log that is being read or recovered hurts right
+  // away, so first evict only logs that are neither. Only if that is not
+  // enough, also evict active logs, still largest first.
+  size_t idle_bytes = 0;
+  MinQueue idle_queue =
+      selectLogsToEvict(log_map, target_bytes, /*active=*/false, &idle_bytes);
+  size_t active_bytes = 0;
+  MinQueue active_queue;
+  if (idle_bytes < target_bytes) {
+    active_queue = selectLogsToEvict(
+        log_map, target_bytes - idle_bytes, /*active=*/true, &active_bytes);
+  }
+
+  if (idle_queue.empty() && active_queue.empty()) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Can't find a log to evict, nothing to do.");
+    return;
+  }
+
+  const size_t num_idle_evicted = evictLogs(log_map, idle_queue);
+  const size_t num_active_evicted = evictLogs(log_map, active_queue);
+  const size_t bytes_evicted = idle_bytes + active_bytes;
 
   STAT_INCR(processor_->stats_, record_cache_eviction_performed_by_monitor);
   STAT_ADD(processor_->stats_,
            record_cache_bytes_evicted_by_monitor,
-           bytes_in_queue);
+           bytes_evicted);
+  STAT_ADD(processor_->stats_,
+           record_cache_active_logs_evicted_by_monitor,
+           num_active_evicted);
 
   RATELIMIT_INFO(
       std::chrono::seconds(10),
       1,
-      "Evicted %lu logs from the record cache, estimate actual total "
-      "bytes evicted: %lu, bytes evicted target: %lu",
-      num_logs_evicted,
-      bytes_in_queue,
+      "Evicted %lu logs (%lu of them with readers or recovery in progress) "
+      "from the record cache, estimate actual total bytes evicted: %lu, bytes "
+      "evicted target: %lu",
+      num_idle_evicted + num_active_evicted,
+      num_active_evicted,
+      bytes_evicted,
       target_bytes);
 }
 
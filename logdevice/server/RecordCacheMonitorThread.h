@@ -27,6 +27,11 @@ class ServerProcessor;
  *         epochs currently cached. This could help to leave more logs in the
  *         cache, achieving better availability in terms of logs and less seeks
  *         durng epoch recovery.
+ *
+ *         Logs that have active read streams or an unfinished recovery are
+ *         only evicted if evicting all other logs is not enough. Eviction is
+ *         also triggered if the process RSS exceeds
+ *         Settings::record_cache_rss_limit.
  */
 
 class RecordCacheMonitorThread {
@@ -46,8 +51,8 @@ class RecordCacheMonitorThread {
   // mainLoop of the thread
   void threadMain();
 
-  // Check if the total size of all record caches exceeds the limit and
-  // eviction is needed.
+  // Check if the total size of all record caches exceeds the limit, or the
+  // process is over its RSS limit, and eviction is needed.
   //
   // @return  a pair of <eviction_needed, bytes_target>, where:
   //          eviction_needed is a boolean value indicating whether eviction
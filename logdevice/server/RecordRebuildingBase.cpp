@@ -67,6 +67,11 @@ const Settings& RecordRebuildingBase::getSettings() const {
   return Worker::settings();
 }
 
+std::shared_ptr<const NodesConfiguration>
+RecordRebuildingBase::getNodesConfiguration() const {
+  return Worker::onThisThread()->getNodesConfiguration();
+}
+
 void RecordRebuildingBase::activateRetryTimer() {
   if (!retryTimer_.isAssigned()) {
     const auto& retry_timeout = owner_->getRebuildingSettings()->retry_timeout;
@@ -392,6 +392,8 @@ class RecordRebuildingBase : public RecordRebuildingInterface {
   virtual node_index_t getMyNodeIndex() const;
   virtual bool isStorageShardInConfig(ShardID shard) const;
   virtual const Settings& getSettings() const;
+  virtual std::shared_ptr<const NodesConfiguration>
+  getNodesConfiguration() const;
   virtual void activateRetryTimer();
   virtual void resetRetryTimer();
   virtual void activateStoreTimer();
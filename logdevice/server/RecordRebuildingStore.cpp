@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/RecordRebuildingStore.h"
 
+#include <algorithm>
+
 #include <folly/Random.h>
 
 #include "logdevice/common/CopySetSelector.h"
@@ -61,7 +63,8 @@ int RecordRebuildingStore::parseRecord() {
 
   Slice record_slice(reinterpret_cast<const void*>(recordOrPayload_.data()),
                      recordOrPayload_.length());
-  bool verify_checksum = getSettings().verify_checksum_before_replicating;
+  bool verify_checksum = getSettings().verify_checksum_before_replicating &&
+      !skipChecksumVerification_;
 
   if (verify_checksum) {
     rv = LocalLogStoreRecordFormat::checkWellFormed(record_slice);
@@ -375,6 +378,78 @@ int RecordRebuildingStore::pickCopyset() {
   return 0;
 }
 
+void RecordRebuildingStore::addLocalRecipients(RNG& rng) {
+  // Trying more candidates than this per scope isn't worth the extra calls to
+  // augment(): if a few random local nodes don't fit, others likely won't
+  // either.
+  static constexpr size_t kMaxCandidatesPerScope = 3;
+
+  const NodeLocationScope max_scope =
+      getSettings().rebuilding_local_recipients_scope;
+  if (max_scope <= NodeLocationScope::NODE ||
+      max_scope >= NodeLocationScope::ROOT) {
+    return;
+  }
+
+  auto nodes_configuration = getNodesConfiguration();
+  const auto* my_sd =
+      nodes_configuration->getNodeServiceDiscovery(getMyNodeIndex());
+  if (my_sd == nullptr || !my_sd->location.has_value()) {
+    return;
+  }
+  const NodeLocation& my_location = my_sd->location.value();
+
+  const auto replication_factor =
+      replication_->epoch_metadata.replication.getReplicationFactor();
+  const auto writable_shards =
+      nodes_configuration->getStorageMembership()->writerView(
+          replication_->epoch_metadata.shards);
+  const NodeSetState& nodeset_state = *replication_->nodeset_state;
+
+  for (NodeLocationScope scope = NodeLocationScope::RACK;
+       scope <= max_scope && newCopyset_.size() < replication_factor;
+       scope = NodeLocation::nextGreaterScope(scope)) {
+    std::vector<ShardID> candidates;
+    for (ShardID shard : writable_shards) {
+      if (std::find(newCopyset_.begin(), newCopyset_.end(), shard) !=
+              newCopyset_.end() ||
+          !nodeset_state.consideredAvailable(
+              nodeset_state.getNotAvailableReason(shard))) {
+        continue;
+      }
+      const auto* sd =
+          nodes_configuration->getNodeServiceDiscovery(shard.node());
+      if (sd != nullptr && sd->location.has_value() &&
+          sd->location->sharesScopeWith(my_location, scope)) {
+        candidates.push_back(shard);
+      }
+    }
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+
+    size_t tried = 0;
+    for (ShardID candidate : candidates) {
+      if (tried++ == kMaxCandidatesPerScope ||
+          newCopyset_.size() >= replication_factor) {
+        break;
+      }
+      // Only keep the candidate if the copyset can still be completed to
+      // satisfy the replication property.
+      copyset_t trial(newCopyset_.begin(), newCopyset_.end());
+      trial.push_back(candidate);
+      const size_t trial_existing = trial.size();
+      trial.resize(trial_existing + replication_factor);
+      copyset_size_t full_size;
+      auto rv = replication_->copysetSelector->augment(
+          trial.data(), trial_existing, &full_size, rng);
+      if (rv == CopySetSelector::Result::SUCCESS &&
+          full_size == replication_factor) {
+        newCopyset_.push_back(candidate);
+        WORKER_STAT_INCR(rebuilding_local_recipients_picked);
+      }
+    }
+  }
+}
+
 int RecordRebuildingStore::pickCopysetImpl() {
   // Seed the RNG with the hash of the old copyset for deterministic copyset
   // selection to preserve sticky copyset blocks
@@ -384,6 +459,8 @@ int RecordRebuildingStore::pickCopysetImpl() {
   XorShift128PRNG rng;
   rng.seed(rng_seed);
 
+  addLocalRecipients(rng);
+
   size_t existing_copies = newCopyset_.size();
   auto replication_factor =
       replication_->epoch_metadata.replication.getReplicationFactor();
@@ -49,6 +49,12 @@ class RecordRebuildingStore : public RecordRebuildingBase {
 
   void start(bool read_only = false) override;
 
+  // Called before start() if the checksum of the record has already been
+  // verified, e.g. by RebuildingReadStorageTask.
+  void skipChecksumVerification() {
+    skipChecksumVerification_ = true;
+  }
+
   size_t getRecordSize() const;
 
   // RecordRebuildingAmendState contains all information necessary to start
@@ -60,6 +66,7 @@ class RecordRebuildingStore : public RecordRebuildingBase {
 
   copyset_size_t replicationFactor_;
   size_t blockID_;
+  bool skipChecksumVerification_ = false;
 
   // Before parseRecord(): raw record, to be parsed using
   // LocalLogStoreRecordFormat::parse().
@@ -84,6 +91,10 @@ class RecordRebuildingStore : public RecordRebuildingBase {
   // Populates newCopyset_ with recipients from existingCopyset_ that we want to
   // keep.
   void buildNewCopysetBase();
+  // Appends to newCopyset_ recipients that share the donor's location at the
+  // smallest scopes up to rebuilding-local-recipients-scope, as long as the
+  // copyset selector can still complete the copyset with them.
+  void addLocalRecipients(RNG& rng);
   void sendCurrentStage(bool resend_inflight_stores = false);
   void nextStage();
   // Start a new wave. If immediate==true, start it immediately. Otherwise,
@@ -15,7 +15,6 @@
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 #include "logdevice/server/storage/SealStorageTask.h"
-#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
 namespace facebook { namespace logdevice {
@@ -135,7 +134,7 @@ Message::Disposition SEAL_onReceived(SEAL_Message* msg, const Address& from) {
 
   auto task = std::make_unique<SealStorageTask>(
       header.log_id, header.last_clean_epoch, seal, from, tail_optimized);
-  worker->getStorageTaskQueueForShard(shard_idx)->putTask(std::move(task));
+  worker->putSealStorageTask(std::move(task), shard_idx);
 
   return Message::Disposition::NORMAL;
 }
@@ -326,7 +326,9 @@ Message::Disposition START_onReceived(START_Message* msg,
                                              header.read_stream_id,
                                              from.id_.client_,
                                              header.start_lsn,
-                                             std::move(epoch_snapshot));
+                                             std::move(epoch_snapshot),
+                                             header.flags &
+                                                 START_Header::NO_PAYLOAD);
           if (status != E::OK) {
             return send_error_reply(msg, from, status);
           }
@@ -441,6 +443,7 @@ Message::Disposition START_onReceived(START_Message* msg,
   stream->no_payload_ = header.flags & START_Header::NO_PAYLOAD;
   stream->csi_data_only_ = header.flags & START_Header::CSI_DATA_ONLY;
   stream->payload_hash_only_ = header.flags & START_Header::PAYLOAD_HASH_ONLY;
+  stream->e2e_trace_id_ = msg->e2e_trace_id_;
   stream->include_byte_offset_ =
       (header.flags & START_Header::INCLUDE_BYTE_OFFSET) &&
       Worker::settings().byte_offsets;
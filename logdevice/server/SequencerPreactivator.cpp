@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/SequencerPreactivator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+
+#include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/Sequencer.h"
+#include "logdevice/common/SequencerLocator.h"
+#include "logdevice/common/ThreadID.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/ServerProcessor.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr std::chrono::seconds SequencerPreactivator::HISTORY_SAVE_INTERVAL;
+
+SequencerPreactivator::SequencerPreactivator(ServerProcessor* processor,
+                                             std::string history_path)
+    : processor_(processor), history_path_(std::move(history_path)) {
+  ld_check(processor != nullptr);
+  ld_check(!history_path_.empty());
+  thread_ = std::thread([this] { threadMain(); });
+}
+
+SequencerPreactivator::~SequencerPreactivator() {
+  shutdown_.signal();
+  thread_.join();
+  writeHistory();
+}
+
+void SequencerPreactivator::threadMain() {
+  ThreadID::set(ThreadID::Type::UTILITY, "ld:seq-preact");
+
+  std::vector<logid_t> logs = readHistory();
+  if (!logs.empty() && waitForLogsConfig()) {
+    ld_info("Pre-activating sequencers for %zu logs that had appends before "
+            "the restart",
+            logs.size());
+    preactivate(logs);
+  }
+
+  while (!shutdown_.waitFor(HISTORY_SAVE_INTERVAL)) {
+    writeHistory();
+  }
+}
+
+bool SequencerPreactivator::waitForLogsConfig() {
+  while (!shutdown_.signaled()) {
+    auto logs_config = processor_->config_->getLogsConfig();
+    if (logs_config && logs_config->isFullyLoaded()) {
+      return true;
+    }
+    shutdown_.waitFor(
+        processor_->settings()->sequencer_preactivation_batch_interval);
+  }
+  return false;
+}
+
+void SequencerPreactivator::preactivate(const std::vector<logid_t>& logs) {
+  size_t batch_idx = 0;
+  auto it = logs.begin();
+  while (it != logs.end() && !shutdown_.signaled()) {
+    const auto& settings = processor_->settings();
+    const size_t batch_size = std::max<size_t>(
+        settings->sequencer_preactivation_batch_size, 1);
+    auto end = it + std::min<size_t>(batch_size, logs.end() - it);
+    preactivateBatch(std::vector<logid_t>(it, end), batch_idx++);
+    it = end;
+    shutdown_.waitFor(settings->sequencer_preactivation_batch_interval);
+  }
+}
+
+void SequencerPreactivator::preactivateBatch(std::vector<logid_t> batch,
+                                             size_t batch_idx) {
+  // Spread the batches, and the activations they start, over the workers.
+  const int nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+  ld_check(nworkers > 0);
+  run_on_worker_nonblocking(
+      processor_,
+      worker_id_t(batch_idx % nworkers),
+      WorkerType::GENERAL,
+      RequestType::SEQUENCER_PREACTIVATION,
+      [batch = std::move(batch)] {
+        Worker* w = Worker::onThisThread();
+        if (!w->isAcceptingWork()) {
+          return;
+        }
+        auto cb = [](Status st, logid_t log_id, NodeID node) {
+          Processor* processor = Worker::onThisThread()->processor_;
+          if (st != E::OK || node != processor->getMyNodeID()) {
+            // The log has no sequencer node, or it's not us.
+            return;
+          }
+          int rv = processor->allSequencers().activateSequencerIfNotActive(
+              log_id, "pre-activation");
+          if (rv == 0) {
+            WORKER_STAT_INCR(sequencer_preactivations);
+          } else if (err != E::EXISTS && err != E::INPROGRESS) {
+            RATELIMIT_INFO(std::chrono::seconds(10),
+                           5,
+                           "Failed to pre-activate sequencer for log %lu: %s",
+                           log_id.val_,
+                           error_name(err));
+          }
+        };
+        for (logid_t log_id : batch) {
+          w->processor_->sequencer_locator_->locateSequencer(log_id, cb);
+        }
+      },
+      /* with_retrying */ true);
+}
+
+std::vector<logid_t> SequencerPreactivator::readHistory() const {
+  std::string data;
+  if (!folly::readFile(history_path_.c_str(), data)) {
+    if (errno != ENOENT) {
+      ld_warning("Failed to read sequencer pre-activation history %s: %s",
+                 history_path_.c_str(),
+                 folly::errnoStr(errno).c_str());
+    }
+    return {};
+  }
+
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', data, lines, /* ignoreEmpty */ true);
+  std::vector<logid_t> logs;
+  logs.reserve(lines.size());
+  for (folly::StringPiece line : lines) {
+    auto log_id = folly::tryTo<logid_t::raw_type>(line);
+    if (!log_id.hasValue() || log_id.value() == LOGID_INVALID.val_) {
+      ld_warning("Ignoring invalid log id \"%s\" in sequencer pre-activation "
+                 "history %s",
+                 line.str().c_str(),
+                 history_path_.c_str());
+      continue;
+    }
+    logs.push_back(logid_t(log_id.value()));
+  }
+  return logs;
+}
+
+void SequencerPreactivator::writeHistory() const {
+  const std::chrono::milliseconds window =
+      processor_->settings()->sequencer_preactivation_window;
+
+  std::vector<std::pair<std::chrono::milliseconds, logid_t>> recent;
+  for (const auto& seq : processor_->allSequencers().accessAll()) {
+    if (seq.getState() != Sequencer::State::ACTIVE) {
+      continue;
+    }
+    auto since_last_append = seq.getTimeSinceLastAppend();
+    if (since_last_append <= window) {
+      recent.emplace_back(since_last_append, seq.getLogID());
+    }
+  }
+  // Most recently appended logs first, so that they are activated first.
+  std::sort(recent.begin(), recent.end());
+
+  std::string data;
+  for (const auto& entry : recent) {
+    data += folly::to<std::string>(entry.second.val_) + '\n';
+  }
+  int rv = folly::writeFileAtomicNoThrow(history_path_, data, 0644);
+  if (rv != 0) {
+    RATELIMIT_WARNING(std::chrono::minutes(10),
+                      1,
+                      "Failed to write sequencer pre-activation history %s: "
+                      "%s",
+                      history_path_.c_str(),
+                      folly::errnoStr(rv).c_str());
+  }
+}
+
+}} // namespace facebook::logdevice
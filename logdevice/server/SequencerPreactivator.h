@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logdevice/common/SingleEvent.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+class ServerProcessor;
+
+/**
+ * @file  A thread that brings up sequencers ahead of the first append after a
+ *        restart. With lazy sequencer placement, a sequencer is only activated
+ *        by the first append that reaches its node, and that append waits for
+ *        the epoch store round trips and for recovery.
+ *
+ *        While the node runs, the thread periodically writes the logs whose
+ *        sequencers on this node took appends within
+ *        Settings::sequencer_preactivation_window to a local file, most
+ *        recently appended first. When the node starts, once the logs config
+ *        is fully loaded, it reads the file back and activates the sequencers
+ *        of these logs, at most Settings::sequencer_preactivation_batch_size
+ *        of them every Settings::sequencer_preactivation_batch_interval.
+ *        A log is only activated if the SequencerLocator picks this node for
+ *        it, so that sequencers that moved elsewhere are not preempted.
+ */
+
+class SequencerPreactivator {
+ public:
+  // How often the list of recently appended logs is written.
+  static constexpr std::chrono::seconds HISTORY_SAVE_INTERVAL{60};
+
+  SequencerPreactivator(ServerProcessor* processor, std::string history_path);
+
+  // Writes the history one last time before stopping the thread.
+  ~SequencerPreactivator();
+
+ private:
+  ServerProcessor* const processor_;
+  const std::string history_path_;
+
+  // for controlling thread shut down
+  SingleEvent shutdown_;
+
+  // main thread handle
+  std::thread thread_;
+
+  void threadMain();
+
+  // Blocks until the logs config is fully loaded or the thread is stopped.
+  // @return  false if the thread was stopped.
+  bool waitForLogsConfig();
+
+  // Activates sequencers for the given logs in rate-limited batches.
+  void preactivate(const std::vector<logid_t>& logs);
+
+  // Posts a request that asks the SequencerLocator about each log of the
+  // batch and activates the sequencers that belong to this node.
+  void preactivateBatch(std::vector<logid_t> batch, size_t batch_idx);
+
+  // @return  logs listed in the history file, empty if it can't be read.
+  std::vector<logid_t> readHistory() const;
+
+  // Replaces the history file with the logs that recently had appends.
+  void writeHistory() const;
+};
+
+}} // namespace facebook::logdevice
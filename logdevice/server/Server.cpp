@@ -7,10 +7,13 @@
  */
 #include "logdevice/server/Server.h"
 
+#include <chrono>
+
 #include <folly/io/async/EventBaseThread.h>
 
 #include "logdevice/admin/SimpleAdminServer.h"
 #include "logdevice/admin/maintenance/ClusterMaintenanceStateMachine.h"
+#include "logdevice/common/CPUAffinity.h"
 #include "logdevice/common/ConfigInit.h"
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/CopySetManager.h"
@@ -47,6 +50,7 @@
 #include "logdevice/server/FailureDetector.h"
 #include "logdevice/server/IOFaultInjection.h"
 #include "logdevice/server/LazySequencerPlacement.h"
+#include "logdevice/server/SequencerPreactivator.h"
 #include "logdevice/server/LogStoreMonitor.h"
 #include "logdevice/server/MyNodeIDFinder.h"
 #include "logdevice/server/NodeRegistrationHandler.h"
@@ -652,9 +656,10 @@ Server::Server(ServerParameters* params)
         initStorageThreadPool() && initProcessor() && initFailureDetector() &&
         startWorkers() && initNCM() && repopulateRecordCaches() &&
         initSequencers() && initSequencerPlacement() &&
-        initRebuildingCoordinator() && initClusterMaintenanceStateMachine() &&
-        initLogStoreMonitor() && initUnreleasedRecordDetector() &&
-        initLogsConfigManager() && initAdminServer())) {
+        initSequencerPreactivator() && initRebuildingCoordinator() &&
+        initClusterMaintenanceStateMachine() && initLogStoreMonitor() &&
+        initUnreleasedRecordDetector() && initLogsConfigManager() &&
+        initAdminServer())) {
     _exit(EXIT_FAILURE);
   }
 }
@@ -942,6 +947,27 @@ bool Server::initStorageThreadPool() {
   // Size the storage thread pool task queue to never fill up.
   size_t task_queue_size =
       local_settings->num_workers * local_settings->max_inflight_storage_tasks;
+  // Run each shard's storage threads on the NUMA node its disk is attached
+  // to, if we can tell.
+  std::vector<int> shard_numa_nodes;
+  if (server_settings_->storage_thread_numa_affinity &&
+      getNumaNodeCount() > 1) {
+    for (shard_index_t shard_idx = 0; shard_idx < sharded_store_->numShards();
+         ++shard_idx) {
+      dev_t dev = sharded_store_->getShardDevice(shard_idx);
+      int node = dev != 0 ? getNumaNodeOfDevice(dev) : -1;
+      if (node >= 0) {
+        ld_info("Pinning storage threads of shard %d to NUMA node %d",
+                (int)shard_idx,
+                node);
+      } else {
+        ld_warning("Couldn't find the NUMA node of shard %d's disk. Its "
+                   "storage threads won't be pinned.",
+                   (int)shard_idx);
+      }
+      shard_numa_nodes.push_back(node);
+    }
+  }
   sharded_storage_thread_pool_.reset(
       new ShardedStorageThreadPool(sharded_store_.get(),
                                    server_settings_->storage_pool_params,
@@ -949,7 +975,8 @@ bool Server::initStorageThreadPool() {
                                    params_->getProcessorSettings(),
                                    task_queue_size,
                                    params_->getStats(),
-                                   params_->getTraceLogger()));
+                                   params_->getTraceLogger(),
+                                   shard_numa_nodes));
   return true;
 }
 
@@ -1062,6 +1089,7 @@ bool Server::initLogStorageStateMap() {
         [shard, &make_traverser, &sharded_store = sharded_store_]() {
           ThreadID::set(ThreadID::UTILITY,
                         folly::sformat("ld:populateLogState{}", shard));
+          auto start_time = std::chrono::steady_clock::now();
           auto store = sharded_store->getByIndex(shard);
           auto trim_point_traverser = make_traverser(
               shard,
@@ -1117,6 +1145,11 @@ bool Server::initLogStorageStateMap() {
             ld_critical("Failed to disable shard %d.", shard);
             return false;
           }
+          ld_info("Populated log storage state from shard %d in %.3fs",
+                  shard,
+                  std::chrono::duration_cast<std::chrono::duration<double>>(
+                      std::chrono::steady_clock::now() - start_time)
+                      .count());
           return true;
         }));
   }
@@ -1357,6 +1390,19 @@ bool Server::initSequencerPlacement() {
   return true;
 }
 
+bool Server::initSequencerPreactivator() {
+  // With static placement all sequencers are already active.
+  if (params_->isSequencingEnabled() &&
+      server_settings_->sequencer == SequencerOptions::LAZY &&
+      !processor_->settings()->sequencer_preactivation_history_path.empty()) {
+    sequencer_preactivator_ = std::make_unique<SequencerPreactivator>(
+        processor_.get(),
+        processor_->settings()->sequencer_preactivation_history_path);
+  }
+
+  return true;
+}
+
 bool Server::initRebuildingCoordinator() {
   std::shared_ptr<Configuration> config = processor_->config_->get();
 
@@ -1660,6 +1706,7 @@ void Server::gracefulShutdown() {
                   ssl_connection_listener_loop_,
                   server_to_server_listener_loop_,
                   logstore_monitor_,
+                  sequencer_preactivator_,
                   processor_,
                   sharded_storage_thread_pool_,
                   sharded_store_,
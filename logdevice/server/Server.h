@@ -40,6 +40,7 @@ class Processor;
 class RebuildingCoordinator;
 class RebuildingSupervisor;
 class SequencerPlacement;
+class SequencerPreactivator;
 class ServerProcessor;
 class SettingsUpdater;
 class ShardedRocksDBLocalLogStore;
@@ -307,6 +308,10 @@ class Server {
   // initSequencerPlacement()
   UpdateableSharedPtr<SequencerPlacement> sequencer_placement_;
 
+  // initSequencerPreactivator()
+  // only populated if sequencer-preactivation-history-path is set.
+  std::unique_ptr<SequencerPreactivator> sequencer_preactivator_;
+
   // initRebuildingCoordinator()
   // only populated if this node is a storage node.
   std::unique_ptr<RebuildingCoordinator> rebuilding_coordinator_;
@@ -350,6 +355,7 @@ class Server {
   bool initSequencers();
   bool initLogStoreMonitor();
   bool initSequencerPlacement();
+  bool initSequencerPreactivator();
   bool initRebuildingCoordinator();
   bool initClusterMaintenanceStateMachine();
   bool createAndAttachMaintenanceManager(AdminServer* server);
@@ -23,6 +23,7 @@
 #include "logdevice/server/DATA_SIZE_onReceived.h"
 #include "logdevice/server/DELETE_LOG_METADATA_onReceived.h"
 #include "logdevice/server/DELETE_onReceived.h"
+#include "logdevice/server/FINDKEY_BATCH_onReceived.h"
 #include "logdevice/server/FINDKEY_onReceived.h"
 #include "logdevice/server/GAP_onSent.h"
 #include "logdevice/server/GET_EPOCH_RECOVERY_METADATA_REPLY_onReceived.h"
@@ -32,6 +33,7 @@
 #include "logdevice/server/GET_TRIM_POINT_onReceived.h"
 #include "logdevice/server/GOSSIP_onReceived.h"
 #include "logdevice/server/GOSSIP_onSent.h"
+#include "logdevice/server/HandOffMessageRequest.h"
 #include "logdevice/server/LOGS_CONFIG_API_onReceived.h"
 #include "logdevice/server/MEMTABLE_FLUSHED_onReceived.h"
 #include "logdevice/server/RECORD_onSent.h"
@@ -44,6 +46,7 @@
 #include "logdevice/server/ServerMessagePermission.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/StoreStateMachine.h"
+#include "logdevice/server/TRIM_BATCH_onReceived.h"
 #include "logdevice/server/TRIM_onReceived.h"
 #include "logdevice/server/read_path/AllServerReadStreams.h"
 #include "logdevice/server/sequencer_boycotting/NODE_STATS_AGGREGATE_REPLY_onReceived.h"
@@ -55,10 +58,50 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+Message::Disposition STORE_onReceived(Message* msg, const Address& from) {
+  return StoreStateMachine::onReceived(
+      checked_downcast<STORE_Message*>(msg), from);
+}
+} // namespace
+
 Message::Disposition
 ServerMessageDispatch::onReceivedImpl(Message* msg,
                                       const Address& from,
                                       const PrincipalIdentity& principal) {
+  if (msg->type_ == MessageType::FINDKEY_BATCH) {
+    auto batch = checked_downcast<FINDKEY_BATCH_Message*>(msg);
+    std::vector<logid_t> log_ids;
+    for (const FINDKEY_Header& header : batch->headers_) {
+      log_ids.push_back(header.log_id);
+    }
+    return onBatchReceived(msg,
+                           principal,
+                           MessageType::FINDKEY,
+                           ACTION::READ,
+                           log_ids,
+                           [batch, from](const PermissionStatusMap& statuses) {
+                             return FINDKEY_BATCH_onReceived(
+                                 batch, from, statuses);
+                           });
+  }
+  if (msg->type_ == MessageType::TRIM_BATCH) {
+    auto batch = checked_downcast<TRIM_BATCH_Message*>(msg);
+    std::vector<logid_t> log_ids;
+    for (const TRIM_Header& header : batch->headers_) {
+      log_ids.push_back(header.log_id);
+    }
+    return onBatchReceived(msg,
+                           principal,
+                           MessageType::TRIM,
+                           ACTION::TRIM,
+                           log_ids,
+                           [batch, from](const PermissionStatusMap& statuses) {
+                             return TRIM_BATCH_onReceived(
+                                 batch, from, statuses);
+                           });
+  }
+
   auto params = ServerMessagePermission::computePermissionParams(msg);
 
   std::shared_ptr<PermissionChecker> permission_checker =
@@ -105,6 +148,65 @@ ServerMessageDispatch::onReceivedImpl(Message* msg,
   }
 }
 
+Message::Disposition ServerMessageDispatch::onBatchReceived(
+    Message* msg,
+    const PrincipalIdentity& principal,
+    MessageType single_type,
+    ACTION action,
+    const std::vector<logid_t>& log_ids,
+    std::function<Message::Disposition(const PermissionStatusMap&)> handler) {
+  // Every entry needs the permission a message of single_type for its log
+  // would need.
+  std::shared_ptr<PermissionChecker> permission_checker =
+      processor_->security_info_->get()->permission_checker;
+  if (!permission_checker ||
+      processor_->settings()->require_permission_message_types.count(
+          single_type) == 0) {
+    STAT_INCR(processor_->stats_, server_message_dispatch_skip_permission);
+    return handler(PermissionStatusMap());
+  }
+
+  STAT_INCR(processor_->stats_, server_message_dispatch_check_permission);
+  struct State {
+    PermissionStatusMap statuses;
+    size_t pending;
+  };
+  auto state = std::make_shared<State>();
+  for (logid_t log_id : log_ids) {
+    state->statuses.emplace(log_id, PermissionCheckStatus::NONE);
+  }
+  // Guards against the callbacks below being called synchronously, before
+  // all checks have been started.
+  state->pending = state->statuses.size() + 1;
+
+  auto on_checked = [msg, state, handler = std::move(handler)]() {
+    if (--state->pending > 0) {
+      return;
+    }
+    Message::Disposition disp = handler(state->statuses);
+    if (disp != Message::Disposition::KEEP) {
+      delete msg;
+    }
+  };
+
+  std::vector<logid_t> distinct_log_ids;
+  for (const auto& kv : state->statuses) {
+    distinct_log_ids.push_back(kv.first);
+  }
+  for (logid_t log_id : distinct_log_ids) {
+    permission_checker->isAllowed(
+        action,
+        principal,
+        log_id,
+        [state, log_id, on_checked](PermissionCheckStatus status) {
+          state->statuses[log_id] = status;
+          on_checked();
+        });
+  }
+  on_checked();
+  return Message::Disposition::KEEP;
+}
+
 Message::Disposition ServerMessageDispatch::onReceivedHandler(
     Message* msg,
     const Address& from,
@@ -194,8 +296,11 @@ Message::Disposition ServerMessageDispatch::onReceivedHandler(
       return STOP_onReceived(checked_downcast<STOP_Message*>(msg), from);
 
     case MessageType::STORE:
-      return StoreStateMachine::onReceived(
-          checked_downcast<STORE_Message*>(msg), from);
+      if (processor_->settings()->handoff_stores_by_log &&
+          HandOffMessageRequest::handOff(msg, from, STORE_onReceived)) {
+        return Message::Disposition::KEEP;
+      }
+      return STORE_onReceived(msg, from);
 
     case MessageType::STORED:
       return STORED_onReceived(checked_downcast<STORED_Message*>(msg), from);
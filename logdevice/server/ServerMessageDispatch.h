@@ -7,6 +7,10 @@
  */
 #pragma once
 
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
 #include "logdevice/common/PermissionChecker.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/MessageDispatch.h"
@@ -34,6 +38,22 @@ class ServerMessageDispatch : public MessageDispatch {
                   const SteadyTimestamp enqueue_time) override;
 
  protected:
+  using PermissionStatusMap =
+      std::unordered_map<logid_t, PermissionCheckStatus, logid_t::Hash>;
+
+  // Handles a message batching several messages of type single_type, such
+  // as FINDKEY_BATCH. Checks that the principal may perform `action` on
+  // every log of the batch if messages of single_type need that check,
+  // then calls handler with the outcomes and deletes msg unless the
+  // handler returns KEEP.
+  Message::Disposition onBatchReceived(
+      Message* msg,
+      const PrincipalIdentity& principal,
+      MessageType single_type,
+      ACTION action,
+      const std::vector<logid_t>& log_ids,
+      std::function<Message::Disposition(const PermissionStatusMap&)> handler);
+
   Message::Disposition
   onReceivedHandler(Message* msg,
                     const Address& from,
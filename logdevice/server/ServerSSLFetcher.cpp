@@ -21,9 +21,10 @@ ServerSSLFetcher::create(const std::string& cert_path,
                          const std::string& ca_path,
                          bool use_tls_ticket_seeds,
                          const std::string& tls_ticket_seeds_path,
+                         bool enable_ktls,
                          StatsHolder* stats) {
   std::unique_ptr<ServerSSLFetcher> fetcher{new ServerSSLFetcher(
-      cert_path, key_path, ca_path, use_tls_ticket_seeds, stats)};
+      cert_path, key_path, ca_path, use_tls_ticket_seeds, enable_ktls, stats)};
   fetcher->reloadSSLContext();
 
   if (use_tls_ticket_seeds) {
@@ -46,8 +47,9 @@ ServerSSLFetcher::ServerSSLFetcher(const std::string& cert_path,
                                    const std::string& key_path,
                                    const std::string& ca_path,
                                    bool use_tls_ticket_seeds,
+                                   bool enable_ktls,
                                    StatsHolder* stats)
-    : SSLFetcher(cert_path, key_path, ca_path, true, stats),
+    : SSLFetcher(cert_path, key_path, ca_path, true, enable_ktls, stats),
       use_tls_ticket_seeds_(use_tls_ticket_seeds) {}
 
 void ServerSSLFetcher::reloadSSLContext() {
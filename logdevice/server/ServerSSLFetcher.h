@@ -34,6 +34,7 @@ class ServerSSLFetcher : public SSLFetcher {
          const std::string& ca_path,
          bool use_tls_ticket_seeds,
          const std::string& tls_ticket_seeds_path,
+         bool enable_ktls,
          StatsHolder* stats = nullptr);
 
   virtual ~ServerSSLFetcher() = default;
@@ -58,6 +59,7 @@ class ServerSSLFetcher : public SSLFetcher {
                    const std::string& key_path,
                    const std::string& ca_path,
                    bool enable_shared_tickets,
+                   bool enable_ktls,
                    StatsHolder* stats = nullptr);
 
  private:
@@ -278,6 +278,18 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER | REQUIRES_RESTART | DEPRECATED,
      SettingsCategory::Storage)
 
+    ("storage-thread-numa-affinity",
+     &storage_thread_numa_affinity,
+     "false",
+     nullptr, // no validation
+     "Pin the storage threads of each shard to the CPUs of the NUMA node that "
+     "the shard's block device is attached to, so that IO completions, the "
+     "memory the threads allocate (e.g. RocksDB block cache entries they "
+     "read in) and the device are on the same socket. Shards whose device's "
+     "NUMA node can't be determined are left unpinned.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Storage)
+
     ("epoch-store-path", &epoch_store_path, "", nullptr,
      "directory containing epoch files for logs (for testing only)",
      SERVER | REQUIRES_RESTART,
@@ -306,6 +318,20 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER,
      SettingsCategory::Storage)
 
+    ("storage-thread-max-sync-coalescing-delay",
+     &storage_thread_max_sync_coalescing_delay,
+     "0ms",
+     validate_nonnegative<ssize_t>(),
+     "Maximum time a sync requested by an undelayable storage task may be "
+     "held back so that it can be coalesced with the sync requests arriving "
+     "after it. Within this bound, the syncing thread of each shard waits "
+     "for as long as a sync took recently, and only while sync requests keep "
+     "arriving concurrently, so that the number of syncs per second follows "
+     "the rate of sync requests instead of the rate of wakeups. 0 disables "
+     "coalescing.",
+     SERVER,
+     SettingsCategory::Storage)
+
     ("fd-limit", &fd_limit, "0",
      [](int val) -> void {
        if (val < 0) {
@@ -394,7 +420,10 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      parse_positive<ssize_t>(),
      "(server-only setting) Maximum number of incoming connections that have "
      "been accepted by listener (have an open FD) but have not been processed "
-     "by workers (made logdevice protocol handshake).",
+     "by workers (made logdevice protocol handshake). Applies to the data "
+     "ports only: connections to the gossip and server-to-server ports are "
+     "always accepted, so that clients reconnecting at once can't keep "
+     "nodes from talking to each other.",
      SERVER | REQUIRES_RESTART,
      SettingsCategory::Network)
 
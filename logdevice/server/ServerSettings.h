@@ -56,10 +56,17 @@ struct ServerSettings : public SettingsBundle {
   std::string config_path;
   std::string epoch_store_path;
   StoragePoolParams storage_pool_params;
+  // If true, storage threads of each shard only run on the CPUs of the NUMA
+  // node the shard's block device is attached to.
+  bool storage_thread_numa_affinity;
   std::chrono::milliseconds shutdown_timeout;
   // Interval between invoking syncs for delayable storage tasks.
   // Ignored when undelayable task is being enqueued.
   std::chrono::milliseconds storage_thread_delaying_sync_interval;
+  // Upper bound on how long a sync requested by an undelayable task may be
+  // held back to coalesce it with other sync requests. The actual window
+  // tracks the measured sync latency. 0 disables coalescing.
+  std::chrono::milliseconds storage_thread_max_sync_coalescing_delay;
   std::string server_id;
   int fd_limit;
   bool eagerly_allocate_fdtable;
@@ -19,7 +19,9 @@
 #include "logdevice/server/sequencer_boycotting/NodeStatsControllerLocator.h"
 #include "logdevice/server/storage/AllCachedDigests.h"
 #include "logdevice/server/storage/PurgeScheduler.h"
+#include "logdevice/server/storage/PurgeSingleEpoch.h"
 #include "logdevice/server/storage/PurgeUncleanEpochs.h"
+#include "logdevice/server/storage/SealStorageTask.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
@@ -55,6 +57,16 @@ class ServerWorkerImpl {
    * have to be destructed before the node_stats_controller_
    */
   Timer node_stats_controller_locator_timer_;
+
+  // Tasks accumulated by putSealStorageTask() and putPurgeDeleteRecordsTask(),
+  // per shard, until the end of the current event loop iteration.
+  std::map<shard_index_t, std::vector<std::unique_ptr<SealStorageTask>>>
+      pending_seal_batches_;
+  std::map<shard_index_t,
+           std::vector<std::unique_ptr<PurgeDeleteRecordsStorageTask>>>
+      pending_purge_delete_batches_;
+  // A zero-delay timer calling flushStorageTaskBatches().
+  Timer flush_batches_timer_;
 };
 
 ServerWorker::ServerWorker(WorkContext::KeepAlive event_loop,
@@ -135,6 +147,9 @@ void ServerWorker::subclassWorkFinished() {
   // PerWorkerStorageTaskQueue may involve communication, so take care of
   // that before we tear down the messaging fabric.
   server_read_streams_->clear();
+  // Hand batched seals to the queues so that they get dropped below.
+  impl_->flush_batches_timer_.cancel();
+  flushStorageTaskBatches();
   for (auto& q : storage_task_queues_) {
     ld_check(q);
     q->drop(StorageTask::ThreadType::SLOW);
@@ -201,6 +216,7 @@ void ServerWorker::initSSLFetcher() {
                                setting.ssl_ca_path,
                                server_settings->use_tls_ticket_seeds,
                                server_settings->tls_ticket_seeds_path,
+                               setting.ssl_ktls,
                                stats());
 }
 
@@ -225,6 +241,88 @@ ServerWorker::getStorageTaskQueueForShard(shard_index_t shard) const {
   return storage_task_queues_[shard].get();
 }
 
+void ServerWorker::putSealStorageTask(std::unique_ptr<SealStorageTask> task,
+                                      shard_index_t shard) {
+  if (settings().seal_storage_tasks_batch_size <= 1) {
+    getStorageTaskQueueForShard(shard)->putTask(std::move(task));
+    return;
+  }
+  impl_->pending_seal_batches_[shard].push_back(std::move(task));
+  scheduleFlushStorageTaskBatches();
+}
+
+void ServerWorker::putPurgeDeleteRecordsTask(
+    std::unique_ptr<PurgeDeleteRecordsStorageTask> task,
+    shard_index_t shard) {
+  if (settings().purge_delete_tasks_batch_size <= 1) {
+    getStorageTaskQueueForShard(shard)->putTask(std::move(task));
+    return;
+  }
+  impl_->pending_purge_delete_batches_[shard].push_back(std::move(task));
+  scheduleFlushStorageTaskBatches();
+}
+
+void ServerWorker::scheduleFlushStorageTaskBatches() {
+  Timer& timer = impl_->flush_batches_timer_;
+  if (!timer.isAssigned()) {
+    timer.assign([this] { flushStorageTaskBatches(); });
+  }
+  if (!timer.isActive()) {
+    timer.activate(std::chrono::microseconds(0));
+  }
+}
+
+namespace {
+
+// Attaches consecutive tasks of each shard in `pending` to a leader task with
+// T::addToBatch(), up to `batch_size` tasks per leader, and sends the leaders
+// to storage threads. Returns the number of attached tasks.
+template <typename T>
+size_t sendStorageTaskBatches(
+    ServerWorker* worker,
+    std::map<shard_index_t, std::vector<std::unique_ptr<T>>> pending,
+    size_t batch_size) {
+  batch_size = std::max(batch_size, size_t(1));
+  size_t batched = 0;
+  for (auto& kv : pending) {
+    auto task_queue = worker->getStorageTaskQueueForShard(kv.first);
+    std::unique_ptr<T> leader;
+    for (auto& task : kv.second) {
+      if (leader && leader->batchSize() >= batch_size) {
+        task_queue->putTask(std::move(leader));
+      }
+      if (!leader) {
+        leader = std::move(task);
+      } else {
+        leader->addToBatch(std::move(task));
+        ++batched;
+      }
+    }
+    if (leader) {
+      task_queue->putTask(std::move(leader));
+    }
+  }
+  return batched;
+}
+
+} // namespace
+
+void ServerWorker::flushStorageTaskBatches() {
+  auto seals = std::move(impl_->pending_seal_batches_);
+  impl_->pending_seal_batches_.clear();
+  auto purge_deletes = std::move(impl_->pending_purge_delete_batches_);
+  impl_->pending_purge_delete_batches_.clear();
+
+  const size_t seals_batched = sendStorageTaskBatches(
+      this, std::move(seals), settings().seal_storage_tasks_batch_size);
+  const size_t purge_deletes_batched =
+      sendStorageTaskBatches(this,
+                             std::move(purge_deletes),
+                             settings().purge_delete_tasks_batch_size);
+  WORKER_STAT_ADD(seal_storage_tasks_batched, seals_batched);
+  WORKER_STAT_ADD(purge_delete_tasks_batched, purge_deletes_batched);
+}
+
 StorageThreadPool&
 ServerWorker::getStorageThreadPoolForShard(shard_index_t shard) const {
   return processor_->sharded_storage_thread_pool_->getByIndex(shard);
@@ -23,7 +23,9 @@ class AllServerReadStreams;
 class BoycottingStatsHolder;
 class NodeStatsControllerCallback;
 class PerWorkerStorageTaskQueue;
+class PurgeDeleteRecordsStorageTask;
 class PurgeScheduler;
+class SealStorageTask;
 class StorageThreadPool;
 class ServerProcessor;
 class ServerWorkerImpl;
@@ -98,6 +100,23 @@ class ServerWorker : public Worker {
   PerWorkerStorageTaskQueue*
   getStorageTaskQueueForShard(shard_index_t shard) const;
 
+  /**
+   * Sends a SealStorageTask in recovery context to the given shard. If
+   * Settings::seal_storage_tasks_batch_size > 1, the task is held until the
+   * end of the current event loop iteration and batched with other seals for
+   * the same shard.
+   */
+  void putSealStorageTask(std::unique_ptr<SealStorageTask> task,
+                          shard_index_t shard);
+
+  /**
+   * Same as putSealStorageTask() but for PurgeDeleteRecordsStorageTasks, see
+   * Settings::purge_delete_tasks_batch_size.
+   */
+  void
+  putPurgeDeleteRecordsTask(std::unique_ptr<PurgeDeleteRecordsStorageTask> task,
+                            shard_index_t shard);
+
   /**
    * Gets the storage thread pool assigned to the given shard.
    */
@@ -119,6 +138,11 @@ class ServerWorker : public Worker {
   std::unique_ptr<MessageDispatch> createMessageDispatch() override;
   void noteShuttingDownNoPendingRequests() override;
   void initializeNodeStatsController();
+  // Sends the tasks accumulated by putSealStorageTask() and
+  // putPurgeDeleteRecordsTask() to storage threads in batches.
+  void flushStorageTaskBatches();
+  // Activates the timer calling flushStorageTaskBatches().
+  void scheduleFlushStorageTaskBatches();
 
   // Coordinator for tasks to storage threads to read from the local log store
   // and their replies, sharded by log ID to match ShardedStorageThreadPool
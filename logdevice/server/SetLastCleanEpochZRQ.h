@@ -106,6 +106,21 @@ class SetLastCleanEpochZRQ : public LastCleanEpochZRQ {
     return NextStep::MODIFY;
   }
 
+  // see ZookeeperEpochStoreRequest.h
+  bool canUseCachedZnodeValue(const char* znode_value,
+                              int znode_value_len) const override {
+    epoch_t parsed_epoch;
+    TailRecord parsed_tail;
+    int rv = EpochStoreLastCleanEpochFormat::fromLinearBuffer(
+        znode_value, znode_value_len, logid_, &parsed_epoch, &parsed_tail);
+    // Only the case where onGotZnodeValue() neither fails nor patches
+    // tail_record_ with the stored tail.
+    return rv == 0 && epoch_ > parsed_epoch &&
+        tail_record_.header.lsn != LSN_INVALID &&
+        tail_record_.header.timestamp != 0 &&
+        tail_record_.offsets_map_.isValid();
+  }
+
   // see ZookeeperEpochStoreRequest.h
   int composeZnodeValue(char* buf, size_t size) override {
     ld_check(buf);
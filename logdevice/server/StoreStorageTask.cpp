@@ -12,6 +12,7 @@
 #include <folly/Format.h>
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/E2ETracer.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/protocol/MUTATED_Message.h"
@@ -48,7 +49,8 @@ StoreStorageTask::StoreStorageTask(
       payload_holder_(payload_holder),
       timestamp_(store_header.timestamp),
       lng_(store_header.last_known_good),
-      flags_(store_header.flags),
+      // Not a property of the record, keep it out of the record cache.
+      flags_(store_header.flags & ~STORE_Header::E2E_TRACING_ON),
       rid_(store_header.rid),
       wave_(store_header.wave),
       reply_to_(reply_to),
@@ -211,6 +213,7 @@ size_t StoreStorageTask::getWriteOps(const WriteOp** write_ops,
 
 void StoreStorageTask::onDone() {
   ServerWorker* worker = ServerWorker::onThisThread();
+  traceE2ESpans(status_);
   if (status_ == E::TIMEDOUT) {
     RATELIMIT_INFO(std::chrono::seconds(1),
                    1,
@@ -232,6 +235,16 @@ void StoreStorageTask::onDone() {
     status_ = E::DISABLED;
   }
 
+  // Let UnreleasedRecordDetector know that the log may need watching. This
+  // happens after the write, so that the detector sees the record in
+  // getHighestInsertedLSN() if it already stopped watching the log.
+  if (status_ == E::OK && !rebuilding_) {
+    LogStorageState& log_state = getLogStorageState();
+    if (rid_.lsn() > log_state.getLastReleasedLSN().value()) {
+      log_state.noteUnreleasedRecordStored();
+    }
+  }
+
   // Bump metadata write stats if metadata has been written successfully
   if (status_ == E::OK && metadata_write_op_.has_value()) {
     STAT_INCR(worker->stats(), mutable_per_epoch_log_metadata_writes);
@@ -257,9 +270,43 @@ void StoreStorageTask::onDone() {
 }
 
 void StoreStorageTask::onDropped() {
+  traceE2ESpans(E::DROPPED);
   sendReply(E::DROPPED);
 }
 
+void StoreStorageTask::traceE2ESpans(Status status) const {
+  if (extra_.e2e_trace_id == E2E_TRACE_ID_INVALID) {
+    return;
+  }
+  E2ETracer tracer(ServerWorker::onThisThread()->getTraceLogger());
+  tracer.traceSpan(extra_.e2e_trace_id,
+                   "store",
+                   rid_.logid,
+                   rid_.lsn(),
+                   status,
+                   start_time_,
+                   std::chrono::steady_clock::now(),
+                   {{"shard", getShardIdx()}, {"wave", wave_}});
+  if (execution_start_time_.has_value() && execution_end_time_.has_value()) {
+    auto usec = [](std::chrono::steady_clock::duration d) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    tracer.traceSpan(
+        extra_.e2e_trace_id,
+        "write_storage_task",
+        rid_.logid,
+        rid_.lsn(),
+        status,
+        enqueue_time_,
+        execution_end_time_.value(),
+        {{"shard", getShardIdx()},
+         {"queue_us", usec(execution_start_time_.value() - enqueue_time_)},
+         {"write_us",
+          usec(execution_end_time_.value() - execution_start_time_.value())},
+         {"synced", synced_}});
+  }
+}
+
 shard_index_t StoreStorageTask::getShardIdx() const {
   return static_cast<shard_index_t>(storageThreadPool_->getShardIdx());
 }
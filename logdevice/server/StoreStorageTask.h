@@ -131,6 +131,10 @@ class StoreStorageTask : public WriteStorageTask {
   // Convenience wrapper for STORED_Message_createAndSend
   void sendReply(Status status) const;
 
+  // Publishes the store and write_storage_task spans if the STORE was sampled
+  // for end-to-end tracing.
+  void traceE2ESpans(Status status) const;
+
   // called when the storage task is sent back to the worker thread,
   // in case record caching is on, free evicted cache entries previously
   // disposed on the same worker thread
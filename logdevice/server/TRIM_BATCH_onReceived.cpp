@@ -0,0 +1,242 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/TRIM_BATCH_onReceived.h"
+
+#include <vector>
+
+#include "logdevice/common/Metadata.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/TRIMMED_BATCH_Message.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+// Writes the trim points of all the entries of a TRIM_BATCH message that go
+// to the same shard with one LocalLogStore::updateLogMetadataMulti() call,
+// then replies to all of them with one TRIMMED_BATCH message. Each entry
+// otherwise gets the outcome WriteTrimMetadataTask in TRIM_onReceived.cpp
+// would have given it.
+class WriteTrimMetadataBatchTask : public StorageTask {
+ public:
+  struct Entry {
+    request_id_t client_rqid;
+    logid_t log_id;
+    lsn_t trim_point;
+    Status status;
+  };
+
+  WriteTrimMetadataBatchTask(std::vector<Entry> entries,
+                             const Address& reply_to)
+      : StorageTask(StorageTask::Type::WRITE_TRIM_METADATA_BATCH),
+        entries_(std::move(entries)),
+        reply_to_(reply_to) {}
+
+  Principal getPrincipal() const override {
+    return Principal::METADATA;
+  }
+
+  void execute() override {
+    LocalLogStore& store = storageThreadPool_->getLocalLogStore();
+    LogStorageStateMap& map =
+        storageThreadPool_->getProcessor().getLogStorageStateMap();
+
+    // Not resized after this point, updates point into it.
+    std::vector<TrimMetadata> metadata;
+    metadata.reserve(entries_.size());
+    std::vector<LocalLogStore::LogMetadataUpdate> updates;
+    updates.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+      metadata.emplace_back(entry.trim_point);
+      updates.push_back(
+          LocalLogStore::LogMetadataUpdate{entry.log_id, &metadata.back()});
+    }
+
+    LocalLogStore::WriteOptions options;
+    store.updateLogMetadataMulti(updates, options);
+
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      Entry& entry = entries_[i];
+      if (updates[i].status != E::OK) {
+        // if local log store already contained a trim point with a higher
+        // LSN, report it as a success to the client
+        entry.status = updates[i].status == E::UPTODATE ? E::OK : E::FAILED;
+        continue;
+      }
+
+      LogStorageState* log_state =
+          map.insertOrGet(entry.log_id, storageThreadPool_->getShardIdx());
+      if (log_state == nullptr) {
+        entry.status = E::FAILED;
+        continue;
+      }
+
+      log_state->updateTrimPoint(entry.trim_point);
+      entry.status = E::OK;
+      durability_ = Durability::SYNC_WRITE;
+    }
+  }
+
+  Durability durability() const override {
+    return durability_;
+  }
+
+  void onDone() override {
+    sendReply();
+  }
+
+  void onDropped() override {
+    for (Entry& entry : entries_) {
+      entry.status = E::FAILED;
+    }
+    sendReply();
+  }
+
+ private:
+  void sendReply() {
+    shard_index_t shard = storageThreadPool_->getShardIdx();
+    std::vector<TRIMMED_Header> headers;
+    headers.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+      headers.push_back(TRIMMED_Header{entry.client_rqid, entry.status, shard});
+    }
+    Worker::onThisThread()->sender().sendMessage(
+        std::make_unique<TRIMMED_BATCH_Message>(std::move(headers)),
+        reply_to_);
+  }
+
+  std::vector<Entry> entries_;
+  Address reply_to_;
+  Durability durability_ = Durability::INVALID;
+};
+
+} // namespace
+
+Message::Disposition TRIM_BATCH_onReceived(
+    TRIM_BATCH_Message* msg,
+    const Address& from,
+    const std::unordered_map<logid_t, PermissionCheckStatus, logid_t::Hash>&
+        permission_statuses) {
+  if (!from.isClientAddress()) {
+    ld_error("Received TRIM_BATCH message from non-client %s",
+             Sender::describeConnection(from).c_str());
+    err = E::PROTO;
+    return Message::Disposition::ERROR;
+  }
+
+  WORKER_STAT_INCR(trim_batches_received);
+
+  ServerWorker* worker = ServerWorker::onThisThread();
+  const shard_size_t n_shards = worker->getNodesConfiguration()->getNumShards();
+  const bool storage_node = worker->processor_->runningOnStorageNode();
+  const bool accepting_work = worker->isAcceptingWork();
+  // Check if socket still exists.
+  const bool socket_open = worker->sender().getPrincipal(from) != nullptr &&
+      worker->sender().getSockaddr(from) != Sockaddr::INVALID;
+
+  std::vector<TRIMMED_Header> replies;
+  std::unordered_map<shard_index_t,
+                     std::vector<WriteTrimMetadataBatchTask::Entry>>
+      tasks;
+  for (const TRIM_Header& header : msg->headers_) {
+    const shard_index_t shard_idx = header.shard;
+    if (shard_idx < 0 || shard_idx >= n_shards) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      10,
+                      "Got TRIM_BATCH message from client %s with invalid "
+                      "shard %d, this node only has %u shards",
+                      Sender::describeConnection(from).c_str(),
+                      shard_idx,
+                      n_shards);
+      continue;
+    }
+
+    auto reply = [&](Status status) {
+      replies.push_back(TRIMMED_Header{header.client_rqid, status, shard_idx});
+    };
+
+    if (!storage_node) {
+      reply(E::NOTSTORAGE);
+      continue;
+    }
+
+    auto it = permission_statuses.find(header.log_id);
+    Status st = PermissionChecker::toStatus(it != permission_statuses.end()
+                                                ? it->second
+                                                : PermissionCheckStatus::NONE);
+    if (st != E::OK) {
+      RATELIMIT_LEVEL(st == E::ACCESS ? dbg::Level::WARNING : dbg::Level::INFO,
+                      std::chrono::seconds(2),
+                      1,
+                      "TRIM_BATCH entry from %s for log %lu failed with %s",
+                      Sender::describeConnection(from).c_str(),
+                      header.log_id.val_,
+                      error_description(st));
+      reply(st);
+      continue;
+    }
+
+    if (!accepting_work) {
+      reply(E::SHUTDOWN);
+      continue;
+    }
+
+    if (!socket_open) {
+      reply(E::AGAIN);
+      continue;
+    }
+
+    WORKER_LOG_STAT_INCR(header.log_id, trim_received);
+
+    if (header.log_id == LOGID_INVALID || header.trim_point == LSN_INVALID ||
+        !epoch_valid_or_unset(lsn_to_epoch(header.trim_point))) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      10,
+                      "Received an invalid TRIM_BATCH entry from %s: "
+                      "log id %lu, trim point %lu",
+                      Sender::describeConnection(from).c_str(),
+                      header.log_id.val_,
+                      header.trim_point);
+      reply(E::INVALID_PARAM);
+      continue;
+    }
+
+    tasks[shard_idx].push_back(WriteTrimMetadataBatchTask::Entry{
+        header.client_rqid, header.log_id, header.trim_point, E::UNKNOWN});
+  }
+
+  if (!replies.empty()) {
+    auto reply_msg =
+        std::make_unique<TRIMMED_BATCH_Message>(std::move(replies));
+    if (worker->sender().sendMessage(std::move(reply_msg), from) != 0) {
+      RATELIMIT_INFO(std::chrono::seconds(10),
+                     1,
+                     "Failed to send TRIMMED_BATCH to %s: %s",
+                     Sender::describeConnection(from).c_str(),
+                     error_description(err));
+    }
+  }
+
+  for (auto& kv : tasks) {
+    WORKER_STAT_INCR(trim_batch_storage_tasks);
+    worker->getStorageTaskQueueForShard(kv.first)->putTask(
+        std::make_unique<WriteTrimMetadataBatchTask>(
+            std::move(kv.second), from));
+  }
+  return Message::Disposition::NORMAL;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+
+#include "logdevice/common/PermissionChecker.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/TRIM_BATCH_Message.h"
+
+namespace facebook { namespace logdevice {
+
+struct Address;
+
+/**
+ * Handles every entry of the batch as TRIM_onReceived() would handle a TRIM
+ * message with the same header. Entries that are rejected right away get
+ * their replies in one TRIMMED_BATCH; the trim points of the others are
+ * written with one storage task per shard, which updates all of them in a
+ * single local log store write and replies with one TRIMMED_BATCH.
+ *
+ * @param permission_statuses  outcome of the permission check of each log of
+ *                             the batch; logs that weren't checked are
+ *                             missing.
+ */
+Message::Disposition TRIM_BATCH_onReceived(
+    TRIM_BATCH_Message* msg,
+    const Address& from,
+    const std::unordered_map<logid_t, PermissionCheckStatus, logid_t::Hash>&
+        permission_statuses);
+
+}} // namespace facebook::logdevice
@@ -204,6 +204,7 @@ bool UnreleasedRecordDetector::collectLogStates() {
   auto* const sharded_local_log_store =
       processor_->sharded_storage_thread_pool_->getShardedLocalLogStore();
   ld_check(sharded_local_log_store);
+  LogStorageStateMap& state_map = processor_->getLogStorageStateMap();
 
   // get pointer to latest snapshot of local logs config, may be nullptr in
   // unit tests
@@ -211,57 +212,86 @@ bool UnreleasedRecordDetector::collectLogStates() {
       ? processor_->config_->getLocalLogsConfig()
       : nullptr;
 
-  // visitor lambda for LogStorageStateMap that collects LogStates for all
-  // logs whose last_released_lsn < highest_inserted_lsn; i.e., all logs for
-  // which there are unreleased records
-  const auto visitor = [this, sharded_local_log_store, &local_logs_config](
-                           const logid_t log_id, const LogStorageState& state) {
-    shard_index_t shard_idx = state.getShardIdx();
-    const lsn_t last_released_lsn = state.getLastReleasedLSN().value();
+  if (!initial_scan_done_) {
+    // Records stored before this node started were never reported by
+    // StoreStorageTask, look at every log once.
+    state_map.forEachLog([this](logid_t log_id, const LogStorageState& state) {
+      watched_.emplace(log_id.val(), state.getShardIdx());
+      return 0;
+    });
+    initial_scan_done_ = true;
+  }
+  for (const auto& log : state_map.takeLogsWithUnreleasedRecords()) {
+    watched_.emplace(log.first.val(), log.second);
+  }
 
-    // read highest inserted LSN from local log store
-    lsn_t highest_inserted_lsn;
+  enum class Check { UNRELEASED, RELEASED, FATAL };
+  lsn_t highest_inserted_lsn;
+  lsn_t last_released_lsn;
+  // reads highest_inserted_lsn from the local log store and
+  // last_released_lsn from the LogStorageState
+  const auto check = [&](logid_t log_id, const LogStorageState& state) {
+    const shard_index_t shard_idx = state.getShardIdx();
+    last_released_lsn = state.getLastReleasedLSN().value();
     if (sharded_local_log_store->getByIndex(shard_idx)->getHighestInsertedLSN(
             log_id, &highest_inserted_lsn)) {
       switch (err) {
         case E::LOCAL_LOG_STORE_READ:
           // shard failed to start or is under repair
-          return 0;
+          return Check::RELEASED;
         case E::NOTSUPPORTEDLOG:
           // getHighestInsertedLSN() not supported for this particular log
-          return 0;
+          return Check::RELEASED;
         case E::NOTSUPPORTED:
           // local store does not meet our requirements
-          return -1;
+          return Check::FATAL;
         default:
           // unknown error
           ld_check(false);
-          return -1;
+          return Check::FATAL;
       }
     }
-
-    // check for unreleased records, ignoring logs that do not exist (have been
-    // removed from the config)
-    if ((last_released_lsn < highest_inserted_lsn) &&
-        (!local_logs_config || local_logs_config->logExists(log_id))) {
-      // log has unreleased records and exists, remember state
-      const bool insert_happened =
-          new_states_
-              .emplace(std::make_pair(log_id.val(), shard_idx),
-                       std::make_pair(highest_inserted_lsn, last_released_lsn))
-              .second;
-      ld_check(insert_happened);
-      (void)insert_happened;
-    }
-    return 0;
+    // ignore logs that do not exist (have been removed from the config)
+    return (last_released_lsn < highest_inserted_lsn) &&
+            (!local_logs_config || local_logs_config->logExists(log_id))
+        ? Check::UNRELEASED
+        : Check::RELEASED;
   };
 
-  ld_debug("Collecting log states...");
-  const bool error = processor_->getLogStorageStateMap().forEachLog(visitor);
+  // collect LogStates for all watched logs whose last_released_lsn <
+  // highest_inserted_lsn; i.e., all logs for which there are unreleased
+  // records, and stop watching the others
+  ld_debug("Collecting log states of %zu logs...", watched_.size());
+  for (auto it = watched_.begin(); it != watched_.end();) {
+    const logid_t log_id(it->first);
+    LogStorageState* state = state_map.find(log_id, it->second);
+    Check res = state ? check(log_id, *state) : Check::RELEASED;
+    if (res == Check::RELEASED && state) {
+      // A store that completes from now on will report the log again. One
+      // that completed since check() will be seen by the second check().
+      state->clearUnreleasedRecordsWatched();
+      res = check(log_id, *state);
+    }
+    if (res == Check::FATAL) {
+      return true;
+    }
+    if (res == Check::RELEASED) {
+      it = watched_.erase(it);
+      continue;
+    }
+    // log has unreleased records and exists, remember state
+    const bool insert_happened =
+        new_states_
+            .emplace(*it,
+                     std::make_pair(highest_inserted_lsn, last_released_lsn))
+            .second;
+    ld_check(insert_happened);
+    (void)insert_happened;
+    ++it;
+  }
   ld_debug("Finished collecting log states.");
 
-  // return true iff visitor() returned -1 for some invocation
-  return error;
+  return false;
 }
 
 bool UnreleasedRecordDetector::compareLogStates() {
@@ -12,6 +12,7 @@
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <boost/noncopyable.hpp>
@@ -36,6 +37,12 @@
  *       GetSeqStateRequest, causing sequencer fail-over and eventually release
  *       of the records.
  *
+ *       Only logs that are known to have unreleased records are checked:
+ *       StoreStorageTask reports logs that get them through
+ *       LogStorageStateMap, and logs are dropped once all of their records
+ *       are released. Every log is checked at the first iteration, to cover
+ *       records stored before the node started.
+ *
  *       Runs only on storage nodes.
  */
 namespace facebook { namespace logdevice {
@@ -75,7 +82,10 @@ class UnreleasedRecordDetector final
   bool waitNextInterval(std::unique_lock<std::mutex>& lock);
 
   /**
-   * Collect new log states from local log store.
+   * Collect new log states from local log store, for the logs in watched_
+   * and the logs that got unreleased records since the previous interval
+   * (see LogStorageStateMap::takeLogsWithUnreleasedRecords()). Logs that no
+   * longer have unreleased records are removed from watched_.
    *
    * @return true iff some local log store does not support
    *         getHighestInsertedLSN() (fatal error)
@@ -118,6 +128,14 @@ class UnreleasedRecordDetector final
   std::condition_variable cv_;
   std::mutex mutex_;
 
+  /// logs that had unreleased records at the previous iteration, or got
+  /// some since; the only logs whose states are collected
+  std::unordered_set<Key> watched_;
+
+  /// false until every log in LogStorageStateMap was added to watched_ once,
+  /// at the first iteration
+  bool initial_scan_done_ = false;
+
   /// log states at previous iteration
   LogStates prev_states_;
 
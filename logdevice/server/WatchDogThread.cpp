@@ -71,15 +71,24 @@ void WatchDogThread::detectStalls() {
           stalled_worker_names.push_back(w.getName());
           total_stalled_time_ms_[idx] += poll_interval_ms_;
 
+          // What the worker is running right now is most likely what's
+          // blocking it. NONE means it's stuck outside of any request or
+          // message callback, e.g. in a libevent callback.
+          auto running = w.profiler_.currentlyRunning();
           ld_info("WatchDog found %s(tid:%d) stalled for %ld ms, old("
-                  "posted:%zu, completed:%zu), new(posted:%zu, completed:%zu)",
+                  "posted:%zu, completed:%zu), new(posted:%zu, completed:%zu), "
+                  "running %s for %ld ms",
                   w.getName().c_str(),
                   w.getThreadId(),
                   total_stalled_time_ms_[idx].count(),
                   events_called_[idx],
                   events_completed_[idx],
                   events_called_new,
-                  events_completed_new);
+                  events_completed_new,
+                  running.first.describe().c_str(),
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                      running.second)
+                      .count());
 
         } else {
           // Clear accumulated time for idx which is not stalled any more
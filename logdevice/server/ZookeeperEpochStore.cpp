@@ -42,7 +42,8 @@ ZookeeperEpochStore::ZookeeperEpochStore(
       nodes_configuration_(nodes_configuration),
       settings_(settings),
       shutting_down_(std::make_shared<std::atomic<bool>>(false)),
-      zkFactory_(zkFactory) {
+      zkFactory_(zkFactory),
+      znode_cache_(std::max<size_t>(settings->zk_znode_cache_size, 1)) {
   ld_check(!cluster_name.empty() &&
            cluster_name.length() <
                configuration::ZookeeperConfig::MAX_CLUSTER_NAME);
@@ -270,11 +271,68 @@ void ZookeeperEpochStore::provisionLogZnodes(
   zkclient->multiOp(std::move(ops), std::move(cb));
 }
 
+void ZookeeperEpochStore::cacheZnodeValue(
+    const ZookeeperEpochStoreRequest& zrq,
+    const std::string& path,
+    std::string value,
+    zk::version_t version) {
+  const size_t max_size = settings_->zk_znode_cache_size;
+  if (max_size == 0 || !zrq.isZnodeValueCacheable()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(znode_cache_mutex_);
+  if (znode_cache_.getMaxSize() != max_size) {
+    znode_cache_.setMaxSize(max_size);
+  }
+  auto it = znode_cache_.find(path);
+  if (it != znode_cache_.end() && it->second.version > version) {
+    // A read that completed after a newer write.
+    return;
+  }
+  znode_cache_.set(path, CachedZnode{std::move(value), version});
+}
+
+void ZookeeperEpochStore::forgetZnodeValue(
+    const ZookeeperEpochStoreRequest& zrq,
+    const std::string& path) {
+  if (settings_->zk_znode_cache_size == 0 || !zrq.isZnodeValueCacheable()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(znode_cache_mutex_);
+  znode_cache_.erase(path);
+}
+
+bool ZookeeperEpochStore::runRequestWithCachedZnode(
+    std::unique_ptr<ZookeeperEpochStoreRequest>& zrq) {
+  if (settings_->zk_znode_cache_size == 0 || !zrq->isZnodeValueCacheable()) {
+    return false;
+  }
+  std::string value;
+  zk::Stat stat;
+  {
+    std::lock_guard<std::mutex> lock(znode_cache_mutex_);
+    auto it = znode_cache_.find(zrq->getZnodePath());
+    if (it == znode_cache_.end()) {
+      return false;
+    }
+    value = it->second.value;
+    stat.version_ = it->second.version;
+  }
+  if (!zrq->canUseCachedZnodeValue(value.data(), value.size())) {
+    return false;
+  }
+  STAT_INCR(processor_->stats_, zookeeper_epoch_store_znode_cache_hits);
+  onGetZnodeComplete(
+      ZOK, std::move(value), stat, std::move(zrq), true /* from_cache */);
+  return true;
+}
+
 void ZookeeperEpochStore::onGetZnodeComplete(
     int rc,
     std::string value_from_zk,
     const zk::Stat& stat,
-    std::unique_ptr<ZookeeperEpochStoreRequest> zrq) {
+    std::unique_ptr<ZookeeperEpochStoreRequest> zrq,
+    bool from_cache) {
   ZookeeperEpochStoreRequest::NextStep next_step;
   bool do_provision = false;
   ld_check(zrq);
@@ -286,12 +344,21 @@ void ZookeeperEpochStore::onGetZnodeComplete(
     goto err;
   }
 
+  if (st == E::OK && !from_cache) {
+    cacheZnodeValue(*zrq, zrq->getZnodePath(), value_from_zk, stat.version_);
+  } else if (st == E::NOTFOUND) {
+    forgetZnodeValue(*zrq, zrq->getZnodePath());
+  }
+
   if (st == E::NOTFOUND) {
     // no znode exists, passing nullptr with length 0 to zrq
     value_for_zrq = nullptr;
   }
 
   next_step = zrq->onGotZnodeValue(value_for_zrq, value_from_zk.size());
+  // See ZookeeperEpochStoreRequest::canUseCachedZnodeValue().
+  ld_check(!from_cache ||
+           next_step == ZookeeperEpochStoreRequest::NextStep::MODIFY);
   switch (next_step) {
     case ZookeeperEpochStoreRequest::NextStep::PROVISION:
       // continue with creation of new znodes
@@ -356,7 +423,24 @@ void ZookeeperEpochStore::onGetZnodeComplete(
       // match zkSetCf() will be called with status ZBADVERSION. This ensures
       // that if our read-modify-write of znode_path succeeds, it was atomic.
       std::shared_ptr<ZookeeperClientBase> zkclient = zkclient_.load();
-      auto cb = [this, req = std::move(zrq)](int res, zk::Stat) mutable {
+      auto cb = [this,
+                 req = std::move(zrq),
+                 path = znode_path,
+                 value = znode_value_str,
+                 from_cache](int res, zk::Stat new_stat) mutable {
+        if (res == ZOK) {
+          cacheZnodeValue(*req, path, std::move(value), new_stat.version_);
+        } else {
+          forgetZnodeValue(*req, path);
+          if (from_cache && res == ZBADVERSION) {
+            // The cached value was outdated. Start over with a regular read;
+            // the request wasn't modified by the cached value.
+            STAT_INCR(processor_->stats_,
+                      zookeeper_epoch_store_znode_cache_stale);
+            runRequest(std::move(req));
+            return;
+          }
+        }
         postRequestCompletion(res, std::move(req));
       };
       zkclient->setData(std::move(znode_path),
@@ -400,6 +484,10 @@ int ZookeeperEpochStore::runRequest(
     std::unique_ptr<ZookeeperEpochStoreRequest> zrq) {
   ld_check(zrq);
 
+  if (runRequestWithCachedZnode(zrq)) {
+    return 0;
+  }
+
   std::string znode_path = zrq->getZnodePath();
   std::shared_ptr<ZookeeperClientBase> zkclient = zkclient_.load();
   auto cb = [this, req = std::move(zrq)](
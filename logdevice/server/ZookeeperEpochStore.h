@@ -11,9 +11,12 @@
 #include <memory>
 #include <string>
 
+#include <mutex>
+
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
 #include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <zookeeper/zookeeper.h>
 
 #include "logdevice/common/EpochStore.h"
@@ -160,6 +163,32 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
   // ZookeeperClientFactory to create ZookeeperClient
   std::shared_ptr<ZookeeperClientFactory> zkFactory_;
 
+  // The last known value and version of a znode.
+  struct CachedZnode {
+    std::string value;
+    zk::version_t version;
+  };
+
+  // Values of the znodes of requests with isZnodeValueCacheable(), by path,
+  // as of our last successful read or write. Settings::zk_znode_cache_size
+  // bounds the number of entries; 0 disables the cache. Entries may be
+  // outdated if another node wrote the znode since; see
+  // ZookeeperEpochStoreRequest::canUseCachedZnodeValue().
+  folly::EvictingCacheMap<std::string, CachedZnode> znode_cache_;
+  std::mutex znode_cache_mutex_;
+
+  void cacheZnodeValue(const ZookeeperEpochStoreRequest& zrq,
+                       const std::string& path,
+                       std::string value,
+                       zk::version_t version);
+  void forgetZnodeValue(const ZookeeperEpochStoreRequest& zrq,
+                        const std::string& path);
+
+  // If the znode of zrq is cached and the request can work with the cached
+  // value, runs the request on it and returns true.
+  bool runRequestWithCachedZnode(
+      std::unique_ptr<ZookeeperEpochStoreRequest>& zrq);
+
   /**
    * Run a zoo_aget() on a znode, optionally followed by a modify and a
    * version-conditional zoo_aset() of a new value into the same znode.
@@ -186,11 +215,15 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
 
   /**
    * The callback executed when a znode has been fetched.
+   *
+   * @param from_cache  true if `value` and `stat` come from znode_cache_
+   *                    rather than from Zookeeper
    */
   void onGetZnodeComplete(int rc,
                           std::string value,
                           const zk::Stat& stat,
-                          std::unique_ptr<ZookeeperEpochStoreRequest> zrq);
+                          std::unique_ptr<ZookeeperEpochStoreRequest> zrq,
+                          bool from_cache = false);
 
   /**
    * Provisions znodes for a log that a particular zrq runs on. Executes
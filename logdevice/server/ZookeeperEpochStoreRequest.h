@@ -103,6 +103,26 @@ class ZookeeperEpochStoreRequest {
    */
   virtual int composeZnodeValue(char* buf, size_t size) = 0;
 
+  /**
+   * Returns true if ZookeeperEpochStore may keep the values it reads from
+   * and writes to this request's znode in its znode cache.
+   */
+  virtual bool isZnodeValueCacheable() const {
+    return false;
+  }
+
+  /**
+   * Called with a cached value of the znode, which may be outdated. Returns
+   * true if onGotZnodeValue() would return NextStep::MODIFY for it without
+   * modifying the request, in which case the cached value is used instead
+   * of reading the znode: a stale value makes the version-conditional write
+   * fail, and the request then starts over with a regular read.
+   */
+  virtual bool canUseCachedZnodeValue(const char* /*value*/,
+                                      int /*len*/) const {
+    return false;
+  }
+
   // EpochStore that created this ZookeeperEpochStoreRequest
   ZookeeperEpochStore* const store_;
 
@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <functional>
+#include <limits>
 
 #include <boost/program_options.hpp>
 #include <folly/io/Cursor.h>
@@ -50,9 +51,28 @@ class AdminCommand {
   }
 
  protected:
+  /**
+   * For commands printing large tables: adds the --offset and --limit options
+   * selecting which rows of the table to print. Use with paginate().
+   */
+  void addPagingOptions(boost::program_options::options_description& opts) {
+    opts.add_options()(
+        "offset", boost::program_options::value<size_t>(&page_offset_))(
+        "limit", boost::program_options::value<size_t>(&page_limit_));
+  }
+
+  template <typename Table>
+  void paginate(Table& table) const {
+    table.page(page_offset_, page_limit_);
+  }
+
   Server* server_;
   const RestrictionLevel restrictionLevel_;
   folly::io::Appender& out_;
+
+ private:
+  size_t page_offset_ = 0;
+  size_t page_limit_ = std::numeric_limits<size_t>::max();
 };
 
 }} // namespace facebook::logdevice
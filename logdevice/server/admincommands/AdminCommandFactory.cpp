@@ -30,12 +30,15 @@
 #include "logdevice/server/admincommands/InfoCatchupQueues.h"
 #include "logdevice/server/admincommands/InfoClientReadStreams.h"
 #include "logdevice/server/admincommands/InfoConfig.h"
+#include "logdevice/server/admincommands/InfoEventLoop.h"
 #include "logdevice/server/admincommands/InfoEventLog.h"
 #include "logdevice/server/admincommands/InfoGossip.h"
 #include "logdevice/server/admincommands/InfoGraylist.h"
+#include "logdevice/server/admincommands/InfoIOTracing.h"
 #include "logdevice/server/admincommands/InfoIterators.h"
 #include "logdevice/server/admincommands/InfoLogsConfigRsm.h"
 #include "logdevice/server/admincommands/InfoLogsDBMetadata.h"
+#include "logdevice/server/admincommands/InfoMemory.h"
 #include "logdevice/server/admincommands/InfoPartitions.h"
 #include "logdevice/server/admincommands/InfoPurges.h"
 #include "logdevice/server/admincommands/InfoReaders.h"
@@ -46,6 +49,7 @@
 #include "logdevice/server/admincommands/InfoReplication.h"
 #include "logdevice/server/admincommands/InfoRsm.h"
 #include "logdevice/server/admincommands/InfoSST.h"
+#include "logdevice/server/admincommands/InfoSequencerBatching.h"
 #include "logdevice/server/admincommands/InfoSequencers.h"
 #include "logdevice/server/admincommands/InfoSettings.h"
 #include "logdevice/server/admincommands/InfoShardOperationalState.h"
@@ -108,10 +112,12 @@ AdminCommandFactory::AdminCommandFactory() {
   selector_.add<commands::InfoSockets>("info sockets");
   selector_.add<commands::InfoConfig>("info config");
   selector_.add<commands::InfoSequencers>("info sequencers");
+  selector_.add<commands::InfoSequencerBatching>("info sequencer_batching");
   selector_.add<commands::InfoReaders>("info readers");
   selector_.add<commands::InfoCatchupQueues>("info catchup_queues");
   selector_.add<commands::InfoClientReadStreams>("info client_read_streams");
   selector_.add<commands::InfoEventLog>("info event_log");
+  selector_.add<commands::InfoEventLoop>("info event_loop");
   selector_.add<commands::InfoLogsConfigRsm>("info logsconfig_rsm");
   selector_.add<commands::InfoRecoveries>("info recoveries");
   selector_.add<commands::InfoPurges>("info purges");
@@ -126,6 +132,8 @@ AdminCommandFactory::AdminCommandFactory() {
   selector_.add<commands::ListOrEraseMetadata>("delete metadata",
                                                /* erase */ true);
   selector_.add<commands::InfoIterators>("info iterators");
+  selector_.add<commands::InfoIOTracing>("info io_tracing");
+  selector_.add<commands::InfoMemory>("info memory");
   selector_.add<commands::InfoShards>("info shards");
   selector_.add<commands::InfoSettings>("info settings");
   selector_.add<commands::InfoRecordCache>("info record_cache");
@@ -158,11 +166,14 @@ AdminCommandFactory::AdminCommandFactory() {
 
   selector_.add<commands::Stats>("stats2");
   selector_.add<commands::StatsWorker>("stats worker");
+  selector_.add<commands::StatsOpenMetrics>("stats openmetrics");
   selector_.add<commands::StatsReset>("stats reset");
   selector_.add<commands::StatsRocks>("stats rocksdb");
 
   selector_.add<commands::StatsHistogram>("stats2 histogram");
   selector_.add<commands::TrafficShapingHistogram>("stats2 shaping");
+  selector_.add<commands::LogGroupStatsHistogram>(
+      "stats2 log_group_histogram");
   selector_.add<commands::StoreTimeoutHistogram>("stats2 store_timeouts");
 
   selector_.add<commands::StatsThroughput>("stats throughput");
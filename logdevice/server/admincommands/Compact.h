@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include "logdevice/common/util.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/locallogstore/CompactionRequest.h"
@@ -23,13 +24,18 @@ class Compact : public AdminCommand {
  private:
   shard_index_t shard_{-1};
   bool all_{false};
+  std::string rate_limit_;
 
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "shard", boost::program_options::value<shard_index_t>(&shard_))(
-        "all", boost::program_options::bool_switch(&all_));
+        "all", boost::program_options::bool_switch(&all_))(
+        "rate-limit",
+        boost::program_options::value<std::string>(&rate_limit_),
+        "Throttle the compaction to this rate instead of "
+        "--rocksdb-compaction-ratelimit, e.g. 10M/1s");
   }
   void getPositionalOptions(
       boost::program_options::positional_options_description& out_options)
@@ -37,7 +43,8 @@ class Compact : public AdminCommand {
     out_options.add("shard", 1);
   }
   std::string getUsage() override {
-    return "compact <shard>|--all";
+    return "compact <shard>|--all "
+           "[--rate-limit <count><suffix>/<duration><unit>]";
   }
 
   void run() override {
@@ -94,10 +101,22 @@ class Compact : public AdminCommand {
       shard_idx = shard_;
     }
 
+    folly::Optional<rate_limit_t> rate_limit;
+    if (!rate_limit_.empty()) {
+      rate_limit.emplace();
+      if (parse_rate_limit(rate_limit_.c_str(), &rate_limit.value()) != 0 ||
+          rate_limit->first == 0) {
+        out_.printf("Invalid value for --rate-limit: '%s'; expected e.g. "
+                    "10M/1s or unlimited\r\n",
+                    rate_limit_.c_str());
+        return;
+      }
+    }
+
     // To prevent blocking the CommandListener thread, send a request to
     // eventually let a storage thread execute the compaction.
     std::unique_ptr<Request> request =
-        std::make_unique<CompactionRequest>(shard_idx);
+        std::make_unique<CompactionRequest>(shard_idx, nullptr, rate_limit);
 
     // Noted that success here only means we posted the request to processor
     if (server_->getProcessor()->postRequest(request) == 0) {
@@ -24,15 +24,18 @@ class InfoCatchupQueues : public AdminCommand {
   using AdminCommand::AdminCommand;
 
  private:
-  std::string type_;
-  folly::Optional<uint64_t> id_;
+  folly::Optional<uint64_t> client_;
   bool json_ = false;
 
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
+        "client",
+        boost::program_options::value<uint64_t>()->notifier(
+            [&](uint64_t id) { client_ = id; }))(
         "json", boost::program_options::bool_switch(&json_));
+    addPagingOptions(out_options);
   }
 
   void getPositionalOptions(
@@ -40,10 +43,23 @@ class InfoCatchupQueues : public AdminCommand {
       override {}
 
   std::string getUsage() override {
-    return "info catchup_queues [--json]";
+    return "info catchup_queues [--client <clientid>] [--offset <n>] "
+           "[--limit <n>] [--json]";
   }
 
   void run() override {
+    ClientID client_id = ClientID::INVALID;
+    if (client_.has_value()) {
+      if (client_.value() > std::numeric_limits<uint32_t>::max() ||
+          !ClientID::valid(static_cast<int32_t>(client_.value()))) {
+        out_.printf("Invalid value for --client. Expected a valid client id, "
+                    "got %lu.\r\n",
+                    client_.value());
+        return;
+      }
+      client_id = ClientID(client_.value());
+    }
+
     InfoCatchupQueuesTable table(!json_,
                                  "Client",
                                  "Queued total",
@@ -57,13 +73,14 @@ class InfoCatchupQueues : public AdminCommand {
     auto tables = run_on_all_workers(server_->getProcessor(), [&]() {
       InfoCatchupQueuesTable t(table);
       ServerWorker* w = ServerWorker::onThisThread();
-      w->serverReadStreams().getCatchupQueuesDebugInfo(t);
+      w->serverReadStreams().getCatchupQueuesDebugInfo(t, client_id);
       return t;
     });
 
     for (int i = 0; i < tables.size(); ++i) {
       table.mergeWith(std::move(tables[i]));
     }
+    paginate(table);
 
     json_ ? table.printJson(out_) : table.print(out_);
   }
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/EventLoopProfiler.h"
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Lists the request types, message types and storage task responses that
+ * took the longest to run on each worker, the slowest first. See
+ * EventLoopProfiler.
+ */
+class InfoEventLoop : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool json_ = false;
+  bool reset_ = false;
+  size_t limit_ = 0;
+
+ public:
+  using InfoEventLoopTable =
+      AdminCommandTable<std::string,               /* Worker */
+                        std::string,               /* Context */
+                        std::string,               /* Type */
+                        uint64_t,                  /* Sampled */
+                        uint64_t,                  /* Avg usec */
+                        uint64_t,                  /* Max usec */
+                        std::chrono::milliseconds  /* Max time */
+                        >;
+
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "json", boost::program_options::bool_switch(&json_))(
+        "limit", boost::program_options::value<size_t>(&limit_))(
+        "reset", boost::program_options::bool_switch(&reset_));
+  }
+
+  std::string getUsage() override {
+    return "info event_loop [--limit <rows>] [--reset] [--json]";
+  }
+
+  void run() override {
+    struct Row {
+      std::string worker;
+      EventLoopProfiler::Entry entry;
+    };
+
+    bool reset = reset_;
+    auto rows_per_worker = run_on_all_workers(
+        server_->getProcessor(), [reset]() -> std::vector<Row> {
+          Worker* w = Worker::onThisThread();
+          std::vector<Row> res;
+          if (reset) {
+            w->profiler_.reset();
+            return res;
+          }
+          for (auto& entry : w->profiler_.getEntries()) {
+            res.push_back(Row{w->getName(), std::move(entry)});
+          }
+          return res;
+        });
+
+    if (reset) {
+      if (!json_) {
+        out_.printf("Reset event loop profiles of %zu workers\r\n",
+                    rows_per_worker.size());
+      }
+      return;
+    }
+
+    std::vector<Row> rows;
+    for (auto& worker_rows : rows_per_worker) {
+      std::move(
+          worker_rows.begin(), worker_rows.end(), std::back_inserter(rows));
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+      return a.entry.max > b.entry.max;
+    });
+    if (limit_ > 0 && rows.size() > limit_) {
+      rows.resize(limit_);
+    }
+
+    InfoEventLoopTable table(!json_,
+                             "Worker",
+                             "Context",
+                             "Type",
+                             "Sampled",
+                             "Avg usec",
+                             "Max usec",
+                             "Max time");
+    for (Row& row : rows) {
+      const auto& e = row.entry;
+      table.next()
+          .set<0>(row.worker)
+          .set<1>(contextName(e.context))
+          .set<2>(e.context.subtypeName())
+          .set<3>(e.sampled)
+          .set<4>(e.sampled > 0 ? e.total.count() / e.sampled : 0ul)
+          .set<5>(static_cast<uint64_t>(e.max.count()))
+          .set<6>(std::chrono::duration_cast<std::chrono::milliseconds>(
+              e.max_time.time_since_epoch()));
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+
+ private:
+  static std::string contextName(const RunContext& context) {
+    switch (context.type_) {
+      case RunContext::NONE:
+        return "none";
+      case RunContext::REQUEST:
+        return "request";
+      case RunContext::MESSAGE:
+        return "message";
+      case RunContext::STORAGE_TASK_RESPONSE:
+        return "storage_task_response";
+    }
+    return "unknown";
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/locallogstore/IOTracing.h"
+#include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Prints the IO latency histograms kept by IOTracing for each shard and kind
+ * of context (see rocksdb-io-tracing-histograms). Kinds with no operations
+ * are omitted.
+ */
+class InfoIOTracing : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool json_ = false;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "json", boost::program_options::bool_switch(&json_));
+  }
+  std::string getUsage() override {
+    return "info io_tracing [--json]";
+  }
+
+  void run() override {
+    InfoIOTracingTable table(!json_,
+                             "Shard",
+                             "Kind",
+                             "Count",
+                             "Total usec",
+                             "P50 usec",
+                             "P99 usec",
+                             "P99.9 usec",
+                             "Max usec");
+
+    if (!server_->getProcessor()->runningOnStorageNode()) {
+      out_.printf("Error: not a storage node\r\n");
+      return;
+    }
+    auto sharded_store = server_->getShardedLocalLogStore();
+
+    const double percentiles[] = {.5, .99, .999, 1.};
+    for (shard_index_t shard_idx = 0; shard_idx < sharded_store->numShards();
+         ++shard_idx) {
+      IOTracing* tracing =
+          sharded_store->getByIndex(shard_idx)->getIOTracing();
+      if (tracing == nullptr) {
+        continue;
+      }
+      for (size_t i = 0; i < static_cast<size_t>(IOTracing::Kind::MAX); ++i) {
+        auto kind = static_cast<IOTracing::Kind>(i);
+        int64_t samples[4];
+        uint64_t count;
+        int64_t sum;
+        tracing->getHistogram(kind).estimatePercentiles(
+            percentiles, 4, samples, &count, &sum);
+        if (count == 0) {
+          continue;
+        }
+        table.next()
+            .set<0>(shard_idx)
+            .set<1>(IOTracing::kindName(kind))
+            .set<2>(count)
+            .set<3>(sum)
+            .set<4>(samples[0])
+            .set<5>(samples[1])
+            .set<6>(samples[2])
+            .set<7>(samples[3]);
+      }
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -25,9 +25,10 @@ class InfoLogsDBMetadata : public AdminCommand {
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "json", boost::program_options::bool_switch(&json_));
+    addPagingOptions(out_options);
   }
   std::string getUsage() override {
-    return "info logsdb metadata [--json]";
+    return "info logsdb metadata [--offset <n>] [--limit <n>] [--json]";
   }
 
   void run() override {
@@ -90,6 +91,7 @@ class InfoLogsDBMetadata : public AdminCommand {
       }
     }
 
+    paginate(table);
     if (json_) {
       table.printJson(out_);
     } else {
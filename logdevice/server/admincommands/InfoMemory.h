@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <rocksdb/cache.h>
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/admincommands/StatsJemalloc.h"
+#include "logdevice/server/fatalsignal.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Memory used by the major subsystems of the server, from the counters they
+ * maintain as they allocate and free (see the "Source" column), next to the
+ * allocator's totals. The counters are estimates of the bytes the subsystems
+ * hold, not including the allocator's overhead; "untracked" is what the
+ * allocator reports beyond all of them.
+ */
+class InfoMemory : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool json_ = false;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "json", boost::program_options::bool_switch(&json_));
+  }
+  std::string getUsage() override {
+    return "info memory [--json]";
+  }
+
+  void run() override {
+    InfoMemoryTable table(!json_, "Subsystem", "Bytes", "Source");
+    int64_t tracked = 0;
+    auto add = [&](const char* subsystem, int64_t bytes, const char* source) {
+      table.next().set<0>(subsystem).set<1>(bytes).set<2>(source);
+      tracked += bytes;
+    };
+
+    if (server_->getParameters()->getStats()) {
+      Stats stats = server_->getParameters()->getStats()->aggregate();
+      add("record_cache",
+          stats.record_cache_bytes_cached_estimate,
+          "stat record_cache_bytes_cached_estimate");
+      add("appenders",
+          stats.total_size_of_appenders,
+          "stat total_size_of_appenders");
+      add("client_read_streams",
+          stats.client_read_streams_bytes_buffered,
+          "stat client_read_streams_bytes_buffered");
+      add("socket_output_buffers",
+          stats.sockets_bytes_pending_total,
+          "stat sockets_bytes_pending_total");
+      add("logsconfig",
+          stats.logsconfig_snapshot_size,
+          "stat logsconfig_snapshot_size (serialized size)");
+
+      int64_t memtables = 0;
+      if (stats.per_shard_stats) {
+        for (shard_index_t shard = 0;
+             shard < stats.per_shard_stats->getNumShards();
+             ++shard) {
+          const PerShardStats* s = stats.per_shard_stats->get(shard);
+          memtables += s->memtable_size_active + s->memtable_size_flushing +
+              s->memtable_size_pinned;
+        }
+      }
+      add("rocksdb_memtables",
+          memtables,
+          "stats memtable_size_{active,flushing,pinned}");
+    }
+
+    for (auto cache : {std::make_pair("rocksdb_block_cache",
+                                      g_rocksdb_caches.block_cache),
+                       std::make_pair("rocksdb_block_cache_compressed",
+                                      g_rocksdb_caches.block_cache_compressed),
+                       std::make_pair("rocksdb_metadata_block_cache",
+                                      g_rocksdb_caches.metadata_block_cache)}) {
+      std::shared_ptr<rocksdb::Cache> c = cache.second.lock();
+      if (c != nullptr) {
+        add(cache.first, c->GetUsage(), "rocksdb::Cache::GetUsage()");
+      }
+    }
+
+#ifdef LOGDEVICE_USING_JEMALLOC
+    if (mallctl != nullptr) {
+      // Stats are cached by jemalloc until the epoch is bumped.
+      uint64_t epoch = 1;
+      size_t sz = sizeof(epoch);
+      mallctl("epoch", &epoch, &sz, &epoch, sz);
+      for (const char* name : {"allocated", "active", "resident"}) {
+        std::string ctl = std::string("stats.") + name;
+        size_t value;
+        sz = sizeof(value);
+        if (mallctl(ctl.c_str(), &value, &sz, nullptr, 0) != 0) {
+          continue;
+        }
+        table.next()
+            .set<0>(std::string("jemalloc_") + name)
+            .set<1>(int64_t(value))
+            .set<2>("mallctl " + ctl);
+        if (ctl == "stats.allocated") {
+          table.next()
+              .set<0>("untracked")
+              .set<1>(int64_t(value) - tracked)
+              .set<2>("jemalloc_allocated minus the subsystems above");
+        }
+      }
+    }
+#endif
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -7,6 +7,10 @@
  */
 #pragma once
 
+#include <unordered_map>
+
+#include <folly/Format.h>
+
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
@@ -26,6 +30,13 @@ class InfoPartitions : public AdminCommand {
     return 2;
   }
 
+  static std::string rateLimitToString(rate_limit_t limit) {
+    if (limit == RATE_UNLIMITED) {
+      return "unlimited";
+    }
+    return folly::sformat("{}/{}ms", limit.first, limit.second.count());
+  }
+
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
@@ -85,6 +96,9 @@ class InfoPartitions : public AdminCommand {
                               "Append Dirtied By",
                               "Rebuild Dirtied By",
                               "Under Replicated",
+                              "Compaction",
+                              "Compaction Bytes Filtered",
+                              "Compaction Rate Limit",
                               // Level 2
                               "Approx. Obsolete Bytes");
 
@@ -122,6 +136,17 @@ class InfoPartitions : public AdminCommand {
 
         auto partitions = partitioned_store->getPartitionList();
 
+        // partition -> hi_pri, for pending manual compactions
+        std::unordered_map<partition_id_t, bool> pending_compactions;
+        folly::Optional<PartitionedRocksDBStore::RunningCompaction>
+            running_compaction;
+        if (level_ >= 1) {
+          for (const auto& p : partitioned_store->getManualCompactionList()) {
+            pending_compactions.emplace(p.first, p.second);
+          }
+          running_compaction = partitioned_store->getRunningCompaction();
+        }
+
         for (auto partition : *partitions) {
           table.next()
               .set<0>(shard_idx)
@@ -177,17 +202,37 @@ class InfoPartitions : public AdminCommand {
             table.set<19>(toString(meta.getDirtiedBy(DataClass::APPEND)))
                 .set<20>(toString(meta.getDirtiedBy(DataClass::REBUILD)))
                 .set<21>(partition->isUnderReplicated());
+
+            if (running_compaction.has_value() &&
+                running_compaction->partition_id == partition->id_) {
+              using PartitionToCompact =
+                  PartitionedRocksDBStore::PartitionToCompact;
+              const std::string& reason =
+                  PartitionToCompact::reasonNames()[running_compaction->reason];
+              table.set<22>("running (" + reason + ")")
+                  .set<23>(running_compaction->bytes_filtered);
+              if (running_compaction->rate_limit.has_value()) {
+                table.set<24>(
+                    rateLimitToString(running_compaction->rate_limit.value()));
+              }
+            } else {
+              auto it = pending_compactions.find(partition->id_);
+              if (it != pending_compactions.end()) {
+                table.set<22>(it->second ? "pending (hi-pri)"
+                                         : "pending (lo-pri)");
+              }
+            }
           }
 
           if (level_ >= 2) {
-            table.set<22>(
+            table.set<25>(
                 partitioned_store->getApproximateObsoleteBytes(partition->id_));
           }
         }
       }
     }
 
-    constexpr std::array<int, maxLevel() + 1> num_stats_per_level = {8, 14, 1};
+    constexpr std::array<int, maxLevel() + 1> num_stats_per_level = {8, 17, 1};
     static_assert(table.numCols() ==
                       num_stats_per_level[0] + num_stats_per_level[1] +
                           num_stats_per_level[2],
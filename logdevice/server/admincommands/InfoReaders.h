@@ -26,6 +26,7 @@ class InfoReaders : public AdminCommand {
  private:
   std::string type_;
   folly::Optional<uint64_t> id_;
+  shard_index_t shard_ = -1;
   bool json_ = false;
 
  public:
@@ -43,8 +44,10 @@ class InfoReaders : public AdminCommand {
         ->notifier([&] (uint64_t id) {
           id_ = id;
         }))
+      ("shard", boost::program_options::value<shard_index_t>(&shard_))
       ("json", boost::program_options::bool_switch(&json_));
     // clang-format on
+    addPagingOptions(out_options);
   }
 
   void getPositionalOptions(
@@ -55,7 +58,8 @@ class InfoReaders : public AdminCommand {
   }
 
   std::string getUsage() override {
-    return "info readers client|log|all [<clientid>|<logid>] [--json]";
+    return "info readers client|log|all [<clientid>|<logid>] "
+           "[--shard <shard>] [--offset <n>] [--limit <n>] [--json]";
   }
 
   void run() override {
@@ -114,18 +118,23 @@ class InfoReaders : public AdminCommand {
                            "ReadShaping(Meter Level)",
                            "CSID",
                            "RSID",
-                           "TCP sndbuf");
+                           "TCP sndbuf",
+                           "Adaptive batch bytes",
+                           "Drain rate",
+                           "Wait state",
+                           "Stalled ms");
 
     auto tables = run_on_all_workers(server_->getProcessor(), [&]() {
       InfoReadersTable t(table);
       ServerWorker* w = ServerWorker::onThisThread();
       if (type_ == "log") {
-        w->serverReadStreams().getReadStreamsDebugInfo(logid_t(id_.value()), t);
+        w->serverReadStreams().getReadStreamsDebugInfo(
+            logid_t(id_.value()), t, shard_);
       } else if (type_ == "client") {
         w->serverReadStreams().getReadStreamsDebugInfo(
-            ClientID(id_.value()), t);
+            ClientID(id_.value()), t, shard_);
       } else {
-        w->serverReadStreams().getReadStreamsDebugInfo(t);
+        w->serverReadStreams().getReadStreamsDebugInfo(t, shard_);
       }
       return t;
     });
@@ -133,6 +142,7 @@ class InfoReaders : public AdminCommand {
     for (int i = 0; i < tables.size(); ++i) {
       table.mergeWith(std::move(tables[i]));
     }
+    paginate(table);
 
     json_ ? table.printJson(out_) : table.print(out_);
   }
@@ -54,7 +54,11 @@ class InfoRebuildingShards : public AdminCommand {
                                     "Read buffer bytes",         // 12
                                     "Records in flight",         // 13
                                     "Read pointer",              // 14
-                                    "Progress");                 // 15
+                                    "Progress",                  // 15
+                                    "Bytes total",               // 16
+                                    "Bytes remaining",           // 17
+                                    "Bytes per sec",             // 18
+                                    "ETA seconds");              // 19
 
     auto workerType = EventLogStateMachine::workerType(server->getProcessor());
     auto workerIdx = EventLogStateMachine::getWorkerIdx(
@@ -27,6 +27,7 @@ class InfoRecordCache : public AdminCommand {
             [this](logid_t::raw_type id) { log_id_ = logid_t(id); }))(
         "shard", boost::program_options::value<shard_index_t>(&shard_))(
         "json", boost::program_options::bool_switch(&json_));
+    addPagingOptions(opts);
   }
 
   void getPositionalOptions(
@@ -36,7 +37,8 @@ class InfoRecordCache : public AdminCommand {
   }
 
   std::string getUsage() override {
-    return "info record_cache [<logid>] [--shard <shard>] [--json]";
+    return "info record_cache [<logid>] [--shard <shard>] [--offset <n>] "
+           "[--limit <n>] [--json]";
   }
 
   void run() override {
@@ -107,6 +109,7 @@ class InfoRecordCache : public AdminCommand {
         state_map.forEachLogOnShard(shard_, process_one);
       }
     }
+    paginate(table);
 
     json_ ? table.printJson(out_) : table.print(out_);
   }
@@ -10,6 +10,7 @@
 #include <folly/Memory.h>
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/LogIDUniqueQueue.h"
 #include "logdevice/common/LogRecoveryRequest.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/request_util.h"
@@ -59,6 +60,16 @@ class InfoRecoveries : public AdminCommand {
           it.second->getDebugInfo(t);
         }
       }
+
+      // Logs waiting for a recovery slot, in the order they were queued.
+      for (LogIDUniqueQueue* queue : {&w->recoveryQueueMetaDataLog(),
+                                      &w->recoveryQueueDataLog()}) {
+        for (logid_t log : queue->q.get<LogIDUniqueQueue::FIFOIndex>()) {
+          if (!logid_.has_value() || logid_.value() == log) {
+            t.next().set<0>(log).set<2>("QUEUED");
+          }
+        }
+      }
       return t;
     });
 
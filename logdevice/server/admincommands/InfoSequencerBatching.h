@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/SequencerBatching.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Per-log decisions of adaptive sequencer batching (see
+ * --sequencer-batching-adaptive): estimated append rate, whether appends are
+ * batched and the time trigger of the last batch.
+ */
+class InfoSequencerBatching : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool json_ = false;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "json", boost::program_options::bool_switch(&json_));
+  }
+
+  std::string getUsage() override {
+    return "info sequencer_batching [--json]";
+  }
+
+  void run() override {
+    InfoSequencerBatchingTable table(!json_,
+                                     "Log ID",
+                                     "Appends/s",
+                                     "Bytes/s",
+                                     "Batching",
+                                     "Time trigger");
+    auto& batching = server_->getProcessor()->sequencerBatching();
+    for (const auto& info : batching.getAdaptiveLogInfo()) {
+      table.next()
+          .set<0>(info.log_id)
+          .set<1>(info.appends_per_sec)
+          .set<2>(info.bytes_per_sec)
+          .set<3>(info.batching)
+          .set<4>(info.time_trigger);
+    }
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
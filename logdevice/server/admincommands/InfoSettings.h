@@ -7,9 +7,16 @@
  */
 #pragma once
 
+#include <algorithm>
+
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/CPUAffinity.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/SettingsUpdater.h"
+#include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
 namespace facebook { namespace logdevice { namespace commands {
 
@@ -18,6 +25,7 @@ class InfoSettings : public AdminCommand {
 
  private:
   bool json_ = false;
+  bool placement_ = false;
 
   typedef AdminCommandTable<std::string, // Bundle Name
                             std::string, // Name
@@ -29,17 +37,29 @@ class InfoSettings : public AdminCommand {
                             >
       InfoSettingsTable;
 
+  typedef AdminCommandTable<std::string, // Thread
+                            int,         // NUMA Node
+                            std::string  // CPUs
+                            >
+      InfoPlacementTable;
+
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "placement", boost::program_options::bool_switch(&placement_));
   }
   std::string getUsage() override {
-    return "info settings [--json]";
+    return "info settings [--placement] [--json]";
   }
 
   void run() override {
+    if (placement_) {
+      printPlacement();
+      return;
+    }
+
     // TODO(T8584641): add more columns:
     // - flags;
     // - timestamp of last update;
@@ -79,6 +99,58 @@ class InfoSettings : public AdminCommand {
       }
     }
 
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+
+ private:
+  // Prints which CPUs workers and storage threads may run on, see the
+  // worker-numa-affinity and storage-thread-numa-affinity settings.
+  void printPlacement() {
+    std::vector<std::vector<int>> node_cpus;
+    for (int node = 0; node < getNumaNodeCount(); ++node) {
+      node_cpus.push_back(getNumaNodeCPUs(node));
+    }
+    // -1 if the CPUs span more than one node.
+    auto node_of = [&](const std::vector<int>& cpus) -> int {
+      for (size_t node = 0; node < node_cpus.size(); ++node) {
+        if (!cpus.empty() &&
+            std::includes(node_cpus[node].begin(),
+                          node_cpus[node].end(),
+                          cpus.begin(),
+                          cpus.end())) {
+          return node;
+        }
+      }
+      return -1;
+    };
+
+    InfoPlacementTable table(!json_, "Thread", "NUMA Node", "CPUs");
+
+    auto workers = run_on_all_workers(server_->getProcessor(), [] {
+      return std::make_pair(
+          Worker::onThisThread()->getName(), getThreadCPUAffinity(0));
+    });
+    for (const auto& w : workers) {
+      table.next()
+          .set<0>(w.first)
+          .set<1>(node_of(w.second))
+          .set<2>(formatCPUList(w.second));
+    }
+
+    const ShardedStorageThreadPool* sharded_pool =
+        server_->getServerProcessor()->sharded_storage_thread_pool_;
+    if (sharded_pool != nullptr) {
+      for (int i = 0; i < sharded_pool->numShards(); ++i) {
+        const StorageThreadPool& pool = sharded_pool->getByIndex(i);
+        table.next()
+            .set<0>("storage threads of shard " + std::to_string(i))
+            .set<1>(pool.getNumaNode());
+        if (!pool.getPinnedCPUs().empty()) {
+          table.set<2>(formatCPUList(pool.getPinnedCPUs()));
+        }
+      }
+    }
+
     json_ ? table.printJson(out_) : table.print(out_);
   }
 };
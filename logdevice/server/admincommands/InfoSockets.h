@@ -28,10 +28,11 @@ class InfoSockets : public AdminCommand {
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "json", boost::program_options::bool_switch(&json_));
+    addPagingOptions(out_options);
   }
 
   std::string getUsage() override {
-    return "info sockets [--json]";
+    return "info sockets [--offset <n>] [--limit <n>] [--json]";
   }
 
   void run() override {
@@ -62,6 +63,7 @@ class InfoSockets : public AdminCommand {
     for (int i = 0; i < tables.size(); ++i) {
       table.mergeWith(std::move(tables[i]));
     }
+    paginate(table);
 
     json_ ? table.printJson(out_) : table.print(out_);
   }
@@ -21,13 +21,15 @@ class InfoStorageTasks : public AdminCommand {
  private:
   shard_index_t shard_ = -1;
   bool json_ = false;
+  bool queues_ = false;
 
  public:
   virtual void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "shard", boost::program_options::value<shard_index_t>(&shard_))(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "queues", boost::program_options::bool_switch(&queues_));
   }
   virtual void getPositionalOptions(
       boost::program_options::positional_options_description& out_options)
@@ -35,10 +37,15 @@ class InfoStorageTasks : public AdminCommand {
     out_options.add("shard", 1);
   }
   virtual std::string getUsage() override {
-    return "info storage_tasks [<shard>] [--json]";
+    return "info storage_tasks [<shard>] [--queues] [--json]";
   }
 
   virtual void run() override {
+    if (queues_) {
+      printQueues();
+      return;
+    }
+
     InfoStorageTasksTable table(!json_,
                                 "Shard",
                                 "Priority",
@@ -92,6 +99,38 @@ class InfoStorageTasks : public AdminCommand {
       table.print(out_, table.numCols());
     }
   }
+
+ private:
+  // With --queues, prints the number of tasks waiting in the DRR queue of
+  // SLOW storage threads for each IO principal, instead of the tasks
+  // themselves.
+  void printQueues() {
+    InfoStorageTaskQueuesTable table(
+        !json_, "Shard", "Principal", "Share", "Queued", "Deficit");
+
+    if (!server_->getProcessor()->runningOnStorageNode()) {
+      if (!json_) {
+        out_.printf("Not a storage node.\r\n\r\n");
+      }
+      return;
+    }
+    auto sharded_store = server_->getShardedLocalLogStore();
+    for (shard_index_t shard_idx = 0; shard_idx < sharded_store->numShards();
+         ++shard_idx) {
+      if (shard_ != -1 && shard_ != shard_idx) {
+        continue;
+      }
+      server_->getServerProcessor()
+          ->sharded_storage_thread_pool_->getByIndex(shard_idx)
+          .getDRRQueueInfo(table);
+    }
+
+    if (json_) {
+      table.printJson(out_);
+    } else {
+      table.print(out_);
+    }
+  }
 };
 
 }}} // namespace facebook::logdevice::commands
@@ -10,6 +10,7 @@
 #include <folly/ScopeGuard.h>
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/util.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
@@ -310,6 +311,7 @@ class CompactPartition : public AdminCommand {
   bool hi_pri_{false};
   bool list_{false};
   bool json_{false};
+  std::string rate_limit_;
 
  public:
   void getOptions(
@@ -321,7 +323,11 @@ class CompactPartition : public AdminCommand {
         "hi-pri", boost::program_options::bool_switch(&hi_pri_))(
         "cancel", boost::program_options::bool_switch(&cancel_))(
         "list", boost::program_options::bool_switch(&list_))(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "rate-limit",
+        boost::program_options::value<std::string>(&rate_limit_),
+        "Throttle the compaction to this rate instead of "
+        "--rocksdb-compaction-ratelimit, e.g. 10M/1s");
   }
   void getPositionalOptions(
       boost::program_options::positional_options_description& out_options)
@@ -331,7 +337,8 @@ class CompactPartition : public AdminCommand {
   }
   std::string getUsage() override {
     return "logsdb compact <shard> [partition] "
-           "[--hi-pri | --cancel | --list [--json]]";
+           "[--hi-pri | --cancel | --list [--json]] "
+           "[--rate-limit <count><suffix>/<duration><unit>]";
   }
 
   void listCompactions(PartitionedRocksDBStore* partitioned_store) {
@@ -346,14 +353,29 @@ class CompactPartition : public AdminCommand {
   }
 
   void scheduleOrCancelCompactions(PartitionedRocksDBStore* partitioned_store) {
+    folly::Optional<rate_limit_t> rate_limit;
+    if (!rate_limit_.empty()) {
+      rate_limit.emplace();
+      if (parse_rate_limit(rate_limit_.c_str(), &rate_limit.value()) != 0 ||
+          rate_limit->first == 0) {
+        out_.printf("Error: invalid --rate-limit '%s'; expected e.g. 10M/1s "
+                    "or unlimited\r\n",
+                    rate_limit_.c_str());
+        return;
+      }
+    }
+
     ld_info("%s partition %lu of shard %d, triggered by admin "
-            "command",
+            "command%s%s",
             cancel_ ? "Cancelling compaction of" : "Compacting",
             partition_id_,
-            shard_);
+            shard_,
+            rate_limit_.empty() ? "" : ", rate limit ",
+            rate_limit_.c_str());
 
     if (!cancel_) {
-      partitioned_store->scheduleManualCompaction(partition_id_, hi_pri_);
+      partitioned_store->scheduleManualCompaction(
+          partition_id_, hi_pri_, rate_limit);
     } else {
       partitioned_store->cancelManualCompaction(partition_id_);
     }
@@ -377,6 +399,11 @@ class CompactPartition : public AdminCommand {
       out_.printf("Error: --json is only valid with --list\r\n");
       return;
     }
+    if (!rate_limit_.empty() && (cancel_ || list_)) {
+      out_.printf("Error: --rate-limit is only valid when scheduling a "
+                  "compaction\r\n");
+      return;
+    }
 
     auto partitioned_store = getStore(server_, shard_, out_);
 
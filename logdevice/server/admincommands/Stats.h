@@ -9,8 +9,11 @@
 
 #include <sstream>
 
+#include <sys/resource.h>
+
 #include "logdevice/common/PriorityMap.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/stats/OpenMetrics.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
 
@@ -161,6 +164,22 @@ inline void printStats(const Stats& stats,
   stats.enumerate(&cb, /* list_all */ true);
 }
 
+// CPU time of the whole process so far, in the same format as the stats.
+// Lets benchmarks compute CPU per operation from the "stats2" output.
+inline void printProcessCpu(folly::io::Appender& out) {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return;
+  }
+  auto usec = [](const struct timeval& tv) {
+    return int64_t(tv.tv_sec) * 1000000 + tv.tv_usec;
+  };
+  out.printf(
+      "STAT process_cpu_user_usec %" PRId64 "\r\n", usec(usage.ru_utime));
+  out.printf(
+      "STAT process_cpu_system_usec %" PRId64 "\r\n", usec(usage.ru_stime));
+}
+
 class Stats : public AdminCommand {
   using AdminCommand::AdminCommand;
 
@@ -190,6 +209,34 @@ class Stats : public AdminCommand {
                  out_,
                  include_log_groups_);
     }
+    printProcessCpu(out_);
+  }
+};
+
+// Same stats as "stats", in the OpenMetrics text format, for scrapers.
+class StatsOpenMetrics : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool include_log_groups_;
+
+ public:
+  std::string getUsage() override {
+    return "stats openmetrics [--include-log-groups]";
+  }
+
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "include-log-groups",
+        boost::program_options::bool_switch(&include_log_groups_));
+  }
+
+  void run() override {
+    auto stats = server_->getParameters()->getStats();
+    if (stats) {
+      OpenMetricsWriter::write(stats->aggregate(), out_, include_log_groups_);
+    }
   }
 };
 
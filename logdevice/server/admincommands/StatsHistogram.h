@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/stats/PerShardHistograms.h"
 #include "logdevice/common/stats/ServerHistograms.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
@@ -293,6 +294,82 @@ class StatsHistogram : public ShardedStatsHistogramBase {
   }
 };
 
+using LogGroupStatsHistogramBase =
+    StatsHistogramBase<std::string /*log group*/>;
+class LogGroupStatsHistogram : public LogGroupStatsHistogramBase {
+  using LogGroupStatsHistogramBase::LogGroupStatsHistogramBase;
+
+ public:
+  std::string getUsage() override {
+    return "stats2 log_group_histogram <type>|all [--log-group=NAME] " +
+        LogGroupStatsHistogramBase::getUsage();
+  }
+
+  void getOptions(boost::program_options::options_description& opts) override {
+    opts.add_options()(
+        "type", boost::program_options::value<std::string>(&type_))(
+        "log-group", boost::program_options::value<std::string>(&log_group_));
+    LogGroupStatsHistogramBase::getOptions(opts);
+  }
+
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& out_options)
+      override {
+    out_options.add("type", 1);
+    LogGroupStatsHistogramBase::getPositionalOptions(out_options);
+  }
+
+  void run() override {
+    if (type_.empty()) {
+      out_.printf("Statistic name or \'all\' must be specified\r\n");
+      return;
+    }
+    SCOPE_EXIT {
+      histograms_.clear();
+    };
+
+    execute("Log group");
+  }
+
+ private:
+  std::string type_;
+  std::string log_group_;
+  // Keeps the histograms returned by findHistograms() alive.
+  std::vector<std::shared_ptr<SketchHistogram>> histograms_;
+
+  std::vector<HistTuple>
+  findHistograms(facebook::logdevice::Stats& stats) override {
+    std::vector<HistTuple> hists;
+    for (const auto& kv : stats.synchronizedCopy(
+             &facebook::logdevice::Stats::per_log_stats)) {
+      if (!log_group_.empty() && kv.first != log_group_) {
+        continue;
+      }
+      std::lock_guard<std::mutex> guard(kv.second->mutex);
+#define HISTOGRAM_DEFINE(name)                                          \
+  if (kv.second->name && (type_ == "all" || type_ == #name)) {          \
+    histograms_.push_back(kv.second->name);                             \
+    hists.push_back(HistTuple(#name, kv.second->name.get(), kv.first)); \
+  }
+#include "logdevice/common/stats/per_log_histograms.inc" // nolint
+    }
+    return hists;
+  }
+
+  void setUniqueCols(HistTuple& tuple, SummaryTable& table) override {
+    table.set<1>(std::get<2>(tuple));
+  }
+
+  void printHist(HistTuple& tuple) override {
+    std::ostringstream oss;
+    std::get<1>(tuple)->print(oss);
+    out_.printf("%s - %s:\r\n%s\r\n",
+                std::get<2>(tuple).c_str(),
+                std::get<0>(tuple).c_str(),
+                oss.str().c_str());
+  }
+};
+
 using TrafficShapingHistogramBase =
     StatsHistogramBase<std::string /*scope*/, std::string /*priority*/>;
 class TrafficShapingHistogram : public TrafficShapingHistogramBase {
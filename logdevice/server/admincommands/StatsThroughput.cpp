@@ -122,7 +122,8 @@ void StatsThroughput::getOptions(
                   folly::join("', '", allowedStats()) + "'");
             }
           }),
-      "'appends_in' (same as 'appends'), 'appends_out' or 'reads'")(
+      "'appends_in' (same as 'appends'), 'appends_out', 'appends_unbatched' "
+      "or 'reads'")(
       "threshold",
       value<int64_t>(&threshold_)->default_value(threshold_),
       "only include log groups for which the rate is at "
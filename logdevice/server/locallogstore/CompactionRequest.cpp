@@ -25,10 +25,13 @@ namespace facebook { namespace logdevice {
 // for a fixed amount of filtering).
 class CompactionStorageTask : public StorageTask {
  public:
-  CompactionStorageTask(int idx, std::function<void(Status)> callback)
+  CompactionStorageTask(int idx,
+                        std::function<void(Status)> callback,
+                        folly::Optional<rate_limit_t> rate_limit)
       : StorageTask(StorageTask::Type::COMPACT_PARTITION),
         shard_idx_(idx),
-        callback_(callback) {}
+        callback_(callback),
+        rate_limit_(rate_limit) {}
 
   ThreadType getThreadType() const override {
     return ThreadType::SLOW;
@@ -47,7 +50,7 @@ class CompactionStorageTask : public StorageTask {
       return;
     }
     // block until compaction is finished
-    if (rocks_store->performCompaction() != 0) {
+    if (rocks_store->performCompaction(rate_limit_) != 0) {
       RATELIMIT_ERROR(std::chrono::seconds(1),
                       1,
                       "Manual Compaction failed on RocksDBLocalLogStore "
@@ -76,6 +79,8 @@ class CompactionStorageTask : public StorageTask {
 
   // called upon the completion of the storage task
   std::function<void(Status)> callback_;
+
+  folly::Optional<rate_limit_t> rate_limit_;
 };
 
 Request::Execution CompactionRequest::execute() {
@@ -88,7 +93,8 @@ Request::Execution CompactionRequest::execute() {
     // the callback_ 'pins' an inflight request slot in the
     // MonitorRequestQueue (See MonitorRequestCallback in LogStoreMonitor.cpp)
     // It will get released once we get a response on the storage task.
-    auto task = std::make_unique<CompactionStorageTask>(idx, callback_);
+    auto task =
+        std::make_unique<CompactionStorageTask>(idx, callback_, rate_limit_);
     ServerWorker::onThisThread()->getStorageTaskQueueForShard(idx)->putTask(
         std::move(task));
   };
@@ -10,6 +10,7 @@
 #include <folly/Optional.h>
 
 #include "logdevice/common/Request.h"
+#include "logdevice/common/types_internal.h"
 #include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
@@ -20,11 +21,14 @@ namespace facebook { namespace logdevice {
 
 class CompactionRequest : public Request {
  public:
-  explicit CompactionRequest(folly::Optional<int> shard_idx,
-                             std::function<void(Status)> callback = nullptr)
+  explicit CompactionRequest(
+      folly::Optional<int> shard_idx,
+      std::function<void(Status)> callback = nullptr,
+      folly::Optional<rate_limit_t> rate_limit = folly::none)
       : Request(RequestType::COMPACTION),
         shard_idx_(shard_idx),
-        callback_(callback) {}
+        callback_(callback),
+        rate_limit_(rate_limit) {}
 
   Request::Execution execute() override;
 
@@ -35,6 +39,10 @@ class CompactionRequest : public Request {
 
   // callback function to pass to the Storage task
   std::function<void(Status)> callback_;
+
+  // If supplied, the compaction filter is throttled to this rate instead of
+  // RocksDBSettings::compaction_rate_limit_
+  folly::Optional<rate_limit_t> rate_limit_;
 };
 
 }} // namespace facebook::logdevice
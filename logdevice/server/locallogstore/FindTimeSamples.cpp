@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/FindTimeSamples.h"
+
+#include <folly/Varint.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
+#include "logdevice/server/locallogstore/RocksDBWriterMergeOperator.h"
+
+namespace facebook { namespace logdevice {
+
+using RocksDBKeyFormat::DataKey;
+
+// Format of the property: for each log, in increasing order of log ID,
+//   varint log_id, varint size, <size bytes>
+// where the bytes are
+//   varint num_samples, then for each sample in increasing order of LSN
+//   varint (lsn - previous lsn), varint zigzag(timestamp - previous timestamp)
+// with the previous LSN and timestamp starting at 0.
+
+static void appendVarint(uint64_t val, std::string& out) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  size_t len = folly::encodeVarint(val, buf);
+  out.append(reinterpret_cast<const char*>(buf), len);
+}
+
+static bool readVarint(folly::ByteRange& range, uint64_t* out) {
+  auto res = folly::tryDecodeVarint(range);
+  if (!res.hasValue()) {
+    return false;
+  }
+  *out = res.value();
+  return true;
+}
+
+void FindTimeSamples::serialize(logid_t log,
+                                const std::vector<Sample>& samples,
+                                std::string& out) {
+  std::string body;
+  appendVarint(samples.size(), body);
+  lsn_t prev_lsn = LSN_INVALID;
+  int64_t prev_timestamp = 0;
+  for (const Sample& s : samples) {
+    ld_check(s.lsn > prev_lsn);
+    appendVarint(s.lsn - prev_lsn, body);
+    appendVarint(folly::encodeZigZag(s.timestamp_ms - prev_timestamp), body);
+    prev_lsn = s.lsn;
+    prev_timestamp = s.timestamp_ms;
+  }
+  appendVarint(log.val_, out);
+  appendVarint(body.size(), out);
+  out += body;
+}
+
+bool FindTimeSamples::narrow(const std::string& blob,
+                             logid_t log,
+                             RecordTimestamp target,
+                             lsn_t min_lo,
+                             lsn_t max_hi,
+                             lsn_t* inout_lo,
+                             lsn_t* inout_hi) {
+  folly::ByteRange range(folly::StringPiece(blob.data(), blob.size()));
+  const int64_t target_ms = target.toMilliseconds().count();
+  while (!range.empty()) {
+    uint64_t log_id;
+    uint64_t size;
+    if (!readVarint(range, &log_id) || !readVarint(range, &size) ||
+        size > range.size()) {
+      return false;
+    }
+    if (log_id < log.val_) {
+      range.advance(size);
+      continue;
+    }
+    if (log_id > log.val_) {
+      // Logs are sorted, there are no samples for `log`.
+      return true;
+    }
+
+    folly::ByteRange body(range.begin(), size);
+    uint64_t num_samples;
+    if (!readVarint(body, &num_samples)) {
+      return false;
+    }
+    lsn_t lsn = LSN_INVALID;
+    int64_t timestamp_ms = 0;
+    for (uint64_t i = 0; i < num_samples; ++i) {
+      uint64_t lsn_delta;
+      uint64_t timestamp_delta;
+      if (!readVarint(body, &lsn_delta) ||
+          !readVarint(body, &timestamp_delta)) {
+        return false;
+      }
+      lsn += lsn_delta;
+      timestamp_ms += folly::decodeZigZag(timestamp_delta);
+      if (lsn <= min_lo) {
+        continue;
+      }
+      if (lsn > max_hi) {
+        break;
+      }
+      if (timestamp_ms < target_ms) {
+        *inout_lo = std::max(*inout_lo, lsn);
+      } else {
+        *inout_hi = std::min(*inout_hi, lsn);
+        // Subsequent samples can only have higher LSNs.
+        break;
+      }
+    }
+    return true;
+  }
+  return true;
+}
+
+FindTimeSamplesCollector::FindTimeSamplesCollector(size_t max_samples_per_log)
+    : max_samples_(std::max<size_t>(1, max_samples_per_log)) {}
+
+rocksdb::Status
+FindTimeSamplesCollector::AddUserKey(const rocksdb::Slice& key,
+                                     const rocksdb::Slice& value,
+                                     rocksdb::EntryType type,
+                                     rocksdb::SequenceNumber /*seq*/,
+                                     uint64_t /*file_size*/) {
+  if (!DataKey::valid(key.data(), key.size()) ||
+      (type != rocksdb::EntryType::kEntryPut &&
+       type != rocksdb::EntryType::kEntryMerge)) {
+    return rocksdb::Status::OK();
+  }
+
+  Slice value_slice(value.data(), value.size());
+  if (type == rocksdb::EntryType::kEntryMerge) {
+    if (value_slice.size == 0 ||
+        *reinterpret_cast<const char*>(value_slice.data) !=
+            RocksDBWriterMergeOperator::DATA_MERGE_HEADER) {
+      return rocksdb::Status::OK();
+    }
+    // Remove the 'd' byte prepended to merge operands by RocksDBWriter.
+    value_slice.data = reinterpret_cast<const char*>(value_slice.data) + 1;
+    --value_slice.size;
+  }
+
+  std::chrono::milliseconds timestamp;
+  LocalLogStoreRecordFormat::flags_t flags;
+  int rv = LocalLogStoreRecordFormat::parse(value_slice,
+                                            &timestamp,
+                                            nullptr,
+                                            &flags,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            0,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            -1 /* unused */);
+  if (rv != 0 ||
+      (flags &
+       (LocalLogStoreRecordFormat::FLAG_AMEND |
+        LocalLogStoreRecordFormat::FLAG_HOLE |
+        LocalLogStoreRecordFormat::FLAG_BRIDGE))) {
+    return rocksdb::Status::OK();
+  }
+
+  const logid_t log = DataKey::getLogID(key.data());
+  const lsn_t lsn = DataKey::getLSN(key.data());
+  if (log != log_) {
+    finishLog();
+    log_ = log;
+  } else if (lsn <= last_.lsn) {
+    // Another version of the same record (DataKey in the old format).
+    return rocksdb::Status::OK();
+  }
+
+  last_ = {lsn, timestamp.count()};
+  if (records_seen_++ % stride_ == 0) {
+    samples_.push_back(last_);
+    if (samples_.size() > max_samples_) {
+      // Keep samples 0, 2, 4, ... which are exactly the records we'd have
+      // sampled with twice the stride.
+      size_t kept = 0;
+      for (size_t i = 0; i < samples_.size(); i += 2) {
+        samples_[kept++] = samples_[i];
+      }
+      samples_.resize(kept);
+      stride_ *= 2;
+    }
+  }
+  return rocksdb::Status::OK();
+}
+
+void FindTimeSamplesCollector::finishLog() {
+  if (log_ != LOGID_INVALID && records_seen_ > 0) {
+    if (samples_.empty() || samples_.back().lsn != last_.lsn) {
+      samples_.push_back(last_);
+    }
+    FindTimeSamples::serialize(log_, samples_, blob_);
+  }
+  log_ = LOGID_INVALID;
+  samples_.clear();
+  stride_ = 1;
+  records_seen_ = 0;
+  last_ = {LSN_INVALID, 0};
+}
+
+rocksdb::Status FindTimeSamplesCollector::Finish(
+    rocksdb::UserCollectedProperties* properties) {
+  finishLog();
+  if (!blob_.empty()) {
+    properties->emplace(FindTimeSamples::PROPERTY_NAME, std::move(blob_));
+  }
+  blob_.clear();
+  return rocksdb::Status::OK();
+}
+
+rocksdb::TablePropertiesCollector*
+FindTimeSamplesCollectorFactory::CreateTablePropertiesCollector(
+    rocksdb::TablePropertiesCollectorFactory::Context /*context*/) {
+  return new FindTimeSamplesCollector(max_samples_per_log_);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <rocksdb/table_properties.h>
+
+#include "logdevice/common/Timestamp.h"
+#include "logdevice/common/types_internal.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A compact sample of (LSN, timestamp) pairs of the records of each log
+ *       in a table file, stored in the file's table properties. The samples
+ *       are collected by FindTimeSamplesCollector when RocksDB writes the file
+ *       (flush or compaction), so they cost nothing on the write path, and
+ *       are loaded with the rest of the table properties when RocksDB opens
+ *       the file.
+ *
+ *       FindTime uses them to narrow its binary search within a partition
+ *       down to the records between two consecutive samples, which are
+ *       usually in the same data block; without them every step of the binary
+ *       search is a seek, and on a cold partition a block read.
+ *
+ *       Enabled by --rocksdb-find-time-samples-per-log. findKey doesn't need
+ *       samples: it always seeks in the findKey index.
+ */
+
+class FindTimeSamples {
+ public:
+  // Name of the table property holding the samples.
+  static constexpr const char* PROPERTY_NAME = "logdevice.find_time_samples";
+
+  struct Sample {
+    lsn_t lsn;
+    int64_t timestamp_ms;
+  };
+
+  /**
+   * Appends the samples of one log to `out`. Logs must be appended in
+   * increasing order of log ID, and samples in increasing order of LSN.
+   */
+  static void serialize(logid_t log,
+                        const std::vector<Sample>& samples,
+                        std::string& out);
+
+  /**
+   * Looks for samples of `log` in `blob` (a PROPERTY_NAME table property)
+   * with LSNs in (min_lo, max_hi], and updates:
+   *  - *inout_lo to the highest sampled LSN with timestamp < `target`, if
+   *    it's greater than *inout_lo,
+   *  - *inout_hi to the lowest sampled LSN with timestamp >= `target`, if
+   *    it's smaller than *inout_hi.
+   *
+   * @return false if `blob` is malformed.
+   */
+  static bool narrow(const std::string& blob,
+                     logid_t log,
+                     RecordTimestamp target,
+                     lsn_t min_lo,
+                     lsn_t max_hi,
+                     lsn_t* inout_lo,
+                     lsn_t* inout_hi);
+};
+
+/**
+ * Collects FindTimeSamples of data records. Keeps at most
+ * `max_samples_per_log` evenly spaced (by record count) samples of each log in
+ * the file, plus its last record. Holes, bridges and amends aren't sampled:
+ * their timestamps aren't meaningful.
+ */
+class FindTimeSamplesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  explicit FindTimeSamplesCollector(size_t max_samples_per_log);
+
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key,
+                             const rocksdb::Slice& value,
+                             rocksdb::EntryType type,
+                             rocksdb::SequenceNumber seq,
+                             uint64_t file_size) override;
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override;
+
+  // The samples are binary, nothing readable here.
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return {};
+  }
+
+  const char* Name() const override {
+    return "facebook::logdevice::FindTimeSamplesCollector";
+  }
+
+ private:
+  // Serializes samples of the current log into blob_ and resets them.
+  void finishLog();
+
+  const size_t max_samples_;
+
+  logid_t log_{LOGID_INVALID};
+  std::vector<FindTimeSamples::Sample> samples_;
+  // Sample every stride_-th record of the log. Doubled, and every other
+  // sample dropped, when samples_ would exceed max_samples_.
+  size_t stride_{1};
+  size_t records_seen_{0};
+  FindTimeSamples::Sample last_{LSN_INVALID, 0};
+
+  std::string blob_;
+};
+
+class FindTimeSamplesCollectorFactory
+    : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  explicit FindTimeSamplesCollectorFactory(size_t max_samples_per_log)
+      : max_samples_per_log_(max_samples_per_log) {}
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override;
+
+  const char* Name() const override {
+    return "facebook::logdevice::FindTimeSamplesCollectorFactory";
+  }
+
+ private:
+  const size_t max_samples_per_log_;
+};
+
+}} // namespace facebook::logdevice
@@ -14,8 +14,38 @@ namespace facebook { namespace logdevice {
 
 IOTracing::IOTracing(shard_index_t shard_idx) : shardIdx_(shard_idx) {}
 
+const char* IOTracing::kindName(Kind kind) {
+  switch (kind) {
+    case Kind::OTHER:
+      return "other";
+    case Kind::WRITE:
+      return "write";
+    case Kind::WAL_SYNC:
+      return "wal_sync";
+    case Kind::FLUSH:
+      return "flush";
+    case Kind::COMPACTION:
+      return "compaction";
+    case Kind::ITERATOR_SEEK:
+      return "iterator_seek";
+    case Kind::ITERATOR_STEP:
+      return "iterator_step";
+    case Kind::MAX:
+      break;
+  }
+  ld_check(false);
+  return "unknown";
+}
+
 void IOTracing::reportCompletedOp(
     std::chrono::steady_clock::duration duration) {
+  if (options_->histograms_enabled.load(std::memory_order_relaxed)) {
+    histograms_[static_cast<size_t>(state_->kind)].add(
+        to_usec(duration).count());
+  }
+  if (!isLoggingEnabled()) {
+    return;
+  }
   auto threshold = options_->threshold.load(std::memory_order_relaxed);
   if (threshold.count() <= 0 || duration >= threshold) {
     ld_info("[io:S%d] %s  %.3fms",
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <array>
+
 #include <folly/Format.h>
 #include <folly/Preprocessor.h>
 #include <folly/ThreadLocal.h>
@@ -14,6 +16,7 @@
 #include <folly/lang/Aligned.h>
 
 #include "logdevice/common/checks.h"
+#include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/toString.h"
 #include "logdevice/common/types_internal.h"
 
@@ -45,12 +48,14 @@
  * To time and report an IO operation, use macro SCOPED_IO_TRACED_OP();
  * this is done in RocksDBEnv.cpp - very close to the actual syscalls for IO.
  *
- * The thread-local context is currently just a free-form std::string to which
- * everyone appends. It could instead be more structured, e.g. describe the
- * reason for iops with an enum (e.g. write path, read path, rebuilding etc)
- * and aggregate some stats per enum value. We don't do it for now, to keep
- * adding context easy, but it may make sense in future, when we have a better
- * idea of what sort of aggregated stats would be useful to expose.
+ * The thread-local context is mostly a free-form std::string to which
+ * everyone appends. In addition, some of the places adding context also
+ * classify the IO by setting a Kind (e.g. flush, compaction, iterator seek).
+ * Independently of logging, IOTracing can keep a latency histogram of
+ * operations of each Kind (see setHistogramsEnabled()). This is much cheaper
+ * than logging: the context string is not built if logging is disabled, and
+ * reporting an operation is a relaxed atomic increment. Histograms can be
+ * inspected with admin command "info io_tracing".
  *
  * Performance-wise, appending to thread-local std::string should be pretty
  * cheap because it doesn't do memory allocations, apart from the initial
@@ -63,6 +68,26 @@ namespace facebook { namespace logdevice {
 
 class IOTracing {
  public:
+  // What the IO operations are done for. Operations done outside of any
+  // context that sets a Kind are counted as OTHER.
+  enum class Kind : uint8_t {
+    OTHER = 0,
+    // Writing records or metadata, including appending to WAL.
+    WRITE,
+    // Explicit WAL syncs.
+    WAL_SYNC,
+    // Memtable flushes.
+    FLUSH,
+    // Compactions.
+    COMPACTION,
+    // Seeking a data or copyset index iterator.
+    ITERATOR_SEEK,
+    // Moving a data or copyset index iterator to the next/previous record.
+    ITERATOR_STEP,
+    MAX
+  };
+  static const char* kindName(Kind kind);
+
   // Appends the given string, formatted with folly::format(), to IOTracing's
   // thread-local context string.
   // Destructor truncates the context string back to its previous length.
@@ -80,11 +105,26 @@ class IOTracing {
       assign(tracing, format, std::forward<Args>(args)...);
     }
 
+    // Same as above, and additionally sets the Kind of the operations done
+    // in this context.
+    template <class... Args>
+    AddContext(IOTracing* tracing,
+               Kind kind,
+               folly::StringPiece format,
+               Args&&... args) {
+      assign(tracing, kind, format, std::forward<Args>(args)...);
+    }
+
     AddContext(AddContext&& rhs) noexcept
-        : str_(rhs.str_), prevSize_(rhs.prevSize_), addedSize_(rhs.addedSize_) {
+        : str_(rhs.str_),
+          prevSize_(rhs.prevSize_),
+          addedSize_(rhs.addedSize_),
+          kind_(rhs.kind_),
+          prevKind_(rhs.prevKind_) {
       rhs.str_ = nullptr;
       rhs.prevSize_ = std::numeric_limits<size_t>::max();
       rhs.addedSize_ = 0;
+      rhs.kind_ = nullptr;
     }
 
     // Assignment operator would be error-prone. Consider:
@@ -104,6 +144,10 @@ class IOTracing {
     template <class... Args>
     void assign(IOTracing* tracing, folly::StringPiece format, Args&&... args) {
       clear();
+      if (!tracing->isLoggingEnabled()) {
+        // Only histograms are enabled, and they don't need the string.
+        return;
+      }
       str_ = &tracing->state_->context;
       prevSize_ = str_->size();
 
@@ -123,7 +167,22 @@ class IOTracing {
       addedSize_ = str_->size() - prevSize_;
     }
 
+    template <class... Args>
+    void assign(IOTracing* tracing,
+                Kind kind,
+                folly::StringPiece format,
+                Args&&... args) {
+      assign(tracing, format, std::forward<Args>(args)...);
+      kind_ = &tracing->state_->kind;
+      prevKind_ = *kind_;
+      *kind_ = kind;
+    }
+
     void clear() {
+      if (kind_ != nullptr) {
+        *kind_ = prevKind_;
+        kind_ = nullptr;
+      }
       if (prevSize_ == std::numeric_limits<size_t>::max()) {
         ld_check_eq(0, addedSize_);
         return;
@@ -139,6 +198,8 @@ class IOTracing {
     std::string* str_ = nullptr;
     size_t prevSize_ = std::numeric_limits<size_t>::max();
     size_t addedSize_ = 0;
+    Kind* kind_ = nullptr;
+    Kind prevKind_ = Kind::OTHER;
   };
 
   // Times and reports an IO operation. Also contains an AddContext for
@@ -188,28 +249,46 @@ class IOTracing {
 
   explicit IOTracing(shard_index_t shard_idx);
 
+  // True if either logging or histograms are enabled, i.e. if IO operations
+  // need to be timed.
   bool isEnabled() const {
+    return isLoggingEnabled() ||
+        options_->histograms_enabled.load(std::memory_order_relaxed);
+  }
+  bool isLoggingEnabled() const {
     return options_->enabled.load(std::memory_order_relaxed);
   }
   void setEnabled(bool enabled) {
     options_->enabled.store(enabled);
   }
+  void setHistogramsEnabled(bool enabled) {
+    options_->histograms_enabled.store(enabled);
+  }
   void setThreshold(std::chrono::milliseconds t) {
     options_->threshold.store(t);
   }
 
-  // Logs the current context along with operation duration.
-  // Does _not_ check isEnabled() or threshold; they need to be checked before
-  // calling this.
+  // Adds the duration to the histogram of the current Kind, if histograms are
+  // enabled, and logs the current context along with operation duration, if
+  // logging is enabled and the duration is above threshold.
   // Usually used through OpTimer/SCOPED_IO_TRACED_OP() rather than directly.
   void reportCompletedOp(std::chrono::steady_clock::duration duration);
 
+  // Latencies of operations of the given kind, in microseconds, since the
+  // histograms were enabled.
+  const CompactLatencyHistogram& getHistogram(Kind kind) const {
+    ld_check(kind < Kind::MAX);
+    return histograms_[static_cast<size_t>(kind)];
+  }
+
  private:
   struct State {
     std::string context;
+    Kind kind = Kind::OTHER;
   };
   struct Options {
     std::atomic<bool> enabled{false};
+    std::atomic<bool> histograms_enabled{false};
     std::atomic<std::chrono::milliseconds> threshold{
         std::chrono::milliseconds(0)};
   };
@@ -217,6 +296,8 @@ class IOTracing {
   shard_index_t shardIdx_;
   folly::cacheline_aligned<Options> options_;
   folly::ThreadLocal<State> state_;
+  std::array<CompactLatencyHistogram, static_cast<size_t>(Kind::MAX)>
+      histograms_;
 };
 
 // Declares a local variable of type AddContext, passing it the given arguments.
@@ -230,6 +311,14 @@ class IOTracing {
       ? IOTracing::AddContext((tracing), (format), ##args)  \
       : IOTracing::AddContext()
 
+// Same as SCOPED_IO_TRACING_CONTEXT(), and also sets the IOTracing::Kind of
+// operations done in this scope.
+#define SCOPED_IO_TRACING_CONTEXT_WITH_KIND(tracing, kind, format, args...) \
+  auto FB_ANONYMOUS_VARIABLE(io_tracing_ctx) =                              \
+      ((tracing) && (tracing)->isEnabled())                                 \
+      ? IOTracing::AddContext((tracing), (kind), (format), ##args)          \
+      : IOTracing::AddContext()
+
 // Declares a local variable of type OpTimer, passing it the given arguments.
 // This macro intentionally doesn't nest, you can have at most one per scope;
 // that's because IO tracing is intended for low-level indivisible operations,
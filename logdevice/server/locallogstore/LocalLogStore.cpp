@@ -19,6 +19,15 @@
 
 namespace facebook { namespace logdevice {
 
+void LocalLogStore::updateLogMetadataMulti(
+    std::vector<LogMetadataUpdate>& updates,
+    const WriteOptions& opts) {
+  for (LogMetadataUpdate& update : updates) {
+    int rv = updateLogMetadata(update.log_id, *update.metadata, opts);
+    update.status = rv == 0 ? E::OK : err;
+  }
+}
+
 void FlushCallback::deactivate() {
   LocalLogStore* store = registered_with.load();
   if (store != nullptr) {
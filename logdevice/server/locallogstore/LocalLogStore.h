@@ -265,6 +265,13 @@ class LocalLogStore : boost::noncopyable {
       return -1;
     }
 
+    // Approximate total size of the data the iterator goes through, in
+    // bytes. Together with getProgress() this tells how much is left to
+    // read. -1 means size estimation is not supported.
+    virtual int64_t getApproximateTotalBytes() const {
+      return -1;
+    }
+
     // The filtering works the same way as in ReadIterator; see comment above.
     // `filter` can be null. `stats` can be null if `data_logs_filter` passed
     // to readAllLogs() was an empty map.
@@ -546,6 +553,16 @@ class LocalLogStore : boost::noncopyable {
     return WriteThrottleState::NONE;
   }
 
+  /**
+   * How long writers should wait before each write batch when the throttle
+   * state is NONE or doesn't apply to them. Grows gradually as the store
+   * approaches REJECT_WRITE, so that the write rate slows down proportionally
+   * instead of oscillating between full speed and rejecting everything.
+   */
+  virtual std::chrono::microseconds getWriteDelay() {
+    return std::chrono::microseconds::zero();
+  }
+
   /**
    * Called once during shutdown.
    * Unblocks all current and future stallLowPriWrite() calls.
@@ -838,6 +855,27 @@ class LocalLogStore : boost::noncopyable {
                                 ComparableLogMetadata& metadata,
                                 const WriteOptions& opts = WriteOptions()) = 0;
 
+  struct LogMetadataUpdate {
+    logid_t log_id;
+    // Metadata to store; may be modified like the `metadata` argument of
+    // updateLogMetadata().
+    ComparableLogMetadata* metadata;
+    // Outcome of the update: E::OK if it was written, otherwise the error
+    // updateLogMetadata() would have set err to.
+    Status status{E::UNKNOWN};
+  };
+
+  /**
+   * Has the same effect as calling updateLogMetadata() for each element of
+   * `updates` in order, and sets their `status`. Updates of the same entry
+   * within `updates` are compared against each other. Implementations may
+   * write all successful updates in a single batch; the default one just
+   * calls updateLogMetadata() for each of them.
+   */
+  virtual void
+  updateLogMetadataMulti(std::vector<LogMetadataUpdate>& updates,
+                         const WriteOptions& opts = WriteOptions());
+
   /**
    * Option that decides whether to check seal metadata preemption for
    * PerEpochLogMetadata.
@@ -1012,6 +1050,16 @@ class LocalLogStore : boost::noncopyable {
     return false;
   }
 
+  /**
+   * @return true if payload checksums of records were verified when the
+   *         records were written, and corruption of the stored data is
+   *         detected on read (e.g. by RocksDB block checksums). Readers may
+   *         then skip verifying payload checksums themselves.
+   */
+  virtual bool verifiesChecksumsOnWriteAndRead() const {
+    return false;
+  }
+
   /**
    * Called by each StorageThread before starting to execute
    * StorageTasks. Allows the store to initialize any per-thread data it may
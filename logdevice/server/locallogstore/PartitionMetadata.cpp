@@ -13,9 +13,12 @@
 
 namespace facebook { namespace logdevice {
 
-PartitionDirtyMetadata::PartitionDirtyMetadata(const DirtiedByMap& dbm,
-                                               bool under_replicated)
-    : under_replicated_(under_replicated) {
+PartitionDirtyMetadata::PartitionDirtyMetadata(
+    const DirtiedByMap& dbm,
+    bool under_replicated,
+    RecordTimestamp min_unflushed_timestamp)
+    : under_replicated_(under_replicated),
+      min_unflushed_timestamp_(min_unflushed_timestamp) {
   for (const auto& kv : dbm) {
     if (kv.second.dirtyUntil() != FlushToken_INVALID) {
       node_index_t nidx;
@@ -38,6 +41,8 @@ Slice PartitionDirtyMetadata::serialize() const {
   h.flags = under_replicated_ ? Header::UNDER_REPLICATED : 0;
   h.dnc_array_offset = 0;
   h.dnc_array_len = 0;
+  h.min_unflushed_timestamp_ms =
+      min_unflushed_timestamp_.toMilliseconds().count();
   for (auto& dv : dirtied_by_) {
     if (!dv.empty()) {
       h.dnc_array_len += sizeof(DirtyNodesForClass);
@@ -87,14 +92,14 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
 
   Header h;
   const uint8_t* data = static_cast<const uint8_t*>(blob.data);
-  if (blob.size < sizeof(h)) {
+  if (blob.size < Header::kMinLen) {
     ld_check(false);
     err = E::MALFORMED_RECORD;
     return -1;
   }
 
-  memcpy(&h, data, sizeof(h));
-  if (h.len < sizeof(h) || h.len > blob.size ||
+  memcpy(&h, data, std::min(blob.size, sizeof(h)));
+  if (h.len < Header::kMinLen || h.len > blob.size ||
       (h.dnc_array_len != 0 &&
        (h.dnc_array_offset < h.len || h.dnc_array_offset > blob.size))) {
     ld_check(false);
@@ -103,6 +108,13 @@ int PartitionDirtyMetadata::deserialize(Slice blob) {
   }
 
   under_replicated_ = (h.flags & Header::UNDER_REPLICATED) != 0;
+  if (h.len < sizeof(h)) {
+    // Written by an older version.
+    min_unflushed_timestamp_ = RecordTimestamp::min();
+  } else {
+    min_unflushed_timestamp_ = RecordTimestamp::from(
+        std::chrono::milliseconds(h.min_unflushed_timestamp_ms));
+  }
 
   uint32_t dnc_offset = h.dnc_array_offset;
   uint32_t data_offset = dnc_offset + h.dnc_array_len;
@@ -164,6 +176,11 @@ std::string PartitionDirtyMetadata::toString() const {
     }
     dci++;
   }
+  if (min_unflushed_timestamp_ != RecordTimestamp::min()) {
+    str += "{min_unflushed:";
+    str += logdevice::toString(min_unflushed_timestamp_);
+    str += "}";
+  }
   str += ")";
   return str;
 }
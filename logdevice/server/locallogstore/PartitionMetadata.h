@@ -110,7 +110,10 @@ class PartitionDirtyMetadata : public PartitionMetadata {
   using DirtyNodeVectors = std::array<DirtyNodeVector, (size_t)DataClass::MAX>;
 
   explicit PartitionDirtyMetadata() {}
-  explicit PartitionDirtyMetadata(const DirtiedByMap&, bool under_replicated);
+  explicit PartitionDirtyMetadata(
+      const DirtiedByMap&,
+      bool under_replicated,
+      RecordTimestamp min_unflushed_timestamp = RecordTimestamp::min());
 
   PartitionMetadataType getType() const override {
     return PartitionMetadataType::DIRTY;
@@ -133,6 +136,13 @@ class PartitionDirtyMetadata : public PartitionMetadata {
     return dirtied_by_;
   }
 
+  // Lower bound on the timestamps of append records in the partition that
+  // may not have been flushed from memtables. RecordTimestamp::min() if
+  // unknown, e.g. if the metadata was written by an older version.
+  RecordTimestamp getMinUnflushedTimestamp() const {
+    return min_unflushed_timestamp_;
+  }
+
  private:
   // Offsets are from the beginning of the metadata record.
   // Both offsets and lengths are in terms of bytes.
@@ -164,8 +174,14 @@ class PartitionDirtyMetadata : public PartitionMetadata {
     // Offset to DirtyNodeForClass elements
     uint32_t dnc_array_offset;
     uint32_t dnc_array_len;
+    uint32_t pad2 = 0;
+    // See getMinUnflushedTimestamp(). Not present in records written by
+    // older versions; their header is kMinLen bytes long.
+    int64_t min_unflushed_timestamp_ms;
+
+    static constexpr uint16_t kMinLen = 12;
   };
-  static_assert(sizeof(Header) == 12,
+  static_assert(sizeof(Header) == 24,
                 "PartitionDirtyMetadata::Header is not packed.");
 
   DirtyNodeVectors dirtied_by_;
@@ -174,6 +190,8 @@ class PartitionDirtyMetadata : public PartitionMetadata {
   // rebuilding.
   bool under_replicated_ = false;
 
+  RecordTimestamp min_unflushed_timestamp_ = RecordTimestamp::min();
+
   mutable std::vector<uint8_t> serialize_buffer_;
 };
 
@@ -12,7 +12,9 @@
 #include <cstdlib>
 #include <iterator>
 #include <list>
+#include <thread>
 
+#include <boost/filesystem.hpp>
 #include <folly/Conv.h>
 #include <folly/Likely.h>
 #include <folly/Optional.h>
@@ -22,6 +24,7 @@
 #include <rocksdb/convenience.h>
 #include <rocksdb/merge_operator.h>
 #include <rocksdb/sst_file_manager.h>
+#include <rocksdb/table.h>
 
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
@@ -333,6 +336,25 @@ RecordTimeInterval PartitionedRocksDBStore::Partition::dirtyTimeInterval(
                    settings.partition_timestamp_granularity_));
 }
 
+RecordTimeInterval PartitionedRocksDBStore::Partition::unflushedTimeInterval(
+    const RocksDBSettings& settings,
+    partition_id_t latest_id) const {
+  RecordTimeInterval dti = dirtyTimeInterval(settings, latest_id);
+  RecordTimestamp min_unflushed = dirty_state_.min_unflushed_timestamp;
+  if (min_unflushed == RecordTimestamp::min()) {
+    return dti;
+  }
+  RecordTimestamp lower = min_unflushed -
+      std::min(min_unflushed.time_since_epoch(), // avoiding overflow
+               settings.partition_timestamp_granularity_);
+  if (lower <= dti.lower() || lower >= dti.upper()) {
+    // Nothing to tighten, or the bound is inconsistent with the durable
+    // timestamps. Be conservative in the latter case.
+    return dti;
+  }
+  return RecordTimeInterval(lower, dti.upper());
+}
+
 PartitionedRocksDBStore::PartitionedRocksDBStore(
     uint32_t shard_idx,
     uint32_t num_shards,
@@ -366,6 +388,30 @@ void PartitionedRocksDBStore::init(const Configuration* config) {
   data_cf_options_.level0_stop_writes_trigger = 1 << 29;
   data_cf_options_.disable_auto_compactions = true;
 
+  if (!getSettings()->cold_storage_path.empty()) {
+    // Sst files may be in either path; compactions choose explicitly which one
+    // they write to, see getCompactionOutputPathId(). The order must never
+    // change: rocksdb refers to paths by index.
+    cold_storage_path_ =
+        (boost::filesystem::path(getSettings()->cold_storage_path) /
+         boost::filesystem::path(db_path_).filename())
+            .string();
+    if (!getSettings()->read_only) {
+      boost::system::error_code ec;
+      boost::filesystem::create_directories(cold_storage_path_, ec);
+      if (ec) {
+        ld_error("Failed to create cold storage directory %s: %s",
+                 cold_storage_path_.c_str(),
+                 ec.message().c_str());
+        throw ConstructorFailed();
+      }
+    }
+    data_cf_options_.cf_paths = {
+        rocksdb::DbPath(db_path_, std::numeric_limits<uint64_t>::max()),
+        rocksdb::DbPath(cold_storage_path_,
+                        std::numeric_limits<uint64_t>::max())};
+  }
+
   // Metadata column family, on the other hand, gets compacted and can have a
   // dedicated block cache. Partition directory is usually small, and 100%
   // cache hit ratio is expected most of the time. If someone accidentally
@@ -417,9 +463,19 @@ void PartitionedRocksDBStore::init(const Configuration* config) {
 
   ld_spew("Found %zd column families", column_families.size());
 
-  if (!open(column_families, meta_cf_options, config) || !readDirectories()) {
+  if (!open(column_families, meta_cf_options, config)) {
+    throw ConstructorFailed();
+  }
+  auto directories_start = std::chrono::steady_clock::now();
+  if (!readDirectories()) {
     throw ConstructorFailed();
   }
+  ld_info("Shard %u: read directories of %lu logs in %.3fs",
+          shard_idx_,
+          logs_.size(),
+          std::chrono::duration_cast<std::chrono::duration<double>>(
+              std::chrono::steady_clock::now() - directories_start)
+              .count());
   if (!getSettings()->read_only) {
     if (!finishInterruptedDrops() || !convertDataKeyFormat()) {
       throw ConstructorFailed();
@@ -612,9 +668,44 @@ bool PartitionedRocksDBStore::open(
     const std::vector<std::string>& column_families,
     const rocksdb::ColumnFamilyOptions& meta_cf_options,
     const Configuration* /*config*/) {
+  auto open_start = std::chrono::steady_clock::now();
+
+  // RocksDB has to open all column families at once, so partitions can't be
+  // opened lazily. What we can do is keep old partitions, which are rarely
+  // read, from pinning index blocks of their files in memory.
+  auto is_partition_cf = [](const std::string& name) {
+    return name != rocksdb::kDefaultColumnFamilyName &&
+        name != METADATA_CF_NAME && name != UNPARTITIONED_CF_NAME &&
+        name != SNAPSHOTS_CF_NAME;
+  };
+  size_t old_partitions = 0;
+  rocksdb::ColumnFamilyOptions old_data_cf_options = data_cf_options_;
+  const size_t num_latest = getSettings()->cache_index_except_latest_partitions;
+  if (num_latest > 0 &&
+      !rocksdb_config_.table_options_.cache_index_and_filter_blocks) {
+    size_t num_partitions = std::count_if(
+        column_families.begin(), column_families.end(), is_partition_cf);
+    old_partitions = num_partitions - std::min(num_partitions, num_latest);
+    rocksdb::BlockBasedTableOptions table_options =
+        rocksdb_config_.table_options_;
+    table_options.cache_index_and_filter_blocks = true;
+    old_data_cf_options.table_factory.reset(
+        rocksdb::NewBlockBasedTableFactory(table_options));
+  }
+
   // build a list of CF descriptors
   std::vector<rocksdb::ColumnFamilyDescriptor> cf_descriptors;
   for (const auto& name : column_families) {
+    if (is_partition_cf(name)) {
+      // Column families are sorted by partition ID.
+      if (old_partitions > 0) {
+        cf_descriptors.emplace_back(name, old_data_cf_options);
+        --old_partitions;
+      } else {
+        cf_descriptors.emplace_back(name, data_cf_options_);
+      }
+      continue;
+    }
     cf_descriptors.emplace_back(
         name,
         name == METADATA_CF_NAME ? meta_cf_options
@@ -753,6 +844,24 @@ bool PartitionedRocksDBStore::open(
 
   // Read per-partition metadata. We'll need it below to decide if we need
   // to create more partitions.
+  auto metadata_read_start = std::chrono::steady_clock::now();
+  std::vector<Status> metadata_status;
+  if (latest_partition_id != PARTITION_INVALID) {
+    metadata_status =
+        readPartitionsMetadata(oldest_partition_id, latest_partition_id);
+  }
+  ld_info("Shard %u: opened DB with %lu column families in %.3fs, read "
+          "metadata of %lu partitions in %.3fs",
+          shard_idx_,
+          column_families.size(),
+          std::chrono::duration_cast<std::chrono::duration<double>>(
+              metadata_read_start - open_start)
+              .count(),
+          metadata_status.size(),
+          std::chrono::duration_cast<std::chrono::duration<double>>(
+              std::chrono::steady_clock::now() - metadata_read_start)
+              .count());
+
   rocksdb::WriteBatch partition_updates;
   for (partition_id_t id = oldest_partition_id; id <= latest_partition_id;
        ++id) {
@@ -762,7 +871,9 @@ bool PartitionedRocksDBStore::open(
       continue;
     }
 
-    if (!readPartitionTimestamps(partition)) {
+    const Status read_status = metadata_status[id - oldest_partition_id];
+    if (read_status != E::OK) {
+      err = read_status;
       if (err != E::NOTFOUND) {
         // readPartitionTimestamps() already printed an error message.
         return false;
@@ -808,9 +919,6 @@ bool PartitionedRocksDBStore::open(
         break;
       }
     }
-    if (!readPartitionDirtyState(partition)) {
-      return false;
-    }
 
     for (auto& ndd_kv : partition->dirty_state_.dirtied_by_nodes) {
       // Only persisting Appends for now.
@@ -820,8 +928,10 @@ bool PartitionedRocksDBStore::open(
 
       if (!ndd_kv.second.isClean()) {
         setUnderReplicated(partition);
-        auto dti =
-            partition->dirtyTimeInterval(*getSettings(), latest_partition_id);
+        // Only appends newer than min_unflushed_timestamp can have been
+        // lost. A dirty hold doesn't add any data to the partition.
+        auto dti = partition->unflushedTimeInterval(
+            *getSettings(), latest_partition_id);
         ld_info("Partition s%u:%lu found dirty: %s",
                 shard_idx_,
                 partition->id_,
@@ -1472,6 +1582,20 @@ bool PartitionedRocksDBStore::convertDataKeyFormat() {
   return true;
 }
 
+LocalLogStore::ReadOptions PartitionedRocksDBStore::getPartitionReadOptions(
+    const LocalLogStore::ReadOptions& options,
+    partition_id_t partition) const {
+  LocalLogStore::ReadOptions res = options;
+  const size_t latest_to_cache = getSettings()->fill_cache_latest_partitions;
+  if (res.fill_cache && latest_to_cache > 0 &&
+      partition + latest_to_cache <= latest_.get()->id_) {
+    // Readers this far behind scan through data that nobody else is going to
+    // read soon. Don't let them evict the tail readers' working set.
+    res.fill_cache = false;
+  }
+  return res;
+}
+
 bool PartitionedRocksDBStore::readDirectories() {
   const char key = PartitionDirectoryKey::HEADER;
   DirectoryEntry directory_entry;
@@ -1550,6 +1674,7 @@ bool PartitionedRocksDBStore::readDirectories() {
       return false;
     }
     log_state->directory.emplace(directory_entry.first_lsn, directory_entry);
+    log_state->approximate_size_bytes += directory_entry.approximate_size_bytes;
 
     // Update latest_partition
     latest_partition = directory_entry.id;
@@ -1561,6 +1686,56 @@ bool PartitionedRocksDBStore::readDirectories() {
   return true;
 }
 
+std::vector<Status>
+PartitionedRocksDBStore::readPartitionsMetadata(partition_id_t first,
+                                                partition_id_t last) {
+  ld_check_le(first, last);
+  std::vector<Status> status(last - first + 1, E::OK);
+
+  // Each partition's metadata is a handful of point lookups in the metadata
+  // column family. With thousands of partitions and a cold page cache these
+  // dominate the time it takes to open the shard, so spread them over a few
+  // threads. Partitions are independent, and nothing else accesses them yet.
+  auto read_range = [&](partition_id_t begin, partition_id_t end) {
+    for (partition_id_t id = begin; id < end; ++id) {
+      PartitionPtr partition = partitions_.get(id);
+      if (!partition) {
+        continue;
+      }
+      if (!readPartitionTimestamps(partition) ||
+          !readPartitionDirtyState(partition)) {
+        status[id - first] = err;
+      }
+    }
+  };
+
+  const size_t count = status.size();
+  const size_t nthreads = std::min<size_t>(
+      std::max(1, getSettings()->partition_metadata_read_threads),
+      // Not worth a thread for fewer partitions than this.
+      (count + 63) / 64);
+  if (nthreads <= 1) {
+    read_range(first, last + 1);
+    return status;
+  }
+
+  std::vector<std::thread> threads;
+  const size_t per_thread = (count + nthreads - 1) / nthreads;
+  for (size_t i = 0; i < nthreads; ++i) {
+    partition_id_t begin = first + i * per_thread;
+    partition_id_t end = std::min<partition_id_t>(begin + per_thread, last + 1);
+    threads.emplace_back([this, begin, end, &read_range] {
+      ThreadID::set(ThreadID::UTILITY,
+                    folly::sformat("ld:open-meta{}", shard_idx_));
+      read_range(begin, end);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
 bool PartitionedRocksDBStore::readPartitionTimestamps(PartitionPtr partition) {
   partition_id_t id = partition->id_;
 
@@ -1639,6 +1814,8 @@ bool PartitionedRocksDBStore::readPartitionDirtyState(PartitionPtr partition) {
   if (meta.isUnderReplicated()) {
     setUnderReplicated(partition);
   }
+  partition->dirty_state_.min_unflushed_timestamp =
+      meta.getMinUnflushedTimestamp();
 
   size_t dci = 0;
   for (const auto& dnv : meta.getAllDirtiedBy()) {
@@ -1844,6 +2021,7 @@ PartitionedRocksDBStore::getWritePartition(
 
     // Update data size
     current_partition->approximate_size_bytes += payload_size_bytes;
+    log_state->approximate_size_bytes += payload_size_bytes;
 
     // Unset PSEUDORECORDS_ONLY flag if we're writing the first real record to
     // the given partition for this log.
@@ -1888,6 +2066,7 @@ PartitionedRocksDBStore::getWritePartition(
     new_next_partition.first_lsn = lsn;
     // Update data size
     new_next_partition.approximate_size_bytes += payload_size_bytes;
+    log_state->approximate_size_bytes += payload_size_bytes;
     new_next_partition.doPut(
         log_id, Durability::ASYNC_WRITE, metadata_cf_->get(), durable_batch);
     STAT_INCR(stats_, logsdb_writes_dir_key_decrease);
@@ -1926,6 +2105,7 @@ PartitionedRocksDBStore::getWritePartition(
     // Add to in-memory directory metadata
     current_partition =
         &log_directory.emplace_hint(next_it, lsn, new_partition)->second;
+    log_state->approximate_size_bytes += payload_size_bytes;
     if (target_partition > max_used_partition) {
       // New latest partition, update LogState
       log_state->latest_partition.store(target_partition, lsn, lsn);
@@ -2260,6 +2440,20 @@ int PartitionedRocksDBStore::dataSize(logid_t log_id,
   }
   auto partitions = getPartitionList();
 
+  // If the range covers all partitions that have data for this log, which is
+  // the case when asking for the size of the entire log, every directory
+  // entry would be fully counted below. Use their sum instead of visiting
+  // them.
+  PartitionPtr first_partition =
+      partitions->get(log_directory.cbegin()->second.id);
+  ld_check(first_partition != nullptr);
+  if (first_partition->starting_timestamp >= lo_timestamp &&
+      hi_timestamp >= now) {
+    STAT_INCR(stats_, logsdb_data_size_whole_directory);
+    *out = log_state->approximate_size_bytes;
+    return 0;
+  }
+
   // Find the directory entry for the first partition which spans any
   // timestamps >= lo_timestamp -- that's our starting point.
   // Use lower_bound to binary search on LSN.
@@ -2425,7 +2619,8 @@ int PartitionedRocksDBStore::findKey(logid_t log_id,
 rocksdb::Status
 PartitionedRocksDBStore::writeBatch(const rocksdb::WriteOptions& options,
                                     rocksdb::WriteBatch* batch) {
-  SCOPED_IO_TRACING_CONTEXT(getIOTracing(), "write-batch");
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      getIOTracing(), IOTracing::Kind::WRITE, "write-batch");
   uint64_t batch_size = batch->GetDataSize();
   uint64_t total_bytes_written =
       bytes_written_since_flush_eval_.fetch_add(batch_size);
@@ -2639,7 +2834,8 @@ bool PartitionedRocksDBStore::shouldCreatePartition() {
 int PartitionedRocksDBStore::writeMulti(
     const std::vector<const WriteOp*>& writes_in,
     const WriteOptions& options) {
-  SCOPED_IO_TRACING_CONTEXT(getIOTracing(), "writeMulti");
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      getIOTracing(), IOTracing::Kind::WRITE, "writeMulti");
 
   ld_check(!getSettings()->read_only);
   ld_check(!immutable_.load());
@@ -2873,6 +3069,52 @@ int PartitionedRocksDBStore::writeMultiImpl(
     return true;
   };
 
+  // Verify checksums before attempting to actually write the records,
+  // so that a corrupt record does not affect log state or directory.
+  // Checksums of all records in the batch are computed together, which is
+  // cheaper than doing it one record at a time.
+  if (getSettings()->verify_checksum_during_store) {
+    std::vector<const PutWriteOp*> put_ops;
+    std::vector<Slice> headers;
+    std::vector<Slice> data;
+    put_ops.reserve(expected_batch_size);
+    headers.reserve(expected_batch_size);
+    data.reserve(expected_batch_size);
+    for (const auto write : writes_in) {
+      if (write->getType() != WriteType::PUT) {
+        continue;
+      }
+      const PutWriteOp* op = static_cast<const PutWriteOp*>(write);
+      if (skip_rebuilding && op->isRebuilding()) {
+        continue;
+      }
+      put_ops.push_back(op);
+      headers.push_back(op->record_header);
+      data.push_back(op->data);
+    }
+    size_t bad_idx;
+    int rv = LocalLogStoreRecordFormat::checkWellFormedBatch(
+        headers.data(), data.data(), headers.size(), &bad_idx);
+    if (rv != 0) {
+      // Reject to store malformed records.
+      const PutWriteOp* op = put_ops[bad_idx];
+      RATELIMIT_ERROR(
+          std::chrono::seconds(10),
+          10,
+          "checksum mismatch: refusing to write malformed record %lu%s. "
+          "Header: %s, data: %s",
+          op->log_id.val_,
+          lsn_to_string(op->lsn).c_str(),
+          hexdump_buf(op->record_header, 500).c_str(),
+          hexdump_buf(op->data, 500).c_str());
+      // Fail and send an error to sequencer. The record was corrupted
+      // or malformed by this or sequencer's node, likely due to bad
+      // hardware or bug.
+      err = E::CHECKSUM_MISMATCH;
+      return -1;
+    }
+  }
+
   ld_spew("------------- Write Batch Begin --------------");
   for (const auto write : writes_in) {
     // When testing, we may want to ignore rebuilding related writes.
@@ -2886,30 +3128,10 @@ int PartitionedRocksDBStore::writeMultiImpl(
 
     switch (write->getType()) {
       case WriteType::PUT:
-        // Verify checksums before attempting to actually write the records,
-        // so that a corrupt record does not affect log state or directory.
+        // Checksums were verified before the loop.
         if (getSettings()->verify_checksum_during_store) {
-          // Reject to store malformed records.
           const PutWriteOp* op = static_cast<const PutWriteOp*>(write);
-          int rv = LocalLogStoreRecordFormat::checkWellFormed(
-              op->record_header, op->data);
-          if (rv != 0) {
-            RATELIMIT_ERROR(
-                std::chrono::seconds(10),
-                10,
-                "checksum mismatch: refusing to write malformed record %lu%s. "
-                "Header: %s, data: %s",
-                op->log_id.val_,
-                lsn_to_string(op->lsn).c_str(),
-                hexdump_buf(op->record_header, 500).c_str(),
-                hexdump_buf(op->data, 500).c_str());
-            // Fail and send an error to sequencer. The record was corrupted
-            // or malformed by this or sequencer's node, likely due to bad
-            // hardware or bug.
-            flush_dir_updates();
-            err = E::CHECKSUM_MISMATCH;
-            return -1;
-          } else if (getSettings()->test_corrupt_stores) {
+          if (getSettings()->test_corrupt_stores) {
             RATELIMIT_INFO(std::chrono::seconds(60),
                            5,
                            "checksum mismatch: Pretending record %lu%s is "
@@ -3252,6 +3474,55 @@ int PartitionedRocksDBStore::writeMultiImpl(
       auto& dirty_state = cur_partition->dirty_state_;
       dirty_state.noteDirtied(flush_token, now);
 
+      // Appends more than partition_timestamp_granularity_ older than the
+      // partition's min_unflushed_timestamp have to lower it, and wait for
+      // the new value to be synced, before they can be acknowledged.
+      // Updating it requires a write lock.
+      bool lower_min_unflushed = false;
+      RecordTimestamp min_ts = op->timestamp;
+      if (op->data_class == DataClass::APPEND) {
+        for (auto next_op = op + 1;
+             next_op != dirty_ops.end() && op->canMergeWith(*next_op);
+             ++next_op) {
+          min_ts = std::min(min_ts, next_op->timestamp);
+        }
+        dirty_state.noteAppendsWritten(flush_token, min_ts);
+        RecordTimestamp min_unflushed = dirty_state.min_unflushed_timestamp;
+        lower_min_unflushed = min_unflushed != RecordTimestamp::min() &&
+            min_ts < min_unflushed -
+                std::min(min_unflushed.time_since_epoch(),
+                         getSettings()->partition_timestamp_granularity_);
+      }
+      if (lower_min_unflushed &&
+          (dirtied_partitions.empty() ||
+           cur_partition->id_ != dirtied_partitions.back().first->id_)) {
+        // Upgrade to write lock.
+        cf_lock.unlock();
+        folly::SharedMutex::WriteHolder partition_lock(op->partition->mutex_);
+        if (op->partition->is_dropped) {
+          // Trimmed away. See the similar case below.
+          cf_lock = folly::SharedMutex::ReadHolder(std::move(partition_lock));
+          auto next_op = op;
+          while (++next_op != dirty_ops.end() &&
+                 next_op->partition->is_dropped) {
+            op = next_op;
+          }
+          continue;
+        }
+        dirtied_partitions.emplace_back(
+            op->partition, std::move(partition_lock));
+      }
+      if (lower_min_unflushed) {
+        dirty_state.min_unflushed_timestamp.storeMin(min_ts);
+        op->lowered_min_unflushed_timestamp = true;
+        STAT_INCR(stats_, partition_min_unflushed_timestamp_lowered);
+        ld_spew("Partition s%u:%ld min unflushed timestamp lowered to %s",
+                getShardIdx(),
+                op->partition->id_,
+                logdevice::toString(dirty_state.min_unflushed_timestamp)
+                    .c_str());
+      }
+
       // To simplify some logic, use the result type from emplace() to
       // track lookup/update/emplace operations on the node dirty data.
       DirtiedByKey key(op->node_idx, op->data_class);
@@ -3303,10 +3574,9 @@ int PartitionedRocksDBStore::writeMultiImpl(
                     toString(op->data_class).c_str());
           }
         } else {
-          // A previous iteration of this loop locked and dirtied this
-          // partition. It should not be clean.
+          // A previous iteration of this loop locked this partition, either
+          // to dirty it or to lower its min_unflushed_timestamp.
           clean_partition = dirty_state.dirtied_by_nodes.empty();
-          ld_check(!clean_partition);
 
           result = dirty_state.dirtied_by_nodes.emplace(
               std::piecewise_construct,
@@ -3363,6 +3633,11 @@ int PartitionedRocksDBStore::writeMultiImpl(
           ld_check(false);
           break;
       }
+      if (lower_min_unflushed) {
+        // Unconditional sync and wait.
+        min_durability = Durability::SYNC_WRITE;
+        min_sync_token = FlushToken_INVALID;
+      }
 
       bool wait_for_timestamp_update = !boost::icl::contains(
           op->partition->dirtyTimeInterval(*getSettings(), latest_.get()->id_),
@@ -3421,6 +3696,13 @@ int PartitionedRocksDBStore::writeMultiImpl(
               ndd_kv->second.markSyncingUntil(wal_token);
             }
           }
+          if (op.lowered_min_unflushed_timestamp) {
+            // Appends that rely on the lowered min_unflushed_timestamp must
+            // wait for it to be synced.
+            atomic_fetch_max(
+                op.partition->dirty_state_.append_dirtied_wal_token,
+                wal_token);
+          }
         }
       }
     }
@@ -3793,6 +4075,25 @@ void PartitionedRocksDBStore::updatePartitionDirtyState(
         ++kv;
       }
     }
+    // Appends in the flushed memtables are durable now. Raise
+    // min_unflushed_timestamp to the oldest append that may still be
+    // unflushed, but not above the (approximate) newest record in the
+    // partition, so that appends keep finding it already low enough.
+    RecordTimestamp min_unflushed =
+        dirty_state.noteAppendsFlushed(flushed_up_through);
+    RecordTimestamp max_ts = partition->max_timestamp;
+    if (max_ts != RecordTimestamp::min()) {
+      min_unflushed = std::min(
+          min_unflushed,
+          max_ts -
+              std::min(max_ts.time_since_epoch(), // avoiding overflow
+                       getSettings()->partition_timestamp_granularity_));
+      if (min_unflushed > dirty_state.min_unflushed_timestamp) {
+        dirty_state.min_unflushed_timestamp = min_unflushed;
+        update_partition_dirty_state = true;
+      }
+    }
+
     if (nodes.empty()) {
       update_partition_dirty_state = true;
       ld_debug("FUT(%ju): Partition s%u:%lu clean",
@@ -4225,6 +4526,94 @@ void PartitionedRocksDBStore::getPartitionsForProactiveCompaction(
   }
 }
 
+void PartitionedRocksDBStore::getPartitionsForColdStorageCompaction(
+    std::vector<PartitionToCompact>* out_to_compact) {
+  ld_check(out_to_compact);
+  const bool cold_compression_enabled =
+      getSettings()->cold_compression != rocksdb::kDisableCompressionOption;
+  if (cold_storage_path_.empty() && !cold_compression_enabled) {
+    return;
+  }
+
+  auto partitions = getPartitionList();
+  const RecordTimestamp now(currentTime());
+  for (PartitionPtr partition : *partitions) {
+    const RecordTimestamp cold_since = getColdSince(partition);
+    if (cold_since > now) {
+      // Partitions are sorted by time, the rest are even newer.
+      break;
+    }
+    // If the partition was fully compacted since it became cold, the
+    // compaction used cold compression. Partial compactions of late writes
+    // don't update last_compaction_time but use cold compression too.
+    bool needs_compaction = cold_compression_enabled &&
+        partition->last_compaction_time.load() < cold_since;
+    if (!needs_compaction && !cold_storage_path_.empty()) {
+      rocksdb::ColumnFamilyMetaData cf_meta;
+      db_->GetColumnFamilyMetaData(partition->cf_->get(), &cf_meta);
+      for (const auto& level : cf_meta.levels) {
+        for (const auto& file : level.files) {
+          needs_compaction |= file.db_path != cold_storage_path_;
+        }
+      }
+    }
+    if (needs_compaction) {
+      out_to_compact->emplace_back(
+          partition, PartitionToCompact::Reason::COLD_STORAGE);
+    }
+  }
+}
+
+RecordTimestamp
+PartitionedRocksDBStore::getColdSince(const PartitionPtr& partition) {
+  PartitionPtr next_partition;
+  if (partition->id_ >= latest_.get()->id_ ||
+      !getPartition(partition->id_ + 1, &next_partition)) {
+    return RecordTimestamp::max();
+  }
+  // The next partition's starting timestamp approximates the maximum
+  // timestamp of records in this partition.
+  return next_partition->starting_timestamp + getSettings()->cold_storage_age;
+}
+
+bool PartitionedRocksDBStore::isColdPartition(const PartitionPtr& partition) {
+  return getColdSince(partition) <= RecordTimestamp(currentTime());
+}
+
+rocksdb::CompressionType PartitionedRocksDBStore::getCompactionCompression(
+    const PartitionPtr& partition) {
+  const rocksdb::CompressionType cold_compression =
+      getSettings()->cold_compression;
+  if (cold_compression != rocksdb::kDisableCompressionOption &&
+      isColdPartition(partition)) {
+    return cold_compression;
+  }
+  return rocksdb_config_.options_.compression;
+}
+
+rocksdb::Status
+PartitionedRocksDBStore::setPartitionCompression(const PartitionPtr& partition,
+                                                 rocksdb::CompressionType type) {
+  rocksdb::ColumnFamilyDescriptor descriptor;
+  rocksdb::Status status = partition->cf_->get()->GetDescriptor(&descriptor);
+  if (!status.ok() || descriptor.options.compression == type) {
+    return status;
+  }
+  std::string type_str;
+  if (!rocksdb::GetStringFromCompressionType(&type_str, type)) {
+    return rocksdb::Status::InvalidArgument("unknown compression type");
+  }
+  return db_->SetOptions(partition->cf_->get(), {{"compression", type_str}});
+}
+
+int PartitionedRocksDBStore::getCompactionOutputPathId(
+    const PartitionPtr& partition) {
+  if (cold_storage_path_.empty()) {
+    return -1;
+  }
+  return isColdPartition(partition) ? 1 : 0;
+}
+
 bool PartitionedRocksDBStore::getPartitionsForManualCompaction(
     std::vector<PartitionToCompact>* out_to_compact,
     size_t count,
@@ -4241,6 +4630,8 @@ bool PartitionedRocksDBStore::getPartitionsForManualCompaction(
     if (partition) {
       out_to_compact->emplace_back(
           partition, PartitionToCompact::Reason::MANUAL);
+      out_to_compact->back().rate_limit =
+          manual_compaction_index_.at(partition_id).rate_limit;
       --count;
     }
     ++it;
@@ -4250,7 +4641,8 @@ bool PartitionedRocksDBStore::getPartitionsForManualCompaction(
 
 void PartitionedRocksDBStore::scheduleManualCompaction(
     partition_id_t partition_id,
-    bool hi_pri) {
+    bool hi_pri,
+    folly::Optional<rate_limit_t> rate_limit) {
   ld_check_ne(partition_id, PARTITION_INVALID);
   std::lock_guard<std::mutex> lock(manual_compaction_mutex_);
   // cancelling any other manual compactions for this partition if they are
@@ -4259,8 +4651,8 @@ void PartitionedRocksDBStore::scheduleManualCompaction(
   auto& target_list =
       hi_pri ? hi_pri_manual_compactions_ : lo_pri_manual_compactions_;
   auto list_it = target_list.insert(target_list.end(), partition_id);
-  auto insert_res =
-      manual_compaction_index_.insert({partition_id, {hi_pri, list_it}});
+  auto insert_res = manual_compaction_index_.insert(
+      {partition_id, ManualCompactionInfo{hi_pri, list_it, rate_limit}});
   // there should be no other elements with this key, so the insert should've
   // been successful
   ld_check(insert_res.second);
@@ -4278,8 +4670,8 @@ void PartitionedRocksDBStore::cancelManualCompactionImpl(
   }
   auto index_it = manual_compaction_index_.find(partition_id);
   if (index_it != manual_compaction_index_.end()) {
-    bool hi_pri = index_it->second.first;
-    auto& list_iterator = index_it->second.second;
+    bool hi_pri = index_it->second.hi_pri;
+    auto& list_iterator = index_it->second.list_it;
     auto& target_list =
         hi_pri ? hi_pri_manual_compactions_ : lo_pri_manual_compactions_;
     target_list.erase(list_iterator);
@@ -4307,6 +4699,51 @@ PartitionedRocksDBStore::getManualCompactionList() {
   return res;
 }
 
+std::shared_ptr<void>
+PartitionedRocksDBStore::startCompaction(CompactionContext* context,
+                                         partition_id_t partition_id) {
+  struct Holder {
+    explicit Holder(PartitionedRocksDBStore& owner) : owner(owner) {}
+    ~Holder() {
+      // Runs before compaction_lock is released, so the next compaction
+      // can't register before this one is unregistered.
+      std::lock_guard<std::mutex> lock(owner.running_compaction_mutex_);
+      owner.running_compaction_context_ = nullptr;
+      owner.running_compaction_partition_ = PARTITION_INVALID;
+    }
+
+    PartitionedRocksDBStore& owner;
+    std::shared_ptr<void> compaction_lock;
+  };
+
+  auto factory = checked_downcast<RocksDBCompactionFilterFactory*>(
+      rocksdb_config_.options_.compaction_filter_factory.get());
+  auto res = std::make_shared<Holder>(*this);
+  // This will wait for other compactions to finish.
+  res->compaction_lock = factory->startUsingContext(context);
+  std::lock_guard<std::mutex> lock(running_compaction_mutex_);
+  running_compaction_context_ = context;
+  running_compaction_partition_ = partition_id;
+  running_compaction_start_time_ = currentSteadyTime();
+  return res;
+}
+
+folly::Optional<PartitionedRocksDBStore::RunningCompaction>
+PartitionedRocksDBStore::getRunningCompaction() {
+  std::lock_guard<std::mutex> lock(running_compaction_mutex_);
+  if (running_compaction_context_ == nullptr) {
+    return folly::none;
+  }
+  RunningCompaction res;
+  res.partition_id = running_compaction_partition_;
+  res.reason = running_compaction_context_->reason;
+  res.rate_limit = running_compaction_context_->rate_limit;
+  res.bytes_filtered = running_compaction_context_->bytes_filtered.load(
+      std::memory_order_relaxed);
+  res.start_time = running_compaction_start_time_;
+  return res;
+}
+
 folly::Optional<std::chrono::seconds>
 PartitionedRocksDBStore::getEffectiveBacklogDuration(
     logid_t log_id,
@@ -4600,6 +5037,8 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
   }
 
   if (out_to_compact != nullptr) {
+    const double min_reclaim_ratio =
+        settings->partition_compaction_min_reclaim_ratio;
     for (auto& it : backlog_durations) {
       // Advise compacting those partitions for which all records for logs with
       // this backlog duration have been marked as trimmed.
@@ -4607,7 +5046,10 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
            it.second.partitions_with_trimmed_records) {
         ld_check_lt(partition, it.second.oldest_non_trimmed);
         if (partition >= oldest_to_keep &&
-            partitions->get(partition)->compacted_retention.load() < it.first) {
+            partitions->get(partition)->compacted_retention.load() < it.first &&
+            (min_reclaim_ratio <= 0 ||
+             getRetentionReclaimRatio(partitions->get(partition), it.first) >=
+                 min_reclaim_ratio)) {
           out_to_compact->emplace_back(partitions->get(partition), it.first);
         }
       }
@@ -4750,16 +5192,14 @@ void PartitionedRocksDBStore::performCompactionInternal(
       return;
     }
   } else {
-    auto factory = checked_downcast<RocksDBCompactionFilterFactory*>(
-        rocksdb_config_.options_.compaction_filter_factory.get());
-
     CompactionContext context;
     context.reason = to_compact.reason;
+    context.rate_limit = to_compact.rate_limit;
     rocksdb::Status status;
 
     {
       // This will wait for other compactions to finish.
-      auto compaction_lock = factory->startUsingContext(&context);
+      auto compaction_lock = startCompaction(&context, partition_id);
 
       if (shutdown_event_.signaled()) {
         return;
@@ -4769,22 +5209,32 @@ void PartitionedRocksDBStore::performCompactionInternal(
         SCOPED_IO_TRACING_CONTEXT(
             getIOTracing(), "part-compact|cf:{}", partition->id_);
         rocksdb::CompactionOptions options;
-        options.compression = rocksdb_config_.options_.compression;
+        options.compression = getCompactionCompression(partition);
 
         status = db_->CompactFiles(options,
                                    partition->cf_->get(),
                                    to_compact.partial_compaction_filenames,
-                                   0 /* L0 */);
+                                   0 /* L0 */,
+                                   getCompactionOutputPathId(partition));
       } else {
         // This context currently doesn't do anything because full compactions
         // run on background threads. But let's keep it in case this changes.
         SCOPED_IO_TRACING_CONTEXT(
             getIOTracing(), "full-compact|cf:{}", partition->id_);
 
-        status = db_->CompactRange(rocksdb::CompactRangeOptions(),
-                                   partition->cf_->get(),
-                                   nullptr,
-                                   nullptr);
+        rocksdb::CompactRangeOptions options;
+        int path_id = getCompactionOutputPathId(partition);
+        if (path_id >= 0) {
+          options.target_path_id = path_id;
+        }
+        // Unlike CompactFiles(), CompactRange() takes compression type from
+        // column family options.
+        status = setPartitionCompression(
+            partition, getCompactionCompression(partition));
+        if (status.ok()) {
+          status = db_->CompactRange(
+              options, partition->cf_->get(), nullptr, nullptr);
+        }
       }
     }
 
@@ -4825,6 +5275,8 @@ void PartitionedRocksDBStore::performCompactionInternal(
 
   if (to_compact.reason == PartitionToCompact::Reason::PROACTIVE) {
     STAT_INCR(stats_, partition_proactive_compactions);
+  } else if (to_compact.reason == PartitionToCompact::Reason::COLD_STORAGE) {
+    STAT_INCR(stats_, partition_cold_storage_compactions);
   } else if (to_compact.reason == PartitionToCompact::Reason::MANUAL) {
     STAT_INCR(stats_, partition_manual_compactions);
   } else if (to_compact.reason == PartitionToCompact::Reason::PARTIAL) {
@@ -4957,27 +5409,27 @@ bool PartitionedRocksDBStore::performStronglyFilteredCompactionInternal(
           compaction_context.logs_to_keep->size(),
           logs_seen);
 
-  auto filter_factory = dynamic_cast<RocksDBCompactionFilterFactory*>(
-      rocksdb_config_.options_.compaction_filter_factory.get());
-  ld_check(filter_factory);
   rocksdb::Status status;
 
   {
     // This will wait for other compactions to finish.
     auto compaction_lock =
-        filter_factory->startUsingContext(&compaction_context);
+        startCompaction(&compaction_context, partition->id_);
 
     if (shutdown_event_.signaled()) {
       return false;
     }
 
     rocksdb::CompactionOptions options;
-    options.compression = rocksdb_config_.options_.compression;
+    options.compression = getCompactionCompression(partition);
 
     SCOPED_IO_TRACING_CONTEXT(
         getIOTracing(), "filter-compact|cf:{}", partition->id_);
-    status = db_->CompactFiles(
-        options, partition->cf_->get(), files_to_compact, 0 /* L0 */);
+    status = db_->CompactFiles(options,
+                               partition->cf_->get(),
+                               files_to_compact,
+                               0 /* L0 */,
+                               getCompactionOutputPathId(partition));
   }
 
   if (!status.ok()) {
@@ -5194,6 +5646,10 @@ void PartitionedRocksDBStore::cleanUpDirectory(
         // Delete the directory entry.
         batch.Delete(metadata_cf_->get(), it.key());
         // From in-memory directory as well
+        ld_check_ge(log_state->approximate_size_bytes,
+                    in_memory_directory_it->second.approximate_size_bytes);
+        log_state->approximate_size_bytes -=
+            in_memory_directory_it->second.approximate_size_bytes;
         in_memory_directory_it =
             log_state->directory.erase(in_memory_directory_it);
 
@@ -5555,25 +6011,10 @@ uint64_t PartitionedRocksDBStore::getApproximateObsoleteBytes(
     return 0;
   }
 
-  // RocksDBTablePropertiesCollector collects total size of data for each
-  // backlog duration for each table file flushed/compacted. Here we get
-  // properties of all table files of this partition and see how much data
-  // is older than its retention.
-
-  rocksdb::TablePropertiesCollection props;
-  rocksdb::Status status =
-      db_->GetPropertiesOfAllTables(partition->cf_->get(), &props);
-  if (!status.ok()) {
-    ld_warning("Failed to get properties of sst files in partition %lu: %s",
-               partition_id,
-               status.ToString().c_str());
-    enterFailSafeIfFailed(status, "GetPropertiesOfAllTables()");
-    return 0;
-  }
+  // Here we see how much data in this partition is older than its retention.
   RocksDBTablePropertiesCollector::RetentionSizeMap retention_sizes;
-  for (const auto& it : props) {
-    RocksDBTablePropertiesCollector::extractRetentionSizeMap(
-        it.second->user_collected_properties, retention_sizes);
+  if (!getRetentionSizes(partition, &retention_sizes)) {
+    return 0;
   }
 
   // Approximate minimum age of records in partition.
@@ -5592,6 +6033,50 @@ uint64_t PartitionedRocksDBStore::getApproximateObsoleteBytes(
   return res;
 }
 
+bool PartitionedRocksDBStore::getRetentionSizes(
+    const PartitionPtr& partition,
+    std::map<std::chrono::seconds, uint64_t>* out) {
+  // RocksDBTablePropertiesCollector collects total size of data for each
+  // backlog duration for each table file flushed/compacted. Here we sum them
+  // over all table files of the partition.
+  rocksdb::TablePropertiesCollection props;
+  rocksdb::Status status =
+      db_->GetPropertiesOfAllTables(partition->cf_->get(), &props);
+  if (!status.ok()) {
+    ld_warning("Failed to get properties of sst files in partition %lu: %s",
+               partition->id_,
+               status.ToString().c_str());
+    enterFailSafeIfFailed(status, "GetPropertiesOfAllTables()");
+    return false;
+  }
+  for (const auto& it : props) {
+    RocksDBTablePropertiesCollector::extractRetentionSizeMap(
+        it.second->user_collected_properties, *out);
+  }
+  return true;
+}
+
+double
+PartitionedRocksDBStore::getRetentionReclaimRatio(const PartitionPtr& partition,
+                                                  std::chrono::seconds backlog) {
+  RocksDBTablePropertiesCollector::RetentionSizeMap retention_sizes;
+  if (!getRetentionSizes(partition, &retention_sizes)) {
+    // Don't hold back compaction because of an error.
+    return 1;
+  }
+  uint64_t total = 0;
+  uint64_t reclaimable = 0;
+  for (const auto& it : retention_sizes) {
+    total += it.second;
+    if (it.first <= backlog) {
+      reclaimable += it.second;
+    }
+  }
+  // A partition without size information, e.g. written before the properties
+  // collector existed, is compacted as usual.
+  return total == 0 ? 1 : (double)reclaimable / total;
+}
+
 int PartitionedRocksDBStore::isEmpty() const {
   int res = isCFEmpty(unpartitioned_cf_->get());
   if (res != 1) {
@@ -6013,6 +6498,19 @@ PartitionedRocksDBStore::subclassSuggestedThrottleState() {
       : WriteThrottleState::NONE;
 }
 
+double PartitionedRocksDBStore::subclassSuggestedWriteDelayFraction() {
+  const double start_percent = getSettings()->write_delay_start_percent;
+  const double trigger =
+      getSettings()->partition_partial_compaction_stall_trigger_;
+  const double start = trigger * start_percent / 100;
+  const double pending = num_pending_partial_compactions_.load();
+  if (start_percent <= 0 || trigger == 0 || start >= trigger ||
+      pending <= start) {
+    return 0;
+  }
+  return (pending - start) / (trigger - start);
+}
+
 void PartitionedRocksDBStore::hiPriBackgroundThreadRun() {
   ld_check(!getSettings()->read_only);
   setBGThreadName("hi", shard_idx_);
@@ -6158,6 +6656,7 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
     bool need_stall = max_pending_partial_compactions != 0 &&
         partial_compactions.size() >= max_pending_partial_compactions;
     bool needed_stall = too_many_partial_compactions_.load();
+    num_pending_partial_compactions_.store(partial_compactions.size());
     if (need_stall != needed_stall) {
       too_many_partial_compactions_.store(need_stall);
       if (!need_stall) {
@@ -6195,6 +6694,7 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
               std::back_inserter(to_compact));
 
     getPartitionsForProactiveCompaction(&to_compact);
+    getPartitionsForColdStorageCompaction(&to_compact);
 
     // We only get lo-pri manual compactions if there are no other compactions
     // pending. But, we skip the delay if there are pending lo-pri manual
@@ -6533,11 +7033,12 @@ void EnumMap<PartitionedRocksDBStore::PartitionToCompact::Reason,
   using Reason = PartitionedRocksDBStore::PartitionToCompact::Reason;
   set(Reason::INVALID, "INVALID");
   set(Reason::PARTIAL, "PARTIAL");
+  set(Reason::COLD_STORAGE, "COLD_STORAGE");
   set(Reason::RETENTION, "RETENTION");
   set(Reason::PROACTIVE, "PROACTIVE");
   set(Reason::MANUAL, "MANUAL");
   static_assert(
-      (size_t)Reason::MAX == 5,
+      (size_t)Reason::MAX == 6,
       "Added more values to the enum? Add them above and update this assert.");
 }
 
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <deque>
 #include <limits>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -63,6 +64,7 @@ namespace facebook { namespace logdevice {
  *        always visit one partition at a time.
  */
 
+struct CompactionContext;
 class ServerProcessor;
 
 class PartitionedRocksDBStore : public RocksDBLogStoreBase {
@@ -105,7 +107,11 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
               src.append_dirtied_wal_token.load(std::memory_order_relaxed)),
           latest_dirty_time(src.latest_dirty_time.timePoint()),
           oldest_dirty_time(src.oldest_dirty_time.timePoint()),
-          under_replicated(false) {}
+          under_replicated(false),
+          min_unflushed_timestamp(src.min_unflushed_timestamp.timePoint()) {
+      std::lock_guard<std::mutex> lock(src.unflushed_timestamps_mutex);
+      unflushed_timestamps = src.unflushed_timestamps;
+    }
 
     const DirtyState& operator=(const DirtyState& rhs) {
       dirtied_by_nodes = rhs.dirtied_by_nodes;
@@ -116,6 +122,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
       latest_dirty_time = rhs.latest_dirty_time.timePoint();
       oldest_dirty_time = rhs.oldest_dirty_time.timePoint();
       under_replicated.store(false, std::memory_order_relaxed);
+      min_unflushed_timestamp = rhs.min_unflushed_timestamp.timePoint();
+      std::lock_guard<std::mutex> lock(rhs.unflushed_timestamps_mutex);
+      unflushed_timestamps = rhs.unflushed_timestamps;
       return *this;
     }
 
@@ -169,9 +178,36 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
       return data_retired;
     }
 
+    // Records that appends with timestamps of at least min_ts were written
+    // to the memtable with the given flush token.
+    void noteAppendsWritten(FlushToken token, RecordTimestamp min_ts) {
+      std::lock_guard<std::mutex> lock(unflushed_timestamps_mutex);
+      auto res = unflushed_timestamps.emplace(token, min_ts);
+      if (!res.second && min_ts < res.first->second) {
+        res.first->second = min_ts;
+      }
+    }
+
+    // Forgets memtables flushed up through flushed_up_through.
+    // @return  the smallest timestamp of appends that may still be in
+    //          memtables, or RecordTimestamp::max() if there are none.
+    RecordTimestamp noteAppendsFlushed(FlushToken flushed_up_through) {
+      std::lock_guard<std::mutex> lock(unflushed_timestamps_mutex);
+      unflushed_timestamps.erase(
+          unflushed_timestamps.begin(),
+          unflushed_timestamps.upper_bound(flushed_up_through));
+      RecordTimestamp min_ts = RecordTimestamp::max();
+      for (const auto& kv : unflushed_timestamps) {
+        min_ts = std::min(min_ts, kv.second);
+      }
+      return min_ts;
+    }
+
     PartitionDirtyMetadata metadata() const {
       return PartitionDirtyMetadata(
-          dirtied_by_nodes, under_replicated.load(std::memory_order_relaxed));
+          dirtied_by_nodes,
+          under_replicated.load(std::memory_order_relaxed),
+          min_unflushed_timestamp);
     }
 
     // Key used for the special DirtiedByMap entry signifying that a
@@ -226,6 +262,24 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     // Report that this partition has lost records that have not yet been
     // restored by rebuilding.
     std::atomic<bool> under_replicated{false};
+
+    // Append records that may not have been flushed from memtables yet
+    // have timestamps of at least min_unflushed_timestamp minus
+    // partition_timestamp_granularity_. Persisted as part of
+    // PartitionDirtyMetadata, so that after a crash only appends newer than
+    // that need to be rebuilt, rather than the whole partition (see
+    // Partition::unflushedTimeInterval()). RecordTimestamp::min() if unknown.
+    //
+    // Lowered by the write path with the partition's mutex_ held in write
+    // mode; the lowering append is made to wait for the updated metadata to
+    // be synced. Raised, without syncing, as memtables are flushed: losing
+    // the raised value only makes the bound more conservative.
+    AtomicRecordTimestamp min_unflushed_timestamp{RecordTimestamp::min()};
+
+    // Smallest timestamp of appends in each unflushed memtable, keyed by the
+    // memtable's flush token. Used to raise min_unflushed_timestamp.
+    std::map<FlushToken, RecordTimestamp> unflushed_timestamps;
+    mutable std::mutex unflushed_timestamps_mutex;
   };
 
   struct Partition;
@@ -326,6 +380,13 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     // partitions.
     RecordTimeInterval dirtyTimeInterval(const RocksDBSettings& settings,
                                          partition_id_t latest_id) const;
+
+    // Same as dirtyTimeInterval(), but not starting earlier than
+    // dirty_state_.min_unflushed_timestamp (padded by
+    // partition_timestamp_granularity_). This is the range of appends that
+    // may have been lost if the partition was dirty when we crashed.
+    RecordTimeInterval unflushedTimeInterval(const RocksDBSettings& settings,
+                                             partition_id_t latest_id) const;
   };
 
   struct DirectoryEntry {
@@ -391,6 +452,7 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     node_index_t node_idx;
     DataClass data_class;
     bool newly_dirtied = false;
+    bool lowered_min_unflushed_timestamp = false;
   };
 
   // @param config is only guaranteed to be alive during the call,
@@ -623,6 +685,19 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // trimming into account.
   uint64_t getApproximateObsoleteBytes(partition_id_t partition_id);
 
+  // Adds the total size of records in the partition for each backlog
+  // duration, as collected by RocksDBTablePropertiesCollector, to *out.
+  // Returns false if table properties couldn't be read.
+  bool getRetentionSizes(const PartitionPtr& partition,
+                         std::map<std::chrono::seconds, uint64_t>* out);
+
+  // Share of the partition's data that a compaction would remove once all
+  // logs with backlog duration up to `backlog` are trimmed from it, based on
+  // getRetentionSizes(). Used to leave partitions that are mostly long-lived
+  // data alone until they can be dropped, rather than rewriting them.
+  double getRetentionReclaimRatio(const PartitionPtr& partition,
+                                  std::chrono::seconds backlog);
+
   // Returns rocksdb handle of metadata column family.
   rocksdb::ColumnFamilyHandle* getMetadataCFHandle() const override {
     return metadata_cf_->get();
@@ -757,8 +832,13 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // other compactions. Otherwise, lo-pri compactions will only be scheduled
   // when there are no other compactions taking place. If there already is a
   // manual compaction pending for the specified partition_id, removes it from
-  // the list before adding the new one.
-  void scheduleManualCompaction(partition_id_t partition_id, bool hi_pri);
+  // the list before adding the new one. If rate_limit has a value, the
+  // compaction filter is throttled to it instead of
+  // RocksDBSettings::compaction_rate_limit_.
+  void scheduleManualCompaction(
+      partition_id_t partition_id,
+      bool hi_pri,
+      folly::Optional<rate_limit_t> rate_limit = folly::none);
 
   // Cancels a manual compaction. If partition_id == 0, cancels all compactions
   // on the shard.
@@ -790,6 +870,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     enum class Reason {
       INVALID = 0,
       PARTIAL, // this is first, for lowest priority when deduplicating
+      // Moves the partition to RocksDBSettings::cold_storage_path. Any other
+      // full compaction of the partition would do that too.
+      COLD_STORAGE,
       RETENTION,
       PROACTIVE,
       MANUAL,
@@ -809,6 +892,10 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     std::vector<std::string> partial_compaction_filenames;
     std::vector<uint64_t> partial_compaction_file_sizes;
 
+    // If reason == MANUAL, the rate limit the compaction was requested with,
+    // if any.
+    folly::Optional<rate_limit_t> rate_limit;
+
     PartitionToCompact(PartitionPtr p, Reason r)
         : partition(std::move(p)), reason(r) {
       ld_check(reason != Reason::RETENTION);
@@ -920,6 +1007,21 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     size_t sort_order;
   };
 
+  // Compaction going through the compaction filter (i.e. not a partition
+  // drop) that is running on this shard.
+  struct RunningCompaction {
+    partition_id_t partition_id;
+    PartitionToCompact::Reason reason;
+    folly::Optional<rate_limit_t> rate_limit;
+    // Bytes of keys and values filtered so far.
+    uint64_t bytes_filtered;
+    SteadyTimestamp start_time;
+  };
+
+  // There's at most one such compaction at a time, see
+  // RocksDBCompactionFilterFactory::startUsingContext().
+  folly::Optional<RunningCompaction> getRunningCompaction();
+
   class PartialCompactionEvaluator {
    public:
     class Deps {
@@ -1158,6 +1260,7 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   }
 
   WriteThrottleState subclassSuggestedThrottleState() override;
+  double subclassSuggestedWriteDelayFraction() override;
 
   void markImmutable() override {
     joinBackgroundThreads();
@@ -1230,6 +1333,11 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
     // Information about partitions used by this log, keyed by their first_lsn
     std::map<lsn_t, DirectoryEntry> directory;
+
+    // Sum of approximate_size_bytes of all entries in directory. Lets
+    // dataSize() answer for time ranges covering the whole directory, such as
+    // the size of the entire log, without visiting every entry.
+    size_t approximate_size_bytes = 0;
   };
 
   using LogStateMap = folly::ConcurrentHashMap<logid_t::raw_type,
@@ -1296,9 +1404,24 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
                                  logid_t log,
                                  lsn_t lsn);
 
+  // Read options for a data iterator in the given partition: `options` with
+  // fill_cache turned off if the partition isn't among the
+  // RocksDBSettings::fill_cache_latest_partitions latest ones.
+  LocalLogStore::ReadOptions
+  getPartitionReadOptions(const LocalLogStore::ReadOptions& options,
+                          partition_id_t partition) const;
+
   // Called by the constructor. Populates directory in LogState for each log.
   bool readDirectories();
 
+  // Called by the constructor.
+  // Reads timestamps and dirty metadata of partitions [first, last] using up to
+  // RocksDBSettings::partition_metadata_read_threads threads. Returns the
+  // status for each partition: E::OK, or the err set by
+  // readPartitionTimestamps() or readPartitionDirtyState().
+  std::vector<Status> readPartitionsMetadata(partition_id_t first,
+                                             partition_id_t last);
+
   // Called by the constructor.
   // Reads timestamps metadata for the given partition.
   bool readPartitionTimestamps(PartitionPtr partition);
@@ -1506,6 +1629,39 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   void getPartitionsForProactiveCompaction(
       std::vector<PartitionToCompact>* out_to_compact);
 
+  // Gets partitions that should be in cold storage but still have sst files
+  // in the primary path, or should be recompressed with
+  // RocksDBSettings::cold_compression but weren't compacted since they became
+  // cold.
+  void getPartitionsForColdStorageCompaction(
+      std::vector<PartitionToCompact>* out_to_compact);
+
+  // When all data in the partition will be older than
+  // RocksDBSettings::cold_storage_age. RecordTimestamp::max() for the latest
+  // partition.
+  RecordTimestamp getColdSince(const PartitionPtr& partition);
+
+  // Whether all data in the partition is older than
+  // RocksDBSettings::cold_storage_age.
+  bool isColdPartition(const PartitionPtr& partition);
+
+  // Compression that compactions of this partition should use:
+  // RocksDBSettings::cold_compression for cold partitions if it's set,
+  // the usual compression otherwise.
+  rocksdb::CompressionType
+  getCompactionCompression(const PartitionPtr& partition);
+
+  // Changes the compression type in options of partition's column family,
+  // if needed, for the next flush or CompactRange().
+  rocksdb::Status setPartitionCompression(const PartitionPtr& partition,
+                                          rocksdb::CompressionType type);
+
+  // Index in data_cf_options_.cf_paths that compactions of this partition
+  // should write to: 1 (cold storage path) for cold partitions, 0 (shard's
+  // primary path) for others, or -1 if cold storage is disabled and there's
+  // only one path to choose from. Flushes always write to the primary path.
+  int getCompactionOutputPathId(const PartitionPtr& partition);
+
   // Gets partitions for partial compaction. Returns true if there are more
   // partial compactions to be done than the results added
   bool getPartitionsForPartialCompaction(
@@ -1705,6 +1861,10 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // Options used for data partitions
   rocksdb::ColumnFamilyOptions data_cf_options_;
 
+  // Directory for sst files of cold partitions, empty if cold storage is
+  // disabled. See RocksDBSettings::cold_storage_path.
+  std::string cold_storage_path_;
+
   // Processor is needed to:
   //  - update trim points when dropping partitions,
   //  - get trimming policy from config.
@@ -1714,15 +1874,31 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   std::list<partition_id_t> hi_pri_manual_compactions_;
   std::list<partition_id_t> lo_pri_manual_compactions_;
 
-  // index of partition_id -> (hi_pri, iterator_to_list_entry)
-  std::unordered_map<partition_id_t,
-                     std::pair<bool, std::list<partition_id_t>::iterator>>
+  struct ManualCompactionInfo {
+    bool hi_pri;
+    std::list<partition_id_t>::iterator list_it;
+    folly::Optional<rate_limit_t> rate_limit;
+  };
+
+  // index of partition_id -> manual compaction
+  std::unordered_map<partition_id_t, ManualCompactionInfo>
       manual_compaction_index_;
 
+  // Context of the compaction that is currently using the compaction filter
+  // factory, and the partition it compacts. Protected by
+  // running_compaction_mutex_.
+  std::mutex running_compaction_mutex_;
+  const CompactionContext* running_compaction_context_{nullptr};
+  partition_id_t running_compaction_partition_{PARTITION_INVALID};
+  SteadyTimestamp running_compaction_start_time_;
+
   std::unique_ptr<MemtableFlushCallback> flushCallback_;
 
   // If true, stall low-pri writes to wait for partial compactions to catch up.
   std::atomic<bool> too_many_partial_compactions_{false};
+  // Number of partial compactions found by the last lo-pri background thread
+  // iteration. Used for write delay.
+  std::atomic<size_t> num_pending_partial_compactions_{0};
 
   // Approximate time when "metadata" CF was last compacted.
   SteadyTimestamp last_metadata_manual_compaction_time_;
@@ -1826,6 +2002,12 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   void onMemTableWindowUpdated() override;
 
+  // Calls RocksDBCompactionFilterFactory::startUsingContext() and makes the
+  // compaction visible to getRunningCompaction() until the returned object is
+  // destroyed.
+  std::shared_ptr<void> startCompaction(CompactionContext* context,
+                                        partition_id_t partition_id);
+
   // Performs compaction of the partition. Removes obsolete partition directory
   // entries afterwards (for logs that were fully removed from partition).
   // The compaction updates trim points to more precise values than trimLogs()
@@ -7,8 +7,11 @@
  */
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindTime.h"
 
+#include <algorithm>
+
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/util.h"
+#include "logdevice/server/locallogstore/FindTimeSamples.h"
 #include "logdevice/server/locallogstore/IteratorSearch.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreIterators.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
@@ -35,6 +38,8 @@ PartitionedRocksDBStore::FindTime::FindTime(
       approximate_(approximate),
       allow_blocking_io_(allow_blocking_io),
       use_index_(store_.getSettings()->read_find_time_index),
+      use_in_memory_directory_(
+          store_.getSettings()->find_time_in_memory_directory),
       deadline_(deadline) {}
 
 int PartitionedRocksDBStore::FindTime::execute(lsn_t* lo, lsn_t* hi) {
@@ -96,7 +101,12 @@ int PartitionedRocksDBStore::FindTime::execute(lsn_t* lo, lsn_t* hi) {
     // timestamp `timestamp_` by doing a binary search on the partition
     // directory.
 
-    int rv = findPartition(&p, &p_first_lsn);
+    int rv = 0;
+    if (use_in_memory_directory_) {
+      findPartitionInMemory(&p, &p_first_lsn);
+    } else {
+      rv = findPartition(&p, &p_first_lsn);
+    }
     // Note that `p` is nullptr on success if searching within
     // a partition cannot improve upon the lo_ and high_ as updated
     // by findPartition().
@@ -419,16 +429,111 @@ int PartitionedRocksDBStore::FindTime::findPartition(
   return 0;
 }
 
+void PartitionedRocksDBStore::FindTime::findPartitionInMemory(
+    PartitionPtr* out_partition,
+    lsn_t* out_first_lsn) const {
+  *out_partition = nullptr;
+  *out_first_lsn = LSN_INVALID;
+
+  // Same algorithm as in findPartition(), see the comment there.
+
+  auto partitions = store_.getPartitionList();
+  auto logs_it = store_.logs_.find(logid_.val_);
+  if (logs_it == store_.logs_.cend()) {
+    // Log is empty.
+    return;
+  }
+
+  LogState* log_state = logs_it->second.get();
+  std::lock_guard<std::mutex> log_lock(log_state->mutex);
+  const auto& directory = log_state->directory;
+
+  // Entries of dropped partitions are at the beginning of the directory;
+  // entries of partitions created after we got the partition list are at the
+  // end. Find the first relevant partition with
+  // starting_timestamp >= timestamp_, or the first entry of a partition
+  // created after the partition list.
+  auto right =
+      std::partition_point(directory.begin(),
+                           directory.end(),
+                           [&](const auto& entry) {
+                             partition_id_t id = entry.second.id;
+                             if (id < partitions->firstID()) {
+                               return true;
+                             }
+                             if (id >= partitions->nextID()) {
+                               return false;
+                             }
+                             PartitionPtr partition = partitions->get(id);
+                             ld_check(partition);
+                             return partition->starting_timestamp < timestamp_;
+                           });
+
+  if (right != directory.end() && right->second.id < partitions->nextID()) {
+    // This is partition C.
+    *hi_ = std::min(*hi_, right->first);
+  }
+
+  if (right == directory.begin()) {
+    return;
+  }
+  auto left = std::prev(right);
+  if (left->second.id < partitions->firstID()) {
+    // No relevant partitions before timestamp_.
+    return;
+  }
+
+  // `left` is partition X.
+  PartitionPtr left_partition = partitions->get(left->second.id);
+  ld_check(left_partition);
+  ld_check(left_partition->starting_timestamp < timestamp_);
+  PartitionPtr next_partition = partitions->get(left_partition->id_ + 1);
+  if (next_partition && next_partition->starting_timestamp < timestamp_) {
+    // 2a - left_partition is A, and B doesn't exist.
+  } else {
+    // 2b - left_partition is B.
+    *out_partition = left_partition;
+    *out_first_lsn = left->first;
+    if (left == directory.begin()) {
+      return;
+    }
+    --left;
+  }
+
+  // `left` points to A now.
+  *lo_ = std::max(*lo_, left->second.max_lsn);
+}
+
 int PartitionedRocksDBStore::FindTime::partitionSearch(
     rocksdb::ColumnFamilyHandle* cf) const {
+  lsn_t search_lo = min_lo_;
+  lsn_t search_hi = max_hi_;
+  lsn_t sample_hi = LSN_MAX;
+  if (!use_index_ && allow_blocking_io_ &&
+      store_.getSettings()->find_time_samples_per_log > 0) {
+    narrowWithSamples(cf, &search_lo, &sample_hi);
+    if (sample_hi != LSN_MAX) {
+      // The record at sample_hi is stamped at or after timestamp_, only the
+      // records before it need to be searched.
+      search_hi = std::min(search_hi, sample_hi - 1);
+    }
+    *lo_ = std::max(*lo_, search_lo);
+    *hi_ = std::min(*hi_, sample_hi);
+    if (search_lo >= search_hi) {
+      // The samples are consecutive records (or there's nothing between them
+      // in the search range), no need to search.
+      return 0;
+    }
+  }
+
   IteratorSearch search(&store_,
                         cf,
                         FIND_TIME_INDEX,
                         timestamp_.toMilliseconds().count(),
                         std::string(""),
                         logid_,
-                        min_lo_,
-                        max_hi_,
+                        search_lo,
+                        search_hi,
                         allow_blocking_io_,
                         deadline_);
 
@@ -443,4 +548,52 @@ int PartitionedRocksDBStore::FindTime::partitionSearch(
   return rv;
 }
 
+void PartitionedRocksDBStore::FindTime::narrowWithSamples(
+    rocksdb::ColumnFamilyHandle* cf,
+    lsn_t* search_lo,
+    lsn_t* search_hi) const {
+  RocksDBKeyFormat::DataKey first_key(logid_, LSN_INVALID);
+  RocksDBKeyFormat::DataKey last_key(logid_, LSN_MAX);
+  rocksdb::Range range(
+      first_key.sliceForForwardSeek(), last_key.sliceForBackwardSeek());
+  rocksdb::TablePropertiesCollection props;
+  rocksdb::Status status =
+      store_.getDB().GetPropertiesOfTablesInRange(cf, &range, 1, &props);
+  if (!status.ok()) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      2,
+                      "Failed to get table properties for findTime samples of "
+                      "log %lu: %s",
+                      logid_.val_,
+                      status.ToString().c_str());
+    return;
+  }
+
+  for (const auto& file_props : props) {
+    const auto& user_props = file_props.second->user_collected_properties;
+    auto it = user_props.find(FindTimeSamples::PROPERTY_NAME);
+    if (it == user_props.end()) {
+      continue;
+    }
+    if (!FindTimeSamples::narrow(it->second,
+                                 logid_,
+                                 timestamp_,
+                                 min_lo_,
+                                 max_hi_,
+                                 search_lo,
+                                 search_hi)) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      2,
+                      "Malformed findTime samples in table file %s",
+                      file_props.first.c_str());
+    }
+  }
+  if (*search_lo >= *search_hi) {
+    // Samples from different files disagree, which can happen if timestamps
+    // aren't monotonic in LSN. Fall back to searching the whole range.
+    *search_lo = min_lo_;
+    *search_hi = LSN_MAX;
+  }
+}
+
 }} // namespace facebook::logdevice
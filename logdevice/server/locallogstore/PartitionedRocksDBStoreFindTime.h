@@ -65,6 +65,15 @@ class PartitionedRocksDBStore::FindTime {
    */
   int findPartition(PartitionPtr* out_partition, lsn_t* out_first_lsn) const;
 
+  /**
+   * Same as findPartition() but searches the in-memory copy of the directory
+   * (LogState::directory) instead of the metadata column family, so it never
+   * reads from rocksdb and never fails. Used if
+   * rocksdb-find-time-in-memory-directory is set.
+   */
+  void findPartitionInMemory(PartitionPtr* out_partition,
+                             lsn_t* out_first_lsn) const;
+
   /**
    * Do a binary search or, if the findTime index is used, a seek on the given
    * column family, and update *lo_ and *hi_ with the result. Only one of *lo_
@@ -76,6 +85,17 @@ class PartitionedRocksDBStore::FindTime {
    */
   int partitionSearch(rocksdb::ColumnFamilyHandle* cf) const;
 
+  /**
+   * Narrows (*search_lo, *search_hi] using FindTimeSamples from the table
+   * properties of the column family's files; see FindTimeSamples.h.
+   * *search_lo and *search_hi are set to LSNs of records stamped before and
+   * at or after `timestamp_` respectively, if any are found. Never fails,
+   * the search range is left unchanged if samples can't be read.
+   */
+  void narrowWithSamples(rocksdb::ColumnFamilyHandle* cf,
+                         lsn_t* search_lo,
+                         lsn_t* search_hi) const;
+
   bool isTimedOut() const {
     return std::chrono::steady_clock::now() >= deadline_;
   }
@@ -93,6 +113,7 @@ class PartitionedRocksDBStore::FindTime {
   bool approximate_;
   bool allow_blocking_io_;
   bool use_index_;
+  bool use_in_memory_directory_;
   std::chrono::steady_clock::time_point deadline_;
 };
 
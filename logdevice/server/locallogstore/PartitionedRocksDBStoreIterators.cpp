@@ -49,7 +49,10 @@ void PartitionedRocksDBStore::Iterator::setDataIteratorFromCurrent(
   if (!filter || checkFilterTimeRange(*filter, &min_ts, &max_ts)) {
     if (data_iterator_ == nullptr) {
       data_iterator_ = std::make_unique<RocksDBLocalLogStore::CSIWrapper>(
-          pstore_, log_id_, options_, current_.partition_->cf_->get());
+          pstore_,
+          log_id_,
+          pstore_->getPartitionReadOptions(options_, current_.partition_->id_),
+          current_.partition_->cf_->get());
     }
     data_iterator_->min_ts_ = min_ts;
     data_iterator_->max_ts_ = max_ts;
@@ -1162,7 +1165,7 @@ void PartitionedRocksDBStore::PartitionedAllLogsIterator::seekToCurrentEntry(
       data_iterator_ = std::make_unique<RocksDBLocalLogStore::CSIWrapper>(
           pstore_,
           /* log_id */ folly::none,
-          options_,
+          pstore_->getPartitionReadOptions(options_, current_partition_->id_),
           current_partition_->cf_->get());
       data_iterator_->min_ts_ = min_ts;
       data_iterator_->max_ts_ = max_ts;
@@ -1243,6 +1246,7 @@ void PartitionedRocksDBStore::PartitionedAllLogsIterator::
     progress_lookup_.at(i) = sum_so_far;
     sum_so_far += directory_[i].second.approximate_size_bytes;
   }
+  total_bytes_ = static_cast<int64_t>(sum_so_far);
 
   if (sum_so_far != 0) {
     for (double& x : progress_lookup_) {
@@ -263,6 +263,9 @@ class PartitionedRocksDBStore::PartitionedAllLogsIterator
   Slice getRecord() const override;
   std::unique_ptr<Location> getLocation() const override;
   double getProgress() const override;
+  int64_t getApproximateTotalBytes() const override {
+    return total_bytes_;
+  }
 
   void seek(const Location& location,
             ReadFilter* filter = nullptr,
@@ -313,6 +316,8 @@ class PartitionedRocksDBStore::PartitionedAllLogsIterator
   // on directory entry i, getProgress() reports progress_lookup_[i].
   // Precalculated based on data size estimates in directory.
   std::vector<double> progress_lookup_;
+  // Sum of the data size estimates progress_lookup_ is based on.
+  int64_t total_bytes_ = 0;
 
   // Copy of the logsdb directory for the requested data logs.
   std::vector<LogDirectoryEntry> directory_;
@@ -99,6 +99,9 @@ RocksDBCompactionFilter::filterImpl(const rocksdb::Slice& key,
   }
 
   uint64_t bytesNeeded = key.size() + value.size();
+  if (context_) {
+    context_->bytes_filtered.fetch_add(bytesNeeded, std::memory_order_relaxed);
+  }
   if (storage_thread_pool_->useDRR() && context_ &&
       (context_->reason == Reason::PARTIAL ||
        context_->reason == Reason::RETENTION)) {
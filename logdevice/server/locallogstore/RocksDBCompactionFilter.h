@@ -65,6 +65,17 @@ struct CompactionContext {
   // Note that empty Optional and empty vector mean different (opposite) things.
   folly::Optional<std::vector<logid_t>> logs_to_keep;
   PartitionedRocksDBStore::PartitionToCompact::Reason reason;
+
+  // Passed from caller to the compaction filter.
+  // If has value, used instead of RocksDBSettings::compaction_rate_limit_ to
+  // throttle this compaction. Set for manual compactions requested with a
+  // rate limit by an admin command.
+  folly::Optional<rate_limit_t> rate_limit;
+
+  // Passed from the compaction filter to whoever wants to know how far along
+  // the compaction is: bytes of keys and values the filter has seen so far.
+  // Can be read by other threads while the compaction is running.
+  std::atomic<uint64_t> bytes_filtered{0};
 };
 
 // When using a filter factory (as we do), RocksDB will use each filter on a
@@ -77,7 +88,9 @@ class RocksDBCompactionFilter : public rocksdb::CompactionFilter {
       : storage_thread_pool_(pool),
         context_(context),
         settings_(settings),
-        rate_limiter_(settings->compaction_rate_limit_),
+        rate_limiter_(context && context->rate_limit.has_value()
+                          ? context->rate_limit.value()
+                          : settings->compaction_rate_limit_),
         drrBytesAllowed_(0),
         force_no_skips_(settings->force_no_compaction_optimizations_) {
     ld_check(pool != nullptr);
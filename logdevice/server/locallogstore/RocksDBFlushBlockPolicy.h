@@ -38,20 +38,34 @@ class RocksDBFlushBlockPolicy : public rocksdb::FlushBlockPolicy {
 
     bool ret = false;
     Group g = getGroup(key, value);
-
+    const bool group_changed = g != last_group_;
+
+    // Cut blocks at group boundaries, i.e. between the runs of records of
+    // different logs, so that a read of one log doesn't have to decompress
+    // other logs' records. Groups smaller than min_block_size share blocks.
+    // Past block_size, a group's run is cut even without a boundary, but is
+    // allowed to overshoot by min_block_size first, so that a small
+    // remainder of it doesn't end up in a block with the next groups.
+    //
     // Cut a block between csi and data records even if the block will be
     // smaller than min_block_size. This keeps csi blocks small, so more of them
     // fit in block cache.
-    if (cur_block_bytes_ >= opts_.block_size ||
-        (g != cur_group_ && cur_block_bytes_ >= opts_.min_block_size) ||
+    if ((group_changed &&
+         cur_block_bytes_ >=
+             std::min(opts_.block_size, opts_.min_block_size)) ||
+        cur_block_bytes_ >= opts_.block_size + opts_.min_block_size ||
         ((g.log == LOGID_INVALID) != (cur_group_.log == LOGID_INVALID) &&
          cur_block_bytes_ != 0)) {
       bumpStatsForCurBlock();
       cur_group_ = g;
       cur_block_bytes_ = 0;
+      cur_block_mixed_ = false;
       ret = true;
+    } else if (cur_block_bytes_ != 0 && g.log != last_group_.log) {
+      cur_block_mixed_ = true;
     }
 
+    last_group_ = g;
     cur_block_bytes_ += std::max(1ul, key.size() + value.size());
 
     return ret;
@@ -78,7 +92,12 @@ class RocksDBFlushBlockPolicy : public rocksdb::FlushBlockPolicy {
   const Options opts_;
 
   size_t cur_block_bytes_ = 0;
+  // Group of the first record of the current block.
   Group cur_group_;
+  // Group of the last record passed to Update().
+  Group last_group_;
+  // True if the current block has records of more than one log.
+  bool cur_block_mixed_ = false;
 
   Group getGroup(const rocksdb::Slice& key, const rocksdb::Slice& value) {
     Group g;
@@ -118,6 +137,9 @@ class RocksDBFlushBlockPolicy : public rocksdb::FlushBlockPolicy {
     if (cur_group_.log != LOGID_INVALID) {
       STAT_INCR(opts_.stats, sst_record_blocks_written);
       STAT_ADD(opts_.stats, sst_record_blocks_bytes, cur_block_bytes_);
+      if (cur_block_mixed_) {
+        STAT_INCR(opts_.stats, sst_mixed_record_blocks_written);
+      }
     }
   }
 };
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/RocksDBKeyComparator.h"
+
+#include <cstring>
+#include <endian.h>
+
+namespace facebook { namespace logdevice {
+
+static inline uint64_t loadBigEndian(const char* p) {
+  uint64_t raw_be;
+  memcpy(&raw_be, p, sizeof(raw_be));
+  return be64toh(raw_be);
+}
+
+const RocksDBKeyComparator* RocksDBKeyComparator::instance() {
+  static RocksDBKeyComparator comparator;
+  return &comparator;
+}
+
+int RocksDBKeyComparator::Compare(const rocksdb::Slice& a,
+                                  const rocksdb::Slice& b) const {
+  if (a.size() < FIXED_PREFIX_LENGTH || b.size() < FIXED_PREFIX_LENGTH) {
+    return a.compare(b);
+  }
+
+  const unsigned char header_a = a.data()[0];
+  const unsigned char header_b = b.data()[0];
+  if (header_a != header_b) {
+    return header_a < header_b ? -1 : 1;
+  }
+  for (size_t offset = 1; offset < FIXED_PREFIX_LENGTH;
+       offset += sizeof(uint64_t)) {
+    const uint64_t val_a = loadBigEndian(a.data() + offset);
+    const uint64_t val_b = loadBigEndian(b.data() + offset);
+    if (val_a != val_b) {
+      return val_a < val_b ? -1 : 1;
+    }
+  }
+
+  // Same fixed-width prefix. Compare the rest, if any, bytewise.
+  rocksdb::Slice suffix_a(
+      a.data() + FIXED_PREFIX_LENGTH, a.size() - FIXED_PREFIX_LENGTH);
+  rocksdb::Slice suffix_b(
+      b.data() + FIXED_PREFIX_LENGTH, b.size() - FIXED_PREFIX_LENGTH);
+  return suffix_a.compare(suffix_b);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+
+#include <rocksdb/comparator.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A key comparator specialized for our fixed-width keys: DataKey and
+ *       most metadata keys start with a header byte followed by two
+ *       big-endian uint64s (log ID and LSN, or log ID and epoch etc.).
+ *       For such keys bytewise comparison is the same as comparing the header
+ *       bytes and then the two integers, which is a couple of loads and
+ *       compares instead of a call to memcmp().
+ *
+ *       The resulting order is exactly the bytewise order for all keys,
+ *       including shorter or longer keys and the old DataKey format with a
+ *       wave suffix. Because of this we report the same Name() as rocksdb's
+ *       BytewiseComparator, so that existing databases can be opened with
+ *       either comparator and switching between them needs no migration.
+ *
+ *       Enabled by --rocksdb-fixed-width-key-comparator.
+ */
+
+class RocksDBKeyComparator : public rocksdb::Comparator {
+ public:
+  // Length of the part of the key compared as integers.
+  static constexpr size_t FIXED_PREFIX_LENGTH =
+      sizeof(char) + 2 * sizeof(uint64_t);
+
+  static const RocksDBKeyComparator* instance();
+
+  int Compare(const rocksdb::Slice& a, const rocksdb::Slice& b) const override;
+
+  bool Equal(const rocksdb::Slice& a, const rocksdb::Slice& b) const override {
+    return a == b;
+  }
+
+  // Must be the same as rocksdb::BytewiseComparator()->Name(), see above.
+  const char* Name() const override {
+    return "leveldb.BytewiseComparator";
+  }
+
+  void FindShortestSeparator(std::string* start,
+                             const rocksdb::Slice& limit) const override {
+    rocksdb::BytewiseComparator()->FindShortestSeparator(start, limit);
+  }
+
+  void FindShortSuccessor(std::string* key) const override {
+    rocksdb::BytewiseComparator()->FindShortSuccessor(key);
+  }
+};
+
+}} // namespace facebook::logdevice
@@ -96,7 +96,8 @@ void RocksDBListener::OnFlushBegin(rocksdb::DB*,
   IOTracing::AddContext* io_tracing_context =
       env_->backgroundJobContextOfThisThread();
   if (io_tracing_context && io_tracing_ && io_tracing_->isEnabled()) {
-    io_tracing_context->assign(io_tracing_, "flush|cf:{}", info.cf_name);
+    io_tracing_context->assign(
+        io_tracing_, IOTracing::Kind::FLUSH, "flush|cf:{}", info.cf_name);
   }
 }
 void RocksDBListener::OnCompactionBegin(
@@ -105,7 +106,10 @@ void RocksDBListener::OnCompactionBegin(
   IOTracing::AddContext* io_tracing_context =
       env_->backgroundJobContextOfThisThread();
   if (io_tracing_context && io_tracing_ && io_tracing_->isEnabled()) {
-    io_tracing_context->assign(io_tracing_, "compact|cf:{}", info.cf_name);
+    io_tracing_context->assign(io_tracing_,
+                               IOTracing::Kind::COMPACTION,
+                               "compact|cf:{}",
+                               info.cf_name);
   }
 }
 
@@ -29,6 +29,7 @@
 #include "logdevice/include/Err.h"
 #include "logdevice/server/locallogstore/IOTracing.h"
 #include "logdevice/server/locallogstore/IteratorSearch.h"
+#include "logdevice/server/locallogstore/RocksDBCompactionFilter.h"
 #include "logdevice/server/locallogstore/RocksDBCustomiser.h"
 #include "logdevice/server/locallogstore/RocksDBEnv.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
@@ -210,7 +211,18 @@ int RocksDBLocalLogStore::deleteAllLogSnapshotBlobs() {
   return 0;
 }
 
-int RocksDBLocalLogStore::performCompaction() {
+int RocksDBLocalLogStore::performCompaction(
+    folly::Optional<rate_limit_t> rate_limit) {
+  CompactionContext context;
+  context.reason = PartitionedRocksDBStore::PartitionToCompact::Reason::MANUAL;
+  context.rate_limit = rate_limit;
+  std::shared_ptr<void> compaction_lock;
+  auto factory = dynamic_cast<RocksDBCompactionFilterFactory*>(
+      rocksdb_config_.options_.compaction_filter_factory.get());
+  if (factory != nullptr) {
+    // This will wait for other manual compactions to finish.
+    compaction_lock = factory->startUsingContext(&context);
+  }
   rocksdb::Status status =
       db_->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr);
   if (!status.ok()) {
@@ -1237,9 +1249,11 @@ RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::getCurrentEntrySize() {
 void RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::seek(
     Location loc,
     Direction dir) {
-  SCOPED_IO_TRACING_CONTEXT(getStore()->getIOTracing(),
-                            "CSI:seek{}",
-                            dir == Direction::FORWARD ? "" : "ForPrev");
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      getStore()->getIOTracing(),
+      IOTracing::Kind::ITERATOR_SEEK,
+      "CSI:seek{}",
+      dir == Direction::FORWARD ? "" : "ForPrev");
 
   createIteratorIfNeeded();
   if (dir == Direction::FORWARD) {
@@ -1264,9 +1278,11 @@ void RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::seek(
 void RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::step(
     Direction dir) {
   ld_check(state() == IteratorState::AT_RECORD);
-  SCOPED_IO_TRACING_CONTEXT(getStore()->getIOTracing(),
-                            "CSI:{}",
-                            dir == Direction::FORWARD ? "next" : "prev");
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      getStore()->getIOTracing(),
+      IOTracing::Kind::ITERATOR_STEP,
+      "CSI:{}",
+      dir == Direction::FORWARD ? "next" : "prev");
   if (dir == Direction::FORWARD) {
     ROCKSDB_ACCOUNTED_NEXT(iterator_, csi);
   } else {
@@ -1285,6 +1301,15 @@ RocksDBLocalLogStore::CSIWrapper::DataIterator::DataIterator(
       rocks_options_(translateReadOptions(parent_->read_opts_,
                                           parent_->log_id_.has_value(),
                                           &upper_bound_.upper_bound)) {
+#ifdef LOGDEVICE_ROCKSDB_HAS_ASYNC_IO
+  // Non-blocking iterators only read from block cache, async reads are of no
+  // use to them.
+  if (parent_->getRocksDBStore()->getSettings()->read_async_io &&
+      rocks_options_.read_tier != rocksdb::kBlockCacheTier) {
+    rocks_options_.async_io = true;
+    rocks_options_.adaptive_readahead = true;
+  }
+#endif
   registerTracking(parent_->cf_->GetName(),
                    parent_->log_id_.value_or(LOGID_INVALID),
                    rocks_options_.tailing,
@@ -1376,9 +1401,11 @@ Slice RocksDBLocalLogStore::CSIWrapper::DataIterator::getRecord() const {
 
 void RocksDBLocalLogStore::CSIWrapper::DataIterator::seek(Location loc,
                                                           Direction dir) {
-  SCOPED_IO_TRACING_CONTEXT(getStore()->getIOTracing(),
-                            "data:seek{}",
-                            dir == Direction::FORWARD ? "" : "ForPrev");
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      getStore()->getIOTracing(),
+      IOTracing::Kind::ITERATOR_SEEK,
+      "data:seek{}",
+      dir == Direction::FORWARD ? "" : "ForPrev");
   merged_value_.clear();
   createIteratorIfNeeded();
   DataKey key(loc.log_id, loc.lsn);
@@ -1395,9 +1422,11 @@ void RocksDBLocalLogStore::CSIWrapper::DataIterator::seek(Location loc,
 }
 
 void RocksDBLocalLogStore::CSIWrapper::DataIterator::step(Direction dir) {
-  SCOPED_IO_TRACING_CONTEXT(getStore()->getIOTracing(),
-                            "data:{}",
-                            dir == Direction::FORWARD ? "next" : "prev");
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      getStore()->getIOTracing(),
+      IOTracing::Kind::ITERATOR_STEP,
+      "data:{}",
+      dir == Direction::FORWARD ? "next" : "prev");
   merged_value_.clear();
   ld_assert(state() == IteratorState::AT_RECORD);
   if (dir == Direction::FORWARD) {
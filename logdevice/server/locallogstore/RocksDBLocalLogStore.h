@@ -15,6 +15,7 @@
 #include <utility>
 #include <vector>
 
+#include <folly/Optional.h>
 #include <rocksdb/db.h>
 #include <rocksdb/iterator.h>
 #include <rocksdb/statistics.h>
@@ -345,9 +346,12 @@ class RocksDBLocalLogStore : public RocksDBLogStoreBase {
    * Perform a manual compation run on the entire rocksDB logstore.
    * Will block the calling thread until the compaction finishes.
    *
+   * @param rate_limit  if has value, throttles the compaction filter to it
+   *                    instead of RocksDBSettings::compaction_rate_limit_
+   *
    * @return  0 on success, -1 on failure
    */
-  int performCompaction();
+  int performCompaction(folly::Optional<rate_limit_t> rate_limit = folly::none);
 
   int isEmpty() const override {
     return isCFEmpty(db_->DefaultColumnFamily());
@@ -240,6 +240,43 @@ void RocksDBLogStoreBase::throttleIOIfNeeded(WriteBufStats buf_stats,
 
   new_state = std::max(new_state, subclassSuggestedThrottleState());
 
+  // Proportional delay of writes that aren't stalled or rejected. Ramps up
+  // linearly from 0 at --rocksdb-write-delay-start-percent of the memory limit
+  // to --rocksdb-max-write-delay at the memory limit, where we would start
+  // rejecting writes. This way the write rate converges to what flushes can
+  // sustain before we get to REJECT_WRITE.
+  double delay_fraction = 0;
+  const double delay_start_percent = getSettings()->write_delay_start_percent;
+  if (rocksdb_config_.use_ld_managed_flushes_ && delay_start_percent > 0 &&
+      delay_start_percent < 100) {
+    const double start = memory_limit * delay_start_percent / 100;
+    const double used =
+        buf_stats.active_memory_usage + buf_stats.memory_being_flushed;
+    if (used > start) {
+      delay_fraction = (used - start) / (memory_limit - start);
+    }
+  }
+  delay_fraction =
+      std::max(delay_fraction, subclassSuggestedWriteDelayFraction());
+  delay_fraction = std::min(1.0, std::max(0.0, delay_fraction));
+  const int64_t new_delay_usec = new_state == WriteThrottleState::REJECT_WRITE
+      ? 0
+      : static_cast<int64_t>(delay_fraction *
+                             getSettings()->max_write_delay.count());
+  const int64_t prev_delay_usec = write_delay_usec_.exchange(new_delay_usec);
+  PER_SHARD_STAT_SET(stats_, write_delay_usec, shard_idx_, new_delay_usec);
+  if ((prev_delay_usec == 0) != (new_delay_usec == 0)) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Shard %u: write delay changed from %ldus to %ldus. "
+                   "Memtables active: %.3f MB, flushing: %.3f MB.",
+                   shard_idx_,
+                   prev_delay_usec,
+                   new_delay_usec,
+                   buf_stats.active_memory_usage / 1e6,
+                   buf_stats.memory_being_flushed / 1e6);
+  }
+
   auto now = SteadyTimestamp::now();
   WriteThrottleState prev_state;
   std::chrono::steady_clock::duration prev_state_duration{0};
@@ -426,6 +463,12 @@ int RocksDBLogStoreBase::updateLogMetadata(logid_t log_id,
   return writer_->updateLogMetadata(
       log_id, metadata, write_options, getMetadataCFHandle());
 }
+void RocksDBLogStoreBase::updateLogMetadataMulti(
+    std::vector<LogMetadataUpdate>& updates,
+    const WriteOptions& write_options) {
+  writer_->updateLogMetadataMulti(
+      updates, write_options, getMetadataCFHandle());
+}
 int RocksDBLogStoreBase::updatePerEpochLogMetadata(
     logid_t log_id,
     epoch_t epoch,
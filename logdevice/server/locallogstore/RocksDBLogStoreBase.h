@@ -371,6 +371,9 @@ class RocksDBLogStoreBase : public LocalLogStore {
       logid_t log_id,
       ComparableLogMetadata& metadata,
       const WriteOptions& write_options = WriteOptions()) override;
+  void updateLogMetadataMulti(
+      std::vector<LogMetadataUpdate>& updates,
+      const WriteOptions& write_options = WriteOptions()) override;
   int updatePerEpochLogMetadata(
       logid_t log_id,
       epoch_t epoch,
@@ -422,6 +425,10 @@ class RocksDBLogStoreBase : public LocalLogStore {
     return write_throttle_state_.load();
   }
 
+  std::chrono::microseconds getWriteDelay() override {
+    return std::chrono::microseconds(write_delay_usec_.load());
+  }
+
   // A wrapper around rocksdb::DB::Write() which also updates stats and injects
   // IO errors if needed. Subclasses can override it to add some hooks to all
   // rocksdb writes.
@@ -508,6 +515,12 @@ class RocksDBLogStoreBase : public LocalLogStore {
   // Checks that there are no keys in CF, except, maybe, "schema_version" key.
   int isCFEmpty(rocksdb::ColumnFamilyHandle* cf) const;
 
+  // Stores are verified if rocksdb-verify-checksum-during-store is set, and
+  // rocksdb::ReadOptions::verify_checksums is left at its default (true).
+  bool verifiesChecksumsOnWriteAndRead() const override {
+    return getSettings()->verify_checksum_during_store;
+  }
+
   uint64_t getVersion() const override {
     uint64_t version;
     if (!db_->GetIntProperty(
@@ -565,6 +578,13 @@ class RocksDBLogStoreBase : public LocalLogStore {
     return WriteThrottleState::NONE;
   }
 
+  // Called from throttleIOIfNeeded(). How close the subclass is to
+  // suggesting a more severe throttle state, from 0 (not at all) to 1 (about
+  // to). Used for proportional write delay, see getWriteDelay().
+  virtual double subclassSuggestedWriteDelayFraction() {
+    return 0;
+  }
+
   std::unique_ptr<rocksdb::DB> db_;
 
   // Index of this shard and how many shards this node has in total.
@@ -629,6 +649,8 @@ class RocksDBLogStoreBase : public LocalLogStore {
   SteadyTimestamp write_throttle_state_since_{SteadyTimestamp::min()};
   // When write_throttle_state_ was recalculated.
   SteadyTimestamp last_throttle_update_time_{SteadyTimestamp::min()};
+  // See getWriteDelay(). Updated together with write_throttle_state_.
+  std::atomic<int64_t> write_delay_usec_{0};
 
   // Installs a MemTableRepFactory so that LogDevice's MemTabelRep is
   // used when constructing all MemTables.
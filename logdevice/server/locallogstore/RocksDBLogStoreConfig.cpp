@@ -16,10 +16,12 @@
 #include <rocksdb/table.h>
 #include <rocksdb/write_buffer_manager.h>
 
+#include "logdevice/server/locallogstore/FindTimeSamples.h"
 #include "logdevice/server/locallogstore/RocksDBCache.h"
 #include "logdevice/server/locallogstore/RocksDBCompactionFilter.h"
 #include "logdevice/server/locallogstore/RocksDBEnv.h"
 #include "logdevice/server/locallogstore/RocksDBFlushBlockPolicy.h"
+#include "logdevice/server/locallogstore/RocksDBKeyComparator.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 #include "logdevice/server/locallogstore/RocksDBListener.h"
 #include "logdevice/server/locallogstore/RocksDBLogger.h"
@@ -60,11 +62,20 @@ RocksDBLogStoreConfig::RocksDBLogStoreConfig(
 
   options_.wal_recovery_mode = rocksdb::WALRecoveryMode::kPointInTimeRecovery;
 
+  if (rocksdb_settings_->fixed_width_key_comparator) {
+    options_.comparator = RocksDBKeyComparator::instance();
+  }
+
   if (updateable_config) {
     options_.table_properties_collector_factories.push_back(
         std::make_shared<RocksDBTablePropertiesCollectorFactory>(
             updateable_config, stats));
   }
+  if (rocksdb_settings_->find_time_samples_per_log > 0) {
+    options_.table_properties_collector_factories.push_back(
+        std::make_shared<FindTimeSamplesCollectorFactory>(
+            rocksdb_settings_->find_time_samples_per_log));
+  }
 
   // Use a prefix extractor which returns the part of the key containing just
   // the log id. Since almost all of our reads are restricted to a particular
@@ -38,6 +38,12 @@ void RocksDBMemTableRep::Insert(rocksdb::KeyHandle handle) {
   mtr_->Insert(handle);
 }
 
+void RocksDBMemTableRep::InsertWithHint(rocksdb::KeyHandle handle,
+                                        void** hint) {
+  factory_->registerMemTableRep(*this);
+  mtr_->InsertWithHint(handle, hint);
+}
+
 void RocksDBMemTableRep::MarkReadOnly() {
   factory_->markMemtableRepImmutable(*this);
   mtr_->MarkReadOnly();
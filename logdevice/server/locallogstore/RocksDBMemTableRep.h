@@ -37,6 +37,14 @@ class RocksDBMemTableRep : public RocksDBMemTableRepWrapper {
 
   void Insert(rocksdb::KeyHandle handle) override;
 
+  // Used by RocksDB instead of Insert() when
+  // memtable_insert_with_hint_prefix_extractor is set (see
+  // --rocksdb-enable-insert-hint). `hint` is kept by the memtable per key
+  // prefix, i.e. per log and key type, and lets the skiplist insert keys that
+  // are increasing within a log next to the previous one instead of searching
+  // from the head.
+  void InsertWithHint(rocksdb::KeyHandle handle, void** hint) override;
+
   void MarkReadOnly() override;
 
   void MarkFlushed() override;
@@ -28,6 +28,9 @@ class RocksDBMemTableRepWrapper : public rocksdb::MemTableRep {
   void Insert(rocksdb::KeyHandle handle) override {
     wrapped_->Insert(handle);
   }
+  void InsertWithHint(rocksdb::KeyHandle handle, void** hint) override {
+    wrapped_->InsertWithHint(handle, hint);
+  }
   void InsertConcurrently(rocksdb::KeyHandle handle) override {
     wrapped_->InsertConcurrently(handle);
   }
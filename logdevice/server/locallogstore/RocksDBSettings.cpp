@@ -32,6 +32,30 @@ using namespace facebook::logdevice::setting_validators;
 
 namespace facebook { namespace logdevice {
 
+static rocksdb::CompressionType
+parse_compression_type(const std::string& val, const char* option) {
+  if (val == "snappy") {
+    return rocksdb::kSnappyCompression;
+  } else if (val == "none") {
+    return rocksdb::kNoCompression;
+  } else if (val == "zlib") {
+    return rocksdb::kZlibCompression;
+  } else if (val == "bzip2") {
+    return rocksdb::kBZip2Compression;
+  } else if (val == "lz4") {
+    return rocksdb::kLZ4Compression;
+  } else if (val == "lz4hc") {
+    return rocksdb::kLZ4HCCompression;
+  } else if (val == "xpress") {
+    return rocksdb::kXpressCompression;
+  } else if (val == "zstd") {
+    return rocksdb::kZSTD;
+  } else {
+    throw boost::program_options::error("invalid value '" + val +
+                                        "' for option --" + option);
+  }
+}
+
 void RocksDBSettings::defineSettings(SettingEasyInit& init) {
   using namespace SettingFlag;
 
@@ -59,27 +83,7 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        &compression,
        "lz4",
        [](const std::string& val) {
-         if (val == "snappy") {
-           return rocksdb::kSnappyCompression;
-         } else if (val == "none") {
-           return rocksdb::kNoCompression;
-         } else if (val == "zlib") {
-           return rocksdb::kZlibCompression;
-         } else if (val == "bzip2") {
-           return rocksdb::kBZip2Compression;
-         } else if (val == "lz4") {
-           return rocksdb::kLZ4Compression;
-         } else if (val == "lz4hc") {
-           return rocksdb::kLZ4HCCompression;
-         } else if (val == "xpress") {
-           return rocksdb::kXpressCompression;
-         } else if (val == "zstd") {
-           return rocksdb::kZSTD;
-         } else {
-           throw boost::program_options::error(
-               "invalid value '" + val +
-               "' for option --rocksdb-compression-type");
-         }
+         return parse_compression_type(val, "rocksdb-compression-type");
        },
        "compression algorithm: 'lz4' (default), 'lz4hc', 'snappy', "
        "'zlib', 'bzip2', 'zstd', 'none'",
@@ -183,6 +187,82 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-fill-cache-latest-partitions",
+       &fill_cache_latest_partitions,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive, only reads from this many latest partitions insert blocks "
+       "into the block cache. Reads from older partitions, i.e. readers far "
+       "behind the tail, still use blocks that are already cached but don't add "
+       "new ones, so a backlog scan doesn't evict the working set of tail "
+       "readers. Rebuilding reads don't fill the cache regardless, see "
+       "--rebuilding-use-rocksdb-cache. 0 means all reads fill the cache.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cold-storage-path",
+       &cold_storage_path,
+       "",
+       nullptr,
+       "If not empty, LogsDB moves partitions whose data is older than "
+       "--rocksdb-cold-storage-age to this directory, e.g. on cheaper, slower "
+       "media. Each shard uses a subdirectory named after its own directory. "
+       "Partitions are moved by compacting them, and stay readable, trimmable "
+       "and rebuildable as usual; new writes always go to the shard's primary "
+       "directory first. Once some partitions were moved this setting must "
+       "not be removed, otherwise the shard won't open.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cold-compression-type",
+       &cold_compression,
+       "",
+       [](const std::string& val) {
+         if (val.empty()) {
+           return rocksdb::kDisableCompressionOption;
+         }
+         return parse_compression_type(val, "rocksdb-cold-compression-type");
+       },
+       "If not empty, compression algorithm for partitions whose data is older "
+       "than --rocksdb-cold-storage-age, e.g. 'zstd', while newer partitions "
+       "use --rocksdb-compression-type, e.g. 'lz4' or 'none'. Partitions are "
+       "recompressed by compacting them once they get old enough. Takes the "
+       "same values as --rocksdb-compression-type. Empty means all partitions "
+       "use --rocksdb-compression-type.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cold-storage-age",
+       &cold_storage_age,
+       "1d",
+       [](std::chrono::milliseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-cold-storage-age must be non-negative");
+         }
+       },
+       "Partitions whose newest data is older than this are moved to "
+       "--rocksdb-cold-storage-path and recompressed with "
+       "--rocksdb-cold-compression-type, if these are set.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-cache-index-except-latest-partitions",
+       &cache_index_except_latest_partitions,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive, and --rocksdb-cache-index is false, only this many latest "
+       "partitions of each shard (counted when the shard is opened) keep index "
+       "and filter blocks of their sst files in memory. Older partitions put "
+       "them in the block cache, as with --rocksdb-cache-index, so that "
+       "partitions that are never read don't use memory for them. Old "
+       "partitions are read rarely (by rebuilding or readers far behind), so "
+       "this saves memory proportional to retention at the cost of an extra "
+       "read or two when such a partition is first read. 0 means all "
+       "partitions follow --rocksdb-cache-index.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-force-no-compaction-optimizations",
        &force_no_compaction_optimizations_,
        "false",
@@ -286,6 +366,38 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-compaction-min-reclaim-ratio",
+       &partition_compaction_min_reclaim_ratio,
+       "0",
+       [](double val) {
+         if (val < 0.0 || val > 1.0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-partition-compaction-min-reclaim-ratio must "
+               "be in the range [0.0, 1.0]");
+         }
+       },
+       "Skip a retention-based compaction of a partition if less than this "
+       "share of its data (by size, per table properties) would be trimmed "
+       "by it. Such partitions are left to be compacted for a longer backlog "
+       "duration in --rocksdb-partition-compaction-schedule, or dropped whole "
+       "once all their data expires. Avoids rewriting long-retention data "
+       "that shares partitions with a small amount of short-retention data. "
+       "0 means always compact.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-metadata-read-threads",
+       &partition_metadata_read_threads,
+       "4",
+       parse_positive<ssize_t>(),
+       "Number of threads each shard uses to read per-partition metadata "
+       "(timestamps, dirty state) when opening LogsDB. Shards are opened "
+       "concurrently, so the total is this times the number of shards. "
+       "Startup time of shards with many partitions is dominated by these "
+       "reads when the metadata isn't in page cache.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-proactive-compaction-enabled",
        &proactive_compaction_enabled,
        "false",
@@ -872,6 +984,41 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-find-time-in-memory-directory",
+       &find_time_in_memory_directory,
+       "true",
+       nullptr,
+       "If set to true, findTime will look for the partition covering the "
+       "target timestamp in the in-memory copy of the partition directory, "
+       "without reading the metadata column family. Partitions that hold no "
+       "records of the log are skipped without any rocksdb reads.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-find-time-samples-per-log",
+       &find_time_samples_per_log,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If positive, table files written by flushes and compactions store up "
+       "to this many (LSN, timestamp) samples of each log in their table "
+       "properties, and findTime uses them to narrow its binary search within "
+       "a partition to a few records, usually a single block read. Costs "
+       "about 4 bytes per sample per log per table file of table properties "
+       "memory. 0 disables both collecting and using the samples.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-read-async-io",
+       &read_async_io,
+       "false",
+       nullptr,
+       "If set to true, data iterators used by blocking reads prefetch data "
+       "blocks with asynchronous reads (rocksdb ReadOptions::async_io, which "
+       "uses io_uring if rocksdb was built with liburing). Keeps more reads in "
+       "flight per storage thread. No-op with rocksdb older than 7.2.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-read-only",
        &read_only,
        "false",
@@ -958,6 +1105,19 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SettingsCategory::RocksDB);
 #endif
 
+  init("rocksdb-fixed-width-key-comparator",
+       &fixed_width_key_comparator,
+       "false",
+       nullptr,
+       "If true, rocksdb keys are compared with a comparator specialized for "
+       "our fixed-width keys (a header byte followed by two big-endian 64-bit "
+       "integers), instead of the generic bytewise comparator. The order of "
+       "keys is the same, so this can be switched on and off on existing "
+       "databases. Reduces CPU usage of memtable inserts, seeks and "
+       "compactions.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-track-iterator-versions",
        &track_iterator_versions,
        "false",
@@ -1115,8 +1275,9 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        "16384",
        parse_positive<ssize_t>(),
        "minimum size of the uncompressed data block; only used when "
-       "--rocksdb-flush-block-policy is not default; on SSD consider reducing "
-       "this value",
+       "--rocksdb-flush-block-policy is not default; a block may also exceed "
+       "--rocksdb-block-size by up to this much to end at a log boundary; on "
+       "SSD consider reducing this value",
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
@@ -1497,6 +1658,42 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-write-delay-start-percent",
+       &write_delay_start_percent,
+       "0",
+       [](double val) {
+         if (val < 0 || val > 100) {
+           throw boost::program_options::error(
+               "value of rocksdb-write-delay-start-percent must be between 0 "
+               "and 100");
+         }
+       },
+       "Start delaying writes when active+flushing memtable size of a shard "
+       "goes above this percentage of the per shard memory limit (the point "
+       "where writes get rejected). The delay grows linearly up to "
+       "--rocksdb-max-write-delay at the limit, so the write rate slows down "
+       "gradually instead of flipping between accepting and rejecting all "
+       "writes. Also applies to pending partial compactions approaching "
+       "--rocksdb-partition-partial-compaction-stall-trigger. 0 disables "
+       "write delay.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-max-write-delay",
+       &max_write_delay,
+       "5ms",
+       [](std::chrono::microseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "rocksdb-max-write-delay must be non-negative");
+         }
+       },
+       "Delay of each write batch when memtables are right at the per shard "
+       "memory limit or partial compactions at the stall trigger. See "
+       "--rocksdb-write-delay-start-percent.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-pinned-memtables-limit-percent",
        &pinned_memtables_limit_percent,
        "200",
@@ -1617,6 +1814,17 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-io-tracing-histograms",
+       &io_tracing_histograms,
+       "false",
+       nullptr,
+       "If true, keep a latency histogram of IO operations on each shard for "
+       "each kind of context they're done in (e.g. flush, compaction, "
+       "iterator seek, WAL sync), regardless of rocksdb-io-tracing-shards. "
+       "Much cheaper than IO tracing. See admin command 'info io_tracing'.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-paranoid-checks",
        &paranoid_checks,
        "true",
@@ -56,6 +56,12 @@ static_assert(ROCKSDB_MAJOR > 5 || (ROCKSDB_MAJOR == 5 && ROCKSDB_MINOR >= 7),
 #define LOGDEVICE_ROCKSDB_HAS_SKIP_CHECKING_SST_FILE_SIZES_ON_DB_OPEN
 #endif
 
+#if ROCKSDB_MAJOR > 7 || (ROCKSDB_MAJOR == 7 && ROCKSDB_MINOR >= 2)
+// ReadOptions::async_io: iterators prefetch data blocks with asynchronous
+// reads (io_uring, if rocksdb was built with liburing).
+#define LOGDEVICE_ROCKSDB_HAS_ASYNC_IO
+#endif
+
 namespace boost { namespace program_options {
 class options_description;
 }} // namespace boost::program_options
@@ -150,6 +156,16 @@ class RocksDBSettings : public SettingsBundle {
   using compaction_schedule_t = std::vector<std::chrono::seconds>;
   folly::Optional<compaction_schedule_t> partition_compaction_schedule;
 
+  // A retention-based compaction of a partition is skipped if less than this
+  // share of the partition's data would be trimmed by it. The partition is
+  // then dropped whole when all its data expires, or compacted for a longer
+  // backlog duration, instead of having its long-retention data rewritten.
+  double partition_compaction_min_reclaim_ratio;
+
+  // Number of threads each shard uses to read per-partition metadata when
+  // opening the store.
+  int partition_metadata_read_threads;
+
   // whether we're going to proactively compact all partitions
   // (besides two latest) that were never compacted.
   // Compacting will be done in low priority background thread
@@ -282,6 +298,22 @@ class RocksDBSettings : public SettingsBundle {
   // instead of doing a binary search in the relevant partition.
   bool read_find_time_index;
 
+  // When set to true, findTime does its binary search over partitions in the
+  // in-memory copy of the partition directory instead of seeking in the
+  // metadata column family.
+  bool find_time_in_memory_directory;
+
+  // If positive, new table files store up to this many (LSN, timestamp)
+  // samples of each log in their table properties, and findTime uses them to
+  // narrow its binary search within a partition. See FindTimeSamples.h.
+  size_t find_time_samples_per_log;
+
+  // If true, data iterators that are allowed to block do readahead with
+  // asynchronous reads, so that a storage thread keeps multiple reads in
+  // flight instead of waiting for each block in turn. Requires rocksdb 7.2+;
+  // rocksdb uses io_uring for these reads when built with liburing.
+  bool read_async_io;
+
   // If true, PartitionedRocksDBStore will be opened in read only mode.
   bool read_only;
 
@@ -311,6 +343,10 @@ class RocksDBSettings : public SettingsBundle {
   bool first_key_in_index_;
 #endif
 
+  // If true, use RocksDBKeyComparator instead of rocksdb's bytewise
+  // comparator. Same order, cheaper comparisons.
+  bool fixed_width_key_comparator;
+
   // ignored for FlushBlockPolicyType::DEFAULT
   size_t min_block_size_;
 
@@ -351,6 +387,26 @@ class RocksDBSettings : public SettingsBundle {
   // don't use filters.
   bool cache_index_;
 
+  // If not empty, partitions whose data is older than cold_storage_age are
+  // moved to this path (in a subdirectory named after the shard) by
+  // compacting them. See PartitionedRocksDBStore::getCompactionOutputPathId().
+  std::string cold_storage_path;
+  std::chrono::milliseconds cold_storage_age;
+
+  // If not kDisableCompressionOption, compactions of partitions older than
+  // cold_storage_age use this compression instead of `compression`.
+  rocksdb::CompressionType cold_compression;
+
+  // If positive, only reads from this many latest partitions fill the block
+  // cache. Reads from older partitions (backlog readers) don't.
+  size_t fill_cache_latest_partitions;
+
+  // If positive and cache_index_ is false, only this many latest partitions
+  // (as of opening the shard) hold index blocks of their files in memory.
+  // Older partitions are opened as if cache_index_ was true, so their index
+  // blocks are only loaded when read and get evicted when not used.
+  size_t cache_index_except_latest_partitions;
+
   // See .cpp
   bool force_no_compaction_optimizations_;
 
@@ -379,6 +435,8 @@ class RocksDBSettings : public SettingsBundle {
 
   std::chrono::milliseconds io_tracing_threshold;
 
+  bool io_tracing_histograms;
+
   // When ld manages flushes, memory limit for the node and memtable
   // within rocksdb set to a very high value. rocksdb should never be
   // able to reach those limits and initiate a flush. This limit is a
@@ -391,6 +449,8 @@ class RocksDBSettings : public SettingsBundle {
   // See .cpp
   double low_pri_write_stall_threshold_percent;
   double pinned_memtables_limit_percent;
+  double write_delay_start_percent;
+  std::chrono::microseconds max_write_delay;
 
   // See .cpp
   std::chrono::milliseconds flush_trigger_check_interval;
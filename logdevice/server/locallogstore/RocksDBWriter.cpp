@@ -8,6 +8,7 @@
 #include "logdevice/server/locallogstore/RocksDBWriter.h"
 
 #include <algorithm>
+#include <map>
 
 #include <folly/small_vector.h>
 #include <rocksdb/env.h>
@@ -535,6 +536,117 @@ int RocksDBWriter::updateLogMetadata(
   return 0;
 }
 
+void RocksDBWriter::updateLogMetadataMulti(
+    std::vector<LocalLogStore::LogMetadataUpdate>& updates,
+    const LocalLogStore::WriteOptions& /*write_options*/,
+    rocksdb::ColumnFamilyHandle* cf) {
+  auto fail_all = [&] {
+    for (LocalLogStore::LogMetadataUpdate& update : updates) {
+      update.status = E::LOCAL_LOG_STORE_WRITE;
+    }
+  };
+  if (read_only_) {
+    ld_check(false);
+    fail_all();
+    return;
+  }
+  if (store_->acceptingWrites() == E::DISABLED) {
+    fail_all();
+    return;
+  }
+
+  // Take the locks of all logs in the batch, in increasing order so that we
+  // can't deadlock with another batch.
+  std::vector<size_t> stripes;
+  stripes.reserve(updates.size());
+  for (const LocalLogStore::LogMetadataUpdate& update : updates) {
+    stripes.push_back(update.log_id.val_ % locks_.size());
+  }
+  std::sort(stripes.begin(), stripes.end());
+  stripes.erase(std::unique(stripes.begin(), stripes.end()), stripes.end());
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve(stripes.size());
+  for (size_t stripe : stripes) {
+    locks.emplace_back(locks_[stripe]);
+  }
+
+  // Latest value of each entry touched by the batch: either read from the
+  // store, or the metadata of an earlier update in this batch. nullptr if the
+  // entry doesn't exist.
+  std::map<std::pair<LogMetadataType, logid_t>, ComparableLogMetadata*> latest;
+  std::vector<std::unique_ptr<LogMetadata>> read_values;
+
+  rocksdb::WriteBatch batch;
+  size_t num_writes = 0;
+  for (LocalLogStore::LogMetadataUpdate& update : updates) {
+    ComparableLogMetadata& metadata = *update.metadata;
+    if (!metadata.valid()) {
+      // See updateLogMetadata().
+      RATELIMIT_CRITICAL(std::chrono::seconds(10),
+                         10,
+                         "INTERNAL ERROR: Not writing invalid metadata %s to "
+                         "persistent log store!",
+                         metadata.toString().c_str());
+      update.status = E::LOCAL_LOG_STORE_WRITE;
+      dd_assert(false, "invalid metadata");
+      continue;
+    }
+
+    auto it = latest.find(std::make_pair(metadata.getType(), update.log_id));
+    if (it == latest.end()) {
+      auto p = LogMetadataFactory::create(metadata.getType());
+      ld_assert(dynamic_cast<ComparableLogMetadata*>(p.get()) != nullptr);
+      ComparableLogMetadata* prev =
+          static_cast<ComparableLogMetadata*>(p.get());
+      int rv = readLogMetadata(update.log_id, prev, cf);
+      if (rv != 0 && err != E::NOTFOUND) {
+        RATELIMIT_ERROR(
+            std::chrono::seconds(1),
+            10,
+            "Reading existing metadata type %d for log %lu failed: %s",
+            static_cast<int>(metadata.getType()),
+            update.log_id.val_,
+            error_description(err));
+        update.status = err;
+        continue;
+      }
+      it = latest
+               .emplace(std::make_pair(metadata.getType(), update.log_id),
+                        rv == 0 ? prev : nullptr)
+               .first;
+      read_values.push_back(std::move(p));
+    }
+
+    if (it->second != nullptr && !(*it->second < metadata)) {
+      metadata.deserialize(it->second->serialize());
+      update.status = E::UPTODATE;
+      continue;
+    }
+
+    LogMetaKey key(metadata.getType(), update.log_id);
+    Slice value(metadata.serialize());
+    batch.Put(
+        cf,
+        rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof key),
+        rocksdb::Slice(reinterpret_cast<const char*>(value.data), value.size));
+    it->second = &metadata;
+    update.status = E::OK;
+    ++num_writes;
+  }
+
+  if (num_writes == 0) {
+    return;
+  }
+  rocksdb::Status status = store_->writeBatch(rocksdb::WriteOptions(), &batch);
+  if (!status.ok()) {
+    for (LocalLogStore::LogMetadataUpdate& update : updates) {
+      if (update.status == E::OK) {
+        update.status = E::LOCAL_LOG_STORE_WRITE;
+      }
+    }
+  }
+}
+
 int RocksDBWriter::readPreviousPerEpochLogMetadata(
     logid_t log_id,
     epoch_t epoch,
@@ -735,6 +847,8 @@ int RocksDBWriter::writeLogSnapshotBlobs(
 rocksdb::Status RocksDBWriter::syncWAL() {
   FlushToken synced_up_to = next_wal_sync_token_.fetch_add(1);
 
+  SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+      store_->getIOTracing(), IOTracing::Kind::WAL_SYNC, "sync-wal");
   auto time_start = std::chrono::steady_clock::now();
   auto status = store_->getDB().SyncWAL();
   auto time_end = std::chrono::steady_clock::now();
@@ -101,6 +101,11 @@ class RocksDBWriter {
                         ComparableLogMetadata& metadata,
                         const LocalLogStore::WriteOptions& options,
                         rocksdb::ColumnFamilyHandle* cf);
+  // Writes all successful updates in one WriteBatch.
+  void updateLogMetadataMulti(
+      std::vector<LocalLogStore::LogMetadataUpdate>& updates,
+      const LocalLogStore::WriteOptions& options,
+      rocksdb::ColumnFamilyHandle* cf);
   int deleteStoreMetadata(const StoreMetadataType& type,
                           const LocalLogStore::WriteOptions& options,
                           rocksdb::ColumnFamilyHandle* cf);
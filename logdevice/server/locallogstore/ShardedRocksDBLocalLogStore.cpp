@@ -9,6 +9,7 @@
 
 #include <array>
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <future>
@@ -162,6 +163,7 @@ void ShardedRocksDBLocalLogStore::init(
     futures.push_back(std::async(std::launch::async, [=]() {
       ThreadID::set(
           ThreadID::UTILITY, folly::sformat("ld:open-rocks{}", shard_idx));
+      auto start_time = std::chrono::steady_clock::now();
 
       // Make a copy of RocksDBLogStoreConfig for this shard.
       RocksDBLogStoreConfig shard_config = rocksdb_config_;
@@ -214,7 +216,11 @@ void ShardedRocksDBLocalLogStore::init(
       }
 
       if (shard_store) {
-        ld_info("Opened RocksDB instance at %s", shard_path.c_str());
+        ld_info("Opened RocksDB instance at %s in %.3fs",
+                shard_path.c_str(),
+                std::chrono::duration_cast<std::chrono::duration<double>>(
+                    std::chrono::steady_clock::now() - start_time)
+                    .count());
         ld_check(dynamic_cast<RocksDBLogStoreBase*>(shard_store.get()) !=
                  nullptr);
       } else {
@@ -746,6 +752,8 @@ void ShardedRocksDBLocalLogStore::refreshIOTracingSettings() {
   for (shard_index_t i = 0; i < enabled_by_shard.size(); ++i) {
     io_tracing_by_shard_[i]->setEnabled(enabled_by_shard[i]);
     io_tracing_by_shard_[i]->setThreshold(threshold);
+    io_tracing_by_shard_[i]->setHistogramsEnabled(
+        settings->io_tracing_histograms);
   }
 }
 
@@ -154,6 +154,16 @@ class ShardedRocksDBLocalLogStore : public ShardedLocalLogStore {
   const std::unordered_map<dev_t, DiskShardMappingEntry>&
   getShardToDiskMapping();
 
+  /**
+   * Device the given shard's data lives on, or 0 if unknown (data is not
+   * stored locally or createDiskShardMapping() failed for this shard).
+   */
+  dev_t getShardDevice(shard_index_t shard_idx) const {
+    return shard_idx >= 0 && (size_t)shard_idx < shard_to_devt_.size()
+        ? shard_to_devt_[shard_idx]
+        : 0;
+  }
+
   /**
    * If the shards use LogsDB, per-disk space-based trimming is enabled, and
    * space usage has reached that limit, trim logs on the given disk until that
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/IOTracing.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+uint64_t count(const IOTracing& tracing, IOTracing::Kind kind) {
+  return tracing.getHistogram(kind).getCountAndSum().first;
+}
+
+void tracedOp(IOTracing* tracing) {
+  SCOPED_IO_TRACED_OP(tracing, "op");
+}
+
+} // namespace
+
+TEST(IOTracingTest, HistogramsByKind) {
+  IOTracing tracing(0);
+  EXPECT_FALSE(tracing.isEnabled());
+  tracedOp(&tracing);
+  EXPECT_EQ(0, count(tracing, IOTracing::Kind::OTHER));
+
+  tracing.setHistogramsEnabled(true);
+  EXPECT_TRUE(tracing.isEnabled());
+  EXPECT_FALSE(tracing.isLoggingEnabled());
+  tracedOp(&tracing);
+  {
+    SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+        &tracing, IOTracing::Kind::FLUSH, "flush|cf:{}", 42);
+    tracedOp(&tracing);
+    {
+      // Nested contexts override the kind until they go out of scope.
+      SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+          &tracing, IOTracing::Kind::ITERATOR_SEEK, "seek");
+      SCOPED_IO_TRACING_CONTEXT(&tracing, "more");
+      tracedOp(&tracing);
+    }
+    tracedOp(&tracing);
+  }
+  tracedOp(&tracing);
+
+  EXPECT_EQ(2, count(tracing, IOTracing::Kind::OTHER));
+  EXPECT_EQ(2, count(tracing, IOTracing::Kind::FLUSH));
+  EXPECT_EQ(1, count(tracing, IOTracing::Kind::ITERATOR_SEEK));
+  EXPECT_EQ(0, count(tracing, IOTracing::Kind::COMPACTION));
+
+  // Logging doesn't affect histograms. Threshold is high enough for nothing
+  // to be logged.
+  tracing.setEnabled(true);
+  tracing.setThreshold(std::chrono::hours(1));
+  {
+    SCOPED_IO_TRACING_CONTEXT_WITH_KIND(
+        &tracing, IOTracing::Kind::WAL_SYNC, "sync-wal");
+    tracedOp(&tracing);
+  }
+  EXPECT_EQ(1, count(tracing, IOTracing::Kind::WAL_SYNC));
+}
@@ -194,9 +194,18 @@ class TestPartitionedRocksDBStore : public PartitionedRocksDBStore {
       future_to_wait.wait();
     }
 
+    {
+      std::lock_guard<std::mutex> lock(test_mutex_);
+      last_compaction_rate_limit_ = to_compact.rate_limit;
+    }
     PartitionedRocksDBStore::performCompactionInternal(std::move(to_compact));
   }
 
+  folly::Optional<rate_limit_t> getLastCompactionRateLimit() {
+    std::lock_guard<std::mutex> lock(test_mutex_);
+    return last_compaction_rate_limit_;
+  }
+
   // Makes the next call to performCompactionInternal() stall until the returned
   // std::promise is signaled with set_value().
   std::promise<void> stallCompaction() {
@@ -234,6 +243,7 @@ class TestPartitionedRocksDBStore : public PartitionedRocksDBStore {
   std::mutex test_mutex_;
   State states_[(int)BackgroundThreadType::COUNT];
   std::future<void> compaction_stall_future_;
+  folly::Optional<rate_limit_t> last_compaction_rate_limit_;
 
   SystemTimestamp* time_;
   WriteThrottleState suggested_throttle_state_ = WriteThrottleState::NONE;
@@ -3111,6 +3121,285 @@ TEST_F(PartitionedRocksDBStoreTest, CompactionScheduleBaseline) {
   EXPECT_EQ(2, stats.partitions_compacted);
 }
 
+// Partition metadata is read by multiple threads when opening a store with
+// many partitions (RocksDBSettings::partition_metadata_read_threads).
+TEST_F(PartitionedRocksDBStoreTest, OpenReadsPartitionMetadataInParallel) {
+  const logid_t log(1);
+  const int num_partitions = 300;
+  for (int i = 0; i < num_partitions; ++i) {
+    put({TestRecord(log, i + 1, BASE_TIME + i * MINUTE + 1)});
+    time_ += std::chrono::milliseconds(MINUTE);
+    store_->createPartition();
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> expected;
+  {
+    auto p = store_->getPartitionList();
+    for (int i = 0; i < num_partitions; ++i) {
+      expected.emplace_back(
+          p->get(ID0 + i)->starting_timestamp.toMilliseconds().count(),
+          p->get(ID0 + i)->min_timestamp.toMilliseconds().count());
+    }
+  }
+
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-partition-metadata-read-threads"] = "4";
+  openStore(s);
+
+  auto p = store_->getPartitionList();
+  ASSERT_GE(p->size(), (size_t)num_partitions);
+  for (int i = 0; i < num_partitions; ++i) {
+    EXPECT_EQ(expected[i].first,
+              p->get(ID0 + i)->starting_timestamp.toMilliseconds().count());
+    EXPECT_EQ(expected[i].second,
+              p->get(ID0 + i)->min_timestamp.toMilliseconds().count());
+  }
+
+  auto data = readAndCheck();
+  for (int i = 0; i < num_partitions; ++i) {
+    EXPECT_EQ(std::vector<lsn_t>({lsn_t(i + 1)}), data[i][log].records);
+  }
+}
+
+// Old partitions opened with different table options
+// (--rocksdb-cache-index-except-latest-partitions) are readable and writable
+// as usual.
+TEST_F(PartitionedRocksDBStoreTest, CacheIndexExceptLatestPartitions) {
+  const logid_t log(1);
+  for (int i = 0; i < 4; ++i) {
+    put({TestRecord(log, i * 10 + 1, BASE_TIME + i * MINUTE + 1)});
+    time_ += std::chrono::milliseconds(MINUTE);
+    store_->createPartition();
+  }
+  store_->flushAllMemtables();
+
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-cache-index-except-latest-partitions"] = "2";
+  openStore(s);
+
+  // A late record in the oldest partition.
+  put({TestRecord(log, 2, BASE_TIME + 2)});
+  store_->flushAllMemtables();
+
+  auto data = readAndCheck();
+  EXPECT_EQ(std::vector<lsn_t>({1, 2}), data[0][log].records);
+  for (int i = 1; i < 4; ++i) {
+    EXPECT_EQ(std::vector<lsn_t>({lsn_t(i * 10 + 1)}), data[i][log].records);
+  }
+}
+
+// Databases written with --rocksdb-fixed-width-key-comparator can be opened
+// without it and vice versa.
+TEST_F(PartitionedRocksDBStoreTest, FixedWidthKeyComparator) {
+  closeStore();
+  openStore({{"rocksdb-fixed-width-key-comparator", "true"}});
+
+  const logid_t log(1);
+  put({TestRecord(log, 10, BASE_TIME + 1),
+       TestRecord(logid_t(2), 5, BASE_TIME + 1)});
+  store_->createPartition();
+  put({TestRecord(log, 20, BASE_TIME + 2)});
+  store_->flushAllMemtables();
+  put({TestRecord(log, 30, BASE_TIME + 3)});
+
+  closeStore();
+  openStore();
+  put({TestRecord(log, 40, BASE_TIME + 4)});
+  store_->flushAllMemtables();
+  auto data = readAndCheck();
+  EXPECT_EQ(std::vector<lsn_t>({10}), data[0][log].records);
+  EXPECT_EQ(std::vector<lsn_t>({20, 30, 40}), data[1][log].records);
+
+  closeStore();
+  openStore({{"rocksdb-fixed-width-key-comparator", "true"}});
+  data = readAndCheck();
+  EXPECT_EQ(std::vector<lsn_t>({10}), data[0][log].records);
+  EXPECT_EQ(std::vector<lsn_t>({20, 30, 40}), data[1][log].records);
+}
+
+// Partitions older than --rocksdb-cold-storage-age are recompressed with
+// --rocksdb-cold-compression-type.
+TEST_F(PartitionedRocksDBStoreTest, ColdCompression) {
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-compression-type"] = "none";
+  s["rocksdb-cold-compression-type"] = "lz4";
+  s["rocksdb-cold-storage-age"] = "1h";
+  openStore(s);
+
+  const logid_t log(1);
+  put({TestRecord(log, 10, BASE_TIME + MINUTE)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + MINUTE * 2));
+  store_->createPartition();
+  put({TestRecord(log, 20, BASE_TIME + MINUTE * 3)});
+  store_->flushAllMemtables();
+
+  auto compressions = [&](partition_id_t id) {
+    rocksdb::TablePropertiesCollection props;
+    auto status = store_->getDB().GetPropertiesOfAllTables(
+        store_->getPartitionList()->get(id)->cf_->get(), &props);
+    EXPECT_TRUE(status.ok());
+    std::set<std::string> res;
+    for (const auto& p : props) {
+      res.insert(p.second->compression_name);
+    }
+    return res;
+  };
+  EXPECT_EQ(std::set<std::string>({"NoCompression"}), compressions(ID0));
+
+  auto run_lo_pri = [&] {
+    store_
+        ->backgroundThreadIteration(
+            PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+        .wait();
+  };
+
+  // Partition 0 isn't old enough yet.
+  time_ = SystemTimestamp(
+      std::chrono::milliseconds(BASE_TIME + MINUTE * 2 + HOUR / 2));
+  run_lo_pri();
+  EXPECT_EQ(0, stats_.aggregate().partition_cold_storage_compactions);
+
+  time_ = SystemTimestamp(
+      std::chrono::milliseconds(BASE_TIME + MINUTE * 2 + HOUR * 2));
+  run_lo_pri();
+  EXPECT_EQ(1, stats_.aggregate().partition_cold_storage_compactions);
+  EXPECT_EQ(std::set<std::string>({"LZ4"}), compressions(ID0));
+  EXPECT_EQ(std::set<std::string>({"NoCompression"}), compressions(ID0 + 1));
+
+  // Compacted once is enough.
+  run_lo_pri();
+  EXPECT_EQ(1, stats_.aggregate().partition_cold_storage_compactions);
+
+  auto data = readAndCheck();
+  EXPECT_EQ(std::vector<lsn_t>({10}), data[0][log].records);
+  EXPECT_EQ(std::vector<lsn_t>({20}), data[1][log].records);
+}
+
+// Partitions older than --rocksdb-cold-storage-age are compacted into
+// --rocksdb-cold-storage-path and stay readable.
+TEST_F(PartitionedRocksDBStoreTest, ColdStorage) {
+  TemporaryDirectory cold_dir("PartitionedRocksDBStoreTestCold");
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-cold-storage-path"] = cold_dir.path().string();
+  s["rocksdb-cold-storage-age"] = "1h";
+  openStore(s);
+
+  const logid_t log(1);
+  put({TestRecord(log, 10, BASE_TIME + MINUTE)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + MINUTE * 2));
+  store_->createPartition();
+  put({TestRecord(log, 20, BASE_TIME + MINUTE * 3)});
+  store_->flushAllMemtables();
+
+  auto files_in_cold_storage = [&](partition_id_t id) {
+    rocksdb::ColumnFamilyMetaData cf_meta;
+    store_->getDB().GetColumnFamilyMetaData(
+        store_->getPartitionList()->get(id)->cf_->get(), &cf_meta);
+    size_t cold = 0;
+    size_t total = 0;
+    for (const auto& level : cf_meta.levels) {
+      for (const auto& file : level.files) {
+        ++total;
+        cold += file.db_path.find(cold_dir.path().string()) == 0;
+      }
+    }
+    return std::make_pair(cold, total);
+  };
+  EXPECT_EQ(std::make_pair(size_t(0), size_t(1)), files_in_cold_storage(ID0));
+
+  // Partition 0 isn't old enough yet.
+  time_ = SystemTimestamp(
+      std::chrono::milliseconds(BASE_TIME + MINUTE * 2 + HOUR / 2));
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(0, stats_.aggregate().partition_cold_storage_compactions);
+
+  time_ = SystemTimestamp(
+      std::chrono::milliseconds(BASE_TIME + MINUTE * 2 + HOUR * 2));
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(1, stats_.aggregate().partition_cold_storage_compactions);
+  EXPECT_EQ(std::make_pair(size_t(1), size_t(1)), files_in_cold_storage(ID0));
+  // Latest partition is never cold.
+  EXPECT_EQ(
+      std::make_pair(size_t(0), size_t(1)), files_in_cold_storage(ID0 + 1));
+
+  // Already moved, nothing more to do.
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(1, stats_.aggregate().partition_cold_storage_compactions);
+
+  // Readable from both paths, also after reopening.
+  auto data = readAndCheck();
+  EXPECT_EQ(std::vector<lsn_t>({10}), data[0][log].records);
+  EXPECT_EQ(std::vector<lsn_t>({20}), data[1][log].records);
+  closeStore();
+  openStore(s);
+  data = readAndCheck();
+  EXPECT_EQ(std::vector<lsn_t>({10}), data[0][log].records);
+  EXPECT_EQ(std::vector<lsn_t>({20}), data[1][log].records);
+}
+
+// Test for RocksDBSettings::partition_compaction_min_reclaim_ratio.
+// A partition that is mostly 3-day data isn't compacted when the little
+// 1-day and 2-day data it has expires; it's dropped whole later instead.
+TEST_F(PartitionedRocksDBStoreTest, CompactionMinReclaimRatio) {
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-partition-compaction-min-reclaim-ratio"] = "0.5";
+  openStore(s, [&](RocksDBLogStoreConfig& cfg) {
+    cfg.options_.table_properties_collector_factories.push_back(
+        std::make_shared<RocksDBTablePropertiesCollectorFactory>(
+            processor_->config_, nullptr /* stats */));
+  });
+
+  put({TestRecord(logid_t(50), 10, BASE_TIME + HOUR),
+       TestRecord(logid_t(150), 10, BASE_TIME + HOUR)});
+  for (int i = 0; i < 100; ++i) {
+    put({TestRecord(logid_t(250), i + 10, BASE_TIME + HOUR)});
+  }
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + HOUR));
+  store_->createPartition();
+  // Table properties are only collected for flushed sst files.
+  EXPECT_TRUE(store_->flushMemtable(store_->getPartitionList()->get(ID0)->cf_));
+
+  EXPECT_LT(store_->getRetentionReclaimRatio(
+                store_->getPartitionList()->get(ID0), std::chrono::hours(48)),
+            0.5);
+
+  for (int day = 2; day <= 3; ++day) {
+    time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + DAY * day));
+    store_
+        ->backgroundThreadIteration(
+            PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+        .wait();
+    auto stats = stats_.aggregate();
+    EXPECT_EQ(0, stats.partitions_compacted);
+    EXPECT_EQ(0, stats.partitions_dropped);
+  }
+
+  // All logs are trimmed from partition 0. Dropped without ever having been
+  // compacted.
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + DAY * 4));
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  auto stats = stats_.aggregate();
+  EXPECT_EQ(0, stats.partitions_compacted);
+  EXPECT_EQ(1, stats.partitions_dropped);
+}
+
 // Test for RocksDBSettings proactive_compaction_enabled option.
 TEST_F(PartitionedRocksDBStoreTest, ProactiveCompaction) {
   closeStore();
@@ -3470,6 +3759,66 @@ TEST_F(PartitionedRocksDBStoreTest, FindTimeBehindTrimPoint) {
   FINDTIME(logid, BASE_TIME, 30, LSN_MAX, 30, 31);
 }
 
+// Checks that findTime gives the same results for a sparse log whether the
+// directory search is done in memory or in the metadata column family.
+TEST_F(PartitionedRocksDBStoreTest, FindTimeSparseLogDirectorySearch) {
+  logid_t logid(3);
+  logid_t sparse_logid(42);
+
+  // Sparse log only has records in the first and last partition.
+  put({TestRecord(logid, 10, BASE_TIME)});
+  put({TestRecord(sparse_logid, 100, BASE_TIME + 1)});
+  for (int i = 1; i <= 4; ++i) {
+    time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + i * 10));
+    store_->createPartition();
+    put({TestRecord(logid, 10 + i, BASE_TIME + i * 10 + 1)});
+  }
+  put({TestRecord(sparse_logid, 200, BASE_TIME + 45)});
+
+  for (bool in_memory : {true, false}) {
+    closeStore();
+    ServerConfig::SettingsConfig s;
+    s["rocksdb-find-time-in-memory-directory"] = in_memory ? "true" : "false";
+    openStore(s);
+
+    FINDTIME(sparse_logid, BASE_TIME + 25, LSN_INVALID, LSN_MAX, 100, 200);
+    FINDTIME(sparse_logid, BASE_TIME, LSN_INVALID, LSN_MAX, LSN_INVALID, 100);
+    FINDTIME(sparse_logid, BASE_TIME + 90, LSN_INVALID, LSN_MAX, 200, LSN_MAX);
+    FINDTIME(
+        logid_t(43), BASE_TIME + 25, LSN_INVALID, LSN_MAX, LSN_INVALID, LSN_MAX);
+  }
+}
+
+TEST_F(PartitionedRocksDBStoreTest, FindTimeWithSamples) {
+  logid_t logid(3);
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-find-time-samples-per-log"] = "4";
+  openStore(s);
+
+  // partition 0
+  put({TestRecord(logid, 5, BASE_TIME)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME));
+  store_->createPartition();
+  // partition 1: records 10, 20, ..., 1000 stamped 1ms apart, in a table file
+  // with (at most) 4 samples plus the last record, and a few more records
+  // still in the memtable.
+  for (int i = 1; i <= 100; ++i) {
+    put({TestRecord(logid, i * 10, BASE_TIME + i)});
+  }
+  store_->flushAllMemtables();
+  for (int i = 101; i <= 110; ++i) {
+    put({TestRecord(logid, i * 10, BASE_TIME + i)});
+  }
+
+  for (int i = 2; i <= 110; ++i) {
+    FINDTIME(logid, BASE_TIME + i, LSN_INVALID, LSN_MAX, (i - 1) * 10, i * 10);
+  }
+  FINDTIME(logid, BASE_TIME + 200, LSN_INVALID, LSN_MAX, 1100, LSN_MAX);
+  // With a trim point, samples below it are ignored.
+  FINDTIME(logid, BASE_TIME + 2, 500, LSN_MAX, 500, 510);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, FindTimeWithIndexSimple) {
   logid_t logid(3);
   openStoreWithReadFindTimeIndex();
@@ -4625,6 +4974,33 @@ TEST_F(PartitionedRocksDBStoreTest, ManualCompactions) {
   EXPECT_EQ(exp_list, list);
 }
 
+TEST_F(PartitionedRocksDBStoreTest, ManualCompactionRateLimit) {
+  put({TestRecord(logid_t(50), lsn_t(2), BASE_TIME)});
+  store_->createPartition();
+  EXPECT_FALSE(store_->getRunningCompaction().has_value());
+
+  const rate_limit_t limit(10 * 1024 * 1024, std::chrono::seconds(1));
+  store_->scheduleManualCompaction(ID0, true /* hi_pri */, limit);
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(1, stats_.aggregate().partitions_compacted);
+  ASSERT_TRUE(store_->getLastCompactionRateLimit().has_value());
+  EXPECT_EQ(limit, store_->getLastCompactionRateLimit().value());
+  EXPECT_FALSE(store_->getRunningCompaction().has_value());
+
+  // Rescheduling without a rate limit drops the previous one.
+  store_->scheduleManualCompaction(ID0, true /* hi_pri */, limit);
+  store_->scheduleManualCompaction(ID0, true /* hi_pri */);
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(2, stats_.aggregate().partitions_compacted);
+  EXPECT_FALSE(store_->getLastCompactionRateLimit().has_value());
+}
+
 TEST_F(PartitionedRocksDBStoreTest, PartialCompactionEvaluator) {
   // tests various sets of file sizes and verifies that the output of the
   // evaluator is as expected.
@@ -7830,6 +8206,73 @@ TEST_F(PartitionedRocksDBStoreTest, TimestampDurability) {
   EXPECT_EQ(2, stats_.aggregate().partition_sync_write_promotion_for_timstamp);
 }
 
+TEST_F(PartitionedRocksDBStoreTest, MinUnflushedTimestamp) {
+  closeStore();
+  openStore({{"rocksdb-partition-duration", "15min"},
+             {"rocksdb-partition-timestamp-granularity", "5s"}});
+  auto min_unflushed = [this] {
+    return RecordTimestamp(
+        store_->getLatestPartition()->dirty_state_.min_unflushed_timestamp);
+  };
+  auto lowered = [this] {
+    return stats_.aggregate().partition_min_unflushed_timestamp_lowered;
+  };
+  auto flush = [this] {
+    store_->flushAllMemtables();
+    store_->updateDirtyState(store_->flushedUpThrough());
+  };
+  const RecordTimestamp base_ts =
+      RecordTimestamp::from(std::chrono::milliseconds(BASE_TIME));
+
+  // Unknown until the partition's appends are flushed.
+  logid_t logid(1);
+  put({TestRecord(logid,
+                  10,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::APPEND,
+                  BASE_TIME)});
+  EXPECT_EQ(RecordTimestamp::min(), min_unflushed());
+
+  // Once everything is flushed, it's raised to about the newest record.
+  flush();
+  EXPECT_EQ(base_ts, min_unflushed());
+
+  // Appends within partition-timestamp-granularity of it don't change it.
+  put({TestRecord(logid,
+                  11,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::APPEND,
+                  BASE_TIME - SECOND * 2)});
+  EXPECT_EQ(0, lowered());
+  EXPECT_EQ(base_ts, min_unflushed());
+
+  // Older appends lower it.
+  put({TestRecord(logid,
+                  12,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::APPEND,
+                  BASE_TIME - SECOND * 10)});
+  EXPECT_EQ(1, lowered());
+  EXPECT_EQ(base_ts - std::chrono::seconds(10), min_unflushed());
+
+  // Rebuilding writes don't affect it.
+  put({TestRecord(logid,
+                  13,
+                  Durability::MEMORY,
+                  TestRecord::StoreType::REBUILD,
+                  BASE_TIME - SECOND * 20)});
+  EXPECT_EQ(1, lowered());
+
+  // Flushing the old appends raises it again, and the value survives a
+  // restart.
+  flush();
+  EXPECT_EQ(base_ts, min_unflushed());
+  closeStore();
+  openStore({{"rocksdb-partition-duration", "15min"},
+             {"rocksdb-partition-timestamp-granularity", "5s"}});
+  EXPECT_EQ(base_ts, min_unflushed());
+}
+
 // Write two records to each of two partitions. Modify directory entry in
 // for the first partition to simulate a missing maxLSN update for the
 // second record in the first partition. Write this second record again
@@ -9126,6 +9569,50 @@ TEST_F(PartitionedRocksDBStoreTest, DataSizeOnRestart) {
   ASSERT_EQ(result, old_size);
 }
 
+// Checks that dataSize() for a range covering the whole log, which doesn't
+// visit the directory, agrees with the sizes of its parts, also after
+// partitions are dropped.
+TEST_F(PartitionedRocksDBStoreTest, DataSizeWholeLog) {
+  const logid_t log(1);
+  uint64_t time_raw = BASE_TIME;
+  auto dataSize = [&](uint64_t lo, uint64_t hi) {
+    size_t result = 0;
+    EXPECT_EQ(0,
+              store_->dataSize(log,
+                               std::chrono::milliseconds(lo),
+                               std::chrono::milliseconds(hi),
+                               &result));
+    return result;
+  };
+  const uint64_t max_ts = std::chrono::milliseconds::max().count();
+
+  put({TestRecord(log, 10, time_raw, std::string(100, 'x'))});
+  time_raw += 20 * MINUTE;
+  setTime(time_raw);
+  const uint64_t second_start = time_raw;
+  auto second = store_->createPartition();
+  put({TestRecord(log, 20, time_raw, std::string(200, 'x'))});
+  time_raw += 20 * MINUTE;
+  setTime(time_raw);
+  store_->createPartition();
+  put({TestRecord(log, 30, time_raw, std::string(300, 'x'))});
+  time_raw += MINUTE;
+  setTime(time_raw);
+
+  const size_t whole = dataSize(0, max_ts);
+  EXPECT_EQ(1, stats_.aggregate().logsdb_data_size_whole_directory);
+  const size_t first = dataSize(0, second_start);
+  const size_t rest = dataSize(second_start, max_ts);
+  EXPECT_EQ(1, stats_.aggregate().logsdb_data_size_whole_directory);
+  EXPECT_GT(first, 0);
+  EXPECT_GT(rest, 0);
+  EXPECT_EQ(whole, first + rest);
+
+  store_->dropPartitionsUpTo(second->id_);
+  EXPECT_EQ(rest, dataSize(0, max_ts));
+  EXPECT_EQ(2, stats_.aggregate().logsdb_data_size_whole_directory);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, IteratorStaleMaxLsnBug) {
   logid_t logid(3);
 
@@ -10434,6 +10921,42 @@ TEST_F(PartitionedRocksDBStoreTest, ThrottleWrites) {
   }
 }
 
+// Writes get delayed proportionally as memtables approach the limit.
+TEST_F(PartitionedRocksDBStoreTest, WriteDelay) {
+  closeStore();
+  openStore({{"rocksdb-write-delay-start-percent", "50"},
+             {"rocksdb-max-write-delay", "10ms"}});
+  uint64_t memory_limit = 2000;
+
+  auto check = [&](uint64_t active,
+                   uint64_t flushing,
+                   LocalLogStore::WriteThrottleState expected_state,
+                   int64_t expected_delay_usec) {
+    WriteBufStats stats;
+    stats.active_memory_usage = active;
+    stats.memory_being_flushed = flushing;
+    store_->throttleIOIfNeeded(stats, memory_limit);
+    EXPECT_EQ(expected_state, store_->getWriteThrottleState());
+    EXPECT_EQ(expected_delay_usec, store_->getWriteDelay().count());
+  };
+
+  // Below the start of the ramp.
+  check(500, 400, LocalLogStore::WriteThrottleState::NONE, 0);
+  // A quarter and three quarters of the way from 1000 to 2000 bytes. Low-pri
+  // writes are stalled, the others are delayed.
+  check(1250, 0, LocalLogStore::WriteThrottleState::STALL_LOW_PRI_WRITE, 2500);
+  check(
+      1000, 750, LocalLogStore::WriteThrottleState::STALL_LOW_PRI_WRITE, 7500);
+  // At the limit writes are rejected instead.
+  check(1000, 1000, LocalLogStore::WriteThrottleState::REJECT_WRITE, 0);
+  check(0, 0, LocalLogStore::WriteThrottleState::NONE, 0);
+
+  // Disabled by default.
+  closeStore();
+  openStore();
+  check(1000, 750, LocalLogStore::WriteThrottleState::STALL_LOW_PRI_WRITE, 0);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, FlushBlockPolicyTest) {
   std::vector<StoreChainLink> cs1 = {
       StoreChainLink{ShardID(0, 0), ClientID::INVALID},
@@ -10466,6 +10989,7 @@ TEST_F(PartitionedRocksDBStoreTest, FlushBlockPolicyTest) {
   EXPECT_EQ(1, stats.sst_record_blocks_written);
   EXPECT_GE(stats.sst_record_blocks_bytes, 40);
   EXPECT_LE(stats.sst_record_blocks_bytes, 400);
+  EXPECT_EQ(1, stats.sst_mixed_record_blocks_written);
   stats_.reset();
 
   closeStore();
@@ -10476,6 +11000,7 @@ TEST_F(PartitionedRocksDBStoreTest, FlushBlockPolicyTest) {
   write_and_flush();
   stats = stats_.aggregate();
   EXPECT_EQ(2, stats.sst_record_blocks_written);
+  EXPECT_EQ(0, stats.sst_mixed_record_blocks_written);
   stats_.reset();
 
   closeStore();
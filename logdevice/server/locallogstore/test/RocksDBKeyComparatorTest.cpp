@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/RocksDBKeyComparator.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/util.h"
+#include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
+
+using namespace facebook::logdevice;
+using RocksDBKeyFormat::DataKey;
+
+namespace {
+
+int sign(int x) {
+  return (x > 0) - (x < 0);
+}
+
+} // namespace
+
+// The order must be exactly the bytewise order, for any keys.
+TEST(RocksDBKeyComparatorTest, SameOrderAsBytewise) {
+  const rocksdb::Comparator* bytewise = rocksdb::BytewiseComparator();
+  const RocksDBKeyComparator* cmp = RocksDBKeyComparator::instance();
+  EXPECT_STREQ(bytewise->Name(), cmp->Name());
+
+  std::vector<std::string> keys = {"", "d", "a123", std::string(17, '\0')};
+  std::mt19937_64 rng(4242);
+  for (int i = 0; i < 200; ++i) {
+    // Few distinct values, so that many keys share log IDs and LSNs.
+    DataKey key(logid_t(rng() % 4), rng() % 4 == 0 ? LSN_MAX : rng() % 8);
+    keys.push_back(key.sliceForWriting().ToString());
+    // Old format, with wave suffix.
+    keys.push_back(key.sliceForBackwardSeek().ToString());
+    // Random bytes of random length around the fixed width.
+    std::string random(rng() % 24, '\0');
+    for (char& c : random) {
+      c = static_cast<char>(rng() % 3 == 0 ? 0xff : rng() % 4);
+    }
+    keys.push_back(random);
+  }
+
+  for (const std::string& a : keys) {
+    for (const std::string& b : keys) {
+      ASSERT_EQ(sign(bytewise->Compare(a, b)), sign(cmp->Compare(a, b)))
+          << hexdump_buf(a.data(), a.size()) << " vs "
+          << hexdump_buf(b.data(), b.size());
+      ASSERT_EQ(a == b, cmp->Equal(a, b));
+    }
+  }
+}
@@ -124,6 +124,12 @@ int TemporaryLogStore::updateLogMetadata(logid_t log_id,
   return db_->updateLogMetadata(log_id, metadata, options);
 }
 
+void TemporaryLogStore::updateLogMetadataMulti(
+    std::vector<LogMetadataUpdate>& updates,
+    const WriteOptions& options) {
+  db_->updateLogMetadataMulti(updates, options);
+}
+
 int TemporaryLogStore::readStoreMetadata(StoreMetadata* metadata) {
   return db_->readStoreMetadata(metadata);
 }
@@ -322,7 +328,8 @@ int TemporaryPartitionedStore::putRecord(
     RecordTimestamp timestamp,
     copyset_t copyset,
     LocalLogStoreRecordFormat::flags_t extra_flags,
-    folly::Optional<Slice> payload) {
+    folly::Optional<Slice> payload,
+    const std::map<KeyType, std::string>& optional_keys) {
   LocalLogStoreRecordFormat::flags_t flags =
       extra_flags | LocalLogStoreRecordFormat::FLAG_SHARD_ID;
   if (!(flags &
@@ -342,7 +349,7 @@ int TemporaryPartitionedStore::putRecord(
       folly::Range<const ShardID*>(
           copyset.data(), copyset.data() + copyset.size()),
       OffsetMap::fromLegacy(0), // offsets
-      {},                       // keys
+      optional_keys,
       &header_buf);
 
   std::string csi_entry_buf;
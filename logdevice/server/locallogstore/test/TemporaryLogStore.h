@@ -91,6 +91,8 @@ class TemporaryLogStore : public LocalLogStore {
   int updateLogMetadata(logid_t log_id,
                         ComparableLogMetadata& metadata,
                         const WriteOptions& options) override;
+  void updateLogMetadataMulti(std::vector<LogMetadataUpdate>& updates,
+                              const WriteOptions& options) override;
   int readStoreMetadata(StoreMetadata* metadata) override;
   int writeStoreMetadata(const StoreMetadata& metadata,
                          const WriteOptions& options) override;
@@ -182,7 +184,8 @@ struct TemporaryPartitionedStore : public TemporaryLogStore {
                 RecordTimestamp timestamp,
                 copyset_t copyset,
                 LocalLogStoreRecordFormat::flags_t extra_flags = 0,
-                folly::Optional<Slice> payload = folly::none);
+                folly::Optional<Slice> payload = folly::none,
+                const std::map<KeyType, std::string>& optional_keys = {});
 
   void createPartition();
 
@@ -8,7 +8,9 @@
 #define __STDC_FORMAT_MACROS
 #include "logdevice/server/read_path/AllServerReadStreams.h"
 
+#include <algorithm>
 #include <functional>
+#include <tuple>
 #include <utility>
 
 #include <folly/Memory.h>
@@ -361,7 +363,7 @@ void AllServerReadStreams::onReadTaskDropped(ReadStorageTask& task) {
   // We're on worker thread.
   CatchupQueue* q = task.catchup_queue_.get().get();
   if (q) {
-    q->onStorageTaskDropped(task.stream_.get().get());
+    q->onReadTaskDropped(task);
   } else {
     // Client disconnected.
   }
@@ -577,12 +579,24 @@ int AllServerReadStreams::updateSubscription(logid_t log_id,
     log_state->subscribeWorker(worker_id_);
   } else {
     log_state->unsubscribeWorker(worker_id_);
+    if (streams_.get<LogIndex>().count(log_id) == 0) {
+      // Nobody left on this worker to read the shared tail of this log.
+      shared_tail_.erase(log_id);
+    }
   }
   return 0;
 }
 
 void AllServerReadStreams::getCatchupQueuesDebugInfo(
-    InfoCatchupQueuesTable& table) {
+    InfoCatchupQueuesTable& table,
+    ClientID client_id) {
+  if (client_id.valid()) {
+    auto it = client_states_.find(client_id);
+    if (it != client_states_.end() && it->second.catchup_queue) {
+      it->second.catchup_queue->getDebugInfo(table);
+    }
+    return;
+  }
   for (auto& c : client_states_) {
     if (c.second.catchup_queue) {
       c.second.catchup_queue->getDebugInfo(table);
@@ -592,30 +606,37 @@ void AllServerReadStreams::getCatchupQueuesDebugInfo(
 
 void AllServerReadStreams::getReadStreamsDebugInfo(
     ClientID client_id,
-    InfoReadersTable& table) const {
+    InfoReadersTable& table,
+    shard_index_t shard) const {
   const auto& client_index = streams_.get<ClientIndex>();
   auto range = client_index.equal_range(client_id);
-  std::string out;
   for (auto it = range.first; it != range.second; ++it) {
-    it->getDebugInfo(table);
+    if (shard == -1 || it->shard_ == shard) {
+      it->getDebugInfo(table);
+    }
   }
 }
 
 void AllServerReadStreams::getReadStreamsDebugInfo(
     logid_t log_id,
-    InfoReadersTable& table) const {
+    InfoReadersTable& table,
+    shard_index_t shard) const {
   const auto& log_index = streams_.get<LogIndex>();
   auto range = log_index.equal_range(log_id);
-  std::string out;
   for (auto it = range.first; it != range.second; ++it) {
-    it->getDebugInfo(table);
+    if (shard == -1 || it->shard_ == shard) {
+      it->getDebugInfo(table);
+    }
   }
 }
 
 void AllServerReadStreams::getReadStreamsDebugInfo(
-    InfoReadersTable& table) const {
+    InfoReadersTable& table,
+    shard_index_t shard) const {
   for (const ServerReadStream& stream : streams_) {
-    stream.getDebugInfo(table);
+    if (shard == -1 || stream.shard_ == shard) {
+      stream.getDebugInfo(table);
+    }
   }
 }
 
@@ -693,8 +714,74 @@ void AllServerReadStreams::sendStorageTask(
     shard_index_t shard) {
   ServerWorker* worker = ServerWorker::onThisThread();
   ld_check(worker);
-  auto task_queue = worker->getStorageTaskQueueForShard(shard);
-  task_queue->putTask(std::move(task));
+  const size_t batch_size = settings_->read_storage_tasks_batch_size;
+  if (batch_size <= 1) {
+    auto task_queue = worker->getStorageTaskQueueForShard(shard);
+    task_queue->putTask(std::move(task));
+    return;
+  }
+
+  auto& pending = pending_read_batches_[shard];
+  pending.push_back(std::move(task));
+  if (!flush_read_batches_timer_.isAssigned()) {
+    flush_read_batches_timer_.assign([this] { flushReadStorageTaskBatches(); });
+  }
+  if (!flush_read_batches_timer_.isActive()) {
+    flush_read_batches_timer_.activate(std::chrono::microseconds(0));
+  }
+}
+
+void AllServerReadStreams::flushReadStorageTaskBatches() {
+  ServerWorker* worker = ServerWorker::onThisThread();
+  ld_check(worker);
+  const size_t batch_size =
+      std::max(settings_->read_storage_tasks_batch_size, size_t(1));
+
+  auto pending_batches = std::move(pending_read_batches_);
+  pending_read_batches_.clear();
+
+  for (auto& kv : pending_batches) {
+    auto& tasks = kv.second;
+    // Only tasks that would be scheduled identically can share a storage
+    // task. Within such a group, execute reads in (log, lsn) order so that
+    // readers of the same or adjacent logs hit the same blocks.
+    auto as_tuple = [](const std::unique_ptr<ReadStorageTask>& t) {
+      return std::make_tuple(t->getThreadType(),
+                             t->getPriority(),
+                             t->getPrincipal(),
+                             t->getReadPriority(),
+                             t->read_ctx_.logid_,
+                             t->read_ctx_.read_ptr_.lsn);
+    };
+    std::stable_sort(tasks.begin(),
+                     tasks.end(),
+                     [&](const std::unique_ptr<ReadStorageTask>& a,
+                         const std::unique_ptr<ReadStorageTask>& b) {
+                       return as_tuple(a) < as_tuple(b);
+                     });
+
+    auto task_queue = worker->getStorageTaskQueueForShard(kv.first);
+    std::unique_ptr<ReadStorageTask> leader;
+    for (auto& task : tasks) {
+      if (leader &&
+          (leader->batchSize() >= batch_size ||
+           leader->getThreadType() != task->getThreadType() ||
+           leader->getPriority() != task->getPriority() ||
+           leader->getPrincipal() != task->getPrincipal() ||
+           leader->getReadPriority() != task->getReadPriority())) {
+        task_queue->putTask(std::move(leader));
+      }
+      if (!leader) {
+        leader = std::move(task);
+      } else {
+        leader->addToBatch(std::move(task));
+        STAT_INCR(stats_, read_storage_tasks_batched);
+      }
+    }
+    if (leader) {
+      task_queue->putTask(std::move(leader));
+    }
+  }
 }
 
 ResourceBudget& AllServerReadStreams::getMemoryBudget() {
@@ -728,11 +815,20 @@ void AllServerReadStreams::evictRealTimeLog(logid_t logid) {
   ld_check(logid != LOGID_INVALID);
   ld_check(logid != LOGID_INVALID2);
 
+  // The shared tail may be the only holder of released records for this log.
+  bool had_shared_tail = false;
+  auto shared = shared_tail_.find(logid);
+  if (shared != shared_tail_.end()) {
+    STAT_ADD(stats_, real_time_record_buffer_eviction, shared->second.size());
+    shared_tail_.erase(shared);
+    had_shared_tail = true;
+  }
+
   auto range = streams_.get<LogIndex>().equal_range(logid);
   // Items can only ever come off on this thread, so nothing should have
   // removed entries / read streams between the "toEvict()' call above and the
   // "equal_range' call.
-  ld_check(range.first != range.second);
+  ld_check(had_shared_tail || range.first != range.second);
   for (auto it = range.first; it != range.second; ++it) {
     auto recs = deref(it).giveReleasedRecords();
     STAT_ADD(stats_, real_time_record_buffer_eviction, recs.size());
@@ -879,12 +975,33 @@ void AllServerReadStreams::distributeNewlyReleasedRecords() {
         real_time_record_buffer_.addToLRU(records->logid_);
         std::shared_ptr<ReleasedRecords> ptr{records.release()};
         auto range = streams_.get<LogIndex>().equal_range(ptr->logid_);
+        if (range.first == range.second) {
+          return;
+        }
         for (auto it = range.first; it != range.second; ++it) {
           deref(it).addReleasedRecords(ptr);
         }
+        const size_t max_shared = settings_->real_time_shared_tail_batches;
+        if (max_shared > 0) {
+          auto& tail = shared_tail_[ptr->logid_];
+          tail.push_back(ptr);
+          while (tail.size() > max_shared) {
+            tail.pop_front();
+          }
+        }
       });
 }
 
+std::vector<std::shared_ptr<ReleasedRecords>>
+AllServerReadStreams::getSharedTailRecords(logid_t logid) const {
+  auto it = shared_tail_.find(logid);
+  if (it == shared_tail_.end()) {
+    return {};
+  }
+  return std::vector<std::shared_ptr<ReleasedRecords>>(
+      it->second.begin(), it->second.end());
+}
+
 Request::Execution EvictRealTimeRequest::execute() {
   ServerWorker::onThisThread()->serverReadStreams().evictRealTime();
   return Request::Execution::COMPLETE;
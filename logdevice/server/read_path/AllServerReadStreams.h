@@ -7,9 +7,11 @@
  */
 #pragma once
 
+#include <deque>
 #include <map>
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include <utility>
 
 #include <boost/multi_index/composite_key.hpp>
@@ -261,6 +263,7 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
 
     streams_.clear();
     client_states_.clear();
+    shared_tail_.clear();
     // Free all released records that we didn't get around to sending.
     // This moves EpochRecordCacheEntrys to various workers, so
     // must be run before the Worker::~Worker() is called.
@@ -325,6 +328,15 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
     real_time_record_buffer_.used(logid);
   }
 
+  /**
+   * Returns the most recent batches of released records of the given log that
+   * were distributed on this worker, oldest first. Used by read streams that
+   * fell behind the records they were given. Empty unless
+   * Settings::real_time_shared_tail_batches > 0.
+   */
+  std::vector<std::shared_ptr<ReleasedRecords>>
+  getSharedTailRecords(logid_t logid) const;
+
   /**
    * Callback, called when settings_ changes.
    */
@@ -333,15 +345,24 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // The following functions return a string of human-readable
   // debug information about ServerReadStream_s.
 
-  void getCatchupQueuesDebugInfo(InfoCatchupQueuesTable& table);
+  // If `client_id` is valid, only the CatchupQueue of that client.
+  void getCatchupQueuesDebugInfo(InfoCatchupQueuesTable& table,
+                                 ClientID client_id = ClientID::INVALID);
+
+  // In the functions below, if `shard` is not -1, only the streams reading
+  // from that shard are included.
 
   // All streams associated with a client.
   void getReadStreamsDebugInfo(ClientID client_id,
-                               InfoReadersTable& table) const;
+                               InfoReadersTable& table,
+                               shard_index_t shard = -1) const;
   // All streams associated with a logid.
-  void getReadStreamsDebugInfo(logid_t log_id, InfoReadersTable& table) const;
+  void getReadStreamsDebugInfo(logid_t log_id,
+                               InfoReadersTable& table,
+                               shard_index_t shard = -1) const;
   // All streams.
-  void getReadStreamsDebugInfo(InfoReadersTable& table) const;
+  void getReadStreamsDebugInfo(InfoReadersTable& table,
+                               shard_index_t shard = -1) const;
 
   void blockUnblockClient(ClientID cid, bool block);
 
@@ -373,6 +394,13 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // event loop iteration.
   virtual void scheduleSendDelayedStorageTasks();
 
+  /**
+   * Groups the tasks accumulated in pending_read_batches_ into batches of at
+   * most Settings::read_storage_tasks_batch_size tasks and sends them to
+   * storage threads.
+   */
+  void flushReadStorageTaskBatches();
+
  protected:
   //
   // Main data structure containing ServerReadStream instances.  We use a
@@ -441,6 +469,17 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
 
   RealTimeRecordBuffer real_time_record_buffer_;
 
+  // Per log, the last Settings::real_time_shared_tail_batches batches of
+  // released records distributed by distributeNewlyReleasedRecords(). These
+  // keep the records alive (and accounted in real_time_record_buffer_) after
+  // read streams are done with their own references, so that other streams
+  // of the log can still read them. Entries are dropped when the log is
+  // evicted from the real time buffer or has no more read streams.
+  std::unordered_map<logid_t,
+                     std::deque<std::shared_ptr<ReleasedRecords>>,
+                     logid_t::Hash>
+      shared_tail_;
+
   /**
    * Retrieve a ServerReadStream behind an iterator. boost::multi_index does not
    * allow retrieving a non const ServerReadStream because modifying its
@@ -548,6 +587,16 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // away because it's not nice to post more tasks from onDropped() callback.
   Timer send_delayed_storage_tasks_timer_;
 
+  // If Settings::read_storage_tasks_batch_size > 1, ReadStorageTasks passed to
+  // sendStorageTask() are accumulated here, per shard, until the end of the
+  // current event loop iteration and then sent in batches by
+  // flushReadStorageTaskBatches().
+  std::map<shard_index_t, std::vector<std::unique_ptr<ReadStorageTask>>>
+      pending_read_batches_;
+
+  // A zero-delay timer calling flushReadStorageTaskBatches().
+  Timer flush_read_batches_timer_;
+
   // Worker ID we are on, used to manage subscriptions for RELEASE messages.
   // In production, this is always equal to Worker::onThisThread()->idx_.  In
   // unit tests where there is no Worker, the test supplies a fake value.
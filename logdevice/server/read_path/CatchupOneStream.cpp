@@ -9,15 +9,18 @@
 
 #include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <utility>
 
 #include <folly/CppAttributes.h>
 #include <folly/Optional.h>
+#include <folly/io/IOBuf.h>
 
 #include "logdevice/common/BWAvailableCallback.h"
 #include "logdevice/common/Checksum.h"
+#include "logdevice/common/E2ETracer.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
 #include "logdevice/common/Metadata.h"
 #include "logdevice/common/Sender.h"
@@ -182,12 +185,20 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
 
   int processRecord(const RawRecord& record) override;
 
+  /**
+   * If set, the blob of the records being processed is held by `blob_buf`,
+   * and RECORD messages reference payloads in it instead of copying them.
+   */
+  void setBlobBuffer(const folly::IOBuf* blob_buf) {
+    blob_buf_ = blob_buf;
+  }
+
   int nrecords_ = 0;
 
   int processRecord(const lsn_t lsn,
                     const std::chrono::milliseconds timestamp,
                     const LocalLogStoreRecordFormat::flags_t flags,
-                    const std::map<KeyType, std::string>& optional_keys,
+                    folly::Optional<folly::StringPiece> filterable_key,
                     const Payload& payload,
                     const uint32_t wave,
                     const esn_t last_known_good,
@@ -221,6 +232,7 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
   LocalLogStore* store_;
   ServerReadStream::RecordSource source_;
   CatchupEventTrigger catchup_reason_;
+  const folly::IOBuf* blob_buf_ = nullptr;
 };
 
 int ReadingCallback::processRecord(const RawRecord& record) {
@@ -230,7 +242,7 @@ int ReadingCallback::processRecord(const RawRecord& record) {
   std::chrono::milliseconds timestamp;
   Payload payload;
   LocalLogStoreRecordFormat::flags_t flags;
-  std::map<KeyType, std::string> optional_keys;
+  folly::Optional<folly::StringPiece> filterable_key;
   copyset_size_t copyset_size;
   esn_t last_known_good;
   ShardID* copyset = nullptr;
@@ -240,7 +252,8 @@ int ReadingCallback::processRecord(const RawRecord& record) {
   if (stream_->include_extra_metadata_) {
     copyset = (ShardID*)alloca(COPYSET_SIZE_MAX * sizeof(ShardID));
   }
-  int rv = LocalLogStoreRecordFormat::parse(
+  // The filterable key is not copied, it points into record.blob.
+  int rv = LocalLogStoreRecordFormat::parseWithOptionalKey(
       record.blob,
       &timestamp,
       &last_known_good,
@@ -250,7 +263,8 @@ int ReadingCallback::processRecord(const RawRecord& record) {
       stream_->include_extra_metadata_ ? copyset : nullptr,
       COPYSET_SIZE_MAX,
       &offsets_within_epoch,
-      stream_->filter_pred_ != nullptr ? &optional_keys : nullptr,
+      KeyType::FILTERABLE,
+      stream_->filter_pred_ != nullptr ? &filterable_key : nullptr,
       &payload,
       stream_->shard_);
 
@@ -281,7 +295,7 @@ int ReadingCallback::processRecord(const RawRecord& record) {
   return processRecord(lsn,
                        timestamp,
                        flags,
-                       optional_keys,
+                       filterable_key,
                        payload,
                        wave,
                        last_known_good,
@@ -294,7 +308,7 @@ int ReadingCallback::processRecord(
     const lsn_t lsn,
     const std::chrono::milliseconds timestamp,
     const LocalLogStoreRecordFormat::flags_t flags,
-    const std::map<KeyType, std::string>& optional_keys,
+    folly::Optional<folly::StringPiece> filterable_key,
     const Payload& payload,
     const uint32_t wave,
     const esn_t last_known_good,
@@ -310,13 +324,9 @@ int ReadingCallback::processRecord(
   bool filtered_out = false;
 
   if (stream_->filter_pred_ != nullptr &&
-      (flags & LocalLogStoreRecordFormat::FLAG_OPTIONAL_KEYS)) {
-    const auto it = optional_keys.find(KeyType::FILTERABLE);
-    if (it != optional_keys.end()) {
-      if (!(*stream_->filter_pred_)(it->second)) {
-        filtered_out = true;
-      }
-    }
+      (flags & LocalLogStoreRecordFormat::FLAG_OPTIONAL_KEYS) &&
+      filterable_key.hasValue()) {
+    filtered_out = !(*stream_->filter_pred_)(filterable_key.value());
   }
 
   // Insert a TRIM gap for any records before this one that have been trimmed
@@ -359,23 +369,6 @@ int ReadingCallback::processRecord(
   // Iterators are expected to skip amends that don't correspond to any record.
   ld_check(!(flags & LocalLogStoreRecordFormat::FLAG_AMEND));
 
-  std::unique_ptr<ExtraMetadata> extra_metadata;
-  if (stream_->include_extra_metadata_) {
-    DCHECK_NOTNULL(copyset);
-    extra_metadata = this->prepareExtraMetadata(
-        last_known_good, wave, copyset, copyset_size, offsets_within_epoch);
-  }
-
-  OffsetMap offsets;
-  if (stream_->include_byte_offset_ && offsets_within_epoch.isValid()) {
-    // epoch OffsetMap value has to be known to determine global OffsetMap.
-    OffsetMap epoch_offsets = getEpochOffsets(lsn_to_epoch(lsn), log_state);
-    if (epoch_offsets.isValid()) {
-      offsets = OffsetMap::mergeOffsets(
-          std::move(epoch_offsets), offsets_within_epoch);
-    }
-  }
-
   if (filtered_out) {
     // If filtered_out_end_lsn_ is not lsn - 1, FILTERED_OUT gap is not
     // continuous between filtered_out_end_lsn_ and lsn. We deliver last
@@ -401,6 +394,24 @@ int ReadingCallback::processRecord(
       return -1;
     }
 
+    // Only computed for records we ship, most records may be filtered out.
+    std::unique_ptr<ExtraMetadata> extra_metadata;
+    if (stream_->include_extra_metadata_) {
+      DCHECK_NOTNULL(copyset);
+      extra_metadata = this->prepareExtraMetadata(
+          last_known_good, wave, copyset, copyset_size, offsets_within_epoch);
+    }
+
+    OffsetMap offsets;
+    if (stream_->include_byte_offset_ && offsets_within_epoch.isValid()) {
+      // epoch OffsetMap value has to be known to determine global OffsetMap.
+      OffsetMap epoch_offsets = getEpochOffsets(lsn_to_epoch(lsn), log_state);
+      if (epoch_offsets.isValid()) {
+        offsets = OffsetMap::mergeOffsets(
+            std::move(epoch_offsets), offsets_within_epoch);
+      }
+    }
+
     int rv = shipRecord(lsn,
                         timestamp,
                         flags,
@@ -630,6 +641,16 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     h.length = static_cast<uint32_t>(payload.size());
     h.hash = checksum_32bit(Slice(payload));
     payload_holder = PayloadHolder::copyBuffer(&h, sizeof(h));
+  } else if (blob_buf_ != nullptr && payload.size() > 0) {
+    // The payload is a slice of a blob we own. Share it with the message
+    // instead of copying; the blob lives until the message is destroyed.
+    const uint8_t* start = static_cast<const uint8_t*>(payload.data());
+    ld_check(start >= blob_buf_->data());
+    ld_check(start + payload.size() <= blob_buf_->tail());
+    folly::IOBuf buf = blob_buf_->cloneOneAsValue();
+    buf.trimStart(start - blob_buf_->data());
+    buf.trimEnd(buf.length() - payload.size());
+    payload_holder = PayloadHolder(std::move(buf));
   } else {
     // Make private copy of the data so it is stable for the lifetime of
     // the, possibly deferred on transmission, RECORD message.
@@ -700,6 +721,12 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     latency *= 1000;
 
     HISTOGRAM_ADD(Worker::stats(), write_to_read_latency, latency);
+    if (stream_->log_group_path_) {
+      LOG_GROUP_HISTOGRAM_ADD(Worker::stats(),
+                              write_to_read_latency,
+                              *stream_->log_group_path_,
+                              latency);
+    }
   }
 
   size_t& bytes_queued = catchup_->record_bytes_queued_;
@@ -984,6 +1011,9 @@ CatchupOneStream::startRead(WeakRef<CatchupQueue> catchup_queue,
   // released records <= last_released will be processed below.
   deps_.distributeNewlyReleasedRecords();
   auto released_records = stream_->giveReleasedRecords();
+  if (deps_.getSettings().real_time_shared_tail_batches > 0) {
+    addSharedTailRecords(released_records, read_ctx.read_ptr_.lsn);
+  }
 
   ld_spew("Real time reads: log id %s read ptr %s first real time record %s",
           toString(stream_->log_id_).c_str(),
@@ -1005,9 +1035,13 @@ CatchupOneStream::startRead(WeakRef<CatchupQueue> catchup_queue,
     Action action = pushReleasedRecords(released_records, read_ctx);
     if (action != Action::NOT_IN_REAL_TIME_BUFFER) {
       deps_.used(stream_->log_id_);
+      STAT_INCR(deps_.getStatsHolder(), real_time_read_batch_hits);
       return action;
     }
   }
+  if (deps_.getSettings().real_time_reads_enabled) {
+    STAT_INCR(deps_.getStatsHolder(), real_time_read_batch_misses);
+  }
 
   if (try_non_blocking_read && !inject_latency) {
     // First try an immediate non-blocking read on the current worker
@@ -1052,6 +1086,38 @@ CatchupOneStream::startRead(WeakRef<CatchupQueue> catchup_queue,
   return Action::WAIT_FOR_STORAGE_TASK;
 }
 
+void CatchupOneStream::addSharedTailRecords(
+    std::vector<std::shared_ptr<ReleasedRecords>>& released_records,
+    lsn_t read_ptr) {
+  if (!released_records.empty() && !(*released_records.front() > read_ptr)) {
+    // The stream's own records already cover the read pointer.
+    return;
+  }
+
+  std::vector<std::shared_ptr<ReleasedRecords>> merged;
+  for (auto& rec : deps_.getSharedTailRecords(stream_->log_id_)) {
+    if (*rec < read_ptr) {
+      // Already delivered.
+      continue;
+    }
+    if (!released_records.empty() &&
+        !(*rec < released_records.front()->begin_lsn_)) {
+      // The stream has this batch and everything after it.
+      break;
+    }
+    merged.push_back(std::move(rec));
+  }
+  if (merged.empty()) {
+    return;
+  }
+
+  STAT_ADD(deps_.getStatsHolder(), real_time_shared_tail_hits, merged.size());
+  merged.insert(merged.end(),
+                std::make_move_iterator(released_records.begin()),
+                std::make_move_iterator(released_records.end()));
+  released_records = std::move(merged);
+}
+
 CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
     std::vector<std::shared_ptr<ReleasedRecords>>& released_records,
     LocalLogStoreReader::ReadContext& read_ctx) {
@@ -1216,11 +1282,19 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
 
       nrecords++;
 
+      folly::Optional<folly::StringPiece> filterable_key;
+      if (stream_->filter_pred_ != nullptr) {
+        auto key_it = entry->keys.find(KeyType::FILTERABLE);
+        if (key_it != entry->keys.end()) {
+          filterable_key = folly::StringPiece(key_it->second);
+        }
+      }
+
       int rv =
           callback.processRecord(entry->lsn,
                                  std::chrono::milliseconds(entry->timestamp),
                                  entry->flags,
-                                 entry->keys,
+                                 filterable_key,
                                  entry->payload.getPayload(),
                                  entry->wave_or_recovery_epoch,
                                  entry->last_known_good,
@@ -1288,7 +1362,9 @@ CatchupOneStream::readNonBlocking(WeakRef<CatchupQueue> /*catchup_queue*/,
                            stream_,
                            ServerReadStream::RecordSource::NON_BLOCKING,
                            read_ctx.catchup_reason_);
+  const auto read_start = std::chrono::steady_clock::now();
   Status status = deps_.read(read_iterator.get(), callback, &read_ctx);
+  traceRead(read_start, status, callback.nrecords_, /*blocking=*/false);
 
   stream_ld_debug(*stream_,
                   "got %d records without blocking, status=%s",
@@ -1330,6 +1406,31 @@ CatchupOneStream::readNonBlocking(WeakRef<CatchupQueue> /*catchup_queue*/,
   return handleBatchEnd(stream_->version_, status, read_ctx.read_ptr_);
 }
 
+void CatchupOneStream::traceRead(std::chrono::steady_clock::time_point start,
+                                 Status status,
+                                 size_t nrecords,
+                                 bool blocking) const {
+  if (stream_->e2e_trace_id_ == E2E_TRACE_ID_INVALID) {
+    return;
+  }
+  ServerWorker* w = ServerWorker::onThisThread(false);
+  if (!w) {
+    // Tests.
+    return;
+  }
+  E2ETracer(w->getTraceLogger())
+      .traceSpan(stream_->e2e_trace_id_,
+                 "catchup_read",
+                 stream_->log_id_,
+                 stream_->getReadPtr().lsn,
+                 status,
+                 start,
+                 std::chrono::steady_clock::now(),
+                 {{"records", int64_t(nrecords)},
+                  {"blocking", blocking},
+                  {"shard", stream_->shard_}});
+}
+
 void CatchupOneStream::readOnStorageThread(
     WeakRef<CatchupQueue> catchup_queue,
     LocalLogStoreReader::ReadContext& read_ctx,
@@ -1432,6 +1533,10 @@ CatchupOneStream::processTask(const ReadStorageTask& task) {
                   error_description(task.status_));
 
   ld_check(task.status_ != E::UNKNOWN);
+  traceRead(task.enqueue_time_,
+            task.status_,
+            task.records_.size(),
+            /*blocking=*/true);
 
   bool accessed_under_replicated_region =
       task.owned_iterator_ && // May be null in tests.
@@ -1614,7 +1719,7 @@ int CatchupOneStream::sendGapFilteredOutIfNeeded(lsn_t trim_point) {
 }
 
 CatchupOneStream::Action CatchupOneStream::processRecords(
-    const std::vector<RawRecord>& records,
+    std::vector<RawRecord>& records,
     server_read_stream_version_t version,
     const LocalLogStoreReader::ReadPointer& read_ptr,
     bool accessed_under_replicated_region,
@@ -1624,8 +1729,24 @@ CatchupOneStream::Action CatchupOneStream::processRecords(
   // in the non-blocking read path.
   ReadingCallback callback(
       this, stream_, ServerReadStream::RecordSource::BLOCKING, catchup_reason);
-  for (const RawRecord& record : records) {
-    if (callback.processRecord(record) != 0) {
+  for (RawRecord& record : records) {
+    folly::IOBuf blob_buf;
+    const bool share_blob = record.owned && record.blob.size > 0;
+    if (share_blob) {
+      // Move the malloc'd blob into a refcounted IOBuf that RECORD messages
+      // can point into. It's freed once this iteration and all messages
+      // referencing it are done with it.
+      blob_buf = folly::IOBuf(folly::IOBuf::TAKE_OWNERSHIP,
+                              const_cast<void*>(record.blob.data),
+                              record.blob.size);
+      record.owned = false;
+    }
+    callback.setBlobBuffer(share_blob ? &blob_buf : nullptr);
+    int rv = callback.processRecord(record);
+    if (share_blob) {
+      record.blob = Slice();
+    }
+    if (rv != 0) {
       ld_check(err != E::CBREGISTERED);
       stream_ld_debug(*stream_,
                       "Could not process record with lsn %s. Aborting.",
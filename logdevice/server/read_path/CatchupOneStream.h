@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <string>
 
 #include "logdevice/common/StorageTask-enums.h"
@@ -182,9 +183,23 @@ class CatchupOneStream {
   Action pushReleasedRecords(std::vector<std::shared_ptr<ReleasedRecords>>&,
                              LocalLogStoreReader::ReadContext& read_ctx);
 
+  /**
+   * If the stream is behind the first of `released_records` (or has none),
+   * prepends the batches from the log's shared tail that it hasn't read yet
+   * (see Settings::real_time_shared_tail_batches), so that they can be
+   * delivered without reading from the local log store.
+   */
+  void addSharedTailRecords(
+      std::vector<std::shared_ptr<ReleasedRecords>>& released_records,
+      lsn_t read_ptr);
+
   Action processTask(const ReadStorageTask& task);
 
-  Action processRecords(const std::vector<RawRecord>& records,
+  /**
+   * Ships a batch of records read by a storage task. Takes ownership of the
+   * blobs of owned records so that RECORD messages can share them.
+   */
+  Action processRecords(std::vector<RawRecord>& records,
                         server_read_stream_version_t version,
                         const LocalLogStoreReader::ReadPointer& read_ptr,
                         bool accessed_under_replicated_region,
@@ -297,6 +312,14 @@ class CatchupOneStream {
                     bool first_record_any_size,
                     CatchupEventTrigger catchup_reason);
 
+  /**
+   * Publishes a "catchup_read" span if the stream is traced, see E2ETracer.
+   */
+  void traceRead(std::chrono::steady_clock::time_point start,
+                 Status status,
+                 size_t nrecords,
+                 bool blocking) const;
+
   std::tuple<StorageTaskType,
              StorageTaskThreadType,
              StorageTaskPriority,
@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/read_path/CatchupQueue.h"
 
+#include <algorithm>
+
 #include <folly/Optional.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -30,6 +32,7 @@
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 #include "logdevice/server/read_path/ServerReadStream.h"
+#include "logdevice/server/read_path/ServerStalledReadTracer.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/ReadStorageTask.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
@@ -41,6 +44,29 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+// What a stream waits for after CatchupOneStream returned `act` for it.
+ServerReadStream::WaitState waitStateAfter(const ServerReadStream& stream,
+                                           CatchupOneStream::Action act) {
+  using WaitState = ServerReadStream::WaitState;
+  switch (act) {
+    case CatchupOneStream::Action::WAIT_FOR_STORAGE_TASK:
+    case CatchupOneStream::Action::WAIT_FOR_LNG:
+      return WaitState::STORAGE_TASK;
+    case CatchupOneStream::Action::WAIT_FOR_BANDWIDTH:
+      return WaitState::NETWORK_BANDWIDTH;
+    case CatchupOneStream::Action::WAIT_FOR_READ_BANDWIDTH:
+      return WaitState::READ_BANDWIDTH;
+    case CatchupOneStream::Action::DEQUEUE_AND_CONTINUE:
+      return stream.isPastWindow() ? WaitState::WINDOW : WaitState::RELEASE;
+    default:
+      return WaitState::QUEUED;
+  }
+}
+
+} // namespace
+
 CatchupQueueDependencies::CatchupQueueDependencies(
     AllServerReadStreams* all_server_read_streams,
     StatsHolder* stats_holder)
@@ -74,6 +100,7 @@ CatchupQueue::~CatchupQueue() = default;
 void CatchupQueue::add(ServerReadStream& stream, CatchupQueue::PushMode mode) {
   using std::chrono::steady_clock;
   stream.last_enqueued_time_ = steady_clock::now();
+  noteWaitState(stream, ServerReadStream::WaitState::QUEUED);
 
   ld_check(!stream.isCatchingUp());
 
@@ -231,6 +258,7 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
         // Ping timer will trigger a retry for this stream.
         STAT_INCR(deps_->getStatsHolder(), read_streams_transient_errors);
       }
+      noteWaitState(*stream, ServerReadStream::WaitState::NETWORK_BANDWIDTH);
       break;
     }
 
@@ -239,6 +267,7 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
     using std::chrono::steady_clock;
     stream->last_batch_started_time_ = steady_clock::now();
     stream->last_batch_status_ = "(not assigned)";
+    noteWaitState(*stream, ServerReadStream::WaitState::NONE);
     uint64_t t =
         std::chrono::duration_cast<std::chrono::microseconds>(
             stream->last_batch_started_time_ - stream->last_enqueued_time_)
@@ -246,6 +275,19 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
     STAT_ADD(deps_->getStatsHolder(), read_streams_batch_queue_microsec, t);
 
     ld_check_lt(record_bytes_queued_, max_record_bytes_queued);
+    size_t max_batch_bytes = max_record_bytes_queued - record_bytes_queued_;
+    const auto& settings = deps_->getSettings();
+    if (settings.read_batch_target_drain_time.count() > 0) {
+      max_batch_bytes = stream->batch_size_controller_.getBatchBytes(
+          std::min(settings.read_batch_min_bytes, max_batch_bytes),
+          max_batch_bytes,
+          settings.read_batch_target_drain_time);
+    }
+
+    // Digest streams don't have to wait for the regular storage task slot if
+    // a digest slot is free.
+    const bool digest_slot = canUseDigestSlot(*stream);
+    stream->in_digest_lane_ = digest_slot;
 
     CatchupOneStream::Action act;
     size_t n_bytes_queued;
@@ -256,11 +298,12 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
                                &*stream,
                                ref_holder_.ref(),
                                try_non_blocking_read,
-                               max_record_bytes_queued - record_bytes_queued_,
+                               max_batch_bytes,
                                record_bytes_queued_ == 0,
-                               !storage_task_in_flight_,
+                               digest_slot || !storage_task_in_flight_,
                                catchup_reason);
     record_bytes_queued_ += n_bytes_queued;
+    stream->batch_size_controller_.onBytesQueued(n_bytes_queued);
 
     // Note: storage_task_in_flight_ is NOT updated in the above call to
     // CatchupOneStream::read(), but stream->storage_task_in_flight_ is.  Also,
@@ -274,6 +317,24 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
       }
     }
 
+    if (digest_slot) {
+      // Streams that ignore the release status never need a ReadLngTask.
+      ld_check(act != CatchupOneStream::Action::WAIT_FOR_LNG);
+      if (act == CatchupOneStream::Action::WAIT_FOR_STORAGE_TASK) {
+        ld_check(stream->storage_task_in_flight_);
+        ++digest_tasks_in_flight_;
+        queue_.erase(stream);
+        digest_in_flight_.push_back(*stream);
+        stream_ld_debug(*stream, "Issued storage task in a digest slot");
+        noteWaitState(*stream,
+                      ServerReadStream::WaitState::STORAGE_TASK,
+                      n_bytes_queued > 0);
+        // onReadTaskDone() will call onBatchComplete().
+        continue;
+      }
+      stream->in_digest_lane_ = false;
+    }
+
     // The stream should have a storage task in flight iff we returned a
     // WAIT_FOR_*.
     if (act == CatchupOneStream::Action::WAIT_FOR_STORAGE_TASK ||
@@ -296,6 +357,11 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
                     "Read on worker thread completes with %s",
                     CatchupOneStream::action_names[act].c_str());
 
+    if (act != CatchupOneStream::Action::ERASE_AND_CONTINUE &&
+        act != CatchupOneStream::Action::PERMANENT_ERROR) {
+      noteWaitState(*stream, waitStateAfter(*stream, act), n_bytes_queued > 0);
+    }
+
     if (act == CatchupOneStream::Action::TRANSIENT_ERROR) {
       // Ping timer will trigger a retry for this stream.
       STAT_INCR(deps_->getStatsHolder(), read_streams_transient_errors);
@@ -438,6 +504,8 @@ void CatchupQueue::onRecordSent(const RECORD_Message& msg,
     return;
   }
 
+  stream->batch_size_controller_.onBytesDrained(msg_size);
+
   // Handle the case of a stream rewind after we hit until lsn and
   // destroyed the ServerReadStream object.
   if (enqueue_time < stream->created_) {
@@ -685,6 +753,11 @@ void CatchupQueueDependencies::used(logid_t logid) {
   all_server_read_streams_->used(logid);
 }
 
+std::vector<std::shared_ptr<ReleasedRecords>>
+CatchupQueueDependencies::getSharedTailRecords(logid_t logid) {
+  return all_server_read_streams_->getSharedTailRecords(logid);
+}
+
 void CatchupQueueDependencies::invalidateIterators(ClientID client_id) {
   all_server_read_streams_->invalidateIterators(client_id);
 }
@@ -777,6 +850,31 @@ const Settings& CatchupQueueDependencies::getSettings() const {
   return Worker::settings();
 }
 
+void CatchupQueueDependencies::traceStall(const ServerReadStream& stream) {
+  Worker* worker = Worker::onThisThread(false);
+  if (!worker) {
+    return;
+  }
+  ServerStalledReadTracer tracer(worker->getTraceLogger());
+  tracer.traceStall(stream);
+}
+
+void CatchupQueue::noteWaitState(ServerReadStream& stream,
+                                 ServerReadStream::WaitState state,
+                                 bool progress) {
+  stream.setWaitState(state);
+  auto threshold = deps_->getSettings().read_stream_stall_trace_threshold;
+  if (!stream.stall_reported_ && threshold.count() > 0 &&
+      stream.getStallDuration() >= threshold) {
+    stream.stall_reported_ = true;
+    STAT_INCR(deps_->getStatsHolder(), read_streams_stalled);
+    deps_->traceStall(stream);
+  }
+  if (progress) {
+    stream.noteProgress();
+  }
+}
+
 void CatchupQueue::readThrottlingOnReadTaskDone(const ReadStorageTask& task) {
   // Reconcile our cost estimate with the actual cost of performing this I/O
   size_t cost_estimate = task.getThrottlingEstimate();
@@ -863,20 +961,28 @@ void CatchupQueue::onReadTaskDone(const ReadStorageTask& task) {
   resume_cb_.deactivate();
 
   ServerReadStream* stream = task.stream_.get().get();
-  onStorageTaskStopped(stream);
+  if (task.in_digest_lane_) {
+    onDigestTaskStopped(stream);
+  } else {
+    onStorageTaskStopped(stream);
+  }
   if (!stream) {
     // The ServerReadStreams was erased while the storage task was in flight.
     pushRecords();
     return;
   }
 
-  ld_check(stream == &queue_.front());
+  // A stream coming back from a digest slot was appended to queue_, the one
+  // owning the regular slot is at its front.
+  ld_check(task.in_digest_lane_ ? stream == &queue_.back()
+                                : stream == &queue_.front());
 
   size_t n_bytes_queued;
   CatchupOneStream::Action act;
   std::tie(act, n_bytes_queued) =
       CatchupOneStream::onReadTaskDone(*deps_, stream, task);
   record_bytes_queued_ += n_bytes_queued;
+  stream->batch_size_controller_.onBytesQueued(n_bytes_queued);
 
   onBatchComplete(stream);
 
@@ -884,6 +990,11 @@ void CatchupQueue::onReadTaskDone(const ReadStorageTask& task) {
                   "Read on storage thread completes with %s",
                   CatchupOneStream::action_names[act].c_str());
 
+  if (act != CatchupOneStream::Action::ERASE_AND_CONTINUE &&
+      act != CatchupOneStream::Action::PERMANENT_ERROR) {
+    noteWaitState(*stream, waitStateAfter(*stream, act), n_bytes_queued > 0);
+  }
+
   if (act == CatchupOneStream::Action::TRANSIENT_ERROR) {
     // We hit an error trying to send out a record to the client.
     adjustPingTimer();
@@ -901,7 +1012,7 @@ void CatchupQueue::onReadTaskDone(const ReadStorageTask& task) {
   }
 
   if (act == CatchupOneStream::Action::DEQUEUE_AND_CONTINUE) {
-    queue_.pop_front();
+    queue_.erase(queue_.iterator_to(*stream));
     ld_check(!stream->isCatchingUp());
     stream->adjustStatWhenCatchingUpChanged();
   } else if (act == CatchupOneStream::Action::ERASE_AND_CONTINUE) {
@@ -921,7 +1032,7 @@ void CatchupQueue::onReadTaskDone(const ReadStorageTask& task) {
     ld_check(act == CatchupOneStream::Action::REQUEUE_AND_DRAIN ||
              act == CatchupOneStream::Action::REQUEUE_AND_CONTINUE);
     // Move to the end of the queue.
-    queue_.pop_front();
+    queue_.erase(queue_.iterator_to(*stream));
     queue_.push_back(*stream);
     ld_check(stream->isCatchingUp());
   }
@@ -949,13 +1060,45 @@ void CatchupQueue::onStorageTaskStopped(const ServerReadStream* stream) {
   }
 }
 
+void CatchupQueue::onReadTaskDropped(const ReadStorageTask& task) {
+  if (!task.in_digest_lane_) {
+    onStorageTaskDropped(task.stream_.get().get());
+    return;
+  }
+  catchup_queue_ld_debug("Storage task in digest slot dropped");
+  onDigestTaskStopped(task.stream_.get().get());
+  adjustPingTimer();
+}
+
+bool CatchupQueue::canUseDigestSlot(const ServerReadStream& stream) const {
+  return stream.digest_ && stream.ignore_released_status_ &&
+      digest_tasks_in_flight_ <
+      deps_->getSettings().digest_read_tasks_per_client;
+}
+
+void CatchupQueue::onDigestTaskStopped(ServerReadStream* stream) {
+  ld_check(digest_tasks_in_flight_ > 0);
+  --digest_tasks_in_flight_;
+
+  if (stream != nullptr) {
+    ld_check(stream->storage_task_in_flight_);
+    ld_check(stream->in_digest_lane_);
+    stream->storage_task_in_flight_ = false;
+    stream->in_digest_lane_ = false;
+    digest_in_flight_.erase(digest_in_flight_.iterator_to(*stream));
+    queue_.push_back(*stream);
+  } else {
+    catchup_queue_ld_debug("Stream was erased while task was in flight");
+  }
+}
+
 void CatchupQueue::adjustPingTimer() {
   // If this class cannot get invoked again (because there are no RECORD
   // messages queued in the output evbuffer or outstanding storage tasks) but
   // there is still work to do, then we need to activate the timer to retry
   // later.
   if (record_bytes_queued_ == 0 && !resume_cb_.active() &&
-      !storage_task_in_flight_ &&
+      !storage_task_in_flight_ && digest_tasks_in_flight_ == 0 &&
       (!queue_.empty() || !queue_delayed_.empty())) {
     STAT_INCR(deps_->getStatsHolder(), read_streams_transient_errors);
     catchup_queue_ld_debug("Activate ping timer with timeout=%lu",
@@ -998,7 +1141,8 @@ void CatchupQueue::onBatchComplete(ServerReadStream* stream) {
 void CatchupQueue::getDebugInfo(InfoCatchupQueuesTable& table) {
   table.next()
       .set<0>(client_id_)
-      .set<1>(queue_.size() + queue_delayed_.size())
+      .set<1>(queue_.size() + queue_delayed_.size() +
+              digest_in_flight_.size())
       .set<2>(queue_.size())
       .set<3>(queue_delayed_.size())
       .set<4>(record_bytes_queued_)
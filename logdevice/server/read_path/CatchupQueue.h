@@ -13,6 +13,7 @@
 #include <mutex>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include <boost/intrusive/set.hpp>
 #include <folly/IntrusiveList.h>
@@ -52,6 +53,7 @@ class LogStorageStateMap;
 class ReadIoShapingCallback;
 class ReadStorageTask;
 class RECORD_Message;
+class ReleasedRecords;
 class SenderBase;
 class SenderProxy;
 class ServerReadStream;
@@ -91,6 +93,12 @@ class CatchupQueueDependencies {
    */
   virtual void used(logid_t logid);
 
+  /**
+   * Proxy for AllServerReadStreams::getSharedTailRecords().
+   */
+  virtual std::vector<std::shared_ptr<ReleasedRecords>>
+  getSharedTailRecords(logid_t logid);
+
   /**
    * If specified in the configuration for a log, return how much is allowed to
    * artificially delay delivery of newly released records in order to improve
@@ -163,6 +171,12 @@ class CatchupQueueDependencies {
   virtual bool canIssueReadIO(ReadIoShapingCallback& on_bw_avail,
                               ServerReadStream* stream);
 
+  /**
+   * Reports a stream stalled for longer than
+   * read-stream-stall-trace-threshold to ServerStalledReadTracer.
+   */
+  virtual void traceStall(const ServerReadStream& stream);
+
   virtual ~CatchupQueueDependencies();
 
  public:
@@ -266,6 +280,12 @@ class CatchupQueue {
    */
   void onStorageTaskDropped(ServerReadStream* stream);
 
+  /**
+   * Called after a ReadStorageTask is dropped. Unlike onStorageTaskDropped(),
+   * also handles tasks issued in a digest slot.
+   */
+  void onReadTaskDropped(const ReadStorageTask& task);
+
   /**
    * Adds a read stream to the queue. Depending on the mode argument, the
    * stream will be processed either next time pushRecords() runs, or only
@@ -322,9 +342,20 @@ class CatchupQueue {
   size_t record_bytes_queued_ = 0;
 
   // Is there a storage task in flight for this catchup queue?  We only allow
-  // one at a time.
+  // one at a time, not counting tasks in digest slots.
   bool storage_task_in_flight_ = false;
 
+  // Digest streams with a ReadStorageTask in flight in one of the digest slots
+  // (see Settings::digest_read_tasks_per_client). They are kept out of queue_
+  // until the task comes back, so that the stream owning the regular storage
+  // task stays at the front of queue_.
+  folly::IntrusiveList<ServerReadStream, &ServerReadStream::queue_hook_>
+      digest_in_flight_;
+
+  // Number of ReadStorageTasks in flight in digest slots. Unlike
+  // digest_in_flight_.size(), this includes tasks whose stream was erased.
+  size_t digest_tasks_in_flight_ = 0;
+
   // If true, try a non-blocking read on the worker thread before involving a
   // storage thread.  This is only disabled in tests.
   bool try_non_blocking_read_ = true;
@@ -352,6 +383,28 @@ class CatchupQueue {
 
   void onStorageTaskStopped(const ServerReadStream* stream);
 
+  /**
+   * Switches `stream` to wait state `state` and reports the stream if it has
+   * now been stalled for longer than read-stream-stall-trace-threshold.
+   * `progress` means that records or gaps were just queued for the client,
+   * which ends the stall.
+   */
+  void noteWaitState(ServerReadStream& stream,
+                     ServerReadStream::WaitState state,
+                     bool progress = false);
+
+  /**
+   * @return true if a storage task for `stream` can be issued in a digest
+   *         slot. Only digest streams that ignore the release status qualify,
+   *         since other streams may need a ReadLngTask, which always uses the
+   *         regular slot.
+   */
+  bool canUseDigestSlot(const ServerReadStream& stream) const;
+
+  // Counterpart of onStorageTaskStopped() for tasks in digest slots. Moves the
+  // stream, if it still exists, back to the end of queue_.
+  void onDigestTaskStopped(ServerReadStream* stream);
+
   /**
    * Handle Read Throttling related credits and stats,
    * should be called upon read storage task completion.
@@ -71,6 +71,13 @@ bool LogStorageState::notePermanentError(const char* context) {
   return false;
 }
 
+void LogStorageState::noteUnreleasedRecordStored() {
+  if (!unreleased_records_watched_.load(std::memory_order_relaxed) &&
+      !unreleased_records_watched_.exchange(true)) {
+    owner_->noteUnreleasedRecords(log_id_, shard_);
+  }
+}
+
 bool LogStorageState::hasPermanentError() {
   return permanent_error_.load();
 }
@@ -125,6 +132,11 @@ epoch_t LogStorageState::getLastCleanEpoch() const {
   return epoch_t(last_clean_epoch_.load());
 }
 
+bool LogStorageState::isRecoveryPending() const {
+  folly::Optional<Seal> seal = getSeal(SealType::NORMAL);
+  return seal.has_value() && seal.value().epoch > getLastCleanEpoch();
+}
+
 folly::Optional<std::pair<epoch_t, OffsetMap>>
 LogStorageState::getEpochOffsetMap() const {
   RWLock::ReadHolder read_guard(rw_lock_);
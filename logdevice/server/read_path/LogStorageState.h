@@ -247,14 +247,32 @@ class LogStorageState {
 
   void subscribeWorker(worker_id_t id) {
     ld_check(id.val_ >= 0);
-    subscribed_workers_.set(id.val_);
+    if (!subscribed_workers_.set(id.val_)) {
+      num_subscribed_workers_.fetch_add(1);
+    }
   }
 
   void unsubscribeWorker(worker_id_t id) {
     ld_check(id.val_ >= 0);
-    subscribed_workers_.reset(id.val_);
+    if (subscribed_workers_.reset(id.val_)) {
+      num_subscribed_workers_.fetch_sub(1);
+    }
   }
 
+  /**
+   * @return  true if some worker has read streams for this log.
+   */
+  bool hasSubscribedWorkers() const {
+    return num_subscribed_workers_.load() > 0;
+  }
+
+  /**
+   * @return  true if the log was sealed for an epoch that is not clean yet,
+   *          i.e. log recovery is (or was recently) in progress and may
+   *          consult the record cache.
+   */
+  bool isRecoveryPending() const;
+
   /**
    * Implementation of LogStorageStateMap::recoverLogState().
    */
@@ -319,6 +337,22 @@ class LogStorageState {
     return shard_;
   }
 
+  /**
+   * Called after a record above the last released LSN was written to the
+   * local log store. The first call after the log stopped being watched
+   * hands it to LogStorageStateMap::noteUnreleasedRecords(), so that
+   * UnreleasedRecordDetector only looks at logs that had such stores.
+   */
+  void noteUnreleasedRecordStored();
+
+  /**
+   * Called by UnreleasedRecordDetector when it stops watching the log,
+   * because all the records it has are released.
+   */
+  void clearUnreleasedRecordsWatched() {
+    unreleased_records_watched_.store(false);
+  }
+
  private:
   const logid_t log_id_;
   const shard_index_t shard_;
@@ -358,6 +392,10 @@ class LogStorageState {
   // creating new ones until it comes back.
   std::atomic<bool> get_seq_state_inflight_{false};
 
+  // Is the log being watched by UnreleasedRecordDetector, or about to be?
+  // See noteUnreleasedRecordStored().
+  std::atomic<bool> unreleased_records_watched_{false};
+
   // Trim point of log.  Allows the local log store to delete trimmed
   // records and read paths to recognize that records are missing
   // because of trimming. All records up to (and including) this LSN
@@ -391,6 +429,8 @@ class LogStorageState {
   // subscribed to broadcasts of RELEASE messages.  These workers are
   // notified, for example, when a new record is released for delivery.
   folly::ConcurrentBitSet<MAX_WORKERS> subscribed_workers_;
+  // Number of bits set in subscribed_workers_.
+  std::atomic<uint32_t> num_subscribed_workers_{0};
 
   // Latest time (number of microseconds since steady_clock's epoch) when
   // some storage node tried to recover the state.
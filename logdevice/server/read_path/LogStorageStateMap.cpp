@@ -19,48 +19,127 @@
 
 namespace facebook { namespace logdevice {
 
-LogStorageState* LogStorageStateMap::insertOrGet(logid_t log_id,
-                                                 shard_index_t shard_idx) {
-  Map& map = *shard_map_[shard_idx];
+constexpr logid_t::raw_type LogStorageStateMap::Map::EMPTY;
+
+namespace {
+// Number of slots of the initial table of each shard. Must be a power of 2.
+constexpr size_t INITIAL_CAPACITY = 1024;
+} // namespace
+
+LogStorageStateMap::Map::Map() {
+  tables_.push_back(std::make_unique<Table>(INITIAL_CAPACITY));
+  table_.store(tables_.back().get());
+}
 
-  // First try a lookup to avoid memory allocation in the common case
-  auto it = map.find(log_id.val_);
-  if (it != map.cend()) {
-    return it->second.get();
+LogStorageStateMap::Map::~Map() {
+  clear();
+}
+
+LogStorageStateMap::Map::Slot&
+LogStorageStateMap::Map::probe(const Table& table, logid_t::raw_type log_id) {
+  // use Hash64 to mitigate the effect of logid (data and metadata) collision
+  size_t idx = Hash64<logid_t::raw_type>()(log_id) & table.mask;
+  while (true) {
+    Slot& slot = table.slots[idx];
+    logid_t::raw_type key = slot.key.load(std::memory_order_acquire);
+    if (key == log_id || key == EMPTY) {
+      return slot;
+    }
+    idx = (idx + 1) & table.mask;
   }
+}
 
-  // No state for this log yet.
-  auto insert_result =
-      map.emplace(log_id.val(),
-                  std::make_unique<LogStorageState>(
-                      log_id, shard_idx, this, cache_disposal_.get()));
+LogStorageState*
+LogStorageStateMap::Map::find(logid_t::raw_type log_id) const {
+  ld_check(log_id != EMPTY);
+  Slot& slot = probe(*table_.load(std::memory_order_acquire), log_id);
+  // If the slot is empty, state is nullptr.
+  return slot.key.load(std::memory_order_acquire) == log_id
+      ? slot.state.load(std::memory_order_relaxed)
+      : nullptr;
+}
+
+LogStorageState* LogStorageStateMap::Map::insertOrGet(
+    logid_t::raw_type log_id,
+    const std::function<std::unique_ptr<LogStorageState>()>& make) {
+  // First try a lookup to avoid locking in the common case
+  LogStorageState* state = find(log_id);
+  if (state) {
+    return state;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Some other thread may have inserted the log, or replaced the table,
+  // since the lookup.
+  Table* table = table_.load(std::memory_order_relaxed);
+  Slot* slot = &probe(*table, log_id);
+  if (slot->key.load(std::memory_order_relaxed) == log_id) {
+    return slot->state.load(std::memory_order_relaxed);
+  }
 
-  // Whether or not we were the ones to insert or some other thread beat us
-  // to it, return a pointer to whatever ended up in the map.
-  return insert_result.first->second.get();
+  if ((size_ + 1) * 2 > table->mask + 1) {
+    auto bigger = std::make_unique<Table>((table->mask + 1) * 2);
+    for (size_t i = 0; i <= table->mask; ++i) {
+      const Slot& from = table->slots[i];
+      logid_t::raw_type key = from.key.load(std::memory_order_relaxed);
+      if (key != EMPTY) {
+        Slot& to = probe(*bigger, key);
+        to.state.store(from.state.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+        to.key.store(key, std::memory_order_relaxed);
+      }
+    }
+    table = bigger.get();
+    tables_.push_back(std::move(bigger));
+    // Publishes the slots filled above.
+    table_.store(table, std::memory_order_release);
+    slot = &probe(*table, log_id);
+  }
+
+  state = make().release();
+  slot->state.store(state, std::memory_order_relaxed);
+  slot->key.store(log_id, std::memory_order_release);
+  ++size_;
+  return state;
+}
+
+void LogStorageStateMap::Map::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  forEach([](logid_t::raw_type, LogStorageState& state) {
+    delete &state;
+    return 0;
+  });
+  tables_.clear();
+  tables_.push_back(std::make_unique<Table>(INITIAL_CAPACITY));
+  table_.store(tables_.back().get());
+  size_ = 0;
+}
+
+LogStorageState* LogStorageStateMap::insertOrGet(logid_t log_id,
+                                                 shard_index_t shard_idx) {
+  ld_check(shard_idx < shard_map_.size());
+  return shard_map_[shard_idx]->insertOrGet(log_id.val_, [&] {
+    return std::make_unique<LogStorageState>(
+        log_id, shard_idx, this, cache_disposal_.get());
+  });
 }
 
 LogStorageState* LogStorageStateMap::find(logid_t log_id,
                                           shard_index_t shard_idx) {
   ld_check(shard_idx < shard_map_.size());
-  Map& map = *shard_map_[shard_idx];
-  auto it = map.find(log_id.val_);
-  return it != map.cend() ? it->second.get() : nullptr;
+  return shard_map_[shard_idx]->find(log_id.val_);
 }
 
 LogStorageState& LogStorageStateMap::get(logid_t log_id,
                                          shard_index_t shard_idx) {
-  ld_check(shard_idx < shard_map_.size());
-  Map& map = *shard_map_[shard_idx];
-  auto it = map.find(log_id.val_);
-  ld_check(it != map.cend());
-  return *(it->second);
+  LogStorageState* state = find(log_id, shard_idx);
+  ld_check(state != nullptr);
+  return *state;
 }
 
 void LogStorageStateMap::clear() {
   for (shard_index_t s = 0; s < num_shards_; ++s) {
-    Map& map = *shard_map_[s];
-    map.clear();
+    shard_map_[s]->clear();
   }
 }
 
@@ -91,13 +170,12 @@ LogStorageStateMap::ReleaseStates
 LogStorageStateMap::getAllLastReleasedLSNs(shard_index_t shard) const {
   ReleaseStates states;
 
-  for (auto entry = shard_map_[shard]->cbegin();
-       entry != shard_map_[shard]->cend();
-       ++entry) {
+  forEachLogOnShard(shard, [&](logid_t log_id, const LogStorageState& state) {
     LogStorageState::LastReleasedLSN last_released =
-        entry->second->getLastReleasedLSN();
-    states.emplace_back(logid_t(entry->first), last_released.value());
-  }
+        state.getLastReleasedLSN();
+    states.emplace_back(log_id, last_released.value());
+    return 0;
+  });
 
   return states;
 }
@@ -119,14 +197,12 @@ void LogStorageStateMap::shutdownRecordCaches() {
   if (cache_disposal_ == nullptr) {
     return;
   }
-  for (shard_index_t i = 0; i < num_shards_; ++i) {
-    for (auto entry = shard_map_[i]->cbegin(); entry != shard_map_[i]->cend();
-         ++entry) {
-      if (entry->second->record_cache_ != nullptr) {
-        entry->second->record_cache_->shutdown();
-      }
+  forEachLog([](logid_t, const LogStorageState& state) {
+    if (state.record_cache_ != nullptr) {
+      state.record_cache_->shutdown();
     }
-  }
+    return 0;
+  });
 }
 
 void LogStorageStateMap::shutdownRecordCacheMonitor() {
@@ -153,6 +229,20 @@ void LogStorageStateMap::setProcessor(ServerProcessor* processor) {
   }
 }
 
+void LogStorageStateMap::noteUnreleasedRecords(logid_t log_id,
+                                               shard_index_t shard_idx) {
+  std::lock_guard<std::mutex> lock(unreleased_mutex_);
+  logs_with_unreleased_records_.emplace_back(log_id, shard_idx);
+}
+
+LogStorageStateMap::LogShardPairs
+LogStorageStateMap::takeLogsWithUnreleasedRecords() {
+  LogShardPairs logs;
+  std::lock_guard<std::mutex> lock(unreleased_mutex_);
+  logs.swap(logs_with_unreleased_records_);
+  return logs;
+}
+
 StatsHolder* LogStorageStateMap::getStats() {
   return stats_;
 }
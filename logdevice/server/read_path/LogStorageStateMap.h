@@ -9,11 +9,11 @@
 
 #include <atomic>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <vector>
 
-#include <folly/concurrency/ConcurrentHashMap.h>
-
 #include "logdevice/common/types_internal.h"
 #include "logdevice/common/util.h"
 #include "logdevice/include/Err.h"
@@ -28,13 +28,18 @@ namespace facebook { namespace logdevice {
  * @file
  * On storage nodes, maps log IDs to LogStorageState instances, state that we
  * need to keep in memory for fast access.
+ *
+ * Every STORE and every read looks up the map, from all workers and storage
+ * threads, while new logs are only added once. Each shard has an insert-only
+ * open addressing table of (log id, LogStorageState*) slots, four to a cache
+ * line: lookups are lock-free and touch one or two cache lines, insertions
+ * take a per-shard mutex.
  */
 
 class LogStorageStateMap {
  public:
   /**
    * @param num_shards         Number of shards on this node
-   *                           map, required by AtomicHashMap
    * @param recovery_interval  interval between consecutive attempts to recover
    *                           log state
    */
@@ -120,6 +125,21 @@ class LogStorageStateMap {
                       LogStorageState::RecoverContext ctx,
                       bool force_ask_sequencer = false);
 
+  using LogShardPairs = std::vector<std::pair<logid_t, shard_index_t>>;
+
+  /**
+   * Called by LogStorageState::noteUnreleasedRecordStored() the first time a
+   * log gets a record above its last released LSN since it was last checked
+   * by UnreleasedRecordDetector.
+   */
+  void noteUnreleasedRecords(logid_t log_id, shard_index_t shard_idx);
+
+  /**
+   * Returns the logs passed to noteUnreleasedRecords() since the previous
+   * call.
+   */
+  LogShardPairs takeLogsWithUnreleasedRecords();
+
   /**
    * If record cache is enabled, shutdown record caches of all logs by clearing
    * their entries. Called during server shutdown.
@@ -176,15 +196,70 @@ class LogStorageStateMap {
   // initialization.
   ServerProcessor* processor_;
 
-  // use Hash64 to mitigate the effect of logid (data and metadata) collision
-  using Map = folly::ConcurrentHashMap<logid_t::raw_type,
-                                       std::unique_ptr<LogStorageState>,
-                                       Hash64<logid_t::raw_type>>;
+  // LogStorageStates of one shard, see the file comment. Owns the states.
+  class Map {
+   public:
+    Map();
+    ~Map();
+
+    LogStorageState* find(logid_t::raw_type log_id) const;
+
+    // Returns the state of the log, creating it with make() if it doesn't
+    // exist yet.
+    LogStorageState*
+    insertOrGet(logid_t::raw_type log_id,
+                const std::function<std::unique_ptr<LogStorageState>()>& make);
+
+    // Calls func(log_id, state) for each state until it returns non-zero.
+    // States inserted concurrently may or may not be visited.
+    template <typename Func>
+    int forEach(const Func& func) const;
+
+    // Not thread-safe.
+    void clear();
+
+   private:
+    static constexpr logid_t::raw_type EMPTY =
+        std::numeric_limits<logid_t::raw_type>::max();
+
+    // `state` is written before `key`, so readers that see the key see the
+    // state as well.
+    struct Slot {
+      std::atomic<logid_t::raw_type> key{EMPTY};
+      std::atomic<LogStorageState*> state{nullptr};
+    };
+
+    struct Table {
+      explicit Table(size_t capacity)
+          : mask(capacity - 1), slots(new Slot[capacity]) {}
+      const size_t mask;
+      std::unique_ptr<Slot[]> slots;
+    };
+
+    // Linear probing from the hash of the key. Tables are at most half full,
+    // so there is always an empty slot to stop at. Returns the slot of the
+    // key, or the empty slot where it would go.
+    static Slot& probe(const Table& table, logid_t::raw_type log_id);
+
+    // The table that lookups use. Replaced by a table twice as big when it
+    // becomes half full. Replaced tables are kept in tables_ since readers
+    // may still be probing them; they take less memory than the current one.
+    std::atomic<Table*> table_;
+    std::mutex mutex_;
+    // Protected by mutex_.
+    std::vector<std::unique_ptr<Table>> tables_;
+    size_t size_{0};
+  };
 
   const std::vector<std::unique_ptr<Map>> shard_map_;
 
   static std::vector<std::unique_ptr<Map>> makeMap(shard_size_t num_shards);
 
+  // Logs that got unreleased records, waiting for UnreleasedRecordDetector.
+  // A log is added at most once per detector period, so a mutex is enough.
+  std::mutex unreleased_mutex_;
+  LogShardPairs logs_with_unreleased_records_;
+
   // Attempt to recover log state only once this many usecs.
   std::chrono::microseconds state_recovery_interval_;
 
@@ -200,10 +275,20 @@ template <typename Func>
 int LogStorageStateMap::forEachLogOnShard(shard_index_t shard,
                                           const Func& func) const {
   ld_check(shard < shard_map_.size());
-  for (auto kv = shard_map_[shard]->cbegin(); kv != shard_map_[shard]->cend();
-       ++kv) {
-    if (kv->second != nullptr) {
-      if (func(logid_t(kv->first), *kv->second) != 0) {
+  return shard_map_[shard]->forEach(
+      [&](logid_t::raw_type log_id, const LogStorageState& state) {
+        return func(logid_t(log_id), state);
+      });
+}
+
+template <typename Func>
+int LogStorageStateMap::Map::forEach(const Func& func) const {
+  const Table* table = table_.load(std::memory_order_acquire);
+  for (size_t i = 0; i <= table->mask; ++i) {
+    const Slot& slot = table->slots[i];
+    logid_t::raw_type log_id = slot.key.load(std::memory_order_acquire);
+    if (log_id != EMPTY) {
+      if (func(log_id, *slot.state.load(std::memory_order_relaxed)) != 0) {
         return -1;
       }
     }
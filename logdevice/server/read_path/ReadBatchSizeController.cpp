@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/ReadBatchSizeController.h"
+
+#include <algorithm>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr std::chrono::milliseconds ReadBatchSizeController::kSampleInterval;
+constexpr double ReadBatchSizeController::kSampleWeight;
+
+void ReadBatchSizeController::updateBusyTime(Clock::time_point now) {
+  if (pending_bytes_ > 0 && now > busy_since_) {
+    sample_busy_time_ += now - busy_since_;
+  }
+  busy_since_ = now;
+}
+
+void ReadBatchSizeController::onBytesQueued(size_t bytes,
+                                            Clock::time_point now) {
+  if (bytes == 0) {
+    return;
+  }
+  updateBusyTime(now);
+  pending_bytes_ += bytes;
+}
+
+void ReadBatchSizeController::onBytesDrained(size_t bytes,
+                                             Clock::time_point now) {
+  updateBusyTime(now);
+  // The stream may have been rewound with messages still in flight; don't
+  // let the accounting go negative.
+  pending_bytes_ -= std::min(bytes, pending_bytes_);
+  sample_bytes_ += bytes;
+
+  if (sample_busy_time_ < kSampleInterval) {
+    return;
+  }
+
+  const double seconds =
+      std::chrono::duration_cast<std::chrono::duration<double>>(
+          sample_busy_time_)
+          .count();
+  const double sample = sample_bytes_ / seconds;
+  drain_rate_ = drain_rate_.hasValue()
+      ? kSampleWeight * sample + (1 - kSampleWeight) * drain_rate_.value()
+      : sample;
+  sample_busy_time_ = Clock::duration(0);
+  sample_bytes_ = 0;
+}
+
+size_t
+ReadBatchSizeController::getBatchBytes(size_t min_bytes,
+                                       size_t max_bytes,
+                                       std::chrono::milliseconds target) const {
+  ld_check(min_bytes <= max_bytes);
+  size_t res = max_bytes;
+  if (drain_rate_.hasValue()) {
+    const double target_bytes = drain_rate_.value() *
+        std::chrono::duration_cast<std::chrono::duration<double>>(target)
+            .count();
+    if (target_bytes < max_bytes + pending_bytes_) {
+      const double budget = target_bytes - pending_bytes_;
+      res = budget > min_bytes ? static_cast<size_t>(budget) : min_bytes;
+    }
+  }
+  last_batch_bytes_ = res;
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+#include <folly/Optional.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Sizes the read batches of a ServerReadStream from the rate at which
+ *        its client drains RECORD messages, so that a batch holds about
+ *        `target` worth of data at that rate (see
+ *        Settings::read_batch_target_drain_time). Slow consumers get small
+ *        batches and don't tie up storage threads and output buffers with
+ *        data that sits there; fast consumers get batches up to the usual
+ *        output-max-records-kb limit.
+ *
+ *        The drain rate is measured only over time during which the stream
+ *        had bytes pending in the Sender, so idle periods (nothing to send)
+ *        don't make the client look slow.
+ *
+ *        Not thread-safe, used on the worker that owns the stream.
+ */
+
+class ReadBatchSizeController {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Drain rate samples are taken over at least this much busy time.
+  static constexpr std::chrono::milliseconds kSampleInterval{100};
+
+  // Weight of a new sample in the drain rate moving average.
+  static constexpr double kSampleWeight = 0.3;
+
+  /**
+   * Called when RECORD messages of `bytes` total size were queued in the
+   * Sender for this stream.
+   */
+  void onBytesQueued(size_t bytes, Clock::time_point now = Clock::now());
+
+  /**
+   * Called when a RECORD message of `bytes` size of this stream was sent.
+   */
+  void onBytesDrained(size_t bytes, Clock::time_point now = Clock::now());
+
+  /**
+   * Byte limit for the next batch: the amount of data the client is expected
+   * to drain in `target`, minus what's already pending, clamped to
+   * [min_bytes, max_bytes]. Returns max_bytes until the drain rate has been
+   * measured.
+   */
+  size_t getBatchBytes(size_t min_bytes,
+                       size_t max_bytes,
+                       std::chrono::milliseconds target) const;
+
+  /**
+   * Estimated drain rate in bytes per second, if measured.
+   */
+  folly::Optional<double> getDrainRate() const {
+    return drain_rate_;
+  }
+
+  size_t getPendingBytes() const {
+    return pending_bytes_;
+  }
+
+  /**
+   * Last value returned by getBatchBytes(), for debugging. 0 if never called.
+   */
+  size_t getLastBatchBytes() const {
+    return last_batch_bytes_;
+  }
+
+ private:
+  // Accounts for busy time up to `now`.
+  void updateBusyTime(Clock::time_point now);
+
+  size_t pending_bytes_{0};
+
+  // Valid when pending_bytes_ > 0: since when busy time is being accounted.
+  Clock::time_point busy_since_;
+
+  // Busy time and bytes drained in the current sample.
+  Clock::duration sample_busy_time_{0};
+  size_t sample_bytes_{0};
+
+  folly::Optional<double> drain_rate_;
+
+  mutable size_t last_batch_bytes_{0};
+};
+
+}} // namespace facebook::logdevice
@@ -87,6 +87,52 @@ const SimpleEnumMap<ServerReadStream::RecordSource, const char*>
                             {RecordSource::NON_BLOCKING, "NON_BLOCKING"},
                             {RecordSource::BLOCKING, "BLOCKING"}};
 
+const SimpleEnumMap<ServerReadStream::WaitState, const char*>
+    ServerReadStream::wait_state_names{
+        {WaitState::NONE, "NONE"},
+        {WaitState::QUEUED, "QUEUED"},
+        {WaitState::STORAGE_TASK, "STORAGE_TASK"},
+        {WaitState::NETWORK_BANDWIDTH, "NETWORK_BANDWIDTH"},
+        {WaitState::READ_BANDWIDTH, "READ_BANDWIDTH"},
+        {WaitState::WINDOW, "WINDOW"},
+        {WaitState::RELEASE, "RELEASE"}};
+
+void ServerReadStream::setWaitState(WaitState state) {
+  ld_check(state < WaitState::MAX);
+  auto now = std::chrono::steady_clock::now();
+  stall_wait_times_[static_cast<size_t>(wait_state_)] +=
+      now - wait_state_since_;
+  wait_state_ = state;
+  wait_state_since_ = now;
+}
+
+void ServerReadStream::noteProgress() {
+  stall_wait_times_.fill(std::chrono::steady_clock::duration::zero());
+  wait_state_since_ = std::chrono::steady_clock::now();
+  stall_reported_ = false;
+}
+
+std::array<std::chrono::steady_clock::duration,
+           static_cast<size_t>(ServerReadStream::WaitState::MAX)>
+ServerReadStream::getStallWaitTimes() const {
+  auto res = stall_wait_times_;
+  res[static_cast<size_t>(wait_state_)] +=
+      std::chrono::steady_clock::now() - wait_state_since_;
+  return res;
+}
+
+std::chrono::steady_clock::duration
+ServerReadStream::getStallDuration() const {
+  auto times = getStallWaitTimes();
+  auto res = std::chrono::steady_clock::duration::zero();
+  for (size_t i = 0; i < times.size(); ++i) {
+    if (static_cast<WaitState>(i) != WaitState::RELEASE) {
+      res += times[i];
+    }
+  }
+  return res;
+}
+
 bool ServerReadStream::isCatchingUp() const {
   return queue_hook_.is_linked() || queue_delayed_hook_.is_linked();
 }
@@ -285,6 +331,17 @@ void ServerReadStream::getDebugInfo(InfoReadersTable& table) const {
   ssize_t send_buf_occupancy =
       worker->sender().getTcpSendBufOccupancyForClient(client_id_);
   table.set<25>(send_buf_occupancy);
+
+  if (batch_size_controller_.getLastBatchBytes() > 0) {
+    table.set<26>(batch_size_controller_.getLastBatchBytes());
+  }
+  if (batch_size_controller_.getDrainRate().hasValue()) {
+    table.set<27>(batch_size_controller_.getDrainRate().value());
+  }
+  table.set<28>(wait_state_names[wait_state_]);
+  table.set<29>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    getStallDuration())
+                    .count());
 }
 
 void ServerReadStream::addReleasedRecords(
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <memory>
 
@@ -31,6 +32,7 @@
 #include "logdevice/include/types.h"
 #include "logdevice/server/RealTimeRecordBuffer.h"
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
+#include "logdevice/server/read_path/ReadBatchSizeController.h"
 #include "logdevice/server/read_path/ReadIoShapingCallback.h"
 
 namespace facebook { namespace logdevice {
@@ -498,13 +500,25 @@ class ServerReadStream : boost::noncopyable {
   ReadIoShapingCallback read_shaping_cb_;
 
   // Whether there is currently a storage task in flight for this stream, in
-  // which case the stream should be at the top of CatchupQueue.
+  // which case the stream should be at the top of CatchupQueue, unless
+  // in_digest_lane_ is set.
   bool storage_task_in_flight_;
 
+  // Set by CatchupQueue while issuing a ReadStorageTask for a digest stream
+  // that uses one of the digest slots (see
+  // Settings::digest_read_tasks_per_client) rather than the CatchupQueue's
+  // regular storage task slot. Such streams are parked outside the queue until
+  // their task comes back.
+  bool in_digest_lane_ = false;
+
   // Status of the last batch. Used for debugging only.
   // Pointer to a string literal, so that it's fast to assign.
   const char* last_batch_status_ = "no batches";
 
+  // Tracks how fast the client drains RECORDs of this stream and sizes read
+  // batches accordingly if read-batch-target-drain-time is set.
+  ReadBatchSizeController batch_size_controller_;
+
   // Replication factor this client expects for records.
   // This value helps the storage node figure out that the copy it has is
   // actually an extra so it can ship it if SCD is active.
@@ -533,6 +547,69 @@ class ServerReadStream : boost::noncopyable {
   // onSent handler
   std::shared_ptr<std::string> log_group_path_;
 
+  // Set if the client sampled this read stream for end-to-end tracing. Each
+  // batch read for the stream is then published as a "catchup_read" span.
+  e2e_trace_id_t e2e_trace_id_ = E2E_TRACE_ID_INVALID;
+
+  // What the stream is waiting for, as far as this storage node can tell.
+  // Used to explain read stalls, see setWaitState().
+  enum class WaitState : uint8_t {
+    // Reading or sending a batch, or not waiting for anything in particular.
+    NONE = 0,
+    // In CatchupQueue, behind other streams of the same client or waiting for
+    // records already queued for the client to drain.
+    QUEUED,
+    // Waiting for a ReadStorageTask or ReadLngTask to come back.
+    STORAGE_TASK,
+    // Waiting for traffic shaping to allow sending to the client.
+    NETWORK_BANDWIDTH,
+    // Waiting for read throttling to allow a read storage task.
+    READ_BANDWIDTH,
+    // Reached the end of the client's window, waiting for a WINDOW message.
+    WINDOW,
+    // Caught up, waiting for more records to be released.
+    RELEASE,
+    MAX
+  };
+
+  static const SimpleEnumMap<WaitState, const char*> wait_state_names;
+
+  /**
+   * Accounts the time since the previous call to the state the stream was
+   * waiting for, and switches to `state`.
+   */
+  void setWaitState(WaitState state);
+
+  WaitState getWaitState() const {
+    return wait_state_;
+  }
+
+  /**
+   * Called when records or gaps of this stream were queued for the client.
+   * Ends the current stall, if any.
+   */
+  void noteProgress();
+
+  /**
+   * How long the stream has been stalled: the time since it last made
+   * progress, excluding the time spent caught up (WaitState::RELEASE), which
+   * is the normal state of a tailing stream. Includes the time spent in the
+   * current state.
+   */
+  std::chrono::steady_clock::duration getStallDuration() const;
+
+  /**
+   * Time spent in each WaitState since the stream last made progress,
+   * including the time spent in the current state.
+   */
+  std::array<std::chrono::steady_clock::duration,
+             static_cast<size_t>(WaitState::MAX)>
+  getStallWaitTimes() const;
+
+  // Set once the current stall has been reported to ServerStalledReadTracer,
+  // to report each stall once.
+  bool stall_reported_ = false;
+
   enum class RecordSource { REAL_TIME, NON_BLOCKING, BLOCKING, MAX };
 
   static const SimpleEnumMap<RecordSource, const char*> names;
@@ -607,6 +684,16 @@ class ServerReadStream : boost::noncopyable {
   std::vector<std::shared_ptr<ReleasedRecords>> released_records_;
 
   folly::Optional<RecordSource> last_sent_source_;
+
+  WaitState wait_state_ = WaitState::NONE;
+  std::chrono::steady_clock::time_point wait_state_since_{
+      std::chrono::steady_clock::now()};
+
+  // Time spent in each WaitState, other than the current one, since the
+  // stream last made progress.
+  std::array<std::chrono::steady_clock::duration,
+             static_cast<size_t>(WaitState::MAX)>
+      stall_wait_times_{};
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/ServerStalledReadTracer.h"
+
+#include <folly/String.h>
+
+#include "logdevice/common/configuration/TrafficClass.h"
+#include "logdevice/server/read_path/ServerReadStream.h"
+
+namespace facebook { namespace logdevice {
+
+ServerStalledReadTracer::ServerStalledReadTracer(
+    std::shared_ptr<TraceLogger> logger)
+    : SampledTracer(std::move(logger)) {}
+
+void ServerStalledReadTracer::traceStall(const ServerReadStream& stream) {
+  auto sample_builder = [&]() -> std::unique_ptr<TraceSample> {
+    using namespace std::chrono;
+    using WaitState = ServerReadStream::WaitState;
+    auto sample = std::make_unique<TraceSample>();
+    sample->addNormalValue("log_id", std::to_string(stream.log_id_.val()));
+    sample->addNormalValue(
+        "read_stream_id", std::to_string(stream.id_.val()));
+    sample->addNormalValue("client_id", stream.client_id_.toString());
+    sample->addIntValue("shard", stream.shard_);
+    sample->addNormalValue("csid", stream.csid_);
+    sample->addNormalValue("from_lsn", std::to_string(stream.start_lsn_));
+    sample->addNormalValue("until_lsn", std::to_string(stream.until_lsn_));
+    sample->addIntValue("read_ptr", stream.getReadPtr().lsn);
+    sample->addIntValue("window_high", stream.getWindowHigh());
+    sample->addIntValue("last_delivered_lsn", stream.last_delivered_lsn_);
+    sample->addNormalValue("last_batch_status", stream.last_batch_status_);
+    sample->addNormalValue(
+        "traffic_class", trafficClasses()[stream.trafficClass()]);
+    sample->addNormalValue(
+        "wait_state",
+        ServerReadStream::wait_state_names[stream.getWaitState()]);
+    sample->addIntValue(
+        "stall_ms",
+        duration_cast<milliseconds>(stream.getStallDuration()).count());
+    auto times = stream.getStallWaitTimes();
+    for (size_t i = 0; i < times.size(); ++i) {
+      std::string name =
+          ServerReadStream::wait_state_names[static_cast<WaitState>(i)];
+      folly::toLowerAscii(name);
+      sample->addIntValue("wait_ms_" + name,
+                          duration_cast<milliseconds>(times[i]).count());
+    }
+    return sample;
+  };
+  publish(SERVER_STALL_READ_TRACER, sample_builder);
+}
+
+}} // namespace facebook::logdevice
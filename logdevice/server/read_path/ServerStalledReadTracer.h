@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include "logdevice/common/SampledTracer.h"
+
+namespace facebook { namespace logdevice {
+
+class ServerReadStream;
+class TraceLogger;
+
+constexpr auto SERVER_STALL_READ_TRACER = "server_stall_read_tracer";
+
+/**
+ * Server-side counterpart of ClientStalledReadTracer. Reports read streams
+ * that haven't shipped anything to the client for longer than
+ * --read-stream-stall-trace-threshold, with a breakdown of what the stream
+ * was waiting for. The log_id and read_stream_id fields match the ones of
+ * ClientStalledReadTracer, so the two tables can be joined.
+ */
+class ServerStalledReadTracer : SampledTracer {
+ public:
+  explicit ServerStalledReadTracer(std::shared_ptr<TraceLogger> logger);
+
+  void traceStall(const ServerReadStream& stream);
+
+  folly::Optional<double> getDefaultSamplePercentage() const override {
+    // Stalls past the threshold are rare, keep all of them.
+    return 100;
+  }
+};
+
+}} // namespace facebook::logdevice
@@ -72,6 +72,9 @@ void ChunkRebuilding::start() {
                                                 data_->getRecordBlob(i),
                                                 this,
                                                 data_->replication);
+    if (data_->checksumsVerified) {
+      rrStores_[i]->skipChecksumVerification();
+    }
   }
   numInFlight_ = rrStores_.size();
   for (size_t i = 0; i < rrStores_.size(); ++i) {
@@ -67,6 +67,10 @@ struct ChunkData {
   RecordTimestamp oldestTimestamp;
   // Information about records' epoch.
   std::shared_ptr<ReplicationScheme> replication;
+  // True if the read storage task has already verified payload checksums of
+  // all records (or found that it doesn't need to), so RecordRebuildingStore
+  // doesn't verify them again.
+  bool checksumsVerified = false;
 
   // All records concatenated together.
   folly::IOBuf buffer;
@@ -121,6 +125,13 @@ struct ChunkData {
     return b;
   }
 
+  // Same as getRecordBlob() but without copying, valid until the next
+  // addRecord().
+  Slice getRecordSlice(size_t idx) const {
+    size_t off = idx ? records[idx - 1].offset : 0ul;
+    return Slice(buffer.data() + off, records[idx].offset - off);
+  }
+
   ssize_t findLSN(lsn_t lsn) const {
     // For now LSNs in a chunk are required to be consecutive. If you remove
     // this requirement, just replace this with binary search.
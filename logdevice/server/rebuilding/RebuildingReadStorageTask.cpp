@@ -124,6 +124,9 @@ void RebuildingReadStorageTask::execute() {
       STAT_ADD(stats,
                rebuilding_num_records_late_filtered,
                context->filter->nRecordsLateFiltered);
+      STAT_ADD(stats,
+               rebuilding_record_ranges_skipped_clean,
+               context->filter->nRecordRangesCleanFiltered);
 
       size_t tot_skipped = context->filter->nRecordsSCDFiltered +
           context->filter->nRecordsNotDirtyFiltered +
@@ -139,7 +142,8 @@ void RebuildingReadStorageTask::execute() {
           "Rebuilding has read a batch of records in %.3fs. Got %lu records "
           "(%lu bytes) in %lu chunks, read %lu bytes of rocksdb blocks. "
           "Skipped %lu records (SCD: %lu, ND: %lu, "
-          "DRAINED: %lu, TS: %lu, EPOCH: %lu; LATE: %lu).",
+          "DRAINED: %lu, TS: %lu, EPOCH: %lu; LATE: %lu) and %lu clean "
+          "log ranges.",
           std::chrono::duration_cast<std::chrono::duration<double>>(end_time -
                                                                     start_time)
               .count(),
@@ -153,7 +157,8 @@ void RebuildingReadStorageTask::execute() {
           context->filter->nRecordsDrainedFiltered,
           context->filter->nRecordsTimestampFiltered,
           context->filter->nRecordsEpochRangeFiltered,
-          context->filter->nRecordsLateFiltered);
+          context->filter->nRecordsLateFiltered,
+          context->filter->nRecordRangesCleanFiltered);
     }
   };
 
@@ -290,6 +295,23 @@ void RebuildingReadStorageTask::execute() {
     bytes_in_result += record.size;
   }
 
+  if (!result_.empty() && getSettings()->verify_checksum_before_replicating) {
+    switch (context->rebuildingSettings->checksum_verification) {
+      case RebuildingChecksumVerification::PER_RECORD:
+        break;
+      case RebuildingChecksumVerification::BATCH:
+        verifyChecksumsInBatch(result_);
+        break;
+      case RebuildingChecksumVerification::SKIP_IF_VERIFIED_ON_STORE:
+        if (storeVerifiesChecksums()) {
+          for (auto& c : result_) {
+            c->checksumsVerified = true;
+          }
+        }
+        break;
+    }
+  }
+
   switch (iterator->state()) {
     case IteratorState::AT_RECORD:
     case IteratorState::LIMIT_REACHED:
@@ -297,11 +319,13 @@ void RebuildingReadStorageTask::execute() {
           std::shared_ptr<LocalLogStore::AllLogsIterator::Location>(
               iterator->getLocation());
       context->progress = iterator->getProgress();
+      context->totalBytes = iterator->getApproximateTotalBytes();
       break;
     case IteratorState::AT_END:
       context->reachedEnd = true;
       context->nextLocation.reset();
       context->progress = 1;
+      context->totalBytes = iterator->getApproximateTotalBytes();
       // context->iterator will be destroyed in the SCOPE_EXIT above, after
       // pulling stats out of it one last time.
       break;
@@ -357,7 +381,10 @@ int RebuildingReadStorageTask::checkRecordForBlockChange(
   bool epoch_changed =
       lsn_to_epoch(log_state->lastSeenLSN) != lsn_to_epoch(lsn);
   // Factor 2 is arbitrary.
-  size_t max_block_size = getSettings().get()->sticky_copysets_block_size * 2;
+  size_t max_block_size =
+      std::max(getSettings().get()->sticky_copysets_block_size,
+               getSettings().get()->sticky_copysets_block_max_size) *
+      2;
   bool byte_limit_exceeded = log_state->bytesInCurrentBlock > max_block_size;
   if (copyset_changed || epoch_changed || byte_limit_exceeded) {
     // End of the block reached. Bump block counter and save the new copyset.
@@ -490,6 +517,46 @@ folly::Optional<NodeID> RebuildingReadStorageTask::getMyNodeID() {
 StatsHolder* RebuildingReadStorageTask::getStats() {
   return storageThreadPool_->stats();
 }
+bool RebuildingReadStorageTask::storeVerifiesChecksums() {
+  return storageThreadPool_->getLocalLogStore()
+      .verifiesChecksumsOnWriteAndRead();
+}
+
+void RebuildingReadStorageTask::verifyChecksumsInBatch(
+    std::vector<std::unique_ptr<ChunkData>>& chunks) {
+  std::vector<Slice> blobs;
+  // Index in `chunks` of each record in `blobs`.
+  std::vector<size_t> chunk_idx;
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    for (size_t i = 0; i < chunks[c]->numRecords(); ++i) {
+      blobs.push_back(chunks[c]->getRecordSlice(i));
+      chunk_idx.push_back(c);
+    }
+  }
+
+  std::vector<bool> bad(chunks.size(), false);
+  size_t begin = 0;
+  while (begin < blobs.size()) {
+    size_t bad_idx;
+    int rv = LocalLogStoreRecordFormat::checkWellFormedBatch(
+        &blobs[begin], nullptr, blobs.size() - begin, &bad_idx);
+    if (rv == 0) {
+      break;
+    }
+    // Skip the rest of the chunk with the bad record and go on with the next
+    // one.
+    const size_t c = chunk_idx[begin + bad_idx];
+    bad[c] = true;
+    begin += bad_idx + 1;
+    while (begin < blobs.size() && chunk_idx[begin] == c) {
+      ++begin;
+    }
+  }
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    chunks[c]->checksumsVerified = !bad[c];
+  }
+}
 
 std::unique_ptr<LocalLogStore::AllLogsIterator>
 RebuildingReadStorageTask::createIterator(
@@ -521,6 +588,7 @@ void RebuildingReadStorageTask::Filter::clearStats() {
   nRecordsDrainedFiltered = 0;
   nRecordsTimestampFiltered = 0;
   nRecordsEpochRangeFiltered = 0;
+  nRecordRangesCleanFiltered = 0;
 }
 
 bool RebuildingReadStorageTask::Filter::shouldProcessTimeRange(
@@ -585,13 +653,13 @@ bool RebuildingReadStorageTask::Filter::shouldProcessRecordRange(
     logid_t log,
     lsn_t min_lsn,
     lsn_t max_lsn,
-    RecordTimestamp /* min_ts */,
-    RecordTimestamp /* max_ts */) {
-  // Note: we're not taking time ranges into account. I.e. if in some partition
-  // the effective rebuilding set (rebuilding set minus shardsOutsideTimeRange)
-  // doesn't intersect some log's nodeset, we could detect it here and skip
-  // this log in this partition. For simplicity we're not doing it currently.
-  // We're just skipping epoch ranges not covered by rebuilding plan.
+    RecordTimestamp min_ts,
+    RecordTimestamp max_ts) {
+  // Skip epoch ranges not covered by rebuilding plan. Also skip the log in
+  // this partition if the whole lsn range is in one epoch range and the
+  // effective rebuilding set (rebuilding set minus shardsOutsideTimeRange)
+  // doesn't intersect its nodeset: then this donor wouldn't re-replicate any
+  // of these records, and there's no point reading their CSI.
 
   if (!lookUpLogState(log)) {
     return false;
@@ -610,8 +678,16 @@ bool RebuildingReadStorageTask::Filter::shouldProcessRecordRange(
                                 context,
                                 currentLogState,
                                 /* create_replication_scheme */ false);
-  // If min_lsn is covered by rebuilding plan, process the range.
+  // If min_lsn is covered by rebuilding plan, process the range, unless it's
+  // all clean.
   if (first_epoch_good) {
+    if (lsn_to_epoch(max_lsn) < currentLogState->currentEpochRange.second &&
+        timeRangeCache.valid(min_ts, max_ts) &&
+        !storageSetNeedsRebuilding(
+            currentLogState->currentEpochMetadata->shards)) {
+      ++nRecordRangesCleanFiltered;
+      return false;
+    }
     return true;
   }
   // If max_lsn is in the same, non-covered, epoch range as min_lsn, reject the
@@ -625,6 +701,30 @@ bool RebuildingReadStorageTask::Filter::shouldProcessRecordRange(
   return true;
 }
 
+bool RebuildingReadStorageTask::Filter::storageSetNeedsRebuilding(
+    const StorageSet& storage_set) const {
+  // TODO(T43708398): same as in populateFilterParams(), only look at append
+  // dirty ranges.
+  const auto dc = DataClass::APPEND;
+  for (ShardID shard : storage_set) {
+    auto node_kv = context->rebuildingSet->shards.find(shard);
+    if (node_kv == context->rebuildingSet->shards.end()) {
+      continue;
+    }
+    const auto& node_info = node_kv->second;
+    if (node_info.dc_dirty_ranges.empty()) {
+      // Dirty for all time points.
+      return true;
+    }
+    if (node_info.dc_dirty_ranges.count(dc) &&
+        !timeRangeCache.shardsOutsideTimeRange.count(
+            std::make_pair(shard, dc))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool RebuildingReadStorageTask::Filter::
 operator()(logid_t log,
            lsn_t lsn,
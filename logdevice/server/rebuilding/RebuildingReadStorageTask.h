@@ -108,6 +108,9 @@ class RebuildingReadStorageTask : public StorageTask {
     // What fraction of data we have read, approximately. Between 0 and 1.
     // -1 if not supported.
     double progress = 0;
+    // Approximate size of all the data this context reads, in bytes.
+    // -1 if not supported.
+    int64_t totalBytes = -1;
 
     // Bytes read (including CSI, filtered out records and and other overhead)
     // by the last storage task.
@@ -156,12 +159,21 @@ class RebuildingReadStorageTask : public StorageTask {
     return Principal::REBUILD;
   }
 
+  // Verifies payload checksums of all records in `chunks` in one batch and
+  // sets ChunkData::checksumsVerified for chunks whose records all passed.
+  // Chunks with a bad record are left for RecordRebuildingStore to verify
+  // record by record, and to report. Public for tests.
+  static void
+  verifyChecksumsInBatch(std::vector<std::unique_ptr<ChunkData>>& chunks);
+
  protected:
   // Can be overridden in tests.
   virtual UpdateableSettings<Settings> getSettings();
   virtual std::shared_ptr<UpdateableConfig> getConfig();
   virtual folly::Optional<NodeID> getMyNodeID();
   virtual StatsHolder* getStats();
+  // LocalLogStore::verifiesChecksumsOnWriteAndRead() of the shard.
+  virtual bool storeVerifiesChecksums();
 
   virtual std::unique_ptr<LocalLogStore::AllLogsIterator> createIterator(
       const LocalLogStore::ReadOptions& opts,
@@ -203,6 +215,12 @@ class RebuildingReadStorageTask : public StorageTask {
                                   RecordTimestamp min_ts,
                                   RecordTimestamp max_ts) override;
 
+    // Returns false if none of the shards in `storage_set` is in the
+    // rebuilding set with dirty ranges intersecting the time range cached in
+    // timeRangeCache, i.e. no record with a copyset drawn from `storage_set`
+    // and a timestamp in that range needs rebuilding.
+    bool storageSetNeedsRebuilding(const StorageSet& storage_set) const;
+
     // Finds the log in `context->logs` and puts it in `currentLogState`.
     // Has a fast path for consecutive lookups of the same log.
     // If the log is not in `context->logs`, sets currentLogState = nullptr
@@ -278,6 +296,9 @@ class RebuildingReadStorageTask : public StorageTask {
     size_t nRecordsDrainedFiltered{std::numeric_limits<size_t>::max() / 2};
     size_t nRecordsTimestampFiltered{std::numeric_limits<size_t>::max() / 2};
     size_t nRecordsEpochRangeFiltered{std::numeric_limits<size_t>::max() / 2};
+    // Not records but whole (log, partition) ranges skipped by
+    // shouldProcessRecordRange() because of storageSetNeedsRebuilding().
+    size_t nRecordRangesCleanFiltered{std::numeric_limits<size_t>::max() / 2};
   };
 
   std::weak_ptr<Context> context_;
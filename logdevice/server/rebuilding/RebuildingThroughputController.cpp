@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/rebuilding/RebuildingThroughputController.h"
+
+#include <algorithm>
+
+#include "logdevice/common/settings/RebuildingSettings.h"
+
+namespace facebook { namespace logdevice {
+
+constexpr double RebuildingThroughputController::kMinScale;
+constexpr double RebuildingThroughputController::kScaleIncrease;
+constexpr uint64_t RebuildingThroughputController::kMinSamples;
+
+double
+RebuildingThroughputController::update(const HistogramInterface& append_latency,
+                                       const HistogramInterface& store_latency,
+                                       const RebuildingSettings& settings) {
+  const bool first = !appendWindow_.primed();
+  auto append_p99 = appendWindow_.update(append_latency);
+  auto store_p99 = storeWindow_.update(store_latency);
+  if (first) {
+    // Nothing to compare with yet.
+    return scale_;
+  }
+
+  const bool over_target =
+      (append_p99.hasValue() &&
+       append_p99.value() > settings.autotune_append_latency_p99) ||
+      (store_p99.hasValue() &&
+       store_p99.value() > settings.autotune_store_latency_p99);
+  if (over_target) {
+    scale_ = std::max(kMinScale, scale_ / 2);
+  } else {
+    scale_ = std::min(std::max(1.0, settings.autotune_max_scale),
+                      scale_ + kScaleIncrease);
+  }
+  return scale_;
+}
+
+void RebuildingThroughputController::reset() {
+  scale_ = 1;
+  appendWindow_.reset();
+  storeWindow_.reset();
+}
+
+folly::Optional<std::chrono::microseconds>
+RebuildingThroughputController::Window::update(
+    const HistogramInterface& current) {
+  const bool had_previous = havePrevious_;
+  LatencyHistogram window;
+  window.assign(current);
+  // If the histogram has fewer values than last time, stats were reset in
+  // between, and `current` only has new values.
+  if (had_previous &&
+      previous_.getCountAndSum().first <= current.getCountAndSum().first) {
+    window.subtract(previous_);
+  }
+  previous_.assign(current);
+  havePrevious_ = true;
+
+  if (!had_previous || window.getCountAndSum().first < kMinSamples) {
+    return folly::none;
+  }
+  return std::chrono::microseconds(window.estimatePercentile(.99));
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <folly/Optional.h>
+
+#include "logdevice/common/stats/Histogram.h"
+
+namespace facebook { namespace logdevice {
+
+struct RebuildingSettings;
+
+/**
+ * @file Closed-loop controller that adapts how hard a rebuilding donor pushes
+ *       to how the clients of the node are doing. Every
+ *       rebuilding-autotune-interval ShardRebuilding hands it the cumulative
+ *       append latency histogram of the node and the store latency histogram
+ *       of the donor shard. The controller looks at the p99 of the values
+ *       added since the previous update and maintains a scale factor for the
+ *       in-flight limits of rebuilding (rebuilding-max-records-in-flight and
+ *       rebuilding-max-record-bytes-in-flight):
+ *        - if either p99 is above its target, the scale is halved, down to
+ *          kMinScale;
+ *        - otherwise the scale goes up by kScaleIncrease, up to
+ *          rebuilding-autotune-max-scale.
+ *       A latency with fewer than kMinSamples new values in the interval is
+ *       considered to be below target. The first update() only takes a
+ *       snapshot of the histograms and doesn't change the scale.
+ *
+ *       Not thread-safe.
+ */
+
+class RebuildingThroughputController {
+ public:
+  static constexpr double kMinScale = 1.0 / 16;
+  static constexpr double kScaleIncrease = 0.25;
+  static constexpr uint64_t kMinSamples = 100;
+
+  /**
+   * @param append_latency  cumulative histogram of append latencies
+   * @param store_latency   cumulative histogram of store latencies on the
+   *                        donor shard
+   * @return  the new scale
+   */
+  double update(const HistogramInterface& append_latency,
+                const HistogramInterface& store_latency,
+                const RebuildingSettings& settings);
+
+  double scale() const {
+    return scale_;
+  }
+
+  // Goes back to scale 1 and forgets the previous histograms.
+  void reset();
+
+ private:
+  // Remembers a cumulative histogram to compute percentiles of the values
+  // added to it between consecutive calls to update().
+  class Window {
+   public:
+    // Returns the p99 of the values added since the previous call, or
+    // folly::none if there are fewer than kMinSamples of them or there was
+    // no previous call.
+    folly::Optional<std::chrono::microseconds>
+    update(const HistogramInterface& current);
+
+    bool primed() const {
+      return havePrevious_;
+    }
+
+    void reset() {
+      havePrevious_ = false;
+    }
+
+   private:
+    LatencyHistogram previous_;
+    bool havePrevious_ = false;
+  };
+
+  double scale_ = 1;
+  Window appendWindow_;
+  Window storeWindow_;
+};
+
+}} // namespace facebook::logdevice
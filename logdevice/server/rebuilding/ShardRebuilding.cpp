@@ -7,9 +7,13 @@
  */
 #include "logdevice/server/rebuilding/ShardRebuilding.h"
 
+#include <cmath>
+
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/configuration/InternalLogs.h"
+#include "logdevice/common/stats/PerShardHistograms.h"
+#include "logdevice/common/stats/ServerHistograms.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 
@@ -45,6 +49,9 @@ ShardRebuilding::ShardRebuilding(
 ShardRebuilding::~ShardRebuilding() {
   PER_SHARD_STAT_SET(
       getStats(), rebuilding_global_window_waiting_flag, shard_, 0);
+  PER_SHARD_STAT_SET(getStats(), rebuilding_autotune_scale_percent, shard_, 0);
+  PER_SHARD_STAT_SET(getStats(), rebuilding_bytes_remaining, shard_, 0);
+  PER_SHARD_STAT_SET(getStats(), rebuilding_eta_seconds, shard_, 0);
   abortChunkRebuildings();
 }
 
@@ -67,25 +74,9 @@ void ShardRebuilding::start(
   startTime_ = SteadyTimestamp::now();
   readingProgressTimestamp_ = direction_.firstTimestamp();
   readRateLimiter_ = RateLimiter(rebuildingSettings_->rate_limit);
-  readContext_ = std::make_shared<RebuildingReadStorageTask::Context>();
-  readContext_->onDone = [this, this_ref = callbackHelper_.getHolder().ref()](
-                             std::vector<std::unique_ptr<ChunkData>> chunks) {
-    if (this_ref.get() != nullptr) {
-      onReadTaskDone(std::move(chunks));
-    }
-  };
-  readContext_->rebuildingSet = rebuildingSet_;
-  readContext_->rebuildingSettings = rebuildingSettings_;
-  readContext_->myShardID = ShardID(getMyNodeIndex(), shard_);
-  readContext_->progressTimestamp = direction_.firstTimestamp();
 
-  for (const auto& log_plan : plan) {
-    auto ins = readContext_->logs.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(log_plan.first),
-        std::forward_as_tuple(std::move(*log_plan.second)));
-    ld_check(ins.second);
-  }
+  addReadStreams(
+      std::move(plan), std::max<size_t>(1, rebuildingSettings_->read_streams));
 
   delayedReadTimer_ = createTimer([this] { tryMakeProgress(); });
   iteratorInvalidationTimer_ = createTimer([this] { invalidateIterator(); });
@@ -95,13 +86,69 @@ void ShardRebuilding::start(
   });
 
   profilingTimer_->activate(PROFILING_TIMER_PERIOD);
+  autotuneTimer_ = createTimer([this] { autotune(); });
+  updateAutotuneTimer();
+
+  tryMakeProgress();
+}
 
+void ShardRebuilding::expectMoreLogs() {
+  ld_check(readStreams_.empty());
+  morePlansExpected_ = true;
+}
+
+void ShardRebuilding::addLogs(
+    std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan,
+    bool last) {
+  ld_check(!readStreams_.empty());
+  ld_check(morePlansExpected_);
+  if (!plan.empty()) {
+    numLogs_ += plan.size();
+    addReadStreams(std::move(plan), 1);
+  }
+  if (last) {
+    morePlansExpected_ = false;
+  }
+  // This may complete the rebuilding if the last batch is empty.
   tryMakeProgress();
 }
 
+void ShardRebuilding::addReadStreams(
+    std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan,
+    size_t num_streams) {
+  const size_t first = readStreams_.size();
+  readStreams_.resize(first + num_streams);
+  for (size_t i = first; i < readStreams_.size(); ++i) {
+    ReadStream& stream = readStreams_[i];
+    stream.context = std::make_shared<RebuildingReadStorageTask::Context>();
+    auto& context = *stream.context;
+    context.onDone = [this, i, this_ref = callbackHelper_.getHolder().ref()](
+                         std::vector<std::unique_ptr<ChunkData>> chunks) {
+      if (this_ref.get() != nullptr) {
+        onReadTaskDone(i, std::move(chunks));
+      }
+    };
+    context.rebuildingSet = rebuildingSet_;
+    context.rebuildingSettings = rebuildingSettings_;
+    context.myShardID = ShardID(getMyNodeIndex(), shard_);
+    context.progressTimestamp = direction_.firstTimestamp();
+    stream.progressTimestamp = direction_.firstTimestamp();
+  }
+
+  for (const auto& log_plan : plan) {
+    auto& context =
+        *readStreams_[first + log_plan.first.val_ % num_streams].context;
+    auto ins = context.logs.emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(log_plan.first),
+        std::forward_as_tuple(std::move(*log_plan.second)));
+    ld_check(ins.second);
+  }
+}
+
 void ShardRebuilding::advanceGlobalWindow(RecordTimestamp new_window_end) {
   globalWindowEnd_ = new_window_end;
-  if (readContext_ != nullptr) {
+  if (!readStreams_.empty()) {
     tryMakeProgress();
   } else {
     // start() hasn't been called yet.
@@ -110,42 +157,82 @@ void ShardRebuilding::advanceGlobalWindow(RecordTimestamp new_window_end) {
 
 void ShardRebuilding::sendStorageTaskIfNeeded() {
   const size_t read_batch_size = rebuildingSettings_->max_batch_bytes;
-  // Hard code max size of readBuffer_ as 3x max read batch size.
+  // Streams added by addLogs() don't read concurrently beyond
+  // rebuilding_read_streams.
+  const size_t max_tasks_in_flight = std::min(
+      readStreams_.size(),
+      std::max<size_t>(1, rebuildingSettings_->read_streams));
+  // Hard code max size of readBuffer_ as 3x max read batch size, plus one
+  // batch for each additional concurrent read.
   // This could be a separate setting, but that doesn't seem very useful.
-  const size_t max_read_buffer_size = read_batch_size * 3;
+  const size_t max_read_buffer_size =
+      read_batch_size * (max_tasks_in_flight + 2);
 
   // Note that reading is not affected by global window or
   // max_record_bytes_in_flight. Reading just tries to keep readBuffer_
   // reasonably full.
-  if (completed_ || storageTaskInFlight_ || readContext_->reachedEnd ||
-      readContext_->persistentError ||
-      bytesInReadBuffer_ + read_batch_size > max_read_buffer_size ||
+  if (completed_ || readingPersistentError() ||
       rebuildingSettings_->test_stall_rebuilding) {
     return;
   }
 
-  // Consult rate limiter. Use zero cost for now. We'll tell rate limiter the
-  // actual cost in bytes once the storage task is done.
-  std::chrono::steady_clock::duration to_wait;
-  bool allowed = readRateLimiter_.isAllowed(
-      0, &to_wait, std::chrono::steady_clock::duration::zero());
-  if (!allowed) {
-    if (to_wait != std::chrono::steady_clock::duration::max()) {
-      delayedReadTimer_->activate(
-          std::chrono::duration_cast<std::chrono::microseconds>(to_wait));
+  for (size_t i = 0; i < readStreams_.size(); ++i) {
+    ReadStream& stream = readStreams_[i];
+    if (stream.taskInFlight || stream.context->reachedEnd) {
+      continue;
+    }
+    if (storageTasksInFlight_ >= max_tasks_in_flight) {
+      return;
+    }
+    // Leave room in the read buffer for the results of all tasks in flight.
+    if (bytesInReadBuffer_ + read_batch_size * (storageTasksInFlight_ + 1) >
+        max_read_buffer_size) {
+      return;
+    }
+
+    // Consult rate limiter. Use zero cost for now. We'll tell rate limiter the
+    // actual cost in bytes once the storage task is done.
+    std::chrono::steady_clock::duration to_wait;
+    bool allowed = readRateLimiter_.isAllowed(
+        0, &to_wait, std::chrono::steady_clock::duration::zero());
+    if (!allowed) {
+      if (to_wait != std::chrono::steady_clock::duration::max()) {
+        delayedReadTimer_->activate(
+            std::chrono::duration_cast<std::chrono::microseconds>(to_wait));
+      }
+      return;
+    }
+
+    if (stream.context->iterator != nullptr && storageTasksInFlight_ == 0) {
+      iteratorInvalidationTimer_->cancel();
+    }
+    stream.taskInFlight = true;
+    ++storageTasksInFlight_;
+    putStorageTask(i);
+  }
+}
+
+bool ShardRebuilding::readingReachedEnd() const {
+  for (const ReadStream& stream : readStreams_) {
+    if (stream.taskInFlight || !stream.context->reachedEnd) {
+      return false;
     }
-    return;
   }
+  return true;
+}
 
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->cancel();
+bool ShardRebuilding::readingPersistentError() const {
+  for (const ReadStream& stream : readStreams_) {
+    if (!stream.taskInFlight && stream.context->persistentError) {
+      return true;
+    }
   }
-  storageTaskInFlight_ = true;
-  putStorageTask();
+  return false;
 }
 
-void ShardRebuilding::putStorageTask() {
-  auto task = std::make_unique<RebuildingReadStorageTask>(readContext_);
+void ShardRebuilding::putStorageTask(size_t stream_idx) {
+  auto task = std::make_unique<RebuildingReadStorageTask>(
+      readStreams_[stream_idx].context);
   auto task_queue =
       ServerWorker::onThisThread()->getStorageTaskQueueForShard(shard_);
   task_queue->putTask(std::move(task));
@@ -161,17 +248,26 @@ ShardRebuilding::createTimer(std::function<void()> cb) {
 }
 
 void ShardRebuilding::invalidateIterator() {
-  ld_info("Invalidating rebuilding iterator in shard %u", shard_);
-  ld_check(!storageTaskInFlight_);
-  ld_check(readContext_->iterator != nullptr);
-  readContext_->iterator->invalidate();
+  ld_info("Invalidating rebuilding iterators in shard %u", shard_);
+  // Streams that have a task in flight are using their iterators.
+  for (ReadStream& stream : readStreams_) {
+    if (!stream.taskInFlight && stream.context->iterator != nullptr) {
+      stream.context->iterator->invalidate();
+    }
+  }
 }
 
 void ShardRebuilding::onReadTaskDone(
+    size_t stream_idx,
     std::vector<std::unique_ptr<ChunkData>> chunks) {
+  ld_check_lt(stream_idx, readStreams_.size());
+  ReadStream& stream = readStreams_[stream_idx];
+  ld_check(stream.taskInFlight);
+  const RebuildingReadStorageTask::Context& context = *stream.context;
+
   // Report the cost of this read task to rate limiter.
   std::chrono::steady_clock::duration unused;
-  readRateLimiter_.isAllowed(readContext_->bytesRead, &unused);
+  readRateLimiter_.isAllowed(context.bytesRead, &unused);
 
   for (auto& c : chunks) {
     bytesInReadBuffer_ += c->totalBytes();
@@ -179,22 +275,50 @@ void ShardRebuilding::onReadTaskDone(
   readBuffer_.insert(readBuffer_.end(),
                      std::make_move_iterator(chunks.begin()),
                      std::make_move_iterator(chunks.end()));
-  storageTaskInFlight_ = false;
+  stream.taskInFlight = false;
+  ld_check_gt(storageTasksInFlight_, 0);
+  --storageTasksInFlight_;
   ++readTasksDone_;
-  nextLocation_ = readContext_->nextLocation;
-  readingProgressTimestamp_ = readContext_->progressTimestamp;
-  readingProgress_ = readContext_->progress;
-  if (readContext_->iterator != nullptr) {
+  stream.nextLocation = context.nextLocation;
+  stream.progressTimestamp = context.progressTimestamp;
+  stream.progress = context.progress;
+  stream.totalBytes = context.totalBytes;
+
+  // Report the timestamp of the stream that is furthest behind, not counting
+  // streams that have finished unless all of them have.
+  const bool all_reached_end = readingReachedEnd();
+  readingProgressTimestamp_ = direction_.lastTimestamp();
+  readingProgress_ = 0;
+  for (const ReadStream& s : readStreams_) {
+    const bool finished = !s.taskInFlight && s.context->reachedEnd;
+    if ((all_reached_end || !finished) &&
+        direction_.timestampCmp(
+            s.progressTimestamp, readingProgressTimestamp_) < 0) {
+      readingProgressTimestamp_ = s.progressTimestamp;
+    }
+    if (s.progress < 0 || readingProgress_ < 0) {
+      readingProgress_ = -1;
+    } else {
+      readingProgress_ += s.progress / readStreams_.size();
+    }
+  }
+  updateRemainingBytesEstimate();
+
+  if (context.iterator != nullptr) {
     iteratorInvalidationTimer_->activate(getIteratorTTL());
   }
   tryMakeProgress();
 }
 
 void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
-  const size_t max_records_in_flight =
-      rebuildingSettings_->max_records_in_flight;
-  const size_t max_bytes_in_flight =
-      rebuildingSettings_->max_record_bytes_in_flight;
+  const double scale = throughputController_.scale();
+  const size_t max_records_in_flight = std::max<size_t>(
+      1,
+      static_cast<size_t>(rebuildingSettings_->max_records_in_flight * scale));
+  const size_t max_bytes_in_flight = std::max<size_t>(
+      1,
+      static_cast<size_t>(rebuildingSettings_->max_record_bytes_in_flight *
+                          scale));
   const bool new_to_old = rebuildingSettings_->new_to_old;
 
   auto is_log_exempted_from_window = [&](logid_t log) {
@@ -370,14 +494,14 @@ void ShardRebuilding::onChunkRebuildingDone(chunk_rebuilding_id_t chunk_id,
 }
 
 void ShardRebuilding::finalizeIfNeeded() {
-  // We're done if reading has reached the end, read buffer was drained,
-  // and all chunk rebuildings have completed.
+  // We're done if all logs were planned, reading has reached the end, read
+  // buffer was drained, and all chunk rebuildings have completed.
   // Additionally, if we got a persistent read error, we just stall the
   // ShardRebuilding indefinitely; usually this happens if our own disk is
   // broken, in which case self-initiated rebuilding will soon request a
   // rebuilding, and this ShardRebuilding will be aborted.
-  if (completed_ || storageTaskInFlight_ || !readContext_->reachedEnd ||
-      readContext_->persistentError || !readBuffer_.empty() ||
+  if (completed_ || morePlansExpected_ || !readingReachedEnd() ||
+      readingPersistentError() || !readBuffer_.empty() ||
       !chunkRebuildings_.empty()) {
     return;
   }
@@ -411,9 +535,57 @@ void ShardRebuilding::noteConfigurationChanged() {
 
 void ShardRebuilding::noteRebuildingSettingsChanged() {
   readRateLimiter_.update(rebuildingSettings_->rate_limit);
+  if (autotuneTimer_) {
+    updateAutotuneTimer();
+  }
   tryMakeProgress();
 }
 
+void ShardRebuilding::updateAutotuneTimer() {
+  if (rebuildingSettings_->autotune_interval.count() <= 0) {
+    autotuneTimer_->cancel();
+    throughputController_.reset();
+    PER_SHARD_STAT_SET(
+        getStats(), rebuilding_autotune_scale_percent, shard_, 0);
+  } else if (!autotuneTimer_->isActive()) {
+    // The first update() only takes a snapshot of the histograms.
+    autotune();
+  }
+}
+
+void ShardRebuilding::autotune() {
+  const auto interval = rebuildingSettings_->autotune_interval;
+  if (interval.count() <= 0) {
+    return;
+  }
+  autotuneTimer_->activate(interval);
+
+  LatencyHistogram append_latency;
+  LatencyHistogram store_latency;
+  getClientLatencies(&append_latency, &store_latency);
+  const double prev_scale = throughputController_.scale();
+  const double scale = throughputController_.update(
+      append_latency, store_latency, *rebuildingSettings_.get());
+
+  StatsHolder* stats = getStats();
+  PER_SHARD_STAT_SET(stats,
+                     rebuilding_autotune_scale_percent,
+                     shard_,
+                     static_cast<int64_t>(scale * 100));
+  if (scale < prev_scale) {
+    PER_SHARD_STAT_INCR(stats, rebuilding_autotune_backoffs, shard_);
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Client latencies on shard %u are above target, lowering "
+                   "rebuilding in-flight limits to %.2fx",
+                   shard_,
+                   scale);
+  } else if (scale > prev_scale) {
+    PER_SHARD_STAT_INCR(stats, rebuilding_autotune_raises, shard_);
+    tryMakeProgress();
+  }
+}
+
 void ShardRebuilding::getDebugInfo(InfoRebuildingShardsTable& table) const {
   // Some measure of how far we have progressed, in terms of record timestamps.
   if (!chunkRebuildings_.empty()) {
@@ -430,26 +602,95 @@ void ShardRebuilding::getDebugInfo(InfoRebuildingShardsTable& table) const {
   table.set<6>(bytesInReadBuffer_ + chunkRebuildingBytesInFlight_);
   table.set<7>(numLogs_);
   table.set<9>(describeTimeByState());
-  table.set<10>(storageTaskInFlight_);
-  if (!storageTaskInFlight_) {
-    table.set<11>(readContext_->persistentError);
-  }
+  table.set<10>(storageTasksInFlight_ > 0);
+  table.set<11>(readingPersistentError());
   table.set<12>(bytesInReadBuffer_);
   // TODO (#24665001):
   //   When ChunkRebuilding gets reimplemented to process all records at once,
   //   change this into number of chunks in flight.
   table.set<13>(chunkRebuildingRecordsInFlight_);
-  if (nextLocation_ != nullptr) {
-    table.set<14>(nextLocation_->toString());
+  std::string locations;
+  for (const ReadStream& stream : readStreams_) {
+    if (stream.nextLocation != nullptr) {
+      locations += (locations.empty() ? "" : ", ") +
+          stream.nextLocation->toString();
+    }
+  }
+  if (!locations.empty()) {
+    table.set<14>(locations);
   }
   table.set<15>(readingProgress_);
+  table.set<16>(bytesTotal_);
+  table.set<17>(bytesRemaining_);
+  table.set<18>(bytesPerSec_);
+  table.set<19>(getETA().count());
+}
+
+void ShardRebuilding::updateRemainingBytesEstimate() {
+  int64_t total = 0;
+  double done = 0;
+  for (const ReadStream& s : readStreams_) {
+    if (s.totalBytes < 0 || s.progress < 0) {
+      total = -1;
+      break;
+    }
+    total += s.totalBytes;
+    done += s.progress * s.totalBytes;
+  }
+  if (total < 0) {
+    bytesTotal_ = bytesRemaining_ = -1;
+    bytesPerSec_ = 0;
+    return;
+  }
+
+  bytesTotal_ = total;
+  bytesRemaining_ = std::max<int64_t>(0, total - static_cast<int64_t>(done));
+  const auto now = SteadyTimestamp::now();
+  if (throughputStartTime_ == SteadyTimestamp::min()) {
+    throughputStartTime_ = now;
+    throughputStartBytes_ = static_cast<int64_t>(done);
+  } else {
+    const double elapsed_sec =
+        std::chrono::duration_cast<std::chrono::duration<double>>(
+            now - throughputStartTime_)
+            .count();
+    if (elapsed_sec > 0) {
+      bytesPerSec_ =
+          std::max(0.0, (done - throughputStartBytes_) / elapsed_sec);
+    }
+  }
+
+  PER_SHARD_STAT_SET(
+      getStats(), rebuilding_bytes_remaining, shard_, bytesRemaining_);
+  PER_SHARD_STAT_SET(
+      getStats(), rebuilding_eta_seconds, shard_, getETA().count());
+}
+
+std::chrono::seconds ShardRebuilding::getETA() const {
+  if (bytesRemaining_ < 0) {
+    return std::chrono::seconds(-1);
+  }
+  if (bytesRemaining_ == 0) {
+    return std::chrono::seconds(0);
+  }
+  if (bytesPerSec_ <= 0) {
+    return std::chrono::seconds(-1);
+  }
+  return std::chrono::seconds(
+      static_cast<int64_t>(std::ceil(bytesRemaining_ / bytesPerSec_)));
 }
 
 std::function<void(InfoRebuildingLogsTable&)>
 ShardRebuilding::beginGetLogsDebugInfo() const {
-  ld_check(readContext_ != nullptr);
-  return [context = readContext_](InfoRebuildingLogsTable& table) {
-    context->getLogsDebugInfo(table);
+  ld_check(!readStreams_.empty());
+  std::vector<std::shared_ptr<RebuildingReadStorageTask::Context>> contexts;
+  for (const ReadStream& stream : readStreams_) {
+    contexts.push_back(stream.context);
+  }
+  return [contexts = std::move(contexts)](InfoRebuildingLogsTable& table) {
+    for (const auto& context : contexts) {
+      context->getLogsDebugInfo(table);
+    }
   };
 }
 
@@ -457,6 +698,23 @@ StatsHolder* ShardRebuilding::getStats() {
   return Worker::stats();
 }
 
+void ShardRebuilding::getClientLatencies(LatencyHistogram* append_latency,
+                                         LatencyHistogram* store_latency) {
+  StatsHolder* stats = getStats();
+  if (stats == nullptr) {
+    return;
+  }
+  stats->runForEach([&](Stats& s) {
+    if (s.server_histograms) {
+      append_latency->merge(s.server_histograms->append_latency);
+    }
+    if (s.per_shard_histograms &&
+        s.per_shard_histograms->store_latency.getNumShards() > shard_) {
+      store_latency->merge(*s.per_shard_histograms->store_latency.get(shard_));
+    }
+  });
+}
+
 node_index_t ShardRebuilding::getMyNodeIndex() {
   return my_node_id_.index();
 }
@@ -481,7 +739,9 @@ void ShardRebuilding::flushCurrentStateTime() {
   ld_check(currentStateStartTime_ != SteadyTimestamp::min());
   auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
       now - currentStateStartTime_);
-  currentStateStartTime_ = now;
+  // Carry the sub-millisecond remainder over to the next flush, otherwise
+  // frequent state changes would make most of the time disappear.
+  currentStateStartTime_ += elapsed_ms;
 
   totalTimeByState_[(int)profilingState_] += elapsed_ms;
 
@@ -504,7 +764,7 @@ void ShardRebuilding::flushCurrentStateTime() {
 void ShardRebuilding::updateProfilingState() {
   ProfilingState new_state;
   if (chunkRebuildings_.empty()) {
-    if (storageTaskInFlight_) {
+    if (storageTasksInFlight_ > 0) {
       new_state = ProfilingState::WAITING_FOR_READ;
     } else if (readBuffer_.empty()) {
       new_state = ProfilingState::RATE_LIMITED;
@@ -512,13 +772,13 @@ void ShardRebuilding::updateProfilingState() {
       new_state = ProfilingState::STALLED;
     }
   } else {
-    new_state = storageTaskInFlight_
+    new_state = storageTasksInFlight_ > 0
         ? ProfilingState::FULLY_OCCUPIED
         : ProfilingState::WAITING_FOR_REREPLICATION;
   }
   if (new_state != profilingState_) {
     // Log a message if we started or stopped waiting on global window.
-    if (storageTaskInFlight_ || !readContext_->persistentError) {
+    if (!readingPersistentError()) {
       if (new_state == ProfilingState::STALLED) {
         PER_SHARD_STAT_SET(
             getStats(), rebuilding_global_window_waiting_flag, shard_, 1);
@@ -15,6 +15,7 @@
 #include "logdevice/common/settings/RebuildingSettings.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/rebuilding/RebuildingReadStorageTask.h"
+#include "logdevice/server/rebuilding/RebuildingThroughputController.h"
 
 namespace facebook { namespace logdevice {
 
@@ -31,11 +32,16 @@ class ShardRebuilding : public ShardRebuildingInterface {
 
   void start(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan)
       override;
+  void expectMoreLogs() override;
+  void
+  addLogs(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan,
+          bool last) override;
   void advanceGlobalWindow(RecordTimestamp new_window_end) override;
   void noteConfigurationChanged() override;
   void noteRebuildingSettingsChanged() override;
 
-  void onReadTaskDone(std::vector<std::unique_ptr<ChunkData>> chunks);
+  void onReadTaskDone(size_t stream_idx,
+                      std::vector<std::unique_ptr<ChunkData>> chunks);
   void onChunkRebuildingDone(chunk_rebuilding_id_t chunk_id,
                              RecordTimestamp oldest_timestamp);
 
@@ -56,8 +62,12 @@ class ShardRebuilding : public ShardRebuildingInterface {
   virtual worker_id_t startChunkRebuilding(std::unique_ptr<ChunkData> chunk,
                                            chunk_rebuilding_id_t chunk_id);
   virtual std::chrono::milliseconds getIteratorTTL();
-  virtual void putStorageTask();
+  virtual void putStorageTask(size_t stream_idx);
   virtual std::unique_ptr<TimerInterface> createTimer(std::function<void()> cb);
+  // Merges append latency histograms of all threads into `append_latency`
+  // and store latency histograms of this shard into `store_latency`.
+  virtual void getClientLatencies(LatencyHistogram* append_latency,
+                                  LatencyHistogram* store_latency);
 
  protected:
   // Key in the ordered map of in-flight chunk rebuildings.
@@ -91,14 +101,34 @@ class ShardRebuilding : public ShardRebuildingInterface {
   Listener* listener_;
   RebuildingDirectionHelper direction_;
   bool completed_ = false;
+  // True between expectMoreLogs() and addLogs(..., last = true).
+  bool morePlansExpected_ = false;
 
   RecordTimestamp globalWindowEnd_;
 
-  // There's at most one RebuildingReadStorageTask in flight at any time.
-  bool storageTaskInFlight_ = false;
-  // The reading context is shared between us and the storage task.
-  // When a storage task is in flight, we're not allowed to access the context.
-  std::shared_ptr<RebuildingReadStorageTask::Context> readContext_;
+  // The shard is read by rebuilding_read_streams independent streams. Logs
+  // are split among them, so all records of a log are read by one stream, in
+  // the same order as with a single stream. Each stream has its own iterator
+  // and at most one RebuildingReadStorageTask in flight at any time.
+  // Each addLogs() call appends one more stream for its logs; at most
+  // rebuilding_read_streams streams have a task in flight at a time.
+  struct ReadStream {
+    // The reading context is shared between us and the storage task.
+    // When a storage task is in flight, we're not allowed to access the
+    // context.
+    std::shared_ptr<RebuildingReadStorageTask::Context> context;
+    bool taskInFlight = false;
+
+    // These are duplicated from context to make sure we always have
+    // lock-free access to them.
+    std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation;
+    RecordTimestamp progressTimestamp;
+    double progress = 0;
+    int64_t totalBytes = -1;
+  };
+  std::vector<ReadStream> readStreams_;
+  // Number of streams with taskInFlight.
+  size_t storageTasksInFlight_ = 0;
 
   RateLimiter readRateLimiter_;
   // The timer is used when readRateLimiter_ tells us to wait before reading.
@@ -125,6 +155,11 @@ class ShardRebuilding : public ShardRebuildingInterface {
   // data indefinitely.
   std::unique_ptr<TimerInterface> iteratorInvalidationTimer_;
 
+  // Scales the in-flight limits according to client latencies if
+  // rebuilding-autotune-interval is positive. Runs on autotuneTimer_.
+  RebuildingThroughputController throughputController_;
+  std::unique_ptr<TimerInterface> autotuneTimer_;
+
   WorkerCallbackHelper<ShardRebuilding> callbackHelper_;
 
   static std::atomic<chunk_rebuilding_id_t::raw_type> nextChunkID_;
@@ -132,12 +167,28 @@ class ShardRebuilding : public ShardRebuildingInterface {
   // Posts requests to abort state machines listed in chunkRebuildings_.
   void abortChunkRebuildings();
 
+  // True if all read streams have read everything.
+  bool readingReachedEnd() const;
+  // True if some read stream got a persistent error. Rebuilding stalls then.
+  bool readingPersistentError() const;
+
+  // Appends `num_streams` read streams and splits the logs of `plan` among
+  // them.
+  void addReadStreams(
+      std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan,
+      size_t num_streams);
   void sendStorageTaskIfNeeded();
   void startSomeChunkRebuildingsIfNeeded();
   void finalizeIfNeeded();
 
   void invalidateIterator();
 
+  // Feeds client latencies to throughputController_ and reschedules
+  // autotuneTimer_.
+  void autotune();
+  // Starts or stops autotuneTimer_ according to settings.
+  void updateAutotuneTimer();
+
   void tryMakeProgress();
 
   // Stuff below is for instrumentation and stats.
@@ -177,24 +228,40 @@ class ShardRebuilding : public ShardRebuildingInterface {
   size_t recordsRebuilt_ = 0;
   size_t bytesRebuilt_ = 0;
   size_t readTasksDone_ = 0;
-  // These are duplicated from readContext_ to make sure we always have
-  // lock-free access to them.
   size_t numLogs_;
-  std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation_;
   // Calls flushCurrentStateTime() every minute, to make sure we're publishing
   // accurate time spent in each state even when state doesn't change often.
   std::unique_ptr<TimerInterface> profilingTimer_;
 
-  // How far the iterator has read, approximately.
+  // How far the iterators have read, approximately. With multiple read
+  // streams, this is the progress of the one furthest behind.
   // Note that this may not correspond to any record.
   // In particular, if we're filtering out very long ranges of data, this
   // iterator will show progress of the filtering, while any record-based
   // indicators would stand still until we find a record that passes filter.
   RecordTimestamp readingProgressTimestamp_;
   // Value between 0 and 1 indicating approximately what fraction of the data
-  // we have read. -1 means not supported.
+  // we have read, averaged over read streams. -1 means not supported.
   double readingProgress_ = 0;
 
+  // Estimates of how much data is left to read, based on the data size
+  // estimates of the read streams' iterators. -1 if not supported.
+  int64_t bytesTotal_ = -1;
+  int64_t bytesRemaining_ = -1;
+  // Average reading throughput since the first read task completed, in
+  // bytes of data per second. Includes time spent throttled or waiting for
+  // the global window, so bytesRemaining_ / bytesPerSec_ is an estimate of
+  // the time left.
+  double bytesPerSec_ = 0;
+  SteadyTimestamp throughputStartTime_ = SteadyTimestamp::min();
+  int64_t throughputStartBytes_ = 0;
+
+  // Updates the estimates above from readStreams_ and publishes them to
+  // stats.
+  void updateRemainingBytesEstimate();
+  // Estimated time until all data is read. -1 if unknown.
+  std::chrono::seconds getETA() const;
+
   // Advances currentStateStartTime_ to current time, updating totalTimeByState_
   // and stats as needed.
   void flushCurrentStateTime();
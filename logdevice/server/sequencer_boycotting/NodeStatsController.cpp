@@ -130,19 +130,21 @@ void NodeStatsController::aggregateThroughCallback(AggregateStatsCallback cb) {
   const auto required_client_count = getRequiredClientCount();
 
   size_t max_period_count = 0;
-  std::unordered_set<NodeID, NodeID::Hash> all_nodes;
-  std::vector<std::unordered_map<NodeID, unsigned int, NodeID::Hash>>
-      node_mapping(received_stats_.size());
+  // For each node, where stats about it are in received_stats_: pairs of
+  // (index in received_stats_, node index in that BucketedNodeStats). Built
+  // once so that the loop below doesn't look nodes up for every period.
+  std::unordered_map<NodeID,
+                     std::vector<std::pair<unsigned int, unsigned int>>,
+                     NodeID::Hash>
+      node_mapping;
 
-  ld_check(received_stats_.size() == node_mapping.size());
   // get the NodeID to index mapping and the max period count
   for (unsigned int i = 0; i < received_stats_.size(); ++i) {
     for (unsigned int node_idx = 0;
          node_idx < received_stats_[i].node_ids.size();
          ++node_idx) {
       auto node = received_stats_[i].node_ids[node_idx];
-      node_mapping[i].emplace(node, node_idx);
-      all_nodes.emplace(node);
+      node_mapping[node].emplace_back(i, node_idx);
 
       max_period_count = std::max(
           max_period_count, received_stats_[i].summed_counts->shape()[1]);
@@ -170,24 +172,21 @@ void NodeStatsController::aggregateThroughCallback(AggregateStatsCallback cb) {
    * 7)
    * Give it to the outlier detector
    */
-  for (const auto& node : all_nodes) {
+  std::vector<BucketedNodeStats::ClientNodeStats> worst_clients;
+  for (const auto& node_entry : node_mapping) {
+    const NodeID node = node_entry.first;
     for (int period_idx = 0; period_idx < max_period_count; ++period_idx) {
-      std::vector<BucketedNodeStats::ClientNodeStats> worst_clients;
+      worst_clients.clear();
       BucketedNodeStats::SummedNodeStats sum;
-      for (unsigned int received_from_idx = 0;
-           received_from_idx < received_stats_.size();
-           ++received_from_idx) {
-        const auto& received = received_stats_[received_from_idx];
+      for (const auto& location : node_entry.second) {
+        const auto& received = received_stats_[location.first];
+        const auto node_idx = location.second;
         // shape()[1] = period count
         ld_check(received.summed_counts->shape()[1] ==
                  received.client_counts->shape()[1]);
 
-        ld_check(received_from_idx < node_mapping.size());
-        // make sure that the request contains information about the node and
-        // period
-        if (received.summed_counts->shape()[1] > period_idx &&
-            node_mapping[received_from_idx].count(node)) {
-          auto node_idx = node_mapping[received_from_idx].at(node);
+        // make sure that the request contains information about the period
+        if (received.summed_counts->shape()[1] > period_idx) {
           sum += (*received.summed_counts)[node_idx][period_idx];
 
           std::copy_if(
@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/sequencer_boycotting/PerClientNodeStatsAggregator.h"
 
+#include <algorithm>
+
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/sequencer_boycotting/BoycottingStats.h"
 
@@ -36,57 +38,50 @@ auto getTimeIntervals(int period_count,
 
 BucketedNodeStats
 PerClientNodeStatsAggregator::aggregate(unsigned int period_count) const {
-  auto per_client_node_stats = fromRawStats(period_count);
+  auto all = fromRawStats(period_count);
 
-  if (per_client_node_stats.empty()) {
+  if (all.node_ids.empty()) {
     return BucketedNodeStats{};
   }
 
-  const auto nodes = getNodes(per_client_node_stats);
-
-  const auto all_counts =
-      getAllCounts(per_client_node_stats, nodes, period_count);
+  const auto& all_counts = all.counts;
+  const size_t node_count = all_counts.shape()[0];
+  const size_t client_count = all_counts.shape()[2];
 
   BucketedNodeStats stats;
-  stats.node_ids.resize(nodes.size());
-  stats.summed_counts->resize(
-      boost::extents[all_counts.shape()[0]][period_count]);
+  stats.node_ids = std::move(all.node_ids);
+  stats.summed_counts->resize(boost::extents[node_count][period_count]);
 
   auto worst_clients_to_find = getWorstClientCount();
   if (worst_clients_to_find) {
     stats.client_counts->resize(
-        boost::extents[all_counts.shape()[0]][period_count]
-                      [worst_clients_to_find]);
+        boost::extents[node_count][period_count][worst_clients_to_find]);
   }
 
-  for (const auto& node : nodes) {
-    const auto node_idx = node.second;
-    ld_check(node_idx < stats.node_ids.size());
-    stats.node_ids[node_idx] = node.first;
+  // reused for every (node, bucket) row
+  std::vector<std::pair<double, unsigned int>> ratios;
+  std::vector<bool> is_worst(client_count, false);
 
-    for (unsigned int bucket_idx = 0;
-         bucket_idx < all_counts[node_idx].shape()[0];
+  for (unsigned int node_idx = 0; node_idx < node_count; ++node_idx) {
+    for (unsigned int bucket_idx = 0; bucket_idx < period_count;
          ++bucket_idx) {
-      auto worst_client_idxs = findWorstClients(
-          all_counts[node_idx][bucket_idx], worst_clients_to_find);
+      const auto row = all_counts[node_idx][bucket_idx];
+      if (worst_clients_to_find) {
+        findWorstClients(row, worst_clients_to_find, ratios, is_worst);
+      }
 
+      auto& summed_count = (*stats.summed_counts)[node_idx][bucket_idx];
       unsigned int client_count_idx = 0;
-      for (unsigned int client_idx = 0; client_idx < all_counts.shape()[2];
+      for (unsigned int client_idx = 0; client_idx < client_count;
            ++client_idx) {
-        if (!worst_client_idxs.count(client_idx)) {
-          auto& summed_count = (*stats.summed_counts)[node_idx][bucket_idx];
-          const auto& all_count = all_counts[node_idx][bucket_idx][client_idx];
-
-          // only increment if there were values reported
-          if (all_count.successes + all_count.fails > 0) {
-            ++summed_count.client_count;
-            summed_count.successes += all_count.successes;
-            summed_count.fails += all_count.fails;
-          }
-        } else {
+        const auto& count = row[client_idx];
+        if (is_worst[client_idx]) {
           (*stats.client_counts)[node_idx][bucket_idx][client_count_idx] =
-              all_counts[node_idx][bucket_idx][client_idx];
+              count;
           ++client_count_idx;
+        } else if (count.successes + count.fails > 0) {
+          // only count the client if there were values reported
+          summed_count += count;
         }
       }
     }
@@ -110,124 +105,89 @@ unsigned int PerClientNodeStatsAggregator::getWorstClientCount() const {
       .sequencer_boycotting.node_stats_send_worst_client_count;
 }
 
-PerClientNodeStatsAggregator::PerClientCounts
+PerClientNodeStatsAggregator::AllCounts
 PerClientNodeStatsAggregator::fromRawStats(unsigned int period_count) const {
   const auto now = std::chrono::steady_clock::now();
 
   const auto time_intervals =
       getTimeIntervals(period_count, getAggregationPeriod(), now);
 
-  std::vector<
-      std::pair<uint32_t,
-                std::vector<PerClientNodeTimeSeriesStats::ClientNodeValue>>>
-      period_stats;
+  struct Entry {
+    uint32_t node_idx;
+    uint32_t period_idx;
+    uint32_t client_idx;
+    BucketedNodeStats::ClientNodeStats stats;
+  };
+
+  // Assign dense indices to clients and nodes as they are seen, so that the
+  // matrix can be filled without building per-client maps first.
+  AllCounts all;
+  ClientMap<uint32_t> client_idxs;
+  NodeMap<uint32_t> node_idxs;
+  std::vector<Entry> entries;
 
   getStats()->runForEach([&](auto& pcn_stats) {
     pcn_stats.wlock()->updateCurrentTime(now);
     for (int period_index = 0; period_index < period_count; ++period_index) {
       const auto& interval = time_intervals[period_index];
       auto stats = pcn_stats.rlock()->sum(interval.first, interval.second);
-      period_stats.emplace_back(std::make_pair(period_index, std::move(stats)));
-    }
-  });
-
-  PerClientCounts per_client_node_stats;
-  for (const auto& period_stats_pair : period_stats) {
-    auto period_idx = period_stats_pair.first;
-    for (const auto& bucket : period_stats_pair.second) {
-      auto clients_it = per_client_node_stats.find(bucket.client_id);
-      auto& nodes_map = clients_it == per_client_node_stats.end()
-          ? per_client_node_stats
-                .emplace(std::make_pair(
-                    bucket.client_id, NodeMap<std::vector<PeriodStatsPair>>{}))
-                .first->second
-          : clients_it->second;
-      auto nodes_it = nodes_map.find(bucket.node_id);
-      auto& node_stats = nodes_it == nodes_map.end()
-          ? nodes_map
-                .emplace(std::make_pair(
-                    bucket.node_id, std::vector<PeriodStatsPair>{}))
-                .first->second
-          : nodes_it->second;
-      node_stats.emplace_back(
-          std::make_pair(period_idx,
-                         BucketedNodeStats::ClientNodeStats{
-                             bucket.value.successes, bucket.value.failures}));
-    }
-  }
-
-  return per_client_node_stats;
-}
-
-PerClientNodeStatsAggregator::NodeMap<uint32_t>
-PerClientNodeStatsAggregator::getNodes(const PerClientCounts& counts) const {
-  NodeMap<uint32_t> nodes;
-  uint32_t node_idx = 0;
-  for (const auto& client_entry : counts) {
-    for (const auto& node_entry : client_entry.second) {
-      if (!nodes.count(node_entry.first)) {
-        nodes.emplace(node_entry.first, node_idx++);
+      for (const auto& value : stats) {
+        const uint32_t client_idx =
+            client_idxs.try_emplace(value.client_id, client_idxs.size())
+                .first->second;
+        auto node_it = node_idxs.try_emplace(value.node_id, node_idxs.size());
+        if (node_it.second) {
+          all.node_ids.push_back(value.node_id);
+        }
+        entries.push_back(Entry{
+            node_it.first->second,
+            static_cast<uint32_t>(period_index),
+            client_idx,
+            BucketedNodeStats::ClientNodeStats{
+                value.value.successes, value.value.failures}});
       }
     }
-  }
-  return nodes;
-}
+  });
 
-boost::multi_array<BucketedNodeStats::ClientNodeStats, 3>
-PerClientNodeStatsAggregator::getAllCounts(const PerClientCounts& counts,
-                                           const NodeMap<uint32_t>& node_idxs,
-                                           uint32_t period_count) const {
-  boost::multi_array<BucketedNodeStats::ClientNodeStats, 3> all_counts(
-      boost::extents[node_idxs.size()][period_count][counts.size()]);
-
-  uint32_t client_idx = 0;
-  for (const auto& client_entry : counts) {
-    for (const auto& node_entry : client_entry.second) {
-      for (const auto& period_bucket : node_entry.second) {
-        all_counts[node_idxs.at(node_entry.first)][period_bucket.first]
-                  [client_idx] = period_bucket.second;
-      }
-    }
-    ++client_idx;
+  all.counts.resize(
+      boost::extents[all.node_ids.size()][period_count][client_idxs.size()]);
+  for (const Entry& entry : entries) {
+    // The same client may have been reported in more than one holder
+    auto& count =
+        all.counts[entry.node_idx][entry.period_idx][entry.client_idx];
+    count.successes += entry.stats.successes;
+    count.fails += entry.stats.fails;
   }
 
-  return all_counts;
+  return all;
 }
 
-std::unordered_set<unsigned int> PerClientNodeStatsAggregator::findWorstClients(
+void PerClientNodeStatsAggregator::findWorstClients(
     const boost::detail::multi_array::
         const_sub_array<BucketedNodeStats::ClientNodeStats, 1>& row,
-    unsigned int client_count) const {
-  struct RatioWithIdx {
-    unsigned int idx;
-    double ratio;
-  };
-
+    unsigned int client_count,
+    std::vector<std::pair<double, unsigned int>>& ratios,
+    std::vector<bool>& is_worst) {
   auto successRatio = [](double suc, double fail) -> double {
     return suc + fail != 0 ? suc / (suc + fail) : 1.0;
   };
 
-  std::vector<RatioWithIdx> to_sort;
-  to_sort.reserve(row.size());
+  ratios.clear();
   for (unsigned int i = 0; i < row.size(); ++i) {
-    to_sort.emplace_back(
-        RatioWithIdx{i, successRatio(row[i].successes, row[i].fails)});
+    ratios.emplace_back(successRatio(row[i].successes, row[i].fails), i);
   }
 
-  std::sort(to_sort.begin(), to_sort.end(), [](auto& lhs, auto& rhs) {
-    return lhs.ratio < rhs.ratio;
-  });
-
-  // only use the first client_count values
-  to_sort.resize(client_count);
-
-  std::unordered_set<unsigned int> client_idxs;
-
-  std::transform(to_sort.cbegin(),
-                 to_sort.cend(),
-                 std::inserter(client_idxs, client_idxs.begin()),
-                 [](auto& val) { return val.idx; });
+  // Only the client_count lowest ratios are needed, not a full sort. Ties are
+  // broken by client index.
+  const size_t worst_count = std::min<size_t>(client_count, ratios.size());
+  if (worst_count < ratios.size()) {
+    std::nth_element(
+        ratios.begin(), ratios.begin() + worst_count, ratios.end());
+  }
 
-  return client_idxs;
+  is_worst.assign(row.size(), false);
+  for (size_t i = 0; i < worst_count; ++i) {
+    is_worst[ratios[i].second] = true;
+  }
 }
 }} // namespace facebook::logdevice
@@ -9,7 +9,8 @@
 
 #include <chrono>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "logdevice/common/BucketedNodeStats.h"
 #include "logdevice/common/ClientID.h"
@@ -27,9 +28,18 @@ class PerClientNodeStatsAggregator {
   using ClientMap = std::unordered_map<ClientID, T, ClientID::Hash>;
   template <class T>
   using NodeMap = std::unordered_map<NodeID, T, NodeID::Hash>;
-  using PeriodStatsPair =
-      std::pair<uint32_t, BucketedNodeStats::ClientNodeStats>;
-  using PerClientCounts = ClientMap<NodeMap<std::vector<PeriodStatsPair>>>;
+
+  /**
+   * Stats reported about each node by each client, for each period, laid out
+   * in a dense matrix so that aggregating them is a linear scan over
+   * contiguous memory.
+   */
+  struct AllCounts {
+    // index in the first dimension of counts -> node the stats are about
+    std::vector<NodeID> node_ids;
+    // first dimension is node, second is period, third is client
+    boost::multi_array<BucketedNodeStats::ClientNodeStats, 3> counts;
+  };
 
  public:
   virtual ~PerClientNodeStatsAggregator() = default;
@@ -65,30 +75,18 @@ class PerClientNodeStatsAggregator {
    * @returns                 Stats reported about each node from each client,
    *                          for each requested period
    */
-  PerClientCounts fromRawStats(unsigned int period_count) const;
+  AllCounts fromRawStats(unsigned int period_count) const;
 
   /**
-   * @returns The client_count worst client indices for the given period
+   * Sets is_worst[i] to true for the client_count clients of row with the
+   * lowest success ratio, and to false for all others. ratios is scratch
+   * space, passed in to be reused across rows.
    */
-  std::unordered_set<unsigned int> findWorstClients(
+  static void findWorstClients(
       const boost::detail::multi_array::
           const_sub_array<BucketedNodeStats::ClientNodeStats, 1>& row,
-      unsigned int client_count) const;
-
-  /**
-   * @returns A map of all tracked nodes, mapped to their index in the matrix
-   */
-  NodeMap<unsigned int> getNodes(const PerClientCounts& counts) const;
-  /**
-   * Turn the nested maps into a matrix to make it easier to find the worst node
-   * per bucket and node
-   *
-   * @returns All values in counts in a 3-dimensional matrix where the first
-   * dimension is node, second is bucket, third is client
-   */
-  boost::multi_array<BucketedNodeStats::ClientNodeStats, 3>
-  getAllCounts(const PerClientCounts& counts,
-               const NodeMap<unsigned int>& node_idxs,
-               unsigned int period_count) const;
+      unsigned int client_count,
+      std::vector<std::pair<double, unsigned int>>& ratios,
+      std::vector<bool>& is_worst);
 };
 }} // namespace facebook::logdevice
@@ -27,6 +27,7 @@
 #include "logdevice/server/LogStoreMonitor.h"
 #include "logdevice/server/RebuildingCoordinator.h"
 #include "logdevice/server/RebuildingSupervisor.h"
+#include "logdevice/server/SequencerPreactivator.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/UnreleasedRecordDetector.h"
 #include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
@@ -140,6 +141,7 @@ void shutdown_server(
     std::unique_ptr<folly::EventBaseThread>& ssl_connection_listener_loop,
     std::unique_ptr<folly::EventBaseThread>& server_to_server_listener_loop,
     std::unique_ptr<LogStoreMonitor>& logstore_monitor,
+    std::unique_ptr<SequencerPreactivator>& sequencer_preactivator,
     std::shared_ptr<ServerProcessor>& processor,
     std::unique_ptr<ShardedStorageThreadPool>& storage_thread_pool,
     std::unique_ptr<ShardedRocksDBLocalLogStore>& sharded_store,
@@ -153,6 +155,17 @@ void shutdown_server(
     bool fast_shutdown) {
   auto t1 = steady_clock::now();
 
+  // Logs how long each phase of the shutdown took, to tell which one is slow
+  // when a node takes long to restart.
+  auto phase_start = t1;
+  auto end_phase = [&phase_start](const char* phase) {
+    auto now = steady_clock::now();
+    ld_info("Shutdown phase '%s' took %ld ms",
+            phase,
+            duration_cast<milliseconds>(now - phase_start).count());
+    phase_start = now;
+  };
+
   // Stop the Admin API Server
   if (admin_server) {
     ld_info("Stopping Admin API server");
@@ -162,6 +175,12 @@ void shutdown_server(
     ld_info("Admin API server stopped accepting requests");
   }
 
+  if (sequencer_preactivator) {
+    // records the logs with active sequencers before they fail over
+    ld_info("Stopping sequencer pre-activation thread");
+    sequencer_preactivator.reset();
+  }
+
   if (sequencer_placement && !fast_shutdown) {
     // request that any logs handled by this server are moved to a different
     // machine before shutting down workers
@@ -182,6 +201,7 @@ void shutdown_server(
     // stop rebuilding supervisor (destruction is below)
     rebuilding_supervisor->stop();
   }
+  end_phase("stop background threads");
 
   // stop accepting new connections
   ld_info("Destroying listeners");
@@ -214,6 +234,7 @@ void shutdown_server(
   ssl_connection_listener_loop.reset();
   server_to_server_listener.reset();
   server_to_server_listener_loop.reset();
+  end_phase("close listeners");
 
   auto health_monitor_closed = processor->getHealthMonitor() != nullptr
       ? processor->getHealthMonitor()->shutdown()
@@ -242,7 +263,15 @@ void shutdown_server(
              workers_except_fd - nworkers,
              workers_except_fd);
   }
-
+  end_phase("stop accepting work");
+
+  // Each shard drains its storage threads, persists its record caches and
+  // flushes its memtables independently of the others, on a thread of its
+  // own, while workers finish their work below. A shard's memtables are
+  // flushed as soon as its own storage threads are done, without waiting
+  // for the slowest shard.
+  Semaphore storage_threads_stopped;
+  std::vector<std::thread> flushing_threads;
   if (storage_thread_pool) {
     // dump last released LSNs from LogStorageStateMap to the local log store
     // (note that workers could still be processing some RELEASE messages so
@@ -258,26 +287,53 @@ void shutdown_server(
     bool persist_record_caches = false;
     auto local_settings = processor->settings();
     persist_record_caches = local_settings->enable_record_cache;
-    // Stop accepting new storage tasks and wait for the existing ones to
-    // finish. Also write record cache after all the storage tasks are done.
-    storage_thread_pool->shutdown(persist_record_caches);
+    // Stop accepting new storage tasks. Existing ones finish, then the last
+    // storage thread of each shard writes the shard's record caches.
+    for (shard_index_t idx = 0; idx < storage_thread_pool->numShards();
+         ++idx) {
+      storage_thread_pool->getByIndex(idx).shutDown(persist_record_caches);
+    }
+  }
+
+  const shard_size_t nshards = storage_thread_pool
+      ? storage_thread_pool->numShards()
+      : sharded_store ? sharded_store->numShards() : 0;
+  if (nshards > 0) {
+    ld_info("Spawning background threads to stop storage threads and flush "
+            "memtables");
+  }
+  for (shard_index_t idx = 0; idx < nshards; ++idx) {
+    flushing_threads.emplace_back([&, idx] {
+      auto start = steady_clock::now();
+      if (storage_thread_pool) {
+        storage_thread_pool->getByIndex(idx).join();
+        ld_info("Storage threads of shard %d stopped in %ld ms",
+                idx,
+                duration_cast<milliseconds>(steady_clock::now() - start)
+                    .count());
+        storage_threads_stopped.post();
+      }
+      if (sharded_store) {
+        auto flush_start = steady_clock::now();
+        sharded_store->getByIndex(idx)->markImmutable();
+        ld_info("Finished flushing memtables in shard %d in %ld ms",
+                idx,
+                duration_cast<milliseconds>(steady_clock::now() - flush_start)
+                    .count());
+      }
+    });
+  }
 
+  if (storage_thread_pool) {
+    for (shard_index_t idx = 0; idx < nshards; ++idx) {
+      storage_threads_stopped.wait();
+    }
     // storage threads have been shut down, record cache will not get any
     // new writes, clear all existing caches so that their entries can be
     // destroyed on Worker later.
     ld_info("Shutting down record caches");
     processor->getLogStorageStateMap().shutdownRecordCaches();
-  }
-
-  std::vector<std::thread> flushing_threads;
-  if (sharded_store) {
-    ld_info("Spawning background threads to flush memtables");
-    for (shard_index_t idx = 0; idx < sharded_store->numShards(); ++idx) {
-      flushing_threads.emplace_back([&sharded_store, idx] {
-        sharded_store->getByIndex(idx)->markImmutable();
-        ld_info("Finished flushing memtables in shard %d", idx);
-      });
-    }
+    end_phase("stop storage threads");
   }
 
   // after stateful requests finish, flush and close sockets
@@ -300,6 +356,7 @@ void shutdown_server(
   // waits for all workers except FAILURE_DETECTOR
   ld_info("Waiting for workers to stop");
   processor->waitForWorkers(nworkers);
+  end_phase("stop workers");
 
   // Shutdown FAILURE_DETECTOR worker
   ld_info("Finishing work and closing sockets on FAILURE_DETECTOR");
@@ -332,6 +389,7 @@ void shutdown_server(
   // take down all worker threads
   ld_info("Shutting down worker threads");
   processor->shutdown();
+  end_phase("stop failure detector and worker threads");
 
   if (admin_server) {
     // Note that deallocating AdminServer might be expensive if it's holding the
@@ -363,11 +421,13 @@ void shutdown_server(
     ld_info("Destroying sequencer placement");
     sequencer_placement.reset();
   }
-  if (sharded_store) {
+  end_phase("destroy components");
+  if (!flushing_threads.empty()) {
     ld_info("Waiting for memtable flushes");
     for (auto& t : flushing_threads) {
       t.join();
     }
+    end_phase("wait for memtable flushes");
   }
   if (sharded_store) {
     ld_info("Destroying local log store");
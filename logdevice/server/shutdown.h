@@ -29,6 +29,7 @@ class ServerProcessor;
 class ShardedStorageThreadPool;
 class ShardedRocksDBLocalLogStore;
 class SequencerPlacement;
+class SequencerPreactivator;
 class UnreleasedRecordDetector;
 class Worker;
 
@@ -66,6 +67,7 @@ void shutdown_server(
     std::unique_ptr<folly::EventBaseThread>& ssl_connection_listener_loop,
     std::unique_ptr<folly::EventBaseThread>& server_to_server_listener_loop,
     std::unique_ptr<LogStoreMonitor>& logstore_monitor,
+    std::unique_ptr<SequencerPreactivator>& sequencer_preactivator,
     std::shared_ptr<ServerProcessor>& processor,
     std::unique_ptr<ShardedStorageThreadPool>& storage_thread_pool,
     std::unique_ptr<ShardedRocksDBLocalLogStore>& sharded_store,
@@ -95,7 +95,8 @@ Status AllCachedDigests::startDigest(
     read_stream_id_t rid,
     ClientID client_id,
     lsn_t start_lsn,
-    std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot) {
+    std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
+    bool no_payload) {
   ClientDigests* client_digests = insertOrGet(client_id);
   ld_check(client_digests != nullptr);
 
@@ -106,6 +107,7 @@ Status AllCachedDigests::startDigest(
     CachedDigest* digest = result.first;
     ld_check(digest != nullptr);
     ld_check(!digest->started());
+    digest->setNoPayload(no_payload);
     queue_.push(std::make_pair(client_id, rid));
     scheduleMoreDigests();
     WORKER_STAT_INCR(record_cache_digest_created);
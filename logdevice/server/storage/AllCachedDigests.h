@@ -129,6 +129,7 @@ class AllCachedDigests {
    *
    *  @param epoch_cache         epoch record cache for the digesting epoch,
    *                             nullptr if the epoch is _empty_
+   *  @param no_payload          if true, ship digest records without payloads
    *
    *  @return  E::OK             This is a request for a new digest. The digest
    *                             request is being processed and will include
@@ -146,7 +147,8 @@ class AllCachedDigests {
               read_stream_id_t rid,
               ClientID client_id,
               lsn_t start_lsn,
-              std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot);
+              std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
+              bool no_payload = false);
 
   /**
    * Called when a CachedDigest instance is destroyed. @param active is true
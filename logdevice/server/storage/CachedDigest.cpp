@@ -314,12 +314,21 @@ CachedDigest::shipRecord(esn_t esn,
     header.flags |= RECORD_Header::INCLUDE_OFFSET_WITHIN_EPOCH;
   }
 
-  // TODO: Don't copy payload here, probably by using PayloadHolder in
-  //       Snapshot::Record, and wherever that Record comes from.
+  PayloadHolder payload_holder;
+  if (no_payload_) {
+    // Clear checksum flags if we don't ship payload
+    header.flags &= ~(RECORD_Header::CHECKSUM | RECORD_Header::CHECKSUM_64BIT);
+    header.flags |= RECORD_Header::CHECKSUM_PARITY;
+  } else {
+    // TODO: Don't copy payload here, probably by using PayloadHolder in
+    //       Snapshot::Record, and wherever that Record comes from.
+    payload_holder = PayloadHolder::copyPayload(payload_raw);
+  }
+
   auto msg =
       std::make_unique<RECORD_Message>(header,
                                        TrafficClass::RECOVERY,
-                                       PayloadHolder::copyPayload(payload_raw),
+                                       std::move(payload_holder),
                                        std::move(extra_metadata),
                                        RECORD_Message::Source::CACHED_DIGEST);
 
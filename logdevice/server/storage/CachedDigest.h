@@ -10,6 +10,7 @@
 #include "logdevice/common/BWAvailableCallback.h"
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/Sender.h"
+#include "logdevice/common/checks.h"
 #include "logdevice/common/protocol/GAP_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
@@ -98,6 +99,17 @@ class CachedDigest {
     return state_ > State::INIT;
   }
 
+  /**
+   * If set, digest records are shipped without payloads (the client asked
+   * for a digest with START_Header::NO_PAYLOAD). Timestamps, flags and extra
+   * metadata (copyset, wave, LNG) are still included. Must be called before
+   * start().
+   */
+  void setNoPayload(bool no_payload) {
+    ld_check(!started());
+    no_payload_ = no_payload;
+  }
+
   virtual ~CachedDigest();
 
  protected:
@@ -159,6 +171,9 @@ class CachedDigest {
   // esn of the last record delivered
   esn_t last_esn_delivered_{ESN_INVALID};
 
+  // see setNoPayload()
+  bool no_payload_{false};
+
   // Timers used to defer pushing records. The push timer will cause pushing to
   // resume on the next iteration of this thread's event loop. The delay timer
   // resumes pushing after exponential backoff and is activated when network TX
@@ -7,7 +7,9 @@
  */
 #include "logdevice/server/storage/PurgeSingleEpoch.h"
 
+#include <algorithm>
 #include <functional>
+#include <tuple>
 
 #include <folly/Memory.h>
 
@@ -286,8 +288,15 @@ std::unique_ptr<BackoffTimer> PurgeSingleEpoch::createRetryTimer() {
 }
 
 void PurgeSingleEpoch::startStorageTask(std::unique_ptr<StorageTask>&& task) {
-  ServerWorker::onThisThread()->getStorageTaskQueueForShard(shard_)->putTask(
-      std::move(task));
+  ServerWorker* worker = ServerWorker::onThisThread();
+  if (task->getType() == StorageTask::Type::PURGE_DELETE_RECORDS) {
+    worker->putPurgeDeleteRecordsTask(
+        std::unique_ptr<PurgeDeleteRecordsStorageTask>(
+            static_cast<PurgeDeleteRecordsStorageTask*>(task.release())),
+        shard_);
+    return;
+  }
+  worker->getStorageTaskQueueForShard(shard_)->putTask(std::move(task));
 }
 
 StatsHolder* PurgeSingleEpoch::getStats() {
@@ -329,7 +338,18 @@ PurgeDeleteRecordsStorageTask::PurgeDeleteRecordsStorageTask(
   ld_check(start_esn_ <= end_esn_);
 }
 
+void PurgeDeleteRecordsStorageTask::addToBatch(
+    std::unique_ptr<PurgeDeleteRecordsStorageTask> task) {
+  ld_check(task);
+  ld_check(task->batched_tasks_.empty());
+  batched_tasks_.push_back(std::move(task));
+}
+
 void PurgeDeleteRecordsStorageTask::execute() {
+  for (auto& task : batched_tasks_) {
+    task->setStorageThreadPool(storageThreadPool_);
+    task->setStorageThread(storageThread_);
+  }
   executeImpl(storageThreadPool_->getLocalLogStore(),
               stats_,
               storageThreadPool_->getProcessor().getTraceLogger().get());
@@ -338,11 +358,66 @@ void PurgeDeleteRecordsStorageTask::execute() {
 void PurgeDeleteRecordsStorageTask::executeImpl(LocalLogStore& store,
                                                 StatsHolder* stats,
                                                 TraceLogger* logger) {
-  ld_check(end_esn_ >= start_esn_);
-  STAT_INCR(stats, purging_delete_started);
+  std::vector<PurgeDeleteRecordsStorageTask*> tasks;
+  tasks.reserve(batchSize());
+  tasks.push_back(this);
+  for (auto& task : batched_tasks_) {
+    tasks.push_back(task.get());
+  }
+  // Group tasks of the same log so that they can share an iterator, and read
+  // each log in key order.
+  auto as_tuple = [](const PurgeDeleteRecordsStorageTask* t) {
+    return std::make_tuple(t->log_id_, t->epoch_, t->start_esn_);
+  };
+  std::stable_sort(tasks.begin(),
+                   tasks.end(),
+                   [&](const PurgeDeleteRecordsStorageTask* a,
+                       const PurgeDeleteRecordsStorageTask* b) {
+                     return as_tuple(a) < as_tuple(b);
+                   });
 
   std::vector<DeleteWriteOp> deletes;
-  std::vector<const WriteOp*> ops;
+  std::unique_ptr<LocalLogStore::ReadIterator> store_it;
+  std::vector<PurgeDeleteRecordsStorageTask*> to_write;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    PurgeDeleteRecordsStorageTask* task = tasks[i];
+    if (i > 0 && tasks[i - 1]->log_id_ != task->log_id_) {
+      store_it.reset();
+    }
+    STAT_INCR(stats, purging_delete_started);
+    const size_t prev_size = deletes.size();
+    if (!task->collectDeletes(store, stats, logger, store_it, deletes)) {
+      deletes.resize(prev_size);
+      task->status_ = E::FAILED;
+      continue;
+    }
+    to_write.push_back(task);
+  }
+
+  if (to_write.empty()) {
+    return;
+  }
+
+  std::vector<const WriteOp*> ops(deletes.size());
+  for (size_t i = 0; i < deletes.size(); ++i) {
+    ops[i] = &deletes[i];
+  }
+
+  int rv = store.writeMulti(ops);
+  for (PurgeDeleteRecordsStorageTask* task : to_write) {
+    task->status_ = (rv == 0 ? E::OK : E::FAILED);
+    STAT_INCR(stats, purging_delete_done);
+  }
+}
+
+bool PurgeDeleteRecordsStorageTask::collectDeletes(
+    LocalLogStore& store,
+    StatsHolder* stats,
+    TraceLogger* logger,
+    std::unique_ptr<LocalLogStore::ReadIterator>& store_it,
+    std::vector<DeleteWriteOp>& deletes) {
+  ld_check(end_esn_ >= start_esn_);
+
   if (end_esn_.val_ - start_esn_.val_ <= PURGE_DELETE_BY_KEY_THRESHOLD - 1) {
     // there are not so many records to delete, delete all possible keys to
     // avoid reading from the data key space, which may incur expensive
@@ -351,7 +426,7 @@ void PurgeDeleteRecordsStorageTask::executeImpl(LocalLogStore& store,
 
     // shouldn't overflow here
     const size_t num_keys = end_esn_.val_ - start_esn_.val_ + 1;
-    deletes.reserve(num_keys);
+    deletes.reserve(deletes.size() + num_keys);
 
     for (size_t i = 0; i < num_keys; ++i) {
       esn_t::raw_type esn = start_esn_.val_ + static_cast<esn_t::raw_type>(i);
@@ -369,77 +444,70 @@ void PurgeDeleteRecordsStorageTask::executeImpl(LocalLogStore& store,
     }
     PurgingTracer::traceRecordPurge(
         logger, log_id_, epoch_, ESN_INVALID, start_esn_, end_esn_, true);
+    return true;
+  }
 
-    ld_check(deletes.size() == num_keys);
-  } else {
-    // the range contains too many keys, read the data space to collect records
-    // that were actually stored in this range
-    STAT_INCR(stats, purging_v2_delete_by_reading_data);
+  // the range contains too many keys, read the data space to collect records
+  // that were actually stored in this range
+  STAT_INCR(stats, purging_v2_delete_by_reading_data);
 
+  if (store_it == nullptr) {
     LocalLogStore::ReadOptions read_options("PurgeDeleteRecords");
     read_options.allow_blocking_io = true;
     read_options.tailing = false;
-    std::unique_ptr<LocalLogStore::ReadIterator> store_it =
-        store.read(log_id_, read_options);
-
-    for (store_it->seek(compose_lsn(epoch_, start_esn_));
-         store_it->state() == IteratorState::AT_RECORD;
-         store_it->next()) {
-      lsn_t lsn = store_it->getLSN();
-      if (lsn_to_epoch(lsn) != epoch_) {
-        // No longer in epoch being purged, stop reading
-        break;
-      }
-
-      if (lsn_to_esn(lsn) > end_esn_) {
-        ld_error("Internal error: new records appeared during purging: "
-                 "log %lu, epoch %u, expected records up to ESN %u, got "
-                 "record %u.",
-                 log_id_.val_,
-                 epoch_.val_,
-                 end_esn_.val_,
-                 lsn_to_esn(lsn).val_);
-        break;
-      }
-
-      if (MetaDataLog::isMetaDataLog(log_id_)) {
-        ld_info("Deleting metadata log record; log: %lu lsn: %s "
-                "start esn: %u end esn: %u",
-                log_id_.val_,
-                lsn_to_string(lsn).c_str(),
-                start_esn_.val_,
-                end_esn_.val_);
-      }
-      PurgingTracer::traceRecordPurge(
-          logger, log_id_, epoch_, lsn_to_esn(lsn), start_esn_, end_esn_, true);
-
-      deletes.emplace_back(log_id_, lsn);
+    store_it = store.read(log_id_, read_options);
+  }
+
+  for (store_it->seek(compose_lsn(epoch_, start_esn_));
+       store_it->state() == IteratorState::AT_RECORD;
+       store_it->next()) {
+    lsn_t lsn = store_it->getLSN();
+    if (lsn_to_epoch(lsn) != epoch_) {
+      // No longer in epoch being purged, stop reading
+      break;
     }
 
-    switch (store_it->state()) {
-      case IteratorState::AT_RECORD:
-      case IteratorState::AT_END:
-        break;
-      case IteratorState::ERROR:
-        status_ = E::FAILED;
-        return;
-      case IteratorState::WOULDBLOCK:
-      case IteratorState::LIMIT_REACHED:
-      case IteratorState::MAX:
-        ld_check(false);
-        status_ = E::FAILED;
-        return;
+    if (lsn_to_esn(lsn) > end_esn_) {
+      ld_error("Internal error: new records appeared during purging: "
+               "log %lu, epoch %u, expected records up to ESN %u, got "
+               "record %u.",
+               log_id_.val_,
+               epoch_.val_,
+               end_esn_.val_,
+               lsn_to_esn(lsn).val_);
+      break;
     }
-  }
 
-  ops.resize(deletes.size());
-  for (int i = 0; i < deletes.size(); ++i) {
-    ops[i] = &deletes[i];
+    if (MetaDataLog::isMetaDataLog(log_id_)) {
+      ld_info("Deleting metadata log record; log: %lu lsn: %s "
+              "start esn: %u end esn: %u",
+              log_id_.val_,
+              lsn_to_string(lsn).c_str(),
+              start_esn_.val_,
+              end_esn_.val_);
+    }
+    PurgingTracer::traceRecordPurge(
+        logger, log_id_, epoch_, lsn_to_esn(lsn), start_esn_, end_esn_, true);
+
+    deletes.emplace_back(log_id_, lsn);
   }
 
-  int rv = store.writeMulti(ops);
-  status_ = (rv == 0 ? E::OK : E::FAILED);
-  STAT_INCR(stats, purging_delete_done);
+  switch (store_it->state()) {
+    case IteratorState::AT_RECORD:
+    case IteratorState::AT_END:
+      return true;
+    case IteratorState::ERROR:
+      // don't reuse a failed iterator for other tasks of the log
+      store_it.reset();
+      return false;
+    case IteratorState::WOULDBLOCK:
+    case IteratorState::LIMIT_REACHED:
+    case IteratorState::MAX:
+      break;
+  }
+  ld_check(false);
+  store_it.reset();
+  return false;
 }
 
 void PurgeDeleteRecordsStorageTask::onDone() {
@@ -447,6 +515,10 @@ void PurgeDeleteRecordsStorageTask::onDone() {
   if (driver != nullptr) {
     driver->onPurgeRecordsTaskDone(status_);
   }
+  for (auto& task : batched_tasks_) {
+    task->onDone();
+  }
+  batched_tasks_.clear();
 }
 
 void PurgeDeleteRecordsStorageTask::onDropped() {
@@ -455,6 +527,11 @@ void PurgeDeleteRecordsStorageTask::onDropped() {
     STAT_INCR(driver->getStats(), purging_task_dropped);
   }
   status_ = E::DROPPED;
+  // batched tasks were dropped too
+  for (auto& task : batched_tasks_) {
+    task->onDropped();
+  }
+  batched_tasks_.clear();
   onDone();
 }
 
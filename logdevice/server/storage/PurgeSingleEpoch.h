@@ -15,6 +15,8 @@
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
 #include "logdevice/common/WeakRefHolder.h"
 #include "logdevice/common/WorkerCallbackHelper.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
 #include "logdevice/server/storage/SealStorageTask.h"
 
 namespace facebook { namespace logdevice {
@@ -131,7 +133,25 @@ class PurgeDeleteRecordsStorageTask : public StorageTask {
                                 esn_t end_esn,
                                 WeakRef<PurgeSingleEpoch> driver);
 
+  /**
+   * Attaches another PurgeDeleteRecordsStorageTask for the same shard, of any
+   * log, to this one. Records of all tasks in the batch are deleted with a
+   * single LocalLogStore::writeMulti(), and tasks of the same log share the
+   * iterator used to find records to delete. onDone()/onDropped() of attached
+   * tasks are called together with this task's. Used by ServerWorker to batch
+   * purges of many logs, see Settings::purge_delete_tasks_batch_size.
+   */
+  void addToBatch(std::unique_ptr<PurgeDeleteRecordsStorageTask> task);
+
+  /**
+   * @return number of tasks executed by this task, including itself.
+   */
+  size_t batchSize() const {
+    return 1 + batched_tasks_.size();
+  }
+
   void execute() override;
+  // Executes this task and all batched tasks.
   void executeImpl(LocalLogStore& store,
                    StatsHolder* stats,
                    TraceLogger* logger);
@@ -141,6 +161,10 @@ class PurgeDeleteRecordsStorageTask : public StorageTask {
     return StorageTaskPriority::HIGH;
   }
 
+  Status getStatus() const {
+    return status_;
+  }
+
   Durability durability() const override {
     // do not require syncing the delete task immediately.
     // The reason is that local LCE is advanced after delete is completed, so
@@ -157,6 +181,19 @@ class PurgeDeleteRecordsStorageTask : public StorageTask {
   WeakRef<PurgeSingleEpoch> driver_;
   Status status_;
 
+  // see addToBatch()
+  std::vector<std::unique_ptr<PurgeDeleteRecordsStorageTask>> batched_tasks_;
+
+  // Appends deletes of all records in this task's range to `deletes`.
+  // `store_it` is an iterator over this task's log; it is created if null
+  // and needed.
+  // @return  false if reading the local log store failed
+  bool collectDeletes(LocalLogStore& store,
+                      StatsHolder* stats,
+                      TraceLogger* logger,
+                      std::unique_ptr<LocalLogStore::ReadIterator>& store_it,
+                      std::vector<DeleteWriteOp>& deletes);
+
   // if the ESN range contains less or equal number of records than this
   // threshold, delete key by key directly. Otherwise, create an iterator
   // to read actual records for deletion
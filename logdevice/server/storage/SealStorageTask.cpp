@@ -56,11 +56,38 @@ SealStorageTask::SealStorageTask(logid_t log_id,
   ld_check(!reply_to_.valid());
 }
 
+void SealStorageTask::addToBatch(std::unique_ptr<SealStorageTask> task) {
+  ld_check(task);
+  ld_check(context_ == Context::RECOVERY);
+  ld_check(task->context_ == Context::RECOVERY);
+  ld_check(task->batched_tasks_.empty());
+  batched_tasks_.push_back(std::move(task));
+}
+
 void SealStorageTask::execute() {
-  status_ =
-      executeImpl(storageThreadPool_->getLocalLogStore(),
-                  storageThreadPool_->getProcessor().getLogStorageStateMap(),
-                  storageThreadPool_->stats());
+  if (batched_tasks_.empty()) {
+    status_ =
+        executeImpl(storageThreadPool_->getLocalLogStore(),
+                    storageThreadPool_->getProcessor().getLogStorageStateMap(),
+                    storageThreadPool_->stats());
+    return;
+  }
+  for (auto& task : batched_tasks_) {
+    task->setStorageThreadPool(storageThreadPool_);
+    task->setStorageThread(storageThread_);
+  }
+  executeBatch(storageThreadPool_->getLocalLogStore(),
+               storageThreadPool_->getProcessor().getLogStorageStateMap(),
+               storageThreadPool_->stats());
+}
+
+StorageTask::Durability SealStorageTask::durability() const {
+  for (const auto& task : batched_tasks_) {
+    if (task->durability_ == Durability::SYNC_WRITE) {
+      return Durability::SYNC_WRITE;
+    }
+  }
+  return durability_;
 }
 
 shard_index_t SealStorageTask::getShardIdx() const {
@@ -71,6 +98,61 @@ shard_index_t SealStorageTask::getShardIdx() const {
 Status SealStorageTask::executeImpl(LocalLogStore& store,
                                     LogStorageStateMap& state_map,
                                     StatsHolder* stats) {
+  LogStorageState* log_state = nullptr;
+  Status status = E::OK;
+  if (!prepareSealWrite(store, state_map, stats, &log_state, &status)) {
+    return status;
+  }
+
+  SealMetadata seal_metadata{seal_};
+  LocalLogStore::WriteOptions write_options;
+  int rv = store.updateLogMetadata(log_id_, seal_metadata, write_options);
+  return finishSeal(
+      store, log_state, seal_metadata, rv == 0 ? E::OK : err, stats);
+}
+
+void SealStorageTask::executeBatch(LocalLogStore& store,
+                                   LogStorageStateMap& state_map,
+                                   StatsHolder* stats) {
+  std::vector<SealStorageTask*> tasks;
+  tasks.reserve(batchSize());
+  tasks.push_back(this);
+  for (auto& task : batched_tasks_) {
+    tasks.push_back(task.get());
+  }
+
+  std::vector<LogStorageState*> log_states(tasks.size(), nullptr);
+  // Not resized after this point, updates point into it.
+  std::vector<SealMetadata> seal_metadata(tasks.size());
+  std::vector<LocalLogStore::LogMetadataUpdate> updates;
+  std::vector<size_t> update_tasks;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    SealStorageTask* task = tasks[i];
+    if (!task->prepareSealWrite(
+            store, state_map, stats, &log_states[i], &task->status_)) {
+      continue;
+    }
+    seal_metadata[i] = SealMetadata{task->seal_};
+    updates.push_back(
+        LocalLogStore::LogMetadataUpdate{task->log_id_, &seal_metadata[i]});
+    update_tasks.push_back(i);
+  }
+
+  LocalLogStore::WriteOptions write_options;
+  store.updateLogMetadataMulti(updates, write_options);
+
+  for (size_t j = 0; j < updates.size(); ++j) {
+    const size_t i = update_tasks[j];
+    tasks[i]->status_ = tasks[i]->finishSeal(
+        store, log_states[i], seal_metadata[i], updates[j].status, stats);
+  }
+}
+
+bool SealStorageTask::prepareSealWrite(LocalLogStore& store,
+                                       LogStorageStateMap& state_map,
+                                       StatsHolder* stats,
+                                       LogStorageState** log_state_out,
+                                       Status* status) {
   // quickly check the current value of the seal to avoid reading LNGs if
   // E::PREEMPTED would be returned
 
@@ -81,12 +163,14 @@ Status SealStorageTask::executeImpl(LocalLogStore& store,
                     "Unable to update seal for log %lu: %s",
                     log_id_.val_,
                     error_description(err));
-    return E::FAILED;
+    *status = E::FAILED;
+    return false;
   }
 
   if (context_ == Context::PURGING) {
     // take a shortcut if we are in the purging context
-    return sealForPurging(store, log_state, stats);
+    *status = sealForPurging(store, log_state, stats);
+    return false;
   }
 
   folly::Optional<Seal> current_seal =
@@ -95,7 +179,8 @@ Status SealStorageTask::executeImpl(LocalLogStore& store,
   if (current_seal.has_value() && current_seal.value() > seal_) {
     // return the current value to the sequencer
     seal_ = current_seal.value();
-    return E::PREEMPTED;
+    *status = E::PREEMPTED;
+    return false;
   }
 
   // recover soft seal metadata before accessing the record cache, this could
@@ -103,15 +188,21 @@ Status SealStorageTask::executeImpl(LocalLogStore& store,
   // nonauthoritative epoch initialized.
   recoverSoftSeals(store, log_state);
 
-  Status status = E::OK;
-  SealMetadata seal_metadata{seal_};
+  *log_state_out = log_state;
+  return true;
+}
 
-  LocalLogStore::WriteOptions write_options;
-  int rv = store.updateLogMetadata(log_id_, seal_metadata, write_options);
-  if (rv != 0) {
+Status SealStorageTask::finishSeal(LocalLogStore& store,
+                                   LogStorageState* log_state,
+                                   SealMetadata& seal_metadata,
+                                   Status write_status,
+                                   StatsHolder* stats) {
+  ld_check(log_state != nullptr);
+  Status status = E::OK;
+  if (write_status != E::OK) {
     ld_check(durability_ == Durability::INVALID);
 
-    if (err != E::UPTODATE) {
+    if (write_status != E::UPTODATE) {
       return E::FAILED;
     }
 
@@ -143,11 +234,12 @@ Status SealStorageTask::executeImpl(LocalLogStore& store,
   // stored in the local log store.
   seal_ = seal_metadata.seal_;
 
-  rv = log_state->updateSeal(
+  int rv = log_state->updateSeal(
       seal_metadata.seal_, LogStorageState::SealType::NORMAL);
   if (rv != 0) {
     // update seal_ to the updated value
-    current_seal = log_state->getSeal(LogStorageState::SealType::NORMAL);
+    folly::Optional<Seal> current_seal =
+        log_state->getSeal(LogStorageState::SealType::NORMAL);
     ld_check(current_seal.has_value());
     seal_ = current_seal.value();
     status = E::PREEMPTED;
@@ -532,6 +624,10 @@ void SealStorageTask::onDone() {
                                     last_timestamp,
                                     max_seen_lsn,
                                     tail_records_);
+      for (auto& task : batched_tasks_) {
+        task->onDone();
+      }
+      batched_tasks_.clear();
     } break;
     case Context::PURGING: {
       PurgeUncleanEpochs* driver = purge_driver_.get();
@@ -551,6 +647,10 @@ void SealStorageTask::onDropped() {
                                     storageThreadPool_->getShardIdx(),
                                     seal_epoch_,
                                     E::FAILED);
+      for (auto& task : batched_tasks_) {
+        task->onDropped();
+      }
+      batched_tasks_.clear();
       break;
     case Context::PURGING: {
       PurgeUncleanEpochs* driver = purge_driver_.get();
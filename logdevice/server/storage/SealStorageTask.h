@@ -34,6 +34,7 @@ class LocalLogStore;
 class LogStorageStateMap;
 class LogStorageState;
 class PurgeUncleanEpochs;
+class SealMetadata;
 
 class SealStorageTask : public StorageTask {
  public:
@@ -87,9 +88,8 @@ class SealStorageTask : public StorageTask {
   // see StorageTask.h
   void execute() override;
 
-  Durability durability() const override {
-    return durability_;
-  }
+  // SYNC_WRITE if the seal of this task or of any batched task was written
+  Durability durability() const override;
 
   void onDone() override;
   void onDropped() override;
@@ -98,11 +98,39 @@ class SealStorageTask : public StorageTask {
     return StorageTaskPriority::HIGH;
   }
 
+  /**
+   * Attaches another SealStorageTask in recovery context for the same shard
+   * to this one. Seals of all tasks in the batch are written to the local log
+   * store with a single updateLogMetadataMulti() call, and their onDone()/
+   * onDropped() are called together with this task's. Used by ServerWorker
+   * to batch seals coming from many log recoveries at once, see
+   * Settings::seal_storage_tasks_batch_size.
+   */
+  void addToBatch(std::unique_ptr<SealStorageTask> task);
+
+  /**
+   * @return number of tasks executed by this task, including itself.
+   */
+  size_t batchSize() const {
+    return 1 + batched_tasks_.size();
+  }
+
   // Public for tests
   Status executeImpl(LocalLogStore& store,
                      LogStorageStateMap& state_map,
                      StatsHolder* stats = nullptr);
 
+  // Executes this task and all batched tasks, setting their status_. Public
+  // for tests.
+  void executeBatch(LocalLogStore& store,
+                    LogStorageStateMap& state_map,
+                    StatsHolder* stats = nullptr);
+
+  // expose status_ of a task executed with executeBatch(). used for testing
+  Status getStatus() const {
+    return status_;
+  }
+
   // expose seal_. used for testing
   Seal getSeal() const {
     return seal_;
@@ -145,6 +173,28 @@ class SealStorageTask : public StorageTask {
 
   EpochInfoSource epoch_info_source_{EpochInfoSource::INVALID};
 
+  // see addToBatch()
+  std::vector<std::unique_ptr<SealStorageTask>> batched_tasks_;
+
+  // First step of executeImpl(): gets the log state, checks the seal
+  // currently in the state map for preemption and recovers soft seals.
+  // @return  true if the seal needs to be written to the local log store;
+  //          false if the task is already finished with *status
+  bool prepareSealWrite(LocalLogStore& store,
+                        LogStorageStateMap& state_map,
+                        StatsHolder* stats,
+                        LogStorageState** log_state,
+                        Status* status);
+
+  // Last step of executeImpl(), after `seal_metadata` was written to the
+  // local log store with result `write_status` (E::OK, E::UPTODATE or
+  // an error).
+  Status finishSeal(LocalLogStore& store,
+                    LogStorageState* log_state,
+                    SealMetadata& seal_metadata,
+                    Status write_status,
+                    StatsHolder* stats);
+
   // helper method that checks soft seals for preemption, may read metadata
   // from local logstore. updates seal_ if soft seal has a higher Seal record
   // for preemption
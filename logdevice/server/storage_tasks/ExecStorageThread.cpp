@@ -23,6 +23,7 @@
 namespace facebook { namespace logdevice {
 
 void ExecStorageThread::run() {
+  pool_->onThreadStarted();
   pool_->getLocalLogStore().onStorageThreadStarted();
 
   auto settings = pool_->getSettings().get();
@@ -35,8 +36,16 @@ void ExecStorageThread::run() {
 
   SlowStorageTasksTracer slow_task_tracer{pool_->getTraceLogger()};
 
+  busy_poller_.setStats(pool_->stats());
+
   while (shouldProcessTasks_) {
-    std::unique_ptr<StorageTask> task = pool_->blockingGetTask(thread_type_);
+    {
+      auto current_settings = pool_->getSettings().get();
+      busy_poller_.configure(current_settings->busy_poll_max_spin,
+                             current_settings->busy_poll_cpu_budget);
+    }
+    std::unique_ptr<StorageTask> task =
+        pool_->blockingGetTask(thread_type_, &busy_poller_);
     task->setStorageThread(this);
 
     // Maintain stats for queueing latency.
@@ -55,8 +64,10 @@ void ExecStorageThread::run() {
     }
 
     auto execution_start_time = std::chrono::steady_clock::now();
+    task->execution_start_time_ = execution_start_time;
     task->execute();
     auto execution_end_time = std::chrono::steady_clock::now();
+    task->execution_end_time_ = execution_end_time;
     auto usec = SystemTimestamp(execution_end_time - execution_start_time)
                     .toMicroseconds()
                     .count();
@@ -78,6 +89,30 @@ void ExecStorageThread::run() {
             task->reply_shard_idx_,
             usec);
       }
+      const auto priority = task->getPriority();
+      if (priority < StorageTaskPriority::NUM_PRIORITIES) {
+        const int idx = static_cast<int>(priority);
+        PER_SHARD_HISTOGRAM_ADD(pool_->stats(),
+                                storage_task_queue_time_by_priority[idx],
+                                task->reply_shard_idx_,
+                                queueing_usec);
+        PER_SHARD_HISTOGRAM_ADD(pool_->stats(),
+                                storage_task_execution_time_by_priority[idx],
+                                task->reply_shard_idx_,
+                                usec);
+      }
+      const auto principal = task->getPrincipal();
+      if (principal < StorageTaskPrincipal::NUM_PRINCIPALS) {
+        const int idx = static_cast<int>(principal);
+        PER_SHARD_HISTOGRAM_ADD(pool_->stats(),
+                                storage_task_queue_time_by_principal[idx],
+                                task->reply_shard_idx_,
+                                queueing_usec);
+        PER_SHARD_HISTOGRAM_ADD(pool_->stats(),
+                                storage_task_execution_time_by_principal[idx],
+                                task->reply_shard_idx_,
+                                usec);
+      }
     }
 
     slow_task_tracer.traceStorageTask(
@@ -100,6 +135,15 @@ void ExecStorageThread::run() {
        task->bytesProcessed(0);
     */
 
+    if (task->hasCpuStage()) {
+      if (pool_->tryOffloadCpuStage(task)) {
+        // A storage thread of another shard will run the CPU stage and pass
+        // the task back to the worker.
+        continue;
+      }
+      task->executeCpuStage();
+    }
+
     if (task->durability() == Durability::SYNC_WRITE) {
       pool_->enqueueForSync(std::move(task));
     } else {
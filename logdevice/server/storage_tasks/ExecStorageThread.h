@@ -9,6 +9,7 @@
 
 #include <memory>
 
+#include "logdevice/common/BusyPoller.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
 #include "logdevice/server/storage_tasks/StorageThread.h"
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
@@ -60,5 +61,8 @@ class ExecStorageThread : public StorageThread {
   int idx_;
 
   bool shouldProcessTasks_ = true;
+
+  // Spins on the task queue before blocking, see --busy-poll-max-spin
+  BusyPoller busy_poller_;
 };
 }} // namespace facebook::logdevice
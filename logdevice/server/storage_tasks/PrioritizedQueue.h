@@ -17,6 +17,7 @@
 #include <folly/MPMCQueue.h>
 #include <folly/SharedMutex.h>
 #include <folly/small_vector.h>
+#include <logdevice/common/BusyPoller.h>
 #include <logdevice/common/Semaphore.h>
 #include <logdevice/common/debug.h>
 #include <logdevice/common/stats/Stats.h>
@@ -63,6 +64,15 @@ class PrioritizedQueue {
     readQueueGuaranteedNonEmpty(out);
   }
 
+  // Same as blockingRead(), but first busy-polls with `poller` (if not null)
+  // before blocking.
+  void blockingRead(T& out, BusyPoller* poller) {
+    if (!poller || !poller->spin([this] { return sem_.try_wait(); })) {
+      sem_.wait();
+    }
+    readQueueGuaranteedNonEmpty(out);
+  }
+
   bool read(T& out) {
     if (!sem_.try_wait()) {
       return false;
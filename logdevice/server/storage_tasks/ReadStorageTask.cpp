@@ -88,6 +88,7 @@ ReadStorageTask::ReadStorageTask(
   stream_shard_ = stream_ptr->shard_;
   stream_scd_enabled_ = stream_ptr->scdEnabled();
   stream_known_down_ = stream_ptr->getKnownDown();
+  in_digest_lane_ = stream_ptr->in_digest_lane_;
 
   // catchup_queue may be nullptr in tests.
 
@@ -113,7 +114,22 @@ void ReadStorageTask::setMemoryToken(ResourceBudget::Token memory_token) {
   memory_token_ = std::move(memory_token);
 }
 
+void ReadStorageTask::addToBatch(std::unique_ptr<ReadStorageTask> task) {
+  ld_check(task);
+  ld_check(task->batched_tasks_.empty());
+  batched_tasks_.push_back(std::move(task));
+}
+
 void ReadStorageTask::execute() {
+  executeOne();
+  for (auto& task : batched_tasks_) {
+    task->setStorageThreadPool(storageThreadPool_);
+    task->setStorageThread(storageThread_);
+    task->executeOne();
+  }
+}
+
+void ReadStorageTask::executeOne() {
   ld_check(options_.allow_blocking_io);
   ld_check(total_bytes_ == 0);
 
@@ -184,11 +200,19 @@ void ReadStorageTask::execute() {
 void ReadStorageTask::onDone() {
   ServerWorker::onThisThread()->serverReadStreams().onReadTaskDone(*this);
   WORKER_STAT_DECR(num_in_flight_read_storage_tasks);
+  for (auto& task : batched_tasks_) {
+    task->onDone();
+  }
+  batched_tasks_.clear();
 }
 
 void ReadStorageTask::onDropped() {
   ld_check(total_bytes_ == 0);
   ServerWorker::onThisThread()->serverReadStreams().onReadTaskDropped(*this);
+  for (auto& task : batched_tasks_) {
+    task->onDropped();
+  }
+  batched_tasks_.clear();
 }
 
 void ReadStorageTask::releaseRecords() {
@@ -211,6 +235,10 @@ void ReadStorageTask::getDebugInfoDetailed(StorageTaskDebugInfo& info) const {
   info.client_id = client_id_;
   info.client_address = client_address_;
   info.extra_info = read_ctx_.toString() +
+      (batched_tasks_.empty()
+           ? std::string()
+           : folly::sformat(", batched with {} other tasks",
+                            batched_tasks_.size())) +
       folly::sformat(", Read stream ID: {}, stream start lsn: {}, stream "
                      "version at task creation: {}, stream filter version at "
                      "task creation: {}, stream creation time: {}, SCD: {}, "
@@ -86,6 +86,22 @@ class ReadStorageTask : public StorageTask {
 
   void releaseRecords();
 
+  /**
+   * Attaches another ReadStorageTask for the same shard to this one. Attached
+   * tasks are executed on the same storage thread right after this task, in
+   * the order they were added, and their onDone()/onDropped() are called
+   * together with this task's. Used by AllServerReadStreams to batch read
+   * tasks, see Settings::read_storage_tasks_batch_size.
+   */
+  void addToBatch(std::unique_ptr<ReadStorageTask> task);
+
+  /**
+   * @return number of tasks executed by this task, including itself.
+   */
+  size_t batchSize() const {
+    return 1 + batched_tasks_.size();
+  }
+
   ThreadType getThreadType() const override {
     // Read tasks may take a while to execute, so they shouldn't block fast
     // write operations.
@@ -121,7 +137,9 @@ class ReadStorageTask : public StorageTask {
   //
   typedef std::vector<RawRecord> RecordContainer;
   Status status_{E::UNKNOWN};
-  RecordContainer records_;
+  // Mutable because CatchupOneStream takes ownership of the blobs when
+  // shipping them, to avoid copying payloads into RECORD messages.
+  mutable RecordContainer records_;
   // Total amount of record bytes that were allocated by this storage task.
   // Used for stats.
   size_t total_bytes_{0};
@@ -130,6 +148,10 @@ class ReadStorageTask : public StorageTask {
   StorageTaskPriority priority_;
   Principal principal_;
 
+  // True if this task was issued in one of CatchupQueue's digest slots, see
+  // ServerReadStream::in_digest_lane_.
+  bool in_digest_lane_{false};
+
   size_t getThrottlingEstimate() const {
     return throttling_estimate_;
   }
@@ -141,6 +163,12 @@ class ReadStorageTask : public StorageTask {
  private:
   void getDebugInfoDetailed(StorageTaskDebugInfo&) const override;
 
+  // Does the actual reading for this task, not including batched_tasks_.
+  void executeOne();
+
+  // Tasks attached with addToBatch().
+  std::vector<std::unique_ptr<ReadStorageTask>> batched_tasks_;
+
   // The following fields store some information about the read stream for debug
   // output
   read_stream_id_t stream_id_;
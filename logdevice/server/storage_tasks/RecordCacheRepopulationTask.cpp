@@ -7,7 +7,16 @@
  */
 #include "logdevice/server/storage_tasks/RecordCacheRepopulationTask.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/ThreadID.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
@@ -21,6 +30,9 @@
 
 namespace facebook { namespace logdevice {
 
+// Deserialize snapshot blobs in chunks of about 64MiB
+static const size_t REPOPULATION_CHUNK_SIZE_LIMIT = 64 * 1024 * 1024;
+
 void RecordCacheRepopulationTask::execute() {
   LocalLogStore& shard = storageThreadPool_->getLocalLogStore();
   // the store should not be disabled since we checked before creating the task,
@@ -50,41 +62,97 @@ void RecordCacheRepopulationTask::execute() {
 
   ld_check(sharded_store->numShards() > 0);
 
+  auto start_time = std::chrono::steady_clock::now();
+
   size_t repopulated_caches = 0;
   size_t repopulated_bytes = 0;
   const size_t bytes_limit_per_shard =
       storageThreadPool_->getProcessor().settings()->record_cache_max_size /
       sharded_store->numShards();
 
+  const size_t num_threads = storageThreadPool_->getProcessor()
+                                 .settings()
+                                 ->record_cache_repopulation_threads;
+  ld_check(num_threads > 0);
+
+  // Blobs read from the local log store but not yet deserialized. Reading is
+  // sequential; deserializing the blobs and inserting them into the record
+  // cache is split across `num_threads` threads, a chunk of blobs at a time
+  // so that memory used for the copies stays bounded.
+  std::vector<std::pair<logid_t, std::string>> chunk;
+  size_t bytes_in_chunk = 0;
+  bool repopulation_failed = false;
+
+  auto repopulate_chunk = [&]() {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> caches{0};
+    std::atomic<size_t> bytes{0};
+    std::atomic<bool> failed{false};
+    auto work = [&]() {
+      for (size_t i = next++; i < chunk.size(); i = next++) {
+        const auto& blob = chunk[i];
+        int rv = log_storage_state_map.repopulateRecordCacheFromLinearBuffer(
+            blob.first, shard_idx_, blob.second.data(), blob.second.size());
+        if (rv == 0) {
+          ++caches;
+          bytes += blob.second.size();
+        } else {
+          failed = true;
+        }
+      }
+    };
+
+    // The storage thread running this task does its share of the work, too.
+    const size_t parallelism = std::min(num_threads, chunk.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < parallelism; ++i) {
+      threads.emplace_back([&] {
+        ThreadID::set(ThreadID::Type::UTILITY, "ld:rc-repop");
+        work();
+      });
+    }
+    work();
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    repopulated_caches += caches.load();
+    repopulated_bytes += bytes.load();
+    repopulation_failed |= failed.load();
+    chunk.clear();
+    bytes_in_chunk = 0;
+  };
+
   LocalLogStore::LogSnapshotBlobCallback repopulate = [&](logid_t log_id,
                                                           Slice data) {
     if (bytes_limit_per_shard > 0 &&
-        repopulated_bytes + data.size > bytes_limit_per_shard) {
+        repopulated_bytes + bytes_in_chunk + data.size >
+            bytes_limit_per_shard) {
       ld_error("Repopulating saved snapshot of record cache on shard %d "
                "reached the byte limit of %lu bytes per-shard. Already "
                "populated %lu bytes. Stop populating record caches on "
                "this shard.",
                shard_idx_,
                bytes_limit_per_shard,
-               repopulated_bytes);
+               repopulated_bytes + bytes_in_chunk);
       return -1;
     }
 
-    int rv = log_storage_state_map.repopulateRecordCacheFromLinearBuffer(
+    chunk.emplace_back(
         log_id,
-        shard_idx_,
-        reinterpret_cast<const char*>(data.data),
-        data.size);
-    if (rv == 0) {
-      repopulated_caches++;
-      repopulated_bytes += data.size;
+        std::string(reinterpret_cast<const char*>(data.data), data.size));
+    bytes_in_chunk += data.size;
+    if (bytes_in_chunk >= REPOPULATION_CHUNK_SIZE_LIMIT) {
+      repopulate_chunk();
     }
-    return rv;
+    return repopulation_failed ? -1 : 0;
   };
 
   int rv = shard.readAllLogSnapshotBlobs(
       LocalLogStore::LogSnapshotBlobType::RECORD_CACHE, repopulate);
-  if (rv == 0) {
+  // Blobs read before an error are still good to use.
+  repopulate_chunk();
+  if (rv == 0 && !repopulation_failed) {
     status_ = E::OK;
   } else {
     ld_error("Failed to read all snapshots on shard %d. Repopulated caches "
@@ -97,10 +165,13 @@ void RecordCacheRepopulationTask::execute() {
   }
 
   ld_info("Repopulated record caches for %ju logs on shard %d, totaling %ju "
-          "bytes.",
+          "bytes, in %.3fs.",
           repopulated_caches,
           shard_idx_,
-          repopulated_bytes);
+          repopulated_bytes,
+          std::chrono::duration_cast<std::chrono::duration<double>>(
+              std::chrono::steady_clock::now() - start_time)
+              .count());
   STAT_ADD(stats_, record_cache_repopulated_bytes, repopulated_bytes);
 
   // also bump the record_cache_bytes_cached_estimate stats for accurately
@@ -18,11 +18,15 @@ ShardedStorageThreadPool::ShardedStorageThreadPool(
     UpdateableSettings<Settings> settings,
     size_t task_queue_size,
     StatsHolder* stats,
-    const std::shared_ptr<TraceLogger> trace_logger)
+    const std::shared_ptr<TraceLogger> trace_logger,
+    const std::vector<int>& shard_numa_nodes)
     : sharded_log_store_(store) {
   shard_size_t nshards = store->numShards();
   pools_.reserve(nshards);
   for (shard_index_t shard_idx = 0; shard_idx < nshards; ++shard_idx) {
+    int numa_node = (size_t)shard_idx < shard_numa_nodes.size()
+        ? shard_numa_nodes[shard_idx]
+        : -1;
     pools_.push_back(
         // may throw
         std::make_unique<StorageThreadPool>(shard_idx,
@@ -33,7 +37,17 @@ ShardedStorageThreadPool::ShardedStorageThreadPool(
                                             store->getByIndex(shard_idx),
                                             task_queue_size,
                                             stats,
-                                            trace_logger));
+                                            trace_logger,
+                                            numa_node));
+  }
+  for (auto& pool : pools_) {
+    std::vector<StorageThreadPool*> peers;
+    for (auto& peer : pools_) {
+      if (peer != pool) {
+        peers.push_back(peer.get());
+      }
+    }
+    pool->setPeers(std::move(peers));
   }
 }
 }} // namespace facebook::logdevice
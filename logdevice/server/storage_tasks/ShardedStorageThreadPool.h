@@ -33,6 +33,10 @@ class ShardedStorageThreadPool {
    * StorageThreadPools contain raw pointers to individual LocalLogStore
    * instances.
    *
+   * @param shard_numa_nodes  if not empty, NUMA node to pin each shard's
+   *                          storage threads to, -1 to leave them unpinned.
+   *                          See StorageThreadPool.
+   *
    * @throws ConstructorFailed on failure
    */
   ShardedStorageThreadPool(
@@ -42,7 +46,8 @@ class ShardedStorageThreadPool {
       UpdateableSettings<Settings> settings,
       size_t task_queue_size,
       StatsHolder* stats,
-      const std::shared_ptr<TraceLogger> trace_logger = nullptr);
+      const std::shared_ptr<TraceLogger> trace_logger = nullptr,
+      const std::vector<int>& shard_numa_nodes = {});
 
   void setProcessor(ServerProcessor* processor) {
     for (auto& pool : pools_) {
@@ -108,6 +108,19 @@ class StorageTask {
    */
   virtual void onSynced() {}
 
+  /**
+   * Tasks with CPU-only work to do after execute() can return true here and
+   * do that work in executeCpuStage(). The CPU stage must not touch the
+   * local log store. It runs after execute() and before the task is passed
+   * back to the worker, either on the same storage thread or, if
+   * storage-tasks-steal-cpu-stages is enabled, on an idle storage thread of
+   * another shard. Not supported for tasks with SYNC_WRITE durability.
+   */
+  virtual bool hasCpuStage() const {
+    return false;
+  }
+  virtual void executeCpuStage() {}
+
   /**
    * Called on a worker thread after execute() has finished running on a
    * storage thread.
@@ -218,7 +231,7 @@ class StorageTask {
    * It is set by PerWorkerStorageTaskQueue::putTask() when issuing the task to
    * storage threads.
    */
-  folly::Executor* reply_executor_;
+  folly::Executor* reply_executor_ = nullptr;
 
   /**
    * Index of database shard that this task is going to.  Set by
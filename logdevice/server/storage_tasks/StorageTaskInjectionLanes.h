@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/ProducerConsumerQueue.h>
+
+#include "logdevice/common/Semaphore.h"
+#include "logdevice/common/checks.h"
+
+/**
+ * @file  Lock-free injection path in front of a consumer-side scheduler
+ *        (DRRScheduler in StorageThreadPool).
+ *
+ *        Every producer thread (normally a worker) claims its own SPSC lane,
+ *        so posting an item is a wait-free ring buffer write plus a semaphore
+ *        post, and producers never contend with each other or with the
+ *        consumers on the scheduler mutex. Consumers wait on the semaphore and
+ *        then move whatever the lanes contain into the scheduler, which picks
+ *        the next item to run as before.
+ *
+ *        Producers that could not claim a lane (or whose lane is full) must
+ *        put items directly into the scheduler and call notify() instead.
+ */
+
+namespace facebook { namespace logdevice {
+
+template <class T>
+class StorageTaskInjectionLanes {
+ public:
+  // Per-thread state a producer keeps to remember its lane.
+  struct LaneId {
+    // -1 if no lane is available for this thread.
+    int lane{-1};
+    bool claimed{false};
+  };
+
+  StorageTaskInjectionLanes(size_t nlanes, size_t lane_capacity) {
+    ld_check(lane_capacity > 0);
+    lanes_.reserve(nlanes);
+    for (size_t i = 0; i < nlanes; ++i) {
+      // ProducerConsumerQueue keeps one slot empty.
+      lanes_.push_back(
+          std::make_unique<folly::ProducerConsumerQueue<T>>(lane_capacity + 1));
+    }
+  }
+
+  /**
+   * Returns the lane of the calling producer, claiming a new one on first
+   * use. Returns -1 if all lanes are already taken by other threads.
+   */
+  int getLane(LaneId& id) {
+    if (!id.claimed) {
+      const size_t lane = next_lane_.fetch_add(1);
+      id.lane = lane < lanes_.size() ? static_cast<int>(lane) : -1;
+      id.claimed = true;
+    }
+    return id.lane;
+  }
+
+  /**
+   * Producer side. Must only be called by the thread owning `lane`.
+   *
+   * @return true if the item was appended to the lane and a consumer was
+   *         notified, false if the lane is full.
+   */
+  bool tryWrite(int lane, T item) {
+    ld_check(lane >= 0 && lane < (int)lanes_.size());
+    if (!lanes_[lane]->write(item)) {
+      return false;
+    }
+    sem_.post();
+    return true;
+  }
+
+  /**
+   * Wakes up one consumer for an item that was put directly into the
+   * scheduler, bypassing the lanes.
+   */
+  void notify() {
+    sem_.post();
+  }
+
+  /**
+   * Consumer side. Blocks until an item is available, either in one of the
+   * lanes or in the scheduler.
+   */
+  void wait() {
+    sem_.wait();
+  }
+
+  /**
+   * Consumer side. Moves the contents of all lanes into the scheduler by
+   * calling `fn` on each item. Lanes are single-consumer, so only one thread
+   * drains at a time; others return immediately and pick up the items from
+   * the scheduler once the draining thread is done.
+   *
+   * @return number of items moved.
+   */
+  template <typename F>
+  size_t drain(F&& fn) {
+    std::unique_lock<std::mutex> lock(drain_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return 0;
+    }
+    size_t moved = 0;
+    for (auto& lane : lanes_) {
+      T item;
+      while (lane->read(item)) {
+        fn(item);
+        ++moved;
+      }
+    }
+    return moved;
+  }
+
+  /**
+   * Approximate number of items sitting in the lanes.
+   */
+  size_t sizeGuess() const {
+    size_t res = 0;
+    for (auto& lane : lanes_) {
+      res += lane->sizeGuess();
+    }
+    return res;
+  }
+
+ private:
+  std::vector<std::unique_ptr<folly::ProducerConsumerQueue<T>>> lanes_;
+
+  // Index of the next lane to hand out in getLane().
+  std::atomic<size_t> next_lane_{0};
+
+  // Posted once for every item injected, through a lane or directly into the
+  // scheduler.
+  Semaphore sem_;
+
+  // Serializes consumers in drain().
+  std::mutex drain_mutex_;
+};
+
+}} // namespace facebook::logdevice
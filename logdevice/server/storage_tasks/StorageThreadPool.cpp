@@ -7,9 +7,12 @@
  */
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
 
+#include <thread>
+
 #include <folly/Memory.h>
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/CPUAffinity.h"
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/debug.h"
@@ -61,6 +64,46 @@ class StopExecStorageTask : public StorageTask {
   std::shared_ptr<std::atomic<int>> remaining_threads_;
   bool persist_record_caches_;
 };
+
+/**
+ * Carries a task whose execute() has run on its own shard over to an idle
+ * storage thread of another shard, which runs the task's CPU stage and then
+ * sends the task back to its worker.
+ */
+class CpuStageStorageTask : public StorageTask {
+ public:
+  explicit CpuStageStorageTask(std::unique_ptr<StorageTask> task)
+      : StorageTask(StorageTask::Type::CPU_STAGE), task_(std::move(task)) {}
+  void execute() override {
+    task_->setStorageThread(storageThread_);
+    task_->executeCpuStage();
+    StorageTaskResponse::sendBackToWorker(std::move(task_));
+  }
+  void onDone() override {}
+  void onDropped() override {
+    ld_check(false);
+  }
+  ThreadType getThreadType() const override {
+    return task_->getThreadType();
+  }
+  StorageTaskPriority getPriority() const override {
+    return task_->getPriority();
+  }
+  Principal getPrincipal() const override {
+    return task_->getPrincipal();
+  }
+  bool isDroppable() const override {
+    // The I/O stage has already been done, dropping would waste it.
+    return false;
+  }
+
+  std::unique_ptr<StorageTask> releaseTask() {
+    return std::move(task_);
+  }
+
+ private:
+  std::unique_ptr<StorageTask> task_;
+};
 } // namespace
 
 StorageThreadPool::StorageThreadPool(
@@ -72,7 +115,8 @@ StorageThreadPool::StorageThreadPool(
     LocalLogStore* local_log_store,
     size_t task_queue_size,
     StatsHolder* stats,
-    const std::shared_ptr<TraceLogger> trace_logger)
+    const std::shared_ptr<TraceLogger> trace_logger,
+    int numa_node)
     : server_settings_(server_settings),
       settings_(settings),
       nthreads_slow_(params[(size_t)ThreadType::SLOW].nthreads),
@@ -82,6 +126,9 @@ StorageThreadPool::StorageThreadPool(
           params[(size_t)ThreadType::FAST_TIME_SENSITIVE].nthreads),
       nthreads_default_(params[(size_t)ThreadType::DEFAULT].nthreads),
       useDRR_(settings->storage_tasks_use_drr),
+      numa_node_(numa_node),
+      pinned_cpus_(numa_node >= 0 ? getNumaNodeCPUs(numa_node)
+                                  : std::vector<int>()),
       local_log_store_(local_log_store),
       processor_(nullptr),
       trace_logger_(trace_logger),
@@ -132,6 +179,12 @@ StorageThreadPool::StorageThreadPool(
         settings_->storage_tasks_drr_quanta, principals);
   });
 
+  if (useDRR_ && settings_->storage_tasks_drr_injection_lanes > 0) {
+    drr_injection_lanes_ = std::make_unique<DRRInjectionLanes>(
+        settings_->storage_tasks_drr_injection_lanes,
+        computeActualQueueSizes(task_queue_size)[(int)ThreadType::SLOW]);
+  }
+
   // Find an upper limit on the number of tasks in flight for this thread
   // pool, to size the syncing thread's queue
   size_t max_tasks_in_flight = 0;
@@ -204,6 +257,22 @@ StorageThreadPool::computeActualQueueSizes(size_t task_queue_size) const {
   return actual_queue_sizes;
 }
 
+void StorageThreadPool::onThreadStarted() {
+  if (pinned_cpus_.empty()) {
+    return;
+  }
+  // Failure isn't fatal, the thread just runs wherever the scheduler puts it.
+  if (setThreadCPUAffinity(0, pinned_cpus_) != 0) {
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      1,
+                      "Failed to pin storage thread of shard %d to NUMA node "
+                      "%d: %s",
+                      (int)shard_idx_,
+                      numa_node_,
+                      error_description(err));
+  }
+}
+
 StorageThreadPool::~StorageThreadPool() {
   // Join all the pthreads to complete shutdown.  This is necessary because
   // StorageThreads have a pointer to us, so they have to finish before we're
@@ -236,8 +305,7 @@ void StorageThreadPool::shutDown(bool persist_record_caches) {
           shard_idx_, remaining_threads, persist_record_caches);
       task->setStorageThreadPool(this);
       if (drr) {
-        uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
-        task_queue.drrQueue.enqueue(task.release(), principal);
+        enqueueDRR(task.release());
       } else {
         task_queue.queue.blockingWrite(task.release());
       }
@@ -305,8 +373,7 @@ int StorageThreadPool::tryPutTask(std::unique_ptr<StorageTask>&& task) {
 
   bool ret = true;
   if (useDRR_ && (thread_type == StorageTask::ThreadType::SLOW)) {
-    uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
-    taskQueues_[thread_type].drrQueue.enqueue(task.get(), principal);
+    enqueueDRR(task.get());
   } else {
     ret = taskQueues_[thread_type].queue.writeIfNotFull(task.get());
   }
@@ -352,8 +419,7 @@ bool StorageThreadPool::blockingPutTask(std::unique_ptr<StorageTask>&& task) {
 
   task->setStorageThreadPool(this);
   if (useDRR_ && (thread_type == StorageTask::ThreadType::SLOW)) {
-    uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
-    taskQueues_[thread_type].drrQueue.enqueue(task.release(), principal);
+    enqueueDRR(task.release());
   } else {
     taskQueues_[thread_type].queue.blockingWrite(task.release());
   }
@@ -363,17 +429,20 @@ bool StorageThreadPool::blockingPutTask(std::unique_ptr<StorageTask>&& task) {
 }
 
 std::unique_ptr<StorageTask>
-StorageThreadPool::blockingGetTask(StorageTask::ThreadType type) {
+StorageThreadPool::blockingGetTask(StorageTask::ThreadType type,
+                                   BusyPoller* poller) {
   auto& task_queue = taskQueues_[getThreadType(type)];
   std::map<StorageTaskType, int> dropped_by_type;
 
   while (true) {
     StorageTask* rawptr;
+    ++task_queue.idle_threads;
     if (useDRR_ && (type == StorageTask::ThreadType::SLOW)) {
-      rawptr = task_queue.drrQueue.blockingDequeue();
+      rawptr = blockingDequeueDRR();
     } else {
-      task_queue.queue.blockingRead(rawptr);
+      task_queue.queue.blockingRead(rawptr, poller);
     }
+    --task_queue.idle_threads;
 
     std::unique_ptr<StorageTask> task(rawptr);
 
@@ -425,6 +494,9 @@ void StorageThreadPool::dropTaskQueue(StorageTask::ThreadType type) {
   ssize_t ntasks;
   if (useDRR_ && (type == StorageTask::ThreadType::SLOW)) {
     ntasks = task_queue.drrQueue.size();
+    if (drr_injection_lanes_) {
+      ntasks += drr_injection_lanes_->sizeGuess();
+    }
   } else {
     ntasks = task_queue.queue.size();
   }
@@ -437,6 +509,76 @@ void StorageThreadPool::dropTaskQueue(StorageTask::ThreadType type) {
   }
 }
 
+bool StorageThreadPool::tryOffloadCpuStage(
+    std::unique_ptr<StorageTask>& task) {
+  ld_check(task->hasCpuStage());
+  if (!settings_->storage_tasks_steal_cpu_stages || peers_.empty() ||
+      task->durability() == Durability::SYNC_WRITE) {
+    return false;
+  }
+
+  const size_t start = next_peer_.fetch_add(1);
+  for (size_t i = 0; i < peers_.size(); ++i) {
+    StorageThreadPool* peer = peers_[(start + i) % peers_.size()];
+    const auto thread_type = peer->getThreadType(*task);
+    if (peer->isShuttingDown() ||
+        peer->taskQueues_[thread_type].idle_threads.load() <= 0) {
+      continue;
+    }
+    auto wrapper = std::make_unique<CpuStageStorageTask>(std::move(task));
+    std::unique_ptr<StorageTask> wrapper_task(wrapper.release());
+    if (peer->tryPutTask(std::move(wrapper_task)) == 0) {
+      STAT_INCR(stats_, storage_tasks_cpu_stages_stolen);
+      return true;
+    }
+    // The peer's queue is full or shutting down. tryPutTask() left the
+    // wrapper with us, take the task back out of it.
+    task = static_cast<CpuStageStorageTask&>(*wrapper_task).releaseTask();
+  }
+  return false;
+}
+
+void StorageThreadPool::enqueueDRR(StorageTask* task) {
+  const uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
+  if (drr_injection_lanes_) {
+    const int lane = drr_injection_lanes_->getLane(*drr_lane_id_);
+    if (lane >= 0 && drr_injection_lanes_->tryWrite(lane, task)) {
+      return;
+    }
+    // This thread has no lane or its lane is full. Fall back to enqueueing
+    // under the scheduler mutex, which may reorder this task ahead of the
+    // ones still in the lane; DRR does not guarantee FIFO order anyway.
+    STAT_INCR(stats_, storage_tasks_injection_lane_fallbacks);
+    taskQueues_[ThreadType::SLOW].drrQueue.enqueue(task, principal);
+    drr_injection_lanes_->notify();
+    return;
+  }
+  taskQueues_[ThreadType::SLOW].drrQueue.enqueue(task, principal);
+}
+
+StorageTask* StorageThreadPool::blockingDequeueDRR() {
+  auto& drr_queue = taskQueues_[ThreadType::SLOW].drrQueue;
+  if (!drr_injection_lanes_) {
+    return drr_queue.blockingDequeue();
+  }
+
+  // Every task injected posts the semaphore once, so after waiting there is
+  // a task for us either in the scheduler or in one of the lanes.
+  drr_injection_lanes_->wait();
+  while (true) {
+    drr_injection_lanes_->drain([&](StorageTask* task) {
+      drr_queue.enqueue(task, static_cast<uint64_t>(task->getPrincipal()));
+    });
+    StorageTask* task = drr_queue.dequeue();
+    if (task) {
+      return task;
+    }
+    // Another storage thread is in the middle of moving our task from its
+    // lane into the scheduler.
+    std::this_thread::yield();
+  }
+}
+
 bool StorageThreadPool::tryDropOneTask(
     std::unique_ptr<StorageTask>& task,
     std::map<StorageTaskType, int>& dropped_by_type) {
@@ -531,4 +673,19 @@ void StorageThreadPool::getStorageTaskDebugInfo(InfoStorageTasksTable& table) {
         std::bind(cb, std::placeholders::_1, eType, true));
   }
 }
+
+void StorageThreadPool::getDRRQueueInfo(InfoStorageTaskQueuesTable& table) {
+  if (!useDRR_) {
+    return;
+  }
+  for (const DRRQueueInfo& info :
+       taskQueues_[StorageTask::ThreadType::SLOW].drrQueue.getQueueInfo()) {
+    table.next()
+        .set<0>(shard_idx_)
+        .set<1>(info.principal.name)
+        .set<2>(info.principal.share)
+        .set<3>(info.numReqs)
+        .set<4>(info.deficit);
+  }
+}
 }} // namespace facebook::logdevice
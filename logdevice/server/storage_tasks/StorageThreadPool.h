@@ -10,6 +10,7 @@
 #include <memory>
 #include <vector>
 
+#include <folly/ThreadLocal.h>
 #include <folly/small_vector.h>
 
 #include "logdevice/common/DRRScheduler.h"
@@ -20,6 +21,7 @@
 #include "logdevice/server/ServerSettings.h"
 #include "logdevice/server/storage_tasks/PrioritizedQueue.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
+#include "logdevice/server/storage_tasks/StorageTaskInjectionLanes.h"
 
 namespace facebook { namespace logdevice {
 
@@ -47,11 +49,15 @@ class StorageThreadPool {
                        (size_t)StorageTaskPriority::NUM_PRIORITIES>;
 
   using DRRTaskQueue = DRRScheduler<StorageTask, &StorageTask::schedulerQHook_>;
+  using DRRInjectionLanes = StorageTaskInjectionLanes<StorageTask*>;
 
   /**
    * Creates the pool and starts all threads.  Does not claim ownership of the
    * local log store.
    *
+   * @param numa_node  if not -1, all threads of the pool are restricted to the
+   *                   CPUs of this NUMA node
+   *
    * @throws ConstructorFailed on failure
    */
   StorageThreadPool(shard_index_t shard_idx,
@@ -62,7 +68,8 @@ class StorageThreadPool {
                     LocalLogStore* local_log_store,
                     size_t task_queue_size,
                     StatsHolder* stats = nullptr,
-                    const std::shared_ptr<TraceLogger> trace_logger = nullptr);
+                    const std::shared_ptr<TraceLogger> trace_logger = nullptr,
+                    int numa_node = -1);
 
   ~StorageThreadPool();
 
@@ -171,8 +178,13 @@ class StorageThreadPool {
   /**
    * Gets a task from the queue, blocking if there are none.  Used by storage
    * threads to get work to do.
+   *
+   * @param poller  if not null, used to busy-poll the queue before blocking
+   *                (not for SLOW threads when DRR scheduling is on)
    */
-  std::unique_ptr<StorageTask> blockingGetTask(StorageTask::ThreadType type);
+  std::unique_ptr<StorageTask>
+  blockingGetTask(StorageTask::ThreadType type,
+                  BusyPoller* poller = nullptr);
 
   /**
    * Tries to get a batch of WriteStorageTasks from the write queue.
@@ -210,13 +222,61 @@ class StorageThreadPool {
    */
   void join();
 
+  /**
+   * Sets the pools of the other shards on this node, which CPU stages of
+   * tasks can be handed over to. Called by ShardedStorageThreadPool before
+   * any tasks are posted.
+   */
+  void setPeers(std::vector<StorageThreadPool*> peers) {
+    peers_ = std::move(peers);
+  }
+
+  /**
+   * Called by a storage thread after execute() of a task with a CPU stage.
+   * If storage-tasks-steal-cpu-stages is enabled and another shard has an
+   * idle storage thread of the same type, hands the task over to that shard,
+   * which will run the CPU stage and pass the task back to the worker.
+   *
+   * @return true if the task was handed over, false if the caller should run
+   *         the CPU stage itself; `task` is left untouched in that case.
+   */
+  bool tryOffloadCpuStage(std::unique_ptr<StorageTask>& task);
+
   ResourceBudget& getMemoryBudget(StorageTask::ThreadType thread_type);
 
+  /**
+   * NUMA node this pool's threads are pinned to, -1 if they aren't.
+   */
+  int getNumaNode() const {
+    return numa_node_;
+  }
+
+  /**
+   * CPUs this pool's threads are pinned to, empty if they aren't.
+   */
+  const std::vector<int>& getPinnedCPUs() const {
+    return pinned_cpus_;
+  }
+
+  /**
+   * Called by each storage thread of the pool when it starts. Pins the
+   * thread to getPinnedCPUs(), if any, before it allocates anything, so that
+   * its memory comes from the local node.
+   */
+  void onThreadStarted();
+
   /**
    * Fetches debug info on all pending storage tasks into the table provided
    */
   void getStorageTaskDebugInfo(InfoStorageTasksTable& table);
 
+  /**
+   * Fetches the number of tasks queued for each IO principal in the DRR queue
+   * of SLOW threads into the table provided. Adds nothing if DRR is disabled.
+   * Tasks still in injection lanes are not counted.
+   */
+  void getDRRQueueInfo(InfoStorageTaskQueuesTable& table);
+
  private:
   UpdateableSettings<ServerSettings> server_settings_;
   UpdateableSettings<Settings> settings_;
@@ -227,6 +287,10 @@ class StorageThreadPool {
   const int nthreads_default_;
   const bool useDRR_;
 
+  // See getNumaNode() and getPinnedCPUs().
+  const int numa_node_;
+  const std::vector<int> pinned_cpus_;
+
   std::vector<std::unique_ptr<ExecStorageThread>> exec_threads_;
 
   std::unique_ptr<SyncingStorageThread> syncing_thread_;
@@ -259,6 +323,9 @@ class StorageThreadPool {
     std::atomic<int64_t> tasks_to_drop;
 
     ResourceBudget memory_budget;
+
+    // Number of storage threads waiting for a task from this queue.
+    std::atomic<int> idle_threads{0};
   };
 
   // If set, *Put{Task,Write} methods will immediately return (with err set
@@ -275,9 +342,34 @@ class StorageThreadPool {
   // Separate queue for each type of storage thread.
   SimpleEnumMap<StorageTask::ThreadType, PerTypeTaskQueue> taskQueues_;
 
+  // Pools of the other shards, see setPeers().
+  std::vector<StorageThreadPool*> peers_;
+
+  // Where tryOffloadCpuStage() starts looking for an idle peer.
+  std::atomic<size_t> next_peer_{0};
+
   // This updates memory budgets whenever they change in settings.
   UpdateableSettings<Settings>::SubscriptionHandle settings_subscription_;
 
+  // If storage-tasks-drr-injection-lanes is set, producers put tasks for the
+  // DRR queue into their own lock-free lane instead of taking the scheduler
+  // mutex. Storage threads move them into the scheduler when dequeueing.
+  std::unique_ptr<DRRInjectionLanes> drr_injection_lanes_;
+  // Lane claimed by the calling producer thread.
+  folly::ThreadLocal<DRRInjectionLanes::LaneId> drr_lane_id_;
+
+  /**
+   * Puts a task into the DRR queue of SLOW threads, through the calling
+   * thread's injection lane if there is one. Claims ownership of the task.
+   */
+  void enqueueDRR(StorageTask* task);
+
+  /**
+   * Gets the next task from the DRR queue of SLOW threads, blocking if there
+   * are none.
+   */
+  StorageTask* blockingDequeueDRR();
+
   /**
    * Called when tasksToDrop_ was observed to be more than 0, suggesting that
    * a task should be dropped.
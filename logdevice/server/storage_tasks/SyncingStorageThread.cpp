@@ -7,8 +7,10 @@
  */
 #include "logdevice/server/storage_tasks/SyncingStorageThread.h"
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
+#include <thread>
 
 #include "logdevice/common/SlowStorageTasksTracer.h"
 #include "logdevice/common/debug.h"
@@ -53,11 +55,19 @@ void SyncingStorageThread::stopProcessingTasks() {
 }
 
 void SyncingStorageThread::run() {
+  pool_->onThreadStarted();
   pool_->getLocalLogStore().onStorageThreadStarted();
   SlowStorageTasksTracer slow_task_tracer{pool_->getTraceLogger()};
 
   std::deque<std::unique_ptr<StorageTask>> batch;
   bool stop = false;
+  // Moving average of the duration of sync() calls.
+  std::chrono::microseconds sync_latency{0};
+  // Whether the next sync requested by an undelayable task should be held
+  // back to coalesce it with requests arriving after it. Cleared when doing
+  // so didn't pick up any additional task, i.e. when requests don't arrive
+  // concurrently and waiting would only add latency.
+  bool coalesce_next = true;
   auto got_task = [&](std::unique_ptr<StorageTask> task) {
     if (task) {
       ld_check(task->durability() == Durability::SYNC_WRITE);
@@ -88,11 +98,13 @@ void SyncingStorageThread::run() {
     }
 
     // Delay some tasks until timeout occurs or undelayable task arrives.
+    bool undelayable = false;
     if (!stop) {
       const std::chrono::milliseconds interval =
           pool_->getServerSettings()->storage_thread_delaying_sync_interval;
       std::unique_lock<std::mutex> lock(delay_cv_mutex_);
-      delay_cv_.wait_for(lock, interval, [&]() { return sync_immediately_; });
+      undelayable = delay_cv_.wait_for(
+          lock, interval, [&]() { return sync_immediately_; });
       // Usage of sync_immediately_ introduces race condition
       // when we set it to false before signalling from enqueueForSync
       // for the same undelayable task. Thus, next batch is going
@@ -100,6 +112,27 @@ void SyncingStorageThread::run() {
       sync_immediately_ = false;
     }
 
+    // An undelayable task wants a sync now. If sync requests have been
+    // arriving concurrently, hold the sync back for about as long as a sync
+    // takes: tasks that arrive meanwhile share it instead of each paying for
+    // a sync of their own, and latency grows by at most one sync duration.
+    const std::chrono::microseconds coalescing_window =
+        std::min<std::chrono::microseconds>(
+            pool_->getServerSettings()
+                ->storage_thread_max_sync_coalescing_delay,
+            sync_latency);
+    const bool coalescing =
+        undelayable && coalesce_next && coalescing_window.count() > 0;
+    size_t batch_size_before_window = 0;
+    if (coalescing && !stop) {
+      while (batch.size() < queue_.capacity() && queue_.read(task)) {
+        got_task(std::move(task));
+      }
+      batch_size_before_window = batch.size();
+      /* sleep override */
+      std::this_thread::sleep_for(coalescing_window);
+    }
+
     // We got one task off the incoming queue, waited for timeout
     // or undelayable task, now pull as much as possible to sync
     // in the same batch. This should handle typical cases when a burst
@@ -118,6 +151,12 @@ void SyncingStorageThread::run() {
       got_task(std::move(task));
     }
 
+    if (coalescing) {
+      coalesce_next = batch.size() > batch_size_before_window;
+    } else if (undelayable) {
+      coalesce_next = batch.size() > 1;
+    }
+
     if (!batch.empty()) {
       using namespace std::chrono;
       auto start_time = steady_clock::now();
@@ -129,6 +168,13 @@ void SyncingStorageThread::run() {
         RATELIMIT_ERROR(std::chrono::seconds(60), 1, "Sync failed!?");
       }
 
+      auto duration = duration_cast<microseconds>(end_time - start_time);
+      sync_latency = sync_latency.count() == 0
+          ? duration
+          : (sync_latency * 3 + duration) / 4;
+      PER_SHARD_HISTOGRAM_ADD(
+          pool_->stats(), sync_batch_size, pool_->getShardIdx(), batch.size());
+
       uint64_t duration_ms =
           duration_cast<milliseconds>(end_time - start_time).count();
       ld_debug("Shard %d: Synced %zu tasks in %ld ms",
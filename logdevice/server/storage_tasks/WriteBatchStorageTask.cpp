@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
@@ -32,16 +33,20 @@ void WriteBatchStorageTask::execute() {
   using namespace std::chrono_literals;
 
   size_t ntasks, limit = getWriteBatchSize();
-  auto writes = tryGetWriteBatch(limit, getWriteBatchBytes());
-  ntasks = writes.size();
-
-  ld_spew("WriteBatchStorageTask picked up batch of %lu writes", writes.size());
+  const size_t max_bytes = getWriteBatchBytes();
+  auto writes = tryGetWriteBatch(limit, max_bytes);
 
-  if (ntasks == 0) {
+  if (writes.empty()) {
     // Common case, avoid cost of interaction with local log store
+    ld_spew("WriteBatchStorageTask picked up batch of 0 writes");
     return;
   }
 
+  waitForGroupCommit(writes, limit, max_bytes);
+  ntasks = writes.size();
+
+  ld_spew("WriteBatchStorageTask picked up batch of %lu writes", writes.size());
+
   // Yield to higher-pri tasks if needed. Since this can take a few seconds
   // or even minutes, this is done before checking timeouts and preemption.
   auto reject_writes = throttleIfNeeded();
@@ -131,8 +136,10 @@ void WriteBatchStorageTask::execute() {
     STAT_INCR(stats(), write_batches);
   }
 
+  const auto write_start_time = std::chrono::steady_clock::now();
   int rv = writeMulti(write_ops);
   Status status = rv == 0 ? E::OK : err;
+  const auto write_end_time = std::chrono::steady_clock::now();
 
   auto write_ops_iter = write_ops.begin();
   for (auto& write : writes) {
@@ -140,6 +147,8 @@ void WriteBatchStorageTask::execute() {
       continue;
     }
     write->status_ = status;
+    write->execution_start_time_ = write_start_time;
+    write->execution_end_time_ = write_end_time;
     if (status == E::OK) {
       // store success, try to insert the stored record into the record
       // cache. Perform insertion on the storage thread rather than the
@@ -171,23 +180,83 @@ void WriteBatchStorageTask::execute() {
   // StorageThread will send back the response for *this
 }
 
+void WriteBatchStorageTask::waitForGroupCommit(WriteBatch& writes,
+                                               size_t max_count,
+                                               size_t max_bytes) {
+  // How long to sleep between polls of the write queue.
+  static constexpr std::chrono::microseconds kPollInterval{50};
+
+  const std::chrono::microseconds window = getGroupCommitWindow();
+  if (window.count() <= 0) {
+    return;
+  }
+  // Writes that don't wait for a WAL sync gain little from bigger batches,
+  // don't delay them.
+  if (std::none_of(writes.begin(), writes.end(), [](const auto& write) {
+        return write->durability() == Durability::SYNC_WRITE;
+      })) {
+    return;
+  }
+
+  size_t bytes = 0;
+  for (const auto& write : writes) {
+    bytes += write->getPayloadSize();
+  }
+  const size_t initial_count = writes.size();
+  const auto deadline = std::chrono::steady_clock::now() + window;
+  while (writes.size() < max_count && bytes < max_bytes) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      break;
+    }
+    /* sleep override */
+    std::this_thread::sleep_for(
+        std::min<std::chrono::steady_clock::duration>(deadline - now,
+                                                      kPollInterval));
+    // The WriteBatchStorageTasks that were posted for the writes we pick up
+    // here will find the write queue empty and do nothing.
+    auto more = tryGetWriteBatch(max_count - writes.size(), max_bytes - bytes);
+    for (auto& write : more) {
+      bytes += write->getPayloadSize();
+      writes.push_back(std::move(write));
+    }
+  }
+
+  STAT_INCR(stats(), write_batch_group_commit_waits);
+  STAT_ADD(stats(),
+           write_batch_group_commit_writes_added,
+           writes.size() - initial_count);
+}
+
 bool WriteBatchStorageTask::throttleIfNeeded() {
   auto& store = storageThreadPool_->getLocalLogStore();
   auto writes_throttle_state = store.getWriteThrottleState();
-  if (writes_throttle_state == LocalLogStore::WriteThrottleState::NONE) {
-    return false;
-  }
+  if (writes_throttle_state != LocalLogStore::WriteThrottleState::NONE) {
+    if (thread_type_ == StorageTask::ThreadType::FAST_STALLABLE &&
+        storageThreadPool_->writeStallingEnabled()) {
+      store.stallLowPriWrite();
+      return false;
+    }
 
-  if (thread_type_ == StorageTask::ThreadType::FAST_STALLABLE &&
-      storageThreadPool_->writeStallingEnabled()) {
-    store.stallLowPriWrite();
-    return false;
+    // For other thread types, reject the write if throttle state asks us to
+    // do so.
+    if (writes_throttle_state ==
+        LocalLogStore::WriteThrottleState::REJECT_WRITE) {
+      return true;
+    }
   }
 
-  // For other thread types, reject the write if throttle state asks us to do
-  // so.
-  return writes_throttle_state ==
-      LocalLogStore::WriteThrottleState::REJECT_WRITE;
+  // Not stalled or rejected, but the store may be getting close to it. Slow
+  // down proportionally.
+  std::chrono::microseconds delay = store.getWriteDelay();
+  if (delay.count() > 0) {
+    /* sleep override */
+    std::this_thread::sleep_for(delay);
+    StatsHolder* stats_holder = stats();
+    PER_SHARD_STAT_ADD(
+        stats_holder, write_delay_microsec, reply_shard_idx_, delay.count());
+  }
+  return false;
 }
 
 void WriteBatchStorageTask::onDone() {}
@@ -208,11 +277,21 @@ void WriteBatchStorageTask::onStorageThreadDrop() {
 }
 
 size_t WriteBatchStorageTask::getWriteBatchSize() const {
-  return storageThreadPool_->getSettings()->write_batch_size;
+  auto settings = storageThreadPool_->getSettings();
+  return thread_type_ == StorageTask::ThreadType::FAST_STALLABLE
+      ? settings->rebuilding_write_batch_size
+      : settings->write_batch_size;
 }
 
 size_t WriteBatchStorageTask::getWriteBatchBytes() const {
-  return storageThreadPool_->getSettings()->write_batch_bytes;
+  auto settings = storageThreadPool_->getSettings();
+  return thread_type_ == StorageTask::ThreadType::FAST_STALLABLE
+      ? settings->rebuilding_write_batch_bytes
+      : settings->write_batch_bytes;
+}
+
+std::chrono::microseconds WriteBatchStorageTask::getGroupCommitWindow() const {
+  return storageThreadPool_->getSettings()->write_batch_group_commit_window;
 }
 
 std::unique_ptr<WriteStorageTask> WriteBatchStorageTask::tryGetWrite() {
@@ -7,6 +7,10 @@
  */
 #pragma once
 
+#include <chrono>
+
+#include <folly/small_vector.h>
+
 #include "logdevice/server/storage_tasks/StorageTask.h"
 #include "logdevice/server/storage_tasks/WriteStorageTask.h"
 
@@ -79,6 +83,7 @@ class WriteBatchStorageTask : public StorageTask {
 
   virtual size_t getWriteBatchSize() const;
   virtual size_t getWriteBatchBytes() const;
+  virtual std::chrono::microseconds getGroupCommitWindow() const;
   virtual void sendBackToWorker(std::unique_ptr<WriteStorageTask> task);
   virtual void sendDroppedToWorker(std::unique_ptr<WriteStorageTask> task);
   virtual StatsHolder* stats();
@@ -88,5 +93,16 @@ class WriteBatchStorageTask : public StorageTask {
   virtual int writeMulti(const std::vector<const WriteOp*>& write_ops);
   // Returns true if entire tasks will be rejected.
   virtual bool throttleIfNeeded();
+
+ private:
+  using WriteBatch = folly::small_vector<std::unique_ptr<WriteStorageTask>, 4>;
+
+  // If `writes` contains a write that needs a WAL sync, keeps pulling more
+  // writes from the write queue for up to getGroupCommitWindow() or until
+  // the batch limits are reached, so that more STOREs share the rocksdb
+  // write and the WAL sync.
+  void waitForGroupCommit(WriteBatch& writes,
+                          size_t max_count,
+                          size_t max_bytes);
 };
 }} // namespace facebook::logdevice
@@ -10,9 +10,11 @@
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
 
+#include "logdevice/common/ZeroCopiedRecord.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/settings/util.h"
+#include "logdevice/server/RealTimeRecordBuffer.h"
 #include "logdevice/server/read_path/CatchupQueue.h"
 #include "logdevice/server/read_path/LocalLogStoreReader.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
@@ -332,3 +334,51 @@ TEST(AllServerReadStreams, ReadStorageTasksMemoryLimit) {
 
   streams.clear();
 }
+
+// Released records distributed to read streams of a log are also kept in the
+// log's shared tail, up to real-time-shared-tail-batches batches, until the
+// log has no more read streams on this worker.
+TEST(AllServerReadStreams, SharedTail) {
+  LogStorageStateMap map(1, /*stats*/ nullptr, /*record_cache*/ false);
+  Settings settings = create_default_settings<Settings>();
+  settings.real_time_shared_tail_batches = 2;
+  AllServerReadStreams streams(
+      settings, 99999, worker_id_t(1), &map, nullptr, nullptr, false);
+
+  const logid_t log1(1), log2(2);
+  const ClientID c1(111), c2(112);
+  const std::string csid("");
+
+  ASSERT_NE(streams.insertOrGet(c1, log1, SHARD_IDX, csid, read_stream_id_t(1))
+                .first,
+            nullptr);
+  ASSERT_NE(streams.insertOrGet(c2, log1, SHARD_IDX, csid, read_stream_id_t(1))
+                .first,
+            nullptr);
+
+  auto release = [&](logid_t log, lsn_t begin, lsn_t end) {
+    streams.appendReleasedRecords(std::make_unique<ReleasedRecords>(
+        log, begin, end, std::shared_ptr<ZeroCopiedRecord>(), 100));
+  };
+  release(log1, 1, 10);
+  release(log1, 11, 20);
+  release(log1, 21, 30);
+  // Nobody reads log2, so its records are not kept.
+  release(log2, 1, 10);
+  streams.distributeNewlyReleasedRecords();
+
+  auto tail = streams.getSharedTailRecords(log1);
+  ASSERT_EQ(2, tail.size());
+  EXPECT_EQ(11, tail[0]->begin_lsn_);
+  EXPECT_EQ(21, tail[1]->begin_lsn_);
+  EXPECT_TRUE(streams.getSharedTailRecords(log2).empty());
+
+  // The shared tail survives one of the readers going away, but not the last.
+  streams.erase(c1, log1, read_stream_id_t(1), SHARD_IDX);
+  EXPECT_EQ(2, streams.getSharedTailRecords(log1).size());
+  tail.clear();
+  streams.erase(c2, log1, read_stream_id_t(1), SHARD_IDX);
+  EXPECT_TRUE(streams.getSharedTailRecords(log1).empty());
+
+  streams.clear();
+}
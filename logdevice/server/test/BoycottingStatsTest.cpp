@@ -488,6 +488,30 @@ TEST(PerClientNodeStatsAggregatorTest, AggregateWithMoreWorstThanClients) {
                 (*result.client_counts)[0][0][1].fails);
 }
 
+TEST(PerClientNodeStatsAggregatorTest, AggregateWorstOfManyClients) {
+  MockPerClientNodeStatsAggregator aggregator;
+  EXPECT_CALL(aggregator, getWorstClientCount()).WillRepeatedly(Return(2));
+
+  NodeID stats_about{1};
+  auto holder_ptr = aggregator.getStats();
+
+  // clients 1..100 with a growing number of fails; 99 and 100 are the worst
+  for (int i = 1; i <= 100; ++i) {
+    perClientNodeStatAdd(holder_ptr, ClientID{i}, stats_about, 100, i);
+  }
+
+  auto result = aggregator.aggregate(1);
+  EXPECT_THAT(result.node_ids, ElementsAre(stats_about));
+
+  EXPECT_EQ(98, (*result.summed_counts)[0][0].client_count);
+  EXPECT_EQ(9800, (*result.summed_counts)[0][0].successes);
+  EXPECT_EQ(98 * 99 / 2, (*result.summed_counts)[0][0].fails);
+
+  EXPECT_THAT(std::vector<uint32_t>({(*result.client_counts)[0][0][0].fails,
+                                     (*result.client_counts)[0][0][1].fails}),
+              UnorderedElementsAre(99, 100));
+}
+
 TEST(PerClientNodeStatsAggregatorTest, AggregateWithWorstAndSumBuckets) {
   MockPerClientNodeStatsAggregator aggregator;
   EXPECT_CALL(aggregator, getWorstClientCount()).WillRepeatedly(Return(1));
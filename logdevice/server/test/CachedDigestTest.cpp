@@ -80,6 +80,8 @@ class CachedDigestTest : public ::testing::Test {
   // used to generate the expected digest
   double record_probability_ = 0.5;
   bool epoch_empty_ = false;
+  // digest is requested without payloads
+  bool no_payload_ = false;
 
   ////////////////
   bool push_timer_active_ = false;
@@ -314,6 +316,7 @@ void CachedDigestTest::setUp() {
 
   // create digest
   digest_ = std::make_unique<MockedCachedDigest>(this);
+  digest_->setNoPayload(no_payload_);
 }
 
 void CachedDigestTest::verifyResult() {
@@ -376,11 +379,18 @@ void CachedDigestTest::verifyResult() {
     ASSERT_EQ(read_stream_id_t(1), rm->header_.read_stream_id);
     ASSERT_EQ(compose_lsn(EPOCH, itr->first), rm->header_.lsn);
     ASSERT_EQ(r.timestamp, rm->header_.timestamp);
-    ASSERT_EQ(
-        CachedDigest::StoreFlagsToRecordFlags(r.flags), rm->header_.flags);
     ASSERT_EQ(SHARD, rm->header_.shard);
-    ASSERT_EQ(sizeof(lsn_t), rm->payload_.size());
-    ASSERT_EQ(rm->header_.lsn, *((lsn_t*)rm->payload_.getPayload().data()));
+    if (no_payload_) {
+      ASSERT_EQ(CachedDigest::StoreFlagsToRecordFlags(r.flags) |
+                    RECORD_Header::CHECKSUM_PARITY,
+                rm->header_.flags);
+      ASSERT_EQ(0, rm->payload_.size());
+    } else {
+      ASSERT_EQ(
+          CachedDigest::StoreFlagsToRecordFlags(r.flags), rm->header_.flags);
+      ASSERT_EQ(sizeof(lsn_t), rm->payload_.size());
+      ASSERT_EQ(rm->header_.lsn, *((lsn_t*)rm->payload_.getPayload().data()));
+    }
     itr++, itm++;
     ++record_delivered;
   }
@@ -466,6 +476,17 @@ TEST_F(CachedDigestTest, DeliverTailRecord2) {
   verifyResult();
 }
 
+TEST_F(CachedDigestTest, NoPayload) {
+  tail_esn_ = esn_t(11322);
+  lng_ = esn_t(11394);
+  start_esn_ = esn_t(11322);
+  num_record_deliverable_ = 70;
+  no_payload_ = true;
+  setUp();
+  digest_->start();
+  verifyResult();
+}
+
 TEST_F(CachedDigestTest, SynchronousFinish) {
   start_esn_ = esn_t(761);
   num_record_deliverable_ = 1000;
@@ -25,6 +25,7 @@
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
+#include "logdevice/common/settings/util.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/test/MockBackoffTimer.h"
 #include "logdevice/common/test/MockTimer.h"
@@ -295,6 +296,7 @@ class CatchupQueueTest : public ::testing::Test {
                         folly::StringPiece record_key1,
                         folly::StringPiece record_key2);
 
+  Settings settings_{create_default_settings<Settings>()};
   LogStorageStateMap log_storage_state_map_;
   InterceptedTasks tasks_;
   TestAllServerReadStreams streams_;
@@ -451,7 +453,7 @@ class MockCatchupQueueDependencies : public CatchupQueueDependencies {
   }
 
   const Settings& getSettings() const override {
-    return *settings_.get();
+    return test_.settings_;
   }
 
  private:
@@ -461,7 +463,6 @@ class MockCatchupQueueDependencies : public CatchupQueueDependencies {
     test_.flow_group_->push(callback, priority);
   }
 
-  UpdateableSettings<Settings> settings_; // never updated
   CatchupQueueTest& test_;
   StatsHolder server_stats_;
 };
@@ -1003,6 +1004,53 @@ TEST_F(CatchupQueueTest, RecoveryFlag) {
   EXPECT_GE(task->read_ctx_.last_released_lsn_, task->read_ctx_.until_lsn_);
 }
 
+/**
+ * Digest streams can have storage tasks in flight in digest slots while
+ * another stream of the same client holds the regular storage task slot.
+ */
+TEST_F(CatchupQueueTest, DigestStreamsUseDigestSlots) {
+  settings_.digest_read_tasks_per_client = 2;
+
+  read_stream_id_t regular_id(1);
+  ServerReadStream& regular = createStream(regular_id);
+  notifyNeedsCatchup(regular, regular_id);
+
+  std::vector<read_stream_id_t> digest_ids{
+      read_stream_id_t(2), read_stream_id_t(3), read_stream_id_t(4)};
+  for (read_stream_id_t id : digest_ids) {
+    ServerReadStream& stream = createStream(id);
+    stream.digest_ = true;
+    stream.ignore_released_status_ = true;
+    stream.until_lsn_ = 1000;
+    notifyNeedsCatchup(stream, id);
+  }
+
+  // One task for the regular stream and one for each of the first two digest
+  // streams. The third digest stream has to wait for a free slot.
+  ASSERT_EQ(3, tasks_.size());
+  EXPECT_FALSE(tasks_[0]->in_digest_lane_);
+  EXPECT_TRUE(tasks_[1]->in_digest_lane_);
+  EXPECT_TRUE(tasks_[2]->in_digest_lane_);
+  InterceptedTasks in_flight = std::move(tasks_);
+  tasks_.clear();
+
+  // The first digest stream reaches its until_lsn, freeing its slot for the
+  // third one.
+  in_flight[1]->status_ = E::UNTIL_LSN_REACHED;
+  in_flight[1]->read_ctx_.read_ptr_ = {lsn_t{1001}};
+  streams_.onReadTaskDone(*in_flight[1]);
+  ASSERT_EQ(1, tasks_.size());
+  EXPECT_TRUE(tasks_[0]->in_digest_lane_);
+  EXPECT_EQ(digest_ids[2], tasks_[0]->stream_.get().get()->id_);
+
+  // The regular stream's task comes back as usual.
+  in_flight[0]->status_ = E::CAUGHT_UP;
+  in_flight[0]->read_ctx_.read_ptr_ = {lsn_t{101}};
+  streams_.onReadTaskDone(*in_flight[0]);
+  EXPECT_FALSE(regular.storage_task_in_flight_);
+  EXPECT_EQ(1, tasks_.size());
+}
+
 /**
  * Tests that the HOLE store flag is propagated to clients via the RECORD
  * message.
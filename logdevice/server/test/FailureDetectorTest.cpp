@@ -142,15 +142,23 @@ class FailureDetectorTest : public testing::Test {
   Alarm alarm_{DEFAULT_TEST_TIMEOUT};
 };
 
-// generates a dummy config consisting of num_nodes sequencers
+// generates a dummy config consisting of num_nodes sequencers, placed in racks
+// of nodes_per_rack nodes if nodes_per_rack > 0
 std::shared_ptr<ServerConfig> gen_config(size_t num_nodes,
-                                         node_index_t this_node) {
+                                         node_index_t this_node,
+                                         size_t nodes_per_rack = 0) {
   configuration::Nodes nodes;
   for (node_index_t i = 0; i < num_nodes; ++i) {
     auto& node = nodes[i];
     node.address =
         Sockaddr(get_localhost_address_str(), folly::to<std::string>(1337 + i));
     node.generation = 1;
+    if (nodes_per_rack > 0) {
+      NodeLocation location;
+      location.fromDomainString("rg1.dc1.cl1.row1.rack" +
+                                folly::to<std::string>(i / nodes_per_rack));
+      node.location = location;
+    }
     node.addSequencerRole();
     node.addStorageRole();
   }
@@ -170,7 +178,8 @@ std::pair<std::shared_ptr<ServerProcessor>, MockFailureDetector*>
 make_processor_with_detector(node_index_t nid,
                              size_t num_nodes,
                              const GossipSettings& gossip_settings,
-                             bool create_monitor = true) {
+                             bool create_monitor = true,
+                             size_t nodes_per_rack = 0) {
   /* setup default settings */
   ServerSettings server_settings = create_default_settings<ServerSettings>();
   Settings main_settings = create_default_settings<Settings>();
@@ -183,7 +192,7 @@ make_processor_with_detector(node_index_t nid,
   /* make config for this index */
   std::shared_ptr<UpdateableConfig> uconfig =
       std::make_shared<UpdateableConfig>(std::make_shared<Configuration>(
-          gen_config(num_nodes, nid),
+          gen_config(num_nodes, nid, nodes_per_rack),
           std::make_shared<configuration::LocalLogsConfig>()));
 
   auto processor_builder = TestServerProcessorBuilder{main_settings}
@@ -286,15 +295,16 @@ void simulate_single(detector_list_t& detectors,
 std::tuple<std::vector<std::shared_ptr<ServerProcessor>>, detector_list_t>
 create_processors_and_detectors(size_t num_nodes,
                                 const GossipSettings& settings,
-                                bool create_monitor = true) {
+                                bool create_monitor = true,
+                                size_t nodes_per_rack = 0) {
   std::vector<std::shared_ptr<ServerProcessor>> processors;
   detector_list_t detectors;
 
   for (node_index_t i = 0; i < num_nodes; ++i) {
     std::shared_ptr<ServerProcessor> p;
     MockFailureDetector* d;
-    std::tie(p, d) =
-        make_processor_with_detector(i, num_nodes, settings, create_monitor);
+    std::tie(p, d) = make_processor_with_detector(
+        i, num_nodes, settings, create_monitor, nodes_per_rack);
     processors.push_back(std::move(p));
     detectors.push_back(d);
   }
@@ -340,7 +350,9 @@ create_processors_detectors_monitors(size_t num_nodes,
 // Runs a simulation featuring N nodes gossiping. For each 0 <= i < N/2,
 // i randomly selected nodes are marked as down. The rest of the cluster is
 // expected to detect that in a limited number of steps.
-void simulate(size_t num_nodes, const GossipSettings& settings) {
+void simulate(size_t num_nodes,
+              const GossipSettings& settings,
+              size_t nodes_per_rack = 0) {
   folly::ThreadLocalPRNG g;
 
   for (size_t num_dead = 1; num_dead < num_nodes / 2; ++num_dead) {
@@ -359,8 +371,8 @@ void simulate(size_t num_nodes, const GossipSettings& settings) {
     std::vector<std::shared_ptr<ServerProcessor>> processors;
     detector_list_t detectors;
 
-    std::tie(processors, detectors) =
-        create_processors_and_detectors(num_nodes, settings);
+    std::tie(processors, detectors) = create_processors_and_detectors(
+        num_nodes, settings, /*create_monitor=*/true, nodes_per_rack);
 
     simulate_single(detectors, dead);
     // Cleanly shutdown the processors since FailureDetector runs on
@@ -387,6 +399,14 @@ TEST_F(FailureDetectorTest, RoundRobinGossip) {
   simulate(20, settings);
 }
 
+TEST_F(FailureDetectorTest, HierarchicalGossip) {
+  GossipSettings settings = create_default_settings<GossipSettings>();
+  settings.mode = GossipSettings::SelectionMode::HIERARCHICAL;
+  settings.gossip_hierarchy_scope = NodeLocationScope::RACK;
+  settings.suspect_duration = std::chrono::milliseconds(0);
+  simulate(20, settings, /*nodes_per_rack=*/5);
+}
+
 namespace {
 // simulates a single round of gossiping between two nodes
 void gossip_round(MockFailureDetector* d1, MockFailureDetector* d2) {
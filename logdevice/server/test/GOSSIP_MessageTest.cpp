@@ -42,6 +42,8 @@ struct Params {
   bool with_starting = false;
   bool with_health_status = false;
   bool with_versions = false;
+  bool compact = false;
+  // not checked if empty
   std::string expected;
 };
 void checkGOSSIP_Node(const GOSSIP_Node& left, const GOSSIP_Node& right) {
@@ -126,7 +128,8 @@ void checkVersions(uint16_t proto,
   }
 }
 
-void serializeAndDeserializeTest(Params params) {
+// Returns the size of the serialized message.
+size_t serializeAndDeserializeTest(Params params) {
   unique_evbuffer evbuf(LD_EV(evbuffer_new)(), [](auto ptr) {
     LD_EV(evbuffer_free)(ptr);
   });
@@ -195,6 +198,7 @@ void serializeAndDeserializeTest(Params params) {
                      0,
                      rsm_types,
                      versions_list);
+  msg.compact_encoding_ = params.compact;
 
   EXPECT_EQ(this_node, msg.gossip_node_);
   EXPECT_EQ(instance_id, msg.instance_id_);
@@ -214,16 +218,24 @@ void serializeAndDeserializeTest(Params params) {
   msg.serialize(writer);
   auto write_count = writer.result();
 
-  ASSERT_GT(write_count, 0);
+  EXPECT_GT(write_count, 0);
+  if (write_count <= 0) {
+    return 0;
+  }
   size_t size = LD_EV(evbuffer_get_length)(evbuf.get());
   unsigned char* serialized = LD_EV(evbuffer_pullup)(evbuf.get(), -1);
   std::string serialized_hex = hexdump_buf(serialized, size);
-  EXPECT_EQ(params.expected, serialized_hex);
+  if (!params.expected.empty()) {
+    EXPECT_EQ(params.expected, serialized_hex);
+  }
 
   ProtocolReader reader(msg.type_, evbuf.get(), write_count, params.proto);
   std::unique_ptr<Message> deserialized_msg_base =
       GOSSIP_Message::deserialize(reader).msg;
-  ASSERT_NE(nullptr, deserialized_msg_base);
+  EXPECT_NE(nullptr, deserialized_msg_base);
+  if (deserialized_msg_base == nullptr) {
+    return size;
+  }
 
   auto deserialized_msg =
       static_cast<GOSSIP_Message*>(deserialized_msg_base.get());
@@ -240,6 +252,7 @@ void serializeAndDeserializeTest(Params params) {
                 rsm_types,
                 deserialized_msg->rsm_types_,
                 flags);
+  return size;
 }
 } // namespace
 
@@ -367,3 +380,33 @@ TEST(GOSSIP_MessageTest, SerializeAndDeserializeWithVersions) {
     serializeAndDeserializeTest(params);
   }
 }
+
+TEST(GOSSIP_MessageTest, SerializeAndDeserializeCompact) {
+  for (bool with_versions : {false, true}) {
+    Params params{Compatibility::MAX_PROTOCOL_SUPPORTED};
+    params.with_failover = true;
+    params.with_starting = true;
+    params.with_health_status = true;
+    params.with_versions = with_versions;
+    size_t full_size = serializeAndDeserializeTest(params);
+
+    params.compact = true;
+    size_t compact_size = serializeAndDeserializeTest(params);
+    EXPECT_LT(compact_size, full_size);
+  }
+
+  // Peers that don't support the compact encoding get the regular one.
+  Params params{Compatibility::COMPACT_GOSSIP_ENCODING - 1};
+  params.with_versions = true;
+  params.compact = true;
+  params.expected =
+      "0200000001002001000000000000000100000000000000000000000000000000000000"
+      "0000000000010000000000000005000000000000000000000000000000000000000000"
+      "0000010000000000000002000000000000000A00000000000000000000000000000001"
+      "0000000000000003FBFFFFFFFFFFFF3FFDFFFFFFFFFFFF3FFFFFFFFFFFFFFF3F000000"
+      "0000000000010000000000000002000000000000000300000000000000650000000000"
+      "0000660000000000000067000000000000000100000000000000040000000000000005"
+      "000000000000000600000000000000680000000000000069000000000000006A000000"
+      "00000000";
+  serializeAndDeserializeTest(params);
+}
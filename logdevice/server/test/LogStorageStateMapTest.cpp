@@ -8,6 +8,7 @@
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 
 #include <deque>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -102,6 +103,56 @@ TEST(LogStorageStateMapTest, StressTestLSNUpdating) {
   }
 }
 
+/**
+ * Many threads insert and look up overlapping sets of logs, enough of them
+ * for the tables to grow several times while they do. Every thread must get
+ * the same state for a given log, and iteration must see every log once.
+ */
+TEST(LogStorageStateMapTest, ConcurrentInsertAndGrow) {
+  const int nthreads = 16;
+  // A power of two, so that multiplying by an odd number permutes the logs.
+  const logid_t::raw_type nlogs = 1 << 14;
+  LogStorageStateMap map(2, /*stats*/ nullptr, /*record cache*/ false);
+
+  std::vector<std::vector<LogStorageState*>> seen(nthreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&, i] {
+      for (logid_t::raw_type log = 1; log <= nlogs; ++log) {
+        // Each thread goes through the logs in a different order.
+        logid_t log_id((log * (2 * i + 1)) % nlogs + 1);
+        shard_index_t shard = log_id.val() % 2;
+        LogStorageState* state = map.insertOrGet(log_id, shard);
+        ASSERT_NE(nullptr, state);
+        EXPECT_EQ(shard, state->getShardIdx());
+        EXPECT_EQ(state, map.find(log_id, shard));
+      }
+      for (logid_t::raw_type log = 1; log <= nlogs; ++log) {
+        seen[i].push_back(map.find(logid_t(log), 0));
+        seen[i].push_back(map.find(logid_t(log), 1));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int i = 1; i < nthreads; ++i) {
+    EXPECT_EQ(seen[0], seen[i]);
+  }
+
+  std::set<std::pair<shard_index_t, logid_t>> visited;
+  for (shard_index_t shard = 0; shard < 2; ++shard) {
+    map.forEachLogOnShard(shard, [&](logid_t log_id, const LogStorageState&) {
+      EXPECT_TRUE(visited.emplace(shard, log_id).second);
+      return 0;
+    });
+  }
+  EXPECT_EQ(nlogs, visited.size());
+
+  map.clear();
+  EXPECT_EQ(nullptr, map.find(logid_t(1), 0));
+}
+
 /**
  * Basic test for worker subscriptions.
  */
@@ -113,6 +164,7 @@ TEST(LogStorageStateMapTest, WorkerSubscriptions) {
   for (int i = 0; i < nworkers; ++i) {
     ASSERT_FALSE(log_state.isWorkerSubscribed(worker_id_t(i)));
   }
+  ASSERT_FALSE(log_state.hasSubscribedWorkers());
 
   const worker_id_t sub(4);
   log_state.subscribeWorker(sub);
@@ -124,9 +176,18 @@ TEST(LogStorageStateMapTest, WorkerSubscriptions) {
       ASSERT_FALSE(log_state.isWorkerSubscribed(id));
     }
   }
+  ASSERT_TRUE(log_state.hasSubscribedWorkers());
+
+  // subscriptions are idempotent
+  log_state.subscribeWorker(sub);
+  log_state.subscribeWorker(worker_id_t(2));
+  log_state.unsubscribeWorker(worker_id_t(2));
+  log_state.unsubscribeWorker(worker_id_t(2));
+  ASSERT_TRUE(log_state.hasSubscribedWorkers());
 
   log_state.unsubscribeWorker(sub);
   ASSERT_FALSE(log_state.isWorkerSubscribed(sub));
+  ASSERT_FALSE(log_state.hasSubscribedWorkers());
 }
 
 TEST(LogStorageStateMapTest, LastReleasedLSNSource) {
@@ -146,3 +207,24 @@ TEST(LogStorageStateMapTest, LastReleasedLSNSource) {
   EXPECT_EQ(
       LogStorageState::LastReleasedSource::RELEASE, released_state.source());
 }
+
+TEST(LogStorageStateMapTest, UnreleasedRecords) {
+  LogStorageStateMap map(2, /*stats*/ nullptr, /*record_cache*/ false);
+  LogStorageState* log1 = map.insertOrGet(logid_t(1), 0);
+  LogStorageState* log2 = map.insertOrGet(logid_t(2), 1);
+  using Logs = LogStorageStateMap::LogShardPairs;
+
+  // a log is reported once until the detector stops watching it
+  log1->noteUnreleasedRecordStored();
+  log1->noteUnreleasedRecordStored();
+  log2->noteUnreleasedRecordStored();
+  EXPECT_EQ((Logs{{logid_t(1), 0}, {logid_t(2), 1}}),
+            map.takeLogsWithUnreleasedRecords());
+  log1->noteUnreleasedRecordStored();
+  EXPECT_EQ(Logs(), map.takeLogsWithUnreleasedRecords());
+
+  log1->clearUnreleasedRecordsWatched();
+  log1->noteUnreleasedRecordStored();
+  log2->noteUnreleasedRecordStored();
+  EXPECT_EQ((Logs{{logid_t(1), 0}}), map.takeLogsWithUnreleasedRecords());
+}
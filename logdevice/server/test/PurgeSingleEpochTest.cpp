@@ -309,3 +309,43 @@ TEST_F(PurgeSingleEpochTest, DeleteRecordsByReadingData) {
   ASSERT_EQ(0, stats.get().purging_v2_delete_by_keys);
   ASSERT_EQ(1, stats.get().purging_v2_delete_by_reading_data);
 }
+
+// Deletes of several logs and epochs executed as one batched task
+TEST_F(PurgeSingleEpochTest, DeleteRecordsBatched) {
+  TemporaryRocksDBStore store;
+  StatsHolder stats(StatsParams().setIsServer(true));
+  const logid_t other_log(LOG_ID.val_ + 1);
+
+  std::vector<TestRecord> test_data = {
+      TestRecord(LOG_ID, lsn(1, 2), esn_t(1)),
+      TestRecord(LOG_ID, lsn(2, 2), esn_t(1)),
+      TestRecord(LOG_ID, lsn(2, 3988765544), esn_t(225)),
+      TestRecord(LOG_ID, lsn(3, 1), esn_t(0)),
+      TestRecord(LOG_ID, lsn(3, 3988765544), esn_t(0)),
+      TestRecord(LOG_ID, lsn(4, 1), esn_t(0)),
+
+      TestRecord(other_log, lsn(1, 1), esn_t(0)),
+      TestRecord(other_log, lsn(1, 5), esn_t(0)),
+  };
+  store_fill(store, test_data);
+
+  auto make_task = [](logid_t log_id, epoch_t epoch, esn_t start, esn_t end) {
+    return std::make_unique<PurgeDeleteRecordsStorageTask>(
+        log_id, epoch, start, end, WeakRef<PurgeSingleEpoch>());
+  };
+  auto task = make_task(other_log, epoch_t(1), esn_t(2), esn_t(10));
+  // out of order on purpose, the batch reads each log in order with a single
+  // iterator
+  task->addToBatch(make_task(LOG_ID, epoch_t(3), esn_t(2), ESN_MAX));
+  task->addToBatch(make_task(LOG_ID, epoch_t(2), esn_t(3), ESN_MAX));
+  ASSERT_EQ(3, task->batchSize());
+  task->executeImpl(store, &stats, nullptr);
+  EXPECT_EQ(E::OK, task->getStatus());
+
+  EXPECT_EQ(std::vector<lsn_t>({lsn(1, 2), lsn(2, 2), lsn(3, 1), lsn(4, 1)}),
+            getLsnsForLog(LOG_ID, store));
+  EXPECT_EQ(std::vector<lsn_t>({lsn(1, 1)}), getLsnsForLog(other_log, store));
+  EXPECT_EQ(1, stats.get().purging_v2_delete_by_keys);
+  EXPECT_EQ(2, stats.get().purging_v2_delete_by_reading_data);
+  EXPECT_EQ(3, stats.get().purging_delete_done);
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/ReadBatchSizeController.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace std::chrono_literals;
+
+namespace {
+
+const size_t kMin = 1000;
+const size_t kMax = 1000000;
+
+// Queues and drains `chunks` chunks of `chunk` bytes, one every `interval`.
+ReadBatchSizeController::Clock::time_point
+drain(ReadBatchSizeController& c,
+      ReadBatchSizeController::Clock::time_point now,
+      size_t chunk,
+      int chunks,
+      std::chrono::milliseconds interval) {
+  c.onBytesQueued(chunk * chunks, now);
+  for (int i = 0; i < chunks; ++i) {
+    now += interval;
+    c.onBytesDrained(chunk, now);
+  }
+  return now;
+}
+
+} // namespace
+
+TEST(ReadBatchSizeControllerTest, MaxUntilMeasured) {
+  ReadBatchSizeController c;
+  EXPECT_FALSE(c.getDrainRate().hasValue());
+  EXPECT_EQ(kMax, c.getBatchBytes(kMin, kMax, 100ms));
+  EXPECT_EQ(kMax, c.getLastBatchBytes());
+}
+
+TEST(ReadBatchSizeControllerTest, SlowConsumer) {
+  ReadBatchSizeController c;
+  auto now = ReadBatchSizeController::Clock::now();
+  // 10 KB every 10ms: 1 MB/s.
+  now = drain(c, now, 10000, 20, 10ms);
+  ASSERT_TRUE(c.getDrainRate().hasValue());
+  EXPECT_NEAR(1e6, c.getDrainRate().value(), 1e3);
+  EXPECT_EQ(0, c.getPendingBytes());
+
+  // 100ms worth of data at 1 MB/s.
+  EXPECT_NEAR(100000, c.getBatchBytes(kMin, kMax, 100ms), 100);
+
+  // Bytes still pending count towards the target.
+  c.onBytesQueued(60000, now);
+  EXPECT_NEAR(40000, c.getBatchBytes(kMin, kMax, 100ms), 100);
+  c.onBytesQueued(60000, now);
+  EXPECT_EQ(kMin, c.getBatchBytes(kMin, kMax, 100ms));
+}
+
+TEST(ReadBatchSizeControllerTest, FastConsumer) {
+  ReadBatchSizeController c;
+  auto now = ReadBatchSizeController::Clock::now();
+  // 1 MB every 10ms: 100 MB/s.
+  drain(c, now, 1000000, 20, 10ms);
+  EXPECT_EQ(kMax, c.getBatchBytes(kMin, kMax, 100ms));
+}
+
+TEST(ReadBatchSizeControllerTest, IdleTimeIgnored) {
+  ReadBatchSizeController c;
+  auto now = ReadBatchSizeController::Clock::now();
+  now = drain(c, now, 10000, 5, 10ms);
+  // Nothing pending for a long time, then more data.
+  now += 10s;
+  drain(c, now, 10000, 15, 10ms);
+  ASSERT_TRUE(c.getDrainRate().hasValue());
+  EXPECT_NEAR(1e6, c.getDrainRate().value(), 1e3);
+}
+
+TEST(ReadBatchSizeControllerTest, RateAdapts) {
+  ReadBatchSizeController c;
+  auto now = ReadBatchSizeController::Clock::now();
+  now = drain(c, now, 10000, 20, 10ms);
+  const double slow = c.getDrainRate().value();
+  for (int i = 0; i < 20; ++i) {
+    now = drain(c, now, 100000, 10, 10ms);
+  }
+  EXPECT_GT(c.getDrainRate().value(), slow * 9);
+}
@@ -145,6 +145,18 @@ class MockedShardRebuilding : public ShardRebuildingInterface {
   void start(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan)
       override;
 
+  void expectMoreLogs() override {
+    more_logs_expected = true;
+  }
+
+  void
+  addLogs(std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan,
+          bool last) override {
+    ld_check(more_logs_expected);
+    num_logs += plan.size();
+    more_logs_expected = !last;
+  }
+
   virtual void advanceGlobalWindow(RecordTimestamp new_window_end) override {
     global_window = new_window_end;
   }
@@ -161,6 +173,8 @@ class MockedShardRebuilding : public ShardRebuildingInterface {
   const lsn_t restart_version;
   const RebuildingSet rebuilding_set;
   RecordTimestamp global_window = RecordTimestamp::min();
+  size_t num_logs = 0;
+  bool more_logs_expected = false;
 };
 
 class MockMaintenanceLogWriter : public MaintenanceLogWriter {
@@ -418,6 +432,7 @@ void MockedShardRebuilding::start(
     std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan) {
   ld_check(!owner->shardRebuildings.count(shard));
   owner->shardRebuildings[shard] = this;
+  num_logs = plan.size();
 }
 MockedShardRebuilding::~MockedShardRebuilding() {
   ld_check(owner->shardRebuildings.at(shard) == this);
@@ -845,6 +860,37 @@ TEST_F(RebuildingCoordinatorTest, NoLogsToRebuild) {
   ASSERT_SHARD_REBUILT(6, version);
 }
 
+// With rebuilding-planning-batch-logs, ShardRebuilding is started as soon as
+// the first batch of logs is planned and gets the rest as they are planned.
+TEST_F(RebuildingCoordinatorTest, IncrementalPlanning) {
+  settings.planning_batch_logs = 2;
+  start();
+
+  // We rebuild shard 1 of node 2. Logs 1, 3, 5, 7, 9 are on that shard.
+  lsn_t version = onShardNeedsRebuild(2, 1, 0 /* flags */, folly::none);
+
+  onRetrievedPlanForLog(1, 1, LSN_MAX, version);
+  EXPECT_EQ(0, coordinator_->shardRebuildings.count(1));
+  onRetrievedPlanForLog(3, 1, LSN_MAX, version);
+  EXPECT_EQ(2, getShard(1)->num_logs);
+  EXPECT_TRUE(getShard(1)->more_logs_expected);
+
+  onRetrievedPlanForLog(5, 1, LSN_MAX, version);
+  EXPECT_EQ(2, getShard(1)->num_logs);
+  onRetrievedPlanForLog(7, 1, LSN_MAX, version);
+  EXPECT_EQ(4, getShard(1)->num_logs);
+  EXPECT_TRUE(getShard(1)->more_logs_expected);
+
+  onRetrievedPlanForLog(9, 1, LSN_MAX, version);
+  onFinishedRetrievingPlans(1);
+  EXPECT_EQ(5, getShard(1)->num_logs);
+  EXPECT_FALSE(getShard(1)->more_logs_expected);
+  ASSERT_NO_SHARD_REBUILT();
+
+  coordinator_->onShardRebuildingComplete(1);
+  ASSERT_SHARD_REBUILT(1, version);
+}
+
 // All logs are rebuilt at the same time and there is a global timestamp window.
 TEST_F(RebuildingCoordinatorTest, GlobalWindow1) {
   settings.global_window = std::chrono::seconds(30);
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 
+#include "logdevice/common/Checksum.h"
 #include "logdevice/common/settings/SettingsUpdater.h"
 #include "logdevice/common/test/NodeSetTestUtil.h"
 #include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
@@ -69,6 +70,9 @@ class RebuildingReadStorageTaskTest : public ::testing::TestWithParam<bool> {
     StatsHolder* getStats() override {
       return &test->stats;
     }
+    bool storeVerifiesChecksums() override {
+      return test->store->verifiesChecksumsOnWriteAndRead();
+    }
   };
 
   RebuildingReadStorageTaskTest() {
@@ -608,6 +612,94 @@ TEST_P(RebuildingReadStorageTaskTest, TimeRanges) {
                                                {L2, mklsn(2, 3)}}),
                 convertChunks(chunks));
     }
+    // Log 1 in partitions 2 and 3, and log 2 in partition 3, were skipped
+    // without reading their records: none of the shards in their nodesets
+    // are dirty in those partitions' time ranges.
+    EXPECT_EQ(3, stats.aggregate().rebuilding_record_ranges_skipped_clean);
+  }
+}
+
+TEST_P(RebuildingReadStorageTaskTest, ChecksumVerification) {
+  logid_t L1(1), L2(2);
+  auto& P = partition_start;
+  ReplicationProperty R({{NodeLocationScope::NODE, 3}});
+  StorageSet all_nodes{N0, N1, N2, N3, N4, N5, N6, N7, N8, N9};
+
+  auto rebuilding_set = std::make_shared<RebuildingSet>();
+  rebuilding_set->shards.emplace(
+      ShardID(2, 0), RebuildingNodeInfo(RebuildingMode::RESTORE));
+
+  // Records with 32-bit checksums prefixed to their payloads.
+  auto put = [&](logid_t log, lsn_t lsn) {
+    std::string payload = "payload" + lsn_to_string(lsn);
+    char buf[8];
+    Slice checksum =
+        checksum_bytes(Slice(payload.data(), payload.size()), 32, buf);
+    payload = std::string((const char*)checksum.data, checksum.size) + payload;
+    store->putRecord(log,
+                     lsn,
+                     P[0] + MINUTE,
+                     {N1, N2, N3},
+                     LocalLogStoreRecordFormat::FLAG_CHECKSUM,
+                     Slice::fromString(payload));
+  };
+  put(L1, mklsn(1, 1));
+  put(L1, mklsn(1, 2));
+  put(L2, mklsn(1, 1));
+
+  // Reads everything and returns the chunks.
+  auto read_all = [&] {
+    auto c = createContext(rebuilding_set);
+    for (logid_t log : {L1, L2}) {
+      c->logs[log].plan.untilLSN = LSN_MAX;
+      c->logs[log].plan.addEpochRange(
+          EPOCH_INVALID,
+          EPOCH_MAX,
+          std::make_shared<EpochMetaData>(all_nodes, R));
+    }
+    std::vector<std::unique_ptr<ChunkData>> res;
+    while (!c->reachedEnd) {
+      MockRebuildingReadStorageTask task(this, c);
+      task.execute();
+      task.onDone();
+      EXPECT_FALSE(c->persistentError);
+      for (auto& chunk : chunks) {
+        res.push_back(std::move(chunk));
+      }
+      chunks.clear();
+    }
+    EXPECT_EQ(2, res.size());
+    return res;
+  };
+
+  setRebuildingSettings({{"rebuilding-checksum-verification", "per-record"}});
+  for (auto& chunk : read_all()) {
+    EXPECT_FALSE(chunk->checksumsVerified);
+  }
+
+  setRebuildingSettings(
+      {{"rebuilding-checksum-verification", "skip-if-verified-on-store"}});
+  for (auto& chunk : read_all()) {
+    EXPECT_EQ(store->verifiesChecksumsOnWriteAndRead(),
+              chunk->checksumsVerified);
+  }
+
+  setRebuildingSettings({{"rebuilding-checksum-verification", "batch"}});
+  auto res = read_all();
+  for (auto& chunk : res) {
+    EXPECT_TRUE(chunk->checksumsVerified);
+  }
+
+  // Corrupt the payload of the log 2 record. Only its chunk fails
+  // verification.
+  for (auto& chunk : res) {
+    if (chunk->address.log == L2) {
+      chunk->buffer.writableData()[chunk->buffer.length() - 1] ^= 1;
+    }
+  }
+  RebuildingReadStorageTask::verifyChecksumsInBatch(res);
+  for (auto& chunk : res) {
+    EXPECT_EQ(chunk->address.log == L1, chunk->checksumsVerified);
   }
 }
 
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/rebuilding/RebuildingThroughputController.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/settings/RebuildingSettings.h"
+#include "logdevice/common/settings/util.h"
+
+using namespace facebook::logdevice;
+using namespace std::literals::chrono_literals;
+
+namespace {
+
+using Controller = RebuildingThroughputController;
+
+class RebuildingThroughputControllerTest : public ::testing::Test {
+ public:
+  RebuildingThroughputControllerTest()
+      : settings(create_default_settings<RebuildingSettings>()) {
+    settings.autotune_append_latency_p99 = 100ms;
+    settings.autotune_store_latency_p99 = 20ms;
+    settings.autotune_max_scale = 2;
+  }
+
+  // Adds enough samples of the given latency to count for the next update.
+  static void addSamples(LatencyHistogram& hist,
+                         std::chrono::microseconds latency) {
+    for (uint64_t i = 0; i < Controller::kMinSamples; ++i) {
+      hist.add(latency.count());
+    }
+  }
+
+  double update() {
+    return controller.update(append, store, settings);
+  }
+
+  RebuildingSettings settings;
+  LatencyHistogram append;
+  LatencyHistogram store;
+  Controller controller;
+};
+
+} // namespace
+
+TEST_F(RebuildingThroughputControllerTest, RaisesWhileBelowTargets) {
+  addSamples(append, 5ms);
+  // First update only takes a snapshot.
+  EXPECT_EQ(1.0, update());
+
+  addSamples(append, 5ms);
+  addSamples(store, 1ms);
+  EXPECT_EQ(1 + Controller::kScaleIncrease, update());
+  // No traffic at all also counts as below target.
+  EXPECT_EQ(1 + Controller::kScaleIncrease * 2, update());
+  for (int i = 0; i < 10; ++i) {
+    update();
+  }
+  EXPECT_EQ(settings.autotune_max_scale, controller.scale());
+}
+
+TEST_F(RebuildingThroughputControllerTest, BacksOffAboveTarget) {
+  update();
+  for (int i = 0; i < 4; ++i) {
+    update();
+  }
+  EXPECT_EQ(2.0, controller.scale());
+
+  // Slow stores on the donor shard.
+  addSamples(store, 50ms);
+  EXPECT_EQ(1.0, update());
+  // Slow appends.
+  addSamples(append, 500ms);
+  EXPECT_EQ(0.5, update());
+  for (int i = 0; i < 10; ++i) {
+    addSamples(append, 500ms);
+    update();
+  }
+  EXPECT_EQ(Controller::kMinScale, controller.scale());
+
+  // Old slow appends don't count once they're out of the window.
+  addSamples(append, 5ms);
+  EXPECT_EQ(Controller::kMinScale + Controller::kScaleIncrease, update());
+}
+
+TEST_F(RebuildingThroughputControllerTest, IgnoresFewSamples) {
+  update();
+  append.add(std::chrono::microseconds(1s).count());
+  EXPECT_EQ(1 + Controller::kScaleIncrease, update());
+}
+
+TEST_F(RebuildingThroughputControllerTest, Reset) {
+  update();
+  addSamples(store, 50ms);
+  EXPECT_EQ(0.5, update());
+  controller.reset();
+  EXPECT_EQ(1.0, controller.scale());
+  // The next update is a snapshot again.
+  addSamples(store, 50ms);
+  EXPECT_EQ(1.0, update());
+}
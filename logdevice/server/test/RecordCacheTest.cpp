@@ -2189,3 +2189,33 @@ TEST_F(RecordCacheTest, SequencingSizeCalculation) {
   ASSERT_NE(linear_size, -1);
   ASSERT_EQ(calculated_size, linear_size);
 }
+
+// Entries allocated from an arena stay valid after the arena is gone and can
+// be freed in any order, from any thread.
+TEST(EpochRecordCacheEntryArenaTest, EntriesOutliveArena) {
+  std::vector<std::unique_ptr<Entry>> entries;
+  {
+    Entry::Arena arena;
+    for (lsn_t lsn = 1; lsn <= 3 * Entry::Arena::kMaxSlotsPerSlab; ++lsn) {
+      entries.emplace_back(new (arena) Entry(lsn,
+                                             STORE_flags_t(0),
+                                             0,
+                                             ESN_INVALID,
+                                             1,
+                                             copyset_t{ShardID(1, 0)},
+                                             OffsetMap(),
+                                             KeysType(),
+                                             createPayload(lsn)));
+    }
+  }
+  std::thread([&] {
+    for (size_t i = 0; i < entries.size(); i += 2) {
+      entries[i].reset();
+    }
+  }).join();
+  for (size_t i = 1; i < entries.size(); i += 2) {
+    ASSERT_EQ(lsn_t(i + 1), entries[i]->lsn);
+    ASSERT_EQ(sizeof(lsn_t), entries[i]->payload.size());
+  }
+  entries.clear();
+}
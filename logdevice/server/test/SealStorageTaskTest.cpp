@@ -544,4 +544,56 @@ TEST(SealStorageTaskTest, RetrySealingAndDurability) {
   }
 }
 
+// Seals of several logs written in one batch, including two seals of the same
+// log.
+TEST(SealStorageTaskTest, BatchedSeals) {
+  TemporaryRocksDBStore store;
+  LogStorageStateMap map(1, /*stats*/ nullptr, /*record_cache*/ false);
+
+  // local log store already contains a seal record with epoch 5 for log 2
+  store.writeLogMetadata(logid_t(2),
+                         SealMetadata(Seal(epoch_t(5), NodeID(0, 1))),
+                         LocalLogStore::WriteOptions());
+
+  auto make_task = [](logid_t log_id, epoch_t seal_epoch) {
+    return std::make_unique<TestSealStorageTask>(log_id,
+                                                 EPOCH_INVALID,
+                                                 Seal(seal_epoch, NodeID(0, 1)),
+                                                 Address(NodeID()),
+                                                 false);
+  };
+  auto leader = make_task(logid_t(1), epoch_t(2));
+  std::vector<TestSealStorageTask*> tasks{leader.get()};
+  for (auto p : {std::make_pair(logid_t(2), epoch_t(3)),
+                 std::make_pair(logid_t(3), epoch_t(4)),
+                 // preempted by the leader's seal within the same batch
+                 std::make_pair(logid_t(1), epoch_t(1))}) {
+    auto task = make_task(p.first, p.second);
+    tasks.push_back(task.get());
+    leader->addToBatch(std::move(task));
+  }
+  ASSERT_EQ(4, leader->batchSize());
+
+  leader->executeBatch(store, map);
+  EXPECT_EQ(E::OK, tasks[0]->getStatus());
+  EXPECT_EQ(E::PREEMPTED, tasks[1]->getStatus());
+  EXPECT_EQ(epoch_t(5), tasks[1]->getSeal().epoch);
+  EXPECT_EQ(E::OK, tasks[2]->getStatus());
+  EXPECT_EQ(E::PREEMPTED, tasks[3]->getStatus());
+  EXPECT_EQ(epoch_t(2), tasks[3]->getSeal().epoch);
+  ASSERT_EQ(Durability::SYNC_WRITE, leader->durability());
+
+  for (auto p : {std::make_pair(logid_t(1), epoch_t(2)),
+                 std::make_pair(logid_t(2), epoch_t(5)),
+                 std::make_pair(logid_t(3), epoch_t(4))}) {
+    SealMetadata metadata;
+    ASSERT_EQ(0, store.readLogMetadata(p.first, &metadata));
+    EXPECT_EQ(p.second, metadata.seal_.epoch);
+    folly::Optional<Seal> seal =
+        map.get(p.first, SHARD_IDX).getSeal(LogStorageState::SealType::NORMAL);
+    ASSERT_TRUE(seal.has_value());
+    EXPECT_EQ(p.second, seal.value().epoch);
+  }
+}
+
 }} // namespace facebook::logdevice
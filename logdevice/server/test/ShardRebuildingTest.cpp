@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/rebuilding/ShardRebuilding.h"
 
+#include <set>
+
 #include <gtest/gtest.h>
 
 #include "logdevice/common/settings/SettingsUpdater.h"
@@ -31,6 +33,9 @@ class MockedShardRebuilding : public ShardRebuilding,
   };
 
   StatsHolder stats;
+  // Read streams with a storage task in flight.
+  std::set<size_t> streamsInFlight;
+  // True if any read stream has a storage task in flight.
   bool taskInFlight = false;
   bool waitingForGlobalWindow = false;
   bool completed = false;
@@ -116,8 +121,9 @@ class MockedShardRebuilding : public ShardRebuilding,
         ChunkInfo{.id = chunk_id, .data = std::move(chunk), .worker = worker});
     return worker;
   }
-  void putStorageTask() override {
-    EXPECT_FALSE(taskInFlight);
+  void putStorageTask(size_t stream_idx) override {
+    EXPECT_EQ(0, streamsInFlight.count(stream_idx));
+    streamsInFlight.insert(stream_idx);
     taskInFlight = true;
   }
 
@@ -148,28 +154,42 @@ class MockedShardRebuilding : public ShardRebuilding,
   }
 
   void simulateReadTaskDone(std::vector<ChunkData*> chunks,
-                            bool reached_end = false) {
-    ld_check(taskInFlight);
-    taskInFlight = false;
-
-    ld_check(!readContext_->reachedEnd);
-    readContext_->reachedEnd = reached_end;
+                            bool reached_end = false,
+                            size_t stream_idx = 0) {
+    ld_check(streamsInFlight.count(stream_idx));
+    streamsInFlight.erase(stream_idx);
+    taskInFlight = !streamsInFlight.empty();
+
+    auto& context = *readStreams_.at(stream_idx).context;
+    ld_check(!context.reachedEnd);
+    context.reachedEnd = reached_end;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone(
+    context.onDone(
         std::vector<std::unique_ptr<ChunkData>>(chunks.begin(), chunks.end()));
     globalWindowWaitingMayHaveChanged(before);
   }
 
-  void simulatePersistentError() {
-    ld_check(taskInFlight);
-    taskInFlight = false;
+  void simulatePersistentError(size_t stream_idx = 0) {
+    ld_check(streamsInFlight.count(stream_idx));
+    streamsInFlight.erase(stream_idx);
+    taskInFlight = !streamsInFlight.empty();
 
-    readContext_->persistentError = true;
+    auto& context = *readStreams_.at(stream_idx).context;
+    context.persistentError = true;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone({});
+    context.onDone({});
     globalWindowWaitingMayHaveChanged(before);
   }
 
+  // Logs assigned to the given read stream.
+  std::set<logid_t> streamLogs(size_t stream_idx) const {
+    std::set<logid_t> logs;
+    for (const auto& p : readStreams_.at(stream_idx).context->logs) {
+      logs.insert(p.first);
+    }
+    return logs;
+  }
+
   // idx is index in chunkRebuildings.
   void simulateChunkRebuildingDone(size_t idx) {
     auto before = SteadyTimestamp::now();
@@ -238,7 +258,7 @@ ChunkData* makeChunk(logid_t log,
 TEST_P(ShardRebuildingTest, Basic) {
   MockedShardRebuilding reb(rebuildingSettings_);
   // ShardRebuilding doesn't directly use rebuilding plan, it just passes it to
-  // readContext_. So we can pass an empty plan.
+  // the read contexts. So we can pass an empty plan.
   reb.start({});
   EXPECT_TRUE(reb.taskInFlight);
   EXPECT_EQ(0, reb.chunkRebuildings.size());
@@ -452,6 +472,90 @@ TEST_P(ShardRebuildingTest, PersistentError) {
   EXPECT_FALSE(reb.completed);
 }
 
+TEST_P(ShardRebuildingTest, MultipleReadStreams) {
+  rebuildingSettingsUpdater_.setFromCLI({{"rebuilding-read-streams", "2"}});
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan;
+  for (logid_t::raw_type log = 1; log <= 4; ++log) {
+    plan[logid_t(log)] = std::make_unique<RebuildingPlan>();
+  }
+  reb.start(std::move(plan));
+
+  // Logs are split between the streams, and both streams are reading.
+  EXPECT_EQ(std::set<logid_t>({logid_t(2), logid_t(4)}), reb.streamLogs(0));
+  EXPECT_EQ(std::set<logid_t>({logid_t(1), logid_t(3)}), reb.streamLogs(1));
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.streamsInFlight);
+
+  // Second stream reads a chunk and gets another task.
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(1), 100, 101, 10, BASE_TIME)}, false, 1);
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.streamsInFlight);
+  ASSERT_EQ(1, reb.chunkRebuildings.size());
+  EXPECT_DONOR_PROGRESS(BASE_TIME);
+
+  // First stream is done, but the second one isn't.
+  reb.simulateReadTaskDone({}, true, 0);
+  EXPECT_EQ(std::set<size_t>({1}), reb.streamsInFlight);
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_FALSE(reb.completed);
+  reb.donorProgress.clear();
+
+  // Second stream reads its last chunk.
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(3), 200, 200, 10, BASE_TIME)}, true, 1);
+  EXPECT_FALSE(reb.taskInFlight);
+  ASSERT_EQ(1, reb.chunkRebuildings.size());
+  EXPECT_FALSE(reb.completed);
+
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_TRUE(reb.completed);
+}
+
+TEST_P(ShardRebuildingTest, AddLogs) {
+  MockedShardRebuilding reb(rebuildingSettings_);
+  std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan;
+  plan[logid_t(1)] = std::make_unique<RebuildingPlan>();
+  plan[logid_t(2)] = std::make_unique<RebuildingPlan>();
+  reb.expectMoreLogs();
+  reb.start(std::move(plan));
+  EXPECT_EQ(std::set<size_t>({0}), reb.streamsInFlight);
+
+  // Reading the first batch is done, but more logs are still being planned.
+  reb.simulateReadTaskDone({}, true, 0);
+  EXPECT_FALSE(reb.taskInFlight);
+  EXPECT_FALSE(reb.completed);
+
+  // Each batch gets its own stream.
+  plan.clear();
+  plan[logid_t(3)] = std::make_unique<RebuildingPlan>();
+  plan[logid_t(4)] = std::make_unique<RebuildingPlan>();
+  reb.addLogs(std::move(plan), /* last */ false);
+  EXPECT_EQ(std::set<logid_t>({logid_t(3), logid_t(4)}), reb.streamLogs(1));
+  EXPECT_EQ(std::set<size_t>({1}), reb.streamsInFlight);
+
+  // Only rebuilding-read-streams streams read at the same time.
+  plan.clear();
+  plan[logid_t(5)] = std::make_unique<RebuildingPlan>();
+  reb.addLogs(std::move(plan), /* last */ false);
+  EXPECT_EQ(std::set<logid_t>({logid_t(5)}), reb.streamLogs(2));
+  EXPECT_EQ(std::set<size_t>({1}), reb.streamsInFlight);
+
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(3), 100, 101, 10, BASE_TIME)}, true, 1);
+  EXPECT_EQ(std::set<size_t>({2}), reb.streamsInFlight);
+  ASSERT_EQ(1, reb.chunkRebuildings.size());
+  reb.donorProgress.clear();
+
+  // Planning is done.
+  reb.addLogs({}, /* last */ true);
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_FALSE(reb.completed);
+  reb.simulateReadTaskDone({}, true, 2);
+  EXPECT_FALSE(reb.taskInFlight);
+  EXPECT_TRUE(reb.completed);
+}
+
 TEST_P(ShardRebuildingTest, TestStallRebuilding) {
   rebuildingSettingsUpdater_.setFromCLI({{"test-stall-rebuilding", "true"}});
 
@@ -8,6 +8,8 @@
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
 
 #include <atomic>
+#include <thread>
+#include <vector>
 
 #include <folly/Memory.h>
 #include <folly/synchronization/Baton.h>
@@ -98,15 +100,19 @@ class MockWriteStorageTask : public WriteStorageTask {
 /**
  * Spins up storage thread pool, has it do some trivial tasks, verifies that
  * the pool can cleanly shut down. The seconds iteration drives the DRR
- * scheduler code path.
+ * scheduler code path; the third one puts tasks into the DRR scheduler from
+ * several threads, some of them through injection lanes.
  */
 TEST(StorageThreadPoolTest, Basic) {
-  for (int testIter = 0; testIter < 2; testIter++) {
+  for (int testIter = 0; testIter < 3; testIter++) {
     ld_info("starting test iter %d", testIter);
     Settings init_settings = create_default_settings<Settings>();
-    if (testIter == 1) {
+    if (testIter >= 1) {
       init_settings.storage_tasks_use_drr = true;
     }
+    if (testIter == 2) {
+      init_settings.storage_tasks_drr_injection_lanes = 2;
+    }
     UpdateableSettings<Settings> settings(init_settings);
     ServerSettings init_server_settings =
         create_default_settings<ServerSettings>();
@@ -123,11 +129,25 @@ TEST(StorageThreadPoolTest, Basic) {
         0, 1, params, server_settings, settings, &store, task_queue_slots);
 
     Semaphore sem;
-    for (int i = 0; i < ntasks; ++i) {
-      bool ret =
-          pool->blockingPutTask(std::make_unique<SimpleStorageTask>(&sem));
-      ASSERT_TRUE(ret);
+    // More producer threads than lanes, so some of them fall back to the
+    // scheduler mutex.
+    const int nproducers = testIter == 2 ? 4 : 1;
+    std::vector<std::thread> producers;
+    std::atomic<int> failed_puts{0};
+    for (int p = 0; p < nproducers; ++p) {
+      producers.emplace_back([&] {
+        for (int i = 0; i < ntasks / nproducers; ++i) {
+          if (!pool->blockingPutTask(
+                  std::make_unique<SimpleStorageTask>(&sem))) {
+            ++failed_puts;
+          }
+        }
+      });
     }
+    for (auto& t : producers) {
+      t.join();
+    }
+    ASSERT_EQ(0, failed_puts.load());
     // Wait until all tasks have finished
     for (int i = 0; i < ntasks; ++i) {
       sem.wait();
@@ -402,3 +422,82 @@ TEST(StorageThreadPoolTest, BatchLimits) {
     ASSERT_EQ(1, res.size());
   }
 }
+
+// With storage-tasks-steal-cpu-stages, the CPU stage of a task runs on an idle
+// storage thread of another shard, while execute() stays on the task's shard.
+TEST(StorageThreadPoolTest, StealCpuStages) {
+  class TwoStageTask : public StorageTask {
+   public:
+    TwoStageTask(StorageThreadPool** io_pool,
+                 StorageThreadPool** cpu_pool,
+                 Semaphore* sem)
+        : StorageTask(StorageTask::Type::UNKNOWN),
+          io_pool_(io_pool),
+          cpu_pool_(cpu_pool),
+          sem_(sem) {}
+
+    void execute() override {
+      *io_pool_ = &storageThread_->getThreadPool();
+    }
+    bool hasCpuStage() const override {
+      return true;
+    }
+    void executeCpuStage() override {
+      *cpu_pool_ = &storageThread_->getThreadPool();
+      sem_->post();
+    }
+    void onDone() override {}
+    void onDropped() override {
+      ld_check(false);
+    }
+
+   private:
+    StorageThreadPool** io_pool_;
+    StorageThreadPool** cpu_pool_;
+    Semaphore* sem_;
+  };
+
+  Settings init_settings = create_default_settings<Settings>();
+  init_settings.storage_tasks_steal_cpu_stages = true;
+  UpdateableSettings<Settings> settings(init_settings);
+  ServerSettings init_server_settings =
+      create_default_settings<ServerSettings>();
+  UpdateableSettings<ServerSettings> server_settings(init_server_settings);
+
+  Params params;
+  params[(size_t)StorageTaskThreadType::SLOW].nthreads = 1;
+  params[(size_t)StorageTaskThreadType::DEFAULT].nthreads = 1;
+
+  TemporaryRocksDBStore store0;
+  TemporaryRocksDBStore store1;
+  auto pool0 = std::make_unique<StorageThreadPool>(
+      0, 2, params, server_settings, settings, &store0, 16);
+  auto pool1 = std::make_unique<StorageThreadPool>(
+      1, 2, params, server_settings, settings, &store1, 16);
+  pool0->setPeers({pool1.get()});
+  pool1->setPeers({pool0.get()});
+
+  // pool1's thread may not be waiting for tasks yet when the first tasks
+  // finish their I/O stage, so retry until a CPU stage gets stolen.
+  bool stolen = false;
+  for (int attempt = 0; attempt < 100 && !stolen; ++attempt) {
+    StorageThreadPool* io_pool = nullptr;
+    StorageThreadPool* cpu_pool = nullptr;
+    Semaphore sem;
+    ASSERT_TRUE(pool0->blockingPutTask(
+        std::make_unique<TwoStageTask>(&io_pool, &cpu_pool, &sem)));
+    sem.wait();
+    EXPECT_EQ(pool0.get(), io_pool);
+    stolen = cpu_pool == pool1.get();
+    if (!stolen) {
+      EXPECT_EQ(pool0.get(), cpu_pool);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  EXPECT_TRUE(stolen);
+
+  pool0->shutDown();
+  pool1->shutDown();
+  pool0->join();
+  pool1->join();
+}
@@ -134,6 +134,10 @@ class MockWriteBatchStorageTask : public WriteBatchStorageTask {
     return 32768;
   }
 
+  std::chrono::microseconds getGroupCommitWindow() const override {
+    return std::chrono::microseconds(0);
+  }
+
   StatsHolder* stats() override {
     return &stats_;
   }
@@ -148,6 +148,45 @@ TEST(SyncingStorageThreadTest, BurstUndelayableTasks) {
   pool.reset();
 }
 
+/**
+ * Same as BurstUndelayableTasks but with sync coalescing enabled: waves of
+ * undelayable tasks still get synced well before ARRIVAL_TIMEOUT.
+ */
+TEST(SyncingStorageThreadTest, CoalescedUndelayableTasks) {
+  UpdateableSettings<Settings> settings;
+  ServerSettings init_server_settings =
+      create_default_settings<ServerSettings>();
+  init_server_settings.storage_thread_delaying_sync_interval =
+      std::chrono::milliseconds(TIMEOUT_MS);
+  init_server_settings.storage_thread_max_sync_coalescing_delay =
+      std::chrono::milliseconds(50);
+  UpdateableSettings<ServerSettings> server_settings(init_server_settings);
+
+  Params params;
+  params[(size_t)StorageTaskThreadType::SLOW].nthreads = 4;
+  const int task_queue_slots = 4;
+  const int ntasks = 16;
+  const int nwaves = 4;
+
+  TemporaryRocksDBStore store;
+  auto pool = std::make_unique<StorageThreadPool>(
+      0, 1, params, server_settings, settings, &store, task_queue_slots);
+
+  Semaphore sem;
+  for (int wave = 0; wave < nwaves; ++wave) {
+    for (int i = 0; i < ntasks; ++i) {
+      pool->enqueueForSync(std::make_unique<UndelayableStorageTask>(
+          &sem, 0, ARRIVAL_TIMEOUT_MS));
+    }
+    // Wait until all tasks of the wave have finished
+    for (int i = 0; i < ntasks; ++i) {
+      sem.wait();
+    }
+  }
+
+  pool.reset();
+}
+
 /**
  * Run thread, put some delayable tasks, then undelayable after some time,
  * wait for completion
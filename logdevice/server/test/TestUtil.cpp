@@ -21,6 +21,7 @@
 #include "logdevice/server/LogStoreMonitor.h"
 #include "logdevice/server/RebuildingCoordinator.h"
 #include "logdevice/server/RebuildingSupervisor.h"
+#include "logdevice/server/SequencerPreactivator.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
 #include "logdevice/server/shutdown.h"
@@ -128,6 +129,7 @@ void shutdown_test_server(std::shared_ptr<ServerProcessor>& processor) {
   std::unique_ptr<folly::EventBaseThread> ssl_connection_listener_loop;
   std::unique_ptr<folly::EventBaseThread> server_to_server_listener_loop;
   std::unique_ptr<LogStoreMonitor> logstore_monitor;
+  std::unique_ptr<SequencerPreactivator> sequencer_preactivator;
   std::unique_ptr<ShardedStorageThreadPool> storage_thread_pool;
   std::unique_ptr<ShardedRocksDBLocalLogStore> sharded_store;
   std::shared_ptr<SequencerPlacement> sequencer_placement;
@@ -148,6 +150,7 @@ void shutdown_test_server(std::shared_ptr<ServerProcessor>& processor) {
                   ssl_connection_listener_loop,
                   server_to_server_listener_loop,
                   logstore_monitor,
+                  sequencer_preactivator,
                   processor,
                   storage_thread_pool,
                   sharded_store,
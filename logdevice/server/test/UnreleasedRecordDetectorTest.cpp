@@ -374,6 +374,10 @@ bool UnreleasedRecordDetectorTest::waitUntilSequencerIsActive(
 void UnreleasedRecordDetectorTest::setHighestInsertedLSN(lsn_t lsn) {
   static_cast<TemporaryRocksDBStoreExt*>(sharded_store_->getByIndex(0))
       ->setHighestInsertedLSN(lsn);
+  // like StoreStorageTask does after writing a record
+  processor_->getLogStorageStateMap()
+      .insertOrGet(LOG_ID, 0)
+      ->noteUnreleasedRecordStored();
 }
 
 /**
@@ -945,3 +945,79 @@ TEST_F(ZookeeperEpochStoreTest, LastCleanEpochWithTailRecord) {
   ASSERT_EQ(0, rv);
   sem.wait();
 }
+
+TEST_F(ZookeeperEpochStoreTest, LastCleanEpochZnodeCache) {
+  StatsHolder stats(StatsParams().setIsServer(true));
+  Settings settings = create_default_settings<Settings>();
+  settings.server = true;
+  settings.zk_znode_cache_size = 100;
+  auto cached_processor =
+      make_test_processor(settings, config, &stats, NodeID(0, 1));
+  auto store = std::make_unique<ZookeeperEpochStore>(
+      TEST_CLUSTER,
+      cached_processor.get(),
+      config->updateableZookeeperConfig(),
+      config->updateableNodesConfiguration(),
+      cached_processor->updateableSettings(),
+      std::make_shared<ZookeeperClientInMemoryFactory>(getPrefillZnodes()));
+
+  Semaphore sem;
+  const logid_t logid(1);
+  const epoch_t initial_lce(3559930028);
+  auto tail = gen_tail_record(logid,
+                              compose_lsn(epoch_t(3429107), esn_t(43940088)),
+                              224433115,
+                              OffsetMap({{BYTE_OFFSET, 1103428925893352348}}));
+
+  // Reading the LCE caches the znode.
+  int rv = store->getLastCleanEpoch(
+      logid, [&](Status st, logid_t, epoch_t lce, TailRecord) {
+        EXPECT_EQ(E::OK, st);
+        EXPECT_EQ(initial_lce, lce);
+        sem.post();
+      });
+  ASSERT_EQ(0, rv);
+  sem.wait();
+
+  // So the update doesn't need to read it.
+  rv = store->setLastCleanEpoch(
+      logid,
+      epoch_t(initial_lce.val_ + 1),
+      tail,
+      [&](Status st, logid_t, epoch_t lce, TailRecord) {
+        EXPECT_EQ(E::OK, st);
+        EXPECT_EQ(epoch_t(initial_lce.val_ + 1), lce);
+        sem.post();
+      });
+  ASSERT_EQ(0, rv);
+  sem.wait();
+  EXPECT_EQ(1, stats.aggregate().zookeeper_epoch_store_znode_cache_hits);
+  EXPECT_EQ(0, stats.aggregate().zookeeper_epoch_store_znode_cache_stale);
+
+  // Another node advances the LCE behind our back.
+  const epoch_t other_lce(initial_lce.val_ + 10);
+  store->getZookeeperClient()->setData(
+      "/logdevice/epochstore_test/logs/1/lce",
+      std::to_string(other_lce.val_) + "@18446744073709551615@0@0",
+      [&](int rc, zk::Stat) {
+        EXPECT_EQ(ZOK, rc);
+        sem.post();
+      });
+  sem.wait();
+
+  // The cached value is outdated: the conditional write fails, and the
+  // update falls back to reading the znode, which makes it stale.
+  rv = store->setLastCleanEpoch(
+      logid,
+      epoch_t(initial_lce.val_ + 2),
+      tail,
+      [&](Status st, logid_t, epoch_t lce, TailRecord) {
+        EXPECT_EQ(E::STALE, st);
+        EXPECT_EQ(other_lce, lce);
+        sem.post();
+      });
+  ASSERT_EQ(0, rv);
+  sem.wait();
+  EXPECT_EQ(2, stats.aggregate().zookeeper_epoch_store_znode_cache_hits);
+  EXPECT_EQ(1, stats.aggregate().zookeeper_epoch_store_znode_cache_stale);
+}
@@ -0,0 +1,463 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <folly/Random.h>
+#include <folly/Singleton.h>
+#include <folly/String.h>
+#include <gflags/gflags.h>
+#include <rocksdb/statistics.h>
+
+#include "logdevice/common/LegacyLogToShard.h"
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/checks.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/settings/RebuildingSettings.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/SettingsUpdater.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/server/locallogstore/LocalLogStoreSettings.h"
+#include "logdevice/server/locallogstore/RocksDBCustomiser.h"
+#include "logdevice/server/locallogstore/RocksDBLogStoreBase.h"
+#include "logdevice/server/locallogstore/RocksDBSettings.h"
+#include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: Storage engine benchmark without a cluster: opens a
+ *        ShardedRocksDBLocalLogStore on a local path, writes to it through
+ *        LocalLogStore::writeMulti() and reads everything back through
+ *        LocalLogStore::ReadIterator, the way storage tasks do.
+ *
+ *        Write phase: one thread per shard writes --records records in
+ *        total, to --num-logs logs, in batches of --write-batch records.
+ *        Payload sizes are uniform in --payload-size * [1 - spread,
+ *        1 + spread]. A --rebuilding-fraction of the batches are written
+ *        the way rebuilding does it: records of an older epoch, in random
+ *        LSN order, with timestamps up to --rebuilding-age-s in the past.
+ *        Read phase: one thread per shard reads all of its logs from the
+ *        beginning, then does --random-seeks seeks to random records.
+ *
+ *        Settings of the store are given with --settings as a
+ *        comma-separated list of name=value, using the names of logdeviced
+ *        command line options, e.g. --settings=rocksdb-partition-duration=1min,
+ *        rocksdb-compression-type=lz4
+ *
+ *        Reports throughput of each phase, write amplification (bytes
+ *        written to the WAL, flushed and compacted by RocksDB over the bytes
+ *        given to writeMulti()) and latency percentiles of each operation.
+ */
+
+DEFINE_string(path,
+              "",
+              "Where to create the store. A temporary directory, deleted at "
+              "exit, if empty.");
+DEFINE_int32(num_shards, 1, "Number of shards, each written by a thread.");
+DEFINE_int32(num_logs, 1000, "Number of logs.");
+DEFINE_int64(records, 1000000, "Number of records to write.");
+DEFINE_int32(payload_size, 1000, "Average payload size, in bytes.");
+DEFINE_double(payload_size_spread,
+              0.5,
+              "Payload sizes are uniform in payload-size * [1 - spread, "
+              "1 + spread].");
+DEFINE_int32(write_batch, 1, "Number of records in each writeMulti() call.");
+DEFINE_double(rebuilding_fraction,
+              0.1,
+              "Fraction of batches written the way rebuilding does.");
+DEFINE_int32(rebuilding_age_s,
+             3600,
+             "Rebuilding writes have timestamps up to this many seconds in "
+             "the past.");
+DEFINE_int64(random_seeks, 100000, "Number of random seeks in read phase.");
+DEFINE_string(settings,
+              "",
+              "Comma-separated list of name=value settings of the store.");
+
+namespace {
+
+// Appends go to this epoch, rebuilding writes to the one before.
+const epoch_t kAppendEpoch(2);
+const epoch_t kRebuildingEpoch(1);
+const copyset_t kCopyset = {ShardID(0, 0), ShardID(1, 0), ShardID(2, 0)};
+
+enum class Op { WRITE, SEEK, NEXT, MAX };
+const char* const kOpNames[] = {"write", "seek", "next"};
+
+// What each thread measured.
+struct ThreadResult {
+  uint64_t records = 0;
+  uint64_t bytes = 0;
+  std::vector<uint64_t> latency_ns[(int)Op::MAX];
+
+  void add(Op op, std::chrono::steady_clock::time_point start) {
+    latency_ns[(int)op].push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+  }
+};
+
+struct BenchSettings {
+  UpdateableSettings<Settings> settings;
+  UpdateableSettings<RocksDBSettings> rocksdb;
+  UpdateableSettings<LocalLogStoreSettings> local_log_store;
+  UpdateableSettings<RebuildingSettings> rebuilding;
+};
+
+std::vector<logid_t> logsOfShard(int shard) {
+  std::vector<logid_t> logs;
+  for (int log = 1; log <= FLAGS_num_logs; ++log) {
+    if (getLegacyShardIndexForLog(logid_t(log), FLAGS_num_shards) == shard) {
+      logs.push_back(logid_t(log));
+    }
+  }
+  return logs;
+}
+
+// Random bytes to cut payloads from.
+std::string makePayloadPool() {
+  std::string pool(
+      (size_t)(FLAGS_payload_size * (1 + FLAGS_payload_size_spread)) + 1, 0);
+  for (char& c : pool) {
+    c = (char)folly::Random::rand32();
+  }
+  return pool;
+}
+
+Slice samplePayload(const std::string& pool) {
+  const double lo = FLAGS_payload_size * (1 - FLAGS_payload_size_spread);
+  const double hi = FLAGS_payload_size * (1 + FLAGS_payload_size_spread);
+  size_t size = (size_t)folly::Random::randDouble(std::max(0., lo), hi);
+  size = std::min(size, pool.size());
+  return Slice(pool.data() + folly::Random::rand64(pool.size() - size + 1),
+               size);
+}
+
+// One record ready to be written.
+struct Record {
+  std::string header;
+  std::string csi_entry;
+  PutWriteOp op;
+};
+
+void formRecord(logid_t log,
+                lsn_t lsn,
+                std::chrono::milliseconds timestamp,
+                bool rebuilding,
+                Slice payload,
+                Record* out) {
+  LocalLogStoreRecordFormat::flags_t flags =
+      LocalLogStoreRecordFormat::FLAG_SHARD_ID |
+      LocalLogStoreRecordFormat::FLAG_CHECKSUM_PARITY;
+  if (rebuilding) {
+    flags |= LocalLogStoreRecordFormat::FLAG_WRITTEN_BY_REBUILDING;
+  }
+  Slice header = LocalLogStoreRecordFormat::formRecordHeader(
+      timestamp.count(),
+      esn_t(0),
+      flags,
+      /* wave */ 1,
+      folly::Range<const ShardID*>(kCopyset.data(), kCopyset.size()),
+      OffsetMap::fromLegacy(0),
+      /* optional_keys */ {},
+      &out->header);
+  Slice csi_entry = LocalLogStoreRecordFormat::formCopySetIndexEntry(
+      /* wave */ 1,
+      kCopyset.data(),
+      kCopyset.size(),
+      LSN_INVALID,
+      LocalLogStoreRecordFormat::formCopySetIndexFlags(flags),
+      &out->csi_entry);
+  out->op = PutWriteOp(log,
+                       lsn,
+                       header,
+                       payload,
+                       node_index_t(1),
+                       LSN_INVALID,
+                       csi_entry,
+                       {},
+                       Durability::ASYNC_WRITE,
+                       rebuilding);
+}
+
+ThreadResult writeShard(LocalLogStore& store, int shard) {
+  ThreadResult res;
+  const std::vector<logid_t> logs = logsOfShard(shard);
+  if (logs.empty()) {
+    return res;
+  }
+  const std::string pool = makePayloadPool();
+  const int64_t records = FLAGS_records / FLAGS_num_shards +
+      (shard < FLAGS_records % FLAGS_num_shards);
+
+  // Next append ESN of each log.
+  std::vector<uint32_t> next_esn(logs.size(), 1);
+  // Each log gets a block of rebuilding ESNs, written in a scrambled order:
+  // i-th write goes to ESN i * step mod block size, which is a permutation
+  // because step is coprime with the block size.
+  const uint32_t rebuilding_block =
+      std::max<uint32_t>(1, records / logs.size() + 1);
+  std::vector<uint32_t> next_rebuilding(logs.size(), 0);
+  uint32_t step = 2654435761u % rebuilding_block;
+  while (std::gcd(step, rebuilding_block) != 1) {
+    ++step;
+  }
+
+  std::vector<Record> batch(FLAGS_write_batch);
+  std::vector<const WriteOp*> ops;
+  for (int64_t written = 0; written < records;) {
+    const size_t idx = folly::Random::rand32(logs.size());
+    const bool rebuilding =
+        folly::Random::randDouble01() < FLAGS_rebuilding_fraction &&
+        next_rebuilding[idx] < rebuilding_block;
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    const int n = std::min<int64_t>(FLAGS_write_batch, records - written);
+    ops.resize(n);
+    for (int i = 0; i < n; ++i) {
+      lsn_t lsn;
+      std::chrono::milliseconds timestamp = now;
+      if (rebuilding && next_rebuilding[idx] < rebuilding_block) {
+        uint32_t esn =
+            (uint64_t)next_rebuilding[idx]++ * step % rebuilding_block + 1;
+        lsn = compose_lsn(kRebuildingEpoch, esn_t(esn));
+        timestamp -= std::chrono::milliseconds(folly::Random::rand64(
+            (uint64_t)FLAGS_rebuilding_age_s * 1000 + 1));
+      } else {
+        lsn = compose_lsn(kAppendEpoch, esn_t(next_esn[idx]++));
+      }
+      Slice payload = samplePayload(pool);
+      formRecord(logs[idx], lsn, timestamp, rebuilding, payload, &batch[i]);
+      ops[i] = &batch[i].op;
+      res.bytes += payload.size + batch[i].header.size();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int rv = store.writeMulti(ops);
+    res.add(Op::WRITE, start);
+    if (rv != 0) {
+      ld_critical("writeMulti() failed: %s", error_name(err));
+      std::exit(1);
+    }
+    written += n;
+    res.records += n;
+  }
+  return res;
+}
+
+ThreadResult readShard(LocalLogStore& store, int shard) {
+  ThreadResult res;
+  const std::vector<logid_t> logs = logsOfShard(shard);
+  std::vector<std::vector<lsn_t>> lsns(logs.size());
+
+  // Catch-up reads of every log.
+  for (size_t i = 0; i < logs.size(); ++i) {
+    LocalLogStore::ReadOptions options("LocalLogStoreBenchmark");
+    options.fill_cache = false;
+    auto it = store.read(logs[i], options);
+    auto start = std::chrono::steady_clock::now();
+    it->seek(LSN_OLDEST);
+    res.add(Op::SEEK, start);
+    while (it->state() == IteratorState::AT_RECORD) {
+      res.records++;
+      res.bytes += it->getRecord().size;
+      lsns[i].push_back(it->getLSN());
+      start = std::chrono::steady_clock::now();
+      it->next();
+      res.add(Op::NEXT, start);
+    }
+    if (it->state() == IteratorState::ERROR) {
+      ld_critical("Reading log %lu failed", logs[i].val());
+      std::exit(1);
+    }
+  }
+
+  // Random point reads, each with its own iterator like a new read stream.
+  const int64_t seeks = FLAGS_random_seeks / FLAGS_num_shards;
+  for (int64_t s = 0; s < seeks && !logs.empty(); ++s) {
+    size_t i = folly::Random::rand32(logs.size());
+    if (lsns[i].empty()) {
+      continue;
+    }
+    lsn_t lsn = lsns[i][folly::Random::rand32(lsns[i].size())];
+    LocalLogStore::ReadOptions options("LocalLogStoreBenchmark");
+    auto it = store.read(logs[i], options);
+    auto start = std::chrono::steady_clock::now();
+    it->seek(lsn);
+    res.add(Op::SEEK, start);
+    ld_check(it->state() == IteratorState::AT_RECORD);
+  }
+  return res;
+}
+
+template <typename F>
+ThreadResult runPhase(ShardedRocksDBLocalLogStore& store,
+                      F f,
+                      std::chrono::microseconds* elapsed) {
+  std::vector<ThreadResult> results(FLAGS_num_shards);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int shard = 0; shard < FLAGS_num_shards; ++shard) {
+    threads.emplace_back([&, shard] {
+      results[shard] = f(*store.getByIndex(shard), shard);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  *elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  ThreadResult total;
+  for (ThreadResult& r : results) {
+    total.records += r.records;
+    total.bytes += r.bytes;
+    for (int op = 0; op < (int)Op::MAX; ++op) {
+      total.latency_ns[op].insert(total.latency_ns[op].end(),
+                                  r.latency_ns[op].begin(),
+                                  r.latency_ns[op].end());
+    }
+  }
+  return total;
+}
+
+uint64_t tickerSum(ShardedRocksDBLocalLogStore& store,
+                   std::initializer_list<rocksdb::Tickers> tickers) {
+  uint64_t sum = 0;
+  for (int shard = 0; shard < store.numShards(); ++shard) {
+    auto rocks = dynamic_cast<RocksDBLogStoreBase*>(store.getByIndex(shard));
+    if (rocks) {
+      for (rocksdb::Tickers t : tickers) {
+        sum += rocks->getStatsTickerCount(t);
+      }
+    }
+  }
+  return sum;
+}
+
+void printPhase(const char* name,
+                const ThreadResult& r,
+                std::chrono::microseconds elapsed) {
+  const double sec = std::max<double>(1, elapsed.count()) / 1e6;
+  std::printf("%s: %lu records, %.1f MB in %.3fs: %.0f records/s, %.1f MB/s\n",
+              name,
+              r.records,
+              r.bytes / 1e6,
+              sec,
+              r.records / sec,
+              r.bytes / sec / 1e6);
+  for (int op = 0; op < (int)Op::MAX; ++op) {
+    std::vector<uint64_t> v = r.latency_ns[op];
+    if (v.empty()) {
+      continue;
+    }
+    std::sort(v.begin(), v.end());
+    auto pct = [&](double p) {
+      return v[std::min(v.size() - 1, (size_t)(p * v.size()))] / 1e3;
+    };
+    std::printf("  %-6s %10zu ops  p50 %9.1fus  p99 %9.1fus  "
+                "p99.9 %9.1fus  max %9.1fus\n",
+                kOpNames[op],
+                v.size(),
+                pct(.5),
+                pct(.99),
+                pct(.999),
+                v.back() / 1e3);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  dbg::currentLevel = dbg::Level::ERROR;
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_num_shards < 1 || FLAGS_num_logs < 1 || FLAGS_write_batch < 1) {
+    std::fprintf(stderr, "Invalid --num-shards, --num-logs or --write-batch\n");
+    return 1;
+  }
+
+  BenchSettings s;
+  SettingsUpdater updater;
+  updater.registerSettings(s.settings);
+  updater.registerSettings(s.rocksdb);
+  updater.registerSettings(s.local_log_store);
+  updater.registerSettings(s.rebuilding);
+  std::unordered_map<std::string, std::string> settings = {
+      {"rocksdb-auto-create-shards", "true"},
+      {"rocksdb-allow-fallocate", "false"},
+  };
+  std::vector<std::string> pairs;
+  folly::split(',', FLAGS_settings, pairs, /* ignoreEmpty */ true);
+  for (const std::string& pair : pairs) {
+    std::string name, value;
+    if (!folly::split('=', pair, name, value)) {
+      std::fprintf(stderr, "Invalid setting: %s\n", pair.c_str());
+      return 1;
+    }
+    settings[name] = value;
+  }
+  try {
+    updater.setFromCLI(settings);
+  } catch (const boost::program_options::error& e) {
+    std::fprintf(stderr, "Invalid settings: %s\n", e.what());
+    return 1;
+  }
+
+  std::unique_ptr<TemporaryDirectory> temp_dir;
+  std::string path = FLAGS_path;
+  if (path.empty()) {
+    temp_dir = std::make_unique<TemporaryDirectory>("LocalLogStoreBenchmark");
+    path = temp_dir->path().string();
+  }
+
+  ShardedRocksDBLocalLogStore store(path,
+                                    FLAGS_num_shards,
+                                    s.rocksdb,
+                                    std::make_unique<RocksDBCustomiser>());
+  store.init(*s.settings.get(), s.rebuilding, nullptr, nullptr);
+
+  std::chrono::microseconds elapsed;
+  ThreadResult writes = runPhase(store, writeShard, &elapsed);
+  printPhase("write", writes, elapsed);
+
+  // Include the flush of whatever is still in memtables.
+  for (int shard = 0; shard < store.numShards(); ++shard) {
+    auto rocks = dynamic_cast<RocksDBLogStoreBase*>(store.getByIndex(shard));
+    if (rocks) {
+      rocks->flushAllMemtables();
+    }
+  }
+  const uint64_t wal = tickerSum(store, {rocksdb::WAL_FILE_BYTES});
+  const uint64_t flushed = tickerSum(store, {rocksdb::FLUSH_WRITE_BYTES});
+  const uint64_t compacted = tickerSum(store, {rocksdb::COMPACT_WRITE_BYTES});
+  std::printf("  write amplification %.2f (WAL %.1f MB, flushed %.1f MB, "
+              "compacted %.1f MB)\n",
+              (double)(wal + flushed + compacted) /
+                  std::max<uint64_t>(1, writes.bytes),
+              wal / 1e6,
+              flushed / 1e6,
+              compacted / 1e6);
+
+  ThreadResult reads = runPhase(store, readShard, &elapsed);
+  printPhase("read", reads, elapsed);
+
+  return 0;
+}
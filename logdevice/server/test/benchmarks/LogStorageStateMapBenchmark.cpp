@@ -26,7 +26,7 @@ const shard_index_t SHARD_IDX = 0;
 /**
  * @file: a benchmark for testing time spent on accessing LogStorageStateMap
  *        populated with different logids. The performance is directly related
- *        to the internal AtomicHashMap, and specifically, its hash function.
+ *        to the internal hash table, and specifically, its hash function.
  */
 
 // range 1..100000
@@ -43,19 +43,21 @@ static inline void populateLogs(LogStorageStateMap* map, bool metadata_log) {
   }
 }
 
+// Calls op(map, log_id) n_iters times on each of n_threads threads, with
+// random logs in 1..N_LOGS/2.
+template <typename Op>
 static inline void accessMap(LogStorageStateMap* map,
                              int n_threads,
-                             size_t n_iters) {
+                             size_t n_iters,
+                             Op op) {
   ld_check(map);
-  static std::mt19937_64 rnd{std::random_device()()};
-  std::uniform_int_distribution<logid_t::raw_type> dis(1, N_LOGS / 2);
-
   std::vector<std::thread> threads;
   for (int i = 0; i < n_threads; ++i) {
-    threads.emplace_back([map, &dis, n_iters]() {
+    threads.emplace_back([map, n_iters, op]() {
+      std::mt19937_64 rnd{std::random_device()()};
+      std::uniform_int_distribution<logid_t::raw_type> dis(1, N_LOGS / 2);
       for (size_t j = 0; j < n_iters; ++j) {
-        folly::doNotOptimizeAway(
-            map->insertOrGet(logid_t(dis(rnd)), SHARD_IDX));
+        op(map, logid_t(dis(rnd)));
       }
     });
   }
@@ -65,6 +67,10 @@ static inline void accessMap(LogStorageStateMap* map,
   }
 }
 
+static inline void insertOrGet(LogStorageStateMap* map, logid_t log_id) {
+  folly::doNotOptimizeAway(map->insertOrGet(log_id, SHARD_IDX));
+}
+
 DEFINE_int32(num_threads, 32, "Number of threads for benchmarks.");
 
 BENCHMARK(LogStorageStateMapWithDataLogs, iters) {
@@ -76,7 +82,8 @@ BENCHMARK(LogStorageStateMapWithDataLogs, iters) {
     populateLogs(map.get(), false);
   }
 
-  accessMap(map.get(), FLAGS_num_threads, iters / FLAGS_num_threads);
+  accessMap(
+      map.get(), FLAGS_num_threads, iters / FLAGS_num_threads, insertOrGet);
 }
 
 BENCHMARK(LogStorageStateMapWithMetaDataLogs, iters) {
@@ -88,7 +95,30 @@ BENCHMARK(LogStorageStateMapWithMetaDataLogs, iters) {
     populateLogs(map.get(), true);
   }
 
-  accessMap(map.get(), FLAGS_num_threads, iters / FLAGS_num_threads);
+  accessMap(
+      map.get(), FLAGS_num_threads, iters / FLAGS_num_threads, insertOrGet);
+}
+
+// Lookups and updates of the state from many threads, as done for every
+// STORE and read.
+BENCHMARK(LogStorageStateMapFindAndUpdate, iters) {
+  std::unique_ptr<LogStorageStateMap> map = nullptr;
+
+  BENCHMARK_SUSPEND {
+    map.reset(
+        new LogStorageStateMap(1, /*stats*/ nullptr, /*record_cache*/ false));
+    populateLogs(map.get(), false);
+  }
+
+  accessMap(map.get(),
+            FLAGS_num_threads,
+            iters / FLAGS_num_threads,
+            [](LogStorageStateMap* m, logid_t log_id) {
+              LogStorageState* state = m->find(log_id, SHARD_IDX);
+              folly::doNotOptimizeAway(state->getTrimPoint());
+              state->updateLastPerEpochReleasedLSN(
+                  compose_lsn(epoch_t(1), esn_t(log_id.val())));
+            });
 }
 
 BENCHMARK_DRAW_LINE();
@@ -0,0 +1,315 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/checks.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/util.h"
+#include "logdevice/server/ServerRecordEqualityFilter.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
+#include "logdevice/server/read_path/LocalLogStoreReader.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: a benchmark for the storage side of the read path: reading batches of
+ *        records from a PartitionedRocksDBStore with LocalLogStoreReader::read()
+ *        and parsing them the way CatchupOneStream's ReadingCallback does.
+ *
+ *        The store is a temporary logsdb instance with --num-logs logs, each
+ *        with --records-per-log records spread evenly over --num-partitions
+ *        partitions. All payloads are --payload-size bytes, so bytes/sec is
+ *        records/sec (as reported, one iteration is one record delivered)
+ *        times the payload size.
+ *
+ *        Scenarios:
+ *         - catchUp: reading every log from the beginning,
+ *         - tailing: reading the last --tail-records records of every log
+ *           with tailing iterators kept across batches,
+ *         - filteredScd: catch-up with single copy delivery filtering, one
+ *           record in three is shipped,
+ *         - filteredServerRecordFilter: catch-up with a server-side equality
+ *           filter on the record key, one record in four passes,
+ *         - rebuilding: reading all logs with readAllLogs() and a
+ *           required-in-copyset filter, the way rebuilding donors read.
+ */
+
+DEFINE_int32(num_logs, 100, "Number of logs in the store.");
+DEFINE_int32(records_per_log, 2000, "Number of records in each log.");
+DEFINE_int32(num_partitions, 10, "Number of partitions to spread records on.");
+DEFINE_int32(payload_size, 1000, "Payload size of every record, in bytes.");
+DEFINE_int64(batch_bytes,
+             1024 * 1024,
+             "max_bytes_to_deliver of each LocalLogStoreReader::read() call.");
+DEFINE_int32(tail_records,
+             10,
+             "Number of records of each log read by the tailing benchmark.");
+
+namespace {
+
+// This storage shard. It's in every copyset, at a position that rotates with
+// the LSN; other copies are on shards 1 to kNumOtherShards.
+const ShardID kMyShard(0, 0);
+const int kNumOtherShards = 5;
+const int kNumKeys = 4;
+
+copyset_t makeCopyset(lsn_t lsn) {
+  copyset_t copyset = {ShardID(1 + lsn % kNumOtherShards, 0),
+                       ShardID(1 + (lsn + 1) % kNumOtherShards, 0)};
+  copyset.insert(copyset.begin() + lsn % 3, kMyShard);
+  return copyset;
+}
+
+std::string makeKey(lsn_t lsn) {
+  return "key" + std::to_string(lsn % kNumKeys);
+}
+
+class BenchStore {
+ public:
+  BenchStore() : settings_(create_default_settings<Settings>()) {
+    const std::string payload(FLAGS_payload_size, 'x');
+    const int per_partition =
+        std::max(1, FLAGS_records_per_log / FLAGS_num_partitions);
+    auto time = TemporaryPartitionedStore::baseTime();
+    for (lsn_t lsn = 1; lsn <= (lsn_t)FLAGS_records_per_log; ++lsn) {
+      if (lsn > 1 && (lsn - 1) % per_partition == 0) {
+        time += std::chrono::seconds(1);
+        store_.setTime(time);
+        store_.createPartition();
+      }
+      for (int log = 1; log <= FLAGS_num_logs; ++log) {
+        int rv = store_.putRecord(
+            logid_t(log),
+            lsn,
+            RecordTimestamp(time.toMilliseconds()),
+            makeCopyset(lsn),
+            0,
+            Slice(payload.data(), payload.size()),
+            {{KeyType::FILTERABLE, makeKey(lsn)}});
+        ld_check(rv == 0);
+      }
+    }
+  }
+
+  LocalLogStore& store() {
+    return store_;
+  }
+
+  const Settings& settings() const {
+    return settings_;
+  }
+
+ private:
+  TemporaryPartitionedStore store_;
+  Settings settings_;
+};
+
+BenchStore& getStore() {
+  static BenchStore store;
+  return store;
+}
+
+// Parses records like ReadingCallback::processRecord() and optionally applies
+// a ServerRecordFilter to their key.
+class BenchCallback : public LocalLogStoreReader::Callback {
+ public:
+  explicit BenchCallback(ServerRecordFilter* filter = nullptr)
+      : filter_(filter) {}
+
+  int processRecord(const RawRecord& record) override {
+    return process(record.blob);
+  }
+
+  int process(const Slice& blob) {
+    std::chrono::milliseconds timestamp;
+    esn_t last_known_good;
+    LocalLogStoreRecordFormat::flags_t flags;
+    uint32_t wave;
+    copyset_size_t copyset_size;
+    OffsetMap offsets_within_epoch;
+    folly::Optional<folly::StringPiece> filterable_key;
+    Payload payload;
+    int rv = LocalLogStoreRecordFormat::parseWithOptionalKey(
+        blob,
+        &timestamp,
+        &last_known_good,
+        &flags,
+        &wave,
+        &copyset_size,
+        nullptr,
+        0,
+        &offsets_within_epoch,
+        KeyType::FILTERABLE,
+        filter_ ? &filterable_key : nullptr,
+        &payload,
+        kMyShard.shard());
+    if (rv != 0) {
+      ld_check(false);
+      return -1;
+    }
+    if (filter_ && filterable_key.hasValue() &&
+        !(*filter_)(filterable_key.value())) {
+      return 0;
+    }
+    ++records_;
+    folly::doNotOptimizeAway(payload.data());
+    return 0;
+  }
+
+  size_t records() const {
+    return records_;
+  }
+
+ private:
+  ServerRecordFilter* filter_;
+  size_t records_{0};
+};
+
+// Reads records [from, until] of the log in batches, like a catching up
+// ServerReadStream would. Returns the number of LocalLogStoreReader::read()
+// calls.
+size_t readLog(LocalLogStore::ReadIterator& it,
+               logid_t log,
+               lsn_t from,
+               lsn_t until,
+               std::shared_ptr<LocalLogStore::ReadFilter> lls_filter,
+               BenchCallback& cb) {
+  BenchStore& store = getStore();
+  LocalLogStoreReader::ReadContext ctx(log,
+                                       {from},
+                                       until,
+                                       LSN_MAX,
+                                       std::chrono::milliseconds::max(),
+                                       until,
+                                       FLAGS_batch_bytes,
+                                       true, // first_record_any_size
+                                       std::move(lls_filter),
+                                       CatchupEventTrigger::OTHER);
+  size_t batches = 0;
+  while (true) {
+    ++batches;
+    Status st =
+        LocalLogStoreReader::read(it, cb, &ctx, nullptr, store.settings());
+    if (st != E::BYTE_LIMIT_REACHED && st != E::PARTIAL) {
+      ld_check(st == E::UNTIL_LSN_REACHED);
+      return batches;
+    }
+  }
+}
+
+size_t runCatchUp(std::shared_ptr<LocalLogStore::ReadFilter> lls_filter,
+                  ServerRecordFilter* filter) {
+  BenchStore* store;
+  BENCHMARK_SUSPEND {
+    store = &getStore();
+  }
+  BenchCallback cb(filter);
+  LocalLogStore::ReadOptions options("ReadPathBenchmark");
+  options.allow_copyset_index = lls_filter != nullptr;
+  for (int log = 1; log <= FLAGS_num_logs; ++log) {
+    auto it = store->store().read(logid_t(log), options);
+    readLog(*it, logid_t(log), 1, FLAGS_records_per_log, lls_filter, cb);
+  }
+  return cb.records();
+}
+
+size_t runTailing() {
+  BenchStore* store;
+  std::vector<std::unique_ptr<LocalLogStore::ReadIterator>> iterators;
+  BENCHMARK_SUSPEND {
+    store = &getStore();
+    LocalLogStore::ReadOptions options("ReadPathBenchmark");
+    options.tailing = true;
+    for (int log = 1; log <= FLAGS_num_logs; ++log) {
+      iterators.push_back(store->store().read(logid_t(log), options));
+    }
+  }
+  BenchCallback cb;
+  const lsn_t until = FLAGS_records_per_log;
+  const lsn_t from = until - std::min<lsn_t>(until - 1, FLAGS_tail_records);
+  for (int log = 1; log <= FLAGS_num_logs; ++log) {
+    readLog(*iterators[log - 1], logid_t(log), from, until, nullptr, cb);
+  }
+  return cb.records();
+}
+
+size_t runFilteredScd() {
+  auto filter = std::make_shared<LocalLogStoreReadFilter>();
+  filter->scd_my_shard_id_ = kMyShard;
+  filter->scd_replication_ = 3;
+  return runCatchUp(std::move(filter), nullptr);
+}
+
+size_t runFilteredServerRecordFilter() {
+  ServerRecordEqualityFilter filter(makeKey(0));
+  return runCatchUp(nullptr, &filter);
+}
+
+size_t runRebuilding() {
+  BenchStore* store;
+  std::unique_ptr<LocalLogStore::AllLogsIterator> it;
+  BENCHMARK_SUSPEND {
+    store = &getStore();
+    LocalLogStore::ReadOptions options(
+        "ReadPathBenchmark", /* rebuilding */ true);
+    options.allow_copyset_index = true;
+    options.fill_cache = false;
+    it = store->store().readAllLogs(options, folly::none);
+  }
+  LocalLogStoreReadFilter filter;
+  filter.required_in_copyset_ = {ShardID(1, 0)};
+  LocalLogStore::ReadStats stats;
+  BenchCallback cb;
+  for (it->seek(*it->minLocation(), &filter, &stats);
+       it->state() == IteratorState::AT_RECORD;
+       it->next(&filter, &stats)) {
+    cb.process(it->getRecord());
+  }
+  ld_check(it->state() == IteratorState::AT_END);
+  BENCHMARK_SUSPEND {
+    it.reset();
+  }
+  return cb.records();
+}
+
+} // namespace
+
+BENCHMARK_MULTI(catchUp) {
+  return runCatchUp(nullptr, nullptr);
+}
+
+BENCHMARK_MULTI(tailing) {
+  return runTailing();
+}
+
+BENCHMARK_MULTI(filteredScd) {
+  return runFilteredScd();
+}
+
+BENCHMARK_MULTI(filteredServerRecordFilter) {
+  return runFilteredServerRecordFilter();
+}
+
+BENCHMARK_MULTI(rebuilding) {
+  return runRebuilding();
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
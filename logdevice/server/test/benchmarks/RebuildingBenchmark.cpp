@@ -0,0 +1,467 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/Checksum.h"
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/checks.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/settings/SettingsUpdater.h"
+#include "logdevice/common/test/MockTimer.h"
+#include "logdevice/common/test/NodeSetTestUtil.h"
+#include "logdevice/server/RecordRebuildingBase.h"
+#include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
+#include "logdevice/server/rebuilding/ChunkRebuilding.h"
+#include "logdevice/server/rebuilding/RebuildingReadStorageTask.h"
+#include "logdevice/server/rebuilding/ShardRebuilding.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: Throughput of a rebuilding donor: ShardRebuilding reading a synthetic
+ *        shard with RebuildingReadStorageTask and handing the chunks to
+ *        simulated ChunkRebuildings.
+ *
+ *        The shard is a temporary logsdb store on local disk with --num-logs
+ *        logs of --records-per-log records each, spread over --num-partitions
+ *        partitions. All payloads are --payload-size bytes with a 32-bit
+ *        checksum. We are N0 and the rebuilding set is {N1}. Every record is
+ *        stored on N0 and two of N1..N(--nodes - 1), so with the defaults
+ *        about 2 / 9 of the records need rebuilding and the rest is filtered
+ *        out by the read path.
+ *
+ *        Storage tasks run synchronously on the benchmark thread. Simulated
+ *        ChunkRebuildings do the donor-side work of RecordRebuildingStore
+ *        for every record (checksum verification unless the read task did
+ *        it, parsing, picking a copyset with the real copyset selector) and
+ *        then wait --store-latency-us for the recipients to reply; no
+ *        messages are sent.
+ *
+ *        folly's iters/s is records rebuilt per second. When run standalone,
+ *        MB/s, records/s and the time ShardRebuilding spent in each
+ *        ProfilingState are printed after the benchmarks for a few settings.
+ */
+
+DEFINE_int32(num_logs, 100, "Number of logs in the store.");
+DEFINE_int32(records_per_log, 1000, "Number of records in each log.");
+DEFINE_int32(num_partitions, 10, "Number of partitions to spread records on.");
+DEFINE_int32(payload_size, 1000, "Payload size of every record, in bytes.");
+DEFINE_int32(nodes, 10, "Number of storage nodes in the cluster.");
+DEFINE_int32(store_latency_us,
+             0,
+             "How long a simulated ChunkRebuilding waits for recipients.");
+DEFINE_string(max_batch_bytes,
+              "",
+              "Value of rebuilding-max-batch-bytes; default if empty.");
+
+namespace {
+
+const ShardID kMyShard(0, 0);
+const ShardID kRebuildingShard(1, 0);
+const ReplicationProperty kReplication({{NodeLocationScope::NODE, 3}});
+
+copyset_t makeCopyset(lsn_t lsn) {
+  const int others = std::max(2, FLAGS_nodes - 1);
+  return {kMyShard,
+          ShardID(1 + lsn % others, 0),
+          ShardID(1 + (lsn + 1) % others, 0)};
+}
+
+// The synthetic shard and the cluster config it belongs to.
+class BenchShard {
+ public:
+  BenchShard() {
+    configuration::Nodes nodes;
+    NodeSetTestUtil::addNodes(&nodes, FLAGS_nodes, /* shards */ 1, "....");
+    auto logs_config = std::make_shared<configuration::LocalLogsConfig>();
+    logs_config->insert(
+        boost::icl::right_open_interval<logid_t::raw_type>(
+            1, FLAGS_num_logs + 1),
+        "lg1",
+        logsconfig::LogAttributes().with_replicationFactor(3));
+    logs_config->markAsFullyLoaded();
+    configuration::MetaDataLogsConfig meta_logs_config;
+    meta_logs_config.metadata_nodes = {0, 1, 2};
+    auto server_config = std::shared_ptr<ServerConfig>(
+        ServerConfig::fromDataTest("RebuildingBenchmark",
+                                   configuration::NodesConfig(nodes),
+                                   meta_logs_config));
+    config_ = std::make_shared<UpdateableConfig>(
+        std::make_shared<Configuration>(server_config, logs_config));
+    config_->updateableNodesConfiguration()->update(
+        config_->getNodesConfigurationFromServerConfigSource());
+
+    for (int i = 0; i < FLAGS_nodes; ++i) {
+      storageSet_.push_back(ShardID(i, 0));
+    }
+
+    std::string payload(FLAGS_payload_size, 'x');
+    char buf[8];
+    Slice checksum =
+        checksum_bytes(Slice(payload.data(), payload.size()), 32, buf);
+    payload = std::string((const char*)checksum.data, checksum.size) + payload;
+
+    const int per_partition =
+        std::max(1, FLAGS_records_per_log / FLAGS_num_partitions);
+    auto time = TemporaryPartitionedStore::baseTime();
+    for (lsn_t lsn = 1; lsn <= (lsn_t)FLAGS_records_per_log; ++lsn) {
+      if (lsn > 1 && (lsn - 1) % per_partition == 0) {
+        time += std::chrono::seconds(1);
+        store_.setTime(time);
+        store_.createPartition();
+      }
+      for (int log = 1; log <= FLAGS_num_logs; ++log) {
+        int rv = store_.putRecord(logid_t(log),
+                                  lsn,
+                                  RecordTimestamp(time.toMilliseconds()),
+                                  makeCopyset(lsn),
+                                  LocalLogStoreRecordFormat::FLAG_CHECKSUM,
+                                  Slice(payload.data(), payload.size()));
+        ld_check(rv == 0);
+      }
+    }
+  }
+
+  LocalLogStore& store() {
+    return store_;
+  }
+
+  std::shared_ptr<UpdateableConfig> config() const {
+    return config_;
+  }
+
+  const StorageSet& storageSet() const {
+    return storageSet_;
+  }
+
+ private:
+  TemporaryPartitionedStore store_;
+  std::shared_ptr<UpdateableConfig> config_;
+  StorageSet storageSet_;
+};
+
+BenchShard& getShard() {
+  static BenchShard shard;
+  return shard;
+}
+
+struct BenchResult {
+  size_t records = 0;
+  size_t bytes = 0;
+  size_t stores = 0;
+  std::chrono::microseconds elapsed{0};
+  // Indexed by ShardRebuilding::ProfilingState.
+  std::vector<std::pair<std::string, std::chrono::milliseconds>> timeByState;
+};
+
+class BenchShardRebuilding : public ShardRebuilding,
+                             public ShardRebuildingInterface::Listener {
+ public:
+  class ReadTask : public RebuildingReadStorageTask {
+   public:
+    ReadTask(BenchShardRebuilding* owner, std::weak_ptr<Context> context)
+        : RebuildingReadStorageTask(context), owner_(owner) {}
+
+   protected:
+    UpdateableSettings<Settings> getSettings() override {
+      return owner_->settings_;
+    }
+    std::shared_ptr<UpdateableConfig> getConfig() override {
+      return getShard().config();
+    }
+    folly::Optional<NodeID> getMyNodeID() override {
+      return NodeID(kMyShard.node(), 1);
+    }
+    std::unique_ptr<LocalLogStore::AllLogsIterator> createIterator(
+        const LocalLogStore::ReadOptions& opts,
+        const std::unordered_map<logid_t, std::pair<lsn_t, lsn_t>>& logs)
+        override {
+      return getShard().store().readAllLogs(opts, logs);
+    }
+    void updateTrimPoint(logid_t log,
+                         Context* context,
+                         Context::LogState* log_state) override {}
+    StatsHolder* getStats() override {
+      return &owner_->stats_;
+    }
+    bool storeVerifiesChecksums() override {
+      return getShard().store().verifiesChecksumsOnWriteAndRead();
+    }
+
+   private:
+    BenchShardRebuilding* owner_;
+  };
+
+  BenchShardRebuilding(std::shared_ptr<const RebuildingSet> rebuilding_set,
+                       UpdateableSettings<RebuildingSettings> settings)
+      : ShardRebuilding(kMyShard.shard(),
+                        /* rebuilding_version */ 42,
+                        /* restart_version */ 420,
+                        rebuilding_set,
+                        settings,
+                        NodeID(kMyShard.node(), 1),
+                        /* listener */ this),
+        stats_(StatsParams().setIsServer(true)) {}
+
+  BenchResult run() {
+    std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan;
+    for (int log = 1; log <= FLAGS_num_logs; ++log) {
+      auto p = std::make_unique<RebuildingPlan>();
+      p->untilLSN = LSN_MAX;
+      p->addEpochRange(EPOCH_INVALID,
+                       EPOCH_MAX,
+                       std::make_shared<EpochMetaData>(
+                           getShard().storageSet(), kReplication));
+      plan.emplace(logid_t(log), std::move(p));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    this->start(std::move(plan));
+    while (!completed_) {
+      // Reply to the chunks whose recipients have answered.
+      auto now = std::chrono::steady_clock::now();
+      while (!inFlight_.empty() && inFlight_.front().deadline <= now) {
+        InFlightChunk c = std::move(inFlight_.front());
+        inFlight_.pop_front();
+        onChunkRebuildingDone(c.id, c.oldestTimestamp);
+      }
+      if (!pendingReads_.empty()) {
+        size_t stream_idx = pendingReads_.front();
+        pendingReads_.pop_front();
+        ReadTask task(this, readStreams_[stream_idx].context);
+        task.execute();
+        task.onDone();
+      } else if (!inFlight_.empty()) {
+        std::this_thread::sleep_until(inFlight_.front().deadline);
+      } else if (!completed_) {
+        ld_critical("Rebuilding stalled");
+        ld_check(false);
+        break;
+      }
+    }
+    result_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    flushCurrentStateTime();
+    for (size_t i = 0; i < (size_t)ProfilingState::MAX; ++i) {
+      result_.timeByState.emplace_back(
+          profilingStateNames()[(ProfilingState)i], totalTimeByState_[i]);
+    }
+    return result_;
+  }
+
+  void onShardRebuildingComplete(uint32_t /* shard_idx */) override {}
+  void onShardRebuildingProgress(uint32_t /* shard */,
+                                 RecordTimestamp /* next_ts */,
+                                 double /* progress_estimate */) override {}
+
+ protected:
+  StatsHolder* getStats() override {
+    return &stats_;
+  }
+  node_index_t getMyNodeIndex() override {
+    return kMyShard.node();
+  }
+  std::chrono::milliseconds getIteratorTTL() override {
+    return std::chrono::seconds(20);
+  }
+  std::unique_ptr<TimerInterface>
+  createTimer(std::function<void()> cb) override {
+    return std::make_unique<MockTimer>(cb);
+  }
+  void putStorageTask(size_t stream_idx) override {
+    pendingReads_.push_back(stream_idx);
+  }
+  worker_id_t startChunkRebuilding(std::unique_ptr<ChunkData> chunk,
+                                   chunk_rebuilding_id_t chunk_id) override {
+    for (size_t i = 0; i < chunk->numRecords(); ++i) {
+      rebuildRecord(*chunk, i);
+    }
+    result_.records += chunk->numRecords();
+    result_.bytes += chunk->totalBytes();
+    inFlight_.push_back(InFlightChunk{
+        std::chrono::steady_clock::now() +
+            std::chrono::microseconds(FLAGS_store_latency_us),
+        chunk_id,
+        chunk->oldestTimestamp});
+    return worker_id_t(0);
+  }
+
+ private:
+  struct InFlightChunk {
+    std::chrono::steady_clock::time_point deadline;
+    chunk_rebuilding_id_t id;
+    RecordTimestamp oldestTimestamp;
+  };
+
+  UpdateableSettings<Settings> settings_;
+  StatsHolder stats_;
+  std::deque<size_t> pendingReads_;
+  std::deque<InFlightChunk> inFlight_;
+  BenchResult result_;
+
+  // What RecordRebuildingStore does with a record before sending STOREs.
+  void rebuildRecord(const ChunkData& chunk, size_t idx) {
+    Slice blob = chunk.getRecordSlice(idx);
+    if (settings_->verify_checksum_before_replicating &&
+        !chunk.checksumsVerified) {
+      int rv = LocalLogStoreRecordFormat::checkWellFormed(blob);
+      ld_check(rv == 0);
+    }
+
+    copyset_size_t copyset_size;
+    Payload payload;
+    int rv = LocalLogStoreRecordFormat::parse(blob,
+                                              nullptr,
+                                              nullptr,
+                                              nullptr,
+                                              nullptr,
+                                              &copyset_size,
+                                              nullptr,
+                                              0,
+                                              nullptr,
+                                              nullptr,
+                                              &payload,
+                                              kMyShard.shard());
+    ld_check(rv == 0);
+    copyset_t existing(copyset_size);
+    rv = LocalLogStoreRecordFormat::parse(blob,
+                                          nullptr,
+                                          nullptr,
+                                          nullptr,
+                                          nullptr,
+                                          nullptr,
+                                          existing.data(),
+                                          existing.size(),
+                                          nullptr,
+                                          nullptr,
+                                          nullptr,
+                                          kMyShard.shard());
+    ld_check(rv == 0);
+
+    const auto& rebuilding_shards = rebuildingSet_->shards;
+    copyset_t copyset;
+    for (ShardID shard : existing) {
+      if (!rebuilding_shards.count(shard)) {
+        copyset.push_back(shard);
+      }
+    }
+    const size_t kept = copyset.size();
+
+    uint32_t rng_seed[4];
+    RecordRebuildingInterface::getRNGSeedFromRecord(
+        rng_seed, existing.data(), existing.size(), chunk.blockID);
+    XorShift128PRNG rng;
+    rng.seed(rng_seed);
+    copyset.resize(kept + kReplication.getReplicationFactor());
+    copyset_size_t full_size;
+    auto res = chunk.replication->copysetSelector->augment(
+        copyset.data(), kept, &full_size, rng);
+    ld_check(res == CopySetSelector::Result::SUCCESS);
+    result_.stores += full_size - kept;
+    folly::doNotOptimizeAway(payload.size());
+  }
+};
+
+BenchResult
+runRebuilding(std::unordered_map<std::string, std::string> settings) {
+  if (!FLAGS_max_batch_bytes.empty()) {
+    settings.emplace("rebuilding-max-batch-bytes", FLAGS_max_batch_bytes);
+  }
+  UpdateableSettings<RebuildingSettings> rebuilding_settings;
+  SettingsUpdater u;
+  u.registerSettings(rebuilding_settings);
+  u.setFromConfig(settings);
+
+  auto rebuilding_set = std::make_shared<RebuildingSet>();
+  rebuilding_set->shards.emplace(
+      kRebuildingShard, RebuildingNodeInfo(RebuildingMode::RESTORE));
+
+  BenchShardRebuilding rebuilding(rebuilding_set, rebuilding_settings);
+  return rebuilding.run();
+}
+
+size_t runBenchmark(std::unordered_map<std::string, std::string> settings) {
+  BENCHMARK_SUSPEND {
+    getShard();
+  }
+  return runRebuilding(std::move(settings)).records;
+}
+
+#ifndef BENCHMARK_BUNDLE
+void report() {
+  std::printf("\n%d logs x %d records of %d bytes, %dus store latency:\n",
+              FLAGS_num_logs,
+              FLAGS_records_per_log,
+              FLAGS_payload_size,
+              FLAGS_store_latency_us);
+  struct Case {
+    const char* name;
+    std::unordered_map<std::string, std::string> settings;
+  };
+  const Case cases[] = {
+      {"default", {}},
+      {"read_streams_4", {{"rebuilding-read-streams", "4"}}},
+      {"batch_checksums",
+       {{"rebuilding-checksum-verification", "batch"}}},
+      {"new_to_old", {{"rebuilding-new-to-old", "true"}}},
+  };
+  for (const Case& c : cases) {
+    BenchResult r = runRebuilding(c.settings);
+    const double sec = std::max<double>(1, r.elapsed.count()) / 1e6;
+    std::printf("  %-16s %8.1f MB/s %10.0f records/s %8zu records %8zu "
+                "stores %8.3fs\n",
+                c.name,
+                r.bytes / sec / 1e6,
+                r.records / sec,
+                r.records,
+                r.stores,
+                sec);
+    for (const auto& s : r.timeByState) {
+      std::printf(
+          "    %-28s %8.3fs\n", s.first.c_str(), s.second.count() / 1e3);
+    }
+  }
+}
+#endif
+
+} // namespace
+
+BENCHMARK_MULTI(rebuildDefault) {
+  return runBenchmark({});
+}
+
+BENCHMARK_MULTI(rebuildFourReadStreams) {
+  return runBenchmark({{"rebuilding-read-streams", "4"}});
+}
+
+BENCHMARK_MULTI(rebuildBatchChecksums) {
+  return runBenchmark({{"rebuilding-checksum-verification", "batch"}});
+}
+
+#ifndef BENCHMARK_BUNDLE
+int main(int argc, char** argv) {
+  dbg::currentLevel = dbg::Level::ERROR;
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  report();
+
+  return 0;
+}
+#endif
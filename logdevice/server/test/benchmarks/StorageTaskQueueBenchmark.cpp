@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/IntrusiveList.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/DRRScheduler.h"
+#include "logdevice/server/storage_tasks/StorageTaskInjectionLanes.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: a benchmark for the handoff of storage tasks from worker threads to
+ *        the storage threads of a shard, measuring tasks/sec as the number of
+ *        producing workers grows. Compares putting tasks straight into the
+ *        DRR scheduler with going through per-worker injection lanes (see
+ *        storage-tasks-drr-injection-lanes).
+ */
+
+DEFINE_int32(num_consumers, 4, "Number of consuming storage threads.");
+DEFINE_int32(lane_capacity, 4096, "Capacity of each injection lane.");
+
+namespace {
+
+struct BenchTask {
+  // Request based scheduling: every task costs 1.
+  uint64_t reqSize() const {
+    return 1;
+  }
+  folly::IntrusiveListHook hook;
+};
+
+using Scheduler = DRRScheduler<BenchTask, &BenchTask::hook>;
+using Lanes = StorageTaskInjectionLanes<BenchTask*>;
+
+void initScheduler(Scheduler& scheduler) {
+  std::vector<DRRPrincipal> principals;
+  principals.push_back(DRRPrincipal{"bench", 1});
+  scheduler.initShares("bench", 1, principals);
+}
+
+// Pushes `ntasks` through `put` from `nproducers` threads and consumes them
+// with FLAGS_num_consumers threads calling `get`.
+template <typename Put, typename Get>
+void runHandoff(size_t ntasks, int nproducers, Put put, Get get) {
+  std::vector<BenchTask> tasks;
+  BENCHMARK_SUSPEND {
+    tasks.resize(ntasks);
+  }
+  const size_t per_producer = ntasks / nproducers;
+  const size_t total = per_producer * nproducers;
+  // Every consumer gets an equal share, the rest goes to the first one.
+  const size_t per_consumer = total / FLAGS_num_consumers;
+
+  std::vector<std::thread> threads;
+  for (int c = 0; c < FLAGS_num_consumers; ++c) {
+    const size_t n = per_consumer +
+        (c == 0 ? total - per_consumer * FLAGS_num_consumers : 0);
+    threads.emplace_back([&get, n] {
+      for (size_t i = 0; i < n; ++i) {
+        folly::doNotOptimizeAway(get());
+      }
+    });
+  }
+  for (int p = 0; p < nproducers; ++p) {
+    threads.emplace_back([&, p] {
+      for (size_t i = 0; i < per_producer; ++i) {
+        put(&tasks[p * per_producer + i]);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+void schedulerMutex(size_t iters, int nproducers) {
+  Scheduler scheduler;
+  BENCHMARK_SUSPEND {
+    initScheduler(scheduler);
+  }
+  runHandoff(iters,
+             nproducers,
+             [&](BenchTask* task) { scheduler.enqueue(task, 0); },
+             [&] { return scheduler.blockingDequeue(); });
+}
+
+void injectionLanes(size_t iters, int nproducers) {
+  Scheduler scheduler;
+  std::unique_ptr<Lanes> lanes;
+  BENCHMARK_SUSPEND {
+    initScheduler(scheduler);
+    lanes = std::make_unique<Lanes>(nproducers, FLAGS_lane_capacity);
+  }
+  runHandoff(
+      iters,
+      nproducers,
+      [&](BenchTask* task) {
+        thread_local Lanes::LaneId id;
+        // Each run uses a fresh set of lanes and fresh producer threads.
+        const int lane = lanes->getLane(id);
+        if (lane < 0 || !lanes->tryWrite(lane, task)) {
+          scheduler.enqueue(task, 0);
+          lanes->notify();
+        }
+      },
+      [&] {
+        lanes->wait();
+        while (true) {
+          lanes->drain([&](BenchTask* task) { scheduler.enqueue(task, 0); });
+          BenchTask* task = scheduler.dequeue();
+          if (task) {
+            return task;
+          }
+          std::this_thread::yield();
+        }
+      });
+}
+
+} // namespace
+
+BENCHMARK_PARAM(schedulerMutex, 1)
+BENCHMARK_RELATIVE_PARAM(injectionLanes, 1)
+BENCHMARK_PARAM(schedulerMutex, 4)
+BENCHMARK_RELATIVE_PARAM(injectionLanes, 4)
+BENCHMARK_PARAM(schedulerMutex, 16)
+BENCHMARK_RELATIVE_PARAM(injectionLanes, 16)
+BENCHMARK_PARAM(schedulerMutex, 64)
+BENCHMARK_RELATIVE_PARAM(injectionLanes, 64)
+
+BENCHMARK_DRAW_LINE();
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  gflags::SetCommandLineOptionWithMode(
+      "bm_min_iters", "1000000", gflags::SET_FLAG_IF_DEFAULT);
+  folly::runBenchmarks();
+  return 0;
+}
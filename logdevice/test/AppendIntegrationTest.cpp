@@ -1111,3 +1111,34 @@ TEST_F(AppendIntegrationTest, Stats) {
 TEST_F(AppendIntegrationTest, StatsWithSequencerBatching) {
   AppendIntegrationTest_Stats_impl(true);
 }
+
+// Clients created with share-client-transport and the same config and
+// credentials use the same Processor, which keeps running until the last of
+// them is destroyed.
+TEST_F(AppendIntegrationTest, SharedClientTransport) {
+  auto cluster = IntegrationTestUtils::ClusterFactory().create(1);
+  auto create_client = [&](const std::string& credentials) {
+    std::unique_ptr<ClientSettings> settings(ClientSettings::create());
+    EXPECT_EQ(0, settings->set("share-client-transport", "true"));
+    return cluster->createClient(
+        testTimeout(), std::move(settings), credentials);
+  };
+
+  std::shared_ptr<Client> client1 = create_client("");
+  std::shared_ptr<Client> client2 = create_client("");
+  std::shared_ptr<Client> other = create_client("other");
+  ASSERT_TRUE(client1 && client2 && other);
+  auto& impl1 = checked_downcast<ClientImpl&>(*client1);
+  auto& impl2 = checked_downcast<ClientImpl&>(*client2);
+  auto& other_impl = checked_downcast<ClientImpl&>(*other);
+  EXPECT_EQ(&impl1.getProcessor(), &impl2.getProcessor());
+  EXPECT_NE(&impl1.getProcessor(), &other_impl.getProcessor());
+
+  const logid_t log_id(1);
+  EXPECT_NE(LSN_INVALID, client1->appendSync(log_id, "a"));
+  EXPECT_NE(LSN_INVALID, client2->appendSync(log_id, "b"));
+
+  // The Processor outlives the Client that created it
+  client1.reset();
+  EXPECT_NE(LSN_INVALID, client2->appendSync(log_id, "c"));
+}
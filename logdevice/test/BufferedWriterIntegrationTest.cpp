@@ -5,6 +5,7 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <algorithm>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -190,6 +191,55 @@ TEST_F(BufferedWriterIntegrationTest, BatchOffset) {
   EXPECT_EQ(0, data[3]->attrs.batch_offset);
 }
 
+// Client::append() calls made within the coalescing window are written as one
+// batch, which readers see as the original records.
+TEST_F(BufferedWriterIntegrationTest, ClientAppendCoalescing) {
+  auto cluster = IntegrationTestUtils::ClusterFactory().create(1);
+  std::unique_ptr<ClientSettings> client_settings(ClientSettings::create());
+  ASSERT_EQ(0, client_settings->set("append-coalescing", "true"));
+  // Long enough for all appends below to make it into one batch.
+  ASSERT_EQ(0, client_settings->set("append-coalescing-window", "1s"));
+  std::shared_ptr<Client> client =
+      cluster->createClient(this->testTimeout(), std::move(client_settings));
+  const logid_t LOG_ID(1);
+  const int NAPPENDS = 5;
+
+  Semaphore sem;
+  std::mutex mutex;
+  std::vector<std::pair<lsn_t, int>> results;
+  for (int i = 0; i < NAPPENDS; ++i) {
+    int rv = client->append(
+        LOG_ID, std::to_string(i), [&](Status st, const DataRecord& r) {
+          EXPECT_EQ(E::OK, st);
+          std::lock_guard<std::mutex> guard(mutex);
+          results.emplace_back(r.attrs.lsn, r.attrs.batch_offset);
+          sem.post();
+        });
+    ASSERT_EQ(0, rv);
+  }
+  for (int i = 0; i < NAPPENDS; ++i) {
+    sem.wait();
+  }
+  const lsn_t lsn = results[0].first;
+  std::sort(results.begin(), results.end());
+  for (int i = 0; i < NAPPENDS; ++i) {
+    EXPECT_EQ(std::make_pair(lsn, i), results[i]);
+  }
+
+  auto reader = client->createReader(1);
+  ASSERT_EQ(0, reader->startReading(LOG_ID, lsn, lsn));
+  reader->setTimeout(std::chrono::milliseconds(100));
+  std::vector<std::unique_ptr<DataRecord>> data;
+  while (data.size() < (size_t)NAPPENDS) {
+    GapRecord gap;
+    reader->read(NAPPENDS - data.size(), &data, &gap);
+  }
+  for (int i = 0; i < NAPPENDS; ++i) {
+    EXPECT_EQ(std::to_string(i), data[i]->payload.toString());
+    EXPECT_EQ(i, data[i]->attrs.batch_offset);
+  }
+}
+
 // Test a tricky interaction between BufferedWriter and AsyncReader.  If the
 // application rejects a record that was part of a buffered write, AsyncReader
 // needs to carefully handle it.
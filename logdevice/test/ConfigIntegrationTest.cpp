@@ -372,6 +372,77 @@ TEST_F(ConfigIntegrationTest, RemoteLogsConfigWithLogsConfigManagerTest) {
   ASSERT_EQ(3, log_cfg->attrs().replicationFactor().value());
 }
 
+TEST_F(ConfigIntegrationTest, RemoteLogsConfigBoundedCacheTest) {
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .useHashBasedSequencerAssignment()
+                     .enableLogsConfigManager()
+                     .create(1);
+  std::shared_ptr<Client> client = cluster->createClient();
+
+  ASSERT_NE(nullptr, client->makeDirectorySync("/dir", false));
+  ASSERT_NE(nullptr,
+            client->makeLogGroupSync("/dir/log1",
+                                     logid_range_t(logid_t(1), logid_t(100)),
+                                     client::LogAttributes(),
+                                     false));
+  ASSERT_NE(nullptr,
+            client->makeLogGroupSync("/dir/log2",
+                                     logid_range_t(logid_t(201), logid_t(300)),
+                                     client::LogAttributes(),
+                                     false));
+  ASSERT_NE(nullptr,
+            client->makeLogGroupSync("/dir/log3",
+                                     logid_range_t(logid_t(301), logid_t(400)),
+                                     client::LogAttributes(),
+                                     false));
+
+  std::string client_config_path(cluster->getConfigPath() + "_client");
+  boost::filesystem::copy_file(cluster->getConfigPath(), client_config_path);
+  auto client2 = ClientFactory()
+                     .setSetting("on-demand-logs-config", "true")
+                     .setSetting("remote-logs-config-cache-size", "2")
+                     .setTimeout(testTimeout())
+                     .create(client_config_path);
+  ASSERT_TRUE((bool)client2);
+  auto config = static_cast<ClientImpl*>(client2.get())->getConfig()->get();
+  auto rlc =
+      std::dynamic_pointer_cast<const RemoteLogsConfig>(config->logsConfig());
+  ASSERT_NE(nullptr, rlc);
+
+  ASSERT_NE(nullptr, config->getLogGroupByIDShared(logid_t(1)));
+  ASSERT_NE(nullptr, config->getLogGroupByIDShared(logid_t(201)));
+  EXPECT_TRUE(rlc->isInIdCache(logid_t(1)));
+  EXPECT_TRUE(rlc->isInIdCache(logid_t(201)));
+
+  // Touch log1 so that log2 becomes the least recently used
+  ASSERT_NE(nullptr, config->getLogGroupByIDShared(logid_t(50)));
+  ASSERT_NE(nullptr, config->getLogGroupByIDShared(logid_t(301)));
+  EXPECT_TRUE(rlc->isInIdCache(logid_t(1)));
+  EXPECT_FALSE(rlc->isInIdCache(logid_t(201)));
+  EXPECT_TRUE(rlc->isInIdCache(logid_t(350)));
+
+  // An evicted log group is fetched again
+  auto log2 = config->getLogGroupByIDShared(logid_t(250));
+  ASSERT_NE(nullptr, log2);
+  EXPECT_EQ(logid_range_t(logid_t(201), logid_t(300)), log2->range());
+
+  // With sibling prefetch, fetching log1 brings in the rest of /dir
+  auto client3 = ClientFactory()
+                     .setSetting("on-demand-logs-config", "true")
+                     .setSetting("remote-logs-config-prefetch-siblings", "true")
+                     .setTimeout(testTimeout())
+                     .create(client_config_path);
+  ASSERT_TRUE((bool)client3);
+  auto config3 = static_cast<ClientImpl*>(client3.get())->getConfig()->get();
+  auto rlc3 =
+      std::dynamic_pointer_cast<const RemoteLogsConfig>(config3->logsConfig());
+  ASSERT_NE(nullptr, rlc3);
+  ASSERT_NE(nullptr, config3->getLogGroupByIDShared(logid_t(1)));
+  wait_until("siblings are prefetched", [&]() {
+    return rlc3->isInIdCache(logid_t(201)) && rlc3->isInIdCache(logid_t(301));
+  });
+}
+
 TEST_F(ConfigIntegrationTest,
        RemoteLogsConfigWithSubscriptionAndConnectionFailedTest) {
   auto cluster = IntegrationTestUtils::ClusterFactory()
@@ -301,6 +301,35 @@ TEST_F(SequencerBatchingTest, DISABLED_RollingRestart) {
   ASSERT_EQ(expected_statuses, statuses);
 }
 
+// With adaptive batching, a log whose append rate is too low to fill a batch
+// within its time trigger is not batched.
+TEST_F(SequencerBatchingTest, AdaptiveLowRateLogPassesThrough) {
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .setParam("--sequencer-batching")
+                     .setParam("--sequencer-batching-adaptive")
+                     .setParam("--sequencer-batching-adaptive-min-records",
+                               "1000000")
+                     .create(1);
+  auto client = cluster->createClient(this->testTimeout());
+
+  std::set<lsn_t> lsns;
+  const int NWRITES = 10;
+  std::string payload = "payloadcompressible";
+  for (int i = 1; i <= NWRITES; ++i) {
+    lsn_t lsn = client->appendSync(logid_t(1), payload);
+    ASSERT_NE(LSN_INVALID, lsn);
+    lsns.insert(lsn);
+  }
+  // Every record got its own LSN.
+  ASSERT_EQ(NWRITES, lsns.size());
+
+  // The rate can't be estimated until a bit of time has passed since the
+  // first append, which may have been batched.
+  auto stats = cluster->getNode(0).stats();
+  ASSERT_GE(stats["append_bytes_seq_batching_adaptive_passthru"],
+            (NWRITES - 1) * payload.size());
+}
+
 TEST_F(SequencerBatchingTest, DifferentLogGroupSettings) {
   auto cluster = IntegrationTestUtils::ClusterFactory()
                      .enableMessageErrorInjection()
@@ -123,6 +123,17 @@ TailRecordIntegrationTest::checkTail(std::shared_ptr<ClientImpl>& client,
   EXPECT_FALSE(tail_record->containOffsetWithinEpoch());
   EXPECT_EQ(
       tail_attribute->offsets, OffsetMap::toRecord(tail_record->offsets_map_));
+  // the bulk API agrees with the per-log one
+  std::vector<LogTailAttributesResult> bulk;
+  ASSERT_EQ(0, client->getTailAttributesBulkSync({LOG_ID, LOG_ID}, &bulk));
+  ASSERT_EQ(1, bulk.size());
+  EXPECT_EQ(LOG_ID, bulk[0].log_id);
+  ASSERT_NE(nullptr, bulk[0].attributes);
+  EXPECT_EQ(tail_attribute->last_released_real_lsn,
+            bulk[0].attributes->last_released_real_lsn);
+  EXPECT_EQ(tail_attribute->last_timestamp, bulk[0].attributes->last_timestamp);
+  EXPECT_EQ(tail_attribute->offsets, bulk[0].attributes->offsets);
+
   if (data_record) {
     EXPECT_EQ(tail_attribute->last_released_real_lsn, data_record->attrs.lsn);
     EXPECT_EQ(tail_attribute->last_timestamp, data_record->attrs.timestamp);
@@ -240,6 +251,18 @@ TEST_F(TailRecordIntegrationTest, LogNotFound) {
   auto tail_lsn = client->getTailLSNSync(logid_t(41));
   ASSERT_EQ(LSN_INVALID, tail_lsn);
   ASSERT_EQ(E::NOTFOUND, err);
+
+  // The bulk API reports it per log
+  std::vector<LogTailAttributesResult> bulk;
+  ASSERT_EQ(
+      -1, client->getTailAttributesBulkSync({LOG_ID, logid_t(41)}, &bulk));
+  ASSERT_EQ(E::PARTIAL, err);
+  ASSERT_EQ(2, bulk.size());
+  EXPECT_EQ(E::OK, bulk[0].status);
+  EXPECT_NE(nullptr, bulk[0].attributes);
+  EXPECT_EQ(logid_t(41), bulk[1].log_id);
+  EXPECT_EQ(E::NOTFOUND, bulk[1].status);
+  EXPECT_EQ(nullptr, bulk[1].attributes);
 }
 
 // TODO: test empty record payload and large payload cases
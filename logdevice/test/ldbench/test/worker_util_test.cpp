@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include "logdevice/common/debug.h"
+#include "logdevice/test/ldbench/worker/Histogram.h"
 #include "logdevice/test/ldbench/worker/util.h"
 
 using namespace facebook::logdevice::ldbench;
@@ -67,6 +68,74 @@ TEST_F(WorkerUtilTest, Log2Histogram) {
   EXPECT_NEAR(sum_float / iters, h.getMean(), 1e-1);
 }
 
+TEST_F(WorkerUtilTest, Log2HistogramLogNormal) {
+  Log2Histogram h;
+  EXPECT_FALSE(h.parse("lognormal:"));
+  EXPECT_FALSE(h.parse("lognormal:0"));
+  EXPECT_FALSE(h.parse("lognormal:-1"));
+  EXPECT_FALSE(h.parse("lognormal:5"));
+  EXPECT_FALSE(h.parse("lognormal:x"));
+
+  ASSERT_TRUE(h.parse("lognormal:1"));
+  ASSERT_EQ(63, h.p.size());
+  // The median is at the boundary of buckets 30 and 31, and the distribution
+  // is symmetric around it.
+  EXPECT_NEAR(.5, h.p[30], 1e-9);
+  auto b = h.toBucketProbabilities();
+  EXPECT_NEAR(b[30], b[31], 1e-9);
+  EXPECT_NEAR(b[29], b[32], 1e-9);
+  EXPECT_GT(b[31], b[32]);
+
+  // Wider sigma means more mass in the tails.
+  Log2Histogram wide;
+  ASSERT_TRUE(wide.parse("lognormal:2.5"));
+  EXPECT_GT(1 - wide.p[33], 1 - h.p[33]);
+
+  const double target_mean = 1000;
+  RoughProbabilityDistribution d(target_mean, h);
+  const int iters = 1000000;
+  double sum = 0;
+  for (int i = 0; i < iters; ++i) {
+    sum += d.sampleFloat();
+  }
+  EXPECT_NEAR(target_mean, sum / iters, 10);
+}
+
+TEST_F(WorkerUtilTest, EmpiricalDistribution) {
+  EmpiricalDistribution d;
+  EXPECT_TRUE(d.empty());
+  EXPECT_FALSE(d.parse(""));
+  EXPECT_FALSE(d.parse("# nothing\n\n"));
+  EXPECT_FALSE(d.parse("100 1 1"));
+  EXPECT_FALSE(d.parse("-1"));
+  EXPECT_FALSE(d.parse("100 -1"));
+  EXPECT_FALSE(d.parse("1k"));
+  EXPECT_FALSE(d.parse("100 0"));
+
+  ASSERT_TRUE(d.parse("# size count\n"
+                      "100 3\n"
+                      "\n"
+                      "  2000\t1  \n"
+                      "7 0\n"
+                      "50000"));
+  EXPECT_FALSE(d.empty());
+  EXPECT_DOUBLE_EQ((300. + 2000 + 50000) / 5, d.getMean());
+  EXPECT_EQ(100, d.sample(0));
+  EXPECT_EQ(100, d.sample(0.59));
+  EXPECT_EQ(2000, d.sample(0.61));
+  EXPECT_EQ(50000, d.sample(0.81));
+  EXPECT_EQ(50000, d.sample(0.999999));
+
+  const int iters = 100000;
+  int hundreds = 0;
+  for (int i = 0; i < iters; ++i) {
+    uint64_t x = d.sample();
+    EXPECT_TRUE(x == 100 || x == 2000 || x == 50000);
+    hundreds += x == 100;
+  }
+  EXPECT_NEAR(.6, hundreds * 1. / iters, 1e-2);
+}
+
 TEST_F(WorkerUtilTest, RoughProbabilityDistribution) {
   RoughProbabilityDistribution d;
   EXPECT_EQ(0, d.sampleFloat());
@@ -226,3 +295,44 @@ TEST_F(WorkerUtilTest, RandomEventSequence) {
   EXPECT_NEAR(cnt_hi, 5e3, 1e3);
   EXPECT_NEAR(cnt_lo, 5e3, 1e3);
 }
+
+TEST_F(WorkerUtilTest, HdrHistogram) {
+  HdrHistogram h;
+  EXPECT_EQ(0, h.percentile(50));
+
+  // Small values are exact.
+  for (uint64_t v = 1; v <= 100; ++v) {
+    h.add(v);
+  }
+  EXPECT_EQ(100, h.count());
+  EXPECT_EQ(50, h.percentile(50));
+  EXPECT_EQ(99, h.percentile(99));
+  EXPECT_EQ(100, h.percentile(100));
+
+  // Large values are within 1/64 above the exact percentile.
+  HdrHistogram g;
+  for (uint64_t v = 1; v <= 1000000; ++v) {
+    g.add(v * 1000);
+  }
+  EXPECT_EQ(1000000000, g.max());
+  for (double p : {50., 90., 99.9, 99.99}) {
+    uint64_t exact = std::llround(p * 10000) * 1000;
+    EXPECT_GE(g.percentile(p), exact);
+    EXPECT_LE(g.percentile(p), exact + exact / 64);
+  }
+
+  // A single outlier shows up in the tail, never beyond the max.
+  HdrHistogram o;
+  for (int i = 0; i < 9999; ++i) {
+    o.add(10);
+  }
+  o.add(123456789);
+  EXPECT_EQ(10, o.percentile(99.9));
+  EXPECT_EQ(123456789, o.percentile(100));
+
+  o.reset();
+  EXPECT_EQ(0, o.count());
+  EXPECT_EQ(0, o.percentile(99));
+  o.add(5);
+  EXPECT_EQ(5, o.percentile(100));
+}
@@ -11,6 +11,13 @@
 #include <functional>
 #include <iostream>
 
+#include <folly/Conv.h>
+#include <folly/json.h>
+#include <sys/resource.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/test/ldbench/worker/ServerStatsCollector.h"
+
 namespace facebook { namespace logdevice { namespace ldbench {
 
 BenchStats::BenchStats(const std::string& type)
@@ -117,10 +124,19 @@ folly::dynamic BenchStatsHolder::aggregateAllStats() {
 BenchStatsCollectionThread::BenchStatsCollectionThread(
     std::shared_ptr<BenchStatsHolder> stats_source,
     std::shared_ptr<StatsStore> stats_store,
-    uint64_t interval)
+    uint64_t interval,
+    std::shared_ptr<ServerStatsCollector> server_stats)
     : stats_source_(std::move(stats_source)),
       stats_store_(std::move(stats_store)),
+      server_stats_(std::move(server_stats)),
       interval_(interval) {
+  folly::dynamic initial =
+      folly::dynamic::object("success", 0)("success_byte", 0);
+  if (server_stats_) {
+    initial["server"] = server_stats_->collect();
+  }
+  first_sample_ = takeSample(initial);
+  prev_sample_ = first_sample_;
   function_scheduler_.addFunction(
       std::bind(&BenchStatsCollectionThread::statsCollectionFunction, this),
       std::chrono::seconds(interval),
@@ -133,6 +149,13 @@ BenchStatsCollectionThread::~BenchStatsCollectionThread() {
   function_scheduler_.shutdown();
   // We write one more time otherwise will miss some stats based on testing
   statsCollectionFunction();
+
+  folly::dynamic total = folly::dynamic::object();
+  addCpuEfficiency(first_sample_, prev_sample_, &total);
+  if (!total.empty()) {
+    ld_info("CPU per operation over the bench: %s",
+            folly::toJson(total).c_str());
+  }
   return;
 }
 
@@ -140,8 +163,67 @@ void BenchStatsCollectionThread::statsCollectionFunction() {
   auto cur_stats = stats_source_->aggregateAllStats();
   cur_stats["timestamp"] =
       std::chrono::system_clock::now().time_since_epoch().count();
+  if (server_stats_) {
+    cur_stats["server"] = server_stats_->collect();
+  }
+  CpuSample sample = takeSample(cur_stats);
+  cur_stats["cpu_usec"] = sample.client_cpu_usec;
+  addCpuEfficiency(prev_sample_, sample, &cur_stats);
+  prev_sample_ = sample;
   stats_store_->writeCurrentStats(cur_stats);
   return;
 }
 
+BenchStatsCollectionThread::CpuSample
+BenchStatsCollectionThread::takeSample(const folly::dynamic& stats) const {
+  CpuSample sample;
+  sample.client_cpu_usec = processCpuUsec();
+  sample.records = stats["success"].asInt();
+  sample.bytes = stats["success_byte"].asInt();
+  auto server = stats.get_ptr("server");
+  auto all = server ? server->get_ptr("all") : nullptr;
+  if (all) {
+    auto user = all->get_ptr("process_cpu_user_usec");
+    auto system = all->get_ptr("process_cpu_system_usec");
+    if (user && system) {
+      sample.server_cpu_usec = user->asInt() + system->asInt();
+    }
+  }
+  return sample;
+}
+
+void BenchStatsCollectionThread::addCpuEfficiency(const CpuSample& from,
+                                                  const CpuSample& to,
+                                                  folly::dynamic* out) {
+  int64_t records = to.records - from.records;
+  int64_t bytes = to.bytes - from.bytes;
+  if (records <= 0 || bytes <= 0) {
+    return;
+  }
+  auto add = [&](const char* prefix, double cpu_usec) {
+    (*out)[folly::to<std::string>(prefix, "cpu_usec_per_mb")] =
+        cpu_usec * 1e6 / bytes;
+    (*out)[folly::to<std::string>(prefix, "cpu_usec_per_record")] =
+        cpu_usec / records;
+  };
+  add("", double(to.client_cpu_usec) - from.client_cpu_usec);
+  // A node that didn't respond to one of the queries makes the difference
+  // meaningless; it's usually negative then.
+  if (from.server_cpu_usec.has_value() && to.server_cpu_usec.has_value() &&
+      *to.server_cpu_usec >= *from.server_cpu_usec) {
+    add("server_", double(*to.server_cpu_usec) - *from.server_cpu_usec);
+  }
+}
+
+uint64_t processCpuUsec() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  auto usec = [](const struct timeval& tv) {
+    return uint64_t(tv.tv_sec) * 1000000 + tv.tv_usec;
+  };
+  return usec(usage.ru_utime) + usec(usage.ru_stime);
+}
+
 }}} // namespace facebook::logdevice::ldbench
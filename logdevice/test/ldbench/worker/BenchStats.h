@@ -10,6 +10,7 @@
 
 #include <chrono>
 
+#include <folly/Optional.h>
 #include <folly/ThreadLocal.h>
 #include <folly/dynamic.h>
 #include <folly/experimental/FunctionScheduler.h>
@@ -19,6 +20,8 @@
 
 namespace facebook { namespace logdevice { namespace ldbench {
 
+class ServerStatsCollector;
+
 enum class StatsType { SUCCESS, SUCCESS_BYTE, FAILURE, INFLIGHT, SKIPPED };
 
 /**
@@ -150,17 +153,36 @@ struct BenchStatsHolder::BenchStatsWrapper {
   }
 };
 
+/**
+ * @return  user plus system CPU time used by this process so far, in
+ *          microseconds.
+ */
+uint64_t processCpuUsec();
+
 class BenchStatsCollectionThread {
  public:
+  // Totals at some point of the bench, see addCpuEfficiency().
+  struct CpuSample {
+    uint64_t client_cpu_usec = 0;
+    // Sum of the process_cpu_* server stats over the nodes, if collected.
+    folly::Optional<uint64_t> server_cpu_usec;
+    int64_t records = 0;
+    int64_t bytes = 0;
+  };
+
   /**
    * @param:
    *  stat_source
    *  stats_store
    *  interval -- stats collection interval in seconds
+   *  server_stats -- if not null, server stats are written along with
+   *                  client stats under "server"
    */
-  BenchStatsCollectionThread(std::shared_ptr<BenchStatsHolder> stats_source,
-                             std::shared_ptr<StatsStore> stats_store,
-                             uint64_t interval_s);
+  BenchStatsCollectionThread(
+      std::shared_ptr<BenchStatsHolder> stats_source,
+      std::shared_ptr<StatsStore> stats_store,
+      uint64_t interval_s,
+      std::shared_ptr<ServerStatsCollector> server_stats = nullptr);
   ~BenchStatsCollectionThread();
   /**
    * Collect stats from stats_source and publish it to stats_des
@@ -168,10 +190,30 @@ class BenchStatsCollectionThread {
    */
   void statsCollectionFunction();
 
+  /**
+   * Adds to *out the CPU used between two samples per MB (10^6 bytes) and
+   * per record of successful operations: "cpu_usec_per_mb" and
+   * "cpu_usec_per_record" for this process, "server_cpu_usec_per_mb" and
+   * "server_cpu_usec_per_record" for the servers if both samples have their
+   * CPU. Adds nothing if no operations succeeded in between.
+   *
+   * Throughput doesn't drop while a test cluster has spare capacity, but
+   * CPU per operation grows as soon as something gets less efficient.
+   */
+  static void addCpuEfficiency(const CpuSample& from,
+                               const CpuSample& to,
+                               folly::dynamic* out);
+
  private:
+  CpuSample takeSample(const folly::dynamic& stats) const;
+
   std::shared_ptr<BenchStatsHolder> stats_source_;
   std::shared_ptr<StatsStore> stats_store_;
+  std::shared_ptr<ServerStatsCollector> server_stats_;
   std::chrono::seconds interval_;
+  // Samples at the start of the bench and at the previous collection.
+  CpuSample first_sample_;
+  CpuSample prev_sample_;
   folly::FunctionScheduler function_scheduler_;
 };
 
@@ -38,4 +38,36 @@ TEST_F(BenchStatsTest, updateStatsTest) {
   EXPECT_EQ(3, stats_obj2["success"].asInt());
 }
 
+TEST_F(BenchStatsTest, cpuEfficiencyTest) {
+  BenchStatsCollectionThread::CpuSample from;
+  from.client_cpu_usec = 1000;
+  from.server_cpu_usec = 5000;
+  from.records = 10;
+  from.bytes = 1000;
+  BenchStatsCollectionThread::CpuSample to = from;
+  to.client_cpu_usec = 3000;
+  to.server_cpu_usec = 9000;
+  to.records = 110;
+  to.bytes = 2001000;
+
+  folly::dynamic out = folly::dynamic::object();
+  BenchStatsCollectionThread::addCpuEfficiency(from, to, &out);
+  EXPECT_DOUBLE_EQ(1000, out["cpu_usec_per_mb"].asDouble());
+  EXPECT_DOUBLE_EQ(20, out["cpu_usec_per_record"].asDouble());
+  EXPECT_DOUBLE_EQ(2000, out["server_cpu_usec_per_mb"].asDouble());
+  EXPECT_DOUBLE_EQ(40, out["server_cpu_usec_per_record"].asDouble());
+
+  // No server CPU in one of the samples, or a node missing from it.
+  out = folly::dynamic::object();
+  to.server_cpu_usec = 4000;
+  BenchStatsCollectionThread::addCpuEfficiency(from, to, &out);
+  EXPECT_EQ(2, out.size());
+  EXPECT_EQ(0, out.count("server_cpu_usec_per_mb"));
+
+  // Nothing succeeded.
+  out = folly::dynamic::object();
+  BenchStatsCollectionThread::addCpuEfficiency(from, from, &out);
+  EXPECT_TRUE(out.empty());
+}
+
 }}} // namespace facebook::logdevice::ldbench
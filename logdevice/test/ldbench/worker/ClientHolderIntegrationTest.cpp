@@ -54,7 +54,12 @@ class ClientHolderIntegrationTest : public ::testing::Test {
 
   void appendByHolder() {
     client_holder_ = std::make_unique<LogStoreClientHolder>();
-    auto worker_cb = [this](LogIDType, bool, bool, uint64_t, uint64_t) {
+    auto worker_cb = [this](LogIDType,
+                            bool,
+                            bool,
+                            uint64_t,
+                            uint64_t,
+                            const ContextSet&) {
       stop_ = true;
       cv_.notify_all();
     };
@@ -9,7 +9,11 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 #include "logdevice/common/checks.h"
@@ -82,4 +86,97 @@ void equi_depth_histogram(SampleIt samples_begin,
   *lower_bounds++ = max_sample;
 }
 
+/**
+ * HDR-style histogram of non-negative integers, e.g. latencies in
+ * microseconds. Covers the whole range of uint64_t with a relative error of
+ * at most 1/64 in constant memory, so percentiles far in the tail (p99.9,
+ * p99.99) are as accurate as the median, unlike percentiles of a bounded
+ * sample reservoir.
+ *
+ * Values below 128 get a bucket each. Every power-of-two range
+ * [2^m, 2^(m+1)) above that is split into 64 equal buckets.
+ *
+ * add() is lock-free and may be called from any thread.
+ */
+class HdrHistogram {
+ public:
+  void add(uint64_t value) {
+    counts_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (value > prev && !max_.compare_exchange_weak(
+                               prev, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return  a value v such that at least p% of the values added are <= v,
+   *          overestimated by at most the relative error of the histogram;
+   *          0 if the histogram is empty.
+   */
+  uint64_t percentile(double p) const {
+    uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(
+        1, std::min<uint64_t>(total, std::ceil(total * p / 100)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(bucketHighest(i), max());
+      }
+    }
+    return max();
+  }
+
+  // Forgets all values. Values added concurrently may be partially counted.
+  void reset() {
+    for (auto& c : counts_) {
+      c.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int kSubBucketBits = 7;
+  static constexpr uint64_t kSubBuckets = 1ull << kSubBucketBits;
+  static constexpr uint64_t kHalf = kSubBuckets / 2;
+  static constexpr size_t kNumBuckets =
+      kSubBuckets + (64 - kSubBucketBits) * kHalf;
+
+  static size_t bucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - kSubBucketBits + 1;
+    return kSubBuckets + (shift - 1) * kHalf + ((value >> shift) - kHalf);
+  }
+
+  // Largest value that falls into bucket `idx`.
+  static uint64_t bucketHighest(size_t idx) {
+    if (idx < kSubBuckets) {
+      return idx;
+    }
+    int shift = (idx - kSubBuckets) / kHalf + 1;
+    uint64_t sub = (idx - kSubBuckets) % kHalf;
+    return ((sub + kHalf) << shift) + ((1ull << shift) - 1);
+  }
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
 }}} // namespace facebook::logdevice::ldbench
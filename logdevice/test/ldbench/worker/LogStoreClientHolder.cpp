@@ -15,6 +15,7 @@
 #include <folly/Random.h>
 
 #include "logdevice/common/ConstructorFailed.h"
+#include "logdevice/lib/ClientImpl.h"
 #include "logdevice/test/ldbench/worker/BenchStats.h"
 #include "logdevice/test/ldbench/worker/BenchTracer.h"
 #include "logdevice/test/ldbench/worker/FileBasedEventStore.h"
@@ -24,6 +25,7 @@
 #include "logdevice/test/ldbench/worker/LogStoreReader.h"
 #include "logdevice/test/ldbench/worker/Options.h"
 #include "logdevice/test/ldbench/worker/RecordWriterInfo.h"
+#include "logdevice/test/ldbench/worker/ServerStatsCollector.h"
 
 #ifdef BUILDKAFKA
 #include "logdevice/test/ldbench/worker/KafkaClient.h"
@@ -47,9 +49,6 @@ LogStoreClientHolder::LogStoreClientHolder() {
                                                     options.worker_id_index,
                                                     "_.csv");
     stats_store_ = std::make_shared<FileBasedStatsStore>(stats_file);
-    // create collection thread for stats
-    collect_thread_ = std::make_unique<BenchStatsCollectionThread>(
-        bench_stats_holder_, stats_store_, options.stats_interval);
     // create event store
     if (options.event_ratio > 0 && filename != "backfill") {
       std::string event_file = folly::to<std::string>(options.publish_dir,
@@ -89,10 +88,47 @@ LogStoreClientHolder::LogStoreClientHolder() {
                 std::placeholders::_3,
                 std::placeholders::_4,
                 std::placeholders::_5));
+
+  if (stats_store_) {
+    // create collection thread for stats, after the client because server
+    // nodes are found in its config
+    collect_thread_ = std::make_unique<BenchStatsCollectionThread>(
+        bench_stats_holder_,
+        stats_store_,
+        options.stats_interval,
+        makeServerStatsCollector());
+  }
 }
 
 LogStoreClientHolder::~LogStoreClientHolder() {}
 
+std::shared_ptr<ServerStatsCollector>
+LogStoreClientHolder::makeServerStatsCollector() {
+  if (options.server_stats.empty() && options.server_histograms.empty()) {
+    return nullptr;
+  }
+  std::vector<folly::SocketAddress> nodes = options.server_stats_nodes;
+  if (nodes.empty() && options.sys_name == "logdevice") {
+    auto client = std::static_pointer_cast<Client>(getRawClient());
+    auto nodes_config = static_cast<ClientImpl*>(client.get())
+                            ->getConfig()
+                            ->getNodesConfiguration();
+    for (const auto& kv : *nodes_config->getServiceDiscovery()) {
+      if (kv.second.admin_address.has_value()) {
+        nodes.push_back(kv.second.admin_address->getSocketAddress());
+      }
+    }
+  }
+  if (nodes.empty()) {
+    ld_warning("No nodes to get server stats from. Use --server-stats-nodes.");
+    return nullptr;
+  }
+  return std::make_shared<ServerStatsCollector>(std::move(nodes),
+                                                options.server_stats,
+                                                options.server_histograms,
+                                                options.client_timeout);
+}
+
 std::unique_ptr<LogStoreReader> LogStoreClientHolder::createReader() {
   return client_->createReader();
 }
@@ -206,7 +242,8 @@ void LogStoreClientHolder::onAppendDone(bool successful,
                successful,
                options.use_buffered_writer,
                contexts.size(),
-               payload_size);
+               payload_size,
+               contexts);
   }
   return;
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@ class LogStoreClient;
 class BenchStatsHolder;
 class StatsStore;
 class BenchStatsCollectionThread;
+class ServerStatsCollector;
 class BenchTracer;
 class EventStore;
 class Options;
@@ -138,6 +140,12 @@ class LogStoreClientHolder {
                 const std::string& payload,
                 std::string& event_name);
 
+  /**
+   * Returns nullptr if no server stats were requested with --server-stats
+   * or --server-histograms.
+   */
+  std::shared_ptr<ServerStatsCollector> makeServerStatsCollector();
+
   // Explaination of define order
   // callbacks of client use everything so client go first
   // bench_tracer uses event_store
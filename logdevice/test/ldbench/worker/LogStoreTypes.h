@@ -42,12 +42,15 @@ using write_stats_update_callback_t = std::function<void(bool successful,
                                                          ContextSet contexts)>;
 /**
  * write worker callback (WriteWorker::onAppendDone)
+ *   contexts -- context and payload of each of the num_records appends
  */
-using write_worker_callback_t = std::function<void(LogIDType logid,
-                                                   bool successful,
-                                                   bool buffered,
-                                                   uint64_t num_records,
-                                                   uint64_t payload_bytes)>;
+using write_worker_callback_t =
+    std::function<void(LogIDType logid,
+                       bool successful,
+                       bool buffered,
+                       uint64_t num_records,
+                       uint64_t payload_bytes,
+                       const ContextSet& contexts)>;
 
 /**
  * callback for updating stats for reads
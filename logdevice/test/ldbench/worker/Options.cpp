@@ -8,13 +8,17 @@
 
 #include "logdevice/test/ldbench/worker/Options.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <cmath>
 #include <cstdio>
 #include <ctime>
 
 #include <boost/program_options.hpp>
+#include <folly/FileUtil.h>
 #include <folly/Optional.h>
 #include <folly/Random.h>
+#include <folly/String.h>
 #include <folly/experimental/EnvUtil.h>
 
 #include "logdevice/common/buffered_writer/BufferedWriterOptionsUtil.h"
@@ -50,6 +54,9 @@ std::set<std::string>& OptionsRestrictions::commonOptions() {
       "partition-by",
       "publish-dir",
       "stats-interval",
+      "server-stats",
+      "server-histograms",
+      "server-stats-nodes",
       "sys-name",
       "write-bytes-increase-interval",
       "write-bytes-increase-step",
@@ -398,6 +405,32 @@ void Options::get_named_options(options_description& named) {
                       chrono_value(&write_bytes_increase_interval),
                       "How often to increase the write-record-per-second on "
                       "average. 0 or non-configure to never increase");
+  named.add_options()(
+      "saturation-latency-slo",
+      chrono_value(&saturation_latency_slo),
+      "If nonzero, search for the highest write throughput the cluster "
+      "sustains with append latency within this SLO. Each "
+      "--write-bytes-increase-interval is a step of the search: the "
+      "throughput ramps up with --write-bytes-increase-factor or "
+      "--write-bytes-increase-step until a step violates the SLO, fails too "
+      "many appends or falls behind the target, then binary-searches. The "
+      "bench stops when the search is done and reports the rate found, the "
+      "knee of the latency curve and what limited the throughput.");
+  named.add_options()(
+      "saturation-latency-percentile",
+      value<double>(&saturation_latency_percentile)->default_value(99),
+      "Latency percentile that --saturation-latency-slo applies to.");
+  named.add_options()(
+      "saturation-max-error-rate",
+      value<double>(&saturation_max_error_rate)->default_value(0.001),
+      "Highest fraction of failed appends in a sustainable step of "
+      "--saturation-latency-slo search.");
+  named.add_options()(
+      "saturation-precision",
+      value<double>(&saturation_precision)->default_value(0.05),
+      "--saturation-latency-slo search stops when the highest sustainable "
+      "and the lowest unsustainable throughput are within this fraction of "
+      "each other.");
   named.add_options()(
       "rate-limit-bytes",
       value<std::string>()
@@ -509,6 +542,17 @@ void Options::get_named_options(options_description& named) {
             }
           }),
       "Like --max-appends-in-flight but in bytes.");
+  named.add_options()(
+      "open-loop",
+      value<bool>(&open_loop)->default_value(false),
+      "Issue appends on schedule regardless of how many are in flight, and "
+      "measure append latency from the time each append was scheduled rather "
+      "than from the time it was sent. Without this, a slow cluster makes the "
+      "writers append less, and the latency histogram doesn't include the time "
+      "appends spent waiting to be issued (coordinated omission). "
+      "--max-appends-in-flight and --max-window are ignored; "
+      "--max-append-bytes-in-flight still applies, as a guard against running "
+      "out of memory.");
   named.add_options()("use-buffered-writer",
                       value<bool>(&use_buffered_writer)->default_value(false),
                       "Append using BufferedWriter.");
@@ -550,6 +594,32 @@ void Options::get_named_options(options_description& named) {
       "compression on client followed by additional ~2x compression in "
       "sequencer; this can be simulated with --payload-entropy=0.455 "
       "--payload-entropy-sequencer=0.5");
+  named.add_options()(
+      "payload-size-file",
+      value<std::string>(&payload_size_file)->default_value(""),
+      "Draw payload sizes from the sizes listed in this file, e.g. captured "
+      "from production: one size per line, optionally followed by its "
+      "count. Overrides --payload-size and --payload-size-distribution; "
+      "--payload-size becomes the mean of the listed sizes. "
+      "--log-payload-size-distribution still applies on top.");
+  named.add_options()(
+      "payload-corpus",
+      value<std::string>(&payload_corpus_path)->default_value(""),
+      "File, or directory of files, to cut payloads from instead of "
+      "generating them, so that compression behaves like it would on real "
+      "data. Each payload is a slice of the corpus starting at a random "
+      "offset. Overrides --payload-entropy and --payload-entropy-sequencer.");
+  named.add_options()(
+      "payload-corpus-max-bytes",
+      value<std::string>()->default_value("1G")->notifier(
+          [this](const std::string& val) {
+            if (parse_scaled_int(val.c_str(), &payload_corpus_max_bytes) !=
+                0) {
+              throw boost::program_options::error(
+                  "Invalid payload-corpus-max-bytes: " + val);
+            }
+          }),
+      "How much of --payload-corpus to load into memory.");
   named.add_options()(
       "meta-requests-per-sec",
       value<uint64_t>(&meta_requests_per_sec)->default_value(100),
@@ -574,6 +644,13 @@ void Options::get_named_options(options_description& named) {
       "meta worker process. When exceeded, the worker stops making new "
       "requests "
       " until some of the in-flight requests complete.");
+  named.add_options()(
+      "scenario",
+      value<std::string>(&scenario_file),
+      "Path to a JSON file describing the phases of the 'scenario' benchmark: "
+      "how long each phase lasts, how many logs are tailed and the rate and "
+      "mix of appends, findTime()s, backfills and trims. See "
+      "ScenarioWorker.cpp for the format.");
   named.add_options()(
       "findtime-avg-time-ago",
       chrono_value(&findtime_avg_time_ago),
@@ -650,6 +727,44 @@ void Options::get_named_options(options_description& named) {
   named.add_options()("stats-interval",
                       value<uint64_t>(&stats_interval)->default_value(60),
                       "Time Interval (Int for Seconds) to publish stats");
+  named.add_options()(
+      "server-stats",
+      value<std::string>()->notifier([this](const std::string& val) {
+        folly::split(',', val, server_stats, /* ignoreEmpty */ true);
+      }),
+      "Comma-separated list of server stats to write to the stats file along "
+      "with client stats, every --stats-interval. A name ending with '*' "
+      "selects all stats starting with the rest of it, e.g. "
+      "\"append_success,storage_tasks_*\". Requires --publish-dir. Include "
+      "\"process_cpu_*\" to also get the servers' CPU per MB and per record "
+      "of the bench's operations.");
+  named.add_options()(
+      "server-histograms",
+      value<std::string>()->notifier([this](const std::string& val) {
+        folly::split(',', val, server_histograms, /* ignoreEmpty */ true);
+      }),
+      "Like --server-stats but for server histograms, e.g. "
+      "\"store_latency,rocks_delay\". Percentiles of each histogram are "
+      "written.");
+  named.add_options()(
+      "server-stats-nodes",
+      value<std::string>()->notifier([this](const std::string& val) {
+        std::vector<std::string> nodes;
+        folly::split(',', val, nodes, /* ignoreEmpty */ true);
+        for (const std::string& node : nodes) {
+          try {
+            folly::SocketAddress addr;
+            addr.setFromHostPort(node);
+            server_stats_nodes.push_back(addr);
+          } catch (const std::exception& e) {
+            throw boost::program_options::error(
+                "Invalid server-stats-nodes: " + node + ": " + e.what());
+          }
+        }
+      }),
+      "Comma-separated list of host:port admin API addresses to get "
+      "--server-stats and --server-histograms from. Defaults to all nodes in "
+      "the cluster config that have an admin address.");
   named.add_options()("event-sample-ratio",
                       value<double>(&event_ratio)->default_value(0),
                       "Double 0~1. The ratio to sample events.");
@@ -791,6 +906,40 @@ folly::Optional<int> parse_commandline_options(ClientSettingsImpl& settings,
     }
   }
 
+  if (!options.payload_size_file.empty()) {
+    std::string sizes;
+    if (!folly::readFile(options.payload_size_file.c_str(), sizes) ||
+        !options.payload_size_empirical.parse(sizes)) {
+      output << "Failed to read payload sizes from "
+             << options.payload_size_file << std::endl;
+      return 1;
+    }
+    // Rates given in bytes are converted to appends using the mean size.
+    options.payload_size = std::max<uint64_t>(
+        1, std::llround(options.payload_size_empirical.getMean()));
+  }
+  if (!options.payload_corpus_path.empty()) {
+    auto corpus = std::make_shared<PayloadCorpus>();
+    std::string error;
+    if (corpus->load(options.payload_corpus_path,
+                     options.payload_corpus_max_bytes,
+                     &error)) {
+      output << "Failed to load payload corpus: " << error << std::endl;
+      return 1;
+    }
+    options.payload_corpus = std::move(corpus);
+  }
+  if (options.saturation_latency_slo.count() > 0 &&
+      (options.write_bytes_increase_interval.count() <= 0 ||
+       (options.write_bytes_increase_factor <= 1.0 &&
+        options.write_bytes_increase_step == 0))) {
+    output << "--saturation-latency-slo needs "
+              "--write-bytes-increase-interval and either "
+              "--write-bytes-increase-factor > 1 or "
+              "--write-bytes-increase-step" << std::endl;
+    return 1;
+  }
+
   // TODO (#34402103): This is copy-pasted from readtestapp. Move it (or some
   // other authentication logic) to client plugin so readtestapp and ldbench
   // don't need to worry about it.
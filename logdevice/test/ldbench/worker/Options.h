@@ -10,18 +10,21 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <string>
 #include <vector>
 
 #include <folly/Optional.h>
+#include <folly/SocketAddress.h>
 
 #include "logdevice/common/ServerRecordFilter.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/BufferedWriter.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
+#include "logdevice/test/ldbench/worker/PayloadCorpus.h"
 #include "logdevice/test/ldbench/worker/util.h"
 
 namespace boost { namespace program_options {
@@ -63,10 +66,24 @@ struct Options {
   std::string publish_dir; // directory to store stats and event files
   uint64_t stats_interval; // stats snapshot interval (seconds)
   double event_ratio;      // event sampling ratio (0 ~ 1)
+  // Server stats and histograms to write along with BenchStats, see
+  // ServerStatsCollector. Nodes are admin API addresses; if empty, all nodes
+  // in the config that have one.
+  std::vector<std::string> server_stats;
+  std::vector<std::string> server_histograms;
+  std::vector<folly::SocketAddress> server_stats_nodes;
   std::chrono::milliseconds write_bytes_increase_interval =
       std::chrono::milliseconds(0);   // throughput increase interval
   uint64_t write_bytes_increase_step; // throughput increase step (B/second)
   double write_bytes_increase_factor; // increasing factor of throughput
+  // If nonzero, the throughput increases are steps of a search for the
+  // highest throughput whose latency stays within this SLO, see
+  // SaturationSearch.
+  std::chrono::milliseconds saturation_latency_slo =
+      std::chrono::milliseconds(0);
+  double saturation_latency_percentile;
+  double saturation_max_error_rate;
+  double saturation_precision;
   std::string sys_name;               // logdevice or kafka
   SystemTimestamp start_time;         // worker start time
 
@@ -119,15 +136,27 @@ struct Options {
   Log2Histogram log_payload_size_distribution;
   uint64_t max_appends_in_flight;
   uint64_t max_append_bytes_in_flight;
+  bool open_loop;
   bool use_buffered_writer;
   BufferedWriter::Options buffered_writer_options;
   double payload_entropy;
   double payload_entropy_sequencer;
+  // Loaded from --payload-size-file. If not empty, payload sizes are drawn
+  // from it instead of --payload-size-distribution.
+  std::string payload_size_file;
+  EmpiricalDistribution payload_size_empirical;
+  // Loaded from --payload-corpus. If not null, payloads are cut from it
+  // instead of being generated according to --payload-entropy.
+  std::string payload_corpus_path;
+  uint64_t payload_corpus_max_bytes;
+  std::shared_ptr<const PayloadCorpus> payload_corpus;
 
   // Options of metadata API benchmarks.
   uint64_t meta_requests_per_sec;
   Spikiness meta_requests_spikiness;
   uint64_t max_requests_in_flight;
+  // JSON file with the phases of the scenario worker. See ScenarioWorker.cpp.
+  std::string scenario_file;
   Log2Histogram log_requests_per_sec_distribution;
   // findTime options to help pick timestamps
   std::chrono::milliseconds findtime_avg_time_ago = std::chrono::minutes(30);
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/PayloadCorpus.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <folly/Random.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+namespace fs = boost::filesystem;
+
+bool PayloadCorpus::load(const std::string& path,
+                         size_t max_bytes,
+                         std::string* error) {
+  ld_check(error);
+  data_.clear();
+
+  std::vector<std::string> files;
+  boost::system::error_code ec;
+  if (fs::is_directory(path, ec)) {
+    for (fs::directory_iterator it(path, ec), end; !ec && it != end;
+         it.increment(ec)) {
+      if (fs::is_regular_file(it->status())) {
+        files.push_back(it->path().string());
+      }
+    }
+    if (ec) {
+      *error = "failed to list " + path + ": " + ec.message();
+      return true;
+    }
+    std::sort(files.begin(), files.end());
+  } else {
+    files.push_back(path);
+  }
+
+  for (const std::string& file : files) {
+    if (data_.size() >= max_bytes) {
+      break;
+    }
+    std::string contents;
+    if (!folly::readFile(
+            file.c_str(), contents, max_bytes - data_.size())) {
+      *error = "failed to read " + file;
+      return true;
+    }
+    data_ += contents;
+  }
+  if (data_.empty()) {
+    *error = path + " is empty";
+    return true;
+  }
+  ld_info("Loaded %lu bytes of payload corpus from %s",
+          data_.size(),
+          path.c_str());
+  return false;
+}
+
+void PayloadCorpus::fill(char* out, size_t size) const {
+  ld_check(!data_.empty());
+  size_t pos = folly::Random::rand64(data_.size());
+  while (size > 0) {
+    size_t n = std::min(size, data_.size() - pos);
+    std::copy(data_.data() + pos, data_.data() + pos + n, out);
+    out += n;
+    size -= n;
+    pos = 0;
+  }
+}
+
+}}} // namespace facebook::logdevice::ldbench
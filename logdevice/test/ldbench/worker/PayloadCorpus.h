@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+// Captured data (e.g. a dump of production records) to cut payloads from, so
+// that compression and batching see realistic data instead of the synthetic
+// mix of random and repeated bytes controlled by --payload-entropy.
+class PayloadCorpus {
+ public:
+  // Loads `path`, which is either a file or a directory whose regular files
+  // (not recursively) are concatenated in name order. Stops after max_bytes.
+  // Returns false on success, true on failure with *error set.
+  bool load(const std::string& path, size_t max_bytes, std::string* error);
+
+  // Copies `size` bytes of the corpus, starting at a random position, to
+  // `out`. Wraps around at the end of the corpus.
+  void fill(char* out, size_t size) const;
+
+  size_t size() const {
+    return data_.size();
+  }
+
+ private:
+  std::string data_;
+};
+
+}}} // namespace facebook::logdevice::ldbench
@@ -9,19 +9,22 @@
 #include <algorithm>
 #include <chrono>
 #include <cinttypes>
+#include <cmath>
 #include <condition_variable>
 #include <cstdint>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
-#include <unordered_set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <folly/Random.h>
 
 #include "logdevice/common/debug.h"
+#include "logdevice/include/AsyncReader.h"
 #include "logdevice/include/Client.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/Record.h"
@@ -48,6 +51,15 @@ static constexpr const char* BENCH_NAME = "read_your_write_latency";
  * set of logs is partitioned among concurrent writers so that each worker
  * only reads its own writes. (Otherwise, one would quickly exceed the read
  * bandwidth of workers.)
+ *
+ * Each log is tailed by round(--fanout) readers, each with its own
+ * AsyncReader, and a record counts as read once all of them delivered it.
+ * Besides the overall latency histogram, reports the latency distribution of
+ * every reader, and splits it into the append latency (until the append
+ * callback) and the time from the append callback to delivery. The sequencer
+ * releases a record as soon as it's stored, right before acknowledging the
+ * append, so the latter is mostly the time it takes the RELEASE to reach the
+ * storage nodes and the record to be pushed to the reader.
  */
 class ReadYourWriteLatencyWorker final : public SteadyWriteRateWorker {
  public:
@@ -62,14 +74,30 @@ class ReadYourWriteLatencyWorker final : public SteadyWriteRateWorker {
   using Sample = std::chrono::microseconds;
   struct PayloadHeader;
 
+  struct PendingRead {
+    // Number of readers that haven't delivered the record yet.
+    size_t nremaining;
+    // Time of the append callback. Zero until it's called.
+    TimePoint ack_time{};
+  };
+
+  struct ReaderStats {
+    // From append to delivery to this reader, in microseconds.
+    HdrHistogram delivery_latency_us;
+    // From the append callback to delivery to this reader, in microseconds.
+    HdrHistogram release_wait_us;
+  };
+
   /// Maximum number of samples to collect per output histogram bucket.
   static constexpr size_t OVERSAMPLE_FACTOR = 100;
   // Key that will pass filtering test.
   static constexpr const char* FILTER_KEY = "abcdefg";
 
+  bool startReaders(const LogToLsnMap& from_lsns);
   void printResult();
+  void printLatency();
   void appendCallback(Status status, const DataRecord& record);
-  void recordCallback(const DataRecord& record);
+  void recordCallback(size_t reader_idx, const DataRecord& record);
   void handleAppendSuccess(Payload payload) override;
   void handleAppendError(Status st, Payload payload) override;
   size_t getNumPendingXacts() const noexcept override;
@@ -80,8 +108,14 @@ class ReadYourWriteLatencyWorker final : public SteadyWriteRateWorker {
   uint64_t npending_appends_ = 0;
   bool collect_samples_ = false;
   bool error_ = false;
-  std::unordered_set<uint64_t> pending_reads_;
+  size_t num_readers_ = 1;
+  std::unordered_map<uint64_t, PendingRead> pending_reads_;
   std::unique_ptr<Reservoir<Sample>> reservoir_;
+  HdrHistogram append_latency_us_;
+  HdrHistogram release_wait_us_;
+  std::vector<std::unique_ptr<ReaderStats>> reader_stats_;
+  // Empty if options.pretend is true.
+  std::vector<std::unique_ptr<AsyncReader>> readers_;
 };
 
 struct ReadYourWriteLatencyWorker::PayloadHeader final {
@@ -106,6 +140,7 @@ struct ReadYourWriteLatencyWorker::PayloadHeader final {
 
 ReadYourWriteLatencyWorker::~ReadYourWriteLatencyWorker() {
   // Make sure no callbacks are called after this subclass is destroyed.
+  readers_.clear();
   destroyClient();
 }
 
@@ -113,7 +148,7 @@ std::string ReadYourWriteLatencyWorker::generatePayload(size_t size) {
   static_assert(
       sizeof(PayloadHeader) == 32, "Unexpected padding of PayloadHeader");
   auto record_id = next_record_id_++;
-  PayloadHeader header(worker_id, record_id, Clock::now(), false);
+  PayloadHeader header(worker_id, record_id, scheduled_append_time_, false);
   std::string payload(reinterpret_cast<char*>(&header), sizeof(header));
   if (size > sizeof(header)) {
     payload.append(generatePayload(size - sizeof(header)));
@@ -142,6 +177,11 @@ int ReadYourWriteLatencyWorker::run() {
   reservoir_ = std::make_unique<Reservoir<Sample>>(
       options.histogram_bucket_count * OVERSAMPLE_FACTOR);
 
+  num_readers_ = std::max<size_t>(1, std::llround(options.fanout));
+  for (size_t i = 0; i < num_readers_; ++i) {
+    reader_stats_.push_back(std::make_unique<ReaderStats>());
+  }
+
   // Clear append token bucket.
   token_bucket_.reset(token_bucket_.defaultClockNow());
 
@@ -150,13 +190,6 @@ int ReadYourWriteLatencyWorker::run() {
     appendCallback(status, record);
   });
 
-  // Async reader callback.
-  RecordCallback record_cb([this](std::unique_ptr<DataRecord>& record) {
-    recordCallback(*record);
-    record.reset();
-    return true;
-  });
-
   // Get tail LSN of each log in our log set partition.
   LogToLsnMap tail_lsns;
   if (getTailLSNs(tail_lsns, logs)) {
@@ -164,8 +197,8 @@ int ReadYourWriteLatencyWorker::run() {
   }
 
   // Start tailing our log set partition ("read your own writes").
-  ld_info("Starting reads");
-  if (startReading(tail_lsns, std::move(record_cb))) {
+  ld_info("Starting reads: nlogs=%zu, nreaders=%zu", logs.size(), num_readers_);
+  if (startReaders(tail_lsns)) {
     return 1;
   }
 
@@ -217,13 +250,13 @@ int ReadYourWriteLatencyWorker::run() {
   // Stop tailing.
   ld_info("Stopping reads");
   lock.unlock();
-  if (stopReading()) {
-    return 1;
-  }
+  // Destroying an AsyncReader stops all its reads.
+  readers_.clear();
   ld_info("All done");
 
   if (!error()) {
     // All is good.
+    printLatency();
     printResult();
     return 0;
   }
@@ -232,6 +265,63 @@ int ReadYourWriteLatencyWorker::run() {
   return 1;
 }
 
+bool ReadYourWriteLatencyWorker::startReaders(const LogToLsnMap& from_lsns) {
+  if (options.pretend) {
+    // Pretend mode. Do not actually read.
+    return false;
+  }
+  ld_check(client_ != nullptr);
+  ld_check(readers_.empty());
+
+  auto attrs = getReadAttrs();
+  for (size_t idx = 0; idx < num_readers_; ++idx) {
+    readers_.push_back(client_->createAsyncReader());
+    AsyncReader& reader = *readers_.back();
+    reader.setRecordCallback(
+        [this, idx](std::unique_ptr<DataRecord>& record) {
+          recordCallback(idx, *record);
+          record.reset();
+          return true;
+        });
+    for (const auto& entry : from_lsns) {
+      if (reader.startReading(
+              logid_t(entry.first), entry.second, LSN_MAX, &attrs) != 0) {
+        ld_error("Failed to start reading log %" PRIu64 ": %s (%s)",
+                 entry.first,
+                 error_name(err),
+                 error_description(err));
+        if (!options.ignore_errors) {
+          readers_.clear();
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+void ReadYourWriteLatencyWorker::printLatency() {
+  auto print = [](const char* what, const HdrHistogram& h) {
+    ld_info("%s in us over %lu samples: p50: %lu, p90: %lu, p99: %lu, "
+            "p99.9: %lu, max: %lu",
+            what,
+            h.count(),
+            h.percentile(50),
+            h.percentile(90),
+            h.percentile(99),
+            h.percentile(99.9),
+            h.max());
+  };
+  print("append latency", append_latency_us_);
+  print("append callback to delivery (RELEASE wait)", release_wait_us_);
+  for (size_t idx = 0; idx < num_readers_; ++idx) {
+    const ReaderStats& stats = *reader_stats_[idx];
+    std::string prefix = "reader " + std::to_string(idx) + ": ";
+    print((prefix + "delivery latency").c_str(), stats.delivery_latency_us);
+    print((prefix + "RELEASE wait").c_str(), stats.release_wait_us);
+  }
+}
+
 void ReadYourWriteLatencyWorker::printResult() {
   // Print number of reads i.e. number of insertions into sample reservoir.
   std::cout << reservoir_->getNumberOfInsertions() << '\n';
@@ -281,19 +371,35 @@ void ReadYourWriteLatencyWorker::appendCallback(Status status,
   // Handle append error, if any.
   if (status != E::OK) {
     handleAppendError(status, record.payload);
+  } else {
+    auto now = Clock::now();
+    if (collect_samples_) {
+      append_latency_us_.add(
+          std::chrono::duration_cast<Sample>(now - header.append_time)
+              .count());
+    }
+    // May be missing if all readers were faster than the append callback.
+    auto it = pending_reads_.find(header.record_id);
+    if (it != pending_reads_.end()) {
+      it->second.ack_time = now;
+    }
   }
   lock.unlock();
 
   if (status == E::OK && (options.pretend || header.filter_out)) {
-    // Pretend mode. There is no reader. Just call record callback immediately.
-    recordCallback(record);
+    // Pretend mode. There are no readers. Just call record callback
+    // immediately, as if every reader delivered the record.
+    for (size_t idx = 0; idx < num_readers_; ++idx) {
+      recordCallback(idx, record);
+    }
   }
 
   // Notify main thread in run().
   cond_var_.notify_one();
 }
 
-void ReadYourWriteLatencyWorker::recordCallback(const DataRecord& record) {
+void ReadYourWriteLatencyWorker::recordCallback(size_t reader_idx,
+                                                const DataRecord& record) {
   if (record.payload.size() >= sizeof(PayloadHeader)) {
     const auto& header =
         *static_cast<const PayloadHeader*>(record.payload.data());
@@ -313,16 +419,34 @@ void ReadYourWriteLatencyWorker::recordCallback(const DataRecord& record) {
         std::lock_guard<std::recursive_mutex> lock(mutex_);
         --nwaiting_;
 
+        // Once every reader has delivered the record, remove its id from
+        // pending reads. The id may be missing in case the append was
+        // considered failed but succeeded anyways. (That can happen in a
+        // distributed system and is the reason for keeping a map of record
+        // ids instead of a simple counter.)
+        Sample release_wait(0);
+        auto it = pending_reads_.find(header.record_id);
+        if (it != pending_reads_.end()) {
+          // If the record was delivered before the append callback was
+          // called, there was no wait for the RELEASE to speak of.
+          if (it->second.ack_time != TimePoint()) {
+            release_wait = std::max(
+                Sample(0),
+                std::chrono::duration_cast<Sample>(now - it->second.ack_time));
+          }
+          if (--it->second.nremaining == 0) {
+            pending_reads_.erase(it);
+          }
+        }
+
         // Put sample into reservoir (or not).
         if (collect_samples_) {
           reservoir_->put(latency_sample);
+          ReaderStats& stats = *reader_stats_[reader_idx];
+          stats.delivery_latency_us.add(latency_sample.count());
+          stats.release_wait_us.add(release_wait.count());
+          release_wait_us_.add(release_wait.count());
         }
-
-        // Remove record id from pending reads. May be a no-op in case the
-        // append was considered failed but succeeded anyways. (That can happen
-        // in a distributed system and is the reason for keeping a set of
-        // record ids instead of a simple counter.)
-        pending_reads_.erase(header.record_id);
       }
 
       // Notify main thread in tryAppend().
@@ -352,7 +476,8 @@ void ReadYourWriteLatencyWorker::handleAppendSuccess(Payload payload) {
   auto record_id = header.record_id;
 
   ++npending_appends_;
-  bool inserted = pending_reads_.insert(record_id).second;
+  bool inserted =
+      pending_reads_.emplace(record_id, PendingRead{num_readers_}).second;
   ld_check(inserted);
   (void)inserted;
 }
@@ -419,7 +544,9 @@ void registerReadYourWriteLatencyWorker() {
                                           "payload-size",
                                           "histogram-bucket-count",
                                           "filter-selectivity",
-                                          "write-rate"},
+                                          "fanout",
+                                          "write-rate",
+                                          "open-loop"},
                                          {PartitioningMode::LOG}));
 }
 
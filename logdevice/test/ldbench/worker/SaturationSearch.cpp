@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/SaturationSearch.h"
+
+#include <cmath>
+
+#include <folly/Format.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+constexpr double SaturationSearch::KEEP_UP_FRACTION;
+
+SaturationSearch::SaturationSearch(std::function<double(double)> ramp,
+                                   uint64_t latency_slo_us,
+                                   double max_error_rate,
+                                   double precision)
+    : ramp_(std::move(ramp)),
+      latency_slo_us_(latency_slo_us),
+      max_error_rate_(max_error_rate),
+      precision_(precision) {}
+
+bool SaturationSearch::isSustainable(const Step& step) const {
+  return describeBottleneck(step).empty();
+}
+
+std::string SaturationSearch::describeBottleneck(const Step& step) const {
+  std::string res;
+  auto append = [&](std::string s) {
+    res += (res.empty() ? "" : ", ") + s;
+  };
+  if (step.latency_us > latency_slo_us_) {
+    append(folly::sformat(
+        "latency {}us > SLO {}us", step.latency_us, latency_slo_us_));
+  }
+  if (step.error_rate > max_error_rate_) {
+    append(folly::sformat("{:.3f}% of appends failed", step.error_rate * 100));
+  }
+  if (step.achieved_rate < step.rate * KEEP_UP_FRACTION) {
+    append(folly::sformat("achieved only {:.0f} of {:.0f}",
+                          step.achieved_rate,
+                          step.rate));
+  }
+  return res;
+}
+
+folly::Optional<double> SaturationSearch::onStepDone(const Step& step) {
+  if (!knee_.has_value()) {
+    // Latency growing faster than the rate means that requests are queueing
+    // somewhere.
+    bool superlinear = prev_.has_value() && step.rate > prev_->rate &&
+        prev_->latency_us > 0 && step.latency_us > prev_->latency_us &&
+        std::log(double(step.latency_us) / prev_->latency_us) >
+            std::log(step.rate / prev_->rate);
+    if (step.error_rate > 0 || superlinear) {
+      knee_ = step;
+    }
+  }
+  prev_ = step;
+
+  bool ok = isSustainable(step);
+  if (ok && (!best_.has_value() || step.rate > best_->rate)) {
+    best_ = step;
+  }
+  if (ramping_) {
+    if (ok) {
+      lo_ = step.rate;
+      return ramp_(step.rate);
+    }
+    ramping_ = false;
+    first_unsustainable_ = step;
+    hi_ = step.rate;
+    if (!best_.has_value()) {
+      // Not even the starting rate is sustainable. Searching below it
+      // wouldn't converge; let the user pick a lower starting rate.
+      return folly::none;
+    }
+  } else if (ok) {
+    lo_ = step.rate;
+  } else {
+    hi_ = step.rate;
+  }
+
+  if (hi_ - lo_ <= precision_ * hi_) {
+    return folly::none;
+  }
+  return (lo_ + hi_) / 2;
+}
+
+}}} // namespace facebook::logdevice::ldbench
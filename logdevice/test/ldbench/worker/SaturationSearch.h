@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <folly/Optional.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+/**
+ * Finds the highest write rate a cluster sustains under a latency SLO. The
+ * caller runs the workload in steps at the rates this class asks for and
+ * reports the outcome of each step.
+ *
+ * First ramps the rate up with the given function until a step is not
+ * sustainable: its latency exceeds the SLO, too many appends failed, or the
+ * achieved rate fell behind the target. Then binary-searches between the
+ * last sustainable rate and that one until they're within `precision` of
+ * each other.
+ *
+ * Also remembers the knee: the first step at which appends started failing
+ * or latency started growing faster than the rate. The knee usually comes
+ * before the SLO is violated.
+ */
+class SaturationSearch {
+ public:
+  struct Step {
+    // Target rate of the step.
+    double rate;
+    // Latency percentile of the step's successful appends.
+    uint64_t latency_us;
+    // Fraction of the step's appends that failed.
+    double error_rate;
+    // Rate of successful appends.
+    double achieved_rate;
+  };
+
+  // A step is sustainable only if it achieved at least this fraction of the
+  // target rate.
+  static constexpr double KEEP_UP_FRACTION = 0.9;
+
+  /**
+   * @param ramp            returns the rate of the next ramp-up step given
+   *                        the rate of the current one; must increase it
+   * @param latency_slo_us  highest sustainable latency
+   * @param max_error_rate  highest sustainable fraction of failed appends
+   * @param precision       stop when the bounds are within this fraction of
+   *                        the upper bound
+   */
+  SaturationSearch(std::function<double(double)> ramp,
+                   uint64_t latency_slo_us,
+                   double max_error_rate,
+                   double precision);
+
+  /**
+   * Records the outcome of a step. The search ends right away if the first
+   * step is not sustainable.
+   *
+   * @return  the rate of the next step, or folly::none if the search is over
+   */
+  folly::Optional<double> onStepDone(const Step& step);
+
+  bool isSustainable(const Step& step) const;
+
+  // Why the step is not sustainable, e.g. "latency 1200us > SLO 1000us".
+  // Empty if it is.
+  std::string describeBottleneck(const Step& step) const;
+
+  // Fastest sustainable step so far.
+  const folly::Optional<Step>& getBest() const {
+    return best_;
+  }
+
+  const folly::Optional<Step>& getKnee() const {
+    return knee_;
+  }
+
+  // First step that was not sustainable, which ended the ramp-up.
+  const folly::Optional<Step>& getFirstUnsustainable() const {
+    return first_unsustainable_;
+  }
+
+ private:
+  std::function<double(double)> ramp_;
+  uint64_t latency_slo_us_;
+  double max_error_rate_;
+  double precision_;
+
+  bool ramping_ = true;
+  folly::Optional<Step> prev_;
+  folly::Optional<Step> best_;
+  folly::Optional<Step> knee_;
+  folly::Optional<Step> first_unsustainable_;
+  // Bounds of the binary search.
+  double lo_ = 0;
+  double hi_ = 0;
+};
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/SaturationSearch.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+using Step = SaturationSearch::Step;
+
+// A cluster whose latency is flat up to 1000 and grows quickly after that,
+// and that starts failing appends at 1500.
+static Step runStep(double rate) {
+  uint64_t latency = rate <= 1000 ? 100 : 100 + (rate - 1000) * (rate - 1000);
+  return Step{rate, latency, rate >= 1500 ? 0.1 : 0., rate};
+}
+
+TEST(SaturationSearchTest, FindsMaxRate) {
+  SaturationSearch search([](double rate) { return rate * 2; },
+                          /* latency_slo_us */ 10000,
+                          /* max_error_rate */ 0.01,
+                          /* precision */ 0.01);
+  folly::Optional<double> rate = 100.;
+  int steps = 0;
+  while (rate.has_value()) {
+    ASSERT_LT(++steps, 100);
+    rate = search.onStepDone(runStep(*rate));
+  }
+  // Latency reaches the SLO at 1099.5.
+  ASSERT_TRUE(search.getBest().has_value());
+  EXPECT_LE(search.getBest()->rate, 1099.5);
+  EXPECT_GE(search.getBest()->rate, 1099.5 * 0.99);
+  // The ramp went 100, 200, 400, 800, 1600.
+  ASSERT_TRUE(search.getFirstUnsustainable().has_value());
+  EXPECT_EQ(1600, search.getFirstUnsustainable()->rate);
+  EXPECT_EQ("latency 360100us > SLO 10000us, 10.000% of appends failed",
+            search.describeBottleneck(*search.getFirstUnsustainable()));
+  // Latency started growing at 1600.
+  ASSERT_TRUE(search.getKnee().has_value());
+  EXPECT_EQ(1600, search.getKnee()->rate);
+}
+
+TEST(SaturationSearchTest, NothingSustainable) {
+  SaturationSearch search([](double rate) { return rate + 10; },
+                          /* latency_slo_us */ 10,
+                          /* max_error_rate */ 0,
+                          /* precision */ 0.1);
+  EXPECT_FALSE(search.onStepDone(Step{100, 100, 0, 100}).has_value());
+  EXPECT_FALSE(search.getBest().has_value());
+  ASSERT_TRUE(search.getFirstUnsustainable().has_value());
+  EXPECT_EQ(100, search.getFirstUnsustainable()->rate);
+}
+
+TEST(SaturationSearchTest, FallingBehind) {
+  SaturationSearch search([](double rate) { return rate + 100; },
+                          /* latency_slo_us */ 1000,
+                          /* max_error_rate */ 0,
+                          /* precision */ 0.1);
+  EXPECT_TRUE(search.isSustainable(Step{100, 10, 0, 95}));
+  EXPECT_FALSE(search.isSustainable(Step{100, 10, 0, 50}));
+  EXPECT_EQ("achieved only 50 of 100",
+            search.describeBottleneck(Step{100, 10, 0, 50}));
+}
+
+}}} // namespace facebook::logdevice::ldbench
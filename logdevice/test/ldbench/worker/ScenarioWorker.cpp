@@ -0,0 +1,856 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/json.h>
+
+#include "logdevice/common/LibeventTimer.h"
+#include "logdevice/common/Timestamp.h"
+#include "logdevice/common/commandline_util_chrono.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/include/AsyncReader.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/test/ldbench/worker/BenchStats.h"
+#include "logdevice/test/ldbench/worker/FileBasedStatsStore.h"
+#include "logdevice/test/ldbench/worker/ServerStatsCollector.h"
+#include "logdevice/test/ldbench/worker/Worker.h"
+#include "logdevice/test/ldbench/worker/WorkerRegistry.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+namespace {
+
+static constexpr const char* BENCH_NAME = "scenario";
+
+/**
+ * Mixed-workload benchmark worker.
+ *
+ * Runs the phases of the scenario given by --scenario one after another, in
+ * a single client. Each phase keeps some logs tailed and issues a weighted
+ * mix of operations at a given total rate. Example:
+ *
+ *   {"phases": [
+ *     {"name": "steady",
+ *      "duration": "10min",
+ *      "ops_per_sec": 2000,
+ *      "mix": {"append": 90, "findtime": 5, "backfill": 1, "trim": 4},
+ *      "tailers": 100,
+ *      "max_backfills": 4,
+ *      "backfill_from": "1h",
+ *      "findtime_ago": "30min",
+ *      "trim_keep": "1d"},
+ *     {"name": "backfill storm",
+ *      "duration": "2min",
+ *      "ops_per_sec": 100,
+ *      "mix": {"append": 50, "backfill": 50},
+ *      "tailers": 100,
+ *      "max_backfills": 64}
+ *   ]}
+ *
+ * Only "duration" is required. "mix" weights don't need to add up to 100.
+ * "tailers" is the number of this worker's logs tailed from their tail
+ * during the phase. A backfill reads one log from "backfill_from" ago up to
+ * the tail at the time it starts, with at most "max_backfills" running at
+ * once. findTime()s look for "findtime_ago" ago. A trim trims one log up to
+ * "trim_keep" ago. Each operation picks its log uniformly at random among
+ * the logs of this worker.
+ *
+ * Each operation type has its own BenchStatsHolder, published to
+ * stats_scenario_<op><worker index>_.csv in --publish-dir and printed when
+ * the scenario ends. For tailing readers and backfills, successes count
+ * records read.
+ *
+ * A phase may also inject faults at given times after its start, to measure
+ * how the workload behaves during failures:
+ *
+ *   {"gap_threshold": "500ms",
+ *    "phases": [
+ *     {"name": "slow disk",
+ *      "duration": "5min",
+ *      "ops_per_sec": 2000,
+ *      "mix": {"append": 100},
+ *      "tailers": 100,
+ *      "faults": [
+ *        {"at": "1min", "node": "10.0.0.1:6440",
+ *         "admin": "inject shard_fault all d a latency --latency=500 --force"},
+ *        {"at": "2min", "node": "10.0.0.1:6440",
+ *         "admin": "inject shard_fault all a a none --force"},
+ *        {"at": "3min", "node": "10.0.0.2:6440", "admin": "stop"},
+ *        {"at": "4min", "shell": "ssh 10.0.0.2 systemctl start logdevice"}]}
+ *   ]}
+ *
+ * "admin" runs an admin command on the node with the given admin API address
+ * ("stop" kills the node); "shell" runs a shell command, e.g. to start a node
+ * again, which no admin command can do. Periods longer than "gap_threshold"
+ * (default 1s) without a successful append, or without a record read by the
+ * tailers, are reported as availability gaps and read stalls. The faults,
+ * gaps, and the time from each fault until the end of the last gap before
+ * the next fault (the recovery duration) are printed as JSON when the
+ * scenario ends and written to timeline_scenario<worker index>_.json in
+ * --publish-dir. Gaps are detected the same way with no faults, so phases
+ * that don't append or tail anything show up as gaps too.
+ */
+class ScenarioWorker final : public Worker {
+ public:
+  using Worker::Worker;
+  ~ScenarioWorker() override;
+  int run() override;
+
+ private:
+  enum class Op { APPEND, FINDTIME, BACKFILL, TRIM, TAIL, MAX };
+  // Operations that are part of the mix, as opposed to tailing.
+  static constexpr size_t NUM_MIX_OPS = static_cast<size_t>(Op::TAIL);
+
+  struct Fault {
+    std::chrono::milliseconds at{0};
+    // Either an admin command to run on `node`, or a shell command.
+    folly::SocketAddress node;
+    std::string admin;
+    std::string shell;
+  };
+
+  struct Phase {
+    std::string name;
+    std::chrono::milliseconds duration{0};
+    double ops_per_sec = 0;
+    std::array<double, NUM_MIX_OPS> weights{};
+    size_t tailers = 0;
+    size_t max_backfills = 4;
+    std::chrono::milliseconds backfill_from{std::chrono::hours(1)};
+    std::chrono::milliseconds findtime_ago{std::chrono::minutes(30)};
+    std::chrono::milliseconds trim_keep{std::chrono::hours(24)};
+    std::vector<Fault> faults;
+  };
+
+  // Times are in seconds since the start of the scenario.
+  struct FaultEvent {
+    double time;
+    std::string description;
+    bool failed;
+  };
+  struct Gap {
+    Op op;
+    double start;
+    double end;
+  };
+
+  static const char* opName(Op op);
+
+  // Returns false on success, true on failure.
+  static bool parseScenario(const std::string& json,
+                            std::vector<Phase>* out,
+                            std::chrono::milliseconds* gap_threshold);
+
+  BenchStats* stats(Op op) {
+    return stats_holders_[static_cast<size_t>(op)]->getOrCreateTLStats();
+  }
+
+  // All of the following run on ev_.
+  void startPhase(size_t idx);
+  void onTick();
+  void runOp(Op op);
+  void append(logid_t log);
+  void findTime(logid_t log);
+  void backfill(logid_t log);
+  void trim(logid_t log);
+  void adjustTailers();
+
+  // Called on every successful append and every record read by the tailers.
+  void noteSuccess(Op op);
+  // Runs on fault_thread_, injecting the faults of all phases on schedule.
+  void runFaults();
+  folly::dynamic getTimeline();
+
+  void printProgress(double seconds_since_start,
+                     double seconds_since_last_call) override;
+
+  static double steadyTime() {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  std::vector<Phase> phases_;
+  size_t phase_idx_ = 0;
+  std::vector<logid_t> logs_;
+
+  std::array<std::shared_ptr<BenchStatsHolder>, static_cast<size_t>(Op::MAX)>
+      stats_holders_;
+  std::vector<std::unique_ptr<BenchStatsCollectionThread>> collect_threads_;
+  std::array<std::atomic<uint64_t>, NUM_MIX_OPS> in_flight_{};
+
+  LibeventTimer tick_timer_;
+  LibeventTimer phase_timer_;
+  double last_tick_time_ = 0;
+  // Fractional number of operations due but not issued yet.
+  double ops_due_ = 0;
+
+  // Tails logs_[0, tailed_).
+  std::unique_ptr<AsyncReader> tail_reader_;
+  size_t tailed_ = 0;
+
+  std::unordered_map<uint64_t, std::unique_ptr<AsyncReader>> backfills_;
+  uint64_t next_backfill_id_ = 0;
+
+  std::chrono::steady_clock::time_point scenario_start_;
+  double scenario_start_time_ = 0;
+  double gap_threshold_ = 1;
+
+  std::thread fault_thread_;
+  std::mutex fault_mutex_;
+  std::condition_variable fault_cv_;
+  bool faults_stopped_ = false;
+
+  // Protects the members below, updated from client threads.
+  std::mutex timeline_mutex_;
+  // Zero if there was no success yet.
+  std::array<double, static_cast<size_t>(Op::MAX)> last_success_time_{};
+  std::vector<FaultEvent> fault_events_;
+  std::vector<Gap> gaps_;
+};
+
+static constexpr std::chrono::milliseconds TICK_INTERVAL{10};
+
+ScenarioWorker::~ScenarioWorker() {
+  // Make sure no callbacks are called after this subclass is destroyed.
+  destroyClient();
+}
+
+const char* ScenarioWorker::opName(Op op) {
+  switch (op) {
+    case Op::APPEND:
+      return "append";
+    case Op::FINDTIME:
+      return "findtime";
+    case Op::BACKFILL:
+      return "backfill";
+    case Op::TRIM:
+      return "trim";
+    case Op::TAIL:
+      return "tail";
+    case Op::MAX:
+      break;
+  }
+  ld_check(false);
+  return "unknown";
+}
+
+bool ScenarioWorker::parseScenario(const std::string& json,
+                                   std::vector<Phase>* out,
+                                   std::chrono::milliseconds* gap_threshold) {
+  folly::dynamic spec;
+  try {
+    spec = folly::parseJson(json);
+  } catch (const std::exception& e) {
+    ld_error("Invalid scenario JSON: %s", e.what());
+    return true;
+  }
+  const folly::dynamic* phases =
+      spec.isObject() ? spec.get_ptr("phases") : nullptr;
+  if (!phases || !phases->isArray() || phases->empty()) {
+    ld_error("Scenario must be an object with a non-empty \"phases\" array");
+    return true;
+  }
+
+  auto get_duration = [](const folly::dynamic& obj,
+                         const char* key,
+                         std::chrono::milliseconds* duration) {
+    const folly::dynamic* v = obj.get_ptr(key);
+    if (!v) {
+      return false;
+    }
+    if (!v->isString() || parse_chrono_string(v->getString(), duration) != 0) {
+      ld_error("Invalid \"%s\" in scenario phase: %s",
+               key,
+               folly::toJson(*v).c_str());
+      return true;
+    }
+    return false;
+  };
+  if (get_duration(spec, "gap_threshold", gap_threshold)) {
+    return true;
+  }
+
+  out->clear();
+  for (const folly::dynamic& p : *phases) {
+    Phase phase;
+    phase.name = folly::to<std::string>(out->size());
+    try {
+      if (!p.isObject()) {
+        ld_error("Scenario phases must be objects");
+        return true;
+      }
+      if (!p.get_ptr("duration")) {
+        ld_error("Scenario phase %s has no \"duration\"", phase.name.c_str());
+        return true;
+      }
+      if (get_duration(p, "duration", &phase.duration) ||
+          get_duration(p, "backfill_from", &phase.backfill_from) ||
+          get_duration(p, "findtime_ago", &phase.findtime_ago) ||
+          get_duration(p, "trim_keep", &phase.trim_keep)) {
+        return true;
+      }
+      phase.name = p.getDefault("name", phase.name).asString();
+      phase.ops_per_sec = p.getDefault("ops_per_sec", 0).asDouble();
+      int64_t tailers = p.getDefault("tailers", 0).asInt();
+      int64_t max_backfills =
+          p.getDefault("max_backfills", phase.max_backfills).asInt();
+      if (phase.ops_per_sec < 0 || tailers < 0 || max_backfills < 0) {
+        ld_error("Negative ops_per_sec, tailers or max_backfills in "
+                 "scenario phase %s",
+                 phase.name.c_str());
+        return true;
+      }
+      phase.tailers = tailers;
+      phase.max_backfills = max_backfills;
+      if (const folly::dynamic* mix = p.get_ptr("mix")) {
+        for (const auto& kv : mix->items()) {
+          size_t i = 0;
+          while (i < NUM_MIX_OPS &&
+                 kv.first.asString() != opName(static_cast<Op>(i))) {
+            ++i;
+          }
+          if (i == NUM_MIX_OPS || kv.second.asDouble() < 0) {
+            ld_error("Invalid operation in mix of scenario phase %s: %s",
+                     phase.name.c_str(),
+                     folly::toJson(kv.first).c_str());
+            return true;
+          }
+          phase.weights[i] = kv.second.asDouble();
+        }
+      }
+      if (const folly::dynamic* faults = p.get_ptr("faults")) {
+        for (const folly::dynamic& f : *faults) {
+          Fault fault;
+          if (!f.get_ptr("at") || get_duration(f, "at", &fault.at)) {
+            ld_error("Fault in scenario phase %s needs a valid \"at\"",
+                     phase.name.c_str());
+            return true;
+          }
+          fault.admin = f.getDefault("admin", "").asString();
+          fault.shell = fault.admin.empty()
+              ? f.getDefault("shell", "").asString()
+              : std::string();
+          if (fault.admin.empty() == fault.shell.empty()) {
+            ld_error("Fault in scenario phase %s needs either \"admin\" or "
+                     "\"shell\"",
+                     phase.name.c_str());
+            return true;
+          }
+          if (!fault.admin.empty()) {
+            try {
+              fault.node.setFromHostPort(f.getDefault("node", "").asString());
+            } catch (const std::exception& e) {
+              ld_error("Invalid \"node\" of fault in scenario phase %s: %s",
+                       phase.name.c_str(),
+                       e.what());
+              return true;
+            }
+          }
+          phase.faults.push_back(std::move(fault));
+        }
+      }
+    } catch (const folly::TypeError& e) {
+      ld_error("Invalid scenario phase %s: %s", phase.name.c_str(), e.what());
+      return true;
+    }
+    out->push_back(std::move(phase));
+  }
+  return false;
+}
+
+void ScenarioWorker::startPhase(size_t idx) {
+  if (idx >= phases_.size()) {
+    ld_info("Scenario completed");
+    stop();
+    return;
+  }
+  phase_idx_ = idx;
+  const Phase& phase = phases_[idx];
+  ld_info("Starting phase %s: %.1f ops/s for %s, tailing %lu logs",
+          phase.name.c_str(),
+          phase.ops_per_sec,
+          format_chrono_string(phase.duration).c_str(),
+          std::min(phase.tailers, logs_.size()));
+  ops_due_ = 0;
+  adjustTailers();
+  phase_timer_.activate(phase.duration);
+}
+
+void ScenarioWorker::onTick() {
+  tick_timer_.activate(TICK_INTERVAL);
+  const Phase& phase = phases_[phase_idx_];
+  double now = steadyTime();
+  ops_due_ += (now - last_tick_time_) * phase.ops_per_sec;
+  last_tick_time_ = now;
+
+  double total_weight = 0;
+  for (double w : phase.weights) {
+    total_weight += w;
+  }
+  if (total_weight <= 0) {
+    ops_due_ = 0;
+    return;
+  }
+  for (; ops_due_ >= 1; ops_due_ -= 1) {
+    double x = folly::Random::randDouble01() * total_weight;
+    size_t i = 0;
+    while (i + 1 < NUM_MIX_OPS && x >= phase.weights[i]) {
+      x -= phase.weights[i];
+      ++i;
+    }
+    runOp(static_cast<Op>(i));
+  }
+}
+
+void ScenarioWorker::runOp(Op op) {
+  uint64_t limit = op == Op::APPEND ? options.max_appends_in_flight
+                                    : options.max_requests_in_flight;
+  if (op == Op::BACKFILL) {
+    limit = phases_[phase_idx_].max_backfills;
+  }
+  if (in_flight_[static_cast<size_t>(op)].load() >= limit) {
+    stats(op)->incStat(StatsType::SKIPPED, 1);
+    return;
+  }
+  logid_t log = logs_[folly::Random::rand64(logs_.size())];
+  switch (op) {
+    case Op::APPEND:
+      append(log);
+      break;
+    case Op::FINDTIME:
+      findTime(log);
+      break;
+    case Op::BACKFILL:
+      backfill(log);
+      break;
+    case Op::TRIM:
+      trim(log);
+      break;
+    case Op::TAIL:
+    case Op::MAX:
+      ld_check(false);
+      break;
+  }
+}
+
+void ScenarioWorker::append(logid_t log) {
+  std::string payload = generatePayload();
+  auto cb = [this](Status st, const DataRecord& r) {
+    --in_flight_[static_cast<size_t>(Op::APPEND)];
+    stats(Op::APPEND)->incStat(StatsType::INFLIGHT, -1);
+    if (st == E::OK) {
+      stats(Op::APPEND)->incStat(StatsType::SUCCESS, 1);
+      stats(Op::APPEND)->incStat(StatsType::SUCCESS_BYTE, r.payload.size());
+      noteSuccess(Op::APPEND);
+    } else {
+      stats(Op::APPEND)->incStat(StatsType::FAILURE, 1);
+    }
+  };
+  ++in_flight_[static_cast<size_t>(Op::APPEND)];
+  stats(Op::APPEND)->incStat(StatsType::INFLIGHT, 1);
+  if (tryAppend(log, std::move(payload), cb)) {
+    --in_flight_[static_cast<size_t>(Op::APPEND)];
+    stats(Op::APPEND)->incStat(StatsType::INFLIGHT, -1);
+    stats(Op::APPEND)->incStat(StatsType::FAILURE, 1);
+  }
+}
+
+void ScenarioWorker::findTime(logid_t log) {
+  auto ts = RecordTimestamp::now().toMilliseconds() -
+      phases_[phase_idx_].findtime_ago;
+  ++in_flight_[static_cast<size_t>(Op::FINDTIME)];
+  stats(Op::FINDTIME)->incStat(StatsType::INFLIGHT, 1);
+  int rv = Worker::findTime(log, ts, [this](Status st, lsn_t) {
+    --in_flight_[static_cast<size_t>(Op::FINDTIME)];
+    stats(Op::FINDTIME)->incStat(StatsType::INFLIGHT, -1);
+    stats(Op::FINDTIME)
+        ->incStat(st == E::OK ? StatsType::SUCCESS : StatsType::FAILURE, 1);
+  });
+  if (rv != 0) {
+    --in_flight_[static_cast<size_t>(Op::FINDTIME)];
+    stats(Op::FINDTIME)->incStat(StatsType::INFLIGHT, -1);
+    stats(Op::FINDTIME)->incStat(StatsType::FAILURE, 1);
+  }
+}
+
+void ScenarioWorker::backfill(logid_t log) {
+  auto& in_flight = in_flight_[static_cast<size_t>(Op::BACKFILL)];
+  // Called if the backfill ends before a reader is started.
+  auto finish = [this, &in_flight](bool success) {
+    --in_flight;
+    stats(Op::BACKFILL)->incStat(StatsType::INFLIGHT, -1);
+    if (!success) {
+      stats(Op::BACKFILL)->incStat(StatsType::FAILURE, 1);
+    }
+  };
+  ++in_flight;
+  stats(Op::BACKFILL)->incStat(StatsType::INFLIGHT, 1);
+
+  // Find where to start, then where to stop, then read.
+  auto ts = RecordTimestamp::now().toMilliseconds() -
+      phases_[phase_idx_].backfill_from;
+  int rv = Worker::findTime(log, ts, [=](Status st, lsn_t from) {
+    if (st != E::OK && st != E::PARTIAL) {
+      finish(false);
+      return;
+    }
+    int rv2 = getTailLSN(log, [=](Status st2, lsn_t until) {
+      if (st2 != E::OK) {
+        finish(false);
+        return;
+      }
+      uint64_t id = next_backfill_id_++;
+      auto reader = client_->createAsyncReader();
+      reader->setRecordCallback([this](std::unique_ptr<DataRecord>& r) {
+        stats(Op::BACKFILL)->incStat(StatsType::SUCCESS, 1);
+        stats(Op::BACKFILL)->incStat(
+            StatsType::SUCCESS_BYTE, r->payload.size());
+        return true;
+      });
+      reader->setDoneCallback([this, id](logid_t) {
+        // Can't destroy the reader from its own callback.
+        ev_->add([this, id] {
+          if (backfills_.erase(id)) {
+            --in_flight_[static_cast<size_t>(Op::BACKFILL)];
+            stats(Op::BACKFILL)->incStat(StatsType::INFLIGHT, -1);
+          }
+        });
+      });
+      if (from > until) {
+        // The log was trimmed past its tail since findTime().
+        finish(true);
+        return;
+      }
+      if (reader->startReading(log, from, until) != 0) {
+        finish(false);
+        return;
+      }
+      backfills_[id] = std::move(reader);
+    });
+    if (rv2 != 0) {
+      finish(false);
+    }
+  });
+  if (rv != 0) {
+    finish(false);
+  }
+}
+
+void ScenarioWorker::trim(logid_t log) {
+  auto& in_flight = in_flight_[static_cast<size_t>(Op::TRIM)];
+  auto done = [this, &in_flight](bool success) {
+    --in_flight;
+    stats(Op::TRIM)->incStat(StatsType::INFLIGHT, -1);
+    stats(Op::TRIM)->incStat(
+        success ? StatsType::SUCCESS : StatsType::FAILURE, 1);
+  };
+  ++in_flight;
+  stats(Op::TRIM)->incStat(StatsType::INFLIGHT, 1);
+
+  auto ts =
+      RecordTimestamp::now().toMilliseconds() - phases_[phase_idx_].trim_keep;
+  int rv = Worker::findTime(log, ts, [=](Status st, lsn_t lsn) {
+    if (st != E::OK) {
+      done(false);
+      return;
+    }
+    if (lsn <= LSN_OLDEST) {
+      // Nothing older than trim_keep.
+      done(true);
+      return;
+    }
+    int rv2 = client_->trim(
+        log, lsn - 1, [done](Status st2) { done(st2 == E::OK); });
+    if (rv2 != 0) {
+      done(false);
+    }
+  });
+  if (rv != 0) {
+    done(false);
+  }
+}
+
+void ScenarioWorker::adjustTailers() {
+  size_t target = std::min(phases_[phase_idx_].tailers, logs_.size());
+  for (; tailed_ > target; --tailed_) {
+    tail_reader_->stopReading(logs_[tailed_ - 1]);
+  }
+  for (; tailed_ < target; ++tailed_) {
+    size_t idx = tailed_;
+    logid_t log = logs_[idx];
+    int rv = getTailLSN(log, [this, idx, log](Status st, lsn_t tail) {
+      if (st != E::OK) {
+        stats(Op::TAIL)->incStat(StatsType::FAILURE, 1);
+        return;
+      }
+      if (idx < tailed_) {
+        tail_reader_->startReading(log, tail + 1);
+      }
+    });
+    if (rv != 0) {
+      stats(Op::TAIL)->incStat(StatsType::FAILURE, 1);
+    }
+  }
+}
+
+void ScenarioWorker::noteSuccess(Op op) {
+  double now = steadyTime();
+  std::lock_guard<std::mutex> lock(timeline_mutex_);
+  double& last = last_success_time_[static_cast<size_t>(op)];
+  if (last != 0 && now - last >= gap_threshold_) {
+    ld_info("No %s succeeded for %.3fs, from %.3fs to %.3fs",
+            opName(op),
+            now - last,
+            last - scenario_start_time_,
+            now - scenario_start_time_);
+    gaps_.push_back(
+        {op, last - scenario_start_time_, now - scenario_start_time_});
+  }
+  last = now;
+}
+
+void ScenarioWorker::runFaults() {
+  auto phase_start = scenario_start_;
+  for (const Phase& phase : phases_) {
+    for (const Fault& fault : phase.faults) {
+      {
+        std::unique_lock<std::mutex> lock(fault_mutex_);
+        if (fault_cv_.wait_until(lock, phase_start + fault.at, [this] {
+              return faults_stopped_;
+            })) {
+          return;
+        }
+      }
+      double time = steadyTime() - scenario_start_time_;
+      std::string description;
+      bool failed;
+      if (!fault.admin.empty()) {
+        description = fault.node.describe() + ": " + fault.admin;
+        std::string response;
+        failed = ServerStatsCollector::runAdminCommand(
+            fault.node, fault.admin, options.client_timeout, &response);
+        if (!failed) {
+          ld_info("Admin command \"%s\" on %s returned: %s",
+                  fault.admin.c_str(),
+                  fault.node.describe().c_str(),
+                  folly::trimWhitespace(response).str().c_str());
+        }
+      } else {
+        description = fault.shell;
+        int rv = std::system(fault.shell.c_str());
+        failed = rv != 0;
+        if (failed) {
+          ld_error("Shell command \"%s\" failed: %d", fault.shell.c_str(), rv);
+        }
+      }
+      ld_info("Injected fault at %.3fs: %s", time, description.c_str());
+      std::lock_guard<std::mutex> lock(timeline_mutex_);
+      fault_events_.push_back({time, std::move(description), failed});
+    }
+    phase_start += phase.duration;
+  }
+}
+
+folly::dynamic ScenarioWorker::getTimeline() {
+  std::lock_guard<std::mutex> lock(timeline_mutex_);
+  // Gaps still going on are cut off at the end of the scenario.
+  double end = steadyTime();
+  for (Op op : {Op::APPEND, Op::TAIL}) {
+    double last = last_success_time_[static_cast<size_t>(op)];
+    if (last != 0 && end - last >= gap_threshold_) {
+      gaps_.push_back(
+          {op, last - scenario_start_time_, end - scenario_start_time_});
+    }
+  }
+
+  folly::dynamic faults = folly::dynamic::array;
+  for (size_t i = 0; i < fault_events_.size(); ++i) {
+    const FaultEvent& fault = fault_events_[i];
+    double next = i + 1 < fault_events_.size()
+        ? fault_events_[i + 1].time
+        : std::numeric_limits<double>::infinity();
+    folly::dynamic recovery = folly::dynamic::object;
+    for (Op op : {Op::APPEND, Op::TAIL}) {
+      double recovered = fault.time;
+      for (const Gap& gap : gaps_) {
+        if (gap.op == op && gap.end > fault.time && gap.start < next) {
+          recovered = std::max(recovered, gap.end);
+        }
+      }
+      recovery[opName(op)] = recovered - fault.time;
+    }
+    faults.push_back(folly::dynamic::object("time", fault.time)(
+        "fault", fault.description)("failed", fault.failed)(
+        "recovery_duration", std::move(recovery)));
+  }
+  folly::dynamic gaps = folly::dynamic::array;
+  for (const Gap& gap : gaps_) {
+    gaps.push_back(folly::dynamic::object("op", opName(gap.op))(
+        "start", gap.start)("end", gap.end)("duration", gap.end - gap.start));
+  }
+  return folly::dynamic::object("faults", std::move(faults))(
+      "gaps", std::move(gaps));
+}
+
+void ScenarioWorker::printProgress(double seconds_since_start,
+                                   double /* seconds_since_last_call */) {
+  std::string s;
+  for (size_t i = 0; i < static_cast<size_t>(Op::MAX); ++i) {
+    folly::dynamic st = stats_holders_[i]->aggregateAllStats();
+    s += folly::sformat(", {}: {} ok, {} failed, {} skipped",
+                        opName(static_cast<Op>(i)),
+                        st["success"].asInt(),
+                        st["fail"].asInt(),
+                        st["skipped"].asInt());
+  }
+  ld_info("ran for: %.3fs%s", seconds_since_start, s.c_str());
+}
+
+int ScenarioWorker::run() {
+  std::string json;
+  if (!folly::readFile(options.scenario_file.c_str(), json)) {
+    ld_error("Failed to read scenario file %s: %s",
+             options.scenario_file.c_str(),
+             folly::errnoStr(errno).c_str());
+    return 1;
+  }
+  std::chrono::milliseconds gap_threshold{std::chrono::seconds(1)};
+  if (parseScenario(json, &phases_, &gap_threshold)) {
+    return 1;
+  }
+  gap_threshold_ = gap_threshold.count() / 1000.;
+
+  std::vector<logid_t> all_logs;
+  if (getLogs(all_logs)) {
+    return 1;
+  }
+  logs_ = getLogsPartition(all_logs);
+  if (logs_.empty()) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < static_cast<size_t>(Op::MAX); ++i) {
+    std::string name = opName(static_cast<Op>(i));
+    stats_holders_[i] = std::make_shared<BenchStatsHolder>(name);
+    if (options.publish_dir != "") {
+      std::string stats_file = folly::to<std::string>(options.publish_dir,
+                                                      "/stats_",
+                                                      BENCH_NAME,
+                                                      "_",
+                                                      name,
+                                                      options.worker_id_index,
+                                                      "_.csv");
+      collect_threads_.push_back(std::make_unique<BenchStatsCollectionThread>(
+          stats_holders_[i],
+          std::make_shared<FileBasedStatsStore>(stats_file),
+          options.stats_interval));
+    }
+  }
+
+  tail_reader_ = client_->createAsyncReader();
+  tail_reader_->setRecordCallback([this](std::unique_ptr<DataRecord>& r) {
+    stats(Op::TAIL)->incStat(StatsType::SUCCESS, 1);
+    stats(Op::TAIL)->incStat(StatsType::SUCCESS_BYTE, r->payload.size());
+    noteSuccess(Op::TAIL);
+    return true;
+  });
+
+  // The scenario decides when the benchmark ends.
+  options.duration = -1;
+
+  ev_->add([this] {
+    waitUntilStartTime();
+    phase_timer_.assign(
+        &ev_->getEvBase(), [this] { startPhase(phase_idx_ + 1); });
+    tick_timer_.assign(&ev_->getEvBase(), [this] { onTick(); });
+    last_tick_time_ = steadyTime();
+    scenario_start_ = std::chrono::steady_clock::now();
+    scenario_start_time_ = last_tick_time_;
+    startPhase(0);
+    tick_timer_.activate(TICK_INTERVAL);
+    fault_thread_ = std::thread([this] { runFaults(); });
+  });
+
+  sleepForDurationOfTheBench();
+
+  ld_info("Stopping");
+  executeOnEventLoopSync([&] {
+    tick_timer_.cancel();
+    phase_timer_.cancel();
+    backfills_.clear();
+    tail_reader_.reset();
+  });
+  {
+    std::lock_guard<std::mutex> lock(fault_mutex_);
+    faults_stopped_ = true;
+  }
+  fault_cv_.notify_all();
+  if (fault_thread_.joinable()) {
+    fault_thread_.join();
+  }
+  destroyClient();
+
+  for (size_t i = 0; i < static_cast<size_t>(Op::MAX); ++i) {
+    folly::dynamic st = stats_holders_[i]->aggregateAllStats();
+    std::cout << folly::toJson(st) << std::endl;
+  }
+  folly::dynamic timeline = getTimeline();
+  std::cout << folly::toJson(timeline) << std::endl;
+  if (options.publish_dir != "") {
+    std::string timeline_file = folly::to<std::string>(options.publish_dir,
+                                                       "/timeline_",
+                                                       BENCH_NAME,
+                                                       options.worker_id_index,
+                                                       "_.json");
+    if (!folly::writeFile(
+            folly::toPrettyJson(timeline), timeline_file.c_str())) {
+      ld_error("Failed to write %s: %s",
+               timeline_file.c_str(),
+               folly::errnoStr(errno).c_str());
+    }
+  }
+  // Publishes the final stats.
+  collect_threads_.clear();
+  return 0;
+}
+
+} // namespace
+
+void registerScenarioWorker() {
+  registerWorkerImpl(BENCH_NAME,
+                     []() -> std::unique_ptr<Worker> {
+                       return std::make_unique<ScenarioWorker>();
+                     },
+                     OptionsRestrictions(
+                         {
+                             "scenario",
+                             "payload-size",
+                             "payload-corpus",
+                             "payload-corpus-max-bytes",
+                             "max-appends-in-flight",
+                             "max-requests-in-flight",
+                         },
+                         {PartitioningMode::LOG},
+                         OptionsRestrictions::AllowBufferedWriterOptions::NO));
+}
+
+}}} // namespace facebook::logdevice::ldbench
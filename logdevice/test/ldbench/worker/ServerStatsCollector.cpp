@@ -0,0 +1,221 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/ServerStatsCollector.h"
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/AsyncSocket.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/json.h>
+#include <thrift/lib/cpp2/async/HeaderClientChannel.h>
+
+#include "logdevice/admin/if/gen-cpp2/AdminAPI.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+using Response = thrift::AdminCommandResponse;
+
+ServerStatsCollector::ServerStatsCollector(
+    std::vector<folly::SocketAddress> nodes,
+    std::vector<std::string> stats,
+    std::vector<std::string> histograms,
+    std::chrono::milliseconds timeout)
+    : nodes_(std::move(nodes)),
+      stats_(std::move(stats)),
+      histograms_(std::move(histograms)),
+      timeout_(timeout) {}
+
+folly::dynamic ServerStatsCollector::collect() const {
+  folly::EventBase eb;
+  apache::thrift::RpcOptions rpc_options;
+  rpc_options.setTimeout(timeout_);
+
+  std::vector<std::unique_ptr<thrift::AdminAPIAsyncClient>> clients;
+  std::vector<folly::SemiFuture<Response>> stats_futures;
+  std::vector<folly::SemiFuture<Response>> histogram_futures;
+  auto send = [&](thrift::AdminAPIAsyncClient& client,
+                  const std::vector<std::string>& selectors,
+                  const char* command) {
+    if (selectors.empty()) {
+      return folly::makeSemiFuture(Response());
+    }
+    thrift::AdminCommandRequest req;
+    req.request = command;
+    return client.semifuture_executeAdminCommand(rpc_options, std::move(req));
+  };
+  for (const folly::SocketAddress& addr : nodes_) {
+    auto transport = folly::AsyncSocket::newSocket(&eb, addr, timeout_.count());
+    auto channel =
+        apache::thrift::HeaderClientChannel::newChannel(std::move(transport));
+    channel->setTimeout(timeout_.count());
+    clients.push_back(
+        std::make_unique<thrift::AdminAPIAsyncClient>(std::move(channel)));
+    stats_futures.push_back(send(*clients.back(), stats_, "stats2"));
+    histogram_futures.push_back(send(
+        *clients.back(), histograms_, "stats2 histogram all --json"));
+  }
+  auto stats_results = folly::collectAllSemiFuture(std::move(stats_futures))
+                           .via(&eb)
+                           .getVia(&eb);
+  auto histogram_results =
+      folly::collectAllSemiFuture(std::move(histogram_futures))
+          .via(&eb)
+          .getVia(&eb);
+
+  folly::dynamic result = folly::dynamic::object;
+  folly::dynamic total = folly::dynamic::object;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const std::string name = nodes_[i].describe();
+    if (stats_results[i].hasException() ||
+        histogram_results[i].hasException()) {
+      RATELIMIT_WARNING(std::chrono::seconds(10),
+                        1,
+                        "Failed to get stats from %s: %s",
+                        name.c_str(),
+                        (stats_results[i].hasException()
+                             ? stats_results[i].exception()
+                             : histogram_results[i].exception())
+                            .what()
+                            .c_str());
+      continue;
+    }
+    folly::dynamic node = folly::dynamic::object;
+    parseStats(stats_results[i].value().response, stats_, &node);
+    for (const auto& kv : node.items()) {
+      total[kv.first] =
+          total.getDefault(kv.first, 0).asInt() + kv.second.asInt();
+    }
+    parseHistograms(
+        histogram_results[i].value().response, histograms_, &node);
+    result[name] = std::move(node);
+  }
+  result["all"] = std::move(total);
+  return result;
+}
+
+bool ServerStatsCollector::runAdminCommand(const folly::SocketAddress& node,
+                                           const std::string& command,
+                                           std::chrono::milliseconds timeout,
+                                           std::string* response_out) {
+  folly::EventBase eb;
+  apache::thrift::RpcOptions rpc_options;
+  rpc_options.setTimeout(timeout);
+  auto transport = folly::AsyncSocket::newSocket(&eb, node, timeout.count());
+  auto channel =
+      apache::thrift::HeaderClientChannel::newChannel(std::move(transport));
+  channel->setTimeout(timeout.count());
+  thrift::AdminAPIAsyncClient client(std::move(channel));
+  thrift::AdminCommandRequest req;
+  req.request = command;
+  auto result = client.semifuture_executeAdminCommand(rpc_options, req)
+                    .via(&eb)
+                    .getTryVia(&eb);
+  if (result.hasException()) {
+    ld_error("Admin command \"%s\" failed on %s: %s",
+             command.c_str(),
+             node.describe().c_str(),
+             result.exception().what().c_str());
+    return true;
+  }
+  if (response_out) {
+    *response_out = std::move(result.value().response);
+  }
+  return false;
+}
+
+void ServerStatsCollector::parseStats(const std::string& response,
+                                      const std::vector<std::string>& selectors,
+                                      folly::dynamic* out) {
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', response, lines);
+  for (folly::StringPiece line : lines) {
+    std::vector<folly::StringPiece> tokens;
+    folly::split(' ', folly::trimWhitespace(line), tokens);
+    if (tokens.size() != 3 || tokens[0] != "STAT") {
+      continue;
+    }
+    std::string name = tokens[1].str();
+    auto value = folly::tryTo<int64_t>(tokens[2]);
+    if (value.hasValue() && matches(name, selectors)) {
+      (*out)[name] = value.value();
+    }
+  }
+}
+
+void ServerStatsCollector::parseHistograms(
+    const std::string& response,
+    const std::vector<std::string>& selectors,
+    folly::dynamic* out) {
+  // The table may be followed by "END".
+  size_t begin = response.find('{');
+  size_t end = response.rfind('}');
+  if (begin == std::string::npos || end == std::string::npos) {
+    return;
+  }
+  folly::dynamic table;
+  try {
+    table = folly::parseJson(
+        folly::StringPiece(response).subpiece(begin, end - begin + 1));
+  } catch (const std::exception& e) {
+    ld_error("Failed to parse histograms: %s", e.what());
+    return;
+  }
+  const folly::dynamic* headers = table.get_ptr("headers");
+  const folly::dynamic* rows = table.get_ptr("rows");
+  if (!headers || !rows || !headers->isArray() || !rows->isArray()) {
+    return;
+  }
+  for (const folly::dynamic& row : *rows) {
+    if (!row.isArray() || row.size() != headers->size()) {
+      continue;
+    }
+    std::string name;
+    std::string shard = "-1";
+    folly::dynamic summary = folly::dynamic::object;
+    for (size_t col = 0; col < row.size(); ++col) {
+      const std::string header = (*headers)[col].asString();
+      if (row[col].isNull()) {
+        continue;
+      }
+      const std::string value = row[col].asString();
+      if (header == "Name") {
+        name = value;
+      } else if (header == "Shard") {
+        shard = value;
+      } else {
+        auto number = folly::tryTo<double>(value);
+        summary[header] = number.hasValue() ? folly::dynamic(number.value())
+                                            : folly::dynamic(value);
+      }
+    }
+    if (name.empty() || !matches(name, selectors)) {
+      continue;
+    }
+    if (shard != "-1") {
+      name += ".shard" + shard;
+    }
+    (*out)[name] = std::move(summary);
+  }
+}
+
+bool ServerStatsCollector::matches(const std::string& name,
+                                   const std::vector<std::string>& selectors) {
+  for (const std::string& s : selectors) {
+    if ((!s.empty() && s.back() == '*')
+            ? name.compare(0, s.size() - 1, s, 0, s.size() - 1) == 0
+            : name == s) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <folly/SocketAddress.h>
+#include <folly/dynamic.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+/**
+ * Snapshots selected server stats and histograms through the admin API of
+ * the cluster's nodes. BenchStatsCollectionThread writes the snapshot next
+ * to the client-side BenchStats of the same interval, so that one file shows
+ * e.g. append latency next to storage task queueing and RocksDB stalls.
+ *
+ * Stats are cumulative counters as printed by the "stats2" admin command;
+ * histograms are summarized by "stats2 histogram all --json".
+ */
+class ServerStatsCollector {
+ public:
+  /**
+   * @param nodes       admin API addresses of the nodes to query
+   * @param stats       names of stats to collect; a name ending with '*'
+   *                    selects all stats starting with the rest of it
+   * @param histograms  names of histograms to collect, same syntax
+   * @param timeout     how long to wait for each node
+   */
+  ServerStatsCollector(std::vector<folly::SocketAddress> nodes,
+                       std::vector<std::string> stats,
+                       std::vector<std::string> histograms,
+                       std::chrono::milliseconds timeout);
+
+  /**
+   * Queries all nodes in parallel. Returns an object with a member for each
+   * node that responded, keyed by address, with the selected stats and
+   * histograms of that node; and a member "all" with the stats summed over
+   * the nodes. E.g.
+   *   {"all": {"append_success": 42},
+   *    "[::1]:6440": {"append_success": 42,
+   *                   "store_latency": {"p50": 10, "p99": 200, ...}}}
+   */
+  folly::dynamic collect() const;
+
+  /**
+   * Parses the output of "stats2" into *out, keeping only stats matching
+   * `selectors`.
+   */
+  static void parseStats(const std::string& response,
+                         const std::vector<std::string>& selectors,
+                         folly::dynamic* out);
+
+  /**
+   * Parses the output of "stats2 histogram all --json" into *out, keeping
+   * only histograms matching `selectors`. Per-shard histograms are keyed
+   * "<name>.shard<idx>".
+   */
+  static void parseHistograms(const std::string& response,
+                              const std::vector<std::string>& selectors,
+                              folly::dynamic* out);
+
+  static bool matches(const std::string& name,
+                      const std::vector<std::string>& selectors);
+
+  /**
+   * Runs an arbitrary admin command on one node and waits for it, e.g. to
+   * inject a fault.
+   *
+   * @return  false on success, true on failure. Logs the error on failure.
+   */
+  static bool runAdminCommand(const folly::SocketAddress& node,
+                              const std::string& command,
+                              std::chrono::milliseconds timeout,
+                              std::string* response_out = nullptr);
+
+ private:
+  std::vector<folly::SocketAddress> nodes_;
+  std::vector<std::string> stats_;
+  std::vector<std::string> histograms_;
+  std::chrono::milliseconds timeout_;
+};
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/ServerStatsCollector.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+TEST(ServerStatsCollectorTest, Matches) {
+  std::vector<std::string> selectors = {"append_success", "storage_tasks_*"};
+  EXPECT_TRUE(ServerStatsCollector::matches("append_success", selectors));
+  EXPECT_FALSE(ServerStatsCollector::matches("append_success2", selectors));
+  EXPECT_TRUE(ServerStatsCollector::matches("storage_tasks_", selectors));
+  EXPECT_TRUE(
+      ServerStatsCollector::matches("storage_tasks_queued.shard0", selectors));
+  EXPECT_FALSE(ServerStatsCollector::matches("storage_task", selectors));
+  EXPECT_TRUE(ServerStatsCollector::matches("anything", {"*"}));
+  EXPECT_FALSE(ServerStatsCollector::matches("anything", {}));
+}
+
+TEST(ServerStatsCollectorTest, ParseStats) {
+  folly::dynamic out = folly::dynamic::object;
+  ServerStatsCollector::parseStats("STAT append_success 42\r\n"
+                                   "STAT append_failed 3\r\n"
+                                   "STAT storage_tasks_queued.shard1 -7\r\n"
+                                   "STAT storage_tasks_bad x\r\n"
+                                   "garbage\r\n"
+                                   "END\r\n",
+                                   {"append_success", "storage_tasks_*"},
+                                   &out);
+  EXPECT_EQ(folly::dynamic::object("append_success", 42)(
+                "storage_tasks_queued.shard1", -7),
+            out);
+}
+
+TEST(ServerStatsCollectorTest, ParseHistograms) {
+  folly::dynamic out = folly::dynamic::object;
+  ServerStatsCollector::parseHistograms(
+      R"({"headers": ["Name", "Shard", "Unit", "p50", "p99", "count"],)"
+      R"( "rows": [["append_latency", "-1", "usec", "10", "200.5", "3"],)"
+      R"(          ["store_latency", "0", "usec", "5", "7", "1"],)"
+      R"(          ["store_latency", "1", "usec", null, null, "0"],)"
+      R"(          ["rocks_wal", "0", "usec", "1", "2", "3"]]})"
+      "\r\nEND\r\n",
+      {"append_latency", "store_*"},
+      &out);
+  folly::dynamic expected = folly::dynamic::object;
+  expected["append_latency"] = folly::dynamic::object("Unit", "usec")(
+      "p50", 10.)("p99", 200.5)("count", 3.);
+  expected["store_latency.shard0"] = folly::dynamic::object("Unit", "usec")(
+      "p50", 5.)("p99", 7.)("count", 1.);
+  expected["store_latency.shard1"] =
+      folly::dynamic::object("Unit", "usec")("count", 0.);
+  EXPECT_EQ(expected, out);
+
+  // Errors are ignored.
+  out = folly::dynamic::object;
+  ServerStatsCollector::parseHistograms(
+      "Could not find any histogram that matches the filters.\r\n",
+      {"*"},
+      &out);
+  ServerStatsCollector::parseHistograms("{\"rows\": 42}", {"*"}, &out);
+  EXPECT_TRUE(out.empty());
+}
+
+}}} // namespace facebook::logdevice::ldbench
@@ -26,32 +26,40 @@ bool SteadyWriteRateWorker::tryAppend(
     return true;
   }
 
-  // Wait for fatal error, stop request, or append token. We need to wake up
-  // every second to poll for isStopped() in errorOrStopped(), because stop()
-  // is an async-safe function. It cannot signal the condition variable.
-  ld_debug("Waiting for append token: npending_xacts=%" PRIu64,
-           getNumPendingXacts());
-  for (;;) {
-    const double missing_tokens = std::max(
-        0.0, 1.0 - token_bucket_.available(write_rate_, options.max_window));
-    const double missing_sec = missing_tokens / write_rate_;
-    auto now = Clock::now();
-    auto wakeup_time =
-        std::min({now + std::chrono::seconds(1),
-                  now + std::chrono::nanoseconds(uint64_t(missing_sec * 1e9)),
-                  end_time_});
-    bool token_consumed = cond_var_.wait_until(lock, wakeup_time, [this] {
-      return errorOrStopped() ||
-          ((getNumPendingXacts() < options.max_window) &&
-           token_bucket_.consume(1, write_rate_, options.max_window));
-    });
-    if (errorOrStopped() || Clock::now() >= end_time_) {
-      // Fatal error, stop requested, or end of benchmark.
+  if (options.open_loop) {
+    if (waitForScheduledAppend(lock)) {
       return true;
-    } else if (token_consumed) {
-      // Token consumed. Proceed.
-      break;
     }
+  } else {
+    // Wait for fatal error, stop request, or append token. We need to wake up
+    // every second to poll for isStopped() in errorOrStopped(), because
+    // stop() is an async-safe function. It cannot signal the condition
+    // variable.
+    ld_debug("Waiting for append token: npending_xacts=%" PRIu64,
+             getNumPendingXacts());
+    for (;;) {
+      const double missing_tokens = std::max(
+          0.0, 1.0 - token_bucket_.available(write_rate_, options.max_window));
+      const double missing_sec = missing_tokens / write_rate_;
+      auto now = Clock::now();
+      auto wakeup_time = std::min(
+          {now + std::chrono::seconds(1),
+           now + std::chrono::nanoseconds(uint64_t(missing_sec * 1e9)),
+           end_time_});
+      bool token_consumed = cond_var_.wait_until(lock, wakeup_time, [this] {
+        return errorOrStopped() ||
+            ((getNumPendingXacts() < options.max_window) &&
+             token_bucket_.consume(1, write_rate_, options.max_window));
+      });
+      if (errorOrStopped() || Clock::now() >= end_time_) {
+        // Fatal error, stop requested, or end of benchmark.
+        return true;
+      } else if (token_consumed) {
+        // Token consumed. Proceed.
+        break;
+      }
+    }
+    scheduled_append_time_ = Clock::now();
   }
 
   // Pick random log id from distribution.
@@ -82,6 +90,35 @@ bool SteadyWriteRateWorker::tryAppend(
   return false;
 }
 
+bool SteadyWriteRateWorker::waitForScheduledAppend(
+    std::unique_lock<std::recursive_mutex>& lock) {
+  if (next_scheduled_append_time_ == TimePoint()) {
+    next_scheduled_append_time_ = Clock::now();
+  }
+  // Unlike the token bucket, the schedule doesn't depend on how many appends
+  // are pending, so a slow cluster doesn't slow down the writer and the
+  // latency measured from scheduled_append_time_ includes the time appends
+  // would have waited for it.
+  for (;;) {
+    auto now = Clock::now();
+    if (errorOrStopped() || now >= end_time_) {
+      return true;
+    }
+    if (now >= next_scheduled_append_time_) {
+      break;
+    }
+    cond_var_.wait_until(lock,
+                         std::min({now + std::chrono::seconds(1),
+                                   next_scheduled_append_time_,
+                                   end_time_}));
+  }
+  scheduled_append_time_ = next_scheduled_append_time_;
+  next_scheduled_append_time_ +=
+      std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1 / write_rate_));
+  return false;
+}
+
 bool SteadyWriteRateWorker::errorOrStopped() const noexcept {
   return error() || isStopped();
 }
@@ -54,6 +54,20 @@ class SteadyWriteRateWorker : public Worker {
   double write_rate_;
   TimePoint end_time_;
   TokenBucket token_bucket_;
+  // When the append tryAppend() is performing was due. With --open-loop this
+  // is its place in a fixed schedule of 1/write_rate_ intervals, which may be
+  // in the past if appends couldn't be issued fast enough. Otherwise, the
+  // time the append token was consumed. Subclasses should measure latency
+  // from this time.
+  TimePoint scheduled_append_time_;
+
+ private:
+  // Used with --open-loop. Zero until the first append.
+  TimePoint next_scheduled_append_time_{};
+
+  // Waits until the next append is due in open-loop mode. Returns true if the
+  // benchmark should end instead.
+  bool waitForScheduledAppend(std::unique_lock<std::recursive_mutex>& lock);
 };
 
 }}} // namespace facebook::logdevice::ldbench
@@ -45,7 +45,8 @@ Worker::Worker() : ev_(new EventLoop("ldbench:ev")) {
                                               std::placeholders::_2,
                                               std::placeholders::_3,
                                               std::placeholders::_4,
-                                              std::placeholders::_5));
+                                              std::placeholders::_5,
+                                              std::placeholders::_6));
   ld_check(options.sys_name == "logdevice" || options.sys_name == "kafka");
   if (options.sys_name == "logdevice") {
     if (client_ == nullptr) {
@@ -125,8 +126,13 @@ std::string Worker::generatePayload(size_t size) {
   // options.payload_size may not be parsed yet when Worker is created. Also,
   // this avoids allocating a buffer in case a benchmark does not perform any
   // appends.
-  folly::ThreadLocalPRNG prng;
   payload_buf_.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+  if (options.payload_corpus) {
+    options.payload_corpus->fill(
+        reinterpret_cast<char*>(payload_buf_.data()), size);
+    return std::string(reinterpret_cast<char*>(payload_buf_.data()), size);
+  }
+  folly::ThreadLocalPRNG prng;
   std::generate(payload_buf_.begin(), payload_buf_.end(), [&] {
     return folly::Random::rand32(prng);
   });
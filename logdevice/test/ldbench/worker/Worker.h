@@ -102,7 +102,8 @@ class Worker : private boost::noncopyable {
                             bool /* status */,
                             bool /* buffered */,
                             uint64_t /* num_records */,
-                            uint64_t /* payload_bytes */) {}
+                            uint64_t /* payload_bytes */,
+                            const ContextSet& /* contexts */) {}
 
  protected:
   using LogIdDist = std::function<logid_t()>;
@@ -67,6 +67,7 @@ void registerReadYourWriteLatencyWorker();
 void registerWriteSaturationWorker();
 void registerIsLogEmptyWorker();
 void registerFindTimeWorker();
+void registerScenarioWorker();
 
 } // namespace ldbench
 }} // namespace facebook::logdevice
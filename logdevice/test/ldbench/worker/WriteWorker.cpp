@@ -8,11 +8,15 @@
 
 #include <iostream>
 
+#include <folly/Format.h>
+
 #include "logdevice/common/LibeventTimer.h"
 #include "logdevice/common/Random.h"
 #include "logdevice/test/ldbench/worker/BenchStats.h"
+#include "logdevice/test/ldbench/worker/Histogram.h"
 #include "logdevice/test/ldbench/worker/LogStoreClientHolder.h"
 #include "logdevice/test/ldbench/worker/RecordWriterInfo.h"
+#include "logdevice/test/ldbench/worker/SaturationSearch.h"
 #include "logdevice/test/ldbench/worker/Worker.h"
 #include "logdevice/test/ldbench/worker/WorkerRegistry.h"
 
@@ -32,6 +36,8 @@ class WriteWorker final : public Worker {
 
     RandomEventSequence::State append_generator_state;
     LibeventTimer next_append_timer;
+    // Scheduled time of the append next_append_timer is armed for.
+    double next_append_time = 0;
     double payload_size_multiplier;
 
     // See makePayload() for explanation.
@@ -41,11 +47,14 @@ class WriteWorker final : public Worker {
     explicit LogState(logid_t log) : log_id(log) {}
   };
 
-  // Returns how many appends we need to do now. Typically 1, but can be more
-  // if timer is ticking slower than our target rate of appends.
-  size_t activateNextAppendTimer(LogState* state);
+  // Fills *due with the scheduled times of appends we need to do now.
+  // Typically 1, but can be more if timer is ticking slower than our target
+  // rate of appends.
+  void activateNextAppendTimer(LogState* state, std::vector<double>* due);
 
-  void maybeAppend(LogState* state);
+  // `scheduled_time` is when the append should have been issued, in
+  // steadyTime() terms.
+  void maybeAppend(LogState* state, double scheduled_time);
 
   void updateThroughput();
 
@@ -53,9 +62,20 @@ class WriteWorker final : public Worker {
                     bool successful,
                     bool buffered,
                     uint64_t num_records,
-                    uint64_t payload_bytes) override;
+                    uint64_t payload_bytes,
+                    const ContextSet& contexts) override;
+
+  std::string makePayload(size_t size, LogState* state, double scheduled_time);
+
+  void printLatency();
 
-  std::string makePayload(size_t size, LogState* state);
+  // With --saturation-latency-slo, the throughput increase timer ends a step
+  // of the search and starts the next one.
+  void startSaturationStep();
+  // @return  throughput of the next step, or folly::none if the search is
+  //          done.
+  folly::Optional<double> finishSaturationStep();
+  void printSaturation();
 
   void printProgress(double seconds_since_start,
                      double seconds_since_last_call) override;
@@ -76,10 +96,30 @@ class WriteWorker final : public Worker {
 
   std::atomic<uint64_t> largest_payload_size_{0};
 
+  // Latency of successful appends, in microseconds. Measured from the time the
+  // append was scheduled with --open-loop, from the time it was sent
+  // otherwise.
+  HdrHistogram append_latency_us_;
+  std::vector<double> due_appends_;
+
   // Maintaining some numbers for printProgress().
   std::atomic<uint64_t> bytes_ok_since_last_call_{0};
   LibeventTimer next_increase_throughput_timer_;
   uint64_t increase_count_;
+
+  // Set if --saturation-latency-slo is given.
+  std::unique_ptr<SaturationSearch> saturation_search_;
+  // Latency and counters of the current step of the search. The counters are
+  // the totals at the start of the step.
+  HdrHistogram step_latency_us_;
+  std::atomic<uint64_t> bytes_ok_{0};
+  double step_start_time_;
+  uint64_t step_start_bytes_ok_;
+  uint64_t step_start_succeeded_;
+  uint64_t step_start_failed_;
+  uint64_t step_start_skipped_;
+  // What made the ramp-up stop.
+  std::string saturation_bottleneck_;
 };
 
 static double steadyTime() {
@@ -88,17 +128,37 @@ static double steadyTime() {
       .count();
 }
 
+// Appends carry their scheduled time, in microseconds of steadyTime(), as
+// context.
+static Context timeToContext(double t) {
+  return reinterpret_cast<Context>(static_cast<uintptr_t>(t * 1e6));
+}
+
+static double contextToTime(Context context) {
+  return reinterpret_cast<uintptr_t>(context) / 1e6;
+}
+
 void WriteWorker::onAppendDone(LogIDType log_id,
                                bool successful,
                                bool buffered,
                                uint64_t num_records,
-                               uint64_t payload_bytes) {
+                               uint64_t payload_bytes,
+                               const ContextSet& contexts) {
   if (successful) {
     if (buffered) {
       ++batches_succeeded_;
     }
     appends_succeeded_ += num_records;
     bytes_ok_since_last_call_ += payload_bytes;
+    bytes_ok_ += payload_bytes;
+    double now = steadyTime();
+    for (const auto& context : contexts) {
+      double latency = std::max(0., now - contextToTime(context.first));
+      append_latency_us_.add(static_cast<uint64_t>(latency * 1e6));
+      if (saturation_search_) {
+        step_latency_us_.add(static_cast<uint64_t>(latency * 1e6));
+      }
+    }
   } else {
     if (buffered) {
       ++batches_failed_;
@@ -122,7 +182,9 @@ void WriteWorker::onAppendDone(LogIDType log_id,
   }
 }
 
-std::string WriteWorker::makePayload(size_t size, LogState* state) {
+std::string WriteWorker::makePayload(size_t size,
+                                     LogState* state,
+                                     double scheduled_time) {
   // We want the payload to have a given compression ratio on the client,
   // followed by a given additional compression ratio in sequencer batching.
   // To do that, we'll generate payload consisting of 3 parts:
@@ -153,6 +215,12 @@ std::string WriteWorker::makePayload(size_t size, LogState* state) {
     info.client_timestamp =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::system_clock::now().time_since_epoch());
+    if (options.open_loop) {
+      // Make readers measure end-to-end latency from the scheduled time too.
+      info.client_timestamp -=
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::duration<double>(steadyTime() - scheduled_time));
+    }
     header = (info.serializedSize() + 3) / 4;
     len = std::max(len, header) - header;
     payload_buf_.resize(header + len);
@@ -167,6 +235,12 @@ std::string WriteWorker::makePayload(size_t size, LogState* state) {
         reinterpret_cast<char*>(payload_buf_.data()), header * 4);
   }
 
+  if (options.payload_corpus) {
+    options.payload_corpus->fill(
+        reinterpret_cast<char*>(payload_buf_.data() + header), len * 4);
+    return std::string(reinterpret_cast<char*>(payload_buf_.data()), size);
+  }
+
   size_t random_len = (size_t)(
       options.payload_entropy * options.payload_entropy_sequencer * len + .5);
   size_t pseudorandom_len =
@@ -238,16 +312,126 @@ void WriteWorker::printProgress(double seconds_since_start,
           commaprint_r(uint64_t(bytes_per_sec), &bufs[5][0], 32));
 }
 
-size_t WriteWorker::activateNextAppendTimer(LogState* state) {
+void WriteWorker::printLatency() {
+  const HdrHistogram& h = append_latency_us_;
+  ld_info("append latency (%s) in us over %lu appends: p50: %lu, p90: %lu, "
+          "p99: %lu, p99.9: %lu, p99.99: %lu, max: %lu",
+          options.open_loop ? "from scheduled time" : "from send time",
+          h.count(),
+          h.percentile(50),
+          h.percentile(90),
+          h.percentile(99),
+          h.percentile(99.9),
+          h.percentile(99.99),
+          h.max());
+}
+
+void WriteWorker::startSaturationStep() {
+  step_latency_us_.reset();
+  step_start_time_ = steadyTime();
+  step_start_bytes_ok_ = bytes_ok_.load();
+  step_start_succeeded_ = appends_succeeded_.load();
+  step_start_failed_ = appends_failed_.load();
+  step_start_skipped_ = appends_skipped_.load();
+}
+
+folly::Optional<double> WriteWorker::finishSaturationStep() {
+  double seconds = std::max(1e-6, steadyTime() - step_start_time_);
+  uint64_t succeeded = appends_succeeded_.load() - step_start_succeeded_;
+  uint64_t failed = appends_failed_.load() - step_start_failed_;
+  uint64_t skipped = appends_skipped_.load() - step_start_skipped_;
+
+  SaturationSearch::Step step;
+  step.rate = options.write_bytes_per_sec;
+  step.latency_us =
+      step_latency_us_.percentile(options.saturation_latency_percentile);
+  step.error_rate =
+      succeeded + failed == 0 ? 0. : 1. * failed / (succeeded + failed);
+  // write_bytes_per_sec is split among the workers with --partition-by=record.
+  step.achieved_rate = (bytes_ok_.load() - step_start_bytes_ok_) / seconds *
+      (options.partition_by == PartitioningMode::RECORD
+           ? options.worker_id_count
+           : 1);
+
+  std::string bottleneck = saturation_search_->describeBottleneck(step);
+  if (!bottleneck.empty() && skipped > 0) {
+    // Appends are skipped when the client's in-flight limits are reached, so
+    // the client may be what's limiting the throughput.
+    bottleneck += folly::sformat(
+        ", {} appends skipped at --max-appends-in-flight or "
+        "--max-append-bytes-in-flight",
+        skipped);
+  }
+  ld_info("saturation search step: target %.0f B/s, achieved %.0f B/s, "
+          "p%g latency %lu us, %lu appends failed: %s",
+          step.rate,
+          step.achieved_rate,
+          options.saturation_latency_percentile,
+          step.latency_us,
+          failed,
+          bottleneck.empty() ? "sustainable" : bottleneck.c_str());
+
+  bool ramping = !saturation_search_->getFirstUnsustainable().has_value();
+  folly::Optional<double> next = saturation_search_->onStepDone(step);
+  if (ramping && saturation_search_->getFirstUnsustainable().has_value()) {
+    saturation_bottleneck_ = bottleneck;
+  }
+  startSaturationStep();
+  return next;
+}
+
+void WriteWorker::printSaturation() {
+  const auto& best = saturation_search_->getBest();
+  const auto& knee = saturation_search_->getKnee();
+  if (best.has_value()) {
+    ld_info("max sustainable throughput with p%g latency <= %ld ms: %.0f B/s "
+            "(achieved %.0f B/s, p%g latency %lu us)",
+            options.saturation_latency_percentile,
+            options.saturation_latency_slo.count(),
+            best->rate,
+            best->achieved_rate,
+            options.saturation_latency_percentile,
+            best->latency_us);
+  } else {
+    ld_info("No sustainable throughput found; try a lower "
+            "--write-bytes-per-sec");
+  }
+  if (knee.has_value()) {
+    ld_info("knee at %.0f B/s: p%g latency %lu us, %.3f%% appends failed",
+            knee->rate,
+            options.saturation_latency_percentile,
+            knee->latency_us,
+            knee->error_rate * 100);
+  }
+  if (!saturation_bottleneck_.empty()) {
+    ld_info("bottleneck: %s", saturation_bottleneck_.c_str());
+  }
+
+  std::cout << "saturation " << uint64_t(best ? best->rate : 0) << ' '
+            << (best ? best->latency_us : 0) << ' '
+            << uint64_t(knee ? knee->rate : 0) << std::endl;
+}
+
+void WriteWorker::activateNextAppendTimer(LogState* state,
+                                          std::vector<double>* due) {
   double now = steadyTime();
   double t;
-  size_t to_append = 1;
+  due->clear();
+  due->push_back(state->next_append_time);
   while (true) {
     t = append_generator_.nextEvent(state->append_generator_state);
     if (t >= now) {
       break;
     }
 
+    if (options.open_loop) {
+      // Never skip appends in open-loop mode: the skipped ones would be
+      // exactly the ones that would have waited the longest.
+      due->push_back(t);
+      STAT_INCR(stats_.get(), ldbench->writer_append_timer_slightly_late);
+      continue;
+    }
+
     // Libevent timers are only ~1ms granularity (at least in our current
     // configuration), but we often want to append more than one record per
     // millisecond per log. So we may need to do multiple appends per timer
@@ -255,7 +439,7 @@ size_t WriteWorker::activateNextAppendTimer(LogState* state) {
     if (t >= now - 0.010) { // 10 ms ago
       // If we missed a few events because the timer was a little late, let's
       // do as many extra appends as many events we missed.
-      ++to_append;
+      due->push_back(t);
       STAT_INCR(stats_.get(), ldbench->writer_append_timer_slightly_late);
     } else {
       // But if we're too far behind, it means we're probably out of CPU and
@@ -267,20 +451,21 @@ size_t WriteWorker::activateNextAppendTimer(LogState* state) {
           StatsType::SKIPPED, 1);
     }
   }
+  state->next_append_time = t;
   state->next_append_timer.activate(
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::duration<double>(t - now)));
-  return to_append;
 }
 
-void WriteWorker::maybeAppend(LogState* state) {
+void WriteWorker::maybeAppend(LogState* state, double scheduled_time) {
   if (append_bytes_in_flight_.load() >= options.max_append_bytes_in_flight) {
     ++appends_skipped_;
     STAT_INCR(stats_.get(), ldbench->writer_appends_skipped_bytes_in_flight);
     client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
         StatsType::SKIPPED, 1);
     return;
-  } else if (appends_in_flight_.load() >= options.max_appends_in_flight) {
+  } else if (!options.open_loop &&
+             appends_in_flight_.load() >= options.max_appends_in_flight) {
     ++appends_skipped_;
     STAT_INCR(stats_.get(), ldbench->writer_appends_skipped_appends_in_flight);
     client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
@@ -289,10 +474,12 @@ void WriteWorker::maybeAppend(LogState* state) {
   }
   STAT_INCR(stats_.get(), ldbench->writer_appends_done);
 
-  uint64_t payload_size = (uint64_t)(payload_size_distribution_.sampleFloat() *
-                                         state->payload_size_multiplier +
-                                     0.5);
-  std::string payload = makePayload(payload_size, state);
+  double base_size = options.payload_size_empirical.empty()
+      ? payload_size_distribution_.sampleFloat()
+      : (double)options.payload_size_empirical.sample();
+  uint64_t payload_size =
+      (uint64_t)(base_size * state->payload_size_multiplier + 0.5);
+  std::string payload = makePayload(payload_size, state, scheduled_time);
   payload_size = payload.size(); // may be slightly different
 
   // Track the largest payload size we've constructed.
@@ -307,17 +494,24 @@ void WriteWorker::maybeAppend(LogState* state) {
   }
 
   bool failed = false;
+  // In closed-loop mode latency is measured from the time the append is sent.
+  Context context =
+      timeToContext(options.open_loop ? scheduled_time : steadyTime());
   if (options.pretend) {
     // pretend
-    ev_->add([this, log = state->log_id, payload_size] {
+    ev_->add([this, log = state->log_id, payload_size, context] {
       DataRecordAttributes attrs;
-      onAppendDone(log.val_, true, false, 1, payload_size);
+      onAppendDone(log.val_,
+                   true,
+                   false,
+                   1,
+                   payload_size,
+                   {{context, std::string()}});
     });
     failed = false;
   } else {
-    failed = !(client_holder_->append(state->log_id.val(),
-                                      std::move(payload),
-                                      reinterpret_cast<void*>(payload_size)));
+    failed = !(client_holder_->append(
+        state->log_id.val(), std::move(payload), context));
   }
   if (failed) {
     ++appends_failed_;
@@ -488,9 +682,9 @@ int WriteWorker::run() {
     for (auto& kv : logs_) {
       auto state = kv.second.get();
       state->next_append_timer.assign(&ev_->getEvBase(), [this, state] {
-        size_t to_append = activateNextAppendTimer(state);
-        for (size_t i = 0; i < to_append; ++i) {
-          maybeAppend(state);
+        activateNextAppendTimer(state, &due_appends_);
+        for (double scheduled_time : due_appends_) {
+          maybeAppend(state, scheduled_time);
         }
       });
     }
@@ -503,11 +697,15 @@ int WriteWorker::run() {
     if (options.write_bytes_increase_interval > std::chrono::milliseconds(0)) {
       increase_count_ = 0;
       next_increase_throughput_timer_.assign(&ev_->getEvBase(), [this]() {
-        // activate next timer
-        next_increase_throughput_timer_.activate(
-            options.write_bytes_increase_interval);
         // increase the throughput for each log
-        if (options.write_bytes_increase_factor != 1.0) {
+        if (saturation_search_) {
+          folly::Optional<double> next = finishSaturationStep();
+          if (!next.has_value()) {
+            stop();
+            return;
+          }
+          options.write_bytes_per_sec = std::max<uint64_t>(1, *next);
+        } else if (options.write_bytes_increase_factor != 1.0) {
           options.write_bytes_per_sec *= options.write_bytes_increase_factor;
         } else if (options.write_bytes_increase_step != 0) {
           options.write_bytes_per_sec += options.write_bytes_increase_step;
@@ -517,7 +715,24 @@ int WriteWorker::run() {
                  options.write_bytes_per_sec);
         updateThroughput();
         increase_count_++;
+        // activate next timer
+        next_increase_throughput_timer_.activate(
+            options.write_bytes_increase_interval);
       });
+      if (options.saturation_latency_slo.count() > 0) {
+        saturation_search_ = std::make_unique<SaturationSearch>(
+            [](double rate) {
+              return options.write_bytes_increase_factor > 1.0
+                  ? rate * options.write_bytes_increase_factor
+                  : rate + options.write_bytes_increase_step;
+            },
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                options.saturation_latency_slo)
+                .count(),
+            options.saturation_max_error_rate,
+            options.saturation_precision);
+        startSaturationStep();
+      }
       next_increase_throughput_timer_.activate(
           options.write_bytes_increase_interval);
     }
@@ -527,7 +742,7 @@ int WriteWorker::run() {
     }
 
     for (auto& kv : logs_) {
-      activateNextAppendTimer(kv.second.get());
+      activateNextAppendTimer(kv.second.get(), &due_appends_);
     }
   });
 
@@ -546,6 +761,10 @@ int WriteWorker::run() {
   while (appends_in_flight_) {
   };
   destroyClient();
+  printLatency();
+  if (saturation_search_) {
+    printSaturation();
+  }
 
   std::cout << actual_duration_ms.count() << ' ' << appends_succeeded_ << ' '
             << appends_failed_ << ' ' << appends_skipped_ << ' '
@@ -569,6 +788,10 @@ void registerWriteWorker() {
                              "write-bytes-increase-factor",
                              "write-bytes-increase-step",
                              "write-bytes-increase-interval",
+                             "saturation-latency-slo",
+                             "saturation-latency-percentile",
+                             "saturation-max-error-rate",
+                             "saturation-precision",
                              "log-write-bytes-per-sec-distribution",
                              "write-spikiness",
                              "payload-size",
@@ -576,9 +799,13 @@ void registerWriteWorker() {
                              "log-payload-size-distribution",
                              "max-appends-in-flight",
                              "max-append-bytes-in-flight",
+                             "open-loop",
                              "use-buffered-writer",
                              "payload-entropy",
                              "payload-entropy-sequencer",
+                             "payload-size-file",
+                             "payload-corpus",
+                             "payload-corpus-max-bytes",
                              "start-time",
                              "record-writer-info",
                          },
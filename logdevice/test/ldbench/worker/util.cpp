@@ -9,6 +9,7 @@
 #include "logdevice/test/ldbench/worker/util.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include <folly/Random.h>
 #include <folly/String.h>
@@ -63,6 +64,31 @@ bool Log2Histogram::parse(const std::string& s) {
   if (s == "constant") {
     return true;
   }
+  const std::string lognormal = "lognormal:";
+  if (s.compare(0, lognormal.size(), lognormal) == 0) {
+    double sigma;
+    try {
+      sigma = folly::to<double>(s.substr(lognormal.size()));
+    } catch (std::range_error&) {
+      return false;
+    }
+    // Wider than that doesn't fit in 63 buckets.
+    if (!(sigma > 0 && sigma <= 4)) {
+      return false;
+    }
+    // Put the median in the middle of the range so that the tails don't get
+    // cut off. The mean is rescaled by RoughProbabilityDistribution anyway.
+    const double mu = 31 * std::log(2.);
+    auto cdf = [&](double x) {
+      return .5 * std::erfc((mu - std::log(x)) / (sigma * std::sqrt(2.)));
+    };
+    std::vector<double> buckets(63);
+    for (int i = 0; i < 63; ++i) {
+      buckets[i] = cdf(std::ldexp(1., i + 1)) - cdf(std::ldexp(1., i));
+    }
+    fromBucketProbabilities(std::move(buckets));
+    return true;
+  }
   std::vector<std::string> tokens;
   folly::split(',', s, tokens);
   for (std::string& t : tokens) {
@@ -168,6 +194,67 @@ Log2Histogram Log2Histogram::inverse() const {
   return h;
 }
 
+bool EmpiricalDistribution::parse(const std::string& s) {
+  values_.clear();
+  cumulative_weights_.clear();
+  mean_ = 0;
+
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', s, lines);
+  double total_weight = 0;
+  double weighted_sum = 0;
+  for (folly::StringPiece l : lines) {
+    std::string line = folly::trimWhitespace(l).str();
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::replace(line.begin(), line.end(), '\t', ' ');
+    std::vector<folly::StringPiece> tokens;
+    folly::split(' ', line, tokens, /* ignoreEmpty */ true);
+    if (tokens.size() > 2) {
+      return false;
+    }
+    uint64_t value;
+    double weight = 1;
+    try {
+      value = folly::to<uint64_t>(tokens[0]);
+      if (tokens.size() == 2) {
+        weight = folly::to<double>(tokens[1]);
+      }
+    } catch (std::range_error&) {
+      return false;
+    }
+    if (!(weight >= 0)) {
+      return false;
+    }
+    if (weight == 0) {
+      continue;
+    }
+    total_weight += weight;
+    weighted_sum += weight * value;
+    values_.push_back(value);
+    cumulative_weights_.push_back(total_weight);
+  }
+  if (values_.empty()) {
+    return false;
+  }
+  mean_ = weighted_sum / total_weight;
+  return true;
+}
+
+uint64_t EmpiricalDistribution::sample() const {
+  return sample(folly::Random::randDouble01());
+}
+
+uint64_t EmpiricalDistribution::sample(double x) const {
+  ld_check(!values_.empty());
+  size_t i = std::upper_bound(cumulative_weights_.begin(),
+                              cumulative_weights_.end(),
+                              x * cumulative_weights_.back()) -
+      cumulative_weights_.begin();
+  return values_[std::min(i, values_.size() - 1)];
+}
+
 RoughProbabilityDistribution::RoughProbabilityDistribution()
     : target_mean(0), histogram_mean(1) {}
 
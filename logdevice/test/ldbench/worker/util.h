@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,10 @@ struct Log2Histogram {
   // Expected value of 1/sample().
   double getMeanInverse() const;
 
+  // Parses "constant", a comma-separated list of bucket probabilities, or
+  // "lognormal:<sigma>", a log-normal distribution with the given standard
+  // deviation of the log of the value. Only the shape matters: the mean is
+  // given by the accompanying option anyway.
   // Returns true on success, false on failure.
   bool parse(const std::string& s);
 
@@ -84,6 +89,36 @@ class RoughProbabilityDistribution {
   Log2Histogram histogram;
 };
 
+// An exact distribution of nonnegative integers given by a list of values,
+// e.g. payload sizes captured from production.
+class EmpiricalDistribution {
+ public:
+  // One value per line, optionally followed by whitespace and the value's
+  // weight (e.g. the number of times it was seen); the default weight is 1.
+  // Empty lines and lines starting with '#' are ignored.
+  // Returns true on success, false on failure.
+  bool parse(const std::string& s);
+
+  bool empty() const {
+    return values_.empty();
+  }
+
+  uint64_t sample() const;
+  // A deterministic version of sample(). x should be uniformly distributed
+  // in [0, 1).
+  uint64_t sample(double x) const;
+
+  double getMean() const {
+    return mean_;
+  }
+
+ private:
+  std::vector<uint64_t> values_;
+  // cumulative_weights_[i] is the total weight of values_[0..i].
+  std::vector<double> cumulative_weights_;
+  double mean_ = 0;
+};
+
 // Description of how bursty a workload is.
 // The graph of event rate over time is periodic and piecewise-constant:
 //